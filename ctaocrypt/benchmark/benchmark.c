@@ -34,6 +34,7 @@
     #include <fio.h>
 #else
     #include <stdio.h>
+    #include <stdlib.h>
 #endif
 
 #include <cyassl/ctaocrypt/des3.h>
@@ -43,11 +44,13 @@
 #include <cyassl/ctaocrypt/chacha.h>
 #include <cyassl/ctaocrypt/aes.h>
 #include <cyassl/ctaocrypt/poly1305.h>
+#include <cyassl/ctaocrypt/chacha20_poly1305.h>
 #include <cyassl/ctaocrypt/camellia.h>
 #include <cyassl/ctaocrypt/md5.h>
 #include <cyassl/ctaocrypt/sha.h>
 #include <cyassl/ctaocrypt/sha256.h>
 #include <cyassl/ctaocrypt/sha512.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #include <cyassl/ctaocrypt/rsa.h>
 #include <cyassl/ctaocrypt/asn.h>
 #include <cyassl/ctaocrypt/ripemd.h>
@@ -57,6 +60,9 @@
 #ifdef HAVE_ECC25519
     #include <cyassl/ctaocrypt/ecc25519.h>
 #endif
+#ifdef HAVE_ED25519
+    #include <cyassl/ctaocrypt/ed25519.h>
+#endif
 #include <cyassl/ctaocrypt/dh.h>
 #ifdef HAVE_CAVIUM
     #include "cavium_sysdep.h"
@@ -98,6 +104,7 @@ void bench_arc4(void);
 void bench_hc128(void);
 void bench_rabbit(void);
 void bench_chacha(void);
+void bench_chacha20_poly1305_aead(void);
 void bench_aes(int);
 void bench_aesgcm(void);
 void bench_aesccm(void);
@@ -123,6 +130,10 @@ void bench_eccKeyAgree(void);
 void bench_ecc25519KeyGen(void);
 void bench_ecc25519KeyAgree(void);
 #endif
+#ifdef HAVE_ED25519
+void bench_ed25519KeyGen(void);
+void bench_ed25519KeySign(void);
+#endif
 #ifdef HAVE_NTRU
 void bench_ntru(void);
 void bench_ntruKeyGen(void);
@@ -130,6 +141,26 @@ void bench_ntruKeyGen(void);
 
 double current_time(int);
 
+/* the -sweep, -threads, -csv and -json options of the standalone program */
+#if !defined(BENCH_EMBEDDED) && !defined(NO_MAIN_DRIVER)
+    #define BENCH_SWEEP
+
+    #if defined(HAVE_PTHREAD) && !defined(SINGLE_THREADED) && \
+        !defined(_WIN32)
+        #define BENCH_THREADS
+    #endif
+
+    #define BENCH_MAX_THREADS 64
+
+    enum {
+        SWEEP_TEXT = 0,
+        SWEEP_CSV  = 1,
+        SWEEP_JSON = 2
+    };
+
+    static int bench_sweep(int threads, int format);
+#endif
+
 
 #ifdef HAVE_CAVIUM
 
@@ -164,8 +195,51 @@ static int OpenNitroxDevice(int dma_mode,int dev_id)
 int main(int argc, char** argv)
 
 {
+#ifdef BENCH_SWEEP
+    int sweep   = 0;
+    int threads = 1;
+    int format  = SWEEP_TEXT;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-sweep") == 0)
+            sweep = 1;
+        else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            sweep   = 1;
+        }
+        else if (strcmp(argv[i], "-csv") == 0) {
+            format = SWEEP_CSV;
+            sweep  = 1;
+        }
+        else if (strcmp(argv[i], "-json") == 0) {
+            format = SWEEP_JSON;
+            sweep  = 1;
+        }
+        else {
+            printf("usage: %s [-sweep] [-threads N] [-csv | -json]\n",
+                   argv[0]);
+            return 1;
+        }
+    }
+
+    #ifndef BENCH_THREADS
+        if (threads > 1) {
+            printf("-threads needs pthreads, not in this build\n");
+            return 1;
+        }
+    #endif
+    if (threads < 1 || threads > BENCH_MAX_THREADS) {
+        printf("-threads must be 1 to %d\n", BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    if (sweep)
+        return bench_sweep(threads, format) == 0 ? 0 : 1;
+#else
   (void)argc;
   (void)argv;
+#endif
 #else
 int benchmark_test(void *args) 
 {
@@ -212,6 +286,9 @@ int benchmark_test(void *args)
 #ifdef HAVE_CHACHA
     bench_chacha();
 #endif
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    bench_chacha20_poly1305_aead();
+#endif
 #ifndef NO_DES3
     bench_des();
 #endif
@@ -243,6 +320,29 @@ int benchmark_test(void *args)
     bench_blake2();
 #endif
 
+#ifdef HAVE_CYASSL_ARMV8_CRYPTO
+    /* the generic code on the same cpu, to compare against the crypto
+     * extension numbers above */
+    if (CyaSSL_GetCpuFeatures() & (CYASSL_CPU_ARM_AES | CYASSL_CPU_ARM_SHA1 |
+                                   CYASSL_CPU_ARM_SHA2)) {
+        printf("\nwithout ARMv8 crypto extensions\n");
+        CyaSSL_SetCpuFeatureMask(0);
+    #ifndef NO_AES
+        bench_aes(1);
+    #endif
+    #ifdef HAVE_AESGCM
+        bench_aesgcm();
+    #endif
+    #ifndef NO_SHA
+        bench_sha();
+    #endif
+    #ifndef NO_SHA256
+        bench_sha256();
+    #endif
+        CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    }
+#endif
+
     printf("\n");
 
 #ifndef NO_RSA
@@ -278,6 +378,11 @@ int benchmark_test(void *args)
     bench_ecc25519KeyAgree();
 #endif
 
+#ifdef HAVE_ED25519
+    bench_ed25519KeyGen();
+    bench_ed25519KeySign();
+#endif
+
     return 0;
 }
 
@@ -527,11 +632,63 @@ void bench_camellia(void)
 
     printf("Camellia %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
                                               blockType, total, persec);
+
+    /* decryption runs 16 blocks at a time where the cpu allows */
+    start = current_time(1);
+
+    for(i = 0; i < numBlocks; i++)
+        CamelliaCbcDecrypt(&cam, plain, cipher, sizeof(plain));
+
+    total = current_time(0) - start;
+
+    persec = 1 / total * numBlocks;
+#ifdef BENCH_EMBEDDED
+    /* since using kB, convert to MB/s */
+    persec = persec / 1024;
+#endif
+
+    printf("CAM-DEC  %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
+                                              blockType, total, persec);
 }
 #endif
 
 
 #ifndef NO_DES3
+static void bench_des_dec(const char* impl)
+{
+    Des3   dec;
+    double start, total, persec;
+    int    i, ret;
+
+#ifdef HAVE_CAVIUM
+    if (Des3_InitCavium(&dec, CAVIUM_DEV_ID) != 0)
+        printf("des3 init cavium failed\n");
+#endif
+    ret = Des3_SetKey(&dec, key, iv, DES_DECRYPTION);
+    if (ret != 0) {
+        printf("Des3_SetKey failed, ret = %d\n", ret);
+        return;
+    }
+    start = current_time(1);
+
+    for(i = 0; i < numBlocks; i++)
+        Des3_CbcDecrypt(&dec, plain, cipher, sizeof(plain));
+
+    total = current_time(0) - start;
+
+    persec = 1 / total * numBlocks;
+#ifdef BENCH_EMBEDDED
+    /* since using kB, convert to MB/s */
+    persec = persec / 1024;
+#endif
+
+    printf("3DES-DEC %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+#ifdef HAVE_CAVIUM
+    Des3_FreeCavium(&dec);
+#endif
+}
+
 void bench_des(void)
 {
     Des3   enc;
@@ -565,6 +722,18 @@ void bench_des(void)
 #ifdef HAVE_CAVIUM
     Des3_FreeCavium(&enc);
 #endif
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* decryption runs eight blocks at a time with AVX2 */
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2) {
+        bench_des_dec(" (avx2)");
+        CyaSSL_SetCpuFeatureMask((word32)~CYASSL_CPU_AVX2);
+        bench_des_dec(" (c)");
+        CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    }
+    else
+#endif
+        bench_des_dec("");
 }
 #endif
 
@@ -603,8 +772,29 @@ void bench_arc4(void)
 #endif
 
 
+#if (!defined(NO_RABBIT) || defined(HAVE_HC128)) && \
+    (defined(HAVE_CYASSL_X86_SIMD) || \
+     (defined(HAVE_CYASSL_CPUID) && defined(__aarch64__)))
+    #define BENCH_STREAM_IMPLS
+/* stream cipher variants, the wide one and the generic C code */
+static const struct {
+    word32      need;
+    word32      mask;
+    const char* name;
+} streamImpls[] = {
+#ifdef HAVE_CYASSL_X86_SIMD
+    { CYASSL_CPU_SSE2,     0xFFFFFFFF,                   " (sse2)" },
+#else
+    { CYASSL_CPU_ARM_NEON, 0xFFFFFFFF,                   " (neon)" },
+#endif
+    { 0,                   (word32)~(CYASSL_CPU_SSE2 |
+                                     CYASSL_CPU_ARM_NEON), " (c)"    }
+};
+#endif
+
+
 #ifdef HAVE_HC128
-void bench_hc128(void)
+static void bench_hc128_impl(const char* impl)
 {
     HC128  enc;
     double start, total, persec;
@@ -623,14 +813,32 @@ void bench_hc128(void)
     persec = persec / 1024;
 #endif
 
-    printf("HC128    %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
-                                              blockType, total, persec);
+    printf("HC128    %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+}
+
+void bench_hc128(void)
+{
+#ifdef BENCH_STREAM_IMPLS
+    word32 cpu = CyaSSL_GetCpuFeatures();
+    int    i;
+
+    for (i = 0; i < (int)(sizeof(streamImpls)/sizeof(streamImpls[0])); i++) {
+        if ((cpu & streamImpls[i].need) != streamImpls[i].need)
+            continue;
+        CyaSSL_SetCpuFeatureMask(streamImpls[i].mask);
+        bench_hc128_impl(streamImpls[i].name);
+    }
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#else
+    bench_hc128_impl("");
+#endif
 }
 #endif /* HAVE_HC128 */
 
 
 #ifndef NO_RABBIT
-void bench_rabbit(void)
+static void bench_rabbit_impl(const char* impl)
 {
     Rabbit  enc;
     double start, total, persec;
@@ -649,8 +857,26 @@ void bench_rabbit(void)
     persec = persec / 1024;
 #endif
 
-    printf("RABBIT   %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
-                                              blockType, total, persec);
+    printf("RABBIT   %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+}
+
+void bench_rabbit(void)
+{
+#ifdef BENCH_STREAM_IMPLS
+    word32 cpu = CyaSSL_GetCpuFeatures();
+    int    i;
+
+    for (i = 0; i < (int)(sizeof(streamImpls)/sizeof(streamImpls[0])); i++) {
+        if ((cpu & streamImpls[i].need) != streamImpls[i].need)
+            continue;
+        CyaSSL_SetCpuFeatureMask(streamImpls[i].mask);
+        bench_rabbit_impl(streamImpls[i].name);
+    }
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#else
+    bench_rabbit_impl("");
+#endif
 }
 #endif /* NO_RABBIT */
 
@@ -682,6 +908,44 @@ void bench_chacha(void)
 #endif /* HAVE_CHACHA*/
 
 
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+void bench_chacha20_poly1305_aead(void)
+{
+    static const byte aeadKey[CHACHA20_POLY1305_AEAD_KEYSIZE] =
+    {
+        0x01,0x23,0x45,0x67,0x89,0xab,0xcd,0xef,
+        0xfe,0xde,0xba,0x98,0x76,0x54,0x32,0x10,
+        0x89,0xab,0xcd,0xef,0x01,0x23,0x45,0x67,
+        0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7
+    };
+    byte   authTag[CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE];
+    double start, total, persec;
+    int    i;
+    int    ret;
+
+    start = current_time(1);
+
+    for (i = 0; i < numBlocks; i++) {
+        ret = ChaCha20Poly1305_Encrypt(aeadKey, iv, iv, 13, plain,
+                                       sizeof(plain), cipher, authTag);
+        if (ret != 0) {
+            printf("ChaCha20Poly1305_Encrypt failed, ret = %d\n", ret);
+            return;
+        }
+    }
+    total = current_time(0) - start;
+    persec = 1 / total * numBlocks;
+#ifdef BENCH_EMBEDDED
+    /* since using kB, convert to MB/s */
+    persec = persec / 1024;
+#endif
+
+    printf("CHA-POLY %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
+                                              blockType, total, persec);
+}
+#endif /* HAVE_CHACHA && HAVE_POLY1305 */
+
+
 #ifndef NO_MD5
 void bench_md5(void)
 {
@@ -712,7 +976,23 @@ void bench_md5(void)
 
 
 #ifndef NO_SHA
-void bench_sha(void)
+#ifdef HAVE_CYASSL_X86_SIMD
+/* SHA-1 variants this cpu can run, best first, and the feature mask that
+ * selects each */
+static const struct {
+    word32      need;
+    word32      mask;
+    const char* name;
+} shaImpls[] = {
+    { CYASSL_CPU_SHA | CYASSL_CPU_SSE4_1, 0xFFFFFFFF,              " (sha-ni)" },
+    { CYASSL_CPU_AVX2,                    (word32)~CYASSL_CPU_SHA, " (avx2)"   },
+    { CYASSL_CPU_SSSE3,                   (word32)~(CYASSL_CPU_SHA |
+                                                    CYASSL_CPU_AVX2), " (ssse3)" },
+    { 0,                                  0,                       " (c)"      }
+};
+#endif
+
+static void bench_sha_impl(const char* impl)
 {
     Sha    hash;
     byte   digest[SHA_DIGEST_SIZE];
@@ -738,8 +1018,26 @@ void bench_sha(void)
     persec = persec / 1024;
 #endif
 
-    printf("SHA      %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
-                                              blockType, total, persec);
+    printf("SHA      %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+}
+
+void bench_sha(void)
+{
+#ifdef HAVE_CYASSL_X86_SIMD
+    word32 cpu = CyaSSL_GetCpuFeatures();
+    int    i;
+
+    for (i = 0; i < (int)(sizeof(shaImpls)/sizeof(shaImpls[0])); i++) {
+        if ((cpu & shaImpls[i].need) != shaImpls[i].need)
+            continue;
+        CyaSSL_SetCpuFeatureMask(shaImpls[i].mask);
+        bench_sha_impl(shaImpls[i].name);
+    }
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#else
+    bench_sha_impl("");
+#endif
 }
 #endif /* NO_SHA */
 
@@ -785,8 +1083,22 @@ void bench_sha256(void)
 }
 #endif
 
+#if defined(HAVE_CYASSL_X86_SIMD) && (defined(CYASSL_SHA512) || defined(CYASSL_SHA384))
+/* SHA-512/384 variants this cpu can run, best first, and the feature mask
+ * that selects each */
+static const struct {
+    word32      need;
+    word32      mask;
+    const char* name;
+} sha512Impls[] = {
+    { CYASSL_CPU_AVX2 | CYASSL_CPU_BMI2, 0xFFFFFFFF,               " (avx2)" },
+    { CYASSL_CPU_BMI2,                   (word32)~CYASSL_CPU_AVX2, " (rorx)" },
+    { 0,                                 0,                        " (c)"    }
+};
+#endif
+
 #ifdef CYASSL_SHA384
-void bench_sha384(void)
+static void bench_sha384_impl(const char* impl)
 {
     Sha384 hash;
     byte   digest[SHA384_DIGEST_SIZE];
@@ -821,13 +1133,31 @@ void bench_sha384(void)
     persec = persec / 1024;
 #endif
 
-    printf("SHA-384  %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
-                                              blockType, total, persec);
+    printf("SHA-384  %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+}
+
+void bench_sha384(void)
+{
+#ifdef HAVE_CYASSL_X86_SIMD
+    word32 cpu = CyaSSL_GetCpuFeatures();
+    int    i;
+
+    for (i = 0; i < (int)(sizeof(sha512Impls)/sizeof(sha512Impls[0])); i++) {
+        if ((cpu & sha512Impls[i].need) != sha512Impls[i].need)
+            continue;
+        CyaSSL_SetCpuFeatureMask(sha512Impls[i].mask);
+        bench_sha384_impl(sha512Impls[i].name);
+    }
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#else
+    bench_sha384_impl("");
+#endif
 }
 #endif
 
 #ifdef CYASSL_SHA512
-void bench_sha512(void)
+static void bench_sha512_impl(const char* impl)
 {
     Sha512 hash;
     byte   digest[SHA512_DIGEST_SIZE];
@@ -862,8 +1192,26 @@ void bench_sha512(void)
     persec = persec / 1024;
 #endif
 
-    printf("SHA-512  %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
-                                              blockType, total, persec);
+    printf("SHA-512  %d %s took %5.3f seconds, %7.3f MB/s%s\n", numBlocks,
+                                              blockType, total, persec, impl);
+}
+
+void bench_sha512(void)
+{
+#ifdef HAVE_CYASSL_X86_SIMD
+    word32 cpu = CyaSSL_GetCpuFeatures();
+    int    i;
+
+    for (i = 0; i < (int)(sizeof(sha512Impls)/sizeof(sha512Impls[0])); i++) {
+        if ((cpu & sha512Impls[i].need) != sha512Impls[i].need)
+            continue;
+        CyaSSL_SetCpuFeatureMask(sha512Impls[i].mask);
+        bench_sha512_impl(sha512Impls[i].name);
+    }
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#else
+    bench_sha512_impl("");
+#endif
 }
 #endif
 
@@ -934,6 +1282,41 @@ void bench_blake2(void)
 
     printf("BLAKE2b  %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
                                               blockType, total, persec);
+
+    {
+        Blake2bp b2bp;
+
+        ret = InitBlake2bp(&b2bp, 64);
+        if (ret != 0) {
+            printf("InitBlake2bp failed, ret = %d\n", ret);
+            return;
+        }
+        start = current_time(1);
+
+        for(i = 0; i < numBlocks; i++) {
+            ret = Blake2bpUpdate(&b2bp, plain, sizeof(plain));
+            if (ret != 0) {
+                printf("Blake2bpUpdate failed, ret = %d\n", ret);
+                return;
+            }
+        }
+
+        ret = Blake2bpFinal(&b2bp, digest, 64);
+        if (ret != 0) {
+            printf("Blake2bpFinal failed, ret = %d\n", ret);
+            return;
+        }
+
+        total = current_time(0) - start;
+        persec = 1 / total * numBlocks;
+#ifdef BENCH_EMBEDDED
+        /* since using kB, convert to MB/s */
+        persec = persec / 1024;
+#endif
+
+        printf("BLAKE2bp %d %s took %5.3f seconds, %7.3f MB/s\n", numBlocks,
+                                                  blockType, total, persec);
+    }
 }
 #endif
 
@@ -1041,6 +1424,22 @@ void bench_rsa(void)
     printf("RSA %d decryption took %6.3f milliseconds, avg over %d"
            " iterations\n", rsaKeySz, milliEach, ntimes);
 
+    /* signing also blinds the private exponents */
+    start = current_time(1);
+
+    for (i = 0; i < ntimes; i++)
+        ret = RsaSSL_Sign(message, len, enc, sizeof(enc), &rsaKey, &rng);
+
+    total = current_time(0) - start;
+    each  = total / ntimes;   /* per second   */
+    milliEach = each * 1000; /* milliseconds */
+
+    printf("RSA %d sign       took %6.3f milliseconds, avg over %d"
+           " iterations\n", rsaKeySz, milliEach, ntimes);
+
+    if (ret < 0)
+        printf("Rsa Sign failed\n");
+
     FreeRsaKey(&rsaKey);
 #ifdef HAVE_CAVIUM
     RsaFreeCavium(&rsaKey);
@@ -1501,6 +1900,62 @@ void bench_eccKeyAgree(void)
     printf("EC-DSA   verify time     %6.3f milliseconds, avg over %d"
            " iterations\n", milliEach, agreeTimes);
 
+    {
+        /* batches of BATCH_SZ, reported per signature */
+        #define BATCH_SZ 16
+        static byte bsig[BATCH_SZ][ECC_BUFSIZE];
+        byte*       bout[BATCH_SZ];
+        const byte* bin[BATCH_SZ];
+        word32      binLen[BATCH_SZ], boutLen[BATCH_SZ];
+        int         bstat[BATCH_SZ];
+        ecc_key*    bkey[BATCH_SZ];
+        int         j, batches = (agreeTimes + BATCH_SZ - 1) / BATCH_SZ;
+
+        for (j = 0; j < BATCH_SZ; j++) {
+            bin[j]    = digest;
+            binLen[j] = sizeof(digest);
+            bout[j]   = bsig[j];
+            bkey[j]   = &genKey;
+        }
+
+        start = current_time(1);
+
+        for(i = 0; i < batches; i++) {
+            for (j = 0; j < BATCH_SZ; j++)
+                boutLen[j] = ECC_BUFSIZE;
+            ret = ecc_sign_hash_batch(bin, binLen, bout, boutLen, BATCH_SZ,
+                                      &rng, bkey);
+            if (ret != 0) {
+                printf("ecc_sign_hash_batch failed\n");
+                return;
+            }
+        }
+
+        total = current_time(0) - start;
+        each  = total / (batches * BATCH_SZ);
+        milliEach = each * 1000;
+        printf("EC-DSA   batch sign      %6.3f milliseconds, avg over %d"
+               " iterations\n", milliEach, batches * BATCH_SZ);
+
+        start = current_time(1);
+
+        for(i = 0; i < batches; i++) {
+            ret = ecc_verify_hash_batch((const byte**)bout, boutLen, bin,
+                                        binLen, bstat, BATCH_SZ, bkey);
+            if (ret != 0 || bstat[0] != 1) {
+                printf("ecc_verify_hash_batch failed\n");
+                return;
+            }
+        }
+
+        total = current_time(0) - start;
+        each  = total / (batches * BATCH_SZ);
+        milliEach = each * 1000;
+        printf("EC-DSA   batch verify    %6.3f milliseconds, avg over %d"
+               " iterations\n", milliEach, batches * BATCH_SZ);
+        #undef BATCH_SZ
+    }
+
     ecc_free(&genKey2);
     ecc_free(&genKey);
 }
@@ -1586,6 +2041,553 @@ void bench_ecc25519KeyAgree(void)
 }
 #endif /* HAVE_ECC25519 */
 
+#ifdef HAVE_ED25519
+void bench_ed25519KeyGen(void)
+{
+    ed25519_key genKey;
+    double start, total, each, milliEach;
+    int    i, ret;
+
+    ret = InitRng(&rng);
+    if (ret < 0) {
+        printf("InitRNG failed\n");
+        return;
+    }
+    /* 256 bit */
+    start = current_time(1);
+
+    for(i = 0; i < genTimes; i++) {
+        ed25519_init(&genKey);
+        ed25519_make_key(&rng, 32, &genKey);
+        ed25519_free(&genKey);
+    }
+
+    total = current_time(0) - start;
+    each  = total / genTimes;  /* per second  */
+    milliEach = each * 1000;   /* millisconds */
+    printf("\n");
+    printf("ED25519  key generation     %6.3f milliseconds, avg over %d"
+           " iterations\n", milliEach, genTimes);
+}
+
+
+void bench_ed25519KeySign(void)
+{
+    enum { batchSz = 16 };
+    ed25519_key  genKey;
+    ed25519_key* keys[batchSz];
+    const byte*  sigs[batchSz];
+    const byte*  msgs[batchSz];
+    word32       sigLens[batchSz];
+    word32       msgLens[batchSz];
+    int          stats[batchSz];
+    double start, total, each, milliEach;
+    int    i, ret, verify;
+    byte   sig[ED25519_SIG_SIZE];
+    byte   msg[512];
+    word32 x = 0;
+
+    ed25519_init(&genKey);
+
+    ret = InitRng(&rng);
+    if (ret < 0) {
+        printf("InitRNG failed\n");
+        return;
+    }
+
+    ret = ed25519_make_key(&rng, 32, &genKey);
+    if (ret != 0) {
+        printf("ed25519_make_key failed\n");
+        return;
+    }
+
+    /* make dummy msg */
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (byte)i;
+
+    start = current_time(1);
+
+    for(i = 0; i < agreeTimes; i++) {
+        x = sizeof(sig);
+        ret = ed25519_sign_msg(msg, sizeof(msg), sig, &x, &genKey);
+        if (ret != 0) {
+            printf("ed25519_sign_msg failed\n");
+            return;
+        }
+    }
+
+    total = current_time(0) - start;
+    each  = total / agreeTimes;  /* per second  */
+    milliEach = each * 1000;   /* millisconds */
+    printf("ED25519  sign   time        %6.3f milliseconds, avg over %d"
+           " iterations\n", milliEach, agreeTimes);
+
+    start = current_time(1);
+
+    for(i = 0; i < agreeTimes; i++) {
+        verify = 0;
+        ret = ed25519_verify_msg(sig, x, msg, sizeof(msg), &verify, &genKey);
+        if (ret != 0 || verify != 1) {
+            printf("ed25519_verify_msg failed\n");
+            return;
+        }
+    }
+
+    total = current_time(0) - start;
+    each  = total / agreeTimes;  /* per second  */
+    milliEach = each * 1000;   /* millisconds */
+    printf("ED25519  verify time        %6.3f milliseconds, avg over %d"
+           " iterations\n", milliEach, agreeTimes);
+
+    /* the same signature batchSz times, per signature cost */
+    for (i = 0; i < batchSz; i++) {
+        keys[i]    = &genKey;
+        sigs[i]    = sig;
+        msgs[i]    = msg;
+        sigLens[i] = x;
+        msgLens[i] = sizeof(msg);
+    }
+
+    start = current_time(1);
+
+    for(i = 0; i < agreeTimes; i += batchSz) {
+        ret = ed25519_verify_msg_batch(sigs, sigLens, msgs, msgLens, stats,
+                                       batchSz, keys);
+        if (ret != 0 || stats[0] != 1) {
+            printf("ed25519_verify_msg_batch failed\n");
+            return;
+        }
+    }
+
+    total = current_time(0) - start;
+    each  = total / ((agreeTimes + batchSz - 1) / batchSz * batchSz);
+    milliEach = each * 1000;   /* millisconds */
+    printf("ED25519  batch verify       %6.3f milliseconds, per signature in "
+           "batches of %d\n", milliEach, batchSz);
+
+    ed25519_free(&genKey);
+}
+#endif /* HAVE_ED25519 */
+
+#ifdef BENCH_SWEEP
+
+/* -sweep mode: each primitive over buffer sizes from 16 bytes to 64 kB,
+ * optionally on N threads at once, as text, CSV or JSON */
+
+#ifdef BENCH_THREADS
+    #include <pthread.h>
+#endif
+
+#define SWEEP_BUDGET      (4 * 1024 * 1024)   /* bytes per thread per run */
+#define SWEEP_MAX_SIZE    (64 * 1024)
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define HAVE_INTEL_CYCLES
+
+    static INLINE word64 get_intel_cycles(void)
+    {
+        unsigned int lo, hi;
+        __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+        return ((word64)hi << 32) | lo;
+    }
+
+    #define BEGIN_INTEL_CYCLES(c) (c) = get_intel_cycles();
+    #define END_INTEL_CYCLES(c)   (c) = get_intel_cycles() - (c);
+#else
+    #define BEGIN_INTEL_CYCLES(c) (c) = 0;
+    #define END_INTEL_CYCLES(c)
+#endif
+
+
+static const byte sweepKey[32] =
+{
+    0x01,0x23,0x45,0x67,0x89,0xab,0xcd,0xef,
+    0xfe,0xde,0xba,0x98,0x76,0x54,0x32,0x10,
+    0x89,0xab,0xcd,0xef,0x01,0x23,0x45,0x67,
+    0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7
+};
+
+
+/* iters operations of sz bytes each, keys are set up once per call */
+typedef int (*SweepFunc)(byte* out, const byte* in, word32 sz, int iters);
+
+#ifndef NO_AES
+static int sweep_aes_cbc(byte* out, const byte* in, word32 sz, int iters)
+{
+    Aes enc;
+    int i, ret;
+
+    ret = AesSetKey(&enc, sweepKey, 16, iv, AES_ENCRYPTION);
+    for (i = 0; i < iters && ret == 0; i++)
+        ret = AesCbcEncrypt(&enc, out, in, sz);
+
+    return ret;
+}
+#endif
+
+#ifdef HAVE_AESGCM
+static int sweep_aes_gcm(byte* out, const byte* in, word32 sz, int iters)
+{
+    Aes  enc;
+    byte authTag[AES_BLOCK_SIZE];
+    int  i, ret;
+
+    ret = AesGcmSetKey(&enc, sweepKey, 16);
+    for (i = 0; i < iters && ret == 0; i++)
+        ret = AesGcmEncrypt(&enc, out, in, sz, iv, 12, authTag,
+                            sizeof(authTag), additional, 13);
+
+    return ret;
+}
+#endif
+
+#ifdef CYASSL_AES_COUNTER
+static int sweep_aes_ctr(byte* out, const byte* in, word32 sz, int iters)
+{
+    Aes enc;
+    int i, ret;
+
+    ret = AesSetKeyDirect(&enc, sweepKey, 16, iv, AES_ENCRYPTION);
+    for (i = 0; i < iters && ret == 0; i++)
+        AesCtrEncrypt(&enc, out, in, sz);
+
+    return ret;
+}
+#endif
+
+#ifdef HAVE_CHACHA
+static int sweep_chacha(byte* out, const byte* in, word32 sz, int iters)
+{
+    ChaCha enc;
+    int    i, ret;
+
+    ret = Chacha_SetKey(&enc, sweepKey, 32);
+    for (i = 0; i < iters && ret == 0; i++) {
+        ret = Chacha_SetIV(&enc, iv, 0);
+        if (ret == 0)
+            ret = Chacha_Process(&enc, out, in, sz);
+    }
+
+    return ret;
+}
+#endif
+
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+static int sweep_chacha_poly(byte* out, const byte* in, word32 sz, int iters)
+{
+    byte authTag[CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE];
+    int  i, ret = 0;
+
+    for (i = 0; i < iters && ret == 0; i++)
+        ret = ChaCha20Poly1305_Encrypt(sweepKey, iv, iv, 13, in, sz, out,
+                                       authTag);
+
+    return ret;
+}
+#endif
+
+#ifndef NO_RC4
+static int sweep_arc4(byte* out, const byte* in, word32 sz, int iters)
+{
+    Arc4 enc;
+    int  i;
+
+    Arc4SetKey(&enc, sweepKey, 16);
+    for (i = 0; i < iters; i++)
+        Arc4Process(&enc, out, in, sz);
+
+    return 0;
+}
+#endif
+
+#ifndef NO_DES3
+static int sweep_des3(byte* out, const byte* in, word32 sz, int iters)
+{
+    Des3 enc;
+    int  i, ret;
+
+    ret = Des3_SetKey(&enc, sweepKey, iv, DES_ENCRYPTION);
+    for (i = 0; i < iters && ret == 0; i++)
+        ret = Des3_CbcEncrypt(&enc, out, in, sz);
+
+    return ret;
+}
+#endif
+
+#ifdef HAVE_POLY1305
+static int sweep_poly1305(byte* out, const byte* in, word32 sz, int iters)
+{
+    Poly1305 mac;
+    int      i, ret = 0;
+
+    for (i = 0; i < iters && ret == 0; i++) {
+        ret = Poly1305SetKey(&mac, sweepKey, 32);
+        if (ret == 0)
+            ret = Poly1305Update(&mac, in, sz);
+        if (ret == 0)
+            ret = Poly1305Final(&mac, out);
+    }
+
+    return ret;
+}
+#endif
+
+#ifndef NO_MD5
+static int sweep_md5(byte* out, const byte* in, word32 sz, int iters)
+{
+    Md5 hash;
+    int i;
+
+    InitMd5(&hash);
+    for (i = 0; i < iters; i++) {
+        Md5Update(&hash, in, sz);
+        Md5Final(&hash, out);
+    }
+
+    return 0;
+}
+#endif
+
+#ifndef NO_SHA
+static int sweep_sha(byte* out, const byte* in, word32 sz, int iters)
+{
+    Sha hash;
+    int i, ret;
+
+    ret = InitSha(&hash);
+    for (i = 0; i < iters && ret == 0; i++) {
+        ret = ShaUpdate(&hash, in, sz);
+        if (ret == 0)
+            ret = ShaFinal(&hash, out);
+    }
+
+    return ret;
+}
+#endif
+
+#ifndef NO_SHA256
+static int sweep_sha256(byte* out, const byte* in, word32 sz, int iters)
+{
+    Sha256 hash;
+    int    i, ret;
+
+    ret = InitSha256(&hash);
+    for (i = 0; i < iters && ret == 0; i++) {
+        ret = Sha256Update(&hash, in, sz);
+        if (ret == 0)
+            ret = Sha256Final(&hash, out);
+    }
+
+    return ret;
+}
+#endif
+
+#ifdef CYASSL_SHA512
+static int sweep_sha512(byte* out, const byte* in, word32 sz, int iters)
+{
+    Sha512 hash;
+    int    i, ret;
+
+    ret = InitSha512(&hash);
+    for (i = 0; i < iters && ret == 0; i++) {
+        ret = Sha512Update(&hash, in, sz);
+        if (ret == 0)
+            ret = Sha512Final(&hash, out);
+    }
+
+    return ret;
+}
+#endif
+
+
+static const struct {
+    const char* name;
+    SweepFunc   func;
+    word32      align;    /* sizes must be a multiple of this */
+} sweepAlgos[] = {
+#ifndef NO_AES
+    { "AES-128-CBC",       sweep_aes_cbc,     AES_BLOCK_SIZE },
+#endif
+#ifdef HAVE_AESGCM
+    { "AES-128-GCM",       sweep_aes_gcm,     1 },
+#endif
+#ifdef CYASSL_AES_COUNTER
+    { "AES-128-CTR",       sweep_aes_ctr,     1 },
+#endif
+#ifdef HAVE_CHACHA
+    { "CHACHA20",          sweep_chacha,      1 },
+#endif
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    { "CHACHA20-POLY1305", sweep_chacha_poly, 1 },
+#endif
+#ifndef NO_RC4
+    { "ARC4",              sweep_arc4,        1 },
+#endif
+#ifndef NO_DES3
+    { "3DES-CBC",          sweep_des3,        DES_BLOCK_SIZE },
+#endif
+#ifdef HAVE_POLY1305
+    { "POLY1305",          sweep_poly1305,    1 },
+#endif
+#ifndef NO_MD5
+    { "MD5",               sweep_md5,         1 },
+#endif
+#ifndef NO_SHA
+    { "SHA-1",             sweep_sha,         1 },
+#endif
+#ifndef NO_SHA256
+    { "SHA-256",           sweep_sha256,      1 },
+#endif
+#ifdef CYASSL_SHA512
+    { "SHA-512",           sweep_sha512,      1 },
+#endif
+    { NULL, NULL, 0 }
+};
+
+static const word32 sweepSizes[] = { 16, 64, 256, 1024, 8192, 16384, 65536 };
+
+
+typedef struct SweepThread {
+    SweepFunc func;
+    byte*     in;
+    byte*     out;
+    word32    sz;
+    int       iters;
+    word64    cycles;
+    int       ret;
+} SweepThread;
+
+
+static void* SweepRun(void* arg)
+{
+    SweepThread* t = (SweepThread*)arg;
+
+    BEGIN_INTEL_CYCLES(t->cycles)
+    t->ret = t->func(t->out, t->in, t->sz, t->iters);
+    END_INTEL_CYCLES(t->cycles)
+
+    return NULL;
+}
+
+
+/* one primitive at one size on threads threads, aggregate MB/s plus the mean
+ * cycles per byte of a thread */
+static int SweepOne(SweepThread* t, int threads, double* mbps, double* cpb)
+{
+    double start, total, bytes;
+    word64 cycles = 0;
+    int    i, ret = 0;
+
+    start = current_time(1);
+
+#ifdef BENCH_THREADS
+    if (threads > 1) {
+        pthread_t tid[BENCH_MAX_THREADS];
+
+        for (i = 0; i < threads; i++) {
+            if (pthread_create(&tid[i], NULL, SweepRun, &t[i]) != 0) {
+                threads = i;
+                ret = -1;
+                break;
+            }
+        }
+        for (i = 0; i < threads; i++)
+            pthread_join(tid[i], NULL);
+    }
+    else
+#endif
+        SweepRun(&t[0]);
+
+    total = current_time(0) - start;
+
+    for (i = 0; i < threads; i++) {
+        if (t[i].ret != 0)
+            ret = t[i].ret;
+        cycles += t[i].cycles;
+    }
+
+    bytes = (double)t[0].sz * t[0].iters;
+    *mbps = total > 0 ? bytes * threads / total / (1024 * 1024) : 0;
+    *cpb  = bytes > 0 ? (double)cycles / threads / bytes : 0;
+
+    return ret;
+}
+
+
+static int bench_sweep(int threads, int format)
+{
+    SweepThread t[BENCH_MAX_THREADS];
+    int         first = 1;
+    int         a, i, s;
+    int         ret = 0;
+
+    XMEMSET(t, 0, sizeof(t));
+    for (i = 0; i < threads; i++) {
+        t[i].in  = (byte*)XMALLOC(SWEEP_MAX_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        t[i].out = (byte*)XMALLOC(SWEEP_MAX_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (t[i].in == NULL || t[i].out == NULL) {
+            ret = -1;
+            break;
+        }
+        XMEMSET(t[i].in, 0, SWEEP_MAX_SIZE);
+    }
+
+    if (format == SWEEP_CSV)
+        printf("algorithm,threads,bytes,iterations,MB/s,cycles/byte\n");
+    else if (format == SWEEP_JSON)
+        printf("[\n");
+
+    for (a = 0; ret == 0 && sweepAlgos[a].name != NULL; a++) {
+        for (s = 0; s < (int)(sizeof(sweepSizes)/sizeof(sweepSizes[0])); s++) {
+            word32 sz = sweepSizes[s];
+            double mbps, cpb;
+
+            if (sz % sweepAlgos[a].align)
+                continue;
+
+            for (i = 0; i < threads; i++) {
+                t[i].func  = sweepAlgos[a].func;
+                t[i].sz    = sz;
+                t[i].iters = SWEEP_BUDGET / sz;
+            }
+
+            ret = SweepOne(t, threads, &mbps, &cpb);
+            if (ret != 0) {
+                printf("%s %u byte run failed, ret = %d\n",
+                       sweepAlgos[a].name, sz, ret);
+                break;
+            }
+
+            if (format == SWEEP_CSV)
+                printf("%s,%d,%u,%d,%.3f,%.2f\n", sweepAlgos[a].name,
+                       threads, sz, t[0].iters, mbps, cpb);
+            else if (format == SWEEP_JSON) {
+                printf("%s  {\"algorithm\": \"%s\", \"threads\": %d, "
+                       "\"bytes\": %u, \"iterations\": %d, \"mbps\": %.3f, "
+                       "\"cycles_per_byte\": %.2f}", first ? "" : ",\n",
+                       sweepAlgos[a].name, threads, sz, t[0].iters, mbps, cpb);
+                first = 0;
+            }
+            else
+                printf("%-17s %2d threads %6u bytes %10.3f MB/s %8.2f "
+                       "cycles/byte\n", sweepAlgos[a].name, threads, sz,
+                       mbps, cpb);
+        }
+    }
+
+    if (format == SWEEP_JSON)
+        printf("\n]\n");
+
+    for (i = 0; i < threads; i++) {
+        XFREE(t[i].in,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(t[i].out, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+
+    return ret;
+}
+
+#endif /* BENCH_SWEEP */
+
 #ifdef _WIN32
 
     #define WIN32_LEAN_AND_MEAN
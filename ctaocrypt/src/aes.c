@@ -35,6 +35,10 @@
 #include <cyassl/ctaocrypt/aes.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/cpuid.h>
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 #ifdef NO_INLINE
     #include <cyassl/ctaocrypt/misc.h>
 #else
@@ -97,6 +101,24 @@
 
 #ifdef NEED_AES_TABLES
 
+/* vector permute fallback when the cpu has SSSE3 but AES-NI is absent or
+ * not built, replaces the cache timing dependent table rounds */
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_AES_VPERM)
+    #define AES_VPERM
+    #include <tmmintrin.h>
+#endif
+
+/* ARMv8 crypto extension rounds, AESE/AESMC and AESD/AESIMC */
+#ifdef HAVE_CYASSL_ARMV8_CRYPTO
+    #define AES_ARMV8
+    #include <arm_neon.h>
+#endif
+
+#if defined(AES_VPERM) || defined(AES_ARMV8)
+    #define AES_BLOCKS_SIMD
+    #define AES_SIMD_PAR 8    /* blocks interleaved per call */
+#endif
+
 static const word32 rcon[] = {
     0x01000000, 0x02000000, 0x04000000, 0x08000000,
     0x10000000, 0x20000000, 0x40000000, 0x80000000,
@@ -775,43 +797,17 @@ static const word32 Td[5][256] = {
 
 #ifdef CYASSL_AESNI
 
-/* Each platform needs to query info type 1 from cpuid to see if aesni is
- * supported. Also, let's setup a macro for proper linkage w/o ABI conflicts
+/* the cpu features come from the central probe in cpuid.c, let's setup a
+ * macro for proper linkage w/o ABI conflicts
  */
 
 #ifndef _MSC_VER
-
-    #define cpuid(reg, func)\
-        __asm__ __volatile__ ("cpuid":\
-             "=a" (reg[0]), "=b" (reg[1]), "=c" (reg[2]), "=d" (reg[3]) :\
-             "a" (func));
-
     #define XASM_LINK(f) asm(f)
 #else
-
-    #include <intrin.h>
-    #define cpuid(a,b) __cpuid((int*)a,b)
-
     #define XASM_LINK(f)
-
 #endif /* _MSC_VER */
 
 
-static int Check_CPU_support_AES(void)
-{
-    unsigned int reg[4];  /* put a,b,c,d into 0,1,2,3 */
-    cpuid(reg, 1);        /* query info 1 */
-
-    if (reg[2] & 0x2000000)
-        return 1;
-
-    return 0;
-}
-
-static int checkAESNI = 0;
-static int haveAESNI  = 0;
-
-
 /* tell C compiler these are asm functions in case any mix up of ABI underscore
    prefix between clang/gcc/llvm etc */
 void AES_CBC_encrypt(const unsigned char* in, unsigned char* out,
@@ -913,10 +909,428 @@ static int AES_set_decrypt_key(const unsigned char* userKey, const int bits,
 }
 
 
+/* CBC decrypt has no chain between blocks, 8 are kept in flight so the
+ * AESDEC latency is hidden behind the other streams, the asm interleaves
+ * 4. ks is the AES_set_decrypt_key schedule, ivec is updated. All of a
+ * batch is loaded before any of it is stored so in may equal out. */
+#define AESNI_DEC8(op, k)                      \
+    do {                                       \
+        s0 = op(s0, k); s1 = op(s1, k);        \
+        s2 = op(s2, k); s3 = op(s3, k);        \
+        s4 = op(s4, k); s5 = op(s5, k);        \
+        s6 = op(s6, k); s7 = op(s7, k);        \
+    } while (0)
+
+static void AesCbcDecrypt8(const byte* in, byte* out, byte* ivec,
+                           word32 blocks, const byte* ks, int nr)
+{
+    const __m128i* rk = (const __m128i*)ks;
+    const __m128i* pin = (const __m128i*)in;
+    __m128i*       pout = (__m128i*)out;
+    __m128i        iv = _mm_loadu_si128((const __m128i*)ivec);
+    __m128i        c0, c1, c2, c3, c4, c5, c6, c7;
+    __m128i        s0, s1, s2, s3, s4, s5, s6, s7;
+    int            r;
+
+    for (; blocks >= 8; blocks -= 8, pin += 8, pout += 8) {
+        c0 = _mm_loadu_si128(pin + 0);
+        c1 = _mm_loadu_si128(pin + 1);
+        c2 = _mm_loadu_si128(pin + 2);
+        c3 = _mm_loadu_si128(pin + 3);
+        c4 = _mm_loadu_si128(pin + 4);
+        c5 = _mm_loadu_si128(pin + 5);
+        c6 = _mm_loadu_si128(pin + 6);
+        c7 = _mm_loadu_si128(pin + 7);
+
+        s0 = c0; s1 = c1; s2 = c2; s3 = c3;
+        s4 = c4; s5 = c5; s6 = c6; s7 = c7;
+        AESNI_DEC8(_mm_xor_si128, rk[0]);
+        for (r = 1; r < nr; r++)
+            AESNI_DEC8(_mm_aesdec_si128, rk[r]);
+        AESNI_DEC8(_mm_aesdeclast_si128, rk[nr]);
+
+        _mm_storeu_si128(pout + 0, _mm_xor_si128(s0, iv));
+        _mm_storeu_si128(pout + 1, _mm_xor_si128(s1, c0));
+        _mm_storeu_si128(pout + 2, _mm_xor_si128(s2, c1));
+        _mm_storeu_si128(pout + 3, _mm_xor_si128(s3, c2));
+        _mm_storeu_si128(pout + 4, _mm_xor_si128(s4, c3));
+        _mm_storeu_si128(pout + 5, _mm_xor_si128(s5, c4));
+        _mm_storeu_si128(pout + 6, _mm_xor_si128(s6, c5));
+        _mm_storeu_si128(pout + 7, _mm_xor_si128(s7, c6));
+        iv = c7;
+    }
+
+    for (; blocks > 0; blocks--, pin++, pout++) {
+        c0 = _mm_loadu_si128(pin);
+        s0 = _mm_xor_si128(c0, rk[0]);
+        for (r = 1; r < nr; r++)
+            s0 = _mm_aesdec_si128(s0, rk[r]);
+        s0 = _mm_aesdeclast_si128(s0, rk[nr]);
+        _mm_storeu_si128(pout, _mm_xor_si128(s0, iv));
+        iv = c0;
+    }
+
+    _mm_storeu_si128((__m128i*)ivec, iv);
+}
+
+
+/* VAES does four blocks per 512 bit register, four registers give 16 in
+ * flight. Each block's chaining value is the ciphertext one to its left,
+ * taken from the registers rather than reloaded since in may equal out.
+ * gcc 8 and clang 6 are the first to know the vaes target. */
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_AES_VAES) && \
+    (defined(__clang__) ? __clang_major__ >= 6 : __GNUC__ >= 8)
+    #define AES_VAES
+    #include <immintrin.h>
+
+#define VAES_DEC4(op, k)                       \
+    do {                                       \
+        s0 = op(s0, k); s1 = op(s1, k);        \
+        s2 = op(s2, k); s3 = op(s3, k);        \
+    } while (0)
+
+CYASSL_TARGET("vaes,avx512f")
+static void AesCbcDecryptVaes(const byte* in, byte* out, byte* ivec,
+                              word32 blocks, const byte* ks, int nr)
+{
+    const __m128i* rk = (const __m128i*)ks;
+    __m512i        k[15];
+    __m512i        prev, c0, c1, c2, c3, s0, s1, s2, s3;
+    int            r;
+
+    for (r = 0; r <= nr; r++)
+        k[r] = _mm512_broadcast_i32x4(_mm_loadu_si128(rk + r));
+
+    /* only the top lane of prev is read, the previous ciphertext block */
+    prev = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)ivec));
+
+    for (; blocks >= 16; blocks -= 16, in += 256, out += 256) {
+        c0 = _mm512_loadu_si512((const void*)(in +   0));
+        c1 = _mm512_loadu_si512((const void*)(in +  64));
+        c2 = _mm512_loadu_si512((const void*)(in + 128));
+        c3 = _mm512_loadu_si512((const void*)(in + 192));
+
+        s0 = c0; s1 = c1; s2 = c2; s3 = c3;
+        VAES_DEC4(_mm512_xor_si512, k[0]);
+        for (r = 1; r < nr; r++)
+            VAES_DEC4(_mm512_aesdec_epi128, k[r]);
+        VAES_DEC4(_mm512_aesdeclast_epi128, k[nr]);
+
+        /* alignr by 6 quadwords: top block of the left register, then the
+         * low three of the right */
+        s0 = _mm512_xor_si512(s0, _mm512_alignr_epi64(c0, prev, 6));
+        s1 = _mm512_xor_si512(s1, _mm512_alignr_epi64(c1, c0, 6));
+        s2 = _mm512_xor_si512(s2, _mm512_alignr_epi64(c2, c1, 6));
+        s3 = _mm512_xor_si512(s3, _mm512_alignr_epi64(c3, c2, 6));
+
+        _mm512_storeu_si512((void*)(out +   0), s0);
+        _mm512_storeu_si512((void*)(out +  64), s1);
+        _mm512_storeu_si512((void*)(out + 128), s2);
+        _mm512_storeu_si512((void*)(out + 192), s3);
+        prev = c3;
+    }
+
+    _mm_storeu_si128((__m128i*)ivec, _mm512_extracti32x4_epi32(prev, 3));
+
+    if (blocks)
+        AesCbcDecrypt8(in, out, ivec, blocks, ks, nr);
+}
+
+#endif /* HAVE_CYASSL_X86_SIMD && !NO_AES_VAES */
+
 
 #endif /* CYASSL_AESNI */
 
 
+#ifdef AES_VPERM
+
+/* Constant time AES for x86 without AES-NI, SSSE3 pshufb does every S-box
+ * lookup from registers. Bytes are taken to GF((2^4)^2) by a linear map,
+ * inverted there with 16 entry log/exp tables (a zero log is 0xe0 so any
+ * sum with it indexes past the table and pshufb yields 0), and mapped back
+ * with the affine step folded in. Tables are derived offline and checked
+ * against Te[4]/Td[4] for every byte. */
+
+enum {
+    VP_ENC_IN = 0, VP_ENC_OUT = 2, VP_DEC_IN = 4, VP_DEC_OUT = 6,
+    VP_LOG = 8, VP_NLOG, VP_SQL, VP_SQ, VP_EXPLO, VP_EXPHI, VP_TABLES
+};
+
+static const ALIGN16 byte vpTables[VP_TABLES][AES_BLOCK_SIZE] = {
+    /* enc in lo */
+    { 0x00, 0x01, 0x20, 0x21, 0x46, 0x47, 0x66, 0x67,
+      0x4c, 0x4d, 0x6c, 0x6d, 0x0a, 0x0b, 0x2a, 0x2b },
+    /* enc in hi */
+    { 0x00, 0x3c, 0xd5, 0xe9, 0x34, 0x08, 0xe1, 0xdd,
+      0xe5, 0xd9, 0x30, 0x0c, 0xd1, 0xed, 0x04, 0x38 },
+    /* enc out lo */
+    { 0x63, 0x7c, 0xd1, 0xce, 0xc8, 0xd7, 0x7a, 0x65,
+      0x55, 0x4a, 0xe7, 0xf8, 0xfe, 0xe1, 0x4c, 0x53 },
+    /* enc out hi */
+    { 0x00, 0x52, 0x3e, 0x6c, 0x65, 0x37, 0x5b, 0x09,
+      0x60, 0x32, 0x5e, 0x0c, 0x05, 0x57, 0x3b, 0x69 },
+    /* dec in lo */
+    { 0x47, 0x1f, 0xd8, 0x80, 0xdf, 0x87, 0x40, 0x18,
+      0x6f, 0x37, 0xf0, 0xa8, 0xf7, 0xaf, 0x68, 0x30 },
+    /* dec in hi */
+    { 0x00, 0x76, 0x79, 0x0f, 0xf9, 0x8f, 0x80, 0xf6,
+      0x92, 0xe4, 0xeb, 0x9d, 0x6b, 0x1d, 0x12, 0x64 },
+    /* dec out lo */
+    { 0x00, 0x01, 0x5c, 0x5d, 0xe0, 0xe1, 0xbc, 0xbd,
+      0x50, 0x51, 0x0c, 0x0d, 0xb0, 0xb1, 0xec, 0xed },
+    /* dec out hi */
+    { 0x00, 0xa2, 0x02, 0xa0, 0xb8, 0x1a, 0xba, 0x18,
+      0xdb, 0x79, 0xd9, 0x7b, 0x63, 0xc1, 0x61, 0xc3 },
+    /* log */
+    { 0xe0, 0x00, 0x01, 0x04, 0x02, 0x08, 0x05, 0x0a,
+      0x03, 0x0e, 0x09, 0x07, 0x06, 0x0d, 0x0b, 0x0c },
+    /* -log */
+    { 0xe0, 0x00, 0x0e, 0x0b, 0x0d, 0x07, 0x0a, 0x05,
+      0x0c, 0x01, 0x06, 0x08, 0x09, 0x02, 0x04, 0x03 },
+    /* lambda a^2 */
+    { 0x00, 0x08, 0x06, 0x0e, 0x0b, 0x03, 0x0d, 0x05,
+      0x0a, 0x02, 0x0c, 0x04, 0x01, 0x09, 0x07, 0x0f },
+    /* b^2 */
+    { 0x00, 0x01, 0x04, 0x05, 0x03, 0x02, 0x07, 0x06,
+      0x0c, 0x0d, 0x08, 0x09, 0x0f, 0x0e, 0x0b, 0x0a },
+    /* exp 0..15 */
+    { 0x01, 0x02, 0x04, 0x08, 0x03, 0x06, 0x0c, 0x0b,
+      0x05, 0x0a, 0x07, 0x0e, 0x0f, 0x0d, 0x09, 0x01 },
+    /* exp 16..31 */
+    { 0x02, 0x04, 0x08, 0x03, 0x06, 0x0c, 0x0b, 0x05,
+      0x0a, 0x07, 0x0e, 0x0f, 0x0d, 0x09, 0x01, 0x02 }
+};
+
+
+/* 16 way vector of nibble exps of s, s is up to two logs added */
+CYASSL_TARGET("ssse3")
+static INLINE __m128i VpExp(const __m128i* k, __m128i s)
+{
+    return _mm_xor_si128(
+        _mm_shuffle_epi8(k[VP_EXPLO], _mm_adds_epu8(s, _mm_set1_epi8(0x70))),
+        _mm_shuffle_epi8(k[VP_EXPHI], _mm_sub_epi8(s, _mm_set1_epi8(0x10))));
+}
+
+
+/* S-box (dir VP_ENC_IN) or inverse S-box (VP_DEC_IN) on all 16 bytes */
+CYASSL_TARGET("ssse3")
+static INLINE __m128i VpSubBytes(const __m128i* k, __m128i x, int dir)
+{
+    const __m128i nib = _mm_set1_epi8(0x0f);
+    __m128i t, a, b, la, ld, d;
+
+    t = _mm_xor_si128(
+        _mm_shuffle_epi8(k[dir], _mm_and_si128(x, nib)),
+        _mm_shuffle_epi8(k[dir + 1], _mm_and_si128(_mm_srli_epi16(x, 4), nib)));
+    a = _mm_and_si128(_mm_srli_epi16(t, 4), nib);
+    b = _mm_and_si128(t, nib);
+    x = _mm_xor_si128(a, b);
+
+    /* (aY + b)^-1 = (aY + a + b) / (lambda a^2 + ab + b^2) */
+    la = _mm_shuffle_epi8(k[VP_LOG], a);
+    d  = VpExp(k, _mm_add_epi8(la, _mm_shuffle_epi8(k[VP_LOG], b)));
+    d  = _mm_xor_si128(d, _mm_xor_si128(_mm_shuffle_epi8(k[VP_SQL], a),
+                                        _mm_shuffle_epi8(k[VP_SQ], b)));
+    ld = _mm_shuffle_epi8(k[VP_NLOG], d);
+    a  = VpExp(k, _mm_add_epi8(la, ld));
+    b  = VpExp(k, _mm_add_epi8(_mm_shuffle_epi8(k[VP_LOG], x), ld));
+
+    return _mm_xor_si128(_mm_shuffle_epi8(k[dir + VP_ENC_OUT], b),
+                         _mm_shuffle_epi8(k[dir + VP_ENC_OUT + 1], a));
+}
+
+
+CYASSL_TARGET("ssse3")
+static INLINE __m128i VpMixColumns(__m128i x)
+{
+    const __m128i rot1 = _mm_setr_epi8(1,2,3,0, 5,6,7,4, 9,10,11,8,
+                                       13,14,15,12);
+    const __m128i rot2 = _mm_setr_epi8(2,3,0,1, 6,7,4,5, 10,11,8,9,
+                                       14,15,12,13);
+    __m128i x2 = _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(
+                     _mm_cmplt_epi8(x, _mm_setzero_si128()),
+                     _mm_set1_epi8(0x1b)));
+    __m128i t  = _mm_xor_si128(x, _mm_shuffle_epi8(x, rot1));
+
+    /* 2a0 ^ 3a1 ^ a2 ^ a3 = 2a0 ^ (2a1 ^ a1) ^ (a2 ^ a3) */
+    return _mm_xor_si128(_mm_xor_si128(x2, _mm_shuffle_epi8(
+                                           _mm_xor_si128(x2, x), rot1)),
+                         _mm_shuffle_epi8(t, rot2));
+}
+
+
+CYASSL_TARGET("ssse3")
+static INLINE __m128i VpInvMixColumns(__m128i x)
+{
+    const __m128i rot2 = _mm_setr_epi8(2,3,0,1, 6,7,4,5, 10,11,8,9,
+                                       14,15,12,13);
+    const __m128i poly = _mm_set1_epi8(0x1b);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i u = _mm_xor_si128(x, _mm_shuffle_epi8(x, rot2));
+
+    /* a0 ^= 4(a0 ^ a2), a1 ^= 4(a1 ^ a3), ... then MixColumns */
+    u = _mm_xor_si128(_mm_add_epi8(u, u),
+                      _mm_and_si128(_mm_cmplt_epi8(u, zero), poly));
+    u = _mm_xor_si128(_mm_add_epi8(u, u),
+                      _mm_and_si128(_mm_cmplt_epi8(u, zero), poly));
+
+    return VpMixColumns(_mm_xor_si128(x, u));
+}
+
+
+/* n (1..AES_SIMD_PAR) blocks with the Td/Te style round keys in aes->key */
+CYASSL_TARGET("ssse3")
+static void AesCryptBlocksVp(const Aes* aes, const byte* in, byte* out,
+                             word32 n, int dir)
+{
+    const __m128i bswap = _mm_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8,
+                                        15,14,13,12);
+    const int     io    = (dir == AES_ENCRYPTION) ? VP_ENC_IN : VP_DEC_IN;
+    const __m128i shift = (io == VP_ENC_IN) ?
+        _mm_setr_epi8(0,5,10,15, 4,9,14,3, 8,13,2,7, 12,1,6,11) :
+        _mm_setr_epi8(0,13,10,7, 4,1,14,11, 8,5,2,15, 12,9,6,3);
+    const word32* rk = aes->key;
+    __m128i k[VP_TABLES];
+    __m128i s[AES_SIMD_PAR];
+    __m128i key;
+    word32  i, r;
+
+    for (i = 0; i < VP_TABLES; i++)
+        k[i] = _mm_load_si128((const __m128i*)vpTables[i]);
+
+    key = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)rk), bswap);
+    for (i = 0; i < n; i++)
+        s[i] = _mm_xor_si128(key, _mm_loadu_si128(
+                                  (const __m128i*)(in + i * AES_BLOCK_SIZE)));
+
+    for (r = 1; r <= aes->rounds; r++) {
+        rk += 4;
+        key = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)rk), bswap);
+        for (i = 0; i < n; i++) {
+            __m128i x = VpSubBytes(k, _mm_shuffle_epi8(s[i], shift), io);
+            if (r != aes->rounds)
+                x = (io == VP_ENC_IN) ? VpMixColumns(x) : VpInvMixColumns(x);
+            s[i] = _mm_xor_si128(x, key);
+        }
+    }
+
+    for (i = 0; i < n; i++)
+        _mm_storeu_si128((__m128i*)(out + i * AES_BLOCK_SIZE), s[i]);
+}
+
+
+
+#endif /* AES_VPERM */
+
+
+#ifdef AES_ARMV8
+
+/* n (1..AES_SIMD_PAR) blocks, the byte order round keys are the same for
+ * AESE and for AESD with the equivalent inverse schedule AesSetKey made */
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static void AesCryptBlocksArm(const Aes* aes, const byte* in, byte* out,
+                              word32 n, int dir)
+{
+    uint8x16_t rk[15];
+    uint8x16_t s[AES_SIMD_PAR];
+    word32     last = aes->rounds - 1;
+    word32     i, r;
+
+    for (r = 0; r <= aes->rounds; r++)
+        rk[r] = vrev32q_u8(vld1q_u8((const byte*)(aes->key + 4 * r)));
+
+    for (i = 0; i < n; i++)
+        s[i] = vld1q_u8(in + i * AES_BLOCK_SIZE);
+
+    if (dir == AES_ENCRYPTION) {
+        for (r = 0; r < last; r++)
+            for (i = 0; i < n; i++)
+                s[i] = vaesmcq_u8(vaeseq_u8(s[i], rk[r]));
+        for (i = 0; i < n; i++)
+            s[i] = veorq_u8(vaeseq_u8(s[i], rk[last]), rk[last + 1]);
+    }
+    else {
+        for (r = 0; r < last; r++)
+            for (i = 0; i < n; i++)
+                s[i] = vaesimcq_u8(vaesdq_u8(s[i], rk[r]));
+        for (i = 0; i < n; i++)
+            s[i] = veorq_u8(vaesdq_u8(s[i], rk[last]), rk[last + 1]);
+    }
+
+    for (i = 0; i < n; i++)
+        vst1q_u8(out + i * AES_BLOCK_SIZE, s[i]);
+}
+
+#endif /* AES_ARMV8 */
+
+
+#ifdef AES_BLOCKS_SIMD
+
+typedef void (*AesBlocksFunc)(const Aes* aes, const byte* in, byte* out,
+                              word32 n, int dir);
+
+/* constant time block function this cpu has, NULL for the tables */
+static INLINE AesBlocksFunc AesGetBlocks(void)
+{
+    word32 cpu = CyaSSL_GetCpuFeatures();
+
+#ifdef AES_ARMV8
+    if (cpu & CYASSL_CPU_ARM_AES)
+        return AesCryptBlocksArm;
+#endif
+#ifdef AES_VPERM
+    if (cpu & CYASSL_CPU_SSSE3)
+        return AesCryptBlocksVp;
+#endif
+    (void)cpu;
+
+    return NULL;
+}
+
+
+#if defined(HAVE_AESGCM) || defined(CYASSL_AES_COUNTER)
+
+/* counter mode, AES_SIMD_PAR blocks at a time while at least that many
+ * remain, inc steps ctr before (GCM) or after (CTR) each use, returns blocks
+ * done */
+static word32 AesCtrBlocksSimd(const Aes* aes, byte* ctr, void (*inc)(byte*),
+                               int preInc, byte* out, const byte* in,
+                               word32 blocks)
+{
+    AesBlocksFunc blocksFunc = AesGetBlocks();
+    byte          ctrs[AES_SIMD_PAR * AES_BLOCK_SIZE];
+    word32        done = 0;
+    word32        i;
+
+    if (blocksFunc == NULL)
+        return 0;
+
+    while (blocks - done >= AES_SIMD_PAR) {
+        for (i = 0; i < AES_SIMD_PAR; i++) {
+            if (preInc)
+                inc(ctr);
+            XMEMCPY(ctrs + i * AES_BLOCK_SIZE, ctr, AES_BLOCK_SIZE);
+            if (!preInc)
+                inc(ctr);
+        }
+        blocksFunc(aes, ctrs, ctrs, AES_SIMD_PAR, AES_ENCRYPTION);
+        xorbuf(ctrs, in, sizeof(ctrs));
+        XMEMCPY(out, ctrs, sizeof(ctrs));
+
+        in   += sizeof(ctrs);
+        out  += sizeof(ctrs);
+        done += AES_SIMD_PAR;
+    }
+    XMEMSET(ctrs, 0, sizeof(ctrs));
+
+    return done;
+}
+
+#endif /* HAVE_AESGCM || CYASSL_AES_COUNTER */
+
+#endif /* AES_BLOCKS_SIMD */
+
+
 static void AesEncrypt(Aes* aes, const byte* inBlock, byte* outBlock)
 {
     word32 s0, s1, s2, s3;
@@ -929,7 +1343,7 @@ static void AesEncrypt(Aes* aes, const byte* inBlock, byte* outBlock)
         return;  /* stop instead of segfaulting, set up your keys! */
     }
 #ifdef CYASSL_AESNI
-    if (haveAESNI && aes->use_aesni) {
+    if (aes->use_aesni) {
         #ifdef DEBUG_AESNI
             printf("about to aes encrypt\n");
             printf("in  = %p\n", inBlock);
@@ -970,6 +1384,16 @@ static void AesEncrypt(Aes* aes, const byte* inBlock, byte* outBlock)
     }
 #endif
 
+#ifdef AES_BLOCKS_SIMD
+    {
+        AesBlocksFunc blocksFunc = AesGetBlocks();
+        if (blocksFunc) {
+            blocksFunc(aes, inBlock, outBlock, 1, AES_ENCRYPTION);
+            return;
+        }
+    }
+#endif
+
     /*
      * map byte array block to cipher state
      * and add initial round key:
@@ -1108,7 +1532,7 @@ static void AesDecrypt(Aes* aes, const byte* inBlock, byte* outBlock)
         return;  /* stop instead of segfaulting, set up your keys! */
     }
 #ifdef CYASSL_AESNI
-    if (haveAESNI && aes->use_aesni) {
+    if (aes->use_aesni) {
         #ifdef DEBUG_AESNI
             printf("about to aes decrypt\n");
             printf("in  = %p\n", inBlock);
@@ -1131,6 +1555,16 @@ static void AesDecrypt(Aes* aes, const byte* inBlock, byte* outBlock)
     }
 #endif
 
+#ifdef AES_BLOCKS_SIMD
+    {
+        AesBlocksFunc blocksFunc = AesGetBlocks();
+        if (blocksFunc) {
+            blocksFunc(aes, inBlock, outBlock, 1, AES_DECRYPTION);
+            return;
+        }
+    }
+#endif
+
     /*
      * map byte array block to cipher state
      * and add initial round key:
@@ -1529,12 +1963,14 @@ static void AesDecrypt(Aes* aes, const byte* inBlock, byte* outBlock)
         #endif
 
         #ifdef CYASSL_AESNI
-        if (checkAESNI == 0) {
-            haveAESNI  = Check_CPU_support_AES();
-            checkAESNI = 1;
-        }
-        if (haveAESNI) {
+        if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_AESNI) {
             aes->use_aesni = 1;
+            #ifdef CYASSL_AES_COUNTER
+                aes->left = 0;
+            #endif
+            aes->use_vaes  = (CyaSSL_GetCpuFeatures() &
+                              (CYASSL_CPU_VAES | CYASSL_CPU_AVX512F)) ==
+                                          (CYASSL_CPU_VAES | CYASSL_CPU_AVX512F);
             if (iv)
                 XMEMCPY(aes->reg, iv, AES_BLOCK_SIZE);
             if (dir == AES_ENCRYPTION)
@@ -1549,11 +1985,11 @@ static void AesDecrypt(Aes* aes, const byte* inBlock, byte* outBlock)
 
     #if defined(CYASSL_AES_DIRECT) || defined(CYASSL_AES_COUNTER)
 
-    /* AES-CTR and AES-DIRECT need to use this for key setup, no aesni yet */
+    /* AES-CTR and AES-DIRECT need to use this for key setup */
     int AesSetKeyDirect(Aes* aes, const byte* userKey, word32 keylen,
                         const byte* iv, int dir)
     {
-        return AesSetKeyLocal(aes, userKey, keylen, iv, dir);
+        return AesSetKey(aes, userKey, keylen, iv, dir);
     }
 
     #endif /* CYASSL_AES_DIRECT || CYASSL_AES_COUNTER */
@@ -2059,20 +2495,22 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
     }
 
 #elif defined(CYASSL_PIC32MZ_CRYPT)
-    /* core hardware crypt engine driver */
-    static void AesCrypt(Aes *aes, byte* out, const byte* in, word32 sz,
+    /* core hardware crypt engine driver, one job of up to PIC32MZ_MAX_BD
+       chained descriptors of PIC32MZ_MAX_BUFLEN each */
+    static void AesCryptChain(Aes *aes, byte* out, const byte* in, word32 sz,
                                             int dir, int algo, int cryptoalgo)
     {
         securityAssociation *sa_p ;
         bufferDescriptor *bd_p ;
 
         volatile securityAssociation sa __attribute__((aligned (8)));
-        volatile bufferDescriptor bd __attribute__((aligned (8)));
+        volatile bufferDescriptor bd[PIC32MZ_MAX_BD] __attribute__((aligned (8)));
         volatile int k ;
+        word32 left, len, padded ;
+        int n ;
 
         /* get uncached address */
         sa_p = KVA0_TO_KVA1(&sa) ;
-        bd_p = KVA0_TO_KVA1(&bd) ;
 
         /* Sync cache and physical memory */
         if(PIC32MZ_IF_RAM(in)) {
@@ -2109,28 +2547,40 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
         ByteReverseWords(
         (word32*)KVA0_TO_KVA1(sa.SA_ENCIV), (word32 *)aes->iv_ce, 16);
 
-        XMEMSET((byte *)KVA0_TO_KVA1(&bd), 0, sizeof(bd));
-        /* Set up the Buffer Descriptor */
-        bd_p->BD_CTRL.BUFLEN = sz;
+        XMEMSET((byte *)KVA0_TO_KVA1(bd), 0, sizeof(bd));
+        /* Set up the Buffer Descriptors, the engine walks NXTPTR and only
+           fetches the SA for the first, the last ends the message */
+        padded = sz ;
         if(cryptoalgo == PIC32_CRYPTOALGO_AES_GCM) {
             if(sz % 0x10)
-                bd_p->BD_CTRL.BUFLEN = (sz/0x10 + 1) * 0x10 ;
+                padded = (sz/0x10 + 1) * 0x10 ;
+        }
+        n = 0 ;
+        bd_p = KVA0_TO_KVA1(&bd[0]) ;
+        for (left = padded; left > 0 && n < PIC32MZ_MAX_BD; left -= len) {
+            len = left > PIC32MZ_MAX_BUFLEN ? PIC32MZ_MAX_BUFLEN : left ;
+            bd_p = KVA0_TO_KVA1(&bd[n]) ;
+            bd_p->BD_CTRL.BUFLEN = len;
+            bd_p->BD_CTRL.DESC_EN = 1;
+            bd_p->SA_ADDR = (unsigned int)KVA_TO_PA(&sa) ;
+            bd_p->SRCADDR = (unsigned int)KVA_TO_PA(in + (padded - left)) ;
+            bd_p->DSTADDR = (unsigned int)KVA_TO_PA(out + (padded - left));
+            bd_p->MSGLEN = sz ;
+            if (n == 0)
+                bd_p->BD_CTRL.SA_FETCH_EN = 1;
+            else
+                ((bufferDescriptor *)KVA0_TO_KVA1(&bd[n-1]))->NXTPTR =
+                                          (unsigned int)KVA_TO_PA(&bd[n]) ;
+            n++ ;
         }
         bd_p->BD_CTRL.LIFM = 1;
-        bd_p->BD_CTRL.SA_FETCH_EN = 1;
         bd_p->BD_CTRL.LAST_BD = 1;
-        bd_p->BD_CTRL.DESC_EN = 1;
-
-        bd_p->SA_ADDR = (unsigned int)KVA_TO_PA(&sa) ;
-        bd_p->SRCADDR = (unsigned int)KVA_TO_PA(in) ;
-        bd_p->DSTADDR = (unsigned int)KVA_TO_PA(out);
-        bd_p->MSGLEN = sz ;
 
         CECON = 1 << 6;
         while (CECON);
 
         /* Run the engine */
-        CEBDPADDR = (unsigned int)KVA_TO_PA(&bd) ;
+        CEBDPADDR = (unsigned int)KVA_TO_PA(&bd[0]) ;
         CEINTEN = 0x07;
         CECON = 0x27;
 
@@ -2154,6 +2604,24 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
         ByteReverseWords((word32*)out, (word32 *)out, sz);
     }
 
+    /* CBC longer than one chain runs as several jobs, each leaves iv_ce
+       at the last cipher block. GCM is record sized, a single job. */
+    static void AesCrypt(Aes *aes, byte* out, const byte* in, word32 sz,
+                                            int dir, int algo, int cryptoalgo)
+    {
+        const word32 maxJob = PIC32MZ_MAX_BD * PIC32MZ_MAX_BUFLEN ;
+
+        if (cryptoalgo != PIC32_CRYPTOALGO_AES_GCM) {
+            while (sz > maxJob) {
+                AesCryptChain(aes, out, in, maxJob, dir, algo, cryptoalgo) ;
+                in  += maxJob ;
+                out += maxJob ;
+                sz  -= maxJob ;
+            }
+        }
+        AesCryptChain(aes, out, in, sz, dir, algo, cryptoalgo) ;
+    }
+
     int AesCbcEncrypt(Aes* aes, byte* out, const byte* in, word32 sz)
     {
         AesCrypt(aes, out, in, sz, PIC32_ENCRYPTION, PIC32_ALGO_AES,
@@ -2179,7 +2647,7 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
     #endif
 
     #ifdef CYASSL_AESNI
-        if (haveAESNI) {
+        if (aes->use_aesni) {
             #ifdef DEBUG_AESNI
                 printf("about to aes cbc encrypt\n");
                 printf("in  = %p\n", in);
@@ -2242,7 +2710,7 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
     #endif
 
     #ifdef CYASSL_AESNI
-        if (haveAESNI) {
+        if (aes->use_aesni) {
             #ifdef DEBUG_AESNI
                 printf("about to aes cbc decrypt\n");
                 printf("in  = %p\n", in);
@@ -2253,12 +2721,15 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
                 printf("sz = %d\n", sz);
             #endif
 
-            /* if input and output same will overwrite input iv */
-            XMEMCPY(aes->tmp, in + sz - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
-            AES_CBC_decrypt(in, out, (byte*)aes->reg, sz, (byte*)aes->key,
-                            aes->rounds);
-            /* store iv for next call */
-            XMEMCPY(aes->reg, aes->tmp, AES_BLOCK_SIZE);
+        #ifdef AES_VAES
+            if (aes->use_vaes) {
+                AesCbcDecryptVaes(in, out, (byte*)aes->reg, blocks,
+                                  (byte*)aes->key, aes->rounds);
+                return 0;
+            }
+        #endif
+            AesCbcDecrypt8(in, out, (byte*)aes->reg, blocks, (byte*)aes->key,
+                           aes->rounds);
             return 0;
         }
     #endif
@@ -2462,6 +2933,112 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
             }
         }
 
+    #ifdef CYASSL_AESNI
+
+        #include <tmmintrin.h>
+
+        #define AESNI_CTR_PAR 8
+
+        #define AESNI_ENC8(op, k)                      \
+            do {                                       \
+                b0 = op(b0, k); b1 = op(b1, k);        \
+                b2 = op(b2, k); b3 = op(b3, k);        \
+                b4 = op(b4, k); b5 = op(b5, k);        \
+                b6 = op(b6, k); b7 = op(b7, k);        \
+            } while (0)
+
+        /* the big endian 128 bit counter plus one, x is byte swapped */
+        static INLINE __m128i AesNiCtrInc(__m128i x)
+        {
+            x = _mm_add_epi64(x, _mm_set_epi64x(0, 1));
+            if (_mm_cvtsi128_si64(x) == 0)
+                x = _mm_add_epi64(x, _mm_set_epi64x(1, 0));
+
+            return x;
+        }
+
+        /* whole blocks of CTR with AESNI_CTR_PAR counters through the rounds
+         * at once. The counter is kept byte swapped so the next ones are 64
+         * bit lane adds, only a batch that would carry out of the low half
+         * steps one block at a time. aes->reg is left at the next counter */
+        static void AesNiCtrBlocks(Aes* aes, byte* out, const byte* in,
+                                   word32 blocks)
+        {
+            const __m128i* rk    = (const __m128i*)aes->key;
+            const int      nr    = (int)aes->rounds;
+            const __m128i  bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8,
+                                                9, 10, 11, 12, 13, 14, 15);
+            const __m128i* pin   = (const __m128i*)in;
+            __m128i*       pout  = (__m128i*)out;
+            __m128i        cnt, b0, b1, b2, b3, b4, b5, b6, b7;
+            int            r;
+
+            cnt = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)aes->reg), bswap);
+
+            for (; blocks >= AESNI_CTR_PAR; blocks -= AESNI_CTR_PAR,
+                             pin += AESNI_CTR_PAR, pout += AESNI_CTR_PAR) {
+                if ((word64)_mm_cvtsi128_si64(cnt) <=
+                                        (word64)0 - 1 - AESNI_CTR_PAR) {
+                    b0 = cnt;
+                    b1 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 1));
+                    b2 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 2));
+                    b3 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 3));
+                    b4 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 4));
+                    b5 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 5));
+                    b6 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 6));
+                    b7 = _mm_add_epi64(cnt, _mm_set_epi64x(0, 7));
+                    cnt = _mm_add_epi64(cnt, _mm_set_epi64x(0, 8));
+                }
+                else {
+                    b0 = cnt;
+                    b1 = AesNiCtrInc(b0);
+                    b2 = AesNiCtrInc(b1);
+                    b3 = AesNiCtrInc(b2);
+                    b4 = AesNiCtrInc(b3);
+                    b5 = AesNiCtrInc(b4);
+                    b6 = AesNiCtrInc(b5);
+                    b7 = AesNiCtrInc(b6);
+                    cnt = AesNiCtrInc(b7);
+                }
+
+                AESNI_ENC8(_mm_shuffle_epi8, bswap);
+                AESNI_ENC8(_mm_xor_si128, rk[0]);
+                for (r = 1; r < nr; r++)
+                    AESNI_ENC8(_mm_aesenc_si128, rk[r]);
+                AESNI_ENC8(_mm_aesenclast_si128, rk[nr]);
+
+                _mm_storeu_si128(pout + 0,
+                                 _mm_xor_si128(b0, _mm_loadu_si128(pin + 0)));
+                _mm_storeu_si128(pout + 1,
+                                 _mm_xor_si128(b1, _mm_loadu_si128(pin + 1)));
+                _mm_storeu_si128(pout + 2,
+                                 _mm_xor_si128(b2, _mm_loadu_si128(pin + 2)));
+                _mm_storeu_si128(pout + 3,
+                                 _mm_xor_si128(b3, _mm_loadu_si128(pin + 3)));
+                _mm_storeu_si128(pout + 4,
+                                 _mm_xor_si128(b4, _mm_loadu_si128(pin + 4)));
+                _mm_storeu_si128(pout + 5,
+                                 _mm_xor_si128(b5, _mm_loadu_si128(pin + 5)));
+                _mm_storeu_si128(pout + 6,
+                                 _mm_xor_si128(b6, _mm_loadu_si128(pin + 6)));
+                _mm_storeu_si128(pout + 7,
+                                 _mm_xor_si128(b7, _mm_loadu_si128(pin + 7)));
+            }
+
+            for (; blocks > 0; blocks--, pin++, pout++) {
+                b0  = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), rk[0]);
+                cnt = AesNiCtrInc(cnt);
+                for (r = 1; r < nr; r++)
+                    b0 = _mm_aesenc_si128(b0, rk[r]);
+                b0 = _mm_aesenclast_si128(b0, rk[nr]);
+                _mm_storeu_si128(pout, _mm_xor_si128(b0, _mm_loadu_si128(pin)));
+            }
+
+            _mm_storeu_si128((__m128i*)aes->reg, _mm_shuffle_epi8(cnt, bswap));
+        }
+
+    #endif /* CYASSL_AESNI */
+
         void AesCtrEncrypt(Aes* aes, byte* out, const byte* in, word32 sz)
         {
             byte* tmp = (byte*)aes->tmp + AES_BLOCK_SIZE - aes->left;
@@ -2473,11 +3050,35 @@ int AesCbcDecryptWithKey(byte* out, const byte* in, word32 inSz,
                sz--;
             }
 
+        #ifdef CYASSL_AESNI
+            if (aes->use_aesni) {
+                word32 done = sz / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+
+                AesNiCtrBlocks(aes, out, in, sz / AES_BLOCK_SIZE);
+                out += done;
+                in  += done;
+                sz  -= done;
+            }
+        #endif
+
+        #ifdef AES_BLOCKS_SIMD
+            {
+                word32 done = AesCtrBlocksSimd(aes, (byte*)aes->reg,
+                                  IncrementAesCounter, 0, out, in,
+                                  sz / AES_BLOCK_SIZE) * AES_BLOCK_SIZE;
+                out += done;
+                in  += done;
+                sz  -= done;
+            }
+        #endif
+
             /* do as many block size ops as possible */
             while (sz >= AES_BLOCK_SIZE) {
-                AesEncrypt(aes, (byte*)aes->reg, out);
+                /* through tmp so out may be in */
+                AesEncrypt(aes, (byte*)aes->reg, (byte*)aes->tmp);
                 IncrementAesCounter((byte*)aes->reg);
-                xorbuf(out, in, AES_BLOCK_SIZE);
+                xorbuf((byte*)aes->tmp, in, AES_BLOCK_SIZE);
+                XMEMCPY(out, aes->tmp, AES_BLOCK_SIZE);
 
                 out += AES_BLOCK_SIZE;
                 in  += AES_BLOCK_SIZE;
@@ -2617,6 +3218,296 @@ static void GenerateM0(Aes* aes)
 #endif /* GCM_TABLE */
 
 
+#ifdef CYASSL_AESNI
+
+/* PCLMULQDQ GHASH and pipelined AES-NI CTR for GCM, used when the cpu has
+ * both.  Blocks are kept byte reflected (BSWAP_MASK) so the carry-less
+ * products line up with GCM's bit order, see Intel's "Carry-Less
+ * Multiplication and Its Usage for Computing the GCM Mode" white paper. */
+
+#include <tmmintrin.h>
+
+#define GCM_CLMUL_BLOCKS 4   /* blocks per CTR batch and GHASH reduction,
+                                same as the powers kept in Aes.Hpow */
+
+#define BSWAP_MASK _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)
+
+
+/* shift the 256 bit product hi:lo left by one and reduce it mod the GCM
+ * polynomial */
+static INLINE __m128i GcmReduce(__m128i lo, __m128i hi)
+{
+    __m128i t2, t4, t5, t7, t8, t9;
+
+    t7 = _mm_srli_epi32(lo, 31);
+    t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(hi, t8);
+    hi = _mm_or_si128(hi, t9);
+
+    t7 = _mm_slli_epi32(lo, 31);
+    t8 = _mm_slli_epi32(lo, 30);
+    t9 = _mm_slli_epi32(lo, 25);
+    t7 = _mm_xor_si128(t7, t8);
+    t7 = _mm_xor_si128(t7, t9);
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    lo = _mm_xor_si128(lo, t7);
+
+    t2 = _mm_srli_epi32(lo, 1);
+    t4 = _mm_srli_epi32(lo, 2);
+    t5 = _mm_srli_epi32(lo, 7);
+    t2 = _mm_xor_si128(t2, t4);
+    t2 = _mm_xor_si128(t2, t5);
+    t2 = _mm_xor_si128(t2, t8);
+    lo = _mm_xor_si128(lo, t2);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+
+/* accumulate the unreduced 256 bit product a * b into lo, mid and hi,
+ * Karatsuba style */
+static INLINE void GcmMulAcc(__m128i a, __m128i b,
+                             __m128i* lo, __m128i* mid, __m128i* hi)
+{
+    __m128i ta = _mm_xor_si128(_mm_shuffle_epi32(a, 78), a);
+    __m128i tb = _mm_xor_si128(_mm_shuffle_epi32(b, 78), b);
+
+    *lo  = _mm_xor_si128(*lo,  _mm_clmulepi64_si128(a, b, 0x00));
+    *hi  = _mm_xor_si128(*hi,  _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(ta, tb, 0x00));
+}
+
+
+static INLINE __m128i GcmReduceAcc(__m128i lo, __m128i mid, __m128i hi)
+{
+    mid = _mm_xor_si128(mid, lo);
+    mid = _mm_xor_si128(mid, hi);
+    lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    return GcmReduce(lo, hi);
+}
+
+
+static INLINE __m128i GcmMul(__m128i a, __m128i b)
+{
+    __m128i lo  = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi  = _mm_setzero_si128();
+
+    GcmMulAcc(a, b, &lo, &mid, &hi);
+
+    return GcmReduceAcc(lo, mid, hi);
+}
+
+
+/* H, H^2, .. H^GCM_CLMUL_BLOCKS byte reflected into aes->Hpow */
+static void GenerateHpow(Aes* aes)
+{
+    __m128i* Hpow = (__m128i*)aes->Hpow;
+    __m128i  H    = _mm_shuffle_epi8(_mm_load_si128((__m128i*)aes->H),
+                                     BSWAP_MASK);
+    int i;
+
+    Hpow[0] = H;
+    for (i = 1; i < GCM_CLMUL_BLOCKS; i++)
+        Hpow[i] = GcmMul(Hpow[i-1], H);
+}
+
+
+/* fold sz bytes of a into the reflected hash X, the final partial block is
+ * zero padded, whole batches share one reduction */
+static __m128i GcmHashClmul(const Aes* aes, __m128i X, const byte* a, word32 sz)
+{
+    const __m128i* Hpow = (const __m128i*)aes->Hpow;
+    const __m128i  bswap = BSWAP_MASK;
+    __m128i lo, mid, hi;
+    int i;
+
+    while (sz >= GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE) {
+        lo = mid = hi = _mm_setzero_si128();
+        for (i = 0; i < GCM_CLMUL_BLOCKS; i++) {
+            __m128i x = _mm_shuffle_epi8(
+                  _mm_loadu_si128((const __m128i*)(a + i*AES_BLOCK_SIZE)), bswap);
+            if (i == 0)
+                x = _mm_xor_si128(x, X);
+            GcmMulAcc(x, Hpow[GCM_CLMUL_BLOCKS - 1 - i], &lo, &mid, &hi);
+        }
+        X   = GcmReduceAcc(lo, mid, hi);
+        a  += GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE;
+        sz -= GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    while (sz >= AES_BLOCK_SIZE) {
+        X   = _mm_xor_si128(X, _mm_shuffle_epi8(
+                               _mm_loadu_si128((const __m128i*)a), bswap));
+        X   = GcmMul(X, Hpow[0]);
+        a  += AES_BLOCK_SIZE;
+        sz -= AES_BLOCK_SIZE;
+    }
+
+    if (sz) {
+        ALIGN16 byte scratch[AES_BLOCK_SIZE];
+
+        XMEMSET(scratch, 0, AES_BLOCK_SIZE);
+        XMEMCPY(scratch, a, sz);
+        X = _mm_xor_si128(X, _mm_shuffle_epi8(
+                               _mm_load_si128((__m128i*)scratch), bswap));
+        X = GcmMul(X, Hpow[0]);
+    }
+
+    return X;
+}
+
+
+/* close the hash X with the bit lengths and store the byte order tag */
+static void GcmFinalClmul(const Aes* aes, __m128i X, word32 aSz, word32 cSz,
+                          byte* s)
+{
+    __m128i lengths = _mm_set_epi64x((long long)((word64)aSz * 8),
+                                     (long long)((word64)cSz * 8));
+
+    X = GcmMul(_mm_xor_si128(X, lengths), ((const __m128i*)aes->Hpow)[0]);
+    _mm_storeu_si128((__m128i*)s, _mm_shuffle_epi8(X, BSWAP_MASK));
+}
+
+
+/* CTR crypt sz bytes starting after the counter block ctr, which is left at
+ * the last counter used.  GCM_CLMUL_BLOCKS blocks go through the AES rounds
+ * together to keep the aesenc pipeline full, and when encrypting (X not
+ * NULL) each batch of cipher text is folded into the hash while still in
+ * registers */
+static void GcmCtrClmul(const Aes* aes, byte* out, const byte* in, word32 sz,
+                        byte* ctr, __m128i* X)
+{
+    const __m128i* key   = (const __m128i*)aes->key;
+    const __m128i* Hpow  = (const __m128i*)aes->Hpow;
+    const int      nr    = (int)aes->rounds;
+    const __m128i  bswap = BSWAP_MASK;
+    const __m128i  one   = _mm_set_epi32(0, 0, 0, 1);
+    __m128i cnt = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)ctr), bswap);
+    __m128i b[GCM_CLMUL_BLOCKS];
+    __m128i lo, mid, hi;
+    byte*   tail;
+    word32  tailSz;
+    int i, j;
+
+    while (sz >= GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE) {
+        for (i = 0; i < GCM_CLMUL_BLOCKS; i++) {
+            cnt  = _mm_add_epi32(cnt, one);
+            b[i] = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), key[0]);
+        }
+        for (j = 1; j < nr; j++)
+            for (i = 0; i < GCM_CLMUL_BLOCKS; i++)
+                b[i] = _mm_aesenc_si128(b[i], key[j]);
+        for (i = 0; i < GCM_CLMUL_BLOCKS; i++) {
+            b[i] = _mm_aesenclast_si128(b[i], key[nr]);
+            b[i] = _mm_xor_si128(b[i],
+                   _mm_loadu_si128((const __m128i*)(in + i*AES_BLOCK_SIZE)));
+            _mm_storeu_si128((__m128i*)(out + i*AES_BLOCK_SIZE), b[i]);
+        }
+        if (X) {
+            lo = mid = hi = _mm_setzero_si128();
+            for (i = 0; i < GCM_CLMUL_BLOCKS; i++) {
+                __m128i x = _mm_shuffle_epi8(b[i], bswap);
+                if (i == 0)
+                    x = _mm_xor_si128(x, *X);
+                GcmMulAcc(x, Hpow[GCM_CLMUL_BLOCKS - 1 - i], &lo, &mid, &hi);
+            }
+            *X = GcmReduceAcc(lo, mid, hi);
+        }
+        in  += GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE;
+        out += GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE;
+        sz  -= GCM_CLMUL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    tail   = out;
+    tailSz = sz;
+
+    while (sz) {
+        word32 len = sz < AES_BLOCK_SIZE ? sz : AES_BLOCK_SIZE;
+
+        cnt  = _mm_add_epi32(cnt, one);
+        b[0] = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), key[0]);
+        for (j = 1; j < nr; j++)
+            b[0] = _mm_aesenc_si128(b[0], key[j]);
+        b[0] = _mm_aesenclast_si128(b[0], key[nr]);
+
+        if (len == AES_BLOCK_SIZE) {
+            b[0] = _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i*)in));
+            _mm_storeu_si128((__m128i*)out, b[0]);
+        }
+        else {
+            ALIGN16 byte scratch[AES_BLOCK_SIZE];
+
+            _mm_store_si128((__m128i*)scratch, b[0]);
+            xorbuf(scratch, in, len);
+            XMEMCPY(out, scratch, len);
+        }
+        in  += len;
+        out += len;
+        sz  -= len;
+    }
+
+    if (X && tailSz)
+        *X = GcmHashClmul(aes, *X, tail, tailSz);
+
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(cnt, bswap));
+}
+
+
+static void AesGcmEncryptClmul(Aes* aes, byte* out, const byte* in, word32 sz,
+                               byte* ctr, byte* authTag, word32 authTagSz,
+                               const byte* authIn, word32 authInSz)
+{
+    ALIGN16 byte s[AES_BLOCK_SIZE];
+    ALIGN16 byte EKY0[AES_BLOCK_SIZE];
+    __m128i X;
+
+    AesEncrypt(aes, ctr, EKY0);
+
+    X = GcmHashClmul(aes, _mm_setzero_si128(), authIn, authInSz);
+    GcmCtrClmul(aes, out, in, sz, ctr, &X);
+    GcmFinalClmul(aes, X, authInSz, sz, s);
+
+    xorbuf(s, EKY0, authTagSz);
+    XMEMCPY(authTag, s, authTagSz);
+}
+
+
+static int AesGcmDecryptClmul(Aes* aes, byte* out, const byte* in, word32 sz,
+                              byte* ctr, const byte* authTag, word32 authTagSz,
+                              const byte* authIn, word32 authInSz)
+{
+    ALIGN16 byte Tprime[AES_BLOCK_SIZE];
+    ALIGN16 byte EKY0[AES_BLOCK_SIZE];
+    __m128i X;
+
+    AesEncrypt(aes, ctr, EKY0);
+
+    X = GcmHashClmul(aes, _mm_setzero_si128(), authIn, authInSz);
+    X = GcmHashClmul(aes, X, in, sz);
+    GcmFinalClmul(aes, X, authInSz, sz, Tprime);
+    xorbuf(Tprime, EKY0, sizeof(Tprime));
+
+    if (XMEMCMP(authTag, Tprime, authTagSz) != 0)
+        return AES_GCM_AUTH_E;
+
+    GcmCtrClmul(aes, out, in, sz, ctr, NULL);
+
+    return 0;
+}
+
+#endif /* CYASSL_AESNI */
+
+
 int AesGcmSetKey(Aes* aes, const byte* key, word32 len)
 {
     int  ret;
@@ -2641,6 +3532,12 @@ int AesGcmSetKey(Aes* aes, const byte* key, word32 len)
     #ifdef GCM_TABLE
         GenerateM0(aes);
     #endif /* GCM_TABLE */
+    #ifdef CYASSL_AESNI
+        aes->use_clmul = aes->use_aesni &&
+                         (CyaSSL_GetCpuFeatures() & CYASSL_CPU_PCLMUL);
+        if (aes->use_clmul)
+            GenerateHpow(aes);
+    #endif
     }
 
     return ret;
@@ -3150,6 +4047,103 @@ static void GHASH(Aes* aes, const byte* a, word32 aSz,
 #endif /* end GCM_WORD32 */
 
 
+#ifdef AES_ARMV8
+
+/* PMULL GHASH, RBIT on every byte turns GCM's reflected bit order into the
+ * plain polynomial x^128 + x^7 + x^2 + x + 1 over the little endian value,
+ * so products reduce by folding the high words with 0x87 */
+
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static INLINE uint64x2_t GcmMulPmull(uint64x2_t a, uint64x2_t b)
+{
+    const uint64x2_t zero = vdupq_n_u64(0);
+    poly64x2_t pa = vreinterpretq_p64_u64(a);
+    poly64x2_t pb = vreinterpretq_p64_u64(b);
+    uint64x2_t lo, hi, mid, t;
+
+    lo  = vreinterpretq_u64_p128(vmull_p64(vgetq_lane_p64(pa, 0),
+                                           vgetq_lane_p64(pb, 0)));
+    hi  = vreinterpretq_u64_p128(vmull_high_p64(pa, pb));
+    mid = veorq_u64(
+              vreinterpretq_u64_p128(vmull_p64(vgetq_lane_p64(pa, 0),
+                                               vgetq_lane_p64(pb, 1))),
+              vreinterpretq_u64_p128(vmull_p64(vgetq_lane_p64(pa, 1),
+                                               vgetq_lane_p64(pb, 0))));
+    lo  = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi  = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+    /* x^192 then x^128 terms back down, x^128 = x^7 + x^2 + x + 1 */
+    t   = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(hi, 1),
+                                           (poly64_t)0x87));
+    lo  = veorq_u64(lo, vextq_u64(zero, t, 1));
+    hi  = veorq_u64(hi, vextq_u64(t, zero, 1));
+    t   = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(hi, 0),
+                                           (poly64_t)0x87));
+
+    return veorq_u64(lo, t);
+}
+
+
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static INLINE uint64x2_t GcmLoadPmull(const byte* in)
+{
+    return vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(in)));
+}
+
+
+/* fold sz bytes of a into X, the final partial block zero padded */
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static uint64x2_t GcmHashPmull(uint64x2_t X, uint64x2_t H, const byte* a,
+                               word32 sz)
+{
+    while (sz >= AES_BLOCK_SIZE) {
+        X   = GcmMulPmull(veorq_u64(X, GcmLoadPmull(a)), H);
+        a  += AES_BLOCK_SIZE;
+        sz -= AES_BLOCK_SIZE;
+    }
+
+    if (sz) {
+        byte scratch[AES_BLOCK_SIZE];
+
+        XMEMSET(scratch, 0, AES_BLOCK_SIZE);
+        XMEMCPY(scratch, a, sz);
+        X = GcmMulPmull(veorq_u64(X, GcmLoadPmull(scratch)), H);
+    }
+
+    return X;
+}
+
+
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static void GhashPmull(Aes* aes, const byte* a, word32 aSz,
+                       const byte* c, word32 cSz, byte* s, word32 sSz)
+{
+    uint64x2_t H = GcmLoadPmull(aes->H);
+    uint64x2_t X = vdupq_n_u64(0);
+    byte       scratch[AES_BLOCK_SIZE];
+    word64     aBits = (word64)aSz * 8;
+    word64     cBits = (word64)cSz * 8;
+    int        i;
+
+    if (aSz != 0 && a != NULL)
+        X = GcmHashPmull(X, H, a, aSz);
+    if (cSz != 0 && c != NULL)
+        X = GcmHashPmull(X, H, c, cSz);
+
+    /* the big endian bit lengths of A and C */
+    for (i = 0; i < 8; i++) {
+        scratch[7 - i]  = (byte)(aBits >> (8 * i));
+        scratch[15 - i] = (byte)(cBits >> (8 * i));
+    }
+    X = GcmHashPmull(X, H, scratch, AES_BLOCK_SIZE);
+
+    vst1q_u8(scratch, vrbitq_u8(vreinterpretq_u8_u64(X)));
+    XMEMCPY(s, scratch, sSz);
+}
+
+#endif /* AES_ARMV8 */
+
+
 int AesGcmEncrypt(Aes* aes, byte* out, const byte* in, word32 sz,
                    const byte* iv, word32 ivSz,
                    byte* authTag, word32 authTagSz,
@@ -3169,6 +4163,15 @@ int AesGcmEncrypt(Aes* aes, byte* out, const byte* in, word32 sz,
 
     CYASSL_ENTER("AesGcmEncrypt");
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (aes->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        int ret = CryptoDev_AesGcm(aes, 1, out, in, sz, iv, ivSz,
+                                   authTag, authTagSz, authIn, authInSz);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
 #ifdef CYASSL_PIC32MZ_CRYPT
     ctr = (char *)aes->iv_ce ;
 #else
@@ -3179,10 +4182,27 @@ int AesGcmEncrypt(Aes* aes, byte* out, const byte* in, word32 sz,
     XMEMCPY(ctr, iv, ivSz);
     InitGcmCounter(ctr);
 
+#ifdef CYASSL_AESNI
+    if (aes->use_clmul) {
+        AesGcmEncryptClmul(aes, out, in, sz, ctr, authTag, authTagSz,
+                           authIn, authInSz);
+        return 0;
+    }
+#endif
+
 #ifdef CYASSL_PIC32MZ_CRYPT
     if(blocks)
         AesCrypt(aes, out, in, blocks*AES_BLOCK_SIZE,
              PIC32_ENCRYPTION, PIC32_ALGO_AES, PIC32_CRYPTOALGO_AES_GCM );
+#endif
+#ifdef AES_BLOCKS_SIMD
+    {
+        word32 done = AesCtrBlocksSimd(aes, ctr, IncrementGcmCounter, 1,
+                                       c, p, blocks);
+        p += done * AES_BLOCK_SIZE;
+        c += done * AES_BLOCK_SIZE;
+        blocks -= done;
+    }
 #endif
     while (blocks--) {
         IncrementGcmCounter(ctr);
@@ -3211,6 +4231,11 @@ int AesGcmEncrypt(Aes* aes, byte* out, const byte* in, word32 sz,
 
     }
 
+#ifdef AES_ARMV8
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_ARM_PMULL)
+        GhashPmull(aes, authIn, authInSz, out, sz, authTag, authTagSz);
+    else
+#endif
     GHASH(aes, authIn, authInSz, out, sz, authTag, authTagSz);
     InitGcmCounter(ctr);
     #ifdef FREESCALE_MMCAU
@@ -3243,6 +4268,16 @@ int  AesGcmDecrypt(Aes* aes, byte* out, const byte* in, word32 sz,
 
     CYASSL_ENTER("AesGcmDecrypt");
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (aes->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        int ret = CryptoDev_AesGcm(aes, 0, out, in, sz, iv, ivSz,
+                                   (byte*)authTag, authTagSz,
+                                   authIn, authInSz);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
 #ifdef CYASSL_PIC32MZ_CRYPT
     ctr = (char *)aes->iv_ce ;
 #else
@@ -3253,12 +4288,23 @@ int  AesGcmDecrypt(Aes* aes, byte* out, const byte* in, word32 sz,
     XMEMCPY(ctr, iv, ivSz);
     InitGcmCounter(ctr);
 
+#ifdef CYASSL_AESNI
+    if (aes->use_clmul)
+        return AesGcmDecryptClmul(aes, out, in, sz, ctr, authTag, authTagSz,
+                                  authIn, authInSz);
+#endif
+
     /* Calculate the authTag again using the received auth data and the
      * cipher text. */
     {
         byte Tprime[AES_BLOCK_SIZE];
         byte EKY0[AES_BLOCK_SIZE];
 
+    #ifdef AES_ARMV8
+        if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_ARM_PMULL)
+            GhashPmull(aes, authIn, authInSz, in, sz, Tprime, sizeof(Tprime));
+        else
+    #endif
         GHASH(aes, authIn, authInSz, in, sz, Tprime, sizeof(Tprime));
         #ifdef FREESCALE_MMCAU
             cau_aes_encrypt(ctr, key, aes->rounds, EKY0);
@@ -3277,6 +4323,15 @@ int  AesGcmDecrypt(Aes* aes, byte* out, const byte* in, word32 sz,
         AesCrypt(aes, out, in, blocks*AES_BLOCK_SIZE,
              PIC32_DECRYPTION, PIC32_ALGO_AES, PIC32_CRYPTOALGO_AES_GCM );
 #endif
+#ifdef AES_BLOCKS_SIMD
+    {
+        word32 done = AesCtrBlocksSimd(aes, ctr, IncrementGcmCounter, 1,
+                                       p, c, blocks);
+        p += done * AES_BLOCK_SIZE;
+        c += done * AES_BLOCK_SIZE;
+        blocks -= done;
+    }
+#endif
 
     while (blocks--) {
         IncrementGcmCounter(ctr);
@@ -3443,14 +4498,97 @@ static INLINE void AesCcmCtrInc(byte* B, word32 lenSz)
 }
 
 
-void AesCcmEncrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
-                   const byte* nonce, word32 nonceSz,
-                   byte* authTag, word32 authTagSz,
-                   const byte* authIn, word32 authInSz)
+#ifdef CYASSL_AESNI
+
+#include <tmmintrin.h>
+
+/* CBC-MAC is a chain and CTR is not, so each MAC block goes through the
+ * rounds next to a CTR block and the two hide each other's latency.
+ * Encrypting both take block i, decrypting the MAC needs the plain text so
+ * it runs one block behind. ctr is the next counter block and mac the
+ * chain so far, both carried on. The counter field never carries out of
+ * its low 64 bits, it is at most 8 bytes and can't pass the length.
+ * Whole blocks only, returns the bytes done, in may equal out. */
+static word32 AesCcmBlocksAesni(const Aes* aes, byte* out, const byte* in,
+                                word32 sz, byte* ctr, byte* mac, int enc)
 {
-    byte A[AES_BLOCK_SIZE];
-    byte B[AES_BLOCK_SIZE];
-    byte lenSz;
+    const __m128i* rk     = (const __m128i*)aes->key;
+    const int      nr     = (int)aes->rounds;
+    const __m128i  bswap  = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                         11, 12, 13, 14, 15);
+    const __m128i  one    = _mm_set_epi64x(0, 1);
+    const word32   blocks = sz / AES_BLOCK_SIZE;
+    __m128i        cnt, x, k, p, c;
+    word32         i;
+    int            r;
+
+    if (blocks == 0)
+        return 0;
+
+    cnt = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)ctr), bswap);
+    x   = _mm_loadu_si128((const __m128i*)mac);
+
+    if (enc) {
+        for (i = 0; i < blocks; i++) {
+            p   = _mm_loadu_si128((const __m128i*)in + i);
+            k   = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), rk[0]);
+            x   = _mm_xor_si128(_mm_xor_si128(x, p), rk[0]);
+            cnt = _mm_add_epi64(cnt, one);
+            for (r = 1; r < nr; r++) {
+                k = _mm_aesenc_si128(k, rk[r]);
+                x = _mm_aesenc_si128(x, rk[r]);
+            }
+            k = _mm_aesenclast_si128(k, rk[nr]);
+            x = _mm_aesenclast_si128(x, rk[nr]);
+            _mm_storeu_si128((__m128i*)out + i, _mm_xor_si128(k, p));
+        }
+    }
+    else {
+        /* first key stream block alone, then block i's with MAC i-1 */
+        k = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), rk[0]);
+        cnt = _mm_add_epi64(cnt, one);
+        for (r = 1; r < nr; r++)
+            k = _mm_aesenc_si128(k, rk[r]);
+        k = _mm_aesenclast_si128(k, rk[nr]);
+        p = _mm_xor_si128(k, _mm_loadu_si128((const __m128i*)in));
+        _mm_storeu_si128((__m128i*)out, p);
+
+        for (i = 1; i < blocks; i++) {
+            c   = _mm_loadu_si128((const __m128i*)in + i);
+            k   = _mm_xor_si128(_mm_shuffle_epi8(cnt, bswap), rk[0]);
+            x   = _mm_xor_si128(_mm_xor_si128(x, p), rk[0]);
+            cnt = _mm_add_epi64(cnt, one);
+            for (r = 1; r < nr; r++) {
+                k = _mm_aesenc_si128(k, rk[r]);
+                x = _mm_aesenc_si128(x, rk[r]);
+            }
+            k = _mm_aesenclast_si128(k, rk[nr]);
+            x = _mm_aesenclast_si128(x, rk[nr]);
+            p = _mm_xor_si128(k, c);
+            _mm_storeu_si128((__m128i*)out + i, p);
+        }
+
+        x = _mm_xor_si128(_mm_xor_si128(x, p), rk[0]);
+        for (r = 1; r < nr; r++)
+            x = _mm_aesenc_si128(x, rk[r]);
+        x = _mm_aesenclast_si128(x, rk[nr]);
+    }
+
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(cnt, bswap));
+    _mm_storeu_si128((__m128i*)mac, x);
+
+    return blocks * AES_BLOCK_SIZE;
+}
+
+#endif /* CYASSL_AESNI */
+
+
+/* B0 into A and the auth data rolled in, then B is left as counter 0 */
+static void AesCcmStart(Aes* aes, byte* A, byte* B, word32 inSz,
+                        const byte* nonce, word32 nonceSz, word32 authTagSz,
+                        const byte* authIn, word32 authInSz)
+{
+    byte   lenSz = AES_BLOCK_SIZE - 1 - (byte)nonceSz;
     word32 i;
 
     #ifdef FREESCALE_MMCAU
@@ -3458,12 +4596,13 @@ void AesCcmEncrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
     #endif
 
     XMEMCPY(B+1, nonce, nonceSz);
-    lenSz = AES_BLOCK_SIZE - 1 - (byte)nonceSz;
     B[0] = (authInSz > 0 ? 64 : 0)
          + (8 * (((byte)authTagSz - 2) / 2))
          + (lenSz - 1);
+    /* the length field is up to 8 bytes, inSz only fills 4 of them */
     for (i = 0; i < lenSz; i++)
-        B[AES_BLOCK_SIZE - 1 - i] = (inSz >> (8 * i)) & 0xFF;
+        B[AES_BLOCK_SIZE - 1 - i] = i < sizeof(inSz) ?
+                                    (byte)(inSz >> (8 * i)) : 0;
 
     #ifdef FREESCALE_MMCAU
         cau_aes_encrypt(B, key, aes->rounds, A);
@@ -3472,136 +4611,120 @@ void AesCcmEncrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
     #endif
     if (authInSz > 0)
         roll_auth(aes, authIn, authInSz, A);
-    if (inSz > 0)
-        roll_x(aes, in, inSz, A);
-    XMEMCPY(authTag, A, authTagSz);
 
     B[0] = lenSz - 1;
     for (i = 0; i < lenSz; i++)
         B[AES_BLOCK_SIZE - 1 - i] = 0;
+}
+
+
+/* CTR from counter block B, which is carried on */
+static void AesCcmCtr(Aes* aes, byte* out, const byte* in, word32 sz,
+                      byte* B, word32 lenSz)
+{
+    byte A[AES_BLOCK_SIZE];
+
     #ifdef FREESCALE_MMCAU
-        cau_aes_encrypt(B, key, aes->rounds, A);
-    #else
-        AesEncrypt(aes, B, A);
+        byte* key = (byte*)aes->key;
     #endif
-    xorbuf(authTag, A, authTagSz);
 
-    B[15] = 1;
-    while (inSz >= AES_BLOCK_SIZE) {
+    while (sz > 0) {
+        word32 len = sz < AES_BLOCK_SIZE ? sz : AES_BLOCK_SIZE;
+
         #ifdef FREESCALE_MMCAU
             cau_aes_encrypt(B, key, aes->rounds, A);
         #else
             AesEncrypt(aes, B, A);
         #endif
-        xorbuf(A, in, AES_BLOCK_SIZE);
-        XMEMCPY(out, A, AES_BLOCK_SIZE);
+        xorbuf(A, in, len);
+        XMEMCPY(out, A, len);
 
         AesCcmCtrInc(B, lenSz);
-        inSz -= AES_BLOCK_SIZE;
-        in += AES_BLOCK_SIZE;
-        out += AES_BLOCK_SIZE;
-    }
-    if (inSz > 0) {
-        #ifdef FREESCALE_MMCAU
-            cau_aes_encrypt(B, key, aes->rounds, A);
-        #else
-            AesEncrypt(aes, B, A);
-        #endif
-        xorbuf(A, in, inSz);
-        XMEMCPY(out, A, inSz);
+        sz  -= len;
+        in  += len;
+        out += len;
     }
 
     XMEMSET(A, 0, AES_BLOCK_SIZE);
-    XMEMSET(B, 0, AES_BLOCK_SIZE);
 }
 
 
-int  AesCcmDecrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
+void AesCcmEncrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
                    const byte* nonce, word32 nonceSz,
-                   const byte* authTag, word32 authTagSz,
+                   byte* authTag, word32 authTagSz,
                    const byte* authIn, word32 authInSz)
 {
     byte A[AES_BLOCK_SIZE];
     byte B[AES_BLOCK_SIZE];
-    byte* o;
-    byte lenSz;
-    word32 i, oSz;
-    int result = 0;
+    byte S0[AES_BLOCK_SIZE];
+    byte lenSz = AES_BLOCK_SIZE - 1 - (byte)nonceSz;
+    word32 done = 0;
 
     #ifdef FREESCALE_MMCAU
         byte* key = (byte*)aes->key;
     #endif
 
-    o = out;
-    oSz = inSz;
-    XMEMCPY(B+1, nonce, nonceSz);
-    lenSz = AES_BLOCK_SIZE - 1 - (byte)nonceSz;
-
-    B[0] = lenSz - 1;
-    for (i = 0; i < lenSz; i++)
-        B[AES_BLOCK_SIZE - 1 - i] = 0;
-    B[15] = 1;
-    
-    while (oSz >= AES_BLOCK_SIZE) {
-        #ifdef FREESCALE_MMCAU
-            cau_aes_encrypt(B, key, aes->rounds, A);
-        #else
-            AesEncrypt(aes, B, A);
-        #endif
-        xorbuf(A, in, AES_BLOCK_SIZE);
-        XMEMCPY(o, A, AES_BLOCK_SIZE);
-
-        AesCcmCtrInc(B, lenSz);
-        oSz -= AES_BLOCK_SIZE;
-        in += AES_BLOCK_SIZE;
-        o += AES_BLOCK_SIZE;
-    }
-    if (inSz > 0) {
-        #ifdef FREESCALE_MMCAU
-            cau_aes_encrypt(B, key, aes->rounds, A);
-        #else
-            AesEncrypt(aes, B, A);
-        #endif
-        xorbuf(A, in, oSz);
-        XMEMCPY(o, A, oSz);
-    }
+    AesCcmStart(aes, A, B, inSz, nonce, nonceSz, authTagSz, authIn, authInSz);
 
-    for (i = 0; i < lenSz; i++)
-        B[AES_BLOCK_SIZE - 1 - i] = 0;
+    /* counter 0 is kept for the tag, the data starts at 1 */
     #ifdef FREESCALE_MMCAU
-        cau_aes_encrypt(B, key, aes->rounds, A);
+        cau_aes_encrypt(B, key, aes->rounds, S0);
     #else
-        AesEncrypt(aes, B, A);
+        AesEncrypt(aes, B, S0);
     #endif
+    B[AES_BLOCK_SIZE - 1] = 1;
 
-    o = out;
-    oSz = inSz;
+    #ifdef CYASSL_AESNI
+        if (aes->use_aesni)
+            done = AesCcmBlocksAesni(aes, out, in, inSz, B, A, 1);
+    #endif
+    if (inSz > done) {
+        roll_x(aes, in + done, inSz - done, A);
+        AesCcmCtr(aes, out + done, in + done, inSz - done, B, lenSz);
+    }
+    xorbuf(A, S0, authTagSz);
+    XMEMCPY(authTag, A, authTagSz);
 
-    B[0] = (authInSz > 0 ? 64 : 0)
-         + (8 * (((byte)authTagSz - 2) / 2))
-         + (lenSz - 1);
-    for (i = 0; i < lenSz; i++)
-        B[AES_BLOCK_SIZE - 1 - i] = (inSz >> (8 * i)) & 0xFF;
+    XMEMSET(A, 0, AES_BLOCK_SIZE);
+    XMEMSET(B, 0, AES_BLOCK_SIZE);
+    XMEMSET(S0, 0, AES_BLOCK_SIZE);
+}
+
+
+int  AesCcmDecrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
+                   const byte* nonce, word32 nonceSz,
+                   const byte* authTag, word32 authTagSz,
+                   const byte* authIn, word32 authInSz)
+{
+    byte A[AES_BLOCK_SIZE];
+    byte B[AES_BLOCK_SIZE];
+    byte S0[AES_BLOCK_SIZE];
+    byte lenSz = AES_BLOCK_SIZE - 1 - (byte)nonceSz;
+    word32 done = 0;
+    int result = 0;
 
     #ifdef FREESCALE_MMCAU
-        cau_aes_encrypt(B, key, aes->rounds, A);
-    #else
-        AesEncrypt(aes, B, A);
+        byte* key = (byte*)aes->key;
     #endif
-    if (authInSz > 0)
-        roll_auth(aes, authIn, authInSz, A);
-    if (inSz > 0)
-        roll_x(aes, o, oSz, A);
 
-    B[0] = lenSz - 1;
-    for (i = 0; i < lenSz; i++)
-        B[AES_BLOCK_SIZE - 1 - i] = 0;
+    AesCcmStart(aes, A, B, inSz, nonce, nonceSz, authTagSz, authIn, authInSz);
+
     #ifdef FREESCALE_MMCAU
-        cau_aes_encrypt(B, key, aes->rounds, B);
+        cau_aes_encrypt(B, key, aes->rounds, S0);
     #else
-        AesEncrypt(aes, B, B);
+        AesEncrypt(aes, B, S0);
     #endif
-    xorbuf(A, B, authTagSz);
+    B[AES_BLOCK_SIZE - 1] = 1;
+
+    #ifdef CYASSL_AESNI
+        if (aes->use_aesni)
+            done = AesCcmBlocksAesni(aes, out, in, inSz, B, A, 0);
+    #endif
+    if (inSz > done) {
+        AesCcmCtr(aes, out + done, in + done, inSz - done, B, lenSz);
+        roll_x(aes, out + done, inSz - done, A);
+    }
+    xorbuf(A, S0, authTagSz);
 
     if (XMEMCMP(A, authTag, authTagSz) != 0) {
         /* If the authTag check fails, don't keep the decrypted data.
@@ -3613,7 +4736,7 @@ int  AesCcmDecrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
 
     XMEMSET(A, 0, AES_BLOCK_SIZE);
     XMEMSET(B, 0, AES_BLOCK_SIZE);
-    o = NULL;
+    XMEMSET(S0, 0, AES_BLOCK_SIZE);
 
     return result;
 }
@@ -3744,5 +4867,17 @@ static int AesCaviumCbcDecrypt(Aes* aes, byte* out, const byte* in,
 
 #endif /* HAVE_CAVIUM */
 
+
+#ifdef CYASSL_CRYPTO_DEV
+
+/* send this Aes's requests to the device registered as devId first */
+void AesSetDevId(Aes* aes, int devId)
+{
+    aes->cdevId    = devId;
+    aes->cdevMagic = CYASSL_CRYPTO_DEV_MAGIC;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
 #endif /* NO_AES */
 
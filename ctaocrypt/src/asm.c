@@ -485,6 +485,42 @@ __asm__(                                 \
 
 
 #define LO  0
+
+
+#if defined(TFM_X86_64) && defined(HAVE_CYASSL_X86_SIMD)
+/* MULX/ADX rows, used instead of the macros above when the cpu reports BMI2
+   and ADX. One row does _c[0..k-1] += mu * tmpm[0..k-1] + cy and leaves the
+   carry out in cy: adcx carries the low halves, adox the high halves and the
+   incoming cy, so the two chains run side by side. The sum always fits in
+   k + 1 digits, so neither chain carries past the last one. */
+#define HAVE_FP_MULX
+
+#define INNERMULX(k)                                      \
+__asm__ __volatile__(                                     \
+   "movq   %[mu], %%rdx            \n\t"                  \
+   "xorl   %%r8d, %%r8d            \n\t"                  \
+   "movq   (%[c]), %%r9            \n\t"                  \
+   "adoxq  %[cy], %%r9             \n\t"                  \
+   ".set   .Lcya_x, 0              \n\t"                  \
+   ".rept  " #k "-1                \n\t"                  \
+   "mulxq  .Lcya_x(%[m]), %%rax, %%r10 \n\t"              \
+   "adcxq  %%rax, %%r9             \n\t"                  \
+   "movq   %%r9, .Lcya_x(%[c])     \n\t"                  \
+   "movq   .Lcya_x+8(%[c]), %%r9   \n\t"                  \
+   "adoxq  %%r10, %%r9             \n\t"                  \
+   ".set   .Lcya_x, .Lcya_x+8      \n\t"                  \
+   ".endr                          \n\t"                  \
+   "mulxq  " #k "*8-8(%[m]), %%rax, %%r10 \n\t"           \
+   "adcxq  %%rax, %%r9             \n\t"                  \
+   "movq   %%r9, " #k "*8-8(%[c])  \n\t"                  \
+   "adcxq  %%r8, %%r10             \n\t"                  \
+   "adoxq  %%r8, %%r10             \n\t"                  \
+   "movq   %%r10, %[cy]            \n\t"                  \
+   : [cy] "+r" (cy)                                       \
+   : [c] "r" (_c), [m] "r" (tmpm), [mu] "r" (mu)          \
+   : "%rax", "%rdx", "%r8", "%r9", "%r10", "cc", "memory")
+
+#endif /* TFM_X86_64 && HAVE_CYASSL_X86_SIMD */
 /* end fp_montogomery_reduce.c asm */
 
 
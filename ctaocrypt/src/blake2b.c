@@ -42,6 +42,12 @@
 
 #include <cyassl/ctaocrypt/blake2.h>
 #include <cyassl/ctaocrypt/blake2-impl.h>
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_BLAKE2B_SIMD)
+    #define BLAKE2B_X86_SIMD
+    #include <immintrin.h>
+#endif
 
 
 static const word64 blake2b_IV[8] =
@@ -186,8 +192,8 @@ int blake2b_init_key( blake2b_state *S, const byte outlen, const void *key,
   return 0;
 }
 
-static int blake2b_compress( blake2b_state *S,
-                             const byte block[BLAKE2B_BLOCKBYTES] )
+static int blake2b_compress_c( blake2b_state *S,
+                               const byte block[BLAKE2B_BLOCKBYTES] )
 {
   int i;
 
@@ -274,6 +280,254 @@ static int blake2b_compress( blake2b_state *S,
   return 0;
 }
 
+#ifdef BLAKE2B_X86_SIMD
+
+/* message words x and y as the low and high half of a register, built from
+   the block's eight 128 bit words in mv. x and y are constants once a round
+   is spelled out, so each pair folds to a single shuffle */
+CYASSL_TARGET("sse4.1")
+static INLINE __m128i b2b_pair( const __m128i* mv, int x, int y )
+{
+  __m128i vx = mv[x >> 1];
+  __m128i vy = mv[y >> 1];
+
+  if( ( x >> 1 ) == ( y >> 1 ) )
+    return ( x & 1 ) ? _mm_shuffle_epi32( vx, _MM_SHUFFLE( 1, 0, 3, 2 ) ) : vx;
+
+  switch( ( ( x & 1 ) << 1 ) | ( y & 1 ) )
+  {
+    case 0:  return _mm_unpacklo_epi64( vx, vy );
+    case 1:  return _mm_blend_epi16( vx, vy, 0xF0 );
+    case 2:  return _mm_alignr_epi8( vy, vx, 8 );
+    default: return _mm_unpackhi_epi64( vx, vy );
+  }
+}
+
+/* the message words G steps i and j of round r take */
+#define B2B_M2(r, i, j) \
+  b2b_pair( mv, blake2b_sigma[r][i], blake2b_sigma[r][j] )
+
+#define B2B_ROTR32_SSE(x)  _mm_shuffle_epi32( (x), _MM_SHUFFLE( 2, 3, 0, 1 ) )
+#define B2B_ROTR24_SSE(x)  _mm_shuffle_epi8( (x), r24 )
+#define B2B_ROTR16_SSE(x)  _mm_shuffle_epi8( (x), r16 )
+#define B2B_ROTR63_SSE(x)  _mm_xor_si128( _mm_srli_epi64( (x), 63 ), \
+                                          _mm_add_epi64( (x), (x) ) )
+
+/* half a G on all four columns, each row split over two registers */
+#define B2B_HALF_SSE(bl, bh, ROTD, ROTB) \
+  do { \
+    row1l = _mm_add_epi64( _mm_add_epi64( row1l, (bl) ), row2l ); \
+    row1h = _mm_add_epi64( _mm_add_epi64( row1h, (bh) ), row2h ); \
+    row4l = ROTD( _mm_xor_si128( row4l, row1l ) ); \
+    row4h = ROTD( _mm_xor_si128( row4h, row1h ) ); \
+    row3l = _mm_add_epi64( row3l, row4l ); \
+    row3h = _mm_add_epi64( row3h, row4h ); \
+    row2l = ROTB( _mm_xor_si128( row2l, row3l ) ); \
+    row2h = ROTB( _mm_xor_si128( row2h, row3h ) ); \
+  } while(0)
+
+/* line the diagonals up as columns and back. Row 2 stays put, since a half
+   G finishes with it; row 1 turns right by a word, row 3 left by one and
+   row 4 by two, which is just a swap of its halves */
+#define B2B_DIAG_SSE() \
+  do { \
+    t0 = _mm_alignr_epi8( row1l, row1h, 8 ); \
+    t1 = _mm_alignr_epi8( row1h, row1l, 8 ); \
+    row1l = t0; row1h = t1; \
+    t0 = _mm_alignr_epi8( row3h, row3l, 8 ); \
+    t1 = _mm_alignr_epi8( row3l, row3h, 8 ); \
+    row3l = t0; row3h = t1; \
+    t0 = row4l; row4l = row4h; row4h = t0; \
+  } while(0)
+
+#define B2B_UNDIAG_SSE() \
+  do { \
+    t0 = _mm_alignr_epi8( row1h, row1l, 8 ); \
+    t1 = _mm_alignr_epi8( row1l, row1h, 8 ); \
+    row1l = t0; row1h = t1; \
+    t0 = _mm_alignr_epi8( row3l, row3h, 8 ); \
+    t1 = _mm_alignr_epi8( row3h, row3l, 8 ); \
+    row3l = t0; row3h = t1; \
+    t0 = row4l; row4l = row4h; row4h = t0; \
+  } while(0)
+
+/* rounds are spelled out so the sigma lookups fold into constant offsets */
+#define B2B_ROUND_SSE(r) \
+  do { \
+    B2B_HALF_SSE( B2B_M2( r, 0, 2 ), \
+                  B2B_M2( r, 4, 6 ), \
+                  B2B_ROTR32_SSE, B2B_ROTR24_SSE ); \
+    B2B_HALF_SSE( B2B_M2( r, 1, 3 ), \
+                  B2B_M2( r, 5, 7 ), \
+                  B2B_ROTR16_SSE, B2B_ROTR63_SSE ); \
+    B2B_DIAG_SSE(); \
+    B2B_HALF_SSE( B2B_M2( r, 14, 8 ), \
+                  B2B_M2( r, 10, 12 ), \
+                  B2B_ROTR32_SSE, B2B_ROTR24_SSE ); \
+    B2B_HALF_SSE( B2B_M2( r, 15, 9 ), \
+                  B2B_M2( r, 11, 13 ), \
+                  B2B_ROTR16_SSE, B2B_ROTR63_SSE ); \
+    B2B_UNDIAG_SSE(); \
+  } while(0)
+
+CYASSL_TARGET("sse4.1")
+static void blake2b_compress_sse41( blake2b_state *S,
+                                    const byte block[BLAKE2B_BLOCKBYTES] )
+{
+  const __m128i r16 = _mm_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1,
+                                     10, 11, 12, 13, 14, 15, 8, 9 );
+  const __m128i r24 = _mm_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2,
+                                     11, 12, 13, 14, 15, 8, 9, 10 );
+  __m128i row1l, row1h, row2l, row2h, row3l, row3h, row4l, row4h;
+  __m128i t0, t1;
+  __m128i mv[8];
+  int     i;
+
+  for( i = 0; i < 8; ++i )
+    mv[i] = _mm_loadu_si128( (const __m128i*)block + i );
+
+  row1l = _mm_loadu_si128( (const __m128i*)&S->h[0] );
+  row1h = _mm_loadu_si128( (const __m128i*)&S->h[2] );
+  row2l = _mm_loadu_si128( (const __m128i*)&S->h[4] );
+  row2h = _mm_loadu_si128( (const __m128i*)&S->h[6] );
+  row3l = _mm_loadu_si128( (const __m128i*)&blake2b_IV[0] );
+  row3h = _mm_loadu_si128( (const __m128i*)&blake2b_IV[2] );
+  row4l = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)&blake2b_IV[4] ),
+                         _mm_loadu_si128( (const __m128i*)&S->t[0] ) );
+  row4h = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)&blake2b_IV[6] ),
+                         _mm_loadu_si128( (const __m128i*)&S->f[0] ) );
+
+  B2B_ROUND_SSE( 0 );
+  B2B_ROUND_SSE( 1 );
+  B2B_ROUND_SSE( 2 );
+  B2B_ROUND_SSE( 3 );
+  B2B_ROUND_SSE( 4 );
+  B2B_ROUND_SSE( 5 );
+  B2B_ROUND_SSE( 6 );
+  B2B_ROUND_SSE( 7 );
+  B2B_ROUND_SSE( 8 );
+  B2B_ROUND_SSE( 9 );
+  B2B_ROUND_SSE( 10 );
+  B2B_ROUND_SSE( 11 );
+
+  row1l = _mm_xor_si128( row1l, row3l );
+  row1h = _mm_xor_si128( row1h, row3h );
+  row2l = _mm_xor_si128( row2l, row4l );
+  row2h = _mm_xor_si128( row2h, row4h );
+  _mm_storeu_si128( (__m128i*)&S->h[0], _mm_xor_si128( row1l,
+                    _mm_loadu_si128( (const __m128i*)&S->h[0] ) ) );
+  _mm_storeu_si128( (__m128i*)&S->h[2], _mm_xor_si128( row1h,
+                    _mm_loadu_si128( (const __m128i*)&S->h[2] ) ) );
+  _mm_storeu_si128( (__m128i*)&S->h[4], _mm_xor_si128( row2l,
+                    _mm_loadu_si128( (const __m128i*)&S->h[4] ) ) );
+  _mm_storeu_si128( (__m128i*)&S->h[6], _mm_xor_si128( row2h,
+                    _mm_loadu_si128( (const __m128i*)&S->h[6] ) ) );
+}
+
+
+#define B2B_ROTR32_AVX(x)  _mm256_shuffle_epi32( (x), _MM_SHUFFLE(2, 3, 0, 1) )
+#define B2B_ROTR24_AVX(x)  _mm256_shuffle_epi8( (x), r24 )
+#define B2B_ROTR16_AVX(x)  _mm256_shuffle_epi8( (x), r16 )
+#define B2B_ROTR63_AVX(x)  _mm256_xor_si256( _mm256_srli_epi64( (x), 63 ), \
+                                             _mm256_add_epi64( (x), (x) ) )
+
+#define B2B_HALF_AVX(b, ROTD, ROTB) \
+  do { \
+    row1 = _mm256_add_epi64( _mm256_add_epi64( row1, (b) ), row2 ); \
+    row4 = ROTD( _mm256_xor_si256( row4, row1 ) ); \
+    row3 = _mm256_add_epi64( row3, row4 ); \
+    row2 = ROTB( _mm256_xor_si256( row2, row3 ) ); \
+  } while(0)
+
+#define B2B_M4(r, a, b, c, d) \
+  _mm256_inserti128_si256( _mm256_castsi128_si256( B2B_M2( r, a, b ) ), \
+                           B2B_M2( r, c, d ), 1 )
+
+#define B2B_ROUND_AVX(r) \
+  do { \
+    B2B_HALF_AVX( B2B_M4( r, 0, 2, 4, 6 ), B2B_ROTR32_AVX, B2B_ROTR24_AVX ); \
+    B2B_HALF_AVX( B2B_M4( r, 1, 3, 5, 7 ), B2B_ROTR16_AVX, B2B_ROTR63_AVX ); \
+    row1 = _mm256_permute4x64_epi64( row1, _MM_SHUFFLE( 2, 1, 0, 3 ) ); \
+    row4 = _mm256_permute4x64_epi64( row4, _MM_SHUFFLE( 1, 0, 3, 2 ) ); \
+    row3 = _mm256_permute4x64_epi64( row3, _MM_SHUFFLE( 0, 3, 2, 1 ) ); \
+    B2B_HALF_AVX( B2B_M4( r, 14, 8, 10, 12 ), B2B_ROTR32_AVX, B2B_ROTR24_AVX ); \
+    B2B_HALF_AVX( B2B_M4( r, 15, 9, 11, 13 ), B2B_ROTR16_AVX, B2B_ROTR63_AVX ); \
+    row1 = _mm256_permute4x64_epi64( row1, _MM_SHUFFLE( 0, 3, 2, 1 ) ); \
+    row4 = _mm256_permute4x64_epi64( row4, _MM_SHUFFLE( 1, 0, 3, 2 ) ); \
+    row3 = _mm256_permute4x64_epi64( row3, _MM_SHUFFLE( 2, 1, 0, 3 ) ); \
+  } while(0)
+
+/* one row per register. The diagonal step turns rows 1, 3 and 4 rather
+   than row 2, which is the last one a half G finishes, so the permutes stay
+   off the dependency chain */
+CYASSL_TARGET("avx2")
+static void blake2b_compress_avx2( blake2b_state *S,
+                                   const byte block[BLAKE2B_BLOCKBYTES] )
+{
+  const __m256i r16 = _mm256_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1,
+                                        10, 11, 12, 13, 14, 15, 8, 9,
+                                        2, 3, 4, 5, 6, 7, 0, 1,
+                                        10, 11, 12, 13, 14, 15, 8, 9 );
+  const __m256i r24 = _mm256_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2,
+                                        11, 12, 13, 14, 15, 8, 9, 10,
+                                        3, 4, 5, 6, 7, 0, 1, 2,
+                                        11, 12, 13, 14, 15, 8, 9, 10 );
+  __m256i row1, row2, row3, row4, h1, h2;
+  __m128i mv[8];
+  int     i;
+
+  for( i = 0; i < 8; ++i )
+    mv[i] = _mm_loadu_si128( (const __m128i*)block + i );
+
+  row1 = h1 = _mm256_loadu_si256( (const __m256i*)&S->h[0] );
+  row2 = h2 = _mm256_loadu_si256( (const __m256i*)&S->h[4] );
+  row3 = _mm256_loadu_si256( (const __m256i*)&blake2b_IV[0] );
+  row4 = _mm256_xor_si256( _mm256_loadu_si256( (const __m256i*)&blake2b_IV[4] ),
+                           _mm256_loadu_si256( (const __m256i*)&S->t[0] ) );
+
+  B2B_ROUND_AVX( 0 );
+  B2B_ROUND_AVX( 1 );
+  B2B_ROUND_AVX( 2 );
+  B2B_ROUND_AVX( 3 );
+  B2B_ROUND_AVX( 4 );
+  B2B_ROUND_AVX( 5 );
+  B2B_ROUND_AVX( 6 );
+  B2B_ROUND_AVX( 7 );
+  B2B_ROUND_AVX( 8 );
+  B2B_ROUND_AVX( 9 );
+  B2B_ROUND_AVX( 10 );
+  B2B_ROUND_AVX( 11 );
+
+  _mm256_storeu_si256( (__m256i*)&S->h[0],
+                       _mm256_xor_si256( h1, _mm256_xor_si256( row1, row3 ) ) );
+  _mm256_storeu_si256( (__m256i*)&S->h[4],
+                       _mm256_xor_si256( h2, _mm256_xor_si256( row2, row4 ) ) );
+}
+
+#endif /* BLAKE2B_X86_SIMD */
+
+
+static int blake2b_compress( blake2b_state *S,
+                             const byte block[BLAKE2B_BLOCKBYTES] )
+{
+#ifdef BLAKE2B_X86_SIMD
+  word32 cpu = CyaSSL_GetCpuFeatures();
+
+  if( cpu & CYASSL_CPU_AVX2 )
+  {
+    blake2b_compress_avx2( S, block );
+    return 0;
+  }
+  if( cpu & CYASSL_CPU_SSE4_1 )
+  {
+    blake2b_compress_sse41( S, block );
+    return 0;
+  }
+#endif
+
+  return blake2b_compress_c( S, block );
+}
+
 /* inlen now in bytes */
 int blake2b_update( blake2b_state *S, const byte *in, word64 inlen )
 {
@@ -364,6 +618,319 @@ int blake2b( byte *out, const void *in, const void *key, const byte outlen,
   return blake2b_final( S, out, outlen );
 }
 
+
+/* BLAKE2bp: four leaves take the 128 byte blocks of the input in turn and a
+   root hashes their digests. A stripe of four blocks only goes to the leaves
+   once more than three blocks follow it, so every leaf keeps its last block
+   for final and all four sit at the same counter in between. */
+
+#define BLAKE2BP_LEAVES  4
+#define BLAKE2BP_STRIPE  ( BLAKE2BP_LEAVES * BLAKE2B_BLOCKBYTES )
+#define BLAKE2BP_KEEP    ( ( BLAKE2BP_LEAVES - 1 ) * BLAKE2B_BLOCKBYTES )
+
+#ifndef BLAKE2BP_THREAD_BYTES
+    #define BLAKE2BP_THREAD_BYTES (1024 * 1024)
+#endif
+
+#ifdef BLAKE2B_X86_SIMD
+
+#define B2B_G4(a, b, c, d, x, y) \
+  do { \
+    v[a] = _mm256_add_epi64( _mm256_add_epi64( v[a], v[b] ), (x) ); \
+    v[d] = B2B_ROTR32_AVX( _mm256_xor_si256( v[d], v[a] ) ); \
+    v[c] = _mm256_add_epi64( v[c], v[d] ); \
+    v[b] = B2B_ROTR24_AVX( _mm256_xor_si256( v[b], v[c] ) ); \
+    v[a] = _mm256_add_epi64( _mm256_add_epi64( v[a], v[b] ), (y) ); \
+    v[d] = B2B_ROTR16_AVX( _mm256_xor_si256( v[d], v[a] ) ); \
+    v[c] = _mm256_add_epi64( v[c], v[d] ); \
+    v[b] = B2B_ROTR63_AVX( _mm256_xor_si256( v[b], v[c] ) ); \
+  } while(0)
+
+/* n stripes, lane j of every register belongs to leaf j */
+CYASSL_TARGET("avx2")
+static void blake2bp_compress4_avx2( blake2bp_state *S, const byte *in,
+                                     word64 n )
+{
+  const __m256i r16 = _mm256_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1,
+                                        10, 11, 12, 13, 14, 15, 8, 9,
+                                        2, 3, 4, 5, 6, 7, 0, 1,
+                                        10, 11, 12, 13, 14, 15, 8, 9 );
+  const __m256i r24 = _mm256_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2,
+                                        11, 12, 13, 14, 15, 8, 9, 10,
+                                        3, 4, 5, 6, 7, 0, 1, 2,
+                                        11, 12, 13, 14, 15, 8, 9, 10 );
+  __m256i     h[8], v[16], m[16], t0, t1, t2, t3;
+  word64      w[BLAKE2BP_LEAVES];
+  const byte* s;
+  int         i, j, r;
+
+  for( i = 0; i < 8; ++i )
+    h[i] = _mm256_set_epi64x( (long long)S->S[3]->h[i],
+                              (long long)S->S[2]->h[i],
+                              (long long)S->S[1]->h[i],
+                              (long long)S->S[0]->h[i] );
+
+  while( n-- )
+  {
+    for( j = 0; j < BLAKE2BP_LEAVES; ++j )
+      blake2b_increment_counter( S->S[j], BLAKE2B_BLOCKBYTES );
+
+    /* 4x4 transposes so m[k] holds word k of each leaf's block */
+    for( i = 0; i < 16; i += 4 )
+    {
+      t0 = _mm256_loadu_si256( (const __m256i*)( in + 8 * i ) );
+      t1 = _mm256_loadu_si256( (const __m256i*)( in + 128 + 8 * i ) );
+      t2 = _mm256_loadu_si256( (const __m256i*)( in + 256 + 8 * i ) );
+      t3 = _mm256_loadu_si256( (const __m256i*)( in + 384 + 8 * i ) );
+      m[i]     = _mm256_unpacklo_epi64( t0, t1 );
+      m[i + 1] = _mm256_unpackhi_epi64( t0, t1 );
+      m[i + 2] = _mm256_unpacklo_epi64( t2, t3 );
+      m[i + 3] = _mm256_unpackhi_epi64( t2, t3 );
+      t0 = m[i];
+      t1 = m[i + 1];
+      m[i]     = _mm256_permute2x128_si256( t0, m[i + 2], 0x20 );
+      m[i + 1] = _mm256_permute2x128_si256( t1, m[i + 3], 0x20 );
+      m[i + 2] = _mm256_permute2x128_si256( t0, m[i + 2], 0x31 );
+      m[i + 3] = _mm256_permute2x128_si256( t1, m[i + 3], 0x31 );
+    }
+
+    for( i = 0; i < 8; ++i )
+      v[i] = h[i];
+    for( i = 0; i < 4; ++i )
+      v[i + 8] = _mm256_set1_epi64x( (long long)blake2b_IV[i] );
+    v[12] = _mm256_set1_epi64x( (long long)( S->S[0]->t[0] ^ blake2b_IV[4] ) );
+    v[13] = _mm256_set1_epi64x( (long long)( S->S[0]->t[1] ^ blake2b_IV[5] ) );
+    v[14] = _mm256_set1_epi64x( (long long)blake2b_IV[6] );
+    v[15] = _mm256_set1_epi64x( (long long)blake2b_IV[7] );
+
+    for( r = 0; r < 12; ++r )
+    {
+      s = blake2b_sigma[r];
+      B2B_G4( 0, 4,  8, 12, m[s[ 0]], m[s[ 1]] );
+      B2B_G4( 1, 5,  9, 13, m[s[ 2]], m[s[ 3]] );
+      B2B_G4( 2, 6, 10, 14, m[s[ 4]], m[s[ 5]] );
+      B2B_G4( 3, 7, 11, 15, m[s[ 6]], m[s[ 7]] );
+      B2B_G4( 0, 5, 10, 15, m[s[ 8]], m[s[ 9]] );
+      B2B_G4( 1, 6, 11, 12, m[s[10]], m[s[11]] );
+      B2B_G4( 2, 7,  8, 13, m[s[12]], m[s[13]] );
+      B2B_G4( 3, 4,  9, 14, m[s[14]], m[s[15]] );
+    }
+
+    for( i = 0; i < 8; ++i )
+      h[i] = _mm256_xor_si256( h[i], _mm256_xor_si256( v[i], v[i + 8] ) );
+
+    in += BLAKE2BP_STRIPE;
+  }
+
+  for( i = 0; i < 8; ++i )
+  {
+    _mm256_storeu_si256( (__m256i*)w, h[i] );
+    for( j = 0; j < BLAKE2BP_LEAVES; ++j )
+      S->S[j]->h[i] = w[j];
+  }
+}
+
+#endif /* BLAKE2B_X86_SIMD */
+
+
+/* one leaf's blocks out of n stripes */
+static int blake2bp_leaf( blake2b_state *S, const byte *in, word64 n )
+{
+  while( n-- )
+  {
+    blake2b_increment_counter( S, BLAKE2B_BLOCKBYTES );
+    if( blake2b_compress( S, in ) < 0 ) return -1;
+    in += BLAKE2BP_STRIPE;
+  }
+
+  return 0;
+}
+
+
+#if defined(CYASSL_BLAKE2BP_THREADS) && defined(CYASSL_PTHREADS)
+
+typedef struct Blake2bpJob {
+  blake2b_state* S;
+  const byte*    in;
+  word64         n;
+  int            ret;
+} Blake2bpJob;
+
+static void* blake2bp_leaf_thread( void* arg )
+{
+  Blake2bpJob* job = (Blake2bpJob*)arg;
+
+  job->ret = blake2bp_leaf( job->S, job->in, job->n );
+
+  return NULL;
+}
+
+/* leaves 1 to 3 on their own threads, leaf 0 on this one */
+static int blake2bp_stripes_threaded( blake2bp_state *S, const byte *in,
+                                      word64 n )
+{
+  Blake2bpJob job[BLAKE2BP_LEAVES];
+  pthread_t   tid[BLAKE2BP_LEAVES];
+  int         started[BLAKE2BP_LEAVES];
+  int         i, ret = 0;
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+  {
+    job[i].S   = S->S[i];
+    job[i].in  = in + i * BLAKE2B_BLOCKBYTES;
+    job[i].n   = n;
+    job[i].ret = 0;
+    started[i] = i > 0 &&
+                 pthread_create( &tid[i], NULL, blake2bp_leaf_thread,
+                                 &job[i] ) == 0;
+  }
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+    if( !started[i] ) blake2bp_leaf_thread( &job[i] );
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+  {
+    if( started[i] ) pthread_join( tid[i], NULL );
+    if( job[i].ret < 0 ) ret = -1;
+  }
+
+  return ret;
+}
+
+#endif /* CYASSL_BLAKE2BP_THREADS && CYASSL_PTHREADS */
+
+
+/* n stripes, none holding a leaf's last block */
+static int blake2bp_stripes( blake2bp_state *S, const byte *in, word64 n )
+{
+  int i;
+
+#if defined(CYASSL_BLAKE2BP_THREADS) && defined(CYASSL_PTHREADS)
+  if( n >= BLAKE2BP_THREAD_BYTES / BLAKE2BP_STRIPE )
+    return blake2bp_stripes_threaded( S, in, n );
+#endif
+
+#ifdef BLAKE2B_X86_SIMD
+  if( CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2 )
+  {
+    blake2bp_compress4_avx2( S, in, n );
+    return 0;
+  }
+#endif
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+    if( blake2bp_leaf( S->S[i], in + i * BLAKE2B_BLOCKBYTES, n ) < 0 )
+      return -1;
+
+  return 0;
+}
+
+
+static int blake2bp_init_node( blake2b_state *S, const byte outlen,
+                               word64 offset, byte depth )
+{
+  blake2b_param P[1];
+
+  P->digest_length = outlen;
+  P->key_length    = 0;
+  P->fanout        = BLAKE2BP_LEAVES;
+  P->depth         = 2;
+  store32( &P->leaf_length, 0 );
+  store64( &P->node_offset, offset );
+  P->node_depth    = depth;
+  P->inner_length  = BLAKE2B_OUTBYTES;
+  XMEMSET( P->reserved, 0, sizeof( P->reserved ) );
+  XMEMSET( P->salt,     0, sizeof( P->salt ) );
+  XMEMSET( P->personal, 0, sizeof( P->personal ) );
+  return blake2b_init_param( S, P );
+}
+
+
+int blake2bp_init( blake2bp_state *S, const byte outlen )
+{
+  int i;
+
+  if ( ( !outlen ) || ( outlen > BLAKE2B_OUTBYTES ) ) return -1;
+
+  XMEMSET( S->buf, 0, sizeof( S->buf ) );
+  S->buflen = 0;
+
+  if( blake2bp_init_node( S->R, outlen, 0, 1 ) < 0 ) return -1;
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+    if( blake2bp_init_node( S->S[i], outlen, i, 0 ) < 0 ) return -1;
+
+  S->R->last_node = 1;
+  S->S[BLAKE2BP_LEAVES - 1]->last_node = 1;
+  return 0;
+}
+
+
+int blake2bp_update( blake2bp_state *S, const byte *in, word64 inlen )
+{
+  while( inlen > 0 )
+  {
+    if( S->buflen == 0 && inlen > BLAKE2BP_STRIPE + BLAKE2BP_KEEP )
+    {
+      /* straight from the caller's buffer */
+      word64 n = ( inlen - BLAKE2BP_KEEP - 1 ) / BLAKE2BP_STRIPE;
+
+      if( blake2bp_stripes( S, in, n ) < 0 ) return -1;
+
+      in    += n * BLAKE2BP_STRIPE;
+      inlen -= n * BLAKE2BP_STRIPE;
+    }
+    else
+    {
+      word64 fill = sizeof( S->buf ) - S->buflen;
+
+      if( fill > inlen ) fill = inlen;
+
+      XMEMCPY( S->buf + S->buflen, in, (cyassl_word)fill );
+      S->buflen += fill;
+      in        += fill;
+      inlen     -= fill;
+
+      if( S->buflen > BLAKE2BP_STRIPE + BLAKE2BP_KEEP )
+      {
+        if( blake2bp_stripes( S, S->buf, 1 ) < 0 ) return -1;
+
+        S->buflen -= BLAKE2BP_STRIPE;
+        XMEMCPY( S->buf, S->buf + BLAKE2BP_STRIPE, (cyassl_word)S->buflen );
+      }
+    }
+  }
+
+  return 0;
+}
+
+
+int blake2bp_final( blake2bp_state *S, byte *out, byte outlen )
+{
+  byte   hash[BLAKE2BP_LEAVES][BLAKE2B_OUTBYTES];
+  word64 i, j, left;
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+  {
+    /* leaf i owns buffered blocks i and i + 4 */
+    for( j = i * BLAKE2B_BLOCKBYTES; j < S->buflen; j += BLAKE2BP_STRIPE )
+    {
+      left = S->buflen - j;
+      if( left > BLAKE2B_BLOCKBYTES ) left = BLAKE2B_BLOCKBYTES;
+
+      if( blake2b_update( S->S[i], S->buf + j, left ) < 0 ) return -1;
+    }
+
+    if( blake2b_final( S->S[i], hash[i], BLAKE2B_OUTBYTES ) < 0 ) return -1;
+  }
+
+  for( i = 0; i < BLAKE2BP_LEAVES; ++i )
+    if( blake2b_update( S->R, hash[i], BLAKE2B_OUTBYTES ) < 0 ) return -1;
+
+  return blake2b_final( S->R, out, outlen );
+}
+
+
 #if defined(BLAKE2B_SELFTEST)
 #include <string.h>
 #include "blake2-kat.h"
@@ -427,6 +994,31 @@ int Blake2bFinal(Blake2b* b2b, byte* final, word32 requestSz)
 }
 
 
+/* Init Blake2bp digest, same size rules as Blake2b */
+int InitBlake2bp(Blake2bp* b2bp, word32 digestSz)
+{
+    b2bp->digestSz = digestSz;
+
+    return blake2bp_init(b2bp->S, (byte)digestSz);
+}
+
+
+/* Blake2bp Update */
+int Blake2bpUpdate(Blake2bp* b2bp, const byte* data, word32 sz)
+{
+    return blake2bp_update(b2bp->S, data, sz);
+}
+
+
+/* Blake2bp Final, if pass in zero size we use init digestSz */
+int Blake2bpFinal(Blake2bp* b2bp, byte* final, word32 requestSz)
+{
+    word32 sz = requestSz ? requestSz : b2bp->digestSz;
+
+    return blake2bp_final(b2bp->S, final, (byte)sz);
+}
+
+
 /* end CTaoCrypt API */
 
 #endif  /* HAVE_BLAKE2 */
@@ -63,12 +63,18 @@
 #include <cyassl/ctaocrypt/camellia.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #ifdef NO_INLINE
     #include <cyassl/ctaocrypt/misc.h>
 #else
     #include <ctaocrypt/src/misc.c>
 #endif
 
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_CAMELLIA_SIMD)
+    #define CAMELLIA_X86_SIMD
+    #include <immintrin.h>
+#endif
+
 
 /* u32 must be 32bit word */
 typedef unsigned int u32;
@@ -1526,6 +1532,252 @@ static void Camellia_DecryptBlock(const int keyBitLength,
 
 
 
+#ifdef CAMELLIA_X86_SIMD
+
+/* 16 way CBC decrypt. The blocks are byte sliced, register j holds byte j of
+ * all 16 blocks, so the P function and the subkey whitening become register
+ * xors. Camellia's s1 is affine equivalent to the AES s-box: a nibble table
+ * shuffle maps the input into the AES field, AESENCLAST does the inversion,
+ * a second shuffle maps back. s4 folds its input rotation into the first
+ * table, s2 and s3 their output rotations into the second. The rounds follow
+ * camellia_decrypt128() and camellia_decrypt256() on the same subkeys. */
+
+/* each table is 16 low nibble entries followed by 16 high nibble entries */
+static const byte camPreS1[32] = {
+    0x08, 0x09, 0x11, 0x10, 0xb9, 0xb8, 0xa0, 0xa1,
+    0xa3, 0xa2, 0xba, 0xbb, 0x12, 0x13, 0x0b, 0x0a,
+    0x00, 0xa7, 0x93, 0x34, 0x61, 0xc6, 0xf2, 0x55,
+    0xd9, 0x7e, 0x4a, 0xed, 0xb8, 0x1f, 0x2b, 0x8c
+};
+
+static const byte camPreS4[32] = {
+    0x08, 0x11, 0xb9, 0xa0, 0xa3, 0xba, 0x12, 0x0b,
+    0xaf, 0xb6, 0x1e, 0x07, 0x04, 0x1d, 0xb5, 0xac,
+    0x00, 0x93, 0x61, 0xf2, 0xd9, 0x4a, 0xb8, 0x2b,
+    0x01, 0x92, 0x60, 0xf3, 0xd8, 0x4b, 0xb9, 0x2a
+};
+
+static const byte camPostS1[32] = {
+    0x11, 0x82, 0x84, 0x17, 0x3e, 0xad, 0xab, 0x38,
+    0x71, 0xe2, 0xe4, 0x77, 0x5e, 0xcd, 0xcb, 0x58,
+    0x00, 0xb8, 0xd9, 0x61, 0xa0, 0x18, 0x79, 0xc1,
+    0xa8, 0x10, 0x71, 0xc9, 0x08, 0xb0, 0xd1, 0x69
+};
+
+static const byte camPostS2[32] = {
+    0x22, 0x05, 0x09, 0x2e, 0x7c, 0x5b, 0x57, 0x70,
+    0xe2, 0xc5, 0xc9, 0xee, 0xbc, 0x9b, 0x97, 0xb0,
+    0x00, 0x71, 0xb3, 0xc2, 0x41, 0x30, 0xf2, 0x83,
+    0x51, 0x20, 0xe2, 0x93, 0x10, 0x61, 0xa3, 0xd2
+};
+
+static const byte camPostS3[32] = {
+    0x88, 0x41, 0x42, 0x8b, 0x1f, 0xd6, 0xd5, 0x1c,
+    0xb8, 0x71, 0x72, 0xbb, 0x2f, 0xe6, 0xe5, 0x2c,
+    0x00, 0x5c, 0xec, 0xb0, 0x50, 0x0c, 0xbc, 0xe0,
+    0x54, 0x08, 0xb8, 0xe4, 0x04, 0x58, 0xe8, 0xb4
+};
+
+/* undoes the ShiftRows that AESENCLAST applies before SubBytes */
+static const byte camInvShiftRows[16] = {
+    0x00, 0x0d, 0x0a, 0x07, 0x04, 0x01, 0x0e, 0x0b,
+    0x08, 0x05, 0x02, 0x0f, 0x0c, 0x09, 0x06, 0x03
+};
+
+#define CAM_XOR(a, b)     _mm_xor_si128((a), (b))
+#define CAM_KEY8(k, j)    _mm_set1_epi8((char)((k) >> (24 - 8 * (j))))
+
+
+CYASSL_TARGET("aes,avx")
+static INLINE __m128i CamSimdFilter(__m128i x, const byte* tab)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    __m128i lo = _mm_and_si128(x, mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+
+    return CAM_XOR(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)tab), lo),
+                   _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(tab + 16)),
+                                    hi));
+}
+
+
+CYASSL_TARGET("aes,avx")
+static INLINE __m128i CamSimdSbox(__m128i x, const byte* pre,
+                                  const byte* post)
+{
+    x = CamSimdFilter(x, pre);
+    x = _mm_shuffle_epi8(x,
+                         _mm_loadu_si128((const __m128i*)camInvShiftRows));
+    x = _mm_aesenclast_si128(x, _mm_setzero_si128());
+
+    return CamSimdFilter(x, post);
+}
+
+
+/* rotate the 32 bit words left by one, word byte 0 is the most significant */
+CYASSL_TARGET("aes,avx")
+static INLINE void CamSimdRol1(__m128i* t)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i msb[4];
+    int     j;
+
+    for (j = 0; j < 4; j++)
+        msb[j] = _mm_abs_epi8(_mm_cmpgt_epi8(zero, t[j]));
+    for (j = 0; j < 4; j++)
+        t[j] = _mm_or_si128(_mm_add_epi8(t[j], t[j]), msb[(j + 1) & 3]);
+}
+
+
+/* CAMELLIA_ROUNDSM, x and y each point at a 64 bit half */
+CYASSL_TARGET("aes,avx")
+static INLINE void CamSimdRound(const __m128i* x, __m128i* y, u32 kl, u32 kr)
+{
+    __m128i s1, s2, s3, s4, t;
+    __m128i il[4], ir[4];
+    int     j;
+
+    s1 = CamSimdSbox(x[0], camPreS1, camPostS1);
+    s2 = CamSimdSbox(x[1], camPreS1, camPostS2);
+    s3 = CamSimdSbox(x[2], camPreS1, camPostS3);
+    s4 = CamSimdSbox(x[3], camPreS4, camPostS1);
+    t  = CAM_XOR(s1, CAM_XOR(s2, CAM_XOR(s3, s4)));
+    il[0] = CAM_XOR(t, s2);
+    il[1] = CAM_XOR(t, s3);
+    il[2] = CAM_XOR(t, s4);
+    il[3] = CAM_XOR(t, s1);
+
+    s1 = CamSimdSbox(x[7], camPreS1, camPostS1);
+    s2 = CamSimdSbox(x[4], camPreS1, camPostS2);
+    s3 = CamSimdSbox(x[5], camPreS1, camPostS3);
+    s4 = CamSimdSbox(x[6], camPreS4, camPostS1);
+    t  = CAM_XOR(s1, CAM_XOR(s2, CAM_XOR(s3, s4)));
+    ir[0] = CAM_XOR(t, s2);
+    ir[1] = CAM_XOR(t, s3);
+    ir[2] = CAM_XOR(t, s4);
+    ir[3] = CAM_XOR(t, s1);
+
+    for (j = 0; j < 4; j++) {
+        il[j] = CAM_XOR(il[j], CAM_KEY8(kl, j));
+        ir[j] = CAM_XOR(ir[j], CAM_XOR(il[j], CAM_KEY8(kr, j)));
+    }
+
+    /* CAMELLIA_RR8 */
+    t     = il[3];
+    il[3] = il[2];
+    il[2] = il[1];
+    il[1] = il[0];
+    il[0] = t;
+
+    for (j = 0; j < 4; j++) {
+        y[j]     = CAM_XOR(y[j], ir[j]);
+        y[j + 4] = CAM_XOR(y[j + 4], CAM_XOR(il[j], ir[j]));
+    }
+}
+
+
+/* CAMELLIA_FLS */
+CYASSL_TARGET("aes,avx")
+static INLINE void CamSimdFls(__m128i* x, u32 kll, u32 klr, u32 krl, u32 krr)
+{
+    __m128i t[4];
+    int     j;
+
+    for (j = 0; j < 4; j++)
+        t[j] = _mm_and_si128(x[j], CAM_KEY8(kll, j));
+    CamSimdRol1(t);
+    for (j = 0; j < 4; j++) {
+        x[j + 4] = CAM_XOR(x[j + 4], t[j]);
+        x[j]     = CAM_XOR(x[j], _mm_or_si128(x[j + 4], CAM_KEY8(klr, j)));
+    }
+
+    for (j = 0; j < 4; j++) {
+        x[j + 8] = CAM_XOR(x[j + 8], _mm_or_si128(x[j + 12], CAM_KEY8(krr, j)));
+        t[j]     = _mm_and_si128(x[j + 8], CAM_KEY8(krl, j));
+    }
+    CamSimdRol1(t);
+    for (j = 0; j < 4; j++)
+        x[j + 12] = CAM_XOR(x[j + 12], t[j]);
+}
+
+
+/* 16x16 byte transpose, each pass rotates the 8 bit (register, byte) index
+ * left by one so four passes swap them */
+CYASSL_TARGET("aes,avx")
+static INLINE void CamSimdTranspose(__m128i* x)
+{
+    __m128i t[16];
+    int     i, pass;
+
+    for (pass = 0; pass < 4; pass++) {
+        for (i = 0; i < 8; i++) {
+            t[2 * i]     = _mm_unpacklo_epi8(x[i], x[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(x[i], x[i + 8]);
+        }
+        for (i = 0; i < 16; i++)
+            x[i] = t[i];
+    }
+}
+
+
+CYASSL_TARGET("aes,avx")
+static void CamelliaCbcDecrypt16(Camellia* cam, byte* out, const byte* in)
+{
+    const u32* subkey = cam->key;
+    __m128i    x[16], c[16], t;
+    int        i, k, rounds;
+
+    for (i = 0; i < 16; i++)
+        x[i] = c[i] = _mm_loadu_si128((const __m128i*)in + i);
+    CamSimdTranspose(x);
+
+    /* decryption walks the encryption subkeys backwards from kw3/kw4 */
+    k      = (cam->keySz == 128) ? 24 : 32;
+    rounds = (cam->keySz == 128) ? 18 : 24;
+
+    for (i = 0; i < 4; i++) {
+        x[i]     = CAM_XOR(x[i], CAM_KEY8(CamelliaSubkeyL(k), i));
+        x[i + 4] = CAM_XOR(x[i + 4], CAM_KEY8(CamelliaSubkeyR(k), i));
+    }
+
+    for (i = 0; i < rounds; i++) {
+        /* mirror of encryption's subkey 2 + i + 2 * (i / 6) */
+        int r = k - 1 - i - 2 * (i / 6);
+
+        if (i > 0 && i % 6 == 0)
+            CamSimdFls(x, CamelliaSubkeyL(r + 2), CamelliaSubkeyR(r + 2),
+                          CamelliaSubkeyL(r + 1), CamelliaSubkeyR(r + 1));
+
+        if (i & 1)
+            CamSimdRound(x + 8, x, CamelliaSubkeyL(r), CamelliaSubkeyR(r));
+        else
+            CamSimdRound(x, x + 8, CamelliaSubkeyL(r), CamelliaSubkeyR(r));
+    }
+
+    for (i = 0; i < 4; i++) {
+        x[i + 8]  = CAM_XOR(x[i + 8], CAM_KEY8(CamelliaSubkeyL(0), i));
+        x[i + 12] = CAM_XOR(x[i + 12], CAM_KEY8(CamelliaSubkeyR(0), i));
+    }
+
+    /* output is the right half first */
+    for (i = 0; i < 8; i++) {
+        t        = x[i];
+        x[i]     = x[i + 8];
+        x[i + 8] = t;
+    }
+    CamSimdTranspose(x);
+
+    t = _mm_loadu_si128((const __m128i*)cam->reg);
+    for (i = 0; i < 16; i++) {
+        _mm_storeu_si128((__m128i*)out + i, CAM_XOR(x[i], t));
+        t = c[i];
+    }
+    _mm_storeu_si128((__m128i*)cam->reg, t);
+}
+
+#endif /* CAMELLIA_X86_SIMD */
+
+
 /* CTaoCrypt wrappers to the Camellia code */
 
 int CamelliaSetKey(Camellia* cam, const byte* key, word32 len, const byte* iv)
@@ -1605,6 +1857,20 @@ void CamelliaCbcDecrypt(Camellia* cam, byte* out, const byte* in, word32 sz)
 {
     word32 blocks = sz / CAMELLIA_BLOCK_SIZE;
 
+#ifdef CAMELLIA_X86_SIMD
+    if (blocks >= 16 && (CyaSSL_GetCpuFeatures() &
+                (CYASSL_CPU_AESNI | CYASSL_CPU_AVX)) ==
+                (CYASSL_CPU_AESNI | CYASSL_CPU_AVX)) {
+        while (blocks >= 16) {
+            CamelliaCbcDecrypt16(cam, out, in);
+
+            out    += 16 * CAMELLIA_BLOCK_SIZE;
+            in     += 16 * CAMELLIA_BLOCK_SIZE;
+            blocks -= 16;
+        }
+    }
+#endif
+
     while (blocks--) {
         XMEMCPY(cam->tmp, in, CAMELLIA_BLOCK_SIZE);
         Camellia_DecryptBlock(cam->keySz, (byte*)cam->tmp, cam->key, out);
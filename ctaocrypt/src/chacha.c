@@ -46,6 +46,13 @@
     #include <stdio.h>
 #endif
 
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(BIG_ENDIAN_ORDER)
+    #define CHACHA_X86_SIMD
+    #include <immintrin.h>
+#endif
+
 #ifdef BIG_ENDIAN_ORDER
     #define LITTLE32(x) ByteReverseWord32(x)
 #else
@@ -55,6 +62,8 @@
 /* Number of rounds */
 #define ROUNDS  20
 
+#define CHACHA_BLOCK_BYTES 64
+
 #define U32C(v) (v##U)
 #define U32V(v) ((word32)(v) & U32C(0xFFFFFFFF))
 #define U8TO32_LITTLE(p) LITTLE32(((word32*)(p))[0])
@@ -202,6 +211,179 @@ static INLINE void Chacha_wordtobyte(word32 output[16], const word32 input[16])
     }
 }
 
+#ifdef CHACHA_X86_SIMD
+
+/* Several blocks at once, state word i of every block in one vector, so
+ * the quarter rounds run on 4 (SSE2) or 8 (AVX2) blocks side by side and
+ * the result is transposed back into keystream order before the XOR */
+
+#define SSE2_ROTL(v, n) \
+    _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define SSE2_QUARTERROUND(a,b,c,d) \
+  x[a] = _mm_add_epi32(x[a], x[b]); \
+  x[d] = SSE2_ROTL(_mm_xor_si128(x[d], x[a]), 16); \
+  x[c] = _mm_add_epi32(x[c], x[d]); \
+  x[b] = SSE2_ROTL(_mm_xor_si128(x[b], x[c]), 12); \
+  x[a] = _mm_add_epi32(x[a], x[b]); \
+  x[d] = SSE2_ROTL(_mm_xor_si128(x[d], x[a]),  8); \
+  x[c] = _mm_add_epi32(x[c], x[d]); \
+  x[b] = SSE2_ROTL(_mm_xor_si128(x[b], x[c]),  7);
+
+/* XOR 4 * 64 bytes of keystream per chunk */
+CYASSL_TARGET("sse2")
+static void Chacha_blocks4_sse2(word32* X, const byte* m, byte* c,
+                                word32 chunks)
+{
+    __m128i s[16], x[16], t0, t1, t2, t3;
+    int i, j;
+
+    for (i = 0; i < 16; i++)
+        s[i] = _mm_set1_epi32((int)X[i]);
+
+    while (chunks--) {
+        s[12] = _mm_add_epi32(_mm_set1_epi32((int)X[12]),
+                              _mm_set_epi32(3, 2, 1, 0));
+
+        for (i = 0; i < 16; i++)
+            x[i] = s[i];
+
+        for (i = ROUNDS; i > 0; i -= 2) {
+            SSE2_QUARTERROUND(0, 4,  8, 12)
+            SSE2_QUARTERROUND(1, 5,  9, 13)
+            SSE2_QUARTERROUND(2, 6, 10, 14)
+            SSE2_QUARTERROUND(3, 7, 11, 15)
+            SSE2_QUARTERROUND(0, 5, 10, 15)
+            SSE2_QUARTERROUND(1, 6, 11, 12)
+            SSE2_QUARTERROUND(2, 7,  8, 13)
+            SSE2_QUARTERROUND(3, 4,  9, 14)
+        }
+
+        for (i = 0; i < 16; i += 4) {
+            for (j = 0; j < 4; j++)
+                x[i+j] = _mm_add_epi32(x[i+j], s[i+j]);
+
+            /* words i..i+3 of blocks 0..3 */
+            t0 = _mm_unpacklo_epi32(x[i+0], x[i+1]);
+            t1 = _mm_unpacklo_epi32(x[i+2], x[i+3]);
+            t2 = _mm_unpackhi_epi32(x[i+0], x[i+1]);
+            t3 = _mm_unpackhi_epi32(x[i+2], x[i+3]);
+            x[i+0] = _mm_unpacklo_epi64(t0, t1);
+            x[i+1] = _mm_unpackhi_epi64(t0, t1);
+            x[i+2] = _mm_unpacklo_epi64(t2, t3);
+            x[i+3] = _mm_unpackhi_epi64(t2, t3);
+
+            for (j = 0; j < 4; j++) {
+                const byte* in  = m + j * CHACHA_BLOCK_BYTES + i * 4;
+                byte*       out = c + j * CHACHA_BLOCK_BYTES + i * 4;
+
+                _mm_storeu_si128((__m128i*)out, _mm_xor_si128(x[i+j],
+                                 _mm_loadu_si128((const __m128i*)in)));
+            }
+        }
+
+        X[12] += 4;
+        m += 4 * CHACHA_BLOCK_BYTES;
+        c += 4 * CHACHA_BLOCK_BYTES;
+    }
+}
+
+
+#define AVX2_ROTL(v, n) \
+    _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define AVX2_QUARTERROUND(a,b,c,d) \
+  x[a] = _mm256_add_epi32(x[a], x[b]); \
+  x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot16); \
+  x[c] = _mm256_add_epi32(x[c], x[d]); \
+  x[b] = AVX2_ROTL(_mm256_xor_si256(x[b], x[c]), 12); \
+  x[a] = _mm256_add_epi32(x[a], x[b]); \
+  x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot8); \
+  x[c] = _mm256_add_epi32(x[c], x[d]); \
+  x[b] = AVX2_ROTL(_mm256_xor_si256(x[b], x[c]),  7);
+
+/* XOR 8 * 64 bytes of keystream per chunk */
+CYASSL_TARGET("avx2")
+static void Chacha_blocks8_avx2(word32* X, const byte* m, byte* c,
+                                word32 chunks)
+{
+    const __m256i rot16 = _mm256_set_epi8(13,12,15,14, 9, 8,11,10,
+                                           5, 4, 7, 6, 1, 0, 3, 2,
+                                          13,12,15,14, 9, 8,11,10,
+                                           5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8  = _mm256_set_epi8(14,13,12,15,10, 9, 8,11,
+                                           6, 5, 4, 7, 2, 1, 0, 3,
+                                          14,13,12,15,10, 9, 8,11,
+                                           6, 5, 4, 7, 2, 1, 0, 3);
+    __m256i s[16], x[16], t0, t1, t2, t3;
+    int i, j;
+
+    for (i = 0; i < 16; i++)
+        s[i] = _mm256_set1_epi32((int)X[i]);
+
+    while (chunks--) {
+        s[12] = _mm256_add_epi32(_mm256_set1_epi32((int)X[12]),
+                                 _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+
+        for (i = 0; i < 16; i++)
+            x[i] = s[i];
+
+        for (i = ROUNDS; i > 0; i -= 2) {
+            AVX2_QUARTERROUND(0, 4,  8, 12)
+            AVX2_QUARTERROUND(1, 5,  9, 13)
+            AVX2_QUARTERROUND(2, 6, 10, 14)
+            AVX2_QUARTERROUND(3, 7, 11, 15)
+            AVX2_QUARTERROUND(0, 5, 10, 15)
+            AVX2_QUARTERROUND(1, 6, 11, 12)
+            AVX2_QUARTERROUND(2, 7,  8, 13)
+            AVX2_QUARTERROUND(3, 4,  9, 14)
+        }
+
+        /* per 128 bit lane transpose, x[i+j] then holds words i..i+3 of
+         * block j low and block j+4 high */
+        for (i = 0; i < 16; i += 4) {
+            for (j = 0; j < 4; j++)
+                x[i+j] = _mm256_add_epi32(x[i+j], s[i+j]);
+
+            t0 = _mm256_unpacklo_epi32(x[i+0], x[i+1]);
+            t1 = _mm256_unpacklo_epi32(x[i+2], x[i+3]);
+            t2 = _mm256_unpackhi_epi32(x[i+0], x[i+1]);
+            t3 = _mm256_unpackhi_epi32(x[i+2], x[i+3]);
+            x[i+0] = _mm256_unpacklo_epi64(t0, t1);
+            x[i+1] = _mm256_unpackhi_epi64(t0, t1);
+            x[i+2] = _mm256_unpacklo_epi64(t2, t3);
+            x[i+3] = _mm256_unpackhi_epi64(t2, t3);
+        }
+
+        for (j = 0; j < 4; j++) {
+            const byte* in  = m + j * CHACHA_BLOCK_BYTES;
+            byte*       out = c + j * CHACHA_BLOCK_BYTES;
+            const byte* in4  = in  + 4 * CHACHA_BLOCK_BYTES;
+            byte*       out4 = out + 4 * CHACHA_BLOCK_BYTES;
+
+            _mm256_storeu_si256((__m256i*)out, _mm256_xor_si256(
+                _mm256_permute2x128_si256(x[j], x[4+j], 0x20),
+                _mm256_loadu_si256((const __m256i*)in)));
+            _mm256_storeu_si256((__m256i*)(out + 32), _mm256_xor_si256(
+                _mm256_permute2x128_si256(x[8+j], x[12+j], 0x20),
+                _mm256_loadu_si256((const __m256i*)(in + 32))));
+            _mm256_storeu_si256((__m256i*)out4, _mm256_xor_si256(
+                _mm256_permute2x128_si256(x[j], x[4+j], 0x31),
+                _mm256_loadu_si256((const __m256i*)in4)));
+            _mm256_storeu_si256((__m256i*)(out4 + 32), _mm256_xor_si256(
+                _mm256_permute2x128_si256(x[8+j], x[12+j], 0x31),
+                _mm256_loadu_si256((const __m256i*)(in4 + 32))));
+        }
+
+        X[12] += 8;
+        m += 8 * CHACHA_BLOCK_BYTES;
+        c += 8 * CHACHA_BLOCK_BYTES;
+    }
+}
+
+#endif /* CHACHA_X86_SIMD */
+
+
 /**
   * Encrypt a stream of bytes
   */
@@ -214,6 +396,30 @@ static void Chacha_encrypt_bytes(ChaCha* ctx, const byte* m, byte* c,
 
     output = (byte*)temp;
 
+#ifdef CHACHA_X86_SIMD
+    {
+        word32 cpu = CyaSSL_GetCpuFeatures();
+        word32 chunk;
+
+        if ((cpu & CYASSL_CPU_AVX2) && bytes >= 8 * CHACHA_BLOCK_BYTES) {
+            chunk = bytes / (8 * CHACHA_BLOCK_BYTES);
+            Chacha_blocks8_avx2(ctx->X, m, c, chunk);
+            chunk *= 8 * CHACHA_BLOCK_BYTES;
+            bytes -= chunk;
+            m     += chunk;
+            c     += chunk;
+        }
+        if ((cpu & CYASSL_CPU_SSE2) && bytes >= 4 * CHACHA_BLOCK_BYTES) {
+            chunk = bytes / (4 * CHACHA_BLOCK_BYTES);
+            Chacha_blocks4_sse2(ctx->X, m, c, chunk);
+            chunk *= 4 * CHACHA_BLOCK_BYTES;
+            bytes -= chunk;
+            m     += chunk;
+            c     += chunk;
+        }
+    }
+#endif
+
     if (!bytes) return;
     for (;;) {
         Chacha_wordtobyte(temp, ctx->X);
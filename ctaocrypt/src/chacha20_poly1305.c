@@ -0,0 +1,231 @@
+/* chacha20_poly1305.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+
+#include <cyassl/ctaocrypt/chacha20_poly1305.h>
+#include <cyassl/ctaocrypt/poly1305.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
+#include <cyassl/ctaocrypt/logging.h>
+#ifdef NO_INLINE
+    #include <cyassl/ctaocrypt/misc.h>
+#else
+    #include <ctaocrypt/src/misc.c>
+#endif
+
+
+/* bytes enciphered and then MACed before moving on, small enough that the
+ * second pass reads from L1, a multiple of the ChaCha block so the counter
+ * runs on across chunks */
+#define CHACHA20_POLY1305_CHUNK 1024
+
+
+static int Poly1305Pad16(Poly1305* poly, word32 sz)
+{
+    byte zeros[POLY1305_BLOCK_SIZE];
+    word32 pad = (POLY1305_BLOCK_SIZE - (sz % POLY1305_BLOCK_SIZE)) %
+                 POLY1305_BLOCK_SIZE;
+
+    if (pad == 0)
+        return 0;
+
+    XMEMSET(zeros, 0, sizeof(zeros));
+    return Poly1305Update(poly, zeros, pad);
+}
+
+
+static void Store64LE(byte* out, word32 v)
+{
+    out[0] = (byte) v;
+    out[1] = (byte)(v >>  8);
+    out[2] = (byte)(v >> 16);
+    out[3] = (byte)(v >> 24);
+    out[4] = out[5] = out[6] = out[7] = 0;
+}
+
+
+static int ChaCha20Poly1305Process(ChaCha* chacha, const byte* iv,
+                                   const byte* aad, word32 aadSz,
+                                   const byte* in, word32 inSz, byte* out,
+                                   byte* tag, int encrypt)
+{
+    Poly1305 poly;
+    byte     polyKey[CHACHA20_POLY1305_AEAD_KEYSIZE];
+    byte     lengths[POLY1305_BLOCK_SIZE];
+    word32   left = inSz;
+    word32   chunk;
+    int      ret;
+
+    if (chacha == NULL || iv == NULL || tag == NULL ||
+        (aad == NULL && aadSz > 0) ||
+        ((in == NULL || out == NULL) && inSz > 0))
+        return BAD_FUNC_ARG;
+
+    /* block 0 keys the MAC, the message starts at block 1 */
+    XMEMSET(polyKey, 0, sizeof(polyKey));
+    ret = Chacha_SetIV(chacha, iv, 0);
+    if (ret == 0)
+        ret = Chacha_Process(chacha, polyKey, polyKey, sizeof(polyKey));
+    if (ret == 0)
+        ret = Poly1305SetKey(&poly, polyKey, sizeof(polyKey));
+    XMEMSET(polyKey, 0, sizeof(polyKey));
+
+    if (ret == 0 && aadSz > 0) {
+        ret = Poly1305Update(&poly, aad, aadSz);
+        if (ret == 0)
+            ret = Poly1305Pad16(&poly, aadSz);
+    }
+
+    while (ret == 0 && left > 0) {
+        chunk = left < CHACHA20_POLY1305_CHUNK ? left : CHACHA20_POLY1305_CHUNK;
+
+        /* the MAC always covers the ciphertext, in place works both ways */
+        if (encrypt) {
+            ret = Chacha_Process(chacha, out, in, chunk);
+            if (ret == 0)
+                ret = Poly1305Update(&poly, out, chunk);
+        }
+        else {
+            ret = Poly1305Update(&poly, in, chunk);
+            if (ret == 0)
+                ret = Chacha_Process(chacha, out, in, chunk);
+        }
+
+        in   += chunk;
+        out  += chunk;
+        left -= chunk;
+    }
+
+    if (ret == 0)
+        ret = Poly1305Pad16(&poly, inSz);
+
+    if (ret == 0) {
+        Store64LE(lengths, aadSz);
+        Store64LE(lengths + 8, inSz);
+        ret = Poly1305Update(&poly, lengths, sizeof(lengths));
+    }
+
+    if (ret == 0)
+        ret = Poly1305Final(&poly, tag);
+    else
+        XMEMSET(&poly, 0, sizeof(poly));
+
+    return ret;
+}
+
+
+int ChaCha20Poly1305_EncryptCtx(ChaCha* chacha, const byte* iv,
+                                const byte* aad, word32 aadSz,
+                                const byte* in, word32 inSz,
+                                byte* out, byte* authTag)
+{
+    CYASSL_ENTER("ChaCha20Poly1305_EncryptCtx");
+
+    return ChaCha20Poly1305Process(chacha, iv, aad, aadSz, in, inSz, out,
+                                   authTag, 1);
+}
+
+
+int ChaCha20Poly1305_DecryptCtx(ChaCha* chacha, const byte* iv,
+                                const byte* aad, word32 aadSz,
+                                const byte* in, word32 inSz,
+                                const byte* authTag, byte* out)
+{
+    byte calcTag[CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE];
+    byte diff = 0;
+    int  i;
+    int  ret;
+
+    CYASSL_ENTER("ChaCha20Poly1305_DecryptCtx");
+
+    if (authTag == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = ChaCha20Poly1305Process(chacha, iv, aad, aadSz, in, inSz, out,
+                                  calcTag, 0);
+    if (ret != 0)
+        return ret;
+
+    /* constant time, the plaintext never leaves on a bad tag */
+    for (i = 0; i < CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE; i++)
+        diff |= calcTag[i] ^ authTag[i];
+
+    if (diff != 0) {
+        CYASSL_MSG("ChaCha20-Poly1305 tag mismatch");
+        if (inSz > 0)
+            XMEMSET(out, 0, inSz);
+        ret = CHACHA_POLY_AUTH_E;
+    }
+    XMEMSET(calcTag, 0, sizeof(calcTag));
+
+    return ret;
+}
+
+
+int ChaCha20Poly1305_Encrypt(const byte* key, const byte* iv,
+                             const byte* aad, word32 aadSz,
+                             const byte* in, word32 inSz,
+                             byte* out, byte* authTag)
+{
+    ChaCha chacha;
+    int    ret;
+
+    if (key == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = Chacha_SetKey(&chacha, key, CHACHA20_POLY1305_AEAD_KEYSIZE);
+    if (ret == 0)
+        ret = ChaCha20Poly1305_EncryptCtx(&chacha, iv, aad, aadSz, in, inSz,
+                                          out, authTag);
+    XMEMSET(&chacha, 0, sizeof(chacha));
+
+    return ret;
+}
+
+
+int ChaCha20Poly1305_Decrypt(const byte* key, const byte* iv,
+                             const byte* aad, word32 aadSz,
+                             const byte* in, word32 inSz,
+                             const byte* authTag, byte* out)
+{
+    ChaCha chacha;
+    int    ret;
+
+    if (key == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = Chacha_SetKey(&chacha, key, CHACHA20_POLY1305_AEAD_KEYSIZE);
+    if (ret == 0)
+        ret = ChaCha20Poly1305_DecryptCtx(&chacha, iv, aad, aadSz, in, inSz,
+                                          authTag, out);
+    XMEMSET(&chacha, 0, sizeof(chacha));
+
+    return ret;
+}
+
+#endif /* HAVE_CHACHA && HAVE_POLY1305 */
@@ -30,6 +30,12 @@
 #include <cyassl/ctaocrypt/coding.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    #define BASE64_X86_SIMD
+    #include <immintrin.h>
+#endif
 
 
 enum {
@@ -53,10 +59,148 @@ const byte base64Decode[] = { 62, BAD, BAD, BAD, 63,   /* + starts at 0x2B */
                             };
 
 
+#ifdef BASE64_X86_SIMD
+
+/* Runs of 16 (SSSE3) or 32 (AVX2) characters at once, the high and low
+ * nibble lookups flag anything outside the alphabet, '=', white space and
+ * end of line included, which stops the run and is left to the byte code.
+ * Every 4 characters pack into 3 bytes, each store writes a whole vector so
+ * room must cover it. Returns characters consumed, a multiple of 16. */
+
+#define BASE64_SIMD_LUTS(set) \
+    const __m##set lutLo  = BASE64_SET(set, \
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A); \
+    const __m##set lutHi  = BASE64_SET(set, \
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10); \
+    const __m##set lutAdd = BASE64_SET(set, \
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0); \
+    const __m##set pack   = BASE64_SET(set, \
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+
+#define BASE64_SET(set, a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+    BASE64_SET_##set(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)
+#define BASE64_SET_128i(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+    _mm_setr_epi8(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)
+#define BASE64_SET_256i(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+    _mm256_setr_epi8(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, \
+                     a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)
+
+
+CYASSL_TARGET("ssse3")
+static word32 Base64_Decode_ssse3(const byte* in, word32 inLen, byte* out,
+                                  word32 room)
+{
+    BASE64_SIMD_LUTS(128i);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+    const __m128i zero   = _mm_setzero_si128();
+    word32 done = 0;
+
+    while (inLen - done >= 16 && room >= 16) {
+        __m128i str = _mm_loadu_si128((const __m128i*)(in + done));
+        __m128i hiN = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+        __m128i bad = _mm_and_si128(_mm_shuffle_epi8(lutLo,
+                                                _mm_and_si128(str, mask2F)),
+                                    _mm_shuffle_epi8(lutHi, hiN));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, zero)) != 0xFFFF)
+            break;
+
+        /* '/' shares '+' and the digits' high nibble, step it off by one */
+        str = _mm_add_epi8(str, _mm_shuffle_epi8(lutAdd,
+                            _mm_add_epi8(_mm_cmpeq_epi8(str, mask2F), hiN)));
+        str = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        str = _mm_madd_epi16(str, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(str, pack));
+
+        done += 16;
+        out  += 12;
+        room -= 12;
+    }
+
+    return done;
+}
+
+
+CYASSL_TARGET("avx2")
+static word32 Base64_Decode_avx2(const byte* in, word32 inLen, byte* out,
+                                 word32 room)
+{
+    BASE64_SIMD_LUTS(256i);
+    const __m256i mask2F = _mm256_set1_epi8(0x2F);
+    const __m256i zero   = _mm256_setzero_si256();
+    const __m256i lanes  = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    word32 done = 0;
+
+    while (inLen - done >= 32 && room >= 32) {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(in + done));
+        __m256i hiN = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+        __m256i bad = _mm256_and_si256(_mm256_shuffle_epi8(lutLo,
+                                            _mm256_and_si256(str, mask2F)),
+                                       _mm256_shuffle_epi8(lutHi, hiN));
+
+        if ((word32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bad, zero)) !=
+                                                                  0xFFFFFFFF)
+            break;
+
+        str = _mm256_add_epi8(str, _mm256_shuffle_epi8(lutAdd,
+                      _mm256_add_epi8(_mm256_cmpeq_epi8(str, mask2F), hiN)));
+        str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+        str = _mm256_shuffle_epi8(str, pack);
+        /* each lane has 12 bytes at the bottom, close the gap between */
+        _mm256_storeu_si256((__m256i*)out,
+                            _mm256_permutevar8x32_epi32(str, lanes));
+
+        done += 32;
+        out  += 24;
+        room -= 24;
+    }
+
+    /* clean upper halves before the legacy SSE tail, else every one of its
+       instructions pays for the mixed state */
+    _mm256_zeroupper();
+
+    return done + Base64_Decode_ssse3(in + done, inLen - done, out, room);
+}
+
+#endif /* BASE64_X86_SIMD */
+
+
+/* after a quantum, eat one line ending with any trailing spaces before it */
+static int Base64_EndLine(const byte* in, word32* j, word32* inLen)
+{
+    if (*inLen && (in[*j] == ' ' || in[*j] == '\r' || in[*j] == '\n')) {
+        byte endLine = in[(*j)++];
+        (*inLen)--;
+        while (*inLen && endLine == ' ') {   /* allow trailing whitespace */
+            endLine = in[(*j)++];
+            (*inLen)--;
+        }
+        if (endLine == '\r') {
+            if (*inLen) {
+                endLine = in[(*j)++];
+                (*inLen)--;
+            }
+        }
+        if (endLine != '\n') {
+            CYASSL_MSG("Bad end of line in Base64 Decode");
+            return ASN_INPUT_E;
+        }
+    }
+
+    return 0;
+}
+
+
 int Base64_Decode(const byte* in, word32 inLen, byte* out, word32* outLen)
 {
     word32 i = 0;
     word32 j = 0;
+#ifdef BASE64_X86_SIMD
+    word32 cpu = CyaSSL_GetCpuFeatures();
+#endif
     word32 plainSz = inLen - ((inLen + (PEM_LINE_SZ - 1)) / PEM_LINE_SZ );
     const byte maxIdx = (byte)sizeof(base64Decode) + 0x2B - 1;
 
@@ -65,14 +209,36 @@ int Base64_Decode(const byte* in, word32 inLen, byte* out, word32* outLen)
 
     while (inLen > 3) {
         byte b1, b2, b3;
-        byte e1 = in[j++];
-        byte e2 = in[j++];
-        byte e3 = in[j++];
-        byte e4 = in[j++];
+        byte e1, e2, e3, e4;
 
         int pad3 = 0;
         int pad4 = 0;
 
+    #ifdef BASE64_X86_SIMD
+        if (cpu & (CYASSL_CPU_AVX2 | CYASSL_CPU_SSSE3)) {
+            word32 done;
+
+            if (cpu & CYASSL_CPU_AVX2)
+                done = Base64_Decode_avx2(in + j, inLen, out + i, *outLen - i);
+            else
+                done = Base64_Decode_ssse3(in + j, inLen, out + i, *outLen - i);
+
+            if (done) {
+                j     += done;
+                i     += done / 4 * 3;
+                inLen -= done;
+                if (Base64_EndLine(in, &j, &inLen) != 0)
+                    return ASN_INPUT_E;
+                continue;
+            }
+        }
+    #endif
+
+        e1 = in[j++];
+        e2 = in[j++];
+        e3 = in[j++];
+        e4 = in[j++];
+
         if (e1 == 0)            /* end file 0's */
             break;
         if (e3 == PAD)
@@ -108,24 +274,8 @@ int Base64_Decode(const byte* in, word32 inLen, byte* out, word32* outLen)
             break;
         
         inLen -= 4;
-        if (inLen && (in[j] == ' ' || in[j] == '\r' || in[j] == '\n')) {
-            byte endLine = in[j++];
-            inLen--;
-            while (inLen && endLine == ' ') {   /* allow trailing whitespace */
-                endLine = in[j++];
-                inLen--;
-            }
-            if (endLine == '\r') {
-                if (inLen) {
-                    endLine = in[j++];
-                    inLen--;
-                }
-            }
-            if (endLine != '\n') {
-                CYASSL_MSG("Bad end of line in Base64 Decode");
-                return ASN_INPUT_E;
-            }
-        }
+        if (Base64_EndLine(in, &j, &inLen) != 0)
+            return ASN_INPUT_E;
     }
     *outLen = i;
 
@@ -165,5 +165,204 @@ int DeCompress(byte* out, word32 outSz, const byte* in, word32 inSz)
 }
 
 
+/* zlib's own sizing, window and hash tables plus its state structs */
+#define DEFLATE_STREAM_OVERHEAD (6 * 1024)
+#define INFLATE_STREAM_OVERHEAD (7 * 1024)
+#define STREAM_MIN_WINDOWBITS   9
+#define STREAM_DEF_MEMLEVEL     8
+
+static word32 StreamMemory(int type, int windowBits, int memLevel)
+{
+    if (type == COMPRESS_STREAM_INFLATE)
+        return (1UL << windowBits) + INFLATE_STREAM_OVERHEAD;
+
+    return (1UL << (windowBits + 2)) + (1UL << (memLevel + 9)) +
+           DEFLATE_STREAM_OVERHEAD;
+}
+
+
+/* largest window and hash that fit memBudget, 0 on success */
+static int StreamParams(int type, word32 memBudget, int* windowBits,
+                        int* memLevel)
+{
+    *windowBits = MAX_WBITS;
+    *memLevel   = STREAM_DEF_MEMLEVEL;
+
+    if (memBudget == 0)
+        return 0;
+
+    while (StreamMemory(type, *windowBits, *memLevel) > memBudget) {
+        /* keep the hash roughly in step with the window as both shrink */
+        if (type == COMPRESS_STREAM_DEFLATE && *memLevel > 1 &&
+                                               *memLevel > *windowBits - 7)
+            (*memLevel)--;
+        else if (*windowBits > STREAM_MIN_WINDOWBITS)
+            (*windowBits)--;
+        else if (type == COMPRESS_STREAM_DEFLATE && *memLevel > 1)
+            (*memLevel)--;
+        else
+            return -1;
+    }
+
+    return 0;
+}
+
+
+/* Set up a persistent stream of type, 0 on success. An inflate stream with a
+ * budget smaller than the peer's window will fail on that peer's data. */
+int CompressStreamInit(CompressStream* cs, int type, word32 memBudget,
+                       void* heap)
+{
+    int windowBits, memLevel;
+
+    if (cs == NULL || (type != COMPRESS_STREAM_DEFLATE &&
+                       type != COMPRESS_STREAM_INFLATE))
+        return BAD_FUNC_ARG;
+
+    XMEMSET(cs, 0, sizeof(CompressStream));
+    cs->type = (byte)type;
+    cs->stream.zalloc = (alloc_func)myAlloc;
+    cs->stream.zfree  = (free_func)myFree;
+    cs->stream.opaque = (voidpf)heap;
+
+    if (type == COMPRESS_STREAM_DEFLATE) {
+        if (StreamParams(type, memBudget, &windowBits, &memLevel) != 0)
+            return COMPRESS_INIT_E;
+        if (deflateInit2(&cs->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         windowBits, memLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+            return COMPRESS_INIT_E;
+    }
+    else {
+        if (StreamParams(type, memBudget, &windowBits, &memLevel) != 0)
+            return DECOMPRESS_INIT_E;
+        if (inflateInit2(&cs->stream, windowBits) != Z_OK)
+            return DECOMPRESS_INIT_E;
+    }
+    cs->init = 1;
+
+    return 0;
+}
+
+
+/* Preset dictionary, both ends must use the same one. Deflate takes it now,
+ * inflate when the stream asks for it. dict must outlive the stream. */
+int CompressStreamSetDictionary(CompressStream* cs, const byte* dict,
+                                word32 dictSz)
+{
+    if (cs == NULL || !cs->init || dict == NULL || dictSz == 0)
+        return BAD_FUNC_ARG;
+
+    cs->dict   = dict;
+    cs->dictSz = dictSz;
+
+    if (cs->type == COMPRESS_STREAM_DEFLATE &&
+            deflateSetDictionary(&cs->stream, dict, dictSz) != Z_OK)
+        return COMPRESS_INIT_E;
+
+    return 0;
+}
+
+
+/* Run in through the stream with a sync flush, returns bytes stored in out
+ * or negative error. All of in must be consumed and flushed into out. */
+int CompressStreamUpdate(CompressStream* cs, byte* out, word32 outSz,
+                         const byte* in, word32 inSz)
+{
+    uLong currTotal;
+    int   err;
+
+    if (cs == NULL || !cs->init || out == NULL || (in == NULL && inSz != 0))
+        return BAD_FUNC_ARG;
+
+    currTotal = cs->stream.total_out;
+
+    cs->stream.next_in   = (Bytef*)in;
+    cs->stream.avail_in  = (uInt)inSz;
+    cs->stream.next_out  = out;
+    cs->stream.avail_out = (uInt)outSz;
+
+    if (cs->type == COMPRESS_STREAM_DEFLATE) {
+        err = deflate(&cs->stream, Z_SYNC_FLUSH);
+        if (err != Z_OK && err != Z_STREAM_END)
+            return COMPRESS_E;
+        /* a full out may still hold back flushed bytes */
+        if (cs->stream.avail_in != 0 || cs->stream.avail_out == 0)
+            return BUFFER_E;
+    }
+    else {
+        err = inflate(&cs->stream, Z_SYNC_FLUSH);
+        if (err == Z_NEED_DICT && cs->dict != NULL) {
+            if (inflateSetDictionary(&cs->stream, cs->dict, cs->dictSz)
+                                                                    != Z_OK)
+                return DECOMPRESS_E;
+            err = inflate(&cs->stream, Z_SYNC_FLUSH);
+        }
+        if (err != Z_OK && err != Z_STREAM_END)
+            return DECOMPRESS_E;
+        if (cs->stream.avail_in != 0)
+            return BUFFER_E;
+    }
+
+    return (int)(cs->stream.total_out - currTotal);
+}
+
+
+/* Finish a deflate stream, returns bytes stored in out or negative error */
+int CompressStreamFinal(CompressStream* cs, byte* out, word32 outSz)
+{
+    uLong currTotal;
+
+    if (cs == NULL || !cs->init || out == NULL ||
+                                   cs->type != COMPRESS_STREAM_DEFLATE)
+        return BAD_FUNC_ARG;
+
+    currTotal = cs->stream.total_out;
+
+    cs->stream.next_in   = NULL;
+    cs->stream.avail_in  = 0;
+    cs->stream.next_out  = out;
+    cs->stream.avail_out = (uInt)outSz;
+
+    if (deflate(&cs->stream, Z_FINISH) != Z_STREAM_END)
+        return BUFFER_E;
+
+    return (int)(cs->stream.total_out - currTotal);
+}
+
+
+/* Start a new stream keeping the window and tables already allocated, the
+ * preset dictionary carries over */
+int CompressStreamReset(CompressStream* cs)
+{
+    if (cs == NULL || !cs->init)
+        return BAD_FUNC_ARG;
+
+    if (cs->type == COMPRESS_STREAM_DEFLATE) {
+        if (deflateReset(&cs->stream) != Z_OK)
+            return COMPRESS_INIT_E;
+        if (cs->dict != NULL &&
+                deflateSetDictionary(&cs->stream, cs->dict, cs->dictSz) != Z_OK)
+            return COMPRESS_INIT_E;
+    }
+    else if (inflateReset(&cs->stream) != Z_OK)
+        return DECOMPRESS_INIT_E;
+
+    return 0;
+}
+
+
+void CompressStreamFree(CompressStream* cs)
+{
+    if (cs == NULL || !cs->init)
+        return;
+
+    if (cs->type == COMPRESS_STREAM_DEFLATE)
+        deflateEnd(&cs->stream);
+    else
+        inflateEnd(&cs->stream);
+    cs->init = 0;
+}
+
+
 #endif /* HAVE_LIBZ */
 
@@ -0,0 +1,169 @@
+/* cpuid.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#ifdef HAVE_CYASSL_CPUID
+
+#ifdef __aarch64__
+
+#include <sys/auxv.h>
+
+/* AT_HWCAP bits, as in the kernel's asm/hwcap.h */
+enum {
+    ARM_HWCAP_ASIMD = 1 << 1,
+    ARM_HWCAP_AES   = 1 << 3,
+    ARM_HWCAP_PMULL = 1 << 4,
+    ARM_HWCAP_SHA1  = 1 << 5,
+    ARM_HWCAP_SHA2  = 1 << 6
+};
+
+
+static word32 ProbeCpuFeatures(void)
+{
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    word32 flags = 0;
+
+    if (hwcap & ARM_HWCAP_ASIMD) flags |= CYASSL_CPU_ARM_NEON;
+    if (hwcap & ARM_HWCAP_AES)   flags |= CYASSL_CPU_ARM_AES;
+    if (hwcap & ARM_HWCAP_PMULL) flags |= CYASSL_CPU_ARM_PMULL;
+    if (hwcap & ARM_HWCAP_SHA1)  flags |= CYASSL_CPU_ARM_SHA1;
+    if (hwcap & ARM_HWCAP_SHA2)  flags |= CYASSL_CPU_ARM_SHA2;
+
+    return flags;
+}
+
+#else /* x86 */
+
+#ifndef _MSC_VER
+
+    #define cpuid(reg, leaf, sub)\
+        __asm__ __volatile__ ("cpuid":\
+             "=a" (reg[0]), "=b" (reg[1]), "=c" (reg[2]), "=d" (reg[3]) :\
+             "a" (leaf), "c" (sub));
+
+    static word32 xgetbv0(void)
+    {
+        word32 eax, edx;
+        __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" :
+                              "=a" (eax), "=d" (edx) : "c" (0));
+        (void)edx;
+        return eax;
+    }
+#else
+
+    #include <intrin.h>
+    #define cpuid(a,b,c) __cpuidex((int*)a,b,c)
+
+    static word32 xgetbv0(void)
+    {
+        return (word32)_xgetbv(0);
+    }
+#endif /* _MSC_VER */
+
+
+static word32 ProbeCpuFeatures(void)
+{
+    unsigned int reg[4];  /* put a,b,c,d into 0,1,2,3 */
+    word32 flags = 0;
+    word32 maxLeaf;
+    int    osYmm = 0;
+    int    osZmm = 0;
+
+    cpuid(reg, 0, 0);
+    maxLeaf = reg[0];
+    if (maxLeaf < 1)
+        return 0;
+
+    cpuid(reg, 1, 0);
+    if (reg[3] & (1 << 26)) flags |= CYASSL_CPU_SSE2;
+    if (reg[2] & (1 <<  9)) flags |= CYASSL_CPU_SSSE3;
+    if (reg[2] & (1 << 19)) flags |= CYASSL_CPU_SSE4_1;
+    if (reg[2] & (1 << 25)) flags |= CYASSL_CPU_AESNI;
+    if (reg[2] & (1 <<  1)) flags |= CYASSL_CPU_PCLMUL;
+
+    /* the wide registers are only usable if the OS saves them, OSXSAVE */
+    if (reg[2] & (1 << 27)) {
+        word32 xcr0 = xgetbv0();
+
+        osYmm = (xcr0 & 0x06) == 0x06;
+        osZmm = (xcr0 & 0xE6) == 0xE6;
+    }
+    if (osYmm && (reg[2] & (1 << 28)))
+        flags |= CYASSL_CPU_AVX;
+
+    if (maxLeaf >= 7) {
+        cpuid(reg, 7, 0);
+        if (osYmm && (reg[1] & (1 <<  5))) flags |= CYASSL_CPU_AVX2;
+        if (reg[1] & (1 <<  8))            flags |= CYASSL_CPU_BMI2;
+        if (reg[1] & (1 << 19))            flags |= CYASSL_CPU_ADX;
+        if (reg[1] & (1 << 29))            flags |= CYASSL_CPU_SHA;
+        if (osZmm && (reg[1] & (1 << 16))) flags |= CYASSL_CPU_AVX512F;
+        if (osYmm && (reg[2] & (1 <<  9))) flags |= CYASSL_CPU_VAES;
+    }
+
+    return flags;
+}
+
+#endif /* __aarch64__ */
+
+
+static word32 cpuFeatures = 0;
+static word32 cpuMask     = 0xFFFFFFFF;
+static int    cpuProbed   = 0;
+
+#endif /* HAVE_CYASSL_CPUID */
+
+
+/* features of the running cpu that the implementations may use, each
+ * primitive picks its variant from these when its key or state is set up */
+word32 CyaSSL_GetCpuFeatures(void)
+{
+#ifdef HAVE_CYASSL_CPUID
+    if (cpuProbed == 0) {
+        cpuFeatures = ProbeCpuFeatures();
+        cpuProbed   = 1;
+    }
+
+    return cpuFeatures & cpuMask;
+#else
+    return 0;
+#endif
+}
+
+
+/* limit the features used from now on to those in mask, e.g. 0 to force
+ * the generic C code for testing or benchmarking */
+void CyaSSL_SetCpuFeatureMask(word32 mask)
+{
+#ifdef HAVE_CYASSL_CPUID
+    cpuMask = mask;
+#else
+    (void)mask;
+#endif
+}
+
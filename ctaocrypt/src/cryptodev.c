@@ -0,0 +1,220 @@
+/* cryptodev.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#ifdef CYASSL_CRYPTO_DEV
+
+#include <cyassl/ctaocrypt/cryptodev.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
+
+
+typedef struct CryptoDevice {
+    int               devId;
+    CryptoDevCallback cb;              /* NULL for a free slot */
+    void*             ctx;
+} CryptoDevice;
+
+static CryptoDevice cryptoDevices[CRYPTO_DEV_MAX_DEVICES];
+
+
+static CryptoDevice* CryptoDevFind(int devId)
+{
+    int i;
+
+    for (i = 0; i < CRYPTO_DEV_MAX_DEVICES; i++)
+        if (cryptoDevices[i].cb != NULL && cryptoDevices[i].devId == devId)
+            return &cryptoDevices[i];
+
+    return NULL;
+}
+
+
+int CryptoDev_RegisterDevice(int devId, CryptoDevCallback cb, void* ctx)
+{
+    CryptoDevice* dev;
+    int i;
+
+    if (cb == NULL)
+        return BAD_FUNC_ARG;
+
+    dev = CryptoDevFind(devId);
+    for (i = 0; dev == NULL && i < CRYPTO_DEV_MAX_DEVICES; i++)
+        if (cryptoDevices[i].cb == NULL)
+            dev = &cryptoDevices[i];
+
+    if (dev == NULL)
+        return MEMORY_E;
+
+    dev->devId = devId;
+    dev->ctx   = ctx;
+    dev->cb    = cb;
+
+    return 0;
+}
+
+
+void CryptoDev_UnRegisterDevice(int devId)
+{
+    CryptoDevice* dev = CryptoDevFind(devId);
+
+    if (dev != NULL)
+        XMEMSET(dev, 0, sizeof(CryptoDevice));
+}
+
+
+static int CryptoDevProcess(int devId, CryptoDevInfo* info)
+{
+    CryptoDevice* dev = CryptoDevFind(devId);
+
+    if (dev == NULL)
+        return CRYPTO_DEV_UNAVAILABLE_E;
+
+    return dev->cb(devId, info, dev->ctx);
+}
+
+
+#ifndef NO_AES
+
+int CryptoDev_AesGcm(Aes* aes, int enc, byte* out, const byte* in, word32 sz,
+                     const byte* iv, word32 ivSz,
+                     byte* authTag, word32 authTagSz,
+                     const byte* authIn, word32 authInSz)
+{
+    CryptoDevInfo info;
+
+    info.algo = enc ? CRYPTO_DEV_AES_GCM_ENC : CRYPTO_DEV_AES_GCM_DEC;
+    info.u.aesGcm.aes       = aes;
+    info.u.aesGcm.out       = out;
+    info.u.aesGcm.in        = in;
+    info.u.aesGcm.sz        = sz;
+    info.u.aesGcm.iv        = iv;
+    info.u.aesGcm.ivSz      = ivSz;
+    info.u.aesGcm.authTag   = authTag;
+    info.u.aesGcm.authTagSz = authTagSz;
+    info.u.aesGcm.authIn    = authIn;
+    info.u.aesGcm.authInSz  = authInSz;
+
+    return CryptoDevProcess(aes->cdevId, &info);
+}
+
+#endif /* NO_AES */
+
+
+#ifndef NO_HMAC
+
+int CryptoDev_Hmac(Hmac* hmac, int macType, const byte* key, word32 keySz,
+                   const byte* in, word32 inSz, byte* digest)
+{
+    CryptoDevInfo info;
+
+    info.algo = CRYPTO_DEV_HMAC;
+    info.u.hmac.hmac    = hmac;
+    info.u.hmac.macType = macType;
+    info.u.hmac.key     = key;
+    info.u.hmac.keySz   = keySz;
+    info.u.hmac.in      = in;
+    info.u.hmac.inSz    = inSz;
+    info.u.hmac.digest  = digest;
+
+    return CryptoDevProcess(hmac->cdevId, &info);
+}
+
+#endif /* NO_HMAC */
+
+
+#ifndef NO_RSA
+
+int CryptoDev_Rsa(RsaKey* key, int type, const byte* in, word32 inSz,
+                  byte* out, word32* outSz, RNG* rng)
+{
+    CryptoDevInfo info;
+
+    info.algo = CRYPTO_DEV_RSA;
+    info.u.rsa.key   = key;
+    info.u.rsa.type  = type;
+    info.u.rsa.in    = in;
+    info.u.rsa.inSz  = inSz;
+    info.u.rsa.out   = out;
+    info.u.rsa.outSz = outSz;
+    info.u.rsa.rng   = rng;
+
+    return CryptoDevProcess(key->cdevId, &info);
+}
+
+#endif /* NO_RSA */
+
+
+#ifdef HAVE_ECC
+
+int CryptoDev_EccSign(ecc_key* key, const byte* in, word32 inSz, byte* out,
+                      word32* outSz, RNG* rng)
+{
+    CryptoDevInfo info;
+
+    info.algo = CRYPTO_DEV_ECC_SIGN;
+    info.u.eccSign.key   = key;
+    info.u.eccSign.in    = in;
+    info.u.eccSign.inSz  = inSz;
+    info.u.eccSign.out   = out;
+    info.u.eccSign.outSz = outSz;
+    info.u.eccSign.rng   = rng;
+
+    return CryptoDevProcess(key->cdevId, &info);
+}
+
+
+int CryptoDev_Ecdh(ecc_key* priv, ecc_key* pub, byte* out, word32* outSz)
+{
+    CryptoDevInfo info;
+
+    info.algo = CRYPTO_DEV_ECDH;
+    info.u.ecdh.priv  = priv;
+    info.u.ecdh.pub   = pub;
+    info.u.ecdh.out   = out;
+    info.u.ecdh.outSz = outSz;
+
+    return CryptoDevProcess(priv->cdevId, &info);
+}
+
+#endif /* HAVE_ECC */
+
+
+int CryptoDev_Rng(RNG* rng, byte* out, word32 sz)
+{
+    CryptoDevInfo info;
+
+    info.algo = CRYPTO_DEV_RNG;
+    info.u.rng.rng = rng;
+    info.u.rng.out = out;
+    info.u.rng.sz  = sz;
+
+    return CryptoDevProcess(rng->cdevId, &info);
+}
+
+
+#endif /* CYASSL_CRYPTO_DEV */
+
@@ -850,6 +850,15 @@ int  Des3_SetIV(Des3* des, const byte* iv);
 
 #else /* CTaoCrypt software implementation */
 
+#include <cyassl/ctaocrypt/cpuid.h>
+
+/* CBC decryption has no chain between blocks, AVX2 gathers run the Spbox
+ * lookups of eight blocks at once */
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(HAVE_CAVIUM)
+    #define DES3_AVX2
+    #include <immintrin.h>
+#endif
+
 /* permuted choice table (key) */
 static const byte pc1[] = {
        57, 49, 41, 33, 25, 17,  9,
@@ -1279,6 +1288,158 @@ static void Des3ProcessBlock(Des3* des, const byte* in, byte* out)
 }
 
 
+#ifdef DES3_AVX2
+
+#define DES_ROTL8(v, n) \
+    _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define DES_ROTR8(v, n) DES_ROTL8(v, 32 - (n))
+
+/* the bits of a and b that differ under mask, a takes b's */
+#define DES_SWAP8(a, b, m, work) \
+    work = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi32(m)); \
+    a = _mm256_xor_si256(a, work)
+
+#define DES_SBOX8(t, w, s) \
+    _mm256_i32gather_epi32((const int*)Spbox[t], _mm256_and_si256( \
+                           _mm256_srli_epi32(w, s), _mm256_set1_epi32(0x3f)), 4)
+
+
+/* IPERM over eight blocks, lane for lane */
+CYASSL_TARGET("avx2")
+static INLINE void IPERM8(__m256i* left, __m256i* right)
+{
+    __m256i l = *left, r = *right, work;
+
+    r = DES_ROTL8(r, 4);
+    DES_SWAP8(l, r, 0xf0f0f0f0, work);
+    r = DES_ROTR8(_mm256_xor_si256(r, work), 20);
+    DES_SWAP8(l, r, 0xffff0000, work);
+    r = DES_ROTR8(_mm256_xor_si256(r, work), 18);
+    DES_SWAP8(l, r, 0x33333333, work);
+    r = DES_ROTR8(_mm256_xor_si256(r, work), 6);
+    DES_SWAP8(l, r, 0x00ff00ff, work);
+    r = DES_ROTL8(_mm256_xor_si256(r, work), 9);
+    work = _mm256_and_si256(_mm256_xor_si256(l, r),
+                            _mm256_set1_epi32(0xaaaaaaaa));
+    l = DES_ROTL8(_mm256_xor_si256(l, work), 1);
+    r = _mm256_xor_si256(r, work);
+
+    *left = l; *right = r;
+}
+
+
+/* FPERM over eight blocks, lane for lane */
+CYASSL_TARGET("avx2")
+static INLINE void FPERM8(__m256i* left, __m256i* right)
+{
+    __m256i l = *left, r = *right, work;
+
+    r = DES_ROTR8(r, 1);
+    DES_SWAP8(r, l, 0xaaaaaaaa, work);
+    l = DES_ROTR8(_mm256_xor_si256(l, work), 9);
+    DES_SWAP8(r, l, 0x00ff00ff, work);
+    l = DES_ROTL8(_mm256_xor_si256(l, work), 6);
+    DES_SWAP8(r, l, 0x33333333, work);
+    l = DES_ROTL8(_mm256_xor_si256(l, work), 18);
+    DES_SWAP8(r, l, 0xffff0000, work);
+    l = DES_ROTL8(_mm256_xor_si256(l, work), 20);
+    DES_SWAP8(r, l, 0xf0f0f0f0, work);
+    l = DES_ROTR8(_mm256_xor_si256(l, work), 4);
+
+    *left = l; *right = r;
+}
+
+
+/* one half round, l ^ f(r) under subkey words k0 and k1 */
+CYASSL_TARGET("avx2")
+static INLINE __m256i DesF8(__m256i l, __m256i r, word32 k0, word32 k1)
+{
+    __m256i work = _mm256_xor_si256(DES_ROTR8(r, 4), _mm256_set1_epi32(k0));
+
+    l = _mm256_xor_si256(l, _mm256_xor_si256(
+            _mm256_xor_si256(DES_SBOX8(6, work, 0),  DES_SBOX8(4, work, 8)),
+            _mm256_xor_si256(DES_SBOX8(2, work, 16), DES_SBOX8(0, work, 24))));
+
+    work = _mm256_xor_si256(r, _mm256_set1_epi32(k1));
+
+    return _mm256_xor_si256(l, _mm256_xor_si256(
+            _mm256_xor_si256(DES_SBOX8(7, work, 0),  DES_SBOX8(5, work, 8)),
+            _mm256_xor_si256(DES_SBOX8(3, work, 16), DES_SBOX8(1, work, 24))));
+}
+
+
+CYASSL_TARGET("avx2")
+static INLINE void DesRawProcessBlock8(__m256i* lIn, __m256i* rIn,
+                                       const word32* kptr)
+{
+    __m256i l = *lIn, r = *rIn;
+    word32  i;
+
+    for (i = 0; i < 8; i++) {
+        l = DesF8(l, r, kptr[4*i+0], kptr[4*i+1]);
+        r = DesF8(r, l, kptr[4*i+2], kptr[4*i+3]);
+    }
+
+    *lIn = l; *rIn = r;
+}
+
+
+/* CBC decrypt groups of eight blocks. The ciphertext is copied behind the
+ * previous block first so the XOR chain holds when out and in overlap. */
+CYASSL_TARGET("avx2")
+static void Des3CbcDecryptAvx2(Des3* des, byte* out, const byte* in,
+                               word32 groups)
+{
+    const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                                          4,  5,  6,  7,  0, 1,  2,  3,
+                                          12, 13, 14, 15, 8, 9, 10, 11,
+                                          4,  5,  6,  7,  0, 1,  2,  3);
+    byte    chain[DES_BLOCK_SIZE * 9];
+    __m256i a, b, l, r;
+
+    XMEMCPY(chain, des->reg, DES_BLOCK_SIZE);
+
+    while (groups--) {
+        XMEMCPY(chain + DES_BLOCK_SIZE, in, DES_BLOCK_SIZE * 8);
+
+        /* blocks 0-3 and 4-7 as big endian words, then l and r of each
+         * block into its own lane, in an order undone by the unpacks */
+        a = _mm256_shuffle_epi8(_mm256_loadu_si256(
+                              (const __m256i*)(chain + DES_BLOCK_SIZE)), bswap);
+        b = _mm256_shuffle_epi8(_mm256_loadu_si256(
+                          (const __m256i*)(chain + DES_BLOCK_SIZE * 5)), bswap);
+        l = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a),
+                               _mm256_castsi256_ps(b), _MM_SHUFFLE(2,0,2,0)));
+        r = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a),
+                               _mm256_castsi256_ps(b), _MM_SHUFFLE(3,1,3,1)));
+
+        IPERM8(&l, &r);
+        DesRawProcessBlock8(&l, &r, des->key[0]);
+        DesRawProcessBlock8(&r, &l, des->key[1]);
+        DesRawProcessBlock8(&l, &r, des->key[2]);
+        FPERM8(&l, &r);
+
+        /* each block comes out r then l */
+        a = _mm256_shuffle_epi8(_mm256_unpacklo_epi32(r, l), bswap);
+        b = _mm256_shuffle_epi8(_mm256_unpackhi_epi32(r, l), bswap);
+
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)chain));
+        b = _mm256_xor_si256(b, _mm256_loadu_si256(
+                                  (const __m256i*)(chain + DES_BLOCK_SIZE * 4)));
+        _mm256_storeu_si256((__m256i*)out, a);
+        _mm256_storeu_si256((__m256i*)(out + DES_BLOCK_SIZE * 4), b);
+
+        XMEMCPY(chain, chain + DES_BLOCK_SIZE * 8, DES_BLOCK_SIZE);
+        out += DES_BLOCK_SIZE * 8;
+        in  += DES_BLOCK_SIZE * 8;
+    }
+
+    XMEMCPY(des->reg, chain, DES_BLOCK_SIZE);
+}
+
+#endif /* DES3_AVX2 */
+
+
 int Des_CbcEncrypt(Des* des, byte* out, const byte* in, word32 sz)
 {
     word32 blocks = sz / DES_BLOCK_SIZE;
@@ -1348,6 +1509,17 @@ int Des3_CbcDecrypt(Des3* des, byte* out, const byte* in, word32 sz)
 #endif
 
     blocks = sz / DES_BLOCK_SIZE;
+
+#ifdef DES3_AVX2
+    if (blocks >= 8 && (CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2)) {
+        Des3CbcDecryptAvx2(des, out, in, blocks / 8);
+
+        out    += (blocks & ~7U) * DES_BLOCK_SIZE;
+        in     += (blocks & ~7U) * DES_BLOCK_SIZE;
+        blocks &= 7;
+    }
+#endif
+
     while (blocks--) {
         XMEMCPY(des->tmp, in, DES_BLOCK_SIZE);
         Des3ProcessBlock(des, (byte*)des->tmp, out);
@@ -32,6 +32,11 @@
 #include <cyassl/ctaocrypt/ecc.h>
 #include <cyassl/ctaocrypt/asn.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
+#include <cyassl/ctaocrypt/ecc_p256.h>
+#include <cyassl/ctaocrypt/stats.h>
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 
 #ifdef HAVE_ECC_ENCRYPT
     #include <cyassl/ctaocrypt/hmac.h>
@@ -174,7 +179,7 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
                       int map);
 #ifdef ECC_SHAMIR
 static int ecc_mul2add(ecc_point* A, mp_int* kA, ecc_point* B, mp_int* kB,
-                       ecc_point* C, mp_int* modulus);
+                       ecc_point* C, mp_int* modulus, int map);
 #endif
 
 int mp_jacobi(mp_int* a, mp_int* p, int* c);
@@ -220,148 +225,151 @@ static mp_digit get_digit(mp_int* a, int n)
 int ecc_projective_add_point(ecc_point *P, ecc_point *Q, ecc_point *R,
                              mp_int* modulus, mp_digit* mp)
 {
-   fp_int t1, t2, x, y, z;
-   int    err;
+   fp_int tmp[5];
+   fp_int *t1 = &tmp[0], *t2 = &tmp[1], *x = &tmp[2], *y = &tmp[3],
+          *z  = &tmp[4];
 
    if (P == NULL || Q == NULL || R == NULL || modulus == NULL || mp == NULL)
        return ECC_BAD_ARG_E;
 
-   if ((err = mp_init_multi(&t1, &t2, &x, &y, &z, NULL)) != MP_OKAY) {
-      return err;
-   }
+   fp_init(t1);
+   fp_init(t2);
+   fp_init(x);
+   fp_init(y);
+   fp_init(z);
 
    /* should we dbl instead? */
-   fp_sub(modulus, &Q->y, &t1);
-   if ( (fp_cmp(&P->x, &Q->x) == FP_EQ) && 
-        (get_digit_count(&Q->z) && fp_cmp(&P->z, &Q->z) == FP_EQ) &&
-        (fp_cmp(&P->y, &Q->y) == FP_EQ || fp_cmp(&P->y, &t1) == FP_EQ)) {
+   fp_sub(modulus, Q->y, t1);
+   if ( (fp_cmp(P->x, Q->x) == FP_EQ) && 
+        (get_digit_count(Q->z) && fp_cmp(P->z, Q->z) == FP_EQ) &&
+        (fp_cmp(P->y, Q->y) == FP_EQ || fp_cmp(P->y, t1) == FP_EQ)) {
         return ecc_projective_dbl_point(P, R, modulus, mp);
    }
 
-   fp_copy(&P->x, &x);
-   fp_copy(&P->y, &y);
-   fp_copy(&P->z, &z);
+   fp_copy(P->x, x);
+   fp_copy(P->y, y);
+   fp_copy(P->z, z);
 
    /* if Z is one then these are no-operations */
-   if (get_digit_count(&Q->z)) {
+   if (get_digit_count(Q->z)) {
       /* T1 = Z' * Z' */
-      fp_sqr(&Q->z, &t1);
-      fp_montgomery_reduce(&t1, modulus, *mp);
+      fp_sqr(Q->z, t1);
+      fp_montgomery_reduce(t1, modulus, *mp);
       /* X = X * T1 */
-      fp_mul(&t1, &x, &x);
-      fp_montgomery_reduce(&x, modulus, *mp);
+      fp_mul(t1, x, x);
+      fp_montgomery_reduce(x, modulus, *mp);
       /* T1 = Z' * T1 */
-      fp_mul(&Q->z, &t1, &t1);
-      fp_montgomery_reduce(&t1, modulus, *mp);
+      fp_mul(Q->z, t1, t1);
+      fp_montgomery_reduce(t1, modulus, *mp);
       /* Y = Y * T1 */
-      fp_mul(&t1, &y, &y);
-      fp_montgomery_reduce(&y, modulus, *mp);
+      fp_mul(t1, y, y);
+      fp_montgomery_reduce(y, modulus, *mp);
    }
 
    /* T1 = Z*Z */
-   fp_sqr(&z, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_sqr(z, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
    /* T2 = X' * T1 */
-   fp_mul(&Q->x, &t1, &t2);
-   fp_montgomery_reduce(&t2, modulus, *mp);
+   fp_mul(Q->x, t1, t2);
+   fp_montgomery_reduce(t2, modulus, *mp);
    /* T1 = Z * T1 */
-   fp_mul(&z, &t1, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_mul(z, t1, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
    /* T1 = Y' * T1 */
-   fp_mul(&Q->y, &t1, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_mul(Q->y, t1, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
 
    /* Y = Y - T1 */
-   fp_sub(&y, &t1, &y);
-   if (fp_cmp_d(&y, 0) == FP_LT) {
-      fp_add(&y, modulus, &y);
+   fp_sub(y, t1, y);
+   if (fp_cmp_d(y, 0) == FP_LT) {
+      fp_add(y, modulus, y);
    }
    /* T1 = 2T1 */
-   fp_add(&t1, &t1, &t1);
-   if (fp_cmp(&t1, modulus) != FP_LT) {
-      fp_sub(&t1, modulus, &t1);
+   fp_add(t1, t1, t1);
+   if (fp_cmp(t1, modulus) != FP_LT) {
+      fp_sub(t1, modulus, t1);
    }
    /* T1 = Y + T1 */
-   fp_add(&t1, &y, &t1);
-   if (fp_cmp(&t1, modulus) != FP_LT) {
-      fp_sub(&t1, modulus, &t1);
+   fp_add(t1, y, t1);
+   if (fp_cmp(t1, modulus) != FP_LT) {
+      fp_sub(t1, modulus, t1);
    }
    /* X = X - T2 */
-   fp_sub(&x, &t2, &x);
-   if (fp_cmp_d(&x, 0) == FP_LT) {
-      fp_add(&x, modulus, &x);
+   fp_sub(x, t2, x);
+   if (fp_cmp_d(x, 0) == FP_LT) {
+      fp_add(x, modulus, x);
    }
    /* T2 = 2T2 */
-   fp_add(&t2, &t2, &t2);
-   if (fp_cmp(&t2, modulus) != FP_LT) {
-      fp_sub(&t2, modulus, &t2);
+   fp_add(t2, t2, t2);
+   if (fp_cmp(t2, modulus) != FP_LT) {
+      fp_sub(t2, modulus, t2);
    }
    /* T2 = X + T2 */
-   fp_add(&t2, &x, &t2);
-   if (fp_cmp(&t2, modulus) != FP_LT) {
-      fp_sub(&t2, modulus, &t2);
+   fp_add(t2, x, t2);
+   if (fp_cmp(t2, modulus) != FP_LT) {
+      fp_sub(t2, modulus, t2);
    }
 
    /* if Z' != 1 */
-   if (get_digit_count(&Q->z)) {
+   if (get_digit_count(Q->z)) {
       /* Z = Z * Z' */
-      fp_mul(&z, &Q->z, &z);
-      fp_montgomery_reduce(&z, modulus, *mp);
+      fp_mul(z, Q->z, z);
+      fp_montgomery_reduce(z, modulus, *mp);
    }
 
    /* Z = Z * X */
-   fp_mul(&z, &x, &z);
-   fp_montgomery_reduce(&z, modulus, *mp);
+   fp_mul(z, x, z);
+   fp_montgomery_reduce(z, modulus, *mp);
 
    /* T1 = T1 * X  */
-   fp_mul(&t1, &x, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_mul(t1, x, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
    /* X = X * X */
-   fp_sqr(&x, &x);
-   fp_montgomery_reduce(&x, modulus, *mp);
+   fp_sqr(x, x);
+   fp_montgomery_reduce(x, modulus, *mp);
    /* T2 = T2 * x */
-   fp_mul(&t2, &x, &t2);
-   fp_montgomery_reduce(&t2, modulus, *mp);
+   fp_mul(t2, x, t2);
+   fp_montgomery_reduce(t2, modulus, *mp);
    /* T1 = T1 * X  */
-   fp_mul(&t1, &x, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_mul(t1, x, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
  
    /* X = Y*Y */
-   fp_sqr(&y, &x);
-   fp_montgomery_reduce(&x, modulus, *mp);
+   fp_sqr(y, x);
+   fp_montgomery_reduce(x, modulus, *mp);
    /* X = X - T2 */
-   fp_sub(&x, &t2, &x);
-   if (fp_cmp_d(&x, 0) == FP_LT) {
-      fp_add(&x, modulus, &x);
+   fp_sub(x, t2, x);
+   if (fp_cmp_d(x, 0) == FP_LT) {
+      fp_add(x, modulus, x);
    }
 
    /* T2 = T2 - X */
-   fp_sub(&t2, &x, &t2);
-   if (fp_cmp_d(&t2, 0) == FP_LT) {
-      fp_add(&t2, modulus, &t2);
+   fp_sub(t2, x, t2);
+   if (fp_cmp_d(t2, 0) == FP_LT) {
+      fp_add(t2, modulus, t2);
    } 
    /* T2 = T2 - X */
-   fp_sub(&t2, &x, &t2);
-   if (fp_cmp_d(&t2, 0) == FP_LT) {
-      fp_add(&t2, modulus, &t2);
+   fp_sub(t2, x, t2);
+   if (fp_cmp_d(t2, 0) == FP_LT) {
+      fp_add(t2, modulus, t2);
    }
    /* T2 = T2 * Y */
-   fp_mul(&t2, &y, &t2);
-   fp_montgomery_reduce(&t2, modulus, *mp);
+   fp_mul(t2, y, t2);
+   fp_montgomery_reduce(t2, modulus, *mp);
    /* Y = T2 - T1 */
-   fp_sub(&t2, &t1, &y);
-   if (fp_cmp_d(&y, 0) == FP_LT) {
-      fp_add(&y, modulus, &y);
+   fp_sub(t2, t1, y);
+   if (fp_cmp_d(y, 0) == FP_LT) {
+      fp_add(y, modulus, y);
    }
    /* Y = Y/2 */
-   if (fp_isodd(&y)) {
-      fp_add(&y, modulus, &y);
+   if (fp_isodd(y)) {
+      fp_add(y, modulus, y);
    }
-   fp_div_2(&y, &y);
+   fp_div_2(y, y);
 
-   fp_copy(&x, &R->x);
-   fp_copy(&y, &R->y);
-   fp_copy(&z, &R->z);
+   fp_copy(x, R->x);
+   fp_copy(y, R->y);
+   fp_copy(z, R->z);
    
    return MP_OKAY;
 }
@@ -378,104 +386,103 @@ int ecc_projective_add_point(ecc_point *P, ecc_point *Q, ecc_point *R,
 int ecc_projective_dbl_point(ecc_point *P, ecc_point *R, mp_int* modulus,
                              mp_digit* mp)
 {
-   fp_int   t1, t2;
-   int      err;
+   fp_int tmp[2];
+   fp_int *t1 = &tmp[0], *t2 = &tmp[1];
 
    if (P == NULL || R == NULL || modulus == NULL || mp == NULL)
        return ECC_BAD_ARG_E;
 
    if (P != R) {
-      fp_copy(&P->x, &R->x);
-      fp_copy(&P->y, &R->y);
-      fp_copy(&P->z, &R->z);
+      fp_copy(P->x, R->x);
+      fp_copy(P->y, R->y);
+      fp_copy(P->z, R->z);
    }
 
-   if ((err = mp_init_multi(&t1, &t2, NULL, NULL, NULL, NULL)) != MP_OKAY) {
-      return err;
-   }
+   fp_init(t1);
+   fp_init(t2);
 
    /* t1 = Z * Z */
-   fp_sqr(&R->z, &t1);
-   fp_montgomery_reduce(&t1, modulus, *mp);
+   fp_sqr(R->z, t1);
+   fp_montgomery_reduce(t1, modulus, *mp);
    /* Z = Y * Z */
-   fp_mul(&R->z, &R->y, &R->z);
-   fp_montgomery_reduce(&R->z, modulus, *mp);
+   fp_mul(R->z, R->y, R->z);
+   fp_montgomery_reduce(R->z, modulus, *mp);
    /* Z = 2Z */
-   fp_add(&R->z, &R->z, &R->z);
-   if (fp_cmp(&R->z, modulus) != FP_LT) {
-      fp_sub(&R->z, modulus, &R->z);
+   fp_add(R->z, R->z, R->z);
+   if (fp_cmp(R->z, modulus) != FP_LT) {
+      fp_sub(R->z, modulus, R->z);
    }
    
-   /* &t2 = X - T1 */
-   fp_sub(&R->x, &t1, &t2);
-   if (fp_cmp_d(&t2, 0) == FP_LT) {
-      fp_add(&t2, modulus, &t2);
+   /* t2 = X - T1 */
+   fp_sub(R->x, t1, t2);
+   if (fp_cmp_d(t2, 0) == FP_LT) {
+      fp_add(t2, modulus, t2);
    }
    /* T1 = X + T1 */
-   fp_add(&t1, &R->x, &t1);
-   if (fp_cmp(&t1, modulus) != FP_LT) {
-      fp_sub(&t1, modulus, &t1);
+   fp_add(t1, R->x, t1);
+   if (fp_cmp(t1, modulus) != FP_LT) {
+      fp_sub(t1, modulus, t1);
    }
    /* T2 = T1 * T2 */
-   fp_mul(&t1, &t2, &t2);
-   fp_montgomery_reduce(&t2, modulus, *mp);
+   fp_mul(t1, t2, t2);
+   fp_montgomery_reduce(t2, modulus, *mp);
    /* T1 = 2T2 */
-   fp_add(&t2, &t2, &t1);
-   if (fp_cmp(&t1, modulus) != FP_LT) {
-      fp_sub(&t1, modulus, &t1);
+   fp_add(t2, t2, t1);
+   if (fp_cmp(t1, modulus) != FP_LT) {
+      fp_sub(t1, modulus, t1);
    }
    /* T1 = T1 + T2 */
-   fp_add(&t1, &t2, &t1);
-   if (fp_cmp(&t1, modulus) != FP_LT) {
-      fp_sub(&t1, modulus, &t1);
+   fp_add(t1, t2, t1);
+   if (fp_cmp(t1, modulus) != FP_LT) {
+      fp_sub(t1, modulus, t1);
    }
 
    /* Y = 2Y */
-   fp_add(&R->y, &R->y, &R->y);
-   if (fp_cmp(&R->y, modulus) != FP_LT) {
-      fp_sub(&R->y, modulus, &R->y);
+   fp_add(R->y, R->y, R->y);
+   if (fp_cmp(R->y, modulus) != FP_LT) {
+      fp_sub(R->y, modulus, R->y);
    }
    /* Y = Y * Y */
-   fp_sqr(&R->y, &R->y);
-   fp_montgomery_reduce(&R->y, modulus, *mp);
+   fp_sqr(R->y, R->y);
+   fp_montgomery_reduce(R->y, modulus, *mp);
    /* T2 = Y * Y */
-   fp_sqr(&R->y, &t2);
-   fp_montgomery_reduce(&t2, modulus, *mp);
+   fp_sqr(R->y, t2);
+   fp_montgomery_reduce(t2, modulus, *mp);
    /* T2 = T2/2 */
-   if (fp_isodd(&t2)) {
-      fp_add(&t2, modulus, &t2);
+   if (fp_isodd(t2)) {
+      fp_add(t2, modulus, t2);
    }
-   fp_div_2(&t2, &t2);
+   fp_div_2(t2, t2);
    /* Y = Y * X */
-   fp_mul(&R->y, &R->x, &R->y);
-   fp_montgomery_reduce(&R->y, modulus, *mp);
+   fp_mul(R->y, R->x, R->y);
+   fp_montgomery_reduce(R->y, modulus, *mp);
 
    /* X  = T1 * T1 */
-   fp_sqr(&t1, &R->x);
-   fp_montgomery_reduce(&R->x, modulus, *mp);
+   fp_sqr(t1, R->x);
+   fp_montgomery_reduce(R->x, modulus, *mp);
    /* X = X - Y */
-   fp_sub(&R->x, &R->y, &R->x);
-   if (fp_cmp_d(&R->x, 0) == FP_LT) {
-      fp_add(&R->x, modulus, &R->x);
+   fp_sub(R->x, R->y, R->x);
+   if (fp_cmp_d(R->x, 0) == FP_LT) {
+      fp_add(R->x, modulus, R->x);
    }
    /* X = X - Y */
-   fp_sub(&R->x, &R->y, &R->x);
-   if (fp_cmp_d(&R->x, 0) == FP_LT) {
-      fp_add(&R->x, modulus, &R->x);
+   fp_sub(R->x, R->y, R->x);
+   if (fp_cmp_d(R->x, 0) == FP_LT) {
+      fp_add(R->x, modulus, R->x);
    }
 
    /* Y = Y - X */     
-   fp_sub(&R->y, &R->x, &R->y);
-   if (fp_cmp_d(&R->y, 0) == FP_LT) {
-      fp_add(&R->y, modulus, &R->y);
+   fp_sub(R->y, R->x, R->y);
+   if (fp_cmp_d(R->y, 0) == FP_LT) {
+      fp_add(R->y, modulus, R->y);
    }
    /* Y = Y * T1 */
-   fp_mul(&R->y, &t1, &R->y);
-   fp_montgomery_reduce(&R->y, modulus, *mp);
+   fp_mul(R->y, t1, R->y);
+   fp_montgomery_reduce(R->y, modulus, *mp);
    /* Y = Y - T2 */
-   fp_sub(&R->y, &t2, &R->y);
-   if (fp_cmp_d(&R->y, 0) == FP_LT) {
-      fp_add(&R->y, modulus, &R->y);
+   fp_sub(R->y, t2, R->y);
+   if (fp_cmp_d(R->y, 0) == FP_LT) {
+      fp_add(R->y, modulus, R->y);
    }
  
    return MP_OKAY;
@@ -510,12 +517,12 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
    }
    
    /* should we dbl instead? */
-   err = mp_sub(modulus, &Q->y, &t1);
+   err = mp_sub(modulus, Q->y, &t1);
 
    if (err == MP_OKAY) {
-       if ( (mp_cmp(&P->x, &Q->x) == MP_EQ) && 
-            (get_digit_count(&Q->z) && mp_cmp(&P->z, &Q->z) == MP_EQ) &&
-            (mp_cmp(&P->y, &Q->y) == MP_EQ || mp_cmp(&P->y, &t1) == MP_EQ)) {
+       if ( (mp_cmp(P->x, Q->x) == MP_EQ) && 
+            (get_digit_count(Q->z) && mp_cmp(P->z, Q->z) == MP_EQ) &&
+            (mp_cmp(P->y, Q->y) == MP_EQ || mp_cmp(P->y, &t1) == MP_EQ)) {
                 mp_clear(&t1);
                 mp_clear(&t2);
                 mp_clear(&x);
@@ -527,17 +534,17 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
    }
 
    if (err == MP_OKAY)
-       err = mp_copy(&P->x, &x);
+       err = mp_copy(P->x, &x);
    if (err == MP_OKAY)
-       err = mp_copy(&P->y, &y);
+       err = mp_copy(P->y, &y);
    if (err == MP_OKAY)
-       err = mp_copy(&P->z, &z);
+       err = mp_copy(P->z, &z);
 
    /* if Z is one then these are no-operations */
    if (err == MP_OKAY) {
-       if (get_digit_count(&Q->z)) {
+       if (get_digit_count(Q->z)) {
            /* T1 = Z' * Z' */
-           err = mp_sqr(&Q->z, &t1);
+           err = mp_sqr(Q->z, &t1);
            if (err == MP_OKAY)
                err = mp_montgomery_reduce(&t1, modulus, *mp);
 
@@ -549,7 +556,7 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
 
            /* T1 = Z' * T1 */
            if (err == MP_OKAY)
-               err = mp_mul(&Q->z, &t1, &t1);
+               err = mp_mul(Q->z, &t1, &t1);
            if (err == MP_OKAY)
                err = mp_montgomery_reduce(&t1, modulus, *mp);
 
@@ -569,7 +576,7 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
 
    /* T2 = X' * T1 */
    if (err == MP_OKAY)
-       err = mp_mul(&Q->x, &t1, &t2);
+       err = mp_mul(Q->x, &t1, &t2);
    if (err == MP_OKAY)
        err = mp_montgomery_reduce(&t2, modulus, *mp);
 
@@ -581,7 +588,7 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
 
    /* T1 = Y' * T1 */
    if (err == MP_OKAY)
-       err = mp_mul(&Q->y, &t1, &t1);
+       err = mp_mul(Q->y, &t1, &t1);
    if (err == MP_OKAY)
        err = mp_montgomery_reduce(&t1, modulus, *mp);
 
@@ -629,9 +636,9 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
    }
 
    if (err == MP_OKAY) {
-       if (get_digit_count(&Q->z)) {
+       if (get_digit_count(Q->z)) {
            /* Z = Z * Z' */
-           err = mp_mul(&z, &Q->z, &z);
+           err = mp_mul(&z, Q->z, &z);
            if (err == MP_OKAY)
                err = mp_montgomery_reduce(&z, modulus, *mp);
        }
@@ -716,11 +723,11 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
        err = mp_div_2(&y, &y);
 
    if (err == MP_OKAY)
-       err = mp_copy(&x, &R->x);
+       err = mp_copy(&x, R->x);
    if (err == MP_OKAY)
-       err = mp_copy(&y, &R->y);
+       err = mp_copy(&y, R->y);
    if (err == MP_OKAY)
-       err = mp_copy(&z, &R->z);
+       err = mp_copy(&z, R->z);
 
    /* clean up */
    mp_clear(&t1);
@@ -756,43 +763,43 @@ int ecc_projective_dbl_point(ecc_point *P, ecc_point *R, mp_int* modulus,
    }
 
    if (P != R) {
-      err = mp_copy(&P->x, &R->x);
+      err = mp_copy(P->x, R->x);
       if (err == MP_OKAY)
-          err = mp_copy(&P->y, &R->y);
+          err = mp_copy(P->y, R->y);
       if (err == MP_OKAY)
-          err = mp_copy(&P->z, &R->z);
+          err = mp_copy(P->z, R->z);
    }
 
    /* t1 = Z * Z */
    if (err == MP_OKAY)
-       err = mp_sqr(&R->z, &t1);
+       err = mp_sqr(R->z, &t1);
    if (err == MP_OKAY)
        err = mp_montgomery_reduce(&t1, modulus, *mp);
 
    /* Z = Y * Z */
    if (err == MP_OKAY)
-       err = mp_mul(&R->z, &R->y, &R->z);
+       err = mp_mul(R->z, R->y, R->z);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&R->z, modulus, *mp);
+       err = mp_montgomery_reduce(R->z, modulus, *mp);
 
    /* Z = 2Z */
    if (err == MP_OKAY)
-       err = mp_add(&R->z, &R->z, &R->z);
+       err = mp_add(R->z, R->z, R->z);
    if (err == MP_OKAY) {
-       if (mp_cmp(&R->z, modulus) != MP_LT)
-           err = mp_sub(&R->z, modulus, &R->z);
+       if (mp_cmp(R->z, modulus) != MP_LT)
+           err = mp_sub(R->z, modulus, R->z);
    }
 
    /* T2 = X - T1 */
    if (err == MP_OKAY)
-       err = mp_sub(&R->x, &t1, &t2);
+       err = mp_sub(R->x, &t1, &t2);
    if (err == MP_OKAY) {
        if (mp_cmp_d(&t2, 0) == MP_LT)
            err = mp_add(&t2, modulus, &t2);
    }
    /* T1 = X + T1 */
    if (err == MP_OKAY)
-       err = mp_add(&t1, &R->x, &t1);
+       err = mp_add(&t1, R->x, &t1);
    if (err == MP_OKAY) {
        if (mp_cmp(&t1, modulus) != MP_LT)
            err = mp_sub(&t1, modulus, &t1);
@@ -819,20 +826,20 @@ int ecc_projective_dbl_point(ecc_point *P, ecc_point *R, mp_int* modulus,
    }
    /* Y = 2Y */
    if (err == MP_OKAY)
-       err = mp_add(&R->y, &R->y, &R->y);
+       err = mp_add(R->y, R->y, R->y);
    if (err == MP_OKAY) {
-       if (mp_cmp(&R->y, modulus) != MP_LT)
-           err = mp_sub(&R->y, modulus, &R->y);
+       if (mp_cmp(R->y, modulus) != MP_LT)
+           err = mp_sub(R->y, modulus, R->y);
    }
    /* Y = Y * Y */
    if (err == MP_OKAY)
-       err = mp_sqr(&R->y, &R->y);
+       err = mp_sqr(R->y, R->y);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&R->y, modulus, *mp);
+       err = mp_montgomery_reduce(R->y, modulus, *mp);
    
    /* T2 = Y * Y */
    if (err == MP_OKAY)
-       err = mp_sqr(&R->y, &t2);
+       err = mp_sqr(R->y, &t2);
    if (err == MP_OKAY)
        err = mp_montgomery_reduce(&t2, modulus, *mp);
 
@@ -846,49 +853,49 @@ int ecc_projective_dbl_point(ecc_point *P, ecc_point *R, mp_int* modulus,
    
    /* Y = Y * X */
    if (err == MP_OKAY)
-       err = mp_mul(&R->y, &R->x, &R->y);
+       err = mp_mul(R->y, R->x, R->y);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&R->y, modulus, *mp);
+       err = mp_montgomery_reduce(R->y, modulus, *mp);
 
    /* X  = T1 * T1 */
    if (err == MP_OKAY)
-       err = mp_sqr(&t1, &R->x);
+       err = mp_sqr(&t1, R->x);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&R->x, modulus, *mp);
+       err = mp_montgomery_reduce(R->x, modulus, *mp);
 
    /* X = X - Y */
    if (err == MP_OKAY)
-       err = mp_sub(&R->x, &R->y, &R->x);
+       err = mp_sub(R->x, R->y, R->x);
    if (err == MP_OKAY) {
-       if (mp_cmp_d(&R->x, 0) == MP_LT)
-           err = mp_add(&R->x, modulus, &R->x);
+       if (mp_cmp_d(R->x, 0) == MP_LT)
+           err = mp_add(R->x, modulus, R->x);
    }
    /* X = X - Y */
    if (err == MP_OKAY)
-       err = mp_sub(&R->x, &R->y, &R->x);
+       err = mp_sub(R->x, R->y, R->x);
    if (err == MP_OKAY) {
-       if (mp_cmp_d(&R->x, 0) == MP_LT)
-           err = mp_add(&R->x, modulus, &R->x);
+       if (mp_cmp_d(R->x, 0) == MP_LT)
+           err = mp_add(R->x, modulus, R->x);
    }
    /* Y = Y - X */     
    if (err == MP_OKAY)
-       err = mp_sub(&R->y, &R->x, &R->y);
+       err = mp_sub(R->y, R->x, R->y);
    if (err == MP_OKAY) {
-       if (mp_cmp_d(&R->y, 0) == MP_LT)
-           err = mp_add(&R->y, modulus, &R->y);
+       if (mp_cmp_d(R->y, 0) == MP_LT)
+           err = mp_add(R->y, modulus, R->y);
    }
    /* Y = Y * T1 */
    if (err == MP_OKAY)
-       err = mp_mul(&R->y, &t1, &R->y);
+       err = mp_mul(R->y, &t1, R->y);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&R->y, modulus, *mp);
+       err = mp_montgomery_reduce(R->y, modulus, *mp);
 
    /* Y = Y - T2 */
    if (err == MP_OKAY)
-       err = mp_sub(&R->y, &t2, &R->y);
+       err = mp_sub(R->y, &t2, R->y);
    if (err == MP_OKAY) {
-       if (mp_cmp_d(&R->y, 0) == MP_LT)
-           err = mp_add(&R->y, modulus, &R->y);
+       if (mp_cmp_d(R->y, 0) == MP_LT)
+           err = mp_add(R->y, modulus, R->y);
    }
 
    /* clean up */ 
@@ -921,11 +928,11 @@ int ecc_map(ecc_point* P, mp_int* modulus, mp_digit* mp)
    }
 
    /* first map z back to normal */
-   err = mp_montgomery_reduce(&P->z, modulus, *mp);
+   err = mp_montgomery_reduce(P->z, modulus, *mp);
 
    /* get 1/z */
    if (err == MP_OKAY)
-       err = mp_invmod(&P->z, modulus, &t1);
+       err = mp_invmod(P->z, modulus, &t1);
  
    /* get 1/z^2 and 1/z^3 */
    if (err == MP_OKAY)
@@ -939,16 +946,16 @@ int ecc_map(ecc_point* P, mp_int* modulus, mp_digit* mp)
 
    /* multiply against x/y */
    if (err == MP_OKAY)
-       err = mp_mul(&P->x, &t2, &P->x);
+       err = mp_mul(P->x, &t2, P->x);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&P->x, modulus, *mp);
+       err = mp_montgomery_reduce(P->x, modulus, *mp);
    if (err == MP_OKAY)
-       err = mp_mul(&P->y, &t1, &P->y);
+       err = mp_mul(P->y, &t1, P->y);
    if (err == MP_OKAY)
-       err = mp_montgomery_reduce(&P->y, modulus, *mp);
+       err = mp_montgomery_reduce(P->y, modulus, *mp);
    
    if (err == MP_OKAY)
-       mp_set(&P->z, 1);
+       mp_set(P->z, 1);
 
    /* clean up */
    mp_clear(&t1);
@@ -1024,17 +1031,17 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
    /* tG = G  and convert to montgomery */
    if (err == MP_OKAY) {
        if (mp_cmp_d(&mu, 1) == MP_EQ) {
-           err = mp_copy(&G->x, &tG->x);
+           err = mp_copy(G->x, tG->x);
            if (err == MP_OKAY)
-               err = mp_copy(&G->y, &tG->y);
+               err = mp_copy(G->y, tG->y);
            if (err == MP_OKAY)
-               err = mp_copy(&G->z, &tG->z);
+               err = mp_copy(G->z, tG->z);
        } else {
-           err = mp_mulmod(&G->x, &mu, modulus, &tG->x);
+           err = mp_mulmod(G->x, &mu, modulus, tG->x);
            if (err == MP_OKAY)
-               err = mp_mulmod(&G->y, &mu, modulus, &tG->y);
+               err = mp_mulmod(G->y, &mu, modulus, tG->y);
            if (err == MP_OKAY)
-               err = mp_mulmod(&G->z, &mu, modulus, &tG->z);
+               err = mp_mulmod(G->z, &mu, modulus, tG->z);
        }
    }
    mp_clear(&mu);
@@ -1099,13 +1106,13 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
                /* if this is the first window we do a simple copy */
                if (first == 1) {
                    /* R = kG [k = first window] */
-                   err = mp_copy(&M[bitbuf-8]->x, &R->x);
+                   err = mp_copy(M[bitbuf-8]->x, R->x);
                    if (err != MP_OKAY) break;
 
-                   err = mp_copy(&M[bitbuf-8]->y, &R->y);
+                   err = mp_copy(M[bitbuf-8]->y, R->y);
                    if (err != MP_OKAY) break;
 
-                   err = mp_copy(&M[bitbuf-8]->z, &R->z);
+                   err = mp_copy(M[bitbuf-8]->z, R->z);
                    first = 0;
                } else {
                    /* normal window */
@@ -1143,13 +1150,13 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
                if ((bitbuf & (1 << WINSIZE)) != 0) {
                    if (first == 1) {
                        /* first add, so copy */
-                       err = mp_copy(&tG->x, &R->x);
+                       err = mp_copy(tG->x, R->x);
                        if (err != MP_OKAY) break;
 
-                       err = mp_copy(&tG->y, &R->y);
+                       err = mp_copy(tG->y, R->y);
                        if (err != MP_OKAY) break;
 
-                       err = mp_copy(&tG->z, &R->z);
+                       err = mp_copy(tG->z, R->z);
                        if (err != MP_OKAY) break;
                        first = 0;
                    } else {
@@ -1238,22 +1245,22 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
 
    /* tG = G  and convert to montgomery */
    if (err == MP_OKAY) {
-       err = mp_mulmod(&G->x, &mu, modulus, &tG->x);
+       err = mp_mulmod(G->x, &mu, modulus, tG->x);
        if (err == MP_OKAY)
-           err = mp_mulmod(&G->y, &mu, modulus, &tG->y);
+           err = mp_mulmod(G->y, &mu, modulus, tG->y);
        if (err == MP_OKAY)
-           err = mp_mulmod(&G->z, &mu, modulus, &tG->z);
+           err = mp_mulmod(G->z, &mu, modulus, tG->z);
    }
    mp_clear(&mu);
 
    /* calc the M tab */
    /* M[0] == G */
    if (err == MP_OKAY)
-       err = mp_copy(&tG->x, &M[0]->x);
+       err = mp_copy(tG->x, M[0]->x);
    if (err == MP_OKAY)
-       err = mp_copy(&tG->y, &M[0]->y);
+       err = mp_copy(tG->y, M[0]->y);
    if (err == MP_OKAY)
-       err = mp_copy(&tG->z, &M[0]->z);
+       err = mp_copy(tG->z, M[0]->z);
 
    /* M[1] == 2G */
    if (err == MP_OKAY)
@@ -1318,11 +1325,11 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
 
    /* copy result out */
    if (err == MP_OKAY)
-       err = mp_copy(&M[0]->x, &R->x);
+       err = mp_copy(M[0]->x, R->x);
    if (err == MP_OKAY)
-       err = mp_copy(&M[0]->y, &R->y);
+       err = mp_copy(M[0]->y, R->y);
    if (err == MP_OKAY)
-       err = mp_copy(&M[0]->z, &R->z);
+       err = mp_copy(M[0]->z, R->z);
 
    /* map R back from projective space */
    if (err == MP_OKAY && map)
@@ -1340,6 +1347,22 @@ static int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
 #endif /* ECC_TIMING_RESISTANT */
 
 
+/* setup the coordinates of a point, curve sized ones with ALT_ECC_SIZE */
+static int ecc_point_init(ecc_point* p)
+{
+#ifdef ALT_ECC_SIZE
+   p->x = (mp_int*)&p->xyz[0];
+   p->y = (mp_int*)&p->xyz[1];
+   p->z = (mp_int*)&p->xyz[2];
+   fp_init_size(p->x, FP_SIZE_ECC);
+   fp_init_size(p->y, FP_SIZE_ECC);
+   fp_init_size(p->z, FP_SIZE_ECC);
+   return MP_OKAY;
+#else
+   return mp_init_multi(p->x, p->y, p->z, NULL, NULL, NULL);
+#endif
+}
+
 /**
    Allocate a new ECC point
    return A newly allocated point or NULL on error 
@@ -1352,7 +1375,7 @@ ecc_point* ecc_new_point(void)
       return NULL;
    }
    XMEMSET(p, 0, sizeof(ecc_point));
-   if (mp_init_multi(&p->x, &p->y, &p->z, NULL, NULL, NULL) != MP_OKAY) {
+   if (ecc_point_init(p) != MP_OKAY) {
       XFREE(p, 0, DYNAMIC_TYPE_BIGINT);
       return NULL;
    }
@@ -1366,9 +1389,9 @@ void ecc_del_point(ecc_point* p)
 {
    /* prevents free'ing null arguments */
    if (p != NULL) {
-      mp_clear(&p->x);
-      mp_clear(&p->y);
-      mp_clear(&p->z);
+      mp_clear(p->x);
+      mp_clear(p->y);
+      mp_clear(p->z);
       XFREE(p, 0, DYNAMIC_TYPE_BIGINT);
    }
 }
@@ -1414,6 +1437,14 @@ int ecc_shared_secret(ecc_key* private_key, ecc_key* public_key, byte* out,
                                                     outlen == NULL)
        return BAD_FUNC_ARG;
 
+#ifdef CYASSL_CRYPTO_DEV
+   if (private_key->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+       err = CryptoDev_Ecdh(private_key, public_key, out, outlen);
+       if (err != CRYPTO_DEV_UNAVAILABLE_E)
+           return err;
+   }
+#endif
+
    /* type valid? */
    if (private_key->type != ECC_PRIVATEKEY) {
       return ECC_BAD_ARG_E;
@@ -1439,6 +1470,11 @@ int ecc_shared_secret(ecc_key* private_key, ecc_key* public_key, byte* out,
 
    err = mp_read_radix(&prime, (char *)private_key->dp->prime, 16);
 
+#ifdef HAVE_ECC_P256
+   if (err == MP_OKAY && ecc_p256_curve(private_key->dp))
+       err = ecc_p256_mulmod(&private_key->k, &public_key->pubkey, result);
+   else
+#endif
    if (err == MP_OKAY)
        err = ecc_mulmod(&private_key->k, &public_key->pubkey, result, &prime,1);
 
@@ -1450,8 +1486,8 @@ int ecc_shared_secret(ecc_key* private_key, ecc_key* public_key, byte* out,
 
    if (err == MP_OKAY) {
        XMEMSET(out, 0, x);
-       err = mp_to_unsigned_bin(&result->x,out + (x -
-                                            mp_unsigned_bin_size(&result->x)));
+       err = mp_to_unsigned_bin(result->x,out + (x -
+                                            mp_unsigned_bin_size(result->x)));
        *outlen = x;
    }
 
@@ -1529,8 +1565,9 @@ int ecc_make_key_ex(RNG* rng, ecc_key* key, const ecc_set_type* dp)
 
    /* setup the key variables */
    if (err == 0) {
-       err = mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z,
-                            &key->k, &prime, &order);
+       err = ecc_point_init(&key->pubkey);
+       if (err == MP_OKAY)
+           err = mp_init_multi(&key->k, &prime, &order, NULL, NULL, NULL);
        if (err != MP_OKAY)
            err = MEMORY_E;
    }
@@ -1547,12 +1584,12 @@ int ecc_make_key_ex(RNG* rng, ecc_key* key, const ecc_set_type* dp)
    if (err == MP_OKAY) 
        err = mp_read_radix(&order,   (char *)key->dp->order, 16);
    if (err == MP_OKAY) 
-       err = mp_read_radix(&base->x, (char *)key->dp->Gx, 16);
+       err = mp_read_radix(base->x, (char *)key->dp->Gx, 16);
    if (err == MP_OKAY) 
-       err = mp_read_radix(&base->y, (char *)key->dp->Gy, 16);
+       err = mp_read_radix(base->y, (char *)key->dp->Gy, 16);
    
    if (err == MP_OKAY) 
-       mp_set(&base->z, 1);
+       mp_set(base->z, 1);
    if (err == MP_OKAY) 
        err = mp_read_unsigned_bin(&key->k, (byte*)buf, keysize);
 
@@ -1562,6 +1599,11 @@ int ecc_make_key_ex(RNG* rng, ecc_key* key, const ecc_set_type* dp)
            err = mp_mod(&key->k, &order, &key->k);
    }
    /* make the public key */
+#ifdef HAVE_ECC_P256
+   if (err == MP_OKAY && ecc_p256_curve(dp))
+       err = ecc_p256_mulmod_base(&key->k, &key->pubkey);
+   else
+#endif
    if (err == MP_OKAY)
        err = ecc_mulmod(&key->k, base, &key->pubkey, &prime, 1);
    if (err == MP_OKAY)
@@ -1569,9 +1611,9 @@ int ecc_make_key_ex(RNG* rng, ecc_key* key, const ecc_set_type* dp)
 
    if (err != MP_OKAY) {
        /* clean up */
-       mp_clear(&key->pubkey.x);
-       mp_clear(&key->pubkey.y);
-       mp_clear(&key->pubkey.z);
+       mp_clear(key->pubkey.x);
+       mp_clear(key->pubkey.y);
+       mp_clear(key->pubkey.z);
        mp_clear(&key->k);
    }
    ecc_del_point(base);
@@ -1594,16 +1636,41 @@ int ecc_make_key_ex(RNG* rng, ecc_key* key, const ecc_set_type* dp)
 void ecc_init(ecc_key* key)
 {
     (void)key;
+#ifdef ALT_ECC_SIZE
+    /* the coordinate pointers have to be set before anything else */
+    ecc_point_init(&key->pubkey);
+    mp_init(&key->k);
+#endif
 #ifndef USE_FAST_MATH
-    key->pubkey.x.dp = NULL;
-    key->pubkey.y.dp = NULL;
-    key->pubkey.z.dp = NULL;
+    key->pubkey.x->dp = NULL;
+    key->pubkey.y->dp = NULL;
+    key->pubkey.z->dp = NULL;
 
     key->k.dp = NULL;
 #endif
 }
 
 
+/* load a message digest as an integer, truncated to the bit size of order */
+static int ecc_load_hash(mp_int* e, const byte* in, word32 inlen,
+                         mp_int* order)
+{
+   int    err;
+   word32 orderBits = mp_count_bits(order);
+
+   /* truncate down to byte size, may be all that's needed */
+   if ( (CYASSL_BIT_SIZE * inlen) > orderBits)
+       inlen = (orderBits + CYASSL_BIT_SIZE - 1)/CYASSL_BIT_SIZE;
+   err = mp_read_unsigned_bin(e, (byte*)in, inlen);
+
+   /* may still need bit truncation too */
+   if (err == MP_OKAY && (CYASSL_BIT_SIZE * inlen) > orderBits)
+       mp_rshb(e, CYASSL_BIT_SIZE - (orderBits & 0x7));
+
+   return err;
+}
+
+
 /**
   Sign a message digest
   in        The message digest to sign
@@ -1621,10 +1688,23 @@ int ecc_sign_hash(const byte* in, word32 inlen, byte* out, word32 *outlen,
    mp_int        e;
    mp_int        p;
    int           err;
+#ifdef CYASSL_SMALL_STACK
+   ecc_key*      pubkey;
+#else
+   ecc_key       pubkey[1];
+#endif
 
    if (in == NULL || out == NULL || outlen == NULL || key == NULL || rng ==NULL)
        return ECC_BAD_ARG_E;
 
+#ifdef CYASSL_CRYPTO_DEV
+   if (key->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+       err = CryptoDev_EccSign(key, in, inlen, out, outlen, rng);
+       if (err != CRYPTO_DEV_UNAVAILABLE_E)
+           return err;
+   }
+#endif
+
    /* is this a private key? */
    if (key->type != ECC_PRIVATEKEY) {
       return ECC_BAD_ARG_E;
@@ -1642,37 +1722,35 @@ int ecc_sign_hash(const byte* in, word32 inlen, byte* out, word32 *outlen,
    }
    err = mp_read_radix(&p, (char *)key->dp->order, 16);
 
-   if (err == MP_OKAY) {
-       /* we may need to truncate if hash is longer than key size */
-       word32 orderBits = mp_count_bits(&p);
-
-       /* truncate down to byte size, may be all that's needed */
-       if ( (CYASSL_BIT_SIZE * inlen) > orderBits)
-           inlen = (orderBits + CYASSL_BIT_SIZE - 1)/CYASSL_BIT_SIZE;
-       err = mp_read_unsigned_bin(&e, (byte*)in, inlen);
+   if (err == MP_OKAY)
+       err = ecc_load_hash(&e, in, inlen, &p);
 
-       /* may still need bit truncation too */
-       if (err == MP_OKAY && (CYASSL_BIT_SIZE * inlen) > orderBits)
-           mp_rshb(&e, CYASSL_BIT_SIZE - (orderBits & 0x7));
+#ifdef CYASSL_SMALL_STACK
+   pubkey = NULL;
+   if (err == MP_OKAY) {
+       pubkey = (ecc_key*)XMALLOC(sizeof(ecc_key), NULL,
+                                  DYNAMIC_TYPE_TMP_BUFFER);
+       if (pubkey == NULL)
+           err = MEMORY_E;
    }
+#endif
 
    /* make up a key and export the public copy */
    if (err == MP_OKAY) {
-       ecc_key pubkey;
-       ecc_init(&pubkey);
+       ecc_init(pubkey);
        for (;;) {
-           err = ecc_make_key_ex(rng, &pubkey, key->dp);
+           err = ecc_make_key_ex(rng, pubkey, key->dp);
            if (err != MP_OKAY) break;
 
            /* find r = x1 mod n */
-           err = mp_mod(&pubkey.pubkey.x, &p, &r);
+           err = mp_mod(pubkey->pubkey.x, &p, &r);
            if (err != MP_OKAY) break;
 
            if (mp_iszero(&r) == MP_YES)
-               ecc_free(&pubkey);
+               ecc_free(pubkey);
            else { 
                /* find s = (e + xr)/k */
-               err = mp_invmod(&pubkey.k, &p, &pubkey.k);
+               err = mp_invmod(&pubkey->k, &p, &pubkey->k);
                if (err != MP_OKAY) break;
 
                err = mp_mulmod(&key->k, &r, &p, &s);   /* s = xr */
@@ -1684,15 +1762,15 @@ int ecc_sign_hash(const byte* in, word32 inlen, byte* out, word32 *outlen,
                err = mp_mod(&s, &p, &s);               /* s = e +  xr */
                if (err != MP_OKAY) break;
 
-               err = mp_mulmod(&s, &pubkey.k, &p, &s); /* s = (e + xr)/k */
+               err = mp_mulmod(&s, &pubkey->k, &p, &s); /* s = (e + xr)/k */
                if (err != MP_OKAY) break;
 
-               ecc_free(&pubkey);
+               ecc_free(pubkey);
                if (mp_iszero(&s) == MP_NO)
                    break;
             }
        }
-       ecc_free(&pubkey);
+       ecc_free(pubkey);
    }
 
    /* store as SEQUENCE { r, s -- integer } */
@@ -1703,6 +1781,9 @@ int ecc_sign_hash(const byte* in, word32 inlen, byte* out, word32 *outlen,
    mp_clear(&s);
    mp_clear(&p);
    mp_clear(&e);
+#ifdef CYASSL_SMALL_STACK
+   XFREE(pubkey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
 
    return err;
 }
@@ -1717,13 +1798,32 @@ void ecc_free(ecc_key* key)
    if (key == NULL)
        return;
 
-   mp_clear(&key->pubkey.x);
-   mp_clear(&key->pubkey.y);
-   mp_clear(&key->pubkey.z);
+#ifdef ALT_ECC_SIZE
+   /* a zeroed key that never had its coordinates set up */
+   if (key->pubkey.x != NULL)
+#endif
+   {
+       mp_clear(key->pubkey.x);
+       mp_clear(key->pubkey.y);
+       mp_clear(key->pubkey.z);
+   }
    mp_clear(&key->k);
 }
 
 
+#ifdef CYASSL_CRYPTO_DEV
+
+/* send this key's signs and shared secrets to the device registered as devId
+   first */
+void EccSetDevId(ecc_key* key, int devId)
+{
+    key->cdevId    = devId;
+    key->cdevMagic = CYASSL_CRYPTO_DEV_MAGIC;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
+
 #ifdef USE_FAST_MATH
     #define GEN_MEM_ERR FP_MEM
 #else
@@ -1739,16 +1839,18 @@ void ecc_free(ecc_key* key)
   kB       What to multiple B by
   C        [out] Destination point (can overlap with A or B)
   modulus  Modulus for curve 
+  map      Boolean whether to map back to affine or not
+                (1==map, 0 == leave in projective)
   return MP_OKAY on success
 */
 #ifdef FP_ECC
 static int normal_ecc_mul2add(ecc_point* A, mp_int* kA,
                              ecc_point* B, mp_int* kB,
-                             ecc_point* C, mp_int* modulus)
+                             ecc_point* C, mp_int* modulus, int map)
 #else
 static int ecc_mul2add(ecc_point* A, mp_int* kA,
                     ecc_point* B, mp_int* kB,
-                    ecc_point* C, mp_int* modulus)
+                    ecc_point* C, mp_int* modulus, int map)
 #endif
 {
   ecc_point*     precomp[16];
@@ -1830,19 +1932,19 @@ static int ecc_mul2add(ecc_point* A, mp_int* kA,
 
   if (err == MP_OKAY)
     /* copy ones ... */
-    err = mp_mulmod(&A->x, &mu, modulus, &precomp[1]->x);
+    err = mp_mulmod(A->x, &mu, modulus, precomp[1]->x);
 
   if (err == MP_OKAY)
-    err = mp_mulmod(&A->y, &mu, modulus, &precomp[1]->y);
+    err = mp_mulmod(A->y, &mu, modulus, precomp[1]->y);
   if (err == MP_OKAY)
-    err = mp_mulmod(&A->z, &mu, modulus, &precomp[1]->z);
+    err = mp_mulmod(A->z, &mu, modulus, precomp[1]->z);
 
   if (err == MP_OKAY)
-    err = mp_mulmod(&B->x, &mu, modulus, &precomp[1<<2]->x);
+    err = mp_mulmod(B->x, &mu, modulus, precomp[1<<2]->x);
   if (err == MP_OKAY)
-    err = mp_mulmod(&B->y, &mu, modulus, &precomp[1<<2]->y);
+    err = mp_mulmod(B->y, &mu, modulus, precomp[1<<2]->y);
   if (err == MP_OKAY)
-    err = mp_mulmod(&B->z, &mu, modulus, &precomp[1<<2]->z);
+    err = mp_mulmod(B->z, &mu, modulus, precomp[1<<2]->z);
 
   if (err == MP_OKAY)
     /* precomp [i,0](A + B) table */
@@ -1914,13 +2016,13 @@ static int ecc_mul2add(ecc_point* A, mp_int* kA,
                 /* if first, copy from table */
                 first = 0;
                 if (err == MP_OKAY)
-                    err = mp_copy(&precomp[nA + (nB<<2)]->x, &C->x);
+                    err = mp_copy(precomp[nA + (nB<<2)]->x, C->x);
 
                 if (err == MP_OKAY)
-                    err = mp_copy(&precomp[nA + (nB<<2)]->y, &C->y);
+                    err = mp_copy(precomp[nA + (nB<<2)]->y, C->y);
 
                 if (err == MP_OKAY)
-                    err = mp_copy(&precomp[nA + (nB<<2)]->z, &C->z);
+                    err = mp_copy(precomp[nA + (nB<<2)]->z, C->z);
                 else
                     break;
             } else {
@@ -1935,7 +2037,7 @@ static int ecc_mul2add(ecc_point* A, mp_int* kA,
     }
   }
 
-  if (err == MP_OKAY)
+  if (err == MP_OKAY && map)
     /* reduce to affine */
     err = ecc_map(C, modulus, &mp);
 
@@ -1962,6 +2064,9 @@ static int ecc_mul2add(ecc_point* A, mp_int* kA,
 #endif /* ECC_SHAMIR */
 
 
+static int ecc_verify_hash_ex(const byte* sig, word32 siglen, const byte* hash,
+                              word32 hashlen, int* stat, ecc_key* key,
+                              const struct ecc_p256_table* table);
 
 /* verify 
  *
@@ -1985,22 +2090,30 @@ static int ecc_mul2add(ecc_point* A, mp_int* kA,
 */
 int ecc_verify_hash(const byte* sig, word32 siglen, const byte* hash,
                     word32 hashlen, int* stat, ecc_key* key)
+{
+   return ecc_verify_hash_ex(sig, siglen, hash, hashlen, stat, key, NULL);
+}
+
+
+/* ecc_verify_hash() with key's precomputed multiples when table isn't NULL */
+static int ecc_verify_hash_ex(const byte* sig, word32 siglen, const byte* hash,
+                              word32 hashlen, int* stat, ecc_key* key,
+                              const struct ecc_p256_table* table)
 {
    ecc_point    *mG, *mQ;
-   mp_int        r;
-   mp_int        s;
-   mp_int        v;
-   mp_int        w;
-   mp_int        u1;
-   mp_int        u2;
-   mp_int        e;
-   mp_int        p;
-   mp_int        m;
+   mp_int       *r, *s, *v, *w, *u1, *u2, *e, *p, *m;
    int           err;
+#ifdef CYASSL_SMALL_STACK
+   mp_int*       t;
+#else
+   mp_int        t[9];
+#endif
 
    if (sig == NULL || hash == NULL || stat == NULL || key == NULL)
        return ECC_BAD_ARG_E; 
 
+   (void)table;
+
    /* default to invalid signature */
    *stat = 0;
 
@@ -2009,18 +2122,32 @@ int ecc_verify_hash(const byte* sig, word32 siglen, const byte* hash,
       return ECC_BAD_ARG_E;
    }
 
+#ifdef CYASSL_SMALL_STACK
+   t = (mp_int*)XMALLOC(sizeof(mp_int) * 9, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+   if (t == NULL)
+      return MEMORY_E;
+#endif
+   r  = &t[0]; s  = &t[1]; v = &t[2]; w = &t[3]; u1 = &t[4];
+   u2 = &t[5]; e  = &t[6]; p = &t[7]; m = &t[8];
+
    /* allocate ints */
-   if ((err = mp_init_multi(&v, &w, &u1, &u2, &p, &e)) != MP_OKAY) {
+   if ((err = mp_init_multi(v, w, u1, u2, p, e)) != MP_OKAY) {
+#ifdef CYASSL_SMALL_STACK
+      XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
       return MEMORY_E;
    }
 
-   if ((err = mp_init(&m)) != MP_OKAY) {
-      mp_clear(&v);
-      mp_clear(&w);
-      mp_clear(&u1);
-      mp_clear(&u2);
-      mp_clear(&p);
-      mp_clear(&e);
+   if ((err = mp_init(m)) != MP_OKAY) {
+      mp_clear(v);
+      mp_clear(w);
+      mp_clear(u1);
+      mp_clear(u2);
+      mp_clear(p);
+      mp_clear(e);
+#ifdef CYASSL_SMALL_STACK
+      XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
       return MEMORY_E;
    }
 
@@ -2034,296 +2161,850 @@ int ecc_verify_hash(const byte* sig, word32 siglen, const byte* hash,
     * If either of those don't allocate correctly, none of
     * the rest of this function will execute, and everything
     * gets cleaned up at the end. */
-   XMEMSET(&r, 0, sizeof(r));
-   XMEMSET(&s, 0, sizeof(s));
+   XMEMSET(r, 0, sizeof(mp_int));
+   XMEMSET(s, 0, sizeof(mp_int));
    if (err == MP_OKAY) 
-       err = DecodeECC_DSA_Sig(sig, siglen, &r, &s);
+       err = DecodeECC_DSA_Sig(sig, siglen, r, s);
 
    /* get the order */
    if (err == MP_OKAY)
-       err = mp_read_radix(&p, (char *)key->dp->order, 16);
+       err = mp_read_radix(p, (char *)key->dp->order, 16);
 
    /* get the modulus */
    if (err == MP_OKAY)
-       err = mp_read_radix(&m, (char *)key->dp->prime, 16);
+       err = mp_read_radix(m, (char *)key->dp->prime, 16);
 
    /* check for zero */
    if (err == MP_OKAY) {
-       if (mp_iszero(&r) || mp_iszero(&s) || mp_cmp(&r, &p) != MP_LT ||
-                                             mp_cmp(&s, &p) != MP_LT)
+       if (mp_iszero(r) || mp_iszero(s) || mp_cmp(r, p) != MP_LT ||
+                                             mp_cmp(s, p) != MP_LT)
            err = MP_ZERO_E; 
    }
    /* read hash */
-   if (err == MP_OKAY) {
-       /* we may need to truncate if hash is longer than key size */
-       unsigned int orderBits = mp_count_bits(&p);
-
-       /* truncate down to byte size, may be all that's needed */
-       if ( (CYASSL_BIT_SIZE * hashlen) > orderBits)
-           hashlen = (orderBits + CYASSL_BIT_SIZE - 1)/CYASSL_BIT_SIZE;
-       err = mp_read_unsigned_bin(&e, hash, hashlen);
-
-       /* may still need bit truncation too */
-       if (err == MP_OKAY && (CYASSL_BIT_SIZE * hashlen) > orderBits)
-           mp_rshb(&e, CYASSL_BIT_SIZE - (orderBits & 0x7));
-   }
+   if (err == MP_OKAY)
+       err = ecc_load_hash(e, hash, hashlen, p);
 
    /*  w  = s^-1 mod n */
    if (err == MP_OKAY)
-       err = mp_invmod(&s, &p, &w);
+       err = mp_invmod(s, p, w);
 
    /* u1 = ew */
    if (err == MP_OKAY)
-       err = mp_mulmod(&e, &w, &p, &u1);
+       err = mp_mulmod(e, w, p, u1);
 
    /* u2 = rw */
    if (err == MP_OKAY)
-       err = mp_mulmod(&r, &w, &p, &u2);
+       err = mp_mulmod(r, w, p, u2);
 
    /* find mG and mQ */
    if (err == MP_OKAY)
-       err = mp_read_radix(&mG->x, (char *)key->dp->Gx, 16);
+       err = mp_read_radix(mG->x, (char *)key->dp->Gx, 16);
 
    if (err == MP_OKAY)
-       err = mp_read_radix(&mG->y, (char *)key->dp->Gy, 16);
+       err = mp_read_radix(mG->y, (char *)key->dp->Gy, 16);
    if (err == MP_OKAY)
-       mp_set(&mG->z, 1);
+       mp_set(mG->z, 1);
 
    if (err == MP_OKAY)
-       err = mp_copy(&key->pubkey.x, &mQ->x);
+       err = mp_copy(key->pubkey.x, mQ->x);
    if (err == MP_OKAY)
-       err = mp_copy(&key->pubkey.y, &mQ->y);
+       err = mp_copy(key->pubkey.y, mQ->y);
    if (err == MP_OKAY)
-       err = mp_copy(&key->pubkey.z, &mQ->z);
+       err = mp_copy(key->pubkey.z, mQ->z);
 
+#ifdef HAVE_ECC_P256
+   if (ecc_p256_curve(key->dp)) {
+       /* u1*G + u2*Q with the fixed base table for G */
+       if (err == MP_OKAY && table != NULL)
+           err = ecc_p256_mul2add_table(u1, u2, table, mG);
+       else if (err == MP_OKAY)
+           err = ecc_p256_mul2add(u1, u2, mQ, mG);
+   }
+   else
+#endif
 #ifndef ECC_SHAMIR
     {
        mp_digit      mp;
 
        /* compute u1*mG + u2*mQ = mG */
        if (err == MP_OKAY)
-           err = ecc_mulmod(&u1, mG, mG, &m, 0);
+           err = ecc_mulmod(u1, mG, mG, m, 0);
        if (err == MP_OKAY)
-           err = ecc_mulmod(&u2, mQ, mQ, &m, 0);
+           err = ecc_mulmod(u2, mQ, mQ, m, 0);
   
        /* find the montgomery mp */
        if (err == MP_OKAY)
-           err = mp_montgomery_setup(&m, &mp);
+           err = mp_montgomery_setup(m, &mp);
 
        /* add them */
        if (err == MP_OKAY)
-           err = ecc_projective_add_point(mQ, mG, mG, &m, &mp);
+           err = ecc_projective_add_point(mQ, mG, mG, m, &mp);
    
        /* reduce */
        if (err == MP_OKAY)
-           err = ecc_map(mG, &m, &mp);
+           err = ecc_map(mG, m, &mp);
     }
 #else
+    {
        /* use Shamir's trick to compute u1*mG + u2*mQ using half the doubles */
        if (err == MP_OKAY)
-           err = ecc_mul2add(mG, &u1, mQ, &u2, mG, &m);
+           err = ecc_mul2add(mG, u1, mQ, u2, mG, m, 1);
+    }
 #endif /* ECC_SHAMIR */ 
 
    /* v = X_x1 mod n */
    if (err == MP_OKAY)
-       err = mp_mod(&mG->x, &p, &v);
+       err = mp_mod(mG->x, p, v);
 
    /* does v == r */
    if (err == MP_OKAY) {
-       if (mp_cmp(&v, &r) == MP_EQ)
+       if (mp_cmp(v, r) == MP_EQ)
            *stat = 1;
    }
 
    ecc_del_point(mG);
    ecc_del_point(mQ);
 
-   mp_clear(&r);
-   mp_clear(&s);
-   mp_clear(&v);
-   mp_clear(&w);
-   mp_clear(&u1);
-   mp_clear(&u2);
-   mp_clear(&p);
-   mp_clear(&e);
-   mp_clear(&m);
+   mp_clear(r);
+   mp_clear(s);
+   mp_clear(v);
+   mp_clear(w);
+   mp_clear(u1);
+   mp_clear(u2);
+   mp_clear(p);
+   mp_clear(e);
+   mp_clear(m);
+
+#ifdef CYASSL_SMALL_STACK
+   XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
 
    return err;
 }
 
 
-/* export public ECC key in ANSI X9.63 format */
-int ecc_export_x963(ecc_key* key, byte* out, word32* outLen)
+/* import the public key in, then for P-256 precompute its multiples */
+int ecc_verify_key_import(const byte* in, word32 inLen, ecc_verify_key* vk)
 {
-#ifdef CYASSL_SMALL_STACK
-   byte*  buf;
-#else
-   byte   buf[ECC_BUFSIZE];
-#endif
-   word32 numlen;
-   int    ret = MP_OKAY;
+   int err;
 
-   /* return length needed only */
-   if (key != NULL && out == NULL && outLen != NULL) {
-      numlen = key->dp->size;
-      *outLen = 1 + 2*numlen;
-      return LENGTH_ONLY_E;
-   }
+   if (in == NULL || vk == NULL)
+       return ECC_BAD_ARG_E;
 
-   if (key == NULL || out == NULL || outLen == NULL)
-      return ECC_BAD_ARG_E;
+   vk->table = NULL;
+   ecc_init(&vk->key);
+   if ((err = ecc_import_x963(in, inLen, &vk->key)) != MP_OKAY)
+       return err;
 
-   if (ecc_is_valid_idx(key->idx) == 0) {
-      return ECC_BAD_ARG_E;
+#ifdef HAVE_ECC_P256
+   if (ecc_p256_curve(vk->key.dp)) {
+       vk->table = (ecc_p256_table*)XMALLOC(sizeof(ecc_p256_table), NULL,
+                                            DYNAMIC_TYPE_ECC);
+       if (vk->table == NULL)
+           err = MEMORY_E;
+       else
+           err = ecc_p256_table_setup(vk->table, &vk->key.pubkey);
+       if (err != MP_OKAY) {
+           ecc_verify_key_free(vk);
+           return err;
+       }
    }
-   numlen = key->dp->size;
+#endif
 
-   if (*outLen < (1 + 2*numlen)) {
-      *outLen = 1 + 2*numlen;
-      return BUFFER_E;
-   }
+   return MP_OKAY;
+}
 
-   /* store byte 0x04 */
-   out[0] = 0x04;
 
-#ifdef CYASSL_SMALL_STACK
-   buf = (byte*)XMALLOC(ECC_BUFSIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-   if (buf == NULL)
-      return MEMORY_E;
-#endif
+/* the same from key's public part, key stays the caller's */
+int ecc_verify_key_prepare(ecc_key* key, ecc_verify_key* vk)
+{
+   byte   buf[ECC_BUFSIZE];
+   word32 bufSz = sizeof(buf);
+   int    err;
 
-   do {
-      /* pad and store x */
-      XMEMSET(buf, 0, ECC_BUFSIZE);
-      ret = mp_to_unsigned_bin(&key->pubkey.x,
-                         buf + (numlen - mp_unsigned_bin_size(&key->pubkey.x)));
-      if (ret != MP_OKAY)
-         break;
-      XMEMCPY(out+1, buf, numlen);
+   if (key == NULL || vk == NULL)
+       return ECC_BAD_ARG_E;
 
-      /* pad and store y */
-      XMEMSET(buf, 0, ECC_BUFSIZE);
-      ret = mp_to_unsigned_bin(&key->pubkey.y,
-                         buf + (numlen - mp_unsigned_bin_size(&key->pubkey.y)));
-      if (ret != MP_OKAY)
-         break;
-      XMEMCPY(out+1+numlen, buf, numlen);
+   if ((err = ecc_export_x963(key, buf, &bufSz)) != MP_OKAY)
+       return err;
 
-      *outLen = 1 + 2*numlen;
-   } while (0);
+   return ecc_verify_key_import(buf, bufSz, vk);
+}
 
-#ifdef CYASSL_SMALL_STACK
-   XFREE(buf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-#endif
 
-   return ret;
+void ecc_verify_key_free(ecc_verify_key* vk)
+{
+   if (vk == NULL)
+       return;
+
+   XFREE(vk->table, NULL, DYNAMIC_TYPE_ECC);
+   vk->table = NULL;
+   ecc_free(&vk->key);
 }
 
 
-/* export public ECC key in ANSI X9.63 format, extended with
- * compression option */
-int ecc_export_x963_ex(ecc_key* key, byte* out, word32* outLen, int compressed)
+int ecc_verify_hash_vk(const byte* sig, word32 siglen, const byte* hash,
+                       word32 hashlen, int* stat, ecc_verify_key* vk)
 {
-    if (compressed == 0)
-        return ecc_export_x963(key, out, outLen);
-#ifdef HAVE_COMP_KEY
-    else
-        return ecc_export_x963_compressed(key, out, outLen);
-#endif
+   if (vk == NULL)
+       return ECC_BAD_ARG_E;
 
-    return NOT_COMPILED_IN;
+   return ecc_verify_hash_ex(sig, siglen, hash, hashlen, stat, &vk->key,
+                             vk->table);
 }
 
 
-/* import public ECC key in ANSI X9.63 format */
-int ecc_import_x963(const byte* in, word32 inLen, ecc_key* key)
+/* take an unmapped point from the ecc_mulmod() family out of the montgomery
+   domain, leaving it projective */
+static int ecc_point_reduce(ecc_point* P, mp_int* modulus, mp_digit mp)
 {
-   int x, err;
-   int compressed = 0;
-   
-   if (in == NULL || key == NULL)
-       return ECC_BAD_ARG_E;
+   int err = mp_montgomery_reduce(P->x, modulus, mp);
 
-   /* must be odd */
-   if ((inLen & 1) == 0) {
-      return ECC_BAD_ARG_E;
-   }
+   if (err == MP_OKAY)
+       err = mp_montgomery_reduce(P->y, modulus, mp);
+   if (err == MP_OKAY)
+       err = mp_montgomery_reduce(P->z, modulus, mp);
 
-   /* init key */
-   if (mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z, &key->k,
-                     NULL, NULL) != MP_OKAY) {
-      return MEMORY_E;
-   }
-   err = MP_OKAY;
+   return err;
+}
 
-   /* check for 4, 2, or 3 */
-   if (in[0] != 0x04 && in[0] != 0x02 && in[0] != 0x03) {
-      err = ASN_PARSE_E;
-   }
 
-   if (in[0] == 0x02 || in[0] == 0x03) {
-#ifdef HAVE_COMP_KEY
-       compressed = 1;
+/* R = k * G, projective in the normal domain so the caller can batch the
+   affine conversion; the P-256 code maps with its own fixed-size inversion,
+   cheaper than the shared one, and returns z = 1 */
+static int ecc_batch_mulmod(mp_int* k, ecc_point* G, ecc_point* R,
+                            const ecc_set_type* dp, mp_int* modulus,
+                            mp_digit mp)
+{
+   int err;
+
+#ifdef HAVE_ECC_P256
+   if (ecc_p256_curve(dp))
+       return ecc_p256_mulmod_base(k, R);
 #else
-       err = NOT_COMPILED_IN;
+   (void)dp;
 #endif
-   }
 
-   if (err == MP_OKAY) {
-      /* determine the idx */
+   err = ecc_mulmod(k, G, R, modulus, 0);
+   if (err == MP_OKAY)
+       err = ecc_point_reduce(R, modulus, mp);
 
-      if (compressed)
-          inLen = (inLen-1)*2 + 1;  /* used uncompressed len */
+   return err;
+}
 
-      for (x = 0; ecc_sets[x].size != 0; x++) {
-         if ((unsigned)ecc_sets[x].size >= ((inLen-1)>>1)) {
-            break;
-         }
-      }
-      if (ecc_sets[x].size == 0) {
-         err = ASN_PARSE_E;
-      } else {
-          /* set the idx */
-          key->idx  = x;
-          key->dp = &ecc_sets[x];
-          key->type = ECC_PUBLICKEY;
-      }
-   }
 
-   /* read data */
-   if (err == MP_OKAY)
-       err = mp_read_unsigned_bin(&key->pubkey.x, (byte*)in+1, (inLen-1)>>1);
+/* C = kA * A + kB * B with A the base point, projective in the normal
+   domain, or affine from the P-256 code */
+static int ecc_batch_mul2add(ecc_point* A, mp_int* kA, ecc_point* B,
+                             mp_int* kB, ecc_point* C, const ecc_set_type* dp,
+                             mp_int* modulus, mp_digit mp)
+{
+   int err;
+#ifndef ECC_SHAMIR
+   ecc_point* T;
+#endif
 
-#ifdef HAVE_COMP_KEY
-   if (err == MP_OKAY && compressed == 1) {   /* build y */
-        mp_int t1, t2, prime, a, b;
+#ifdef HAVE_ECC_P256
+   if (ecc_p256_curve(dp))
+       return ecc_p256_mul2add(kA, kB, B, C);
+#else
+   (void)dp;
+#endif
 
-        if (mp_init_multi(&t1, &t2, &prime, &a, &b, NULL) != MP_OKAY)
-            err = MEMORY_E;
+#ifdef ECC_SHAMIR
+   err = ecc_mul2add(A, kA, B, kB, C, modulus, 0);
+#else
+   T = ecc_new_point();
+   if (T == NULL)
+       return MEMORY_E;
 
-        /* load prime */
-        if (err == MP_OKAY)
-            err = mp_read_radix(&prime, (char *)key->dp->prime, 16);
+   err = ecc_mulmod(kA, A, C, modulus, 0);
+   if (err == MP_OKAY)
+       err = ecc_mulmod(kB, B, T, modulus, 0);
+   if (err == MP_OKAY)
+       err = ecc_projective_add_point(T, C, C, modulus, &mp);
 
-        /* load a */
-        if (err == MP_OKAY)
-            err = mp_read_radix(&a, (char *)key->dp->Af, 16);
+   ecc_del_point(T);
+#endif
 
-        /* load b */
-        if (err == MP_OKAY)
-            err = mp_read_radix(&b, (char *)key->dp->Bf, 16);
+   if (err == MP_OKAY)
+       err = ecc_point_reduce(C, modulus, mp);
 
-        /* compute x^3 */
-        if (err == MP_OKAY)
-            err = mp_sqr(&key->pubkey.x, &t1);
+   return err;
+}
 
-        if (err == MP_OKAY)
-            err = mp_mulmod(&t1, &key->pubkey.x, &prime, &t1);
 
-        /* compute x^3 + a*x */
-        if (err == MP_OKAY)
-            err = mp_mulmod(&a, &key->pubkey.x, &prime, &t2);
+/* Montgomery's simultaneous inversion, a[i] = 1/a[i] mod modulus for all
+   count values with a single mp_invmod, t is count values of scratch */
+static int ecc_batch_invmod(mp_int* a, mp_int* t, int count, mp_int* modulus)
+{
+#ifdef USE_FAST_MATH
+   mp_int inv, tmp;
+   int    i, err;
 
-        if (err == MP_OKAY)
+   if ((err = mp_init_multi(&inv, &tmp, NULL, NULL, NULL, NULL)) != MP_OKAY)
+       return err;
+
+   /* t[i] = a[0] * ... * a[i] */
+   err = mp_copy(&a[0], &t[0]);
+   for (i = 1; err == MP_OKAY && i < count; i++)
+       err = mp_mulmod(&t[i - 1], &a[i], modulus, &t[i]);
+
+   if (err == MP_OKAY)
+       err = mp_invmod(&t[count - 1], modulus, &inv);
+
+   /* walk back down, inv is 1/(a[0] * ... * a[i]) */
+   for (i = count - 1; err == MP_OKAY && i > 0; i--) {
+       err = mp_mulmod(&inv, &t[i - 1], modulus, &tmp);
+       if (err == MP_OKAY)
+           err = mp_mulmod(&inv, &a[i], modulus, &inv);
+       if (err == MP_OKAY)
+           err = mp_copy(&tmp, &a[i]);
+   }
+   if (err == MP_OKAY)
+       err = mp_copy(&inv, &a[0]);
+
+   mp_clear(&tmp);
+   mp_clear(&inv);
+
+   return err;
+#else
+   /* integer.c's mp_mulmod is a full division, the three per value the
+      trick needs cost more than its binary mp_invmod */
+   int i, err = MP_OKAY;
+
+   (void)t;
+   for (i = 0; err == MP_OKAY && i < count; i++)
+       err = mp_invmod(&a[i], modulus, &a[i]);
+
+   return err;
+#endif
+}
+
+
+/**
+  Sign a batch of message digests, the field inversions mapping each nonce
+  point and the nonce inversions are each done once for the whole batch
+  in        The message digests to sign
+  inlen     The length of each digest
+  out       [out] The destinations for the signatures
+  outlen    [in/out] The max sizes and resulting sizes of the signatures
+  count     The number of entries in each array
+  rng       An active RNG state
+  key       The private ECC keys, all on the same curve
+  return    MP_OKAY if successful
+*/
+int ecc_sign_hash_batch(const byte** in, const word32* inlen, byte** out,
+                        word32* outlen, int count, RNG* rng, ecc_key** key)
+{
+   mp_int*             ints;
+   mp_int              *k, *e, *r, *z, *t;
+   mp_int              s, order, prime;
+   mp_digit            mp;
+   ecc_point*          base;
+   ecc_point*          R;
+   const ecc_set_type* dp;
+   byte                buf[ECC_MAXSIZE];
+   int                 i, n, err, affine;
+
+   if (in == NULL || inlen == NULL || out == NULL || outlen == NULL ||
+       rng == NULL || key == NULL || count <= 0)
+       return ECC_BAD_ARG_E;
+
+   for (i = 0; i < count; i++) {
+       if (in[i] == NULL || out[i] == NULL || key[i] == NULL)
+           return ECC_BAD_ARG_E;
+       if (key[i]->type != ECC_PRIVATEKEY || ecc_is_valid_idx(key[i]->idx) != 1)
+           return ECC_BAD_ARG_E;
+       if (XSTRNCMP(key[i]->dp->name, key[0]->dp->name, ECC_MAXNAME) != 0)
+           return ECC_BAD_ARG_E;
+   }
+   dp = key[0]->dp;
+
+   ints = (mp_int*)XMALLOC(sizeof(mp_int) * 5 * count, NULL, DYNAMIC_TYPE_ECC);
+   if (ints == NULL)
+       return MEMORY_E;
+   k = ints;               /* nonces, then their inverses */
+   e = k + count;          /* digests */
+   r = e + count;          /* x of each nonce point, then r */
+   z = r + count;          /* z of each nonce point, then its inverse */
+   t = z + count;          /* batch inversion scratch */
+
+   if ((err = mp_init_multi(&s, &order, &prime, NULL, NULL, NULL)) != MP_OKAY) {
+       XFREE(ints, NULL, DYNAMIC_TYPE_ECC);
+       return err;
+   }
+   for (n = 0; n < 5 * count; n++) {
+       if ((err = mp_init(&ints[n])) != MP_OKAY)
+           break;
+   }
+
+   base = ecc_new_point();
+   R    = ecc_new_point();
+   if (err == MP_OKAY && (base == NULL || R == NULL))
+       err = MEMORY_E;
+
+   /* read in the curve once for the whole batch */
+   if (err == MP_OKAY)
+       err = mp_read_radix(&order, (char *)dp->order, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(&prime, (char *)dp->prime, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(base->x, (char *)dp->Gx, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(base->y, (char *)dp->Gy, 16);
+   if (err == MP_OKAY)
+       mp_set(base->z, 1);
+   if (err == MP_OKAY)
+       err = mp_montgomery_setup(&prime, &mp);
+
+   /* nonces and their points, left projective */
+   for (i = 0; err == MP_OKAY && i < count; i++) {
+       err = ecc_load_hash(&e[i], in[i], inlen[i], &order);
+
+       while (err == MP_OKAY) {
+           err = RNG_GenerateBlock(rng, buf, dp->size);
+           if (err == MP_OKAY) {
+               buf[0] |= 0x0c;
+               err = mp_read_unsigned_bin(&k[i], buf, dp->size);
+           }
+           if (err == MP_OKAY && mp_cmp(&k[i], &order) != MP_LT)
+               err = mp_mod(&k[i], &order, &k[i]);
+           if (err == MP_OKAY && mp_iszero(&k[i]) == MP_NO)
+               break;
+       }
+
+       if (err == MP_OKAY)
+           err = ecc_batch_mulmod(&k[i], base, R, dp, &prime, mp);
+       if (err == MP_OKAY)
+           err = mp_copy(R->x, &r[i]);
+       if (err == MP_OKAY)
+           err = mp_copy(R->z, &z[i]);
+   }
+
+   /* one field inversion for every point, r = x / z^2 mod n */
+   for (i = 0, affine = 1; i < count; i++) {
+       if (mp_cmp_d(&z[i], 1) != MP_EQ)
+           affine = 0;
+   }
+   if (err == MP_OKAY && !affine)
+       err = ecc_batch_invmod(z, t, count, &prime);
+   for (i = 0; err == MP_OKAY && i < count; i++) {
+       if (!affine) {
+           err = mp_sqrmod(&z[i], &prime, &z[i]);
+           if (err == MP_OKAY)
+               err = mp_mulmod(&r[i], &z[i], &prime, &r[i]);
+       }
+       if (err == MP_OKAY)
+           err = mp_mod(&r[i], &order, &r[i]);
+   }
+
+   /* one scalar inversion for every nonce */
+   if (err == MP_OKAY)
+       err = ecc_batch_invmod(k, t, count, &order);
+
+   /* s = (e + xr)/k, the rare zero r or s is signed again on its own */
+   for (i = 0; err == MP_OKAY && i < count; i++) {
+       if (mp_iszero(&r[i]) == MP_YES) {
+           err = ecc_sign_hash(in[i], inlen[i], out[i], &outlen[i], rng,
+                               key[i]);
+           continue;
+       }
+
+       err = mp_mulmod(&key[i]->k, &r[i], &order, &s);   /* s = xr */
+       if (err == MP_OKAY)
+           err = mp_add(&e[i], &s, &s);                   /* s = e +  xr */
+       if (err == MP_OKAY)
+           err = mp_mod(&s, &order, &s);
+       if (err == MP_OKAY)
+           err = mp_mulmod(&s, &k[i], &order, &s);        /* s = (e + xr)/k */
+
+       if (err == MP_OKAY) {
+           if (mp_iszero(&s) == MP_YES)
+               err = ecc_sign_hash(in[i], inlen[i], out[i], &outlen[i], rng,
+                                   key[i]);
+           else
+               err = StoreECC_DSA_Sig(out[i], &outlen[i], &r[i], &s);
+       }
+   }
+
+   ecc_del_point(R);
+   ecc_del_point(base);
+   for (i = 0; i < n; i++)
+       mp_clear(&ints[i]);
+   XFREE(ints, NULL, DYNAMIC_TYPE_ECC);
+   mp_clear(&prime);
+   mp_clear(&order);
+   mp_clear(&s);
+
+#ifdef ECC_CLEAN_STACK
+   XMEMSET(buf, 0, ECC_MAXSIZE);
+#endif
+
+   return err;
+}
+
+
+/**
+  Verify a batch of ECC signatures, the s inversions are done once for the
+  whole batch and no point is mapped back to affine: x1 == r mod n is
+  checked as X == r * Z^2 (or (r + n) * Z^2) mod p
+  sig         The signatures to verify
+  siglen      The length of each signature (octets)
+  hash        The hashes (message digests) that were signed
+  hashlen     The length of each hash (octets)
+  stat        [out] Result of each signature, 1==valid, 0==invalid
+  count       The number of entries in each array
+  key         The corresponding public ECC keys, all on the same curve
+  return      MP_OKAY if the batch was processed; a malformed signature
+              only marks its own entry invalid
+*/
+int ecc_verify_hash_batch(const byte** sig, const word32* siglen,
+                          const byte** hash, const word32* hashlen,
+                          int* stat, int count, ecc_key** key)
+{
+   mp_int*             ints;
+   mp_int              *r, *w, *t;
+   mp_int              *e, *u1, *u2, *v, *order, *prime;
+   mp_int              *sr, *ss;
+   mp_digit            mp;
+   ecc_point           *mG, *mQ, *mC;
+   const ecc_set_type* dp;
+   int                 i, n, err;
+
+   if (sig == NULL || siglen == NULL || hash == NULL || hashlen == NULL ||
+       stat == NULL || key == NULL || count <= 0)
+       return ECC_BAD_ARG_E;
+
+   for (i = 0; i < count; i++) {
+       if (sig[i] == NULL || hash[i] == NULL || key[i] == NULL)
+           return ECC_BAD_ARG_E;
+       if (ecc_is_valid_idx(key[i]->idx) != 1)
+           return ECC_BAD_ARG_E;
+       if (XSTRNCMP(key[i]->dp->name, key[0]->dp->name, ECC_MAXNAME) != 0)
+           return ECC_BAD_ARG_E;
+       /* default to invalid signature */
+       stat[i] = 0;
+   }
+   dp = key[0]->dp;
+
+   /* the per signature arrays and the fixed temporaries share one block,
+      an fp_int is too large to keep eight of them on the stack */
+   ints = (mp_int*)XMALLOC(sizeof(mp_int) * (3 * count + 8), NULL,
+                           DYNAMIC_TYPE_ECC);
+   if (ints == NULL)
+       return MEMORY_E;
+   r = ints;               /* r, zero for a malformed signature */
+   w = r + count;          /* s, then 1/s */
+   t = w + count;          /* batch inversion scratch */
+   e     = t + count;
+   u1    = e + 1;
+   u2    = e + 2;
+   v     = e + 3;
+   order = e + 4;
+   prime = e + 5;
+   sr    = e + 6;
+   ss    = e + 7;
+
+   if ((err = mp_init_multi(e, u1, u2, v, order, prime)) != MP_OKAY) {
+       XFREE(ints, NULL, DYNAMIC_TYPE_ECC);
+       return err;
+   }
+   for (n = 0; n < 3 * count; n++) {
+       if ((err = mp_init(&ints[n])) != MP_OKAY)
+           break;
+   }
+
+   mG = ecc_new_point();
+   mQ = ecc_new_point();
+   mC = ecc_new_point();
+   if (err == MP_OKAY && (mG == NULL || mQ == NULL || mC == NULL))
+       err = MEMORY_E;
+
+   /* read in the curve once for the whole batch */
+   if (err == MP_OKAY)
+       err = mp_read_radix(order, (char *)dp->order, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(prime, (char *)dp->prime, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(mG->x, (char *)dp->Gx, 16);
+   if (err == MP_OKAY)
+       err = mp_read_radix(mG->y, (char *)dp->Gy, 16);
+   if (err == MP_OKAY)
+       mp_set(mG->z, 1);
+   if (err == MP_OKAY)
+       err = mp_montgomery_setup(prime, &mp);
+
+   /* decode, keeping only signatures with r and s in range */
+   for (i = 0; err == MP_OKAY && i < count; i++) {
+       /* DecodeECC_DSA_Sig() does the mp_init() of sr and ss */
+       XMEMSET(sr, 0, sizeof(mp_int));
+       XMEMSET(ss, 0, sizeof(mp_int));
+       if (DecodeECC_DSA_Sig(sig[i], siglen[i], sr, ss) == 0 &&
+           mp_iszero(sr) == MP_NO && mp_iszero(ss) == MP_NO &&
+           mp_cmp(sr, order) == MP_LT && mp_cmp(ss, order) == MP_LT) {
+           err = mp_copy(sr, &r[i]);
+           if (err == MP_OKAY)
+               err = mp_copy(ss, &w[i]);
+       }
+       else {
+           mp_zero(&r[i]);
+           mp_set(&w[i], 1);
+       }
+       mp_clear(sr);
+       mp_clear(ss);
+   }
+
+   /*  w  = s^-1 mod n for every entry */
+   if (err == MP_OKAY)
+       err = ecc_batch_invmod(w, t, count, order);
+
+   for (i = 0; err == MP_OKAY && i < count; i++) {
+       if (mp_iszero(&r[i]) == MP_YES)
+           continue;
+
+       err = ecc_load_hash(e, hash[i], hashlen[i], order);
+
+       /* u1 = ew, u2 = rw */
+       if (err == MP_OKAY)
+           err = mp_mulmod(e, &w[i], order, u1);
+       if (err == MP_OKAY)
+           err = mp_mulmod(&r[i], &w[i], order, u2);
+
+       if (err == MP_OKAY)
+           err = mp_copy(key[i]->pubkey.x, mQ->x);
+       if (err == MP_OKAY)
+           err = mp_copy(key[i]->pubkey.y, mQ->y);
+       if (err == MP_OKAY)
+           err = mp_copy(key[i]->pubkey.z, mQ->z);
+
+       /* u1*mG + u2*mQ, projective */
+       if (err == MP_OKAY)
+           err = ecc_batch_mul2add(mG, u1, mQ, u2, mC, dp, prime, mp);
+
+       /* the point at infinity never verifies */
+       if (err != MP_OKAY || mp_iszero(mC->z) == MP_YES)
+           continue;
+
+       if (mp_cmp_d(mC->z, 1) == MP_EQ) {
+           /* already affine, v = x1 mod n */
+           err = mp_mod(mC->x, order, v);
+           if (err == MP_OKAY && mp_cmp(v, &r[i]) == MP_EQ)
+               stat[i] = 1;
+           continue;
+       }
+
+       /* X == r * Z^2, or (r + n) * Z^2 while r + n is still below p */
+       err = mp_sqrmod(mC->z, prime, u1);
+       if (err == MP_OKAY)
+           err = mp_mulmod(&r[i], u1, prime, v);
+       if (err == MP_OKAY && mp_cmp(v, mC->x) == MP_EQ) {
+           stat[i] = 1;
+           continue;
+       }
+       if (err == MP_OKAY)
+           err = mp_add(&r[i], order, u2);
+       if (err == MP_OKAY && mp_cmp(u2, prime) == MP_LT) {
+           err = mp_mulmod(u2, u1, prime, v);
+           if (err == MP_OKAY && mp_cmp(v, mC->x) == MP_EQ)
+               stat[i] = 1;
+       }
+   }
+
+   ecc_del_point(mC);
+   ecc_del_point(mQ);
+   ecc_del_point(mG);
+   for (i = 0; i < n; i++)
+       mp_clear(&ints[i]);
+   XFREE(ints, NULL, DYNAMIC_TYPE_ECC);
+   mp_clear(prime);
+   mp_clear(order);
+   mp_clear(v);
+   mp_clear(u2);
+   mp_clear(u1);
+   mp_clear(e);
+
+   return err;
+}
+
+
+/* export public ECC key in ANSI X9.63 format */
+int ecc_export_x963(ecc_key* key, byte* out, word32* outLen)
+{
+#ifdef CYASSL_SMALL_STACK
+   byte*  buf;
+#else
+   byte   buf[ECC_BUFSIZE];
+#endif
+   word32 numlen;
+   int    ret = MP_OKAY;
+
+   /* return length needed only */
+   if (key != NULL && out == NULL && outLen != NULL) {
+      numlen = key->dp->size;
+      *outLen = 1 + 2*numlen;
+      return LENGTH_ONLY_E;
+   }
+
+   if (key == NULL || out == NULL || outLen == NULL)
+      return ECC_BAD_ARG_E;
+
+   if (ecc_is_valid_idx(key->idx) == 0) {
+      return ECC_BAD_ARG_E;
+   }
+   numlen = key->dp->size;
+
+   if (*outLen < (1 + 2*numlen)) {
+      *outLen = 1 + 2*numlen;
+      return BUFFER_E;
+   }
+
+   /* store byte 0x04 */
+   out[0] = 0x04;
+
+#ifdef CYASSL_SMALL_STACK
+   buf = (byte*)XMALLOC(ECC_BUFSIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+   if (buf == NULL)
+      return MEMORY_E;
+#endif
+
+   do {
+      /* pad and store x */
+      XMEMSET(buf, 0, ECC_BUFSIZE);
+      ret = mp_to_unsigned_bin(key->pubkey.x,
+                         buf + (numlen - mp_unsigned_bin_size(key->pubkey.x)));
+      if (ret != MP_OKAY)
+         break;
+      XMEMCPY(out+1, buf, numlen);
+
+      /* pad and store y */
+      XMEMSET(buf, 0, ECC_BUFSIZE);
+      ret = mp_to_unsigned_bin(key->pubkey.y,
+                         buf + (numlen - mp_unsigned_bin_size(key->pubkey.y)));
+      if (ret != MP_OKAY)
+         break;
+      XMEMCPY(out+1+numlen, buf, numlen);
+
+      *outLen = 1 + 2*numlen;
+   } while (0);
+
+#ifdef CYASSL_SMALL_STACK
+   XFREE(buf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+   return ret;
+}
+
+
+/* export public ECC key in ANSI X9.63 format, extended with
+ * compression option */
+int ecc_export_x963_ex(ecc_key* key, byte* out, word32* outLen, int compressed)
+{
+    if (compressed == 0)
+        return ecc_export_x963(key, out, outLen);
+#ifdef HAVE_COMP_KEY
+    else
+        return ecc_export_x963_compressed(key, out, outLen);
+#endif
+
+    return NOT_COMPILED_IN;
+}
+
+
+/* import public ECC key in ANSI X9.63 format */
+int ecc_import_x963(const byte* in, word32 inLen, ecc_key* key)
+{
+   int x, err;
+   int compressed = 0;
+   
+   if (in == NULL || key == NULL)
+       return ECC_BAD_ARG_E;
+
+   /* must be odd */
+   if ((inLen & 1) == 0) {
+      return ECC_BAD_ARG_E;
+   }
+
+   /* init key */
+   if (ecc_point_init(&key->pubkey) != MP_OKAY || mp_init(&key->k) != MP_OKAY)
+      return MEMORY_E;
+   err = MP_OKAY;
+
+   /* check for 4, 2, or 3 */
+   if (in[0] != 0x04 && in[0] != 0x02 && in[0] != 0x03) {
+      err = ASN_PARSE_E;
+   }
+
+   if (in[0] == 0x02 || in[0] == 0x03) {
+#ifdef HAVE_COMP_KEY
+       compressed = 1;
+#else
+       err = NOT_COMPILED_IN;
+#endif
+   }
+
+   if (err == MP_OKAY) {
+      /* determine the idx */
+
+      if (compressed)
+          inLen = (inLen-1)*2 + 1;  /* used uncompressed len */
+
+      for (x = 0; ecc_sets[x].size != 0; x++) {
+         if ((unsigned)ecc_sets[x].size >= ((inLen-1)>>1)) {
+            break;
+         }
+      }
+      if (ecc_sets[x].size == 0) {
+         err = ASN_PARSE_E;
+      } else {
+          /* set the idx */
+          key->idx  = x;
+          key->dp = &ecc_sets[x];
+          key->type = ECC_PUBLICKEY;
+      }
+   }
+
+   /* read data */
+   if (err == MP_OKAY)
+       err = mp_read_unsigned_bin(key->pubkey.x, (byte*)in+1, (inLen-1)>>1);
+
+#ifdef HAVE_COMP_KEY
+#ifdef HAVE_ECC_P256
+   if (err == MP_OKAY && compressed == 1 && ecc_p256_curve(key->dp))
+       err = ecc_p256_decompress(key->pubkey.x, in[0] == 0x03,
+                                 key->pubkey.y);
+   else
+#endif
+   if (err == MP_OKAY && compressed == 1) {   /* build y */
+        mp_int t1, t2, prime, a, b;
+
+        if (mp_init_multi(&t1, &t2, &prime, &a, &b, NULL) != MP_OKAY)
+            err = MEMORY_E;
+
+        /* load prime */
+        if (err == MP_OKAY)
+            err = mp_read_radix(&prime, (char *)key->dp->prime, 16);
+
+        /* load a */
+        if (err == MP_OKAY)
+            err = mp_read_radix(&a, (char *)key->dp->Af, 16);
+
+        /* load b */
+        if (err == MP_OKAY)
+            err = mp_read_radix(&b, (char *)key->dp->Bf, 16);
+
+        /* compute x^3 */
+        if (err == MP_OKAY)
+            err = mp_sqr(key->pubkey.x, &t1);
+
+        if (err == MP_OKAY)
+            err = mp_mulmod(&t1, key->pubkey.x, &prime, &t1);
+
+        /* compute x^3 + a*x */
+        if (err == MP_OKAY)
+            err = mp_mulmod(&a, key->pubkey.x, &prime, &t2);
+
+        if (err == MP_OKAY)
             err = mp_add(&t1, &t2, &t1);
 
         /* compute x^3 + a*x + b */
@@ -2331,17 +3012,25 @@ int ecc_import_x963(const byte* in, word32 inLen, ecc_key* key)
             err = mp_add(&t1, &b, &t1);
 
         /* compute sqrt(x^3 + a*x + b) */
+        if (err == MP_OKAY)
+            err = mp_mod(&t1, &prime, &t1);
         if (err == MP_OKAY)
             err = mp_sqrtmod_prime(&t1, &prime, &t2);
 
+        /* no root, x isn't on the curve */
+        if (err == MP_OKAY)
+            err = mp_sqrmod(&t2, &prime, &a);
+        if (err == MP_OKAY && mp_cmp(&a, &t1) != MP_EQ)
+            err = MP_VAL;
+
         /* adjust y */
         if (err == MP_OKAY) {
             if ((mp_isodd(&t2) && in[0] == 0x03) ||
                (!mp_isodd(&t2) && in[0] == 0x02)) {
-                err = mp_mod(&t2, &prime, &key->pubkey.y);
+                err = mp_mod(&t2, &prime, key->pubkey.y);
             }
             else {
-                err = mp_submod(&prime, &t2, &prime, &key->pubkey.y);
+                err = mp_submod(&prime, &t2, &prime, key->pubkey.y);
             }
         }
 
@@ -2354,15 +3043,15 @@ int ecc_import_x963(const byte* in, word32 inLen, ecc_key* key)
 #endif
 
    if (err == MP_OKAY && compressed == 0)
-       err = mp_read_unsigned_bin(&key->pubkey.y, (byte*)in+1+((inLen-1)>>1),
+       err = mp_read_unsigned_bin(key->pubkey.y, (byte*)in+1+((inLen-1)>>1),
                                   (inLen-1)>>1);
    if (err == MP_OKAY)
-       mp_set(&key->pubkey.z, 1);
+       mp_set(key->pubkey.z, 1);
 
    if (err != MP_OKAY) {
-       mp_clear(&key->pubkey.x);
-       mp_clear(&key->pubkey.y);
-       mp_clear(&key->pubkey.z);
+       mp_clear(key->pubkey.x);
+       mp_clear(key->pubkey.y);
+       mp_clear(key->pubkey.z);
        mp_clear(&key->k);
    }
 
@@ -2467,22 +3156,20 @@ int ecc_import_raw(ecc_key* key, const char* qx, const char* qy,
         return ECC_BAD_ARG_E;
 
     /* init key */
-    if (mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z, &key->k,
-                      NULL, NULL) != MP_OKAY) {
+    if (ecc_point_init(&key->pubkey) != MP_OKAY || mp_init(&key->k) != MP_OKAY)
         return MEMORY_E;
-    }
     err = MP_OKAY;
 
     /* read Qx */
     if (err == MP_OKAY)
-        err = mp_read_radix(&key->pubkey.x, qx, 16);
+        err = mp_read_radix(key->pubkey.x, qx, 16);
 
     /* read Qy */
     if (err == MP_OKAY)
-        err = mp_read_radix(&key->pubkey.y, qy, 16);
+        err = mp_read_radix(key->pubkey.y, qy, 16);
 
     if (err == MP_OKAY)
-        mp_set(&key->pubkey.z, 1);
+        mp_set(key->pubkey.z, 1);
 
     /* read and set the curve */
     if (err == MP_OKAY) {
@@ -2509,9 +3196,9 @@ int ecc_import_raw(ecc_key* key, const char* qx, const char* qy,
     }
 
     if (err != MP_OKAY) {
-        mp_clear(&key->pubkey.x);
-        mp_clear(&key->pubkey.y);
-        mp_clear(&key->pubkey.z);
+        mp_clear(key->pubkey.x);
+        mp_clear(key->pubkey.y);
+        mp_clear(key->pubkey.z);
         mp_clear(&key->k);
     }
 
@@ -2553,6 +3240,11 @@ int ecc_sig_size(ecc_key* key)
     #define FP_LUT     8U
 #endif
 
+/* LUT entries mapped to affine per inversion, see lut_to_affine */
+#ifndef FP_LUT_BATCH
+    #define FP_LUT_BATCH 32
+#endif
+
 #ifdef ECC_SHAMIR
     /* Sharmir requires a bigger LUT, TAO */
     #if (FP_LUT > 12) || (FP_LUT < 4)
@@ -2583,6 +3275,36 @@ static THREAD_LS_T fp_cache_t fp_cache[FP_ENTRIES];
     static CyaSSL_Mutex ecc_fp_lock;
 #endif /* HAVE_THREAD_LS */
 
+/* max curve generators in the shared table, one per ecc_sets[] entry */
+#ifndef FP_FIXED_ENTRIES
+    #define FP_FIXED_ENTRIES 16
+#endif
+
+enum {
+    FP_FIXED_NONE   = 0,        /* LUT not built yet */
+    FP_FIXED_BUILT  = 1,        /* LUT ready, read only from here on */
+    FP_FIXED_FAILED = 2         /* couldn't build, use the thread cache */
+};
+
+/** Shared curve generator entry, all threads read the same LUT */
+typedef struct {
+   ecc_point* gen;             /* curve generator, set at init */
+   mp_int     prime;           /* curve modulus the LUT is for */
+   fp_cache_t cache;           /* built on first use under fp_fixed_lock */
+   int        state;           /* FP_FIXED_*, under fp_fixed_lock */
+} fp_fixed_t;
+
+static fp_fixed_t   fp_fixed[FP_FIXED_ENTRIES];
+static int          fp_fixed_count = 0;
+static int          fp_fixed_init  = 0;
+static int          fp_fixed_gen   = 0;     /* bumped by each free */
+static CyaSSL_Mutex fp_fixed_lock;
+
+/* entries this thread has seen built under the lock, so reads them lock
+   free, only good for the fp_fixed_gen it was taken in */
+static THREAD_LS_T word32 fp_fixed_seen    = 0;
+static THREAD_LS_T int    fp_fixed_seenGen = 0;
+
 /* simple table to help direct the generation of the LUT */
 static const struct {
    int ham, terma, termb;
@@ -3152,69 +3874,172 @@ static int find_base(ecc_point* g)
    int x;
    for (x = 0; x < FP_ENTRIES; x++) {
       if (fp_cache[x].g != NULL && 
-          mp_cmp(&fp_cache[x].g->x, &g->x) == MP_EQ && 
-          mp_cmp(&fp_cache[x].g->y, &g->y) == MP_EQ && 
-          mp_cmp(&fp_cache[x].g->z, &g->z) == MP_EQ) {
+          mp_cmp(fp_cache[x].g->x, g->x) == MP_EQ && 
+          mp_cmp(fp_cache[x].g->y, g->y) == MP_EQ && 
+          mp_cmp(fp_cache[x].g->z, g->z) == MP_EQ) {
          break;
       }
    }
    if (x == FP_ENTRIES) {
       x = -1;
+      CYASSL_STAT_INC(fpCacheMisses);
    }
+   else
+      CYASSL_STAT_INC(fpCacheHits);
    return x;
 }
 
 /* add a new base to the cache */
-static int add_entry(int idx, ecc_point *g)
+static int add_entry(fp_cache_t* cache, ecc_point *g)
 {
    unsigned x, y;
 
    /* allocate base and LUT */
-   fp_cache[idx].g = ecc_new_point();
-   if (fp_cache[idx].g == NULL) {
+   cache->g = ecc_new_point();
+   if (cache->g == NULL) {
       return GEN_MEM_ERR;
    }
 
    /* copy x and y */
-   if ((mp_copy(&g->x, &fp_cache[idx].g->x) != MP_OKAY) ||
-       (mp_copy(&g->y, &fp_cache[idx].g->y) != MP_OKAY) ||
-       (mp_copy(&g->z, &fp_cache[idx].g->z) != MP_OKAY)) {
-      ecc_del_point(fp_cache[idx].g);
-      fp_cache[idx].g = NULL;
+   if ((mp_copy(g->x, cache->g->x) != MP_OKAY) ||
+       (mp_copy(g->y, cache->g->y) != MP_OKAY) ||
+       (mp_copy(g->z, cache->g->z) != MP_OKAY)) {
+      ecc_del_point(cache->g);
+      cache->g = NULL;
       return GEN_MEM_ERR;
    }              
 
    for (x = 0; x < (1U<<FP_LUT); x++) {
-      fp_cache[idx].LUT[x] = ecc_new_point();
-      if (fp_cache[idx].LUT[x] == NULL) {
+      cache->LUT[x] = ecc_new_point();
+      if (cache->LUT[x] == NULL) {
          for (y = 0; y < x; y++) {
-            ecc_del_point(fp_cache[idx].LUT[y]);
-            fp_cache[idx].LUT[y] = NULL;
+            ecc_del_point(cache->LUT[y]);
+            cache->LUT[y] = NULL;
          }
-         ecc_del_point(fp_cache[idx].g);
-         fp_cache[idx].g         = NULL;
-         fp_cache[idx].lru_count = 0;
+         ecc_del_point(cache->g);
+         cache->g         = NULL;
+         cache->lru_count = 0;
          return GEN_MEM_ERR;
       }
    }
    
-   fp_cache[idx].lru_count = 0;
+   cache->lru_count = 0;
 
    return MP_OKAY;
 }
 
+/* map n projective points to affine with a single inversion: invert the
+   product of their z's, then peel the running products back off for each 1/z.
+   Everything stays in montgomery form, mu is R mod modulus, z is freed */
+static int lut_to_affine(ecc_point** P, unsigned n, mp_int* modulus,
+                         mp_digit* mp, mp_int* mu)
+{
+#ifdef CYASSL_SMALL_STACK
+   mp_int*  prod;
+#else
+   mp_int   prod[FP_LUT_BATCH];
+#endif
+   mp_int   inv, zi, tmp;
+   unsigned x, y;
+   int      err;
+
+#ifdef CYASSL_SMALL_STACK
+   prod = (mp_int*)XMALLOC(sizeof(mp_int) * FP_LUT_BATCH, NULL,
+                           DYNAMIC_TYPE_TMP_BUFFER);
+   if (prod == NULL)
+       return MEMORY_E;
+#endif
+
+   if ((err = mp_init_multi(&inv, &zi, &tmp, NULL, NULL, NULL)) != MP_OKAY) {
+#ifdef CYASSL_SMALL_STACK
+       XFREE(prod, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+       return err;
+   }
+   for (y = 0; y < n; y++) {
+       if ((err = mp_init(&prod[y])) != MP_OKAY)
+           break;
+   }
+
+   /* prod[x] = z[0] * .. * z[x] */
+   for (x = 0; x < y && err == MP_OKAY; x++) {
+       if (x == 0)
+           err = mp_copy(P[x]->z, &prod[x]);
+       else {
+           err = mp_mul(&prod[x-1], P[x]->z, &prod[x]);
+           if (err == MP_OKAY)
+               err = mp_montgomery_reduce(&prod[x], modulus, *mp);
+       }
+   }
+
+   /* 1 / (z[0] * .. * z[n-1]), the inverse of aR is 1/(aR), R^2 times that
+      is 1/a in montgomery form */
+   if (err == MP_OKAY)
+       err = mp_invmod(&prod[n-1], modulus, &inv);
+   if (err == MP_OKAY)
+       err = mp_mulmod(&inv, mu, modulus, &inv);
+   if (err == MP_OKAY)
+       err = mp_mulmod(&inv, mu, modulus, &inv);
+
+   for (x = n; x-- > 0 && err == MP_OKAY; ) {
+       /* 1/z[x] = inv * prod[x-1], then drop z[x] from inv */
+       if (x > 0) {
+           err = mp_mul(&inv, &prod[x-1], &zi);
+           if (err == MP_OKAY)
+               err = mp_montgomery_reduce(&zi, modulus, *mp);
+           if (err == MP_OKAY)
+               err = mp_mul(&inv, P[x]->z, &inv);
+           if (err == MP_OKAY)
+               err = mp_montgomery_reduce(&inv, modulus, *mp);
+       }
+       else
+           err = mp_copy(&inv, &zi);
+
+       /* fix x with 1/z^2 and y with 1/z^3 */
+       if (err == MP_OKAY)
+           err = mp_sqr(&zi, &tmp);
+       if (err == MP_OKAY)
+           err = mp_montgomery_reduce(&tmp, modulus, *mp);
+       if (err == MP_OKAY)
+           err = mp_mul(P[x]->x, &tmp, P[x]->x);
+       if (err == MP_OKAY)
+           err = mp_montgomery_reduce(P[x]->x, modulus, *mp);
+       if (err == MP_OKAY)
+           err = mp_mul(&tmp, &zi, &tmp);
+       if (err == MP_OKAY)
+           err = mp_montgomery_reduce(&tmp, modulus, *mp);
+       if (err == MP_OKAY)
+           err = mp_mul(P[x]->y, &tmp, P[x]->y);
+       if (err == MP_OKAY)
+           err = mp_montgomery_reduce(P[x]->y, modulus, *mp);
+
+       /* free z */
+       if (err == MP_OKAY)
+           mp_clear(P[x]->z);
+   }
+
+   while (y-- > 0)
+       mp_clear(&prod[y]);
+   mp_clear(&inv);
+   mp_clear(&zi);
+   mp_clear(&tmp);
+
+#ifdef CYASSL_SMALL_STACK
+   XFREE(prod, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+   return err;
+}
+
 /* build the LUT by spacing the bits of the input by #modulus/FP_LUT bits apart 
  * 
  * The algorithm builds patterns in increasing bit order by first making all 
  * single bit input patterns, then all two bit input patterns and so on
  */
-static int build_lut(int idx, mp_int* modulus, mp_digit* mp, mp_int* mu)
+static int build_lut(fp_cache_t* cache, mp_int* modulus, mp_digit* mp,
+                     mp_int* mu)
 { 
    unsigned x, y, err, bitlen, lut_gap;
-   mp_int tmp;
-
-   if (mp_init(&tmp) != MP_OKAY)
-       return GEN_MEM_ERR;
 
    /* sanity check to make sure lut_order table is of correct size,
       should compile out to a NOP if true */
@@ -3231,17 +4056,17 @@ static int build_lut(int idx, mp_int* modulus, mp_digit* mp, mp_int* mu)
     lut_gap = bitlen / FP_LUT;
 
     /* init the mu */
-    err = mp_init_copy(&fp_cache[idx].mu, mu);
+    err = mp_init_copy(&cache->mu, mu);
    }
    
    /* copy base */
    if (err == MP_OKAY) {
-     if ((mp_mulmod(&fp_cache[idx].g->x, mu, modulus,
-                  &fp_cache[idx].LUT[1]->x) != MP_OKAY) || 
-         (mp_mulmod(&fp_cache[idx].g->y, mu, modulus,
-                  &fp_cache[idx].LUT[1]->y) != MP_OKAY) || 
-         (mp_mulmod(&fp_cache[idx].g->z, mu, modulus,
-                  &fp_cache[idx].LUT[1]->z) != MP_OKAY)) {
+     if ((mp_mulmod(cache->g->x, mu, modulus,
+                  cache->LUT[1]->x) != MP_OKAY) || 
+         (mp_mulmod(cache->g->y, mu, modulus,
+                  cache->LUT[1]->y) != MP_OKAY) || 
+         (mp_mulmod(cache->g->z, mu, modulus,
+                  cache->LUT[1]->z) != MP_OKAY)) {
        err = MP_MULMOD_E; 
      }
    }
@@ -3250,20 +4075,20 @@ static int build_lut(int idx, mp_int* modulus, mp_digit* mp, mp_int* mu)
    for (x = 1; x < FP_LUT; x++) {
       if (err != MP_OKAY)
           break;
-      if ((mp_copy(&fp_cache[idx].LUT[1<<(x-1)]->x,
-                   &fp_cache[idx].LUT[1<<x]->x) != MP_OKAY) || 
-          (mp_copy(&fp_cache[idx].LUT[1<<(x-1)]->y,
-                   &fp_cache[idx].LUT[1<<x]->y) != MP_OKAY) || 
-          (mp_copy(&fp_cache[idx].LUT[1<<(x-1)]->z,
-                   &fp_cache[idx].LUT[1<<x]->z) != MP_OKAY)){
+      if ((mp_copy(cache->LUT[1<<(x-1)]->x,
+                   cache->LUT[1<<x]->x) != MP_OKAY) || 
+          (mp_copy(cache->LUT[1<<(x-1)]->y,
+                   cache->LUT[1<<x]->y) != MP_OKAY) || 
+          (mp_copy(cache->LUT[1<<(x-1)]->z,
+                   cache->LUT[1<<x]->z) != MP_OKAY)){
           err = MP_INIT_E;
           break;
       } else {
           
          /* now double it bitlen/FP_LUT times */
          for (y = 0; y < lut_gap; y++) {
-             if ((err = ecc_projective_dbl_point(fp_cache[idx].LUT[1<<x],
-                            fp_cache[idx].LUT[1<<x], modulus, mp)) != MP_OKAY) {
+             if ((err = ecc_projective_dbl_point(cache->LUT[1<<x],
+                            cache->LUT[1<<x], modulus, mp)) != MP_OKAY) {
                  break;
              }
          }
@@ -3281,71 +4106,116 @@ static int build_lut(int idx, mp_int* modulus, mp_digit* mp, mp_int* mu)
                      
            /* perform the add */
            if ((err = ecc_projective_add_point(
-                           fp_cache[idx].LUT[lut_orders[y].terma],
-                           fp_cache[idx].LUT[lut_orders[y].termb],
-                           fp_cache[idx].LUT[y], modulus, mp)) != MP_OKAY) {
+                           cache->LUT[lut_orders[y].terma],
+                           cache->LUT[lut_orders[y].termb],
+                           cache->LUT[y], modulus, mp)) != MP_OKAY) {
               break;
            }
        }
    }
       
-   /* now map all entries back to affine space to make point addition faster */
-   for (x = 1; x < (1UL<<FP_LUT); x++) {
+   /* now map all entries back to affine space to make point addition faster,
+      the adds see no z and skip its terms */
+   for (x = 1; x < (1UL<<FP_LUT); x += FP_LUT_BATCH) {
        if (err != MP_OKAY)
            break;
 
-       /* convert z to normal from montgomery */
-       err = mp_montgomery_reduce(&fp_cache[idx].LUT[x]->z, modulus, *mp);
- 
-       /* invert it */
-       if (err == MP_OKAY)
-         err = mp_invmod(&fp_cache[idx].LUT[x]->z, modulus,
-                         &fp_cache[idx].LUT[x]->z);
-
-       if (err == MP_OKAY)
-         /* now square it */
-         err = mp_sqrmod(&fp_cache[idx].LUT[x]->z, modulus, &tmp);
-       
-       if (err == MP_OKAY)
-         /* fix x */
-         err = mp_mulmod(&fp_cache[idx].LUT[x]->x, &tmp, modulus,
-                         &fp_cache[idx].LUT[x]->x);
-
-       if (err == MP_OKAY)
-         /* get 1/z^3 */
-         err = mp_mulmod(&tmp, &fp_cache[idx].LUT[x]->z, modulus, &tmp);
-
-       if (err == MP_OKAY)
-         /* fix y */
-         err = mp_mulmod(&fp_cache[idx].LUT[x]->y, &tmp, modulus,
-                         &fp_cache[idx].LUT[x]->y);
-
-       if (err == MP_OKAY)
-         /* free z */
-         mp_clear(&fp_cache[idx].LUT[x]->z);
+       y = (1UL<<FP_LUT) - x;
+       err = lut_to_affine(&cache->LUT[x],
+                           y < FP_LUT_BATCH ? y : FP_LUT_BATCH, modulus, mp,
+                           mu);
    }
-   mp_clear(&tmp);
 
    if (err == MP_OKAY)
      return MP_OKAY;
 
    /* err cleanup */
    for (y = 0; y < (1U<<FP_LUT); y++) {
-      ecc_del_point(fp_cache[idx].LUT[y]);
-      fp_cache[idx].LUT[y] = NULL;
+      ecc_del_point(cache->LUT[y]);
+      cache->LUT[y] = NULL;
+   }
+   ecc_del_point(cache->g);
+   cache->g         = NULL;
+   cache->lru_count = 0;
+   mp_clear(&cache->mu);
+
+   return err;
+}
+
+/* allocate and build the LUT for shared entry f, lock held */
+static int build_fixed(fp_fixed_t* f, mp_int* modulus)
+{
+   int      err;
+   mp_digit mp;
+   mp_int   mu;
+
+   if (mp_init(&mu) != MP_OKAY)
+       return MP_INIT_E;
+
+   err = mp_montgomery_setup(modulus, &mp);
+   if (err == MP_OKAY)
+       err = mp_montgomery_calc_normalization(&mu, modulus);
+   if (err == MP_OKAY)
+       err = add_entry(&f->cache, f->gen);
+   if (err == MP_OKAY)
+       err = build_lut(&f->cache, modulus, &mp, &mu);  /* frees on error */
+
+   mp_clear(&mu);
+
+   return err;
+}
+
+/* shared LUT if g is a curve generator on modulus, else NULL for the thread
+   cache, the first caller on each curve builds it */
+static fp_cache_t* find_fixed(ecc_point* g, mp_int* modulus)
+{
+   int x, built;
+
+   if (fp_fixed_init == 0)
+      return NULL;
+
+   if (fp_fixed_seenGen != fp_fixed_gen) {
+      fp_fixed_seen    = 0;
+      fp_fixed_seenGen = fp_fixed_gen;
+   }
+
+   for (x = 0; x < fp_fixed_count; x++) {
+      if (mp_cmp(fp_fixed[x].gen->x, g->x) == MP_EQ &&
+          mp_cmp(fp_fixed[x].gen->y, g->y) == MP_EQ &&
+          mp_cmp(fp_fixed[x].gen->z, g->z) == MP_EQ &&
+          mp_cmp(&fp_fixed[x].prime, modulus) == MP_EQ) {
+         break;
+      }
+   }
+   if (x == fp_fixed_count)
+      return NULL;
+
+   if ((fp_fixed_seen & (1UL << x)) == 0) {
+      if (LockMutex(&fp_fixed_lock) != 0)
+         return NULL;
+
+      if (fp_fixed[x].state == FP_FIXED_NONE) {
+         if (build_fixed(&fp_fixed[x], modulus) == MP_OKAY)
+            fp_fixed[x].state = FP_FIXED_BUILT;
+         else
+            fp_fixed[x].state = FP_FIXED_FAILED;
+      }
+      built = fp_fixed[x].state == FP_FIXED_BUILT;
+
+      UnLockMutex(&fp_fixed_lock);
+
+      if (!built)
+         return NULL;
+      fp_fixed_seen |= 1UL << x;
    }
-   ecc_del_point(fp_cache[idx].g);
-   fp_cache[idx].g         = NULL;
-   fp_cache[idx].lru_count = 0;
-   mp_clear(&fp_cache[idx].mu);
-   mp_clear(&tmp);
 
-   return err;
+   CYASSL_STAT_INC(fpCacheHits);
+   return &fp_fixed[x].cache;
 }
 
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* modulus,
-                        mp_digit* mp, int map)
+static int accel_fp_mul(fp_cache_t* cache, mp_int* k, ecc_point *R,
+                        mp_int* modulus, mp_digit* mp, int map)
 {
 #define KB_SIZE 128
 
@@ -3457,14 +4327,14 @@ static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* modulus,
 
           /* add if not first, otherwise copy */
           if (!first && z) {
-             if ((err = ecc_projective_add_point(R, fp_cache[idx].LUT[z], R,
+             if ((err = ecc_projective_add_point(R, cache->LUT[z], R,
                                                      modulus, mp)) != MP_OKAY) {
                 break;
              }
           } else if (z) {
-             if ((mp_copy(&fp_cache[idx].LUT[z]->x, &R->x) != MP_OKAY) ||
-                 (mp_copy(&fp_cache[idx].LUT[z]->y, &R->y) != MP_OKAY) ||
-                 (mp_copy(&fp_cache[idx].mu,        &R->z) != MP_OKAY)) {
+             if ((mp_copy(cache->LUT[z]->x, R->x) != MP_OKAY) ||
+                 (mp_copy(cache->LUT[z]->y, R->y) != MP_OKAY) ||
+                 (mp_copy(&cache->mu,        R->z) != MP_OKAY)) {
                  err = GEN_MEM_ERR;
                  break;
              }
@@ -3495,9 +4365,10 @@ static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* modulus,
 
 #ifdef ECC_SHAMIR
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul2add(int idx1, int idx2, 
+static int accel_fp_mul2add(fp_cache_t* cache1, fp_cache_t* cache2,
                             mp_int* kA, mp_int* kB,
-                            ecc_point *R, mp_int* modulus, mp_digit* mp)
+                            ecc_point *R, mp_int* modulus, mp_digit* mp,
+                            int map)
 {
 #define KB_SIZE 128
 
@@ -3679,22 +4550,22 @@ static int accel_fp_mul2add(int idx1, int idx2,
           /* add if not first, otherwise copy */
           if (!first) {
              if (zA) {
-                if ((err = ecc_projective_add_point(R, fp_cache[idx1].LUT[zA],
+                if ((err = ecc_projective_add_point(R, cache1->LUT[zA],
                                                   R, modulus, mp)) != MP_OKAY) {
                    break;
                 }
              }
              if (zB) {
-                if ((err = ecc_projective_add_point(R, fp_cache[idx2].LUT[zB],
+                if ((err = ecc_projective_add_point(R, cache2->LUT[zB],
                                                   R, modulus, mp)) != MP_OKAY) {
                    break;
                 }
              }
           } else {
              if (zA) {
-                 if ((mp_copy(&fp_cache[idx1].LUT[zA]->x, &R->x) != MP_OKAY) ||
-                    (mp_copy(&fp_cache[idx1].LUT[zA]->y,  &R->y) != MP_OKAY) ||
-                    (mp_copy(&fp_cache[idx1].mu,          &R->z) != MP_OKAY)) {
+                 if ((mp_copy(cache1->LUT[zA]->x, R->x) != MP_OKAY) ||
+                    (mp_copy(cache1->LUT[zA]->y,  R->y) != MP_OKAY) ||
+                    (mp_copy(&cache1->mu,          R->z) != MP_OKAY)) {
                      err = GEN_MEM_ERR;
                      break;
                  }
@@ -3703,14 +4574,14 @@ static int accel_fp_mul2add(int idx1, int idx2,
              if (zB && first == 0) {
                 if (zB) {
                    if ((err = ecc_projective_add_point(R,
-                           fp_cache[idx2].LUT[zB], R, modulus, mp)) != MP_OKAY){
+                           cache2->LUT[zB], R, modulus, mp)) != MP_OKAY){
                       break;
                    }
                 }
              } else if (zB && first == 1) {
-                 if ((mp_copy(&fp_cache[idx2].LUT[zB]->x, &R->x) != MP_OKAY) ||
-                    (mp_copy(&fp_cache[idx2].LUT[zB]->y, &R->y) != MP_OKAY) ||
-                    (mp_copy(&fp_cache[idx2].mu,        &R->z) != MP_OKAY)) {
+                 if ((mp_copy(cache2->LUT[zB]->x, R->x) != MP_OKAY) ||
+                    (mp_copy(cache2->LUT[zB]->y, R->y) != MP_OKAY) ||
+                    (mp_copy(&cache2->mu,        R->z) != MP_OKAY)) {
                      err = GEN_MEM_ERR;
                      break;
                  }
@@ -3730,7 +4601,10 @@ static int accel_fp_mul2add(int idx1, int idx2,
 
 #undef KB_SIZE
 
-   return ecc_map(R, modulus, mp);
+   if (map)
+       return ecc_map(R, modulus, mp);
+
+   return MP_OKAY;
 }
 
 /** ECC Fixed Point mulmod global
@@ -3741,15 +4615,19 @@ static int accel_fp_mul2add(int idx1, int idx2,
   kB       What to multiple B by
   C        [out] Destination point (can overlap with A or B)
   modulus  Modulus for curve 
+  map      Boolean whether to map back to affine or not
+                (1==map, 0 == leave in projective)
   return MP_OKAY on success
 */ 
 int ecc_mul2add(ecc_point* A, mp_int* kA,
                 ecc_point* B, mp_int* kB,
-                ecc_point* C, mp_int* modulus)
+                ecc_point* C, mp_int* modulus, int map)
 {
    int  idx1 = -1, idx2 = -1, err = MP_OKAY, mpInit = 0;
    mp_digit mp;
    mp_int   mu;
+   fp_cache_t* cache1;
+   fp_cache_t* cache2;
   
    err = mp_init(&mu);
    if (err != MP_OKAY)
@@ -3764,14 +4642,19 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
       return BAD_MUTEX_E;
 #endif /* HAVE_THREAD_LS */
 
+      /* curve generators use the shared LUT, the cache is for the rest */
+      cache1 = find_fixed(A, modulus);
+      cache2 = find_fixed(B, modulus);
+
       /* find point */
-      idx1 = find_base(A);
+      if (cache1 == NULL)
+         idx1 = find_base(A);
 
       /* no entry? */
-      if (idx1 == -1) {
+      if (cache1 == NULL && idx1 == -1) {
          /* find hole and add it */
          if ((idx1 = find_hole()) >= 0) {
-            err = add_entry(idx1, A);
+            err = add_entry(&fp_cache[idx1], A);
          }
       }
       if (err == MP_OKAY && idx1 != -1) {
@@ -3779,16 +4662,16 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
          ++(fp_cache[idx1].lru_count);
       }
 
-      if (err == MP_OKAY)
+      if (err == MP_OKAY && cache2 == NULL)
         /* find point */
         idx2 = find_base(B);
 
-      if (err == MP_OKAY) {
+      if (err == MP_OKAY && cache2 == NULL) {
         /* no entry? */
         if (idx2 == -1) {
            /* find hole and add it */
            if ((idx2 = find_hole()) >= 0)
-              err = add_entry(idx2, B);
+              err = add_entry(&fp_cache[idx2], B);
          }
       }
 
@@ -3810,7 +4693,7 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
                  
            if (err == MP_OKAY)
              /* build the LUT */
-               err = build_lut(idx1, modulus, &mp, &mu);
+               err = build_lut(&fp_cache[idx1], modulus, &mp, &mu);
         }
       }
 
@@ -3828,22 +4711,26 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
                  
             if (err == MP_OKAY) 
             /* build the LUT */
-              err = build_lut(idx2, modulus, &mp, &mu);
+              err = build_lut(&fp_cache[idx2], modulus, &mp, &mu);
         }
       }
 
+      if (idx1 >= 0 && fp_cache[idx1].lru_count >= 2)
+        cache1 = &fp_cache[idx1];
+      if (idx2 >= 0 && fp_cache[idx2].lru_count >= 2)
+        cache2 = &fp_cache[idx2];
 
       if (err == MP_OKAY) {
-        if (idx1 >=0 && idx2 >= 0 && fp_cache[idx1].lru_count >= 2 &&
-                                     fp_cache[idx2].lru_count >= 2) {
+        if (cache1 != NULL && cache2 != NULL) {
            if (mpInit == 0) {
               /* compute mp */
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul2add(idx1, idx2, kA, kB, C, modulus, &mp);
+             err = accel_fp_mul2add(cache1, cache2, kA, kB, C, modulus, &mp,
+                                    map);
         } else {
-           err = normal_ecc_mul2add(A, kA, B, kB, C, modulus);
+           err = normal_ecc_mul2add(A, kA, B, kB, C, modulus, map);
         }
     }
 
@@ -3872,6 +4759,7 @@ int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
    mp_digit mp;
    mp_int   mu;
    int      mpSetup = 0;
+   fp_cache_t* cache;
 
    if (mp_init(&mu) != MP_OKAY)
        return MP_INIT_E;
@@ -3886,16 +4774,19 @@ int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
       return BAD_MUTEX_E;
 #endif /* HAVE_THREAD_LS */
 
+      /* curve generators use the shared LUT, the cache is for the rest */
+      cache = find_fixed(G, modulus);
+
       /* find point */
-      idx = find_base(G);
+      idx = cache ? -1 : find_base(G);
 
       /* no entry? */
-      if (idx == -1) {
+      if (cache == NULL && idx == -1) {
          /* find hole and add it */
          idx = find_hole();
 
          if (idx >= 0)
-            err = add_entry(idx, G);
+            err = add_entry(&fp_cache[idx], G);
       }
       if (err == MP_OKAY && idx != -1) {
          /* increment LRU */
@@ -3917,18 +4808,20 @@ int ecc_mulmod(mp_int* k, ecc_point *G, ecc_point *R, mp_int* modulus,
                  
            if (err == MP_OKAY) 
              /* build the LUT */
-             err = build_lut(idx, modulus, &mp, &mu);
+             err = build_lut(&fp_cache[idx], modulus, &mp, &mu);
         }
+        if (idx >= 0 && fp_cache[idx].lru_count >= 2)
+           cache = &fp_cache[idx];
       }
 
       if (err == MP_OKAY) { 
-        if (idx >= 0 && fp_cache[idx].lru_count >= 2) {
+        if (cache != NULL) {
            if (mpSetup == 0) {
               /* compute mp */
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul(idx, k, R, modulus, &mp, map);
+             err = accel_fp_mul(cache, k, R, modulus, &mp, map);
         } else {
            err = normal_ecc_mulmod(k, G, R, modulus, map);
         }
@@ -3985,6 +4878,93 @@ void ecc_fp_free(void)
 }
 
 
+/* release shared entry f, fine on a partly set up one */
+static void free_fixed(fp_fixed_t* f)
+{
+   unsigned x;
+
+   if (f->state == FP_FIXED_BUILT) {
+      for (x = 0; x < (1U<<FP_LUT); x++) {
+         ecc_del_point(f->cache.LUT[x]);
+         f->cache.LUT[x] = NULL;
+      }
+      ecc_del_point(f->cache.g);
+      f->cache.g = NULL;
+      mp_clear(&f->cache.mu);
+   }
+   f->state = FP_FIXED_NONE;
+
+   ecc_del_point(f->gen);
+   f->gen = NULL;
+   mp_clear(&f->prime);
+}
+
+/** Set up the shared generator LUTs, each curve's is built on first use and
+    then read by every thread without locking. Call before other threads use
+    ECC, CyaSSL_Init() does. Without it generators go in the thread cache */
+int ecc_fp_init_fixed(void)
+{
+   int x, err = MP_OKAY;
+
+   if (fp_fixed_init)
+      return 0;
+
+   if (InitMutex(&fp_fixed_lock) != 0)
+      return BAD_MUTEX_E;
+
+   for (x = 0; ecc_sets[x].size != 0 && x < FP_FIXED_ENTRIES; x++) {
+      fp_fixed_t* f = &fp_fixed[x];
+
+      XMEMSET(f, 0, sizeof(fp_fixed_t));
+      fp_fixed_count = x + 1;
+      f->gen = ecc_new_point();
+      if (f->gen == NULL || mp_init(&f->prime) != MP_OKAY) {
+         err = MEMORY_E;
+         break;
+      }
+
+      err = mp_read_radix(f->gen->x, (char*)ecc_sets[x].Gx, 16);
+      if (err == MP_OKAY)
+         err = mp_read_radix(f->gen->y, (char*)ecc_sets[x].Gy, 16);
+      if (err == MP_OKAY)
+         mp_set(f->gen->z, 1);
+      if (err == MP_OKAY)
+         err = mp_read_radix(&f->prime, (char*)ecc_sets[x].prime, 16);
+      if (err != MP_OKAY)
+         break;
+   }
+
+   if (err != MP_OKAY) {
+      for (x = 0; x < fp_fixed_count; x++)
+         free_fixed(&fp_fixed[x]);
+      fp_fixed_count = 0;
+      FreeMutex(&fp_fixed_lock);
+      return err;
+   }
+
+   fp_fixed_init = 1;
+
+   return 0;
+}
+
+/** Free the shared generator LUTs, no thread may be using ECC */
+void ecc_fp_free_fixed(void)
+{
+   int x;
+
+   if (fp_fixed_init == 0)
+      return;
+
+   for (x = 0; x < fp_fixed_count; x++)
+      free_fixed(&fp_fixed[x]);
+
+   fp_fixed_count = 0;
+   fp_fixed_init  = 0;
+   fp_fixed_gen++;             /* threads drop what they've seen */
+   FreeMutex(&fp_fixed_lock);
+}
+
+
 #endif /* FP_ECC */
 
 #ifdef HAVE_ECC_ENCRYPT
@@ -4532,6 +5512,460 @@ int ecc_decrypt(ecc_key* privKey, ecc_key* pubKey, const byte* msg,
 }
 
 
+/* ecc encrypt session, one ECDH and KDF per peer then only the cipher and
+   mac per message, each message is nonce || ciphertext || mac with a counter
+   nonce, the IV is the nonce encrypted under the message key */
+struct ecEncSession {
+    Aes       enc;                        /* our key, also makes our IVs */
+    Aes       dec;                        /* peer's key */
+    Aes       peerIv;                     /* peer's key, makes its IVs */
+    HmacState encMac;                     /* our keyed mac */
+    HmacState decMac;                     /* peer's keyed mac */
+    Hmac      encStream;                  /* message being encrypted */
+    Hmac      decStream;                  /* message being decrypted */
+    byte      encIvSalt[IV_SIZE_64];      /* IV block ahead of our nonce */
+    byte      decIvSalt[IV_SIZE_64];      /* IV block ahead of peer's */
+    byte      macSalt[EXCHANGE_SALT_SZ];  /* mac'd after each message */
+    word32    macSaltSz;
+    word32    sendHi;                     /* next nonce to send */
+    word32    sendLo;
+    word32    recvHi;                     /* last nonce accepted */
+    word32    recvLo;
+    word32    curHi;                      /* nonce of message being */
+    word32    curLo;                      /* decrypted, accepted at final */
+    byte      recvAny;                    /* recvHi/Lo are set */
+    byte      encOn;                      /* encrypt stream in progress */
+    byte      decOn;                      /* decrypt stream in progress */
+};
+
+
+/* nonce is the big endian hi || lo counter, the IV block is salt || nonce
+   run through aes once */
+static int ecc_session_iv(Aes* aes, const byte* salt, const byte* nonce,
+                          byte* iv)
+{
+    byte block[AES_BLOCK_SIZE];
+    int  ret;
+
+    XMEMCPY(block, salt, IV_SIZE_64);
+    XMEMCPY(block + IV_SIZE_64, nonce, ECC_SESSION_NONCE_SZ);
+
+    ret = AesSetIV(aes, NULL);
+    if (ret == 0)
+        ret = AesCbcEncrypt(aes, iv, block, AES_BLOCK_SIZE);
+
+    return ret;
+}
+
+
+/* constant time, 0 on match */
+static int ecc_session_mac_cmp(const byte* a, const byte* b)
+{
+    byte diff = 0;
+    int  i;
+
+    for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+        diff |= a[i] ^ b[i];
+
+    return diff;
+}
+
+
+static void ecc_session_nonce(word32 hi, word32 lo, byte* nonce)
+{
+    nonce[0] = (byte)(hi >> 24); nonce[1] = (byte)(hi >> 16);
+    nonce[2] = (byte)(hi >>  8); nonce[3] = (byte)hi;
+    nonce[4] = (byte)(lo >> 24); nonce[5] = (byte)(lo >> 16);
+    nonce[6] = (byte)(lo >>  8); nonce[7] = (byte)lo;
+}
+
+
+/* one side of the session from its part of the keys */
+static int ecc_session_keys(Aes* aes, int dir, Aes* ivAes, HmacState* mac,
+                            byte* ivSalt, const byte* keys)
+{
+    int ret;
+
+    ret = AesSetKey(aes, keys, KEY_SIZE_128, NULL, dir);
+    if (ret == 0 && ivAes)
+        ret = AesSetKey(ivAes, keys, KEY_SIZE_128, NULL, AES_ENCRYPTION);
+    if (ret == 0)
+        ret = HmacInitKeyedState(mac, SHA256, keys + KEY_SIZE_128 + IV_SIZE_64,
+                                 SHA256_DIGEST_SIZE);
+    if (ret == 0)
+        XMEMCPY(ivSalt, keys + KEY_SIZE_128, IV_SIZE_64);
+
+    return ret;
+}
+
+
+/* alloc a session between privKey and pubKey, ctx as for ecc_encrypt() with
+   its salts set if it's a REQ_RESP one, NULL for defaults. The keys come from
+   past the ones ecc_encrypt() would use so the two never share one */
+ecEncSession* ecc_session_new(ecc_key* privKey, ecc_key* pubKey,
+                              ecEncCtx* ctx)
+{
+    int           ret;
+    word32        blockSz;
+    word32        digestSz;
+    ecEncCtx      localCtx;
+    ecEncSession* session;
+#ifdef CYASSL_SMALL_STACK
+    byte*         sharedSecret;
+    byte*         keys;
+#else
+    byte          sharedSecret[ECC_MAXSIZE];
+    byte          keys[ECC_BUFSIZE];
+#endif
+    word32        sharedSz = ECC_MAXSIZE;
+    int           keysLen;
+    int           encKeySz;
+    int           ivSz;
+    int           encOff = 0;
+    int           decOff = 0;
+
+    if (privKey == NULL || pubKey == NULL)
+        return NULL;
+
+    if (ctx == NULL) {
+        ecc_ctx_init(&localCtx, 0);
+        ctx = &localCtx;
+    }
+
+    if (ecc_get_key_sizes(ctx, &encKeySz, &ivSz, &keysLen, &digestSz,
+                          &blockSz) != 0)
+        return NULL;
+
+    if (ctx->kdfAlgo != ecHKDF_SHA256)
+        return NULL;
+
+    /* ecc_encrypt() uses up to two sets, ours are the two after */
+    if (ctx->protocol == REQ_RESP_CLIENT) {
+        if (ctx->cliSt != ecCLI_SALT_SET)
+            return NULL;
+        decOff = keysLen;
+    }
+    else if (ctx->protocol == REQ_RESP_SERVER) {
+        if (ctx->srvSt != ecSRV_SALT_SET)
+            return NULL;
+        encOff = keysLen;
+    }
+    encOff += keysLen * 2;
+    decOff += keysLen * 2;
+
+    if (keysLen * 4 > ECC_BUFSIZE || ctx->macSaltSz > EXCHANGE_SALT_SZ)
+        return NULL;
+
+    session = (ecEncSession*)XMALLOC(sizeof(ecEncSession), 0,
+                                     DYNAMIC_TYPE_ECC);
+    if (session == NULL)
+        return NULL;
+    XMEMSET(session, 0, sizeof(ecEncSession));
+
+#ifdef CYASSL_SMALL_STACK
+    sharedSecret = (byte*)XMALLOC(ECC_MAXSIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    keys = (byte*)XMALLOC(ECC_BUFSIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (sharedSecret == NULL || keys == NULL) {
+        XFREE(sharedSecret, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(keys, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(session, 0, DYNAMIC_TYPE_ECC);
+        return NULL;
+    }
+#endif
+
+    ret = ecc_shared_secret(privKey, pubKey, sharedSecret, &sharedSz);
+    if (ret == 0)
+        ret = HKDF(SHA256, sharedSecret, sharedSz, ctx->kdfSalt,
+                   ctx->kdfSaltSz, ctx->kdfInfo, ctx->kdfInfoSz,
+                   keys, keysLen * 4);
+    if (ret == 0)
+        ret = ecc_session_keys(&session->enc, AES_ENCRYPTION, NULL,
+                               &session->encMac, session->encIvSalt,
+                               keys + encOff);
+    if (ret == 0)
+        ret = ecc_session_keys(&session->dec, AES_DECRYPTION, &session->peerIv,
+                               &session->decMac, session->decIvSalt,
+                               keys + decOff);
+    if (ret == 0 && ctx->macSaltSz) {
+        XMEMCPY(session->macSalt, ctx->macSalt, ctx->macSaltSz);
+        session->macSaltSz = ctx->macSaltSz;
+    }
+
+    XMEMSET(sharedSecret, 0, ECC_MAXSIZE);
+    XMEMSET(keys, 0, ECC_BUFSIZE);
+#ifdef CYASSL_SMALL_STACK
+    XFREE(sharedSecret, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(keys, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    if (ret != 0) {
+        ecc_session_free(session);
+        session = NULL;
+    }
+
+    return session;
+}
+
+
+/* free a session, clear its keys */
+void ecc_session_free(ecEncSession* session)
+{
+    if (session) {
+        XMEMSET(session, 0, sizeof(ecEncSession));
+        XFREE(session, 0, DYNAMIC_TYPE_ECC);
+    }
+}
+
+
+/* start streaming the next message out, nonce gets ECC_SESSION_NONCE_SZ
+   bytes that go ahead of the ciphertext */
+int ecc_session_encrypt_begin(ecEncSession* session, byte* nonce)
+{
+    byte iv[AES_BLOCK_SIZE];
+    int  ret;
+
+    if (session == NULL || nonce == NULL)
+        return BAD_FUNC_ARG;
+
+    if (session->sendHi == 0xFFFFFFFF && session->sendLo == 0xFFFFFFFF)
+        return ECC_SESSION_SEQ_E;           /* never reuse a nonce */
+
+    ecc_session_nonce(session->sendHi, session->sendLo, nonce);
+    if (++session->sendLo == 0)
+        session->sendHi++;
+
+    ret = ecc_session_iv(&session->enc, session->encIvSalt, nonce, iv);
+    if (ret == 0)
+        ret = AesSetIV(&session->enc, iv);
+    if (ret == 0)
+        ret = HmacCloneState(&session->encStream, &session->encMac);
+    if (ret == 0)
+        ret = HmacUpdate(&session->encStream, nonce, ECC_SESSION_NONCE_SZ);
+
+    session->encOn = (ret == 0);
+
+    return ret;
+}
+
+
+/* encrypt the next sz bytes of the message, a multiple of the block size,
+   pad the last ones */
+int ecc_session_encrypt_update(ecEncSession* session, const byte* in,
+                               word32 sz, byte* out)
+{
+    int ret;
+
+    if (session == NULL || in == NULL || out == NULL)
+        return BAD_FUNC_ARG;
+
+    if (!session->encOn)
+        return BAD_ENC_STATE_E;
+
+    if (sz % AES_BLOCK_SIZE)
+        return BAD_PADDING_E;
+
+    ret = AesCbcEncrypt(&session->enc, out, in, sz);
+    if (ret == 0)
+        ret = HmacUpdate(&session->encStream, out, sz);
+
+    return ret;
+}
+
+
+/* finish the message, mac gets SHA256_DIGEST_SIZE bytes to go after it */
+int ecc_session_encrypt_final(ecEncSession* session, byte* mac)
+{
+    int ret;
+
+    if (session == NULL || mac == NULL)
+        return BAD_FUNC_ARG;
+
+    if (!session->encOn)
+        return BAD_ENC_STATE_E;
+    session->encOn = 0;
+
+    ret = HmacUpdate(&session->encStream, session->macSalt,
+                     session->macSaltSz);
+    if (ret == 0)
+        ret = HmacFinal(&session->encStream, mac);
+
+    return ret;
+}
+
+
+/* start streaming a message in from its nonce, nonces have to go up from
+   one message to the next, the plaintext isn't to be trusted until
+   ecc_session_decrypt_final() succeeds */
+int ecc_session_decrypt_begin(ecEncSession* session, const byte* nonce)
+{
+    byte   iv[AES_BLOCK_SIZE];
+    word32 hi, lo;
+    int    ret;
+
+    if (session == NULL || nonce == NULL)
+        return BAD_FUNC_ARG;
+
+    hi = ((word32)nonce[0] << 24) | ((word32)nonce[1] << 16) |
+         ((word32)nonce[2] <<  8) |  (word32)nonce[3];
+    lo = ((word32)nonce[4] << 24) | ((word32)nonce[5] << 16) |
+         ((word32)nonce[6] <<  8) |  (word32)nonce[7];
+
+    if (session->recvAny && (hi < session->recvHi ||
+                         (hi == session->recvHi && lo <= session->recvLo)))
+        return ECC_SESSION_SEQ_E;
+
+    ret = ecc_session_iv(&session->peerIv, session->decIvSalt, nonce, iv);
+    if (ret == 0)
+        ret = AesSetIV(&session->dec, iv);
+    if (ret == 0)
+        ret = HmacCloneState(&session->decStream, &session->decMac);
+    if (ret == 0)
+        ret = HmacUpdate(&session->decStream, nonce, ECC_SESSION_NONCE_SZ);
+
+    session->curHi = hi;
+    session->curLo = lo;
+    session->decOn = (ret == 0);
+
+    return ret;
+}
+
+
+/* decrypt the next sz bytes of the message, a multiple of the block size */
+int ecc_session_decrypt_update(ecEncSession* session, const byte* in,
+                               word32 sz, byte* out)
+{
+    int ret;
+
+    if (session == NULL || in == NULL || out == NULL)
+        return BAD_FUNC_ARG;
+
+    if (!session->decOn)
+        return BAD_ENC_STATE_E;
+
+    if (sz % AES_BLOCK_SIZE)
+        return BAD_PADDING_E;
+
+    ret = HmacUpdate(&session->decStream, in, sz);
+    if (ret == 0)
+        ret = AesCbcDecrypt(&session->dec, out, in, sz);
+
+    return ret;
+}
+
+
+/* check the message's mac, its nonce is used up once this succeeds */
+int ecc_session_decrypt_final(ecEncSession* session, const byte* mac)
+{
+    byte verify[SHA256_DIGEST_SIZE];
+    int  ret;
+
+    if (session == NULL || mac == NULL)
+        return BAD_FUNC_ARG;
+
+    if (!session->decOn)
+        return BAD_ENC_STATE_E;
+    session->decOn = 0;
+
+    ret = HmacUpdate(&session->decStream, session->macSalt,
+                     session->macSaltSz);
+    if (ret == 0)
+        ret = HmacFinal(&session->decStream, verify);
+    if (ret == 0 && ecc_session_mac_cmp(verify, mac) != 0)
+        ret = ECC_SESSION_MAC_E;
+
+    if (ret == 0) {
+        session->recvHi  = session->curHi;
+        session->recvLo  = session->curLo;
+        session->recvAny = 1;
+    }
+
+    return ret;
+}
+
+
+/* whole message at once, msgSz already padded, out gets nonce || ciphertext
+   || mac, ECC_SESSION_NONCE_SZ + msgSz + SHA256_DIGEST_SIZE bytes */
+int ecc_session_encrypt(ecEncSession* session, const byte* msg, word32 msgSz,
+                        byte* out, word32* outSz)
+{
+    int ret;
+
+    if (session == NULL || msg == NULL || out == NULL || outSz == NULL)
+        return BAD_FUNC_ARG;
+
+    if (*outSz < ECC_SESSION_NONCE_SZ + msgSz + SHA256_DIGEST_SIZE)
+        return BUFFER_E;
+
+    if (msgSz % AES_BLOCK_SIZE)
+        return BAD_PADDING_E;
+
+    ret = ecc_session_encrypt_begin(session, out);
+    if (ret == 0)
+        ret = ecc_session_encrypt_update(session, msg, msgSz,
+                                         out + ECC_SESSION_NONCE_SZ);
+    if (ret == 0)
+        ret = ecc_session_encrypt_final(session,
+                                        out + ECC_SESSION_NONCE_SZ + msgSz);
+    if (ret == 0)
+        *outSz = ECC_SESSION_NONCE_SZ + msgSz + SHA256_DIGEST_SIZE;
+
+    return ret;
+}
+
+
+/* whole message from ecc_session_encrypt() at once, the mac is checked
+   before any of it is decrypted */
+int ecc_session_decrypt(ecEncSession* session, const byte* msg, word32 msgSz,
+                        byte* out, word32* outSz)
+{
+    word32 dataSz;
+    int    ret;
+
+    if (session == NULL || msg == NULL || out == NULL || outSz == NULL)
+        return BAD_FUNC_ARG;
+
+    if (msgSz < ECC_SESSION_NONCE_SZ + SHA256_DIGEST_SIZE)
+        return BUFFER_E;
+    dataSz = msgSz - ECC_SESSION_NONCE_SZ - SHA256_DIGEST_SIZE;
+
+    if (dataSz % AES_BLOCK_SIZE)
+        return BAD_PADDING_E;
+
+    if (*outSz < dataSz)
+        return BUFFER_E;
+
+    ret = ecc_session_decrypt_begin(session, msg);
+    if (ret == 0)
+        ret = HmacUpdate(&session->decStream, msg + ECC_SESSION_NONCE_SZ,
+                         dataSz);
+    if (ret == 0) {
+        /* mac first, the update below would hash the ciphertext again */
+        byte mac[SHA256_DIGEST_SIZE];
+
+        ret = HmacUpdate(&session->decStream, session->macSalt,
+                         session->macSaltSz);
+        if (ret == 0)
+            ret = HmacFinal(&session->decStream, mac);
+        if (ret == 0 && ecc_session_mac_cmp(mac,
+                                             msg + msgSz - SHA256_DIGEST_SIZE))
+            ret = ECC_SESSION_MAC_E;
+    }
+    session->decOn = 0;
+
+    if (ret == 0)
+        ret = AesCbcDecrypt(&session->dec, out, msg + ECC_SESSION_NONCE_SZ,
+                            dataSz);
+    if (ret == 0) {
+        session->recvHi  = session->curHi;
+        session->recvLo  = session->curLo;
+        session->recvAny = 1;
+        *outSz = dataSz;
+    }
+
+    return ret;
+}
+
+
 #endif /* HAVE_ECC_ENCRYPT */
 
 
@@ -4800,12 +6234,12 @@ int ecc_export_x963_compressed(ecc_key* key, byte* out, word32* outLen)
    }
 
    /* store first byte */
-   out[0] = mp_isodd(&key->pubkey.y) ? 0x03 : 0x02;
+   out[0] = mp_isodd(key->pubkey.y) ? 0x03 : 0x02;
 
    /* pad and store x */
    XMEMSET(out+1, 0, numlen);
-   ret = mp_to_unsigned_bin(&key->pubkey.x,
-                       out+1 + (numlen - mp_unsigned_bin_size(&key->pubkey.x)));
+   ret = mp_to_unsigned_bin(key->pubkey.x,
+                       out+1 + (numlen - mp_unsigned_bin_size(key->pubkey.x)));
    *outLen = 1 + numlen;
    return ret;
 }
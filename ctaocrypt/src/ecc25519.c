@@ -31,6 +31,7 @@
 #ifdef HAVE_ECC25519
 
 #include <cyassl/ctaocrypt/ecc25519.h>
+#include <cyassl/ctaocrypt/ecc25519_ge.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 
 const ecc25519_set_type ecc25519_sets[] = {
@@ -42,8 +43,29 @@ const ecc25519_set_type ecc25519_sets[] = {
 
 
 
+/* q = n * 9 through the fixed base comb on the birationally equivalent
+   Edwards curve, then u = (1 + y) / (1 - y). Half the time of a ladder. */
+static int curve25519_base(unsigned char* q, unsigned char* e)
+{
+  ge_p3 A;
+  fe    num;
+  fe    den;
+
+  ge_scalarmult_base(&A, e);
+
+  fe_add(num, A.Z, A.Y);
+  fe_sub(den, A.Z, A.Y);
+  fe_invert(den, den);
+  fe_mul(num, num, den);
+  fe_tobytes(q, num);
+
+  return 0;
+}
+
+
 static int curve25519(unsigned char* q, unsigned char* n, unsigned char* p)
 {
+  static const unsigned char basepoint[32] = {9};
   unsigned char e[32];
   unsigned int i;
   fe x1;
@@ -62,6 +84,12 @@ static int curve25519(unsigned char* q, unsigned char* n, unsigned char* p)
   e[31] &= 127;
   e[31] |= 64;
 
+  if (XMEMCMP(p, basepoint, sizeof(basepoint)) == 0) {
+    int ret = curve25519_base(q, e);
+    XMEMSET(e, 0, sizeof(e));
+    return ret;
+  }
+
   fe_frombytes(x1,p);
   fe_1(x2);
   fe_0(z2);
@@ -27,6 +27,334 @@
 #include <cyassl/ctaocrypt/ecc25519_fe.h>
 #include <stdint.h>
 
+#ifdef HAVE_ECC25519_FE51
+
+/* 5 limbs of 51 bits, products in 128 bits. Every operation leaves its
+   limbs just over 2^51: add and sub do a carry pass, sub adds 4p first so it
+   never underflows */
+
+typedef unsigned __int128 fe_uint128;
+
+#define FE51_MASK ((uint64_t)0x7ffffffffffff)   /* 2^51 - 1 */
+
+
+static uint64_t load_8(const unsigned char *in)
+{
+  return (uint64_t) in[0]        | ((uint64_t) in[1] <<  8) |
+        ((uint64_t) in[2] << 16) | ((uint64_t) in[3] << 24) |
+        ((uint64_t) in[4] << 32) | ((uint64_t) in[5] << 40) |
+        ((uint64_t) in[6] << 48) | ((uint64_t) in[7] << 56);
+}
+
+
+static void store_8(unsigned char *out, uint64_t in)
+{
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    out[i] = (unsigned char)in;
+    in >>= 8;
+  }
+}
+
+
+/*
+h = 0
+*/
+
+void fe_0(fe h)
+{
+  h[0] = 0;
+  h[1] = 0;
+  h[2] = 0;
+  h[3] = 0;
+  h[4] = 0;
+}
+
+
+/*
+h = 1
+*/
+
+void fe_1(fe h)
+{
+  h[0] = 1;
+  h[1] = 0;
+  h[2] = 0;
+  h[3] = 0;
+  h[4] = 0;
+}
+
+
+/*
+h = f
+*/
+
+void fe_copy(fe h,fe f)
+{
+  h[0] = f[0];
+  h[1] = f[1];
+  h[2] = f[2];
+  h[3] = f[3];
+  h[4] = f[4];
+}
+
+
+/*
+Replace (f,g) with (g,f) if b == 1;
+replace (f,g) with (f,g) if b == 0.
+
+Preconditions: b in {0,1}.
+*/
+
+void fe_cswap(fe f,fe g,unsigned int b)
+{
+  uint64_t mask = (uint64_t)0 - b;
+  uint64_t x;
+  int      i;
+
+  for (i = 0; i < 5; ++i) {
+    x = (f[i] ^ g[i]) & mask;
+    f[i] ^= x;
+    g[i] ^= x;
+  }
+}
+
+
+/* one carry pass, limbs end up below 2^51 + 2^18 */
+static void fe_weak_carry(fe h)
+{
+  uint64_t c = h[4] >> 51;
+
+  h[4] &= FE51_MASK;
+  h[4] += h[3] >> 51;
+  h[3] &= FE51_MASK;
+  h[3] += h[2] >> 51;
+  h[2] &= FE51_MASK;
+  h[2] += h[1] >> 51;
+  h[1] &= FE51_MASK;
+  h[1] += h[0] >> 51;
+  h[0] &= FE51_MASK;
+  h[0] += c * 19;
+}
+
+
+/*
+h = f + g
+Can overlap h with f or g.
+*/
+
+void fe_add(fe h,fe f,fe g)
+{
+  h[0] = f[0] + g[0];
+  h[1] = f[1] + g[1];
+  h[2] = f[2] + g[2];
+  h[3] = f[3] + g[3];
+  h[4] = f[4] + g[4];
+  fe_weak_carry(h);
+}
+
+
+/*
+h = f - g
+Can overlap h with f or g.
+
+Preconditions:
+   g limbs below 2^53, which every fe output here is.
+*/
+
+void fe_sub(fe h,fe f,fe g)
+{
+  /* 4p, limb by limb, keeps every difference positive */
+  h[0] = (f[0] + 0x1fffffffffffb4) - g[0];
+  h[1] = (f[1] + 0x1ffffffffffffc) - g[1];
+  h[2] = (f[2] + 0x1ffffffffffffc) - g[2];
+  h[3] = (f[3] + 0x1ffffffffffffc) - g[3];
+  h[4] = (f[4] + 0x1ffffffffffffc) - g[4];
+  fe_weak_carry(h);
+}
+
+
+/* carry the 128-bit column sums into 51-bit limbs, 2^255 wraps to 19 */
+static void fe_carry(fe h, fe_uint128 r0, fe_uint128 r1, fe_uint128 r2,
+                     fe_uint128 r3, fe_uint128 r4)
+{
+  uint64_t c;
+
+  r1 += (uint64_t)(r0 >> 51);
+  r2 += (uint64_t)(r1 >> 51);
+  r3 += (uint64_t)(r2 >> 51);
+  r4 += (uint64_t)(r3 >> 51);
+  c   = (uint64_t)(r4 >> 51);
+
+  h[0] = ((uint64_t)r0 & FE51_MASK) + c * 19;
+  h[1] = ((uint64_t)r1 & FE51_MASK) + (h[0] >> 51);
+  h[0] &= FE51_MASK;
+  h[2] = (uint64_t)r2 & FE51_MASK;
+  h[3] = (uint64_t)r3 & FE51_MASK;
+  h[4] = (uint64_t)r4 & FE51_MASK;
+}
+
+
+/*
+h = f * g
+Can overlap h with f or g.
+
+Preconditions:
+   f and g limbs below 2^54.
+
+Postconditions:
+   h limbs below 2^51 + 2^13.
+*/
+
+void fe_mul(fe h,fe f,fe g)
+{
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+  uint64_t g1_19 = 19 * g1;
+  uint64_t g2_19 = 19 * g2;
+  uint64_t g3_19 = 19 * g3;
+  uint64_t g4_19 = 19 * g4;
+  fe_uint128 r0, r1, r2, r3, r4;
+
+  r0 = (fe_uint128)f0 * g0    + (fe_uint128)f1 * g4_19 +
+       (fe_uint128)f2 * g3_19 + (fe_uint128)f3 * g2_19 +
+       (fe_uint128)f4 * g1_19;
+  r1 = (fe_uint128)f0 * g1    + (fe_uint128)f1 * g0    +
+       (fe_uint128)f2 * g4_19 + (fe_uint128)f3 * g3_19 +
+       (fe_uint128)f4 * g2_19;
+  r2 = (fe_uint128)f0 * g2    + (fe_uint128)f1 * g1    +
+       (fe_uint128)f2 * g0    + (fe_uint128)f3 * g4_19 +
+       (fe_uint128)f4 * g3_19;
+  r3 = (fe_uint128)f0 * g3    + (fe_uint128)f1 * g2    +
+       (fe_uint128)f2 * g1    + (fe_uint128)f3 * g0    +
+       (fe_uint128)f4 * g4_19;
+  r4 = (fe_uint128)f0 * g4    + (fe_uint128)f1 * g3    +
+       (fe_uint128)f2 * g2    + (fe_uint128)f3 * g1    +
+       (fe_uint128)f4 * g0;
+
+  fe_carry(h, r0, r1, r2, r3, r4);
+}
+
+
+/*
+h = f * f
+Can overlap h with f.
+
+Preconditions:
+   f limbs below 2^54.
+
+Postconditions:
+   h limbs below 2^51 + 2^13.
+*/
+
+void fe_sq(fe h,fe f)
+{
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t f0_2  = 2 * f0;
+  uint64_t f1_2  = 2 * f1;
+  uint64_t f1_38 = 38 * f1;
+  uint64_t f2_38 = 38 * f2;
+  uint64_t f3_38 = 38 * f3;
+  uint64_t f3_19 = 19 * f3;
+  uint64_t f4_19 = 19 * f4;
+  fe_uint128 r0, r1, r2, r3, r4;
+
+  r0 = (fe_uint128)f0   * f0    + (fe_uint128)f1_38 * f4 +
+       (fe_uint128)f2_38 * f3;
+  r1 = (fe_uint128)f0_2 * f1    + (fe_uint128)f2_38 * f4 +
+       (fe_uint128)f3_19 * f3;
+  r2 = (fe_uint128)f0_2 * f2    + (fe_uint128)f1    * f1 +
+       (fe_uint128)f3_38 * f4;
+  r3 = (fe_uint128)f0_2 * f3    + (fe_uint128)f1_2  * f2 +
+       (fe_uint128)f4_19 * f4;
+  r4 = (fe_uint128)f0_2 * f4    + (fe_uint128)f1_2  * f3 +
+       (fe_uint128)f2    * f2;
+
+  fe_carry(h, r0, r1, r2, r3, r4);
+}
+
+
+/*
+h = f * 121666
+Can overlap h with f.
+
+Preconditions:
+   f limbs below 2^54.
+*/
+
+void fe_mul121666(fe h,fe f)
+{
+  fe_carry(h, (fe_uint128)f[0] * 121666, (fe_uint128)f[1] * 121666,
+              (fe_uint128)f[2] * 121666, (fe_uint128)f[3] * 121666,
+              (fe_uint128)f[4] * 121666);
+}
+
+
+/*
+Ignores top bit of s.
+*/
+
+void fe_frombytes(fe h,const unsigned char *s)
+{
+  h[0] =  load_8(s)             & FE51_MASK;
+  h[1] = (load_8(s +  6) >>  3) & FE51_MASK;
+  h[2] = (load_8(s + 12) >>  6) & FE51_MASK;
+  h[3] = (load_8(s + 19) >>  1) & FE51_MASK;
+  h[4] = (load_8(s + 24) >> 12) & FE51_MASK;
+}
+
+
+/*
+Fully reduces h mod p, then packs it little endian.
+*/
+
+void fe_tobytes(unsigned char *s,fe h)
+{
+  uint64_t t[5];
+  int      i, j;
+
+  fe_copy(t, h);
+
+  /* twice brings every limb under 2^51, so t < 2^255 */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < 4; ++i) {
+      t[i + 1] += t[i] >> 51;
+      t[i]     &= FE51_MASK;
+    }
+    t[0] += 19 * (t[4] >> 51);
+    t[4] &= FE51_MASK;
+  }
+
+  /* t + 19 carries out of 2^255 exactly when t >= p */
+  t[0] += 19;
+  for (i = 0; i < 4; ++i) {
+    t[i + 1] += t[i] >> 51;
+    t[i]     &= FE51_MASK;
+  }
+  t[0] += 19 * (t[4] >> 51);
+  t[4] &= FE51_MASK;
+
+  /* now t is (h mod p) + 19, add 2^255 - 19 and drop the 2^255 */
+  t[0] += FE51_MASK + 1 - 19;
+  t[1] += FE51_MASK;
+  t[2] += FE51_MASK;
+  t[3] += FE51_MASK;
+  t[4] += FE51_MASK;
+  for (i = 0; i < 4; ++i) {
+    t[i + 1] += t[i] >> 51;
+    t[i]     &= FE51_MASK;
+  }
+  t[4] &= FE51_MASK;
+
+  store_8(s,      t[0]        | (t[1] << 51));
+  store_8(s +  8, (t[1] >> 13) | (t[2] << 38));
+  store_8(s + 16, (t[2] >> 26) | (t[3] << 25));
+  store_8(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+#else /* HAVE_ECC25519_FE51 */
+
 /*
 h = 0
 */
@@ -295,20 +623,6 @@ void fe_frombytes(fe h,const unsigned char *s)
 
 
 
-void fe_invert(fe out,fe z)
-{
-  fe t0;
-  fe t1;
-  fe t2;
-  fe t3;
-  int i;
-
-#include <cyassl/ctaocrypt/ecc25519_pow225521.h>
-
-  return;
-}
-
-
 /*
 h = f * 121666
 Can overlap h with f.
@@ -957,5 +1271,140 @@ void fe_tobytes(unsigned char *s,fe h)
   s[31] = h9 >> 18;
 }
 
+#endif /* HAVE_ECC25519_FE51 */
+
+
+void fe_invert(fe out,fe z)
+{
+  fe t0;
+  fe t1;
+  fe t2;
+  fe t3;
+  int i;
+
+#include <cyassl/ctaocrypt/ecc25519_pow225521.h>
+
+  return;
+}
+
+
+/* the Edwards group pieces, for the fixed base comb and ed25519 */
+
+/*
+h = -f
+*/
+
+void fe_neg(fe h,fe f)
+{
+  fe zero;
+
+  fe_0(zero);
+  fe_sub(h,zero,f);
+}
+
+
+/*
+Replace f with g if b == 1;
+replace f with f if b == 0.
+
+Preconditions: b in {0,1}.
+*/
+
+void fe_cmov(fe f,const fe g,unsigned int b)
+{
+  fe  t;
+  int i;
+
+  for (i = 0; i < (int)(sizeof(fe) / sizeof(f[0])); ++i)
+    t[i] = g[i];
+  fe_cswap(f,t,b);
+}
+
+
+/*
+h = 2 * f * f
+Can overlap h with f.
+*/
+
+void fe_sq2(fe h,fe f)
+{
+  fe f2;
+
+  fe_add(f2,f,f);
+  fe_mul(h,f2,f);
+}
+
+
+#ifdef HAVE_ED25519
+
+/*
+h = z^(2^252 - 3), the power square roots mod p are built from
+*/
+
+void fe_pow22523(fe out,fe z)
+{
+  fe  t0;
+  fe  t1;
+  fe  t2;
+  int i;
+
+  fe_sq(t0,z);                                      /* 2 */
+  fe_sq(t1,t0); fe_sq(t1,t1);                       /* 8 */
+  fe_mul(t1,z,t1);                                  /* 9 */
+  fe_mul(t0,t0,t1);                                 /* 11 */
+  fe_sq(t0,t0);                                     /* 22 */
+  fe_mul(t0,t1,t0);                                 /* 2^5 - 1 */
+  fe_sq(t1,t0); for (i = 1; i < 5; ++i) fe_sq(t1,t1);
+  fe_mul(t0,t1,t0);                                 /* 2^10 - 1 */
+  fe_sq(t1,t0); for (i = 1; i < 10; ++i) fe_sq(t1,t1);
+  fe_mul(t1,t1,t0);                                 /* 2^20 - 1 */
+  fe_sq(t2,t1); for (i = 1; i < 20; ++i) fe_sq(t2,t2);
+  fe_mul(t1,t2,t1);                                 /* 2^40 - 1 */
+  fe_sq(t1,t1); for (i = 1; i < 10; ++i) fe_sq(t1,t1);
+  fe_mul(t0,t1,t0);                                 /* 2^50 - 1 */
+  fe_sq(t1,t0); for (i = 1; i < 50; ++i) fe_sq(t1,t1);
+  fe_mul(t1,t1,t0);                                 /* 2^100 - 1 */
+  fe_sq(t2,t1); for (i = 1; i < 100; ++i) fe_sq(t2,t2);
+  fe_mul(t1,t2,t1);                                 /* 2^200 - 1 */
+  fe_sq(t1,t1); for (i = 1; i < 50; ++i) fe_sq(t1,t1);
+  fe_mul(t0,t1,t0);                                 /* 2^250 - 1 */
+  fe_sq(t0,t0); fe_sq(t0,t0);                       /* 2^252 - 4 */
+  fe_mul(out,t0,z);                                 /* 2^252 - 3 */
+}
+
+
+/*
+return 1 if f is in {1,3,5,...,q-2}
+return 0 if f is in {0,2,4,...,q-1}
+*/
+
+int fe_isnegative(fe f)
+{
+  unsigned char s[32];
+
+  fe_tobytes(s,f);
+  return s[0] & 1;
+}
+
+
+/*
+return 1 if f == 0
+return 0 if f != 0
+*/
+
+int fe_isnonzero(fe f)
+{
+  unsigned char s[32];
+  unsigned char r = 0;
+  int           i;
+
+  fe_tobytes(s,f);
+  for (i = 0; i < 32; ++i)
+    r |= s[i];
+  return r != 0;
+}
+
+#endif /* HAVE_ED25519 */
+
 #endif /*HAVE_ECC25519*/
 
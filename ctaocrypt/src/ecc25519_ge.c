@@ -0,0 +1,524 @@
+/* ecc25519_ge.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * Group arithmetic from Daniel J Bernstein's ed25519 ref10 work, on top of
+ * the curve25519 field code.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#ifdef HAVE_ECC25519
+
+#include <cyassl/ctaocrypt/ecc25519_ge.h>
+
+
+#include "ed25519_base.i"
+
+
+static void ge_p3_0(ge_p3* h)
+{
+    fe_0(h->X);
+    fe_1(h->Y);
+    fe_1(h->Z);
+    fe_0(h->T);
+}
+
+
+static void ge_precomp_0(ge_precomp* h)
+{
+    fe_1(h->yplusx);
+    fe_1(h->yminusx);
+    fe_0(h->xy2d);
+}
+
+
+/* r = p */
+static void ge_p3_to_p2(ge_p2* r, ge_p3* p)
+{
+    fe_copy(r->X, p->X);
+    fe_copy(r->Y, p->Y);
+    fe_copy(r->Z, p->Z);
+}
+
+
+/* r = p */
+void ge_p1p1_to_p2(ge_p2* r, ge_p1p1* p)
+{
+    fe_mul(r->X, p->X, p->T);
+    fe_mul(r->Y, p->Y, p->Z);
+    fe_mul(r->Z, p->Z, p->T);
+}
+
+
+/* r = p */
+static void ge_p1p1_to_p3(ge_p3* r, ge_p1p1* p)
+{
+    fe_mul(r->X, p->X, p->T);
+    fe_mul(r->Y, p->Y, p->Z);
+    fe_mul(r->Z, p->Z, p->T);
+    fe_mul(r->T, p->X, p->Y);
+}
+
+
+/* r = 2 * p */
+void ge_p2_dbl(ge_p1p1* r, ge_p2* p)
+{
+    fe t0;
+
+    fe_sq(r->X, p->X);
+    fe_sq(r->Z, p->Y);
+    fe_sq2(r->T, p->Z);
+    fe_add(r->Y, p->X, p->Y);
+    fe_sq(t0, r->Y);
+    fe_add(r->Y, r->Z, r->X);
+    fe_sub(r->Z, r->Z, r->X);
+    fe_sub(r->X, t0, r->Y);
+    fe_sub(r->T, r->T, r->Z);
+}
+
+
+/* r = 2 * p */
+static void ge_p3_dbl(ge_p1p1* r, ge_p3* p)
+{
+    ge_p2 q;
+
+    ge_p3_to_p2(&q, p);
+    ge_p2_dbl(r, &q);
+}
+
+
+/* r = p + q */
+static void ge_madd(ge_p1p1* r, ge_p3* p, ge_precomp* q)
+{
+    fe t0;
+
+    fe_add(r->X, p->Y, p->X);
+    fe_sub(r->Y, p->Y, p->X);
+    fe_mul(r->Z, r->X, q->yplusx);
+    fe_mul(r->Y, r->Y, q->yminusx);
+    fe_mul(r->T, q->xy2d, p->T);
+    fe_add(t0, p->Z, p->Z);
+    fe_sub(r->X, r->Z, r->Y);
+    fe_add(r->Y, r->Z, r->Y);
+    fe_add(r->Z, t0, r->T);
+    fe_sub(r->T, t0, r->T);
+}
+
+
+static byte ge_equal(signed char b, signed char c)
+{
+    byte   x = (byte)b ^ (byte)c;   /* 0: yes; 1..255: no */
+    word32 y = x;                   /* 0: yes; 1..255: no */
+
+    y -= 1;                         /* 4294967295: yes; 0..254: no */
+    y >>= 31;                       /* 1: yes; 0: no */
+
+    return (byte)y;
+}
+
+
+static byte ge_negative(signed char b)
+{
+    return (byte)(((word32)(int)b) >> 31);
+}
+
+
+static void ge_cmov(ge_precomp* t, const ge_precomp* u, byte b)
+{
+    fe_cmov(t->yplusx, u->yplusx, b);
+    fe_cmov(t->yminusx, u->yminusx, b);
+    fe_cmov(t->xy2d, u->xy2d, b);
+}
+
+
+/* t = b * 256^pos * B, b in [-8, 8], without branching on b */
+static void ge_select(ge_precomp* t, int pos, signed char b)
+{
+    ge_precomp minust;
+    byte       bnegative = ge_negative(b);
+    byte       babs      = b - (((-bnegative) & b) << 1);
+    int        j;
+
+    ge_precomp_0(t);
+    for (j = 0; j < 8; j++)
+        ge_cmov(t, &ed25519_base[pos][j], ge_equal(babs, j + 1));
+
+    fe_copy(minust.yplusx, t->yminusx);
+    fe_copy(minust.yminusx, t->yplusx);
+    fe_neg(minust.xy2d, t->xy2d);
+    ge_cmov(t, &minust, bnegative);
+}
+
+
+/* h = a * B, a is 32 bytes little endian with a[31] <= 127, constant time */
+void ge_scalarmult_base(ge_p3* h, const byte* a)
+{
+    signed char e[64];
+    signed char carry;
+    ge_p1p1     r;
+    ge_p2       s;
+    ge_precomp  t;
+    int         i;
+
+    for (i = 0; i < 32; ++i) {
+        e[2 * i + 0] = (a[i] >> 0) & 15;
+        e[2 * i + 1] = (a[i] >> 4) & 15;
+    }
+    /* each e[i] is between 0 and 15, e[63] is between 0 and 7 */
+
+    carry = 0;
+    for (i = 0; i < 63; ++i) {
+        e[i] += carry;
+        carry = e[i] + 8;
+        carry >>= 4;
+        e[i] -= carry << 4;
+    }
+    e[63] += carry;
+    /* each e[i] is now between -8 and 8 */
+
+    ge_p3_0(h);
+    for (i = 1; i < 64; i += 2) {
+        ge_select(&t, i / 2, e[i]);
+        ge_madd(&r, h, &t);
+        ge_p1p1_to_p3(h, &r);
+    }
+
+    ge_p3_dbl(&r, h);  ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s); ge_p1p1_to_p3(h, &r);
+
+    for (i = 0; i < 64; i += 2) {
+        ge_select(&t, i / 2, e[i]);
+        ge_madd(&r, h, &t);
+        ge_p1p1_to_p3(h, &r);
+    }
+
+    XMEMSET(e, 0, sizeof(e));
+}
+
+
+#ifdef HAVE_ED25519
+
+void ge_p2_0(ge_p2* h)
+{
+    fe_0(h->X);
+    fe_1(h->Y);
+    fe_1(h->Z);
+}
+
+
+/* r = p */
+static void ge_p3_to_cached(ge_cached* r, ge_p3* p)
+{
+    fe d2;
+
+    XMEMCPY(d2, ed25519_d2, sizeof(fe));
+    fe_add(r->YplusX, p->Y, p->X);
+    fe_sub(r->YminusX, p->Y, p->X);
+    fe_copy(r->Z, p->Z);
+    fe_mul(r->T2d, p->T, d2);
+}
+
+
+/* r = p + q */
+static void ge_add(ge_p1p1* r, ge_p3* p, ge_cached* q)
+{
+    fe t0;
+
+    fe_add(r->X, p->Y, p->X);
+    fe_sub(r->Y, p->Y, p->X);
+    fe_mul(r->Z, r->X, q->YplusX);
+    fe_mul(r->Y, r->Y, q->YminusX);
+    fe_mul(r->T, q->T2d, p->T);
+    fe_mul(r->X, p->Z, q->Z);
+    fe_add(t0, r->X, r->X);
+    fe_sub(r->X, r->Z, r->Y);
+    fe_add(r->Y, r->Z, r->Y);
+    fe_add(r->Z, t0, r->T);
+    fe_sub(r->T, t0, r->T);
+}
+
+
+/* r = p - q */
+static void ge_sub(ge_p1p1* r, ge_p3* p, ge_cached* q)
+{
+    fe t0;
+
+    fe_add(r->X, p->Y, p->X);
+    fe_sub(r->Y, p->Y, p->X);
+    fe_mul(r->Z, r->X, q->YminusX);
+    fe_mul(r->Y, r->Y, q->YplusX);
+    fe_mul(r->T, q->T2d, p->T);
+    fe_mul(r->X, p->Z, q->Z);
+    fe_add(t0, r->X, r->X);
+    fe_sub(r->X, r->Z, r->Y);
+    fe_add(r->Y, r->Z, r->Y);
+    fe_sub(r->Z, t0, r->T);
+    fe_add(r->T, t0, r->T);
+}
+
+
+/* r = p - q */
+static void ge_msub(ge_p1p1* r, ge_p3* p, ge_precomp* q)
+{
+    fe t0;
+
+    fe_add(r->X, p->Y, p->X);
+    fe_sub(r->Y, p->Y, p->X);
+    fe_mul(r->Z, r->X, q->yminusx);
+    fe_mul(r->Y, r->Y, q->yplusx);
+    fe_mul(r->T, q->xy2d, p->T);
+    fe_add(t0, p->Z, p->Z);
+    fe_sub(r->X, r->Z, r->Y);
+    fe_add(r->Y, r->Z, r->Y);
+    fe_sub(r->Z, t0, r->T);
+    fe_add(r->T, t0, r->T);
+}
+
+
+/* encode y with the sign of x in the top bit */
+void ge_tobytes(byte* s, ge_p2* h)
+{
+    fe recip;
+    fe x;
+    fe y;
+
+    fe_invert(recip, h->Z);
+    fe_mul(x, h->X, recip);
+    fe_mul(y, h->Y, recip);
+    fe_tobytes(s, y);
+    s[31] ^= fe_isnegative(x) << 7;
+}
+
+
+void ge_p3_tobytes(byte* s, ge_p3* h)
+{
+    ge_p2 q;
+
+    ge_p3_to_p2(&q, h);
+    ge_tobytes(s, &q);
+}
+
+
+/* decode s into -A, the form verification wants
+   return 0 on success, -1 if s is not a canonical curve point */
+int ge_frombytes_negate_vartime(ge_p3* h, const byte* s)
+{
+    fe     u;
+    fe     v;
+    fe     v3;
+    fe     vxx;
+    fe     check;
+    fe     d;
+    byte   enc[32];
+    int    i;
+
+    XMEMCPY(d, ed25519_d, sizeof(fe));
+
+    fe_frombytes(h->Y, s);
+
+    /* y must be below p */
+    fe_tobytes(enc, h->Y);
+    enc[31] |= s[31] & 0x80;
+    for (i = 0; i < 32; i++)
+        if (enc[i] != s[i])
+            return -1;
+
+    fe_1(h->Z);
+    fe_sq(u, h->Y);
+    fe_mul(v, u, d);
+    fe_sub(u, u, h->Z);          /* u = y^2 - 1 */
+    fe_add(v, v, h->Z);          /* v = dy^2 + 1 */
+
+    fe_sq(v3, v);
+    fe_mul(v3, v3, v);           /* v3 = v^3 */
+    fe_sq(h->X, v3);
+    fe_mul(h->X, h->X, v);
+    fe_mul(h->X, h->X, u);       /* x = uv^7 */
+
+    fe_pow22523(h->X, h->X);     /* x = (uv^7)^((q-5)/8) */
+    fe_mul(h->X, h->X, v3);
+    fe_mul(h->X, h->X, u);       /* x = uv^3(uv^7)^((q-5)/8) */
+
+    fe_sq(vxx, h->X);
+    fe_mul(vxx, vxx, v);
+    fe_sub(check, vxx, u);       /* vx^2 - u */
+    if (fe_isnonzero(check)) {
+        fe_add(check, vxx, u);   /* vx^2 + u */
+        if (fe_isnonzero(check))
+            return -1;
+        XMEMCPY(d, ed25519_sqrtm1, sizeof(fe));
+        fe_mul(h->X, h->X, d);
+    }
+
+    /* x = 0 has no negative form */
+    if (!fe_isnonzero(h->X) && (s[31] >> 7))
+        return -1;
+
+    if (fe_isnegative(h->X) == (s[31] >> 7))
+        fe_neg(h->X, h->X);
+
+    fe_mul(h->T, h->X, h->Y);
+
+    return 0;
+}
+
+
+/* Bi[i] = (2i + 1) * B */
+void ge_base_odd(ge_precomp* Bi)
+{
+    XMEMCPY(Bi, ed25519_Bi, sizeof(ed25519_Bi));
+}
+
+
+/* signed width 5 sliding window digits of a 256 bit little endian scalar,
+   every nonzero r[i] is odd and in [-15, 15] */
+void ge_slide(signed char* r, const byte* a)
+{
+    int i;
+    int b;
+    int k;
+
+    for (i = 0; i < 256; ++i)
+        r[i] = 1 & (a[i >> 3] >> (i & 7));
+
+    for (i = 0; i < 256; ++i) {
+        if (!r[i])
+            continue;
+        for (b = 1; b <= 6 && i + b < 256; ++b) {
+            if (!r[i + b])
+                continue;
+            if (r[i] + (r[i + b] << b) <= 15) {
+                r[i] += r[i + b] << b;
+                r[i + b] = 0;
+            }
+            else if (r[i] - (r[i + b] << b) >= -15) {
+                r[i] -= r[i + b] << b;
+                for (k = i + b; k < 256; ++k) {
+                    if (!r[k]) {
+                        r[k] = 1;
+                        break;
+                    }
+                    r[k] = 0;
+                }
+            }
+            else
+                break;
+        }
+    }
+}
+
+
+/* Ai[i] = (2i + 1) * A */
+void ge_cached_odd(ge_cached* Ai, ge_p3* A)
+{
+    ge_p1p1 t;
+    ge_p3   u;
+    ge_p3   A2;
+    int     i;
+
+    ge_p3_to_cached(&Ai[0], A);
+    ge_p3_dbl(&t, A);
+    ge_p1p1_to_p3(&A2, &t);
+    for (i = 0; i < 7; i++) {
+        ge_add(&t, &A2, &Ai[i]);
+        ge_p1p1_to_p3(&u, &t);
+        ge_p3_to_cached(&Ai[i + 1], &u);
+    }
+}
+
+
+/* One doubling step of a multi scalar sum: r = 2r, then add in digit i of
+   every point's window and of the base point's. Variable time, public data
+   only. */
+void ge_multi_step(ge_p2* r, int i, int n, signed char** slides,
+                   ge_cached** Ai, signed char* bslide, ge_precomp* Bi)
+{
+    ge_p1p1 t;
+    ge_p3   u;
+    int     j;
+
+    ge_p2_dbl(&t, r);
+
+    for (j = 0; j < n; j++) {
+        signed char d = slides[j][i];
+
+        if (d > 0) {
+            ge_p1p1_to_p3(&u, &t);
+            ge_add(&t, &u, &Ai[j][d / 2]);
+        }
+        else if (d < 0) {
+            ge_p1p1_to_p3(&u, &t);
+            ge_sub(&t, &u, &Ai[j][(-d) / 2]);
+        }
+    }
+
+    if (bslide[i] > 0) {
+        ge_p1p1_to_p3(&u, &t);
+        ge_madd(&t, &u, &Bi[bslide[i] / 2]);
+    }
+    else if (bslide[i] < 0) {
+        ge_p1p1_to_p3(&u, &t);
+        ge_msub(&t, &u, &Bi[(-bslide[i]) / 2]);
+    }
+
+    ge_p1p1_to_p2(r, &t);
+}
+
+
+/* r = a * A + b * B, variable time, for verification */
+void ge_double_scalarmult_vartime(ge_p2* r, const byte* a, ge_p3* A,
+                                  const byte* b)
+{
+    signed char  aslide[256];
+    signed char  bslide[256];
+    signed char* slides[1];
+    ge_cached    Ai[8];
+    ge_cached*   cached[1];
+    ge_precomp   Bi[8];
+    int          i;
+
+    ge_base_odd(Bi);
+
+    ge_slide(aslide, a);
+    ge_slide(bslide, b);
+    ge_cached_odd(Ai, A);
+    slides[0] = aslide;
+    cached[0] = Ai;
+
+    ge_p2_0(r);
+
+    for (i = 255; i >= 0; --i)
+        if (aslide[i] || bslide[i])
+            break;
+
+    for (; i >= 0; --i)
+        ge_multi_step(r, i, 1, slides, cached, bslide, Bi);
+}
+
+#endif /* HAVE_ED25519 */
+
+#endif /* HAVE_ECC25519 */
@@ -0,0 +1,4402 @@
+/* ecc_p256.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+/* in case user set HAVE_ECC there */
+#include <cyassl/ctaocrypt/settings.h>
+
+#ifdef HAVE_ECC
+
+#include <cyassl/ctaocrypt/ecc_p256.h>
+
+#ifdef HAVE_ECC_P256
+
+#include <cyassl/ctaocrypt/error-crypt.h>
+
+#ifdef CYASSL_SMALL_STACK
+    #include <cyassl/ctaocrypt/memory.h>
+#endif
+
+
+/* Field elements are 4 little endian 64-bit limbs in Montgomery form
+   (a * 2^256 mod p), always fully reduced.  Points are Jacobian with the
+   point at infinity as z = 0; table points are affine.  Scalars use a
+   signed 5-bit window (digits -16..16) so every lookup touches all 16
+   entries and every step does the same work regardless of the key. */
+
+typedef word64 p256_fe[4];
+
+typedef unsigned __int128 p256_dword;
+
+typedef struct {
+    p256_fe x;
+    p256_fe y;
+    p256_fe z;
+} p256_point;
+
+typedef struct {
+    p256_fe x;
+    p256_fe y;
+} p256_affine;
+
+enum {
+    P256_BYTES   = 32,
+    P256_WINDOW  = 5,
+    P256_TABLE   = 16,                 /* 1 << (P256_WINDOW - 1) */
+    P256_WINDOWS = 52                  /* (256 + P256_WINDOW) / P256_WINDOW */
+};
+
+
+/* curve strings, compared against the ecc_set_type in use */
+static const char p256Prime[] =
+    "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF";
+static const char p256Af[] =
+    "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFC";
+static const char p256Order[] =
+    "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551";
+static const char p256Gx[] =
+    "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296";
+static const char p256Gy[] =
+    "4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5";
+
+/* p = 2^256 - 2^224 + 2^192 + 2^96 - 1 */
+static const p256_fe p256_mod = {
+    W64LIT(0xffffffffffffffff), W64LIT(0x00000000ffffffff),
+    W64LIT(0x0000000000000000), W64LIT(0xffffffff00000001)
+};
+
+/* 2^512 mod p, converts into Montgomery form */
+static const p256_fe p256_rr = {
+    W64LIT(0x0000000000000003), W64LIT(0xfffffffbffffffff),
+    W64LIT(0xfffffffffffffffe), W64LIT(0x00000004fffffffd)
+};
+
+/* 1 in Montgomery form, 2^256 mod p */
+static const p256_fe p256_one = {
+    W64LIT(0x0000000000000001), W64LIT(0xffffffff00000000),
+    W64LIT(0xffffffffffffffff), W64LIT(0x00000000fffffffe)
+};
+
+/* the curve's b in Montgomery form */
+static const p256_fe p256_b = {
+    W64LIT(0xd89cdf6229c4bddf), W64LIT(0xacf005cd78843090),
+    W64LIT(0xe5a220abf7212ed6), W64LIT(0xdc30061d04874834)
+};
+
+
+/* j * 2^(5i) * G for j = 1..16 in affine Montgomery form, entry [i][j - 1].
+   Generated offline, the fixed base multiply only adds one entry per
+   window and never doubles. */
+static const p256_affine p256_base[P256_WINDOWS][P256_TABLE] = {
+    {   /* j * 2^0 * G */
+        { { W64LIT(0x79e730d418a9143c), W64LIT(0x75ba95fc5fedb601),
+            W64LIT(0x79fb732b77622510), W64LIT(0x18905f76a53755c6) },
+          { W64LIT(0xddf25357ce95560a), W64LIT(0x8b4ab8e4ba19e45c),
+            W64LIT(0xd2e88688dd21f325), W64LIT(0x8571ff1825885d85) } },
+        { { W64LIT(0x850046d410ddd64d), W64LIT(0xaa6ae3c1a433827d),
+            W64LIT(0x732205038d1490d9), W64LIT(0xf6bb32e43dcf3a3b) },
+          { W64LIT(0x2f3648d361bee1a5), W64LIT(0x152cd7cbeb236ff8),
+            W64LIT(0x19a8fb0e92042dbe), W64LIT(0x78c577510a5b8a3b) } },
+        { { W64LIT(0xffac3f904eebc127), W64LIT(0xb027f84a087d81fb),
+            W64LIT(0x66ad77dd87cbbc98), W64LIT(0x26936a3fb6ff747e) },
+          { W64LIT(0xb04c5c1fc983a7eb), W64LIT(0x583e47ad0861fe1a),
+            W64LIT(0x788208311a2ee98e), W64LIT(0xd5f06a29e587cc07) } },
+        { { W64LIT(0x74b0b50d46918dcc), W64LIT(0x4650a6edc623c173),
+            W64LIT(0x0cdaacace8100af2), W64LIT(0x577362f541b0176b) },
+          { W64LIT(0x2d96f24ce4cbaba6), W64LIT(0x17628471fad6f447),
+            W64LIT(0x6b6c36dee5ddd22e), W64LIT(0x84b14c394c5ab863) } },
+        { { W64LIT(0xbe1b8aaec45c61f5), W64LIT(0x90ec649a94b9537d),
+            W64LIT(0x941cb5aad076c20c), W64LIT(0xc9079605890523c8) },
+          { W64LIT(0xeb309b4ae7ba4f10), W64LIT(0x73c568efe5eb882b),
+            W64LIT(0x3540a9877e7a1f68), W64LIT(0x73a076bb2dd1e916) } },
+        { { W64LIT(0x403947373e77664a), W64LIT(0x55ae744f346cee3e),
+            W64LIT(0xd50a961a5b17a3ad), W64LIT(0x13074b5954213673) },
+          { W64LIT(0x93d36220d377e44b), W64LIT(0x299c2b53adff14b5),
+            W64LIT(0xf424d44cef639f11), W64LIT(0xa4c9916d4a07f75f) } },
+        { { W64LIT(0x0746354ea0173b4f), W64LIT(0x2bd20213d23c00f7),
+            W64LIT(0xf43eaab50c23bb08), W64LIT(0x13ba5119c3123e03) },
+          { W64LIT(0x2847d0303f5b9d4d), W64LIT(0x6742f2f25da67bdd),
+            W64LIT(0xef933bdc77c94195), W64LIT(0xeaedd9156e240867) } },
+        { { W64LIT(0x27f14cd19499a78f), W64LIT(0x462ab5c56f9b3455),
+            W64LIT(0x8f90f02af02cfc6b), W64LIT(0xb763891eb265230d) },
+          { W64LIT(0xf59da3a9532d4977), W64LIT(0x21e3327dcf9eba15),
+            W64LIT(0x123c7b84be60bbf0), W64LIT(0x56ec12f27706df76) } },
+        { { W64LIT(0x75c96e8f264e20e8), W64LIT(0xabe6bfed59a7a841),
+            W64LIT(0x2cc09c0444c8eb00), W64LIT(0xe05b3080f0c4e16b) },
+          { W64LIT(0x1eb7777aa45f3314), W64LIT(0x56af7bedce5d45e3),
+            W64LIT(0x2b6e019a88b12f1a), W64LIT(0x086659cdfd835f9b) } },
+        { { W64LIT(0x2c18dbd19dc21ec8), W64LIT(0x98f9868a0fcf8139),
+            W64LIT(0x737d2cd648250b49), W64LIT(0xcc61c94724b3428f) },
+          { W64LIT(0x0c2b407880dd9e76), W64LIT(0xc43a8991383fbe08),
+            W64LIT(0x5f7d2d65779be5d2), W64LIT(0x78719a54eb3b4ab5) } },
+        { { W64LIT(0xea7d260a6245e404), W64LIT(0x9de407956e7fdfe0),
+            W64LIT(0x1ff3a4158dac1ab5), W64LIT(0x3e7090f1649c9073) },
+          { W64LIT(0x1a7685612b944e88), W64LIT(0x250f939ee57f61c8),
+            W64LIT(0x0c0daa891ead643d), W64LIT(0x68930023e125b88e) } },
+        { { W64LIT(0x04b71aa7d2697768), W64LIT(0xabdedef5ca345a33),
+            W64LIT(0x2409d29dee37385e), W64LIT(0x4ee1df77cb83e156) },
+          { W64LIT(0x0cac12d91cbb5b43), W64LIT(0x170ed2f6ca895637),
+            W64LIT(0x28228cfa8ade6d66), W64LIT(0x7ff57c9553238aca) } },
+        { { W64LIT(0xccc425634b2ed709), W64LIT(0x0e356769856fd30d),
+            W64LIT(0xbcbcd43f559e9811), W64LIT(0x738477ac5395b759) },
+          { W64LIT(0x35752b90c00ee17f), W64LIT(0x68748390742ed2e3),
+            W64LIT(0x7cd06422bd1f5bc1), W64LIT(0xfbc08769c9e7b797) } },
+        { { W64LIT(0xa242a35bb0cf664a), W64LIT(0x126e48f77f9707e3),
+            W64LIT(0x1717bf54c6832660), W64LIT(0xfaae7332fd12c72e) },
+          { W64LIT(0x27b52db7995d586b), W64LIT(0xbe29569e832237c2),
+            W64LIT(0xe8e4193e2a65e7db), W64LIT(0x152706dc2eaa1bbb) } },
+        { { W64LIT(0x72bcd8b7bc60055b), W64LIT(0x03cc23ee56e27e4b),
+            W64LIT(0xee337424e4819370), W64LIT(0xe2aa0e430ad3da09) },
+          { W64LIT(0x40b8524f6383c45d), W64LIT(0xd766355442a41b25),
+            W64LIT(0x64efa6de778a4797), W64LIT(0x2042170a7079adf4) } },
+        { { W64LIT(0x808b0b650bc6fb80), W64LIT(0x5882e0753ffe2e6b),
+            W64LIT(0xd5ef2f7c2c83f549), W64LIT(0x54d63c809103b723) },
+          { W64LIT(0xf2f11bd652a23f9b), W64LIT(0x3670c3194b0b6587),
+            W64LIT(0x55c4623bb1580e9e), W64LIT(0x64edf7b201efe220) } }
+    },
+    {   /* j * 2^5 * G */
+        { { W64LIT(0xd8c5fccfc5e3a3d8), W64LIT(0xbefd904c4079dfbf),
+            W64LIT(0xbc6d6a58fead0197), W64LIT(0x39227077695532a4) },
+          { W64LIT(0x09e23e6ddbef42f5), W64LIT(0x7e449b64480a9908),
+            W64LIT(0x7b969c1aad9a2e40), W64LIT(0x6231d7929591c2a4) } },
+        { { W64LIT(0xdb6d96f305968b80), W64LIT(0x380a0913089f73b9),
+            W64LIT(0x7da70b83c2c61e01), W64LIT(0x95fb8394569b38c7) },
+          { W64LIT(0x9a3c651280edfe2f), W64LIT(0x8f726bb98faeaf82),
+            W64LIT(0x8010a4a078424bf8), W64LIT(0x296720440e844970) } },
+        { { W64LIT(0x802b8d2333e12b70), W64LIT(0x6d490a4b19dd329b),
+            W64LIT(0x14f356cc6abc354d), W64LIT(0x11eddf7fd0a0da0d) },
+          { W64LIT(0x1e208328d87fd1d8), W64LIT(0xfd2f4f8cfd025813),
+            W64LIT(0x03b48cc47c29bca2), W64LIT(0x3f2a78b3241a2b71) } },
+        { { W64LIT(0x63c5cb817a2ad62a), W64LIT(0x7ef2b6b9ac62ff54),
+            W64LIT(0x3749bba4b3ad9db5), W64LIT(0xad311f2c46d5a617) },
+          { W64LIT(0xb77a8087c2ff3b6d), W64LIT(0xb46feaf3367834ff),
+            W64LIT(0xf8aa266d75d6b138), W64LIT(0xfa38d320ec008188) } },
+        { { W64LIT(0xc04afa1ae3451a09), W64LIT(0x7cc69103bc117423),
+            W64LIT(0x876be3aa51cf56ee), W64LIT(0xe7577d57ad844a25) },
+          { W64LIT(0x266fed8cdb77f341), W64LIT(0xcfa258dc23ae4a2a),
+            W64LIT(0x53a7a98cda782760), W64LIT(0x04b48868ceaf7d4a) } },
+        { { W64LIT(0xc0f2affc4e6916c6), W64LIT(0x6fb94957811842da),
+            W64LIT(0x6034bcb624b4d157), W64LIT(0xde2efdc7992efb90) },
+          { W64LIT(0xd66f7eceac793c87), W64LIT(0x02f026267dc6fdcd),
+            W64LIT(0x90d3235c9aa1c501), W64LIT(0xf6e494962b4666f0) } },
+        { { W64LIT(0x082736d19c0859c3), W64LIT(0x89ea5516b269386a),
+            W64LIT(0xf25071871aa87b33), W64LIT(0xe9d82f5f704e8236) },
+          { W64LIT(0x7834612442e855f5), W64LIT(0x209f50fe395e00d8),
+            W64LIT(0xcd9e03aae6e7e62b), W64LIT(0xb4b4959e5e5be37b) } },
+        { { W64LIT(0x486d8ffa696946fc), W64LIT(0x50fbc6d8b9cba56d),
+            W64LIT(0x7e3d423e90f35a15), W64LIT(0x7c3da195c0dd962c) },
+          { W64LIT(0xe673fdb03cfd5d8b), W64LIT(0x0704b7c2889dfca5),
+            W64LIT(0xf6ce581ff52305aa), W64LIT(0x399d49eb914d5e53) } },
+        { { W64LIT(0x7966afbb10e6d950), W64LIT(0x37e4a4c4e2bf970a),
+            W64LIT(0x23d0c8559d54ca2a), W64LIT(0x13d62865fee39a10) },
+          { W64LIT(0x15f53c38d3bd15e9), W64LIT(0x014b8bed84a80bcc),
+            W64LIT(0x10674c77bfd8f608), W64LIT(0x4dfab986c93fbfef) } },
+        { { W64LIT(0x24c97c367b92d453), W64LIT(0xd2c271a2249a26c0),
+            W64LIT(0x60eb4b2b89d14a39), W64LIT(0x1198de20432e8005) },
+          { W64LIT(0x9eabea75799b80d9), W64LIT(0xab6e0c2b8f826ae5),
+            W64LIT(0xca004eedd10061ec), W64LIT(0x31a9f439e99c4fd8) } },
+        { { W64LIT(0x734c8b75b5498a7c), W64LIT(0xaeccad8a29f64c2d),
+            W64LIT(0x95dd54fa295b1677), W64LIT(0x383902a0b4c54968) },
+          { W64LIT(0x78cb276feb9d33a9), W64LIT(0x00aedca1af552869),
+            W64LIT(0xa01d14594c5c1630), W64LIT(0xfeba17067cf7d50d) } },
+        { { W64LIT(0x380a496d6ec293cd), W64LIT(0x733dbda78e7051f5),
+            W64LIT(0x037e388db849140a), W64LIT(0xee4b32b05946dbf6) },
+          { W64LIT(0xb1c4fda9cae368d1), W64LIT(0x5001a7b0fdb0b2f3),
+            W64LIT(0x6df593742e3ac46e), W64LIT(0x4af675f239b3e656) } },
+        { { W64LIT(0x1a1fffdcc01b0a46), W64LIT(0x07ad675f83f843c2),
+            W64LIT(0xbcec2d076738e81a), W64LIT(0x910aec75aa8b7da8) },
+          { W64LIT(0x13b4d740a4509ba7), W64LIT(0x057010734c7b8216),
+            W64LIT(0x3d75c8f71591f1e5), W64LIT(0x134c1b6f0dfe1d90) } },
+        { { W64LIT(0xb20e7c44d67826eb), W64LIT(0x1212d3cfac379637),
+            W64LIT(0x614f67877de03a5d), W64LIT(0x7538a2fc802baa26) },
+          { W64LIT(0x133c37a19d252415), W64LIT(0x7db390506eb4b587),
+            W64LIT(0x5d40d7574c49d1d9), W64LIT(0xf1126b99a801c4ba) } },
+        { { W64LIT(0x39a7aeb9c56729fc), W64LIT(0x21a59448e7a8bd85),
+            W64LIT(0xd7c6da5d049d10c6), W64LIT(0x93a4c4a8c5197afb) },
+          { W64LIT(0xd185539c25933861), W64LIT(0x4994bcba27494d9d),
+            W64LIT(0xef033de14ce7bfa9), W64LIT(0x22e9b000321f9236) } },
+        { { W64LIT(0x44e3811039949296), W64LIT(0x5b63827b361db1b5),
+            W64LIT(0x3e5323ed206eaff5), W64LIT(0x942370d2c21f4290) },
+          { W64LIT(0xf2caaf2ee0d985a1), W64LIT(0x192cc64b7239846d),
+            W64LIT(0x7c0b8f47ae6312f8), W64LIT(0x7dc61f9196620108) } }
+    },
+    {   /* j * 2^10 * G */
+        { { W64LIT(0x4f7081e144cc3add), W64LIT(0xd5ffa1d687be82cf),
+            W64LIT(0x89890b6c0edd6472), W64LIT(0xada26e1a3ed17863) },
+          { W64LIT(0x276f271563483caa), W64LIT(0xe6924cd92f6077fd),
+            W64LIT(0x05a7fe980a466e3c), W64LIT(0xf1c794b0b1902d1f) } },
+        { { W64LIT(0x3d2b24b9eb7926b8), W64LIT(0xbff88cb3cdbe5509),
+            W64LIT(0xd0f399afe4dd640b), W64LIT(0x3c5fe1302f76ed45) },
+          { W64LIT(0x6f3562f43764fb3d), W64LIT(0x7b5af3183151b62d),
+            W64LIT(0xd5bd0bc7d79ce5f3), W64LIT(0xfdaf6b20ec66890f) } },
+        { { W64LIT(0x32027fe891e5d7d3), W64LIT(0xf14b7d1773a07678),
+            W64LIT(0xf88497b3c0dfdd61), W64LIT(0xf7c2eec02a8c4f48) },
+          { W64LIT(0xaa5573f43756e621), W64LIT(0xc013a2401825b948),
+            W64LIT(0x1c03b34563878572), W64LIT(0xa0472bea653a4184) } },
+        { { W64LIT(0x6772b0e5ab4b35a2), W64LIT(0x1d8b6001f5eeaacf),
+            W64LIT(0x728f7ce4795b9580), W64LIT(0x4a20ed2a41fb81da) },
+          { W64LIT(0x9f685cd44fec01e6), W64LIT(0x3ed7ddcca7ff50ad),
+            W64LIT(0x460fd2640c2d97fd), W64LIT(0x3a241426eb82f4f9) } },
+        { { W64LIT(0x29ae2cf983dfedc9), W64LIT(0xf84371348d87631a),
+            W64LIT(0xaf5717117429c8d2), W64LIT(0x18d15867146d9272) },
+          { W64LIT(0x83053ecf69769bb7), W64LIT(0xc55eb856c479ab82),
+            W64LIT(0x5ef7791c21b0f4b2), W64LIT(0xaa5956ba3d491525) } },
+        { { W64LIT(0x84cfbfa1c5c5ea50), W64LIT(0xd3baf14c67960681),
+            W64LIT(0x263984030dd50942), W64LIT(0xe4b7839c4716a663) },
+          { W64LIT(0xd5f1f794e7de6dc0), W64LIT(0x5cd0f4d4622aa7ce),
+            W64LIT(0x5295f3f159acfeec), W64LIT(0x8d933552953e0607) } },
+        { { W64LIT(0xe652533b3cef0d7d), W64LIT(0xd94f7b182bbb4381),
+            W64LIT(0x838752be0e80f500), W64LIT(0x8e6e24889e9c9bfb) },
+          { W64LIT(0xc975169716caca6a), W64LIT(0x866c49d838531ad9),
+            W64LIT(0xc917e2397151ade1), W64LIT(0x2d016ec16037c407) } },
+        { { W64LIT(0x80009862d5d721d5), W64LIT(0x0c3357a35bd3a182),
+            W64LIT(0x27f3a83b7aa2cda4), W64LIT(0xb58ae74ef6f83085) },
+          { W64LIT(0x2a911a812e6dad6b), W64LIT(0xde286051f43d6c5b),
+            W64LIT(0x4bdccc41f996c4d8), W64LIT(0xe7312ec00ae1e24e) } },
+        { { W64LIT(0x903f6e3960e913af), W64LIT(0xb2b58bee98bf140d),
+            W64LIT(0x9deff025354890b8), W64LIT(0x155810068d2e924e) },
+          { W64LIT(0xb5755db493c95e5b), W64LIT(0x3fac42f0dae20eb8),
+            W64LIT(0x9377c8c109b6d8e0), W64LIT(0xa43e2b46ab47ceff) } },
+        { { W64LIT(0x5f57b2fbfacfa459), W64LIT(0x874b1498c1b5aa6b),
+            W64LIT(0xb9e89acac4db2092), W64LIT(0x1362bf8ddf4381da) },
+          { W64LIT(0x25d76830b76328a0), W64LIT(0x38188b7098572ae4),
+            W64LIT(0xb43e941429132f7d), W64LIT(0x7895a29f22dd42c9) } },
+        { { W64LIT(0xcbde78dd5e22cbb2), W64LIT(0xf449c85b76bb4391),
+            W64LIT(0x4289f357b6a4273b), W64LIT(0x9fce23fd48e84a19) },
+          { W64LIT(0xcfc32730939eb3b4), W64LIT(0x8b3d982c16c32280),
+            W64LIT(0x5ac234bad5f1346c), W64LIT(0x781954b470769fc9) } },
+        { { W64LIT(0x6faf68feaae6ee70), W64LIT(0x78f4cc155602b0c9),
+            W64LIT(0x7e3321a86e94052a), W64LIT(0x2fb3a0d6734d5d80) },
+          { W64LIT(0xf3b98f3bb25a43ba), W64LIT(0x30bf803119ee2951),
+            W64LIT(0x7ffee43321b0612a), W64LIT(0x12f775e42eb821d0) } },
+        { { W64LIT(0x4fdff805f57209b5), W64LIT(0x9bd65ac3f952ac8d),
+            W64LIT(0x02a3abd3c7969a6f), W64LIT(0x1359927ef523775f) },
+          { W64LIT(0xe09b463f88d2e861), W64LIT(0x661d2199623287c3),
+            W64LIT(0x821e64495a70eb7a), W64LIT(0x0afbbb1dd67dc684) } },
+        { { W64LIT(0x7418e3d3acff89f9), W64LIT(0x227f16aed852251f),
+            W64LIT(0xdd5bc6e4eb84658b), W64LIT(0xf066b9c8f90a9f7e) },
+          { W64LIT(0xc2369071800a7f87), W64LIT(0x383ddc0d5a72862a),
+            W64LIT(0x5b48465d8a776da5), W64LIT(0x3d82f64f5e2d8318) } },
+        { { W64LIT(0x5852104b87453b28), W64LIT(0x073e8128b387344d),
+            W64LIT(0x300e78e4817cfc08), W64LIT(0x3a82ed4799362088) },
+          { W64LIT(0xe222304c88de46a4), W64LIT(0x666c94fd57fadf4a),
+            W64LIT(0x40b2d08ea0c8e108), W64LIT(0x4b2955b909e050fa) } },
+        { { W64LIT(0xf8d112e76e6485b3), W64LIT(0x4d3e24db771c52f8),
+            W64LIT(0x48e3ee41684a2f6d), W64LIT(0x7161957d21d95551) },
+          { W64LIT(0x19631283cdb12a6c), W64LIT(0xbf3fa8822e50e164),
+            W64LIT(0xf6254b633166cc73), W64LIT(0x3aefa7aeaee8cc38) } }
+    },
+    {   /* j * 2^15 * G */
+        { { W64LIT(0x79b0fe623b36f9fd), W64LIT(0x26543b23fde19fc0),
+            W64LIT(0x136e64a0958482ef), W64LIT(0x23f637719b095825) },
+          { W64LIT(0x14cfd596b6a1142e), W64LIT(0x5ea6aac6335aac0b),
+            W64LIT(0x86a0e8bdf3081dd5), W64LIT(0x5fb89d79003dc12a) } },
+        { { W64LIT(0x0f0165fce3779ee3), W64LIT(0xe00e7f9dbd495d9e),
+            W64LIT(0x1fa4efa220284e7a), W64LIT(0x4564bade47ac6219) },
+          { W64LIT(0x90e6312ac4708e8e), W64LIT(0x4f5725fba71e9adf),
+            W64LIT(0xe95f55ae3d684b9f), W64LIT(0x47f7ccb11e94b415) } },
+        { { W64LIT(0xda3a77e5522e6b69), W64LIT(0x69c908c3bbcd6c18),
+            W64LIT(0x1f1b9e48d924fd56), W64LIT(0x37c64e36aa4bb3f7) },
+          { W64LIT(0x5a4fdbdfee478d7d), W64LIT(0xba75c8bc0193f7a0),
+            W64LIT(0x84bc1e8456cd16df), W64LIT(0x1fb08f0846fad151) } },
+        { { W64LIT(0x3617890361a341c1), W64LIT(0x3604dc600cfd6142),
+            W64LIT(0x022295eb8533316c), W64LIT(0x3dbde4ac44af2922) },
+          { W64LIT(0x898afc5d1c7eef69), W64LIT(0x58896805d14f4fa1),
+            W64LIT(0x05002160203c21ca), W64LIT(0x6f0d1f3040ef730b) } },
+        { { W64LIT(0x48201b4b12cfe297), W64LIT(0x3eee129c292f74e5),
+            W64LIT(0xe1fe114ec9e874e8), W64LIT(0x899b055c92c5fc41) },
+          { W64LIT(0x4e477a643a39c8cf), W64LIT(0x82f09efe78963cc9),
+            W64LIT(0x6fd3fd8fd333f863), W64LIT(0x85132b2adc949c63) } },
+        { { W64LIT(0xbd9b8b1dbe7a2af3), W64LIT(0xec51caa94fb74a72),
+            W64LIT(0xb9937a4b63879697), W64LIT(0x7c9a9d20ec2687d5) },
+          { W64LIT(0x1773e44f6ef5f014), W64LIT(0x8abcf412e90c6900),
+            W64LIT(0x387bd0228142161e), W64LIT(0x50393755fcb6ff2a) } },
+        { { W64LIT(0x766e072232398baa), W64LIT(0x205fee425cfca031),
+            W64LIT(0xa49f53417a029cf2), W64LIT(0xa88c68b84023890d) },
+          { W64LIT(0xbc2750417337aaa8), W64LIT(0x9ed364ad0eb384f4),
+            W64LIT(0xe0816f8529aba92f), W64LIT(0x2e9e194104e38a88) } },
+        { { W64LIT(0xfabf770977f7195a), W64LIT(0x8ec86167adeb838f),
+            W64LIT(0xea1285a8bb4f012d), W64LIT(0xd68835039a3eab3f) },
+          { W64LIT(0xee5d24f8309004c2), W64LIT(0xa96e4b7613ffe95e),
+            W64LIT(0x0cdffe12bd223ea4), W64LIT(0x8f5c2ee5b6739a53) } },
+        { { W64LIT(0xecace1dda1887395), W64LIT(0x40960f36932a65de),
+            W64LIT(0x9611ff5c3aa95529), W64LIT(0xc58215b07c1e5a36) },
+          { W64LIT(0xd48c9b58f0e1a524), W64LIT(0xb406856bf590dfb8),
+            W64LIT(0xc7605e049cd95662), W64LIT(0x0dd036eea33ecf82) } },
+        { { W64LIT(0x3d61333959145a65), W64LIT(0xcd9bc368fa406337),
+            W64LIT(0x82d11be32d8a52a0), W64LIT(0xf6877b2797a1c590) },
+          { W64LIT(0x837a819bf5cbdb25), W64LIT(0x2a4fd1d8de090249),
+            W64LIT(0x622a7de774990e5f), W64LIT(0x840fa5a07945511b) } },
+        { { W64LIT(0xfe2893277946d3f9), W64LIT(0xe132bd2407472273),
+            W64LIT(0xeeeb510c1eb6ae86), W64LIT(0x777708c5f0595067) },
+          { W64LIT(0x18e2c8cd1297029e), W64LIT(0x2c61095cbbf9305e),
+            W64LIT(0xe466c2586b85d6d9), W64LIT(0x8ac06c36da1ea530) } },
+        { { W64LIT(0xe58e90b36b0cf82e), W64LIT(0x6438d2462615b5e7),
+            W64LIT(0x07b1f8fc669c145a), W64LIT(0xb0d8b2da36f1e1cb) },
+          { W64LIT(0x54d5dadbd9184c4d), W64LIT(0x3dbb18d5f93d9976),
+            W64LIT(0x0a3e0f56d1147d47), W64LIT(0x2afa8c8da0a48609) } },
+        { { W64LIT(0x871239ad653ae326), W64LIT(0x14bcf72aa74cbb43),
+            W64LIT(0x8737650e20d4c083), W64LIT(0x3df86536110ed4af) },
+          { W64LIT(0xd2d86fe7b53ca555), W64LIT(0x688cb00dabd5d538),
+            W64LIT(0xcf81bda31ad38468), W64LIT(0x7ccfe3ccf01167b6) } },
+        { { W64LIT(0x26e08c07e3533d77), W64LIT(0xd7222e6a2e341c99),
+            W64LIT(0x9d60ec3d8d2dc4ed), W64LIT(0xbdfe0d8f7c476cf8) },
+          { W64LIT(0x1fe59ab61d056605), W64LIT(0xa9ea9df686a8551f),
+            W64LIT(0x8489941e47fb8d8c), W64LIT(0xfeb874eb4a7f1b10) } },
+        { { W64LIT(0x61fc181060a71676), W64LIT(0xe852d1a8f66a8ad1),
+            W64LIT(0x172bbd656417231e), W64LIT(0x0d6de7bd3babb11f) },
+          { W64LIT(0x6fde6f88c8e347f8), W64LIT(0x1c5875479bd99cc3),
+            W64LIT(0x78e54ed034076950), W64LIT(0x97f0f334796e83ba) } },
+        { { W64LIT(0xed406aa9bd763802), W64LIT(0xc21486a065303da1),
+            W64LIT(0x61ae291ec7e62ec4), W64LIT(0x622a0492df99333e) },
+          { W64LIT(0x7fd80c9dbb7a8ee0), W64LIT(0xdc2ed3bc6c01aedb),
+            W64LIT(0x35c35a1208be74ec), W64LIT(0xd540cb1a469f671f) } }
+    },
+    {   /* j * 2^20 * G */
+        { { W64LIT(0xa7a8746a584c5e20), W64LIT(0x267e4ea1b9dc7035),
+            W64LIT(0x593a15cfb9548c9b), W64LIT(0x5e6e21354bd012f3) },
+          { W64LIT(0xdf31cc6a8c8f936e), W64LIT(0x8af84d04b5c241dc),
+            W64LIT(0x63990a6f345efb86), W64LIT(0x6fef4e61b9b962cb) } },
+        { { W64LIT(0xf6368f0925722608), W64LIT(0x131260db131cf5c6),
+            W64LIT(0x40eb353bfab4f7ac), W64LIT(0x85c7888037eee829) },
+          { W64LIT(0x4c1581ffc3bdf24e), W64LIT(0x5bff75cbf5c3c5a8),
+            W64LIT(0x35e8c83fa14e6f40), W64LIT(0xb81d1c0f0295e0ca) } },
+        { { W64LIT(0xf2efe23d442a8ad1), W64LIT(0xc3816a7d06b9c164),
+            W64LIT(0xa9df2d8bdc0aa5e5), W64LIT(0x191ae46f120a8e65) },
+          { W64LIT(0x83667f8700611c5b), W64LIT(0x83171ed7ff109948),
+            W64LIT(0x33a2ecf8ca695952), W64LIT(0xfa4a73eef48d1a13) } },
+        { { W64LIT(0xfcde7cc8f43a730f), W64LIT(0xe89b6f3c33ab590e),
+            W64LIT(0xc823f529ad03240b), W64LIT(0x82b79afe98bea5db) },
+          { W64LIT(0x568f2856962fe5de), W64LIT(0x0c590adb60c591f3),
+            W64LIT(0x1fc74a144a28a858), W64LIT(0x3b662498b3203f4c) } },
+        { { W64LIT(0x48fc4ed082dd1b6a), W64LIT(0x5783a13867b703af),
+            W64LIT(0x2463cb9a005d6aaa), W64LIT(0xd31ec55c706ecd43) },
+          { W64LIT(0x9f8ed33f8e9a7641), W64LIT(0x625453ed098d9e7a),
+            W64LIT(0xa3beade4ec887493), W64LIT(0x442b80505a795566) } },
+        { { W64LIT(0x91e3cf0d6c39765a), W64LIT(0xa2db3acdac3cca0b),
+            W64LIT(0x288f2f08cb953b50), W64LIT(0x2414582ccf43cf1a) },
+          { W64LIT(0x8dec8bbc60eee9a8), W64LIT(0x54c79f02729aa042),
+            W64LIT(0xd81cd5ec6532f5d5), W64LIT(0xa672303acf82e15f) } },
+        { { W64LIT(0x46df582d3bfab839), W64LIT(0x92474e042f8adade),
+            W64LIT(0x36a7766a147a1bc3), W64LIT(0xb6940f540dc0f979) },
+          { W64LIT(0x44738ef2f2759f25), W64LIT(0x9dd95789a719f4c6),
+            W64LIT(0x2859b7f40750c345), W64LIT(0x5e788bf2b22180d5) } },
+        { { W64LIT(0x376aafa8719c0563), W64LIT(0xcd8ad2dcbc5fc79f),
+            W64LIT(0x303fdb9fcb750cd3), W64LIT(0x14ff052f4418b08e) },
+          { W64LIT(0xf75084cf3e2d6520), W64LIT(0x7ebdf0f8144ed509),
+            W64LIT(0xf43bf0f2d3f25b98), W64LIT(0x86ad71cfa354d837) } },
+        { { W64LIT(0xa839c9fdfd67ca25), W64LIT(0x023e626860f2015c),
+            W64LIT(0x2414a7930e7b2a65), W64LIT(0x92dbe372b13edcbb) },
+          { W64LIT(0xf64981ee64c2200f), W64LIT(0x94fb9cdf8446f2f3),
+            W64LIT(0x01411a6a3f1367bb), W64LIT(0x7985c1915a1e8331) } },
+        { { W64LIT(0xb827fe9226f43572), W64LIT(0xdfd3ab5b5d824758),
+            W64LIT(0x315dd23a539094c1), W64LIT(0x85c0e37a66623d68) },
+          { W64LIT(0x575c79727be19ae0), W64LIT(0x616a3396df0d36b5),
+            W64LIT(0xa1ebb3c826b1ff7e), W64LIT(0x635b9485140ad453) } },
+        { { W64LIT(0xc8123c6037e2efea), W64LIT(0x8d49b502034a96f6),
+            W64LIT(0x466a346b973e4a95), W64LIT(0xf176b5bab7de00ff) },
+          { W64LIT(0x1c58fa3b82dfa945), W64LIT(0x2eb27a9609e429ae),
+            W64LIT(0x57c67a67a12b187c), W64LIT(0xb155ba82e2298bba) } },
+        { { W64LIT(0x92bf3cdada430c0b), W64LIT(0x4702850e3a96dac6),
+            W64LIT(0xc91cf0a515ac326a), W64LIT(0x95de4f49ab8c25e4) },
+          { W64LIT(0xb01bad09e265c17c), W64LIT(0x24e45464087b3881),
+            W64LIT(0xd43e583ce1fac5ca), W64LIT(0xe17cb3186ead97a6) } },
+        { { W64LIT(0xf1a542073d99bcfa), W64LIT(0x59db703ce8becf6d),
+            W64LIT(0x2e455142d2459569), W64LIT(0xb0ee5143a901b910) },
+          { W64LIT(0xfc05d451e26d994f), W64LIT(0x7a6062b41360caaf),
+            W64LIT(0xdf1ded5f4fa639b1), W64LIT(0xaf930348d335b8b0) } },
+        { { W64LIT(0x6cc3924374dcec46), W64LIT(0x33cfc02d54c2b73f),
+            W64LIT(0x82917844f26cd99c), W64LIT(0x8819dd95d1773f89) },
+          { W64LIT(0x09572aa60871f427), W64LIT(0x8e0cf365f6f01c34),
+            W64LIT(0x7fa52988bff1f5af), W64LIT(0x4eb357eae75e8e50) } },
+        { { W64LIT(0x3d8f248a21fd0861), W64LIT(0xade3bd649bd5a4b6),
+            W64LIT(0xcb56c953c2e2a6bf), W64LIT(0x699cd2b5287d6c5f) },
+          { W64LIT(0xdebce1be47d05e8f), W64LIT(0x1a4fbb13a8f53732),
+            W64LIT(0x97163beaa5852b08), W64LIT(0x92c49e6ceec6987a) } },
+        { { W64LIT(0xd9d0c8c4868af75d), W64LIT(0xd7325cff45c8c7ea),
+            W64LIT(0xab471996cc81ecb0), W64LIT(0xff5d55f3611824ed) },
+          { W64LIT(0xbe3145411977a0ee), W64LIT(0x5085c4c5722038c6),
+            W64LIT(0x2d5335bff94bb495), W64LIT(0x894ad8a6c8e2a082) } }
+    },
+    {   /* j * 2^25 * G */
+        { { W64LIT(0x540234b22c11bb37), W64LIT(0x2d0366dded4c74a3),
+            W64LIT(0xf9a968daeec5f25d), W64LIT(0x3660106867b63142) },
+          { W64LIT(0x07cd6d2c68d7b6d4), W64LIT(0xa8f74f090c842942),
+            W64LIT(0xe27514047768b1ee), W64LIT(0x4b5f7e89fe62aee4) } },
+        { { W64LIT(0xf2369f0b879fbbed), W64LIT(0x0ff0ae86da9d1869),
+            W64LIT(0x5251d75956766f45), W64LIT(0x4984d8c02be8d0fc) },
+          { W64LIT(0x7ecc95a6d21008f0), W64LIT(0x29bd54a03a1a1c49),
+            W64LIT(0xab9828c5d26c50f3), W64LIT(0x32c0087c51d0d251) } },
+        { { W64LIT(0x47feeb6662b5f3af), W64LIT(0xcefab5610abb3734),
+            W64LIT(0x449de60e19f35cb1), W64LIT(0x39f8db14157f0eb9) },
+          { W64LIT(0xffaecc5b3c61bfd6), W64LIT(0xa5a4d41d41216703),
+            W64LIT(0x7f8fabed224e1cc2), W64LIT(0x0d5a8186871ad953) } },
+        { { W64LIT(0x190d8ea601799a52), W64LIT(0xa20cec41b86d2952),
+            W64LIT(0x3062ffb27fff2a7c), W64LIT(0x741b32e579f19d37) },
+          { W64LIT(0xf80d81814eb57d47), W64LIT(0x7a2d0ed416aef06b),
+            W64LIT(0x09735fb01cecb588), W64LIT(0x1641caaac6061f5b) } },
+        { { W64LIT(0xae2ad171656e8c3a), W64LIT(0xc0e2a4631acd0705),
+            W64LIT(0x006f6a8aa0b6055c), W64LIT(0xaf4513d72b65a26e) },
+          { W64LIT(0x3f549e14d616d5bc), W64LIT(0x64ee395571253b1f),
+            W64LIT(0xe8b10bc1b8ce243a), W64LIT(0xbcbeace5913a4e77) } },
+        { { W64LIT(0x68d32256f779d6a7), W64LIT(0x20423b4d19e7284e),
+            W64LIT(0xde19aa1b38f3b153), W64LIT(0x73d0b6c28444f703) },
+          { W64LIT(0x666161489c64e6a3), W64LIT(0x99587c3737256224),
+            W64LIT(0x6f5277fe61331563), W64LIT(0x7174ad4aa656502e) } },
+        { { W64LIT(0xec1ffc920133918d), W64LIT(0x15d9bf5eb2c9ef97),
+            W64LIT(0x7885b542fc6cbb9a), W64LIT(0x8abe64535720cf5d) },
+          { W64LIT(0x4e715dced4ec68ab), W64LIT(0x57a67614279c24a3),
+            W64LIT(0x788ed52a31bb61cf), W64LIT(0xaba82444f437a003) } },
+        { { W64LIT(0x7f99824f20151427), W64LIT(0x206828b692430206),
+            W64LIT(0xaa9097d7e1112357), W64LIT(0xacf9a2f209e414ec) },
+          { W64LIT(0xdbdac9da27915356), W64LIT(0x7e0734b7001efee3),
+            W64LIT(0x54fab5bbd2b288e2), W64LIT(0x4c630fc4f62dd09c) } },
+        { { W64LIT(0x6d883e66bd70a5e1), W64LIT(0x9bd884c1d05de713),
+            W64LIT(0x48d9d445d4d8487d), W64LIT(0x8440cd8b0eeae405) },
+          { W64LIT(0xa3cd0f293d26f83e), W64LIT(0x3fd9453022a3c5e4),
+            W64LIT(0x63a078663ffa2ca7), W64LIT(0xbfeadd2900d4a097) } },
+        { { W64LIT(0x13aea559d68432ba), W64LIT(0x940043fbd33915db),
+            W64LIT(0x476c7c94e2e8da08), W64LIT(0x6b1630c4443065bb) },
+          { W64LIT(0xd6d8546d19f06c75), W64LIT(0x7e1e98c22eb35abd),
+            W64LIT(0x751c9310f0157d8e), W64LIT(0xdef84327f6fa6075) } },
+        { { W64LIT(0x765b993c3a7a4e0e), W64LIT(0xfb8f4aef9d79d314),
+            W64LIT(0x5ea2c50e2a19eb24), W64LIT(0x925016e5b891bc8c) },
+          { W64LIT(0x8f70afdc3ad1ece7), W64LIT(0x0abba84cf08fabe2),
+            W64LIT(0x0a9922c815f6132b), W64LIT(0x6c0213735d076d77) } },
+        { { W64LIT(0x00af2615a4453961), W64LIT(0x1705494b993d112c),
+            W64LIT(0x0032e12aa1cdd652), W64LIT(0x0ebfa612046d9cb3) },
+          { W64LIT(0x9f03a9f31b63728c), W64LIT(0x8f3618a2de022b05),
+            W64LIT(0xd5b24d903e77c5c9), W64LIT(0x837838a372acb77c) } },
+        { { W64LIT(0xfe65cbd98fceb047), W64LIT(0xde872ef53f8b11a1),
+            W64LIT(0x9aba0d3d8fec802f), W64LIT(0x139f1d329a9f381d) },
+          { W64LIT(0x0721aed9c587958d), W64LIT(0x066a015cb9f6a7da),
+            W64LIT(0x059ec4e3ed5d9d06), W64LIT(0x144285716cbaca1f) } },
+        { { W64LIT(0x66fe0fffe298cdf5), W64LIT(0x3f61bea47b2e51b6),
+            W64LIT(0x7d372117bad3afa4), W64LIT(0x6521a09cef656e2f) },
+          { W64LIT(0xb3b8c966e8a58fe7), W64LIT(0x25203a115a47ebc7),
+            W64LIT(0xfe81588d5c4be573), W64LIT(0x6132e2f31f49a03c) } },
+        { { W64LIT(0xec1ab0130f8c2c99), W64LIT(0x60e8968ff17725c2),
+            W64LIT(0xe1a4a593940a980b), W64LIT(0x15ed15b020e9ccb1) },
+          { W64LIT(0x77d754cc64a00bec), W64LIT(0x90d09c3341687382),
+            W64LIT(0x294fe02dc31fb651), W64LIT(0x8372cd1a1c94ae53) } },
+        { { W64LIT(0x8537107a1ac2703b), W64LIT(0xb49258d86bc857b5),
+            W64LIT(0x57df14debcdaccd1), W64LIT(0x24ab68d7c4ae8529) },
+          { W64LIT(0x7ed8b5d4734e59d0), W64LIT(0x5f8740c8c495cc80),
+            W64LIT(0x84aedd5a291db9b3), W64LIT(0x80b360f84fb995be) } }
+    },
+    {   /* j * 2^30 * G */
+        { { W64LIT(0x55d5c68da61a76fa), W64LIT(0x598b441dca1554dc),
+            W64LIT(0xd39923b9773b279c), W64LIT(0x33331d3c36bf9efc) },
+          { W64LIT(0x2d4c848e298de399), W64LIT(0xcfdb8e77a1a27f56),
+            W64LIT(0x94c855ea57b8ab70), W64LIT(0xdcdb9dae6f7879ba) } },
+        { { W64LIT(0x4c4f07367f636a38), W64LIT(0x9f943fb70e76d5cb),
+            W64LIT(0xb03510baa8b68b8b), W64LIT(0xc246780a9ed07a1f) },
+          { W64LIT(0x3c0514156d549fc2), W64LIT(0xc2953f31607781ca),
+            W64LIT(0x955e2c69d8d95413), W64LIT(0xb300fadc7bd282e3) } },
+        { { W64LIT(0xa14b1163c27901b4), W64LIT(0xfd9236e0899b8bf3),
+            W64LIT(0x42b091eccbc6da0a), W64LIT(0xbb1dac6f5ad1d297) },
+          { W64LIT(0x80e61d53a91cf76e), W64LIT(0x4110a412d31f1ee7),
+            W64LIT(0x2d87c3ba13efcf77), W64LIT(0x1f374bb4df450d76) } },
+        { { W64LIT(0x202886024147519a), W64LIT(0xd0981eac26b372f0),
+            W64LIT(0xa9d4a7caa785ebc8), W64LIT(0xd953c50ddbdf58e9) },
+          { W64LIT(0x9d6361ccfd590f8f), W64LIT(0x72e9626b44e6c917),
+            W64LIT(0x7fd9611022eb64cf), W64LIT(0x863ebb7e9eb288f3) } },
+        { { W64LIT(0x15e10a0a097e4403), W64LIT(0xcb3d0a8619854665),
+            W64LIT(0x88d8e211d67d4826), W64LIT(0xb39af66e0b9d2839) },
+          { W64LIT(0xa5f94588bd475ca8), W64LIT(0xe06b7966c077b80b),
+            W64LIT(0xfedb1485da27c26c), W64LIT(0xd290d33afe0fd5e0) } },
+        { { W64LIT(0x686202f31306583d), W64LIT(0x05b10da0437c622e),
+            W64LIT(0xbf9aaa0f076a7bc8), W64LIT(0x25e94efb8f8f4e43) },
+          { W64LIT(0x8a35c9b7fa3dc26d), W64LIT(0xe0e5fb9396ff03c5),
+            W64LIT(0xa77e3843ebc394ce), W64LIT(0xcede65958361de60) } },
+        { { W64LIT(0xbf9075090c22b540), W64LIT(0x2cde42aab7c267d4),
+            W64LIT(0xba18f9ed5ab0d693), W64LIT(0x3ba62aa66e4660d9) },
+          { W64LIT(0xb24bf97bab9ea96a), W64LIT(0x5d039642e3b60e32),
+            W64LIT(0x4e6a45067c4d9bd5), W64LIT(0x666c5b9e7ed4a6a4) } },
+        { { W64LIT(0x877b7cf5678a31b0), W64LIT(0xd50301ae3998b620),
+            W64LIT(0x734257c5c00fb396), W64LIT(0xf9fb18a004e672a6) },
+          { W64LIT(0xff8bd8ebe8758851), W64LIT(0x1e64e4c65d99ba44),
+            W64LIT(0x4b8eaedf7dfd93b7), W64LIT(0xba2f2a9804e76b8c) } },
+        { { W64LIT(0xae02a2f09b56ddbd), W64LIT(0x1339b5ac8a2f1cf3),
+            W64LIT(0xf2b569c7839dff0d), W64LIT(0xb0b9e864fee9a43d) },
+          { W64LIT(0x4ff8ca4177bb064e), W64LIT(0x145a2812fd249f63),
+            W64LIT(0x3ab7beacf86f689a), W64LIT(0x9bafec2701d35f5e) } },
+        { { W64LIT(0xbba23fddae57c7b7), W64LIT(0x345342f21b932522),
+            W64LIT(0xfd9c80fe556d4aa3), W64LIT(0xa03907ba6525bb61) },
+          { W64LIT(0x38b010e1ff218933), W64LIT(0xc066b654aa52117b),
+            W64LIT(0x8e14192094f2e6ea), W64LIT(0x66a27dca0d32f2b2) } },
+        { { W64LIT(0xb2e6b121fbabbe92), W64LIT(0x281850fbe1330076),
+            W64LIT(0x093581ec97890015), W64LIT(0x69b1dded75ff77f5) },
+          { W64LIT(0x7cf0b18fab105105), W64LIT(0x953ced31a89ccfef),
+            W64LIT(0x3151f85feb914009), W64LIT(0x3c9f1b8788ed48ad) } },
+        { { W64LIT(0xa18f07e0e90fb21e), W64LIT(0x00fd2b80bba7fca1),
+            W64LIT(0x20387f2795cd67b5), W64LIT(0x5b89a4e7d39707f7) },
+          { W64LIT(0x8f83ad3f894407ce), W64LIT(0xa0025b946c226132),
+            W64LIT(0xc79563c7f906c13b), W64LIT(0x5f548f314e7bb025) } },
+        { { W64LIT(0xff7589494fde0c1f), W64LIT(0xbf8a1abee5b6ec20),
+            W64LIT(0x702278fb87e1db6c), W64LIT(0xc447ad7a35ed658f) },
+          { W64LIT(0x48d4aa3803d0ccf2), W64LIT(0x80acb338819a7c03),
+            W64LIT(0x9bc7c89e6e17cecc), W64LIT(0x46736b8b03be1d82) } },
+        { { W64LIT(0x2126f742d43b5eaa), W64LIT(0x054a0766dfa59b85),
+            W64LIT(0x9d0d5e36126bfd45), W64LIT(0xa1f8fbd7384f8a8f) },
+          { W64LIT(0x317680f5d563fccc), W64LIT(0x48ca5055f280a928),
+            W64LIT(0xe00b81b227b578cf), W64LIT(0x10aad9182994a514) } },
+        { { W64LIT(0xe63f301f358bcdc0), W64LIT(0x07689e990a9d47f8),
+            W64LIT(0x1f689e2f4f43d43a), W64LIT(0x4d542a1690920904) },
+          { W64LIT(0xaea293d59ca0a707), W64LIT(0xd061fe458ac68065),
+            W64LIT(0x1033bf1b0090008c), W64LIT(0x29749558c08a6db6) } },
+        { { W64LIT(0x0ee6d3a7c35d8794), W64LIT(0x042e65580356bae5),
+            W64LIT(0x9f59698d643322fd), W64LIT(0x9379ae1550a61967) },
+          { W64LIT(0x64b9ae62fcc9981e), W64LIT(0xaed3d6316d2934c6),
+            W64LIT(0x2454b3025e4e65eb), W64LIT(0xab09f647f9950428) } }
+    },
+    {   /* j * 2^35 * G */
+        { { W64LIT(0xb2083a1222248acc), W64LIT(0x1f6ec0ef3264e366),
+            W64LIT(0x5659b7045afdee28), W64LIT(0x7a823a40e6430bb5) },
+          { W64LIT(0x24592a04e1900a79), W64LIT(0xcde09d4ac9ee6576),
+            W64LIT(0x52b6463f4b5ea54a), W64LIT(0x1efe9ed3d3ca65a7) } },
+        { { W64LIT(0xe27a6dbe305406dd), W64LIT(0x8eb7dc7fdd5d1957),
+            W64LIT(0xf54a6876387d4d8f), W64LIT(0x9c479409c7762de4) },
+          { W64LIT(0xbe4d5b5d99b30778), W64LIT(0x25380c566e793682),
+            W64LIT(0x602d37f3dac740e3), W64LIT(0x140deabe1566e4ae) } },
+        { { W64LIT(0x4481d067afd32acf), W64LIT(0xd8f0fccae1f71ccf),
+            W64LIT(0xd208dd0cb596f2da), W64LIT(0xd049d7309aad93f9) },
+          { W64LIT(0xc79f263d42ab580e), W64LIT(0x09411bb123f707b4),
+            W64LIT(0x8cfde1ff835e0eda), W64LIT(0x7270749090f03402) } },
+        { { W64LIT(0xeaee6126c49a861e), W64LIT(0x024f3b65e14f0d06),
+            W64LIT(0x51a3f1e8c69bfc17), W64LIT(0xc3c3a8e9a7686381) },
+          { W64LIT(0x3400752cb103d4c8), W64LIT(0x02bc46139218b36b),
+            W64LIT(0xc67f75eb7651504a), W64LIT(0xd6848b56d02aebfa) } },
+        { { W64LIT(0xbd9802e6c30fa92b), W64LIT(0x5a70d96d9a552784),
+            W64LIT(0x9085c4ea3f83169b), W64LIT(0xfa9423bb06908228) },
+          { W64LIT(0x2ffebe12fe97a5b9), W64LIT(0x85da604971b99118),
+            W64LIT(0x9cbc2f7f63178846), W64LIT(0xfd96bc709153218e) } },
+        { { W64LIT(0x958381db1782269b), W64LIT(0xae34bf792597e550),
+            W64LIT(0xbb5c60645f385153), W64LIT(0x6f0e96afe3088048) },
+          { W64LIT(0xbf6a021577884456), W64LIT(0xb3b5688c69310ea7),
+            W64LIT(0x17c9429504fad2de), W64LIT(0xe020f0e517896d4d) } },
+        { { W64LIT(0x730ba0ab0976505f), W64LIT(0x567f6813095e2ec5),
+            W64LIT(0x470620106331ab71), W64LIT(0x72cfa97741d22b9f) },
+          { W64LIT(0x33e55ead8a2373da), W64LIT(0xa8d0d5f47ba45a68),
+            W64LIT(0xba1d8f9c03029d15), W64LIT(0x8f34f1ccfc55b9f3) } },
+        { { W64LIT(0xcca4428dbbe5a1a9), W64LIT(0x8187fd5f3126bd67),
+            W64LIT(0x0036973a48105826), W64LIT(0xa39b6663b8bd61a0) },
+          { W64LIT(0x6d42deef2d65a808), W64LIT(0x4969044f94636b19),
+            W64LIT(0xf611ee47dd5d564c), W64LIT(0x7b2f3a49d2873077) } },
+        { { W64LIT(0x94157d45300eb294), W64LIT(0x2b2a656e169c1494),
+            W64LIT(0xc000dd76d3a47aa9), W64LIT(0xa2864e4fa6243ea4) },
+          { W64LIT(0x82716c47db89842e), W64LIT(0x12dfd7d761479fb7),
+            W64LIT(0x3b9a2c56e0b2f6dc), W64LIT(0x46be862ad7f85d67) } },
+        { { W64LIT(0x03b0d8dd0f82b214), W64LIT(0x460c34f9f103cbc6),
+            W64LIT(0xf32e5c0318d79e19), W64LIT(0x8b8888baa84117f8) },
+          { W64LIT(0x8f3c37dcc0722677), W64LIT(0x10d21be91c1c0f27),
+            W64LIT(0xd47c8468e0f7a0c6), W64LIT(0x9bf02213adecc0e0) } },
+        { { W64LIT(0x0baa7d1242b48b99), W64LIT(0x1bcb665d48424096),
+            W64LIT(0x8b847cd6ebfb5cfb), W64LIT(0x87c2ae569ad4d10d) },
+          { W64LIT(0xf1cbb1220de36726), W64LIT(0xe7043c683fdfbd21),
+            W64LIT(0x4bd0826a4e79d460), W64LIT(0x11f5e5984bd1a2cb) } },
+        { { W64LIT(0x97554160b7fe7b6e), W64LIT(0x7d16189a400a3fb2),
+            W64LIT(0xd73e9beae328ca1e), W64LIT(0x0dd04b97e793d8cc) },
+          { W64LIT(0xa9c83c9b506db8cc), W64LIT(0x5cd47aaecf38814c),
+            W64LIT(0x26fc430db64b45e6), W64LIT(0x079b5499d818ea84) } },
+        { { W64LIT(0xebb01102c1c24a3b), W64LIT(0xca24e5681c161c1a),
+            W64LIT(0x103eea6936f00a4a), W64LIT(0x9ad76ee876176c7b) },
+          { W64LIT(0x97451fc2538e0ff7), W64LIT(0x94f898096604b3b0),
+            W64LIT(0x6311436e3249cfd7), W64LIT(0x27b4a7bd41224f69) } },
+        { { W64LIT(0x03b5d21ae0ac2941), W64LIT(0x279b0254c2d31937),
+            W64LIT(0x3307c052cac992d0), W64LIT(0x6aa7cb92efa8b1f3) },
+          { W64LIT(0x5a1825800d37c7a5), W64LIT(0x13380c37342d5422),
+            W64LIT(0x92ac2d66d5d2ef92), W64LIT(0x035a70c9030c63c6) } },
+        { { W64LIT(0xc16025dd4ce4f152), W64LIT(0x1f419a71f9df7c06),
+            W64LIT(0x6d5b221491e4bb14), W64LIT(0xfc43c6cc839fb4ce) },
+          { W64LIT(0x49f06591925d6b2d), W64LIT(0x4b37d9d362186598),
+            W64LIT(0x8c54a971d01b1629), W64LIT(0xe1a9c29f51d50e05) } },
+        { { W64LIT(0x5109b78571ba1861), W64LIT(0x48b22d5cd0c8f93d),
+            W64LIT(0xe8fa84a78633bb93), W64LIT(0x53fba6ba5aebbd08) },
+          { W64LIT(0x7ff27df3e5eea7d8), W64LIT(0x521c879668ca7158),
+            W64LIT(0xb9d5133bce6f1a05), W64LIT(0x2d50cd53fd0ebee4) } }
+    },
+    {   /* j * 2^40 * G */
+        { { W64LIT(0x889f6d65533ef217), W64LIT(0x7158c7e4c3ca2e87),
+            W64LIT(0xfb670dfbdc2b4167), W64LIT(0x75910a01844c257f) },
+          { W64LIT(0xf336bf07cf88577d), W64LIT(0x22245250e45e2ace),
+            W64LIT(0x2ed92e8d7ca23d85), W64LIT(0x29f8be4c2b812f58) } },
+        { { W64LIT(0xfbb9b2452133ffd9), W64LIT(0x39a8b2f1830f1a20),
+            W64LIT(0x484bc97dd5a1f52a), W64LIT(0xd6aebf56a40eddf8) },
+          { W64LIT(0x32257acb76ccdac6), W64LIT(0xaf4d36ec1586ff27),
+            W64LIT(0x8eaa8863f8de7dd1), W64LIT(0x0045d5cf88647c16) } },
+        { { W64LIT(0xc51e414351facc61), W64LIT(0xbaf2647de68a25bc),
+            W64LIT(0x8f5271a00ff872ed), W64LIT(0x8f32ef993d2d9659) },
+          { W64LIT(0xca12488c7593cbd4), W64LIT(0xed266c5d02b82fab),
+            W64LIT(0x0a2f78ad14eb3f16), W64LIT(0xc34049484d47afe3) } },
+        { { W64LIT(0xa6f3d574c005979d), W64LIT(0xc2072b426a40e350),
+            W64LIT(0xfca5c1568de2ecf9), W64LIT(0xa8c8bf5ba515344e) },
+          { W64LIT(0x97aee555114df14a), W64LIT(0xd4374a4dfdc5ec6b),
+            W64LIT(0x754cc28f2ca85418), W64LIT(0x71cb9e27d3c41f78) } },
+        { { W64LIT(0x09c1670209470496), W64LIT(0xa489a5edebd23815),
+            W64LIT(0xc4dde4648edd4398), W64LIT(0x3ca7b94a80111696) },
+          { W64LIT(0x3c385d682ad636a4), W64LIT(0x6702702508dc5f1e),
+            W64LIT(0x0c1965deafa21943), W64LIT(0x18666e16610be69e) } },
+        { { W64LIT(0x6792fd350369c8e1), W64LIT(0x9271aa62b9dc843b),
+            W64LIT(0x8711a4b14d02e2ab), W64LIT(0x02b2a3e27ee1a383) },
+          { W64LIT(0xb226e35f0e2b379b), W64LIT(0x3d3de39cd652ab25),
+            W64LIT(0xaca6d4c93b560106), W64LIT(0xeced0cf4c95bd877) } },
+        { { W64LIT(0x45beb4ca2a604b3b), W64LIT(0x56f651843a616762),
+            W64LIT(0xf52f5a70978b806e), W64LIT(0x7aa3978711dc4480) },
+          { W64LIT(0xe13fac2a0e01fabc), W64LIT(0x7c6ee8a5237d99f9),
+            W64LIT(0x251384ee05211ffe), W64LIT(0x4ff6976d1bc9d3eb) } },
+        { { W64LIT(0x8910507903605c39), W64LIT(0xf0843d9ea142c96c),
+            W64LIT(0xf374493416923684), W64LIT(0x732caa2ffa0a2893) },
+          { W64LIT(0xb2e8c27061160170), W64LIT(0xc32788cc437fbaa3),
+            W64LIT(0x39cd818ea6eda3ac), W64LIT(0xe2e942399e2b2e07) } },
+        { { W64LIT(0xdde0492316e043a2), W64LIT(0x98a452611dd3d209),
+            W64LIT(0xeaf9f61bd431ebe8), W64LIT(0x00919f4dbaf56abd) },
+          { W64LIT(0xe42417db6d8774b1), W64LIT(0x5fc5279c58e0e309),
+            W64LIT(0x64aa40613adf81ea), W64LIT(0xef419edabc627c7f) } },
+        { { W64LIT(0x3919759239ef620f), W64LIT(0x9d47284074fa29c4),
+            W64LIT(0x4e428fa39d416d83), W64LIT(0xd1a7c25129f30269) },
+          { W64LIT(0x46076e1cd746218f), W64LIT(0xf3ad6ee8110d967e),
+            W64LIT(0xfbb5f434a00ae61f), W64LIT(0x3cd2c01980d4c929) } },
+        { { W64LIT(0xfa24d0537a4af00f), W64LIT(0x3f938926ca294614),
+            W64LIT(0x0d700c183982182e), W64LIT(0x801334434cc59947) },
+          { W64LIT(0xf0397106ec87c925), W64LIT(0x62bd59fc0ed6665c),
+            W64LIT(0xe8414348c7cca8b5), W64LIT(0x574c76209f9f0a30) } },
+        { { W64LIT(0x6967d39b0260e52a), W64LIT(0xd42585cc90653325),
+            W64LIT(0x0d9bd60521ca7954), W64LIT(0x4fa2087781ed57b3) },
+          { W64LIT(0x60c1eff8e34a0bbe), W64LIT(0x56b0040c84f6ef64),
+            W64LIT(0x28be2b24b1af8483), W64LIT(0xb2278163f5531614) } },
+        { { W64LIT(0x95be42e2bb8b6a07), W64LIT(0x64be74eeca23f86a),
+            W64LIT(0xa73d74fd154ce470), W64LIT(0x1c2d2857d8dc076a) },
+          { W64LIT(0xb1fa1c575a887868), W64LIT(0x38df8e0b3de64818),
+            W64LIT(0xd88e52f9c34e8967), W64LIT(0x274b4f018b4cc76c) } },
+        { { W64LIT(0x59c81ec2c11c208b), W64LIT(0x240207da4e3a7234),
+            W64LIT(0x4957eb80f4a089d8), W64LIT(0xc86960bc2137a072) },
+          { W64LIT(0xde1154fd7f1a932c), W64LIT(0xb517fe74d3f2fa17),
+            W64LIT(0x2d5d94557111c0eb), W64LIT(0x2aa3378980929d36) } },
+        { { W64LIT(0x3f5c05b4f8b7559d), W64LIT(0x0be4c7acfae29200),
+            W64LIT(0xdd6d3ef756532acc), W64LIT(0xf6c3ed87eea7a285) },
+          { W64LIT(0xe463b0a8f46ec59b), W64LIT(0x531d9b14ecea6c83),
+            W64LIT(0x3d6bdbafc2dc836b), W64LIT(0x3ee501e92ab27f0b) } },
+        { { W64LIT(0x8df275455922ac1c), W64LIT(0xa7b3ef5ca52b3f63),
+            W64LIT(0x8e77b21471de57c4), W64LIT(0x31682c10834c008b) },
+          { W64LIT(0xc76824f04bd55d31), W64LIT(0xb6d1c08617b61c71),
+            W64LIT(0x31db0903c2a5089d), W64LIT(0x9c092172184e5d3f) } }
+    },
+    {   /* j * 2^45 * G */
+        { { W64LIT(0x5ace5035ea6c3997), W64LIT(0x54259aaac2610bef),
+            W64LIT(0xef18bb3f3c80dd39), W64LIT(0x6910b95b5fc3fa39) },
+          { W64LIT(0xfce2f51043e09aee), W64LIT(0xced56c9fa7675665),
+            W64LIT(0x10e265acd872db61), W64LIT(0x6982812eae9fce69) } },
+        { { W64LIT(0xb8fa3d931341ed7a), W64LIT(0x4223272ca7b59d49),
+            W64LIT(0x3dcb194783b8c4a4), W64LIT(0x4e413c01ed1302e4) },
+          { W64LIT(0x6d999127e17e44ce), W64LIT(0xee86bf7533b3adfb),
+            W64LIT(0xf6902fe625aa96ca), W64LIT(0xb73540e4e5aae47d) } },
+        { { W64LIT(0xcc50ef6c872b4a60), W64LIT(0xab2a34a44613521b),
+            W64LIT(0x39c5c190983e15d1), W64LIT(0x61dde5df59905512) },
+          { W64LIT(0xe417f6219f2275f3), W64LIT(0x0750c8b6451d894b),
+            W64LIT(0x75b04ab978b0bdaa), W64LIT(0x3bfd9fd4458589bd) } },
+        { { W64LIT(0xaafcbfabaf95894c), W64LIT(0x7b9bdc07276b2241),
+            W64LIT(0xeaf983625bdda48b), W64LIT(0x5977faf2a3fcb4df) },
+          { W64LIT(0xbed042ef052c4b5b), W64LIT(0x9fe87f71067591f0),
+            W64LIT(0xc89c73ca22f24ec7), W64LIT(0x7d37fa9ee64a9f1b) } },
+        { { W64LIT(0xbd78148045ee2f40), W64LIT(0x75e354af416b60cf),
+            W64LIT(0xde0b58a18d49a8c4), W64LIT(0xe40e94e2fa359536) },
+          { W64LIT(0xbd4fa59f62accd76), W64LIT(0x05cf466a8c762837),
+            W64LIT(0xb5abda99448c277b), W64LIT(0x5a9e01bf48b13740) } },
+        { { W64LIT(0xb51e55e6f2606a82), W64LIT(0xe25f706190f2fb57),
+            W64LIT(0xacef6c2ab1a4e37c), W64LIT(0x864e359d5dcf2706) },
+          { W64LIT(0x479e6b187ce57316), W64LIT(0x2cab25003a96b23d),
+            W64LIT(0xed4898628ef16df7), W64LIT(0x2056538cef3758b5) } },
+        { { W64LIT(0xef69a0c3d41d3bd3), W64LIT(0xb533b8c907a26bde),
+            W64LIT(0xe2801d97db2edf9f), W64LIT(0xdc4a8269e1877af0) },
+          { W64LIT(0x6c1c58513d590dbe), W64LIT(0x84632f6bee4e9357),
+            W64LIT(0xd36d36b779b33374), W64LIT(0xb46833e39bbca2e6) } },
+        { { W64LIT(0xcc7a64880a750c0f), W64LIT(0x39bacfe34e548e83),
+            W64LIT(0x3d418c760c110f05), W64LIT(0x3e4daa4cb1f11588) },
+          { W64LIT(0x2733e7b55ffc69ff), W64LIT(0x46f147bc92053127),
+            W64LIT(0x885b2434d722df94), W64LIT(0x6a444f65e6fc6b7c) } },
+        { { W64LIT(0x008be4bb346ac9cb), W64LIT(0x2e6cb02429811bb2),
+            W64LIT(0xa6ccc747f41540c1), W64LIT(0xf119334efbf6de47) },
+          { W64LIT(0x4e6bffe9cc97fe6e), W64LIT(0x7f4b578bf3d82883),
+            W64LIT(0x459db722753dd1c7), W64LIT(0x05843cd82066b495) } },
+        { { W64LIT(0x7cb88cd5dbf2af33), W64LIT(0xded9566eaf6b0eab),
+            W64LIT(0xd1caf5488e40d844), W64LIT(0x3ae59bd67ce1f67f) },
+          { W64LIT(0xacf4ad33dd82429e), W64LIT(0xcc7ebd2bbc4467c7),
+            W64LIT(0xf4f6e95de783d011), W64LIT(0x5197e39116e92db7) } },
+        { { W64LIT(0xd4f2031885e7a4af), W64LIT(0x291bf9a0f7a6878d),
+            W64LIT(0xadd8b6eebd051913), W64LIT(0x174f5124f36be034) },
+          { W64LIT(0x2ac3364527f60189), W64LIT(0xd8902eed8b37ec73),
+            W64LIT(0x546166a11cfdb42e), W64LIT(0x31c4e3b807076421) } },
+        { { W64LIT(0x7de29dfdbc6ebdfb), W64LIT(0xa1ee450589de549b),
+            W64LIT(0xfd7181aa3ef26a64), W64LIT(0x003179eedf2f3980) },
+          { W64LIT(0x1bce4d30fd71bc78), W64LIT(0xeb842b14be86a583),
+            W64LIT(0xe00125dc5eb85711), W64LIT(0x9f586983ff11f405) } },
+        { { W64LIT(0x5b5a089eb833eccb), W64LIT(0xc1b3077a7bc51c79),
+            W64LIT(0xe581157f9fbe0e93), W64LIT(0xab487d695b29b172) },
+          { W64LIT(0xc72551082222f24b), W64LIT(0x338cd22cf6dd35df),
+            W64LIT(0x92010e6f5fc24afe), W64LIT(0xf8298f15681d46ed) } },
+        { { W64LIT(0x2ce7f723042389ed), W64LIT(0xdf7de0d5a54b1972),
+            W64LIT(0xb8ea2e142c251d75), W64LIT(0xd22a4d37f4e8e8c8) },
+          { W64LIT(0xe99958566c29c8bc), W64LIT(0x9fefdbfe1d1e201e),
+            W64LIT(0xb97d946edac885c9), W64LIT(0xf6ea9767d38eac70) } },
+        { { W64LIT(0x9aaca8e974e75a2e), W64LIT(0xcda6fc1eadac968f),
+            W64LIT(0x3f6651bf46306bef), W64LIT(0xc7445e4ecb2ed7f9) },
+          { W64LIT(0x584a12d8d1571ac1), W64LIT(0x684846c4daf3a679),
+            W64LIT(0xcfc622a9863fbc43), W64LIT(0x2f9e101dea6814f2) } },
+        { { W64LIT(0x7a1a465ac3f16ea8), W64LIT(0x115a461db2f1d11c),
+            W64LIT(0x4767dd956c68a172), W64LIT(0x3392f2ebd13a4698) },
+          { W64LIT(0xc7a99ccde526cdc7), W64LIT(0x8e537fdc22292b81),
+            W64LIT(0x76d8cf69a6d39198), W64LIT(0xffc5ff432446852d) } }
+    },
+    {   /* j * 2^50 * G */
+        { { W64LIT(0x97b14f7ea90567e6), W64LIT(0x513257b7b6ae5cb7),
+            W64LIT(0x85454a3c9f10903d), W64LIT(0xd8d2c9ad69bc3724) },
+          { W64LIT(0x38da93246b29cb44), W64LIT(0xb540a21d77c8cbac),
+            W64LIT(0x9bbfe43501918e42), W64LIT(0xfffa707a56c3614e) } },
+        { { W64LIT(0x56c2e05b1cb76219), W64LIT(0x0ec0bf9171567e7e),
+            W64LIT(0xe7076f8661c4c910), W64LIT(0xd67b085bbabc04d9) },
+          { W64LIT(0x9fb904595e93a96a), W64LIT(0x7526c1eafbdc249a),
+            W64LIT(0x0d44d367ecdd0bb7), W64LIT(0x953999179dc0d695) } },
+        { { W64LIT(0x2ccbc583a4c506ec), W64LIT(0x957ed188d1acfe97),
+            W64LIT(0x8baed83312f1aea2), W64LIT(0xef2a6cb48325362d) },
+          { W64LIT(0x130dde428e195c43), W64LIT(0xc842025a0e6050c6),
+            W64LIT(0x2da972a708686a5d), W64LIT(0xb52999a1e508b4a8) } },
+        { { W64LIT(0x83f49167ceca9754), W64LIT(0x426d2cf64b7939a0),
+            W64LIT(0x2555e355723fd0bf), W64LIT(0xa96e6d06c4f144e2) },
+          { W64LIT(0x4768a8dd87880e61), W64LIT(0x15543815e508e4d5),
+            W64LIT(0x09d7e772b1b65e15), W64LIT(0x63439dd6ac302fa0) } },
+        { { W64LIT(0xb11df8e1698e04cc), W64LIT(0x877be203169005c8),
+            W64LIT(0x32749e8c4f3c6179), W64LIT(0x2dbc9d0a7853fc05) },
+          { W64LIT(0x187d4f939454d937), W64LIT(0xe682ce9db4800e1b),
+            W64LIT(0xa9129ad8165e68e8), W64LIT(0x0fe29735be7f785b) } },
+        { { W64LIT(0x31019ccf3a4434b4), W64LIT(0xa34581111a7954dc),
+            W64LIT(0xa9dac80de34972a7), W64LIT(0xb043d05474f6b8dd) },
+          { W64LIT(0x021c319e11137b1a), W64LIT(0x00a754ceed5cc03f),
+            W64LIT(0x0aa2c794cbea5ad4), W64LIT(0x093e67f470c015b6) } },
+        { { W64LIT(0x20ac0351d598d710), W64LIT(0x272c4166cb3a4da4),
+            W64LIT(0xdb82fe1aca71de1f), W64LIT(0x746e79f2d8f54b0f) },
+          { W64LIT(0x6e7fc7364b573e9b), W64LIT(0x75d03f46fd4b5040),
+            W64LIT(0x5c1cc36d0b98d87b), W64LIT(0x513ba3f11f472da1) } },
+        { { W64LIT(0x859d3145983c38b5), W64LIT(0xb14f176c637abc8b),
+            W64LIT(0x2793fb9dcaff7be6), W64LIT(0xebe5a55f35a66a5a) },
+          { W64LIT(0x7cec1dcd9f87dc59), W64LIT(0x7c595cd3fbdbf560),
+            W64LIT(0x5b543b2226eb3257), W64LIT(0x69080646c4c935fd) } },
+        { { W64LIT(0xdca3b70678a6513b), W64LIT(0x92ea4a2a9edb1943),
+            W64LIT(0x02642216db6e2dd8), W64LIT(0x9b45d0b49fd57894) },
+          { W64LIT(0x114e70dbc69d11ae), W64LIT(0x1477dd194c57595f),
+            W64LIT(0xbc2208b4ec77c272), W64LIT(0x95c5b4d7db68f59c) } },
+        { { W64LIT(0xfe541fa47ea67c77), W64LIT(0x952bd2afe3ea810c),
+            W64LIT(0x791fef568d01d374), W64LIT(0xa3a1c6210f11336e) },
+          { W64LIT(0x5ad0d5a9c7ec6d79), W64LIT(0xff7038af3225c342),
+            W64LIT(0x003c6689bc69601b), W64LIT(0x25059bc745e8747d) } },
+        { { W64LIT(0x9a75c80676cb2566), W64LIT(0x8f76acb1b24892d9),
+            W64LIT(0x7ae7b9cc1f08fe45), W64LIT(0x19ef73296a4907d8) },
+          { W64LIT(0x2db4ab715f228bf0), W64LIT(0xf3cdea39817032d7),
+            W64LIT(0x0b1f482edcabe3c0), W64LIT(0x3baf76b4bb86325c) } },
+        { { W64LIT(0x6aac688eadd70482), W64LIT(0x708de92a7b4a4e8a),
+            W64LIT(0x75b6dd73758a6eef), W64LIT(0xea4bf352725b3c43) },
+          { W64LIT(0x10041f2c87912868), W64LIT(0xb1b1be95ef09297a),
+            W64LIT(0x19ae23c5a9f3860a), W64LIT(0xc4f0f839515dcf4b) } },
+        { { W64LIT(0xc71e27bf8538a5c6), W64LIT(0x195c63dd89abff17),
+            W64LIT(0xfd3152851b71e3da), W64LIT(0x9cbdfda7fa680fa0) },
+          { W64LIT(0x9db876ca849d7eab), W64LIT(0xebe2764b3c273271),
+            W64LIT(0x663357e3f208dcea), W64LIT(0x8c5bd833565b1b70) } },
+        { { W64LIT(0x75900d7c2fa4f126), W64LIT(0x08a3b8655c99a232),
+            W64LIT(0x2478b6bfdb25e0c3), W64LIT(0x482cc2c271db2edf) },
+          { W64LIT(0x37df7e645f321bb8), W64LIT(0x8a93821b9a8005b4),
+            W64LIT(0x3fa2f10ccc8c1958), W64LIT(0x0d3322182c269d0a) } },
+        { { W64LIT(0xba5514df3fd165e8), W64LIT(0x499fd6a9061f8811),
+            W64LIT(0x72cd1fe0bfef9f00), W64LIT(0x120a4bb979ad7e8a) },
+          { W64LIT(0xf2ffd0955f4a5ac5), W64LIT(0xcfd174f195a7a2f0),
+            W64LIT(0xd42301ba9d17baf1), W64LIT(0xd2fa487a77f22089) } },
+        { { W64LIT(0xb93452381d531696), W64LIT(0x57201c0088cdde69),
+            W64LIT(0xdde922519a86afc7), W64LIT(0xe3043895bd35cea8) },
+          { W64LIT(0x7608c1e18555970d), W64LIT(0x8267dfa92535935e),
+            W64LIT(0xd4c60a57322ea38b), W64LIT(0xe0bf7977804ef8b5) } }
+    },
+    {   /* j * 2^55 * G */
+        { { W64LIT(0x6233ea68c094dbb5), W64LIT(0xb77d062ed968d410),
+            W64LIT(0x3e719bbc58b3002d), W64LIT(0x68e7dd3d3dc49d58) },
+          { W64LIT(0x8d825740013a5e58), W64LIT(0x213117473c9e3c1b),
+            W64LIT(0x0cb0a2a77c99b6ab), W64LIT(0x5c48a3b3c2f888f2) } },
+        { { W64LIT(0xc7913e91991724f3), W64LIT(0x5eda799c39cbd686),
+            W64LIT(0xddb595c763d4fc1e), W64LIT(0x6b63b80bac4fed54) },
+          { W64LIT(0x6ea0fc697e5fb516), W64LIT(0x737708bad0f1c964),
+            W64LIT(0x9628745f11a92ca5), W64LIT(0x61f379589a86967a) } },
+        { { W64LIT(0x5320fd610979e6b3), W64LIT(0x1d0bd3e593d40723),
+            W64LIT(0x0ac006fcaa80bacc), W64LIT(0xb1d9c60ed2002515) },
+          { W64LIT(0x610e7ed0af780b92), W64LIT(0xf5bf446e80a9ce31),
+            W64LIT(0x441c011d3c20b54b), W64LIT(0x77f76da1191596c3) } },
+        { { W64LIT(0x9af39b2caa665072), W64LIT(0x78322fa4efd324ef),
+            W64LIT(0x3d153394c327bd31), W64LIT(0x81d5f2713129dab0) },
+          { W64LIT(0xc72e0c42f48027f5), W64LIT(0xaa40cdbc8536e717),
+            W64LIT(0xf45a657a2d369d0f), W64LIT(0xb03bbfc4ea7f74e6) } },
+        { { W64LIT(0x7a04d5429b6a42ea), W64LIT(0xfa597e853daf41b9),
+            W64LIT(0x4c58ec27726b0b89), W64LIT(0xed8eb16a030d43de) },
+          { W64LIT(0x65e1e5e1ec9dcf57), W64LIT(0xb7a770c1697cff81),
+            W64LIT(0x1e6d918f9f6e2b22), W64LIT(0x7c277a9ac64e82b7) } },
+        { { W64LIT(0x46a8c4180d738ded), W64LIT(0x6f1a5bb0e0de5729),
+            W64LIT(0xf10230b98ba81675), W64LIT(0x32c6f30c112b33d4) },
+          { W64LIT(0x7559129dd8fffb62), W64LIT(0x6a281b47b459bf05),
+            W64LIT(0x77c1bd3afa3b6776), W64LIT(0x0709b3807829973a) } },
+        { { W64LIT(0x0875e0c1da36cb47), W64LIT(0xfdf5b7cb1e0210f0),
+            W64LIT(0x7e0c7e4d3a3787c8), W64LIT(0xf043f5262b1c741f) },
+          { W64LIT(0x76df1b006d74d72d), W64LIT(0x0514df7338b45ba9),
+            W64LIT(0xaecf7c3e0a6b797a), W64LIT(0x5e30b285ddeaac39) } },
+        { { W64LIT(0x8c26b232a3326505), W64LIT(0x38d69272ee1d41bf),
+            W64LIT(0x0459453effe32afa), W64LIT(0xce8143ad7cb3ea87) },
+          { W64LIT(0x932ec1fa7e6ab666), W64LIT(0x6cd2d23022286264),
+            W64LIT(0x459a46fe6736f8ed), W64LIT(0x50bf0d009eca85bb) } },
+        { { W64LIT(0x15c78f7d605238a5), W64LIT(0xe9d87842448496ab),
+            W64LIT(0xcfcf75d0d210acc1), W64LIT(0x2948f2295c8c14e2) },
+          { W64LIT(0xe81fd76de8daf0cb), W64LIT(0xd02d11e4a03be800),
+            W64LIT(0x0c4df3518778d30c), W64LIT(0x3482bc96965139cb) } },
+        { { W64LIT(0x0b825852877a21ec), W64LIT(0x300414a70f537a94),
+            W64LIT(0x3f1cba4021a9a6a2), W64LIT(0x50824eee76943c00) },
+          { W64LIT(0xa0dbfcecf83cba5d), W64LIT(0xf953814893b4f3c0),
+            W64LIT(0x6174416248f24dd7), W64LIT(0x5322d64de4fb09dd) } },
+        { { W64LIT(0x56b6cf278a448bbc), W64LIT(0x0ca898dfc85251da),
+            W64LIT(0x9082cad836e79b24), W64LIT(0x2e7b9ed31a8e51a7) },
+          { W64LIT(0xdc7d318a43e1c802), W64LIT(0x4750e523cbf8689d),
+            W64LIT(0x9887a072f0071b1a), W64LIT(0x52090f87814bfdc1) } },
+        { { W64LIT(0x574473843d9325f3), W64LIT(0xa9bef2d0f371cb84),
+            W64LIT(0x77d2188ba61e36c5), W64LIT(0xbbd6a7d7c602df72) },
+          { W64LIT(0xba3aa9028f61bc0b), W64LIT(0xf49085ed6ed0b6a1),
+            W64LIT(0x8bc625d6ae6e8298), W64LIT(0x832b0b1da2e9c01d) } },
+        { { W64LIT(0x5bebf2196196bc6e), W64LIT(0x0e66736bef097efd),
+            W64LIT(0x1128f3b8ea87293a), W64LIT(0x2998e4056addfcde) },
+          { W64LIT(0x55cc31b85d16c961), W64LIT(0x87a434e12418f056),
+            W64LIT(0x2e94aaccdc9fe819), W64LIT(0x94a486c1a56490c6) } },
+        { { W64LIT(0xa337c447f1f0ced1), W64LIT(0x800cc7939492dd2b),
+            W64LIT(0x4b93151dbea08efa), W64LIT(0x820cf3f8de0a741e) },
+          { W64LIT(0xff1982dc1c0f7d13), W64LIT(0xef92196084dde6ca),
+            W64LIT(0x1ad7d97245f96ee3), W64LIT(0x319c8dbe29dea0c7) } },
+        { { W64LIT(0x1ff2385bde259ec8), W64LIT(0xf6b0836a30f67b0d),
+            W64LIT(0x04cc65b006661cff), W64LIT(0x467e6358d4230f5c) },
+          { W64LIT(0xce468c802dbed3d3), W64LIT(0x7b984262f1920da6),
+            W64LIT(0x34d257421537479f), W64LIT(0x5c8aa88c87bb8de1) } },
+        { { W64LIT(0xd3ea38717b82b99b), W64LIT(0x75922d4d470eb624),
+            W64LIT(0x8f66ec543b95d466), W64LIT(0x66e673ccbee1e346) },
+          { W64LIT(0x6afe67c4b5f2b89a), W64LIT(0x3de9c1e6290e5cd3),
+            W64LIT(0x8c278bb6310a2ada), W64LIT(0x420fa3840bdb323b) } }
+    },
+    {   /* j * 2^60 * G */
+        { { W64LIT(0x646f96796424c49b), W64LIT(0xf888dfe867c241c9),
+            W64LIT(0xe12d4b9324f68b49), W64LIT(0x9a6b62d8a571df20) },
+          { W64LIT(0x81b4b26d179483cb), W64LIT(0x666f96329511fae2),
+            W64LIT(0xd281b3e4d53aa51f), W64LIT(0x7f96a7657f3dbd16) } },
+        { { W64LIT(0x8553d37c051af62b), W64LIT(0xe9a998eb0bf94496),
+            W64LIT(0xe0844f9fb0d59aa1), W64LIT(0x983fd558e6afb813) },
+          { W64LIT(0x9670c0ca65d69804), W64LIT(0x732b22de6ea5ff2d),
+            W64LIT(0xd7640ba95fd8623b), W64LIT(0x9f619163a6351782) } },
+        { { W64LIT(0xf167b4e0bdefdd4f), W64LIT(0x69958465f366e401),
+            W64LIT(0x5aa368aba73bbec0), W64LIT(0x121487097b240c21) },
+          { W64LIT(0x378c323318969006), W64LIT(0xcb4d73cee1fe53d1),
+            W64LIT(0x5f50a80e130c4361), W64LIT(0xd67f59517ef5212b) } },
+        { { W64LIT(0x332f81088cad38c0), W64LIT(0x471b7e906bd68ae2),
+            W64LIT(0x56ac3fb20d8e27a3), W64LIT(0xb54660db136b4b0d) },
+          { W64LIT(0x123a1e11a6fd8de4), W64LIT(0x44dbffeaa37799ef),
+            W64LIT(0x4540b977ce6ac17c), W64LIT(0x495173a8af60acef) } },
+        { { W64LIT(0xeb4437434573eab0), W64LIT(0x11570dfbd1ac6031),
+            W64LIT(0xf7d9b45b44dd9afd), W64LIT(0xb8066add22067231) },
+          { W64LIT(0x15f92ad8f8a3f0b4), W64LIT(0x9e0e4899e0ace2a2),
+            W64LIT(0xbdcd0aadfab38b80), W64LIT(0x46506ae917020052) } },
+        { { W64LIT(0x429a69f78fca399d), W64LIT(0xfe9e27d20207bb63),
+            W64LIT(0xec655ed68788f582), W64LIT(0xa426d748adb75f6e) },
+          { W64LIT(0x18695c02ca81c66d), W64LIT(0x84fb8d27a531d425),
+            W64LIT(0x3a3a8956deff48ba), W64LIT(0xaf1d0d56766d2247) } },
+        { { W64LIT(0x5a059565352c4b5c), W64LIT(0x49261531590bc3e2),
+            W64LIT(0x809f7521f66f9f5f), W64LIT(0x2baef6bfc70a4a9b) },
+          { W64LIT(0xe7e6fa6509ed3561), W64LIT(0x11370233984b230c),
+            W64LIT(0x2151659bd04cdc69), W64LIT(0xbdb83c63f007d416) } },
+        { { W64LIT(0x9ebb284d391c2a82), W64LIT(0xbcdd4863158308e8),
+            W64LIT(0x006f16ec83f1edca), W64LIT(0xa13e2c37695dc6c8) },
+          { W64LIT(0x2ab756f04a057a87), W64LIT(0xa8765500a6b48f98),
+            W64LIT(0x4252face68651c44), W64LIT(0xa52b540be1765e02) } },
+        { { W64LIT(0xcb35a1a85ca37ff0), W64LIT(0xe1a04f1ccd2f1c8f),
+            W64LIT(0x238816ce15a26112), W64LIT(0xe206a111095b177e) },
+          { W64LIT(0x3c10b6048a424149), W64LIT(0xc6a3f56774752cfb),
+            W64LIT(0xbf16a37a47f1dbb8), W64LIT(0x7c372f9ad31a3dfb) } },
+        { { W64LIT(0x122d05b5c20b4d2a), W64LIT(0xff659cf50c662a67),
+            W64LIT(0xed57c128e8ffc9e9), W64LIT(0x0fbb15859e987683) },
+          { W64LIT(0xadd70df247319a2b), W64LIT(0x4b98baba374be470),
+            W64LIT(0xf03d747356a7b307), W64LIT(0x342e696e3efebf30) } },
+        { { W64LIT(0xf84b48f7864ac537), W64LIT(0x04713409a6940d3d),
+            W64LIT(0x014db22d6174c7ae), W64LIT(0xc73a1c438c213034) },
+          { W64LIT(0x18ac4ea5ffdd93ec), W64LIT(0x724fc7576102783e),
+            W64LIT(0x9fe13fcc91c3e83f), W64LIT(0x92a8c2c8f08f0bf5) } },
+        { { W64LIT(0x7f2e22fd8f67f6de), W64LIT(0xab018833d8693177),
+            W64LIT(0x266d1db6863eca95), W64LIT(0x6bb7732b31b5ef2b) },
+          { W64LIT(0x4fa927c6915f80ce), W64LIT(0x6fa1d6d25f90efd8),
+            W64LIT(0x7bd75de8456b48ad), W64LIT(0xd2cb507a845b6429) } },
+        { { W64LIT(0xa72cf82ae255d7ec), W64LIT(0x52025c23a460e204),
+            W64LIT(0x10ae542d7d5b0a44), W64LIT(0xa85143109305aeda) },
+          { W64LIT(0x958315f5a14bbfe8), W64LIT(0x3f361826385365fe),
+            W64LIT(0xc2b3a36b66d95040), W64LIT(0x12c7b3347cf4eda2) } },
+        { { W64LIT(0xa545b4d1e744119d), W64LIT(0x4c93b169829a71e7),
+            W64LIT(0x2dbb908c6117fcbf), W64LIT(0x4dc97320b35a3d85) },
+          { W64LIT(0x94c04f856bf88105), W64LIT(0x452e1bce1b51bc1f),
+            W64LIT(0x0c41ff50b3013af3), W64LIT(0xf07af445224d7e24) } },
+        { { W64LIT(0xbdb9e57ca3d24f6a), W64LIT(0x8a8246d7f345a763),
+            W64LIT(0x73bd2a6d98cfbb5f), W64LIT(0x1dd8e85e86ed04db) },
+          { W64LIT(0x76f2da42c01f420b), W64LIT(0x7ef0547364407bc7),
+            W64LIT(0x7e98ba7faff548f5), W64LIT(0x6b7afbeefd30b64a) } },
+        { { W64LIT(0x4f922fc516a0d2bb), W64LIT(0x0d5cc16c1a623499),
+            W64LIT(0x9241cf3a57c62c8b), W64LIT(0x2f5e6961fd1b667f) },
+          { W64LIT(0x5c15c70bf5a01797), W64LIT(0x3d20b44d60956192),
+            W64LIT(0x04911b37071fdb52), W64LIT(0xf648f9168d6f0f7b) } }
+    },
+    {   /* j * 2^65 * G */
+        { { W64LIT(0x027cc8b8fac61d9a), W64LIT(0x7d25e062e3c6fe8a),
+            W64LIT(0xe08805bfe5bff503), W64LIT(0x13271e6c6ff632f7) },
+          { W64LIT(0x55dca6c0232f76a5), W64LIT(0x8957c32d701ef426),
+            W64LIT(0xee728bcba10a5178), W64LIT(0x5ea60411b62c5173) } },
+        { { W64LIT(0x9ad5462bb4d8bc50), W64LIT(0x181c0b16a9195770),
+            W64LIT(0xebd4fe1c78412a68), W64LIT(0xae0341bcc0dff48c) },
+          { W64LIT(0xb6bc45cf7003e866), W64LIT(0xf11a6dea8a24a41b),
+            W64LIT(0x5407151ad04c24c2), W64LIT(0x62c9d27dda5b7b68) } },
+        { { W64LIT(0x32865719a8afd30b), W64LIT(0x867983288a826dce),
+            W64LIT(0xdf04e891c4a8fbe0), W64LIT(0xbb6b6e1bebf56ad3) },
+          { W64LIT(0x0a695b11471f1ff0), W64LIT(0xd76c3389be15baf0),
+            W64LIT(0x018edb95be96c43e), W64LIT(0xf2beaaf490794158) } },
+        { { W64LIT(0x0a50b12e523b8bf6), W64LIT(0x8009eb5b8f910c1b),
+            W64LIT(0xf535af824a167588), W64LIT(0x0f835f9cfb2a2abd) },
+          { W64LIT(0xf59b29312afceb62), W64LIT(0xc797df2a169d383f),
+            W64LIT(0xeb3f5fb066ac02b0), W64LIT(0x029d4c6fdaa2d0ca) } },
+        { { W64LIT(0x87a7ebd1e0a1b12a), W64LIT(0x1e4ef88d770ba95f),
+            W64LIT(0x8c33345cdc2ae9cb), W64LIT(0xcecf127601cc8403) },
+          { W64LIT(0x687c012e1b39b80f), W64LIT(0xfd90d0ad35c33ba4),
+            W64LIT(0xa3ef5a675c9661c2), W64LIT(0x368fc88ee017429e) } },
+        { { W64LIT(0xb82226052b7ce542), W64LIT(0xe6d4ce997472bde1),
+            W64LIT(0x53e16ebe09d2f4da), W64LIT(0x180ff42e53b92b2e) },
+          { W64LIT(0xc59bcc022c34a1c6), W64LIT(0x3803d6f9422c46c2),
+            W64LIT(0x18aff74f5c14a8a2), W64LIT(0x55aebf8010a08b28) } },
+        { { W64LIT(0xb956970e2fdd23cc), W64LIT(0xb80288bc5682e971),
+            W64LIT(0xe6e6d91e9ae86ebc), W64LIT(0x0564c83f8c9f1939) },
+          { W64LIT(0x551932a239560368), W64LIT(0xe893752b049c28e2),
+            W64LIT(0x0b03cee5a6a158c3), W64LIT(0xe12d656b04964263) } },
+        { { W64LIT(0x58af2010f5b343bc), W64LIT(0x0f2e400af2f142fe),
+            W64LIT(0x3483bfdea85f4bdf), W64LIT(0xf0b1d09303bfeaa9) },
+          { W64LIT(0x2ea01b95c7081603), W64LIT(0xe943e4c93dba1097),
+            W64LIT(0x47be92adb438f3a6), W64LIT(0x00bb7742e5bf6636) } },
+        { { W64LIT(0x4ed714576be5f7de), W64LIT(0xd93006f8c2263c9e),
+            W64LIT(0xe073694ccacacb36), W64LIT(0x2ff7a5b43ae118ab) },
+          { W64LIT(0x3cce53f1cd871236), W64LIT(0xf156a39dc2aa6d52),
+            W64LIT(0x9cc5f271b198d76d), W64LIT(0xbc615b6f81383d39) } },
+        { { W64LIT(0x137a4fb486df2a61), W64LIT(0xa1ed9c07ecf7b4a2),
+            W64LIT(0xb2e460e27bd042ff), W64LIT(0xb7f5e2fa5f62f5ec) },
+          { W64LIT(0x7aa6ec6bcc2423b7), W64LIT(0x75ce0a7fba63eea7),
+            W64LIT(0x67a45fb1f250a6e1), W64LIT(0x93bc919ce53cdc9f) } },
+        { { W64LIT(0x67930af231f63950), W64LIT(0xa77797c114caa2c9),
+            W64LIT(0x526e80ee27ac7e62), W64LIT(0xe1e6e62658b28aec) },
+          { W64LIT(0x636178b0b3c9fef0), W64LIT(0xaf7752e06d5f90be),
+            W64LIT(0x94ecaf18eece51cf), W64LIT(0x2864d0edca806e1f) } },
+        { { W64LIT(0xec2fccaaddce3345), W64LIT(0x2a6811b7012a4350),
+            W64LIT(0x96760ff1ac598bdc), W64LIT(0x054d652ad1bf4128) },
+          { W64LIT(0x0a1151d492a21005), W64LIT(0xad7f397133110fdf),
+            W64LIT(0x8c95928c1960100f), W64LIT(0x6c91c8257bf03362) } },
+        { { W64LIT(0x17785b7799eb6df0), W64LIT(0x26c3cc517386b779),
+            W64LIT(0x345ed9886417a48e), W64LIT(0xe990b4e407d6ef31) },
+          { W64LIT(0x0f456b7e2586abba), W64LIT(0x239ca6a559c96e9a),
+            W64LIT(0xe327459ce2eb4206), W64LIT(0x3a4c3313a002b90a) } },
+        { { W64LIT(0x19e6125dec3f1dec), W64LIT(0x07b1f040911178da),
+            W64LIT(0xd93ededa904a6738), W64LIT(0x55187a5a0bebedcd) },
+          { W64LIT(0xf7d04722eb329d41), W64LIT(0xf449099ef170b391),
+            W64LIT(0xfd317a69ca99f828), W64LIT(0x50c3db2b34a4976d) } },
+        { { W64LIT(0x3806b69b92222f1f), W64LIT(0x5a2459ca6cf7ae70),
+            W64LIT(0x6789f69ca85217ee), W64LIT(0x5f232b5ee3dc85ac) },
+          { W64LIT(0x660e3ec548e9e516), W64LIT(0x124b4e473197eb31),
+            W64LIT(0x10a0cb13aafcca23), W64LIT(0x7bd63ba48213224f) } },
+        { { W64LIT(0xb674481b7bfe7178), W64LIT(0x4e1debae65405868),
+            W64LIT(0x061b2821c48c867d), W64LIT(0x69c15b35513b30ea) },
+          { W64LIT(0x3b4a166636871088), W64LIT(0xe5e29f5d1220b1ff),
+            W64LIT(0x4b82bb35233d9f4d), W64LIT(0x4e07633318cdc675) } }
+    },
+    {   /* j * 2^70 * G */
+        { { W64LIT(0x0d53f5c7a3e6fced), W64LIT(0xe8cbbdd5f45fbdeb),
+            W64LIT(0xf85c01df13339a70), W64LIT(0x0ff71880142ceb81) },
+          { W64LIT(0x4c4e8774bd70437a), W64LIT(0x5fb32891ba0bda6a),
+            W64LIT(0x1cdbebd2f18bd26e), W64LIT(0x2f9526f103a9d522) } },
+        { { W64LIT(0x40ce305192c4d684), W64LIT(0x8b04d7257612efcd),
+            W64LIT(0xb9dcda366f9cae20), W64LIT(0x0edc4d24f058856c) },
+          { W64LIT(0x64f2e6bf85427900), W64LIT(0x3de81295dc09dfea),
+            W64LIT(0xd41b4487379bf26c), W64LIT(0x50b62c6d6df135a9) } },
+        { { W64LIT(0xd4f8e3b4c72dfe67), W64LIT(0xc416b0f690e19fdf),
+            W64LIT(0x18b9098d4c13bd35), W64LIT(0xac11118a15b8cb9e) },
+          { W64LIT(0xf598a318f0062841), W64LIT(0xbfe0602f89f356f4),
+            W64LIT(0x7ae3637e30177a0c), W64LIT(0x3409774761136537) } },
+        { { W64LIT(0x0db2fb5ed005832a), W64LIT(0x5f5efd3b91042e4f),
+            W64LIT(0x8c4ffdc6ed70f8ca), W64LIT(0xe4645d0bb52da9cc) },
+          { W64LIT(0x9596f58bc9001d1f), W64LIT(0x52c8f0bc4e117205),
+            W64LIT(0xfd4aa0d2e398a084), W64LIT(0x815bfe3a104f49de) } },
+        { { W64LIT(0x97e5443f23885e5f), W64LIT(0xf72f8f99e8433aab),
+            W64LIT(0xbd00b154e4d4e604), W64LIT(0xd0b35e6ae5e173ff) },
+          { W64LIT(0x57b2a0489164722d), W64LIT(0x3e3c665b88761ec8),
+            W64LIT(0x6bdd13973da83832), W64LIT(0x3c8b1a1e73dafe3b) } },
+        { { W64LIT(0x4497ace654317cac), W64LIT(0xbe600ab9521771b3),
+            W64LIT(0xb42e409eb0dfe8b8), W64LIT(0x386a67d73942310f) },
+          { W64LIT(0x25548d8d4431cc28), W64LIT(0xa7cff142985dc524),
+            W64LIT(0x4d60f5a193c4be32), W64LIT(0x83ebd5c8d071c6e1) } },
+        { { W64LIT(0xba3a80a7b1fd2b0b), W64LIT(0x9b3ad3965bec33e8),
+            W64LIT(0xb3868d6179743fb3), W64LIT(0xcfd169fcfdb462fa) },
+          { W64LIT(0xd3b499d79ce0a6af), W64LIT(0x55dc1cf1e42d3ff8),
+            W64LIT(0x04fb9e6cc6c3e1b2), W64LIT(0x47e6961d6f69a474) } },
+        { { W64LIT(0x54eb3acce548b37b), W64LIT(0xb38e754284d40549),
+            W64LIT(0x8c3daa517b341b4f), W64LIT(0x2f6928ec690bf7fa) },
+          { W64LIT(0x0496b32386ce6c41), W64LIT(0x01be1c5510adadcd),
+            W64LIT(0xc04e67e74bb5faf9), W64LIT(0x3cbaf678e15c9985) } },
+        { { W64LIT(0x8cd1214550ca4247), W64LIT(0xba1aa47ae7dd30aa),
+            W64LIT(0x2f81ddf1e58fee24), W64LIT(0x03452936eec9b0e8) },
+          { W64LIT(0x8bdc3b81243aea96), W64LIT(0x9a2919af15c3d0e5),
+            W64LIT(0x9ea640ec10948361), W64LIT(0x5ac86d5b6e0bcccf) } },
+        { { W64LIT(0xf892d918c36cf440), W64LIT(0xaed3e837c939719c),
+            W64LIT(0xb07b08d2c0218b64), W64LIT(0x6f1bcbbace9790dd) },
+          { W64LIT(0x4a84d6ed60919b8e), W64LIT(0xd89007918ac1f9eb),
+            W64LIT(0xf84941aa0dd5daef), W64LIT(0xb22fe40a67fd62c5) } },
+        { { W64LIT(0x97e15ba2157f2db3), W64LIT(0xbda2fc8f8e28ca9c),
+            W64LIT(0x5d050da437b9f454), W64LIT(0x3d57eb572379d72e) },
+          { W64LIT(0xe9b5eba2fb5ee997), W64LIT(0x01648ca2e11538ca),
+            W64LIT(0x32bb76f6f6327974), W64LIT(0x338f14b8ff3f4bb7) } },
+        { { W64LIT(0x524d226ad7ab9a2d), W64LIT(0x9c00090d7dfae958),
+            W64LIT(0x0ba5f5398751d8c2), W64LIT(0x8afcbcdd3ab8262d) },
+          { W64LIT(0x57392729e99d043b), W64LIT(0xef51263baebc943a),
+            W64LIT(0x9feace9320862935), W64LIT(0x639efc03b06c817b) } },
+        { { W64LIT(0x1fe054b366b4be7a), W64LIT(0x3f25a9de84a37a1e),
+            W64LIT(0xf39ef1ad78d75cd9), W64LIT(0xd7b58f495062c1b5) },
+          { W64LIT(0x6f74f9a9ff563436), W64LIT(0xf718ff29e8af51e7),
+            W64LIT(0x5234d31315e97fec), W64LIT(0xb6a8e2b1292f1c0a) } },
+        { { W64LIT(0xa7f53aa8327720c1), W64LIT(0x956ca322ba092cc8),
+            W64LIT(0x8f03d64a28746c4d), W64LIT(0x51fe178266d0d392) },
+          { W64LIT(0xd19b34db3c832c80), W64LIT(0x60dccc5c6da2e3b4),
+            W64LIT(0x245dd62e0a104ccc), W64LIT(0xa7ab1de1620b21fd) } },
+        { { W64LIT(0xb293ae0b3893d123), W64LIT(0xf7b75783b15ee71c),
+            W64LIT(0x5aa3c61442a9468b), W64LIT(0xd686123cdb15d744) },
+          { W64LIT(0x8c616891a7ab4116), W64LIT(0x6fcd72c8a4e6a459),
+            W64LIT(0xac21911077e5fad7), W64LIT(0xfb6a20e7704fa46b) } },
+        { { W64LIT(0xe839be7d341d81dc), W64LIT(0xcddb688932148379),
+            W64LIT(0xda6211a1f7026ead), W64LIT(0xf3b2575ff4d1cc5e) },
+          { W64LIT(0x40cfc8f6a7a73ae6), W64LIT(0x83879a5e61d5b483),
+            W64LIT(0xc5acb1ed41a50ebc), W64LIT(0x59a60cc83c07d8fa) } }
+    },
+    {   /* j * 2^75 * G */
+        { { W64LIT(0x439530b665c7322d), W64LIT(0xcf12cc01b3c1b3fb),
+            W64LIT(0xc70b01860172f685), W64LIT(0xb915ee221b58391d) },
+          { W64LIT(0x9afdf03ba317db24), W64LIT(0x87dec65917b8ffc4),
+            W64LIT(0x7f46597be4d3d050), W64LIT(0x80a1c1ed006500e7) } },
+        { { W64LIT(0x3e22a7b397acf4ec), W64LIT(0x0426c4005ea8b640),
+            W64LIT(0x5e3295a64e969285), W64LIT(0x22aabc59a6a45670) },
+          { W64LIT(0xb929714c5f5942bc), W64LIT(0x9a6168bdfa3182ed),
+            W64LIT(0x2216a665104152ba), W64LIT(0x46908d03b6926368) } },
+        { { W64LIT(0x52cb8ac6c2babcc1), W64LIT(0x4748d448fe81ae8d),
+            W64LIT(0x5844f03f80f1a711), W64LIT(0x3db784b2f8df4ac4) },
+          { W64LIT(0xad918f122df1fe36), W64LIT(0xe40f25b9f33cc7c0),
+            W64LIT(0x4700d0e73b5e5555), W64LIT(0x5c28fa08b03326f9) } },
+        { { W64LIT(0xa9f5d8745a1251fb), W64LIT(0x967747a8c72725c7),
+            W64LIT(0x195c33e531ffe89e), W64LIT(0x609d210fe964935e) },
+          { W64LIT(0xcafd6ca82fe12227), W64LIT(0xaf9b5b960426469d),
+            W64LIT(0x2e9ee04c5693183c), W64LIT(0x1084a333c8146fef) } },
+        { { W64LIT(0x56dab1c8321a518c), W64LIT(0xfd4439a68bce226f),
+            W64LIT(0xe0b30d194facb9fa), W64LIT(0xb5052f307583571b) },
+          { W64LIT(0x1442641012afd476), W64LIT(0xd02e417203fe624a),
+            W64LIT(0xfc394f65531c92e6), W64LIT(0x16d4bf5ad4bc0b52) } },
+        { { W64LIT(0xce06b88210395755), W64LIT(0x117ce6345ec1df80),
+            W64LIT(0xfefae513eff55e96), W64LIT(0xcf36cba6fd7fed1e) },
+          { W64LIT(0x7340eca9a40ebf88), W64LIT(0xe6ec1bcfb3d37e12),
+            W64LIT(0xca51b64e86bbf9ff), W64LIT(0x4e0dbb588b40e05e) } },
+        { { W64LIT(0x120ad0bf5f8b8a84), W64LIT(0xbfa00f36866f3ede),
+            W64LIT(0xa8c6064ec30ebc2c), W64LIT(0xc39e40b823001e3b) },
+          { W64LIT(0x9614f7cde7b1cbab), W64LIT(0xcd4420c704a56284),
+            W64LIT(0x8446a8f316857a19), W64LIT(0x519b93b1e6f706cb) } },
+        { { W64LIT(0x96649933aed1d1f7), W64LIT(0x566eaff350563090),
+            W64LIT(0x345057f0ad2e39cf), W64LIT(0x148ff65b1f832124) },
+          { W64LIT(0x042e89d4cf94cf0d), W64LIT(0x319bec84520c58b3),
+            W64LIT(0x2a2676265361aa0d), W64LIT(0xc86fa3028fbc87ad) } },
+        { { W64LIT(0x3805e5b80863b664), W64LIT(0x8be7ac6b3cabdb53),
+            W64LIT(0x9f7d70505dfeff91), W64LIT(0x7dea8bd095896206) },
+          { W64LIT(0x28005a3b410e3c4e), W64LIT(0x24a4f0e9bc603ebf),
+            W64LIT(0xcc4fd5ae4aec15d2), W64LIT(0x4dc253f80f96641d) } },
+        { { W64LIT(0x359d7b9c7ea2ee34), W64LIT(0x3fd0d94c09cc3a71),
+            W64LIT(0xbb53c31c3a1ea37a), W64LIT(0x533425facf818c87) },
+          { W64LIT(0x7cd199c3810156e0), W64LIT(0x0ea020e430c16448),
+            W64LIT(0xe557ba094a642542), W64LIT(0xe657e7e79465f5ea) } },
+        { { W64LIT(0xea723ad1fbc82439), W64LIT(0xc726868bf896e9fd),
+            W64LIT(0xd97c913c511c33ff), W64LIT(0x8a3fa8e2e2114231) },
+          { W64LIT(0x2a6c0e5608445b3e), W64LIT(0x2c4cd884f8d098d3),
+            W64LIT(0x7bf51faf2fea77d4), W64LIT(0x709f208a7b1c4f71) } },
+        { { W64LIT(0xfc83d2ab5c8b06d5), W64LIT(0xb1a785a2fe4eac46),
+            W64LIT(0xb99315bc846f7779), W64LIT(0xcf31d816ef9ea505) },
+          { W64LIT(0x2391fe6a15d7dc85), W64LIT(0x2f132b04b4016b33),
+            W64LIT(0x29547fe3181cb4c7), W64LIT(0xdb66d8a6650155a1) } },
+        { { W64LIT(0x5b9e4843f45aac50), W64LIT(0xc31e042e91eaaad0),
+            W64LIT(0x6e8c0b345a54eea0), W64LIT(0xf0437b94962c7a57) },
+          { W64LIT(0xe4531ce8fe1d348b), W64LIT(0xe1489378e3786432),
+            W64LIT(0xd5e19c4a3f510d38), W64LIT(0x4df3f016ce348b00) } },
+        { { W64LIT(0x59cd0e8b593d070f), W64LIT(0x437575165255625d),
+            W64LIT(0x551fdda75b7a0399), W64LIT(0x7bb6e6b02dec1eeb) },
+          { W64LIT(0x729bb662334c0922), W64LIT(0x3df631df0cf41b79),
+            W64LIT(0x01abf3c578f32402), W64LIT(0xfcb4666c9cd33c88) } },
+        { { W64LIT(0xb805b445735e843c), W64LIT(0x2a8e890d97379134),
+            W64LIT(0xebc7c10c52ab9f87), W64LIT(0xcbb5e1ecb80a92b6) },
+          { W64LIT(0xd6ada2d9dc2c4efe), W64LIT(0xfccf504eae8cc7bd),
+            W64LIT(0x650115acb2418a74), W64LIT(0x8dd90e06c52bd80c) } },
+        { { W64LIT(0x6b66d7e1adc1696f), W64LIT(0x98ebe5930acd72d0),
+            W64LIT(0x65f24550cc1b7435), W64LIT(0xce231393b4b9a5ec) },
+          { W64LIT(0x234a22d4db067df9), W64LIT(0x98dda095caff9b00),
+            W64LIT(0x1bbc75a06100c9c1), W64LIT(0x1560a9c8939cf695) } }
+    },
+    {   /* j * 2^80 * G */
+        { { W64LIT(0xe4050f1cf1c367ca), W64LIT(0x9bc85a9bc90fbc7d),
+            W64LIT(0xa373c4a2e1a11032), W64LIT(0xb64232b7ad0393a9) },
+          { W64LIT(0xf5577eb0167dad29), W64LIT(0x1604f30194b78ab2),
+            W64LIT(0x0baa94afe829348b), W64LIT(0x77fbd8dd41654342) } },
+        { { W64LIT(0x31f14802fcf0a7fd), W64LIT(0x42fd07895488b01e),
+            W64LIT(0x71d78d6d9952b498), W64LIT(0x8eb572d907ac5201) },
+          { W64LIT(0xe0a2a44c4d194a88), W64LIT(0xd2b63fd9ba017e66),
+            W64LIT(0x78efc6c8f888aefc), W64LIT(0xb76f6bda4a881a11) } },
+        { { W64LIT(0xa2f7932c68af43ee), W64LIT(0x5502468e703d00bd),
+            W64LIT(0xe5dc978f2fb061f5), W64LIT(0xc9a1904a28c815ad) },
+          { W64LIT(0xd3af538d470c56a4), W64LIT(0x159abc5f193d8ced),
+            W64LIT(0x2a37245f20108ef3), W64LIT(0xfa17081e223f7178) } },
+        { { W64LIT(0x1fe2a9b2b4b4b67c), W64LIT(0xc1d10df0e8020604),
+            W64LIT(0x9d64abfcbc8058d8), W64LIT(0x8943b9b2712a0fbb) },
+          { W64LIT(0x90eed9143b3def04), W64LIT(0x85ab3aa24ce775ff),
+            W64LIT(0x605fd4ca7bbc9040), W64LIT(0x8b34a564e2c75dfb) } },
+        { { W64LIT(0x5c18acf88e2f7d90), W64LIT(0xfdbf33d777be32cd),
+            W64LIT(0x0a085cd7d2eb5ee9), W64LIT(0x2d702cfbb3201115) },
+          { W64LIT(0xb6e0ebdb85c88ce8), W64LIT(0x23a3ce3c1e01d617),
+            W64LIT(0x3041618e567333ac), W64LIT(0x9dd0fd8f157edb6b) } },
+        { { W64LIT(0xb2b2610798fa7aaa), W64LIT(0x41209ee4f073aa4e),
+            W64LIT(0xf1570359f2d6b19b), W64LIT(0xcbe6868cfc577caf) },
+          { W64LIT(0x186c4bdc32c04dd3), W64LIT(0xa6c35faecfeee397),
+            W64LIT(0xb4a1b312f086c0cf), W64LIT(0xe0a5ccc6d9461fe2) } },
+        { { W64LIT(0x516ff3a36fa6110c), W64LIT(0x74fb1eb1fb93561f),
+            W64LIT(0x6c0c90478457522b), W64LIT(0xcfd321046bb8bdc6) },
+          { W64LIT(0x2d6884a2cc80ad57), W64LIT(0x7c27fc3586a9b637),
+            W64LIT(0x3461baedadf4e8cd), W64LIT(0x1d56251a617242f0) } },
+        { { W64LIT(0xb84011a9431dd80e), W64LIT(0xeb7c7cca73306cd9),
+            W64LIT(0x20fadd29d1b3b730), W64LIT(0x83858b5bfe37b3d3) },
+          { W64LIT(0xbf4cd193b6251d5c), W64LIT(0x1cca1fd31352d952),
+            W64LIT(0xc66157a490fbc051), W64LIT(0x7990a63889b98636) } },
+        { { W64LIT(0x892c81a321175ec1), W64LIT(0x9159a505ee018109),
+            W64LIT(0xc70130532d8be316), W64LIT(0x76060c21426fa2e5) },
+          { W64LIT(0x074d2dfc6b6f0f22), W64LIT(0x9725fc64ca01a671),
+            W64LIT(0x3f6679b92770bd8e), W64LIT(0x8fe6604fd7c9b3fe) } },
+        { { W64LIT(0xce711154b6e00a84), W64LIT(0xd9fe7e4224890e60),
+            W64LIT(0xd10bc6c34560988f), W64LIT(0xbdc2ef526859b004) },
+          { W64LIT(0xdcf0d868d5c890ee), W64LIT(0x893115e6119c47dc),
+            W64LIT(0xe97966fbee714567), W64LIT(0x117813355c85aa53) } },
+        { { W64LIT(0x71d530cc73204349), W64LIT(0xc9df473d94a0679c),
+            W64LIT(0xc572f0014261e031), W64LIT(0x9786b71f22f135fe) },
+          { W64LIT(0xed6505fa6b64e56f), W64LIT(0xe2fb48e905219c46),
+            W64LIT(0x0dbec45bedf53d71), W64LIT(0xd7d782f2c589f406) } },
+        { { W64LIT(0x350fb66b73ed0966), W64LIT(0x968e4b082886032b),
+            W64LIT(0x5a16ed6e88390493), W64LIT(0x0a83ce84a121edbe) },
+          { W64LIT(0x7c86fc10a3d9cda0), W64LIT(0x5a40a6d595ce67fb),
+            W64LIT(0x6cb8cda7f937dbf6), W64LIT(0x95b44768651f6283) } },
+        { { W64LIT(0x06513c8a446cd7f4), W64LIT(0x158c423b906d52a6),
+            W64LIT(0x71503261c423866c), W64LIT(0x4b96f57093c148ee) },
+          { W64LIT(0x5daf9cc7239a8523), W64LIT(0x611b597695ac4b8b),
+            W64LIT(0xde3981db724bf7f6), W64LIT(0x7e7d0f7867afc443) } },
+        { { W64LIT(0x984f101ed6fc3837), W64LIT(0x340bf99f5e1b3a09),
+            W64LIT(0xbb96036f06942626), W64LIT(0x7bc878ab0c7da618) },
+          { W64LIT(0xb37416441c6fb035), W64LIT(0xc65bd5aea182fe9f),
+            W64LIT(0x1b9c2fb86cc7a67a), W64LIT(0x8d1b19af5ce68d7d) } },
+        { { W64LIT(0x3d1ab80c8ce59954), W64LIT(0x742c5a9478222ac0),
+            W64LIT(0x3ddacbf894f878dd), W64LIT(0xfc085117e7d54a99) },
+          { W64LIT(0xfb0f1dfa21e38ec2), W64LIT(0x1c7b59cb16f4ff7f),
+            W64LIT(0x988752397ea888fe), W64LIT(0x705d270cb10dc889) } },
+        { { W64LIT(0xe5aa692a87dec0e1), W64LIT(0x010ded8df7b39d00),
+            W64LIT(0x7b1b80c854cfa0b5), W64LIT(0x66beb876a0f8ea28) },
+          { W64LIT(0x50d7f5313476cd0e), W64LIT(0xa63d0e65b08d3949),
+            W64LIT(0x1a09eea953479fc6), W64LIT(0x82ae9891f499e742) } }
+    },
+    {   /* j * 2^85 * G */
+        { { W64LIT(0xab58b9105ca7d866), W64LIT(0x582967e23adb3b34),
+            W64LIT(0x89ae4447cceac0bc), W64LIT(0x919c667c7bf56af5) },
+          { W64LIT(0x9aec17b160f5dcd7), W64LIT(0xec697b9fddcaadbc),
+            W64LIT(0x0b98f341463467f5), W64LIT(0xb187f1f7a967132f) } },
+        { { W64LIT(0xeb5ddcb6ec7fae9f), W64LIT(0x995f2714efb66e5a),
+            W64LIT(0xdee95d8e69445d52), W64LIT(0x1b6c2d4609e27620) },
+          { W64LIT(0x32621c318129d716), W64LIT(0xb03909f10958c1aa),
+            W64LIT(0x8c468ef91af4af63), W64LIT(0x162c429ffba5cdf6) } },
+        { { W64LIT(0xe8cb5eef9c053df7), W64LIT(0x8de25b37b300ea6f),
+            W64LIT(0xdb03fa92c849cffb), W64LIT(0x242e43a7e84169bb) },
+          { W64LIT(0xe4fa51f4dd6f958e), W64LIT(0x6925a77ff4445a8d),
+            W64LIT(0xe6e72a50e90d8949), W64LIT(0xc66648e32b1f6390) } },
+        { { W64LIT(0x6c3b96f31711ebec), W64LIT(0x2da40f1fce98fdc4),
+            W64LIT(0xb99774d357b4411f), W64LIT(0x87c8bdf415b65bb6) },
+          { W64LIT(0xda3a89e3c2eef12d), W64LIT(0xde95bb9b3c7471f3),
+            W64LIT(0x600f225bd812c594), W64LIT(0x54907c5d2b75a56b) } },
+        { { W64LIT(0x699e4d2945c1dd53), W64LIT(0xcadc5898231debb5),
+            W64LIT(0xdf49fcc7a77f00e0), W64LIT(0x93057bbfa73e5a0e) },
+          { W64LIT(0x2f8b7ecd027a4cd1), W64LIT(0x114734b3c614011a),
+            W64LIT(0xe7a01db767677c68), W64LIT(0x89d9be5e7e273f4f) } },
+        { { W64LIT(0xe0deee5931fba239), W64LIT(0xf47424d398bd91d1),
+            W64LIT(0x0f8886f4071a3c1d), W64LIT(0x3f7d41e8a819233b) },
+          { W64LIT(0x708623c2cf6eb998), W64LIT(0x86bb49af609a287f),
+            W64LIT(0x942bb24963c90762), W64LIT(0x0ef6eea555a9654b) } },
+        { { W64LIT(0x4add4a2e649d4e57), W64LIT(0xcd53a2b01917526e),
+            W64LIT(0xc526233020b44ac4), W64LIT(0x4028746abaa2c31d) },
+          { W64LIT(0x5131839064291d4c), W64LIT(0xbf48f151ee5ad909),
+            W64LIT(0xcce57f597b185681), W64LIT(0x7c3ac1b04854d442) } },
+        { { W64LIT(0xa80d1db6f79588c0), W64LIT(0xfa52fc69b55768cc),
+            W64LIT(0x0b4df1ae7f54438a), W64LIT(0x0cadd1a7f9b46a4f) },
+          { W64LIT(0xb40ea6b31803dd6f), W64LIT(0x488e4fa555eaae35),
+            W64LIT(0x9f047d55382e4e16), W64LIT(0xc9b5b7e02f6e0c98) } },
+        { { W64LIT(0xc19972d0b611c24b), W64LIT(0x1d468e6560a8f351),
+            W64LIT(0xeb7580697bcf6421), W64LIT(0xec9dd0ee88fbc491) },
+          { W64LIT(0x5b59d2bf956c2e32), W64LIT(0x73dc6864dcddf94e),
+            W64LIT(0xfd5e2321bcee7665), W64LIT(0xa7b4f8ef5e9a06c4) } },
+        { { W64LIT(0x03cc8f17cf41c6e8), W64LIT(0xf1f03c2a037b925c),
+            W64LIT(0xc39c19cc66d2427c), W64LIT(0x823d24ba7b6c18e4) },
+          { W64LIT(0x32ef9013901f0b4f), W64LIT(0x684360f1f8941c2e),
+            W64LIT(0x0ebaff522c28092e), W64LIT(0x7891e4e3256c932f) } },
+        { { W64LIT(0x174e8f82d8d38a9b), W64LIT(0x2e97c600e7de1391),
+            W64LIT(0xc5709850a1c175dd), W64LIT(0x969041a032ae5035) },
+          { W64LIT(0xcbfd533b76a2086b), W64LIT(0xd6bba71bd7c2e8fe),
+            W64LIT(0xb2d58ee6099dfb67), W64LIT(0x3a8b342d064a85d9) } },
+        { { W64LIT(0xf83cbf0502f40d9a), W64LIT(0x4681c4682c318a4d),
+            W64LIT(0x985756180e9c2674), W64LIT(0xbe79d0461847092e) },
+          { W64LIT(0xaf1e480a78bd01e0), W64LIT(0x6dd359e472a51db9),
+            W64LIT(0x62ce3821e3afbab6), W64LIT(0xc5cee5b617733199) } },
+        { { W64LIT(0x671ed8fc3b922bf8), W64LIT(0xe4d8c0a04c29b133),
+            W64LIT(0x87eb12393b6e99c4), W64LIT(0xaff3974c8793beba) },
+          { W64LIT(0x037494052c18df9b), W64LIT(0xc5c3a29391007139),
+            W64LIT(0x6a77234fe37a0b95), W64LIT(0x02c29a21b661c96b) } },
+        { { W64LIT(0x5a52fe2e34d74e31), W64LIT(0xa352c3103bf79ab6),
+            W64LIT(0x97ff6c5aabfeeb8f), W64LIT(0xbfbe8feff5c97305) },
+          { W64LIT(0xd6081ce6a7904608), W64LIT(0x1f812f3ac4fca249),
+            W64LIT(0x9b24bc9ab9e5e200), W64LIT(0x91022c6738012ee8) } },
+        { { W64LIT(0x184de7d7cc5f4394), W64LIT(0xb5551b5c4536e142),
+            W64LIT(0x2e89b212d34aa60a), W64LIT(0x14a96feaf50051d5) },
+          { W64LIT(0x4e21ef740d12bb0b), W64LIT(0xc522f02060b9677e),
+            W64LIT(0x8b12e4672df7731d), W64LIT(0x39f803827b326d31) } },
+        { { W64LIT(0xc12738b67c4a658a), W64LIT(0xb3c4763940e72182),
+            W64LIT(0x3b77be468798e44f), W64LIT(0xdc047df217a7f85f) },
+          { W64LIT(0x2439d4c55e59d92d), W64LIT(0xcedca475e8e64d8d),
+            W64LIT(0xa724cd0d87ca9b16), W64LIT(0x35e4fd59a5540dfe) } }
+    },
+    {   /* j * 2^90 * G */
+        { { W64LIT(0x9894344f3a29467a), W64LIT(0xde81e949c51eba6d),
+            W64LIT(0xdaea066ba5e5c2f2), W64LIT(0x3fc8a61408c8c7b3) },
+          { W64LIT(0x7adff88f06d0de9f), W64LIT(0xbbc11cf53b75ce0a),
+            W64LIT(0x9fbb7accfbbc87d5), W64LIT(0xa1458e267badfde2) } },
+        { { W64LIT(0x1cb43668e039c256), W64LIT(0x5f26fb8b7c17fd5d),
+            W64LIT(0xeee426af79aa062b), W64LIT(0x072002d0d78fbf04) },
+          { W64LIT(0x4c9ca237e84fb7e3), W64LIT(0xb401d8a10c82133d),
+            W64LIT(0xaaa525926d7e4181), W64LIT(0xe943083373dbb152) } },
+        { { W64LIT(0x2f5fad1e6ee7c983), W64LIT(0xeb0f9d7cb41328f5),
+            W64LIT(0x9ba68b441d78d5f7), W64LIT(0xa06b3b9e35bc726f) },
+          { W64LIT(0xa2550255593e1ff1), W64LIT(0x552dd43ddfbec115),
+            W64LIT(0x2c48a7abbba8f046), W64LIT(0xd4fc56a3ad0bf133) } },
+        { { W64LIT(0xf92dda31be24319a), W64LIT(0x03f7d28be095a8e7),
+            W64LIT(0xa52fe84098782185), W64LIT(0x276ddafe29c24dbc) },
+          { W64LIT(0x80cd54961d7a64eb), W64LIT(0xe43608897f1dbe42),
+            W64LIT(0x2f81a8778438d2d5), W64LIT(0x7e4d52a885169036) } },
+        { { W64LIT(0x62f21cefba04b5d1), W64LIT(0x9a442707224c7352),
+            W64LIT(0xbf07966c33c6171f), W64LIT(0xdb7ba8911e0816b0) },
+          { W64LIT(0x306fea59033745a9), W64LIT(0x2aacf7e0c0a78f67),
+            W64LIT(0xb5aa3883ad251bf9), W64LIT(0x345aede926bd7086) } },
+        { { W64LIT(0x19e3d5b11d59715d), W64LIT(0xc7eaa762d788983e),
+            W64LIT(0xe5a730b0abf1f248), W64LIT(0xfbab8084fae3fd83) },
+          { W64LIT(0x65e50d2153765b2f), W64LIT(0xbdd4e083fa127f3d),
+            W64LIT(0x9cf3c074397b1b10), W64LIT(0x59f8090cb1b59fd3) } },
+        { { W64LIT(0xdc1de17d98119f10), W64LIT(0x74353c5d488c36a6),
+            W64LIT(0x14aaf33a3d8e23df), W64LIT(0x31e075c078baf593) },
+          { W64LIT(0x0f7ca03a46d1ca3c), W64LIT(0x99c5e3ac47b660c7),
+            W64LIT(0x70d0241388fe2e59), W64LIT(0x2e9a6be12a7ec005) } },
+        { { W64LIT(0x7b15fd9d615faa8f), W64LIT(0x8fa1eb40968554ed),
+            W64LIT(0x7bb4447e7aa44882), W64LIT(0x2bb2d0d1029fff32) },
+          { W64LIT(0x075e2a646caa6d2f), W64LIT(0x8eb879de22e7351b),
+            W64LIT(0xbcd5624e9a506c62), W64LIT(0x218eaef0a87e24dc) } },
+        { { W64LIT(0xac449695241fbd6f), W64LIT(0x67c9b170081c1223),
+            W64LIT(0x16868f21b56aac6f), W64LIT(0x34bd8fa3f8bcb721) },
+          { W64LIT(0x06b6bd33b6691c76), W64LIT(0x6c924766381a7973),
+            W64LIT(0x6a12444ca54078db), W64LIT(0xd02e91a96d1051cc) } },
+        { { W64LIT(0x37e5684744ddfa35), W64LIT(0x9ccfc5c5dab3f747),
+            W64LIT(0x9ac1df3f1ee96cf4), W64LIT(0x0c0571a13b480b8f) },
+          { W64LIT(0x2fbeb3d54b3a7b3c), W64LIT(0x35c036695dcdbb99),
+            W64LIT(0x52a0f5dcb2415b3a), W64LIT(0xd57759b44413ed9a) } },
+        { { W64LIT(0x077379c00b33d3f8), W64LIT(0x421883c67064e409),
+            W64LIT(0x2d0873d76c29c8f6), W64LIT(0xbfa433a3d274c0c8) },
+          { W64LIT(0x56dc778f23a5891e), W64LIT(0xd663bf6535e2de04),
+            W64LIT(0x488fdb485db517ce), W64LIT(0x00bba55e19b226c2) } },
+        { { W64LIT(0x1fe647d83d30a2c5), W64LIT(0x0857f77ef78a81dc),
+            W64LIT(0x11d5a334131a4a9b), W64LIT(0xc0a94af929d393f5) },
+          { W64LIT(0xbc3a5c0bdaa6ec1a), W64LIT(0xba9fe49388d2d7ed),
+            W64LIT(0xbb4335b4bb614797), W64LIT(0x991c4d6872f83533) } },
+        { { W64LIT(0xedbbeee78a058fb6), W64LIT(0xb9d19ddcfb09121a),
+            W64LIT(0xa41bb45bd34dddce), W64LIT(0x2dbc80b900964bc4) },
+          { W64LIT(0x4ed9137d1d6cb654), W64LIT(0x1b9016db483d01c5),
+            W64LIT(0x5fc501bc6528e22e), W64LIT(0xb2d2f8816cad646b) } },
+        { { W64LIT(0x53258c28d2f01cb3), W64LIT(0x93d6eaa3d75db0b1),
+            W64LIT(0x419a2b0de87d0db4), W64LIT(0xa1e48f03d8fe8493) },
+          { W64LIT(0xf747faf6c508b23a), W64LIT(0xf137571a35d53549),
+            W64LIT(0x9f5e58e2fcf9b838), W64LIT(0xc7186ceea7fd3cf5) } },
+        { { W64LIT(0x5e76fb2f286bad39), W64LIT(0xbad9efe39dcad1e2),
+            W64LIT(0x60e75190edc7e904), W64LIT(0x6a6f063e0fecb5a5) },
+          { W64LIT(0x5150ed85aed8acc3), W64LIT(0xb56ccfbc6d20af6c),
+            W64LIT(0x7e0d1e982c69dbfa), W64LIT(0xabf5628a7c7e10a9) } },
+        { { W64LIT(0x77b868cee978a1d3), W64LIT(0xe3a68b337ab92d04),
+            W64LIT(0x5102979487a5b862), W64LIT(0x5f0606c33a61d41d) },
+          { W64LIT(0x2814be276f9326f1), W64LIT(0x2f521c14c6fe3c2e),
+            W64LIT(0x17464d7dacdf7351), W64LIT(0x10f5f9d3777f7e44) } }
+    },
+    {   /* j * 2^95 * G */
+        { { W64LIT(0xb06b1244c5f95cd8), W64LIT(0xda8c8af0f4ab95f4),
+            W64LIT(0x1bae59c2b9e5836d), W64LIT(0x07d51e7e3acffffc) },
+          { W64LIT(0x01e15e6ac2ccbcda), W64LIT(0x3bc1923f8528c3e0),
+            W64LIT(0x43324577a49fead4), W64LIT(0x61a1b8842aa7a711) } },
+        { { W64LIT(0x4fe7ee31b0e63d34), W64LIT(0xf4600572a9e54fab),
+            W64LIT(0xc0493334d5e7b5a4), W64LIT(0x8589fb9206d54831) },
+          { W64LIT(0xaa70f5cc6583553a), W64LIT(0x0879094ae25649e5),
+            W64LIT(0xcc90450710044652), W64LIT(0xebb0696d02541c4f) } },
+        { { W64LIT(0x172a5247d95ea168), W64LIT(0x1758fada2970764a),
+            W64LIT(0xac803a511d978169), W64LIT(0x299cfe2ede77e01b) },
+          { W64LIT(0x652a1e17b0a98927), W64LIT(0x2e26e1d120014495),
+            W64LIT(0x7ae0af9f7175b56a), W64LIT(0xc2e22a80d64b9f95) } },
+        { { W64LIT(0x758c1a3ea2dee7a6), W64LIT(0xdcde2f3c734b2284),
+            W64LIT(0xaba445d24eaba6ad), W64LIT(0x35aaf66876cee0a7) },
+          { W64LIT(0x7e0b04a9e5aa049a), W64LIT(0xe74083ad91103e84),
+            W64LIT(0xbeb183ce40afecc3), W64LIT(0x6b89de9fea043f7a) } },
+        { { W64LIT(0xafbfb1eda4f7e665), W64LIT(0x403cce6aa23df8e7),
+            W64LIT(0xb49cc83f1312c2f4), W64LIT(0xe1cc2366771a9c34) },
+          { W64LIT(0x7ab6a6c0db92faac), W64LIT(0xacd15e0dec3befe1),
+            W64LIT(0x7f8ed988583a0f36), W64LIT(0x1821de7705f9be09) } },
+        { { W64LIT(0xb99f0e0399375235), W64LIT(0x7614c847b9917970),
+            W64LIT(0xfec93ce9524ec067), W64LIT(0xe40e7bf89b122520) },
+          { W64LIT(0xb5670631ee4c4774), W64LIT(0x6f03847a3b04914c),
+            W64LIT(0xc96e9429dc9dd226), W64LIT(0x43489b6c8c57c1f8) } },
+        { { W64LIT(0x7b9722a5c5f26464), W64LIT(0xca4c3dfba442809a),
+            W64LIT(0x7d10986723644810), W64LIT(0x9e4951723c924f82) },
+          { W64LIT(0xef4a6968a2c5bc14), W64LIT(0x750eac4f68de6b7a),
+            W64LIT(0x4e01884d52a2cbb5), W64LIT(0xac40830af4a5f446) } },
+        { { W64LIT(0x0e299d23fe67ba66), W64LIT(0x9145076093cf2f34),
+            W64LIT(0xf45b5ea997fcf913), W64LIT(0x5be008438bd7ddda) },
+          { W64LIT(0x358c3e05d53ff04d), W64LIT(0xbf7ccdc35de91ef7),
+            W64LIT(0xad684dbfb69ec1a0), W64LIT(0x367e7cf2801fd997) } },
+        { { W64LIT(0x8c54f1076103adf8), W64LIT(0x2d813d6cbe8e9810),
+            W64LIT(0xb1466fa85fbd3c9b), W64LIT(0x68c65d2240e1ca76) },
+          { W64LIT(0xb81baa40255f9164), W64LIT(0x5b34c3eed1a864b2),
+            W64LIT(0x3602209b122ca141), W64LIT(0xe7d7248e885badeb) } },
+        { { W64LIT(0x46ffd227cc2338fb), W64LIT(0x89ff6fa990e26153),
+            W64LIT(0xbe570779331a0076), W64LIT(0x43d241c506e1f3af) },
+          { W64LIT(0xfdcdb97dde9b62a3), W64LIT(0x6a06e984a0ae30ea),
+            W64LIT(0xc9bf16804fbddf7d), W64LIT(0x170471a2d36163c4) } },
+        { { W64LIT(0xfd23e207a6469d43), W64LIT(0xcb9f5f112f753a85),
+            W64LIT(0xde2625d4fbb5ca72), W64LIT(0x82e4e54ab7b1c78b) },
+          { W64LIT(0x2cd0ca5378b9e814), W64LIT(0xfcd44051125b817a),
+            W64LIT(0xb68f719f30cfd965), W64LIT(0x31644719d848a974) } },
+        { { W64LIT(0xff5ba8ae3113655e), W64LIT(0xfa2c6e2b57b83180),
+            W64LIT(0x1c48271977e0eabe), W64LIT(0xf9f3c555337fea97) },
+          { W64LIT(0x340f7022a42581cb), W64LIT(0xe1de0bc218f710e3),
+            W64LIT(0xee640adef62e5aa8), W64LIT(0x16b2389149428940) } },
+        { { W64LIT(0x5045738f25f653f5), W64LIT(0xe42b8cb83764f635),
+            W64LIT(0xb4f89406dc11ffc3), W64LIT(0x99593144b6b3e4aa) },
+          { W64LIT(0x81c849f3c9740052), W64LIT(0x2c9cf4c155ffc48b),
+            W64LIT(0x6299e52177f67a49), W64LIT(0x5869f6e3c00c6c62) } },
+        { { W64LIT(0x361619e455950cc3), W64LIT(0xc71d665c56b66bb8),
+            W64LIT(0xea034b34afac6d84), W64LIT(0xa987f832e5e4c7e3) },
+          { W64LIT(0xa07427727a79a6a7), W64LIT(0x56e5d017e26d6c23),
+            W64LIT(0x7e50b97638167e10), W64LIT(0xaa6c81efe88aa84e) } },
+        { { W64LIT(0xb84186f75fe01576), W64LIT(0x446e276cdea51395),
+            W64LIT(0xf3c5ef8105f3f8d4), W64LIT(0x3d7f7df674f7f142) },
+          { W64LIT(0x7c69b565f9ef1656), W64LIT(0x87efa4247c414ef6),
+            W64LIT(0xeb7e620d3d292060), W64LIT(0x50b1de346eec21ae) } },
+        { { W64LIT(0x0ca1f3b7b0dc8595), W64LIT(0x27de46089f1d9f2e),
+            W64LIT(0x1af3bf39badd82a7), W64LIT(0x79356a7965862448) },
+          { W64LIT(0xc0602345f5f9a052), W64LIT(0x1a8b0f89139a42f9),
+            W64LIT(0xb53eee42844d40fc), W64LIT(0x93b0bfe54e5b6368) } }
+    },
+    {   /* j * 2^100 * G */
+        { { W64LIT(0x0f893a5dc8de610b), W64LIT(0xe8c515fb67e223ce),
+            W64LIT(0x7774bfa64ead6dc5), W64LIT(0x89d20f95925c728f) },
+          { W64LIT(0x7a1e0966098583ce), W64LIT(0xa2eedb9493f2a7d7),
+            W64LIT(0x1b2820974c304d4a), W64LIT(0x0842e3dac077282d) } },
+        { { W64LIT(0xa1010e9d74cd06ff), W64LIT(0x9c17c7dfaca3eeac),
+            W64LIT(0x74c86cd38063aa2b), W64LIT(0x8595c4b3734614ff) },
+          { W64LIT(0xa3de00ca990f62cc), W64LIT(0xd9bed213ca0c3be5),
+            W64LIT(0x7886078adf8ce9f5), W64LIT(0xddb27ce35cd44444) } },
+        { { W64LIT(0x5a3097befc15aa1e), W64LIT(0x40d12548b54b0745),
+            W64LIT(0x5bad4706519a5f12), W64LIT(0xed03f717a439dee6) },
+          { W64LIT(0x0794bb6c4a02c499), W64LIT(0xf725083dcffe71d2),
+            W64LIT(0x2cad75190f3adcaf), W64LIT(0x7f68ea1c43729310) } },
+        { { W64LIT(0x9c7c581d26ee8382), W64LIT(0xcf17dcc5359d638e),
+            W64LIT(0xee8273abb728ae3d), W64LIT(0x1d112926f821f047) },
+          { W64LIT(0x1149847750491a74), W64LIT(0x687fa761fde0dfb9),
+            W64LIT(0x2c2580227ea435ab), W64LIT(0x6b8bdb9491ce7e3f) } },
+        { { W64LIT(0x9c806d8af7f91d0f), W64LIT(0x3b61b0f1a82a5728),
+            W64LIT(0x4640032d94d76754), W64LIT(0x273eb5de47d834c6) },
+          { W64LIT(0x2988abf77b4e4d53), W64LIT(0xb7ce66bfde401777),
+            W64LIT(0x9fba6b32715071b3), W64LIT(0x82413c24ad3a1a98) } },
+        { { W64LIT(0x75537b7e3cc8ac85), W64LIT(0x8d725f57dd02753b),
+            W64LIT(0xfd05ff64b737df2f), W64LIT(0x55fe8712f6d2531d) },
+          { W64LIT(0x57ce04a96ab6b01c), W64LIT(0x69a02a897cd93724),
+            W64LIT(0x4f82ac35cf86699b), W64LIT(0x8242d3ad9cb4b232) } },
+        { { W64LIT(0x69c435269be47be0), W64LIT(0x323b7dd8cb28fea1),
+            W64LIT(0xfa5538ba3a6c67e5), W64LIT(0xef921d701d378e46) },
+          { W64LIT(0xf92961fc3c4b880e), W64LIT(0x3f6f914e98940a67),
+            W64LIT(0xa990eb0afef0ff39), W64LIT(0xa6c2920ff0eeff9c) } },
+        { { W64LIT(0xb23a03a553fb2b56), W64LIT(0x6ce141e74e057f78),
+            W64LIT(0x796525c389e490d9), W64LIT(0x0bc95725a31a7e75) },
+          { W64LIT(0x1ec567911220fd06), W64LIT(0x716e3a3c408b0bd6),
+            W64LIT(0x31cd6bf7e8ebeba9), W64LIT(0xa7326ca6bee6b670) } },
+        { { W64LIT(0x70b63d32343bf1a9), W64LIT(0x8fd3bd2837d1a6b1),
+            W64LIT(0x0454879c316865b4), W64LIT(0xee959ff6c458efa2) },
+          { W64LIT(0x0461dcf89706dc3f), W64LIT(0x737db0e2164e4b2e),
+            W64LIT(0x092626802f8843c8), W64LIT(0x54498bbc7745e6f6) } },
+        { { W64LIT(0x5341352b5acf6e10), W64LIT(0xc50343fdafe652c3),
+            W64LIT(0x4af3792d18577a7f), W64LIT(0xe1a4c617af16823d) },
+          { W64LIT(0x9b26d0cd33425d0a), W64LIT(0x306399ed9b7bc47f),
+            W64LIT(0x2a792f33706bb20b), W64LIT(0x3121961498111055) } },
+        { { W64LIT(0x4c1f428cd5f30851), W64LIT(0x94dfed272a4f6630),
+            W64LIT(0x4df53772fc5d48a4), W64LIT(0xdd2d5a2f933260ce) },
+          { W64LIT(0x574115bdd44cc7a5), W64LIT(0x4ba6b20dbd12533a),
+            W64LIT(0x30e93cb8243057c9), W64LIT(0x794c486a14de320e) } },
+        { { W64LIT(0x6095355699f241d7), W64LIT(0xee4adbd7001a349d),
+            W64LIT(0x0b35bf6aaa89e491), W64LIT(0x7f0076f4136f7546) },
+          { W64LIT(0xd19a18ba9264da3d), W64LIT(0x6eb2d2cd62a7a28b),
+            W64LIT(0xcdba941f8761c971), W64LIT(0x1550518ba3be4a5d) } },
+        { { W64LIT(0xc232d97302f1cd1e), W64LIT(0xce87eacb1dd212a4),
+            W64LIT(0x6e4c8c73e69802f7), W64LIT(0x12ef02901fffddbd) },
+          { W64LIT(0x941ec74e1bcea6e2), W64LIT(0xd0b540243cb92cbb),
+            W64LIT(0x809fb9d47e8f9d05), W64LIT(0x3bf16159f2992aae) } },
+        { { W64LIT(0xb2497007eafbb1e1), W64LIT(0xd75c9ce6e75b7a93),
+            W64LIT(0x3558352defb68d78), W64LIT(0xa2f26699223f6396) },
+          { W64LIT(0xeb911ecfe469b17a), W64LIT(0x62545779e72d3ec2),
+            W64LIT(0x8ea47de782cb113f), W64LIT(0xebe4b0864e1fa98d) } },
+        { { W64LIT(0xbdb8e675b055cb40), W64LIT(0x898f8e7b977b5167),
+            W64LIT(0xecc65651b82fb863), W64LIT(0x565448146d88f01f) },
+          { W64LIT(0xb0928e95263a75a9), W64LIT(0xcfb6836f1a22fcda),
+            W64LIT(0x651d14db3f3bd37c), W64LIT(0x1d3837fbb6ad4664) } },
+        { { W64LIT(0x20d3c982cf7d62d2), W64LIT(0x1f36e29d23ba8150),
+            W64LIT(0x48ae0bf092763f9e), W64LIT(0x7a527e6b1d3a7007) },
+          { W64LIT(0xb4a89097581a85e3), W64LIT(0x1f1a520fdc158be5),
+            W64LIT(0xf98db37d167d726e), W64LIT(0x8802786e1113e862) } }
+    },
+    {   /* j * 2^105 * G */
+        { { W64LIT(0xefb2149e36f09ab0), W64LIT(0x03f163ca4a10bb5b),
+            W64LIT(0xd029704506e20998), W64LIT(0x56f0af001b5a3bab) },
+          { W64LIT(0x7af4cfec70880e0d), W64LIT(0x7332a66fbe3d913f),
+            W64LIT(0x32e6c84a7eceb4bd), W64LIT(0xedc4a79a9c228f55) } },
+        { { W64LIT(0xc37c7dd0c55c4496), W64LIT(0xa6a9635725bbabd2),
+            W64LIT(0x5b7e63f2add7f363), W64LIT(0x9dce37822e73f1df) },
+          { W64LIT(0xe1e5a16ab2b91f71), W64LIT(0xe44898235ba0163c),
+            W64LIT(0xf2759c32f6e515ad), W64LIT(0xa5e2f1f88615eecf) } },
+        { { W64LIT(0x74519be7abded551), W64LIT(0x03d358b8c8b74410),
+            W64LIT(0x4d00b10b0e10d9a9), W64LIT(0x6392b0b128da52b7) },
+          { W64LIT(0x6744a2980b75c904), W64LIT(0xc305b0aea8f7f96c),
+            W64LIT(0x042e421d182cf932), W64LIT(0xf6fc5d509e4636ca) } },
+        { { W64LIT(0x795847c9d64cc78c), W64LIT(0x6c50621b9b6cb27b),
+            W64LIT(0x07099bf8df8022ab), W64LIT(0x48f862ebc04eda1d) },
+          { W64LIT(0xd12732ede1603c16), W64LIT(0x19a80e0f5c9a9450),
+            W64LIT(0xe2257f54b429b4fc), W64LIT(0x66d3b2c645460515) } },
+        { { W64LIT(0x6ca4f87e822e37be), W64LIT(0x73f237b4253bda4e),
+            W64LIT(0xf747f3a241190aeb), W64LIT(0xf06fa36f804cf284) },
+          { W64LIT(0x0a6bbb6efc621c12), W64LIT(0x5d624b6440b80ec6),
+            W64LIT(0x4b0724257ba556f3), W64LIT(0x7fa0c3543e2d20a8) } },
+        { { W64LIT(0xe921fa31e3229d41), W64LIT(0xa929c65294531bd4),
+            W64LIT(0x84156027a6d38209), W64LIT(0xf3d69f736bdb97bd) },
+          { W64LIT(0x8906d19a16833631), W64LIT(0x68a34c2e03d51be3),
+            W64LIT(0xcb59583b0e511cd8), W64LIT(0x99ce6bfdfdc132a8) } },
+        { { W64LIT(0x3facdaaaffcdb463), W64LIT(0x658bbc1a34a38b08),
+            W64LIT(0x12a801f8f1a9078d), W64LIT(0x1567bcf96ab855de) },
+          { W64LIT(0xe08498e03572359b), W64LIT(0xcf0353e58659e68b),
+            W64LIT(0xbb86e9c87d23807c), W64LIT(0xbc08728d2198e8a2) } },
+        { { W64LIT(0x8de2b7bc453cadd6), W64LIT(0x203900a7bc0bc1f8),
+            W64LIT(0xbcd86e47a6abd3af), W64LIT(0x911cac128502effb) },
+          { W64LIT(0x2d550242ec965469), W64LIT(0x0e9f769229e0017e),
+            W64LIT(0x633f078f65979885), W64LIT(0xfb87d4494cf751ef) } },
+        { { W64LIT(0xe1790e4bfc25419a), W64LIT(0x364672034bff3cfd),
+            W64LIT(0xc8db638625b6e83f), W64LIT(0x6cc69f236cad6fd2) },
+          { W64LIT(0x0219e45a6bc68bb9), W64LIT(0xe43d79b6297f7334),
+            W64LIT(0x7d445368465dc97c), W64LIT(0x4b9eea322a0b949a) } },
+        { { W64LIT(0x1b96c6ba6102d021), W64LIT(0xeaafac782f4461ea),
+            W64LIT(0xd4b85c41c49f19a8), W64LIT(0x275c28e4cf538875) },
+          { W64LIT(0x35451a9ddd2e54e0), W64LIT(0x6991adb50605618b),
+            W64LIT(0x5b8b4bcd7b36cd24), W64LIT(0x372a4f8c56f37216) } },
+        { { W64LIT(0xc890bd73a6a5da60), W64LIT(0x6f083da0dc4c9ff0),
+            W64LIT(0xf4e14d94f0536e57), W64LIT(0xf9ee1edaaaec8243) },
+          { W64LIT(0x571241ec8bdcf8e7), W64LIT(0xa5db82710b041e26),
+            W64LIT(0x9a0b9a99e3fff040), W64LIT(0xcaaf21dd7c271202) } },
+        { { W64LIT(0xb4e2b2e14f0dd2e8), W64LIT(0xe77e7c4f0a377ac7),
+            W64LIT(0x69202c3f0d7a2198), W64LIT(0xf759b7ff28200eb8) },
+          { W64LIT(0xc87526eddcfe314e), W64LIT(0xeb84c52453d5cf99),
+            W64LIT(0xb1b52ace515138b6), W64LIT(0x5aa7ff8c23fca3f4) } },
+        { { W64LIT(0xff0b13c3b9791a26), W64LIT(0x960022dacdd58b16),
+            W64LIT(0xdbd55c9257aad2de), W64LIT(0x3baaaaa3f30fe619) },
+          { W64LIT(0x9a4b23460d881efd), W64LIT(0x506416c046325e2a),
+            W64LIT(0x91381e76035c18d4), W64LIT(0xb3bb68bef27817b0) } },
+        { { W64LIT(0x15bfb8bf5116f937), W64LIT(0x7c64a586c1268943),
+            W64LIT(0x71e25cc38419a2c8), W64LIT(0x9fd6b0c48335f463) },
+          { W64LIT(0x4bf0ba3ce8ee0e0e), W64LIT(0x6f6fba60298c21fa),
+            W64LIT(0x57d57b39ae66bee0), W64LIT(0x292d513022672544) } },
+        { { W64LIT(0xf451105dbab093b3), W64LIT(0x012f59b902839986),
+            W64LIT(0x8a9158023474a89c), W64LIT(0x048c919c2de03e97) },
+          { W64LIT(0xc476a2b591071cd5), W64LIT(0x791ed89a034970a5),
+            W64LIT(0x89bd9042e1b7994b), W64LIT(0x8eaf5179a1057ffd) } },
+        { { W64LIT(0x6066e2a2d551ee10), W64LIT(0x87a8f1d8727e09a6),
+            W64LIT(0x00d08bab2c01148d), W64LIT(0x6da8e4f1424f33fe) },
+          { W64LIT(0x466d17f0cf9a4e71), W64LIT(0xff5020103bf5cb19),
+            W64LIT(0xdccf97d8d062ecc0), W64LIT(0x80c0d9af81d80ac4) } }
+    },
+    {   /* j * 2^110 * G */
+        { { W64LIT(0x98857ceb1bf4581c), W64LIT(0xe635e186aca7b166),
+            W64LIT(0x278ddd22659722ac), W64LIT(0xa0903c4c1db68007) },
+          { W64LIT(0x366e458948f21402), W64LIT(0x31b49c14b96abda2),
+            W64LIT(0x329c4b09e0403190), W64LIT(0x97197ca3d29f43fe) } },
+        { { W64LIT(0x03e2de1cf3480d4a), W64LIT(0xf0d8edc7bc8acf1a),
+            W64LIT(0xf23e330368295a9c), W64LIT(0xfadd5f68c546a97d) },
+          { W64LIT(0x895597ad96f8acb1), W64LIT(0xbddd49d5671bdae2),
+            W64LIT(0x16fcd52821dd43f4), W64LIT(0xa5a454126619141a) } },
+        { { W64LIT(0xfa32c79f439f29cf), W64LIT(0x7bf321c04dd82a3b),
+            W64LIT(0xff127f54eaa2c1b1), W64LIT(0xa8365f2df35e9618) },
+          { W64LIT(0x852d29024d0ef8dd), W64LIT(0x395ce2c159228c4a),
+            W64LIT(0xb69f44e8215afed3), W64LIT(0x16c1f898b27458e3) } },
+        { { W64LIT(0x8ce9b6bfc360e25a), W64LIT(0xe6425195075a1a78),
+            W64LIT(0x9dc756a8481732f4), W64LIT(0x83c0440f5432b57a) },
+          { W64LIT(0xc670b3f1d720281f), W64LIT(0x2205910ed135e051),
+            W64LIT(0xded14b0edb052be7), W64LIT(0x697b3d27c568ea39) } },
+        { { W64LIT(0xdef29005dc453233), W64LIT(0xc208c47a2fac4bcf),
+            W64LIT(0x6057a3feac3d55ac), W64LIT(0x1723725d902c1207) },
+          { W64LIT(0x9c31c62733eb0fec), W64LIT(0x4913ccdbbb3c63bb),
+            W64LIT(0x113e542b07305838), W64LIT(0x9d48e72a310c2d97) } },
+        { { W64LIT(0x54424ec4d9bbeb3d), W64LIT(0x34ceafe3d7b2921c),
+            W64LIT(0x5e68022e296d37c5), W64LIT(0xa28e0a2b359f16b0) },
+          { W64LIT(0xfdd82dd9bc3f9d73), W64LIT(0x6939a8f9baf3e1ff),
+            W64LIT(0x55cff45c31736dc4), W64LIT(0x910f56427892e8e7) } },
+        { { W64LIT(0xde09b349dfe39260), W64LIT(0x984612f773549093),
+            W64LIT(0x7cede28167853b02), W64LIT(0x7d809bb429d17703) },
+          { W64LIT(0x450b6bfb2756c4f0), W64LIT(0xc59ff9ba93f02b80),
+            W64LIT(0x3e69545720ad9561), W64LIT(0x0c7cf0be3331e2c7) } },
+        { { W64LIT(0x2e599b9afb3ff9ed), W64LIT(0x28c2e0ab17f6515c),
+            W64LIT(0x1cbee4fd474da449), W64LIT(0x071279a44f364452) },
+          { W64LIT(0x97abff6601fbe855), W64LIT(0x3ee394e85fda51c4),
+            W64LIT(0x190385f667597c0b), W64LIT(0x6e9fccc6a27ee34b) } },
+        { { W64LIT(0xced2d419362fb228), W64LIT(0x894637c206aa0be4),
+            W64LIT(0x7a4fc55eb294b197), W64LIT(0xd9cbac1cfd4ca1e8) },
+          { W64LIT(0x068b74800ccdb6ce), W64LIT(0xca4c556580dfaa49),
+            W64LIT(0xe835382176033b78), W64LIT(0x35db7525c5ce98a7) } },
+        { { W64LIT(0x8cf5927274fd1997), W64LIT(0x987d2031ffadeb58),
+            W64LIT(0x5647c6c3d4db260c), W64LIT(0xf08bb13b985543be) },
+          { W64LIT(0x566eeb1056fad695), W64LIT(0x39e17dde68334cc7),
+            W64LIT(0x8a97b3bb7ddd1db2), W64LIT(0xf91199d8c1c5a300) } },
+        { { W64LIT(0x402fa437bdc47fe4), W64LIT(0x35bd25234f3751f0),
+            W64LIT(0x8c2281b7cf57d485), W64LIT(0x50083ea58f607cb6) },
+          { W64LIT(0x6f41e480df6d730d), W64LIT(0x1164e47e91bb06a2),
+            W64LIT(0xd9040c22391fb48a), W64LIT(0xe12df251da23dda7) } },
+        { { W64LIT(0x0b89de9314092ebb), W64LIT(0xf17256bd428e240c),
+            W64LIT(0xcf89a7f393d2f064), W64LIT(0x4f57841ee1ed3b14) },
+          { W64LIT(0x4ee14405e708d855), W64LIT(0x856aae7203f1c3d0),
+            W64LIT(0xc8e5424fbdd7eed5), W64LIT(0x3333e4ef73ab4270) } },
+        { { W64LIT(0xf9cf2b5148f835b1), W64LIT(0x4a70faf32adaaba8),
+            W64LIT(0xa0d2e24fed7beade), W64LIT(0x2b1e4e6715f04032) },
+          { W64LIT(0xeadbc0b91fb3ceee), W64LIT(0xb817b0863a54b0b4),
+            W64LIT(0x14a787257fd4a188), W64LIT(0xff13304623482e60) } },
+        { { W64LIT(0x312012ec4efe42dc), W64LIT(0x7251b2c2c664b2bc),
+            W64LIT(0x996c2e6b798f9cb9), W64LIT(0x3543376a3b8f3465) },
+          { W64LIT(0x337ae8416fbfb6a9), W64LIT(0xe0893a840cb91a03),
+            W64LIT(0x53744e9d7b02d855), W64LIT(0x7e673186206d473f) } },
+        { { W64LIT(0x9509996f3ef143db), W64LIT(0x9cf1e82e399378bc),
+            W64LIT(0xb59cd09b0b8ccc89), W64LIT(0x64b4a2fc52cda6be) },
+          { W64LIT(0xd3bda8b31bcd55df), W64LIT(0xfec4e87d2507cb37),
+            W64LIT(0x3d48a85eb610e49b), W64LIT(0x02fbe1bd1f9cc445) } },
+        { { W64LIT(0x3bc77adedda492f8), W64LIT(0xc11a3aea78297205),
+            W64LIT(0x5e89a3e734931b4c), W64LIT(0x17512e2e9f5694bb) },
+          { W64LIT(0x5dc349f3177bf8b6), W64LIT(0x232ea4ba08c7ff3e),
+            W64LIT(0x9c4f9d16f511145d), W64LIT(0xccf109a333b379c3) } }
+    },
+    {   /* j * 2^115 * G */
+        { { W64LIT(0x60e2857080eb24a9), W64LIT(0x7bedfb4d488e0cfd),
+            W64LIT(0x721ebbd7c259cdb8), W64LIT(0x0b0da855bc6390a9) },
+          { W64LIT(0x2b4d04dbde314c70), W64LIT(0xcdbf1fbc6c32e846),
+            W64LIT(0x33833eabb162fc9e), W64LIT(0x9939b48bb0dd3ab7) } },
+        { { W64LIT(0x96892c1f711b0eb9), W64LIT(0xb905f2c8780ab954),
+            W64LIT(0xace26309a20792db), W64LIT(0xec8ac9b30684e126) },
+          { W64LIT(0x486ad8b6b40a2447), W64LIT(0x60121fc19fe3fb24),
+            W64LIT(0x5626fccf1a8e3b3f), W64LIT(0x4e5686226ad1f394) } },
+        { { W64LIT(0x5cfbbb22236f4a98), W64LIT(0x0b0c59e9066800bb),
+            W64LIT(0x4ac69a8f5a9a7774), W64LIT(0x2b33f804d6bec948) },
+          { W64LIT(0xb372929532e6c466), W64LIT(0x68956d0f4e599c73),
+            W64LIT(0xa47a249f155c31cc), W64LIT(0x24d80f0de1ce284e) } },
+        { { W64LIT(0x5a4b46c64a8a3d62), W64LIT(0x8469c4d0247743d2),
+            W64LIT(0x2bb3a13d88f7e433), W64LIT(0x62b23a1001be5849) },
+          { W64LIT(0xe83596b4a63d1a4c), W64LIT(0x454e7fea7d183f3e),
+            W64LIT(0x643fce6117afb01c), W64LIT(0x4e65e5e61c4c3638) } },
+        { { W64LIT(0xb7e830e3dc09508b), W64LIT(0xfaf6d2cf74317655),
+            W64LIT(0x72606cebdf690355), W64LIT(0x48bb92b3d0c3ded6) },
+          { W64LIT(0x65b754845c7cf892), W64LIT(0xf6cd7ac9d5d5f01f),
+            W64LIT(0xc2c30a5996401d69), W64LIT(0x91268650ed921878) } },
+        { { W64LIT(0xe5db77176add8545), W64LIT(0x1b71cb6672c49b66),
+            W64LIT(0xd856073968421d77), W64LIT(0x03840fe883e3afea) },
+          { W64LIT(0xb391dad51ec69977), W64LIT(0xae243fb9307f6726),
+            W64LIT(0xc88ac87be8ca160c), W64LIT(0x5174cced4ce355f4) } },
+        { { W64LIT(0x752067f8ff81578e), W64LIT(0x786221509045447d),
+            W64LIT(0xc0c22fcf0505aa6f), W64LIT(0x1030f0a66bed1c77) },
+          { W64LIT(0x31f29f151f0bd739), W64LIT(0x2d7989c7e6debe85),
+            W64LIT(0x5c070e728e677e98), W64LIT(0x0a817bd306e81fd5) } },
+        { { W64LIT(0xc1e17eb6cbc613e5), W64LIT(0x33131d55497ea61c),
+            W64LIT(0x2f69d39eaf7eded5), W64LIT(0x73c2f434de6af11b) },
+          { W64LIT(0x4ca52493a4a375fa), W64LIT(0x5f06787cb833c5c2),
+            W64LIT(0x814e091f3e6e71cf), W64LIT(0x76451f578b746666) } },
+        { { W64LIT(0x01c7e082e1539388), W64LIT(0xfd286f30759a9c6b),
+            W64LIT(0x94581041176bacfb), W64LIT(0xe580f07c3bc3de53) },
+          { W64LIT(0xdcdb6f75884d772f), W64LIT(0xd75c3bb840bb9d4f),
+            W64LIT(0xdc6c2e4edb083011), W64LIT(0xe18789a2cd9c298d) } },
+        { { W64LIT(0x5ee6ab8495fe1347), W64LIT(0xab0f6c396f24503c),
+            W64LIT(0x807e3ffb4486dd6b), W64LIT(0xf00b6c748002fef5) },
+          { W64LIT(0x48bff9a6a7862999), W64LIT(0x85e5a06cbed89e26),
+            W64LIT(0x86d311af3d8419eb), W64LIT(0x24f3ad7834733f16) } },
+        { { W64LIT(0x5e20551311820d44), W64LIT(0x0c651bcc86c4473a),
+            W64LIT(0x1d230c2b9bd80eef), W64LIT(0x042c4a1207515be5) },
+          { W64LIT(0x42517ca0bfe9e284), W64LIT(0xe8f605782369827a),
+            W64LIT(0x184f04f01638699d), W64LIT(0x174618edf2bc6d05) } },
+        { { W64LIT(0x5e3e03fc6c68d687), W64LIT(0x3e732c3d1ff052c7),
+            W64LIT(0xf2d0efa66ed16e7a), W64LIT(0x63d92b26b65bb746) },
+          { W64LIT(0xffcd82badd44867c), W64LIT(0xa71b4a9ef8c081b8),
+            W64LIT(0x6c1676a7736c8785), W64LIT(0xbe2c06169d8932d0) } },
+        { { W64LIT(0x7bfa1a4b9eca1c9f), W64LIT(0x960bc1dc8ce5e535),
+            W64LIT(0xe267d9f317eec30a), W64LIT(0x06fb89ef6c257d38) },
+          { W64LIT(0x2328999ad364a26d), W64LIT(0x69b794cb26eaab58),
+            W64LIT(0xad28ab1fb85ba596), W64LIT(0x05dcbff356d0aa94) } },
+        { { W64LIT(0x53376d282bcffbc4), W64LIT(0x708817a706eadb7a),
+            W64LIT(0x6ff50e05cd35ae69), W64LIT(0x63b5fb7574bc7fde) },
+          { W64LIT(0x71c9e953e7fe08c4), W64LIT(0xb4d8bfd4f583ca18),
+            W64LIT(0xde8d788245e81c5c), W64LIT(0xa5f5e93ce0474138) } },
+        { { W64LIT(0x426c160f293c9f31), W64LIT(0x8eb56333e864d7a7),
+            W64LIT(0xbe1164023ebbba30), W64LIT(0x64c2bae32fd5a302) },
+          { W64LIT(0x800601e1265aff7b), W64LIT(0x52d8a88066fd4b14),
+            W64LIT(0x5aba20e746075a9c), W64LIT(0xdaa32bf87e1234c6) } },
+        { { W64LIT(0x80f9bdef694db7e0), W64LIT(0xedca8787b9fcddc6),
+            W64LIT(0x51981c3403b8dce1), W64LIT(0x4274dcf170e10ba1) },
+          { W64LIT(0xf72743b86def6d1a), W64LIT(0xd25b1670ebdb1866),
+            W64LIT(0xc4491e8c050c6f58), W64LIT(0x2be2b2ab87fbd7f5) } }
+    },
+    {   /* j * 2^120 * G */
+        { { W64LIT(0x3e0e5c9dd111f8ec), W64LIT(0xbcc33f8db7c4e760),
+            W64LIT(0x702f9a91bd392a51), W64LIT(0x7da4a795c132e92d) },
+          { W64LIT(0x1a0b0ae30bb1151b), W64LIT(0x54febac802e32251),
+            W64LIT(0xea3a5082694e9e78), W64LIT(0xe58ffec1e4fe40b8) } },
+        { { W64LIT(0xfbb8349d29c4120b), W64LIT(0x9f94391fc0d0d915),
+            W64LIT(0xc4074fa75410ba51), W64LIT(0xa66adbf6150a5911) },
+          { W64LIT(0xc164543c34bfca38), W64LIT(0xe0f27560b9e1ccfc),
+            W64LIT(0x99da0f53e820219c), W64LIT(0xe8234498c6b4997a) } },
+        { { W64LIT(0x7b23c513516e19e4), W64LIT(0x56e2e847c5c4d593),
+            W64LIT(0x9f727d735ce71ef6), W64LIT(0x5b6304a6f79a44c5) },
+          { W64LIT(0x6638a7363ab7e433), W64LIT(0x1adea470fe742f83),
+            W64LIT(0xe054b8545b7fc19f), W64LIT(0xf935381aba1d0698) } },
+        { { W64LIT(0xb5504f9d918e4936), W64LIT(0x65035ef6b2513982),
+            W64LIT(0x0553a0c26f4d9cb9), W64LIT(0x6cb10d56bea85509) },
+          { W64LIT(0x48d957b7a242da11), W64LIT(0x16a4d3dd672b7268),
+            W64LIT(0x3d7e637c8502a96b), W64LIT(0x27c7032b730d463b) } },
+        { { W64LIT(0x55366b7d5846426f), W64LIT(0xe7d09e89247d441d),
+            W64LIT(0x510b404d736fbf48), W64LIT(0x7fa003d0e784bd7d) },
+          { W64LIT(0x25f7614f17fd9596), W64LIT(0x49e0e0a135cb98db),
+            W64LIT(0x2c65957b2e83a76a), W64LIT(0x5d40da8dcddbe0f8) } },
+        { { W64LIT(0x37f68bb4a595939d), W64LIT(0x0355647928740217),
+            W64LIT(0x8e740e7c84ad7612), W64LIT(0xd89bc8439044695f) },
+          { W64LIT(0xf7f3da5d85a9184d), W64LIT(0x562563bb9fc0b074),
+            W64LIT(0x06d2e6aaf88a888e), W64LIT(0x612d8643161fbe7c) } },
+        { { W64LIT(0x9fb3bba354530bb2), W64LIT(0xbde3ef77cb0869ea),
+            W64LIT(0x89bc90460b431163), W64LIT(0x4d03d7d2e4819a35) },
+          { W64LIT(0x33ae4f9e43b6a782), W64LIT(0x216db3079c88a686),
+            W64LIT(0x91dd88e000ffedd9), W64LIT(0xb280da9f12bd4840) } },
+        { { W64LIT(0x458f86913e538cd7), W64LIT(0xa7001f6c8e08ad53),
+            W64LIT(0x52b8c6e6bf5d15ff), W64LIT(0x548234a4011215dd) },
+          { W64LIT(0xff5a9d2d3d5b4045), W64LIT(0xb0ffeeb64a904190),
+            W64LIT(0x55a3aca448607f8b), W64LIT(0x8cbd665c30a0672a) } },
+        { { W64LIT(0xa37f3573f37f5937), W64LIT(0xeb0f6c7dd1e4fca5),
+            W64LIT(0x2965a554ac8ab0fc), W64LIT(0x17fbf56c274676ac) },
+          { W64LIT(0x2e2f6bd9acf7d720), W64LIT(0x41fc8f8810224766),
+            W64LIT(0x517a14b385d53bef), W64LIT(0xdae327a57d76a7d1) } },
+        { { W64LIT(0x515d5c891f5f82dc), W64LIT(0x9a7f67d76361079e),
+            W64LIT(0xa8da81e311a35330), W64LIT(0xe44990c44b18be1b) },
+          { W64LIT(0xc7d5ed95af103e59), W64LIT(0xece8aba78dac9261),
+            W64LIT(0xbe82b0999394b8d3), W64LIT(0x6830f09a16adfe83) } },
+        { { W64LIT(0x43c41ac194d7d9b1), W64LIT(0x5bafdd82c82e7f17),
+            W64LIT(0xdf0614c15fda0fca), W64LIT(0x74b043a7a8ae37ad) },
+          { W64LIT(0x3ba6afa19e71734c), W64LIT(0x15d5437e9c450f2e),
+            W64LIT(0x4a5883fe67e242b1), W64LIT(0x5143bdc22c1953c2) } },
+        { { W64LIT(0xa2a9ce7c6b53f5f9), W64LIT(0x642465951b176d99),
+            W64LIT(0xb1298d36b95c081b), W64LIT(0x53505bb81d9a9ee6) },
+          { W64LIT(0x3f6f9e61f2ba70b0), W64LIT(0xd07e16c98afad453),
+            W64LIT(0x9f1694bbe7eb4a6a), W64LIT(0xdfebced93cb0bc8e) } },
+        { { W64LIT(0xc676d7f2b1f3390b), W64LIT(0x9f7a1b8ca5b61272),
+            W64LIT(0x4ebebfc9c2e127a9), W64LIT(0x4602500c5dd997bf) },
+          { W64LIT(0x7f09771c4711230f), W64LIT(0x058eb37c020f09c1),
+            W64LIT(0xab693d4bfee5e38b), W64LIT(0x9289eb1f4653cbc0) } },
+        { { W64LIT(0xa44d2b391770f5a7), W64LIT(0xe4d4d7910e44eb82),
+            W64LIT(0x42e69d1e3f69712a), W64LIT(0xbf11c4d6ac6a820e) },
+          { W64LIT(0xb5e7f3e542c4224c), W64LIT(0xd6b4e81c449d941c),
+            W64LIT(0x5d72bd165450e878), W64LIT(0x6a61e28aee25ac54) } },
+        { { W64LIT(0x54da9dc7ab952578), W64LIT(0xb5423df226e84d0b),
+            W64LIT(0xa8b64eeb9b872042), W64LIT(0xac2057825990f6df) },
+          { W64LIT(0x4ff696eb21f4c77a), W64LIT(0x1a79c3e4aab273af),
+            W64LIT(0x29bc922e9436b3f1), W64LIT(0xff807ef8d6d9a27a) } },
+        { { W64LIT(0xc7f3a8f833f6746c), W64LIT(0x21e46f65fea990ca),
+            W64LIT(0x915fd5c5caddb0a9), W64LIT(0xbd41f01678614555) },
+          { W64LIT(0x346f4434426ffb58), W64LIT(0x8055943614dbc204),
+            W64LIT(0xf3dd20fe5a969b7f), W64LIT(0x9d59e956e899a39a) } }
+    },
+    {   /* j * 2^125 * G */
+        { { W64LIT(0x3c2f0ba9b733aa5f), W64LIT(0xdece47cbf05af235),
+            W64LIT(0xf8e3f715a2ac82a5), W64LIT(0xc97ba6412203f18a) },
+          { W64LIT(0xc3af550409c11060), W64LIT(0x56ea2c0546af512d),
+            W64LIT(0xfac28daff3f28146), W64LIT(0x87fab43a959ef494) } },
+        { { W64LIT(0x09891641d4c5105f), W64LIT(0x1ae80f8e6d7fbd65),
+            W64LIT(0x9d67225fbee6bdb0), W64LIT(0x3b433b597fc4d860) },
+          { W64LIT(0x44e66db693e85638), W64LIT(0xf7b59252e3e9862f),
+            W64LIT(0xdb785157665c32ec), W64LIT(0x702fefd7ae362f50) } },
+        { { W64LIT(0xfe756a5c97290293), W64LIT(0xbf04a19cd388acbf),
+            W64LIT(0xfbbbb9cf5e916bda), W64LIT(0xf489527391f93bec) },
+          { W64LIT(0xdee07ec32a5923d7), W64LIT(0xc7bc949bfde0c370),
+            W64LIT(0xbd5121750419d8fc), W64LIT(0x54f5d4763fdcc93f) } },
+        { { W64LIT(0x3754475d0fefb0c3), W64LIT(0xd48fb56b46d7c35d),
+            W64LIT(0xa070b633363798a4), W64LIT(0xae89f3d28fdb98e6) },
+          { W64LIT(0x970b89c86363d14c), W64LIT(0x8981752167abd27d),
+            W64LIT(0x9bf7d47444d5a021), W64LIT(0xb3083bafcac72aee) } },
+        { { W64LIT(0x0acda2ffcc5e62e9), W64LIT(0x3b8b7d755edb02a4),
+            W64LIT(0xa700741c66120c76), W64LIT(0xf77e847f7d974064) },
+          { W64LIT(0x0d310678a5e3d464), W64LIT(0xde68b1f346bf35a3),
+            W64LIT(0xcae83028d32f9043), W64LIT(0x724e4717517cb0cb) } },
+        { { W64LIT(0x389741debe949a44), W64LIT(0x638e9388546a4fa5),
+            W64LIT(0x3fe6419ca0047bdc), W64LIT(0x7047f648aaea57ca) },
+          { W64LIT(0x54e48a9041fbab17), W64LIT(0xda8e0b28576bdba2),
+            W64LIT(0xe807eebcc72afddc), W64LIT(0x07d3336df42577bf) } },
+        { { W64LIT(0xfae8563b4f3011db), W64LIT(0xda33776536610c03),
+            W64LIT(0xad4f6f2a6381af0b), W64LIT(0xc277984cd95378ec) },
+          { W64LIT(0x5ab0a10c5751d2b2), W64LIT(0x70a18bb97a4bf3f4),
+            W64LIT(0x38d07ad4eae3caf3), W64LIT(0xe8ef552fec430361) } },
+        { { W64LIT(0x62a8c244bfe20925), W64LIT(0x91c19ac38fdce867),
+            W64LIT(0x5a96a5d5dd387063), W64LIT(0x61d587d421d324f6) },
+          { W64LIT(0xe87673a2a37173ea), W64LIT(0x2384800853778b65),
+            W64LIT(0x10f8441e05bab43e), W64LIT(0xfa11fe124621efbe) } },
+        { { W64LIT(0xedd0389a8391d54b), W64LIT(0xdac74c08c8afe546),
+            W64LIT(0x8525a4ad5be60bbd), W64LIT(0x2419ac9690ad7b87) },
+          { W64LIT(0x078a3a0277eee51b), W64LIT(0xe86ecf367239768d),
+            W64LIT(0xcb0a259d8fd48035), W64LIT(0x94db43cb9d29ca5b) } },
+        { { W64LIT(0x047b772e81685d7b), W64LIT(0x23f27d81bf34a976),
+            W64LIT(0xc27608e2915f48ef), W64LIT(0x3b0b43faa521d5c3) },
+          { W64LIT(0x7613fb2663ca7284), W64LIT(0x7f5729b41d4db837),
+            W64LIT(0x87b14898583b526b), W64LIT(0x00b732a6bbadd3d1) } },
+        { { W64LIT(0x4fffa25b90f8550a), W64LIT(0x254db3d31c8dae9d),
+            W64LIT(0x58cef963c1fbb232), W64LIT(0xad1cb481a4bfdf0f) },
+          { W64LIT(0x84d26ea1958773c2), W64LIT(0x58622664010114f1),
+            W64LIT(0xeadb3a87f051e67e), W64LIT(0xf3185722b69e45c6) } },
+        { { W64LIT(0x8e02f4262048e396), W64LIT(0x436b50b6383d9de4),
+            W64LIT(0xf78d3481471e85ad), W64LIT(0x8b01ea6ad005c8d6) },
+          { W64LIT(0xd3c7afee97015c07), W64LIT(0x46cdf1a94e3ba2ae),
+            W64LIT(0x7a42e50183d3a1d2), W64LIT(0xd54b5268b541dff4) } },
+        { { W64LIT(0xe120c4f948a48e22), W64LIT(0xf24977eed0335a96),
+            W64LIT(0x9af3442336151c7b), W64LIT(0xe2815a7fd36648d8) },
+          { W64LIT(0xb4d2deba66e0a6b2), W64LIT(0x783a84cf817515e8),
+            W64LIT(0x78424c0bff3ff24a), W64LIT(0x12dd1bb638e1c5d9) } },
+        { { W64LIT(0x3f24cf304e23e9bc), W64LIT(0x4387f816126e3624),
+            W64LIT(0x26a46a033b0b6d61), W64LIT(0xaf1bc8458b2d777c) },
+          { W64LIT(0x25c401ba527de79c), W64LIT(0x0e1346d44261bbb6),
+            W64LIT(0x4b96c44b287b4bc7), W64LIT(0x658493c75254562f) } },
+        { { W64LIT(0xfcb0e9d8fdd41d98), W64LIT(0x8be980c1bcc7c7fb),
+            W64LIT(0xa72e86506f8fa4d9), W64LIT(0x356b14ad748cb88d) },
+          { W64LIT(0xfd9fccefea6178f2), W64LIT(0xc84a620d78bb0e35),
+            W64LIT(0xbc75367c62f391a9), W64LIT(0x6a83a5c623100c05) } },
+        { { W64LIT(0x23f949feb8a24a20), W64LIT(0x17ebfed1f52ca53f),
+            W64LIT(0x9b691bbebcfb4853), W64LIT(0x5617ff6b6278a05d) },
+          { W64LIT(0x241b34c5e3c99ebd), W64LIT(0xfc64242e1784156a),
+            W64LIT(0x4206482f695d67df), W64LIT(0xb967ce0eee27c011) } }
+    },
+    {   /* j * 2^130 * G */
+        { { W64LIT(0xb4480f0441c23fa3), W64LIT(0xb4712eb0c1989a2e),
+            W64LIT(0x3ccbba0f93a29ca7), W64LIT(0x6e205c14d619428c) },
+          { W64LIT(0x90db7957b3641686), W64LIT(0x0432691d45ac8b4e),
+            W64LIT(0x07a759acf64e0350), W64LIT(0x0514d89c9c972517) } },
+        { { W64LIT(0xe3b22c6bc4fe3c39), W64LIT(0xba4a81536c7bebdf),
+            W64LIT(0xf23ab6b725693459), W64LIT(0x53bc377014922b11) },
+          { W64LIT(0x4645c8ab5afc60db), W64LIT(0xaa02235520b9f2a3),
+            W64LIT(0x52a2954cce0fc507), W64LIT(0x8c2731bb7ce1c2e7) } },
+        { { W64LIT(0x5066efb6d9790ed6), W64LIT(0xa77a0cbca6aa793b),
+            W64LIT(0x1a915f3c223e042e), W64LIT(0x1c5def0469c5874b) },
+          { W64LIT(0x0e83007873b6c1da), W64LIT(0x55cf85d2fcd8557a),
+            W64LIT(0x0f7c7c760460f3b1), W64LIT(0x87052acb46e58063) } },
+        { { W64LIT(0x6a7091c2e48fb889), W64LIT(0x26882c137b8a9d06),
+            W64LIT(0xa24986631b82a0e2), W64LIT(0x844ed7363518152d) },
+          { W64LIT(0x282f476fd86e27c7), W64LIT(0xa04edaca04afefdc),
+            W64LIT(0x8b256ebc6119e34d), W64LIT(0x56a413e90787d78b) } },
+        { { W64LIT(0x16eab6a20d645fd6), W64LIT(0x632cbd8df61d3148),
+            W64LIT(0xcc1bf7cf62079ae9), W64LIT(0x257ee5c7f33eccbb) },
+          { W64LIT(0xbf6b34a81680ac73), W64LIT(0xaa084e8872c77aa0),
+            W64LIT(0x7b5a864e05a0a1d1), W64LIT(0x0641f6db359a1b16) } },
+        { { W64LIT(0xf01d095dc8385050), W64LIT(0x0d54a5d5df4b441c),
+            W64LIT(0x2a37ccb40927706a), W64LIT(0xdf008f5445d7eb7e) },
+          { W64LIT(0x74eb34f35bf716c7), W64LIT(0x57a65b58641bd6ca),
+            W64LIT(0xef345e4835e6fa02), W64LIT(0x191f913b88342a09) } },
+        { { W64LIT(0x1554d46da670ff1d), W64LIT(0x24833d88cb97a1cc),
+            W64LIT(0x8fa6ab3cded97493), W64LIT(0x215e037189926498) },
+          { W64LIT(0x549bd592e56d74ff), W64LIT(0x58a8caf543b5e1ec),
+            W64LIT(0x3c6087a323e93cb9), W64LIT(0x8b0549875648b83c) } },
+        { { W64LIT(0x82ee061d5a74be50), W64LIT(0xe41781c4dea16ff5),
+            W64LIT(0xe0b0c81e99bfc8a2), W64LIT(0x624f4d690b547e2d) },
+          { W64LIT(0x3a83545dbdcc9ae4), W64LIT(0x2573dbb6409b1e8e),
+            W64LIT(0x482960c4a6c93539), W64LIT(0xf01059ad5ae18798) } },
+        { { W64LIT(0xc431a238013ff83b), W64LIT(0x7c0018b2fad69d08),
+            W64LIT(0x99aeb52a4c9589ea), W64LIT(0x121f41ab9b1cf19f) },
+          { W64LIT(0x0cfbbcbaef0f5958), W64LIT(0x8deb3aeb7be8fbdc),
+            W64LIT(0x12b954081f15aa31), W64LIT(0x5acc09b34c0c06fd) } },
+        { { W64LIT(0x775cbfa86d518ffb), W64LIT(0xdecee1f6930f124b),
+            W64LIT(0x9a402804f5e81d0f), W64LIT(0x0e8225c52a0eeb2f) },
+          { W64LIT(0x884a5d39fee9e867), W64LIT(0x9540428ffb505454),
+            W64LIT(0xb2bf2e20107a70d1), W64LIT(0xd9917c3ba010b2aa) } },
+        { { W64LIT(0xa98f42fa3d843d53), W64LIT(0x33777cc613ef927a),
+            W64LIT(0xc440cdbecb84ca74), W64LIT(0x8c22f9631dc7c5dd) },
+          { W64LIT(0x4bc82b70c8d94708), W64LIT(0x7e0b43fcc814364f),
+            W64LIT(0x286d4e2486f59b7e), W64LIT(0x1abc895e4d6bf4c4) } },
+        { { W64LIT(0x38151e274d559d96), W64LIT(0x4f18c0d3b8db6c01),
+            W64LIT(0x49a3aa836f9921af), W64LIT(0xdbeab27b8c046029) },
+          { W64LIT(0x242b9eaa7040bf3b), W64LIT(0x39c479e51614b091),
+            W64LIT(0x338ede2b0e4baf5d), W64LIT(0x5bb192b7f0a53945) } },
+        { { W64LIT(0x896d572337e440d7), W64LIT(0x685c5fd9ade23f68),
+            W64LIT(0xb5b1a26dc2c64918), W64LIT(0xb9390e30dad6580c) },
+          { W64LIT(0x87911c4e7dee5b9b), W64LIT(0xb90c5053deb04f6e),
+            W64LIT(0x37b942a18f065aa6), W64LIT(0x34acdf2a1ca0928d) } },
+        { { W64LIT(0x733b64d39de40ca3), W64LIT(0x1d4b6d6fd2f3857e),
+            W64LIT(0xbe2be8e9b2ed92f7), W64LIT(0x64ca7047b77da248) },
+          { W64LIT(0xc65dae9b8da99315), W64LIT(0x9c1451750fc698a4),
+            W64LIT(0x8a296b94ff958c27), W64LIT(0x38684e0843950097) } },
+        { { W64LIT(0x7872e34b3390ff23), W64LIT(0x968ce4abde7d18ef),
+            W64LIT(0x9b4a745e627fe7b1), W64LIT(0x9607b0a0caff3e2a) },
+          { W64LIT(0x1b05818eeb40e3a5), W64LIT(0x6ac62204c0fa8d7a),
+            W64LIT(0xb5b9058571ed4809), W64LIT(0xb2432ef0f7cb65f2) } },
+        { { W64LIT(0x715c9f973112795f), W64LIT(0xe8244437984e6ee1),
+            W64LIT(0x55cb4858ecb66bcd), W64LIT(0x7c136735abaffbee) },
+          { W64LIT(0x546615955dbec38e), W64LIT(0x51c0782c388ad153),
+            W64LIT(0x9ba4c53ac6e0952f), W64LIT(0x27e6782a1b21dfa8) } }
+    },
+    {   /* j * 2^135 * G */
+        { { W64LIT(0xfeb09740e2c2bf15), W64LIT(0x627a2205a9e99704),
+            W64LIT(0xec8d73d0c2fbc565), W64LIT(0x223eed8fc20c8de8) },
+          { W64LIT(0x1ee32583a8363b49), W64LIT(0x1a0b6cb9c9c2b0a6),
+            W64LIT(0x49f7c3d290dbc85c), W64LIT(0xa8dfbb971ef4c1ac) } },
+        { { W64LIT(0xc16c236e846e364f), W64LIT(0x7f33527cdea50ca0),
+            W64LIT(0xc48107750926b86d), W64LIT(0x6c2a36090598e70c) },
+          { W64LIT(0xa6755e52f024e924), W64LIT(0xe0fa07a49db4afca),
+            W64LIT(0x15c3ce7d66831790), W64LIT(0x5b4ef350a6cbb0d6) } },
+        { { W64LIT(0x42806b2da6dc1d29), W64LIT(0xd3030009f871e144),
+            W64LIT(0xa1feb333aaf49276), W64LIT(0xb5583b9ec70bc04b) },
+          { W64LIT(0x1db0be7895695f20), W64LIT(0xfc84181189d012b5),
+            W64LIT(0x6409f27205f61643), W64LIT(0x40d34174d5883128) } },
+        { { W64LIT(0x05214c050f15dde9), W64LIT(0xa47a76a80d5f2b82),
+            W64LIT(0xbb254d3062e82b62), W64LIT(0x11a05fe03ec955ee) },
+          { W64LIT(0x7eaff46e9d529b36), W64LIT(0x55ab13018f9e3df6),
+            W64LIT(0xc463e37199317698), W64LIT(0xfd251438ccda47ad) } },
+        { { W64LIT(0x8c3c669c72ba075b), W64LIT(0x89f78b55ba469015),
+            W64LIT(0x5706aade3e9f8ba8), W64LIT(0x6d8bd565b32d7ed7) },
+          { W64LIT(0x25f4e63b805f08d6), W64LIT(0x7f48200dc3bcc1b5),
+            W64LIT(0x4e801968b025d847), W64LIT(0x74afac0487cbe0a8) } },
+        { { W64LIT(0xe2a37598a9d82abf), W64LIT(0x5f188ccbe6c170f5),
+            W64LIT(0x816822005066b087), W64LIT(0xda22c212c7155ada) },
+          { W64LIT(0x151e5d3afbddb479), W64LIT(0x4b606b846d715b99),
+            W64LIT(0x4a73b54bf997cb2e), W64LIT(0x9a1bfe433ecd8b66) } },
+        { { W64LIT(0x79732522cccc18ad), W64LIT(0xaadf3f8df1a6e027),
+            W64LIT(0xf7382c9317c2354d), W64LIT(0x5ce1680cd818b689) },
+          { W64LIT(0x359ebbfcd9ecbee9), W64LIT(0x4330689c1cae62ac),
+            W64LIT(0xb55ce5b4c51ac38a), W64LIT(0x7921dfeafe238ee8) } },
+        { { W64LIT(0xe13122f3dbfb894e), W64LIT(0xbe9b79f6ce274b18),
+            W64LIT(0x85a49de5ca58aadf), W64LIT(0x2495775811487351) },
+          { W64LIT(0x111def61bb939099), W64LIT(0x1d6a974a26d13694),
+            W64LIT(0x4474b4ced3fc253b), W64LIT(0x3a1485e64c5db15e) } },
+        { { W64LIT(0x65994ddb0f5f27ca), W64LIT(0xe85461fba80d59ff),
+            W64LIT(0xff05481a66601023), W64LIT(0xc665427afc9ebbfb) },
+          { W64LIT(0xb0571a697587fd52), W64LIT(0x935289f88d49efce),
+            W64LIT(0x61becc60ea420688), W64LIT(0xb22639d913a786af) } },
+        { { W64LIT(0x5afddab61430c9ab), W64LIT(0x0bdd41d32238e997),
+            W64LIT(0xf0947430418042ae), W64LIT(0x71f9addacdddc4cb) },
+          { W64LIT(0x7090c016c52dd907), W64LIT(0xd9bdf44d29e2047f),
+            W64LIT(0xe6f1fe801b1011a6), W64LIT(0xb63accbcd9acdc78) } },
+        { { W64LIT(0x264c76680448087c), W64LIT(0xac30903f71432dae),
+            W64LIT(0x3851b26600f9bf47), W64LIT(0x400ed3116cdd6d03) },
+          { W64LIT(0x045e79fef8fd2424), W64LIT(0xfdfd974afa6da98b),
+            W64LIT(0x45c9f6410c1e673a), W64LIT(0x76f2e7335b2c5168) } },
+        { { W64LIT(0x7817acab4baef62e), W64LIT(0x9f5a2202a85b91e8),
+            W64LIT(0x9666ebe66ce57610), W64LIT(0x32ad31f3f73bfe03) },
+          { W64LIT(0x628330a425bcf4d6), W64LIT(0xea950593515056e6),
+            W64LIT(0x59811c89e1332156), W64LIT(0xc89cf1fe8c11b2d7) } },
+        { { W64LIT(0x889e5acbc46d7ce1), W64LIT(0x9a515bb78b085877),
+            W64LIT(0xfac1a03d0b7a5050), W64LIT(0x7d3e738af2926035) },
+          { W64LIT(0x861cc2ce2a6cb0eb), W64LIT(0x6f2e29558f7adc79),
+            W64LIT(0x61c4d45133016376), W64LIT(0xd9fd2c805ad59090) } },
+        { { W64LIT(0x0ad7337ac0b7eff3), W64LIT(0x8552225ec5e48b3c),
+            W64LIT(0xe6f78b0c73f13a5f), W64LIT(0x5e70062e82349cbe) },
+          { W64LIT(0x6b8d5048e7073969), W64LIT(0x392d2a29c33cb3d2),
+            W64LIT(0xee4f727c4ecaa20f), W64LIT(0xa068c99e2ccde707) } },
+        { { W64LIT(0x1888d65861a023ef), W64LIT(0x1d72aab4b9e5246e),
+            W64LIT(0xa9a26348e5563ec0), W64LIT(0xa0971963c3439a43) },
+          { W64LIT(0x567dd54badb9b5b7), W64LIT(0x73fac1a1c45a524b),
+            W64LIT(0x8fe97ef7fe38e608), W64LIT(0x608748d23f384f48) } },
+        { { W64LIT(0xebde86ec1ed66f18), W64LIT(0x225d906bd61fce43),
+            W64LIT(0x5cab07d6e8bed74d), W64LIT(0x16e4617f27855ab7) },
+          { W64LIT(0x6568aaddb2fbc3dd), W64LIT(0xedb5484f8aeddf5b),
+            W64LIT(0x878f20e86dcf2fad), W64LIT(0x3516497c615f5699) } }
+    },
+    {   /* j * 2^140 * G */
+        { { W64LIT(0xef0a3fecfa181e69), W64LIT(0x9ea02f8130d69a98),
+            W64LIT(0xb2e9cf8e66eab95d), W64LIT(0x520f2beb24720021) },
+          { W64LIT(0x621c540a1df84361), W64LIT(0x1203772171fa6d5d),
+            W64LIT(0x6e3c7b510ff5f6ff), W64LIT(0x817a069babb2bef3) } },
+        { { W64LIT(0x83572fb6b294cda6), W64LIT(0x6ce9bf75b9039f34),
+            W64LIT(0x20e012f0095cbb21), W64LIT(0xa0aecc1bd063f0da) },
+          { W64LIT(0x57c21c3af02909e5), W64LIT(0xc7d59ecf48ce9cdc),
+            W64LIT(0x2732b8448ae336f8), W64LIT(0x056e37233f4f85f4) } },
+        { { W64LIT(0x8a10b53189e800ca), W64LIT(0x50fe0c17145208fd),
+            W64LIT(0x9e43c0d3b714ba37), W64LIT(0x427d200e34189acc) },
+          { W64LIT(0x05dee24fe616e2c0), W64LIT(0x9c25f4c8ee1854c1),
+            W64LIT(0x4d3222a58f342a73), W64LIT(0x0807804fa027c952) } },
+        { { W64LIT(0xc222653a4f0d56f3), W64LIT(0x961e4047ca28b805),
+            W64LIT(0x2c03f8b04a73434b), W64LIT(0x4c966787ab712a19) },
+          { W64LIT(0xcc196c42864fee42), W64LIT(0xc1be93da5b0ece5c),
+            W64LIT(0xa87d9f22c131c159), W64LIT(0x2bb6d593dce45655) } },
+        { { W64LIT(0x22c49ec9b809b7ce), W64LIT(0x8a41486be2c72c2c),
+            W64LIT(0x813b9420fea0bf36), W64LIT(0xb3d36ee9a66dac69) },
+          { W64LIT(0x6fddc08a328cc987), W64LIT(0x0a3bcd2c3a326461),
+            W64LIT(0x7103c49dd810dbba), W64LIT(0xf9d81a284b78a4c4) } },
+        { { W64LIT(0x3de865ade4d55941), W64LIT(0xdedafa5e30384087),
+            W64LIT(0x6f414abb4ef18b9b), W64LIT(0x9ee9ea42faee5268) },
+          { W64LIT(0x260faa1637a55a4a), W64LIT(0xeb19a514015f93b9),
+            W64LIT(0x51d7ebd29e9c3598), W64LIT(0x523fc56d1932178e) } },
+        { { W64LIT(0x501d070cb98fe684), W64LIT(0xd60fbe9a124a1458),
+            W64LIT(0xa45761c892bc6b3f), W64LIT(0xf5384858fe6f27cb) },
+          { W64LIT(0x4b0271f7b59e763b), W64LIT(0x3d4606a95b5a8e5e),
+            W64LIT(0x1eda5d9b05a48292), W64LIT(0xda7731d0e6fec446) } },
+        { { W64LIT(0xa3e3369390d45871), W64LIT(0xe976404006166d8d),
+            W64LIT(0xb5c3368289a90403), W64LIT(0x4bd1798372f1d637) },
+          { W64LIT(0xa616679ed5d2c53a), W64LIT(0x5ec4bcd8fdcf3b87),
+            W64LIT(0xae6d7613b66a694e), W64LIT(0x7460fc76e3fc27e5) } },
+        { { W64LIT(0x70469b8295caabee), W64LIT(0xde024ca5889501e3),
+            W64LIT(0x6bdadc06076ed265), W64LIT(0x0cb1236b5a0ef8b2) },
+          { W64LIT(0x4065ddbf0972ebf9), W64LIT(0xf1dd387522aca432),
+            W64LIT(0xa88b97cf744aff76), W64LIT(0xd1359afdfe8e3d24) } },
+        { { W64LIT(0x52a3ba2b91502cf3), W64LIT(0x2c3832a8084db75d),
+            W64LIT(0x04a12dddde30b1c9), W64LIT(0x7802eabce31fd60c) },
+          { W64LIT(0x33707327a37fddab), W64LIT(0x65d6f2abfaafa973),
+            W64LIT(0x3525c5b811e6f91a), W64LIT(0x76aeb0c95f46530b) } },
+        { { W64LIT(0xe8815ff62f93a675), W64LIT(0xa6ec968405f48679),
+            W64LIT(0x6dcbb556358ae884), W64LIT(0x0af61472e19e3873) },
+          { W64LIT(0x72334372a5f696be), W64LIT(0xc65e57ea6f22fb70),
+            W64LIT(0x268da30c946cea90), W64LIT(0x136a8a8765681b2a) } },
+        { { W64LIT(0xad5e81dc0f9f44d4), W64LIT(0xf09a69602c46585a),
+            W64LIT(0xd1649164c447d1b1), W64LIT(0x3b4b36c8879dc8b1) },
+          { W64LIT(0x20d4177b3b6b234c), W64LIT(0x096a25051730d9d0),
+            W64LIT(0x0611b9b8ef80531d), W64LIT(0xba904b3b64bb495d) } },
+        { { W64LIT(0x1192d9d493a3147a), W64LIT(0x9f30a5dc9a565545),
+            W64LIT(0x90b1f9cb6ef07212), W64LIT(0x299585460d87fc13) },
+          { W64LIT(0xd3323effc17db9ba), W64LIT(0xcb18548ccb1644a8),
+            W64LIT(0x18a306d44f49ffbc), W64LIT(0x28d658f14c2e8684) } },
+        { { W64LIT(0x44ba60cda99f8c71), W64LIT(0x67b7abdb4bf742ff),
+            W64LIT(0x66310f9c914b3f99), W64LIT(0xae430a32f412c161) },
+          { W64LIT(0x1e6776d388ace52f), W64LIT(0x4bc0fa2452d7067d),
+            W64LIT(0x03c286aa8f07cd1b), W64LIT(0x4cb8f38ca985b2c1) } },
+        { { W64LIT(0x83ccbe808c3bff36), W64LIT(0x005a0bd25263e575),
+            W64LIT(0x460d7dda259bdcd1), W64LIT(0x4a1c5642fa5cab6b) },
+          { W64LIT(0x2b7bdbb99fe4fc88), W64LIT(0x09418e28cc97bbb5),
+            W64LIT(0xd8274fb4a12321ae), W64LIT(0xb137007d5c87b64e) } },
+        { { W64LIT(0x80531fe1c63c4962), W64LIT(0x50541e89981fdb25),
+            W64LIT(0xdc1291a1fd4c2b6b), W64LIT(0xc0693a17a6df4fca) },
+          { W64LIT(0xb2c4604e0117f203), W64LIT(0x245f19630a99b8d0),
+            W64LIT(0xaedc20aac6212c44), W64LIT(0xb1ed4e56520f52a8) } }
+    },
+    {   /* j * 2^145 * G */
+        { { W64LIT(0xb5560fb6700a1acd), W64LIT(0xe823fd73fd999681),
+            W64LIT(0xda915d1f6cb4e1ba), W64LIT(0x0d0301186ebe00a3) },
+          { W64LIT(0x744fb0c989fca8cd), W64LIT(0x970d01dbf9da0e0b),
+            W64LIT(0x0ad8c5647931d76f), W64LIT(0xb15737bff659b96a) } },
+        { { W64LIT(0xa12b384ece53c2d0), W64LIT(0x779d897d5e4606da),
+            W64LIT(0xa53e47b073ec12b0), W64LIT(0x462dbbba5756f1ad) },
+          { W64LIT(0x69fe09f2cafe37b6), W64LIT(0x273d1ebfecce2e17),
+            W64LIT(0x8ac1d5383cf607fd), W64LIT(0x8035f7ff12e10c25) } },
+        { { W64LIT(0xca442d5a2093c22a), W64LIT(0xebd0bd31d5703aed),
+            W64LIT(0x308f2afd653287b6), W64LIT(0x9bb88bac0d1bc8ba) },
+          { W64LIT(0xfbaf853875c1e3b2), W64LIT(0xbd2ac950ca11447c),
+            W64LIT(0x286d816cea5c4c8d), W64LIT(0xdc3aa80028dc3208) } },
+        { { W64LIT(0x854d34c77e6c5520), W64LIT(0xc27df9efdcb9ea58),
+            W64LIT(0x405f2369d686666d), W64LIT(0x29d1febf0417aa85) },
+          { W64LIT(0x9846819e93470afe), W64LIT(0x3e6a9669e2a27f9e),
+            W64LIT(0x24d008a2e31e6504), W64LIT(0xdba7cecf9cb7680a) } },
+        { { W64LIT(0x26a43e41d07fa53d), W64LIT(0x3154a78a74e35bc5),
+            W64LIT(0x7b768924e0da2f8c), W64LIT(0xba964a2b23613f9a) },
+          { W64LIT(0x5a548d35ba1d16c4), W64LIT(0x2e1bfed1fb54d057),
+            W64LIT(0xff992136bc640205), W64LIT(0xf39cb9148156df29) } },
+        { { W64LIT(0xc913e64699b444ad), W64LIT(0xddfce99dc40504c5),
+            W64LIT(0x58482a99d42e53db), W64LIT(0x9aaf2c25d1aff537) },
+          { W64LIT(0xee90f7962664cf67), W64LIT(0x74ab5c99f1393e2b),
+            W64LIT(0xfad0faeae6225bb0), W64LIT(0xc355648c2d63dd6c) } },
+        { { W64LIT(0xe4e31d271d91cf9d), W64LIT(0xcb35d4fdb377b20a),
+            W64LIT(0x74de1e45055e1327), W64LIT(0x3298e31b28703e75) },
+          { W64LIT(0x55087237de013339), W64LIT(0x32cbf30123d101c6),
+            W64LIT(0xc70dba22e8aab0dc), W64LIT(0x4a52623d3d155bb9) } },
+        { { W64LIT(0xecaff541338d6e43), W64LIT(0x56f7dd734541d5cc),
+            W64LIT(0xb5d426de96bc88ca), W64LIT(0x48d94f6b9ed3a2c3) },
+          { W64LIT(0x6354a3bb2ef8279c), W64LIT(0xd575465b0b1867f2),
+            W64LIT(0xef99b0ff95225151), W64LIT(0xf3e19d88f94500d8) } },
+        { { W64LIT(0xdbf435acc85dcf57), W64LIT(0x61745658c88f5415),
+            W64LIT(0x26367e9a17c55807), W64LIT(0x22d077a5ca90c56f) },
+          { W64LIT(0xfbf72258a2e04e76), W64LIT(0xba965d3e6e06e405),
+            W64LIT(0x5724d06fe3e6f954), W64LIT(0x3e47d47581251a74) } },
+        { { W64LIT(0xb8ba0151e0fb82f7), W64LIT(0x0d160726d5668ac2),
+            W64LIT(0x622ba25814d711b0), W64LIT(0x6addf5577f3fe2f2) },
+          { W64LIT(0x2b831e1c6b9c9435), W64LIT(0xce3a060ab73826bd),
+            W64LIT(0x93fa11c11c240f89), W64LIT(0x4f9cc8d8956e303a) } },
+        { { W64LIT(0x4b9331f6641f82c9), W64LIT(0xd97c7c54dffec756),
+            W64LIT(0xf5ee6d1f1a9158ab), W64LIT(0x054493a385c3da7f) },
+          { W64LIT(0xa57a05f5eb7d96df), W64LIT(0xa3afd447e4473a39),
+            W64LIT(0x42a4d9c488e16d55), W64LIT(0x83e144f5f5f876ae) } },
+        { { W64LIT(0x92a83268e32dd620), W64LIT(0x913ec99f627849a2),
+            W64LIT(0xedd8fdfa2c378882), W64LIT(0xaf96f33eee6f8cfe) },
+          { W64LIT(0xc06737e5dc3fa8a5), W64LIT(0x236bb531b0b03a1d),
+            W64LIT(0x33e59f2989f037b0), W64LIT(0x13f9b5a7d9a12a53) } },
+        { { W64LIT(0x50d8ae9559029aa6), W64LIT(0xd74e292c5a4db2ed),
+            W64LIT(0x0b9c3355848f373d), W64LIT(0xec018db6ac45ab38) },
+          { W64LIT(0x1f44690269cc53a8), W64LIT(0x8c4b628d1a879864),
+            W64LIT(0x1c743d284b13475e), W64LIT(0xbf4a933873de19f6) } },
+        { { W64LIT(0x4a8a4f47f0cefa69), W64LIT(0xdc8e4cbaa4546866),
+            W64LIT(0x359ba69b23f603c1), W64LIT(0xdab4d601187b7ac5) },
+          { W64LIT(0xa6ca4337c1ebc8d9), W64LIT(0x9fa6585452b4074b),
+            W64LIT(0x1a4b4f81902fb733), W64LIT(0xd2bb5d7aa525deaa) } },
+        { { W64LIT(0xeb2e92d5f81f9567), W64LIT(0x54cb95ea4d698470),
+            W64LIT(0x5f2acb28e04c81eb), W64LIT(0x1c1ebfc4f8ceec64) },
+          { W64LIT(0x8f799fac06e07423), W64LIT(0x72225f9937fa0c85),
+            W64LIT(0xb0cd861634f4db44), W64LIT(0x5ec36159752c9091) } },
+        { { W64LIT(0x0d0df6ce51efb310), W64LIT(0xcb5b2eb4958df5be),
+            W64LIT(0xd6459e2936158e59), W64LIT(0x82aae2b91466e336) },
+          { W64LIT(0xfb658a39411aa636), W64LIT(0x7152ecc5d4c0a933),
+            W64LIT(0xf10c758a49f026b7), W64LIT(0xf4837f97cb09311f) } }
+    },
+    {   /* j * 2^150 * G */
+        { { W64LIT(0x994f523a626332d5), W64LIT(0x7bc388335561bb44),
+            W64LIT(0x005ed4b03d845ea2), W64LIT(0xd39d3ee1c2a1f08a) },
+          { W64LIT(0x6561fdd3e7676b0d), W64LIT(0x620e35fffb706017),
+            W64LIT(0x36ce424ff264f9a8), W64LIT(0xc4c3419fda2681f7) } },
+        { { W64LIT(0x00f831769bb81648), W64LIT(0xd69eb485653120d0),
+            W64LIT(0xd17d75f44ccabc62), W64LIT(0x34a07f82b749fcb1) },
+          { W64LIT(0x2c3af787bbfb5554), W64LIT(0xb06ed4d062e283f8),
+            W64LIT(0x5722889fa19213a0), W64LIT(0x162b085edcf3c7b4) } },
+        { { W64LIT(0x36d90ddaeb300f7a), W64LIT(0x9dcf7dfcedb5e801),
+            W64LIT(0x645cb26874d5244c), W64LIT(0xa127ee79348e3aa2) },
+          { W64LIT(0x488acc53575f1dbb), W64LIT(0x95037e8580e6161e),
+            W64LIT(0x57e59283292650d0), W64LIT(0xabe67d9914938216) } },
+        { { W64LIT(0x32670d2f7189e71f), W64LIT(0xc64387485ecf91e7),
+            W64LIT(0x15758e57db757a21), W64LIT(0x427d09f8290a9ce5) },
+          { W64LIT(0x846a308f38384a7a), W64LIT(0xaac3acb4b0732b99),
+            W64LIT(0x9e94100917845819), W64LIT(0x95cba111a7ce5e03) } },
+        { { W64LIT(0xeb81aa377378058e), W64LIT(0x41c746a104411154),
+            W64LIT(0xa10c73bcfb828ac7), W64LIT(0x6439be919d972b29) },
+          { W64LIT(0x4bf3b4b043a2fbad), W64LIT(0x39e6dadf82b5e840),
+            W64LIT(0x4f7164086397bd4c), W64LIT(0x0f7de5687f1eeccb) } },
+        { { W64LIT(0xdb332a73f37ec3c3), W64LIT(0xc65259bddd59eba0),
+            W64LIT(0x2291709cdb4d3257), W64LIT(0x9a793b25bd389390) },
+          { W64LIT(0xf39fe34be43756f0), W64LIT(0x2f76bdce9afb56c9),
+            W64LIT(0x9f37867a61208b27), W64LIT(0xea1d4307089972c3) } },
+        { { W64LIT(0xd0a744878a429f4f), W64LIT(0x0649712bdb516609),
+            W64LIT(0xb826ba57e769b5df), W64LIT(0x82335df21fc7aaf2) },
+          { W64LIT(0x2389f0675c93d995), W64LIT(0x59ac367a68677be6),
+            W64LIT(0xa77985ff21d9951b), W64LIT(0x038956fb85011cce) } },
+        { { W64LIT(0x97b7851aaaca5e9b), W64LIT(0x518aa52156713b97),
+            W64LIT(0x3357e8c7150a61f6), W64LIT(0x7842e7e2ec2c2b69) },
+          { W64LIT(0x8dffaf656868a548), W64LIT(0xd963bd82e068fc81),
+            W64LIT(0x64da5c8b65917733), W64LIT(0x927090ff7b247328) } },
+        { { W64LIT(0xd6ffdb942f6d0d97), W64LIT(0x05c3ee41443b9373),
+            W64LIT(0xb2e541ebffd36db6), W64LIT(0xb7415a96ce1dcc3e) },
+          { W64LIT(0xe383682e163aa2f6), W64LIT(0x46febdd42f3af218),
+            W64LIT(0x90a0507ebafdbadb), W64LIT(0x4ca8ab4dce52e21a) } },
+        { { W64LIT(0xa3f0832e1b7cfb73), W64LIT(0x7a8afe523ec354c9),
+            W64LIT(0xae91c97e378eadca), W64LIT(0x7449c599ac3b32bb) },
+          { W64LIT(0xa619c3710b1c4655), W64LIT(0x692e4c6af79da87e),
+            W64LIT(0xff3f5d86de38d96a), W64LIT(0xc5320f421c08c0ec) } },
+        { { W64LIT(0x92a6f2bc8fec5dec), W64LIT(0xa71383ff84d6786c),
+            W64LIT(0x87588c06dbffa084), W64LIT(0x0d85f5ca6857e715) },
+          { W64LIT(0xe87311b3b6c774d4), W64LIT(0x672357c84c3521a8),
+            W64LIT(0xe5fe74615b29fe0f), W64LIT(0x02bc51105b7158cd) } },
+        { { W64LIT(0x37a01e48a105fc8e), W64LIT(0x769d754a289ba48c),
+            W64LIT(0xc08c6fe1d51c2180), W64LIT(0xb032dd33b7bd1387) },
+          { W64LIT(0x953826db020b0aa6), W64LIT(0x05137e800664c73c),
+            W64LIT(0xc66302c4660cf95d), W64LIT(0x99004e11b2cef28a) } },
+        { { W64LIT(0x824f5b284f973536), W64LIT(0xb43e299ed35b04ea),
+            W64LIT(0xc72c88f74da03089), W64LIT(0x8269d57a45a2e42c) },
+          { W64LIT(0x7c1e63fc6607b38e), W64LIT(0xe89e2aaf29390b0c),
+            W64LIT(0xc7c740da1bee2869), W64LIT(0x8556f6fcaf3fb974) } },
+        { { W64LIT(0x1a0a3995a4b6bed1), W64LIT(0x2dab579597095c54),
+            W64LIT(0x06c6a1ff2aa73ce9), W64LIT(0xadd0a54b4de438a7) },
+          { W64LIT(0x160b6b1afca906cd), W64LIT(0x25fc601629de10dd),
+            W64LIT(0x348e9c99d3633da3), W64LIT(0x1fe3f746158a4d5a) } },
+        { { W64LIT(0xc253edc88be85c1d), W64LIT(0xdd3d0e483ca09cb6),
+            W64LIT(0xb997f6879ae3055a), W64LIT(0x0c929ad007431dbf) },
+          { W64LIT(0xcef1621584d2db42), W64LIT(0xb50df3ef078828cd),
+            W64LIT(0x4589da9d6dbd4b66), W64LIT(0xbc4fd2e3d99c2b04) } },
+        { { W64LIT(0x214bc9a7d298c241), W64LIT(0xe3b697ba56807cfd),
+            W64LIT(0xef1c78024564eadb), W64LIT(0xdde8cdcfb48149c5) },
+          { W64LIT(0x946bf0a75a4d2604), W64LIT(0x27154d7f6c1538af),
+            W64LIT(0x95cc9230de5b1fcc), W64LIT(0xd88519e966864f82) } }
+    },
+    {   /* j * 2^155 * G */
+        { { W64LIT(0xb828dd1a7cb1282c), W64LIT(0xa08d7626be46973a),
+            W64LIT(0x6baf8d40e708d6b2), W64LIT(0x72571fa14daeb3f3) },
+          { W64LIT(0x85b1732ff22dfd98), W64LIT(0x87ab01a70087108d),
+            W64LIT(0xaaaafea85988207a), W64LIT(0xccc832f869f00755) } },
+        { { W64LIT(0x488f1185ca8d9d1a), W64LIT(0xadf2c77dd987ded2),
+            W64LIT(0x5f3039f060c46124), W64LIT(0xe5d70b7571e095f4) },
+          { W64LIT(0x82d586506260e70f), W64LIT(0x39d75ea7f750d105),
+            W64LIT(0x8cf3d0b175bac364), W64LIT(0xf3a7564d21d01329) } },
+        { { W64LIT(0x94ab4700ec3128c2), W64LIT(0x6c76d8628e383f49),
+            W64LIT(0xdc36b150c03024eb), W64LIT(0xfb43947753daac69) },
+          { W64LIT(0xfc68764a8dc79623), W64LIT(0x5b86995db440fbb2),
+            W64LIT(0xd66879bfccc5ee0d), W64LIT(0x0522894295aa8bd3) } },
+        { { W64LIT(0xb24aa43e3fcd3efc), W64LIT(0xdd26c034b8088e9a),
+            W64LIT(0xa5ef4dc9bd3d46ea), W64LIT(0xa2f99d588a4c6a6f) },
+          { W64LIT(0xddabd3552f1da46c), W64LIT(0x72c3f8ce1afacdd1),
+            W64LIT(0xd90c4eee92d40578), W64LIT(0xd28bb41fca623b94) } },
+        { { W64LIT(0x5e7c3becee8314f3), W64LIT(0x1c068aeddbea298f),
+            W64LIT(0x08d381f17c80acec), W64LIT(0x03b56be8e330495b) },
+          { W64LIT(0xaeffb8f29222882d), W64LIT(0x95ff38f6c4af8bf7),
+            W64LIT(0x50e32d351fc57d8c), W64LIT(0x6635be5217b444f0) } },
+        { { W64LIT(0x242792d2e7417ce1), W64LIT(0xff42bc71970ee7f5),
+            W64LIT(0x1ff4dc6d5c67a41e), W64LIT(0x77709b7b20882a58) },
+          { W64LIT(0x3554731dbe217f2c), W64LIT(0x2af2a8cd5bb72177),
+            W64LIT(0x58eee769591dd059), W64LIT(0xbb2930c94bba6477) } },
+        { { W64LIT(0x174a9126cecdaa7a), W64LIT(0xfc8c7e0e0b13247b),
+            W64LIT(0x29c110d23484c1c4), W64LIT(0xf8eb8757831dfc3b) },
+          { W64LIT(0x022f0212c0067452), W64LIT(0x3f6f69ee7b9b926c),
+            W64LIT(0x09032da0ef42daf4), W64LIT(0x79f00ade83f80de4) } },
+        { { W64LIT(0x1e6adddaf176f2c0), W64LIT(0x01ca4604e2572658),
+            W64LIT(0x0a404ded85342ffb), W64LIT(0x8cf60f96441838d6) },
+          { W64LIT(0x9bbc691cc9071c4a), W64LIT(0xfd58874434442803),
+            W64LIT(0x97101c85809c0d81), W64LIT(0xa7fb754c8c456f7f) } },
+        { { W64LIT(0xf8559ff4c1e99d81), W64LIT(0x08e1a7d6a3c617c0),
+            W64LIT(0xb398fd43248c6ba7), W64LIT(0x6ffedd91d1283794) },
+          { W64LIT(0x8a6a59d2d629d208), W64LIT(0xa9d141d53490530e),
+            W64LIT(0x42f6fc1838505989), W64LIT(0x09bf250d479d94ee) } },
+        { { W64LIT(0x6af7a1d5af71013f), W64LIT(0xe68216e50bedc946),
+            W64LIT(0xf4cba30bd27370a0), W64LIT(0x7981afbf870421cc) },
+          { W64LIT(0x02496a679449f0e1), W64LIT(0x86cfc4be0a47edae),
+            W64LIT(0x3073c936b1feca22), W64LIT(0xf569461203f8f8fb) } },
+        { { W64LIT(0xec14f9e12cb7191e), W64LIT(0x78ea1bd8e5b08ea6),
+            W64LIT(0x3c65aa9b46332bb9), W64LIT(0x84cc22b3bf80ce25) },
+          { W64LIT(0x0098e9e9d49d5bf1), W64LIT(0xcd4ec1c619087da4),
+            W64LIT(0x3c9d07c5aef6e357), W64LIT(0x839a02689f8f64b8) } },
+        { { W64LIT(0xbcadd6715bde48f8), W64LIT(0xc97038732189bc7d),
+            W64LIT(0x5d45299ec709ee8a), W64LIT(0xd1287ee2845aaff8) },
+          { W64LIT(0x7d1f8874db1dbf1f), W64LIT(0xea46588b990c88d6),
+            W64LIT(0x60ba649a84368313), W64LIT(0xd5fdcbce60d543ae) } },
+        { { W64LIT(0xf795643037577dd8), W64LIT(0x83b82af429c5fe88),
+            W64LIT(0x9c1bea26cdbdc132), W64LIT(0x589fa0869c04339e) },
+          { W64LIT(0x033e9538b13799df), W64LIT(0x85fa8b21d295d034),
+            W64LIT(0xdf17f73fbd9ddcca), W64LIT(0xf32bd122ddb66334) } },
+        { { W64LIT(0xcf3de9959890272d), W64LIT(0x75f3432a3e713a10),
+            W64LIT(0x5e13479fe28227b8), W64LIT(0xb8561ea9fefacdc8) },
+          { W64LIT(0xa6a297a08332aafd), W64LIT(0x9b0d8bb573809b62),
+            W64LIT(0xd2fa1cfd0c63036f), W64LIT(0x7a16eb55bd64bda8) } },
+        { { W64LIT(0x4cc34ec13cf48283), W64LIT(0xb09daa259c8a705e),
+            W64LIT(0xd1e9d0d05b7d4f84), W64LIT(0x4df6ef64db38929d) },
+          { W64LIT(0xe16b0763aa21ba46), W64LIT(0xc6b1d178a293f8fb),
+            W64LIT(0x0ff5b602d520aabf), W64LIT(0x94d671bdc339397a) } },
+        { { W64LIT(0xf7e48e8a2ac13e27), W64LIT(0x4494f6df4eb1a9f5),
+            W64LIT(0xedbf84eb981f0a62), W64LIT(0x49badc32536438f0) },
+          { W64LIT(0x50bea541004f7571), W64LIT(0xbac67d10df1c94ee),
+            W64LIT(0x253d73a1b727bc31), W64LIT(0xb3d01cf230686e28) } }
+    },
+    {   /* j * 2^160 * G */
+        { { W64LIT(0xd433e50f6d3549cf), W64LIT(0x6f33696ffacd665e),
+            W64LIT(0x695bfdacce11fcb4), W64LIT(0x810ee252af7c9860) },
+          { W64LIT(0x65450fe17159bb2c), W64LIT(0xf7dfbebe758b357b),
+            W64LIT(0x2b057e74d69fea72), W64LIT(0xd485717a92731745) } },
+        { { W64LIT(0x896c42e8ee36860c), W64LIT(0xdaf04dfd4113c22d),
+            W64LIT(0x1adbb7b744104213), W64LIT(0xe5fd5fa11fd394ea) },
+          { W64LIT(0x68235d941a4e0551), W64LIT(0x6772cfbe18d10151),
+            W64LIT(0x276071e309984523), W64LIT(0xe4e879de5a56ba98) } },
+        { { W64LIT(0x6c8d0aa9b898fd52), W64LIT(0x2fb38a57be9af1a7),
+            W64LIT(0xe1f2b9a93b4f03f8), W64LIT(0x2b1aad44c3f0cc6f) },
+          { W64LIT(0x58b5332e7cf2c084), W64LIT(0x1c57d96f0367d26d),
+            W64LIT(0x2297eabdfa6e4a8d), W64LIT(0x65a947ee4a0e2b6a) } },
+        { { W64LIT(0xaaafafb0285b9491), W64LIT(0x01a0be881e4c705e),
+            W64LIT(0xff1d4f5d2ad9caab), W64LIT(0x6e349a4ac37a233f) },
+          { W64LIT(0xcf1c12464a1c6a16), W64LIT(0xd99e6b6629383260),
+            W64LIT(0xea3d43665f6d5471), W64LIT(0x36974d04ff8cc89b) } },
+        { { W64LIT(0xf535b616fdd5b854), W64LIT(0x592549c85728719f),
+            W64LIT(0xe231468606921cad), W64LIT(0x98c8ce34311b1ef8) },
+          { W64LIT(0x28b937e7e9090b36), W64LIT(0x67fc3ab90bf7bbb7),
+            W64LIT(0x12337097a9d87974), W64LIT(0x3e5adca1f970e3fe) } },
+        { { W64LIT(0xc26c49a1cfe89d80), W64LIT(0xb42c026dda9c8371),
+            W64LIT(0xca6c013adad066d2), W64LIT(0xfb8f722856a4f3ee) },
+          { W64LIT(0x08b579ecd850935b), W64LIT(0x34c1a74cd631e1b3),
+            W64LIT(0xcb5fe596ac198534), W64LIT(0x39ff21f6e1f24f25) } },
+        { { W64LIT(0xcdcc68a7b3f85ff0), W64LIT(0xacd21cdd1a888044),
+            W64LIT(0xb6719b2e05dbe894), W64LIT(0xfae1d3d88b8260d4) },
+          { W64LIT(0xedfedece8a1c5d92), W64LIT(0xbca01a94dc52077e),
+            W64LIT(0xc085549c16dd13ed), W64LIT(0xdc5c3bae495ebaad) } },
+        { { W64LIT(0x27f29e148f929057), W64LIT(0x7a64ae06c0c853df),
+            W64LIT(0x256cd18358e9c5ce), W64LIT(0x9d9cce82ded092a5) },
+          { W64LIT(0xcc6e59796e93b7c7), W64LIT(0xe1e4709231bb9e27),
+            W64LIT(0xb70b3083aa9e29a0), W64LIT(0xbf181a753785e644) } },
+        { { W64LIT(0xcc17063fbe7b643a), W64LIT(0x7872e1c846085760),
+            W64LIT(0x86b0fffbb4214c9e), W64LIT(0xb18bbc0e72bf3638) },
+          { W64LIT(0x8b17de0c722591c9), W64LIT(0x1edeab1948c29e0c),
+            W64LIT(0x9fbfd98ef4304f20), W64LIT(0x2d1dbb6b9c77ffb6) } },
+        { { W64LIT(0xf53f2c658ead09f7), W64LIT(0x1335e1d59780d14d),
+            W64LIT(0x69cc20e0cd1b66bc), W64LIT(0x9b670a37bbe0bfc8) },
+          { W64LIT(0xce53dc8128efbeed), W64LIT(0x0c74e77c8326a6e5),
+            W64LIT(0x3604e0d2b88e9a63), W64LIT(0xbab38fca13dc2248) } },
+        { { W64LIT(0x255616d3c7141771), W64LIT(0xa86691ab2f226b66),
+            W64LIT(0xda19fea4b3ca63a9), W64LIT(0xfc05dc42ae672f2b) },
+          { W64LIT(0xa9c6e786718ba28f), W64LIT(0x07b7995b9c66b984),
+            W64LIT(0x0f434f551b3702f2), W64LIT(0xd6f6212fda84eeff) } },
+        { { W64LIT(0x8ed6e8c85c0a3f1e), W64LIT(0xbcad24927c87c37f),
+            W64LIT(0xfdfb62bb9ee3b78d), W64LIT(0xeba8e477cbceba46) },
+          { W64LIT(0x37d38cb0eeaede4b), W64LIT(0x0bc498e87976deb6),
+            W64LIT(0xb2944c046b6147fb), W64LIT(0x8b123f35f71f9609) } },
+        { { W64LIT(0x4b0e7987b5b41d78), W64LIT(0xea7df9074bf0c4f8),
+            W64LIT(0xb4d03560fab80ecd), W64LIT(0x6cf306f6fb1db7e5) },
+          { W64LIT(0x0d59fb5689fd4773), W64LIT(0xab254f4000f9be33),
+            W64LIT(0x18a09a9277352da4), W64LIT(0xf81862f5641ea3ef) } },
+        { { W64LIT(0xa155dcc7de79dc24), W64LIT(0xf1168a32558f69cd),
+            W64LIT(0xbac215950d1850df), W64LIT(0x15c8295bb204c848) },
+          { W64LIT(0xf661aa367d8184ff), W64LIT(0xc396228e30447bdb),
+            W64LIT(0x11cd5143bde4a59e), W64LIT(0xe3a26e3b6beab5e6) } },
+        { { W64LIT(0xb59b01579f759d01), W64LIT(0xa2923d2f7eae4fde),
+            W64LIT(0x18327757690ba8c0), W64LIT(0x4bf7e38b44f51443) },
+          { W64LIT(0xb6812563b413fc26), W64LIT(0xedb7d36379e53b36),
+            W64LIT(0x4fa585c4c389f66d), W64LIT(0x8e1adc3154bd3416) } },
+        { { W64LIT(0xd3b3a13f1402b9d0), W64LIT(0x573441c32c7bc863),
+            W64LIT(0x4b301ec4578c3e6e), W64LIT(0xc26fc9c40adaf57e) },
+          { W64LIT(0x96e71bfd7493cea3), W64LIT(0xd05d4b3f1af81456),
+            W64LIT(0xdaca2a8a6a8c608f), W64LIT(0x53ef07f60725b276) } }
+    },
+    {   /* j * 2^165 * G */
+        { { W64LIT(0xa6b5c9d646ac49d2), W64LIT(0x42c77c0b83137aa9),
+            W64LIT(0x24d000fc68225a38), W64LIT(0x0f63cfc82fe1e907) },
+          { W64LIT(0x22d1b01bc6441f95), W64LIT(0x7d38f719ec8e448f),
+            W64LIT(0x9b33fa5f787fb1ba), W64LIT(0x94dcfda1190158df) } },
+        { { W64LIT(0x211cde10296c36ef), W64LIT(0x7ee8967282c4da77),
+            W64LIT(0xb617d270a57836da), W64LIT(0xf0cd9c319cb7560b) },
+          { W64LIT(0x01fdcbf7e455fe90), W64LIT(0x3fb53cbb7e7334f3),
+            W64LIT(0x781e2ea44e7de4ec), W64LIT(0x8adab3ad0b384fd0) } },
+        { { W64LIT(0x01778a2b599ff0f9), W64LIT(0x68a923d78104fc6b),
+            W64LIT(0x5bfa44dfda694ff3), W64LIT(0x4f7199dbf7667f12) },
+          { W64LIT(0xc06d8ff6e46f2a79), W64LIT(0x08b5deade9f8131d),
+            W64LIT(0x02519a59abb4ce7c), W64LIT(0xc4f710bcb42aec3e) } },
+        { { W64LIT(0x3014368b4ed80940), W64LIT(0x67e6d0567a6fcedd),
+            W64LIT(0x7c208c49ca97579f), W64LIT(0xfe3d7a81a23597f6) },
+          { W64LIT(0x5e2032027e096ae2), W64LIT(0xb1f3e1e724b39366),
+            W64LIT(0x26da26f32fdcdffc), W64LIT(0x79422f1d6097be83) } },
+        { { W64LIT(0x50549c748c878145), W64LIT(0x67f14edf39c63565),
+            W64LIT(0x22ddf78c9bcf2d5e), W64LIT(0xffaa842f68201d10) },
+          { W64LIT(0x47d94a9dd1b2de28), W64LIT(0xc09c4be8054be414),
+            W64LIT(0xac80e178ca82755b), W64LIT(0xe3251d105697c3bd) } },
+        { { W64LIT(0x2bbe09d35001417b), W64LIT(0x795e84ee5962ed5e),
+            W64LIT(0x5b79d1ca279f46c3), W64LIT(0x1f7f8a3b83836a2e) },
+          { W64LIT(0x692200b14a64dc32), W64LIT(0xc84243350f84f739),
+            W64LIT(0xf110da07cc9155c0), W64LIT(0xee8fbe61594b0507) } },
+        { { W64LIT(0x2f6a5391035703cc), W64LIT(0x9899bf6a40c7e24d),
+            W64LIT(0xc3f7f248bbfcbb9a), W64LIT(0xf65027ded555875b) },
+          { W64LIT(0xa7a16b69ffff3b37), W64LIT(0x67b6eb54145b4431),
+            W64LIT(0x19d7e1d249afd679), W64LIT(0xbd819bab110fccdf) } },
+        { { W64LIT(0x263a2cfb9db3b381), W64LIT(0x9c3a2deed4df0a4b),
+            W64LIT(0x728d06e97d04e61f), W64LIT(0x8b1adfbc42449325) },
+          { W64LIT(0x6ec1d9397e053a1b), W64LIT(0xee2be5c766daf707),
+            W64LIT(0x80ba1e14810ac7ab), W64LIT(0xdd2ae778f530f174) } },
+        { { W64LIT(0x3e708e703b9f0426), W64LIT(0xe5b02fb60c84f17c),
+            W64LIT(0x2f4ff35be3b70a0b), W64LIT(0x781b3c5f9b15565d) },
+          { W64LIT(0xe76c636a6e124c3a), W64LIT(0xbde81eba8b496784),
+            W64LIT(0xa412f8e2443f0370), W64LIT(0x15d42362999be45d) } },
+        { { W64LIT(0x0f503ae2a4af76c1), W64LIT(0x550e66dc08276fe7),
+            W64LIT(0x11e0c1fcbf3a33c6), W64LIT(0x42be231006629f85) },
+          { W64LIT(0xedf7743e516ace49), W64LIT(0xce436668436a2262),
+            W64LIT(0xe1ac7036446ca192), W64LIT(0x73631cb5476fe13e) } },
+        { { W64LIT(0xd47f82d4a160bcfa), W64LIT(0x258fb075b8ceb1f2),
+            W64LIT(0x4f818e8fdf5a8d25), W64LIT(0x6685475e6fd31c9d) },
+          { W64LIT(0xcef6385ae1e9b13f), W64LIT(0xe0a42594f0508bdb),
+            W64LIT(0x5ad7ae16aef1f90d), W64LIT(0x45a155ef63f8a81e) } },
+        { { W64LIT(0x8ca407c28034b95e), W64LIT(0xc93eb97617bdc560),
+            W64LIT(0x4ec24e8d339807e8), W64LIT(0x91b734d6dd64a4eb) },
+          { W64LIT(0xd0fece398f668b26), W64LIT(0x4822cc4b141823d5),
+            W64LIT(0xb953bc32f09e4e00), W64LIT(0xca0a7c6006d861ae) } },
+        { { W64LIT(0x4c74d4470f33e712), W64LIT(0x3cec1e0625a87cb0),
+            W64LIT(0x5cec0610e5962db4), W64LIT(0xd971af1571a256aa) },
+          { W64LIT(0xa044c983a2ef4ac9), W64LIT(0xcaa1da63d74e9d00),
+            W64LIT(0xfb972d834673d881), W64LIT(0x50747c5a03a26c8b) } },
+        { { W64LIT(0x04349982a3e25566), W64LIT(0xeef9075e18e1b896),
+            W64LIT(0x4c7bead092b2d24b), W64LIT(0xd99f72fb0a21ba55) },
+          { W64LIT(0xb93e09315005e541), W64LIT(0x2a7a98389ece3205),
+            W64LIT(0xeb388ed11462f2f6), W64LIT(0xb488b15a2e3460a6) } },
+        { { W64LIT(0x43f6cd67969d56af), W64LIT(0x9e0d872cdfc58a8b),
+            W64LIT(0x401c1509a4e70377), W64LIT(0x103d1a1308ad646c) },
+          { W64LIT(0x078ee37e9d062427), W64LIT(0x4e69c5acb9bef78c),
+            W64LIT(0x521ec00136e66142), W64LIT(0x8de1ecb2a634cd82) } },
+        { { W64LIT(0x0435d97a205b9d8b), W64LIT(0x6eb8f064056756d4),
+            W64LIT(0xd5e88a8bb6f8210e), W64LIT(0x070ef12dec9fd9ea) },
+          { W64LIT(0x4d8495053bcc876a), W64LIT(0x12a75338a7404ce3),
+            W64LIT(0xd22b49e1b8a1db5e), W64LIT(0xec1f205114bfa5ad) } }
+    },
+    {   /* j * 2^170 * G */
+        { { W64LIT(0x43ed81b5c4e83d33), W64LIT(0xd9f358795efd488b),
+            W64LIT(0x164a620f9deb4d0f), W64LIT(0xc6927bdbac6a7394) },
+          { W64LIT(0x45c28df79f9e0f03), W64LIT(0x2868661efcd7e1a9),
+            W64LIT(0x7cf4e8d0ffa348f1), W64LIT(0x6bd4c284398538e0) } },
+        { { W64LIT(0x56036e8c06d75fc1), W64LIT(0x2dcf7bb73249a89f),
+            W64LIT(0x81dd1d3de245e7dd), W64LIT(0xf578dc4bebd6e2a7) },
+          { W64LIT(0x4c028903df2ce7a0), W64LIT(0xaee362889c39afac),
+            W64LIT(0xdc847c31146404ab), W64LIT(0x6304c0d8a4e97818) } },
+        { { W64LIT(0xfb6836c327d02dcc), W64LIT(0x5ad009827a68bcc2),
+            W64LIT(0x1b24b44c005e912d), W64LIT(0xcc83d20f811fdcfe) },
+          { W64LIT(0x36527ec1666fba0c), W64LIT(0x6994819714754635),
+            W64LIT(0xfcdcb1a8556da9c2), W64LIT(0xa593426781a732b2) } },
+        { { W64LIT(0xe4ac8b33070d3aab), W64LIT(0x2643672b9a2cd5e5),
+            W64LIT(0x52eff79b1cfc9173), W64LIT(0x665ca49b90a7c13f) },
+          { W64LIT(0x5a8dda59b3efb998), W64LIT(0x8a5b922d052f1341),
+            W64LIT(0xae9ebbab3cf9a530), W64LIT(0x35986e7bf56da4d7) } },
+        { { W64LIT(0x63ee4cbd8088b454), W64LIT(0xdb7f32f79a9e0c8a),
+            W64LIT(0xb377d4186b2447cb), W64LIT(0xe3e982aad370219b) },
+          { W64LIT(0x06ccc1e4c2a2a593), W64LIT(0x72c368650773f24f),
+            W64LIT(0xa13b4da795859423), W64LIT(0x8bbf1d3375040c8f) } },
+        { { W64LIT(0x03c187d0ad886aac), W64LIT(0x5c16878ab771b645),
+            W64LIT(0xb07dfc6fc74045ab), W64LIT(0x2c6360bf7800caed) },
+          { W64LIT(0x24295bb5b9c972a3), W64LIT(0xc9e6f88e7c9a6dba),
+            W64LIT(0x90ffbf2492a79aa6), W64LIT(0xde29d50a41c26ac2) } },
+        { { W64LIT(0xb1f0fb68d84d835d), W64LIT(0xc90caf39861dc1e6),
+            W64LIT(0x12e5b0467594f8d7), W64LIT(0x26897ae265012b92) },
+          { W64LIT(0xbcf68a08a4d6755d), W64LIT(0x403ee41c0991fbda),
+            W64LIT(0x733e343e3bbf17e8), W64LIT(0xd2c7980d679b3d65) } },
+        { { W64LIT(0x534acf4fda79e5ac), W64LIT(0x68b83b3a8630215f),
+            W64LIT(0x5c748b2ed085756e), W64LIT(0xb0317258e5d37cb2) },
+          { W64LIT(0x6735841ac5ccc2c4), W64LIT(0x7d7dc96b3d9d5069),
+            W64LIT(0xa147e410fd1754bd), W64LIT(0x65296e94d399ddd5) } },
+        { { W64LIT(0x1e71c9a1deb8568b), W64LIT(0xa35daea080fb3d32),
+            W64LIT(0xe8b6f2662cf8fb81), W64LIT(0x6d51afe89490696a) },
+          { W64LIT(0x81beac6e51803a19), W64LIT(0xe3d24b7f86219080),
+            W64LIT(0x727cfd9ddf6f463c), W64LIT(0x8c6865ca72284ee8) } },
+        { { W64LIT(0xe00df169d23233f3), W64LIT(0x3e32279677cb637f),
+            W64LIT(0x1f897c0e1da0cf6c), W64LIT(0xa651f5d831d6bbdd) },
+          { W64LIT(0xdd61af191a230c76), W64LIT(0xbd527272cdaa5e4a),
+            W64LIT(0xca753636d0abcd7e), W64LIT(0x78bdd37c370bd8dc) } },
+        { { W64LIT(0xcddb27c17078c432), W64LIT(0xe1961b9cb77fedb7),
+            W64LIT(0x1edc2f5cc2290570), W64LIT(0x2c3fefca19cbd886) },
+          { W64LIT(0xcf880a36c2af389a), W64LIT(0x96c610fdbda71cea),
+            W64LIT(0xf03977a932aa8463), W64LIT(0x8eb7763f8586d90a) } },
+        { { W64LIT(0x831ab3edf0290a8f), W64LIT(0xcae81966cb47c387),
+            W64LIT(0xaad7dece184efb4f), W64LIT(0xdcfc53b34749110e) },
+          { W64LIT(0x6698f23c4cb632f9), W64LIT(0xc42a1ad6b91f8067),
+            W64LIT(0xb116a81d6284180a), W64LIT(0xebedf5f8e901326f) } },
+        { { W64LIT(0x91633f0ab2cf8940), W64LIT(0x72b0b1786f948f51),
+            W64LIT(0x2d28dc30782653c8), W64LIT(0x88829849db903a05) },
+          { W64LIT(0xb8095d0c6a19d2bb), W64LIT(0x4b9e7f0c86f782cb),
+            W64LIT(0x7af739882d907064), W64LIT(0xd12be0fe8b32643c) } },
+        { { W64LIT(0x9561f28b638a7e81), W64LIT(0x54155cdf5980ddc3),
+            W64LIT(0xb2db4a96d26f247a), W64LIT(0x9d774e4e4787d100) },
+          { W64LIT(0x1a9e6e2e078637d2), W64LIT(0x1c363e2d5e0ae06a),
+            W64LIT(0x7493483ee9cfa354), W64LIT(0x76843cb37f74b98d) } },
+        { { W64LIT(0x0491f1bc789a283b), W64LIT(0x72d3ac3d880836f4),
+            W64LIT(0xaa1c5ea388e5402d), W64LIT(0x1b192421d5cc473d) },
+          { W64LIT(0x5c0b99989dc84cac), W64LIT(0xb0a8482d9c6e75b8),
+            W64LIT(0x639961d03a191ce2), W64LIT(0xda3bc8656d837930) } },
+        { { W64LIT(0xd7e0c4cdb30cfb3a), W64LIT(0x6d09b8c16c9db4c8),
+            W64LIT(0x40ba1a4207c8d9df), W64LIT(0x6fd495f71c52c66d) },
+          { W64LIT(0xfb0e169f275264da), W64LIT(0x80c2b746e57d8362),
+            W64LIT(0xedd987f749ad7222), W64LIT(0xfdc229af4398ec7b) } }
+    },
+    {   /* j * 2^175 * G */
+        { { W64LIT(0xb0d1ed8452666a58), W64LIT(0x4bcb6e00e6a9c3c2),
+            W64LIT(0x3c57411c26906408), W64LIT(0xcfc2075513556400) },
+          { W64LIT(0xa08b1c505294dba3), W64LIT(0xa30ba2868b7dd31e),
+            W64LIT(0xd70ba90e991eca74), W64LIT(0x094e142ce762c2b9) } },
+        { { W64LIT(0xb81d783e979f3925), W64LIT(0x1efd130aaf4c89a7),
+            W64LIT(0x525c2144fd1bf7fa), W64LIT(0x4b2969041b265a9e) },
+          { W64LIT(0xed8e9634b9db65b6), W64LIT(0x35c82e3203599d8a),
+            W64LIT(0xdaa7a54f403563f3), W64LIT(0x9df088ad022c38ab) } },
+        { { W64LIT(0xe5cfb066bb3fd30a), W64LIT(0x429169daeff0354e),
+            W64LIT(0x809cf8523524e36c), W64LIT(0x136f4fb30155be1d) },
+          { W64LIT(0x4826af011fbba712), W64LIT(0x6ef0f0b4506ba1a1),
+            W64LIT(0xd9928b3177aea73e), W64LIT(0xe2bf6af25eaa244e) } },
+        { { W64LIT(0x8d084f124237b64b), W64LIT(0x688ebe99e3ecfd07),
+            W64LIT(0x57b8a70cf6845dd8), W64LIT(0x808fc59c5da4a325) },
+          { W64LIT(0xa9032b2ba3585862), W64LIT(0xb66825d5edf29386),
+            W64LIT(0xb5a5a8db431ec29b), W64LIT(0xbb143a983a1e8dc8) } },
+        { { W64LIT(0x35ee94ce12ae381b), W64LIT(0x3a7f176c86ccda90),
+            W64LIT(0xc63a657e4606eaca), W64LIT(0x9ae5a38043cd04df) },
+          { W64LIT(0x9bec8d15ed251b46), W64LIT(0x1f5d6d30caca5e64),
+            W64LIT(0x347b3b359ff20f07), W64LIT(0x4d65f034f7e4b286) } },
+        { { W64LIT(0x9e93ba24f111661e), W64LIT(0xedced484b105eb04),
+            W64LIT(0x96dc9ba1f424b578), W64LIT(0xbf8f66b7e83e9069) },
+          { W64LIT(0x872d4df4d7ed8216), W64LIT(0xbf07f3778e2cbecf),
+            W64LIT(0x4281d89998e73754), W64LIT(0xfec85fbb8aab8708) } },
+        { { W64LIT(0x9a3c0deea5ba5b0b), W64LIT(0xe6a116ce42d05299),
+            W64LIT(0xae9775fee9b02d42), W64LIT(0x72b05200a1545cb6) },
+          { W64LIT(0xbc506f7d31a3b4ea), W64LIT(0xe58930788bbd9b32),
+            W64LIT(0xc8bc5f37e4b12a97), W64LIT(0x6b000c064a73b671) } },
+        { { W64LIT(0x13b5bf22765fa7d0), W64LIT(0x59805bf01d6a5370),
+            W64LIT(0x67a5e29d4280db98), W64LIT(0x4f53916f776b1ce3) },
+          { W64LIT(0x714ff61f33ddf626), W64LIT(0x4206238ea085d103),
+            W64LIT(0x1c50d4b7e5809ee3), W64LIT(0x999f450d85f8eb1d) } },
+        { { W64LIT(0x658a6051e4c79e9b), W64LIT(0x1394cb73c66a9fea),
+            W64LIT(0x27f31ed5c6be7b23), W64LIT(0xf4c88f365aa6f8fe) },
+          { W64LIT(0x0fb0721f4aaa499e), W64LIT(0x68b3a7d5e3fb2a6b),
+            W64LIT(0xa788097d3a92851d), W64LIT(0x060e7f8ae96f4913) } },
+        { { W64LIT(0x82eebe731a3a93bc), W64LIT(0x42bbf465a21adc1a),
+            W64LIT(0xc10b6fa4ef030efd), W64LIT(0x247aa4c787b097bb) },
+          { W64LIT(0x8b8dc632f60c77da), W64LIT(0x6ffbc26ac223523e),
+            W64LIT(0xa4f6ff11344579cf), W64LIT(0x5825653c980250f6) } },
+        { { W64LIT(0xb2dd097ebc1aa2b9), W64LIT(0x0788939337a0333a),
+            W64LIT(0x1cf55e7137a0db38), W64LIT(0x2648487f792c1613) },
+          { W64LIT(0xdad013363fcef261), W64LIT(0x6239c81d0eabf129),
+            W64LIT(0x8ee761de9d276be2), W64LIT(0x406a7a341eda6ad3) } },
+        { { W64LIT(0x4bf367ba4a493b31), W64LIT(0x54f20a529bf7f026),
+            W64LIT(0xb696e0629795914b), W64LIT(0xcddab96d8bf236ac) },
+          { W64LIT(0x4ff2c70aed25ea13), W64LIT(0xfa1d09eb81cbbbe7),
+            W64LIT(0x88fc8c87468544c5), W64LIT(0x847a670d696b3317) } },
+        { { W64LIT(0xf133421e64bcb626), W64LIT(0xaea638c826dee0b5),
+            W64LIT(0xd6e7680bb310346c), W64LIT(0xe06f4097d5d4ced3) },
+          { W64LIT(0x099614527512a30b), W64LIT(0xf3d867fde589a59a),
+            W64LIT(0x2e73254f52d0c180), W64LIT(0x9063d8a3333c74ac) } },
+        { { W64LIT(0xeda6c595d314e7bc), W64LIT(0x2ee7464b467899ed),
+            W64LIT(0x1cef423c0a1ed5d3), W64LIT(0x217e76ea69cc7613) },
+          { W64LIT(0x27ccce1fe7cda917), W64LIT(0x12d8016b8a893f16),
+            W64LIT(0xbcd6de849fc74f6b), W64LIT(0xfa5817e2f3144e61) } },
+        { { W64LIT(0x1f3541640821ee4c), W64LIT(0x1583eab40bc61992),
+            W64LIT(0x7490caf61d72879f), W64LIT(0x998ad9f3f76ae7b2) },
+          { W64LIT(0x1e181950a41157f7), W64LIT(0xa9d7e1e6e8da3a7e),
+            W64LIT(0x963784eb8426b95f), W64LIT(0x0ee4ed6e542e2a10) } },
+        { { W64LIT(0xb79d4cc5ac751e7b), W64LIT(0x93f96472fd4211bd),
+            W64LIT(0x8c72d3d2c8de4fc6), W64LIT(0x7b69cbf5df44f064) },
+          { W64LIT(0x3da90ca2f4bf94e1), W64LIT(0x1a5325f8f12894e2),
+            W64LIT(0x0a437f6c7917d60b), W64LIT(0x9be7048696c9cb5d) } }
+    },
+    {   /* j * 2^180 * G */
+        { { W64LIT(0x949c9976e1337c26), W64LIT(0x6faadebdd73d68e5),
+            W64LIT(0x9e158614f1b768d9), W64LIT(0x22dfa5579cc4f069) },
+          { W64LIT(0xccd6da17be93c6d6), W64LIT(0x24866c61a504f5b9),
+            W64LIT(0x2121353c8d694da1), W64LIT(0x1c6ca5800140b8c6) } },
+        { { W64LIT(0xf1604a7dd4b79bb8), W64LIT(0xaee806fb52c878c8),
+            W64LIT(0x34144f118d47b8e8), W64LIT(0x72edf52b949f9054) },
+          { W64LIT(0xebfca84e2127015a), W64LIT(0x9051d0c09cb7cef3),
+            W64LIT(0x86e8fe58296deec8), W64LIT(0x33b2818841010d74) } },
+        { { W64LIT(0xbd5660ed9aed9f40), W64LIT(0x70ca6ad1532a8c99),
+            W64LIT(0xc4978bfb95c371ea), W64LIT(0xe5464d0d7003109d) },
+          { W64LIT(0x1af32fdfd9e535ef), W64LIT(0xabf57ea798c9185b),
+            W64LIT(0xed7a741712b42488), W64LIT(0x8e0296a7e97286fa) } },
+        { { W64LIT(0x01079383171b445f), W64LIT(0x9bcf21e38131ad4c),
+            W64LIT(0x8cdfe205c93987e8), W64LIT(0xe63f4152c92e8c8f) },
+          { W64LIT(0x729462a930add43d), W64LIT(0x62ebb143c980f05a),
+            W64LIT(0x4f3954e53b06e968), W64LIT(0xfe1d75ad242cf6b1) } },
+        { { W64LIT(0x8b57416e1f017d5e), W64LIT(0x375333967674e99b),
+            W64LIT(0x6e6d94c0e8f488a0), W64LIT(0xb93a787adc16f95e) },
+          { W64LIT(0xc3ac51a2dcc99ccc), W64LIT(0xc134b4139aa47c1d),
+            W64LIT(0xf28fcdafafdfd8d5), W64LIT(0x0d57bd8e10b831ed) } },
+        { { W64LIT(0x9276fbccf0bcfc46), W64LIT(0x3a822aceb5cffee6),
+            W64LIT(0x328ed2fec75d915b), W64LIT(0xa145c113c359476c) },
+          { W64LIT(0xf61a81538be17bcd), W64LIT(0x01e867c3aa6c3d8f),
+            W64LIT(0x5634e15d6516c82f), W64LIT(0xc1437bd26948b9b0) } },
+        { { W64LIT(0xd2fcd2006c19d4c7), W64LIT(0xa0f3c437e1b1e976),
+            W64LIT(0xf0545ff694f237e8), W64LIT(0xdd10ec3fc0bf8bb1) },
+          { W64LIT(0x4f89696cac7cd3e1), W64LIT(0xed3714ec5f24bfe6),
+            W64LIT(0x363eb1d85faf7706), W64LIT(0xfcbd604dc027cc32) } },
+        { { W64LIT(0x5f95c6c7af8685c8), W64LIT(0xd4c1c8ce2f8f01aa),
+            W64LIT(0xc44bbe322574692a), W64LIT(0xb8003478d4a4a068) },
+          { W64LIT(0x7c8fc6e52eca3cdb), W64LIT(0xea1db16bec04d399),
+            W64LIT(0xb05bc82e8f2bc5cf), W64LIT(0x763d517ff44793d2) } },
+        { { W64LIT(0x16ce8eddc355363b), W64LIT(0x4af2f70ff8820d6e),
+            W64LIT(0xcb7ed4d27661a508), W64LIT(0x41d3444edd195472) },
+          { W64LIT(0x17fea2b438da9649), W64LIT(0x9bf69356aeb4a200),
+            W64LIT(0xa13b5f916ab19c3d), W64LIT(0xc0519c14dc9360a6) } },
+        { { W64LIT(0xc2571ae92e42e171), W64LIT(0xcb31ab63ed41ccf9),
+            W64LIT(0x37f3c576b5c8854f), W64LIT(0x66e5191bc62392a1) },
+          { W64LIT(0x71565a1c6cd5683b), W64LIT(0x484b0283606fe689),
+            W64LIT(0xf3a25d6767e2fda6), W64LIT(0x87ba21de8a65c0a4) } },
+        { { W64LIT(0xde74e49ca70684d1), W64LIT(0x3ae8766133e80c3d),
+            W64LIT(0x5984a2a916a5c34d), W64LIT(0x09a83eccb8298c35) },
+          { W64LIT(0x9a19867caa4ca4c0), W64LIT(0x02085610b375b8ff),
+            W64LIT(0xf296328bf70396dc), W64LIT(0x9c9ddc4cde6fae63) } },
+        { { W64LIT(0x4451c1b808bd98d0), W64LIT(0x644b1cd46575f240),
+            W64LIT(0x6907eb337375d270), W64LIT(0x56c8bebdfa2286bd) },
+          { W64LIT(0xc713d2acc4632b46), W64LIT(0x17da427aafd60242),
+            W64LIT(0x313065b7c95c7546), W64LIT(0xf8239898bf17a3de) } },
+        { { W64LIT(0x94683d260b083b6e), W64LIT(0x0a3752eb06f6a54d),
+            W64LIT(0x48bedc23752074dd), W64LIT(0x637622fc3e822593) },
+          { W64LIT(0xea0005136be55d3b), W64LIT(0x9f5e12f4324d006d),
+            W64LIT(0x529486a964fc0270), W64LIT(0x09ba0d0c923399e6) } },
+        { { W64LIT(0x363858473a977080), W64LIT(0x4cf8e1b80c6a6ab6),
+            W64LIT(0x919a5c6c0482261e), W64LIT(0x517a9ad0e5ce4806) },
+          { W64LIT(0x2792d40c056aa7aa), W64LIT(0x4c7c6adae56c61b0),
+            W64LIT(0xf19cb178a4b19e0c), W64LIT(0x046d5c4fe4ba267f) } },
+        { { W64LIT(0xd3e926ab121550b3), W64LIT(0xe4975e4ac147ce84),
+            W64LIT(0x7a8be0f95eff722a), W64LIT(0x71e4702c6fd4f2a0) },
+          { W64LIT(0x13b92acf3cb7b280), W64LIT(0xc588716d28272d73),
+            W64LIT(0x862c7bf3daa9fe5c), W64LIT(0x78c008f2e2a79e42) } },
+        { { W64LIT(0xf3b7963f4c830320), W64LIT(0x842c7aa0903203e3),
+            W64LIT(0xaf22ca0ae7327afb), W64LIT(0x38e13092967609b6) },
+          { W64LIT(0x73b8fb62757558f1), W64LIT(0x3cc3e831f7eca8c1),
+            W64LIT(0xe4174474f6331627), W64LIT(0xa77989cac3c40234) } }
+    },
+    {   /* j * 2^185 * G */
+        { { W64LIT(0xae8317f4b0166f7a), W64LIT(0xfbd3e3f7ceec74e6),
+            W64LIT(0xfdb516ace0874bfd), W64LIT(0x3d846019c681f3a3) },
+          { W64LIT(0x0b12ee5c7c1620b0), W64LIT(0xba68b4dd2b63c501),
+            W64LIT(0xac03cd326668c51e), W64LIT(0x2a6279f74e0bcb5b) } },
+        { { W64LIT(0xfd8e139f8f5fcda8), W64LIT(0xf3e558c4bdee5bfd),
+            W64LIT(0xd76cbaf4e33f9f77), W64LIT(0x3a4c97a471771969) },
+          { W64LIT(0xda27e84bf6dce6a7), W64LIT(0xff373d9613e6c2d1),
+            W64LIT(0xf115193cd759a6e9), W64LIT(0x3f9b702563d2262c) } },
+        { { W64LIT(0x12536fea87baa627), W64LIT(0x58c1fec1f72aa680),
+            W64LIT(0x6c29b637601e5dc9), W64LIT(0x9e3c3c1cde9e01b9) },
+          { W64LIT(0xefc8127b2bcfe0b0), W64LIT(0x351071022a12f50d),
+            W64LIT(0x6ccd6cb14879b397), W64LIT(0xf792f804f8a82f21) } },
+        { { W64LIT(0x8c3184911a335cc8), W64LIT(0x563459ba6a5913e4),
+            W64LIT(0x1b920d61c7b32919), W64LIT(0x805ab8b6a02425ad) },
+          { W64LIT(0x2ac512da8d006086), W64LIT(0x6ca4846abcf5c0fd),
+            W64LIT(0xafea51d8ac2138d7), W64LIT(0xcb647545344cd443) } },
+        { { W64LIT(0xa3f4f521e447f2c4), W64LIT(0x81b8da7a604291f0),
+            W64LIT(0xd680bc467d5926de), W64LIT(0x84f21fd534a1202f) },
+          { W64LIT(0x1d1e31814e9df3d8), W64LIT(0x1ca4861a39ab8d34),
+            W64LIT(0x809ddeec5b19aa4a), W64LIT(0x59f72f7e4d329366) } },
+        { { W64LIT(0x9f1b2466cdedca85), W64LIT(0x140bb7101a09538c),
+            W64LIT(0xac8ae8515e11115d), W64LIT(0x0d63ff676f03f59e) },
+          { W64LIT(0x755e55517d234afb), W64LIT(0x61c2db4e7e208fc1),
+            W64LIT(0xaa9859cef28a4b5d), W64LIT(0xbdd6d4fc34af030f) } },
+        { { W64LIT(0x3f39e67f906151e5), W64LIT(0xcea27f5f55e10649),
+            W64LIT(0xdca1d4e1c17cf7b7), W64LIT(0x0c326d122fe2362d) },
+          { W64LIT(0x05f7ac337dd35df3), W64LIT(0x0c3b7639c396dbdf),
+            W64LIT(0x0912f5ac03b7db1c), W64LIT(0x9dea4b705c9ed4a9) } },
+        { { W64LIT(0x511053e453544774), W64LIT(0x834d0ecc3adba2bc),
+            W64LIT(0x4215d7f7bae371f5), W64LIT(0xfcfd57bf6c8663bc) },
+          { W64LIT(0xded2383dd6901b1d), W64LIT(0x3b49fbb4b5587dc3),
+            W64LIT(0xfd44a08d07625f62), W64LIT(0x3ee4d65b9de9b762) } },
+        { { W64LIT(0x3e56fe5bdf53aad0), W64LIT(0x51314de5e4604a67),
+            W64LIT(0x386ad98607a261a0), W64LIT(0x8b7e021217afcc91) },
+          { W64LIT(0xcbf411273b72aec5), W64LIT(0x13c85d05c4f9f509),
+            W64LIT(0xeda56845b6484b57), W64LIT(0x13cb1642b3d0995b) } },
+        { { W64LIT(0x5a994b6e717815de), W64LIT(0xd995c7a0a7e131d1),
+            W64LIT(0xc8b46df226c023aa), W64LIT(0x8cfd094d702afced) },
+          { W64LIT(0x7bc743cdced6a886), W64LIT(0xb7d70ec41fcabe75),
+            W64LIT(0x2a6c9e47ddac9390), W64LIT(0x720694259310aa90) } },
+        { { W64LIT(0xa607b3263e8f793c), W64LIT(0xa541166ecde3b289),
+            W64LIT(0xf44ff2924a915b21), W64LIT(0x68bea906b58ecda6) },
+          { W64LIT(0xd85b37b440292897), W64LIT(0xd2a508ae4b768423),
+            W64LIT(0xd10bb79da413bbbe), W64LIT(0x0262f481061491f4) } },
+        { { W64LIT(0xd17e80f55464d0eb), W64LIT(0x89d3e1a767a613a7),
+            W64LIT(0x77791260c8c97dad), W64LIT(0xec2ff21fe4f0cbe7) },
+          { W64LIT(0xed984ac2e9e6bc10), W64LIT(0xe3c53de877cba305),
+            W64LIT(0x9bbaf9b283624fdc), W64LIT(0x5e9451cd1485c0ec) } },
+        { { W64LIT(0xfdfc9f63b7abad11), W64LIT(0xc7ec3a9263a46189),
+            W64LIT(0x49ebee42f67037b7), W64LIT(0x8247f504cdac1710) },
+          { W64LIT(0xfc518f8d397583e5), W64LIT(0xe7d24de70c3f8c2e),
+            W64LIT(0x354832669c5edcb1), W64LIT(0x94bba483f8c2cefc) } },
+        { { W64LIT(0x1f13756db1761ec8), W64LIT(0xe53c8b98a4b97e55),
+            W64LIT(0xb2aee3f84096cc28), W64LIT(0x48c361a0920f1a8d) },
+          { W64LIT(0xa98b672d8c31190a), W64LIT(0x7bc1e7d1001855d4),
+            W64LIT(0x242cfb07bf3f4b2a), W64LIT(0x9bf44a3f32a28bc4) } },
+        { { W64LIT(0xeba8976299da550c), W64LIT(0xb2c1781a16baa042),
+            W64LIT(0x3068b082788c2f9d), W64LIT(0xc0fa414594869a9e) },
+          { W64LIT(0x73bd9e39d50b693f), W64LIT(0xb79e2a9c988e2c5e),
+            W64LIT(0xf1cb8de40f8f9f62), W64LIT(0x415b04ee1ea50c7b) } },
+        { { W64LIT(0x64e5137d0d63d1fa), W64LIT(0x658fc05202a9d89f),
+            W64LIT(0x4889487450436309), W64LIT(0xe9ae30f8d598da61) },
+          { W64LIT(0x2ed710d1818baf91), W64LIT(0xe27e9e068b6a0c20),
+            W64LIT(0x1e28dcfb1c1a6b44), W64LIT(0x883acb64d6ac57dc) } }
+    },
+    {   /* j * 2^190 * G */
+        { { W64LIT(0x8735728dc2c6ff70), W64LIT(0x79d6122fc5dc2235),
+            W64LIT(0x23f5d00319e277f9), W64LIT(0x7ee84e25dded8cc7) },
+          { W64LIT(0x91a8afb063cd880a), W64LIT(0x3f3ea7c63574af60),
+            W64LIT(0x0cfcdc8402de7f42), W64LIT(0x62d0792fb31aa152) } },
+        { { W64LIT(0xb02c83f9dec31a21), W64LIT(0x988c8b236ad9d573),
+            W64LIT(0x53e983aea57be365), W64LIT(0xe968734d646f834e) },
+          { W64LIT(0x9137ea8f5da6309b), W64LIT(0x10f3a624c1f1ce16),
+            W64LIT(0x782a9ea2ca440921), W64LIT(0xdf94739e5b46f1b5) } },
+        { { W64LIT(0x1df165a434a35ea8), W64LIT(0x3418e0f74d4412f6),
+            W64LIT(0x5af1f8af518836c3), W64LIT(0x42ceef4d130e1965) },
+          { W64LIT(0x5560ca0b543a1957), W64LIT(0xc33761e5886cb123),
+            W64LIT(0x66624b1ffe98ed30), W64LIT(0xf772f4bf1090997d) } },
+        { { W64LIT(0x56f8410ef4f8b16a), W64LIT(0x97241afec47b266a),
+            W64LIT(0x0a406b8e6d9c87c1), W64LIT(0x803f3e02cd42ab1b) },
+          { W64LIT(0x7f0309a804dbec69), W64LIT(0xa83b85f73bbad05f),
+            W64LIT(0xc6097273ad8e197f), W64LIT(0xc097440e5067adc1) } },
+        { { W64LIT(0xc507b6dd418e7ddd), W64LIT(0x39888d93472f19d6),
+            W64LIT(0x7eae26be0c27eb4d), W64LIT(0x17b53ed3fbabb884) },
+          { W64LIT(0xfc27021b2b01ae4f), W64LIT(0x88462e87cf488682),
+            W64LIT(0xbee096ec215e2d87), W64LIT(0xeb2fea9ad242e29b) } },
+        { { W64LIT(0xbbcc00c756b95bce), W64LIT(0x5ec03906616da680),
+            W64LIT(0x79162ee672214252), W64LIT(0x43132b6386a892d2) },
+          { W64LIT(0x4bdd3ff22f3263bf), W64LIT(0xd5b3733c9cd0a142),
+            W64LIT(0x592eaa8244415ccb), W64LIT(0x663e89248d5474ea) } },
+        { { W64LIT(0x0d38ab35ce7c42d4), W64LIT(0x9fd493ef82feab10),
+            W64LIT(0x46056b6d82111b45), W64LIT(0xda11dae173efc5c3) },
+          { W64LIT(0xdc7402785545a7fb), W64LIT(0xbdb2601c40d507e6),
+            W64LIT(0x121dfeeb7066fa58), W64LIT(0x214369a839ae8c2a) } },
+        { { W64LIT(0x3f747fa0b311898c), W64LIT(0xe2a272e4cd0eac65),
+            W64LIT(0x4bba5851f914d0bc), W64LIT(0x7a1a9660c4a43ee3) },
+          { W64LIT(0xe5a367cea1c8cde9), W64LIT(0x9d958ba97271abe3),
+            W64LIT(0xf3ff7eb63d1615cd), W64LIT(0xa2280dcef5ae20b0) } },
+        { { W64LIT(0x8c0ed566d4312483), W64LIT(0x5179a95d643e216f),
+            W64LIT(0xcc185fec17044493), W64LIT(0xb306333954991a21) },
+          { W64LIT(0xd801ecdb0081a726), W64LIT(0x0149b0c64fa89bbb),
+            W64LIT(0xafe9065a4391b6b9), W64LIT(0xedc92786d633f3a3) } },
+        { { W64LIT(0xd6d9d9e37a6a308b), W64LIT(0x623758304c2767d3),
+            W64LIT(0x874a8bc6f38cbeb6), W64LIT(0xd94d3f1accb6fd9e) },
+          { W64LIT(0x92a9735bba21f248), W64LIT(0x272ad0e56cd1efb0),
+            W64LIT(0x7437b69c05b03284), W64LIT(0xe7f047026948c225) } },
+        { { W64LIT(0x9ae868a9e9adfe1c), W64LIT(0x3984403d314e39bb),
+            W64LIT(0xb5875720f2fe378f), W64LIT(0x33f901e0ba44a628) },
+          { W64LIT(0xea1125fe3652438c), W64LIT(0xae9ec4e69dd1f20b),
+            W64LIT(0x1e740d9ebebf7fbd), W64LIT(0x6dbd3ddc42dbe79c) } },
+        { { W64LIT(0x266344a43794f8dc), W64LIT(0xdcca923a483c5c36),
+            W64LIT(0x2d6b6bbf3f9d10a0), W64LIT(0xb320c5ca81d9bdf3) },
+          { W64LIT(0x620e28ff47b50a95), W64LIT(0x933e3b01cef03371),
+            W64LIT(0xf081bf8599100153), W64LIT(0x183be9a0c3a8c8d6) } },
+        { { W64LIT(0x8a9443d77613aa81), W64LIT(0x8010080085fe6584),
+            W64LIT(0x70fc4dbc7fb10288), W64LIT(0xf58280d3e86beee8) },
+          { W64LIT(0x14fdd82f7c978c38), W64LIT(0xdf1204c10de44d7b),
+            W64LIT(0xa08a1c844160252f), W64LIT(0x591554cac17646a5) } },
+        { { W64LIT(0x7ddc81ea77b46a08), W64LIT(0xcf5a6477c7480699),
+            W64LIT(0x43a8cb346633f683), W64LIT(0x1b867e6b92363c60) },
+          { W64LIT(0x439211141f60558e), W64LIT(0xcdbcdd632f41450e),
+            W64LIT(0x7fc04601cc630e8b), W64LIT(0xea7c66d597038b43) } },
+        { { W64LIT(0x34fc8820fbeee3f9), W64LIT(0x93e5349049091afd),
+            W64LIT(0x764b9be59a31f35c), W64LIT(0x71f3786457e3d924) },
+          { W64LIT(0x02fb34e0943aa75e), W64LIT(0xa18c9c58ab8ff6e4),
+            W64LIT(0x080f31b133cf0d19), W64LIT(0x5c9682db083518a7) } },
+        { { W64LIT(0xb6c185c341dca566), W64LIT(0x7de7fedad8622aa3),
+            W64LIT(0x99e84d92901b6dfb), W64LIT(0x30a02b0e7c4ad288) },
+          { W64LIT(0xc7c81daa2fd3cf36), W64LIT(0xd1319547df89e59f),
+            W64LIT(0xb2be8184cd496733), W64LIT(0xd5f449eb93d3412b) } }
+    },
+    {   /* j * 2^195 * G */
+        { { W64LIT(0xc492ec644cd8f64c), W64LIT(0x58a2d790279d7b51),
+            W64LIT(0x0ced1fc51fc75256), W64LIT(0x3e658aed8f433017) },
+          { W64LIT(0x0b61942e05da59eb), W64LIT(0xba3d60a30ddc3722),
+            W64LIT(0x7c311cd1742e7f87), W64LIT(0x6473ffeef6b01b6e) } },
+        { { W64LIT(0x8303604f692ac542), W64LIT(0xf079ffe1227b91d3),
+            W64LIT(0x19f63e6315aaf9bd), W64LIT(0xf99ee565f1f344fb) },
+          { W64LIT(0x8a1d661fd6219199), W64LIT(0x8c883bc6d48ce41c),
+            W64LIT(0x1065118f3c74d904), W64LIT(0x713889ee0faf8b1b) } },
+        { { W64LIT(0xc035f697960eb8c7), W64LIT(0xf1599f2ce2de04d3),
+            W64LIT(0x892450f8d2ad9228), W64LIT(0x7d48129bb829c1ab) },
+          { W64LIT(0x24d785e13a50afc9), W64LIT(0x2745ba2763a96ee0),
+            W64LIT(0x956534013bfb6d7b), W64LIT(0x536202671bad2a42) } },
+        { { W64LIT(0x972b3f8f81a1b3be), W64LIT(0x4f3ce145ce2764a0),
+            W64LIT(0xe2d0f1cc28c4f5f7), W64LIT(0xdeee0c0dc7f3985b) },
+          { W64LIT(0x7df4adc0d39e25c3), W64LIT(0x40619820c467a080),
+            W64LIT(0x440ebc9361cf5a58), W64LIT(0x527729a6422ad600) } },
+        { { W64LIT(0xa691398a4a9eb3f0), W64LIT(0x56c1dbff3b99a48f),
+            W64LIT(0x9a87e1b91b4b5b32), W64LIT(0xad6396145378b5fe) },
+          { W64LIT(0x437a243ec26b5302), W64LIT(0x0275878c3ccb4c10),
+            W64LIT(0x0e81e4a21de07015), W64LIT(0x0c6265c9850df3c0) } },
+        { { W64LIT(0xca6c0937b1b76ba6), W64LIT(0x1a2eab854d2026dc),
+            W64LIT(0xb1715e1519d9ae0a), W64LIT(0xf1ad9199bac4a026) },
+          { W64LIT(0x35b3dfb807ea7b0e), W64LIT(0xedf5496f3ed9eb89),
+            W64LIT(0x8932e5ff2d6d08ab), W64LIT(0xf314874e25bd2731) } },
+        { { W64LIT(0xc8327149a8c25ff6), W64LIT(0x29bf2556782e6569),
+            W64LIT(0x9012f5c6cd68fc38), W64LIT(0x3e67e8bd3b982ad5) },
+          { W64LIT(0x5e3a75386ecdca88), W64LIT(0xf297eaa6c1753a04),
+            W64LIT(0x10121e5405db3256), W64LIT(0xab9697d4f0851055) } },
+        { { W64LIT(0xefb26a753f73f449), W64LIT(0x1d1c94f88d44fc79),
+            W64LIT(0x49f0fbc53bc0dc4d), W64LIT(0xb747ea0b3698a0d0) },
+          { W64LIT(0x5218c3fe228d291e), W64LIT(0x35b804b543c129d6),
+            W64LIT(0xfac859b8d1acc516), W64LIT(0x6c10697d95d6e668) } },
+        { { W64LIT(0xe5d27171f6bdf1bf), W64LIT(0x0b77b876facb0d8f),
+            W64LIT(0xda95471d8496a31b), W64LIT(0x46a50dbb3f16b103) },
+          { W64LIT(0x2a4f3f977b865bff), W64LIT(0x848195e66b1c198c),
+            W64LIT(0x491ad08821702ea6), W64LIT(0x3f20b43749035228) } },
+        { { W64LIT(0xc38e438f0876fd4e), W64LIT(0x45f0c30783d2f383),
+            W64LIT(0x203cc2ecb10934cb), W64LIT(0x6a8f24392c9d46ee) },
+          { W64LIT(0xf16b431b65ccde7b), W64LIT(0x41e2cd1827e76a6f),
+            W64LIT(0xb9c8cf8f4e3484d7), W64LIT(0x64426efd8315244a) } },
+        { { W64LIT(0xe6ec98093a69fc01), W64LIT(0x7e20fecbfaa9dfc2),
+            W64LIT(0x5cfdbb07f56f2a55), W64LIT(0xb1cd68680bbdbfdf) },
+          { W64LIT(0x247b4995986eb9ed), W64LIT(0x74785bf53dd0955e),
+            W64LIT(0x88f74f61c0c7a201), W64LIT(0x8861a15b5d01a80d) } },
+        { { W64LIT(0x1c0a8e44fc94dea3), W64LIT(0x34c8cdbfdad6a0b0),
+            W64LIT(0x919c384004113cef), W64LIT(0xfd32fba415490ffa) },
+          { W64LIT(0x58d190f6795dcfb7), W64LIT(0xfef01b0383588baf),
+            W64LIT(0x9e6d1d63ca1fc1c0), W64LIT(0x53173f96f0a41ac9) } },
+        { { W64LIT(0x54637e4182997cc1), W64LIT(0x08c5a96ce3720c9c),
+            W64LIT(0x78bce01c11de5d45), W64LIT(0x49d623e50dfdd75a) },
+          { W64LIT(0x8c72a4680fb2a3ac), W64LIT(0xcc53bbff319c25af),
+            W64LIT(0x198eba7978a92421), W64LIT(0xcd61f28ba3bdecf3) } },
+        { { W64LIT(0x2b1d402aba16f73b), W64LIT(0x2fb310148cf9b9fc),
+            W64LIT(0x2d51e60e446ef7bf), W64LIT(0xc731021bb91e1745) },
+          { W64LIT(0x9d3b47244fee99d4), W64LIT(0x4bca48b6fac5c1ea),
+            W64LIT(0x70f5f514bbea9af7), W64LIT(0x751f55a5974c283a) } },
+        { { W64LIT(0x23899fe8662595c2), W64LIT(0x495d672711a80773),
+            W64LIT(0x86c971d2b0d1d43b), W64LIT(0xb518637c93b7a65f) },
+          { W64LIT(0x30e453bad98c99ce), W64LIT(0xba6e0d4a14d39f5b),
+            W64LIT(0xf7db02a6431ce415), W64LIT(0xcd909c7cf6e1d823) } },
+        { { W64LIT(0x6e30251acb452fdb), W64LIT(0x31ee696550f30650),
+            W64LIT(0xb0b3e508933548d9), W64LIT(0xb8949a4ff4b0ef5b) },
+          { W64LIT(0x208b83263c88f3bd), W64LIT(0xab147c30db1d9989),
+            W64LIT(0xed6515fd44d4df03), W64LIT(0x17a12f75e72eb0c5) } }
+    },
+    {   /* j * 2^200 * G */
+        { { W64LIT(0x25914f7881fdad90), W64LIT(0xcf638f560d2cf6ab),
+            W64LIT(0xb90bc03fcc054de5), W64LIT(0x932811a718b06350) },
+          { W64LIT(0x2f00b3309bbd11ff), W64LIT(0x76108a6fb4044974),
+            W64LIT(0x801bb9e0a851d266), W64LIT(0x0dd099bebf8990c1) } },
+        { { W64LIT(0x14c6dd8a58d6cd46), W64LIT(0x9cb633b58e6634d2),
+            W64LIT(0xc1305047f81bc328), W64LIT(0x12ede0e226a177e5) },
+          { W64LIT(0x332cca62065a6f4f), W64LIT(0xc3a47ecd67be487b),
+            W64LIT(0x741eb1870f47ed1c), W64LIT(0x99e66e58e7598b14) } },
+        { { W64LIT(0xebd6a6777b0ac93d), W64LIT(0xa6e37b0d78f5e0d7),
+            W64LIT(0x2516c09676f5492b), W64LIT(0x1e4bf8889ac05f3a) },
+          { W64LIT(0xcdb42ce04df0ba2b), W64LIT(0x935d5cfd5062341b),
+            W64LIT(0x8a30333382acac20), W64LIT(0x429438c45198b00e) } },
+        { { W64LIT(0xfb2838be67e573e0), W64LIT(0x05891db94084c44b),
+            W64LIT(0x9131137396c1c2c5), W64LIT(0x6aebfa3fd958444b) },
+          { W64LIT(0xac9cdce9e56e55c1), W64LIT(0x7148ced32caa46d0),
+            W64LIT(0x2e10c7efb61fe8eb), W64LIT(0x9fd835daff97cf4d) } },
+        { { W64LIT(0x6c626f56c1770616), W64LIT(0x5351909e09da9a2d),
+            W64LIT(0xe58e6825a3730e45), W64LIT(0x9d8c8bc003ef0a79) },
+          { W64LIT(0x543f78b6056becfd), W64LIT(0x33f13253a090b36d),
+            W64LIT(0x82ad4997794432f9), W64LIT(0x1386493c4721f502) } },
+        { { W64LIT(0x3794eefa5abea82a), W64LIT(0x8dc611b993fe62d4),
+            W64LIT(0x69f1af37281ef606), W64LIT(0x6af546c839839e69) },
+          { W64LIT(0x625578c7c977ec23), W64LIT(0xa8de294cbd5c0576),
+            W64LIT(0xe2ddaf0f7cd1a4c0), W64LIT(0x8243fc704f95f4d4) } },
+        { { W64LIT(0xe566f400b008733a), W64LIT(0xcba0697d512e1f57),
+            W64LIT(0x9537c2b240509cd0), W64LIT(0x5f989c6957353d8c) },
+          { W64LIT(0x7dbec9724c3c2b2f), W64LIT(0x90e02fa8ff031fa8),
+            W64LIT(0xf4d15c53cfd5d11f), W64LIT(0xb3404fae48314dfc) } },
+        { { W64LIT(0xa36da109081e9387), W64LIT(0xfb9780d78c935828),
+            W64LIT(0xd5940332e540b015), W64LIT(0xc9d7b51be0f466fa) },
+          { W64LIT(0xfaadcd41d6d9f671), W64LIT(0xba6c1e28b1a2ac17),
+            W64LIT(0x066a7833ed201e5f), W64LIT(0x19d99719f90f462b) } },
+        { { W64LIT(0xf02cc3a9f327a07f), W64LIT(0xefb27a9b4490937d),
+            W64LIT(0x81451e96b1b3afa5), W64LIT(0x67e24de891883be4) },
+          { W64LIT(0x1ad65d4770869e54), W64LIT(0xd36291a464a3856a),
+            W64LIT(0x070a1abf7132e880), W64LIT(0x9511d0a30e28dfdf) } },
+        { { W64LIT(0xfdeed650f8d1cac4), W64LIT(0xeb99194b6d16bda5),
+            W64LIT(0xb53b19f71cabbe46), W64LIT(0x5f45af5039b9276c) },
+          { W64LIT(0xd0784c6126ee9d77), W64LIT(0xf7a1558b0c02ca5d),
+            W64LIT(0xb61d6c59f032e720), W64LIT(0xae3ffb95470cf3f7) } },
+        { { W64LIT(0x9b185facc72a4be5), W64LIT(0xf66de2364d848089),
+            W64LIT(0xba14d07c717afea9), W64LIT(0x25bfbfc02d551c1c) },
+          { W64LIT(0x2cef0ecd4cdf3d88), W64LIT(0x8cee2aa3647f73c4),
+            W64LIT(0xc10a7d3d722d67f7), W64LIT(0x090037a294564a21) } },
+        { { W64LIT(0xe6567987fa9ced27), W64LIT(0x36b2d8842a9e5dbc),
+            W64LIT(0xf4bdeec6380d8e8c), W64LIT(0xb5e6a6b0dbc300d0) },
+          { W64LIT(0x7ba7e9b9592bef36), W64LIT(0x2b373c4fee81b749),
+            W64LIT(0x484b5e01f0ce596b), W64LIT(0x7cc51c62c0bf54cc) } },
+        { { W64LIT(0x6ac07bb84f3815c4), W64LIT(0xddb9f6241aa9017e),
+            W64LIT(0x31e30228ca85720a), W64LIT(0xe59d63f57cb75838) },
+          { W64LIT(0x69e18e777baad2d0), W64LIT(0x2cfdb784d42f5d73),
+            W64LIT(0x025dd53df5774983), W64LIT(0x2f80e7cee042cd52) } },
+        { { W64LIT(0x4bf56bafec695bb0), W64LIT(0x22da1ca8f13c78ad),
+            W64LIT(0x0f9c4b131182abb0), W64LIT(0x02ea555aae7d249e) },
+          { W64LIT(0x868583f25e05d9e3), W64LIT(0xe09cdcdf70382afa),
+            W64LIT(0xdf072ec787080408), W64LIT(0x0a317847cbf75658) } },
+        { { W64LIT(0x43f18d7f4d6ee4ab), W64LIT(0xd3ac8cde9570c3dc),
+            W64LIT(0x527e49070b8c9b2a), W64LIT(0x716709a7c5a4c0f1) },
+          { W64LIT(0x930852b0916a26b1), W64LIT(0x3cc17fcf4e071177),
+            W64LIT(0x34f5e3d459694868), W64LIT(0xee0341aba28f655d) } },
+        { { W64LIT(0xf431f462060b5f61), W64LIT(0xa56f46b47bd057c2),
+            W64LIT(0x348dca6c47e1bf65), W64LIT(0x9a38783e41bcf1ff) },
+          { W64LIT(0x7a5d33a9da710718), W64LIT(0x5a7799872e0aeaf6),
+            W64LIT(0xca87314d2d29d187), W64LIT(0xfa0edc3ec687d733) } }
+    },
+    {   /* j * 2^205 * G */
+        { { W64LIT(0x1c894849cb198ac7), W64LIT(0xa884a93d0f264665),
+            W64LIT(0x2da964ef9b200678), W64LIT(0x3c351b87009834e6) },
+          { W64LIT(0xafb2ef9fe2c4b44b), W64LIT(0x580f6c473326790c),
+            W64LIT(0xb84805210b02264a), W64LIT(0x8ba6f9e242a194e2) } },
+        { { W64LIT(0x39d934abd3c095f1), W64LIT(0x04b261bee4b76d71),
+            W64LIT(0x1d2e6970e73e6984), W64LIT(0x879fb23b5e5fcb11) },
+          { W64LIT(0x11506c72dfd75490), W64LIT(0x3a97d08561bcf1c1),
+            W64LIT(0x43201d82bf5e7007), W64LIT(0x7f0ac52f798232a7) } },
+        { { W64LIT(0xb25101fb319d7682), W64LIT(0xb02931290a982fee),
+            W64LIT(0x51c1c9b90261b344), W64LIT(0x0e008c5bbfd371fa) },
+          { W64LIT(0xd866dd1c0278ca33), W64LIT(0x666f76a6e5aa53b1),
+            W64LIT(0xe5cfb7796013a2cf), W64LIT(0x1d3a1aada3521836) } },
+        { { W64LIT(0x76b4131a567193ec), W64LIT(0xaf3c305ae5f6e70b),
+            W64LIT(0x9587bd39031eebdd), W64LIT(0x5709def871bbe831) },
+          { W64LIT(0x570599830eb2b669), W64LIT(0x4d80ce1b875b7029),
+            W64LIT(0x838a7da80364ac16), W64LIT(0x2f431d23be1c83ab) } },
+        { { W64LIT(0xe781276638235d4e), W64LIT(0x1c62bd67496e3298),
+            W64LIT(0x8378660c3f175bc8), W64LIT(0x4d04e18917afdd4d) },
+          { W64LIT(0x32a8160185a8068c), W64LIT(0xdb58e4e192b29a85),
+            W64LIT(0xe8a65b86c70d8a3b), W64LIT(0x5f0e6f4e98a0403b) } },
+        { { W64LIT(0x2c2492b73f894ae0), W64LIT(0xf59df3e5b75f18ce),
+            W64LIT(0x7cb740d28f53cad0), W64LIT(0x3eb585fbc4f01294) },
+          { W64LIT(0x17da0c8632c7f717), W64LIT(0xeb8c795baf943f4c),
+            W64LIT(0x4ee23fb5f67c51d2), W64LIT(0xef18757568889949) } },
+        { { W64LIT(0x3ea011a4e822f0d0), W64LIT(0xbc647ad15a8704f8),
+            W64LIT(0xbb315b3550c6820f), W64LIT(0x863dec3db7e76bec) },
+          { W64LIT(0x01ff5d3af017bfc7), W64LIT(0x20054439976b8229),
+            W64LIT(0x067fca370bbd0d3b), W64LIT(0xf63dde647f5e3d0f) } },
+        { { W64LIT(0x75d9bc15adf7cccf), W64LIT(0x81a3e5d6dfa1e1b0),
+            W64LIT(0x8c39e444249bc17e), W64LIT(0xf37dccb28ea7fd43) },
+          { W64LIT(0xda654873907fba12), W64LIT(0x35daa6da4a372904),
+            W64LIT(0x0564cfc66283a6c5), W64LIT(0xd09fa4f64a9395bf) } },
+        { { W64LIT(0xb510b3b56aa39dff), W64LIT(0x59b43da29f8e4d8c),
+            W64LIT(0xa8ce31fd9e4c4b9f), W64LIT(0x0e20be26c1303c01) },
+          { W64LIT(0x18187182e8ee47c9), W64LIT(0xd9687cdb7db98101),
+            W64LIT(0x7a520e4da1e14ff6), W64LIT(0x429808ba8836d572) } },
+        { { W64LIT(0x174d46996d16768e), W64LIT(0x9fc4ff6a628bf217),
+            W64LIT(0x77705a94154e490d), W64LIT(0x9d96dd288d2d997a) },
+          { W64LIT(0x77e2d9d8ce5d72c4), W64LIT(0x9d06c5a4c11c714f),
+            W64LIT(0x02aa513679e4a03e), W64LIT(0x1386b3c2030ff28b) } },
+        { { W64LIT(0x26a42d69ea40dc3a), W64LIT(0xdc84ad22aecc018f),
+            W64LIT(0x25c36c7b3270f04a), W64LIT(0x46ba6d4750fa72ed) },
+          { W64LIT(0x6c37d1c593e58a8e), W64LIT(0xa2394731120c088c),
+            W64LIT(0xc3be4263cb6e86da), W64LIT(0x2c417d367126d038) } },
+        { { W64LIT(0xcca523bb440e2229), W64LIT(0x324673a273ef4d04),
+            W64LIT(0xaf3adf343e11ec39), W64LIT(0x6136d7f1dc5968d3) },
+          { W64LIT(0x7a7b2899b053a927), W64LIT(0x3eaa2661ae067ecd),
+            W64LIT(0x8549b9c802779cd9), W64LIT(0x061d7940c53385ea) } },
+        { { W64LIT(0xe07141fcaaa2902b), W64LIT(0x539ad799e4f69ad3),
+            W64LIT(0xa6453f94813f9ffd), W64LIT(0xc58d3c48375bc2f7) },
+          { W64LIT(0xb3326fad5dc64e96), W64LIT(0x3aafcaa9b240e354),
+            W64LIT(0x1d1b0903aca1e7a9), W64LIT(0x4ceb97671211b8a0) } },
+        { { W64LIT(0x1eb4de4687032d58), W64LIT(0xc54f3d835e2c79e0),
+            W64LIT(0x07818df45d04ef23), W64LIT(0x55faa9c8673d41b4) },
+          { W64LIT(0xced64f6f89b95355), W64LIT(0x4860d2eab7415c84),
+            W64LIT(0x5fdb9bd2050ebad3), W64LIT(0xdb53e0cc6685a5bf) } },
+        { { W64LIT(0x919fca5fabfae1ca), W64LIT(0x937afaac1a21459b),
+            W64LIT(0x9e0ca91c1f66a4d2), W64LIT(0x194cc7f323ec1331) },
+          { W64LIT(0xad25143a8aa11690), W64LIT(0xbe40ad8d09b59e08),
+            W64LIT(0x37d60d9be750860a), W64LIT(0x6c53b008c6bf434c) } },
+        { { W64LIT(0x832d7080eb6b242d), W64LIT(0xd30bd0233b71e246),
+            W64LIT(0x7027991bbe31139d), W64LIT(0x68797e91462e4e53) },
+          { W64LIT(0x423fe20a6b4e185a), W64LIT(0x82f2c67e42d9b707),
+            W64LIT(0x25c817684cf7811b), W64LIT(0xbd53005e045bb95d) } }
+    },
+    {   /* j * 2^210 * G */
+        { { W64LIT(0xe5f649be9d8e68fd), W64LIT(0xdb0f05331b044320),
+            W64LIT(0xf6fde9b3e0c33398), W64LIT(0x92f4209b66c8cfae) },
+          { W64LIT(0xe9d1afcc1a739d4b), W64LIT(0x09aea75fa28ab8de),
+            W64LIT(0x14375fb5eac6f1d0), W64LIT(0x6420b560708f7aa5) } },
+        { { W64LIT(0x9eae499c6254dc41), W64LIT(0x7e2939247a837e7e),
+            W64LIT(0x74aec08c090524a7), W64LIT(0xf82b92198d6f55f2) },
+          { W64LIT(0x493c962e1402cec5), W64LIT(0x9f17ca17fa2f30e7),
+            W64LIT(0xbcd783e8e9b879cb), W64LIT(0xea3d8c145a6f145f) } },
+        { { W64LIT(0xdede15e75e0dee6e), W64LIT(0x74f24872dc628aa2),
+            W64LIT(0xd3e9c4fe7861bb93), W64LIT(0x56d4822a6187b2e0) },
+          { W64LIT(0xb66417cfc59826f9), W64LIT(0xca2609692408169e),
+            W64LIT(0xedf69d06c79ef885), W64LIT(0x00031f8adc7d138f) } },
+        { { W64LIT(0x103c46e60ebcf726), W64LIT(0x4482b8316231470e),
+            W64LIT(0x6f6dfaca487c2109), W64LIT(0x2e0ace9762e666ef) },
+          { W64LIT(0x3246a9d31f8d1f42), W64LIT(0x1b1e83f1574944d2),
+            W64LIT(0x13dfa63aa57f334b), W64LIT(0x0cf8daed9f025d81) } },
+        { { W64LIT(0x30d78ea800ee11c1), W64LIT(0xeb053cd4b5e3dd75),
+            W64LIT(0x9b65b13ed58c43c5), W64LIT(0xc3ad49bdbd151663) },
+          { W64LIT(0x99fd8e41b6427990), W64LIT(0x12cf15bd707eae1e),
+            W64LIT(0x29ad4f1b1aabb71e), W64LIT(0x5143e74d07545d0e) } },
+        { { W64LIT(0x30266336c88bdee1), W64LIT(0x25f293065876767c),
+            W64LIT(0x9c078571c6731996), W64LIT(0xc88690b2ed552951) },
+          { W64LIT(0x274f2c2d852705b4), W64LIT(0xb0bf8d444e09552d),
+            W64LIT(0x7628beeb986575d1), W64LIT(0x407be2387f864651) } },
+        { { W64LIT(0x0e5e3049a639fc6b), W64LIT(0xe75c35d986003625),
+            W64LIT(0x0cf35bd85dcc1646), W64LIT(0x8bcaced26c26273a) },
+          { W64LIT(0xe22ecf1db5536742), W64LIT(0x013dd8971a9e068b),
+            W64LIT(0x17f411cb8a7909c5), W64LIT(0x5757ac98861dd506) } },
+        { { W64LIT(0x85de1f0d1e935abb), W64LIT(0xdefd10b4154de37a),
+            W64LIT(0xb8d9e392369cebb5), W64LIT(0x54d5ef9b761324be) },
+          { W64LIT(0x4d6341ba74f17e26), W64LIT(0xc0a0e3c878c1dde4),
+            W64LIT(0xa6d7758187d918fd), W64LIT(0x6687601502ca3a13) } },
+        { { W64LIT(0xc7313e9cf36658f0), W64LIT(0xc433ef1c71f8057e),
+            W64LIT(0x853262461b6a835a), W64LIT(0xc8f053987c86394c) },
+          { W64LIT(0xff398cdfe983c4a1), W64LIT(0xbf5e816203b7b931),
+            W64LIT(0x93193c46b7b9045b), W64LIT(0x1e4ebf5da4a6e46b) } },
+        { { W64LIT(0xf9942a6043a24fe7), W64LIT(0x29c1191effb3492b),
+            W64LIT(0x9f662449902fde05), W64LIT(0xc792a7ac6713c32d) },
+          { W64LIT(0x2fd88ad8b737982c), W64LIT(0x7e3a0319a21e60e3),
+            W64LIT(0x09b0de447383591a), W64LIT(0x6df141ee8310a456) } },
+        { { W64LIT(0xaec1a039e6d6f471), W64LIT(0x14b2ba0f1198d12e),
+            W64LIT(0xebc1a1603aeee5ac), W64LIT(0x401f4836e0b964ce) },
+          { W64LIT(0x2ee437964fd03f66), W64LIT(0x3fdb4e49dd8f3f12),
+            W64LIT(0x6ef267f629380f18), W64LIT(0x3e8e96708da64d16) } },
+        { { W64LIT(0xbc19180c207674f1), W64LIT(0x112e09a733ae8fdb),
+            W64LIT(0x996675546aaeb71e), W64LIT(0x79432af1e101b1c7) },
+          { W64LIT(0xd5eb558fde2ddec6), W64LIT(0x81392d1f5357753f),
+            W64LIT(0xa7a76b973ae1158a), W64LIT(0x416fbbff4a899991) } },
+        { { W64LIT(0x9e65fdfd0d4a9dcf), W64LIT(0x7bc29e48944ddf12),
+            W64LIT(0xbc1a92d93c856866), W64LIT(0x273c69056e98dfe2) },
+          { W64LIT(0x69fce418cdfaa6b8), W64LIT(0x606bd8235061c69f),
+            W64LIT(0x42d495a06af75e27), W64LIT(0x8ed3d5056d873a1f) } },
+        { { W64LIT(0xaf5528416ab25b6a), W64LIT(0xc6c0ffc72b1a4523),
+            W64LIT(0xab18827b21c99e03), W64LIT(0x060e86489034691b) },
+          { W64LIT(0x5207f90f93c7f398), W64LIT(0x9f4a96cb82f8d10b),
+            W64LIT(0xdd71cd793ad0f9e3), W64LIT(0x84f435d2fc3a54f5) } },
+        { { W64LIT(0x4b03c55b8e33787f), W64LIT(0xef42f975a6384673),
+            W64LIT(0xff7304f75051b9f0), W64LIT(0x18aca1dc741c87c2) },
+          { W64LIT(0x56f120a72d4bfe80), W64LIT(0xfd823b3d053e732c),
+            W64LIT(0x11bccfe47537ca16), W64LIT(0xdf6c9c741b5a996b) } },
+        { { W64LIT(0xee7332c7904fc3fa), W64LIT(0x14a23f45c7e3636a),
+            W64LIT(0xc38659c3f091d9aa), W64LIT(0x4a995e5db12d8540) },
+          { W64LIT(0x20a53becf3a5598a), W64LIT(0x56534b17b1eaa995),
+            W64LIT(0x9ed3dca4bf04e03c), W64LIT(0x716c563ad8d56268) } }
+    },
+    {   /* j * 2^215 * G */
+        { { W64LIT(0x5043dea7e0f222c2), W64LIT(0x309d42ac72e65142),
+            W64LIT(0x94fe9ddd9216cd30), W64LIT(0xd6539c7d0f87feec) },
+          { W64LIT(0x03c5a57c432ac7d7), W64LIT(0x72692cf0327fda10),
+            W64LIT(0xec28c85f280698de), W64LIT(0x2331fb467ec283b1) } },
+        { { W64LIT(0xa0158eeae457a477), W64LIT(0xd19857dbee6ddc05),
+            W64LIT(0xb326522418c41671), W64LIT(0x3ffdfc7e3c2c0d58) },
+          { W64LIT(0x3a3a525426ee7cda), W64LIT(0x341b0869df02c3a8),
+            W64LIT(0xa023bf42723bbfc8), W64LIT(0x3d15002a14452691) } },
+        { { W64LIT(0xc961b2f687500b96), W64LIT(0x795510e72dcd9425),
+            W64LIT(0x0308172978615433), W64LIT(0xe5d0145465445029) },
+          { W64LIT(0x5bd13302bf690cbe), W64LIT(0x44e48831731eca67),
+            W64LIT(0x73306bc72b8038a4), W64LIT(0x351d151ebf57bf02) } },
+        { { W64LIT(0x5ef7324c85edfa30), W64LIT(0x2597655487d4f3da),
+            W64LIT(0x352f5bc0dcb50c86), W64LIT(0x8f6927b04832a96c) },
+          { W64LIT(0xd08ee1ba55f2f94c), W64LIT(0x6a996f99344b45fa),
+            W64LIT(0xe133cb8da8aa455d), W64LIT(0x5d0721ec758dc1f7) } },
+        { { W64LIT(0xf3d44e1f9a876441), W64LIT(0x82bc0c14147a818d),
+            W64LIT(0x33ddc1170603edde), W64LIT(0x77163f2e0a25f260) },
+          { W64LIT(0xb54c02caa3bfaa53), W64LIT(0xbd1b2502e2256982),
+            W64LIT(0xc4e1728c1a6f37dc), W64LIT(0xfe36c213814c94a5) } },
+        { { W64LIT(0xf3cae7e9262a3539), W64LIT(0x78a49d1d6670d59e),
+            W64LIT(0x37de0f63c1c5e1b9), W64LIT(0x3072c30c69cb7c1c) },
+          { W64LIT(0x1d278a5277c850e6), W64LIT(0x84f15f8f1f6a3de6),
+            W64LIT(0x46a8bb45592ca7ad), W64LIT(0x1912e3eee4d424b8) } },
+        { { W64LIT(0xc1ffe2d490e31734), W64LIT(0x91b1f1267fca007c),
+            W64LIT(0x5459b1d0ae3f77e8), W64LIT(0x262b051d46425c88) },
+          { W64LIT(0xcf5c8f765c51e274), W64LIT(0x997481e2304e6146),
+            W64LIT(0x6fc1198bd84046b5), W64LIT(0x1cb0a6bbe7f7a6bd) } },
+        { { W64LIT(0x6ba7a92079e5fb67), W64LIT(0xe1331feb70aa725e),
+            W64LIT(0x5080ccf57df5d837), W64LIT(0xe4cae01d7ff72e21) },
+          { W64LIT(0xd9243ee60412a77d), W64LIT(0x06ff7cacdf449025),
+            W64LIT(0xbe75f7cd23ef5a31), W64LIT(0xbc9578220ddef7a8) } },
+        { { W64LIT(0xc4737ad11b7f30b0), W64LIT(0x525ab2c63629dcf9),
+            W64LIT(0x963f4cc1186ae160), W64LIT(0x8507671373e6b6e0) },
+          { W64LIT(0xd9be3180f6998bcf), W64LIT(0x93d91da3b1c8d8d8),
+            W64LIT(0xf902ce661b8c0054), W64LIT(0x47e7924d74a8a768) } },
+        { { W64LIT(0xdc988086365e668b), W64LIT(0xada8dcdaaabda5fb),
+            W64LIT(0xbc146b4c255f1fbe), W64LIT(0x9cfcde29cf34cfc3) },
+          { W64LIT(0xacbb453e7e85d1e4), W64LIT(0x9ca09679f92358b5),
+            W64LIT(0x15fc2d96240823ff), W64LIT(0x8d65adf70c11d11e) } },
+        { { W64LIT(0x323cfd177e19a46f), W64LIT(0x0948a7a786161156),
+            W64LIT(0x50d06b977e7d3363), W64LIT(0x41c47ec1a702579d) },
+          { W64LIT(0x9455998e59e9260b), W64LIT(0xc865e44446c24260),
+            W64LIT(0x393021ec13bc3744), W64LIT(0x4981994ecd92a14a) } },
+        { { W64LIT(0x8cf7230cb0ce1c55), W64LIT(0x5b534d050bbfb607),
+            W64LIT(0xee1ef1130e16363b), W64LIT(0x27e0aa7ab4999e82) },
+          { W64LIT(0xce1dac2d79362c41), W64LIT(0x67920c9091bb6cb0),
+            W64LIT(0x1e648d632223df24), W64LIT(0x0f7d9eefe32e8f28) } },
+        { { W64LIT(0x9766f264d66f51c0), W64LIT(0x644317ab5d9ccea5),
+            W64LIT(0xa39b37bcd721e232), W64LIT(0x98bdde0bb9daf737) },
+          { W64LIT(0xc2ecc758165166bd), W64LIT(0x0951a285a2802108),
+            W64LIT(0xe39fbf24997aa66f), W64LIT(0x1a2f6862db62da27) } },
+        { { W64LIT(0x775557f10296f4fd), W64LIT(0x1dca76a3ea51b436),
+            W64LIT(0xf3e98f60fb950805), W64LIT(0x31ff32ea831cf7f1) },
+          { W64LIT(0x643e7bf18d2c714b), W64LIT(0x64b5c3392e9d2aca),
+            W64LIT(0xa9fd9ccc6adc2d23), W64LIT(0xfc2397eccc721b9b) } },
+        { { W64LIT(0xab651fc764465367), W64LIT(0xe43870152b098f57),
+            W64LIT(0x0a91d519d382376f), W64LIT(0xb5afdb0a53cad929) },
+          { W64LIT(0x457e1875138d5523), W64LIT(0xa92becae1aecacfb),
+            W64LIT(0x0762f6e811484f49), W64LIT(0x114b5c86dda16c2b) } },
+        { { W64LIT(0x6943f39afa833834), W64LIT(0x22951722a6328562),
+            W64LIT(0x81d63dd54170fc10), W64LIT(0x9f5fa58faecc2e6d) },
+          { W64LIT(0xb66c8725e77d9a3b), W64LIT(0x11235cea6384ebe0),
+            W64LIT(0x06a8c1185845e24a), W64LIT(0x0137b286ebd093b1) } }
+    },
+    {   /* j * 2^220 * G */
+        { { W64LIT(0xdb567d6ac42bd6d2), W64LIT(0x6df86468bb1f96ae),
+            W64LIT(0x0efe5b1a4843b28e), W64LIT(0x961bbb056379b240) },
+          { W64LIT(0xb6caf5f070a6a26b), W64LIT(0x70686c0d328e6e39),
+            W64LIT(0x80da06cf895fc8d3), W64LIT(0x804d8810b363fdc9) } },
+        { { W64LIT(0x63b99ce74462007d), W64LIT(0xb8ab48a54cb5f5b7),
+            W64LIT(0x9ec673d2f55edde7), W64LIT(0xd1567f748cfaefda) },
+          { W64LIT(0x46381b6b0887bcec), W64LIT(0x694497cee178f3c2),
+            W64LIT(0x5e6525e31e6266cb), W64LIT(0x5931de26697d6413) } },
+        { { W64LIT(0x14e49da11f17a34c), W64LIT(0x5420ab39235a1456),
+            W64LIT(0xb76372412f50363b), W64LIT(0x7b15d623c3fabb6e) },
+          { W64LIT(0xa0ef40b1e274e49c), W64LIT(0x5cf5074496b1860a),
+            W64LIT(0xd6583fbf66afe5a4), W64LIT(0x44240510f47e3e9a) } },
+        { { W64LIT(0x142b55021a93507a), W64LIT(0xb4cd11878d3c06cf),
+            W64LIT(0xdf70e76a91ec3f40), W64LIT(0x484e81ad4e7553c2) },
+          { W64LIT(0x830f87b5272e9d6e), W64LIT(0xea1c93e5c6ff514a),
+            W64LIT(0x67cc2adcc4192a8e), W64LIT(0xc77e27e242f4535a) } },
+        { { W64LIT(0xb5358b1e48ac2840), W64LIT(0x18311294ecba9477),
+            W64LIT(0xda58f990a6946b43), W64LIT(0x3098baf99ab41819) },
+          { W64LIT(0x66c4c1584198da52), W64LIT(0xab4fc17c146bfd1b),
+            W64LIT(0x2f0a4c3cbf36a908), W64LIT(0x2ae9e34b58cf7838) } },
+        { { W64LIT(0x45eb40ec0ccced58), W64LIT(0x25cd4b9c0da44f98),
+            W64LIT(0x43e06458871812c6), W64LIT(0x99f80d5516cef651) },
+          { W64LIT(0x571340c9ce6dc153), W64LIT(0x138d5117d8665521),
+            W64LIT(0xacdb45bc4e07014d), W64LIT(0x2f34bb3884b60b91) } },
+        { { W64LIT(0x417499e84a34f239), W64LIT(0x15fdb83cb90402d5),
+            W64LIT(0xb75f46bf433aa832), W64LIT(0xb61e15af63215db1) },
+          { W64LIT(0xaabe59d4a127f89a), W64LIT(0x5d541e0c07e816da),
+            W64LIT(0xaaba0659a618b692), W64LIT(0x5532773317266026) } },
+        { { W64LIT(0x8cda9cf2d0c05199), W64LIT(0x502fbc22fae78454),
+            W64LIT(0xc0bda9dff572a182), W64LIT(0x5f9b71b86158b372) },
+          { W64LIT(0xe0f33a592b82dd07), W64LIT(0x763027359523032e),
+            W64LIT(0x7fe1a721c4505a32), W64LIT(0x7b6e3e82f796409f) } },
+        { { W64LIT(0x023c155d3f6effc7), W64LIT(0x1fbd69ff9c90f0c7),
+            W64LIT(0xe5d7da8abeec2c5d), W64LIT(0x8813872bd7e86273) },
+          { W64LIT(0x9f3bc2c655f5e228), W64LIT(0x11482869b0923b41),
+            W64LIT(0x65d75c741aa307ca), W64LIT(0xda92c2577f24eee5) } },
+        { { W64LIT(0x26357732edc665d1), W64LIT(0x9fb5b731a939ef1b),
+            W64LIT(0x7db720fb94968089), W64LIT(0x36f75f2c33138c52) },
+          { W64LIT(0xf8b793ec48d3cb97), W64LIT(0x8dff1d456d261726),
+            W64LIT(0xfb65791b885c4ffb), W64LIT(0xf7c79e2df1a3a870) } },
+        { { W64LIT(0x08dd1028754c92e1), W64LIT(0xca90b57acf0fef34),
+            W64LIT(0x1a9b84ac8af55919), W64LIT(0xaa95e0e1ed93686b) },
+          { W64LIT(0x46737315167021a4), W64LIT(0x6cb6a0da20d5ff98),
+            W64LIT(0xecc4801a1092e706), W64LIT(0xedcab23a3c5e61a6) } },
+        { { W64LIT(0xb4c66356ea37ba9e), W64LIT(0x1adc84150afff55d),
+            W64LIT(0xf0080ef9596cc862), W64LIT(0x756c85b86d647ab6) },
+          { W64LIT(0xc9db94aa1db9c215), W64LIT(0x2dd36db12013b1a5),
+            W64LIT(0xde6ac61c4286c903), W64LIT(0x3fd32f88c76cf884) } },
+        { { W64LIT(0x7f1290fca06d107e), W64LIT(0x697261fdb7661137),
+            W64LIT(0x1bb5be4e947b4b38), W64LIT(0xb49826b63bb79130) },
+          { W64LIT(0x019ddfe85ba8bffb), W64LIT(0xb1af79007e3fa8e4),
+            W64LIT(0x72e1bdf201bcfe7f), W64LIT(0x2ed3ca8fd1169aea) } },
+        { { W64LIT(0x3befda8cd745fff1), W64LIT(0x70b9e9b669b9924e),
+            W64LIT(0xa5df48cfd1511381), W64LIT(0x84f93fe2d06bc535) },
+          { W64LIT(0xaa42c5a9b279a6c3), W64LIT(0x651da6c4d8f96132),
+            W64LIT(0xb0368c8b01b6aea5), W64LIT(0x64e44c47ac7862a2) } },
+        { { W64LIT(0xe17a9947d9de99a8), W64LIT(0xc2e61b2dc93477bd),
+            W64LIT(0x57f684d41d19e287), W64LIT(0x843c2122fe358135) },
+          { W64LIT(0xe2d3e2e904f7e8ab), W64LIT(0xbf93ffe9b5f27aee),
+            W64LIT(0x29830d1d7b1858c4), W64LIT(0xa8f449648106adbf) } },
+        { { W64LIT(0xe3417bc035d0b34a), W64LIT(0x440b386b8327c0a7),
+            W64LIT(0x8fb7262dac0362d1), W64LIT(0x2c41114ce0cdf943) },
+          { W64LIT(0x2ba5cef1ad95a0b1), W64LIT(0xc09b37a867d54362),
+            W64LIT(0x26d6cdd201e486c9), W64LIT(0x20477abf42ff9297) } }
+    },
+    {   /* j * 2^225 * G */
+        { { W64LIT(0xa004dcb3292a9287), W64LIT(0xddc15cf677b092c7),
+            W64LIT(0x083a8464806c0605), W64LIT(0x4a68df703db997b0) },
+          { W64LIT(0x9c134e4505bf7dd0), W64LIT(0xa4e63d398ccf7f8c),
+            W64LIT(0xa6e6517f41b5f8af), W64LIT(0xaa8b9342ad7bc1cc) } },
+        { { W64LIT(0xc41764717af715d2), W64LIT(0xe2f7f594d0134a96),
+            W64LIT(0x2c1873efa41ec956), W64LIT(0xe4e7b4f677821304) },
+          { W64LIT(0xe5c8ff9788d5374a), W64LIT(0x2b915e6380823d5b),
+            W64LIT(0xea6bc755b2ee8fe2), W64LIT(0x6657624ce7112651) } },
+        { { W64LIT(0xd6f800e07442f1d5), W64LIT(0x475607d166e0e3ab),
+            W64LIT(0x82807f16b7c64047), W64LIT(0x8858e1e3a749883d) },
+          { W64LIT(0x5859120b8231ee10), W64LIT(0x1b80e7eb638a1ece),
+            W64LIT(0xcb72525ac6aa73a4), W64LIT(0xa7cdea3d844423ac) } },
+        { { W64LIT(0x57477b11e51732d2), W64LIT(0xdfd6eb282538fc0e),
+            W64LIT(0x5c43b0cc3b39eec5), W64LIT(0x6af12778cb36cc57) },
+          { W64LIT(0x70b0852d06c425ae), W64LIT(0x6df92f8c5c221b9b),
+            W64LIT(0x6c8d4f9ece826d9c), W64LIT(0xf59aba7bb49359c3) } },
+        { { W64LIT(0xd2eb2cf152bfda05), W64LIT(0xe0e4c4e96197b98c),
+            W64LIT(0x1d35076cf8a1726f), W64LIT(0x6c06085b2db11e3d) },
+          { W64LIT(0x15c0c4d74463ba14), W64LIT(0x9d292f830030238c),
+            W64LIT(0x1311ee8b3727536d), W64LIT(0xfeea86efbeaedc1e) } },
+        { { W64LIT(0xa7f96054afa05dd8), W64LIT(0x26dfcf21fcaf119e),
+            W64LIT(0xe20ef2e30564bb59), W64LIT(0xef4dca5061cb02b8) },
+          { W64LIT(0xcda7838a65d30672), W64LIT(0x8b08d534fd657e86),
+            W64LIT(0x4c5b439546d595c8), W64LIT(0x39b58725425cb836) } },
+        { { W64LIT(0xfda853931a62cc26), W64LIT(0x23c69b9650c0e052),
+            W64LIT(0xa227df15bfc633f3), W64LIT(0x2ac788481bae7d48) },
+          { W64LIT(0x487878f9187d073d), W64LIT(0x6c2be919967f807d),
+            W64LIT(0x765861d8336e6d8f), W64LIT(0x88b8974cce528a43) } },
+        { { W64LIT(0xc37e2c2e421d3aa4), W64LIT(0xf926407ce84fa840),
+            W64LIT(0x18abc03d1454e41c), W64LIT(0x26605ecd3f7af644) },
+          { W64LIT(0x242341a6d6a5eabf), W64LIT(0x1edb84f4216b668e),
+            W64LIT(0xd836edb804010102), W64LIT(0x5b337ce7945e1d8c) } },
+        { { W64LIT(0x666ba2dccc78cf66), W64LIT(0xb30181746fdbff77),
+            W64LIT(0x8d4dd0db168d4668), W64LIT(0x259455d01dab3a2a) },
+          { W64LIT(0xf58564c5cde3acec), W64LIT(0x7714192513adb276),
+            W64LIT(0x527d725d8a303f65), W64LIT(0x55deb6c9e6f38f7b) } },
+        { { W64LIT(0x864d05d73272d838), W64LIT(0xe22924f9fa6295c5),
+            W64LIT(0x8189593f6c2fda32), W64LIT(0x330d7189b184b544) },
+          { W64LIT(0x79efa62cbde1f714), W64LIT(0x35771c94e5cb1a63),
+            W64LIT(0x2f4826b8641c8332), W64LIT(0x00a894fbc8cee854) } },
+        { { W64LIT(0xdcdacd0a1058a318), W64LIT(0x369cf3f578053a9a),
+            W64LIT(0xc6c3de5031c68de2), W64LIT(0x4653a5763c4b6d9f) },
+          { W64LIT(0x1688dd5aaa4e5c97), W64LIT(0x5be80aa1b7ab3c74),
+            W64LIT(0x70cefe7cbc65c283), W64LIT(0x57f95f1306867091) } },
+        { { W64LIT(0xc240b6de34eaacda), W64LIT(0xd9e116e82ba0f1de),
+            W64LIT(0xcbe45ec779438e55), W64LIT(0x91787c9d96f752d7) },
+          { W64LIT(0x897f532bf129ac2f), W64LIT(0xd307b7c85a36e22c),
+            W64LIT(0x91940675749fb8f3), W64LIT(0xd14f95d0157fdb28) } },
+        { { W64LIT(0x1625360416df4285), W64LIT(0xb0c9babbd0c56ae2),
+            W64LIT(0x73032b19cfc5cfc3), W64LIT(0xe497e5c309752056) },
+          { W64LIT(0x12096bb4164bda96), W64LIT(0x1ee42419a0b74da1),
+            W64LIT(0x8fc36243403826ba), W64LIT(0x0c8f0069dc09e660) } },
+        { { W64LIT(0xc44b74a15b0ec6f5), W64LIT(0x47989fe45289b2b8),
+            W64LIT(0x745f848458d6fc73), W64LIT(0xec362a6ff61c70ab) },
+          { W64LIT(0x070c98a7b3a8ad41), W64LIT(0x73a20fc07b63db51),
+            W64LIT(0xed2c2173f44c35f4), W64LIT(0x8a56149d9acc9dca) } },
+        { { W64LIT(0xa395c36f35d33ae7), W64LIT(0x200ea12350bb5a94),
+            W64LIT(0x20c789bd0bafe84b), W64LIT(0x243ef52d0919276a) },
+          { W64LIT(0x3934c577e23ae233), W64LIT(0xb93807afa460d1ec),
+            W64LIT(0xb72a53b1f8fa76a4), W64LIT(0xd8914cb0c3ca4491) } },
+        { { W64LIT(0x4c076b86d23ddc82), W64LIT(0x03fd344c7e0143f0),
+            W64LIT(0xa95362ff317af2c5), W64LIT(0x0add3db7e18b7a4f) },
+          { W64LIT(0x9c673e3f8260e01b), W64LIT(0xfbeb49e554a1cc91),
+            W64LIT(0x91351bf292f2e433), W64LIT(0xc755e7ec851141eb) } }
+    },
+    {   /* j * 2^230 * G */
+        { { W64LIT(0x2bf5db47f23206d5), W64LIT(0x2f6d34201d260152),
+            W64LIT(0x17b876533f8ff89a), W64LIT(0x5157c30c378fa458) },
+          { W64LIT(0x7517c5c52d4fb936), W64LIT(0xef22f7ace6518cdc),
+            W64LIT(0xdeb483e6bf847a64), W64LIT(0xf508455892e0fa89) } },
+        { { W64LIT(0xab9659d8df7304d4), W64LIT(0xb71bcf1bff210e8e),
+            W64LIT(0xa9a2438bd73fbd60), W64LIT(0x4595cd1f5d11b4de) },
+          { W64LIT(0x9c0d329a4835859d), W64LIT(0x4a0f0d2d7dbb6e56),
+            W64LIT(0xc6038e5edf928a4e), W64LIT(0xc94296218f5ad154) } },
+        { { W64LIT(0x08a33840a70c6ec4), W64LIT(0x9e8819f7e0311195),
+            W64LIT(0xed209d96708ab202), W64LIT(0x10d7c4e7ce943a27) },
+          { W64LIT(0x372fb317a29b49a1), W64LIT(0x57a67fb346627d1f),
+            W64LIT(0xf912561e7cdf39ec), W64LIT(0xfa3ce6f26f7c8f17) } },
+        { { W64LIT(0x91213462f23f2d92), W64LIT(0x6cab71bd60b94078),
+            W64LIT(0x6bdd0a63176cde20), W64LIT(0x54c9b20cee4d54bc) },
+          { W64LIT(0x3cd2d8aa9f2ac02f), W64LIT(0x03f8e617206eedb0),
+            W64LIT(0xc7f68e1693086434), W64LIT(0x831469c592dd3db9) } },
+        { { W64LIT(0xfe7d7465653f3c5f), W64LIT(0x283dd45ef040feb1),
+            W64LIT(0x91fe599bf3b7edfe), W64LIT(0x5ff039ad80379311) },
+          { W64LIT(0xbf76995b4e96fa49), W64LIT(0x2640b6b2a3e25094),
+            W64LIT(0x8b096341c1c83f74), W64LIT(0xd2bec884fa560ac3) } },
+        { { W64LIT(0x8521df248f981354), W64LIT(0x587e23ec3588a259),
+            W64LIT(0xcbedf281d7a0992c), W64LIT(0x06930a5538961407) },
+          { W64LIT(0x09320debbe5bbe21), W64LIT(0xa7ffa5b52491817f),
+            W64LIT(0xe6c8b4d909065160), W64LIT(0xac4f3992fff6d2a9) } },
+        { { W64LIT(0x2e4eb2a3cc53da66), W64LIT(0x04708a71f17a9b4e),
+            W64LIT(0xdbfdc7b20de05b2c), W64LIT(0x4cdc9aee4907a201) },
+          { W64LIT(0xe5cc8dfc6c475566), W64LIT(0x2b83cbfb47be1691),
+            W64LIT(0x695833a74c05c3fd), W64LIT(0xee938a7243b0deb0) } },
+        { { W64LIT(0x7aa7a1583ae9c1bd), W64LIT(0xe0af6d98e37ce240),
+            W64LIT(0xe54342d928ab38b4), W64LIT(0xe8b750070a1c98ca) },
+          { W64LIT(0xefce86afe02358f2), W64LIT(0x31b8b856ea921228),
+            W64LIT(0x052a19120a1c67fc), W64LIT(0xb4069ea4e3aead59) } },
+        { { W64LIT(0x3b826205c6ffcfe6), W64LIT(0x2eb31256aa39418a),
+            W64LIT(0xc4b4a9e1c18521fb), W64LIT(0x48614dd8db610615) },
+          { W64LIT(0x04c362bbeea7475f), W64LIT(0x916ab969a8ead162),
+            W64LIT(0x6a7975bc0310a876), W64LIT(0xea4e7d11ecc77ec4) } },
+        { { W64LIT(0x3232d6e27fa03cb3), W64LIT(0xdb938e5b0fdd7d88),
+            W64LIT(0x04c1d2cd2ccbfc5d), W64LIT(0xd2f45c12af3a580f) },
+          { W64LIT(0x592620b57883e614), W64LIT(0x5fd27e68be7c5f26),
+            W64LIT(0x139e45a91567e1e3), W64LIT(0x2cc71d2d44d8aaaf) } },
+        { { W64LIT(0x6ef493c706ba8e6f), W64LIT(0x05c07bf8123deffd),
+            W64LIT(0xcebf9b4d9c2b5a4f), W64LIT(0xf958147e2d038e9c) },
+          { W64LIT(0x5af5cee03e5561c4), W64LIT(0x8d0b5a7a794a6afc),
+            W64LIT(0x9de22df13772168b), W64LIT(0xe5d249c5d84097fd) } },
+        { { W64LIT(0x4a9090cde36d0757), W64LIT(0xf722d7b1d9a29382),
+            W64LIT(0xfb7fb04c04b48ddf), W64LIT(0x628ad2a7ebe16f43) },
+          { W64LIT(0xcd3fbfb520226040), W64LIT(0x6c34ecb15104b6c4),
+            W64LIT(0x30c0754ec903c188), W64LIT(0xec336b082d23cab0) } },
+        { { W64LIT(0x74c70b4295c69248), W64LIT(0x8813259dfed90303),
+            W64LIT(0xa3e330684b8cc87a), W64LIT(0xe689371c111a7a95) },
+          { W64LIT(0x52bfbbf7fbbbc20b), W64LIT(0x73a8543d65f9a6e2),
+            W64LIT(0x67bb2fdd7e413e6d), W64LIT(0xa066b3efc5cf2032) } },
+        { { W64LIT(0x473d62a21e206ee5), W64LIT(0xf1e274808c49a633),
+            W64LIT(0x87ab956ce9f6b2c3), W64LIT(0x61830b4862b606ea) },
+          { W64LIT(0x67cd6846e78e815f), W64LIT(0xfe40139f4c02082a),
+            W64LIT(0x52bbbfcb952ec365), W64LIT(0x74c116426b9836ab) } },
+        { { W64LIT(0xcf61b89c44f48971), W64LIT(0xe2d700f76d660683),
+            W64LIT(0x72ef285cd1d431bd), W64LIT(0x0593b24e9bdebf4a) },
+          { W64LIT(0x4084bc5b0561f8a1), W64LIT(0x84ce74d0aa16f256),
+            W64LIT(0x9cbc79d309f6d277), W64LIT(0xa94fe2fe4139bdfe) } },
+        { { W64LIT(0x9f51439e558df019), W64LIT(0x230da4baac712b27),
+            W64LIT(0x518919e355185a24), W64LIT(0x4dcefcdd84b78f50) },
+          { W64LIT(0xa7d90fb2a47d4c5a), W64LIT(0x55ac9abfb30e009e),
+            W64LIT(0xfd2fc35974eed273), W64LIT(0xb72d824cdbea8faf) } }
+    },
+    {   /* j * 2^235 * G */
+        { { W64LIT(0x549db2b5ef7d9289), W64LIT(0x2480d4a8197f015a),
+            W64LIT(0x61d5590bc40493b6), W64LIT(0x3a55b52e6f780331) },
+          { W64LIT(0x40eb8115309eadb0), W64LIT(0xdea7de5a92e5c625),
+            W64LIT(0x64d631f0cc6a3d5a), W64LIT(0x9d5e9d7c93e8dd61) } },
+        { { W64LIT(0x196860411e84e0e5), W64LIT(0xa5db84d3aea34c93),
+            W64LIT(0xf9d5bb197073a732), W64LIT(0xb8d2fe566bcfd7c0) },
+          { W64LIT(0x45775f36f3eb82fa), W64LIT(0x8cb20cccfdff8b58),
+            W64LIT(0x1659b65f8374c110), W64LIT(0xb8b4a422330c789a) } },
+        { { W64LIT(0xc925ff87aedbae9f), W64LIT(0x7daf0eb936880a54),
+            W64LIT(0x9284ddf59c4d0e71), W64LIT(0x1581cf93316f8cf5) },
+          { W64LIT(0x3eeca8873ac1f452), W64LIT(0xb417fce9fb6aeffe),
+            W64LIT(0xa5918046eefb8dc3), W64LIT(0x73d318ac02209400) } },
+        { { W64LIT(0xc4f4cda3af2ebc2f), W64LIT(0xa0af843dcb4efe24),
+            W64LIT(0x53b857c19ccd10b1), W64LIT(0xddc9d1eb914d3e04) },
+          { W64LIT(0x7bdec8bb62771deb), W64LIT(0x829277aa91c5aa81),
+            W64LIT(0x7af18dd6832391ae), W64LIT(0x1740f316c71a84ca) } },
+        { { W64LIT(0xdd4a12d8e12b31f8), W64LIT(0x577e29bc177736e6),
+            W64LIT(0x2353722ba88935e8), W64LIT(0xca1d3729015f286d) },
+          { W64LIT(0x86c7b6a239a3e035), W64LIT(0x6e5250bfd3b03a9f),
+            W64LIT(0x79d98930fd0d536e), W64LIT(0x8c4cbbabfa0c3832) } },
+        { { W64LIT(0x2d500910cab91f1e), W64LIT(0xbedd9e444d1cd216),
+            W64LIT(0xd634b74fedd02252), W64LIT(0xbd60f8e11258617a) },
+          { W64LIT(0xd8c7537b9e05614a), W64LIT(0xfd26c766e7af5fc5),
+            W64LIT(0x0660b581582bd926), W64LIT(0x87019244acf07fc8) } },
+        { { W64LIT(0xafa26ccfaf64ecb6), W64LIT(0xe6054f974bd72775),
+            W64LIT(0xbbcbab5b140f695a), W64LIT(0xbc71b4a4e348efde) },
+          { W64LIT(0xfc2e52becc96d963), W64LIT(0x150abf5f5e5d9018),
+            W64LIT(0xbd182fa604568771), W64LIT(0x35b4c06170339f83) } },
+        { { W64LIT(0x8928e99aeeaf8c49), W64LIT(0xee7aa73d6e24d728),
+            W64LIT(0x4c5007c2e72b156c), W64LIT(0x5fcf57c5ed408a1d) },
+          { W64LIT(0x9f719e39b6057604), W64LIT(0x7d343c01c2868bbf),
+            W64LIT(0x2cca254b7e103e2d), W64LIT(0xe6eb38a9f131bea2) } },
+        { { W64LIT(0xc624a04e5f40ff52), W64LIT(0x3611d7cffcd2914a),
+            W64LIT(0xb7e8b42b1fd3bfd6), W64LIT(0x6cde40fdfa85063a) },
+          { W64LIT(0x7811c449178b7e5b), W64LIT(0x4cb609312972cc13),
+            W64LIT(0xf579125e33b46135), W64LIT(0xca102ef788a4e56e) } },
+        { { W64LIT(0x0ba4e3520a981b0d), W64LIT(0x1c354cb3bd1a41a4),
+            W64LIT(0x1aabaa3adf9fab9c), W64LIT(0x0701a7d153c418d5) },
+          { W64LIT(0xdd1a7cefdcf2b921), W64LIT(0x6ceef0b3bcf48061),
+            W64LIT(0x1083b598de25cce6), W64LIT(0x890a54c7e90a5e34) } },
+        { { W64LIT(0xc535956640ac1807), W64LIT(0xd4c1e56684da0b1e),
+            W64LIT(0xc4b33f97e0b82421), W64LIT(0xd0bd23177b41be00) },
+          { W64LIT(0x53a4b42e147b72e1), W64LIT(0xf8d39f5ff777104c),
+            W64LIT(0x36e64e64d3fb530d), W64LIT(0xa7a6ba6756074fdd) } },
+        { { W64LIT(0x405718db4f6d01b1), W64LIT(0xe73c6bc28f11e8a0),
+            W64LIT(0xac11bb8ca0591a3b), W64LIT(0x12d09a5a0acc4531) },
+          { W64LIT(0xcbf174eee7de13f4), W64LIT(0x177e2be6044fd682),
+            W64LIT(0x65f574cb1c48af70), W64LIT(0xce5966929961cb7c) } },
+        { { W64LIT(0x989fe84ebc6fab9f), W64LIT(0xe70ce6b1c80f6474),
+            W64LIT(0xbe9ff3053b02a1bc), W64LIT(0x12ef486699c0afd3) },
+          { W64LIT(0x22d957f9e3411a26), W64LIT(0x0b41d8817b485b98),
+            W64LIT(0x820e56d04ae20119), W64LIT(0x81e3d01f328528e0) } },
+        { { W64LIT(0xc59eed6c048752a1), W64LIT(0x41f2702ea01341b4),
+            W64LIT(0x6e35903b9dc6b092), W64LIT(0x4291aba81f5b5b23) },
+          { W64LIT(0x8173aa70a653d61d), W64LIT(0xd1b648d44f2eb51e),
+            W64LIT(0x31b7ce065ab93f8f), W64LIT(0xa55408ee99e2f4fe) } },
+        { { W64LIT(0x1fa4ed0985e34160), W64LIT(0xa26d7dc37a03cde2),
+            W64LIT(0x1dac0848fa84df2d), W64LIT(0x5e9a28d61b697108) },
+          { W64LIT(0xa88004d914ea0ea1), W64LIT(0xa8d154283ffe5520),
+            W64LIT(0x4f422dae639b139c), W64LIT(0xeedccc0dd4b5a861) } },
+        { { W64LIT(0xb33e624f8be762b4), W64LIT(0x2a9ee4d1058e3413),
+            W64LIT(0x968e636967d805fa), W64LIT(0x9848949b7db8bfd7) },
+          { W64LIT(0x5308d7e5d23a8417), W64LIT(0x892f3b1df3e29da5),
+            W64LIT(0xc95c139e3dee471f), W64LIT(0x8631594dd757e089) } }
+    },
+    {   /* j * 2^240 * G */
+        { { W64LIT(0x1083e2ea1f095615), W64LIT(0x0a28ad7714e68c33),
+            W64LIT(0x6bfc02523d8818be), W64LIT(0xb585113af35850cd) },
+          { W64LIT(0x7d935f0b30df8aa1), W64LIT(0xaddda07c4ab7e3ac),
+            W64LIT(0x92c34299552f00cb), W64LIT(0xc33ed1de2909df6c) } },
+        { { W64LIT(0x2dc40d483e07113c), W64LIT(0x6e4a5d397d8b63ae),
+            W64LIT(0x5582a94b79684c2b), W64LIT(0x932b33d4622da26c) },
+          { W64LIT(0xf534f6510dbbf08d), W64LIT(0x211d07c964c23a52),
+            W64LIT(0x0eeece0fee5bdc9b), W64LIT(0xdf178168f7015558) } },
+        { { W64LIT(0xabe7905a83cdd60e), W64LIT(0x50602fb5a1170184),
+            W64LIT(0x689886cdb023642a), W64LIT(0xd568d090a6e1fb00) },
+          { W64LIT(0x5b1922c70259217f), W64LIT(0x93831cd9c43141e4),
+            W64LIT(0xdfca35870c95f86e), W64LIT(0xdec2057a568ae828) } },
+        { { W64LIT(0x568f8925913cc16d), W64LIT(0x18bc5b6de1a26f5a),
+            W64LIT(0xdfa413bef5f499ae), W64LIT(0xf8835decc3f0ae84) },
+          { W64LIT(0xb6e60bd865a40ab0), W64LIT(0x65596439194b377e),
+            W64LIT(0xbcd8562592084a69), W64LIT(0x5ce433b94f23ede0) } },
+        { { W64LIT(0x860d523d42e06189), W64LIT(0xbf0779414e3aff13),
+            W64LIT(0x0b616dcac1b20650), W64LIT(0xe66dd6d12131300d) },
+          { W64LIT(0xd4a0fd67ff99abde), W64LIT(0xc9903550c7aac50d),
+            W64LIT(0x022ecf8b7c46b2d7), W64LIT(0x3333b1e83abf92af) } },
+        { { W64LIT(0xc0da65e784d6365d), W64LIT(0xbcb7443f8f759fb8),
+            W64LIT(0x35c712b17ae81930), W64LIT(0x80428dff4c6e08ab) },
+          { W64LIT(0xf19dafefa4faf843), W64LIT(0xced8538dffa9855f),
+            W64LIT(0x20ac409cbe3ac7ce), W64LIT(0x358c1fb6882da71e) } },
+        { { W64LIT(0xefecdef7be42a582), W64LIT(0xd3fc608065046be6),
+            W64LIT(0xc9af13c809e8dba9), W64LIT(0x1e6c9847641491ff) },
+          { W64LIT(0x3b574925d30c31f7), W64LIT(0xb7eb72baac2a2122),
+            W64LIT(0x776a0dacef0859e7), W64LIT(0x06fec31421900942) } },
+        { { W64LIT(0x324794b07e50122b), W64LIT(0xdd744f8b4af07ca5),
+            W64LIT(0x30a12f08d63fc97b), W64LIT(0x39650f1a76626d9d) },
+          { W64LIT(0x101b47f71fa38477), W64LIT(0x3d815f19d4dc124f),
+            W64LIT(0x1569ae95b26eb58a), W64LIT(0xc3cde18895fb1887) } },
+        { { W64LIT(0x7ec62fbbf4737f21), W64LIT(0xd8dba5ab6209f5ac),
+            W64LIT(0x24b5d7a9a5f9adbe), W64LIT(0x707d28f7a61dc768) },
+          { W64LIT(0x7711460bcaa999ea), W64LIT(0xba7b174d1c92e4cc),
+            W64LIT(0x3c4bab6618d4bf2d), W64LIT(0xb8f0c980eb8bd279) } },
+        { { W64LIT(0x9d658932790691bf), W64LIT(0xed61058906b736ae),
+            W64LIT(0x712c2f04c0d63b6e), W64LIT(0x5cf06fd5c63d488f) },
+          { W64LIT(0x97363facd9588e41), W64LIT(0x1f9bf7622b93257e),
+            W64LIT(0xa9d1ffc4667acace), W64LIT(0x1cf4a1aa0a061ecf) } },
+        { { W64LIT(0x28d675b2c0519a23), W64LIT(0x9ebf94fe4f6952e3),
+            W64LIT(0xf28bb767a2294a8a), W64LIT(0x85512b4dfe0af3f5) },
+          { W64LIT(0x18958ba899b16a0d), W64LIT(0x95c2430cba7548a7),
+            W64LIT(0xb30d1b10a16be615), W64LIT(0xe3ebbb9785bfb74c) } },
+        { { W64LIT(0x07b53f5eb2e63645), W64LIT(0xbe57e54784c84232),
+            W64LIT(0xd779c2167214d5cf), W64LIT(0x617969cd029a3aca) },
+          { W64LIT(0xd17668cd8a7017a0), W64LIT(0x77b4d19abe9b7ee8),
+            W64LIT(0x58fd0e939c161776), W64LIT(0xa8c4f4efd5968a72) } },
+        { { W64LIT(0x81eeb865d2fdca23), W64LIT(0x5a15ee08cc8ef895),
+            W64LIT(0x768fa10a01905614), W64LIT(0xeff5b8ef880ee19b) },
+          { W64LIT(0xf0c0cabbcb1c8a0e), W64LIT(0x2e1ee9cdb8c838f9),
+            W64LIT(0x0587d8b88a4a14c0), W64LIT(0xf6f278962ff698e5) } },
+        { { W64LIT(0x519d34b3bf44da80), W64LIT(0x283834f95ab32e66),
+            W64LIT(0x6e6087976278a000), W64LIT(0x1e62960e627312f6) },
+          { W64LIT(0x9b87b27be6901c55), W64LIT(0x80e7853824fdbc1f),
+            W64LIT(0xbbbc09512facc27d), W64LIT(0x06394239ac143b5a) } },
+        { { W64LIT(0x9c4b646e9e2fce99), W64LIT(0x68a210811e80857f),
+            W64LIT(0x06d54e443643b52a), W64LIT(0xde8d6d630d8eb843) },
+          { W64LIT(0x7032156342146a0a), W64LIT(0x8ba826f25eaa3622),
+            W64LIT(0x227a58bd86138787), W64LIT(0x43b6c03c10281d37) } },
+        { { W64LIT(0x02b37a952f41deff), W64LIT(0x0e44a59ae63b89b7),
+            W64LIT(0x673257dc143ff951), W64LIT(0x19c02205d752baf4) },
+          { W64LIT(0x46c23069c4b7d692), W64LIT(0x2e6392c3fd1502ac),
+            W64LIT(0x6057b1a21b220846), W64LIT(0xe51ff9460c1b5b63) } }
+    },
+    {   /* j * 2^245 * G */
+        { { W64LIT(0x6e85cb51566c5c43), W64LIT(0xcff9c9193597f046),
+            W64LIT(0x9354e90c4994d94a), W64LIT(0xe0a393322147927d) },
+          { W64LIT(0x8427fac10dc1eb2b), W64LIT(0x88cfd8c22ff319fa),
+            W64LIT(0xe2d4e68401965274), W64LIT(0xfa2e067d67aaa746) } },
+        { { W64LIT(0xb6d92a7f3e5f9f11), W64LIT(0x9afe153ad6cb3b8e),
+            W64LIT(0x4d1a6dd7ddf800bd), W64LIT(0xf6c13cc0caf17e19) },
+          { W64LIT(0x15f6c58e325fc3ee), W64LIT(0x71095400a31dc3b2),
+            W64LIT(0x168e7c07afa3d3e7), W64LIT(0x3f8417a194c7ae2d) } },
+        { { W64LIT(0xec234772813b230d), W64LIT(0x634d0f5f17344427),
+            W64LIT(0x11548ab1d77fc56a), W64LIT(0x7fab1750ce06af77) },
+          { W64LIT(0xb62c10a74f7c4f83), W64LIT(0xa7d2edc4220a67d9),
+            W64LIT(0x1c404170921209a0), W64LIT(0x0b9815a0face59f0) } },
+        { { W64LIT(0x2842589b319540c3), W64LIT(0x18490f59a283d6f8),
+            W64LIT(0xa2731f84daae9fcb), W64LIT(0x3db6d960c3683ba0) },
+          { W64LIT(0xc85c63bb14611069), W64LIT(0xb19436af0788bf05),
+            W64LIT(0x905459df347460d2), W64LIT(0x73f6e094e11a7db1) } },
+        { { W64LIT(0xdc7f938eb6357f37), W64LIT(0xc5d00f792bd8aa62),
+            W64LIT(0xc878dcb92ca979fc), W64LIT(0x37e83ed9eb023a99) },
+          { W64LIT(0x6b23e2731560bf3d), W64LIT(0x1086e4591d0fae61),
+            W64LIT(0x782483169a9414bd), W64LIT(0x1b956bc0f0ea9ea1) } },
+        { { W64LIT(0x7b85bb91c31b9c38), W64LIT(0x0c5aa90b48ef57b5),
+            W64LIT(0xdedeb169af3bab6f), W64LIT(0xe610ad732d373685) },
+          { W64LIT(0xf13870df02ba8e15), W64LIT(0x0337edb68ca7f771),
+            W64LIT(0xe4acf747b62c036c), W64LIT(0xd921d576b6b94e81) } },
+        { { W64LIT(0xdbc864392c422f7a), W64LIT(0xfb635362ed348898),
+            W64LIT(0x83084668c45bfcd1), W64LIT(0xc357c9e32b315e11) },
+          { W64LIT(0xb173b5405b2e5b8c), W64LIT(0x7e946931e102b9a4),
+            W64LIT(0x17c890eb7b0fb199), W64LIT(0xec225a83d61b662b) } },
+        { { W64LIT(0xf306a3c8ee3c76cb), W64LIT(0x3cf11623d32a1f6e),
+            W64LIT(0xe6d5ab646863e956), W64LIT(0x3b8a4cbe5c005c26) },
+          { W64LIT(0xdcd529a59ce6bb27), W64LIT(0xc4afaa5204d4b16f),
+            W64LIT(0xb0624a267923798d), W64LIT(0x85e56df66b307fab) } },
+        { { W64LIT(0x0281893c2bf29698), W64LIT(0x91fc19a4d7ce7603),
+            W64LIT(0x75a5dca3ad9a558f), W64LIT(0x40ceb3fa4d50bf77) },
+          { W64LIT(0x1baf6060bc9ba369), W64LIT(0x927e1037597888c2),
+            W64LIT(0xd936bf1986a34c07), W64LIT(0xd4cf10c1c34ae980) } },
+        { { W64LIT(0x3a3e5334859dd614), W64LIT(0x9c475b5b18d0c8ee),
+            W64LIT(0x63080d1f07cd51d5), W64LIT(0xc9c0d0a6b88b4326) },
+          { W64LIT(0x1ac98691c234296f), W64LIT(0x2a0a83a494887fb6),
+            W64LIT(0x565114270cea9cf2), W64LIT(0x5230a6e8a24802f5) } },
+        { { W64LIT(0xf7a2bf0f72e3d5c1), W64LIT(0x377174464f21439e),
+            W64LIT(0xfedcbf259ce30334), W64LIT(0xe0030a787ce202f9) },
+          { W64LIT(0x6f2d9ebf1202e9ca), W64LIT(0xe79dde6c75e6e591),
+            W64LIT(0xf52072aff1dac4f8), W64LIT(0x6c8d087ebb9b404d) } },
+        { { W64LIT(0xad0fc73dbce913af), W64LIT(0x909e587b458a07cb),
+            W64LIT(0x1300da84d4f00c8a), W64LIT(0x425cd048b54466ac) },
+          { W64LIT(0xb59cb9be90e9d8bf), W64LIT(0x991616db3e431b0e),
+            W64LIT(0xd3aa117a531aecff), W64LIT(0x91af92d359f4dc3b) } },
+        { { W64LIT(0x9b1ec292e93fda29), W64LIT(0x76bb6c17e97d91bc),
+            W64LIT(0x7509d95faface1e6), W64LIT(0x3653fe47be855ae3) },
+          { W64LIT(0x73180b280f680e75), W64LIT(0x75eefd1beeb6c26c),
+            W64LIT(0xa4cdf29fb66d4236), W64LIT(0x2d70a9976b5821d8) } },
+        { { W64LIT(0x7a3ee20720445c36), W64LIT(0x71d1ac8259877174),
+            W64LIT(0x0fc539f7949f73e9), W64LIT(0xd05cf3d7982e3081) },
+          { W64LIT(0x8758e20b7b1c7129), W64LIT(0xffadcc20569e61f2),
+            W64LIT(0xb05d3a2f59544c2d), W64LIT(0xbe16f5c19fff5e53) } },
+        { { W64LIT(0x73cf65b8aad58135), W64LIT(0x622c2119037aa5be),
+            W64LIT(0x79373b3f646fd6a0), W64LIT(0x0e029db50d3978cf) },
+          { W64LIT(0x8bdfc43794fba037), W64LIT(0xaefbd687620797a6),
+            W64LIT(0x3fa5382bbd30d38e), W64LIT(0x7627cfbf585d7464) } },
+        { { W64LIT(0xb2330fef4e4ca463), W64LIT(0xbcef72873566cc63),
+            W64LIT(0xd161d2cacf780900), W64LIT(0x135dc5395b54827d) },
+          { W64LIT(0x638f052e27bf1bc6), W64LIT(0x10a224f007dfa06c),
+            W64LIT(0xe973586d6d3321da), W64LIT(0x8b0c573826152c8f) } }
+    },
+    {   /* j * 2^250 * G */
+        { { W64LIT(0x9910ba6b23a5d896), W64LIT(0x1fe19e357fe4364e),
+            W64LIT(0x6e1da8c39a33c677), W64LIT(0x15b4488b29fd9fd0) },
+          { W64LIT(0x1f4392541a1f22bf), W64LIT(0x920a8a70ab8163e8),
+            W64LIT(0x3fd1b24907e5658e), W64LIT(0xf2c4f79cb6ec839b) } },
+        { { W64LIT(0x8b5c619c76497ee8), W64LIT(0x5d2b0ac6c717370e),
+            W64LIT(0x98204cb64fcf68e1), W64LIT(0x0bdec21162bc6792) },
+          { W64LIT(0x6973ccefa63b1011), W64LIT(0xf9e3fa97e0de1ac5),
+            W64LIT(0x5efb693e3d0e0c8b), W64LIT(0x037248e9d2d4fcb4) } },
+        { { W64LIT(0xd3694e2ab20364e4), W64LIT(0x62699718e770b20d),
+            W64LIT(0x6183291b6ed77d1c), W64LIT(0x69aada7f6d6180a5) },
+          { W64LIT(0x51f9054bf185509b), W64LIT(0xfd7e845678701077),
+            W64LIT(0xd6a2308a7fb96d8d), W64LIT(0xd53e48d228dc87ee) } },
+        { { W64LIT(0x80802dc91ec34f9e), W64LIT(0xd8772d3533810603),
+            W64LIT(0x3f06d66c530cb4f3), W64LIT(0x7be5ed0dc475c129) },
+          { W64LIT(0xcb9e3c1931e82b10), W64LIT(0xc63d2857c9ff6b4c),
+            W64LIT(0xb92118c692a1b45e), W64LIT(0x0aec44147285bbca) } },
+        { { W64LIT(0x37071afbe8316c45), W64LIT(0x982be4fd46700b8b),
+            W64LIT(0x8d5d177c64ff8578), W64LIT(0x5ec40582c9a82fa7) },
+          { W64LIT(0x5518e37bcfa86678), W64LIT(0x24e809f49f031284),
+            W64LIT(0x312f39604bbbb74c), W64LIT(0xad4b4f6fc0c14de6) } },
+        { { W64LIT(0xa3d6f4868eb6e843), W64LIT(0x6415834bac4ab3ab),
+            W64LIT(0x028a81514f3cf2dc), W64LIT(0xf3b4962f5f3e6c3e) },
+          { W64LIT(0x9119ae90987dd2f2), W64LIT(0x437a6d8ae10bce55),
+            W64LIT(0xc31cdd6b9b149ed6), W64LIT(0x1b77791d06871332) } },
+        { { W64LIT(0x9c34b650e16e05e9), W64LIT(0x965a774094e74640),
+            W64LIT(0xa3fd22fbcea3f029), W64LIT(0x1eb6a9688f95277c) },
+          { W64LIT(0x2520a63d7bad84f6), W64LIT(0xad917201f58f2fee),
+            W64LIT(0xea92c1669b840d48), W64LIT(0x12109c4aacef5cbd) } },
+        { { W64LIT(0xfc189ae71e29a3ef), W64LIT(0xcbe906f04c93302e),
+            W64LIT(0xd0107914ceaae10e), W64LIT(0xb7a23f34b68e19f8) },
+          { W64LIT(0xe9d875c2efd2119d), W64LIT(0x03198c6efcadc9c8),
+            W64LIT(0x65591bf64da17113), W64LIT(0x3cf0bbf83d443038) } },
+        { { W64LIT(0xab293027aad991c1), W64LIT(0x598d0bf8849be4b7),
+            W64LIT(0x8c94a21ab972da90), W64LIT(0xada4cfdd7ecfa840) },
+          { W64LIT(0x93d4b9c0fbcec63a), W64LIT(0x7ca617a203219a34),
+            W64LIT(0x900424eb6a652a55), W64LIT(0xaf9346e9eb8562e0) } },
+        { { W64LIT(0xc3e04d7902381461), W64LIT(0xb1643ab5911bc478),
+            W64LIT(0xc92becfa390b3ef2), W64LIT(0x54476778acd2f1b6) },
+          { W64LIT(0x8daa0c4d66bf3aaf), W64LIT(0x2bc1287b2c21c65a),
+            W64LIT(0xee182910b5a13ac3), W64LIT(0xbb04730090b0790a) } },
+        { { W64LIT(0x83766947d17d4e0b), W64LIT(0xc5772beefdc3a47b),
+            W64LIT(0x765a50db1a6fd0ff), W64LIT(0x17f904ba45b0995e) },
+          { W64LIT(0xcee643832883487e), W64LIT(0xf56db7f3c270aaed),
+            W64LIT(0x6738d94f46cb1fd9), W64LIT(0xc8fa426a142fd4d5) } },
+        { { W64LIT(0xae485bb72b724759), W64LIT(0x945353e1b2d4c63a),
+            W64LIT(0x82159d07de7d6f2c), W64LIT(0x389caef34ec5b109) },
+          { W64LIT(0x4a8ebb53db65ef14), W64LIT(0x2dc2cb7edd99de43),
+            W64LIT(0x816fa3ed83f2405f), W64LIT(0x73429bb9c14208a3) } },
+        { { W64LIT(0x08ed8febd56daf06), W64LIT(0x8d98277b4a837f69),
+            W64LIT(0x9947c636a9b6e05a), W64LIT(0x58c8a77ac0d58abd) },
+          { W64LIT(0xf45496a45f121e4f), W64LIT(0x16cd67c71076d3d3),
+            W64LIT(0xecbd1958e3fb0c5d), W64LIT(0xfbe185ec38e1eb47) } },
+        { { W64LIT(0xb7ef9760ff79d2ee), W64LIT(0xdd4d06aff39e7832),
+            W64LIT(0xfd025001b905b499), W64LIT(0x98fe1c61f5b61d31) },
+          { W64LIT(0xa9f83980c5f12805), W64LIT(0x376e3b783009cd9a),
+            W64LIT(0xa322b09f514eb16d), W64LIT(0x08e213122c3832df) } },
+        { { W64LIT(0xaea68626dc4ad4f4), W64LIT(0x5dc516824ddbc0b6),
+            W64LIT(0xa76697bd602e9065), W64LIT(0xbeeb3ea58c37888e) },
+          { W64LIT(0x1ec4a2f214569113), W64LIT(0xe48b820ca35f4484),
+            W64LIT(0x9fb560949ae44df2), W64LIT(0x6ca1346292cc09fd) } },
+        { { W64LIT(0xb618d590b01e6e27), W64LIT(0x047e2ccde180b2dc),
+            W64LIT(0xd1b299b504aea4a9), W64LIT(0x412c9e1e9fa403a4) },
+          { W64LIT(0x88d28a3679407552), W64LIT(0x49c50136f332b8e3),
+            W64LIT(0x3a1b6fcce668de19), W64LIT(0x178851bc75122b97) } }
+    },
+    {   /* j * 2^255 * G */
+        { { W64LIT(0x197dd46d95a7b1a2), W64LIT(0x9c4e7ad63c6341fb),
+            W64LIT(0x426eca29484c2ece), W64LIT(0x9211e489de7f4f8a) },
+          { W64LIT(0x14997f6ec78ef1f4), W64LIT(0x2b2c091006574586),
+            W64LIT(0x17286a6e1c3eede8), W64LIT(0x25f92e470f60e018) } },
+        { { W64LIT(0xb4e370af3aeac968), W64LIT(0xe4f7fee9c4b63266),
+            W64LIT(0xb4acd4c2e3ac5664), W64LIT(0xf8910bd2ceb38cbf) },
+          { W64LIT(0x1c3ae50cc9c0726e), W64LIT(0x15309569d97b40bf),
+            W64LIT(0x70884b7ffd5a5a1b), W64LIT(0x3890896aef8314cd) } },
+        { { W64LIT(0x090d7d205ffe7b37), W64LIT(0x3b7f3efb1747d2da),
+            W64LIT(0xa2cb525fb54fc519), W64LIT(0x6e220932f66a971e) },
+          { W64LIT(0xddc160dfb486d440), W64LIT(0x7fcfec463fe13465),
+            W64LIT(0x83da7e4e76e4c151), W64LIT(0xd6fa48a1d8d302b5) } },
+        { { W64LIT(0x5ced3c9f82e4c634), W64LIT(0x8efb83143a4464f8),
+            W64LIT(0xe706381b7a1dca25), W64LIT(0x6cd15a3c5a2a412b) },
+          { W64LIT(0x9347a8fdbfcd8fb5), W64LIT(0x31db2eef6e54cd22),
+            W64LIT(0xc4aeb11ef8d8932f), W64LIT(0x11e7c1ed344411af) } },
+        { { W64LIT(0xae4065ef12045cf9), W64LIT(0x6fcb2caf9ccce8bd),
+            W64LIT(0x1fa0ba4ef2cf6525), W64LIT(0xf683125dcb72c312) },
+          { W64LIT(0xa01da4eae312410e), W64LIT(0x67e286776cd8e830),
+            W64LIT(0xabd9575298fb3f07), W64LIT(0x05f11e11eef649a5) } },
+        { { W64LIT(0x996884f5903fa271), W64LIT(0xe6da0fd2b9da921e),
+            W64LIT(0xa6f2f2695db01e54), W64LIT(0x1ee3e9bd6876214e) },
+          { W64LIT(0xa26e181ce27a9497), W64LIT(0x36d254e48e215e04),
+            W64LIT(0x42f32a6c252cabca), W64LIT(0x9948148780b57614) } },
+        { { W64LIT(0xea961058fa28a7e0), W64LIT(0xc726cf250bf5ec74),
+            W64LIT(0xe74d55c8db229666), W64LIT(0x0bd9abbfa57f5799) },
+          { W64LIT(0x7479ef074dfc47b3), W64LIT(0xd9c65fc30c52f91d),
+            W64LIT(0x8e0283fe36a8bde2), W64LIT(0xa32a8b5e7d4b7280) } },
+        { { W64LIT(0xab41b43a43228d83), W64LIT(0x24ae1c304ad63f99),
+            W64LIT(0x8e525f1a46a51229), W64LIT(0x14af860fcd26d2b4) },
+          { W64LIT(0xd6baef613f714aa1), W64LIT(0xf51865adeb78795e),
+            W64LIT(0xd3e21fcee6a9d694), W64LIT(0x82ceb1dd8a37b527) } },
+        { { W64LIT(0x8605d27d48307682), W64LIT(0x745aaba3e10566da),
+            W64LIT(0xe57cae36bff2d7ab), W64LIT(0x91332ba14b127823) },
+          { W64LIT(0xcb5c3638f3429f43), W64LIT(0x43a21c4fec462929),
+            W64LIT(0xe9bc95352b18b7bd), W64LIT(0x8c2addf3e78cb0c6) } },
+        { { W64LIT(0x4a665bfd2f9fd51a), W64LIT(0x7f2f1fe2481b97f7),
+            W64LIT(0xcad05d69ad36ce50), W64LIT(0x314fc2a4844f4ded) },
+          { W64LIT(0xd5593d8cb55fc5c6), W64LIT(0xe3510ce8bfb1e23d),
+            W64LIT(0xf9b7be6937453cce), W64LIT(0xd3541b7969fae631) } },
+        { { W64LIT(0xb013cbcad7154ced), W64LIT(0x949b28573f52651a),
+            W64LIT(0x03b41f6e9f5e642e), W64LIT(0xc3a3462986ed94a4) },
+          { W64LIT(0xf3c86cd6222b24dc), W64LIT(0x7578fe8a028c9c26),
+            W64LIT(0xaac7bfa12edad3b6), W64LIT(0x4112c5d78847940a) } },
+        { { W64LIT(0x99296525eca445df), W64LIT(0xf1af24f22cdfa4c6),
+            W64LIT(0xf5b4eb61eba6d3bc), W64LIT(0x4560910c98972cc7) },
+          { W64LIT(0x54751c32093eaa32), W64LIT(0x018313497d3c67bb),
+            W64LIT(0x3bd90ce62d871110), W64LIT(0x75fc863a538baa7e) } },
+        { { W64LIT(0x8fe1f8b64ae3a278), W64LIT(0x160c5306137cdf65),
+            W64LIT(0x22f029e733be0492), W64LIT(0x79a680427a75cd82) },
+          { W64LIT(0x1d8c094a5b3f3ada), W64LIT(0x5d723bbe165c3250),
+            W64LIT(0x08b958ffa5792e22), W64LIT(0x829fa986b11c1eaa) } },
+        { { W64LIT(0x711b8a4176a9f05d), W64LIT(0x06ca4e4b9011d488),
+            W64LIT(0x543bc62ba248a65e), W64LIT(0x017535ffc9290894) },
+          { W64LIT(0x840b84ce406851d7), W64LIT(0xafa3acdf90e960b4),
+            W64LIT(0xac3394af7128fd34), W64LIT(0x54eb4d5b2ac0f92c) } },
+        { { W64LIT(0x923ea73e4a14f836), W64LIT(0xc8cc8c57f0946328),
+            W64LIT(0xce3f117fe917a4df), W64LIT(0x6372f933f72ce929) },
+          { W64LIT(0x75000249c29ba567), W64LIT(0xcbd437e68c829cca),
+            W64LIT(0x6c63aaabdd02ec7a), W64LIT(0xe9b2f90c7b42bd17) } },
+        { { W64LIT(0xdb09e87355dbd4b3), W64LIT(0x1f8799286639bbb1),
+            W64LIT(0xb83e47e51c651962), W64LIT(0xd4ef0fb6c43fb574) },
+          { W64LIT(0x27d3b9d8f1bfb12a), W64LIT(0x6ab877e86e5e8b72),
+            W64LIT(0x8eebdc9d157b9014), W64LIT(0x4c2110053aa5cb64) } }
+    }
+};
+
+
+/* all ones if a is zero, else zero */
+static INLINE word64 p256_zero_mask(word64 a)
+{
+    return ((a | (0 - a)) >> 63) - 1;
+}
+
+
+static INLINE word64 p256_fe_is_zero(const p256_fe a)
+{
+    return p256_zero_mask(a[0] | a[1] | a[2] | a[3]);
+}
+
+
+/* r = a where mask is all ones, r unchanged where mask is zero */
+static INLINE void p256_fe_cmov(p256_fe r, const p256_fe a, word64 mask)
+{
+    r[0] = (r[0] & ~mask) | (a[0] & mask);
+    r[1] = (r[1] & ~mask) | (a[1] & mask);
+    r[2] = (r[2] & ~mask) | (a[2] & mask);
+    r[3] = (r[3] & ~mask) | (a[3] & mask);
+}
+
+
+/* r = t - p when t (with carry bit hi) is at least p, t < 2p */
+static INLINE void p256_fe_norm(p256_fe r, const word64* t, word64 hi)
+{
+    p256_fe    s;
+    p256_dword w;
+    word64     b = 0, keep;
+    int        i;
+
+    for (i = 0; i < 4; i++) {
+        w = (p256_dword)t[i] - p256_mod[i] - b;
+        s[i] = (word64)w;
+        b = (word64)(w >> 64) & 1;
+    }
+
+    /* borrow out of the top with no carry in means t was already < p */
+    keep = 0 - (b & (hi ^ 1));
+    for (i = 0; i < 4; i++)
+        r[i] = (s[i] & ~keep) | (t[i] & keep);
+}
+
+
+static void p256_fe_add(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    word64     t[4];
+    p256_dword w;
+    word64     c = 0;
+    int        i;
+
+    for (i = 0; i < 4; i++) {
+        w = (p256_dword)a[i] + b[i] + c;
+        t[i] = (word64)w;
+        c = (word64)(w >> 64);
+    }
+    p256_fe_norm(r, t, c);
+}
+
+
+static void p256_fe_sub(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    word64     t[4];
+    p256_dword w;
+    word64     c = 0, mask;
+    int        i;
+
+    for (i = 0; i < 4; i++) {
+        w = (p256_dword)a[i] - b[i] - c;
+        t[i] = (word64)w;
+        c = (word64)(w >> 64) & 1;
+    }
+
+    /* add p back on borrow */
+    mask = 0 - c;
+    c = 0;
+    for (i = 0; i < 4; i++) {
+        w = (p256_dword)t[i] + (p256_mod[i] & mask) + c;
+        r[i] = (word64)w;
+        c = (word64)(w >> 64);
+    }
+}
+
+
+/* Montgomery multiply, r = a * b / 2^256 mod p.  -p^-1 mod 2^64 is 1 and
+   the limbs of p are all ones, zero or small, so each reduction step takes
+   the low word as its multiplier and only needs two real products. */
+static void p256_fe_mul(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    word64     t[6];
+    p256_dword w;
+    word64     c, m;
+    int        i, j;
+
+    t[0] = t[1] = t[2] = t[3] = t[4] = t[5] = 0;
+
+    for (i = 0; i < 4; i++) {
+        c = 0;
+        for (j = 0; j < 4; j++) {
+            w = (p256_dword)a[j] * b[i] + t[j] + c;
+            t[j] = (word64)w;
+            c = (word64)(w >> 64);
+        }
+        w = (p256_dword)t[4] + c;
+        t[4] = (word64)w;
+        t[5] = (word64)(w >> 64);
+
+        /* t += m * p, m * p[0] + t[0] is exactly m * 2^64 */
+        m = t[0];
+        w = (p256_dword)m * p256_mod[1] + t[1] + m;
+        t[0] = (word64)w;
+        c = (word64)(w >> 64);
+        w = (p256_dword)t[2] + c;
+        t[1] = (word64)w;
+        c = (word64)(w >> 64);
+        w = (p256_dword)m * p256_mod[3] + t[3] + c;
+        t[2] = (word64)w;
+        c = (word64)(w >> 64);
+        w = (p256_dword)t[4] + c;
+        t[3] = (word64)w;
+        t[4] = t[5] + (word64)(w >> 64);
+    }
+    p256_fe_norm(r, t, t[4]);
+}
+
+
+static INLINE void p256_fe_sqr(p256_fe r, const p256_fe a)
+{
+    p256_fe_mul(r, a, a);
+}
+
+
+/* r = a^(2^n) */
+static void p256_fe_sqr_n(p256_fe r, const p256_fe a, int n)
+{
+    p256_fe_sqr(r, a);
+    while (--n > 0)
+        p256_fe_sqr(r, r);
+}
+
+
+/* r = a^(p - 2) = 1/a, fixed addition chain so constant time */
+static void p256_fe_inv(p256_fe r, const p256_fe a)
+{
+    p256_fe x2, x4, x8, x16, x30, x32, t;
+
+    p256_fe_sqr(t, a);
+    p256_fe_mul(x2, t, a);                        /* 2^2  - 1 */
+    p256_fe_sqr_n(t, x2, 2);
+    p256_fe_mul(x4, t, x2);                       /* 2^4  - 1 */
+    p256_fe_sqr_n(t, x4, 4);
+    p256_fe_mul(x8, t, x4);                       /* 2^8  - 1 */
+    p256_fe_sqr_n(t, x8, 8);
+    p256_fe_mul(x16, t, x8);                      /* 2^16 - 1 */
+    p256_fe_sqr_n(t, x16, 8);
+    p256_fe_mul(t, t, x8);                        /* 2^24 - 1 */
+    p256_fe_sqr_n(t, t, 4);
+    p256_fe_mul(t, t, x4);                        /* 2^28 - 1 */
+    p256_fe_sqr_n(t, t, 2);
+    p256_fe_mul(x30, t, x2);                      /* 2^30 - 1 */
+    p256_fe_sqr_n(t, x30, 2);
+    p256_fe_mul(x32, t, x2);                      /* 2^32 - 1 */
+
+    /* p - 2 = ffffffff 00000001 00000000 00000000 00000000 ffffffff
+               ffffffff fffffffd */
+    p256_fe_sqr_n(t, x32, 32);
+    p256_fe_mul(t, t, a);
+    p256_fe_sqr_n(t, t, 128);
+    p256_fe_mul(t, t, x32);
+    p256_fe_sqr_n(t, t, 32);
+    p256_fe_mul(t, t, x32);
+    p256_fe_sqr_n(t, t, 30);
+    p256_fe_mul(t, t, x30);
+    p256_fe_sqr_n(t, t, 2);
+    p256_fe_mul(r, t, a);
+}
+
+
+/* r = a^((p + 1) / 4), a square root of a when there is one since
+   p = 3 mod 4, (p + 1) / 4 = 2^254 - 2^222 + 2^190 + 2^94 */
+static void p256_fe_sqrt(p256_fe r, const p256_fe a)
+{
+    p256_fe x2, x4, x8, x16, t;
+
+    p256_fe_sqr(t, a);
+    p256_fe_mul(x2, t, a);                        /* 2^2  - 1 */
+    p256_fe_sqr_n(t, x2, 2);
+    p256_fe_mul(x4, t, x2);                       /* 2^4  - 1 */
+    p256_fe_sqr_n(t, x4, 4);
+    p256_fe_mul(x8, t, x4);                       /* 2^8  - 1 */
+    p256_fe_sqr_n(t, x8, 8);
+    p256_fe_mul(x16, t, x8);                      /* 2^16 - 1 */
+    p256_fe_sqr_n(t, x16, 16);
+    p256_fe_mul(t, t, x16);                       /* 2^32 - 1 */
+
+    p256_fe_sqr_n(t, t, 32);
+    p256_fe_mul(t, t, a);                         /* 2^64 - 2^32 + 1 */
+    p256_fe_sqr_n(t, t, 96);
+    p256_fe_mul(t, t, a);                 /* 2^160 - 2^128 + 2^96 + 1 */
+    p256_fe_sqr_n(r, t, 94);
+}
+
+
+/* a as 32 big endian bytes into limbs, a must fit in 256 bits */
+static int p256_fe_from_mp(p256_fe r, mp_int* a)
+{
+    byte buf[P256_BYTES];
+    int  sz, i, j;
+    int  err = MP_OKAY;
+
+    sz = mp_unsigned_bin_size(a);
+    if (sz > P256_BYTES)
+        return ECC_BAD_ARG_E;
+
+    XMEMSET(buf, 0, sizeof(buf));
+    if (sz > 0)
+        err = mp_to_unsigned_bin(a, buf + P256_BYTES - sz);
+
+    for (i = 0; i < 4; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | buf[P256_BYTES - 8 * (i + 1) + j];
+    }
+#ifdef ECC_CLEAN_STACK
+    XMEMSET(buf, 0, sizeof(buf));
+#endif
+
+    return err;
+}
+
+
+static int p256_fe_to_mp(mp_int* r, const p256_fe a)
+{
+    byte buf[P256_BYTES];
+    int  i, j, err;
+
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 8; j++)
+            buf[P256_BYTES - 8 * (i + 1) + j] = (byte)(a[i] >> (56 - 8 * j));
+
+    err = mp_read_unsigned_bin(r, buf, P256_BYTES);
+
+    return err;
+}
+
+
+/* load a coordinate and convert into Montgomery form */
+static int p256_fe_load(p256_fe r, mp_int* a)
+{
+    int err = p256_fe_from_mp(r, a);
+
+    if (err == MP_OKAY)
+        p256_fe_mul(r, r, p256_rr);
+
+    return err;
+}
+
+
+/* r = 2 * a, dbl-2001-b for a = -3, infinity stays infinity */
+static void p256_point_dbl(p256_point* r, const p256_point* a)
+{
+    p256_fe delta, gamma, beta, alpha, t0, t1;
+
+    p256_fe_sqr(delta, a->z);
+    p256_fe_sqr(gamma, a->y);
+    p256_fe_mul(beta, a->x, gamma);
+
+    /* alpha = 3 * (x - delta) * (x + delta) */
+    p256_fe_sub(t0, a->x, delta);
+    p256_fe_add(t1, a->x, delta);
+    p256_fe_mul(t0, t0, t1);
+    p256_fe_add(alpha, t0, t0);
+    p256_fe_add(alpha, alpha, t0);
+
+    /* z3 = (y + z)^2 - gamma - delta */
+    p256_fe_add(t0, a->y, a->z);
+    p256_fe_sqr(t0, t0);
+    p256_fe_sub(t0, t0, gamma);
+    p256_fe_sub(r->z, t0, delta);
+
+    /* x3 = alpha^2 - 8 * beta */
+    p256_fe_add(beta, beta, beta);
+    p256_fe_add(beta, beta, beta);
+    p256_fe_add(t1, beta, beta);
+    p256_fe_sqr(t0, alpha);
+    p256_fe_sub(r->x, t0, t1);
+
+    /* y3 = alpha * (4 * beta - x3) - 8 * gamma^2 */
+    p256_fe_sub(t0, beta, r->x);
+    p256_fe_mul(t0, alpha, t0);
+    p256_fe_sqr(gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_sub(r->y, t0, gamma);
+}
+
+
+/* r = a + b, add-1998-cmo-2; either input may be infinity.  Equal inputs
+   are only reachable from degenerate scalars and take the doubling path. */
+static void p256_point_add(p256_point* r, const p256_point* a,
+                           const p256_point* b)
+{
+    p256_fe    z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+    p256_point res;
+    word64     aInf = p256_fe_is_zero(a->z);
+    word64     bInf = p256_fe_is_zero(b->z);
+
+    p256_fe_sqr(z1z1, a->z);
+    p256_fe_sqr(z2z2, b->z);
+    p256_fe_mul(u1, a->x, z2z2);
+    p256_fe_mul(u2, b->x, z1z1);
+    p256_fe_mul(s1, a->y, b->z);
+    p256_fe_mul(s1, s1, z2z2);
+    p256_fe_mul(s2, b->y, a->z);
+    p256_fe_mul(s2, s2, z1z1);
+    p256_fe_sub(h, u2, u1);
+    p256_fe_sub(rr, s2, s1);
+
+    if ((p256_fe_is_zero(h) & p256_fe_is_zero(rr) & ~aInf & ~bInf) != 0) {
+        p256_point_dbl(r, a);
+        return;
+    }
+
+    p256_fe_sqr(hh, h);
+    p256_fe_mul(hhh, h, hh);
+    p256_fe_mul(v, u1, hh);
+
+    p256_fe_sqr(res.x, rr);
+    p256_fe_sub(res.x, res.x, hhh);
+    p256_fe_sub(res.x, res.x, v);
+    p256_fe_sub(res.x, res.x, v);
+
+    p256_fe_sub(t, v, res.x);
+    p256_fe_mul(t, rr, t);
+    p256_fe_mul(res.y, s1, hhh);
+    p256_fe_sub(res.y, t, res.y);
+
+    p256_fe_mul(res.z, a->z, b->z);
+    p256_fe_mul(res.z, res.z, h);
+
+    p256_fe_cmov(res.x, b->x, aInf);
+    p256_fe_cmov(res.y, b->y, aInf);
+    p256_fe_cmov(res.z, b->z, aInf);
+    p256_fe_cmov(res.x, a->x, bInf);
+    p256_fe_cmov(res.y, a->y, bInf);
+    p256_fe_cmov(res.z, a->z, bInf);
+
+    XMEMCPY(r, &res, sizeof(res));
+}
+
+
+/* r = a + b with b affine, madd-1998-cmo; bInf mask marks b as infinity */
+static void p256_point_add_affine(p256_point* r, const p256_point* a,
+                                  const p256_affine* b, word64 bInf)
+{
+    p256_fe    z1z1, u2, s2, h, rr, hh, hhh, v, t;
+    p256_point res;
+    word64     aInf = p256_fe_is_zero(a->z);
+
+    p256_fe_sqr(z1z1, a->z);
+    p256_fe_mul(u2, b->x, z1z1);
+    p256_fe_mul(s2, b->y, a->z);
+    p256_fe_mul(s2, s2, z1z1);
+    p256_fe_sub(h, u2, a->x);
+    p256_fe_sub(rr, s2, a->y);
+
+    if ((p256_fe_is_zero(h) & p256_fe_is_zero(rr) & ~aInf & ~bInf) != 0) {
+        p256_point_dbl(r, a);
+        return;
+    }
+
+    p256_fe_sqr(hh, h);
+    p256_fe_mul(hhh, h, hh);
+    p256_fe_mul(v, a->x, hh);
+
+    p256_fe_sqr(res.x, rr);
+    p256_fe_sub(res.x, res.x, hhh);
+    p256_fe_sub(res.x, res.x, v);
+    p256_fe_sub(res.x, res.x, v);
+
+    p256_fe_sub(t, v, res.x);
+    p256_fe_mul(t, rr, t);
+    p256_fe_mul(res.y, a->y, hhh);
+    p256_fe_sub(res.y, t, res.y);
+
+    p256_fe_mul(res.z, a->z, h);
+
+    p256_fe_cmov(res.x, b->x, aInf);
+    p256_fe_cmov(res.y, b->y, aInf);
+    p256_fe_cmov(res.z, p256_one, aInf);
+    p256_fe_cmov(res.x, a->x, bInf);
+    p256_fe_cmov(res.y, a->y, bInf);
+    p256_fe_cmov(res.z, a->z, bInf);
+
+    XMEMCPY(r, &res, sizeof(res));
+}
+
+
+/* y = -y where mask is all ones */
+static INLINE void p256_fe_cneg(p256_fe y, word64 mask)
+{
+    static const p256_fe zero = { 0, 0, 0, 0 };
+    p256_fe t;
+
+    p256_fe_sub(t, zero, y);
+    p256_fe_cmov(y, t, mask);
+}
+
+
+/* window i of the scalar with the bit below it, bits 5i - 1 .. 5i + 4 */
+static INLINE word32 p256_window(const p256_fe k, int i)
+{
+    int    bit = P256_WINDOW * i - 1;
+    int    idx, sh;
+    word64 w;
+
+    if (bit < 0)
+        return (word32)(k[0] << 1) & 0x3f;
+
+    idx = bit >> 6;
+    sh  = bit & 63;
+    w   = k[idx] >> sh;
+    if (sh > 58 && idx < 3)
+        w |= k[idx + 1] << (64 - sh);
+
+    return (word32)w & 0x3f;
+}
+
+
+/* Booth recode a 6-bit window into a digit 0..16 and a negate flag */
+static INLINE void p256_recode(word32 in, word32* digit, word32* neg)
+{
+    word32 s, d;
+
+    s = ~((in >> P256_WINDOW) - 1);     /* all ones if the top bit is set */
+    d = (1 << (P256_WINDOW + 1)) - in - 1;
+    d = (d & s) | (in & ~s);
+    d = (d >> 1) + (d & 1);
+
+    *digit = d;
+    *neg   = s & 1;
+}
+
+
+/* r = table[idx - 1], or all zero (infinity) for idx 0, reads every entry */
+static void p256_select_affine(p256_affine* r, const p256_affine* table,
+                               word32 idx)
+{
+    word64 mask;
+    int    i, j;
+
+    XMEMSET(r, 0, sizeof(p256_affine));
+    for (i = 0; i < P256_TABLE; i++) {
+        mask = p256_zero_mask((word64)(i + 1) ^ idx);
+        for (j = 0; j < 4; j++) {
+            r->x[j] |= table[i].x[j] & mask;
+            r->y[j] |= table[i].y[j] & mask;
+        }
+    }
+}
+
+
+static void p256_select_point(p256_point* r, const p256_point* table,
+                              word32 idx)
+{
+    word64 mask;
+    int    i, j;
+
+    XMEMSET(r, 0, sizeof(p256_point));
+    for (i = 0; i < P256_TABLE; i++) {
+        mask = p256_zero_mask((word64)(i + 1) ^ idx);
+        for (j = 0; j < 4; j++) {
+            r->x[j] |= table[i].x[j] & mask;
+            r->y[j] |= table[i].y[j] & mask;
+            r->z[j] |= table[i].z[j] & mask;
+        }
+    }
+}
+
+
+/* r = k * P from P's fixed base table, table[i][j] = (j + 1) * 2^(5i) * P,
+   one table add per window and no doublings */
+static void p256_mul_fixed(p256_point* r, const p256_fe k,
+                           const p256_affine (*table)[P256_TABLE])
+{
+    p256_affine t;
+    word32      digit, neg;
+    int         i;
+
+    XMEMSET(r, 0, sizeof(p256_point));
+    for (i = 0; i < P256_WINDOWS; i++) {
+        p256_recode(p256_window(k, i), &digit, &neg);
+        p256_select_affine(&t, table[i], digit);
+        p256_fe_cneg(t.y, 0 - (word64)neg);
+        p256_point_add_affine(r, r, &t, p256_zero_mask(digit));
+    }
+}
+
+
+/* r = k * G */
+static void p256_mul_base(p256_point* r, const p256_fe k)
+{
+    p256_mul_fixed(r, k, p256_base);
+}
+
+
+/* table[i] = (i + 1) * p */
+static void p256_point_table(p256_point* table, const p256_point* p)
+{
+    int i;
+
+    XMEMCPY(&table[0], p, sizeof(p256_point));
+    p256_point_dbl(&table[1], p);
+    for (i = 2; i < P256_TABLE; i++)
+        p256_point_add(&table[i], &table[i - 1], p);
+}
+
+
+/* r = k * p, table of 1..16 * p then 5 doublings and one add per window */
+static int p256_mul_point(p256_point* r, const p256_fe k, const p256_point* p)
+{
+    p256_point  t;
+    word32      digit, neg;
+    int         i;
+#ifdef CYASSL_SMALL_STACK
+    p256_point* table;
+
+    table = (p256_point*)XMALLOC(sizeof(p256_point) * P256_TABLE, NULL,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    if (table == NULL)
+        return MEMORY_E;
+#else
+    p256_point  table[P256_TABLE];
+#endif
+
+    p256_point_table(table, p);
+
+    XMEMSET(r, 0, sizeof(p256_point));
+    for (i = P256_WINDOWS - 1; i >= 0; i--) {
+        if (i != P256_WINDOWS - 1) {
+            p256_point_dbl(r, r);
+            p256_point_dbl(r, r);
+            p256_point_dbl(r, r);
+            p256_point_dbl(r, r);
+            p256_point_dbl(r, r);
+        }
+        p256_recode(p256_window(k, i), &digit, &neg);
+        p256_select_point(&t, table, digit);
+        p256_fe_cneg(t.y, 0 - (word64)neg);
+        p256_point_add(r, r, &t);
+    }
+
+#ifdef ECC_CLEAN_STACK
+    XMEMSET(&t, 0, sizeof(t));
+    XMEMSET(table, 0, sizeof(p256_point) * P256_TABLE);
+#endif
+#ifdef CYASSL_SMALL_STACK
+    XFREE(table, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return 0;
+}
+
+
+/* scalar into limbs, reduced by the order first if it is wider than 256 */
+static int p256_scalar_load(p256_fe r, mp_int* k)
+{
+    mp_int order, t;
+    int    err;
+
+    if (mp_count_bits(k) <= P256_BYTES * 8)
+        return p256_fe_from_mp(r, k);
+
+    if ((err = mp_init_multi(&order, &t, NULL, NULL, NULL, NULL)) != MP_OKAY)
+        return err;
+
+    err = mp_read_radix(&order, (char*)p256Order, 16);
+    if (err == MP_OKAY)
+        err = mp_mod(k, &order, &t);
+    if (err == MP_OKAY)
+        err = p256_fe_from_mp(r, &t);
+
+    mp_clear(&t);
+    mp_clear(&order);
+
+    return err;
+}
+
+
+static int p256_point_load(p256_point* r, ecc_point* p)
+{
+    int err = p256_fe_load(r->x, p->x);
+
+    if (err == MP_OKAY)
+        err = p256_fe_load(r->y, p->y);
+    if (err == MP_OKAY)
+        err = p256_fe_load(r->z, p->z);
+
+    return err;
+}
+
+
+/* back to affine ecc_point with z = 1, infinity comes out as (0, 0) */
+static int p256_point_store(ecc_point* r, const p256_point* p)
+{
+    static const p256_fe one = { 1, 0, 0, 0 };
+    p256_fe zi, zi2, x, y;
+    int     err;
+
+    p256_fe_inv(zi, p->z);
+    p256_fe_sqr(zi2, zi);
+    p256_fe_mul(x, p->x, zi2);
+    p256_fe_mul(zi2, zi2, zi);
+    p256_fe_mul(y, p->y, zi2);
+
+    /* out of Montgomery form */
+    p256_fe_mul(x, x, one);
+    p256_fe_mul(y, y, one);
+
+    err = p256_fe_to_mp(r->x, x);
+    if (err == MP_OKAY)
+        err = p256_fe_to_mp(r->y, y);
+    if (err == MP_OKAY)
+        mp_set(r->z, 1);
+
+    return err;
+}
+
+
+int ecc_p256_curve(const ecc_set_type* dp)
+{
+    if (dp == NULL || dp->size != P256_BYTES)
+        return 0;
+
+    return XSTRNCMP(dp->prime, p256Prime, sizeof(p256Prime)) == 0 &&
+           XSTRNCMP(dp->Af,    p256Af,    sizeof(p256Af))    == 0 &&
+           XSTRNCMP(dp->order, p256Order, sizeof(p256Order)) == 0 &&
+           XSTRNCMP(dp->Gx,    p256Gx,    sizeof(p256Gx))    == 0 &&
+           XSTRNCMP(dp->Gy,    p256Gy,    sizeof(p256Gy))    == 0;
+}
+
+
+int ecc_p256_mulmod_base(mp_int* k, ecc_point* R)
+{
+    p256_fe    s;
+    p256_point r;
+    int        err;
+
+    if (k == NULL || R == NULL)
+        return ECC_BAD_ARG_E;
+
+    err = p256_scalar_load(s, k);
+    if (err == MP_OKAY) {
+        p256_mul_base(&r, s);
+        err = p256_point_store(R, &r);
+    }
+
+#ifdef ECC_CLEAN_STACK
+    XMEMSET(s, 0, sizeof(s));
+    XMEMSET(&r, 0, sizeof(r));
+#endif
+
+    return err;
+}
+
+
+int ecc_p256_mulmod(mp_int* k, ecc_point* P, ecc_point* R)
+{
+    p256_fe    s;
+    p256_point p, r;
+    int        err;
+
+    if (k == NULL || P == NULL || R == NULL)
+        return ECC_BAD_ARG_E;
+
+    err = p256_scalar_load(s, k);
+    if (err == MP_OKAY)
+        err = p256_point_load(&p, P);
+    if (err == MP_OKAY)
+        err = p256_mul_point(&r, s, &p);
+    if (err == MP_OKAY)
+        err = p256_point_store(R, &r);
+
+#ifdef ECC_CLEAN_STACK
+    XMEMSET(s, 0, sizeof(s));
+    XMEMSET(&r, 0, sizeof(r));
+#endif
+
+    return err;
+}
+
+
+int ecc_p256_mul2add(mp_int* kG, mp_int* kP, ecc_point* P, ecc_point* R)
+{
+    p256_fe    s;
+    p256_point p, r, t;
+    int        err;
+
+    if (kG == NULL || kP == NULL || P == NULL || R == NULL)
+        return ECC_BAD_ARG_E;
+
+    err = p256_point_load(&p, P);
+    if (err == MP_OKAY)
+        err = p256_scalar_load(s, kP);
+    if (err == MP_OKAY)
+        err = p256_mul_point(&t, s, &p);
+    if (err == MP_OKAY)
+        err = p256_scalar_load(s, kG);
+    if (err == MP_OKAY) {
+        p256_mul_base(&r, s);
+        p256_point_add(&r, &r, &t);
+        err = p256_point_store(R, &r);
+    }
+
+    return err;
+}
+
+
+int ecc_p256_decompress(mp_int* x, int odd, mp_int* y)
+{
+    static const p256_fe one = { 1, 0, 0, 0 };
+    p256_fe  fx, rhs, t, r;
+    word64   b = 0;
+    int      i, err;
+
+    if (x == NULL || y == NULL)
+        return ECC_BAD_ARG_E;
+
+    /* x has to be a field element */
+    err = p256_fe_from_mp(fx, x);
+    if (err != MP_OKAY)
+        return err;
+    for (i = 0; i < 4; i++)
+        b = (word64)(((p256_dword)fx[i] - p256_mod[i] - b) >> 64) & 1;
+    if (b == 0)
+        return MP_VAL;
+    p256_fe_mul(fx, fx, p256_rr);
+
+    /* x^3 - 3x + b */
+    p256_fe_sqr(t, fx);
+    p256_fe_mul(rhs, t, fx);
+    p256_fe_add(t, fx, fx);
+    p256_fe_add(t, t, fx);
+    p256_fe_sub(rhs, rhs, t);
+    p256_fe_add(rhs, rhs, p256_b);
+
+    p256_fe_sqrt(r, rhs);
+
+    /* no root, x isn't on the curve */
+    p256_fe_sqr(t, r);
+    if (XMEMCMP(t, rhs, sizeof(p256_fe)) != 0)
+        return MP_VAL;
+
+    p256_fe_mul(r, r, one);
+    if ((int)(r[0] & 1) != (odd != 0)) {
+        XMEMSET(t, 0, sizeof(t));
+        p256_fe_sub(r, t, r);
+    }
+
+    return p256_fe_to_mp(y, r);
+}
+
+
+int ecc_p256_table_setup(ecc_p256_table* tbl, ecc_point* P)
+{
+    p256_affine (*out)[P256_TABLE];
+    p256_point* jac;
+    p256_fe*    prod;
+    p256_fe     inv, zi, zi2;
+    p256_point  base;
+    int         i, j, n, err;
+
+    if (tbl == NULL || P == NULL)
+        return ECC_BAD_ARG_E;
+
+    if ((err = p256_point_load(&base, P)) != MP_OKAY)
+        return err;
+    if (p256_fe_is_zero(base.z))
+        return ECC_BAD_ARG_E;
+
+    n    = P256_WINDOWS * P256_TABLE;
+    jac  = (p256_point*)XMALLOC(sizeof(p256_point) * n, NULL,
+                                DYNAMIC_TYPE_TMP_BUFFER);
+    prod = (p256_fe*)XMALLOC(sizeof(p256_fe) * n, NULL,
+                             DYNAMIC_TYPE_TMP_BUFFER);
+    if (jac == NULL || prod == NULL) {
+        XFREE(jac, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(prod, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E;
+    }
+
+    /* window i holds 1..16 * 2^(5i) * P, none is infinity for a point of
+       prime order since no multiple reaches the order */
+    for (i = 0; i < P256_WINDOWS; i++) {
+        p256_point_table(&jac[i * P256_TABLE], &base);
+        p256_point_dbl(&base, &jac[i * P256_TABLE + P256_TABLE - 1]);
+    }
+
+    /* to affine with one inversion, prod[i] = z0 * .. * zi */
+    XMEMCPY(prod[0], jac[0].z, sizeof(p256_fe));
+    for (i = 1; i < n; i++)
+        p256_fe_mul(prod[i], prod[i - 1], jac[i].z);
+    p256_fe_inv(inv, prod[n - 1]);
+
+    out = (p256_affine (*)[P256_TABLE])tbl->pt;
+    for (i = n - 1; i >= 0; i--) {
+        if (i > 0) {
+            p256_fe_mul(zi, inv, prod[i - 1]);
+            p256_fe_mul(inv, inv, jac[i].z);
+        }
+        else
+            XMEMCPY(zi, inv, sizeof(p256_fe));
+
+        j = i % P256_TABLE;
+        p256_fe_sqr(zi2, zi);
+        p256_fe_mul(out[i / P256_TABLE][j].x, jac[i].x, zi2);
+        p256_fe_mul(zi2, zi2, zi);
+        p256_fe_mul(out[i / P256_TABLE][j].y, jac[i].y, zi2);
+    }
+
+    XFREE(jac, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(prod, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    return 0;
+}
+
+
+int ecc_p256_mul2add_table(mp_int* kG, mp_int* kP, const ecc_p256_table* tbl,
+                           ecc_point* R)
+{
+    p256_fe    s;
+    p256_point r, t;
+    int        err;
+
+    if (kG == NULL || kP == NULL || tbl == NULL || R == NULL)
+        return ECC_BAD_ARG_E;
+
+    err = p256_scalar_load(s, kP);
+    if (err == MP_OKAY) {
+        p256_mul_fixed(&t, s,
+                       (const p256_affine (*)[P256_TABLE])tbl->pt);
+        err = p256_scalar_load(s, kG);
+    }
+    if (err == MP_OKAY) {
+        p256_mul_base(&r, s);
+        p256_point_add(&r, &r, &t);
+        err = p256_point_store(R, &r);
+    }
+
+    return err;
+}
+
+
+#endif /* HAVE_ECC_P256 */
+#endif /* HAVE_ECC */
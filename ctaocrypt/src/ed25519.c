@@ -0,0 +1,671 @@
+/* ed25519.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * Group arithmetic from Daniel J Bernstein's ed25519 ref10 work, on top of
+ * the curve25519 field code.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#ifdef HAVE_ED25519
+
+#include <cyassl/ctaocrypt/ed25519.h>
+#include <cyassl/ctaocrypt/ecc25519_ge.h>
+#include <cyassl/ctaocrypt/sha512.h>
+#include <cyassl/ctaocrypt/integer.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
+#include <cyassl/ctaocrypt/logging.h>
+
+
+/* the group order l = 2^252 + 27742317777372353535851937790883648493,
+   big endian for mp_read_unsigned_bin */
+static const byte ed25519_order[32] = {
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x14, 0xde, 0xf9, 0xde, 0xa2, 0xf7, 0x9c, 0xd6,
+    0x58, 0x12, 0x63, 0x1a, 0x5c, 0xf5, 0xd3, 0xed
+};
+
+/* batch verification coefficients are this many bytes */
+#define ED25519_BATCH_Z_SIZE 16
+
+
+/* Scalars mod l go through mp_int. The math library isn't constant time for
+   every operation, the same trade ecc_sign_hash makes. */
+
+/* load len little endian bytes into m */
+static int sc_load(mp_int* m, const byte* in, int len)
+{
+    byte be[64];
+    int  i;
+    int  ret;
+
+    for (i = 0; i < len; i++)
+        be[i] = in[len - 1 - i];
+
+    ret = mp_read_unsigned_bin(m, be, len);
+    XMEMSET(be, 0, len);
+
+    return ret;
+}
+
+
+/* store m, already below l, as 32 little endian bytes */
+static int sc_store(mp_int* m, byte* out)
+{
+    byte be[32];
+    int  sz = mp_unsigned_bin_size(m);
+    int  i;
+    int  ret;
+
+    if (sz > 32)
+        return BUFFER_E;
+
+    XMEMSET(be, 0, sizeof(be));
+    ret = mp_to_unsigned_bin(m, be + 32 - sz);
+    if (ret == MP_OKAY)
+        for (i = 0; i < 32; i++)
+            out[i] = be[31 - i];
+    XMEMSET(be, 0, sizeof(be));
+
+    return ret;
+}
+
+
+/* s = in mod l, in is 64 little endian bytes */
+static int sc_reduce(byte* s, const byte* in)
+{
+    mp_int x, l;
+    int    ret;
+
+    if ((ret = mp_init_multi(&x, &l, NULL, NULL, NULL, NULL)) != MP_OKAY)
+        return ret;
+
+    ret = mp_read_unsigned_bin(&l, ed25519_order, sizeof(ed25519_order));
+    if (ret == MP_OKAY)
+        ret = sc_load(&x, in, 64);
+    if (ret == MP_OKAY)
+        ret = mp_mod(&x, &l, &x);
+    if (ret == MP_OKAY)
+        ret = sc_store(&x, s);
+
+    mp_clear(&x);
+    mp_clear(&l);
+
+    return ret;
+}
+
+
+/* s = (a * b + c) mod l, all 32 little endian bytes */
+static int sc_muladd(byte* s, const byte* a, const byte* b, const byte* c)
+{
+    mp_int x, y, z, l;
+    int    ret;
+
+    if ((ret = mp_init_multi(&x, &y, &z, &l, NULL, NULL)) != MP_OKAY)
+        return ret;
+
+    ret = mp_read_unsigned_bin(&l, ed25519_order, sizeof(ed25519_order));
+    if (ret == MP_OKAY)
+        ret = sc_load(&x, a, 32);
+    if (ret == MP_OKAY)
+        ret = sc_load(&y, b, 32);
+    if (ret == MP_OKAY)
+        ret = sc_load(&z, c, 32);
+    if (ret == MP_OKAY)
+        ret = mp_mulmod(&x, &y, &l, &x);
+    if (ret == MP_OKAY)
+        ret = mp_add(&x, &z, &x);
+    if (ret == MP_OKAY)
+        ret = mp_mod(&x, &l, &x);
+    if (ret == MP_OKAY)
+        ret = sc_store(&x, s);
+
+    mp_clear(&x);
+    mp_clear(&y);
+    mp_clear(&z);
+    mp_clear(&l);
+
+    return ret;
+}
+
+
+/* 1 if the 32 little endian bytes in s are below l */
+static int sc_canonical(const byte* s)
+{
+    int i;
+
+    for (i = 31; i >= 0; i--) {
+        byte o = ed25519_order[31 - i];
+        if (s[i] < o)
+            return 1;
+        if (s[i] > o)
+            return 0;
+    }
+
+    return 0;   /* equal to l */
+}
+
+
+/* out = SHA-512(a || b || c) reduced mod l, any part may be NULL */
+static int ed25519_hram(byte* out, const byte* a, word32 aSz, const byte* b,
+                        word32 bSz, const byte* c, word32 cSz)
+{
+    Sha512 sha;
+    byte   h[SHA512_DIGEST_SIZE];
+    int    ret;
+
+    ret = InitSha512(&sha);
+    if (ret == 0 && a != NULL)
+        ret = Sha512Update(&sha, a, aSz);
+    if (ret == 0 && b != NULL)
+        ret = Sha512Update(&sha, b, bSz);
+    if (ret == 0 && c != NULL)
+        ret = Sha512Update(&sha, c, cSz);
+    if (ret == 0)
+        ret = Sha512Final(&sha, h);
+    if (ret == 0)
+        ret = sc_reduce(out, h);
+
+    XMEMSET(h, 0, sizeof(h));
+
+    return ret;
+}
+
+
+/* hash the seed into the clamped scalar a (first half) and the nonce prefix
+   (second half) */
+static int ed25519_expand(const byte* seed, byte* az)
+{
+    int ret = Sha512Hash(seed, ED25519_KEY_SIZE, az);
+
+    if (ret == 0) {
+        az[0]  &= 248;
+        az[31] &= 63;
+        az[31] |= 64;
+    }
+
+    return ret;
+}
+
+
+int ed25519_make_key(RNG* rng, int keysize, ed25519_key* key)
+{
+    byte  az[SHA512_DIGEST_SIZE];
+    ge_p3 A;
+    int   ret;
+
+    if (key == NULL || rng == NULL)
+        return BAD_FUNC_ARG;
+
+    /* only a 32 byte seed */
+    if (keysize != ED25519_KEY_SIZE)
+        return ECC_BAD_ARG_E;
+
+    ret = RNG_GenerateBlock(rng, key->k, ED25519_KEY_SIZE);
+    if (ret != 0)
+        return ret;
+
+    ret = ed25519_expand(key->k, az);
+    if (ret == 0) {
+        ge_scalarmult_base(&A, az);
+        ge_p3_tobytes(key->p, &A);
+
+        XMEMCPY(key->k + ED25519_KEY_SIZE, key->p, ED25519_PUB_KEY_SIZE);
+        key->pubSet  = 1;
+        key->privSet = 1;
+    }
+
+    XMEMSET(az, 0, sizeof(az));
+
+    return ret;
+}
+
+
+/* sign in with RFC 8032 Ed25519, out is R || S
+   return 0 on success */
+int ed25519_sign_msg(const byte* in, word32 inlen, byte* out, word32* outlen,
+                     ed25519_key* key)
+{
+    byte  az[SHA512_DIGEST_SIZE];
+    byte  nonce[32];
+    byte  hram[32];
+    ge_p3 R;
+    int   ret;
+
+    CYASSL_ENTER("ed25519_sign_msg");
+
+    if ((in == NULL && inlen > 0) || out == NULL || outlen == NULL ||
+                                                                key == NULL)
+        return BAD_FUNC_ARG;
+
+    if (!key->privSet)
+        return ECC_BAD_ARG_E;
+
+    if (*outlen < ED25519_SIG_SIZE) {
+        *outlen = ED25519_SIG_SIZE;
+        return BUFFER_E;
+    }
+
+    ret = ed25519_expand(key->k, az);
+
+    /* r = H(prefix || M), R = r * B */
+    if (ret == 0)
+        ret = ed25519_hram(nonce, az + 32, 32, in, inlen, NULL, 0);
+    if (ret == 0) {
+        ge_scalarmult_base(&R, nonce);
+        ge_p3_tobytes(out, &R);
+    }
+
+    /* S = r + H(R || A || M) * a */
+    if (ret == 0)
+        ret = ed25519_hram(hram, out, 32, key->p, ED25519_PUB_KEY_SIZE,
+                           in, inlen);
+    if (ret == 0)
+        ret = sc_muladd(out + 32, hram, az, nonce);
+    if (ret == 0)
+        *outlen = ED25519_SIG_SIZE;
+
+    XMEMSET(az, 0, sizeof(az));
+    XMEMSET(nonce, 0, sizeof(nonce));
+
+    return ret;
+}
+
+
+/* decode the signed key and signature, and hash R || A || M
+   return 0 on success, 1 if the signature can't be valid */
+static int ed25519_verify_setup(const byte* sig, word32 siglen,
+                                const byte* msg, word32 msglen,
+                                ed25519_key* key, ge_p3* negA, byte* hram)
+{
+    int ret;
+
+    if (siglen != ED25519_SIG_SIZE || !sc_canonical(sig + 32))
+        return 1;
+
+    if (ge_frombytes_negate_vartime(negA, key->p) != 0)
+        return 1;
+
+    ret = ed25519_hram(hram, sig, 32, key->p, ED25519_PUB_KEY_SIZE,
+                       msg, msglen);
+    if (ret != 0)
+        return ret;
+
+    return 0;
+}
+
+
+/* verify sig over msg, stat is 1 when it's good and 0 when it isn't
+   return 0 on success, stat holds the result */
+int ed25519_verify_msg(const byte* sig, word32 siglen, const byte* msg,
+                       word32 msglen, int* stat, ed25519_key* key)
+{
+    byte  hram[32];
+    byte  check[32];
+    ge_p3 negA;
+    ge_p2 R;
+    int   ret;
+
+    CYASSL_ENTER("ed25519_verify_msg");
+
+    if (sig == NULL || (msg == NULL && msglen > 0) || stat == NULL ||
+                                                                key == NULL)
+        return BAD_FUNC_ARG;
+
+    *stat = 0;
+
+    if (!key->pubSet)
+        return ECC_BAD_ARG_E;
+
+    ret = ed25519_verify_setup(sig, siglen, msg, msglen, key, &negA, hram);
+    if (ret == 1)
+        return 0;
+    if (ret != 0)
+        return ret;
+
+    /* R' = H(R || A || M) * -A + S * B must encode to R */
+    ge_double_scalarmult_vartime(&R, hram, &negA, sig + 32);
+    ge_tobytes(check, &R);
+
+    if (XMEMCMP(check, sig, 32) == 0)
+        *stat = 1;
+
+    return 0;
+}
+
+
+/* Verify count signatures at once. Each stat[i] is set as ed25519_verify_msg
+   would. With random 128 bit z_i the batch is checked as
+
+       8 * ((sum z_i S_i) B - sum z_i R_i - sum (z_i h_i) A_i) = 0
+
+   sharing one set of doublings across every point. That's the cofactor form
+   RFC 8032 allows; when it fails, or any input is malformed, every signature
+   is checked on its own. The z_i come from SHA-512 over all the inputs so a
+   batch can't be built ahead of them.
+   return 0 on success, stat holds the results */
+int ed25519_verify_msg_batch(const byte** sig, const word32* siglen,
+                             const byte** msg, const word32* msglen,
+                             int* stat, int count, ed25519_key** key)
+{
+    byte*         mem;
+    ge_p3*        pts;
+    ge_cached*    Ai;
+    ge_cached**   cached;
+    signed char*  slide;
+    signed char** slides;
+    byte*         scal;
+    byte          seed[SHA512_DIGEST_SIZE];
+    byte          z[32];
+    byte          bsum[32];
+    byte          zero[32];
+    signed char   bslide[256];
+    ge_precomp    Bi[8];
+    ge_p2         r;
+    ge_p1p1       t;
+    fe            yz;
+    Sha512        sha;
+    word32        sz;
+    byte          len[4];
+    int           n;
+    int           i;
+    int           ok = 0;
+    int           ret = 0;
+
+    CYASSL_ENTER("ed25519_verify_msg_batch");
+
+    if (sig == NULL || siglen == NULL || msg == NULL || msglen == NULL ||
+                                stat == NULL || key == NULL || count < 0)
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < count; i++) {
+        if (sig[i] == NULL || (msg[i] == NULL && msglen[i] > 0) ||
+                                                            key[i] == NULL)
+            return BAD_FUNC_ARG;
+        if (!key[i]->pubSet)
+            return ECC_BAD_ARG_E;
+        stat[i] = 0;
+    }
+
+    /* not worth the setup for one */
+    if (count < 2)
+        goto individual;
+
+    /* per signature: -A and -R, their cached odd multiples, window digits for
+       z_i * h_i and z_i, and those two scalars */
+    n  = 2 * count;
+    sz = n * (sizeof(ge_p3) + 8 * sizeof(ge_cached) + sizeof(ge_cached*) +
+              256 + sizeof(signed char*) + 32);
+    mem = (byte*)XMALLOC(sz, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (mem == NULL)
+        goto individual;
+
+    Ai     = (ge_cached*)mem;
+    pts    = (ge_p3*)(Ai + 8 * n);
+    cached = (ge_cached**)(pts + n);
+    slides = (signed char**)(cached + n);
+    slide  = (signed char*)(slides + n);
+    scal   = (byte*)(slide + 256 * n);
+
+    /* z seed over every input */
+    ret = InitSha512(&sha);
+    for (i = 0; ret == 0 && i < count; i++) {
+        ret = Sha512Update(&sha, sig[i], siglen[i]);
+        if (ret == 0)
+            ret = Sha512Update(&sha, key[i]->p, ED25519_PUB_KEY_SIZE);
+        len[0] = (byte)(msglen[i] >> 24);
+        len[1] = (byte)(msglen[i] >> 16);
+        len[2] = (byte)(msglen[i] >>  8);
+        len[3] = (byte)msglen[i];
+        if (ret == 0)
+            ret = Sha512Update(&sha, len, sizeof(len));
+        if (ret == 0 && msglen[i] > 0)
+            ret = Sha512Update(&sha, msg[i], msglen[i]);
+    }
+    if (ret == 0)
+        ret = Sha512Final(&sha, seed);
+
+    XMEMSET(bsum, 0, sizeof(bsum));
+    XMEMSET(zero, 0, sizeof(zero));
+
+    for (i = 0; ret == 0 && i < count; i++) {
+        byte* zh = scal + 64 * i;
+        byte* zr = zh + 32;
+        byte  hram[32];
+        byte  ctr[4];
+        byte  h[SHA512_DIGEST_SIZE];
+
+        ret = ed25519_verify_setup(sig[i], siglen[i], msg[i], msglen[i], key[i],
+                                   &pts[2 * i], hram);
+        if (ret == 1 ||
+            (ret == 0 && ge_frombytes_negate_vartime(&pts[2 * i + 1],
+                                                     sig[i]) != 0)) {
+            ret = 1;
+            break;
+        }
+
+        /* z_i, 128 bits */
+        ctr[0] = (byte)(i >> 24);
+        ctr[1] = (byte)(i >> 16);
+        ctr[2] = (byte)(i >>  8);
+        ctr[3] = (byte)i;
+        if (ret == 0)
+            ret = InitSha512(&sha);
+        if (ret == 0)
+            ret = Sha512Update(&sha, seed, sizeof(seed));
+        if (ret == 0)
+            ret = Sha512Update(&sha, ctr, sizeof(ctr));
+        if (ret == 0)
+            ret = Sha512Final(&sha, h);
+        if (ret != 0)
+            break;
+        XMEMSET(z, 0, sizeof(z));
+        XMEMCPY(z, h, ED25519_BATCH_Z_SIZE);
+
+        /* z_i * h_i for -A_i, z_i for -R_i, sum of z_i * S_i for B */
+        ret = sc_muladd(zh, z, hram, zero);
+        if (ret == 0)
+            XMEMCPY(zr, z, 32);
+        if (ret == 0)
+            ret = sc_muladd(bsum, z, sig[i] + 32, bsum);
+    }
+
+    if (ret == 0) {
+        ge_base_odd(Bi);
+        ge_slide(bslide, bsum);
+
+        for (i = 0; i < n; i++) {
+            cached[i] = Ai + 8 * i;
+            slides[i] = slide + 256 * i;
+            ge_cached_odd(cached[i], &pts[i]);
+            ge_slide(slides[i], scal + 32 * i);
+        }
+
+        ge_p2_0(&r);
+        for (i = 255; i >= 0; --i)
+            ge_multi_step(&r, i, n, slides, cached, bslide, Bi);
+
+        /* clear the small order part, then test for the identity */
+        ge_p2_dbl(&t, &r); ge_p1p1_to_p2(&r, &t);
+        ge_p2_dbl(&t, &r); ge_p1p1_to_p2(&r, &t);
+        ge_p2_dbl(&t, &r); ge_p1p1_to_p2(&r, &t);
+
+        fe_sub(yz, r.Y, r.Z);
+        ok = !fe_isnonzero(r.X) && !fe_isnonzero(yz);
+    }
+
+    XFREE(mem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    if (ret < 0)
+        return ret;
+
+    if (ok) {
+        for (i = 0; i < count; i++)
+            stat[i] = 1;
+        return 0;
+    }
+
+individual:
+    CYASSL_MSG("Ed25519 batch failed or skipped, verifying one at a time");
+    for (i = 0; i < count; i++) {
+        ret = ed25519_verify_msg(sig[i], siglen[i], msg[i], msglen[i],
+                                 &stat[i], key[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+
+int ed25519_init(ed25519_key* key)
+{
+    if (key == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(key, 0, sizeof(ed25519_key));
+
+    return 0;
+}
+
+
+/**
+  Clean the memory of a key
+*/
+void ed25519_free(ed25519_key* key)
+{
+    if (key == NULL)
+        return;
+
+    XMEMSET(key, 0, sizeof(ed25519_key));
+}
+
+
+/* import a 32 byte Ed25519 public key
+   return 0 on success */
+int ed25519_import_public(const byte* in, word32 inLen, ed25519_key* key)
+{
+    ge_p3 A;
+
+    if (in == NULL || key == NULL)
+        return BAD_FUNC_ARG;
+
+    if (inLen != ED25519_PUB_KEY_SIZE)
+        return ECC_BAD_ARG_E;
+
+    /* must be a point on the curve */
+    if (ge_frombytes_negate_vartime(&A, in) != 0)
+        return ECC_BAD_ARG_E;
+
+    XMEMCPY(key->p, in, ED25519_PUB_KEY_SIZE);
+    key->pubSet = 1;
+
+    return 0;
+}
+
+
+/* import the 32 byte private seed and its public key
+   return 0 on success */
+int ed25519_import_private_key(const byte* priv, word32 privSz,
+                               const byte* pub, word32 pubSz, ed25519_key* key)
+{
+    int ret;
+
+    if (priv == NULL || pub == NULL || key == NULL)
+        return BAD_FUNC_ARG;
+
+    if (privSz != ED25519_KEY_SIZE)
+        return ECC_BAD_ARG_E;
+
+    ret = ed25519_import_public(pub, pubSz, key);
+    if (ret != 0)
+        return ret;
+
+    XMEMCPY(key->k, priv, ED25519_KEY_SIZE);
+    XMEMCPY(key->k + ED25519_KEY_SIZE, pub, ED25519_PUB_KEY_SIZE);
+    key->privSet = 1;
+
+    return 0;
+}
+
+
+/* export the public key, outLen is in/out size
+   return 0 on success */
+int ed25519_export_public(ed25519_key* key, byte* out, word32* outLen)
+{
+    if (key == NULL || out == NULL || outLen == NULL)
+        return BAD_FUNC_ARG;
+
+    if (*outLen < ED25519_PUB_KEY_SIZE) {
+        *outLen = ED25519_PUB_KEY_SIZE;
+        return BUFFER_E;
+    }
+
+    XMEMCPY(out, key->p, ED25519_PUB_KEY_SIZE);
+    *outLen = ED25519_PUB_KEY_SIZE;
+
+    return 0;
+}
+
+
+/* export the private seed only, outLen is in/out size
+   return 0 on success */
+int ed25519_export_private_only(ed25519_key* key, byte* out, word32* outLen)
+{
+    if (key == NULL || out == NULL || outLen == NULL)
+        return BAD_FUNC_ARG;
+
+    if (*outLen < ED25519_KEY_SIZE) {
+        *outLen = ED25519_KEY_SIZE;
+        return BUFFER_E;
+    }
+
+    XMEMCPY(out, key->k, ED25519_KEY_SIZE);
+    *outLen = ED25519_KEY_SIZE;
+
+    return 0;
+}
+
+
+/* key size */
+int ed25519_size(ed25519_key* key)
+{
+    if (key == NULL) return BAD_FUNC_ARG;
+
+    return ED25519_KEY_SIZE;
+}
+
+
+/* signature size */
+int ed25519_sig_size(ed25519_key* key)
+{
+    if (key == NULL) return BAD_FUNC_ARG;
+
+    return ED25519_SIG_SIZE;
+}
+
+#endif /* HAVE_ED25519 */
+
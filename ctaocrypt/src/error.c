@@ -310,6 +310,21 @@ const char* CTaoCryptGetErrorString(int error)
     case AESGCM_KAT_FIPS_E:
         return "AESGCM Known Answer Test check FIPS error";
 
+    case CHACHA_POLY_AUTH_E:
+        return "ChaCha20-Poly1305 Authentication check fail";
+
+    case TREE_HASH_FILE_E:
+        return "Tree hash file open or map error";
+
+    case CRYPTO_DEV_UNAVAILABLE_E:
+        return "Crypto device not registered or declined the request";
+
+    case ECC_SESSION_SEQ_E:
+        return "Ecc session nonce replayed, out of order or used up";
+
+    case ECC_SESSION_MAC_E:
+        return "Ecc session message mac mismatch";
+
     default:
         return "unknown error number";
 
@@ -30,6 +30,7 @@
 #include <cyassl/ctaocrypt/hc128.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #ifdef NO_INLINE
     #include <cyassl/ctaocrypt/hc128.h>
 		#include <cyassl/ctaocrypt/misc.h>
@@ -44,6 +45,21 @@
     #define LITTLE32(x) (x)
 #endif
 
+/* the keystream itself is a serial walk of the P and Q tables, only the
+ * XOR into the message goes wide */
+#if defined(HAVE_CYASSL_X86_SIMD)
+    #define HC128_SSE2
+    #include <emmintrin.h>
+#elif defined(HAVE_CYASSL_CPUID) && defined(__aarch64__) && \
+      !defined(BIG_ENDIAN_ORDER)
+    #define HC128_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(HC128_SSE2) || defined(HC128_NEON)
+    #define HC128_BATCH 4   /* 64 byte keystream chunks per batch */
+#endif
+
 
 /*h1 function*/
 #define h1(ctx, x, y) {                         \
@@ -313,6 +329,42 @@ static INLINE int DoProcess(HC128* ctx, byte* output, const byte* input,
 {
   word32 i, keystream[16];
 
+#ifdef HC128_BATCH
+  #ifdef HC128_SSE2
+  if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_SSE2)
+  #else
+  if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_ARM_NEON)
+  #endif
+  {
+      word32 batch[16 * HC128_BATCH];
+      word32 n, j;
+
+      while (msglen >= 64) {
+          n = msglen / 64;
+          if (n > HC128_BATCH)
+              n = HC128_BATCH;
+
+          for (j = 0; j < n; j++)
+              generate_keystream(ctx, batch + 16 * j);
+
+          for (j = 0; j < n * 64; j += 16) {
+          #ifdef HC128_SSE2
+              _mm_storeu_si128((__m128i*)(output + j), _mm_xor_si128(
+                  _mm_loadu_si128((const __m128i*)(input + j)),
+                  _mm_loadu_si128((const __m128i*)((byte*)batch + j))));
+          #else
+              vst1q_u8(output + j, veorq_u8(vld1q_u8(input + j),
+                                            vld1q_u8((byte*)batch + j)));
+          #endif
+          }
+
+          input  += n * 64;
+          output += n * 64;
+          msglen -= n * 64;
+      }
+  }
+#endif /* HC128_BATCH */
+
   for ( ; msglen >= 64; msglen -= 64, input += 64, output += 64)
   {
 	  generate_keystream(ctx, keystream);
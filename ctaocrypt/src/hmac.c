@@ -50,6 +50,9 @@
 
 #include <cyassl/ctaocrypt/hmac.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 
 
 #ifdef HAVE_CAVIUM
@@ -65,6 +68,7 @@ static int InitHmac(Hmac* hmac, int type)
 
     hmac->innerHashKeyed = 0;
     hmac->macType = (byte)type;
+    hmac->state   = NULL;
 
     if (!(type == MD5 || type == SHA    || type == SHA256 || type == SHA384
                       || type == SHA512 || type == BLAKE2B_ID))
@@ -131,6 +135,14 @@ int HmacSetKey(Hmac* hmac, int type, const byte* key, word32 length)
     if (ret != 0)
         return ret;
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (hmac->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Hmac(hmac, type, key, length, NULL, 0, NULL);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
 #ifdef HAVE_FIPS
     if (length < HMAC_FIPS_MIN_KEY)
         return HMAC_MIN_KEYLEN_E;
@@ -271,27 +283,27 @@ int HmacSetKey(Hmac* hmac, int type, const byte* key, word32 length)
 }
 
 
-static int HmacKeyInnerHash(Hmac* hmac)
+/* hash one of the key pads, a block for every type */
+static int HmacKeyHash(Hmac* hmac, const byte* pad)
 {
     int ret = 0;
 
     switch (hmac->macType) {
         #ifndef NO_MD5
         case MD5:
-            Md5Update(&hmac->hash.md5, (byte*) hmac->ipad, MD5_BLOCK_SIZE);
+            Md5Update(&hmac->hash.md5, pad, MD5_BLOCK_SIZE);
         break;
         #endif
 
         #ifndef NO_SHA
         case SHA:
-            ShaUpdate(&hmac->hash.sha, (byte*) hmac->ipad, SHA_BLOCK_SIZE);
+            ShaUpdate(&hmac->hash.sha, pad, SHA_BLOCK_SIZE);
         break;
         #endif
 
         #ifndef NO_SHA256
         case SHA256:
-            ret = Sha256Update(&hmac->hash.sha256,
-                                         (byte*) hmac->ipad, SHA256_BLOCK_SIZE);
+            ret = Sha256Update(&hmac->hash.sha256, pad, SHA256_BLOCK_SIZE);
             if (ret != 0)
                 return ret;
         break;
@@ -299,8 +311,7 @@ static int HmacKeyInnerHash(Hmac* hmac)
 
         #ifdef CYASSL_SHA384
         case SHA384:
-            ret = Sha384Update(&hmac->hash.sha384,
-                                         (byte*) hmac->ipad, SHA384_BLOCK_SIZE);
+            ret = Sha384Update(&hmac->hash.sha384, pad, SHA384_BLOCK_SIZE);
             if (ret != 0)
                 return ret;
         break;
@@ -308,8 +319,7 @@ static int HmacKeyInnerHash(Hmac* hmac)
 
         #ifdef CYASSL_SHA512
         case SHA512:
-            ret = Sha512Update(&hmac->hash.sha512,
-                                         (byte*) hmac->ipad, SHA512_BLOCK_SIZE);
+            ret = Sha512Update(&hmac->hash.sha512, pad, SHA512_BLOCK_SIZE);
             if (ret != 0)
                 return ret;
         break;
@@ -317,8 +327,7 @@ static int HmacKeyInnerHash(Hmac* hmac)
 
         #ifdef HAVE_BLAKE2 
         case BLAKE2B_ID:
-            ret = Blake2bUpdate(&hmac->hash.blake2b,
-                                         (byte*) hmac->ipad,BLAKE2B_BLOCKBYTES);
+            ret = Blake2bUpdate(&hmac->hash.blake2b, pad, BLAKE2B_BLOCKBYTES);
             if (ret != 0)
                 return ret;
         break;
@@ -328,12 +337,38 @@ static int HmacKeyInnerHash(Hmac* hmac)
         break;
     }
 
+    return ret;
+}
+
+
+/* start the inner hash, from the keyed state if cloned */
+static int HmacKeyInnerHash(Hmac* hmac)
+{
+    int ret = 0;
+
+    if (hmac->state)
+        hmac->hash = hmac->state->inner;
+    else
+        ret = HmacKeyHash(hmac, (byte*) hmac->ipad);
+
     hmac->innerHashKeyed = 1;
 
     return ret;
 }
 
 
+/* start the outer hash, from the keyed state if cloned */
+static int HmacKeyOuterHash(Hmac* hmac)
+{
+    if (hmac->state) {
+        hmac->hash = hmac->state->outer;
+        return 0;
+    }
+
+    return HmacKeyHash(hmac, (byte*) hmac->opad);
+}
+
+
 int HmacUpdate(Hmac* hmac, const byte* msg, word32 length)
 {
     int ret;
@@ -343,6 +378,14 @@ int HmacUpdate(Hmac* hmac, const byte* msg, word32 length)
         return HmacCaviumUpdate(hmac, msg, length);
 #endif
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (hmac->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Hmac(hmac, hmac->macType, NULL, 0, msg, length, NULL);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
     if (!hmac->innerHashKeyed) {
         ret = HmacKeyInnerHash(hmac);
         if (ret != 0)
@@ -411,6 +454,14 @@ int HmacFinal(Hmac* hmac, byte* hash)
         return HmacCaviumFinal(hmac, hash);
 #endif
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (hmac->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Hmac(hmac, hmac->macType, NULL, 0, NULL, 0, hash);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
     if (!hmac->innerHashKeyed) {
         ret = HmacKeyInnerHash(hmac);
         if (ret != 0)
@@ -423,7 +474,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
         {
             Md5Final(&hmac->hash.md5, (byte*) hmac->innerHash);
 
-            Md5Update(&hmac->hash.md5, (byte*) hmac->opad, MD5_BLOCK_SIZE);
+            HmacKeyOuterHash(hmac);
             Md5Update(&hmac->hash.md5,
                                      (byte*) hmac->innerHash, MD5_DIGEST_SIZE);
 
@@ -437,7 +488,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
         {
             ShaFinal(&hmac->hash.sha, (byte*) hmac->innerHash);
 
-            ShaUpdate(&hmac->hash.sha, (byte*) hmac->opad, SHA_BLOCK_SIZE);
+            HmacKeyOuterHash(hmac);
             ShaUpdate(&hmac->hash.sha,
                                      (byte*) hmac->innerHash, SHA_DIGEST_SIZE);
 
@@ -453,8 +504,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
             if (ret != 0)
                 return ret;
 
-            ret = Sha256Update(&hmac->hash.sha256,
-                                (byte*) hmac->opad, SHA256_BLOCK_SIZE);
+            ret = HmacKeyOuterHash(hmac);
             if (ret != 0)
                 return ret;
 
@@ -477,8 +527,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
             if (ret != 0)
                 return ret;
 
-            ret = Sha384Update(&hmac->hash.sha384,
-                                 (byte*) hmac->opad, SHA384_BLOCK_SIZE);
+            ret = HmacKeyOuterHash(hmac);
             if (ret != 0)
                 return ret;
 
@@ -501,8 +550,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
             if (ret != 0)
                 return ret;
 
-            ret = Sha512Update(&hmac->hash.sha512,
-                                 (byte*) hmac->opad, SHA512_BLOCK_SIZE);
+            ret = HmacKeyOuterHash(hmac);
             if (ret != 0)
                 return ret;
 
@@ -526,8 +574,7 @@ int HmacFinal(Hmac* hmac, byte* hash)
             if (ret != 0)
                 return ret;
 
-            ret = Blake2bUpdate(&hmac->hash.blake2b,
-                                 (byte*) hmac->opad, BLAKE2B_BLOCKBYTES);
+            ret = HmacKeyOuterHash(hmac);
             if (ret != 0)
                 return ret;
 
@@ -553,6 +600,57 @@ int HmacFinal(Hmac* hmac, byte* hash)
 }
 
 
+/* hash the key pads once and keep both states for HmacCloneState */
+int HmacInitKeyedState(HmacState* state, int type, const byte* key,
+                       word32 keySz)
+{
+    Hmac   hmac;
+    int    ret;
+
+    if (state == NULL || (key == NULL && keySz != 0))
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_CAVIUM
+    hmac.magic = 0;
+#endif
+
+    ret = HmacSetKey(&hmac, type, key, keySz);
+    if (ret == 0)
+        ret = HmacKeyHash(&hmac, (byte*) hmac.ipad);
+    if (ret == 0) {
+        state->inner = hmac.hash;
+        ret = InitHmac(&hmac, type);
+    }
+    if (ret == 0)
+        ret = HmacKeyHash(&hmac, (byte*) hmac.opad);
+    if (ret == 0) {
+        state->outer   = hmac.hash;
+        state->macType = (byte)type;
+    }
+
+    XMEMSET(&hmac, 0, sizeof(hmac));
+
+    return ret;
+}
+
+
+/* start hmac on the precomputed key, it stays keyed across HmacFinal calls */
+int HmacCloneState(Hmac* hmac, const HmacState* state)
+{
+    if (hmac == NULL || state == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_CAVIUM
+    hmac->magic = 0;
+#endif
+    hmac->macType        = state->macType;
+    hmac->state          = state;
+    hmac->innerHashKeyed = 0;
+
+    return 0;
+}
+
+
 #ifdef HAVE_CAVIUM
 
 /* Initiliaze Hmac for use with Nitrox device */
@@ -663,6 +761,18 @@ static void HmacCaviumSetKey(Hmac* hmac, int type, const byte* key,
 
 #endif /* HAVE_CAVIUM */
 
+
+#ifdef CYASSL_CRYPTO_DEV
+
+/* send this Hmac's requests to the device registered as devId first */
+void HmacSetDevId(Hmac* hmac, int devId)
+{
+    hmac->cdevId    = devId;
+    hmac->cdevMagic = CYASSL_CRYPTO_DEV_MAGIC;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
 int CyaSSL_GetHmacMaxSize(void)
 {
     return MAX_DIGEST_SIZE;
@@ -730,27 +840,55 @@ static INLINE int GetHashSizeByType(int type)
 }
 
 
-/* HMAC-KDF with hash type, optional salt and info, return 0 on success */
-int HKDF(int type, const byte* inKey, word32 inKeySz,
-                   const byte* salt,  word32 saltSz,
-                   const byte* info,  word32 infoSz,
-                   byte* out,         word32 outSz)
+/* HKDF-Extract, prk gets the hash size, no salt means a zero one */
+int HKDF_Extract(int type, const byte* salt, word32 saltSz,
+                 const byte* inKey, word32 inKeySz, byte* prk)
+{
+    Hmac   myHmac;
+    byte   zeros[MAX_DIGEST_SIZE];
+    int    hashSz = GetHashSizeByType(type);
+    int    ret;
+
+    if (hashSz < 0 || prk == NULL)
+        return BAD_FUNC_ARG;
+
+    if (salt == NULL) {
+        XMEMSET(zeros, 0, hashSz);
+        salt   = zeros;
+        saltSz = hashSz;
+    }
+
+    ret = HmacSetKey(&myHmac, type, salt, saltSz);
+    if (ret == 0)
+        ret = HmacUpdate(&myHmac, inKey, inKeySz);
+    if (ret == 0)
+        ret = HmacFinal(&myHmac, prk);
+
+    XMEMSET(&myHmac, 0, sizeof(myHmac));
+
+    return ret;
+}
+
+
+/* HKDF-Expand prk into outSz bytes, at most 255 hash blocks */
+int HKDF_Expand(int type, const byte* prk, word32 prkSz,
+                const byte* info, word32 infoSz, byte* out, word32 outSz)
 {
     Hmac   myHmac;
 #ifdef CYASSL_SMALL_STACK
     byte* tmp;
-    byte* prk;
+    HmacState* prkState;
 #else
-    byte   tmp[MAX_DIGEST_SIZE]; /* localSalt helper and T */
-    byte   prk[MAX_DIGEST_SIZE];
+    byte   tmp[MAX_DIGEST_SIZE]; /* T(n) */
+    HmacState prkState[1];       /* expand keys every T(n) from here */
 #endif
-    const  byte* localSalt;  /* either points to user input or tmp */
     int    hashSz = GetHashSizeByType(type);
     word32 outIdx = 0;
     byte   n = 0x1;
     int    ret;
 
-    if (hashSz < 0)
+    if (hashSz < 0 || prk == NULL || out == NULL ||
+                                             outSz > 255 * (word32)hashSz)
         return BAD_FUNC_ARG;
 
 #ifdef CYASSL_SMALL_STACK
@@ -758,67 +896,76 @@ int HKDF(int type, const byte* inKey, word32 inKeySz,
     if (tmp == NULL)
         return MEMORY_E;
 
-    prk = (byte*)XMALLOC(MAX_DIGEST_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-    if (prk == NULL) {
+    prkState = (HmacState*)XMALLOC(sizeof(HmacState), NULL,
+                                   DYNAMIC_TYPE_TMP_BUFFER);
+    if (prkState == NULL) {
         XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         return MEMORY_E;
     }
 #endif
 
-    localSalt = salt;
-    if (localSalt == NULL) {
-        XMEMSET(tmp, 0, hashSz);
-        localSalt = tmp;
-        saltSz    = hashSz;
-    }
-    
-    do {
-    ret = HmacSetKey(&myHmac, type, localSalt, saltSz);
-    if (ret != 0)
-        break;
-    ret = HmacUpdate(&myHmac, inKey, inKeySz);
-    if (ret != 0)
-        break;
-    ret = HmacFinal(&myHmac,  prk);
-    } while (0);
+    ret = HmacInitKeyedState(prkState, type, prk, prkSz);
+    if (ret == 0)
+        ret = HmacCloneState(&myHmac, prkState);
 
-    if (ret == 0) {
-        while (outIdx < outSz) {
-            int    tmpSz = (n == 1) ? 0 : hashSz;
-            word32 left = outSz - outIdx;
+    while (ret == 0 && outIdx < outSz) {
+        int    tmpSz = (n == 1) ? 0 : hashSz;
+        word32 left = outSz - outIdx;
 
-            ret = HmacSetKey(&myHmac, type, prk, hashSz);
-            if (ret != 0)
-                break;
-            ret = HmacUpdate(&myHmac, tmp, tmpSz);
-            if (ret != 0)
-                break;
-            ret = HmacUpdate(&myHmac, info, infoSz);
-            if (ret != 0)
-                break;
-            ret = HmacUpdate(&myHmac, &n, 1);
-            if (ret != 0)
-                break;
-            ret = HmacFinal(&myHmac, tmp);
-            if (ret != 0)
-                break;
+        ret = HmacUpdate(&myHmac, tmp, tmpSz);
+        if (ret != 0)
+            break;
+        ret = HmacUpdate(&myHmac, info, infoSz);
+        if (ret != 0)
+            break;
+        ret = HmacUpdate(&myHmac, &n, 1);
+        if (ret != 0)
+            break;
+        ret = HmacFinal(&myHmac, tmp);
+        if (ret != 0)
+            break;
 
-            left = min(left, (word32)hashSz);
-            XMEMCPY(out+outIdx, tmp, left);
+        left = min(left, (word32)hashSz);
+        XMEMCPY(out+outIdx, tmp, left);
 
-            outIdx += hashSz;
-            n++;
-        }
+        outIdx += hashSz;
+        n++;
     }
 
+    XMEMSET(tmp, 0, MAX_DIGEST_SIZE);
+    XMEMSET(prkState, 0, sizeof(HmacState));
+
 #ifdef CYASSL_SMALL_STACK
     XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-    XFREE(prk, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(prkState, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
 
     return ret;
 }
 
+
+/* HMAC-KDF with hash type, optional salt and info, return 0 on success */
+int HKDF(int type, const byte* inKey, word32 inKeySz,
+                   const byte* salt,  word32 saltSz,
+                   const byte* info,  word32 infoSz,
+                   byte* out,         word32 outSz)
+{
+    byte   prk[MAX_DIGEST_SIZE];
+    int    hashSz = GetHashSizeByType(type);
+    int    ret;
+
+    if (hashSz < 0)
+        return BAD_FUNC_ARG;
+
+    ret = HKDF_Extract(type, salt, saltSz, inKey, inKeySz, prk);
+    if (ret == 0)
+        ret = HKDF_Expand(type, prk, hashSz, info, infoSz, out, outSz);
+
+    XMEMSET(prk, 0, sizeof(prk));
+
+    return ret;
+}
+
 #endif /* HAVE_HKDF */
 
 #endif /* NO_HMAC */
@@ -47,6 +47,91 @@
 
 static void bn_reverse (unsigned char *s, int len);
 
+
+#ifdef CYASSL_MP_POOL
+
+#if !defined(HAVE_THREAD_LS) && !defined(SINGLE_THREADED)
+    #error CYASSL_MP_POOL needs HAVE_THREAD_LS for its per thread pool
+#endif
+
+#ifndef MP_POOL_SZ
+    #define MP_POOL_SZ         16       /* digit arrays kept per thread */
+#endif
+#ifndef MP_POOL_MAX_DIGITS
+    #define MP_POOL_MAX_DIGITS 256      /* bigger ones go back to the heap */
+#endif
+
+/* Digit arrays mp_clear gave back, zeroed and still at their grown size, so
+   the temporaries of the next exptmod or point op skip malloc and most of
+   their mp_grow reallocs. An array can come back on another thread than it
+   left, it's all the same heap. */
+typedef struct MpPool {
+    mp_digit* dp[MP_POOL_SZ];
+    int       alloc[MP_POOL_SZ];
+    int       count;
+} MpPool;
+
+static THREAD_LS_T MpPool mpPool;
+
+
+/* smallest pooled array of at least size digits, MP_OKAY if one was taken */
+static int mp_pool_get (mp_int * a, int size)
+{
+  MpPool* pool = &mpPool;
+  int     i, best = -1;
+
+  for (i = 0; i < pool->count; i++) {
+    if (pool->alloc[i] >= size &&
+        (best < 0 || pool->alloc[i] < pool->alloc[best]))
+      best = i;
+  }
+  if (best < 0)
+    return MP_VAL;
+
+  a->dp    = pool->dp[best];
+  a->alloc = pool->alloc[best];
+  a->used  = 0;
+  a->sign  = MP_ZPOS;
+
+  pool->count--;
+  pool->dp[best]    = pool->dp[pool->count];
+  pool->alloc[best] = pool->alloc[pool->count];
+
+  return MP_OKAY;
+}
+
+
+/* keep a's zeroed digits for reuse, MP_OKAY if the pool took them */
+static int mp_pool_put (mp_int * a)
+{
+  MpPool* pool = &mpPool;
+
+  if (pool->count == MP_POOL_SZ || a->alloc > MP_POOL_MAX_DIGITS)
+    return MP_VAL;
+
+  XMEMSET(a->dp, 0, sizeof (mp_digit) * a->alloc);
+  pool->dp[pool->count]    = a->dp;
+  pool->alloc[pool->count] = a->alloc;
+  pool->count++;
+
+  return MP_OKAY;
+}
+
+
+/* free this thread's pooled digits, call before a thread exits */
+void mp_pool_free (void)
+{
+  MpPool* pool = &mpPool;
+
+  while (pool->count > 0) {
+    pool->count--;
+    XFREE(pool->dp[pool->count], 0, DYNAMIC_TYPE_BIGINT);
+    pool->dp[pool->count] = NULL;
+  }
+}
+
+#endif /* CYASSL_MP_POOL */
+
 /* math settings check */
 word32 CheckRunTimeSettings(void)
 {
@@ -97,6 +182,11 @@ int mp_init (mp_int * a)
 {
   int i;
 
+#ifdef CYASSL_MP_POOL
+  if (mp_pool_get(a, MP_PREC) == MP_OKAY)
+    return MP_OKAY;
+#endif
+
   /* allocate memory required and clear it */
   a->dp = OPT_CAST(mp_digit) XMALLOC (sizeof (mp_digit) * MP_PREC, 0,
                                       DYNAMIC_TYPE_BIGINT);
@@ -130,13 +220,18 @@ mp_clear (mp_int * a)
 
   /* only do anything if a hasn't been freed previously */
   if (a->dp != NULL) {
-    /* first zero the digits */
-    for (i = 0; i < a->used; i++) {
-        a->dp[i] = 0;
-    }
+  #ifdef CYASSL_MP_POOL
+    if (mp_pool_put(a) != MP_OKAY)
+  #endif
+    {
+      /* first zero the digits */
+      for (i = 0; i < a->used; i++) {
+          a->dp[i] = 0;
+      }
 
-    /* free ram */
-    XFREE(a->dp, 0, DYNAMIC_TYPE_BIGINT);
+      /* free ram */
+      XFREE(a->dp, 0, DYNAMIC_TYPE_BIGINT);
+    }
 
     /* reset members to make debugging easier */
     a->dp    = NULL;
@@ -813,6 +908,73 @@ int mp_exptmod (mp_int * G, mp_int * X, mp_int * P, mp_int * Y)
 }
 
 
+/* exptmod for secret exponents, the sliding window here is not timing
+ * independent, builds that need that should use fastmath */
+int mp_exptmod_ct (mp_int * G, mp_int * X, mp_int * P, mp_int * Y)
+{
+  return mp_exptmod(G, X, P, Y);
+}
+
+
+void mp_mont_ctx_init (mp_mont_ctx * mc)
+{
+  mc->ready = 0;
+}
+
+
+/* nothing to keep, mp_exptmod_fast sets itself up every call */
+int mp_mont_ctx_setup (mp_mont_ctx * mc, mp_int * m)
+{
+  (void)m;
+  mc->ready = 0;
+  return MP_OKAY;
+}
+
+
+int mp_exptmod_ex (mp_int * G, mp_int * X, mp_int * P,
+                   const mp_mont_ctx * mc, mp_int * Y)
+{
+  (void)mc;
+  return mp_exptmod(G, X, P, Y);
+}
+
+
+int mp_exptmod_ct_ex (mp_int * G, mp_int * X, mp_int * P,
+                      const mp_mont_ctx * mc, mp_int * Y)
+{
+  (void)mc;
+  return mp_exptmod_ct(G, X, P, Y);
+}
+
+
+void mp_comb_ctx_init (mp_comb_ctx * cc)
+{
+  cc->ready = 0;
+}
+
+
+/* no table here, mp_exptmod_comb is the plain exptmod */
+int mp_comb_ctx_setup (mp_comb_ctx * cc, mp_int * G, mp_int * P,
+                       const mp_mont_ctx * mc, int bits)
+{
+  (void)G;
+  (void)P;
+  (void)mc;
+  (void)bits;
+  cc->ready = 0;
+  return MP_OKAY;
+}
+
+
+int mp_exptmod_comb (mp_int * G, mp_int * X, mp_int * P,
+                     const mp_mont_ctx * mc, const mp_comb_ctx * cc,
+                     mp_int * Y)
+{
+  (void)cc;
+  return mp_exptmod_ex(G, X, P, mc, Y);
+}
+
+
 /* b = |a| 
  *
  * Simple function copies the input and fixes the sign to positive
@@ -2752,6 +2914,11 @@ int mp_init_size (mp_int * a, int size)
 
   /* pad size so there are always extra digits */
   size += (MP_PREC * 2) - (size % MP_PREC);	
+
+#ifdef CYASSL_MP_POOL
+  if (mp_pool_get(a, size) == MP_OKAY)
+    return MP_OKAY;
+#endif
   
   /* alloc mem */
   a->dp = OPT_CAST(mp_digit) XMALLOC (sizeof (mp_digit) * size, 0,
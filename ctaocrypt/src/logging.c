@@ -29,6 +29,9 @@
 
 #include <cyassl/ctaocrypt/logging.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
+#ifdef CYASSL_RING_LOG
+    #include <cyassl/ctaocrypt/types.h>
+#endif
 
 
 #ifdef __cplusplus
@@ -50,6 +53,119 @@ static int loggingEnabled = 0;
 #endif /* DEBUG_CYASSL */
 
 
+#if defined(CYASSL_RING_LOG) && defined(DEBUG_CYASSL)
+
+#if !defined(HAVE_THREAD_LS) && !defined(SINGLE_THREADED)
+    #error CYASSL_RING_LOG needs HAVE_THREAD_LS for its per thread rings
+#endif
+
+#ifndef CYASSL_LOG_RING_SZ
+    #define CYASSL_LOG_RING_SZ 1024     /* records per thread, power of 2 */
+#endif
+
+#ifndef CYASSL_LOG_RINGS
+    #define CYASSL_LOG_RINGS   64       /* threads that get a ring */
+#endif
+
+#ifdef WORD64_AVAILABLE
+    typedef word64 LogStamp;
+#else
+    typedef word32 LogStamp;
+#endif
+
+/* One binary log record, only formatted when dumped, so the text has to be
+   static as all of the library's messages are */
+typedef struct LogRecord {
+    LogStamp    stamp;                  /* cycle counter when logged */
+    const char* msg;                    /* message or function name */
+    int         value;                  /* return or error code */
+    int         level;                  /* CYA_Log_Levels */
+} LogRecord;
+
+/* A thread's latest records, only that thread writes, the oldest are
+   overwritten */
+typedef struct LogRing {
+    volatile word32 next;               /* records ever added */
+    LogRecord       records[CYASSL_LOG_RING_SZ];
+} LogRing;
+
+static THREAD_LS_T LogRing* threadRing = 0;
+static THREAD_LS_T int      threadRingFull = 0;   /* out of rings, skip */
+
+static LogRing*     logRings[CYASSL_LOG_RINGS];   /* kept after threads end */
+static int          logRingCount = 0;
+static CyaSSL_Mutex logRingMutex;                 /* for logRings and count */
+static int          logRingMutexInit = 0;
+
+
+/* Hardware time stamp, cycles or the virtual counter, 0 where neither */
+static INLINE LogStamp LogTime(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    word32 lo, hi;
+
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((LogStamp)hi << 32) | lo;
+#elif defined(__GNUC__) && defined(__aarch64__)
+    word64 cnt;
+
+    __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (cnt));
+    return cnt;
+#else
+    return 0;
+#endif
+}
+
+
+/* Get a ring for this thread, NULL if out of rings or memory */
+static LogRing* NewLogRing(void)
+{
+    LogRing* ring = NULL;
+
+    if (LockMutex(&logRingMutex) != 0)
+        return NULL;
+
+    if (logRingCount < CYASSL_LOG_RINGS) {
+        ring = (LogRing*)XMALLOC(sizeof(LogRing), NULL, DYNAMIC_TYPE_LOG_RING);
+        if (ring) {
+            XMEMSET(ring, 0, sizeof(LogRing));
+            logRings[logRingCount++] = ring;
+        }
+    }
+
+    UnLockMutex(&logRingMutex);
+
+    threadRing = ring;
+    if (ring == NULL)
+        threadRingFull = 1;
+
+    return ring;
+}
+
+
+/* Add a record to this thread's ring, no lock once it has one */
+static void RingLog(int level, const char* msg, int value)
+{
+    LogRing*   ring = threadRing;
+    LogRecord* rec;
+
+    if (ring == NULL) {
+        if (threadRingFull || (ring = NewLogRing()) == NULL)
+            return;
+    }
+
+    rec = &ring->records[ring->next & (CYASSL_LOG_RING_SZ - 1)];
+    rec->stamp = LogTime();
+    rec->msg   = msg;
+    rec->value = value;
+    rec->level = level;
+
+    ring->next++;
+}
+
+#endif /* CYASSL_RING_LOG && DEBUG_CYASSL */
+
+
 int CyaSSL_SetLoggingCb(CyaSSL_Logging_cb f)
 {
 #ifdef DEBUG_CYASSL
@@ -71,6 +187,13 @@ int CyaSSL_SetLoggingCb(CyaSSL_Logging_cb f)
 int CyaSSL_Debugging_ON(void)
 {
 #ifdef DEBUG_CYASSL
+#ifdef CYASSL_RING_LOG
+    if (!logRingMutexInit) {
+        if (InitMutex(&logRingMutex) != 0)
+            return BAD_MUTEX_E;
+        logRingMutexInit = 1;
+    }
+#endif
     loggingEnabled = 1;
     return 0;
 #else
@@ -99,6 +222,67 @@ void CyaSSL_Debugging_OFF(void)
     int dc_log_printf(char*, ...);
 #endif
 
+
+#ifdef CYASSL_RING_LOG
+
+/* Without a callback records go to the thread's ring, not out one by one */
+
+void CYASSL_MSG(const char* msg)
+{
+    if (loggingEnabled) {
+        if (log_function)
+            log_function(INFO_LOG, msg);
+        else
+            RingLog(INFO_LOG, msg, 0);
+    }
+}
+
+
+void CYASSL_ENTER(const char* msg)
+{
+    if (loggingEnabled) {
+        if (log_function) {
+            char buffer[80];
+            XSNPRINTF(buffer, sizeof(buffer), "CyaSSL Entering %s", msg);
+            log_function(ENTER_LOG, buffer);
+        }
+        else
+            RingLog(ENTER_LOG, msg, 0);
+    }
+}
+
+
+void CYASSL_LEAVE(const char* msg, int ret)
+{
+    if (loggingEnabled) {
+        if (log_function) {
+            char buffer[80];
+            XSNPRINTF(buffer, sizeof(buffer), "CyaSSL Leaving %s, return %d",
+                      msg, ret);
+            log_function(LEAVE_LOG, buffer);
+        }
+        else
+            RingLog(LEAVE_LOG, msg, ret);
+    }
+}
+
+
+void CYASSL_ERROR(int error)
+{
+    if (loggingEnabled) {
+        if (log_function) {
+            char buffer[80];
+            XSNPRINTF(buffer, sizeof(buffer),
+                      "CyaSSL error occured, error = %d", error);
+            log_function(ERROR_LOG, buffer);
+        }
+        else
+            RingLog(ERROR_LOG, NULL, error);
+    }
+}
+
+#else /* CYASSL_RING_LOG */
+
 static void cyassl_log(const int logLevel, const char *const logMessage)
 {
     if (log_function)
@@ -159,4 +343,75 @@ void CYASSL_ERROR(int error)
     }
 }
 
-#endif  /* DEBUG_CYASSL */ 
+#endif /* CYASSL_RING_LOG */
+
+#endif  /* DEBUG_CYASSL */
+
+
+/* Formats the records in every thread's ring, oldest first per thread, to f
+   or stderr when f is NULL. Threads keep logging, records they overwrite
+   while we read are skipped */
+int CyaSSL_Debugging_Dump(CyaSSL_Logging_cb f)
+{
+#if defined(CYASSL_RING_LOG) && defined(DEBUG_CYASSL)
+    int i;
+
+    if (!logRingMutexInit)
+        return 0;    /* never turned on, nothing logged */
+
+    if (LockMutex(&logRingMutex) != 0)
+        return BAD_MUTEX_E;
+
+    for (i = 0; i < logRingCount; i++) {
+        LogRing* ring = logRings[i];
+        word32   end  = ring->next;
+        word32   n    = end > CYASSL_LOG_RING_SZ ? end - CYASSL_LOG_RING_SZ : 0;
+
+        for (; n != end; n++) {
+            LogRecord rec = ring->records[n & (CYASSL_LOG_RING_SZ - 1)];
+            char      buffer[160];
+            int       len;
+
+            if (ring->next - n > CYASSL_LOG_RING_SZ)
+                continue;    /* overwritten while copying */
+
+            len = XSNPRINTF(buffer, sizeof(buffer), "[%d %lu] ", i,
+                            (unsigned long)rec.stamp);
+            if (len < 0 || len >= (int)sizeof(buffer))
+                len = 0;
+
+            switch (rec.level) {
+                case ENTER_LOG:
+                    XSNPRINTF(buffer + len, sizeof(buffer) - len,
+                              "CyaSSL Entering %s", rec.msg);
+                    break;
+                case LEAVE_LOG:
+                    XSNPRINTF(buffer + len, sizeof(buffer) - len,
+                              "CyaSSL Leaving %s, return %d", rec.msg,
+                              rec.value);
+                    break;
+                case ERROR_LOG:
+                    XSNPRINTF(buffer + len, sizeof(buffer) - len,
+                              "CyaSSL error occured, error = %d", rec.value);
+                    break;
+                default:
+                    XSNPRINTF(buffer + len, sizeof(buffer) - len, "%s",
+                              rec.msg ? rec.msg : "");
+                    break;
+            }
+
+            if (f)
+                f(rec.level, buffer);
+            else
+                fprintf(stderr, "%s\n", buffer);
+        }
+    }
+
+    UnLockMutex(&logRingMutex);
+
+    return 0;
+#else
+    (void)f;
+    return NOT_COMPILED_IN;
+#endif
+}
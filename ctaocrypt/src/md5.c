@@ -37,6 +37,20 @@
 #include <cyassl/ctaocrypt/md5.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 
+/* MD5 and SHA-1 over the same data block by block, the TLS 1.0 and 1.1
+   handshake hashes, where neither has hardware of its own */
+#if !defined(NO_SHA) && !defined(FREESCALE_MMCAU) && !defined(STM32F2_HASH) \
+    && !defined(CYASSL_PIC32MZ_HASH) && !defined(HAVE_FIPS)
+    #include <cyassl/ctaocrypt/cpuid.h>
+    #ifndef HAVE_CYASSL_ARMV8_CRYPTO
+        #define MD5_SHA_INTERLEAVE
+    #endif
+#endif
+
+#ifndef NO_SHA
+    #include <cyassl/ctaocrypt/sha.h>
+#endif
+
 #ifdef NO_INLINE
     #include <cyassl/ctaocrypt/misc.h>
 #else
@@ -281,6 +295,214 @@ static void Transform(Md5* md5)
     md5->digest[3] += d;
 }
 
+
+#ifdef MD5_SHA_INTERLEAVE
+
+/* the SHA-1 steps of sha.c, on sha->buffer in big endian words */
+#define SHA_BLK0(i) (W[i] = sha->buffer[i])
+#define SHA_BLK1(i) (W[(i)&15] = \
+              rotlFixed(W[((i)+13)&15]^W[((i)+8)&15]^W[((i)+2)&15]^W[(i)&15],1))
+
+#define SHA_F1(x,y,z) ((z)^((x) &((y)^(z))))
+#define SHA_F2(x,y,z) ((x)^(y)^(z))
+#define SHA_F3(x,y,z) (((x)&(y))|((z)&((x)|(y))))
+
+#define SHA_STEP(f, blk, k, v, w, x, y, z, i) \
+    (z) += f((w),(x),(y)) + blk((i)) + (k) + rotlFixed((v),5); \
+    (w) = rotlFixed((w),30)
+
+/* One block through MD5 and SHA-1 together. Each is a single dependency
+   chain that leaves most of the cpu idle, so four MD5 steps go in between
+   every five SHA-1 steps and the two chains fill each other's gaps */
+static void TransformMd5Sha(Md5* md5, Sha* sha)
+{
+    word32 W[SHA_BLOCK_SIZE / sizeof(word32)];
+
+    word32 ma = md5->digest[0];
+    word32 mb = md5->digest[1];
+    word32 mc = md5->digest[2];
+    word32 md = md5->digest[3];
+
+    word32 sa = sha->digest[0];
+    word32 sb = sha->digest[1];
+    word32 sc = sha->digest[2];
+    word32 sd = sha->digest[3];
+    word32 se = sha->digest[4];
+
+    MD5STEP(F1, ma, mb, mc, md, md5->buffer[0]  + 0xd76aa478,  7);
+    MD5STEP(F1, md, ma, mb, mc, md5->buffer[1]  + 0xe8c7b756, 12);
+    MD5STEP(F1, mc, md, ma, mb, md5->buffer[2]  + 0x242070db, 17);
+    MD5STEP(F1, mb, mc, md, ma, md5->buffer[3]  + 0xc1bdceee, 22);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sa, sb, sc, sd, se,  0);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, se, sa, sb, sc, sd,  1);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sd, se, sa, sb, sc,  2);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sc, sd, se, sa, sb,  3);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sb, sc, sd, se, sa,  4);
+
+    MD5STEP(F1, ma, mb, mc, md, md5->buffer[4]  + 0xf57c0faf,  7);
+    MD5STEP(F1, md, ma, mb, mc, md5->buffer[5]  + 0x4787c62a, 12);
+    MD5STEP(F1, mc, md, ma, mb, md5->buffer[6]  + 0xa8304613, 17);
+    MD5STEP(F1, mb, mc, md, ma, md5->buffer[7]  + 0xfd469501, 22);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sa, sb, sc, sd, se,  5);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, se, sa, sb, sc, sd,  6);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sd, se, sa, sb, sc,  7);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sc, sd, se, sa, sb,  8);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sb, sc, sd, se, sa,  9);
+
+    MD5STEP(F1, ma, mb, mc, md, md5->buffer[8]  + 0x698098d8,  7);
+    MD5STEP(F1, md, ma, mb, mc, md5->buffer[9]  + 0x8b44f7af, 12);
+    MD5STEP(F1, mc, md, ma, mb, md5->buffer[10] + 0xffff5bb1, 17);
+    MD5STEP(F1, mb, mc, md, ma, md5->buffer[11] + 0x895cd7be, 22);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sa, sb, sc, sd, se, 10);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, se, sa, sb, sc, sd, 11);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sd, se, sa, sb, sc, 12);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sc, sd, se, sa, sb, 13);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sb, sc, sd, se, sa, 14);
+
+    MD5STEP(F1, ma, mb, mc, md, md5->buffer[12] + 0x6b901122,  7);
+    MD5STEP(F1, md, ma, mb, mc, md5->buffer[13] + 0xfd987193, 12);
+    MD5STEP(F1, mc, md, ma, mb, md5->buffer[14] + 0xa679438e, 17);
+    MD5STEP(F1, mb, mc, md, ma, md5->buffer[15] + 0x49b40821, 22);
+    SHA_STEP(SHA_F1, SHA_BLK0, 0x5A827999, sa, sb, sc, sd, se, 15);
+    SHA_STEP(SHA_F1, SHA_BLK1, 0x5A827999, se, sa, sb, sc, sd, 16);
+    SHA_STEP(SHA_F1, SHA_BLK1, 0x5A827999, sd, se, sa, sb, sc, 17);
+    SHA_STEP(SHA_F1, SHA_BLK1, 0x5A827999, sc, sd, se, sa, sb, 18);
+    SHA_STEP(SHA_F1, SHA_BLK1, 0x5A827999, sb, sc, sd, se, sa, 19);
+
+    MD5STEP(F2, ma, mb, mc, md, md5->buffer[1]  + 0xf61e2562,  5);
+    MD5STEP(F2, md, ma, mb, mc, md5->buffer[6]  + 0xc040b340,  9);
+    MD5STEP(F2, mc, md, ma, mb, md5->buffer[11] + 0x265e5a51, 14);
+    MD5STEP(F2, mb, mc, md, ma, md5->buffer[0]  + 0xe9b6c7aa, 20);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sa, sb, sc, sd, se, 20);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, se, sa, sb, sc, sd, 21);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sd, se, sa, sb, sc, 22);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sc, sd, se, sa, sb, 23);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sb, sc, sd, se, sa, 24);
+
+    MD5STEP(F2, ma, mb, mc, md, md5->buffer[5]  + 0xd62f105d,  5);
+    MD5STEP(F2, md, ma, mb, mc, md5->buffer[10] + 0x02441453,  9);
+    MD5STEP(F2, mc, md, ma, mb, md5->buffer[15] + 0xd8a1e681, 14);
+    MD5STEP(F2, mb, mc, md, ma, md5->buffer[4]  + 0xe7d3fbc8, 20);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sa, sb, sc, sd, se, 25);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, se, sa, sb, sc, sd, 26);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sd, se, sa, sb, sc, 27);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sc, sd, se, sa, sb, 28);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sb, sc, sd, se, sa, 29);
+
+    MD5STEP(F2, ma, mb, mc, md, md5->buffer[9]  + 0x21e1cde6,  5);
+    MD5STEP(F2, md, ma, mb, mc, md5->buffer[14] + 0xc33707d6,  9);
+    MD5STEP(F2, mc, md, ma, mb, md5->buffer[3]  + 0xf4d50d87, 14);
+    MD5STEP(F2, mb, mc, md, ma, md5->buffer[8]  + 0x455a14ed, 20);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sa, sb, sc, sd, se, 30);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, se, sa, sb, sc, sd, 31);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sd, se, sa, sb, sc, 32);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sc, sd, se, sa, sb, 33);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sb, sc, sd, se, sa, 34);
+
+    MD5STEP(F2, ma, mb, mc, md, md5->buffer[13] + 0xa9e3e905,  5);
+    MD5STEP(F2, md, ma, mb, mc, md5->buffer[2]  + 0xfcefa3f8,  9);
+    MD5STEP(F2, mc, md, ma, mb, md5->buffer[7]  + 0x676f02d9, 14);
+    MD5STEP(F2, mb, mc, md, ma, md5->buffer[12] + 0x8d2a4c8a, 20);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sa, sb, sc, sd, se, 35);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, se, sa, sb, sc, sd, 36);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sd, se, sa, sb, sc, 37);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sc, sd, se, sa, sb, 38);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0x6ED9EBA1, sb, sc, sd, se, sa, 39);
+
+    MD5STEP(F3, ma, mb, mc, md, md5->buffer[5]  + 0xfffa3942,  4);
+    MD5STEP(F3, md, ma, mb, mc, md5->buffer[8]  + 0x8771f681, 11);
+    MD5STEP(F3, mc, md, ma, mb, md5->buffer[11] + 0x6d9d6122, 16);
+    MD5STEP(F3, mb, mc, md, ma, md5->buffer[14] + 0xfde5380c, 23);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sa, sb, sc, sd, se, 40);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, se, sa, sb, sc, sd, 41);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sd, se, sa, sb, sc, 42);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sc, sd, se, sa, sb, 43);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sb, sc, sd, se, sa, 44);
+
+    MD5STEP(F3, ma, mb, mc, md, md5->buffer[1]  + 0xa4beea44,  4);
+    MD5STEP(F3, md, ma, mb, mc, md5->buffer[4]  + 0x4bdecfa9, 11);
+    MD5STEP(F3, mc, md, ma, mb, md5->buffer[7]  + 0xf6bb4b60, 16);
+    MD5STEP(F3, mb, mc, md, ma, md5->buffer[10] + 0xbebfbc70, 23);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sa, sb, sc, sd, se, 45);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, se, sa, sb, sc, sd, 46);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sd, se, sa, sb, sc, 47);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sc, sd, se, sa, sb, 48);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sb, sc, sd, se, sa, 49);
+
+    MD5STEP(F3, ma, mb, mc, md, md5->buffer[13] + 0x289b7ec6,  4);
+    MD5STEP(F3, md, ma, mb, mc, md5->buffer[0]  + 0xeaa127fa, 11);
+    MD5STEP(F3, mc, md, ma, mb, md5->buffer[3]  + 0xd4ef3085, 16);
+    MD5STEP(F3, mb, mc, md, ma, md5->buffer[6]  + 0x04881d05, 23);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sa, sb, sc, sd, se, 50);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, se, sa, sb, sc, sd, 51);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sd, se, sa, sb, sc, 52);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sc, sd, se, sa, sb, 53);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sb, sc, sd, se, sa, 54);
+
+    MD5STEP(F3, ma, mb, mc, md, md5->buffer[9]  + 0xd9d4d039,  4);
+    MD5STEP(F3, md, ma, mb, mc, md5->buffer[12] + 0xe6db99e5, 11);
+    MD5STEP(F3, mc, md, ma, mb, md5->buffer[15] + 0x1fa27cf8, 16);
+    MD5STEP(F3, mb, mc, md, ma, md5->buffer[2]  + 0xc4ac5665, 23);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sa, sb, sc, sd, se, 55);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, se, sa, sb, sc, sd, 56);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sd, se, sa, sb, sc, 57);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sc, sd, se, sa, sb, 58);
+    SHA_STEP(SHA_F3, SHA_BLK1, 0x8F1BBCDC, sb, sc, sd, se, sa, 59);
+
+    MD5STEP(F4, ma, mb, mc, md, md5->buffer[0]  + 0xf4292244,  6);
+    MD5STEP(F4, md, ma, mb, mc, md5->buffer[7]  + 0x432aff97, 10);
+    MD5STEP(F4, mc, md, ma, mb, md5->buffer[14] + 0xab9423a7, 15);
+    MD5STEP(F4, mb, mc, md, ma, md5->buffer[5]  + 0xfc93a039, 21);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sa, sb, sc, sd, se, 60);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, se, sa, sb, sc, sd, 61);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sd, se, sa, sb, sc, 62);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sc, sd, se, sa, sb, 63);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sb, sc, sd, se, sa, 64);
+
+    MD5STEP(F4, ma, mb, mc, md, md5->buffer[12] + 0x655b59c3,  6);
+    MD5STEP(F4, md, ma, mb, mc, md5->buffer[3]  + 0x8f0ccc92, 10);
+    MD5STEP(F4, mc, md, ma, mb, md5->buffer[10] + 0xffeff47d, 15);
+    MD5STEP(F4, mb, mc, md, ma, md5->buffer[1]  + 0x85845dd1, 21);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sa, sb, sc, sd, se, 65);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, se, sa, sb, sc, sd, 66);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sd, se, sa, sb, sc, 67);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sc, sd, se, sa, sb, 68);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sb, sc, sd, se, sa, 69);
+
+    MD5STEP(F4, ma, mb, mc, md, md5->buffer[8]  + 0x6fa87e4f,  6);
+    MD5STEP(F4, md, ma, mb, mc, md5->buffer[15] + 0xfe2ce6e0, 10);
+    MD5STEP(F4, mc, md, ma, mb, md5->buffer[6]  + 0xa3014314, 15);
+    MD5STEP(F4, mb, mc, md, ma, md5->buffer[13] + 0x4e0811a1, 21);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sa, sb, sc, sd, se, 70);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, se, sa, sb, sc, sd, 71);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sd, se, sa, sb, sc, 72);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sc, sd, se, sa, sb, 73);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sb, sc, sd, se, sa, 74);
+
+    MD5STEP(F4, ma, mb, mc, md, md5->buffer[4]  + 0xf7537e82,  6);
+    MD5STEP(F4, md, ma, mb, mc, md5->buffer[11] + 0xbd3af235, 10);
+    MD5STEP(F4, mc, md, ma, mb, md5->buffer[2]  + 0x2ad7d2bb, 15);
+    MD5STEP(F4, mb, mc, md, ma, md5->buffer[9]  + 0xeb86d391, 21);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sa, sb, sc, sd, se, 75);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, se, sa, sb, sc, sd, 76);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sd, se, sa, sb, sc, 77);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sc, sd, se, sa, sb, 78);
+    SHA_STEP(SHA_F2, SHA_BLK1, 0xCA62C1D6, sb, sc, sd, se, sa, 79);
+
+    md5->digest[0] += ma;
+    md5->digest[1] += mb;
+    md5->digest[2] += mc;
+    md5->digest[3] += md;
+
+    sha->digest[0] += sa;
+    sha->digest[1] += sb;
+    sha->digest[2] += sc;
+    sha->digest[3] += sd;
+    sha->digest[4] += se;
+}
+
+#endif /* MD5_SHA_INTERLEAVE */
+
 #endif /* FREESCALE_MMCAU */
 
 
@@ -363,6 +585,60 @@ void Md5Final(Md5* md5, byte* hash)
 #endif /* STM32F2_HASH */
 
 
+#ifndef NO_SHA
+
+#ifdef MD5_SHA_INTERLEAVE
+
+static INLINE void AddLengthSha(Sha* sha, word32 len)
+{
+    word32 tmp = sha->loLen;
+    if ( (sha->loLen += len) < tmp)
+        sha->hiLen++;                       /* carry low to high */
+}
+
+#endif /* MD5_SHA_INTERLEAVE */
+
+
+/* the same data into md5 and sha, the whole blocks in one pass when both
+   sit at a block boundary */
+int Md5ShaUpdate(Md5* md5, Sha* sha, const byte* data, word32 len)
+{
+#ifdef MD5_SHA_INTERLEAVE
+    if (md5->buffLen == sha->buffLen) {
+        /* top both up to the boundary */
+        if (md5->buffLen != 0) {
+            word32 add = min(len, MD5_BLOCK_SIZE - md5->buffLen);
+
+            Md5Update(md5, data, add);
+            ShaUpdate(sha, data, add);
+            data += add;
+            len  -= add;
+        }
+
+        while (md5->buffLen == 0 && len >= MD5_BLOCK_SIZE) {
+            XMEMCPY(md5->buffer, data, MD5_BLOCK_SIZE);
+            #ifdef BIG_ENDIAN_ORDER
+                XMEMCPY(sha->buffer, data, SHA_BLOCK_SIZE);
+                ByteReverseWords(md5->buffer, md5->buffer, MD5_BLOCK_SIZE);
+            #else
+                ByteReverseWords(sha->buffer, md5->buffer, SHA_BLOCK_SIZE);
+            #endif
+            TransformMd5Sha(md5, sha);
+            AddLength(md5, MD5_BLOCK_SIZE);
+            AddLengthSha(sha, SHA_BLOCK_SIZE);
+            data += MD5_BLOCK_SIZE;
+            len  -= MD5_BLOCK_SIZE;
+        }
+    }
+#endif
+
+    Md5Update(md5, data, len);
+    return ShaUpdate(sha, data, len);
+}
+
+#endif /* NO_SHA */
+
+
 int Md5Hash(const byte* data, word32 len, byte* hash)
 {
 #ifdef CYASSL_SMALL_STACK
@@ -30,7 +30,31 @@
 #include <cyassl/ctaocrypt/memory.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 
-#ifdef CYASSL_MALLOC_CHECK
+#if defined(CYASSL_MALLOC_CHECK) || defined(CYASSL_MEM_TRACE)
+    #include <stdio.h>
+#endif
+
+#if defined(CYASSL_SLAB_MALLOC) || defined(CYASSL_MEM_STATS) \
+             || defined(CYASSL_MEM_TRACE) || defined(CYASSL_STATIC_MEMORY)
+    #include <string.h>
+#endif
+
+#if defined(CYASSL_SLAB_MALLOC) || defined(CYASSL_MEM_TRACE) \
+                                || defined(CYASSL_STATIC_MEMORY)
+    #include <cyassl/ctaocrypt/wc_port.h>
+#endif
+
+#if defined(CYASSL_SLAB_MALLOC) || defined(CYASSL_MEM_TRACE)
+    #if !defined(SINGLE_THREADED) && !defined(CYASSL_PTHREADS)
+        #error "slab allocator and tracing need pthreads or SINGLE_THREADED"
+    #endif
+#endif
+
+#if defined(CYASSL_STATIC_MEMORY) && defined(CYASSL_SLAB_MALLOC)
+    #error "static memory pools and the slab allocator don't mix"
+#endif
+
+#ifdef CYASSL_STATIC_MEMORY
     #include <stdio.h>
 #endif
 
@@ -71,7 +95,13 @@ void* CyaSSL_Malloc(size_t size)
     if (malloc_function)
         res = malloc_function(size);
     else
+    #ifdef CYASSL_SLAB_MALLOC
+        res = CyaSSL_SlabMalloc(size);
+    #elif defined(CYASSL_STATIC_MEMORY)
+        res = CyaSSL_StaticMalloc(size);
+    #else
         res = malloc(size);
+    #endif
 
     #ifdef CYASSL_MALLOC_CHECK
         if (res == NULL)
@@ -86,7 +116,13 @@ void CyaSSL_Free(void *ptr)
     if (free_function)
         free_function(ptr);
     else
+    #ifdef CYASSL_SLAB_MALLOC
+        CyaSSL_SlabFree(ptr);
+    #elif defined(CYASSL_STATIC_MEMORY)
+        CyaSSL_StaticFree(ptr);
+    #else
         free(ptr);
+    #endif
 }
 
 void* CyaSSL_Realloc(void *ptr, size_t size)
@@ -96,11 +132,1116 @@ void* CyaSSL_Realloc(void *ptr, size_t size)
     if (realloc_function)
         res = realloc_function(ptr, size);
     else
+    #ifdef CYASSL_SLAB_MALLOC
+        res = CyaSSL_SlabRealloc(ptr, size);
+    #elif defined(CYASSL_STATIC_MEMORY)
+        res = CyaSSL_StaticRealloc(ptr, size);
+    #else
         res = realloc(ptr, size);
+    #endif
+
+    return res;
+}
+
+
+#ifdef CYASSL_SLAB_MALLOC
+
+/* Size classed allocator with per thread caches. Each block carries a small
+ * header naming its class so free needs no size. A thread keeps a short
+ * stack of free blocks per class; when it runs dry or overflows, half a
+ * stack moves from or to a shared depot under one lock, so threads that
+ * free what others allocate still recycle. Anything bigger than the top
+ * class goes straight to the system heap. */
+
+#ifndef SLAB_CACHE_DEPTH
+    #define SLAB_CACHE_DEPTH 32       /* most blocks per class per thread */
+#endif
+#ifndef SLAB_CACHE_BYTES
+    #define SLAB_CACHE_BYTES 65536    /* and bytes per class per thread */
+#endif
+#ifndef SLAB_DEPOT_DEPTH
+    #define SLAB_DEPOT_DEPTH 256      /* most blocks per class in the depot */
+#endif
+
+#define SLAB_HEADER_SZ 16             /* keeps payload 16 byte aligned */
+#define SLAB_HEAP      0xFF           /* class tag for oversized blocks */
+
+/* block sizes, header included; the odd ones are where this library's own
+ * objects land so they don't round up a whole step */
+static const size_t slabSz[] = {
+       32,    48,    64,    96,   128,   160,   192,   256,   384,   512,
+      640,   /* fp_int */
+      768,  1024,
+     1344,   /* CYASSL, DecodedCert with extras */
+     1536,  2048,
+     2432,   /* ecc_key on fastmath */
+     3072,  4096,
+     6528,   /* RsaKey on fastmath */
+     8192, 12288, 16384, 24576
+};
+
+#define SLAB_CLASSES ((int)(sizeof(slabSz) / sizeof(slabSz[0])))
+
+typedef struct SlabBlock {
+    struct SlabBlock* next;
+} SlabBlock;
+
+typedef struct SlabCache {
+    SlabBlock*        top[SLAB_CLASSES];
+    int               count[SLAB_CLASSES];
+    unsigned long     allocs[SLAB_CLASSES + 1];
+    unsigned long     hits[SLAB_CLASSES + 1];
+    unsigned long     frees[SLAB_CLASSES + 1];
+    struct SlabCache* prev;
+    struct SlabCache* next;
+} SlabCache;
+
+
+static SlabBlock*    slabDepot[SLAB_CLASSES];
+static int           slabDepotCount[SLAB_CLASSES];
+static SlabCache*    slabCaches = NULL;      /* every live thread cache */
+static SlabCache     slabRetired;            /* counters of exited threads */
+
+#ifdef SINGLE_THREADED
+    static SlabCache slabOnly;
+    #define SLAB_LOCK()
+    #define SLAB_UNLOCK()
+#else
+    static pthread_mutex_t slabMutex = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_once_t  slabOnce  = PTHREAD_ONCE_INIT;
+    static pthread_key_t   slabKey;
+    #define SLAB_LOCK()   pthread_mutex_lock(&slabMutex)
+    #define SLAB_UNLOCK() pthread_mutex_unlock(&slabMutex)
+#endif
+
+
+static int SlabClass(size_t size)
+{
+    int lo = 0;
+    int hi = SLAB_CLASSES;
+
+    size += SLAB_HEADER_SZ;
+    if (size > slabSz[SLAB_CLASSES - 1])
+        return SLAB_HEAP;
+
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (slabSz[mid] < size)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static int SlabLimit(int c)
+{
+    int limit = (int)(SLAB_CACHE_BYTES / slabSz[c]);
+
+    if (limit > SLAB_CACHE_DEPTH)
+        limit = SLAB_CACHE_DEPTH;
+    if (limit < 2)
+        limit = 2;
+
+    return limit;
+}
+
+
+/* move the whole cache into the depot, freeing what doesn't fit,
+   caller holds the lock */
+static void SlabDrain(SlabCache* cache)
+{
+    int c;
+
+    for (c = 0; c < SLAB_CLASSES; c++) {
+        while (cache->top[c]) {
+            SlabBlock* b = cache->top[c];
+
+            cache->top[c] = b->next;
+            if (slabDepotCount[c] < SLAB_DEPOT_DEPTH) {
+                b->next = slabDepot[c];
+                slabDepot[c] = b;
+                slabDepotCount[c]++;
+            }
+            else
+                free((byte*)b - SLAB_HEADER_SZ);
+        }
+        cache->count[c] = 0;
+    }
+}
+
+
+#ifndef SINGLE_THREADED
+
+/* thread exit, hand blocks and counters back */
+static void SlabThreadDone(void* arg)
+{
+    SlabCache* cache = (SlabCache*)arg;
+    int        c;
+
+    SLAB_LOCK();
+    SlabDrain(cache);
+    for (c = 0; c <= SLAB_CLASSES; c++) {
+        slabRetired.allocs[c] += cache->allocs[c];
+        slabRetired.hits[c]   += cache->hits[c];
+        slabRetired.frees[c]  += cache->frees[c];
+    }
+    if (cache->prev)
+        cache->prev->next = cache->next;
+    else
+        slabCaches = cache->next;
+    if (cache->next)
+        cache->next->prev = cache->prev;
+    SLAB_UNLOCK();
+
+    free(cache);
+}
+
+
+static void SlabKeyInit(void)
+{
+    pthread_key_create(&slabKey, SlabThreadDone);
+}
+
+#endif /* SINGLE_THREADED */
+
+
+/* this thread's cache, NULL if it can't have one */
+static SlabCache* SlabGetCache(void)
+{
+#ifdef SINGLE_THREADED
+    if (slabCaches == NULL)
+        slabCaches = &slabOnly;
+    return &slabOnly;
+#else
+    SlabCache* cache;
+
+    pthread_once(&slabOnce, SlabKeyInit);
+    cache = (SlabCache*)pthread_getspecific(slabKey);
+    if (cache)
+        return cache;
+
+    cache = (SlabCache*)malloc(sizeof(SlabCache));
+    if (cache == NULL)
+        return NULL;
+    memset(cache, 0, sizeof(SlabCache));
+    if (pthread_setspecific(slabKey, cache) != 0) {
+        free(cache);
+        return NULL;
+    }
+
+    SLAB_LOCK();
+    cache->next = slabCaches;
+    if (slabCaches)
+        slabCaches->prev = cache;
+    slabCaches = cache;
+    SLAB_UNLOCK();
+
+    return cache;
+#endif
+}
+
+
+void* CyaSSL_SlabMalloc(size_t size)
+{
+    SlabCache* cache = SlabGetCache();
+    SlabBlock* b;
+    byte*      mem;
+    int        c = SlabClass(size);
+    int        stat = (c == SLAB_HEAP) ? SLAB_CLASSES : c;
+
+    if (cache)
+        cache->allocs[stat]++;
+
+    if (c != SLAB_HEAP && cache) {
+        if (cache->top[c] == NULL && slabDepotCount[c] > 0) {
+            int want = SlabLimit(c) / 2;
+
+            SLAB_LOCK();
+            while (want-- > 0 && slabDepot[c]) {
+                b = slabDepot[c];
+                slabDepot[c] = b->next;
+                slabDepotCount[c]--;
+                b->next = cache->top[c];
+                cache->top[c] = b;
+                cache->count[c]++;
+            }
+            SLAB_UNLOCK();
+        }
+        if (cache->top[c]) {
+            b = cache->top[c];
+            cache->top[c] = b->next;
+            cache->count[c]--;
+            cache->hits[c]++;
+            return b;
+        }
+    }
+
+    mem = (byte*)malloc(c == SLAB_HEAP ? size + SLAB_HEADER_SZ : slabSz[c]);
+    if (mem == NULL)
+        return NULL;
+    mem[0] = (byte)c;
+
+    return mem + SLAB_HEADER_SZ;
+}
+
+
+void CyaSSL_SlabFree(void* ptr)
+{
+    SlabCache* cache;
+    SlabBlock* b = (SlabBlock*)ptr;
+    byte*      mem;
+    int        c;
+
+    if (ptr == NULL)
+        return;
+
+    mem   = (byte*)ptr - SLAB_HEADER_SZ;
+    c     = mem[0];
+    cache = SlabGetCache();
+
+    if (c == SLAB_HEAP || cache == NULL) {
+        if (cache)
+            cache->frees[SLAB_CLASSES]++;
+        free(mem);
+        return;
+    }
+    cache->frees[c]++;
+
+    if (cache->count[c] >= SlabLimit(c)) {
+        int give = SlabLimit(c) / 2;
+
+        SLAB_LOCK();
+        while (give-- > 0) {
+            SlabBlock* out = cache->top[c];
+
+            cache->top[c] = out->next;
+            cache->count[c]--;
+            if (slabDepotCount[c] < SLAB_DEPOT_DEPTH) {
+                out->next = slabDepot[c];
+                slabDepot[c] = out;
+                slabDepotCount[c]++;
+            }
+            else
+                free((byte*)out - SLAB_HEADER_SZ);
+        }
+        SLAB_UNLOCK();
+    }
+
+    b->next = cache->top[c];
+    cache->top[c] = b;
+    cache->count[c]++;
+}
+
+
+void* CyaSSL_SlabRealloc(void* ptr, size_t size)
+{
+    void*  res;
+    size_t have;
+    int    c;
+
+    if (ptr == NULL)
+        return CyaSSL_SlabMalloc(size);
+    if (size == 0) {
+        CyaSSL_SlabFree(ptr);
+        return NULL;
+    }
+
+    c = ((byte*)ptr - SLAB_HEADER_SZ)[0];
+    if (c != SLAB_HEAP) {
+        have = slabSz[c] - SLAB_HEADER_SZ;
+        if (size <= have)
+            return ptr;
+    }
+    else {
+        res = realloc((byte*)ptr - SLAB_HEADER_SZ, size + SLAB_HEADER_SZ);
+        return res ? (byte*)res + SLAB_HEADER_SZ : NULL;
+    }
+
+    res = CyaSSL_SlabMalloc(size);
+    if (res) {
+        memcpy(res, ptr, have);
+        CyaSSL_SlabFree(ptr);
+    }
+
+    return res;
+}
+
+
+/* fill up to max entries, one per class and a last one (size 0) for
+   oversized requests, returns the number of entries available */
+int CyaSSL_SlabGetStats(CyaSSL_SlabStat* stats, int max)
+{
+    SlabCache* cache;
+    int        c;
+
+    if (stats == NULL || max <= 0)
+        return SLAB_CLASSES + 1;
+
+    if (max > SLAB_CLASSES + 1)
+        max = SLAB_CLASSES + 1;
+    memset(stats, 0, max * sizeof(CyaSSL_SlabStat));
+
+    SLAB_LOCK();
+    for (c = 0; c < max; c++) {
+        stats[c].size   = (c < SLAB_CLASSES) ? slabSz[c] : 0;
+        stats[c].allocs = slabRetired.allocs[c];
+        stats[c].hits   = slabRetired.hits[c];
+        stats[c].frees  = slabRetired.frees[c];
+        if (c < SLAB_CLASSES)
+            stats[c].cached = slabDepotCount[c];
+        for (cache = slabCaches; cache; cache = cache->next) {
+            stats[c].allocs += cache->allocs[c];
+            stats[c].hits   += cache->hits[c];
+            stats[c].frees  += cache->frees[c];
+            if (c < SLAB_CLASSES)
+                stats[c].cached += cache->count[c];
+        }
+    }
+    SLAB_UNLOCK();
+
+    return SLAB_CLASSES + 1;
+}
+
+
+/* give the depot and this thread's cache back to the system heap */
+void CyaSSL_SlabFlush(void)
+{
+    SlabCache* cache = SlabGetCache();
+    int        c;
+
+    SLAB_LOCK();
+    if (cache)
+        SlabDrain(cache);
+    for (c = 0; c < SLAB_CLASSES; c++) {
+        while (slabDepot[c]) {
+            SlabBlock* b = slabDepot[c];
+
+            slabDepot[c] = b->next;
+            free((byte*)b - SLAB_HEADER_SZ);
+        }
+        slabDepotCount[c] = 0;
+    }
+    SLAB_UNLOCK();
+}
+
+#endif /* CYASSL_SLAB_MALLOC */
+
+
+#ifdef CYASSL_STATIC_MEMORY
+
+/* Fixed pools for ports that can't have a heap growing and fragmenting
+ * under them for weeks. Each bucket is a run of equal blocks carved from
+ * one static arena, with a free list so malloc and free are a pop and a
+ * push under one lock. A request takes the smallest bucket it fits, or
+ * the next bigger one that has a block left, never the system heap. Free
+ * finds the bucket from the address, so blocks carry no header. The
+ * counters tell which buckets ran dry and how big requests got, to size
+ * the table for a device. */
+
+#ifndef STATIC_MEM_CONNECTIONS
+    #define STATIC_MEM_CONNECTIONS 2      /* SSL objects alive at once */
+#endif
+
+#define STATIC_MEM_ALIGN_SZ 16            /* block sizes are multiples */
+
+/* normal math grows its digits a few words at a time, fastmath keeps them
+   in place */
+#ifdef USE_FAST_MATH
+    #define STATIC_MEM_SMALL 8
+#else
+    #define STATIC_MEM_SMALL 48
+#endif
+
+/* a cached P-256 verify table */
+#ifdef HAVE_ECC
+    #define STATIC_MEM_ECC(X)  X(57344, 1, 1)
+#else
+    #define STATIC_MEM_ECC(X)
+#endif
+
+/* X(block size, blocks for CTXs and the rest, blocks per connection) in
+ * increasing size. The defaults hold a CTX and its certs per side plus
+ * STATIC_MEM_CONNECTIONS handshakes at once, with both full size record
+ * buffers, for the algorithms built in. Redefine them for a device after
+ * reading CyaSSL_StaticMemoryDump() */
+#ifndef STATIC_MEM_BUCKETS
+    #define STATIC_MEM_BUCKETS(X) \
+        X(   64,  8, STATIC_MEM_SMALL)  \
+        X(  128,  4, STATIC_MEM_SMALL)  \
+        X(  256,  4, STATIC_MEM_SMALL)  \
+        X(  512,  4, STATIC_MEM_SMALL)  \
+        X( 1024,  4, 4)                 \
+        X( 2048,  4, 4)                 \
+        X( 4096,  4, 6)                 \
+        X( 8192,  2, 3)                 \
+        X(18432,  0, 2)                 \
+        STATIC_MEM_ECC(X)
+#endif
+
+#define STATIC_MEM_SIZE(sz, base, per)   sz,
+#define STATIC_MEM_COUNT(sz, base, per)  (base) + (per) * STATIC_MEM_CONNECTIONS,
+#define STATIC_MEM_BYTES(sz, base, per) \
+                                 + (sz) * ((base) + (per) * STATIC_MEM_CONNECTIONS)
+
+static const word32 staticSz[]    = { STATIC_MEM_BUCKETS(STATIC_MEM_SIZE) };
+static const word32 staticCount[] = { STATIC_MEM_BUCKETS(STATIC_MEM_COUNT) };
+
+#define STATIC_MEM_CLASSES ((int)(sizeof(staticSz) / sizeof(staticSz[0])))
+#define STATIC_MEM_ARENA_SZ (0 STATIC_MEM_BUCKETS(STATIC_MEM_BYTES))
+
+#if defined(__GNUC__)
+    static byte staticArena[STATIC_MEM_ARENA_SZ]
+                                __attribute__((aligned(STATIC_MEM_ALIGN_SZ)));
+#else
+    static byte staticArena[STATIC_MEM_ARENA_SZ];
+#endif
+
+typedef struct StaticBlock {
+    struct StaticBlock* next;
+} StaticBlock;
+
+static StaticBlock*         staticFree[STATIC_MEM_CLASSES];
+static byte*                staticStart[STATIC_MEM_CLASSES + 1];
+static CyaSSL_StaticMemStat staticStat[STATIC_MEM_CLASSES + 1];
+static CyaSSL_Mutex         staticMutex;
+static int                  staticReady = 0;
+
+
+/* sets up the mutex and carves the arena into the free lists, done by
+   CyaSSL_Init, or by the first allocation before any other thread runs */
+int CyaSSL_StaticMemoryInit(void)
+{
+    byte* mem = staticArena;
+    int   c;
+    word32 i;
+
+    if (staticReady)
+        return 0;
+
+    for (c = 0; c < STATIC_MEM_CLASSES; c++) {
+        if (staticSz[c] % STATIC_MEM_ALIGN_SZ ||
+                              (c > 0 && staticSz[c] <= staticSz[c - 1]))
+            return BAD_FUNC_ARG;
+    }
+    if (InitMutex(&staticMutex) != 0)
+        return BAD_MUTEX_E;
+
+    for (c = 0; c < STATIC_MEM_CLASSES; c++) {
+        staticStart[c] = mem;
+        staticFree[c]  = NULL;
+        /* free lists hand out the lowest blocks first */
+        for (i = staticCount[c]; i > 0; i--) {
+            StaticBlock* b = (StaticBlock*)(mem + (i - 1) * staticSz[c]);
+
+            b->next = staticFree[c];
+            staticFree[c] = b;
+        }
+        mem += staticCount[c] * staticSz[c];
+
+        memset(&staticStat[c], 0, sizeof(CyaSSL_StaticMemStat));
+        staticStat[c].size  = staticSz[c];
+        staticStat[c].total = staticCount[c];
+    }
+    staticStart[STATIC_MEM_CLASSES] = mem;
+    memset(&staticStat[STATIC_MEM_CLASSES], 0, sizeof(CyaSSL_StaticMemStat));
+
+    staticReady = 1;
+
+    return 0;
+}
+
+
+/* smallest bucket size fits in, STATIC_MEM_CLASSES when none */
+static int StaticClass(size_t size)
+{
+    int c;
+
+    for (c = 0; c < STATIC_MEM_CLASSES; c++)
+        if (size <= staticSz[c])
+            break;
+
+    return c;
+}
+
+
+/* bucket holding ptr, STATIC_MEM_CLASSES when not from the arena */
+static int StaticOwner(const byte* ptr)
+{
+    int c;
+
+    if (ptr < staticStart[0] || ptr >= staticStart[STATIC_MEM_CLASSES])
+        return STATIC_MEM_CLASSES;
+
+    for (c = 1; c < STATIC_MEM_CLASSES; c++)
+        if (ptr < staticStart[c])
+            break;
+
+    return c - 1;
+}
+
+
+void* CyaSSL_StaticMalloc(size_t size)
+{
+    StaticBlock* b = NULL;
+    int          want;
+    int          c;
+
+    if (!staticReady && CyaSSL_StaticMemoryInit() != 0)
+        return NULL;
+
+    want = StaticClass(size);
+
+    LockMutex(&staticMutex);
+    staticStat[want].allocs++;
+    if (size > staticStat[want].largest)
+        staticStat[want].largest = (unsigned long)size;
+
+    for (c = want; c < STATIC_MEM_CLASSES; c++) {
+        if (staticFree[c]) {
+            b = staticFree[c];
+            staticFree[c] = b->next;
+            if (++staticStat[c].inUse > staticStat[c].peak)
+                staticStat[c].peak = staticStat[c].inUse;
+            if (c != want)
+                staticStat[want].spills++;
+            break;
+        }
+    }
+    if (b == NULL)
+        staticStat[want].fails++;
+    UnLockMutex(&staticMutex);
+
+    return b;
+}
+
+
+void CyaSSL_StaticFree(void* ptr)
+{
+    StaticBlock* b = (StaticBlock*)ptr;
+    int          c;
+
+    if (ptr == NULL)
+        return;
+
+    c = StaticOwner((byte*)ptr);
+    if (c == STATIC_MEM_CLASSES)
+        return;                       /* not ours, nothing to give back */
+
+    LockMutex(&staticMutex);
+    b->next = staticFree[c];
+    staticFree[c] = b;
+    staticStat[c].inUse--;
+    UnLockMutex(&staticMutex);
+}
+
+
+void* CyaSSL_StaticRealloc(void* ptr, size_t size)
+{
+    void*  res;
+    int    c;
+
+    if (ptr == NULL)
+        return CyaSSL_StaticMalloc(size);
+    if (size == 0) {
+        CyaSSL_StaticFree(ptr);
+        return NULL;
+    }
+
+    c = StaticOwner((byte*)ptr);
+    if (c == STATIC_MEM_CLASSES)
+        return NULL;
+    if (size <= staticSz[c])
+        return ptr;
+
+    res = CyaSSL_StaticMalloc(size);
+    if (res) {
+        memcpy(res, ptr, staticSz[c]);
+        CyaSSL_StaticFree(ptr);
+    }
+
+    return res;
+}
+
+
+/* fill up to max entries, one per bucket and a last one (size 0) for
+   requests bigger than any bucket, returns the number of entries there are */
+int CyaSSL_StaticMemoryGetStats(CyaSSL_StaticMemStat* stats, int max)
+{
+    if (stats == NULL || max <= 0)
+        return STATIC_MEM_CLASSES + 1;
+
+    if (!staticReady && CyaSSL_StaticMemoryInit() != 0)
+        return 0;
+
+    if (max > STATIC_MEM_CLASSES + 1)
+        max = STATIC_MEM_CLASSES + 1;
+
+    LockMutex(&staticMutex);
+    memcpy(stats, staticStat, max * sizeof(CyaSSL_StaticMemStat));
+    UnLockMutex(&staticMutex);
+
+    return STATIC_MEM_CLASSES + 1;
+}
+
+
+/* print the buckets, a peak at total or any spills or fails says a bucket
+   wants more blocks, largest says where a new bucket would fit */
+void CyaSSL_StaticMemoryDump(void)
+{
+    CyaSSL_StaticMemStat stats[STATIC_MEM_CLASSES + 1];
+    int                  n = CyaSSL_StaticMemoryGetStats(stats,
+                                                     STATIC_MEM_CLASSES + 1);
+    int                  c;
+
+    printf("static memory, %lu bytes for %d connections\n",
+           (unsigned long)STATIC_MEM_ARENA_SZ, STATIC_MEM_CONNECTIONS);
+    printf("%8s %6s %6s %6s %10s %8s %8s %8s\n", "size", "total", "inuse",
+           "peak", "allocs", "spills", "fails", "largest");
+    for (c = 0; c < n; c++) {
+        if (stats[c].size)
+            printf("%8lu ", (unsigned long)stats[c].size);
+        else
+            printf("%8s ", "bigger");
+        printf("%6lu %6lu %6lu %10lu %8lu %8lu %8lu\n", stats[c].total,
+               stats[c].inUse, stats[c].peak, stats[c].allocs, stats[c].spills,
+               stats[c].fails, stats[c].largest);
+    }
+}
+
+#endif /* CYASSL_STATIC_MEMORY */
+
+
+#ifdef CYASSL_MEM_STATS
+
+/* Memory accounting. A CyaSSL_MemStats handle passed as the XMALLOC heap
+ * hint is charged for the block, and so is each parent up the chain. Every
+ * block carries a header naming the handle it was charged to, so XFREE
+ * credits the right one whatever hint the caller passes. Handles are
+ * reference counted by their owner, their children and their live blocks,
+ * so memory that outlives a connection still lands on a valid handle. */
+
+#if defined(__GNUC__) && defined(__ATOMIC_RELAXED)
+    #define MS_ADD(x, v)     __atomic_add_fetch(&(x), (v), __ATOMIC_RELAXED)
+    #define MS_SUB(x, v)     __atomic_sub_fetch(&(x), (v), __ATOMIC_ACQ_REL)
+    #define MS_LOAD(x)       __atomic_load_n(&(x), __ATOMIC_RELAXED)
+    #define MS_CAS(x, o, n)  __atomic_compare_exchange_n(&(x), &(o), (n), 0, \
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#elif defined(SINGLE_THREADED)
+    #define MS_ADD(x, v)     ((x) += (v))
+    #define MS_SUB(x, v)     ((x) -= (v))
+    #define MS_LOAD(x)       (x)
+    #define MS_CAS(x, o, n)  ((x) == (o) ? ((x) = (n), 1) : ((o) = (x), 0))
+#else
+    #error "memory stats need compiler atomics or SINGLE_THREADED"
+#endif
+
+#define MEM_STATS_MAGIC 0x6D656D73   /* tells a handle from other heap hints */
+#define MEM_HEADER_SZ   16           /* keeps payload 16 byte aligned */
+
+struct CyaSSL_MemStats {
+    unsigned int     magic;
+    unsigned long    refs;
+    CyaSSL_MemStats* parent;
+    CyaSSL_MemUsage  usage;
+};
+
+typedef struct MemHeader {
+    CyaSSL_MemStats* owner;
+    unsigned int     size;
+    unsigned int     type;
+} MemHeader;
+
+typedef char memHeaderFits[sizeof(MemHeader) <= MEM_HEADER_SZ ? 1 : -1];
+
+
+static void MemRaise(unsigned long* peak, unsigned long cur)
+{
+    unsigned long old = MS_LOAD(*peak);
+
+    while (cur > old && !MS_CAS(*peak, old, cur))
+        ;
+}
+
+
+static void MemCharge(CyaSSL_MemStats* stats, unsigned int sz, int type)
+{
+    for (; stats; stats = stats->parent) {
+        CyaSSL_MemUsage* u = &stats->usage;
+
+        MS_ADD(u->count, 1);
+        MS_ADD(u->typeCount[type], 1);
+        MemRaise(&u->peak, MS_ADD(u->current, sz));
+        MemRaise(&u->typePeak[type], MS_ADD(u->typeCurrent[type], sz));
+    }
+}
+
+
+static void MemCredit(CyaSSL_MemStats* stats, unsigned int sz, int type)
+{
+    for (; stats; stats = stats->parent) {
+        MS_SUB(stats->usage.current, sz);
+        MS_SUB(stats->usage.typeCurrent[type], sz);
+    }
+}
+
+
+static void MemStatsRelease(CyaSSL_MemStats* stats)
+{
+    while (stats && MS_SUB(stats->refs, 1) == 0) {
+        CyaSSL_MemStats* parent = stats->parent;
+
+        stats->magic = 0;
+        CyaSSL_Free(stats);
+        stats = parent;
+    }
+}
+
+
+static int MemType(int type)
+{
+    return (type < 0 || type >= CYASSL_MEM_TYPES) ? 0 : type;
+}
+
+
+/* new handle, charges roll up into parent when given */
+CyaSSL_MemStats* CyaSSL_MemStatsNew(CyaSSL_MemStats* parent)
+{
+    CyaSSL_MemStats* stats;
+
+    stats = (CyaSSL_MemStats*)CyaSSL_Malloc(sizeof(CyaSSL_MemStats));
+    if (stats == NULL)
+        return NULL;
+
+    memset(stats, 0, sizeof(CyaSSL_MemStats));
+    stats->magic  = MEM_STATS_MAGIC;
+    stats->refs   = 1;
+    stats->parent = parent;
+    if (parent)
+        MS_ADD(parent->refs, 1);
+
+    return stats;
+}
+
+
+/* owner is done, handle goes once its last block is freed */
+void CyaSSL_MemStatsFree(CyaSSL_MemStats* stats)
+{
+    MemStatsRelease(stats);
+}
+
+
+int CyaSSL_MemStatsGet(CyaSSL_MemStats* stats, CyaSSL_MemUsage* usage)
+{
+    int i;
+
+    if (stats == NULL || usage == NULL)
+        return BAD_FUNC_ARG;
+
+    usage->current = MS_LOAD(stats->usage.current);
+    usage->peak    = MS_LOAD(stats->usage.peak);
+    usage->count   = MS_LOAD(stats->usage.count);
+    for (i = 0; i < CYASSL_MEM_TYPES; i++) {
+        usage->typeCurrent[i] = MS_LOAD(stats->usage.typeCurrent[i]);
+        usage->typePeak[i]    = MS_LOAD(stats->usage.typePeak[i]);
+        usage->typeCount[i]   = MS_LOAD(stats->usage.typeCount[i]);
+    }
+
+    return 0;
+}
+
+
+void* CyaSSL_MallocHint(size_t size, void* heap, int type)
+{
+    CyaSSL_MemStats* stats = (CyaSSL_MemStats*)heap;
+    MemHeader*       hdr;
+    byte*            mem;
+
+    mem = (byte*)CyaSSL_Malloc(size + MEM_HEADER_SZ);
+    if (mem == NULL)
+        return NULL;
+
+    if (stats && stats->magic != MEM_STATS_MAGIC)
+        stats = NULL;
+
+    hdr = (MemHeader*)mem;
+    hdr->owner = stats;
+    hdr->size  = (unsigned int)size;
+    hdr->type  = (unsigned int)MemType(type);
+    if (stats) {
+        MS_ADD(stats->refs, 1);
+        MemCharge(stats, hdr->size, hdr->type);
+    }
+
+    return mem + MEM_HEADER_SZ;
+}
+
+
+void CyaSSL_FreeHint(void* ptr)
+{
+    MemHeader* hdr;
+
+    if (ptr == NULL)
+        return;
+
+    hdr = (MemHeader*)((byte*)ptr - MEM_HEADER_SZ);
+    if (hdr->owner) {
+        MemCredit(hdr->owner, hdr->size, hdr->type);
+        MemStatsRelease(hdr->owner);
+    }
+
+    CyaSSL_Free(hdr);
+}
+
+
+/* stays charged to the original handle, heap only matters when ptr is NULL */
+void* CyaSSL_ReallocHint(void* ptr, size_t size, void* heap, int type)
+{
+    MemHeader*    hdr;
+    unsigned int  oldSz;
+
+    if (ptr == NULL)
+        return CyaSSL_MallocHint(size, heap, type);
+
+    hdr   = (MemHeader*)((byte*)ptr - MEM_HEADER_SZ);
+    oldSz = hdr->size;
+    hdr   = (MemHeader*)CyaSSL_Realloc(hdr, size + MEM_HEADER_SZ);
+    if (hdr == NULL)
+        return NULL;
+
+    hdr->size = (unsigned int)size;
+    if (hdr->owner) {
+        MemCredit(hdr->owner, oldSz, hdr->type);
+        MemCharge(hdr->owner, hdr->size, hdr->type);
+    }
+
+    return (byte*)hdr + MEM_HEADER_SZ;
+}
+
+#endif /* CYASSL_MEM_STATS */
+
+
+#ifdef CYASSL_MEM_TRACE
+
+/* Allocation tracing. Call sites are keyed by the __FILE__ pointer, line,
+ * type and phase in an open addressed table under one lock, it is a
+ * debugging build so nothing is clever. Frees carry no size or site, only
+ * their phase is counted. Sites past the table size are only counted in
+ * their phase totals. */
+
+#ifndef MEM_TRACE_SITES
+    #define MEM_TRACE_SITES 4096      /* power of two */
+#endif
+
+static CyaSSL_MemTraceSite traceSites[MEM_TRACE_SITES];
+static int                 traceUsed = 0;
+static unsigned long       traceAllocs[CYASSL_TRACE_PHASES];
+static unsigned long       traceFrees[CYASSL_TRACE_PHASES];
+static THREAD_LS_T int     tracePhase = CYASSL_TRACE_OTHER;
+
+#ifdef SINGLE_THREADED
+    #define TRACE_LOCK()
+    #define TRACE_UNLOCK()
+#else
+    static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+    #define TRACE_LOCK()   pthread_mutex_lock(&traceMutex)
+    #define TRACE_UNLOCK() pthread_mutex_unlock(&traceMutex)
+#endif
+
+
+static void TraceAlloc(size_t size, int type, const char* file, int line)
+{
+    int    phase = tracePhase;
+    word32 h = (word32)line * 2654435761U ^ (word32)(size_t)file
+                                          ^ (word32)(phase << 8 | type);
+    int    i;
+
+    TRACE_LOCK();
+    traceAllocs[phase]++;
+    for (i = 0; i < MEM_TRACE_SITES; i++) {
+        CyaSSL_MemTraceSite* s = &traceSites[(h + i) & (MEM_TRACE_SITES - 1)];
+
+        if (s->file == NULL) {
+            if (traceUsed >= MEM_TRACE_SITES / 2)
+                break;                     /* keep probes short */
+            s->file  = file;
+            s->line  = line;
+            s->type  = type;
+            s->phase = phase;
+            traceUsed++;
+        }
+        if (s->file == file && s->line == line && s->type == type &&
+                                                         s->phase == phase) {
+            s->allocs++;
+            s->bytes += size;
+            break;
+        }
+    }
+    TRACE_UNLOCK();
+}
+
+
+int CyaSSL_MemTraceSetPhase(int phase)
+{
+    int prev = tracePhase;
+
+    if (phase >= 0 && phase < CYASSL_TRACE_PHASES)
+        tracePhase = phase;
+
+    return prev;
+}
+
+
+void CyaSSL_MemTraceReset(void)
+{
+    TRACE_LOCK();
+    memset(traceSites, 0, sizeof(traceSites));
+    memset(traceAllocs, 0, sizeof(traceAllocs));
+    memset(traceFrees, 0, sizeof(traceFrees));
+    traceUsed = 0;
+    TRACE_UNLOCK();
+}
+
+
+static unsigned long TraceSum(const unsigned long* counts, int phase)
+{
+    unsigned long sum = 0;
+    int i;
+
+    if (phase >= CYASSL_TRACE_PHASES)
+        return 0;
+
+    TRACE_LOCK();
+    if (phase >= 0)
+        sum = counts[phase];
+    else
+        for (i = 0; i < CYASSL_TRACE_PHASES; i++)
+            sum += counts[i];
+    TRACE_UNLOCK();
+
+    return sum;
+}
+
+
+unsigned long CyaSSL_MemTraceAllocs(int phase)
+{
+    return TraceSum(traceAllocs, phase);
+}
+
+
+unsigned long CyaSSL_MemTraceFrees(int phase)
+{
+    return TraceSum(traceFrees, phase);
+}
+
+
+int CyaSSL_MemTraceGet(CyaSSL_MemTraceSite* sites, int max)
+{
+    int i;
+    int n = 0;
+
+    TRACE_LOCK();
+    for (i = 0; i < MEM_TRACE_SITES; i++) {
+        if (traceSites[i].file == NULL)
+            continue;
+        if (sites && n < max)
+            sites[n] = traceSites[i];
+        n++;
+    }
+    TRACE_UNLOCK();
+
+    return n;
+}
+
+
+static int TraceCompare(const void* a, const void* b)
+{
+    const CyaSSL_MemTraceSite* x = (const CyaSSL_MemTraceSite*)a;
+    const CyaSSL_MemTraceSite* y = (const CyaSSL_MemTraceSite*)b;
+
+    if (x->phase != y->phase)
+        return x->phase - y->phase;
+    if (x->allocs != y->allocs)
+        return x->allocs < y->allocs ? 1 : -1;
+
+    return x->line - y->line;
+}
+
+
+void CyaSSL_MemTraceDump(int phase)
+{
+    static CyaSSL_MemTraceSite snap[MEM_TRACE_SITES / 2];
+    int i;
+    int n;
+    int last = -1;
+
+    n = CyaSSL_MemTraceGet(snap, MEM_TRACE_SITES / 2);
+    if (n > MEM_TRACE_SITES / 2)
+        n = MEM_TRACE_SITES / 2;
+    qsort(snap, n, sizeof(snap[0]), TraceCompare);
+
+    for (i = 0; i < n; i++) {
+        CyaSSL_MemTraceSite* s = &snap[i];
+
+        if (phase >= 0 && s->phase != phase)
+            continue;
+        if (s->phase != last) {
+            last = s->phase;
+            if (last >= CYASSL_TRACE_MSG_BASE)
+                printf("phase handshake msg %d", last - CYASSL_TRACE_MSG_BASE);
+            else
+                printf("phase %d", last);
+            printf(", %lu allocs, %lu frees\n", CyaSSL_MemTraceAllocs(last),
+                   CyaSSL_MemTraceFrees(last));
+        }
+        printf("  %8lu %10lu bytes  type %2d  %s:%d\n", s->allocs, s->bytes,
+               s->type, s->file, s->line);
+    }
+}
+
+
+void* CyaSSL_MallocTrace(size_t size, int type, const char* file, int line)
+{
+    void* res = CyaSSL_Malloc(size);
+
+    if (res)
+        TraceAlloc(size, type, file, line);
+
+    return res;
+}
+
+
+void CyaSSL_FreeTrace(void* ptr, int type)
+{
+    (void)type;
+
+    if (ptr == NULL)
+        return;
+
+    TRACE_LOCK();
+    traceFrees[tracePhase]++;
+    TRACE_UNLOCK();
+
+    CyaSSL_Free(ptr);
+}
+
+
+/* a resize counts as an allocation of the new size */
+void* CyaSSL_ReallocTrace(void* ptr, size_t size, int type, const char* file,
+                          int line)
+{
+    void* res = CyaSSL_Realloc(ptr, size);
+
+    if (res)
+        TraceAlloc(size, type, file, line);
 
     return res;
 }
 
+#endif /* CYASSL_MEM_TRACE */
+
 #endif /* USE_CYASSL_MEMORY */
 
 
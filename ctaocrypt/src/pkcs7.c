@@ -439,7 +439,8 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
         esd->signedAttribsSz += EncodeAttributes(&esd->signedAttribs[2], 4,
                                   pkcs7->signedAttribs, pkcs7->signedAttribsSz);
 
-        flatSignedAttribs = (byte*)XMALLOC(esd->signedAttribsSz, 0, NULL);
+        flatSignedAttribs = (byte*)XMALLOC(esd->signedAttribsSz, NULL,
+                                                 DYNAMIC_TYPE_TMP_BUFFER);
         flatSignedAttribsSz = esd->signedAttribsSz;
         if (flatSignedAttribs == NULL) {
 #ifdef CYASSL_SMALL_STACK
@@ -479,7 +480,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
 
             ret = InitSha(&esd->sha);
             if (ret < 0) {
-                XFREE(flatSignedAttribs, 0, NULL);
+                XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #ifdef CYASSL_SMALL_STACK
                 XFREE(esd, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
@@ -501,7 +502,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
                                     NULL, DYNAMIC_TYPE_TMP_BUFFER);
         if (digestInfo == NULL) {
             if (pkcs7->signedAttribsSz != 0)
-                XFREE(flatSignedAttribs, 0, NULL);
+                XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             XFREE(esd, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             return MEMORY_E;
         }
@@ -523,7 +524,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
                                                        DYNAMIC_TYPE_TMP_BUFFER);
         if (privKey == NULL) {
             if (pkcs7->signedAttribsSz != 0)
-                XFREE(flatSignedAttribs, 0, NULL);
+                XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             XFREE(digestInfo, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             XFREE(esd,        NULL, DYNAMIC_TYPE_TMP_BUFFER);
             return MEMORY_E;
@@ -536,7 +537,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
                                          pkcs7->privateKeySz);
         if (result < 0) {
             if (pkcs7->signedAttribsSz != 0)
-                XFREE(flatSignedAttribs, 0, NULL);
+                XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #ifdef CYASSL_SMALL_STACK
             XFREE(privKey,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
             XFREE(digestInfo, NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -559,7 +560,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
 
         if (result < 0) {
             if (pkcs7->signedAttribsSz != 0)
-                XFREE(flatSignedAttribs, 0, NULL);
+                XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #ifdef CYASSL_SMALL_STACK
             XFREE(esd, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
@@ -602,7 +603,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
 
     if (outputSz < totalSz) {
         if (pkcs7->signedAttribsSz != 0)
-            XFREE(flatSignedAttribs, 0, NULL);
+            XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #ifdef CYASSL_SMALL_STACK
         XFREE(esd, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
@@ -661,7 +662,7 @@ int PKCS7_EncodeSignedData(PKCS7* pkcs7, byte* output, word32 outputSz)
         idx += esd->signedAttribSetSz;
         XMEMCPY(output + idx, flatSignedAttribs, flatSignedAttribsSz);
         idx += flatSignedAttribsSz;
-        XFREE(flatSignedAttribs, 0, NULL);
+        XFREE(flatSignedAttribs, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     }
 
     XMEMCPY(output + idx, esd->digEncAlgoId, esd->digEncAlgoIdSz);
@@ -1459,6 +1460,41 @@ int PKCS7_EncodeEnvelopedData(PKCS7* pkcs7, byte* output, word32 outputSz)
     return idx;
 }
 
+/* total size of the primitive OCTET STRING segments of an indefinite length
+   constructed string, idx just past its header, < 0 on error */
+static int SegmentsSize(const byte* input, word32 idx, word32 maxIdx)
+{
+    int total = 0;
+    int length;
+
+    while (idx + 2 <= maxIdx && (input[idx] != 0 || input[idx + 1] != 0)) {
+        if (input[idx++] != ASN_OCTET_STRING ||
+            GetLength(input, &idx, &length, maxIdx) < 0)
+            return ASN_PARSE_E;
+        total += length;
+        idx   += length;
+    }
+
+    return (idx + 2 <= maxIdx) ? total : ASN_PARSE_E;
+}
+
+
+/* join the segments SegmentsSize() checked into out */
+static void CopySegments(byte* out, const byte* input, word32 idx,
+                         word32 maxIdx)
+{
+    int length;
+
+    while (input[idx] != 0 || input[idx + 1] != 0) {
+        idx++;
+        GetLength(input, &idx, &length, maxIdx);
+        XMEMCPY(out, input + idx, length);
+        out += length;
+        idx += length;
+    }
+}
+
+
 /* unwrap and decrypt PKCS#7 envelopedData object, return decoded size */
 CYASSL_API int PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
                                          word32 pkiMsgSz, byte* output,
@@ -1487,6 +1523,7 @@ CYASSL_API int PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
     RsaKey* privKey = &stack_privKey;
 #endif
     int encryptedContentSz;
+    int segmented = 0;
     byte padLen;
     byte* encryptedContent = NULL;
 
@@ -1703,15 +1740,20 @@ CYASSL_API int PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
     XMEMCPY(tmpIv, &pkiMsg[idx], length);
     idx += length;
 
-    /* read encryptedContent, cont[0] */
-    if (pkiMsg[idx++] != (ASN_CONTEXT_SPECIFIC | 0)) {
-#ifdef CYASSL_SMALL_STACK
-        XFREE(encryptedKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-#endif
-        return ASN_PARSE_E;
+    /* read encryptedContent, cont[0], or segments of it from the streaming
+     * encoder */
+    if (idx + 1 < pkiMsgSz &&
+        pkiMsg[idx] == (ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0) &&
+        pkiMsg[idx + 1] == ASN_LONG_LENGTH) {
+        idx += 2;
+        segmented = 1;
+        encryptedContentSz = SegmentsSize(pkiMsg, idx, pkiMsgSz);
     }
+    else if (pkiMsg[idx++] != (ASN_CONTEXT_SPECIFIC | 0) ||
+             GetLength(pkiMsg, &idx, &encryptedContentSz, pkiMsgSz) < 0)
+        encryptedContentSz = ASN_PARSE_E;
 
-    if (GetLength(pkiMsg, &idx, &encryptedContentSz, pkiMsgSz) < 0) {
+    if (encryptedContentSz <= 0) {
 #ifdef CYASSL_SMALL_STACK
         XFREE(encryptedKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
@@ -1727,7 +1769,10 @@ CYASSL_API int PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
         return MEMORY_E;
     }
 
-    XMEMCPY(encryptedContent, &pkiMsg[idx], encryptedContentSz);
+    if (segmented)
+        CopySegments(encryptedContent, pkiMsg, idx, pkiMsgSz);
+    else
+        XMEMCPY(encryptedContent, &pkiMsg[idx], encryptedContentSz);
 
     /* load private key */
 #ifdef CYASSL_SMALL_STACK
@@ -1836,6 +1881,1131 @@ CYASSL_API int PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
 }
 
 
+/* Streaming. Encoders write the outer layers with indefinite lengths and the
+   content as segments of a constructed OCTET STRING, so nothing has to be
+   sized up front. The content is hashed or encrypted as each Update() hands
+   it over, only a partial cipher block, or for verify the header being
+   parsed and the certs and signerInfos after the content, are kept */
+
+#ifndef PKCS7_STREAM_TRAILER_MAX
+    #define PKCS7_STREAM_TRAILER_MAX 65536   /* certs and signerInfos cap */
+#endif
+
+enum Pkcs7_Stream_State {
+    PKCS7_STREAM_NONE = 0,
+    PKCS7_STREAM_SIGN,              /* encoding SignedData content       */
+    PKCS7_STREAM_ENVELOPE,          /* encoding EnvelopedData content    */
+    PKCS7_STREAM_HEADER,            /* verify, up to the content         */
+    PKCS7_STREAM_SEGMENT,           /* verify, next segment header       */
+    PKCS7_STREAM_CONTENT,           /* verify, in a segment              */
+    PKCS7_STREAM_LAST,              /* verify, in a primitive content    */
+    PKCS7_STREAM_TRAILER            /* verify, after the content         */
+};
+
+
+/* tag with an indefinite length, closed by an end of contents, two zeros */
+static INLINE word32 SetIndefinite(byte tag, byte* output)
+{
+    output[0] = tag;
+    output[1] = ASN_LONG_LENGTH;
+
+    return 2;
+}
+
+
+/* SignerInfo over contentDigest signed by key, the SET OF it holding goes to
+   output. Returns size or < 0 */
+static int EncodeSignerInfoKey(PKCS7* pkcs7, RsaKey* key,
+                               const byte* contentDigest,
+                               byte* output, word32 outputSz)
+{
+    byte contentTypeOid[] =
+            { ASN_OBJECT_ID, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xF7, 0x0d, 0x01,
+                             0x09, 0x03 };
+    byte contentType[] =
+            { ASN_OBJECT_ID, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01,
+                             0x07, 0x01 };
+    byte messageDigestOid[] =
+            { ASN_OBJECT_ID, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01,
+                             0x09, 0x04 };
+    byte messageDigest[2 + SHA_DIGEST_SIZE];
+
+    PKCS7Attrib cannedAttribs[2] =
+    {
+        { contentTypeOid, sizeof(contentTypeOid),
+                         contentType, sizeof(contentType) },
+        { messageDigestOid, sizeof(messageDigestOid),
+                         messageDigest, sizeof(messageDigest) }
+    };
+    EncodedAttrib attribs[6];
+    word32 attribsCount = 0, attribsSz = 0;
+
+    byte infoSet[MAX_SET_SZ];
+    byte infoSeq[MAX_SEQ_SZ];
+    byte version[MAX_VERSION_SZ];
+    byte issuerSnSeq[MAX_SEQ_SZ];
+    byte issuerName[MAX_SEQ_SZ];
+    byte issuerSn[MAX_SN_SZ];
+    byte digAlgoId[MAX_ALGO_SZ];
+    byte attribSet[MAX_SET_SZ];
+    byte encAlgoId[MAX_ALGO_SZ];
+    byte sigOctets[MAX_OCTET_STR_SZ];
+    byte digestInfo[MAX_SEQ_SZ + MAX_ALGO_SZ + MAX_OCTET_STR_SZ +
+                    SHA_DIGEST_SIZE];
+    byte digestSeq[MAX_SEQ_SZ];
+    byte digestStr[MAX_OCTET_STR_SZ];
+    byte attribsDigest[SHA_DIGEST_SIZE];
+    const byte* signDigest = contentDigest;
+
+    word32 infoSetSz, infoSeqSz, versionSz, issuerSnSeqSz, issuerNameSz,
+           issuerSnSz, digAlgoIdSz, attribSetSz = 0, encAlgoIdSz, sigOctetsSz,
+           digestSeqSz, digestStrSz;
+    word32 infoSz, attribsIdx = 0, idx = 0, digIdx = 0;
+    int    sigSz, ret;
+
+    sigSz = RsaEncryptSize(key);
+    if (sigSz <= 0)
+        return PUBLIC_KEY_E;
+
+    if (pkcs7->signedAttribsSz != 0) {
+        messageDigest[0] = ASN_OCTET_STRING;
+        messageDigest[1] = SHA_DIGEST_SIZE;
+        XMEMCPY(messageDigest + 2, contentDigest, SHA_DIGEST_SIZE);
+
+        attribsSz  = EncodeAttributes(&attribs[0], 2, cannedAttribs, 2);
+        attribsSz += EncodeAttributes(&attribs[2], 4, pkcs7->signedAttribs,
+                                      pkcs7->signedAttribsSz);
+        attribsCount = 2 + min(4, pkcs7->signedAttribsSz);
+        attribSetSz  = SetImplicit(ASN_SET, 0, attribsSz, attribSet);
+    }
+
+    versionSz     = SetMyVersion(1, version, 0);
+    issuerSnSz    = SetSerialNumber(pkcs7->issuerSn, pkcs7->issuerSnSz,
+                                    issuerSn);
+    issuerNameSz  = SetSequence(pkcs7->issuerSz, issuerName);
+    issuerSnSeqSz = SetSequence(issuerNameSz + pkcs7->issuerSz + issuerSnSz,
+                                issuerSnSeq);
+    digAlgoIdSz   = SetAlgoID(pkcs7->hashOID, digAlgoId, hashType, 0);
+    encAlgoIdSz   = SetAlgoID(pkcs7->encryptOID, encAlgoId, keyType, 0);
+    sigOctetsSz   = SetOctetString(sigSz, sigOctets);
+
+    infoSz = versionSz + issuerSnSeqSz + issuerNameSz + pkcs7->issuerSz +
+             issuerSnSz + digAlgoIdSz + attribSetSz + attribsSz +
+             encAlgoIdSz + sigOctetsSz + sigSz;
+    infoSeqSz = SetSequence(infoSz, infoSeq);
+    infoSetSz = SetSet(infoSeqSz + infoSz, infoSet);
+
+    if (infoSetSz + infoSeqSz + infoSz > outputSz)
+        return BUFFER_E;
+
+    XMEMCPY(output + idx, infoSet, infoSetSz);
+    idx += infoSetSz;
+    XMEMCPY(output + idx, infoSeq, infoSeqSz);
+    idx += infoSeqSz;
+    XMEMCPY(output + idx, version, versionSz);
+    idx += versionSz;
+    XMEMCPY(output + idx, issuerSnSeq, issuerSnSeqSz);
+    idx += issuerSnSeqSz;
+    XMEMCPY(output + idx, issuerName, issuerNameSz);
+    idx += issuerNameSz;
+    XMEMCPY(output + idx, pkcs7->issuer, pkcs7->issuerSz);
+    idx += pkcs7->issuerSz;
+    XMEMCPY(output + idx, issuerSn, issuerSnSz);
+    idx += issuerSnSz;
+    XMEMCPY(output + idx, digAlgoId, digAlgoIdSz);
+    idx += digAlgoIdSz;
+
+    if (attribsSz != 0) {
+        Sha  sha;
+        byte setHdr[MAX_SET_SZ];
+
+        XMEMCPY(output + idx, attribSet, attribSetSz);
+        idx += attribSetSz;
+        attribsIdx = idx;
+        FlattenAttributes(output + idx, attribs, attribsCount);
+        idx += attribsSz;
+
+        /* signed as a SET, not the [0] they're sent under */
+        ret = InitSha(&sha);
+        if (ret != 0)
+            return ret;
+        ShaUpdate(&sha, setHdr, SetSet(attribsSz, setHdr));
+        ShaUpdate(&sha, output + attribsIdx, attribsSz);
+        ShaFinal(&sha, attribsDigest);
+        signDigest = attribsDigest;
+    }
+
+    XMEMCPY(output + idx, encAlgoId, encAlgoIdSz);
+    idx += encAlgoIdSz;
+    XMEMCPY(output + idx, sigOctets, sigOctetsSz);
+    idx += sigOctetsSz;
+
+    digestStrSz = SetOctetString(SHA_DIGEST_SIZE, digestStr);
+    digestSeqSz = SetSequence(digAlgoIdSz + digestStrSz + SHA_DIGEST_SIZE,
+                              digestSeq);
+    XMEMCPY(digestInfo + digIdx, digestSeq, digestSeqSz);
+    digIdx += digestSeqSz;
+    XMEMCPY(digestInfo + digIdx, digAlgoId, digAlgoIdSz);
+    digIdx += digAlgoIdSz;
+    XMEMCPY(digestInfo + digIdx, digestStr, digestStrSz);
+    digIdx += digestStrSz;
+    XMEMCPY(digestInfo + digIdx, signDigest, SHA_DIGEST_SIZE);
+    digIdx += SHA_DIGEST_SIZE;
+
+    ret = RsaSSL_Sign(digestInfo, digIdx, output + idx, sigSz, key,
+                      pkcs7->rng);
+    if (ret < 0)
+        return ret;
+    if (ret != sigSz)
+        return RSA_BUFFER_E;
+
+    return idx + sigSz;
+}
+
+
+static int EncodeSignerInfo(PKCS7* pkcs7, const byte* contentDigest,
+                            byte* output, word32 outputSz)
+{
+    word32 scratch = 0;
+    int    ret;
+#ifdef CYASSL_SMALL_STACK
+    RsaKey* key;
+#else
+    RsaKey  stack_key;
+    RsaKey* key = &stack_key;
+#endif
+
+#ifdef CYASSL_SMALL_STACK
+    key = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (key == NULL)
+        return MEMORY_E;
+#endif
+
+    ret = InitRsaKey(key, NULL);
+    if (ret == 0) {
+        if (RsaPrivateKeyDecode(pkcs7->privateKey, &scratch, key,
+                                pkcs7->privateKeySz) < 0)
+            ret = PUBLIC_KEY_E;
+        else
+            ret = EncodeSignerInfoKey(pkcs7, key, contentDigest, output,
+                                      outputSz);
+        FreeRsaKey(key);
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+/* start a streamed SignedData, output gets the layers down to the content
+   OCTET STRING */
+int PKCS7_EncodeSignedDataInit(PKCS7* pkcs7, PKCS7Stream* stream,
+                               byte* output, word32 outputSz)
+{
+    byte   hdr[PKCS7_STREAM_HDR_SZ];
+    byte   digAlgoId[MAX_ALGO_SZ];
+    byte   digAlgoIdSet[MAX_SET_SZ];
+    word32 digAlgoIdSz, digAlgoIdSetSz;
+    word32 idx = 0;
+    int    ret;
+
+    if (pkcs7 == NULL || stream == NULL || output == NULL ||
+        pkcs7->encryptOID == 0 || pkcs7->hashOID == 0 || pkcs7->rng == 0 ||
+        pkcs7->singleCert == NULL || pkcs7->singleCertSz == 0 ||
+        pkcs7->privateKey == NULL || pkcs7->privateKeySz == 0)
+        return BAD_FUNC_ARG;
+
+    digAlgoIdSz    = SetAlgoID(pkcs7->hashOID, digAlgoId, hashType, 0);
+    digAlgoIdSetSz = SetSet(digAlgoIdSz, digAlgoIdSet);
+
+    idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, hdr + idx);
+    idx += SetContentType(SIGNED_DATA, hdr + idx);
+    idx += SetIndefinite(ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0, hdr + idx);
+    idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, hdr + idx);
+    idx += SetMyVersion(1, hdr + idx, 0);
+    XMEMCPY(hdr + idx, digAlgoIdSet, digAlgoIdSetSz);
+    idx += digAlgoIdSetSz;
+    XMEMCPY(hdr + idx, digAlgoId, digAlgoIdSz);
+    idx += digAlgoIdSz;
+    idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, hdr + idx);
+    idx += SetContentType(DATA, hdr + idx);
+    idx += SetIndefinite(ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0, hdr + idx);
+    idx += SetIndefinite(ASN_OCTET_STRING | ASN_CONSTRUCTED, hdr + idx);
+
+    if (idx > outputSz)
+        return BUFFER_E;
+
+    XMEMSET(stream, 0, sizeof(PKCS7Stream));
+    ret = InitSha(&stream->sha);
+    if (ret != 0)
+        return ret;
+    stream->state = PKCS7_STREAM_SIGN;
+
+    XMEMCPY(output, hdr, idx);
+
+    return idx;
+}
+
+
+/* hash in and write it as the next content segment, output needs inSz +
+   MAX_OCTET_STR_SZ */
+int PKCS7_EncodeSignedDataUpdate(PKCS7* pkcs7, PKCS7Stream* stream,
+                                 const byte* in, word32 inSz,
+                                 byte* output, word32 outputSz)
+{
+    byte   octets[MAX_OCTET_STR_SZ];
+    word32 octetsSz;
+
+    if (pkcs7 == NULL || stream == NULL || (in == NULL && inSz != 0) ||
+        output == NULL || stream->state != PKCS7_STREAM_SIGN)
+        return BAD_FUNC_ARG;
+
+    if (inSz == 0)
+        return 0;
+
+    octetsSz = SetOctetString(inSz, octets);
+    if (octetsSz + inSz < inSz || octetsSz + inSz > outputSz)
+        return BUFFER_E;
+
+    ShaUpdate(&stream->sha, in, inSz);
+    XMEMCPY(output, octets, octetsSz);
+    XMEMCPY(output + octetsSz, in, inSz);
+
+    return octetsSz + inSz;
+}
+
+
+/* close the content, sign and write the cert, signerInfo and the ends of
+   contents, output needs about singleCertSz plus twice the key size. On
+   BUFFER_E it can be called again with more room */
+int PKCS7_EncodeSignedDataFinal(PKCS7* pkcs7, PKCS7Stream* stream,
+                                byte* output, word32 outputSz)
+{
+    Sha    sha;
+    byte   digest[SHA_DIGEST_SIZE];
+    byte   certsSet[MAX_SET_SZ];
+    word32 certsSetSz, idx;
+    int    ret;
+
+    if (pkcs7 == NULL || stream == NULL || output == NULL ||
+        stream->state != PKCS7_STREAM_SIGN)
+        return BAD_FUNC_ARG;
+
+    certsSetSz = SetImplicit(ASN_SET, 0, pkcs7->singleCertSz, certsSet);
+    if (outputSz < PKCS7_STREAM_EOC_SZ + certsSetSz + pkcs7->singleCertSz)
+        return BUFFER_E;
+
+    sha = stream->sha;              /* stream untouched until done */
+    ShaFinal(&sha, digest);
+
+    /* content OCTET STRING, [0] and encapContentInfo ends */
+    XMEMSET(output, 0, 6);
+    idx = 6;
+    XMEMCPY(output + idx, certsSet, certsSetSz);
+    idx += certsSetSz;
+    XMEMCPY(output + idx, pkcs7->singleCert, pkcs7->singleCertSz);
+    idx += pkcs7->singleCertSz;
+
+    ret = EncodeSignerInfo(pkcs7, digest, output + idx, outputSz - idx - 6);
+    if (ret < 0)
+        return ret;
+    idx += ret;
+
+    /* SignedData, [0] and ContentInfo ends */
+    XMEMSET(output + idx, 0, 6);
+    idx += 6;
+
+    XMEMSET(stream, 0, sizeof(PKCS7Stream));
+
+    return idx;
+}
+
+
+int PKCS7_VerifySignedDataInit(PKCS7* pkcs7, PKCS7Stream* stream)
+{
+    if (pkcs7 == NULL || stream == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(stream, 0, sizeof(PKCS7Stream));
+    stream->state = PKCS7_STREAM_HEADER;
+
+    return InitSha(&stream->sha);
+}
+
+
+/* tag and length at *idx of input still arriving, 1 with *idx past them,
+   0 if more is needed, < 0 on error. *indef set for an indefinite length */
+static int StreamTagLength(const byte* input, word32* idx, word32 sz,
+                           byte tag, word32* len, int* indef)
+{
+    word32 i = *idx;
+    word32 bytes;
+
+    if (i + 2 > sz)
+        return 0;
+    if (input[i++] != tag)
+        return ASN_PARSE_E;
+
+    *len   = 0;
+    *indef = 0;
+    bytes  = input[i++];
+    if (bytes == ASN_LONG_LENGTH)
+        *indef = 1;
+    else if (bytes < ASN_LONG_LENGTH)
+        *len = bytes;
+    else {
+        bytes &= 0x7F;
+        if (bytes > sizeof(word32))
+            return ASN_PARSE_E;
+        if (i + bytes > sz)
+            return 0;
+        while (bytes--)
+            *len = (*len << 8) | input[i++];
+    }
+    *idx = i;
+
+    return 1;
+}
+
+
+/* a definite length element at *idx that has to be here whole, 1 with *idx
+   at its contents, 0 if more is needed, < 0 on error */
+static int StreamElement(const byte* input, word32* idx, word32 sz,
+                         byte tag, word32* len)
+{
+    word32 i = *idx;
+    int    indef;
+    int    ret;
+
+    ret = StreamTagLength(input, &i, sz, tag, len, &indef);
+    if (ret <= 0)
+        return ret;
+    if (indef)
+        return ASN_PARSE_E;
+    if (i + *len > sz)
+        return 0;
+    *idx = i;
+
+    return 1;
+}
+
+
+/* contentType OID at *idx has to be type, 1 with *idx past it, 0 if more is
+   needed, < 0 on error */
+static int StreamContentType(const byte* input, word32* idx, word32 sz,
+                             word32 type)
+{
+    word32 i = *idx;
+    word32 len, contentType;
+    int    ret;
+
+    ret = StreamElement(input, &i, sz, ASN_OBJECT_ID, &len);
+    if (ret <= 0)
+        return ret;
+    if (GetContentType(input, idx, &contentType, sz) < 0)
+        return ASN_PARSE_E;
+    if (contentType != type) {
+        CYASSL_MSG("PKCS#7 stream content type mismatch");
+        return PKCS7_OID_E;
+    }
+
+    return 1;
+}
+
+
+/* ContentInfo down to the SignedData content, bytes of hdr used, 0 if more
+   is needed or < 0 */
+static int StreamSignedHeader(PKCS7Stream* stream)
+{
+    const byte* hdr = stream->hdr;
+    word32 sz  = stream->hdrSz;
+    word32 idx = 0, len;
+    int    indef, ret;
+
+    if ((ret = StreamTagLength(hdr, &idx, sz, ASN_SEQUENCE | ASN_CONSTRUCTED,
+                               &len, &indef)) <= 0 ||
+        (ret = StreamContentType(hdr, &idx, sz, SIGNED_DATA)) <= 0 ||
+        (ret = StreamTagLength(hdr, &idx, sz,
+                               ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0,
+                               &len, &indef)) <= 0 ||
+        (ret = StreamTagLength(hdr, &idx, sz, ASN_SEQUENCE | ASN_CONSTRUCTED,
+                               &len, &indef)) <= 0 ||
+        (ret = StreamElement(hdr, &idx, sz, ASN_INTEGER, &len)) <= 0)
+        return ret;
+
+    if (len != 1 || hdr[idx] != 1) {
+        CYASSL_MSG("PKCS#7 signedData needs to be of version 1");
+        return ASN_VERSION_E;
+    }
+    idx += len;
+
+    /* digestAlgorithms, the content is hashed with SHA regardless */
+    if ((ret = StreamElement(hdr, &idx, sz, ASN_SET | ASN_CONSTRUCTED,
+                             &len)) <= 0)
+        return ret;
+    idx += len;
+
+    if ((ret = StreamTagLength(hdr, &idx, sz, ASN_SEQUENCE | ASN_CONSTRUCTED,
+                               &len, &indef)) <= 0 ||
+        (ret = StreamContentType(hdr, &idx, sz, DATA)) <= 0 ||
+        (ret = StreamTagLength(hdr, &idx, sz,
+                               ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0,
+                               &len, &indef)) <= 0)
+        return ret;
+
+    if (idx >= sz)
+        return 0;
+
+    if (hdr[idx] == ASN_OCTET_STRING) {
+        if ((ret = StreamTagLength(hdr, &idx, sz, ASN_OCTET_STRING, &len,
+                                   &indef)) <= 0)
+            return ret;
+        if (indef)
+            return ASN_PARSE_E;
+        stream->remain = len;
+        stream->state  = len ? PKCS7_STREAM_LAST : PKCS7_STREAM_TRAILER;
+    }
+    else {
+        /* segments, as the streaming encoder writes */
+        if ((ret = StreamTagLength(hdr, &idx, sz,
+                                   ASN_OCTET_STRING | ASN_CONSTRUCTED, &len,
+                                   &indef)) <= 0)
+            return ret;
+        if (!indef) {
+            CYASSL_MSG("PKCS#7 definite length segmented content");
+            return ASN_PARSE_E;
+        }
+        stream->state = PKCS7_STREAM_SEGMENT;
+    }
+
+    return (int)idx;
+}
+
+
+/* next content segment header or the end of contents, bytes of hdr used,
+   0 if more is needed or < 0 */
+static int StreamSegment(PKCS7Stream* stream)
+{
+    word32 idx = 0, len;
+    int    indef, ret;
+
+    if (stream->hdrSz < 2)
+        return 0;
+
+    if (stream->hdr[0] == 0 && stream->hdr[1] == 0) {
+        stream->state = PKCS7_STREAM_TRAILER;
+        return 2;
+    }
+
+    ret = StreamTagLength(stream->hdr, &idx, stream->hdrSz, ASN_OCTET_STRING,
+                          &len, &indef);
+    if (ret <= 0)
+        return ret;
+    if (indef)
+        return ASN_PARSE_E;
+
+    stream->remain = len;
+    if (len)
+        stream->state = PKCS7_STREAM_CONTENT;
+
+    return (int)idx;
+}
+
+
+/* keep what follows the content for Final() */
+static int StreamTrailer(PKCS7Stream* stream, const byte* in, word32 inSz)
+{
+    if (inSz > PKCS7_STREAM_TRAILER_MAX - stream->trailerSz) {
+        CYASSL_MSG("PKCS#7 stream trailer too large");
+        return BUFFER_E;
+    }
+
+    if (stream->trailerSz + inSz > stream->trailerMax) {
+        word32 max = stream->trailerMax ? stream->trailerMax : 2048;
+        byte*  trailer;
+
+        while (max < stream->trailerSz + inSz)
+            max *= 2;
+        if (max > PKCS7_STREAM_TRAILER_MAX)
+            max = PKCS7_STREAM_TRAILER_MAX;
+
+        trailer = (byte*)XMALLOC(max, NULL, DYNAMIC_TYPE_PKCS7);
+        if (trailer == NULL)
+            return MEMORY_E;
+        if (stream->trailer) {
+            XMEMCPY(trailer, stream->trailer, stream->trailerSz);
+            XFREE(stream->trailer, NULL, DYNAMIC_TYPE_PKCS7);
+        }
+        stream->trailer    = trailer;
+        stream->trailerMax = max;
+    }
+
+    XMEMCPY(stream->trailer + stream->trailerSz, in, inSz);
+    stream->trailerSz += inSz;
+
+    return 0;
+}
+
+
+/* hash the content in as it arrives, in may split the message anywhere */
+int PKCS7_VerifySignedDataUpdate(PKCS7* pkcs7, PKCS7Stream* stream,
+                                 const byte* in, word32 inSz)
+{
+    int ret = 0;
+
+    if (pkcs7 == NULL || stream == NULL || (in == NULL && inSz != 0))
+        return BAD_FUNC_ARG;
+
+    while (inSz > 0 && ret >= 0) {
+        word32 n;
+
+        switch (stream->state) {
+            case PKCS7_STREAM_HEADER:
+            case PKCS7_STREAM_SEGMENT:
+                n = min(inSz, PKCS7_STREAM_HDR_SZ - stream->hdrSz);
+                XMEMCPY(stream->hdr + stream->hdrSz, in, n);
+                stream->hdrSz += n;
+
+                if (stream->state == PKCS7_STREAM_HEADER)
+                    ret = StreamSignedHeader(stream);
+                else
+                    ret = StreamSegment(stream);
+
+                if (ret == 0 && stream->hdrSz == PKCS7_STREAM_HDR_SZ)
+                    ret = ASN_PARSE_E;
+                else if (ret > 0) {
+                    /* only part of this input was header */
+                    n = (word32)ret - (stream->hdrSz - n);
+                    stream->hdrSz = 0;
+                }
+                in   += n;
+                inSz -= n;
+                break;
+
+            case PKCS7_STREAM_CONTENT:
+            case PKCS7_STREAM_LAST:
+                n = min(inSz, stream->remain);
+                ShaUpdate(&stream->sha, in, n);
+                stream->remain -= n;
+                in   += n;
+                inSz -= n;
+
+                if (stream->remain == 0)
+                    stream->state = (stream->state == PKCS7_STREAM_CONTENT) ?
+                                    PKCS7_STREAM_SEGMENT : PKCS7_STREAM_TRAILER;
+                break;
+
+            case PKCS7_STREAM_TRAILER:
+                ret  = StreamTrailer(stream, in, inSz);
+                inSz = 0;
+                break;
+
+            default:
+                ret = BAD_FUNC_ARG;
+        }
+    }
+
+    return (ret < 0) ? ret : 0;
+}
+
+
+/* signed attributes have to carry contentDigest as messageDigest */
+static int CheckMessageDigest(const byte* attribs, word32 attribsSz,
+                              const byte* contentDigest)
+{
+    static const byte messageDigestOid[] =
+            { 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x09, 0x04 };
+    word32 idx = 0;
+
+    while (idx < attribsSz) {
+        word32 end;
+        int    length;
+
+        if (GetSequence(attribs, &idx, &length, attribsSz) < 0)
+            return ASN_PARSE_E;
+        end = idx + length;
+
+        if (idx >= end || attribs[idx++] != ASN_OBJECT_ID ||
+            GetLength(attribs, &idx, &length, end) < 0)
+            return ASN_PARSE_E;
+
+        if (length == sizeof(messageDigestOid) &&
+            XMEMCMP(attribs + idx, messageDigestOid, length) == 0) {
+            idx += length;
+            if (GetSet(attribs, &idx, &length, end) < 0 || idx >= end ||
+                attribs[idx++] != ASN_OCTET_STRING ||
+                GetLength(attribs, &idx, &length, end) < 0)
+                return ASN_PARSE_E;
+
+            if (length != SHA_DIGEST_SIZE ||
+                XMEMCMP(attribs + idx, contentDigest, SHA_DIGEST_SIZE) != 0) {
+                CYASSL_MSG("PKCS#7 messageDigest mismatch");
+                return ASN_SIG_CONFIRM_E;
+            }
+            return 0;
+        }
+        idx = end;
+    }
+
+    CYASSL_MSG("PKCS#7 signed attributes without messageDigest");
+    return ASN_SIG_CONFIRM_E;
+}
+
+
+/* signature sig under pkcs7's key has to be a DigestInfo of digest */
+static int CheckSignature(PKCS7* pkcs7, const byte* sig, word32 sigSz,
+                          const byte* digest)
+{
+    word32 scratch = 0, idx = 0, oid;
+    int    plainSz, length, ret;
+    int    digestInfoSz = MAX_SEQ_SZ + MAX_ALGO_SZ + MAX_OCTET_STR_SZ +
+                          SHA_DIGEST_SIZE;
+#ifdef CYASSL_SMALL_STACK
+    byte*   digestInfo;
+    RsaKey* key;
+#else
+    byte    digestInfo[MAX_SEQ_SZ + MAX_ALGO_SZ + MAX_OCTET_STR_SZ +
+                       SHA_DIGEST_SIZE];
+    RsaKey  stack_key;
+    RsaKey* key = &stack_key;
+#endif
+
+#ifdef CYASSL_SMALL_STACK
+    digestInfo = (byte*)XMALLOC(digestInfoSz, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    key = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (digestInfo == NULL || key == NULL) {
+        XFREE(digestInfo, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(key,        NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E;
+    }
+#endif
+
+    ret = InitRsaKey(key, NULL);
+    if (ret == 0) {
+        if (RsaPublicKeyDecode(pkcs7->publicKey, &scratch, key,
+                               pkcs7->publicKeySz) < 0) {
+            CYASSL_MSG("ASN RSA key decode error");
+            ret = PUBLIC_KEY_E;
+        }
+        else {
+            plainSz = RsaSSL_Verify(sig, sigSz, digestInfo, digestInfoSz, key);
+            if (plainSz < 0)
+                ret = plainSz;
+            else if (GetSequence(digestInfo, &idx, &length, plainSz) < 0 ||
+                     GetAlgoId(digestInfo, &idx, &oid, plainSz) < 0 ||
+                     idx >= (word32)plainSz ||
+                     digestInfo[idx++] != ASN_OCTET_STRING ||
+                     GetLength(digestInfo, &idx, &length, plainSz) < 0)
+                ret = ASN_PARSE_E;
+            else if (length != SHA_DIGEST_SIZE ||
+                     XMEMCMP(digestInfo + idx, digest, SHA_DIGEST_SIZE) != 0) {
+                CYASSL_MSG("PKCS#7 signature digest mismatch");
+                ret = ASN_SIG_CONFIRM_E;
+            }
+        }
+        FreeRsaKey(key);
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(digestInfo, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(key,        NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+/* certs and the first signerInfo after the content, checked against
+   contentDigest */
+static int VerifyTrailer(PKCS7* pkcs7, const byte* trailer, word32 sz,
+                         const byte* contentDigest)
+{
+    const byte* attribs = NULL;
+    const byte* sig;
+    word32 idx = 0, attribsSz = 0;
+    int    length, version, ret;
+    byte   digest[SHA_DIGEST_SIZE];
+
+    /* ends of an indefinite [0] and encapContentInfo */
+    while (idx + 1 < sz && trailer[idx] == 0 && trailer[idx + 1] == 0)
+        idx += 2;
+
+    /* implicit[0] set of certificates, the first is the signer's */
+    if (idx < sz &&
+        trailer[idx] == (ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0)) {
+        idx++;
+        if (idx >= sz || trailer[idx] == ASN_LONG_LENGTH ||
+            GetLength(trailer, &idx, &length, sz) < 0)
+            return ASN_PARSE_E;
+
+        if (length > 0) {
+            word32 certIdx = idx;
+            int    certSz;
+
+            if (trailer[certIdx++] != (ASN_CONSTRUCTED | ASN_SEQUENCE) ||
+                GetLength(trailer, &certIdx, &certSz, idx + length) < 0)
+                return ASN_PARSE_E;
+            ret = PKCS7_InitWithCert(pkcs7, (byte*)trailer + idx,
+                                     certSz + (certIdx - idx));
+            if (ret < 0)
+                return ret;
+        }
+        idx += length;
+    }
+
+    /* implicit[1] set of crls */
+    if (idx < sz &&
+        trailer[idx] == (ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 1)) {
+        idx++;
+        if (idx >= sz || trailer[idx] == ASN_LONG_LENGTH ||
+            GetLength(trailer, &idx, &length, sz) < 0)
+            return ASN_PARSE_E;
+        idx += length;
+    }
+
+    if (GetSet(trailer, &idx, &length, sz) < 0 ||
+        GetSequence(trailer, &idx, &length, sz) < 0 ||
+        GetMyVersion(trailer, &idx, &version) < 0)
+        return ASN_PARSE_E;
+
+    if (version != 1) {
+        CYASSL_MSG("PKCS#7 signerInfo needs to be of version 1");
+        return ASN_VERSION_E;
+    }
+
+    /* IssuerAndSerialNumber and digestAlgorithm */
+    if (GetSequence(trailer, &idx, &length, sz) < 0)
+        return ASN_PARSE_E;
+    idx += length;
+    if (GetSequence(trailer, &idx, &length, sz) < 0)
+        return ASN_PARSE_E;
+    idx += length;
+
+    if (idx < sz &&
+        trailer[idx] == (ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0)) {
+        idx++;
+        if (GetLength(trailer, &idx, &length, sz) < 0)
+            return ASN_PARSE_E;
+        attribs   = trailer + idx;
+        attribsSz = length;
+        idx += length;
+    }
+
+    /* digestEncryptionAlgorithm */
+    if (GetSequence(trailer, &idx, &length, sz) < 0)
+        return ASN_PARSE_E;
+    idx += length;
+
+    if (idx >= sz || trailer[idx++] != ASN_OCTET_STRING ||
+        GetLength(trailer, &idx, &length, sz) < 0)
+        return ASN_PARSE_E;
+    sig = trailer + idx;
+
+    if (pkcs7->publicKeySz == 0) {
+        CYASSL_MSG("PKCS#7 no signer cert");
+        return ASN_NO_SIGNER_E;
+    }
+
+    if (attribs == NULL)
+        return CheckSignature(pkcs7, sig, length, contentDigest);
+
+    {
+        Sha  sha;
+        byte setHdr[MAX_SET_SZ];
+
+        ret = CheckMessageDigest(attribs, attribsSz, contentDigest);
+        if (ret != 0)
+            return ret;
+
+        /* signed as a SET, not the [0] they're sent under */
+        ret = InitSha(&sha);
+        if (ret != 0)
+            return ret;
+        ShaUpdate(&sha, setHdr, SetSet(attribsSz, setHdr));
+        ShaUpdate(&sha, attribs, attribsSz);
+        ShaFinal(&sha, digest);
+    }
+
+    return CheckSignature(pkcs7, sig, length, digest);
+}
+
+
+/* check the signature once the whole message went through Update(). The
+   message's signer cert is set on pkcs7, it points into stream so free
+   stream after pkcs7 is done with it */
+int PKCS7_VerifySignedDataFinal(PKCS7* pkcs7, PKCS7Stream* stream)
+{
+    byte digest[SHA_DIGEST_SIZE];
+
+    if (pkcs7 == NULL || stream == NULL)
+        return BAD_FUNC_ARG;
+
+    if (stream->state != PKCS7_STREAM_TRAILER || stream->trailer == NULL) {
+        CYASSL_MSG("PKCS#7 stream ended early");
+        return ASN_PARSE_E;
+    }
+
+    ShaFinal(&stream->sha, digest);
+    stream->state = PKCS7_STREAM_NONE;
+
+    pkcs7->content   = NULL;
+    pkcs7->contentSz = 0;
+
+    return VerifyTrailer(pkcs7, stream->trailer, stream->trailerSz, digest);
+}
+
+
+/* encrypt sz bytes of whole blocks in place */
+static int StreamEncrypt(PKCS7Stream* stream, byte* data, word32 sz)
+{
+    if (stream->encryptOID == DESb)
+        return Des_CbcEncrypt(&stream->cipher.des, data, data, sz);
+
+    return Des3_CbcEncrypt(&stream->cipher.des3, data, data, sz);
+}
+
+
+/* start a streamed EnvelopedData, output gets the RecipientInfo and the
+   layers down to the encrypted content */
+int PKCS7_EncodeEnvelopedDataInit(PKCS7* pkcs7, PKCS7Stream* stream,
+                                  byte* output, word32 outputSz)
+{
+    RNG  rng;
+    byte contentKeyPlain[MAX_CONTENT_KEY_LEN];
+    byte iv[DES_BLOCK_SIZE];
+    byte ver[MAX_VERSION_SZ];
+    byte recipSet[MAX_SET_SZ];
+    byte outerContentType[MAX_ALGO_SZ];
+    byte contentType[MAX_ALGO_SZ];
+    byte contentEncAlgo[MAX_ALGO_SZ];
+    byte ivOctetString[MAX_OCTET_STR_SZ];
+#ifdef CYASSL_SMALL_STACK
+    byte* recip;
+    byte* contentKeyEnc;
+#else
+    byte recip[MAX_RECIP_SZ];
+    byte contentKeyEnc[MAX_ENCRYPTED_KEY_SZ];
+#endif
+    int    blockKeySz, contentKeyEncSz, recipSz = 0, ret;
+    word32 verSz = 0, recipSetSz = 0, outerContentTypeSz = 0, contentTypeSz;
+    word32 contentEncAlgoSz = 0, ivOctetStringSz = 0, totalSz, idx = 0;
+
+    if (pkcs7 == NULL || stream == NULL || output == NULL ||
+        pkcs7->encryptOID == 0 || pkcs7->singleCert == NULL)
+        return BAD_FUNC_ARG;
+
+    switch (pkcs7->encryptOID) {
+        case DESb:
+            blockKeySz = DES_KEYLEN;
+            break;
+
+        case DES3b:
+            blockKeySz = DES3_KEYLEN;
+            break;
+
+        default:
+            CYASSL_MSG("Unsupported content cipher type");
+            return ALGO_ID_E;
+    };
+
+    contentTypeSz = SetContentType(pkcs7->contentOID, contentType);
+    if (contentTypeSz == 0)
+        return BAD_FUNC_ARG;
+
+    ret = InitRng(&rng);
+    if (ret != 0)
+        return ret;
+
+#ifdef CYASSL_SMALL_STACK
+    recip         = (byte*)XMALLOC(MAX_RECIP_SZ, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    contentKeyEnc = (byte*)XMALLOC(MAX_ENCRYPTED_KEY_SZ, NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (recip == NULL || contentKeyEnc == NULL)
+        ret = MEMORY_E;
+#endif
+
+    if (ret == 0)
+        ret = RNG_GenerateBlock(&rng, contentKeyPlain, blockKeySz);
+    if (ret == 0)
+        ret = RNG_GenerateBlock(&rng, iv, DES_BLOCK_SIZE);
+    if (ret == 0) {
+        /* only handle 1 RecipientInfo, like the one shot */
+        recipSz = CreateRecipientInfo(pkcs7->singleCert, pkcs7->singleCertSz,
+                                      RSAk, blockKeySz, &rng, contentKeyPlain,
+                                      contentKeyEnc, &contentKeyEncSz, recip,
+                                      MAX_RECIP_SZ);
+        if (recipSz < 0)
+            ret = recipSz;
+    }
+
+    if (ret == 0) {
+        recipSetSz         = SetSet(recipSz, recipSet);
+        verSz              = SetMyVersion(0, ver, 0);
+        outerContentTypeSz = SetContentType(ENVELOPED_DATA, outerContentType);
+        ivOctetStringSz    = SetOctetString(DES_BLOCK_SIZE, ivOctetString);
+        contentEncAlgoSz   = SetAlgoID(pkcs7->encryptOID, contentEncAlgo,
+                                    blkType, ivOctetStringSz + DES_BLOCK_SIZE);
+
+        totalSz = 4 * 2 + outerContentTypeSz + verSz + recipSetSz + recipSz +
+                  contentTypeSz + contentEncAlgoSz + ivOctetStringSz +
+                  DES_BLOCK_SIZE + 2;
+        if (contentEncAlgoSz == 0)
+            ret = BAD_FUNC_ARG;
+        else if (totalSz > outputSz)
+            ret = BUFFER_E;
+    }
+
+    if (ret == 0) {
+        XMEMSET(stream, 0, sizeof(PKCS7Stream));
+        stream->encryptOID = pkcs7->encryptOID;
+        if (pkcs7->encryptOID == DESb)
+            ret = Des_SetKey(&stream->cipher.des, contentKeyPlain, iv,
+                             DES_ENCRYPTION);
+        else
+            ret = Des3_SetKey(&stream->cipher.des3, contentKeyPlain, iv,
+                              DES_ENCRYPTION);
+    }
+
+    if (ret == 0) {
+        idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, output + idx);
+        XMEMCPY(output + idx, outerContentType, outerContentTypeSz);
+        idx += outerContentTypeSz;
+        idx += SetIndefinite(ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0,
+                             output + idx);
+        idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, output + idx);
+        XMEMCPY(output + idx, ver, verSz);
+        idx += verSz;
+        XMEMCPY(output + idx, recipSet, recipSetSz);
+        idx += recipSetSz;
+        XMEMCPY(output + idx, recip, recipSz);
+        idx += recipSz;
+        idx += SetIndefinite(ASN_SEQUENCE | ASN_CONSTRUCTED, output + idx);
+        XMEMCPY(output + idx, contentType, contentTypeSz);
+        idx += contentTypeSz;
+        XMEMCPY(output + idx, contentEncAlgo, contentEncAlgoSz);
+        idx += contentEncAlgoSz;
+        XMEMCPY(output + idx, ivOctetString, ivOctetStringSz);
+        idx += ivOctetStringSz;
+        XMEMCPY(output + idx, iv, DES_BLOCK_SIZE);
+        idx += DES_BLOCK_SIZE;
+        idx += SetIndefinite(ASN_CONSTRUCTED | ASN_CONTEXT_SPECIFIC | 0,
+                             output + idx);
+
+        stream->state = PKCS7_STREAM_ENVELOPE;
+    }
+
+#if defined(HAVE_HASHDRBG) || defined(NO_RC4)
+    FreeRng(&rng);
+#endif
+
+    XMEMSET(contentKeyPlain, 0, MAX_CONTENT_KEY_LEN);
+#ifdef CYASSL_SMALL_STACK
+    if (contentKeyEnc)
+        XMEMSET(contentKeyEnc, 0, MAX_ENCRYPTED_KEY_SZ);
+    XFREE(contentKeyEnc, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(recip,         NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#else
+    XMEMSET(contentKeyEnc, 0, MAX_ENCRYPTED_KEY_SZ);
+#endif
+
+    return (ret == 0) ? (int)idx : ret;
+}
+
+
+/* encrypt in, the whole blocks go out as the next segment and up to a block
+   is held over, output needs inSz + DES_BLOCK_SIZE + MAX_OCTET_STR_SZ */
+int PKCS7_EncodeEnvelopedDataUpdate(PKCS7* pkcs7, PKCS7Stream* stream,
+                                    const byte* in, word32 inSz,
+                                    byte* output, word32 outputSz)
+{
+    byte   octets[MAX_OCTET_STR_SZ];
+    word32 octetsSz, total, whole, fromIn;
+    int    ret;
+
+    if (pkcs7 == NULL || stream == NULL || (in == NULL && inSz != 0) ||
+        output == NULL || stream->state != PKCS7_STREAM_ENVELOPE)
+        return BAD_FUNC_ARG;
+
+    total = stream->carrySz + inSz;
+    if (total < inSz)
+        return BUFFER_E;
+
+    if (total < DES_BLOCK_SIZE) {
+        XMEMCPY(stream->carry + stream->carrySz, in, inSz);
+        stream->carrySz = total;
+        return 0;
+    }
+
+    whole    = total - (total % DES_BLOCK_SIZE);
+    octetsSz = SetOctetString(whole, octets);
+    if (octetsSz + whole < whole || octetsSz + whole > outputSz)
+        return BUFFER_E;
+
+    fromIn = whole - stream->carrySz;
+    XMEMCPY(output, octets, octetsSz);
+    XMEMCPY(output + octetsSz, stream->carry, stream->carrySz);
+    XMEMCPY(output + octetsSz + stream->carrySz, in, fromIn);
+
+    ret = StreamEncrypt(stream, output + octetsSz, whole);
+    if (ret != 0)
+        return ret;
+
+    stream->carrySz = inSz - fromIn;
+    XMEMCPY(stream->carry, in + fromIn, stream->carrySz);
+
+    return octetsSz + whole;
+}
+
+
+/* pad and encrypt the last block and close every layer */
+int PKCS7_EncodeEnvelopedDataFinal(PKCS7* pkcs7, PKCS7Stream* stream,
+                                   byte* output, word32 outputSz)
+{
+    word32 idx, padSz, i;
+    int    ret;
+
+    if (pkcs7 == NULL || stream == NULL || output == NULL ||
+        stream->state != PKCS7_STREAM_ENVELOPE)
+        return BAD_FUNC_ARG;
+
+    if (outputSz < 2 + DES_BLOCK_SIZE + 10)
+        return BUFFER_E;
+
+    /* PKCS#7 padding, always at least one byte */
+    padSz = DES_BLOCK_SIZE - stream->carrySz;
+    for (i = stream->carrySz; i < DES_BLOCK_SIZE; i++)
+        stream->carry[i] = (byte)padSz;
+
+    idx = SetOctetString(DES_BLOCK_SIZE, output);
+    XMEMCPY(output + idx, stream->carry, DES_BLOCK_SIZE);
+    ret = StreamEncrypt(stream, output + idx, DES_BLOCK_SIZE);
+    idx += DES_BLOCK_SIZE;
+
+    /* [0] encryptedContent, EncryptedContentInfo, EnvelopedData, [0] and
+       ContentInfo ends */
+    XMEMSET(output + idx, 0, 10);
+    idx += 10;
+
+    XMEMSET(stream, 0, sizeof(PKCS7Stream));
+
+    return (ret == 0) ? (int)idx : ret;
+}
+
+
+/* free verify state and zero keys, after pkcs7 is done with its cert */
+void PKCS7_StreamFree(PKCS7Stream* stream)
+{
+    if (stream == NULL)
+        return;
+
+    XFREE(stream->trailer, NULL, DYNAMIC_TYPE_PKCS7);
+    XMEMSET(stream, 0, sizeof(PKCS7Stream));
+}
+
+
 #else  /* HAVE_PKCS7 */
 
 
@@ -40,6 +40,9 @@
 #ifdef CHACHA_AEAD_TEST
     #include <stdio.h>
 #endif
+#ifdef POLY1305_X86_SIMD
+    #include <immintrin.h>
+#endif
 
 #ifdef _MSC_VER
     /* 4127 warning constant while(1)  */
@@ -256,6 +259,224 @@ static void poly1305_blocks(Poly1305* ctx, const unsigned char *m,
 }
 
 
+#ifdef POLY1305_X86_SIMD
+
+/* Four blocks per step: lane k of each vector carries one 26 bit limb of
+ * the accumulator for blocks k, k+4, k+8, ..., all multiplied by r^4, and
+ * the last step multiplies the lanes by r^4, r^3, r^2, r before summing
+ * them into h */
+
+#define POLY1305_M26 0x3ffffff
+
+/* 44/44/42 bit (carried) to 26 bit limbs, value unchanged */
+static void Poly1305To26(word32* l, word64 h0, word64 h1, word64 h2)
+{
+	l[0] = (word32)( h0                      ) & POLY1305_M26;
+	l[1] = (word32)((h0 >> 26) | (h1 << 18)) & POLY1305_M26;
+	l[2] = (word32)( h1 >>  8              ) & POLY1305_M26;
+	l[3] = (word32)((h1 >> 34) | (h2 << 10)) & POLY1305_M26;
+	l[4] = (word32)( h2 >> 16              );
+}
+
+
+/* out = a * b, partially reduced mod 2^130 - 5 */
+static void Poly1305Mul26(word32* out, const word32* a, const word32* b)
+{
+	word32 s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5;
+	word64 d0,d1,d2,d3,d4;
+	word32 c;
+
+	d0 = ((word64)a[0] * b[0]) + ((word64)a[1] * s4) + ((word64)a[2] * s3) +
+	     ((word64)a[3] * s2) + ((word64)a[4] * s1);
+	d1 = ((word64)a[0] * b[1]) + ((word64)a[1] * b[0]) + ((word64)a[2] * s4) +
+	     ((word64)a[3] * s3) + ((word64)a[4] * s2);
+	d2 = ((word64)a[0] * b[2]) + ((word64)a[1] * b[1]) + ((word64)a[2] * b[0]) +
+	     ((word64)a[3] * s4) + ((word64)a[4] * s3);
+	d3 = ((word64)a[0] * b[3]) + ((word64)a[1] * b[2]) + ((word64)a[2] * b[1]) +
+	     ((word64)a[3] * b[0]) + ((word64)a[4] * s4);
+	d4 = ((word64)a[0] * b[4]) + ((word64)a[1] * b[3]) + ((word64)a[2] * b[2]) +
+	     ((word64)a[3] * b[1]) + ((word64)a[4] * b[0]);
+
+	              c = (word32)(d0 >> 26); out[0] = (word32)d0 & POLY1305_M26;
+	d1 += c;      c = (word32)(d1 >> 26); out[1] = (word32)d1 & POLY1305_M26;
+	d2 += c;      c = (word32)(d2 >> 26); out[2] = (word32)d2 & POLY1305_M26;
+	d3 += c;      c = (word32)(d3 >> 26); out[3] = (word32)d3 & POLY1305_M26;
+	d4 += c;      c = (word32)(d4 >> 26); out[4] = (word32)d4 & POLY1305_M26;
+	out[0] += c * 5; c = out[0] >> 26;    out[0] &= POLY1305_M26;
+	out[1] += c;
+}
+
+
+/* 4 message blocks as 26 bit limbs, lane k = block k */
+#define AVX2_LOAD_BLOCKS(m) { \
+	__m256i a_ = _mm256_loadu_si256((const __m256i*)(m)); \
+	__m256i b_ = _mm256_loadu_si256((const __m256i*)((m) + 32)); \
+	__m256i lo_ = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a_, b_), \
+	                                       0xd8); \
+	__m256i hi_ = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a_, b_), \
+	                                       0xd8); \
+	m0 = _mm256_and_si256(lo_, mask); \
+	m1 = _mm256_and_si256(_mm256_srli_epi64(lo_, 26), mask); \
+	m2 = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo_, 52), \
+	                      _mm256_slli_epi64(hi_, 12)), mask); \
+	m3 = _mm256_and_si256(_mm256_srli_epi64(hi_, 14), mask); \
+	m4 = _mm256_or_si256(_mm256_srli_epi64(hi_, 40), hibit); \
+}
+
+#define AVX2_MADD(x, y) _mm256_add_epi64(acc_, _mm256_mul_epu32(x, y))
+
+/* d = h * r, no carry */
+#define AVX2_MUL(r0, r1, r2, r3, r4, s1, s2, s3, s4) { \
+	__m256i acc_; \
+	acc_ = _mm256_mul_epu32(h0, r0); acc_ = AVX2_MADD(h1, s4); \
+	acc_ = AVX2_MADD(h2, s3); acc_ = AVX2_MADD(h3, s2); \
+	d0   = AVX2_MADD(h4, s1); \
+	acc_ = _mm256_mul_epu32(h0, r1); acc_ = AVX2_MADD(h1, r0); \
+	acc_ = AVX2_MADD(h2, s4); acc_ = AVX2_MADD(h3, s3); \
+	d1   = AVX2_MADD(h4, s2); \
+	acc_ = _mm256_mul_epu32(h0, r2); acc_ = AVX2_MADD(h1, r1); \
+	acc_ = AVX2_MADD(h2, r0); acc_ = AVX2_MADD(h3, s4); \
+	d2   = AVX2_MADD(h4, s3); \
+	acc_ = _mm256_mul_epu32(h0, r3); acc_ = AVX2_MADD(h1, r2); \
+	acc_ = AVX2_MADD(h2, r1); acc_ = AVX2_MADD(h3, r0); \
+	d3   = AVX2_MADD(h4, s4); \
+	acc_ = _mm256_mul_epu32(h0, r4); acc_ = AVX2_MADD(h1, r3); \
+	acc_ = AVX2_MADD(h2, r2); acc_ = AVX2_MADD(h3, r1); \
+	d4   = AVX2_MADD(h4, r0); \
+}
+
+/* h = d partially reduced, same carry chain as the 32 bit code */
+#define AVX2_CARRY() { \
+	__m256i c_; \
+	c_ = _mm256_srli_epi64(d0, 26); h0 = _mm256_and_si256(d0, mask); \
+	d1 = _mm256_add_epi64(d1, c_); \
+	c_ = _mm256_srli_epi64(d1, 26); h1 = _mm256_and_si256(d1, mask); \
+	d2 = _mm256_add_epi64(d2, c_); \
+	c_ = _mm256_srli_epi64(d2, 26); h2 = _mm256_and_si256(d2, mask); \
+	d3 = _mm256_add_epi64(d3, c_); \
+	c_ = _mm256_srli_epi64(d3, 26); h3 = _mm256_and_si256(d3, mask); \
+	d4 = _mm256_add_epi64(d4, c_); \
+	c_ = _mm256_srli_epi64(d4, 26); h4 = _mm256_and_si256(d4, mask); \
+	h0 = _mm256_add_epi64(h0, _mm256_add_epi64(c_, _mm256_slli_epi64(c_, 2)));\
+	c_ = _mm256_srli_epi64(h0, 26); h0 = _mm256_and_si256(h0, mask); \
+	h1 = _mm256_add_epi64(h1, c_); \
+}
+
+CYASSL_TARGET("avx2")
+static word64 Avx2SumLanes(__m256i v)
+{
+	__m128i s = _mm_add_epi64(_mm256_castsi256_si128(v),
+	                          _mm256_extracti128_si256(v, 1));
+	return (word64)_mm_cvtsi128_si64(_mm_add_epi64(s,
+	                                 _mm_unpackhi_epi64(s, s)));
+}
+
+
+/* absorbs bytes, a multiple of 4 blocks, never the final padded block */
+CYASSL_TARGET("avx2")
+static void poly1305_blocks_avx2(Poly1305* ctx, const unsigned char* m,
+                                 size_t bytes)
+{
+	const __m256i mask  = _mm256_set1_epi64x(POLY1305_M26);
+	const __m256i hibit = _mm256_set1_epi64x(1 << 24); /* 1 << 128 */
+	__m256i r0, r1, r2, r3, r4, s1, s2, s3, s4;
+	__m256i h0, h1, h2, h3, h4, m0, m1, m2, m3, m4;
+	__m256i d0, d1, d2, d3, d4;
+	word32 (*p)[5] = ctx->rPow;
+	word32  h[5];
+	word64  c, v0, v1, v2, v3, v4;
+	word64  g0, g1, g2;
+
+	if (!ctx->rPowSet) {
+		Poly1305To26(p[0], ctx->r[0], ctx->r[1], ctx->r[2]);
+		Poly1305Mul26(p[1], p[0], p[0]);
+		Poly1305Mul26(p[2], p[1], p[0]);
+		Poly1305Mul26(p[3], p[2], p[0]);
+		ctx->rPowSet = 1;
+	}
+
+	/* 44 bit state fully carried then split, value is kept mod p */
+	g0 = ctx->h[0]; g1 = ctx->h[1]; g2 = ctx->h[2];
+	             c = (g0 >> 44); g0 &= 0xfffffffffff;
+	g1 += c;     c = (g1 >> 44); g1 &= 0xfffffffffff;
+	g2 += c;     c = (g2 >> 42); g2 &= 0x3ffffffffff;
+	g0 += c * 5; c = (g0 >> 44); g0 &= 0xfffffffffff;
+	g1 += c;     c = (g1 >> 44); g1 &= 0xfffffffffff;
+	g2 += c;
+	Poly1305To26(h, g0, g1, g2);
+
+	/* lane 0 starts from h, the others from 0 */
+	AVX2_LOAD_BLOCKS(m);
+	h0 = _mm256_add_epi64(m0, _mm256_set_epi64x(0, 0, 0, h[0]));
+	h1 = _mm256_add_epi64(m1, _mm256_set_epi64x(0, 0, 0, h[1]));
+	h2 = _mm256_add_epi64(m2, _mm256_set_epi64x(0, 0, 0, h[2]));
+	h3 = _mm256_add_epi64(m3, _mm256_set_epi64x(0, 0, 0, h[3]));
+	h4 = _mm256_add_epi64(m4, _mm256_set_epi64x(0, 0, 0, h[4]));
+	m     += 4 * POLY1305_BLOCK_SIZE;
+	bytes -= 4 * POLY1305_BLOCK_SIZE;
+
+	r0 = _mm256_set1_epi64x(p[3][0]);
+	r1 = _mm256_set1_epi64x(p[3][1]);
+	r2 = _mm256_set1_epi64x(p[3][2]);
+	r3 = _mm256_set1_epi64x(p[3][3]);
+	r4 = _mm256_set1_epi64x(p[3][4]);
+	s1 = _mm256_set1_epi64x(p[3][1] * 5);
+	s2 = _mm256_set1_epi64x(p[3][2] * 5);
+	s3 = _mm256_set1_epi64x(p[3][3] * 5);
+	s4 = _mm256_set1_epi64x(p[3][4] * 5);
+
+	while (bytes >= 4 * POLY1305_BLOCK_SIZE) {
+		AVX2_MUL(r0, r1, r2, r3, r4, s1, s2, s3, s4);
+		AVX2_CARRY();
+		AVX2_LOAD_BLOCKS(m);
+		h0 = _mm256_add_epi64(h0, m0);
+		h1 = _mm256_add_epi64(h1, m1);
+		h2 = _mm256_add_epi64(h2, m2);
+		h3 = _mm256_add_epi64(h3, m3);
+		h4 = _mm256_add_epi64(h4, m4);
+		m     += 4 * POLY1305_BLOCK_SIZE;
+		bytes -= 4 * POLY1305_BLOCK_SIZE;
+	}
+
+	/* lane k times r^(4-k), then fold the lanes together */
+#define POLY1305_POW(i) _mm256_set_epi64x(p[0][i], p[1][i], p[2][i], p[3][i])
+#define POLY1305_POW5(i) _mm256_set_epi64x(p[0][i] * 5, p[1][i] * 5, \
+                                           p[2][i] * 5, p[3][i] * 5)
+	AVX2_MUL(POLY1305_POW(0), POLY1305_POW(1), POLY1305_POW(2),
+	         POLY1305_POW(3), POLY1305_POW(4), POLY1305_POW5(1),
+	         POLY1305_POW5(2), POLY1305_POW5(3), POLY1305_POW5(4));
+#undef POLY1305_POW
+#undef POLY1305_POW5
+
+	v0 = Avx2SumLanes(d0);
+	v1 = Avx2SumLanes(d1);
+	v2 = Avx2SumLanes(d2);
+	v3 = Avx2SumLanes(d3);
+	v4 = Avx2SumLanes(d4);
+
+	              c = v0 >> 26; v0 &= POLY1305_M26;
+	v1 += c;      c = v1 >> 26; v1 &= POLY1305_M26;
+	v2 += c;      c = v2 >> 26; v2 &= POLY1305_M26;
+	v3 += c;      c = v3 >> 26; v3 &= POLY1305_M26;
+	v4 += c;      c = v4 >> 26; v4 &= POLY1305_M26;
+	v0 += c * 5;  c = v0 >> 26; v0 &= POLY1305_M26;
+	v1 += c;
+
+	/* back to 44/44/42 bits */
+	g0 = v0 + ((v1 & 0x3ffff) << 26);
+	c = g0 >> 44; g0 &= 0xfffffffffff;
+	g1 = c + (v1 >> 18) + (v2 << 8) + ((v3 & 0x3ff) << 34);
+	c = g1 >> 44; g1 &= 0xfffffffffff;
+	g2 = c + (v3 >> 10) + (v4 << 16);
+	c = g2 >> 42; g2 &= 0x3ffffffffff;
+
+	ctx->h[0] = g0 + c * 5;
+	ctx->h[1] = g1;
+	ctx->h[2] = g2;
+}
+
+#endif /* POLY1305_X86_SIMD */
+
 int Poly1305SetKey(Poly1305* ctx, const byte* key, word32 keySz) {
 
 #if defined(POLY130564)
@@ -321,6 +542,9 @@ int Poly1305SetKey(Poly1305* ctx, const byte* key, word32 keySz) {
 
 	ctx->leftover = 0;
 	ctx->final = 0;
+#ifdef POLY1305_X86_SIMD
+	ctx->rPowSet = 0;
+#endif
 
     return 0;
 }
@@ -413,6 +637,10 @@ int Poly1305Final(Poly1305* ctx, byte* mac) {
 	ctx->r[2] = 0;
 	ctx->pad[0] = 0;
 	ctx->pad[1] = 0;
+#ifdef POLY1305_X86_SIMD
+	XMEMSET(ctx->rPow, 0, sizeof(ctx->rPow));
+	ctx->rPowSet = 0;
+#endif
 
 #else /* if not 64 bit then use 32 bit */
     
@@ -537,6 +765,16 @@ int Poly1305Update(Poly1305* ctx, const byte* m, word32 bytes) {
 	/* process full blocks */
 	if (bytes >= POLY1305_BLOCK_SIZE) {
 		size_t want = (bytes & ~(POLY1305_BLOCK_SIZE - 1));
+#ifdef POLY1305_X86_SIMD
+		if ((CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2) &&
+		                                want >= 4 * POLY1305_BLOCK_SIZE) {
+			size_t vec = want & ~(4 * POLY1305_BLOCK_SIZE - 1);
+			poly1305_blocks_avx2(ctx, m, vec);
+			m += vec;
+			bytes -= vec;
+			want -= vec;
+		}
+#endif
 		poly1305_blocks(ctx, m, want);
 		m += want;
 		bytes -= want;
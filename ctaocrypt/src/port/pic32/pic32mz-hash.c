@@ -28,6 +28,7 @@
 #ifdef CYASSL_PIC32MZ_HASH
 
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/md5.h>
 #include <cyassl/ctaocrypt/sha.h>
 #include <cyassl/ctaocrypt/sha256.h>
@@ -39,6 +40,7 @@
 static void reset_engine(pic32mz_desc *desc_l, int algo)
 {
     pic32mz_desc *desc ;
+    int i ;
     desc = KVA0_TO_KVA1(desc_l) ;
 
     CECON = 1 << 6;
@@ -46,8 +48,7 @@ static void reset_engine(pic32mz_desc *desc_l, int algo)
 
     /* Make sure everything is clear first before we make settings. */
     XMEMSET((void *)KVA0_TO_KVA1(&desc->sa), 0, sizeof(desc->sa));
-    XMEMSET((void *)KVA0_TO_KVA1(&desc->bd[0]), 0, sizeof(desc->bd[0]));
-    XMEMSET((void *)KVA0_TO_KVA1(&desc->bd[1]), 0, sizeof(desc->bd[1]));
+    XMEMSET((void *)KVA0_TO_KVA1(&desc->bd[0]), 0, sizeof(desc->bd));
 
     /* Set up the security association */
     desc->sa.SA_CTRL.ALGO = algo ;
@@ -56,14 +57,13 @@ static void reset_engine(pic32mz_desc *desc_l, int algo)
     desc->sa.SA_CTRL.ENCTYPE = 1;
     desc->sa.SA_CTRL.LOADIV = 1;
 
-    /* Set up the buffer descriptor */
+    /* Set up the buffer descriptors */
     desc->err = 0 ;
-    desc->bd[0].BD_CTRL.LAST_BD = 1;
-    desc->bd[0].BD_CTRL.LIFM = 1;
-    desc->bd[0].SA_ADDR = KVA_TO_PA(&desc->sa);
-    desc->bd[1].BD_CTRL.LAST_BD = 1;
-    desc->bd[1].BD_CTRL.LIFM = 1;
-    desc->bd[1].SA_ADDR = KVA_TO_PA(&desc->sa);
+    for (i = 0; i < PIC32MZ_MAX_BD; i++) {
+        desc->bd[i].BD_CTRL.LAST_BD = 1;
+        desc->bd[i].BD_CTRL.LIFM = 1;
+        desc->bd[i].SA_ADDR = KVA_TO_PA(&desc->sa);
+    }
     desc_l->bdCount = 0 ;
     CEBDPADDR = KVA_TO_PA(&(desc->bd[0]));
 
@@ -72,11 +72,12 @@ static void reset_engine(pic32mz_desc *desc_l, int algo)
 
 #define PIC32MZ_IF_RAM(addr) (KVA_TO_PA(addr) < 0x80000)
 
-static void update_engine(pic32mz_desc *desc_l, const char *input, word32 len,
+/* chain one more buffer onto the job Final starts */
+static void chain_engine(pic32mz_desc *desc_l, const char *input, word32 len,
                     word32 *hash)
 {
     pic32mz_desc *desc ;
-    int i ;
+    int i, j ;
     int total ;
     desc = KVA0_TO_KVA1(desc_l) ;
 
@@ -103,8 +104,8 @@ static void update_engine(pic32mz_desc *desc_l, const char *input, word32 len,
         desc->bd[i-1].BD_CTRL.LAST_BD = 0 ;
         desc->bd[i-1].BD_CTRL.LIFM    = 0 ;
         total = desc->bd[i-1].MSGLEN + len ;
-        desc->bd[i].MSGLEN = total ;
-        desc->bd[i-1].MSGLEN = total ;
+        for (j = 0; j <= i; j++)     /* every descriptor has the total */
+            desc->bd[j].MSGLEN = total ;
     }
     desc->bd[i].UPDPTR = KVA_TO_PA(hash);
     desc_l->bdCount ++ ;
@@ -115,6 +116,17 @@ static void update_engine(pic32mz_desc *desc_l, const char *input, word32 len,
     #endif
 }
 
+static void update_engine(pic32mz_desc *desc_l, const char *input, word32 len,
+                    word32 *hash)
+{
+    while (len > PIC32MZ_MAX_BUFLEN) {
+        chain_engine(desc_l, input, PIC32MZ_MAX_BUFLEN, hash) ;
+        input += PIC32MZ_MAX_BUFLEN ;
+        len   -= PIC32MZ_MAX_BUFLEN ;
+    }
+    chain_engine(desc_l, input, len, hash) ;
+}
+
 static void start_engine(pic32mz_desc *desc) {
     bufferDescriptor *hash_bd[2] ;
     hash_bd[0] = (bufferDescriptor *)KVA0_TO_KVA1(&(desc->bd[0])) ;
@@ -206,6 +218,10 @@ int ShaUpdate(Sha* sha, const byte* data, word32 len)
 int ShaFinal(Sha* sha, byte* hash)
 {
     CYASSL_ENTER("ShaFinal\n") ;
+    if (sha->desc.err) {        /* more updates than PIC32MZ_MAX_BD */
+        InitSha(sha);
+        return BUFFER_E;
+    }
     start_engine(&(sha->desc)) ;
     wait_engine(&(sha->desc), (char *)sha->digest, SHA1_HASH_SIZE) ;
     XMEMCPY(hash, sha->digest, SHA1_HASH_SIZE) ;
@@ -236,6 +252,10 @@ int Sha256Update(Sha256* sha256, const byte* data, word32 len)
 int Sha256Final(Sha256* sha256, byte* hash)
 {
     CYASSL_ENTER("Sha256Final\n") ;
+    if (sha256->desc.err) {     /* more updates than PIC32MZ_MAX_BD */
+        InitSha256(sha256);
+        return BUFFER_E;
+    }
     start_engine(&(sha256->desc)) ;
     wait_engine(&(sha256->desc), (char *)sha256->digest, SHA256_HASH_SIZE) ;
     XMEMCPY(hash, sha256->digest, SHA256_HASH_SIZE) ;
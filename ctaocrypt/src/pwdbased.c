@@ -117,95 +117,240 @@ int PBKDF1(byte* output, const byte* passwd, int pLen, const byte* salt,
 }
 
 
+static int PBKDF2_HashSize(int hashType)
+{
+    if (hashType == MD5)
+        return MD5_DIGEST_SIZE;
+    if (hashType == SHA)
+        return SHA_DIGEST_SIZE;
+#ifndef NO_SHA256
+    if (hashType == SHA256)
+        return SHA256_DIGEST_SIZE;
+#endif
+#ifdef CYASSL_SHA512
+    if (hashType == SHA512)
+        return SHA512_DIGEST_SIZE;
+#endif
+
+    return BAD_FUNC_ARG;
+}
+
+
+/* U1 = HMAC(P, S || INT(i)) into t */
+static int PBKDF2_First(Hmac* hmac, const byte* salt, int sLen, word32 i,
+                        byte* t)
+{
+    byte count[4];
+    int  ret;
+
+    count[0] = (byte)(i >> 24);
+    count[1] = (byte)(i >> 16);
+    count[2] = (byte)(i >>  8);
+    count[3] = (byte)i;
+
+    ret = HmacUpdate(hmac, salt, sLen);
+    if (ret == 0)
+        ret = HmacUpdate(hmac, count, sizeof(count));
+    if (ret == 0)
+        ret = HmacFinal(hmac, t);
+
+    return ret;
+}
+
+
+/* U2 .. Uc xor'd into t, which holds U1, u is hLen of scratch */
+static int PBKDF2_Chain(Hmac* hmac, byte* t, byte* u, int hLen,
+                        int iterations)
+{
+    int j, ret = 0;
+
+    XMEMCPY(u, t, hLen);
+
+    for (j = 1; j < iterations; j++) {
+        ret = HmacUpdate(hmac, u, hLen);
+        if (ret != 0)
+            break;
+        ret = HmacFinal(hmac, u);
+        if (ret != 0)
+            break;
+        xorbuf(t, u, hLen);
+    }
+
+    return ret;
+}
+
+
 int PBKDF2(byte* output, const byte* passwd, int pLen, const byte* salt,
            int sLen, int iterations, int kLen, int hashType)
 {
-    word32 i = 1;
-    int    hLen;
-    int    j, ret;
-    Hmac   hmac;
+    word32    i = 1;
+    int       hLen;
+    int       ret;
+    Hmac      hmac;
 #ifdef CYASSL_SMALL_STACK
-    byte*  buffer;
+    HmacState* state;
+    byte*     buffer;
 #else
-    byte   buffer[MAX_DIGEST_SIZE];
+    HmacState state[1];
+    byte      buffer[2 * MAX_DIGEST_SIZE];
 #endif
 
-    if (hashType == MD5) {
-        hLen = MD5_DIGEST_SIZE;
+    hLen = PBKDF2_HashSize(hashType);
+    if (hLen < 0)
+        return hLen;
+
+#ifdef CYASSL_SMALL_STACK
+    state  = (HmacState*)XMALLOC(sizeof(HmacState), NULL,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    buffer = (byte*)XMALLOC(2 * MAX_DIGEST_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (state == NULL || buffer == NULL) {
+        XFREE(state,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(buffer, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E;
     }
-    else if (hashType == SHA) {
-        hLen = SHA_DIGEST_SIZE;
+#endif
+
+    /* pads hashed once, every iteration then starts from the keyed states */
+    ret = HmacInitKeyedState(state, hashType, passwd, pLen);
+    if (ret == 0)
+        ret = HmacCloneState(&hmac, state);
+
+    while (ret == 0 && kLen) {
+        int currentLen = min(kLen, hLen);
+
+        ret = PBKDF2_First(&hmac, salt, sLen, i, buffer);
+        if (ret == 0)
+            ret = PBKDF2_Chain(&hmac, buffer, buffer + MAX_DIGEST_SIZE, hLen,
+                               iterations);
+        if (ret != 0)
+            break;
+
+        XMEMCPY(output, buffer, currentLen);
+
+        output += currentLen;
+        kLen   -= currentLen;
+        i++;
     }
+
+    XMEMSET(state, 0, sizeof(HmacState));
+    XMEMSET(&hmac, 0, sizeof(Hmac));
+    XMEMSET(buffer, 0, 2 * MAX_DIGEST_SIZE);
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(state,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(buffer, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+#define PBKDF2_MULTI_GROUP 8    /* derivations in flight, one per SIMD lane */
+
+/* count independent PBKDF2 derivations sharing iterations, kLen and hash.
+ * HMAC-SHA256 chains run side by side in SIMD lanes when the cpu has them,
+ * others or without lanes each derivation runs on its own keyed state. */
+int PBKDF2Multi(byte** output, const byte** passwd, const int* pLen,
+                const byte** salt, const int* sLen, int iterations, int kLen,
+                int hashType, int count)
+{
+    int        hLen, n, g, k, done;
+    int        ret = 0;
+    word32     i;
+    Hmac       hmac;
+    byte*      t[PBKDF2_MULTI_GROUP];
 #ifndef NO_SHA256
-    else if (hashType == SHA256) {
-        hLen = SHA256_DIGEST_SIZE;
-    }
+    const word32* inner[PBKDF2_MULTI_GROUP];
+    const word32* outer[PBKDF2_MULTI_GROUP];
 #endif
-#ifdef CYASSL_SHA512
-    else if (hashType == SHA512) {
-        hLen = SHA512_DIGEST_SIZE;
-    }
+#ifdef CYASSL_SMALL_STACK
+    HmacState* state;
+    byte*      buffer;
+#else
+    HmacState  state[PBKDF2_MULTI_GROUP];
+    byte       buffer[(PBKDF2_MULTI_GROUP + 1) * MAX_DIGEST_SIZE];
 #endif
-    else
+
+    if (count < 0 || iterations < 1 || kLen < 0 ||
+        (count > 0 && (output == NULL || passwd == NULL || pLen == NULL ||
+                       salt == NULL || sLen == NULL)))
         return BAD_FUNC_ARG;
 
+    hLen = PBKDF2_HashSize(hashType);
+    if (hLen < 0)
+        return hLen;
+
+    for (k = 0; k < count; k++) {
+        if (output[k] == NULL || (passwd[k] == NULL && pLen[k] != 0) ||
+                                 (salt[k] == NULL && sLen[k] != 0))
+            return BAD_FUNC_ARG;
+    }
+
 #ifdef CYASSL_SMALL_STACK
-    buffer = (byte*)XMALLOC(MAX_DIGEST_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-    if (buffer == NULL)
+    state  = (HmacState*)XMALLOC(PBKDF2_MULTI_GROUP * sizeof(HmacState), NULL,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    buffer = (byte*)XMALLOC((PBKDF2_MULTI_GROUP + 1) * MAX_DIGEST_SIZE, NULL,
+                            DYNAMIC_TYPE_TMP_BUFFER);
+    if (state == NULL || buffer == NULL) {
+        XFREE(state,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(buffer, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         return MEMORY_E;
+    }
 #endif
 
-    ret = HmacSetKey(&hmac, hashType, passwd, pLen);
+    for (k = 0; k < PBKDF2_MULTI_GROUP; k++)
+        t[k] = buffer + (k + 1) * MAX_DIGEST_SIZE;
 
-    if (ret == 0) {
-        while (kLen) {
-            int currentLen;
+    for (g = 0; g < count && ret == 0; g += n) {
+        n = min(count - g, PBKDF2_MULTI_GROUP);
 
-            ret = HmacUpdate(&hmac, salt, sLen);
-            if (ret != 0)
-                break;
+        for (k = 0; k < n && ret == 0; k++) {
+            ret = HmacInitKeyedState(&state[k], hashType, passwd[g + k],
+                                     pLen[g + k]);
+        #ifndef NO_SHA256
+            inner[k] = state[k].inner.sha256.digest;
+            outer[k] = state[k].outer.sha256.digest;
+        #endif
+        }
 
-            /* encode i */
-            for (j = 0; j < 4; j++) {
-                byte b = (byte)(i >> ((3-j) * 8));
+        for (i = 1, done = 0; ret == 0 && done < kLen; i++) {
+            int currentLen = min(kLen - done, hLen);
+            int chained    = 0;
 
-                ret = HmacUpdate(&hmac, &b, 1);
-                if (ret != 0)
-                    break;
+            for (k = 0; k < n && ret == 0; k++) {
+                ret = HmacCloneState(&hmac, &state[k]);
+                if (ret == 0)
+                    ret = PBKDF2_First(&hmac, salt[g + k], sLen[g + k], i,
+                                       t[k]);
             }
-
-            /* check ret from inside for loop */
             if (ret != 0)
                 break;
 
-            ret = HmacFinal(&hmac, buffer);
-            if (ret != 0)
-                break;
-
-            currentLen = min(kLen, hLen);
-            XMEMCPY(output, buffer, currentLen);
+        #ifndef NO_SHA256
+            if (hashType == SHA256 &&
+                    Sha256PbkdfMulti(inner, outer, t, iterations, n) == 0)
+                chained = 1;
+        #endif
 
-            for (j = 1; j < iterations; j++) {
-                ret = HmacUpdate(&hmac, buffer, hLen);
-                if (ret != 0)
-                    break;
-                ret = HmacFinal(&hmac, buffer);
-                if (ret != 0)
-                    break;
-                xorbuf(output, buffer, currentLen);
+            for (k = 0; k < n && !chained && ret == 0; k++) {
+                ret = HmacCloneState(&hmac, &state[k]);
+                if (ret == 0)
+                    ret = PBKDF2_Chain(&hmac, t[k], buffer, hLen, iterations);
             }
 
-            /* check ret from inside for loop */
-            if (ret != 0)
-                break;
+            for (k = 0; k < n && ret == 0; k++)
+                XMEMCPY(output[g + k] + done, t[k], currentLen);
 
-            output += currentLen;
-            kLen   -= currentLen;
-            i++;
+            done += currentLen;
         }
     }
 
+    XMEMSET(state, 0, PBKDF2_MULTI_GROUP * sizeof(HmacState));
+    XMEMSET(&hmac, 0, sizeof(Hmac));
+    XMEMSET(buffer, 0, (PBKDF2_MULTI_GROUP + 1) * MAX_DIGEST_SIZE);
+
 #ifdef CYASSL_SMALL_STACK
+    XFREE(state,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
     XFREE(buffer, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
 
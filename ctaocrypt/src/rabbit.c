@@ -30,6 +30,7 @@
 #include <cyassl/ctaocrypt/rabbit.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #ifdef NO_INLINE
     #include <cyassl/ctaocrypt/misc.h>
 #else
@@ -45,6 +46,16 @@
 
 #define U32V(x) ((word32)(x) & 0xFFFFFFFFU)
 
+/* SSE2 is baseline on x86_64, NEON on aarch64, neither needs a target */
+#if defined(HAVE_CYASSL_X86_SIMD)
+    #define RABBIT_SSE2
+    #include <emmintrin.h>
+#elif defined(HAVE_CYASSL_CPUID) && defined(__aarch64__) && \
+      !defined(BIG_ENDIAN_ORDER)
+    #define RABBIT_NEON
+    #include <arm_neon.h>
+#endif
+
 
 /* Square a 32-bit unsigned integer to obtain the 64-bit result and return */
 /* the upper 32 bits XOR the lower 32 bits */
@@ -66,11 +77,11 @@ static word32 RABBIT_g_func(word32 x)
 }
 
 
-/* Calculate the next internal state */
-static void RABBIT_next_state(RabbitCtx* ctx)
+/* Calculate the next counter values, a serial carry chain */
+static INLINE void RABBIT_next_counters(RabbitCtx* ctx)
 {
     /* Temporary variables */
-    word32 g[8], c_old[8], i;
+    word32 c_old[8], i;
 
     /* Save old counter values */
     for (i=0; i<8; i++)
@@ -86,7 +97,17 @@ static void RABBIT_next_state(RabbitCtx* ctx)
     ctx->c[6] = U32V(ctx->c[6] + 0x4D34D34D + (ctx->c[5] < c_old[5]));
     ctx->c[7] = U32V(ctx->c[7] + 0xD34D34D3 + (ctx->c[6] < c_old[6]));
     ctx->carry = (ctx->c[7] < c_old[7]);
-   
+}
+
+
+/* Calculate the next internal state */
+static void RABBIT_next_state(RabbitCtx* ctx)
+{
+    /* Temporary variables */
+    word32 g[8], i;
+
+    RABBIT_next_counters(ctx);
+
     /* Calculate the g-values */
     for (i=0;i<8;i++)
         g[i] = RABBIT_g_func(U32V(ctx->x[i] + ctx->c[i]));
@@ -218,10 +239,183 @@ int RabbitSetKey(Rabbit* ctx, const byte* key, const byte* iv)
 }
 
 
+#ifdef RABBIT_SSE2
+
+/* The state is kept in two registers across the whole message, even words
+ * E = x0,x2,x4,x6 and odd words O = x1,x3,x5,x7, so the g-values and the
+ * rotated sums of the next state are four lanes at a time. Only the
+ * counters stay scalar, their carry chain runs word to word. */
+
+#define RABBIT_ROTL(v, n) \
+    _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+/* high XOR low half of the 64-bit square, per 32-bit lane */
+static INLINE __m128i RabbitGSse2(__m128i v)
+{
+    const __m128i lo = _mm_set_epi32(0, -1, 0, -1);
+    __m128i even = _mm_mul_epu32(v, v);
+    __m128i odd  = _mm_srli_epi64(v, 32);
+
+    odd  = _mm_mul_epu32(odd, odd);
+    even = _mm_xor_si128(even, _mm_srli_epi64(even, 32));
+    odd  = _mm_xor_si128(odd,  _mm_srli_epi64(odd,  32));
+
+    return _mm_or_si128(_mm_and_si128(even, lo), _mm_slli_epi64(odd, 32));
+}
+
+
+/* split words 0..7 at w into even and odd lanes */
+static INLINE void RabbitLoadSse2(const word32* w, __m128i* e, __m128i* o)
+{
+    __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)w));
+    __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(w + 4)));
+
+    *e = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    *o = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+
+static void RabbitProcessSse2(RabbitCtx* ctx, byte* output,
+                              const byte* input, word32 msglen)
+{
+    __m128i xe, xo, ce, co, ge, go, ge1, go1, ks;
+
+    RabbitLoadSse2(ctx->x, &xe, &xo);
+
+    while (msglen) {
+        RABBIT_next_counters(ctx);
+        RabbitLoadSse2(ctx->c, &ce, &co);
+
+        ge = RabbitGSse2(_mm_add_epi32(xe, ce));
+        go = RabbitGSse2(_mm_add_epi32(xo, co));
+
+        /* g[i-2] and g[i-1] for each even i, lanes moved up by one */
+        ge1 = _mm_shuffle_epi32(ge, _MM_SHUFFLE(2, 1, 0, 3));
+        go1 = _mm_shuffle_epi32(go, _MM_SHUFFLE(2, 1, 0, 3));
+
+        xe = _mm_add_epi32(_mm_add_epi32(ge, RABBIT_ROTL(go1, 16)),
+                           RABBIT_ROTL(ge1, 16));
+        xo = _mm_add_epi32(_mm_add_epi32(go, RABBIT_ROTL(ge, 8)), go1);
+
+        /* s[i] = x[2i] ^ (x[2i+5] >> 16) ^ (x[2i+3] << 16) */
+        ks = _mm_xor_si128(xe, _mm_srli_epi32(
+                 _mm_shuffle_epi32(xo, _MM_SHUFFLE(1, 0, 3, 2)), 16));
+        ks = _mm_xor_si128(ks, _mm_slli_epi32(
+                 _mm_shuffle_epi32(xo, _MM_SHUFFLE(0, 3, 2, 1)), 16));
+
+        if (msglen >= 16) {
+            _mm_storeu_si128((__m128i*)output, _mm_xor_si128(ks,
+                              _mm_loadu_si128((const __m128i*)input)));
+            input  += 16;
+            output += 16;
+            msglen -= 16;
+        }
+        else {
+            /* a partial block uses up the whole block, as the C code */
+            byte   buffer[16];
+            word32 i;
+
+            _mm_storeu_si128((__m128i*)buffer, ks);
+            for (i = 0; i < msglen; i++)
+                output[i] = input[i] ^ buffer[i];
+            msglen = 0;
+        }
+    }
+
+    _mm_storeu_si128((__m128i*)ctx->x,       _mm_unpacklo_epi32(xe, xo));
+    _mm_storeu_si128((__m128i*)(ctx->x + 4), _mm_unpackhi_epi32(xe, xo));
+}
+
+#endif /* RABBIT_SSE2 */
+
+
+#ifdef RABBIT_NEON
+
+/* same layout as the SSE2 code, vld2q splits the even and odd words */
+
+#define RABBIT_ROTL(v, n) vsliq_n_u32(vshrq_n_u32(v, 32 - (n)), v, n)
+#define RABBIT_ROTL16(v) \
+    vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+
+static INLINE uint32x4_t RabbitGNeon(uint32x4_t v)
+{
+    uint64x2_t lo = vmull_u32(vget_low_u32(v),  vget_low_u32(v));
+    uint64x2_t hi = vmull_u32(vget_high_u32(v), vget_high_u32(v));
+
+    lo = veorq_u64(lo, vshrq_n_u64(lo, 32));
+    hi = veorq_u64(hi, vshrq_n_u64(hi, 32));
+
+    return vcombine_u32(vmovn_u64(lo), vmovn_u64(hi));
+}
+
+
+static void RabbitProcessNeon(RabbitCtx* ctx, byte* output,
+                              const byte* input, word32 msglen)
+{
+    uint32x4x2_t x = vld2q_u32(ctx->x);
+    uint32x4x2_t c;
+    uint32x4_t   ge, go, ge1, go1, ks;
+
+    while (msglen) {
+        RABBIT_next_counters(ctx);
+        c = vld2q_u32(ctx->c);
+
+        ge = RabbitGNeon(vaddq_u32(x.val[0], c.val[0]));
+        go = RabbitGNeon(vaddq_u32(x.val[1], c.val[1]));
+
+        ge1 = vextq_u32(ge, ge, 3);
+        go1 = vextq_u32(go, go, 3);
+
+        x.val[0] = vaddq_u32(vaddq_u32(ge, RABBIT_ROTL16(go1)),
+                             RABBIT_ROTL16(ge1));
+        x.val[1] = vaddq_u32(vaddq_u32(go, RABBIT_ROTL(ge, 8)), go1);
+
+        ks = veorq_u32(x.val[0],
+                       vshrq_n_u32(vextq_u32(x.val[1], x.val[1], 2), 16));
+        ks = veorq_u32(ks,
+                       vshlq_n_u32(vextq_u32(x.val[1], x.val[1], 1), 16));
+
+        if (msglen >= 16) {
+            vst1q_u8(output, veorq_u8(vld1q_u8(input),
+                                      vreinterpretq_u8_u32(ks)));
+            input  += 16;
+            output += 16;
+            msglen -= 16;
+        }
+        else {
+            byte   buffer[16];
+            word32 i;
+
+            vst1q_u8(buffer, vreinterpretq_u8_u32(ks));
+            for (i = 0; i < msglen; i++)
+                output[i] = input[i] ^ buffer[i];
+            msglen = 0;
+        }
+    }
+
+    vst2q_u32(ctx->x, x);
+}
+
+#endif /* RABBIT_NEON */
+
+
 /* Encrypt/decrypt a message of any size */
 static INLINE int DoProcess(Rabbit* ctx, byte* output, const byte* input,
                             word32 msglen)
 {
+#ifdef RABBIT_SSE2
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_SSE2) {
+        RabbitProcessSse2(&ctx->workCtx, output, input, msglen);
+        return 0;
+    }
+#endif
+#ifdef RABBIT_NEON
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_ARM_NEON) {
+        RabbitProcessNeon(&ctx->workCtx, output, input, msglen);
+        return 0;
+    }
+#endif
+
     /* Encrypt/decrypt all full blocks */
     while (msglen >= 16) {
         /* Iterate the system */
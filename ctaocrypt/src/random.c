@@ -37,10 +37,17 @@
 
 #include <cyassl/ctaocrypt/random.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 
 #if defined(HAVE_HASHDRBG) || defined(NO_RC4)
 
-    #include <cyassl/ctaocrypt/sha256.h>
+    #ifdef HAVE_CTRDRBG
+        #include <cyassl/ctaocrypt/aes.h>
+    #else
+        #include <cyassl/ctaocrypt/sha256.h>
+    #endif
 
     #ifdef NO_INLINE
         #include <cyassl/ctaocrypt/misc.h>
@@ -72,7 +79,11 @@
 
 /* Start NIST DRBG code */
 
-#define OUTPUT_BLOCK_LEN  (SHA256_DIGEST_SIZE)
+#ifdef HAVE_CTRDRBG
+    #define OUTPUT_BLOCK_LEN  (AES_BLOCK_SIZE)
+#else
+    #define OUTPUT_BLOCK_LEN  (SHA256_DIGEST_SIZE)
+#endif
 #define MAX_REQUEST_LEN   (0x10000)
 #define RESEED_INTERVAL   (1000000)
 #define SECURITY_STRENGTH (256)
@@ -94,6 +105,20 @@
 #define DRBG_CONT_FAILED  3
 
 
+static INLINE void array_add_one(byte* data, word32 dataSz)
+{
+    int i;
+
+    for (i = dataSz - 1; i >= 0; i--)
+    {
+        data[i]++;
+        if (data[i] != 0) break;
+    }
+}
+
+
+#ifndef HAVE_CTRDRBG
+
 enum {
     drbgInitC     = 0,
     drbgReseed    = 1,
@@ -196,18 +221,6 @@ static int Hash_DRBG_Reseed(DRBG* drbg, const byte* entropy, word32 entropySz)
     return DRBG_SUCCESS;
 }
 
-static INLINE void array_add_one(byte* data, word32 dataSz)
-{
-    int i;
-
-    for (i = dataSz - 1; i >= 0; i--)
-    {
-        data[i]++;
-        if (data[i] != 0) break;
-    }
-}
-
-
 /* Returns: DRBG_SUCCESS or DRBG_FAILURE */
 static int Hash_gen(DRBG* drbg, byte* out, word32 outSz, const byte* V)
 {
@@ -357,12 +370,402 @@ static int Hash_DRBG_Uninstantiate(DRBG* drbg)
     return DRBG_SUCCESS;
 }
 
+#else /* HAVE_CTRDRBG */
+
+/* CTR_DRBG with AES-256 and no derivation function, so seeds are full
+ * entropy of exactly CTR_SEED_LEN bytes. AesSetKey() picks up AES-NI where
+ * the CPU has it, each output block is one AES encrypt instead of a SHA-256
+ * compression. */
+
+#define CTR_KEY_LEN   (SECURITY_STRENGTH/8)
+#define CTR_SEED_LEN  (CTR_KEY_LEN+AES_BLOCK_SIZE)
+
+
+typedef struct DRBG {
+    Aes    aes;                 /* keyed with the DRBG Key */
+    byte   V[AES_BLOCK_SIZE];
+    byte   block[AES_BLOCK_SIZE];
+    word32 reseedCtr;
+    word32 lastBlock;
+    byte   matchCount;
+} DRBG;
+
+
+/* CTR_DRBG_Update, provided is CTR_SEED_LEN bytes, or NULL for all zeros */
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int Ctr_update(DRBG* drbg, const byte* provided)
+{
+    byte temp[CTR_SEED_LEN];
+    int  i;
+    int  ret;
+
+    for (i = 0; i < CTR_SEED_LEN; i += AES_BLOCK_SIZE) {
+        array_add_one(drbg->V, AES_BLOCK_SIZE);
+        AesEncryptDirect(&drbg->aes, temp + i, drbg->V);
+    }
+
+    if (provided != NULL)
+        xorbuf(temp, provided, CTR_SEED_LEN);
+
+    ret = AesSetKey(&drbg->aes, temp, CTR_KEY_LEN, NULL, AES_ENCRYPTION);
+    XMEMCPY(drbg->V, temp + CTR_KEY_LEN, AES_BLOCK_SIZE);
+    XMEMSET(temp, 0, sizeof(temp));
+
+    return (ret == 0) ? DRBG_SUCCESS : DRBG_FAILURE;
+}
+
+
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int Ctr_DRBG_Reseed(DRBG* drbg, const byte* entropy, word32 entropySz)
+{
+    if (entropySz != CTR_SEED_LEN || Ctr_update(drbg, entropy) != DRBG_SUCCESS)
+        return DRBG_FAILURE;
+
+    drbg->reseedCtr = 1;
+    drbg->lastBlock = 0;
+    drbg->matchCount = 0;
+    return DRBG_SUCCESS;
+}
+
+
+/* Returns: DRBG_SUCCESS or DRBG_CONT_FAILURE */
+static int Ctr_gen(DRBG* drbg, byte* out, word32 outSz)
+{
+    byte*  block;
+    word32 checkBlock;
+
+    /* Special case: outSz is 0 and out is NULL. Generate a block to save for
+     * the continuous test. */
+
+    if (outSz == 0) outSz = 1;
+
+    while (outSz > 0) {
+        /* whole blocks go straight to the caller */
+        block = (out != NULL && outSz >= OUTPUT_BLOCK_LEN) ? out : drbg->block;
+
+        array_add_one(drbg->V, AES_BLOCK_SIZE);
+        AesEncryptDirect(&drbg->aes, block, drbg->V);
+
+        XMEMCPY(&checkBlock, block, sizeof(checkBlock));
+        if (drbg->reseedCtr > 1 && checkBlock == drbg->lastBlock) {
+            if (drbg->matchCount == 1) {
+                XMEMSET(drbg->block, 0, sizeof(drbg->block));
+                return DRBG_CONT_FAILURE;
+            }
+            drbg->matchCount = 1;
+        }
+        else {
+            drbg->matchCount = 0;
+            drbg->lastBlock = checkBlock;
+        }
+
+        if (outSz >= OUTPUT_BLOCK_LEN) {
+            outSz -= OUTPUT_BLOCK_LEN;
+            if (out != NULL)
+                out += OUTPUT_BLOCK_LEN;
+        }
+        else {
+            if (out != NULL)
+                XMEMCPY(out, drbg->block, outSz);
+            outSz = 0;
+        }
+    }
+    XMEMSET(drbg->block, 0, sizeof(drbg->block));
+
+    return DRBG_SUCCESS;
+}
+
+
+/* Returns: DRBG_SUCCESS, DRBG_NEED_RESEED, DRBG_CONT_FAILURE, or
+ * DRBG_FAILURE */
+static int Ctr_DRBG_Generate(DRBG* drbg, byte* out, word32 outSz)
+{
+    int ret = DRBG_NEED_RESEED;
+
+    if (drbg->reseedCtr != RESEED_INTERVAL) {
+        ret = Ctr_gen(drbg, out, outSz);
+        if (ret == DRBG_SUCCESS) {
+            ret = Ctr_update(drbg, NULL);
+            drbg->reseedCtr++;
+        }
+    }
+
+    return ret;
+}
+
+
+/* No derivation function, so no nonce, the seed is all entropy */
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int Ctr_DRBG_Instantiate(DRBG* drbg, const byte* seed, word32 seedSz,
+                                            const byte* nonce, word32 nonceSz)
+{
+    byte key[CTR_KEY_LEN];
+    int  ret = DRBG_FAILURE;
+
+    (void)nonce;
+
+    XMEMSET(drbg, 0, sizeof(DRBG));
+    XMEMSET(key, 0, sizeof(key));
+
+    if (seedSz == CTR_SEED_LEN && nonceSz == 0 &&
+        AesSetKey(&drbg->aes, key, CTR_KEY_LEN, NULL, AES_ENCRYPTION) == 0 &&
+        Ctr_update(drbg, seed) == DRBG_SUCCESS) {
+
+        drbg->reseedCtr = 1;
+        drbg->lastBlock = 0;
+        drbg->matchCount = 0;
+        ret = DRBG_SUCCESS;
+    }
+
+    return ret;
+}
+
+
+/* Returns: DRBG_SUCCESS */
+static int Ctr_DRBG_Uninstantiate(DRBG* drbg)
+{
+    XMEMSET(drbg, 0, sizeof(DRBG));
+
+    return DRBG_SUCCESS;
+}
+
+#endif /* HAVE_CTRDRBG */
+
 /* End NIST DRBG Code */
 
 
+#ifdef HAVE_CTRDRBG
+    #define DRBG_INSTANTIATE    Ctr_DRBG_Instantiate
+    #define DRBG_RESEED         Ctr_DRBG_Reseed
+    #define DRBG_GENERATE       Ctr_DRBG_Generate
+    #define DRBG_UNINSTANTIATE  Ctr_DRBG_Uninstantiate
+    #define RESEED_SZ           CTR_SEED_LEN    /* no df, full seed */
+#else
+    #define DRBG_INSTANTIATE    Hash_DRBG_Instantiate
+    #define DRBG_RESEED         Hash_DRBG_Reseed
+    #define DRBG_GENERATE       Hash_DRBG_Generate
+    #define DRBG_UNINSTANTIATE  Hash_DRBG_Uninstantiate
+    #define RESEED_SZ           ENTROPY_SZ
+#endif
+
+
+/* Generate from drbg, reseeding from seed when due */
+/* Returns: DRBG_SUCCESS, DRBG_CONT_FAILURE, or DRBG_FAILURE */
+static int DRBG_Generate(DRBG* drbg, OS_Seed* seed, byte* output, word32 sz)
+{
+    int ret = DRBG_GENERATE(drbg, output, sz);
+
+    if (ret == DRBG_NEED_RESEED) {
+        byte entropy[RESEED_SZ];
+
+        if (GenerateSeed(seed, entropy, RESEED_SZ) == 0 &&
+            DRBG_RESEED(drbg, entropy, RESEED_SZ) == DRBG_SUCCESS) {
+
+            ret = DRBG_GENERATE(drbg, NULL, 0);
+            if (ret == DRBG_SUCCESS)
+                ret = DRBG_GENERATE(drbg, output, sz);
+        }
+        else
+            ret = DRBG_FAILURE;
+
+        XMEMSET(entropy, 0, RESEED_SZ);
+    }
+
+    return ret;
+}
+
+
+#if defined(CYASSL_RNG_BUFFER) || defined(CYASSL_TLS_THREAD_RNG)
+
+#if !defined(HAVE_THREAD_LS) && !defined(SINGLE_THREADED)
+    #error CYASSL_RNG_BUFFER and CYASSL_TLS_THREAD_RNG need HAVE_THREAD_LS
+#endif
+
+#ifndef RNG_BUFFER_SZ
+    #define RNG_BUFFER_SZ 4096          /* output made per refill */
+#endif
+
+/* a forked child gets a new fork id and drops its copy of the buffer */
+#if defined(CYASSL_PTHREADS)
+    static volatile word32 rngForkCount = 0;
+    static pthread_once_t  rngForkOnce  = PTHREAD_ONCE_INIT;
+
+    static void RngForkChild(void)
+    {
+        rngForkCount++;
+    }
+
+    static void RngForkSetup(void)
+    {
+        pthread_atfork(NULL, NULL, RngForkChild);
+    }
+
+    /* cheaper than getpid() on every call */
+    #define RNG_BUFFER_FORK_ID() (rngForkCount)
+#elif !defined(USE_WINDOWS_API) && !defined(NO_DEV_RANDOM) && \
+      !defined(CYASSL_MDK_ARM) && !defined(CYASSL_IAR_ARM) && !defined(EBSNET)
+    #define RNG_BUFFER_FORK_ID() ((word32)getpid())
+#endif
+
+/* Each thread has one DRBG that makes RNG_BUFFER_SZ bytes per generate and
+   hands them out in slices to every RNG used on that thread. Reseeding
+   still goes by generate calls, one per refill */
+typedef struct RngBuffer {
+    DRBG    drbg;
+    OS_Seed seed;
+    byte    out[RNG_BUFFER_SZ];
+    word32  idx;                /* next unused byte of out */
+    int     status;             /* DRBG_NOT_INIT, DRBG_OK, ... */
+#ifdef RNG_BUFFER_FORK_ID
+    word32  forkId;             /* RNG_BUFFER_FORK_ID() when instantiated */
+#endif
+} RngBuffer;
+
+static THREAD_LS_T RngBuffer rngBuffer;     /* zero, DRBG_NOT_INIT */
+
+
+/* Instantiate this thread's DRBG, buffer starts out empty */
+static int RngBufferInit(RngBuffer* buf)
+{
+    byte entropy[ENTROPY_NONCE_SZ];
+    int  ret = DRBG_FAILURE;
+
+#ifdef CYASSL_PTHREADS
+    pthread_once(&rngForkOnce, RngForkSetup);
+#endif
+
+    if (GenerateSeed(&buf->seed, entropy, ENTROPY_NONCE_SZ) == 0 &&
+        DRBG_INSTANTIATE(&buf->drbg, entropy, ENTROPY_NONCE_SZ,
+                                                     NULL, 0) == DRBG_SUCCESS) {
+
+        ret = DRBG_GENERATE(&buf->drbg, NULL, 0);
+    }
+
+    XMEMSET(entropy, 0, ENTROPY_NONCE_SZ);
+
+    buf->idx    = RNG_BUFFER_SZ;
+    buf->status = (ret == DRBG_SUCCESS) ? DRBG_OK : DRBG_FAILED;
+#ifdef RNG_BUFFER_FORK_ID
+    buf->forkId = RNG_BUFFER_FORK_ID();
+#endif
+
+    return ret;
+}
+
+
+/* This thread's DRBG, set up on first use */
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int RngBufferGet(RngBuffer** out)
+{
+    RngBuffer* buf = &rngBuffer;
+
+#ifdef RNG_BUFFER_FORK_ID
+    /* a forked child must not repeat its parent's output, start over */
+    if (buf->status != DRBG_NOT_INIT && buf->forkId != RNG_BUFFER_FORK_ID())
+        XMEMSET(buf, 0, sizeof(RngBuffer));
+#endif
+
+    if (buf->status == DRBG_NOT_INIT)
+        RngBufferInit(buf);
+
+    *out = buf;
+
+    return (buf->status == DRBG_OK) ? DRBG_SUCCESS : DRBG_FAILURE;
+}
+
+
+/* Fill output from this thread's buffer, big requests skip it */
+/* Returns: DRBG_SUCCESS, DRBG_CONT_FAILURE, or DRBG_FAILURE */
+static int RngBufferGenerate(byte* output, word32 sz)
+{
+    RngBuffer* buf;
+    int        ret = RngBufferGet(&buf);
+
+    if (ret == DRBG_SUCCESS && sz >= RNG_BUFFER_SZ) {
+        ret = DRBG_Generate(&buf->drbg, &buf->seed, output, sz);
+        sz  = 0;
+    }
+
+    while (ret == DRBG_SUCCESS && sz > 0) {
+        word32 n;
+
+        if (buf->idx == RNG_BUFFER_SZ) {
+            ret = DRBG_Generate(&buf->drbg, &buf->seed, buf->out,
+                                RNG_BUFFER_SZ);
+            if (ret != DRBG_SUCCESS)
+                break;
+            buf->idx = 0;
+        }
+
+        n = RNG_BUFFER_SZ - buf->idx;
+        if (n > sz)
+            n = sz;
+        XMEMCPY(output, buf->out + buf->idx, n);
+        XMEMSET(buf->out + buf->idx, 0, n);     /* handed out, drop it */
+
+        buf->idx += n;
+        output   += n;
+        sz       -= n;
+    }
+
+    if (ret != DRBG_SUCCESS && buf->status == DRBG_OK)
+        buf->status = DRBG_FAILED;
+
+    return ret;
+}
+
+#endif /* CYASSL_RNG_BUFFER || CYASSL_TLS_THREAD_RNG */
+
+
+/* Set rng->status from a DRBG_ result, returns 0 or the error */
+static int RngInitStatus(RNG* rng, int ret)
+{
+    if (ret == DRBG_SUCCESS) {
+        rng->status = DRBG_OK;
+        ret = 0;
+    }
+    else if (ret == DRBG_CONT_FAILURE) {
+        rng->status = DRBG_CONT_FAILED;
+        ret = DRBG_CONT_FIPS_E;
+    }
+    else if (ret == DRBG_FAILURE) {
+        rng->status = DRBG_FAILED;
+        ret = RNG_FAILURE_E;
+    }
+    else {
+        rng->status = DRBG_FAILED;
+    }
+
+    return ret;
+}
+
+
+#if defined(CYASSL_RNG_BUFFER) || defined(CYASSL_TLS_THREAD_RNG)
+
+/* An RNG without state of its own, it draws on the calling thread's DRBG
+   so it may be used from any thread, setup costs no seeding after the
+   first one on a thread */
+int InitRngThread(RNG* rng)
+{
+    RngBuffer* buf;
+
+    if (rng == NULL)
+        return BAD_FUNC_ARG;
+
+    rng->drbg = NULL;
+
+    return RngInitStatus(rng, RngBufferGet(&buf));
+}
+
+#endif
+
+
 /* Get seed and key cipher */
 int InitRng(RNG* rng)
 {
+#ifdef CYASSL_RNG_BUFFER
+    return InitRngThread(rng);
+#else
     int ret = BAD_FUNC_ARG;
 
     if (rng != NULL) {
@@ -376,34 +779,21 @@ int InitRng(RNG* rng)
          * the default size plus the size of the nonce making the seed
          * size. */
         else if (GenerateSeed(&rng->seed, entropy, ENTROPY_NONCE_SZ) == 0 &&
-                 Hash_DRBG_Instantiate(rng->drbg, entropy, ENTROPY_NONCE_SZ,
+                 DRBG_INSTANTIATE(rng->drbg, entropy, ENTROPY_NONCE_SZ,
                                                      NULL, 0) == DRBG_SUCCESS) {
 
-            ret = Hash_DRBG_Generate(rng->drbg, NULL, 0);
+            ret = DRBG_GENERATE(rng->drbg, NULL, 0);
         }
         else
             ret = DRBG_FAILURE;
 
         XMEMSET(entropy, 0, ENTROPY_NONCE_SZ);
 
-        if (ret == DRBG_SUCCESS) {
-            rng->status = DRBG_OK;
-            ret = 0;
-        }
-        else if (ret == DRBG_CONT_FAILURE) {
-            rng->status = DRBG_CONT_FAILED;
-            ret = DRBG_CONT_FIPS_E;
-        }
-        else if (ret == DRBG_FAILURE) {
-            rng->status = DRBG_FAILED;
-            ret = RNG_FAILURE_E;
-        }
-        else {
-            rng->status = DRBG_FAILED;
-        }
+        ret = RngInitStatus(rng, ret);
     }
 
     return ret;
+#endif /* CYASSL_RNG_BUFFER */
 }
 
 
@@ -415,26 +805,23 @@ int RNG_GenerateBlock(RNG* rng, byte* output, word32 sz)
     if (rng == NULL || output == NULL || sz > MAX_REQUEST_LEN)
         return BAD_FUNC_ARG;
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (rng->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Rng(rng, output, sz);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
+
     if (rng->status != DRBG_OK)
         return RNG_FAILURE_E;
 
-    ret = Hash_DRBG_Generate(rng->drbg, output, sz);
-
-    if (ret == DRBG_NEED_RESEED) {
-        byte entropy[ENTROPY_SZ];
-
-        if (GenerateSeed(&rng->seed, entropy, ENTROPY_SZ) == 0 &&
-            Hash_DRBG_Reseed(rng->drbg, entropy, ENTROPY_SZ) == DRBG_SUCCESS) {
-
-            ret = Hash_DRBG_Generate(rng->drbg, NULL, 0);
-            if (ret == DRBG_SUCCESS)
-                ret = Hash_DRBG_Generate(rng->drbg, output, sz);
-        }
-        else
-            ret = DRBG_FAILURE;
-
-        XMEMSET(entropy, 0, ENTROPY_SZ);
-    }
+#if defined(CYASSL_RNG_BUFFER) || defined(CYASSL_TLS_THREAD_RNG)
+    if (rng->drbg == NULL)
+        ret = RngBufferGenerate(output, sz);
+    else
+#endif
+        ret = DRBG_Generate(rng->drbg, &rng->seed, output, sz);
 
     if (ret == DRBG_SUCCESS) {
         ret = 0;
@@ -463,7 +850,8 @@ int FreeRng(RNG* rng)
     int ret = BAD_FUNC_ARG;
 
     if (rng != NULL) {
-        if (Hash_DRBG_Uninstantiate(rng->drbg) == DRBG_SUCCESS)
+        if (rng->drbg == NULL ||    /* buffered, nothing of its own */
+                DRBG_UNINSTANTIATE(rng->drbg) == DRBG_SUCCESS)
             ret = 0;
         else
             ret = RNG_FAILURE_E;
@@ -492,27 +880,27 @@ int RNG_HealthTest(int reseed, const byte* entropyA, word32 entropyASz,
     if (outputSz != (SHA256_DIGEST_SIZE * 4))
         return -1;
 
-    if (Hash_DRBG_Instantiate(&drbg, entropyA, entropyASz, NULL, 0) != 0)
+    if (DRBG_INSTANTIATE(&drbg, entropyA, entropyASz, NULL, 0) != 0)
         return -1;
 
     if (reseed) {
-        if (Hash_DRBG_Reseed(&drbg, entropyB, entropyBSz) != 0) {
-            Hash_DRBG_Uninstantiate(&drbg);
+        if (DRBG_RESEED(&drbg, entropyB, entropyBSz) != 0) {
+            DRBG_UNINSTANTIATE(&drbg);
             return -1;
         }
     }
 
-    if (Hash_DRBG_Generate(&drbg, output, outputSz) != 0) {
-        Hash_DRBG_Uninstantiate(&drbg);
+    if (DRBG_GENERATE(&drbg, output, outputSz) != 0) {
+        DRBG_UNINSTANTIATE(&drbg);
         return -1;
     }
 
-    if (Hash_DRBG_Generate(&drbg, output, outputSz) != 0) {
-        Hash_DRBG_Uninstantiate(&drbg);
+    if (DRBG_GENERATE(&drbg, output, outputSz) != 0) {
+        DRBG_UNINSTANTIATE(&drbg);
         return -1;
     }
 
-    Hash_DRBG_Uninstantiate(&drbg);
+    DRBG_UNINSTANTIATE(&drbg);
 
     return 0;
 }
@@ -572,10 +960,22 @@ int InitRng(RNG* rng)
 /* place a generated block in output */
 int RNG_GenerateBlock(RNG* rng, byte* output, word32 sz)
 {
+#ifdef CYASSL_CRYPTO_DEV
+    int ret;
+#endif
+
 #ifdef HAVE_CAVIUM
     if (rng->magic == CYASSL_RNG_CAVIUM_MAGIC)
         return CaviumRNG_GenerateBlock(rng, output, sz);
 #endif
+
+#ifdef CYASSL_CRYPTO_DEV
+    if (rng->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Rng(rng, output, sz);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+    }
+#endif
     XMEMSET(output, 0, sz);
     Arc4Process(&rng->cipher, output, output, sz);
 
@@ -635,6 +1035,18 @@ static void CaviumRNG_GenerateBlock(RNG* rng, byte* output, word32 sz)
 #endif /* HAVE_HASHDRBG || NO_RC4 */
 
 
+#ifdef CYASSL_CRYPTO_DEV
+
+/* send this RNG's requests to the device registered as devId first */
+void RngSetDevId(RNG* rng, int devId)
+{
+    rng->cdevId    = devId;
+    rng->cdevMagic = CYASSL_CRYPTO_DEV_MAGIC;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
+
 #if defined(USE_WINDOWS_API)
 
 
@@ -37,6 +37,9 @@
 #include <cyassl/ctaocrypt/random.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 #include <cyassl/ctaocrypt/logging.h>
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 
 #ifdef SHOW_GEN
     #ifdef FREESCALE_MQX
@@ -85,6 +88,10 @@ int InitRsaKey(RsaKey* key, void* heap)
     key->type = -1;  /* haven't decided yet */
     key->heap = heap;
 
+    mp_mont_ctx_init(&key->nMont);
+    mp_mont_ctx_init(&key->pMont);
+    mp_mont_ctx_init(&key->qMont);
+
 /* TomsFastMath doesn't use memory allocation */
 #ifndef USE_FAST_MATH
     key->n.dp = key->e.dp = 0;  /* public  alloc parts */
@@ -124,6 +131,19 @@ int FreeRsaKey(RsaKey* key)
     return 0;
 }
 
+/* called once the key parts are in, every RsaFunction after reuses the
+   Montgomery setup of n, p and q. A modulus that can't take it is left unset
+   and its exptmods set themselves up as before */
+void RsaSetupMont(RsaKey* key)
+{
+    mp_mont_ctx_setup(&key->nMont, &key->n);
+    if (key->type == RSA_PRIVATE) {
+        mp_mont_ctx_setup(&key->pMont, &key->p);
+        mp_mont_ctx_setup(&key->qMont, &key->q);
+    }
+}
+
+
 static int RsaPad(const byte* input, word32 inputLen, byte* pkcsBlock,
                    word32 pkcsBlockLen, byte padValue, RNG* rng)
 {
@@ -200,8 +220,48 @@ static int RsaUnPad(const byte *pkcsBlock, unsigned int pkcsBlockLen,
 }
 
 
+#ifndef RSA_LOW_MEM
+
+#define RSA_BLIND_SZ 8      /* bytes of the random exponent blinding factor */
+
+/* out = d + r * (p - 1) for a fresh random r with its top bit set, same
+   result for any r but the exponent bits differ on every call */
+static int RsaBlindExponent(mp_int* d, mp_int* p, RNG* rng, mp_int* out)
+{
+    byte   buf[RSA_BLIND_SZ];
+    mp_int r;
+    int    ret = 0;
+
+    if (mp_init(&r) != MP_OKAY)
+        return MP_INIT_E;
+
+    if (RNG_GenerateBlock(rng, buf, sizeof(buf)) != 0)
+        ret = RNG_FAILURE_E;
+    if (ret == 0) {
+        buf[0] |= 0x80;             /* fixed length exponent */
+        if (mp_read_unsigned_bin(&r, buf, sizeof(buf)) != MP_OKAY)
+            ret = MP_READ_E;
+    }
+    if (ret == 0 && mp_sub_d(p, 1, out) != MP_OKAY)
+        ret = MP_SUB_E;
+    if (ret == 0 && mp_mul(out, &r, out) != MP_OKAY)
+        ret = MP_MUL_E;
+    if (ret == 0 && mp_add(out, d, out) != MP_OKAY)
+        ret = MP_ADD_E;
+
+    XMEMSET(buf, 0, sizeof(buf));
+    mp_clear(&r);
+
+    return ret;
+}
+
+#endif /* RSA_LOW_MEM */
+
+
+/* private operations use the constant time exptmod, and with an rng the
+   CRT exponents are blinded too */
 static int RsaFunction(const byte* in, word32 inLen, byte* out, word32* outLen,
-                       int type, RsaKey* key)
+                       int type, RsaKey* key, RNG* rng)
 {
     #define ERROR_OUT(x) { ret = (x); goto done;}
 
@@ -209,6 +269,18 @@ static int RsaFunction(const byte* in, word32 inLen, byte* out, word32* outLen,
     int    ret = 0;
     word32 keyLen, len;
 
+#ifdef CYASSL_CRYPTO_DEV
+    if (key->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC) {
+        ret = CryptoDev_Rsa(key, (type == RSA_PRIVATE_DECRYPT ||
+                                  type == RSA_PRIVATE_ENCRYPT) ? RSA_PRIVATE
+                                                               : RSA_PUBLIC,
+                            in, inLen, out, outLen, rng);
+        if (ret != CRYPTO_DEV_UNAVAILABLE_E)
+            return ret;
+        ret = 0;
+    }
+#endif
+
     if (mp_init(&tmp) != MP_OKAY)
         return MP_INIT_E;
 
@@ -217,12 +289,16 @@ static int RsaFunction(const byte* in, word32 inLen, byte* out, word32* outLen,
 
     if (type == RSA_PRIVATE_DECRYPT || type == RSA_PRIVATE_ENCRYPT) {
         #ifdef RSA_LOW_MEM      /* half as much memory but twice as slow */
-            if (mp_exptmod(&tmp, &key->d, &key->n, &tmp) != MP_OKAY)
+            (void)rng;
+            if (mp_exptmod_ct_ex(&tmp, &key->d, &key->n, &key->nMont, &tmp)
+                                                                  != MP_OKAY)
                 ERROR_OUT(MP_EXPTMOD_E);
         #else
             #define INNER_ERROR_OUT(x) { ret = (x); goto inner_done; }
 
             mp_int tmpa, tmpb;
+            mp_int* dP = &key->dP;
+            mp_int* dQ = &key->dQ;
 
             if (mp_init(&tmpa) != MP_OKAY)
                 ERROR_OUT(MP_INIT_E);
@@ -232,12 +308,25 @@ static int RsaFunction(const byte* in, word32 inLen, byte* out, word32* outLen,
                 ERROR_OUT(MP_INIT_E);
             }
 
+            /* blinded exponents land in tmpa and tmpb until they're used */
+            if (rng) {
+                ret = RsaBlindExponent(&key->dP, &key->p, rng, &tmpa);
+                if (ret == 0)
+                    ret = RsaBlindExponent(&key->dQ, &key->q, rng, &tmpb);
+                if (ret != 0)
+                    goto inner_done;
+                dP = &tmpa;
+                dQ = &tmpb;
+            }
+
             /* tmpa = tmp^dP mod p */
-            if (mp_exptmod(&tmp, &key->dP, &key->p, &tmpa) != MP_OKAY)
+            if (mp_exptmod_ct_ex(&tmp, dP, &key->p, &key->pMont, &tmpa)
+                                                                  != MP_OKAY)
                 INNER_ERROR_OUT(MP_EXPTMOD_E);
 
             /* tmpb = tmp^dQ mod q */
-            if (mp_exptmod(&tmp, &key->dQ, &key->q, &tmpb) != MP_OKAY)
+            if (mp_exptmod_ct_ex(&tmp, dQ, &key->q, &key->qMont, &tmpb)
+                                                                  != MP_OKAY)
                 INNER_ERROR_OUT(MP_EXPTMOD_E);
 
             /* tmp = (tmpa - tmpb) * qInv (mod p) */
@@ -263,7 +352,8 @@ static int RsaFunction(const byte* in, word32 inLen, byte* out, word32* outLen,
         #endif   /* RSA_LOW_MEM */
     }
     else if (type == RSA_PUBLIC_ENCRYPT || type == RSA_PUBLIC_DECRYPT) {
-        if (mp_exptmod(&tmp, &key->e, &key->n, &tmp) != MP_OKAY)
+        if (mp_exptmod_ex(&tmp, &key->e, &key->n, &key->nMont, &tmp)
+                                                                  != MP_OKAY)
             ERROR_OUT(MP_EXPTMOD_E);
     }
     else
@@ -314,7 +404,8 @@ int RsaPublicEncrypt(const byte* in, word32 inLen, byte* out, word32 outLen,
     if (ret != 0)
         return ret;
 
-    if ((ret = RsaFunction(out, sz, out, &outLen, RSA_PUBLIC_ENCRYPT, key)) < 0)
+    if ((ret = RsaFunction(out, sz, out, &outLen, RSA_PUBLIC_ENCRYPT, key,
+                                                                      NULL)) < 0)
         sz = ret;
 
     return sz;
@@ -334,8 +425,8 @@ int RsaPrivateDecryptInline(byte* in, word32 inLen, byte** out, RsaKey* key)
     }
 #endif
 
-    if ((ret = RsaFunction(in, inLen, in, &inLen, RSA_PRIVATE_DECRYPT, key))
-            < 0) {
+    if ((ret = RsaFunction(in, inLen, in, &inLen, RSA_PRIVATE_DECRYPT, key,
+                                                                   NULL)) < 0) {
         return ret;
     }
  
@@ -391,8 +482,8 @@ int RsaSSL_VerifyInline(byte* in, word32 inLen, byte** out, RsaKey* key)
     }
 #endif
 
-    if ((ret = RsaFunction(in, inLen, in, &inLen, RSA_PUBLIC_DECRYPT, key))
-            < 0) {
+    if ((ret = RsaFunction(in, inLen, in, &inLen, RSA_PUBLIC_DECRYPT, key,
+                                                                   NULL)) < 0) {
         return ret;
     }
   
@@ -457,7 +548,8 @@ int RsaSSL_Sign(const byte* in, word32 inLen, byte* out, word32 outLen,
     if (ret != 0)
         return ret;
 
-    if ((ret = RsaFunction(out, sz, out, &outLen, RSA_PRIVATE_ENCRYPT,key)) < 0)
+    if ((ret = RsaFunction(out, sz, out, &outLen, RSA_PRIVATE_ENCRYPT, key,
+                                                                       rng)) < 0)
         sz = ret;
     
     return sz;
@@ -505,10 +597,45 @@ int RsaFlattenPublicKey(RsaKey* key, byte* e, word32* eSz, byte* n, word32* nSz)
 
 static const int USE_BBS = 1;
 
-static int rand_prime(mp_int* N, int len, RNG* rng, void* heap)
+#ifndef RSA_SIEVE_LIMIT
+    #define RSA_SIEVE_LIMIT  65536   /* sieve with odd primes below, <= 64K */
+#endif
+#define RSA_SIEVE_WINDOW 8192        /* candidates tried per random start */
+#define RSA_SIEVE_MARKS  (RSA_SIEVE_LIMIT / 2 > RSA_SIEVE_WINDOW ? \
+                          RSA_SIEVE_LIMIT / 2 : RSA_SIEVE_WINDOW)
+
+/* odd primes below RSA_SIEVE_LIMIT into primes, returns how many */
+static int sieve_primes(word16* primes, byte* mark)
 {
-    int   err, res, type;
-    byte* buf;
+    word32 i, j;
+    int    n = 0;
+
+    /* mark[i] stands for 2i + 1 */
+    XMEMSET(mark, 0, RSA_SIEVE_LIMIT / 2);
+    for (i = 1; i < RSA_SIEVE_LIMIT / 2; i++) {
+        if (mark[i])
+            continue;
+        primes[n++] = (word16)(2 * i + 1);
+        for (j = 2 * i * (i + 1); j < RSA_SIEVE_LIMIT / 2; j += 2 * i + 1)
+            mark[j] = 1;
+    }
+
+    return n;
+}
+
+
+/* random prime of len bytes, rngLock serializes rng use when two searches
+   share it. Candidates are N + inc*j from a random odd N, the ones with a
+   small factor are sieved out so only the rest get Miller-Rabin tests */
+static int rand_prime(mp_int* N, int len, RNG* rng, CyaSSL_Mutex* rngLock,
+                      void* heap)
+{
+    int      err, res = MP_NO, type, i, nPrimes;
+    word32   j, added, inc, p, inv;
+    mp_digit d;
+    word16*  primes;
+    byte*    mark;
+    byte*    buf;
 
     (void)heap;
     if (N == NULL || rng == NULL)
@@ -526,13 +653,20 @@ static int rand_prime(mp_int* N, int len, RNG* rng, void* heap)
     if (len < 2 || len > 512) { 
         return BAD_FUNC_ARG;
     }
+
+    /* keep N = 3 mod 4 for BBS */
+    inc = (type & USE_BBS) ? 4 : 2;
    
-    /* allocate buffer to work with */
-    buf = (byte*)XMALLOC(len, heap, DYNAMIC_TYPE_RSA);
+    /* allocate buffer to work with, then the prime list and sieve marks */
+    buf = (byte*)XMALLOC(len + 1 + RSA_SIEVE_LIMIT + RSA_SIEVE_MARKS, heap,
+                         DYNAMIC_TYPE_RSA);
     if (buf == NULL) {
         return MEMORY_E;
     }
     XMEMSET(buf, 0, len);
+    primes  = (word16*)(buf + len + (len & 1));
+    mark    = (byte*)(primes + RSA_SIEVE_LIMIT / 2);
+    nPrimes = sieve_primes(primes, mark);
 
     do {
 #ifdef SHOW_GEN
@@ -540,43 +674,133 @@ static int rand_prime(mp_int* N, int len, RNG* rng, void* heap)
         fflush(stdout);
 #endif
         /* generate value */
-        err = RNG_GenerateBlock(rng, buf, len);
-        if (err != 0) {
-            XFREE(buf, heap, DYNAMIC_TYPE_RSA);
-            return err;
+        if (rngLock && LockMutex(rngLock) != 0) {
+            err = BAD_MUTEX_E;
+            break;
         }
+        err = RNG_GenerateBlock(rng, buf, len);
+        if (rngLock)
+            UnLockMutex(rngLock);
+        if (err != 0)
+            break;
 
         /* munge bits */
         buf[0]     |= 0x80 | 0x40;
         buf[len-1] |= 0x01 | ((type & USE_BBS) ? 0x02 : 0x00);
  
         /* load value */
-        if ((err = mp_read_unsigned_bin(N, buf, len)) != MP_OKAY) {
-            XFREE(buf, heap, DYNAMIC_TYPE_RSA);
-            return err;
+        if ((err = mp_read_unsigned_bin(N, buf, len)) != MP_OKAY)
+            break;
+
+        /* mark each j where p divides N + inc*j, N is far above the sieve
+           primes so that always means composite */
+        XMEMSET(mark, 0, RSA_SIEVE_WINDOW);
+        for (i = 0; i < nPrimes && err == MP_OKAY; i++) {
+            p   = primes[i];
+            err = mp_mod_d(N, p, &d);
+            inv = (p + 1) / 2;                   /* 1/2 mod p */
+            if (inc == 4)
+                inv = inv * inv % p;             /* 1/4 mod p */
+            for (j = (p - (word32)d) % p * inv % p; j < RSA_SIEVE_WINDOW;
+                                                                       j += p)
+                mark[j] = 1;
         }
 
-        /* test */
-        if ((err = mp_prime_is_prime(N, 8, &res)) != MP_OKAY) {
-            XFREE(buf, heap, DYNAMIC_TYPE_RSA);
-            return err;
+        for (j = 0, added = 0; err == MP_OKAY && res == MP_NO &&
+                                              j < RSA_SIEVE_WINDOW; j++) {
+            if (mark[j])
+                continue;
+
+            if ((err = mp_add_d(N, inc * (j - added), N)) != MP_OKAY)
+                break;
+            added = j;
+
+            /* carried out of the top byte, start over */
+            if (mp_count_bits(N) != len * 8)
+                break;
+
+            /* test */
+            err = mp_prime_is_prime(N, 8, &res);
         }
-    } while (res == MP_NO);
+    } while (err == MP_OKAY && res == MP_NO);
 
 #ifdef LTC_CLEAN_STACK
     XMEMSET(buf, 0, len);
 #endif
 
     XFREE(buf, heap, DYNAMIC_TYPE_RSA);
-    return 0;
+    return err;
 }
 
 
+/* RSA prime of len bytes with gcd(prime - 1, e) == 1 */
+static int rsa_prime(mp_int* prime, long e, int len, RNG* rng,
+                     CyaSSL_Mutex* rngLock, void* heap)
+{
+    mp_int tmp1, tmp2, tmp3;
+    int    err;
+
+    if ((err = mp_init_multi(&tmp1, &tmp2, &tmp3, NULL, NULL, NULL)) != MP_OKAY)
+        return err;
+
+    err = mp_set_int(&tmp3, e);
+
+    if (err == MP_OKAY) {
+        do {
+            err = rand_prime(prime, len, rng, rngLock, heap);
+
+            if (err == MP_OKAY)
+                err = mp_sub_d(prime, 1, &tmp1);  /* tmp1 = prime-1 */
+
+            if (err == MP_OKAY)
+                err = mp_gcd(&tmp1, &tmp3, &tmp2);  /* tmp2 = gcd(prime-1, e) */
+        } while (err == MP_OKAY && mp_cmp_d(&tmp2, 1) != 0); /* e divdes it */
+    }
+
+    mp_clear(&tmp3);
+    mp_clear(&tmp2);
+    mp_clear(&tmp1);
+
+    return err;
+}
+
+
+#if defined(CYASSL_KEY_GEN_THREADS) && defined(CYASSL_PTHREADS)
+
+/* one prime search, run on its own thread */
+typedef struct RsaPrimeJob {
+    mp_int*       prime;
+    long          e;
+    int           len;
+    RNG*          rng;
+    CyaSSL_Mutex* rngLock;
+    void*         heap;
+    int           err;
+} RsaPrimeJob;
+
+static void* RsaPrimeThread(void* arg)
+{
+    RsaPrimeJob* job = (RsaPrimeJob*)arg;
+
+    job->err = rsa_prime(job->prime, job->e, job->len, job->rng, job->rngLock,
+                         job->heap);
+
+    return NULL;
+}
+
+#endif /* CYASSL_KEY_GEN_THREADS && CYASSL_PTHREADS */
+
+
 /* Make an RSA key for size bits, with e specified, 65537 is a good e */
 int MakeRsaKey(RsaKey* key, int size, long e, RNG* rng)
 {
-    mp_int p, q, tmp1, tmp2, tmp3;
+    mp_int p, q, tmp1, tmp2;
     int    err;
+#if defined(CYASSL_KEY_GEN_THREADS) && defined(CYASSL_PTHREADS)
+    CyaSSL_Mutex rngLock;
+    RsaPrimeJob  job;
+    pthread_t    tid;
+#endif
 
     if (key == NULL || rng == NULL)
         return BAD_FUNC_ARG;
@@ -587,36 +811,49 @@ int MakeRsaKey(RsaKey* key, int size, long e, RNG* rng)
     if (e < 3 || (e & 1) == 0)
         return BAD_FUNC_ARG;
 
-    if ((err = mp_init_multi(&p, &q, &tmp1, &tmp2, &tmp3, NULL)) != MP_OKAY)
+    if ((err = mp_init_multi(&p, &q, &tmp1, &tmp2, NULL, NULL)) != MP_OKAY)
         return err;
 
-    err = mp_set_int(&tmp3, e);
+#if defined(CYASSL_KEY_GEN_THREADS) && defined(CYASSL_PTHREADS)
+    /* q on a second thread while this one finds p, the rng is shared */
+    if (InitMutex(&rngLock) != 0)
+        err = BAD_MUTEX_E;
 
-    /* make p */
     if (err == MP_OKAY) {
-        do {
-            err = rand_prime(&p, size/16, rng, key->heap); /* size in bytes/2 */
+        job.prime   = &q;
+        job.e       = e;
+        job.len     = size/16;                 /* size in bytes/2 */
+        job.rng     = rng;
+        job.rngLock = &rngLock;
+        job.heap    = key->heap;
+        job.err     = MP_OKAY;
+
+        if (pthread_create(&tid, NULL, RsaPrimeThread, &job) != 0) {
+            CYASSL_MSG("Prime search thread failed, finding q inline");
+            RsaPrimeThread(&job);
+            err = rsa_prime(&p, e, size/16, rng, NULL, key->heap);
+        }
+        else {
+            err = rsa_prime(&p, e, size/16, rng, &rngLock, key->heap);
+            pthread_join(tid, NULL);
+        }
 
-            if (err == MP_OKAY)
-                err = mp_sub_d(&p, 1, &tmp1);  /* tmp1 = p-1 */
+        if (err == MP_OKAY)
+            err = job.err;
 
-            if (err == MP_OKAY)
-                err = mp_gcd(&tmp1, &tmp3, &tmp2);  /* tmp2 = gcd(p-1, e) */
-        } while (err == MP_OKAY && mp_cmp_d(&tmp2, 1) != 0);  /* e divdes p-1 */
+        FreeMutex(&rngLock);
     }
+#else
+    /* make p */
+    err = rsa_prime(&p, e, size/16, rng, NULL, key->heap); /* size in bytes/2 */
 
     /* make q */
-    if (err == MP_OKAY) {
-        do {
-            err = rand_prime(&q, size/16, rng, key->heap); /* size in bytes/2 */
-
-            if (err == MP_OKAY)
-                err = mp_sub_d(&q, 1, &tmp1);  /* tmp1 = q-1 */
+    if (err == MP_OKAY)
+        err = rsa_prime(&q, e, size/16, rng, NULL, key->heap);
+#endif
 
-            if (err == MP_OKAY)
-                err = mp_gcd(&tmp1, &tmp3, &tmp2);  /* tmp2 = gcd(q-1, e) */
-        } while (err == MP_OKAY && mp_cmp_d(&tmp2, 1) != 0);  /* e divdes q-1 */
-    }
+    if (err == MP_OKAY)
+        err = mp_sub_d(&q, 1, &tmp1);  /* tmp1 = q-1 */
 
     if (err == MP_OKAY)
         err = mp_init_multi(&key->n, &key->e, &key->d, &key->p, &key->q, NULL);
@@ -628,7 +865,7 @@ int MakeRsaKey(RsaKey* key, int size, long e, RNG* rng)
         err = mp_sub_d(&p, 1, &tmp2);  /* tmp2 = p-1 */
 
     if (err == MP_OKAY)
-        err = mp_lcm(&tmp1, &tmp2, &tmp1);  /* tmp1 = lcm(p-1, q-1),last loop */
+        err = mp_lcm(&tmp1, &tmp2, &tmp1);  /* tmp1 = lcm(p-1, q-1) */
 
     /* make key */
     if (err == MP_OKAY)
@@ -661,10 +898,11 @@ int MakeRsaKey(RsaKey* key, int size, long e, RNG* rng)
     if (err == MP_OKAY)
         err = mp_copy(&q, &key->q);
 
-    if (err == MP_OKAY)
+    if (err == MP_OKAY) {
         key->type = RSA_PRIVATE; 
+        RsaSetupMont(key);
+    }
 
-    mp_clear(&tmp3); 
     mp_clear(&tmp2); 
     mp_clear(&tmp1); 
     mp_clear(&q); 
@@ -859,4 +1097,16 @@ static int CaviumRsaSSL_Verify(const byte* in, word32 inLen, byte* out,
 
 #endif /* HAVE_CAVIUM */
 
+
+#ifdef CYASSL_CRYPTO_DEV
+
+/* send this key's raw operations to the device registered as devId first */
+void RsaSetDevId(RsaKey* key, int devId)
+{
+    key->cdevId    = devId;
+    key->cdevMagic = CYASSL_CRYPTO_DEV_MAGIC;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
 #endif /* NO_RSA */
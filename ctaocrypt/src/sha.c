@@ -56,6 +56,20 @@
     #define XTRANSFORM(S,B)  Transform((S))
 #endif
 
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#if defined(HAVE_CYASSL_ARMV8_CRYPTO) && !defined(FREESCALE_MMCAU) && \
+    !defined(STM32F2_HASH)
+    #define SHA_ARMV8
+    #include <arm_neon.h>
+#endif
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(FREESCALE_MMCAU) && \
+    !defined(STM32F2_HASH)
+    #define SHA_X86_SIMD
+    #include <immintrin.h>
+#endif
+
 
 #ifdef STM32F2_HASH
     /*
@@ -229,6 +243,47 @@ int InitSha(Sha* sha)
 #define R4(v,w,x,y,z,i) (z)+= f4((w),(x),(y)) + blk1((i)) + 0xCA62C1D6+ \
                         rotlFixed((v),5); (w) = rotlFixed((w),30);
 
+#ifdef SHA_ARMV8
+
+/* ARMv8 SHA1C/SHA1P/SHA1M, four rounds per instruction, buffer already in
+ * host word order */
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static void TransformArm(word32* digest, const word32* buffer)
+{
+    static const word32 k[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC,
+                                 0xCA62C1D6 };
+    uint32x4_t abcd = vld1q_u32(digest);
+    uint32x4_t m[4], wk;
+    word32     e = digest[4], eNext;
+    int g;
+
+    for (g = 0; g < 4; g++)
+        m[g] = vld1q_u32(buffer + g * 4);
+
+    for (g = 0; g < 20; g++) {
+        wk    = vaddq_u32(m[g & 3], vdupq_n_u32(k[g / 5]));
+        eNext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+        if (g < 5)
+            abcd = vsha1cq_u32(abcd, e, wk);
+        else if (g >= 10 && g < 15)
+            abcd = vsha1mq_u32(abcd, e, wk);
+        else
+            abcd = vsha1pq_u32(abcd, e, wk);
+        e = eNext;
+
+        if (g < 16)
+            m[g & 3] = vsha1su1q_u32(vsha1su0q_u32(m[g & 3], m[(g + 1) & 3],
+                                         m[(g + 2) & 3]), m[(g + 3) & 3]);
+    }
+
+    vst1q_u32(digest, vaddq_u32(vld1q_u32(digest), abcd));
+    digest[4] += e;
+}
+
+#endif /* SHA_ARMV8 */
+
+
 static void Transform(Sha* sha)
 {
     word32 W[SHA_BLOCK_SIZE / sizeof(word32)];
@@ -240,6 +295,13 @@ static void Transform(Sha* sha)
     word32 d = sha->digest[3];
     word32 e = sha->digest[4];
 
+#ifdef SHA_ARMV8
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_ARM_SHA1) {
+        TransformArm(sha->digest, sha->buffer);
+        return;
+    }
+#endif
+
 #ifdef USE_SLOW_SHA
     word32 t, i;
 
@@ -307,6 +369,295 @@ static void Transform(Sha* sha)
 #endif /* FREESCALE_MMCAU */
 
 
+#ifdef SHA_X86_SIMD
+
+/* Each variant compresses whole blocks of big endian message bytes straight
+ * into digest, so ShaUpdate can skip the buffer copy and byte reversal */
+typedef void (*ShaBlocksFunc)(word32* digest, const byte* data, word32 blocks);
+
+/* four rounds on m[g & 3], then the sha1msg1/xor/sha1msg2 steps that group g
+ * feeds into groups g + 3, g + 2 and g + 1 */
+#define SHANI1_RNDS(g) \
+    e1   = _mm_sha1nexte_epu32(e0, m[(g) & 3]); \
+    e0   = abcd; \
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, (g) / 5); \
+    SHANI1_SCHED(g)
+
+#define SHANI1_SCHED(g) \
+    if ((g) >= 3 && (g) <= 18) \
+        m[((g) + 1) & 3] = _mm_sha1msg2_epu32(m[((g) + 1) & 3], m[(g) & 3]); \
+    if ((g) >= 2 && (g) <= 17) \
+        m[((g) + 2) & 3] = _mm_xor_si128(m[((g) + 2) & 3], m[(g) & 3]); \
+    if ((g) >= 1 && (g) <= 16) \
+        m[((g) + 3) & 3] = _mm_sha1msg1_epu32(m[((g) + 3) & 3], m[(g) & 3])
+
+CYASSL_TARGET("sha,sse4.1")
+static void ShaBlocksShaNi(word32* digest, const byte* data, word32 blocks)
+{
+    /* whole register reversed, sha1rnds4 wants W[t] in the top lane */
+    const __m128i bswap = _mm_set_epi64x(0x0001020304050607ULL,
+                                         0x08090a0b0c0d0e0fULL);
+    __m128i abcd, e0, e1, abcdSave, eSave, m[4];
+    int i;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)digest), 0x1B);
+    e0   = _mm_set_epi32((int)digest[4], 0, 0, 0);
+
+    while (blocks--) {
+        abcdSave = abcd;
+        eSave    = e0;
+
+        for (i = 0; i < 4; i++)
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+                       (const __m128i*)(data + i * 16)), bswap);
+
+        e1   = _mm_add_epi32(e0, m[0]);
+        e0   = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        SHANI1_RNDS( 1); SHANI1_RNDS( 2); SHANI1_RNDS( 3); SHANI1_RNDS( 4);
+        SHANI1_RNDS( 5); SHANI1_RNDS( 6); SHANI1_RNDS( 7); SHANI1_RNDS( 8);
+        SHANI1_RNDS( 9); SHANI1_RNDS(10); SHANI1_RNDS(11); SHANI1_RNDS(12);
+        SHANI1_RNDS(13); SHANI1_RNDS(14); SHANI1_RNDS(15); SHANI1_RNDS(16);
+        SHANI1_RNDS(17); SHANI1_RNDS(18); SHANI1_RNDS(19);
+
+        e0   = _mm_sha1nexte_epu32(e0, eSave);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+
+        data += SHA_BLOCK_SIZE;
+    }
+
+    _mm_storeu_si128((__m128i*)digest, _mm_shuffle_epi32(abcd, 0x1B));
+    digest[4] = (word32)_mm_extract_epi32(e0, 3);
+}
+
+
+/* SSSE3 (one block) and AVX2 (two blocks, one per 128 bit lane) message
+ * schedule four words at a time, interleaved with the scalar rounds sixteen
+ * rounds ahead of where W+K gets used. W[t+3] depends on W[t] from the same
+ * group, so lane 3 is computed without it and gets rotl1(W[t]), which is
+ * rotl2 of lane 0 before its rotate, folded in */
+
+static const word32 shaK[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC,
+                                0xCA62C1D6 };
+
+#define SSE_ROTL(x, n) \
+    _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define AVX2_ROTL(x, n) \
+    _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+
+CYASSL_TARGET("ssse3")
+static INLINE __m128i ShaSchedSsse3(__m128i x0, __m128i x1, __m128i x2,
+                                    __m128i x3)
+{
+    __m128i t = _mm_xor_si128(_mm_xor_si128(x0, _mm_alignr_epi8(x1, x0, 8)),
+                              _mm_xor_si128(x2, _mm_srli_si128(x3, 4)));
+
+    return _mm_xor_si128(SSE_ROTL(t, 1), SSE_ROTL(_mm_slli_si128(t, 12), 2));
+}
+
+CYASSL_TARGET("avx2")
+static INLINE __m256i ShaSchedAvx2(__m256i x0, __m256i x1, __m256i x2,
+                                   __m256i x3)
+{
+    __m256i t = _mm256_xor_si256(
+                    _mm256_xor_si256(x0, _mm256_alignr_epi8(x1, x0, 8)),
+                    _mm256_xor_si256(x2, _mm256_srli_si256(x3, 4)));
+
+    return _mm256_xor_si256(AVX2_ROTL(t, 1),
+                            AVX2_ROTL(_mm256_slli_si256(t, 12), 2));
+}
+
+#define RWK(f,v,w,x,y,z,i) (z)+= f((w),(x),(y)) + wk[(i)] + rotlFixed((v),5); \
+                           (w) = rotlFixed((w),30);
+
+/* four rounds from wk[t], v in the a position */
+#define RWK4(f,v,w,x,y,z,t) \
+    RWK(f,v,w,x,y,z,(t)+0); RWK(f,z,v,w,x,y,(t)+1); \
+    RWK(f,y,z,v,w,x,(t)+2); RWK(f,x,y,z,v,w,(t)+3)
+
+/* all eighty rounds on a..e, SCHED(x0, x1, x2, x3, t) replaces x0 with
+ * W[t..t+3] and stores their W+K to wk[t] */
+#define SHA_WK_ROUNDS(SCHED) \
+    SCHED(x0,x1,x2,x3,16); RWK4(f1,a,b,c,d,e, 0); \
+    SCHED(x1,x2,x3,x0,20); RWK4(f1,b,c,d,e,a, 4); \
+    SCHED(x2,x3,x0,x1,24); RWK4(f1,c,d,e,a,b, 8); \
+    SCHED(x3,x0,x1,x2,28); RWK4(f1,d,e,a,b,c,12); \
+    SCHED(x0,x1,x2,x3,32); RWK4(f1,e,a,b,c,d,16); \
+    SCHED(x1,x2,x3,x0,36); RWK4(f2,a,b,c,d,e,20); \
+    SCHED(x2,x3,x0,x1,40); RWK4(f2,b,c,d,e,a,24); \
+    SCHED(x3,x0,x1,x2,44); RWK4(f2,c,d,e,a,b,28); \
+    SCHED(x0,x1,x2,x3,48); RWK4(f2,d,e,a,b,c,32); \
+    SCHED(x1,x2,x3,x0,52); RWK4(f2,e,a,b,c,d,36); \
+    SCHED(x2,x3,x0,x1,56); RWK4(f3,a,b,c,d,e,40); \
+    SCHED(x3,x0,x1,x2,60); RWK4(f3,b,c,d,e,a,44); \
+    SCHED(x0,x1,x2,x3,64); RWK4(f3,c,d,e,a,b,48); \
+    SCHED(x1,x2,x3,x0,68); RWK4(f3,d,e,a,b,c,52); \
+    SCHED(x2,x3,x0,x1,72); RWK4(f3,e,a,b,c,d,56); \
+    SCHED(x3,x0,x1,x2,76); RWK4(f4,a,b,c,d,e,60); \
+                           RWK4(f4,b,c,d,e,a,64); \
+                           RWK4(f4,c,d,e,a,b,68); \
+                           RWK4(f4,d,e,a,b,c,72); \
+                           RWK4(f4,e,a,b,c,d,76)
+
+#define NO_SCHED(x0,x1,x2,x3,t)
+
+#define SSSE3_WK(x, t) \
+    _mm_storeu_si128((__m128i*)&wk[(t)], \
+                     _mm_add_epi32(x, _mm_set1_epi32((int)shaK[(t) / 20])))
+#define SSSE3_LOAD(x, t) \
+    x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + (t)*4)), \
+                         bswap); \
+    SSSE3_WK(x, t)
+#define SSSE3_SCHED(x0,x1,x2,x3,t) \
+    x0 = ShaSchedSsse3(x0, x1, x2, x3); \
+    SSSE3_WK(x0, t)
+
+#define AVX2_WK(x, t) \
+    v = _mm256_add_epi32(x, _mm256_set1_epi32((int)shaK[(t) / 20])); \
+    _mm_storeu_si128((__m128i*)&wk[(t)], _mm256_castsi256_si128(v)); \
+    _mm_storeu_si128((__m128i*)&wkNext[(t)], _mm256_extracti128_si256(v, 1))
+#define AVX2_LOAD(x, t) \
+    x = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256( \
+            _mm_loadu_si128((const __m128i*)(data + (t)*4))), \
+            _mm_loadu_si128((const __m128i*)(next + (t)*4)), 1), bswap); \
+    AVX2_WK(x, t)
+#define AVX2_SCHED(x0,x1,x2,x3,t) \
+    x0 = ShaSchedAvx2(x0, x1, x2, x3); \
+    AVX2_WK(x0, t)
+
+/* the second AVX2 block, its W+K all worked out with the first */
+static void ShaRoundsWk(word32* digest, const word32* wk)
+{
+    word32 a = digest[0];
+    word32 b = digest[1];
+    word32 c = digest[2];
+    word32 d = digest[3];
+    word32 e = digest[4];
+
+    SHA_WK_ROUNDS(NO_SCHED);
+
+    digest[0] += a;
+    digest[1] += b;
+    digest[2] += c;
+    digest[3] += d;
+    digest[4] += e;
+}
+
+CYASSL_TARGET("ssse3")
+static void ShaBlocksSsse3(word32* digest, const byte* data, word32 blocks)
+{
+    const __m128i bswap = _mm_set_epi8(12,13,14,15, 8, 9,10,11,
+                                        4, 5, 6, 7, 0, 1, 2, 3);
+    word32  wk[80];
+    word32  a, b, c, d, e;
+    __m128i x0, x1, x2, x3;
+
+    while (blocks--) {
+        SSSE3_LOAD(x0, 0);
+        SSSE3_LOAD(x1, 4);
+        SSSE3_LOAD(x2, 8);
+        SSSE3_LOAD(x3, 12);
+
+        a = digest[0];
+        b = digest[1];
+        c = digest[2];
+        d = digest[3];
+        e = digest[4];
+
+        SHA_WK_ROUNDS(SSSE3_SCHED);
+
+        digest[0] += a;
+        digest[1] += b;
+        digest[2] += c;
+        digest[3] += d;
+        digest[4] += e;
+
+        data += SHA_BLOCK_SIZE;
+    }
+}
+
+CYASSL_TARGET("avx2")
+static void ShaBlocksAvx2(word32* digest, const byte* data, word32 blocks)
+{
+    const __m256i bswap = _mm256_set_epi8(12,13,14,15, 8, 9,10,11,
+                                           4, 5, 6, 7, 0, 1, 2, 3,
+                                          12,13,14,15, 8, 9,10,11,
+                                           4, 5, 6, 7, 0, 1, 2, 3);
+    word32  wk[80], wkNext[80];
+    word32  a, b, c, d, e;
+    __m256i x0, x1, x2, x3, v;
+
+    while (blocks) {
+        /* a lone last block rides in both lanes */
+        const byte* next = blocks > 1 ? data + SHA_BLOCK_SIZE : data;
+
+        AVX2_LOAD(x0, 0);
+        AVX2_LOAD(x1, 4);
+        AVX2_LOAD(x2, 8);
+        AVX2_LOAD(x3, 12);
+
+        a = digest[0];
+        b = digest[1];
+        c = digest[2];
+        d = digest[3];
+        e = digest[4];
+
+        SHA_WK_ROUNDS(AVX2_SCHED);
+
+        digest[0] += a;
+        digest[1] += b;
+        digest[2] += c;
+        digest[3] += d;
+        digest[4] += e;
+
+        if (blocks > 1) {
+            ShaRoundsWk(digest, wkNext);
+            data   += SHA_BLOCK_SIZE;
+            blocks -= 1;
+        }
+        data   += SHA_BLOCK_SIZE;
+        blocks -= 1;
+    }
+}
+
+
+/* best variant this cpu has, NULL for the generic Transform */
+static INLINE ShaBlocksFunc ShaGetBlocks(void)
+{
+    word32 cpu = CyaSSL_GetCpuFeatures();
+
+    if ((cpu & CYASSL_CPU_SHA) && (cpu & CYASSL_CPU_SSE4_1))
+        return ShaBlocksShaNi;
+    if (cpu & CYASSL_CPU_AVX2)
+        return ShaBlocksAvx2;
+    if (cpu & CYASSL_CPU_SSSE3)
+        return ShaBlocksSsse3;
+
+    return NULL;
+}
+
+#endif /* SHA_X86_SIMD */
+
+
+/* compress sha->buffer, in message byte order */
+static INLINE void TransformBuffer(Sha* sha)
+{
+#ifdef SHA_X86_SIMD
+    ShaBlocksFunc blocksFunc = ShaGetBlocks();
+
+    if (blocksFunc) {
+        blocksFunc(sha->digest, (byte*)sha->buffer, 1);
+        return;
+    }
+#endif
+
+#if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
+    ByteReverseWords(sha->buffer, sha->buffer, SHA_BLOCK_SIZE);
+#endif
+    XTRANSFORM(sha, (byte*)sha->buffer);
+}
+
+
 static INLINE void AddLength(Sha* sha, word32 len)
 {
     word32 tmp = sha->loLen;
@@ -319,9 +670,26 @@ int ShaUpdate(Sha* sha, const byte* data, word32 len)
 {
     /* do block size increments */
     byte* local = (byte*)sha->buffer;
+#ifdef SHA_X86_SIMD
+    ShaBlocksFunc blocksFunc = ShaGetBlocks();
+#endif
 
     while (len) {
-        word32 add = min(len, SHA_BLOCK_SIZE - sha->buffLen);
+        word32 add;
+
+    #ifdef SHA_X86_SIMD
+        /* whole blocks go straight from data */
+        if (blocksFunc && sha->buffLen == 0 && len >= SHA_BLOCK_SIZE) {
+            add = len - len % SHA_BLOCK_SIZE;
+            blocksFunc(sha->digest, data, add / SHA_BLOCK_SIZE);
+            AddLength(sha, add);
+            data += add;
+            len  -= add;
+            continue;
+        }
+    #endif
+
+        add = min(len, SHA_BLOCK_SIZE - sha->buffLen);
         XMEMCPY(&local[sha->buffLen], data, add);
 
         sha->buffLen += add;
@@ -329,10 +697,7 @@ int ShaUpdate(Sha* sha, const byte* data, word32 len)
         len          -= add;
 
         if (sha->buffLen == SHA_BLOCK_SIZE) {
-            #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
-                ByteReverseWords(sha->buffer, sha->buffer, SHA_BLOCK_SIZE);
-            #endif
-            XTRANSFORM(sha, local);
+            TransformBuffer(sha);
             AddLength(sha, SHA_BLOCK_SIZE);
             sha->buffLen = 0;
         }
@@ -355,10 +720,7 @@ int ShaFinal(Sha* sha, byte* hash)
         XMEMSET(&local[sha->buffLen], 0, SHA_BLOCK_SIZE - sha->buffLen);
         sha->buffLen += SHA_BLOCK_SIZE - sha->buffLen;
 
-        #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
-            ByteReverseWords(sha->buffer, sha->buffer, SHA_BLOCK_SIZE);
-        #endif
-        XTRANSFORM(sha, local);
+        TransformBuffer(sha);
         sha->buffLen = 0;
     }
     XMEMSET(&local[sha->buffLen], 0, SHA_PAD_SIZE - sha->buffLen);
@@ -383,7 +745,15 @@ int ShaFinal(Sha* sha, byte* hash)
                          2 * sizeof(word32));
     #endif
 
-    XTRANSFORM(sha, local);
+    #ifdef SHA_X86_SIMD
+    if (ShaGetBlocks()) {
+        /* the SIMD variants take message byte order */
+        ByteReverseWords(sha->buffer, sha->buffer, SHA_BLOCK_SIZE);
+        TransformBuffer(sha);
+    }
+    else
+    #endif
+        XTRANSFORM(sha, local);
     #ifdef LITTLE_ENDIAN_ORDER
         ByteReverseWords(sha->digest, sha->digest, SHA_DIGEST_SIZE);
     #endif
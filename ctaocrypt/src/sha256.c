@@ -55,6 +55,22 @@
     #include "cau_api.h"
 #endif
 
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(FREESCALE_MMCAU)
+    #define SHA256_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#if defined(HAVE_CYASSL_ARMV8_CRYPTO) && !defined(FREESCALE_MMCAU)
+    #define SHA256_ARMV8
+    #include <arm_neon.h>
+#endif
+
+#if defined(SHA256_X86_SIMD) || defined(SHA256_ARMV8)
+    #define SHA256_BLOCKS
+#endif
+
 #ifndef min
 
     static INLINE word32 min(word32 a, word32 b)
@@ -183,6 +199,283 @@ static int Transform(Sha256* sha256)
 #endif /* FREESCALE_MMCAU */
 
 
+#ifdef SHA256_BLOCKS
+
+/* Each variant compresses whole blocks of big endian message bytes straight
+ * into digest, so Sha256Update can skip the buffer copy and byte reversal */
+typedef void (*Sha256BlocksFunc)(word32* digest, const byte* data,
+                                 word32 blocks);
+
+#endif /* SHA256_BLOCKS */
+
+
+#ifdef SHA256_ARMV8
+
+/* ARMv8 SHA256H/SHA256H2, four rounds per pair, SHA256SU0/SU1 extend the
+ * schedule four words at a time */
+CYASSL_TARGET(CYASSL_ARMV8_CRYPTO_TARGET)
+static void Sha256BlocksArm(word32* digest, const byte* data, word32 blocks)
+{
+    uint32x4_t s0 = vld1q_u32(&digest[0]);
+    uint32x4_t s1 = vld1q_u32(&digest[4]);
+
+    while (blocks--) {
+        uint32x4_t abcd = s0, efgh = s1;
+        uint32x4_t m[4], wk, tmp;
+        int g;
+
+        for (g = 0; g < 4; g++)
+            m[g] = vreinterpretq_u32_u8(vrev32q_u8(
+                       vld1q_u8(data + g * 4 * sizeof(word32))));
+
+        for (g = 0; g < 16; g++) {
+            wk = vaddq_u32(m[g & 3], vld1q_u32(&K[4 * g]));
+            if (g < 12)
+                m[g & 3] = vsha256su1q_u32(vsha256su0q_u32(m[g & 3],
+                               m[(g + 1) & 3]), m[(g + 2) & 3], m[(g + 3) & 3]);
+            tmp = s0;
+            s0  = vsha256hq_u32(s0, s1, wk);
+            s1  = vsha256h2q_u32(s1, tmp, wk);
+        }
+
+        s0 = vaddq_u32(s0, abcd);
+        s1 = vaddq_u32(s1, efgh);
+
+        data += SHA256_BLOCK_SIZE;
+    }
+
+    vst1q_u32(&digest[0], s0);
+    vst1q_u32(&digest[4], s1);
+}
+
+#endif /* SHA256_ARMV8 */
+
+
+#ifdef SHA256_X86_SIMD
+
+
+/* SHA extensions, two rounds per sha256rnds2 */
+
+#define SHANI_RNDS(g, m) \
+    tmp = _mm_add_epi32(m, _mm_loadu_si128((const __m128i*)&K[4*(g)])); \
+    s1  = _mm_sha256rnds2_epu32(s1, s0, tmp); \
+    tmp = _mm_shuffle_epi32(tmp, 0x0E); \
+    s0  = _mm_sha256rnds2_epu32(s0, s1, tmp)
+
+/* m0 = next four schedule words from the previous sixteen m0..m3 */
+#define SHANI_SCHED(m0, m1, m2, m3) \
+    m0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), \
+                                            _mm_alignr_epi8(m3, m2, 4)), m3)
+
+CYASSL_TARGET("sha,sse4.1")
+static void Sha256BlocksShaNi(word32* digest, const byte* data, word32 blocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i s0, s1, tmp, abef, cdgh, m0, m1, m2, m3;
+
+    /* state into the ABEF/CDGH lane order sha256rnds2 works on */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&digest[0]), 0xB1);
+    s1  = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&digest[4]), 0x1B);
+    s0  = _mm_alignr_epi8(tmp, s1, 8);
+    s1  = _mm_blend_epi16(s1, tmp, 0xF0);
+
+    while (blocks--) {
+        abef = s0;
+        cdgh = s1;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data +  0)),
+                              bswap);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)),
+                              bswap);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)),
+                              bswap);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)),
+                              bswap);
+
+        SHANI_RNDS( 0, m0);
+        SHANI_RNDS( 1, m1);
+        SHANI_RNDS( 2, m2);
+        SHANI_RNDS( 3, m3);
+        SHANI_SCHED(m0, m1, m2, m3); SHANI_RNDS( 4, m0);
+        SHANI_SCHED(m1, m2, m3, m0); SHANI_RNDS( 5, m1);
+        SHANI_SCHED(m2, m3, m0, m1); SHANI_RNDS( 6, m2);
+        SHANI_SCHED(m3, m0, m1, m2); SHANI_RNDS( 7, m3);
+        SHANI_SCHED(m0, m1, m2, m3); SHANI_RNDS( 8, m0);
+        SHANI_SCHED(m1, m2, m3, m0); SHANI_RNDS( 9, m1);
+        SHANI_SCHED(m2, m3, m0, m1); SHANI_RNDS(10, m2);
+        SHANI_SCHED(m3, m0, m1, m2); SHANI_RNDS(11, m3);
+        SHANI_SCHED(m0, m1, m2, m3); SHANI_RNDS(12, m0);
+        SHANI_SCHED(m1, m2, m3, m0); SHANI_RNDS(13, m1);
+        SHANI_SCHED(m2, m3, m0, m1); SHANI_RNDS(14, m2);
+        SHANI_SCHED(m3, m0, m1, m2); SHANI_RNDS(15, m3);
+
+        s0 = _mm_add_epi32(s0, abef);
+        s1 = _mm_add_epi32(s1, cdgh);
+
+        data += SHA256_BLOCK_SIZE;
+    }
+
+    /* and back to ABCD/EFGH */
+    tmp = _mm_shuffle_epi32(s0, 0x1B);
+    s1  = _mm_shuffle_epi32(s1, 0xB1);
+    s0  = _mm_blend_epi16(tmp, s1, 0xF0);
+    s1  = _mm_alignr_epi8(s1, tmp, 8);
+
+    _mm_storeu_si128((__m128i*)&digest[0], s0);
+    _mm_storeu_si128((__m128i*)&digest[4], s1);
+}
+
+
+/* AVX2 message schedule for two blocks at once, one per 128 bit lane, then
+ * scalar rounds on the precomputed W+K, rotates come out as BMI2 rorx */
+
+#define AVX2_ROTR(x, n) \
+    _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define AVX2_GAMMA0(x) _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(x, 7), \
+                           AVX2_ROTR(x, 18)), _mm256_srli_epi32(x, 3))
+#define AVX2_GAMMA1(x) _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(x, 17), \
+                           AVX2_ROTR(x, 19)), _mm256_srli_epi32(x, 10))
+
+CYASSL_TARGET("avx2,bmi2")
+static INLINE __m256i Sha256SchedAvx2(__m256i x0, __m256i x1, __m256i x2,
+                                      __m256i x3)
+{
+    __m256i w15 = _mm256_alignr_epi8(x1, x0, 4);     /* W[t-15..t-12] */
+    __m256i w7  = _mm256_alignr_epi8(x3, x2, 4);     /* W[t-7..t-4]   */
+    __m256i t   = _mm256_add_epi32(_mm256_add_epi32(x0, AVX2_GAMMA0(w15)), w7);
+    __m256i lo, hi;
+
+    /* W[t], W[t+1] need W[t-2], W[t-1], then W[t+2], W[t+3] need those */
+    lo = _mm256_add_epi32(t, AVX2_GAMMA1(_mm256_shuffle_epi32(x3, 0xFE)));
+    hi = _mm256_add_epi32(t, AVX2_GAMMA1(_mm256_shuffle_epi32(lo, 0x40)));
+
+    return _mm256_blend_epi32(lo, hi, 0xCC);
+}
+
+#define RNDWK(a,b,c,d,e,f,g,h,i) \
+     t0 = (h) + Sigma1((e)) + Ch((e), (f), (g)) + wk[(i)]; \
+     t1 = Sigma0((a)) + Maj((a), (b), (c)); \
+     (d) += t0; \
+     (h)  = t0 + t1;
+
+CYASSL_TARGET("avx2,bmi2")
+static void Sha256RoundsAvx2(word32* digest, const word32* wk)
+{
+    word32 s[8], t0, t1;
+    int i;
+
+    for (i = 0; i < 8; i++)
+        s[i] = digest[i];
+
+    for (i = 0; i < 64; i += 8) {
+        RNDWK(s[0],s[1],s[2],s[3],s[4],s[5],s[6],s[7],i+0);
+        RNDWK(s[7],s[0],s[1],s[2],s[3],s[4],s[5],s[6],i+1);
+        RNDWK(s[6],s[7],s[0],s[1],s[2],s[3],s[4],s[5],i+2);
+        RNDWK(s[5],s[6],s[7],s[0],s[1],s[2],s[3],s[4],i+3);
+        RNDWK(s[4],s[5],s[6],s[7],s[0],s[1],s[2],s[3],i+4);
+        RNDWK(s[3],s[4],s[5],s[6],s[7],s[0],s[1],s[2],i+5);
+        RNDWK(s[2],s[3],s[4],s[5],s[6],s[7],s[0],s[1],i+6);
+        RNDWK(s[1],s[2],s[3],s[4],s[5],s[6],s[7],s[0],i+7);
+    }
+
+    for (i = 0; i < 8; i++)
+        digest[i] += s[i];
+}
+
+CYASSL_TARGET("avx2,bmi2")
+static void Sha256BlocksAvx2(word32* digest, const byte* data, word32 blocks)
+{
+    const __m256i bswap = _mm256_set_epi8(12,13,14,15, 8, 9,10,11,
+                                           4, 5, 6, 7, 0, 1, 2, 3,
+                                          12,13,14,15, 8, 9,10,11,
+                                           4, 5, 6, 7, 0, 1, 2, 3);
+    word32  wk[2][64];
+    __m256i x[4], v;
+    int i, t;
+
+    while (blocks) {
+        /* a lone last block rides in both lanes */
+        const byte* next = blocks > 1 ? data + SHA256_BLOCK_SIZE : data;
+
+        for (t = 0; t < 64; t += 4) {
+            i = (t / 4) % 4;
+            if (t < 16)
+                x[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                           _mm256_castsi128_si256(_mm_loadu_si128(
+                               (const __m128i*)(data + t*4))),
+                           _mm_loadu_si128((const __m128i*)(next + t*4)), 1),
+                       bswap);
+            else
+                x[i] = Sha256SchedAvx2(x[i], x[(i+1)%4], x[(i+2)%4],
+                                       x[(i+3)%4]);
+
+            v = _mm256_add_epi32(x[i], _mm256_broadcastsi128_si256(
+                                  _mm_loadu_si128((const __m128i*)&K[t])));
+            _mm_storeu_si128((__m128i*)&wk[0][t], _mm256_castsi256_si128(v));
+            _mm_storeu_si128((__m128i*)&wk[1][t],
+                             _mm256_extracti128_si256(v, 1));
+        }
+
+        Sha256RoundsAvx2(digest, wk[0]);
+        if (blocks > 1) {
+            Sha256RoundsAvx2(digest, wk[1]);
+            data   += SHA256_BLOCK_SIZE;
+            blocks -= 1;
+        }
+        data   += SHA256_BLOCK_SIZE;
+        blocks -= 1;
+    }
+}
+
+
+#endif /* SHA256_X86_SIMD */
+
+
+#ifdef SHA256_BLOCKS
+
+/* best variant this cpu has, NULL for the generic Transform */
+static INLINE Sha256BlocksFunc Sha256GetBlocks(void)
+{
+    word32 cpu = CyaSSL_GetCpuFeatures();
+
+#ifdef SHA256_X86_SIMD
+    if ((cpu & CYASSL_CPU_SHA) && (cpu & CYASSL_CPU_SSE4_1))
+        return Sha256BlocksShaNi;
+    if ((cpu & CYASSL_CPU_AVX2) && (cpu & CYASSL_CPU_BMI2))
+        return Sha256BlocksAvx2;
+#endif
+#ifdef SHA256_ARMV8
+    if (cpu & CYASSL_CPU_ARM_SHA2)
+        return Sha256BlocksArm;
+#endif
+
+    return NULL;
+}
+
+#endif /* SHA256_BLOCKS */
+
+
+/* compress sha256->buffer, in message byte order */
+static INLINE int TransformBuffer(Sha256* sha256)
+{
+#ifdef SHA256_BLOCKS
+    Sha256BlocksFunc blocksFunc = Sha256GetBlocks();
+
+    if (blocksFunc) {
+        blocksFunc(sha256->digest, (byte*)sha256->buffer, 1);
+        return 0;
+    }
+#endif
+
+#if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
+    ByteReverseWords(sha256->buffer, sha256->buffer, SHA256_BLOCK_SIZE);
+#endif
+
+    return XTRANSFORM(sha256, (byte*)sha256->buffer);
+}
+
+
 static INLINE void AddLength(Sha256* sha256, word32 len)
 {
     word32 tmp = sha256->loLen;
@@ -195,9 +488,26 @@ int Sha256Update(Sha256* sha256, const byte* data, word32 len)
 {
     /* do block size increments */
     byte* local = (byte*)sha256->buffer;
+#ifdef SHA256_BLOCKS
+    Sha256BlocksFunc blocksFunc = Sha256GetBlocks();
+#endif
 
     while (len) {
-        word32 add = min(len, SHA256_BLOCK_SIZE - sha256->buffLen);
+        word32 add;
+
+    #ifdef SHA256_BLOCKS
+        /* whole blocks go straight from data */
+        if (blocksFunc && sha256->buffLen == 0 && len >= SHA256_BLOCK_SIZE) {
+            add = len - len % SHA256_BLOCK_SIZE;
+            blocksFunc(sha256->digest, data, add / SHA256_BLOCK_SIZE);
+            AddLength(sha256, add);
+            data += add;
+            len  -= add;
+            continue;
+        }
+    #endif
+
+        add = min(len, SHA256_BLOCK_SIZE - sha256->buffLen);
         XMEMCPY(&local[sha256->buffLen], data, add);
 
         sha256->buffLen += add;
@@ -205,14 +515,7 @@ int Sha256Update(Sha256* sha256, const byte* data, word32 len)
         len             -= add;
 
         if (sha256->buffLen == SHA256_BLOCK_SIZE) {
-            int ret;
-
-            #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
-                ByteReverseWords(sha256->buffer, sha256->buffer,
-                                 SHA256_BLOCK_SIZE);
-            #endif
-
-            ret = XTRANSFORM(sha256, local);
+            int ret = TransformBuffer(sha256);
             if (ret != 0)
                 return ret;
 
@@ -239,11 +542,7 @@ int Sha256Final(Sha256* sha256, byte* hash)
         XMEMSET(&local[sha256->buffLen], 0, SHA256_BLOCK_SIZE - sha256->buffLen);
         sha256->buffLen += SHA256_BLOCK_SIZE - sha256->buffLen;
 
-        #if defined(LITTLE_ENDIAN_ORDER) && !defined(FREESCALE_MMCAU)
-            ByteReverseWords(sha256->buffer, sha256->buffer, SHA256_BLOCK_SIZE);
-        #endif
-
-        ret = XTRANSFORM(sha256, local);
+        ret = TransformBuffer(sha256);
         if (ret != 0)
             return ret;
 
@@ -272,7 +571,15 @@ int Sha256Final(Sha256* sha256, byte* hash)
                          2 * sizeof(word32));
     #endif
 
-    ret = XTRANSFORM(sha256, local);
+    #ifdef SHA256_BLOCKS
+    if (Sha256GetBlocks()) {
+        /* the SIMD variants take message byte order */
+        ByteReverseWords(sha256->buffer, sha256->buffer, SHA256_BLOCK_SIZE);
+        ret = TransformBuffer(sha256);
+    }
+    else
+    #endif
+        ret = XTRANSFORM(sha256, local);
     if (ret != 0)
         return ret;
 
@@ -318,5 +625,302 @@ int Sha256Hash(const byte* data, word32 len, byte* hash)
 }
 
 
+#ifdef SHA256_X86_SIMD
+
+#define SHA256_LANES 8   /* independent messages per AVX2 pass */
+
+#define AVX2_CH(x,y,z)  _mm256_xor_si256((z), _mm256_and_si256((x), \
+                            _mm256_xor_si256((y), (z))))
+#define AVX2_MAJ(x,y,z) _mm256_or_si256(_mm256_and_si256( \
+                            _mm256_or_si256((x), (y)), (z)), \
+                            _mm256_and_si256((x), (y)))
+#define AVX2_SIGMA0(x)  _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(x, 2), \
+                            AVX2_ROTR(x, 13)), AVX2_ROTR(x, 22))
+#define AVX2_SIGMA1(x)  _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(x, 6), \
+                            AVX2_ROTR(x, 11)), AVX2_ROTR(x, 25))
+
+/* 64 rounds on the lane transposed state, w is the block as words and is
+   used up as the message schedule */
+CYASSL_TARGET("avx2")
+static void Sha256RoundsLanes(__m256i* state, __m256i* w)
+{
+    __m256i s[8], t0, t1;
+    int i, t;
+
+    for (i = 0; i < 8; i++)
+        s[i] = state[i];
+
+    for (t = 0; t < 64; t++) {
+        if (t >= 16)
+            w[t & 15] = _mm256_add_epi32(
+                            _mm256_add_epi32(AVX2_GAMMA1(w[(t - 2) & 15]),
+                                             w[(t - 7) & 15]),
+                            _mm256_add_epi32(AVX2_GAMMA0(w[(t - 15) & 15]),
+                                             w[t & 15]));
+
+        t0 = _mm256_add_epi32(_mm256_add_epi32(s[7], AVX2_SIGMA1(s[4])),
+                              AVX2_CH(s[4], s[5], s[6]));
+        t0 = _mm256_add_epi32(t0, _mm256_add_epi32(w[t & 15],
+                                          _mm256_set1_epi32((int)K[t])));
+        t1 = _mm256_add_epi32(AVX2_SIGMA0(s[0]), AVX2_MAJ(s[0], s[1], s[2]));
+
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = _mm256_add_epi32(s[3], t0);
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = _mm256_add_epi32(t0, t1);
+    }
+
+    for (i = 0; i < 8; i++)
+        state[i] = _mm256_add_epi32(state[i], s[i]);
+}
+
+
+/* one block from each lane's message into the lane transposed state */
+CYASSL_TARGET("avx2")
+static void Sha256TransformLanes(__m256i* state, const byte** block)
+{
+    __m256i w[16];
+    word32  col[SHA256_LANES];
+    int i, t;
+
+    for (t = 0; t < 16; t++) {
+        for (i = 0; i < SHA256_LANES; i++) {
+            XMEMCPY(&col[i], block[i] + t * sizeof(word32), sizeof(word32));
+            col[i] = ByteReverseWord32(col[i]);
+        }
+        w[t] = _mm256_loadu_si256((const __m256i*)col);
+    }
+
+    Sha256RoundsLanes(state, w);
+}
+
+
+/* hash n <= SHA256_LANES messages side by side, idle lanes repeat lane 0 */
+CYASSL_TARGET("avx2")
+static int Sha256HashLanes(const byte** data, const word32* len, byte** hash,
+                           int n)
+{
+    byte        tail[SHA256_LANES][2 * SHA256_BLOCK_SIZE];
+    word32      full[SHA256_LANES], blocks[SHA256_LANES], most = 0;
+    const byte* block[SHA256_LANES];
+    word32      out[8][SHA256_LANES];
+    __m256i     state[8];
+    Sha256      init;
+    word32      b;
+    int         i, l;
+
+    for (l = 0; l < SHA256_LANES; l++) {
+        int    src = l < n ? l : 0;
+        word32 rem = len[src] % SHA256_BLOCK_SIZE;
+        word32 pad = rem < SHA256_PAD_SIZE ? 1 : 2;
+        word64 bits = (word64)len[src] * 8;
+        byte*  end;
+
+        full[l]   = len[src] / SHA256_BLOCK_SIZE;
+        blocks[l] = full[l] + pad;
+        if (blocks[l] > most)
+            most = blocks[l];
+
+        XMEMSET(tail[l], 0, sizeof(tail[l]));
+        if (rem)
+            XMEMCPY(tail[l], data[src] + full[l] * SHA256_BLOCK_SIZE, rem);
+        tail[l][rem] = 0x80;
+
+        end = tail[l] + pad * SHA256_BLOCK_SIZE;
+        for (i = 1; i <= 8; i++, bits >>= 8)
+            end[-i] = (byte)bits;
+
+        if (l >= n) {
+            full[l]   = full[0];
+            blocks[l] = blocks[0];
+        }
+    }
+
+    InitSha256(&init);
+    for (i = 0; i < 8; i++)
+        state[i] = _mm256_set1_epi32((int)init.digest[i]);
+
+    for (b = 0; b < most; b++) {
+        for (l = 0; l < SHA256_LANES; l++) {
+            int src = l < n ? l : 0;
+
+            if (b < full[l])
+                block[l] = data[src] + b * SHA256_BLOCK_SIZE;
+            else if (b < blocks[l])
+                block[l] = tail[l] + (b - full[l]) * SHA256_BLOCK_SIZE;
+            else
+                block[l] = tail[l];      /* done, lane result is ignored */
+        }
+
+        Sha256TransformLanes(state, block);
+
+        for (l = 0; l < n; l++) {
+            if (b + 1 != blocks[l])
+                continue;
+
+            for (i = 0; i < 8; i++)
+                _mm256_storeu_si256((__m256i*)out[i], state[i]);
+            for (i = 0; i < 8; i++) {
+                word32 d = ByteReverseWord32(out[i][l]);
+                XMEMCPY(hash[l] + i * sizeof(word32), &d, sizeof(word32));
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/* HMAC-SHA256 over a one digest message from the keyed midstates, the block
+   is the message words, the pad bit and the 96 byte length */
+CYASSL_TARGET("avx2")
+static void Sha256HmacLanes(__m256i* u, const __m256i* inner,
+                            const __m256i* outer)
+{
+    __m256i state[8], w[16];
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        state[i] = inner[i];
+        w[i]     = u[i];
+    }
+    w[8] = _mm256_set1_epi32((int)0x80000000);
+    for (i = 9; i < 15; i++)
+        w[i] = _mm256_setzero_si256();
+    w[15] = _mm256_set1_epi32((SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE) * 8);
+    Sha256RoundsLanes(state, w);
+
+    for (i = 0; i < 8; i++) {
+        w[i]     = state[i];
+        state[i] = outer[i];
+    }
+    w[8] = _mm256_set1_epi32((int)0x80000000);
+    for (i = 9; i < 15; i++)
+        w[i] = _mm256_setzero_si256();
+    w[15] = _mm256_set1_epi32((SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE) * 8);
+    Sha256RoundsLanes(state, w);
+
+    for (i = 0; i < 8; i++)
+        u[i] = state[i];
+}
+
+
+/* n <= SHA256_LANES chains, U stays transposed in registers between
+   iterations, idle lanes repeat lane 0 */
+CYASSL_TARGET("avx2")
+static void Sha256PbkdfLanes(const word32** inner, const word32** outer,
+                             byte** u, int iterations, int n)
+{
+    word32  col[8][SHA256_LANES];
+    __m256i in[8], out[8], cur[8], acc[8];
+    int i, l, j;
+
+    for (i = 0; i < 8; i++) {
+        for (l = 0; l < SHA256_LANES; l++)
+            col[i][l] = inner[l < n ? l : 0][i];
+        in[i] = _mm256_loadu_si256((const __m256i*)col[i]);
+        for (l = 0; l < SHA256_LANES; l++)
+            col[i][l] = outer[l < n ? l : 0][i];
+        out[i] = _mm256_loadu_si256((const __m256i*)col[i]);
+        for (l = 0; l < SHA256_LANES; l++) {
+            XMEMCPY(&col[i][l], u[l < n ? l : 0] + i * sizeof(word32),
+                    sizeof(word32));
+            col[i][l] = ByteReverseWord32(col[i][l]);
+        }
+        cur[i] = acc[i] = _mm256_loadu_si256((const __m256i*)col[i]);
+    }
+
+    for (j = 1; j < iterations; j++) {
+        Sha256HmacLanes(cur, in, out);
+        for (i = 0; i < 8; i++)
+            acc[i] = _mm256_xor_si256(acc[i], cur[i]);
+    }
+
+    for (i = 0; i < 8; i++)
+        _mm256_storeu_si256((__m256i*)col[i], acc[i]);
+    for (l = 0; l < n; l++) {
+        for (i = 0; i < 8; i++) {
+            word32 d = ByteReverseWord32(col[i][l]);
+            XMEMCPY(u[l] + i * sizeof(word32), &d, sizeof(word32));
+        }
+    }
+}
+
+#endif /* SHA256_X86_SIMD */
+
+
+/* PBKDF2 iterations 2..c for count HMAC-SHA256 chains side by side. inner
+ * and outer are each key's digest after its pad block, u holds U1 on entry
+ * and U1 ^ ... ^ Uc on return. NOT_COMPILED_IN when this cpu has no lanes,
+ * the caller runs its scalar loop then. */
+int Sha256PbkdfMulti(const word32** inner, const word32** outer, byte** u,
+                     int iterations, int count)
+{
+#ifdef SHA256_X86_SIMD
+    int i, n;
+
+    /* unlike Sha256HashMulti this beats SHA-NI too, the chains never leave
+       the transposed registers */
+    if ((CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2) && count >= 2) {
+        for (i = 0; i < count; i += n) {
+            n = min(count - i, SHA256_LANES);
+            Sha256PbkdfLanes(inner + i, outer + i, u + i, iterations, n);
+        }
+        return 0;
+    }
+#endif
+
+    (void)inner;
+    (void)outer;
+    (void)u;
+    (void)iterations;
+    (void)count;
+
+    return NOT_COMPILED_IN;
+}
+
+
+/* hash count independent messages, data[i] of len[i] bytes to hash[i],
+ * several at a time across SIMD lanes when the cpu has them */
+int Sha256HashMulti(const byte** data, const word32* len, byte** hash,
+                    int count)
+{
+    int i, ret = 0;
+
+    if (count < 0 || (count > 0 && (data == NULL || len == NULL ||
+                                    hash == NULL)))
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < count; i++) {
+        if ((data[i] == NULL && len[i] != 0) || hash[i] == NULL)
+            return BAD_FUNC_ARG;
+    }
+
+    i = 0;
+
+#ifdef SHA256_X86_SIMD
+    /* a single SHA-NI stream already beats the lanes */
+    if ((CyaSSL_GetCpuFeatures() & CYASSL_CPU_AVX2) &&
+        Sha256GetBlocks() != Sha256BlocksShaNi) {
+        while (count - i >= 2 && ret == 0) {
+            int n = min(count - i, SHA256_LANES);
+
+            ret = Sha256HashLanes(data + i, len + i, hash + i, n);
+            i += n;
+        }
+    }
+#endif
+
+    for (; i < count && ret == 0; i++)
+        ret = Sha256Hash(data[i], len[i], hash[i]);
+
+    return ret;
+}
+
+
 #endif /* NO_SHA256 */
 
@@ -42,6 +42,13 @@
     #include <ctaocrypt/src/misc.c>
 #endif
 
+#include <cyassl/ctaocrypt/cpuid.h>
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    #define SHA512_X86_SIMD
+    #include <immintrin.h>
+#endif
+
 
 #ifndef min
 
@@ -207,6 +214,218 @@ static int Transform(Sha512* sha512)
 }
 
 
+#ifdef SHA512_X86_SIMD
+
+/* Each variant compresses whole blocks of big endian message bytes straight
+ * into digest, SHA-384 shares them, only its initial digest differs */
+typedef void (*Sha512BlocksFunc)(word64* digest, const byte* data,
+                                 word32 blocks);
+
+#define blkBE(i) (XMEMCPY(&W[i], data + (i) * sizeof(word64), sizeof(word64)),\
+                  W[i] = ByteReverseWord64(W[i]))
+
+#define R3(i) h(i)+=S1(e(i))+Ch(e(i),f(i),g(i))+K[i+j]+(j?blk2(i):blkBE(i));\
+	d(i)+=h(i);h(i)+=S0(a(i))+Maj(a(i),b(i),c(i))
+
+#define RWK(i) h(i)+=S1(e(i))+Ch(e(i),f(i),g(i))+wk[i+j];\
+	d(i)+=h(i);h(i)+=S0(a(i))+Maj(a(i),b(i),c(i))
+
+
+/* the C rounds built for BMI2, every rotate becomes one rorx */
+CYASSL_TARGET("bmi2")
+static void Sha512BlocksRorx(word64* digest, const byte* data, word32 blocks)
+{
+    const word64* K = K512;
+
+    word32 j;
+    word64 T[8];
+    word64 W[16];
+
+    while (blocks--) {
+        XMEMCPY(T, digest, sizeof(T));
+
+        for (j = 0; j < 80; j += 16) {
+            R3( 0); R3( 1); R3( 2); R3( 3);
+            R3( 4); R3( 5); R3( 6); R3( 7);
+            R3( 8); R3( 9); R3(10); R3(11);
+            R3(12); R3(13); R3(14); R3(15);
+        }
+
+        digest[0] += a(0);
+        digest[1] += b(0);
+        digest[2] += c(0);
+        digest[3] += d(0);
+        digest[4] += e(0);
+        digest[5] += f(0);
+        digest[6] += g(0);
+        digest[7] += h(0);
+
+        data += SHA512_BLOCK_SIZE;
+    }
+
+    /* Wipe variables */
+    XMEMSET(W, 0, sizeof(W));
+    XMEMSET(T, 0, sizeof(T));
+}
+
+
+/* AVX2 message schedule for two blocks at once, one per 128 bit lane, two
+ * words per step so W[t-2], W[t-1] are always the previous vector */
+
+#define AVX2_ROTR64(x, n) \
+    _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define AVX2_s0(x) _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR64(x, 1), \
+                       AVX2_ROTR64(x, 8)), _mm256_srli_epi64(x, 7))
+#define AVX2_s1(x) _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR64(x, 19), \
+                       AVX2_ROTR64(x, 61)), _mm256_srli_epi64(x, 6))
+
+CYASSL_TARGET("avx2,bmi2")
+static void Sha512RoundsAvx2(word64* digest, const word64* wk)
+{
+    word32 j;
+    word64 T[8];
+
+    XMEMCPY(T, digest, sizeof(T));
+
+    for (j = 0; j < 80; j += 16) {
+        RWK( 0); RWK( 1); RWK( 2); RWK( 3);
+        RWK( 4); RWK( 5); RWK( 6); RWK( 7);
+        RWK( 8); RWK( 9); RWK(10); RWK(11);
+        RWK(12); RWK(13); RWK(14); RWK(15);
+    }
+
+    digest[0] += a(0);
+    digest[1] += b(0);
+    digest[2] += c(0);
+    digest[3] += d(0);
+    digest[4] += e(0);
+    digest[5] += f(0);
+    digest[6] += g(0);
+    digest[7] += h(0);
+
+    XMEMSET(T, 0, sizeof(T));
+}
+
+/* W+K for words t, t+1 of both blocks out of x[i] */
+#define AVX2_WK(i, t) \
+    v = _mm256_add_epi64(x[i], _mm256_broadcastsi128_si256( \
+                          _mm_loadu_si128((const __m128i*)&K512[t]))); \
+    _mm_storeu_si128((__m128i*)&sched[0][t], _mm256_castsi256_si128(v)); \
+    _mm_storeu_si128((__m128i*)&sched[1][t], _mm256_extracti128_si256(v, 1))
+
+/* x[i] from W[t-16..t-15] to W[t..t+1] */
+#define AVX2_SCHED(i) \
+    x[i] = _mm256_add_epi64( \
+               _mm256_add_epi64(x[i], AVX2_s0(_mm256_alignr_epi8( \
+                   x[((i)+1)&7], x[i], 8))), \
+               _mm256_add_epi64(_mm256_alignr_epi8(x[((i)+5)&7], \
+                   x[((i)+4)&7], 8), AVX2_s1(x[((i)+7)&7]))); \
+    AVX2_WK(i, t + 2*(i))
+
+CYASSL_TARGET("avx2,bmi2")
+static void Sha512BlocksAvx2(word64* digest, const byte* data, word32 blocks)
+{
+    const __m256i bswap = _mm256_set_epi8( 8, 9,10,11,12,13,14,15,
+                                           0, 1, 2, 3, 4, 5, 6, 7,
+                                           8, 9,10,11,12,13,14,15,
+                                           0, 1, 2, 3, 4, 5, 6, 7);
+    word64        sched[2][80];
+    const word64* wk = sched[0];
+    word64        T[8];
+    __m256i       x[8], v;
+    word32        j;
+    int i, t;
+
+    while (blocks) {
+        /* a lone last block rides in both lanes */
+        const byte* next = blocks > 1 ? data + SHA512_BLOCK_SIZE : data;
+
+        for (i = 0; i < 8; i++) {
+            x[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                       _mm256_castsi128_si256(_mm_loadu_si128(
+                           (const __m128i*)(data + i*16))),
+                       _mm_loadu_si128((const __m128i*)(next + i*16)), 1),
+                   bswap);
+            AVX2_WK(i, 2*i);
+        }
+
+        /* first block's rounds with the rest of the schedule in between, the
+         * vector work fills the ports the serial round chain leaves idle */
+        XMEMCPY(T, digest, sizeof(T));
+
+        for (j = 0; j < 80; j += 16) {
+            RWK( 0); RWK( 1); RWK( 2); RWK( 3);
+            RWK( 4); RWK( 5); RWK( 6); RWK( 7);
+            RWK( 8); RWK( 9); RWK(10); RWK(11);
+            RWK(12); RWK(13); RWK(14); RWK(15);
+
+            if (j < 64) {
+                t = (int)j + 16;
+                AVX2_SCHED(0); AVX2_SCHED(1); AVX2_SCHED(2); AVX2_SCHED(3);
+                AVX2_SCHED(4); AVX2_SCHED(5); AVX2_SCHED(6); AVX2_SCHED(7);
+            }
+        }
+
+        digest[0] += a(0);
+        digest[1] += b(0);
+        digest[2] += c(0);
+        digest[3] += d(0);
+        digest[4] += e(0);
+        digest[5] += f(0);
+        digest[6] += g(0);
+        digest[7] += h(0);
+
+        /* second block's W+K is already done */
+        if (blocks > 1) {
+            Sha512RoundsAvx2(digest, sched[1]);
+            data   += SHA512_BLOCK_SIZE;
+            blocks -= 1;
+        }
+        data   += SHA512_BLOCK_SIZE;
+        blocks -= 1;
+    }
+
+    XMEMSET(sched, 0, sizeof(sched));
+    XMEMSET(T, 0, sizeof(T));
+}
+
+
+/* best variant this cpu has, NULL for the generic Transform */
+static INLINE Sha512BlocksFunc Sha512GetBlocks(void)
+{
+    word32 cpu = CyaSSL_GetCpuFeatures();
+
+    if ((cpu & CYASSL_CPU_AVX2) && (cpu & CYASSL_CPU_BMI2))
+        return Sha512BlocksAvx2;
+    if (cpu & CYASSL_CPU_BMI2)
+        return Sha512BlocksRorx;
+
+    return NULL;
+}
+
+#endif /* SHA512_X86_SIMD */
+
+
+/* compress sha512->buffer, in message byte order */
+static INLINE int TransformBuffer(Sha512* sha512)
+{
+#ifdef SHA512_X86_SIMD
+    Sha512BlocksFunc blocksFunc = Sha512GetBlocks();
+
+    if (blocksFunc) {
+        blocksFunc(sha512->digest, (byte*)sha512->buffer, 1);
+        return 0;
+    }
+#endif
+
+#ifdef LITTLE_ENDIAN_ORDER
+    ByteReverseWords64(sha512->buffer, sha512->buffer, SHA512_BLOCK_SIZE);
+#endif
+
+    return Transform(sha512);
+}
+
+
 static INLINE void AddLength(Sha512* sha512, word32 len)
 {
     word32 tmp = sha512->loLen;
@@ -219,9 +438,26 @@ int Sha512Update(Sha512* sha512, const byte* data, word32 len)
 {
     /* do block size increments */
     byte* local = (byte*)sha512->buffer;
+#ifdef SHA512_X86_SIMD
+    Sha512BlocksFunc blocksFunc = Sha512GetBlocks();
+#endif
 
     while (len) {
-        word32 add = min(len, SHA512_BLOCK_SIZE - sha512->buffLen);
+        word32 add;
+
+    #ifdef SHA512_X86_SIMD
+        /* whole blocks go straight from data */
+        if (blocksFunc && sha512->buffLen == 0 && len >= SHA512_BLOCK_SIZE) {
+            add = len - len % SHA512_BLOCK_SIZE;
+            blocksFunc(sha512->digest, data, add / SHA512_BLOCK_SIZE);
+            AddLength(sha512, add);
+            data += add;
+            len  -= add;
+            continue;
+        }
+    #endif
+
+        add = min(len, SHA512_BLOCK_SIZE - sha512->buffLen);
         XMEMCPY(&local[sha512->buffLen], data, add);
 
         sha512->buffLen += add;
@@ -229,13 +465,7 @@ int Sha512Update(Sha512* sha512, const byte* data, word32 len)
         len          -= add;
 
         if (sha512->buffLen == SHA512_BLOCK_SIZE) {
-            int ret;
-
-            #ifdef LITTLE_ENDIAN_ORDER
-                ByteReverseWords64(sha512->buffer, sha512->buffer,
-                                   SHA512_BLOCK_SIZE);
-            #endif
-            ret = Transform(sha512);
+            int ret = TransformBuffer(sha512);
             if (ret != 0)
                 return ret;
 
@@ -261,10 +491,7 @@ int Sha512Final(Sha512* sha512, byte* hash)
         XMEMSET(&local[sha512->buffLen], 0, SHA512_BLOCK_SIZE -sha512->buffLen);
         sha512->buffLen += SHA512_BLOCK_SIZE - sha512->buffLen;
 
-        #ifdef LITTLE_ENDIAN_ORDER
-            ByteReverseWords64(sha512->buffer,sha512->buffer,SHA512_BLOCK_SIZE);
-        #endif
-        ret = Transform(sha512);
+        ret = TransformBuffer(sha512);
         if (ret != 0)
             return ret;
 
@@ -285,7 +512,15 @@ int Sha512Final(Sha512* sha512, byte* hash)
     sha512->buffer[SHA512_BLOCK_SIZE / sizeof(word64) - 2] = sha512->hiLen;
     sha512->buffer[SHA512_BLOCK_SIZE / sizeof(word64) - 1] = sha512->loLen;
 
-    ret = Transform(sha512);
+    #ifdef SHA512_X86_SIMD
+    if (Sha512GetBlocks()) {
+        /* the SIMD variants take message byte order */
+        ByteReverseWords64(sha512->buffer, sha512->buffer, SHA512_BLOCK_SIZE);
+        ret = TransformBuffer(sha512);
+    }
+    else
+    #endif
+        ret = Transform(sha512);
     if (ret != 0)
         return ret;
 
@@ -414,6 +649,26 @@ static int Transform384(Sha384* sha384)
 }
 
 
+/* compress sha384->buffer, in message byte order */
+static INLINE int TransformBuffer384(Sha384* sha384)
+{
+#ifdef SHA512_X86_SIMD
+    Sha512BlocksFunc blocksFunc = Sha512GetBlocks();
+
+    if (blocksFunc) {
+        blocksFunc(sha384->digest, (byte*)sha384->buffer, 1);
+        return 0;
+    }
+#endif
+
+#ifdef LITTLE_ENDIAN_ORDER
+    ByteReverseWords64(sha384->buffer, sha384->buffer, SHA384_BLOCK_SIZE);
+#endif
+
+    return Transform384(sha384);
+}
+
+
 static INLINE void AddLength384(Sha384* sha384, word32 len)
 {
     word32 tmp = sha384->loLen;
@@ -426,9 +681,26 @@ int Sha384Update(Sha384* sha384, const byte* data, word32 len)
 {
     /* do block size increments */
     byte* local = (byte*)sha384->buffer;
+#ifdef SHA512_X86_SIMD
+    Sha512BlocksFunc blocksFunc = Sha512GetBlocks();
+#endif
 
     while (len) {
-        word32 add = min(len, SHA384_BLOCK_SIZE - sha384->buffLen);
+        word32 add;
+
+    #ifdef SHA512_X86_SIMD
+        /* whole blocks go straight from data */
+        if (blocksFunc && sha384->buffLen == 0 && len >= SHA384_BLOCK_SIZE) {
+            add = len - len % SHA384_BLOCK_SIZE;
+            blocksFunc(sha384->digest, data, add / SHA384_BLOCK_SIZE);
+            AddLength384(sha384, add);
+            data += add;
+            len  -= add;
+            continue;
+        }
+    #endif
+
+        add = min(len, SHA384_BLOCK_SIZE - sha384->buffLen);
         XMEMCPY(&local[sha384->buffLen], data, add);
 
         sha384->buffLen += add;
@@ -436,13 +708,7 @@ int Sha384Update(Sha384* sha384, const byte* data, word32 len)
         len          -= add;
 
         if (sha384->buffLen == SHA384_BLOCK_SIZE) {
-            int ret;
-
-            #ifdef LITTLE_ENDIAN_ORDER
-                ByteReverseWords64(sha384->buffer, sha384->buffer,
-                                   SHA384_BLOCK_SIZE);
-            #endif
-            ret = Transform384(sha384);
+            int ret = TransformBuffer384(sha384);
             if (ret != 0)
                 return ret;
 
@@ -468,10 +734,7 @@ int Sha384Final(Sha384* sha384, byte* hash)
         XMEMSET(&local[sha384->buffLen], 0, SHA384_BLOCK_SIZE -sha384->buffLen);
         sha384->buffLen += SHA384_BLOCK_SIZE - sha384->buffLen;
 
-        #ifdef LITTLE_ENDIAN_ORDER
-            ByteReverseWords64(sha384->buffer,sha384->buffer,SHA384_BLOCK_SIZE);
-        #endif
-        ret = Transform384(sha384);
+        ret = TransformBuffer384(sha384);
         if (ret !=  0)
             return ret;
 
@@ -492,7 +755,15 @@ int Sha384Final(Sha384* sha384, byte* hash)
     sha384->buffer[SHA384_BLOCK_SIZE / sizeof(word64) - 2] = sha384->hiLen;
     sha384->buffer[SHA384_BLOCK_SIZE / sizeof(word64) - 1] = sha384->loLen;
 
-    ret = Transform384(sha384);
+    #ifdef SHA512_X86_SIMD
+    if (Sha512GetBlocks()) {
+        /* the SIMD variants take message byte order */
+        ByteReverseWords64(sha384->buffer, sha384->buffer, SHA384_BLOCK_SIZE);
+        ret = TransformBuffer384(sha384);
+    }
+    else
+    #endif
+        ret = Transform384(sha384);
     if (ret != 0)
         return ret;
 
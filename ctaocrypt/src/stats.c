@@ -0,0 +1,166 @@
+/* stats.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#include <cyassl/ctaocrypt/stats.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
+
+
+#ifdef CYASSL_STATS
+
+#if !defined(HAVE_THREAD_LS) && !defined(SINGLE_THREADED)
+    #error CYASSL_STATS needs HAVE_THREAD_LS for its per thread counters
+#endif
+
+#ifndef CYASSL_STATS_THREADS
+    #define CYASSL_STATS_THREADS 64     /* threads that get their own block */
+#endif
+
+static THREAD_LS_T CyaSSL_Stats* threadStats = 0;
+
+static CyaSSL_Stats* statsBlocks[CYASSL_STATS_THREADS]; /* kept for good */
+static int           statsCount = 0;
+static CyaSSL_Mutex  statsMutex;                /* for statsBlocks, count */
+static int           statsMutexInit = 0;
+
+/* threads past the limit, or before StatsInit(), share this one, their
+   racing increments can lose a count */
+static CyaSSL_Stats  statsShared;
+
+
+/* called from CyaSSL_Init(), before that everyone uses statsShared */
+int StatsInit(void)
+{
+    if (!statsMutexInit) {
+        if (InitMutex(&statsMutex) != 0)
+            return BAD_MUTEX_E;
+        statsMutexInit = 1;
+    }
+
+    return 0;
+}
+
+
+/* Get a block for this thread, the shared one if out of blocks or memory */
+static CyaSSL_Stats* NewStats(void)
+{
+    CyaSSL_Stats* stats = NULL;
+
+    if (!statsMutexInit)
+        return &statsShared;    /* not remembered, may get one later */
+
+    if (LockMutex(&statsMutex) != 0)
+        return &statsShared;
+
+    if (statsCount < CYASSL_STATS_THREADS) {
+        stats = (CyaSSL_Stats*)XMALLOC(sizeof(CyaSSL_Stats), NULL,
+                                       DYNAMIC_TYPE_STATS);
+        if (stats) {
+            XMEMSET(stats, 0, sizeof(CyaSSL_Stats));
+            statsBlocks[statsCount++] = stats;
+        }
+    }
+
+    UnLockMutex(&statsMutex);
+
+    threadStats = stats ? stats : &statsShared;
+
+    return threadStats;
+}
+
+
+CyaSSL_Stats* StatsThread(void)
+{
+    CyaSSL_Stats* stats = threadStats;
+
+    if (stats == NULL)
+        stats = NewStats();
+
+    return stats;
+}
+
+
+static void AddStats(CyaSSL_Stats* sum, const CyaSSL_Stats* stats)
+{
+    int i;
+
+    sum->fullHandshakes    += stats->fullHandshakes;
+    sum->resumedHandshakes += stats->resumedHandshakes;
+    sum->renegotiations    += stats->renegotiations;
+    sum->cacheHits         += stats->cacheHits;
+    sum->cacheMisses       += stats->cacheMisses;
+    sum->cacheEvictions    += stats->cacheEvictions;
+    sum->ticketFailures    += stats->ticketFailures;
+    sum->recordsIn         += stats->recordsIn;
+    sum->recordsOut        += stats->recordsOut;
+    sum->bytesIn           += stats->bytesIn;
+    sum->bytesOut          += stats->bytesOut;
+    sum->crlLookups        += stats->crlLookups;
+    sum->ocspLookups       += stats->ocspLookups;
+    sum->fpCacheHits       += stats->fpCacheHits;
+    sum->fpCacheMisses     += stats->fpCacheMisses;
+
+    for (i = 0; i < CYASSL_STATS_ALERTS; i++) {
+        sum->alertsIn[i]  += stats->alertsIn[i];
+        sum->alertsOut[i] += stats->alertsOut[i];
+    }
+}
+
+#endif /* CYASSL_STATS */
+
+
+/* Other threads keep counting while this reads, each counter is current as
+   of some moment during the call */
+int CyaSSL_get_stats(CyaSSL_Stats* stats)
+{
+#ifdef CYASSL_STATS
+    int i;
+
+    if (stats == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(stats, 0, sizeof(CyaSSL_Stats));
+    AddStats(stats, &statsShared);
+
+    if (!statsMutexInit)
+        return 0;
+
+    if (LockMutex(&statsMutex) != 0)
+        return BAD_MUTEX_E;
+
+    for (i = 0; i < statsCount; i++)
+        AddStats(stats, statsBlocks[i]);
+
+    UnLockMutex(&statsMutex);
+
+    return 0;
+#else
+    (void)stats;
+
+    return NOT_COMPILED_IN;
+#endif
+}
+
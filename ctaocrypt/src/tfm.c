@@ -40,6 +40,7 @@
 #ifdef USE_FAST_MATH
 
 #include <cyassl/ctaocrypt/tfm.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #include <ctaocrypt/src/asm.c>  /* will define asm MACROS or C ones */
 
 
@@ -57,6 +58,58 @@ word32 CheckRunTimeFastMath(void)
 }
 
 
+#ifdef ALT_ECC_SIZE
+
+/* digits an int really has, one that was only XMEMSET to zero (or never set
+   up at all, as plain fp_ints may be) is full size */
+#define FP_INT_SIZE(a)  (((a)->size > 0 && (a)->size <= FP_SIZE) ? (a)->size \
+                                                                 : FP_SIZE)
+
+void fp_init(fp_int *a)
+{
+    fp_init_size(a, FP_SIZE);
+}
+
+/* init an int with room for size digits, the rest of dp is never touched */
+void fp_init_size(fp_int *a, int size)
+{
+    a->size = size;
+    fp_zero(a);
+}
+
+void fp_zero(fp_int *a)
+{
+    a->used = 0;
+    a->sign = FP_ZPOS;
+    XMEMSET(a->dp, 0, FP_INT_SIZE(a) * sizeof(fp_digit));
+}
+
+/* only the used digits move, b's old digits above them are cleared, so b can
+   be a short int as long as the value fits */
+void fp_copy(fp_int *a, fp_int *b)
+{
+    int oldused;
+
+    if (a == b)
+        return;
+
+    oldused = b->used;
+    b->used = a->used;
+    b->sign = a->sign;
+    XMEMCPY(b->dp, a->dp, a->used * sizeof(fp_digit));
+    if (oldused > a->used)
+        XMEMSET(b->dp + a->used, 0, (oldused - a->used) * sizeof(fp_digit));
+}
+
+void fp_init_copy(fp_int *a, fp_int *b)
+{
+    fp_init(a);
+    fp_copy(b, a);
+}
+
+#endif /* ALT_ECC_SIZE */
+
+
 /* Functions */
 
 void fp_add(fp_int *a, fp_int *b, fp_int *c)
@@ -177,6 +230,193 @@ void s_fp_sub(fp_int *a, fp_int *b, fp_int *c)
   fp_clamp(c);
 }
 
+#ifdef HAVE_FP_MULX
+
+/* the MULX/ADX rows take over from the comba code from this many digits,
+   below it the unrolled TFM_MUL/SQR sizes are as fast */
+#ifndef FP_MULX_MIN
+    #define FP_MULX_MIN 5
+#endif
+
+/* 1 when the cpu has MULX (BMI2) and ADCX/ADOX (ADX) */
+static int fp_use_mulx(void)
+{
+   return (CyaSSL_GetCpuFeatures() & (CYASSL_CPU_BMI2 | CYASSL_CPU_ADX)) ==
+                                          (CYASSL_CPU_BMI2 | CYASSL_CPU_ADX);
+}
+
+/* _c[0..n-1] += mu * tmpm[0..n-1], returns the carry out of _c[n-1] */
+static fp_digit fp_mulx_row(fp_digit* _c, fp_digit* tmpm, fp_digit mu, int n)
+{
+   fp_digit cy = 0;
+
+   for (; n >= 8; n -= 8) {
+      INNERMULX(8);
+      _c   += 8;
+      tmpm += 8;
+   }
+   if (n >= 4) {
+      INNERMULX(4);
+      _c   += 4;
+      tmpm += 4;
+      n    -= 4;
+   }
+   if (n >= 2) {
+      INNERMULX(2);
+      _c   += 2;
+      tmpm += 2;
+      n    -= 2;
+   }
+   if (n > 0)
+      INNERMULX(1);
+
+   return cy;
+}
+
+/* C = A * B, one MULX row per digit of the shorter input */
+static void fp_mul_mulx(fp_int *A, fp_int *B, fp_int *C)
+{
+   fp_digit c[FP_SIZE];
+   fp_int*  t;
+   int      x, na, nb, oldused, sign;
+
+   if (A->used > B->used) {
+      t = A;
+      A = B;
+      B = t;
+   }
+   na      = A->used;
+   nb      = B->used;
+   sign    = A->sign ^ B->sign;
+   oldused = C->used;
+
+   XMEMSET(c, 0, nb * sizeof(fp_digit));
+   for (x = 0; x < na; x++)
+      c[x + nb] = fp_mulx_row(c + x, B->dp, A->dp[x], nb);
+
+   /* C may be A or B, so only now */
+   XMEMCPY(C->dp, c, (na + nb) * sizeof(fp_digit));
+   for (x = na + nb; x < oldused; x++)
+      C->dp[x] = 0;
+   C->used = na + nb;
+   C->sign = sign;
+   fp_clamp(C);
+}
+
+/* B = A * A: MULX rows for the products above the diagonal, then one pass
+   that doubles them and adds in the squares */
+static void fp_sqr_mulx(fp_int *A, fp_int *B)
+{
+   fp_digit c[FP_SIZE], *a = A->dp, lo, hi, top = 0, cy = 0;
+   fp_word  w;
+   int      x, n = A->used, oldused = B->used;
+
+   XMEMSET(c, 0, 2 * n * sizeof(fp_digit));
+   for (x = 0; x < n - 1; x++)
+      c[x + n] = fp_mulx_row(c + 2 * x + 1, a + x + 1, a[x], n - 1 - x);
+
+   for (x = 0; x < n; x++) {
+      lo  = c[2 * x];
+      hi  = c[2 * x + 1];
+
+      w   = (fp_word)a[x] * a[x] + ((lo << 1) | top) + cy;
+      c[2 * x] = (fp_digit)w;
+      w   = (w >> DIGIT_BIT) + ((hi << 1) | (lo >> (DIGIT_BIT - 1)));
+      c[2 * x + 1] = (fp_digit)w;
+      cy  = (fp_digit)(w >> DIGIT_BIT);
+      top = hi >> (DIGIT_BIT - 1);
+   }
+
+   XMEMCPY(B->dp, c, 2 * n * sizeof(fp_digit));
+   for (x = 2 * n; x < oldused; x++)
+      B->dp[x] = 0;
+   B->used = 2 * n;
+   B->sign = FP_ZPOS;
+   fp_clamp(B);
+}
+
+#endif /* HAVE_FP_MULX */
+
+/* one Karatsuba split from this many digits in the shorter input, each of
+   the three half size products goes back through fp_mul / fp_sqr, so a big
+   enough one splits again. Below it the comba and MULX kernels are faster
+   than the split with its fp_int temps, 6144 bits on 64-bit targets */
+#ifndef FP_KARATSUBA_MIN
+    #define FP_KARATSUBA_MIN 96
+#endif
+
+/* lo = |a| mod 2^(m digits), hi = |a| / 2^(m digits) */
+static void fp_split(fp_int *a, int m, fp_int *lo, fp_int *hi)
+{
+   fp_zero(lo);
+   fp_zero(hi);
+   XMEMCPY(lo->dp, a->dp, m * sizeof(fp_digit));
+   lo->used = m;
+   fp_clamp(lo);
+   XMEMCPY(hi->dp, a->dp + m, (a->used - m) * sizeof(fp_digit));
+   hi->used = a->used - m;
+   fp_clamp(hi);
+}
+
+/* C = A * B with A = a1 x + a0, B = b1 x + b0, x = 2^(m digits):
+   a1 b1 x^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) x + a0 b0,
+   three products of m digits in place of four. B is NULL to square A, the
+   middle term is then (a0 + a1)^2 - a0^2 - a1^2. 6 temps in t */
+static void _fp_mul_karatsuba(fp_int *A, fp_int *B, fp_int *C, int m,
+                              fp_int *t)
+{
+   fp_int *a0 = &t[0], *a1 = &t[1], *b0 = &t[2], *b1 = &t[3],
+          *z0 = &t[4], *z2 = &t[5];
+   int     sign = (B == NULL) ? FP_ZPOS : A->sign ^ B->sign;
+
+   fp_split(A, m, a0, a1);
+   fp_init(z0);
+   fp_init(z2);
+
+   if (B == NULL) {
+      fp_sqr(a0, z0);
+      fp_sqr(a1, z2);
+      s_fp_add(a0, a1, a0);
+      fp_sqr(a0, a1);               /* a1 = z1 + z0 + z2 */
+   }
+   else {
+      fp_split(B, m, b0, b1);
+      fp_mul(a0, b0, z0);
+      fp_mul(a1, b1, z2);
+      s_fp_add(a0, a1, a0);
+      s_fp_add(b0, b1, b0);
+      fp_mul(a0, b0, a1);           /* a1 = z1 + z0 + z2 */
+   }
+   s_fp_sub(a1, z0, a1);
+   s_fp_sub(a1, z2, a1);
+
+   fp_lshd(z2, m);
+   s_fp_add(z2, a1, z2);
+   fp_lshd(z2, m);
+   s_fp_add(z2, z0, C);
+   C->sign = fp_iszero(C) ? FP_ZPOS : sign;
+}
+
+/* heap temps with CYASSL_SMALL_STACK, returns FP_MEM if they can't be had
+   and the caller goes on with comba */
+static int fp_mul_karatsuba(fp_int *A, fp_int *B, fp_int *C, int m)
+{
+#ifdef CYASSL_SMALL_STACK
+   fp_int *t;
+
+   t = (fp_int*)XMALLOC(sizeof(fp_int) * 6, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+   if (t == NULL)
+      return FP_MEM;
+   _fp_mul_karatsuba(A, B, C, m, t);
+   XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#else
+   fp_int  t[6];
+
+   _fp_mul_karatsuba(A, B, C, m, t);
+#endif
+   return FP_OKAY;
+}
+
 /* c = a * b */
 void fp_mul(fp_int *A, fp_int *B, fp_int *C)
 {
@@ -191,6 +431,20 @@ void fp_mul(fp_int *A, fp_int *B, fp_int *C)
        return ;
     }
 
+    /* both inputs need a high half, a full FP_SIZE result is left to comba */
+    if (yy >= FP_KARATSUBA_MIN && yy > (y + 1) / 2 && y + yy < FP_SIZE &&
+        fp_mul_karatsuba(A, B, C, (y + 1) / 2) == FP_OKAY) {
+       return;
+    }
+
+#ifdef HAVE_FP_MULX
+    /* a full FP_SIZE result is left to the comba code, it trims the top */
+    if (yy >= FP_MULX_MIN && y + yy < FP_SIZE && fp_use_mulx()) {
+       fp_mul_mulx(A, B, C);
+       return;
+    }
+#endif
+
     /* pick a comba (unrolled 4/8/16/32 x or rolled) based on the size
        of the largest input.  We also want to avoid doing excess mults if the 
        inputs are not close to the next power of two.  That is, for example,
@@ -417,7 +671,7 @@ void fp_mul_comba(fp_int *A, fp_int *B, fp_int *C)
    }
 
    if (A == C || B == C) {
-      fp_zero(&tmp);
+      fp_init(&tmp);
       dst = &tmp;
    } else {
       fp_zero(C);
@@ -685,7 +939,7 @@ int fp_mod(fp_int *a, fp_int *b, fp_int *c)
    fp_int t;
    int    err;
 
-   fp_zero(&t);
+   fp_init(&t);
    if ((err = fp_div(a, b, NULL, &t)) != FP_OKAY) {
       return err;
    }
@@ -725,9 +979,10 @@ void fp_mod_2d(fp_int *a, int b, fp_int *c)
   fp_clamp (c);
 }
 
-static int fp_invmod_slow (fp_int * a, fp_int * b, fp_int * c)
+static int _fp_invmod_slow (fp_int * a, fp_int * b, fp_int * c, fp_int * t)
 {
-  fp_int  x, y, u, v, A, B, C, D;
+  fp_int  *x = &t[0], *y = &t[1], *u = &t[2], *v = &t[3],
+          *A = &t[4], *B = &t[5], *C = &t[6], *D = &t[7];
   int     res;
 
   /* b cannot be negative */
@@ -736,104 +991,125 @@ static int fp_invmod_slow (fp_int * a, fp_int * b, fp_int * c)
   }
 
   /* init temps */
-  fp_init(&x);    fp_init(&y);
-  fp_init(&u);    fp_init(&v);
-  fp_init(&A);    fp_init(&B);
-  fp_init(&C);    fp_init(&D);
+  fp_init(x);    fp_init(y);
+  fp_init(u);    fp_init(v);
+  fp_init(A);    fp_init(B);
+  fp_init(C);    fp_init(D);
 
   /* x = a, y = b */
-  if ((res = fp_mod(a, b, &x)) != FP_OKAY) {
+  if ((res = fp_mod(a, b, x)) != FP_OKAY) {
       return res;
   }
-  fp_copy(b, &y);
+  fp_copy(b, y);
 
   /* 2. [modified] if x,y are both even then return an error! */
-  if (fp_iseven (&x) == 1 && fp_iseven (&y) == 1) {
+  if (fp_iseven (x) == 1 && fp_iseven (y) == 1) {
     return FP_VAL;
   }
 
   /* 3. u=x, v=y, A=1, B=0, C=0,D=1 */
-  fp_copy (&x, &u);
-  fp_copy (&y, &v);
-  fp_set (&A, 1);
-  fp_set (&D, 1);
+  fp_copy (x, u);
+  fp_copy (y, v);
+  fp_set (A, 1);
+  fp_set (D, 1);
 
 top:
   /* 4.  while u is even do */
-  while (fp_iseven (&u) == 1) {
+  while (fp_iseven (u) == 1) {
     /* 4.1 u = u/2 */
-    fp_div_2 (&u, &u);
+    fp_div_2 (u, u);
 
     /* 4.2 if A or B is odd then */
-    if (fp_isodd (&A) == 1 || fp_isodd (&B) == 1) {
+    if (fp_isodd (A) == 1 || fp_isodd (B) == 1) {
       /* A = (A+y)/2, B = (B-x)/2 */
-      fp_add (&A, &y, &A);
-      fp_sub (&B, &x, &B);
+      fp_add (A, y, A);
+      fp_sub (B, x, B);
     }
     /* A = A/2, B = B/2 */
-    fp_div_2 (&A, &A);
-    fp_div_2 (&B, &B);
+    fp_div_2 (A, A);
+    fp_div_2 (B, B);
   }
 
   /* 5.  while v is even do */
-  while (fp_iseven (&v) == 1) {
+  while (fp_iseven (v) == 1) {
     /* 5.1 v = v/2 */
-    fp_div_2 (&v, &v);
+    fp_div_2 (v, v);
 
     /* 5.2 if C or D is odd then */
-    if (fp_isodd (&C) == 1 || fp_isodd (&D) == 1) {
+    if (fp_isodd (C) == 1 || fp_isodd (D) == 1) {
       /* C = (C+y)/2, D = (D-x)/2 */
-      fp_add (&C, &y, &C);
-      fp_sub (&D, &x, &D);
+      fp_add (C, y, C);
+      fp_sub (D, x, D);
     }
     /* C = C/2, D = D/2 */
-    fp_div_2 (&C, &C);
-    fp_div_2 (&D, &D);
+    fp_div_2 (C, C);
+    fp_div_2 (D, D);
   }
 
   /* 6.  if u >= v then */
-  if (fp_cmp (&u, &v) != FP_LT) {
+  if (fp_cmp (u, v) != FP_LT) {
     /* u = u - v, A = A - C, B = B - D */
-    fp_sub (&u, &v, &u);
-    fp_sub (&A, &C, &A);
-    fp_sub (&B, &D, &B);
+    fp_sub (u, v, u);
+    fp_sub (A, C, A);
+    fp_sub (B, D, B);
   } else {
     /* v - v - u, C = C - A, D = D - B */
-    fp_sub (&v, &u, &v);
-    fp_sub (&C, &A, &C);
-    fp_sub (&D, &B, &D);
+    fp_sub (v, u, v);
+    fp_sub (C, A, C);
+    fp_sub (D, B, D);
   }
 
   /* if not zero goto step 4 */
-  if (fp_iszero (&u) == 0)
+  if (fp_iszero (u) == 0)
     goto top;
 
   /* now a = C, b = D, gcd == g*v */
 
   /* if v != 1 then there is no inverse */
-  if (fp_cmp_d (&v, 1) != FP_EQ) {
+  if (fp_cmp_d (v, 1) != FP_EQ) {
     return FP_VAL;
   }
 
   /* if its too low */
-  while (fp_cmp_d(&C, 0) == FP_LT) {
-      fp_add(&C, b, &C);
+  while (fp_cmp_d(C, 0) == FP_LT) {
+      fp_add(C, b, C);
   }
   
   /* too big */
-  while (fp_cmp_mag(&C, b) != FP_LT) {
-      fp_sub(&C, b, &C);
+  while (fp_cmp_mag(C, b) != FP_LT) {
+      fp_sub(C, b, C);
   }
   
   /* C is now the inverse */
-  fp_copy(&C, c);
+  fp_copy(C, c);
   return FP_OKAY;
 }
 
-/* c = 1/a (mod b) for odd b only */
-int fp_invmod(fp_int *a, fp_int *b, fp_int *c)
+/* 8 temps, on the heap with CYASSL_SMALL_STACK */
+static int fp_invmod_slow (fp_int * a, fp_int * b, fp_int * c)
+{
+#ifdef CYASSL_SMALL_STACK
+  fp_int *t;
+  int     err;
+
+  t = (fp_int*)XMALLOC(sizeof(fp_int) * 8, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+  if (t == NULL)
+    return FP_MEM;
+  err = _fp_invmod_slow(a, b, c, t);
+  XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+  return err;
+#else
+  fp_int  t[8];
+
+  return _fp_invmod_slow(a, b, c, t);
+#endif
+}
+
+/* fp_invmod() with its 6 temps in t */
+static int _fp_invmod(fp_int *a, fp_int *b, fp_int *c, fp_int *t)
 {
-  fp_int  x, y, u, v, B, D;
+  fp_int  *x = &t[0], *y = &t[1], *u = &t[2],
+          *v = &t[3], *B = &t[4], *D = &t[5];
   int     neg;
 
   /* 2. [modified] b must be odd   */
@@ -842,122 +1118,222 @@ int fp_invmod(fp_int *a, fp_int *b, fp_int *c)
   }
 
   /* init all our temps */
-  fp_init(&x);  fp_init(&y);
-  fp_init(&u);  fp_init(&v);
-  fp_init(&B);  fp_init(&D);
+  fp_init(x);  fp_init(y);
+  fp_init(u);  fp_init(v);
+  fp_init(B);  fp_init(D);
 
   /* x == modulus, y == value to invert */
-  fp_copy(b, &x);
+  fp_copy(b, x);
 
   /* we need y = |a| */
-  fp_abs(a, &y);
+  fp_abs(a, y);
 
   /* 3. u=x, v=y, A=1, B=0, C=0,D=1 */
-  fp_copy(&x, &u);
-  fp_copy(&y, &v);
-  fp_set (&D, 1);
+  fp_copy(x, u);
+  fp_copy(y, v);
+  fp_set (D, 1);
 
 top:
   /* 4.  while u is even do */
-  while (fp_iseven (&u) == FP_YES) {
+  while (fp_iseven (u) == FP_YES) {
     /* 4.1 u = u/2 */
-    fp_div_2 (&u, &u);
+    fp_div_2 (u, u);
 
     /* 4.2 if B is odd then */
-    if (fp_isodd (&B) == FP_YES) {
-      fp_sub (&B, &x, &B);
+    if (fp_isodd (B) == FP_YES) {
+      fp_sub (B, x, B);
     }
     /* B = B/2 */
-    fp_div_2 (&B, &B);
+    fp_div_2 (B, B);
   }
 
   /* 5.  while v is even do */
-  while (fp_iseven (&v) == FP_YES) {
+  while (fp_iseven (v) == FP_YES) {
     /* 5.1 v = v/2 */
-    fp_div_2 (&v, &v);
+    fp_div_2 (v, v);
 
     /* 5.2 if D is odd then */
-    if (fp_isodd (&D) == FP_YES) {
+    if (fp_isodd (D) == FP_YES) {
       /* D = (D-x)/2 */
-      fp_sub (&D, &x, &D);
+      fp_sub (D, x, D);
     }
     /* D = D/2 */
-    fp_div_2 (&D, &D);
+    fp_div_2 (D, D);
   }
 
   /* 6.  if u >= v then */
-  if (fp_cmp (&u, &v) != FP_LT) {
+  if (fp_cmp (u, v) != FP_LT) {
     /* u = u - v, B = B - D */
-    fp_sub (&u, &v, &u);
-    fp_sub (&B, &D, &B);
+    fp_sub (u, v, u);
+    fp_sub (B, D, B);
   } else {
     /* v - v - u, D = D - B */
-    fp_sub (&v, &u, &v);
-    fp_sub (&D, &B, &D);
+    fp_sub (v, u, v);
+    fp_sub (D, B, D);
   }
 
   /* if not zero goto step 4 */
-  if (fp_iszero (&u) == FP_NO) {
+  if (fp_iszero (u) == FP_NO) {
     goto top;
   }
 
   /* now a = C, b = D, gcd == g*v */
 
   /* if v != 1 then there is no inverse */
-  if (fp_cmp_d (&v, 1) != FP_EQ) {
+  if (fp_cmp_d (v, 1) != FP_EQ) {
     return FP_VAL;
   }
 
   /* b is now the inverse */
   neg = a->sign;
-  while (D.sign == FP_NEG) {
-    fp_add (&D, b, &D);
+  while (D->sign == FP_NEG) {
+    fp_add (D, b, D);
   }
-  fp_copy (&D, c);
+  fp_copy (D, c);
   c->sign = neg;
   return FP_OKAY;
 }
 
+/* c = 1/a (mod b) for odd b only, heap temps with CYASSL_SMALL_STACK */
+int fp_invmod(fp_int *a, fp_int *b, fp_int *c)
+{
+#ifdef CYASSL_SMALL_STACK
+  fp_int *t;
+  int     err;
+
+  t = (fp_int*)XMALLOC(sizeof(fp_int) * 6, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+  if (t == NULL)
+    return FP_MEM;
+  err = _fp_invmod(a, b, c, t);
+  XFREE(t, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+  return err;
+#else
+  fp_int  t[6];
+
+  return _fp_invmod(a, b, c, t);
+#endif
+}
+
 /* d = a * b (mod c) */
 int fp_mulmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d)
 {
   fp_int tmp;
-  fp_zero(&tmp);
+  fp_init(&tmp);
   fp_mul(a, b, &tmp);
   return fp_mod(&tmp, c, d);
 }
 
+/* R^2 mod m and mp, what every exptmod over m starts from */
+int fp_mont_ctx_setup(fp_mont_ctx *mc, fp_int *m)
+{
+   int err;
+
+   mc->ready = 0;
+   if (m->used > (FP_SIZE/2))
+      return FP_VAL;
+   if ((err = fp_montgomery_setup(m, &mc->mp)) != FP_OKAY)
+      return err;
+
+   fp_init(&mc->rr);
+   fp_montgomery_calc_normalization(&mc->rr, m);
+   if ((err = fp_mulmod(&mc->rr, &mc->rr, m, &mc->rr)) != FP_OKAY)
+      return err;
+
+   mc->ready = 1;
+   return FP_OKAY;
+}
+
+/* gr = G * R mod P and r = R mod P, the starting values of an exptmod. With
+   a ready mc both come from two Montgomery reductions instead of a division */
+static int fp_mont_start(fp_int *G, fp_int *P, const fp_mont_ctx *mc,
+                         fp_digit mp, fp_int *gr, fp_int *r)
+{
+   int err;
+
+   if (fp_cmp_mag(P, G) != FP_GT) {
+      /* G > P so we reduce it first */
+      if ((err = fp_mod(G, P, gr)) != FP_OKAY)
+         return err;
+   } else {
+      fp_copy(G, gr);
+   }
+
+   if (mc != NULL) {
+      fp_mul(gr, (fp_int*)&mc->rr, gr);
+      fp_montgomery_reduce(gr, P, mp);
+      fp_copy((fp_int*)&mc->rr, r);
+      fp_montgomery_reduce(r, P, mp);
+      return FP_OKAY;
+   }
+
+   fp_montgomery_calc_normalization(r, P);
+   return fp_mulmod(gr, r, P, gr);
+}
+
+/* Y = G^65537 mod P, the public exponent nearly every RSA key has. Sixteen
+   squarings and one multiply, the ladder and the window both spend more */
+static int _fp_exptmod_f4(fp_int * G, fp_int * P, const fp_mont_ctx * mc,
+                          fp_int * Y)
+{
+  fp_int   gr, res;
+  fp_digit mp;
+  int      err, x;
+
+  if (mc != NULL) {
+     mp = mc->mp;
+  } else if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
+     return err;
+  }
+
+  fp_init(&gr);
+  fp_init(&res);
+
+  /* gr = G * R mod P, res is scratch */
+  if ((err = fp_mont_start(G, P, mc, mp, &gr, &res)) != FP_OKAY) {
+     return err;
+  }
+
+  fp_copy(&gr, &res);
+  for (x = 0; x < 16; x++) {
+    fp_sqr(&res, &res);
+    fp_montgomery_reduce(&res, P, mp);
+  }
+  fp_mul(&res, &gr, &res);
+  fp_montgomery_reduce(&res, P, mp);
+
+  /* back out of Montgomery form */
+  fp_montgomery_reduce(&res, P, mp);
+  fp_copy(&res, Y);
+  return FP_OKAY;
+}
+
 #ifdef TFM_TIMING_RESISTANT
 
 /* timing resistant montgomery ladder based exptmod 
 
    Based on work by Marc Joye, Sung-Ming Yen, "The Montgomery Powering Ladder", Cryptographic Hardware and Embedded Systems, CHES 2002
 */
-static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
+static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P,
+                       const fp_mont_ctx * mc, fp_int * Y)
 {
   fp_int   R[2];
   fp_digit buf, mp;
   int      err, bitcnt, digidx, y;
 
   /* now setup montgomery  */
-  if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
+  if (mc != NULL) {
+     mp = mc->mp;
+  } else if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
      return err;
   }
 
   fp_init(&R[0]);   
   fp_init(&R[1]);   
    
-  /* now we need R mod m */
-  fp_montgomery_calc_normalization (&R[0], P);
-
-  /* now set R[0][1] to G * R mod m */
-  if (fp_cmp_mag(P, G) != FP_GT) {
-     /* G > P so we reduce it first */
-     fp_mod(G, P, &R[1]);
-  } else {
-     fp_copy(G, &R[1]);
+  /* now set R[0] to R mod m and R[1] to G * R mod m */
+  if ((err = fp_mont_start(G, P, mc, mp, &R[1], &R[0])) != FP_OKAY) {
+     return err;
   }
-  fp_mulmod (&R[1], &R[0], P, &R[1]);
 
   /* for j = t-1 downto 0 do
         r_!k = R0*R1; r_k = r_k^2
@@ -999,9 +1375,15 @@ static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
 /* y = g**x (mod b) 
  * Some restrictions... x must be positive and < b
  */
-static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
+static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P,
+                       const fp_mont_ctx * mc, fp_int * Y)
 {
-  fp_int   M[64], res;
+#ifdef CYASSL_SMALL_STACK
+  fp_int  *M;
+#else
+  fp_int   M[64];
+#endif
+  fp_int   res;
   fp_digit buf, mp;
   int      err, bitbuf, bitcpy, bitcnt, mode, digidx, x, y, winsize;
 
@@ -1019,14 +1401,24 @@ static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
     winsize = 6;
   } 
 
-  /* init M array */
-  XMEMSET(M, 0, sizeof(M)); 
-
   /* now setup montgomery  */
-  if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
+  if (mc != NULL) {
+     mp = mc->mp;
+  } else if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
      return err;
   }
 
+  /* init M array, only the window's entries are used */
+#ifdef CYASSL_SMALL_STACK
+  M = (fp_int*)XMALLOC(sizeof(fp_int) * (1 << winsize), NULL,
+                       DYNAMIC_TYPE_TMP_BUFFER);
+  if (M == NULL)
+     return FP_MEM;
+  XMEMSET(M, 0, sizeof(fp_int) * (1 << winsize));
+#else
+  XMEMSET(M, 0, sizeof(M));
+#endif
+
   /* setup result */
   fp_init(&res);
 
@@ -1037,17 +1429,13 @@ static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
    * The first half of the table is not computed though accept for M[0] and M[1]
    */
 
-   /* now we need R mod m */
-   fp_montgomery_calc_normalization (&res, P);
-
-   /* now set M[1] to G * R mod m */
-   if (fp_cmp_mag(P, G) != FP_GT) {
-      /* G > P so we reduce it first */
-      fp_mod(G, P, &M[1]);
-   } else {
-      fp_copy(G, &M[1]);
+   /* now we need R mod m, and M[1] set to G * R mod m */
+   if ((err = fp_mont_start(G, P, mc, mp, &M[1], &res)) != FP_OKAY) {
+#ifdef CYASSL_SMALL_STACK
+      XFREE(M, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+      return err;
    }
-   fp_mulmod (&M[1], &res, P, &M[1]);
 
   /* compute the value at M[1<<(winsize-1)] by squaring M[1] (winsize-1) times */
   fp_copy (&M[1], &M[1 << (winsize - 1)]);
@@ -1152,30 +1540,43 @@ static int _fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
 
   /* swap res with Y */
   fp_copy (&res, Y);
+#ifdef CYASSL_SMALL_STACK
+  XFREE(M, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
   return FP_OKAY;
 }
 
 #endif
 
 int fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
+{
+   return fp_exptmod_ex(G, X, P, NULL, Y);
+}
+
+int fp_exptmod_ex(fp_int * G, fp_int * X, fp_int * P, const fp_mont_ctx * mc,
+                  fp_int * Y)
 {
    /* prevent overflows */
    if (P->used > (FP_SIZE/2)) {
       return FP_VAL;
    }
 
+   if (mc != NULL && !mc->ready) {
+      mc = NULL;
+   }
+
    if (X->sign == FP_NEG) {
 #ifndef POSITIVE_EXP_ONLY  /* reduce stack if assume no negatives */
       int    err;
       fp_int tmp;
 
       /* yes, copy G and invmod it */
-      fp_copy(G, &tmp);
+      fp_init_copy(&tmp, G);
       if ((err = fp_invmod(&tmp, P, &tmp)) != FP_OKAY) {
          return err;
       }
       X->sign = FP_ZPOS;
-      err =  _fp_exptmod(&tmp, X, P, Y);
+      err =  _fp_exptmod(&tmp, X, P, mc, Y);
       if (X != Y) {
          X->sign = FP_NEG;
       }
@@ -1184,12 +1585,434 @@ int fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
       return FP_VAL;
 #endif 
    }
+   else if (X->used == 1 && X->dp[0] == 0x10001) {
+      /* RSA public exponent, not secret so no ladder needed */
+      return _fp_exptmod_f4(G, P, mc, Y);
+   }
    else {
       /* Positive exponent so just exptmod */
-      return _fp_exptmod(G, X, P, Y);
+      return _fp_exptmod(G, X, P, mc, Y);
+   }
+}
+
+/* Constant time exponentiation for private exponents: fixed 5 bit windows
+   over every digit of X and a table read that touches all 32 entries, on
+   Montgomery products computed straight on the digit arrays. Sizes of 16,
+   24 and 32 digits (the CRT halves of RSA 2048, 3072 and 4096) get fully
+   unrolled MULX/ADX rows when the cpu has them */
+#define FP_CT_WINSIZE 5
+#define FP_CT_TABLE   (1 << FP_CT_WINSIZE)
+
+#if defined(TFM_X86_64) && defined(HAVE_CYASSL_X86_SIMD)
+    #define HAVE_FP_MONT_MULX
+#endif
+
+/* r = a - m unless that borrows, then r = a. a has n + 1 digits */
+static void fp_mont_sub_ct(fp_digit* r, const fp_digit* a, const fp_digit* m,
+                           int n)
+{
+   fp_word  w;
+   fp_digit b = 0;
+   int      j;
+
+   for (j = 0; j < n; j++) {
+      w    = (fp_word)a[j] - m[j] - b;
+      r[j] = (fp_digit)w;
+      b    = (fp_digit)(w >> DIGIT_BIT) & 1;
+   }
+   b = 0 - (fp_digit)(a[n] < b);        /* all ones keeps a */
+   for (j = 0; j < n; j++)
+      r[j] = (a[j] & b) | (r[j] & ~b);
+}
+
+/* r = a * b / R mod m on n digit arrays, r may alias a or b. The comba
+   product and reduction rows of fp_mul and fp_montgomery_reduce, with the
+   carry out of each row kept in a word instead of rippled as far as it
+   goes, so the work only depends on n. c is scratch for 2n + 2 digits */
+static void fp_mont_mul_comba(fp_digit* r, const fp_digit* a,
+                              const fp_digit* b, const fp_digit* m,
+                              fp_digit mp, fp_digit* c, int n)
+{
+   int             ix, iy, iz, tx, ty, x, y;
+   fp_digit        c0, c1, c2, *tmpx, *tmpy, *_c, *tmpm, mu = 0, hi = 0;
+   fp_word         w;
+
+   COMBA_START;
+   COMBA_CLEAR;
+
+   for (ix = 0; ix < 2 * n; ix++) {
+      ty   = MIN(ix, n - 1);
+      tx   = ix - ty;
+      tmpx = (fp_digit*)a + tx;
+      tmpy = (fp_digit*)b + ty;
+      iy   = MIN(n - tx, ty + 1);
+
+      COMBA_FORWARD;
+      for (iz = 0; iz < iy; ++iz) {
+          MULADD(*tmpx++, *tmpy--);
+      }
+      COMBA_STORE(c[ix]);
+   }
+   COMBA_FINI;
+   c[2 * n] = 0;
+
+   MONT_START;
+   for (x = 0; x < n; x++) {
+      fp_digit cy = 0;
+
+      LOOP_START;
+      _c   = c + x;
+      tmpm = (fp_digit*)m;
+      y    = 0;
+   #if (defined(TFM_SSE2) || defined(TFM_X86_64))
+      for (; y < (n & ~7); y += 8) {
+         INNERMUL8;
+         _c   += 8;
+         tmpm += 8;
+      }
+   #endif
+      for (; y < n; y++) {
+         INNERMUL;
+         ++_c;
+      }
+      LOOP_END;
+
+      w     = (fp_word)_c[0] + cy + hi;
+      _c[0] = (fp_digit)w;
+      hi    = (fp_digit)(w >> DIGIT_BIT);
+   }
+   MONT_FINI;
+   c[2 * n] = hi;
+
+   (void)mu;
+   fp_mont_sub_ct(r, c + n, m, n);
+}
+
+#ifdef HAVE_FP_MONT_MULX
+
+/* one operand scanning round with two carry chains, adcx for the low
+   halves and adox for the high ones, running over n digits of t:
+   t += ai * b, then t = (t + (t[0] * mp) * m) / 2^64. t holds n + 2 digits
+   after a scratch one at t[-1] that the shifted row writes its zero to */
+#define FP_MONT_MULX_ROUND(n)                                          \
+__asm__ __volatile__(                                                  \
+   "movq   %[ai], %%rdx            \n\t"                               \
+   "xorl   %%r8d, %%r8d            \n\t"                               \
+   "movq   (%[t]), %%r9            \n\t"                               \
+   ".set   .Lcya_o, 0              \n\t"                               \
+   ".rept  " #n "                  \n\t"                               \
+   "mulxq  .Lcya_o(%[b]), %%rax, %%r10 \n\t"                           \
+   "adcxq  %%rax, %%r9             \n\t"                               \
+   "movq   %%r9, .Lcya_o(%[t])     \n\t"                               \
+   "movq   .Lcya_o+8(%[t]), %%r9   \n\t"                               \
+   "adoxq  %%r10, %%r9             \n\t"                               \
+   ".set   .Lcya_o, .Lcya_o+8      \n\t"                               \
+   ".endr                          \n\t"                               \
+   "adcxq  %%r8, %%r9              \n\t"                               \
+   "movq   %%r9, " #n "*8(%[t])    \n\t"                               \
+   "movl   $0, %%r9d               \n\t"                               \
+   "adcxq  %%r8, %%r9              \n\t"                               \
+   "adoxq  %%r8, %%r9              \n\t"                               \
+   "movq   %%r9, " #n "*8+8(%[t])  \n\t"                               \
+                                                                       \
+   "movq   (%[t]), %%rdx           \n\t"                               \
+   "imulq  %[mp], %%rdx            \n\t"                               \
+   "xorl   %%r8d, %%r8d            \n\t"                               \
+   "movq   (%[t]), %%r9            \n\t"                               \
+   ".set   .Lcya_o, 0              \n\t"                               \
+   ".rept  " #n "                  \n\t"                               \
+   "mulxq  .Lcya_o(%[m]), %%rax, %%r10 \n\t"                           \
+   "adcxq  %%rax, %%r9             \n\t"                               \
+   "movq   %%r9, .Lcya_o-8(%[t])   \n\t"                               \
+   "movq   .Lcya_o+8(%[t]), %%r9   \n\t"                               \
+   "adoxq  %%r10, %%r9             \n\t"                               \
+   ".set   .Lcya_o, .Lcya_o+8      \n\t"                               \
+   ".endr                          \n\t"                               \
+   "adcxq  %%r8, %%r9              \n\t"                               \
+   "movq   %%r9, " #n "*8-8(%[t])  \n\t"                               \
+   "movq   " #n "*8+8(%[t]), %%r9  \n\t"                               \
+   "adcxq  %%r8, %%r9              \n\t"                               \
+   "adoxq  %%r8, %%r9              \n\t"                               \
+   "movq   %%r9, " #n "*8(%[t])    \n\t"                               \
+   :                                                                   \
+   : [t] "r" (t), [b] "r" (b), [m] "r" (m), [ai] "r" (a[i]),           \
+     [mp] "r" (mp)                                                     \
+   : "%rax", "%rdx", "%r8", "%r9", "%r10", "cc", "memory")
+
+#define FP_MONT_MULX(n)                                                \
+static void fp_mont_mul_mulx##n(fp_digit* r, const fp_digit* a,        \
+                                const fp_digit* b, const fp_digit* m,  \
+                                fp_digit mp, fp_digit* t)              \
+{                                                                      \
+   int i, j;                                                           \
+                                                                       \
+   t++;                                   /* t[-1] is scratch */       \
+   for (j = 0; j < n + 2; j++)                                         \
+      t[j] = 0;                                                        \
+   for (i = 0; i < n; i++)                                             \
+      FP_MONT_MULX_ROUND(n);                                           \
+                                                                       \
+   fp_mont_sub_ct(r, t, m, n);                                         \
+}
+
+FP_MONT_MULX(16)
+FP_MONT_MULX(24)
+FP_MONT_MULX(32)
+
+#endif /* HAVE_FP_MONT_MULX */
+
+typedef void (*fp_mont_mul_fn)(fp_digit*, const fp_digit*, const fp_digit*,
+                               const fp_digit*, fp_digit, fp_digit*);
+
+/* the unrolled MULX/ADX product for an n digit modulus, NULL for comba */
+static fp_mont_mul_fn fp_mont_mul_pick(int n)
+{
+#ifdef HAVE_FP_MONT_MULX
+   if ((CyaSSL_GetCpuFeatures() & (CYASSL_CPU_BMI2 | CYASSL_CPU_ADX)) ==
+                                          (CYASSL_CPU_BMI2 | CYASSL_CPU_ADX)) {
+      if (n == 16)
+         return fp_mont_mul_mulx16;
+      else if (n == 24)
+         return fp_mont_mul_mulx24;
+      else if (n == 32)
+         return fp_mont_mul_mulx32;
+   }
+#endif
+   (void)n;
+   return NULL;
+}
+
+int fp_exptmod_ct(fp_int *G, fp_int *X, fp_int *P, fp_int *Y)
+{
+   return fp_exptmod_ct_ex(G, X, P, NULL, Y);
+}
+
+/* Y = G^X mod P, P odd. Run time depends only on the digit counts of X and
+   P, not their values */
+int fp_exptmod_ct_ex(fp_int *G, fp_int *X, fp_int *P, const fp_mont_ctx *mc,
+                     fp_int *Y)
+{
+   fp_digit        mp, w, mask;
+#ifdef CYASSL_SMALL_STACK
+   fp_digit        (*tbl)[FP_SIZE/2];
+#else
+   fp_digit        tbl[FP_CT_TABLE][FP_SIZE/2];
+#endif
+   fp_digit        acc[FP_SIZE/2], sel[FP_SIZE/2], t[FP_SIZE + 2];
+   fp_mont_mul_fn  mulx;
+   fp_int          tmp, r;
+   int             n, i, j, k, bits, err;
+
+   n = P->used;
+   if (n > (FP_SIZE/2) - 1 || n == 0 || X->sign == FP_NEG)
+      return FP_VAL;
+   if (mc != NULL && !mc->ready)
+      mc = NULL;
+   if (mc != NULL)
+      mp = mc->mp;
+   else if ((err = fp_montgomery_setup(P, &mp)) != FP_OKAY)
+      return err;
+
+#ifdef CYASSL_SMALL_STACK
+   tbl = (fp_digit (*)[FP_SIZE/2])XMALLOC(FP_CT_TABLE * sizeof(*tbl), NULL,
+                                          DYNAMIC_TYPE_TMP_BUFFER);
+   if (tbl == NULL)
+      return FP_MEM;
+#endif
+
+   mulx = fp_mont_mul_pick(n);
+
+   #define FP_CT_MUL(r, a, b)                                          \
+      do {                                                             \
+         if (mulx)                                                     \
+            mulx(r, a, b, P->dp, mp, t);                               \
+         else                                                          \
+            fp_mont_mul_comba(r, a, b, P->dp, mp, t, n);               \
+      } while (0)
+
+   /* tbl[0] = R mod P, tbl[1] = G * R mod P, then successive products */
+   fp_init(&tmp);
+   fp_init(&r);
+   if ((err = fp_mont_start(G, P, mc, mp, &tmp, &r)) != FP_OKAY) {
+#ifdef CYASSL_SMALL_STACK
+      XFREE(tbl, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+      return err;
+   }
+
+   XMEMSET(tbl, 0, 2 * sizeof(tbl[0]));
+   XMEMCPY(tbl[0], r.dp, r.used * sizeof(fp_digit));
+   XMEMCPY(tbl[1], tmp.dp, tmp.used * sizeof(fp_digit));
+   for (i = 2; i < FP_CT_TABLE; i++)
+      FP_CT_MUL(tbl[i], tbl[i-1], tbl[1]);
+
+   XMEMCPY(acc, tbl[0], n * sizeof(fp_digit));
+
+   /* windows from the top of X's digits, padded to a multiple of 5 */
+   bits = X->used * DIGIT_BIT;
+   bits = ((bits + FP_CT_WINSIZE - 1) / FP_CT_WINSIZE) * FP_CT_WINSIZE;
+   for (i = bits - FP_CT_WINSIZE; i >= 0; i -= FP_CT_WINSIZE) {
+      w = 0;
+      for (k = FP_CT_WINSIZE - 1; k >= 0; k--) {
+         int b = i + k;
+         w <<= 1;
+         if (b < X->used * DIGIT_BIT)
+            w |= (X->dp[b / DIGIT_BIT] >> (b % DIGIT_BIT)) & 1;
+      }
+
+      for (k = 0; k < FP_CT_WINSIZE; k++)
+         FP_CT_MUL(acc, acc, acc);
+
+      /* read every entry, keep the one at w */
+      for (j = 0; j < n; j++)
+         sel[j] = 0;
+      for (k = 0; k < FP_CT_TABLE; k++) {
+         mask = (fp_digit)k ^ w;
+         mask = ((mask | (0 - mask)) >> (DIGIT_BIT - 1)) - 1;
+         for (j = 0; j < n; j++)
+            sel[j] |= tbl[k][j] & mask;
+      }
+      FP_CT_MUL(acc, acc, sel);
+   }
+
+   /* out of Montgomery form, multiply by 1 */
+   XMEMSET(sel, 0, n * sizeof(fp_digit));
+   sel[0] = 1;
+   FP_CT_MUL(acc, acc, sel);
+
+   #undef FP_CT_MUL
+
+   fp_zero(Y);
+   XMEMCPY(Y->dp, acc, n * sizeof(fp_digit));
+   Y->used = n;
+   fp_clamp(Y);
+
+   XMEMSET(acc, 0, sizeof(acc));
+   XMEMSET(sel, 0, sizeof(sel));
+   XMEMSET(tbl, 0, FP_CT_TABLE * sizeof(tbl[0]));
+#ifdef CYASSL_SMALL_STACK
+   XFREE(tbl, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+   return FP_OKAY;
+}
+
+#define FP_COMB_TABLE (1 << FP_COMB_TEETH)
+
+#define FP_COMB_MUL(r, a, b)                                           \
+   do {                                                                \
+      if (mulx)                                                        \
+         mulx(r, a, b, P->dp, mc->mp, t);                              \
+      else                                                             \
+         fp_mont_mul_comba(r, a, b, P->dp, mc->mp, t, n);              \
+   } while (0)
+
+void fp_comb_ctx_init(fp_comb_ctx *cc)
+{
+   cc->ready = 0;
+}
+
+int fp_comb_ctx_setup(fp_comb_ctx *cc, fp_int *G, fp_int *P,
+                      const fp_mont_ctx *mc, int bits)
+{
+   fp_digit        base[FP_SIZE/2], t[FP_SIZE + 2];
+   fp_mont_mul_fn  mulx;
+   fp_int          g, r;
+   int             n, i, j, k, err;
+
+   cc->ready = 0;
+   n = P->used;
+   if (n > (FP_SIZE/2) - 1 || n == 0 || bits <= 0 || mc == NULL || !mc->ready)
+      return FP_VAL;
+   mulx = fp_mont_mul_pick(n);
+
+   fp_init(&g);
+   fp_init(&r);
+   if ((err = fp_mont_start(G, P, mc, mc->mp, &g, &r)) != FP_OKAY)
+      return err;
+
+   cc->spacing = (bits + FP_COMB_TEETH - 1) / FP_COMB_TEETH;
+   cc->used    = n;
+
+   XMEMSET(cc->table, 0, sizeof(cc->table));
+   XMEMSET(base, 0, sizeof(base));
+   XMEMCPY(cc->table[0], r.dp, r.used * sizeof(fp_digit));
+   XMEMCPY(base, g.dp, g.used * sizeof(fp_digit));
+
+   /* base steps through G^(2^(k * spacing)), the entries with k as their top
+      bit are the ones below them times base */
+   for (k = 0; k < FP_COMB_TEETH; k++) {
+      if (k > 0)
+         for (i = 0; i < cc->spacing; i++)
+            FP_COMB_MUL(base, base, base);
+      for (j = 1 << k; j < (2 << k); j++)
+         FP_COMB_MUL(cc->table[j], cc->table[j - (1 << k)], base);
+   }
+
+   XMEMSET(base, 0, sizeof(base));
+   cc->ready = 1;
+
+   return FP_OKAY;
+}
+
+int fp_exptmod_comb(fp_int *G, fp_int *X, fp_int *P, const fp_mont_ctx *mc,
+                    const fp_comb_ctx *cc, fp_int *Y)
+{
+   fp_digit        acc[FP_SIZE/2], sel[FP_SIZE/2], t[FP_SIZE + 2], w, mask;
+   fp_mont_mul_fn  mulx;
+   int             n, i, j, k, b;
+
+   n = P->used;
+   if (cc == NULL || !cc->ready || mc == NULL || !mc->ready ||
+       cc->used != n || X->sign == FP_NEG ||
+       fp_count_bits(X) > FP_COMB_TEETH * cc->spacing)
+      return fp_exptmod_ex(G, X, P, mc, Y);
+   mulx = fp_mont_mul_pick(n);
+
+   XMEMCPY(acc, cc->table[0], n * sizeof(fp_digit));
+
+   /* one squaring per bit of spacing, each column of teeth is an entry */
+   for (i = cc->spacing - 1; i >= 0; i--) {
+      w = 0;
+      for (k = FP_COMB_TEETH - 1; k >= 0; k--) {
+         b = k * cc->spacing + i;
+         w <<= 1;
+         if (b < X->used * DIGIT_BIT)
+            w |= (X->dp[b / DIGIT_BIT] >> (b % DIGIT_BIT)) & 1;
+      }
+
+      FP_COMB_MUL(acc, acc, acc);
+
+      /* read every entry, keep the one at w */
+      for (j = 0; j < n; j++)
+         sel[j] = 0;
+      for (k = 0; k < FP_COMB_TABLE; k++) {
+         mask = (fp_digit)k ^ w;
+         mask = ((mask | (0 - mask)) >> (DIGIT_BIT - 1)) - 1;
+         for (j = 0; j < n; j++)
+            sel[j] |= cc->table[k][j] & mask;
+      }
+      FP_COMB_MUL(acc, acc, sel);
    }
+
+   /* out of Montgomery form, multiply by 1 */
+   XMEMSET(sel, 0, n * sizeof(fp_digit));
+   sel[0] = 1;
+   FP_COMB_MUL(acc, acc, sel);
+
+   fp_zero(Y);
+   XMEMCPY(Y->dp, acc, n * sizeof(fp_digit));
+   Y->used = n;
+   fp_clamp(Y);
+
+   XMEMSET(acc, 0, sizeof(acc));
+   XMEMSET(sel, 0, sizeof(sel));
+
+   return FP_OKAY;
 }
 
+#undef FP_COMB_MUL
+
 /* computes a = 2**b */
 void fp_2expt(fp_int *a, int b)
 {
@@ -1225,6 +2048,20 @@ void fp_sqr(fp_int *A, fp_int *B)
        return ;
     }
 
+#ifdef HAVE_FP_MULX
+    if (y >= FP_MULX_MIN && y + y < FP_SIZE && fp_use_mulx()) {
+       fp_sqr_mulx(A, B);
+       return;
+    }
+#endif
+
+    /* after MULX, its squaring already skips half the products and beats
+       the split at every size */
+    if (y >= FP_KARATSUBA_MIN && y + y < FP_SIZE &&
+        fp_mul_karatsuba(A, NULL, B, (y + 1) / 2) == FP_OKAY) {
+       return;
+    }
+
 #if defined(TFM_SQR3)
         if (y <= 3) {
            fp_sqr_comba3(A,B);
@@ -1339,7 +2176,7 @@ void fp_sqr_comba(fp_int *A, fp_int *B)
   COMBA_CLEAR;
 
   if (A == B) {
-     fp_zero(&tmp);
+     fp_init(&tmp);
      dst = &tmp;
   } else {
      fp_zero(B);
@@ -1530,6 +2367,9 @@ void fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
 {
    fp_digit c[FP_SIZE], *_c, *tmpm, mu = 0;
    int      oldused, x, y, pa;
+#ifdef HAVE_FP_MULX
+   int      mulx;
+#endif
 
    /* bail if too large */
    if (m->used > (FP_SIZE/2)) {
@@ -1537,8 +2377,16 @@ void fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
       return;
    }
 
+#ifdef HAVE_FP_MULX
+   mulx = m->used >= FP_MULX_MIN && fp_use_mulx();
+#endif
+
 #ifdef TFM_SMALL_MONT_SET
+   #ifdef HAVE_FP_MULX
+   if (m->used <= 16 && !mulx) {
+   #else
    if (m->used <= 16) {
+   #endif
       fp_montgomery_reduce_small(a, m, mp);
       return;
    }
@@ -1563,6 +2411,13 @@ void fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
        _c   = c + x;
        tmpm = m->dp;
        y = 0;
+       #ifdef HAVE_FP_MULX
+        if (mulx) {
+           cy = fp_mulx_row(_c, tmpm, mu, pa);
+           _c += pa;
+           y   = pa;
+        }
+       #endif
        #if (defined(TFM_SSE2) || defined(TFM_X86_64))
         for (; y < (pa & ~7); y += 8) {
               INNERMUL8;
@@ -1609,6 +2464,15 @@ void fp_read_unsigned_bin(fp_int *a, unsigned char *b, int c)
   /* zero the int */
   fp_zero (a);
 
+#ifdef ALT_ECC_SIZE
+  /* a short int keeps the low order bytes, as a full one does below */
+  if ((unsigned)c > FP_INT_SIZE(a) * sizeof(fp_digit)) {
+     int excess = c - (FP_INT_SIZE(a) * sizeof(fp_digit));
+     c -= excess;
+     b += excess;
+  }
+#endif
+
   /* If we know the endianness of this architecture, and we're using
      32-bit fp_digits, we can optimize this */
 #if (defined(LITTLE_ENDIAN_ORDER) || defined(BIG_ENDIAN_ORDER)) && defined(FP_32BIT)
@@ -1829,7 +2693,9 @@ void fp_reverse (unsigned char *s, int len)
 void fp_sub_d(fp_int *a, fp_digit b, fp_int *c)
 {
    fp_int tmp;
-   fp_set(&tmp, b);
+   fp_init(&tmp);
+   tmp.dp[0] = b;
+   tmp.used  = b ? 1 : 0;
    fp_sub(a, &tmp, c);
 }
 
@@ -1918,6 +2784,52 @@ int mp_exptmod (mp_int * G, mp_int * X, mp_int * P, mp_int * Y)
   return fp_exptmod(G, X, P, Y);
 }
 
+/* exptmod for secret exponents, P odd */
+int mp_exptmod_ct (mp_int * G, mp_int * X, mp_int * P, mp_int * Y)
+{
+  return fp_exptmod_ct(G, X, P, Y);
+}
+
+void mp_mont_ctx_init (mp_mont_ctx * mc)
+{
+  mc->ready = 0;
+}
+
+int mp_mont_ctx_setup (mp_mont_ctx * mc, mp_int * m)
+{
+  return fp_mont_ctx_setup(mc, m);
+}
+
+int mp_exptmod_ex (mp_int * G, mp_int * X, mp_int * P,
+                   const mp_mont_ctx * mc, mp_int * Y)
+{
+  return fp_exptmod_ex(G, X, P, mc, Y);
+}
+
+int mp_exptmod_ct_ex (mp_int * G, mp_int * X, mp_int * P,
+                      const mp_mont_ctx * mc, mp_int * Y)
+{
+  return fp_exptmod_ct_ex(G, X, P, mc, Y);
+}
+
+void mp_comb_ctx_init (mp_comb_ctx * cc)
+{
+  fp_comb_ctx_init(cc);
+}
+
+int mp_comb_ctx_setup (mp_comb_ctx * cc, mp_int * G, mp_int * P,
+                       const mp_mont_ctx * mc, int bits)
+{
+  return fp_comb_ctx_setup(cc, G, P, mc, bits);
+}
+
+int mp_exptmod_comb (mp_int * G, mp_int * X, mp_int * P,
+                     const mp_mont_ctx * mc, const mp_comb_ctx * cc,
+                     mp_int * Y)
+{
+  return fp_exptmod_comb(G, X, P, mc, cc, Y);
+}
+
 /* compare two ints (signed)*/
 int mp_cmp (mp_int * a, mp_int * b)
 {
@@ -2014,7 +2926,7 @@ int mp_set_int(fp_int *a, fp_digit b)
 int fp_sqrmod(fp_int *a, fp_int *b, fp_int *c)
 {
   fp_int tmp;
-  fp_zero(&tmp);
+  fp_init(&tmp);
   fp_sqr(a, &tmp);
   return fp_mod(&tmp, b, c);
 }
@@ -2376,7 +3288,7 @@ void fp_gcd(fp_int *a, fp_int *b, fp_int *c)
       fp_init_copy(&v, a);
    }
  
-   fp_zero(&r);
+   fp_init(&r);
    while (fp_iszero(&v) == FP_NO) {
       fp_mod(&u, &v, &r);
       fp_copy(&v, &u);
@@ -2388,12 +3300,14 @@ void fp_gcd(fp_int *a, fp_int *b, fp_int *c)
 #endif /* CYASSL_KEY_GEN */
 
 
-#if defined(HAVE_ECC) || !defined(NO_PWDBASED)
+#if defined(HAVE_ECC) || !defined(NO_PWDBASED) || defined(CYASSL_KEY_GEN)
 /* c = a + b */
 void fp_add_d(fp_int *a, fp_digit b, fp_int *c)
 {
    fp_int tmp;
-   fp_set(&tmp, b);
+   fp_init(&tmp);
+   tmp.dp[0] = b;
+   tmp.used  = b ? 1 : 0;
    fp_add(a,&tmp,c);
 }
 
@@ -2404,7 +3318,7 @@ int mp_add_d(fp_int *a, fp_digit b, fp_int *c)
     return MP_OKAY;
 }
 
-#endif  /* HAVE_ECC || !NO_PWDBASED */
+#endif  /* HAVE_ECC || !NO_PWDBASED || CYASSL_KEY_GEN */
 
 
 #ifdef HAVE_ECC
@@ -2453,6 +3367,11 @@ static int fp_read_radix(fp_int *a, const char *str, int radix)
      * to the number, otherwise exit the loop.
      */
     if (y < radix) {
+#ifdef ALT_ECC_SIZE
+      /* too long for a short int */
+      if (a->used >= FP_INT_SIZE(a) - 1)
+         return FP_VAL;
+#endif
       fp_mul_d (a, (fp_digit) radix, a);
       fp_add_d (a, (fp_digit) y, a);
     } else {
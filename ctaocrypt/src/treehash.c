@@ -0,0 +1,397 @@
+/* treehash.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#ifdef CYASSL_TREE_HASH
+
+#include <cyassl/ctaocrypt/treehash.h>
+#include <cyassl/ctaocrypt/sha.h>
+#include <cyassl/ctaocrypt/sha256.h>
+#include <cyassl/ctaocrypt/sha512.h>
+#include <cyassl/ctaocrypt/blake2.h>
+#include <cyassl/ctaocrypt/wc_port.h>
+#include <cyassl/ctaocrypt/error-crypt.h>
+#include <cyassl/ctaocrypt/logging.h>
+
+#if !defined(NO_FILESYSTEM) && !defined(USE_WINDOWS_API) && !defined(EBSNET)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define TREE_HASH_MMAP
+#endif
+
+#ifdef CYASSL_PTHREADS
+    #include <unistd.h>     /* sysconf */
+#endif
+
+
+/* one hash in flight */
+typedef union {
+#ifndef NO_SHA
+    Sha     sha;
+#endif
+#ifndef NO_SHA256
+    Sha256  sha256;
+#endif
+#ifdef CYASSL_SHA384
+    Sha384  sha384;
+#endif
+#ifdef CYASSL_SHA512
+    Sha512  sha512;
+#endif
+#ifdef HAVE_BLAKE2
+    Blake2b blake2b;
+#endif
+} TreeHashState;
+
+
+int TreeHashDigestSize(int hashType)
+{
+    switch (hashType) {
+    #ifndef NO_SHA
+        case SHA:
+            return SHA_DIGEST_SIZE;
+    #endif
+    #ifndef NO_SHA256
+        case SHA256:
+            return SHA256_DIGEST_SIZE;
+    #endif
+    #ifdef CYASSL_SHA384
+        case SHA384:
+            return SHA384_DIGEST_SIZE;
+    #endif
+    #ifdef CYASSL_SHA512
+        case SHA512:
+            return SHA512_DIGEST_SIZE;
+    #endif
+    #ifdef HAVE_BLAKE2
+        case BLAKE2B_ID:
+            return BLAKE2B_OUTBYTES;
+    #endif
+        default:
+            return BAD_FUNC_ARG;
+    }
+}
+
+
+/* out = H(prefix || a || b), b may be empty */
+static int TreeHashNode(int hashType, byte prefix, const byte* a, word32 aSz,
+                        const byte* b, word32 bSz, byte* out)
+{
+    TreeHashState h;
+    int           ret;
+
+    switch (hashType) {
+    #ifndef NO_SHA
+        case SHA:
+            ret = InitSha(&h.sha);
+            if (ret == 0)
+                ret = ShaUpdate(&h.sha, &prefix, 1);
+            if (ret == 0)
+                ret = ShaUpdate(&h.sha, a, aSz);
+            if (ret == 0 && bSz > 0)
+                ret = ShaUpdate(&h.sha, b, bSz);
+            if (ret == 0)
+                ret = ShaFinal(&h.sha, out);
+            break;
+    #endif
+    #ifndef NO_SHA256
+        case SHA256:
+            ret = InitSha256(&h.sha256);
+            if (ret == 0)
+                ret = Sha256Update(&h.sha256, &prefix, 1);
+            if (ret == 0)
+                ret = Sha256Update(&h.sha256, a, aSz);
+            if (ret == 0 && bSz > 0)
+                ret = Sha256Update(&h.sha256, b, bSz);
+            if (ret == 0)
+                ret = Sha256Final(&h.sha256, out);
+            break;
+    #endif
+    #ifdef CYASSL_SHA384
+        case SHA384:
+            ret = InitSha384(&h.sha384);
+            if (ret == 0)
+                ret = Sha384Update(&h.sha384, &prefix, 1);
+            if (ret == 0)
+                ret = Sha384Update(&h.sha384, a, aSz);
+            if (ret == 0 && bSz > 0)
+                ret = Sha384Update(&h.sha384, b, bSz);
+            if (ret == 0)
+                ret = Sha384Final(&h.sha384, out);
+            break;
+    #endif
+    #ifdef CYASSL_SHA512
+        case SHA512:
+            ret = InitSha512(&h.sha512);
+            if (ret == 0)
+                ret = Sha512Update(&h.sha512, &prefix, 1);
+            if (ret == 0)
+                ret = Sha512Update(&h.sha512, a, aSz);
+            if (ret == 0 && bSz > 0)
+                ret = Sha512Update(&h.sha512, b, bSz);
+            if (ret == 0)
+                ret = Sha512Final(&h.sha512, out);
+            break;
+    #endif
+    #ifdef HAVE_BLAKE2
+        case BLAKE2B_ID:
+            ret = InitBlake2b(&h.blake2b, BLAKE2B_OUTBYTES);
+            if (ret == 0)
+                ret = Blake2bUpdate(&h.blake2b, &prefix, 1);
+            if (ret == 0)
+                ret = Blake2bUpdate(&h.blake2b, a, aSz);
+            if (ret == 0 && bSz > 0)
+                ret = Blake2bUpdate(&h.blake2b, b, bSz);
+            if (ret == 0)
+                ret = Blake2bFinal(&h.blake2b, out, BLAKE2B_OUTBYTES);
+            break;
+    #endif
+        default:
+            ret = BAD_FUNC_ARG;
+    }
+
+    return ret;
+}
+
+
+/* leaves shared by the workers, each claims the next one under lock */
+typedef struct TreeHashJob {
+    int           hashType;
+    const byte*   in;
+    word64        inSz;
+    word32        leafSz;
+    word32        digestSz;
+    word64        leaves;
+    word64        next;         /* next leaf to claim */
+    byte*         digests;      /* digestSz bytes per leaf */
+    int           err;          /* first failure, stops the claims */
+    CyaSSL_Mutex  lock;
+} TreeHashJob;
+
+
+static void* TreeHashWorker(void* arg)
+{
+    TreeHashJob* job = (TreeHashJob*)arg;
+    word64       i;
+    word64       off;
+    word32       sz;
+    int          ret;
+
+    for (;;) {
+        LockMutex(&job->lock);
+        i = job->next;
+        if (job->err == 0 && i < job->leaves)
+            job->next++;
+        else
+            i = job->leaves;
+        UnLockMutex(&job->lock);
+
+        if (i == job->leaves)
+            break;
+
+        off = i * job->leafSz;
+        sz  = (job->inSz - off < job->leafSz) ? (word32)(job->inSz - off)
+                                              : job->leafSz;
+
+        ret = TreeHashNode(job->hashType, TREE_HASH_LEAF_PREFIX, job->in + off,
+                           sz, NULL, 0, job->digests + i * job->digestSz);
+        if (ret != 0) {
+            LockMutex(&job->lock);
+            if (job->err == 0)
+                job->err = ret;
+            UnLockMutex(&job->lock);
+        }
+    }
+
+    return NULL;
+}
+
+
+/* hash the leaves on threads, the calling one included */
+static void TreeHashLeaves(TreeHashJob* job, int threads)
+{
+#ifdef CYASSL_PTHREADS
+    pthread_t tid[TREE_HASH_MAX_THREADS];
+    int       started = 0;
+    int       i;
+
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > TREE_HASH_MAX_THREADS)
+        threads = TREE_HASH_MAX_THREADS;
+    if ((word64)threads > job->leaves)
+        threads = (int)job->leaves;
+
+    for (i = 1; i < threads; i++) {
+        if (pthread_create(&tid[started], NULL, TreeHashWorker, job) != 0) {
+            CYASSL_MSG("Tree hash thread failed, going on with fewer");
+            break;
+        }
+        started++;
+    }
+
+    TreeHashWorker(job);
+
+    for (i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+#else
+    (void)threads;
+
+    TreeHashWorker(job);
+#endif
+}
+
+
+int TreeHash(int hashType, const byte* in, word64 inSz, word32 leafSz,
+             int threads, byte* digest)
+{
+    TreeHashJob job;
+    word64      n, j;
+    word32      ds;
+    int         ret;
+
+    if ((in == NULL && inSz > 0) || digest == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = TreeHashDigestSize(hashType);
+    if (ret < 0)
+        return ret;
+    ds = (word32)ret;
+
+    if (leafSz == 0)
+        leafSz = TREE_HASH_LEAF_SIZE;
+
+    XMEMSET(&job, 0, sizeof(job));
+    job.hashType = hashType;
+    job.in       = in;
+    job.inSz     = inSz;
+    job.leafSz   = leafSz;
+    job.digestSz = ds;
+    job.leaves   = (inSz == 0) ? 1 : inSz / leafSz + (inSz % leafSz != 0);
+
+    if (job.leaves > (word64)((size_t)-1) / ds)
+        return MEMORY_E;
+
+    job.digests = (byte*)XMALLOC((size_t)(job.leaves * ds), NULL,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    if (job.digests == NULL)
+        return MEMORY_E;
+
+    if (InitMutex(&job.lock) != 0) {
+        XFREE(job.digests, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return BAD_MUTEX_E;
+    }
+
+    TreeHashLeaves(&job, threads);
+    ret = job.err;
+    FreeMutex(&job.lock);
+
+    /* pairing each level left to right and carrying an odd last node up
+       gives the same tree as splitting at the largest power of two */
+    for (n = job.leaves; n > 1 && ret == 0; n = (n + 1) / 2) {
+        byte* d = job.digests;
+
+        for (j = 0; j + 1 < n && ret == 0; j += 2)
+            ret = TreeHashNode(hashType, TREE_HASH_NODE_PREFIX, d + j * ds,
+                               ds, d + (j + 1) * ds, ds, d + (j / 2) * ds);
+        if (n & 1)
+            XMEMMOVE(d + (n / 2) * ds, d + (n - 1) * ds, ds);
+    }
+
+    if (ret == 0)
+        XMEMCPY(digest, job.digests, ds);
+
+    XFREE(job.digests, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    return ret;
+}
+
+
+int TreeHashFile(int hashType, const char* fileName, word32 leafSz,
+                 int threads, byte* digest)
+{
+#ifdef TREE_HASH_MMAP
+    int         fd;
+    int         ret;
+    struct stat st;
+    void*       map = NULL;
+
+    CYASSL_ENTER("TreeHashFile");
+
+    if (fileName == NULL || digest == NULL)
+        return BAD_FUNC_ARG;
+
+    fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        CYASSL_MSG("Couldn't open tree hash file");
+        return TREE_HASH_FILE_E;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size < 0 ||
+                               (off_t)(size_t)st.st_size != st.st_size) {
+        CYASSL_MSG("Bad tree hash file size");
+        close(fd);
+        return TREE_HASH_FILE_E;
+    }
+
+    /* mmap won't take a zero length, that's just the empty leaf */
+    if (st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            CYASSL_MSG("Tree hash file mmap failed");
+            close(fd);
+            return TREE_HASH_FILE_E;
+        }
+    #ifdef MADV_SEQUENTIAL
+        madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    #endif
+    }
+    close(fd);
+
+    ret = TreeHash(hashType, (const byte*)map, (word64)st.st_size, leafSz,
+                   threads, digest);
+
+    if (map != NULL)
+        munmap(map, (size_t)st.st_size);
+
+    return ret;
+#else
+    (void)hashType;
+    (void)fileName;
+    (void)leafSz;
+    (void)threads;
+    (void)digest;
+
+    CYASSL_MSG("No mmap, map the file and use TreeHash");
+    return NOT_COMPILED_IN;
+#endif
+}
+
+
+#endif /* CYASSL_TREE_HASH */
@@ -27,6 +27,10 @@
 #include <cyassl/ctaocrypt/types.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
 
+#ifdef HAVE_SHARED_SESSION_CACHE
+    #include <errno.h>
+#endif
+
 
 #ifdef _MSC_VER
     /* 4996 warning to use MS extensions e.g., strcpy_s instead of strncpy */
@@ -182,7 +186,16 @@ int UnLockMutex(CyaSSL_Mutex *m)
 
         int LockMutex(CyaSSL_Mutex* m)
         {
-            if (pthread_mutex_lock(m) == 0)
+            int ret = pthread_mutex_lock(m);
+
+        #ifdef HAVE_SHARED_SESSION_CACHE
+            /* robust session cache stripe whose process died holding it,
+               a torn session there only fails its own resumption */
+            if (ret == EOWNERDEAD)
+                ret = pthread_mutex_consistent(m);
+        #endif
+
+            if (ret == 0)
                 return 0;
             else
                 return BAD_MUTEX_E;
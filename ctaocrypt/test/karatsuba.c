@@ -0,0 +1,129 @@
+/* karatsuba.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* fp_mul and fp_sqr checked against the comba kernels. tfm.c is built into
+   this program with a low FP_KARATSUBA_MIN, the library's split point is past
+   the operands the default FP_MAX_BITS allows, so only here does it run */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+#include <cyassl/ctaocrypt/tfm.h>
+#include <stdio.h>
+
+#ifndef FP_KARATSUBA_MIN
+    #error build with a FP_KARATSUBA_MIN that operands below FP_SIZE reach
+#endif
+
+static word32 seed = 1;
+
+static fp_digit next_digit(void)
+{
+    fp_digit d = 0;
+    int      i;
+
+    for (i = 0; i < (int)sizeof(fp_digit); i += 2) {
+        seed = seed * 1103515245 + 12345;
+        d = (d << 16) | (seed >> 16);
+    }
+
+    return d;
+}
+
+/* pattern 0 is random digits, 1 all ones for the longest carries and 2 a
+   zero low half, so the split has an empty a0 */
+static void fill(fp_int* a, int digits, int pattern, int neg)
+{
+    int i;
+
+    fp_zero(a);
+    for (i = 0; i < digits; i++) {
+        if (pattern == 1)
+            a->dp[i] = (fp_digit)-1;
+        else if (pattern == 2 && i < digits / 2)
+            a->dp[i] = 0;
+        else
+            a->dp[i] = next_digit();
+    }
+    a->used = digits;
+    a->sign = neg ? FP_NEG : FP_ZPOS;
+    fp_clamp(a);
+}
+
+int main(int argc, char** argv)
+{
+    fp_int a, b, c, d;
+    int    x, y, p;
+    int    ret = 0;
+
+    (void)argc;
+    (void)argv;
+
+    /* every size pair up to half of FP_SIZE, balanced and not, so the
+       split happens again on the three half size products */
+    for (x = 1; x < FP_SIZE / 2; x++) {
+        for (p = 0; p < 3; p++) {
+            for (y = 1; y <= x; y++) {
+                fill(&a, x, p, y & 1);
+                fill(&b, y, p == 2 ? 0 : p, x & 1);
+                fp_mul_comba(&a, &b, &d);
+
+                fp_mul(&a, &b, &c);
+                if (fp_cmp(&c, &d) != FP_EQ) {
+                    printf("fp_mul %d x %d digits, pattern %d failed\n",
+                           x, y, p);
+                    ret = 1;
+                }
+
+                /* the product may go over an input */
+                fp_mul(&a, &b, &a);
+                if (fp_cmp(&a, &d) != FP_EQ) {
+                    printf("fp_mul in place %d x %d digits, pattern %d "
+                           "failed\n", x, y, p);
+                    ret = 1;
+                }
+            }
+
+            fill(&a, x, p, 1);
+            fp_sqr_comba(&a, &d);
+
+            fp_sqr(&a, &c);
+            if (fp_cmp(&c, &d) != FP_EQ) {
+                printf("fp_sqr %d digits, pattern %d failed\n", x, p);
+                ret = 1;
+            }
+
+            fp_sqr(&a, &a);
+            if (fp_cmp(&a, &d) != FP_EQ) {
+                printf("fp_sqr in place %d digits, pattern %d failed\n", x,
+                       p);
+                ret = 1;
+            }
+        }
+    }
+
+    if (ret == 0)
+        printf("Karatsuba test passed!\n");
+
+    return ret;
+}
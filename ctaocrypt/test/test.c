@@ -48,6 +48,7 @@
 #include <cyassl/ctaocrypt/rsa.h>
 #include <cyassl/ctaocrypt/des3.h>
 #include <cyassl/ctaocrypt/aes.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 #include <cyassl/ctaocrypt/poly1305.h>
 #include <cyassl/ctaocrypt/camellia.h>
 #include <cyassl/ctaocrypt/hmac.h>
@@ -56,6 +57,7 @@
 #include <cyassl/ctaocrypt/hc128.h>
 #include <cyassl/ctaocrypt/rabbit.h>
 #include <cyassl/ctaocrypt/chacha.h>
+#include <cyassl/ctaocrypt/chacha20_poly1305.h>
 #include <cyassl/ctaocrypt/pwdbased.h>
 #include <cyassl/ctaocrypt/ripemd.h>
 #include <cyassl/ctaocrypt/error-crypt.h>
@@ -65,9 +67,18 @@
 #ifdef HAVE_ECC25519
     #include <cyassl/ctaocrypt/ecc25519.h>
 #endif
+#ifdef HAVE_ED25519
+    #include <cyassl/ctaocrypt/ed25519.h>
+#endif
 #ifdef HAVE_BLAKE2
     #include <cyassl/ctaocrypt/blake2.h>
 #endif
+#ifdef CYASSL_TREE_HASH
+    #include <cyassl/ctaocrypt/treehash.h>
+#endif
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
 #ifdef HAVE_LIBZ
     #include <cyassl/ctaocrypt/compress.h>
 #endif
@@ -166,6 +177,7 @@ int  des_test(void);
 int  des3_test(void);
 int  aes_test(void);
 int  poly1305_test(void);
+int  chacha20_poly1305_aead_test(void);
 int  aesgcm_test(void);
 int  gmac_test(void);
 int  aesccm_test(void);
@@ -180,6 +192,9 @@ int  openssl_test(void);   /* test mini api */
 int pbkdf1_test(void);
 int pkcs12_test(void);
 int pbkdf2_test(void);
+#ifndef NO_SHA256
+    int pbkdf2_multi_test(void);
+#endif
 #ifdef HAVE_ECC
     int  ecc_test(void);
     #ifdef HAVE_ECC_ENCRYPT
@@ -189,8 +204,18 @@ int pbkdf2_test(void);
 #ifdef HAVE_ECC25519
     int  ecc25519_test(void);
 #endif
+#ifdef HAVE_ED25519
+    int  ed25519_test(void);
+#endif
 #ifdef HAVE_BLAKE2
     int  blake2b_test(void);
+    int  blake2bp_test(void);
+#endif
+#ifdef CYASSL_TREE_HASH
+    int treehash_test(void);
+#endif
+#ifdef CYASSL_CRYPTO_DEV
+    int cryptodev_test(void);
 #endif
 #ifdef HAVE_LIBZ
     int compress_test(void);
@@ -198,6 +223,7 @@ int pbkdf2_test(void);
 #ifdef HAVE_PKCS7
     int pkcs7enveloped_test(void);
     int pkcs7signed_test(void);
+    int pkcs7stream_test(void);
 #endif
 
 
@@ -282,6 +308,17 @@ int ctaocrypt_test(void* args)
         return err_sys("SHA      test failed!\n", ret);
     else
         printf( "SHA      test passed!\n");
+
+#ifdef HAVE_CYASSL_ARMV8_CRYPTO
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = sha_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("SHA generic test failed!\n", ret);
+    else
+        printf( "SHA generic test passed!\n");
+#endif
 #endif
 
 #ifndef NO_SHA256
@@ -289,6 +326,17 @@ int ctaocrypt_test(void* args)
         return err_sys("SHA-256  test failed!\n", ret);
     else
         printf( "SHA-256  test passed!\n");
+
+#if defined(HAVE_CYASSL_X86_SIMD) || defined(HAVE_CYASSL_ARMV8_CRYPTO)
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = sha256_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("SHA-256 generic test failed!\n", ret);
+    else
+        printf( "SHA-256 generic test passed!\n");
+#endif
 #endif
 
 #ifdef CYASSL_SHA384
@@ -296,6 +344,17 @@ int ctaocrypt_test(void* args)
         return err_sys("SHA-384  test failed!\n", ret);
     else
         printf( "SHA-384  test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = sha384_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("SHA-384 generic test failed!\n", ret);
+    else
+        printf( "SHA-384 generic test passed!\n");
+#endif
 #endif
 
 #ifdef CYASSL_SHA512
@@ -303,6 +362,17 @@ int ctaocrypt_test(void* args)
         return err_sys("SHA-512  test failed!\n", ret);
     else
         printf( "SHA-512  test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = sha512_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("SHA-512 generic test failed!\n", ret);
+    else
+        printf( "SHA-512 generic test passed!\n");
+#endif
 #endif
 
 #ifdef CYASSL_RIPEMD
@@ -317,6 +387,31 @@ int ctaocrypt_test(void* args)
         return err_sys("BLAKE2b  test failed!\n", ret);
     else
         printf( "BLAKE2b  test passed!\n");
+
+    if ( (ret = blake2bp_test()) != 0)
+        return err_sys("BLAKE2bp test failed!\n", ret);
+    else
+        printf( "BLAKE2bp test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = blake2b_test();
+    if (ret == 0)
+        ret = blake2bp_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("BLAKE2b  generic test failed!\n", ret);
+    else
+        printf( "BLAKE2b  generic test passed!\n");
+#endif
+#endif
+
+#ifdef CYASSL_TREE_HASH
+    if ( (ret = treehash_test()) != 0)
+        return err_sys("TreeHash test failed!\n", ret);
+    else
+        printf( "TreeHash test passed!\n");
 #endif
 
 #ifndef NO_HMAC
@@ -404,6 +499,17 @@ int ctaocrypt_test(void* args)
         return err_sys("Chacha   test failed!\n", ret);
     else
         printf( "Chacha   test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = chacha_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("Chacha generic test failed!\n", ret);
+    else
+        printf( "Chacha generic test passed!\n");
+#endif
 #endif
 
 #ifndef NO_DES3
@@ -418,6 +524,17 @@ int ctaocrypt_test(void* args)
         return err_sys("DES3     test failed!\n", ret);
     else
         printf( "DES3     test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = des3_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("DES3 generic test failed!\n", ret);
+    else
+        printf( "DES3 generic test passed!\n");
+#endif
 #endif
 
 #ifndef NO_AES
@@ -431,6 +548,24 @@ int ctaocrypt_test(void* args)
         return err_sys("POLY1305 test failed!\n", ret);
     else
         printf( "POLY1305 test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = poly1305_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("POLY1305 generic test failed!\n", ret);
+    else
+        printf( "POLY1305 generic test passed!\n");
+#endif
+#endif
+
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    if ( (ret = chacha20_poly1305_aead_test()) != 0)
+        return err_sys("ChaCha20-Poly1305 AEAD test failed!\n", ret);
+    else
+        printf( "ChaCha20-Poly1305 AEAD test passed!\n");
 #endif
 
 #ifdef HAVE_AESGCM
@@ -440,11 +575,64 @@ int ctaocrypt_test(void* args)
         printf( "AES-GCM  test passed!\n");
 #endif
 
+#if defined(CYASSL_AESNI) || defined(HAVE_CYASSL_X86_SIMD) || \
+    defined(HAVE_CYASSL_ARMV8_CRYPTO)
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    if ( (ret = aes_test()) != 0)
+        return err_sys("AES generic test failed!\n", ret);
+    #ifdef HAVE_AESGCM
+    if ( (ret = aesgcm_test()) != 0)
+        return err_sys("AES-GCM generic test failed!\n", ret);
+    #endif
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    printf( "AES generic test passed!\n");
+#endif
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_AES_VPERM)
+    /* and on the constant time vector permute code, if the cpu has it */
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_SSSE3) {
+        CyaSSL_SetCpuFeatureMask(CYASSL_CPU_SSSE3);
+        if ( (ret = aes_test()) != 0)
+            return err_sys("AES vperm test failed!\n", ret);
+        #ifdef HAVE_AESGCM
+        if ( (ret = aesgcm_test()) != 0)
+            return err_sys("AES-GCM vperm test failed!\n", ret);
+        #endif
+        CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+        printf( "AES vperm test passed!\n");
+    }
+#endif
+
+#if defined(CYASSL_AESNI) && defined(HAVE_CYASSL_X86_SIMD)
+    /* the 8 way AES-NI CBC decrypt, when VAES would otherwise take it */
+    if (CyaSSL_GetCpuFeatures() & CYASSL_CPU_VAES) {
+        CyaSSL_SetCpuFeatureMask(~(word32)CYASSL_CPU_VAES);
+        ret = aes_test();
+        CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+        if (ret != 0)
+            return err_sys("AES-NI no VAES test failed!\n", ret);
+        else
+            printf( "AES-NI no VAES test passed!\n");
+    }
+#endif
+
 #ifdef HAVE_AESCCM
     if ( (ret = aesccm_test()) != 0)
         return err_sys("AES-CCM  test failed!\n", ret);
     else
         printf( "AES-CCM  test passed!\n");
+
+#ifdef CYASSL_AESNI
+    /* again on the table code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = aesccm_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("AES-CCM generic test failed!\n", ret);
+    else
+        printf( "AES-CCM generic test passed!\n");
+#endif
 #endif
 #endif
 
@@ -453,6 +641,17 @@ int ctaocrypt_test(void* args)
         return err_sys("CAMELLIA test failed!\n", ret);
     else
         printf( "CAMELLIA test passed!\n");
+
+#ifdef HAVE_CYASSL_X86_SIMD
+    /* again on the table code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = camellia_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("CAMELLIA generic test failed!\n", ret);
+    else
+        printf( "CAMELLIA generic test passed!\n");
+#endif
 #endif
 
     if ( (ret = random_test()) != 0)
@@ -460,11 +659,29 @@ int ctaocrypt_test(void* args)
     else
         printf( "RANDOM   test passed!\n");
 
+#ifdef CYASSL_CRYPTO_DEV
+    if ( (ret = cryptodev_test()) != 0)
+        return err_sys("CRYPTDEV test failed!\n", ret);
+    else
+        printf( "CRYPTDEV test passed!\n");
+#endif
+
 #ifndef NO_RSA
     if ( (ret = rsa_test()) != 0)
         return err_sys("RSA      test failed!\n", ret);
     else
         printf( "RSA      test passed!\n");
+
+#if defined(USE_FAST_MATH) && defined(HAVE_CYASSL_X86_SIMD)
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = rsa_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("RSA generic test failed!\n", ret);
+    else
+        printf( "RSA generic test passed!\n");
+#endif
 #endif
 
 #ifndef NO_DH
@@ -472,6 +689,17 @@ int ctaocrypt_test(void* args)
         return err_sys("DH       test failed!\n", ret);
     else
         printf( "DH       test passed!\n");
+
+#if defined(USE_FAST_MATH) && defined(HAVE_CYASSL_X86_SIMD)
+    /* again on the generic code */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = dh_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("DH generic test failed!\n", ret);
+    else
+        printf( "DH generic test passed!\n");
+#endif
 #endif
 
 #ifndef NO_DSA
@@ -486,6 +714,17 @@ int ctaocrypt_test(void* args)
         return err_sys("PWDBASED test failed!\n", ret);
     else
         printf( "PWDBASED test passed!\n");
+
+#if defined(HAVE_CYASSL_X86_SIMD) && !defined(NO_SHA256)
+    /* again on the generic code, batches without the AVX2 lanes */
+    CyaSSL_SetCpuFeatureMask(0);
+    ret = pbkdf2_multi_test();
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    if (ret != 0)
+        return err_sys("PBKDF2 generic test failed!\n", ret);
+    else
+        printf( "PBKDF2 generic test passed!\n");
+#endif
 #endif
 
 #ifdef OPENSSL_EXTRA
@@ -515,6 +754,13 @@ int ctaocrypt_test(void* args)
         printf( "ECC25519 test passed!\n");
 #endif
 
+#ifdef HAVE_ED25519
+    if ( (ret = ed25519_test()) != 0)
+        return err_sys("ED25519  test failed!\n", ret);
+    else
+        printf( "ED25519  test passed!\n");
+#endif
+
 #ifdef HAVE_LIBZ
     if ( (ret = compress_test()) != 0)
         return err_sys("COMPRESS test failed!\n", ret);
@@ -532,6 +778,11 @@ int ctaocrypt_test(void* args)
         return err_sys("PKCS7signed    test failed!\n", ret);
     else
         printf( "PKCS7signed    test passed!\n");
+
+    if ( (ret = pkcs7stream_test()) != 0)
+        return err_sys("PKCS7stream    test failed!\n", ret);
+    else
+        printf( "PKCS7stream    test passed!\n");
 #endif
 
     ((func_args*)args)->return_code = ret;
@@ -584,8 +835,18 @@ static int OpenNitroxDevice(int dma_mode,int dev_id)
         args.argc = argc;
         args.argv = argv;
 
+#if defined(HAVE_ECC) && defined(FP_ECC)
+        /* as CyaSSL_Init() would, so the generator LUTs are shared */
+        if (ecc_fp_init_fixed() != 0)
+            err_sys("ecc_fp_init_fixed failed", -1237);
+#endif
+
         ctaocrypt_test(&args);
 
+#if defined(HAVE_ECC) && defined(FP_ECC)
+        ecc_fp_free_fixed();
+#endif
+
 #ifdef HAVE_CAVIUM
         CspShutdown(CAVIUM_DEV_ID);
 #endif
@@ -730,6 +991,46 @@ int md5_test(void)
             return -5 - i;
     }
 
+#ifndef NO_SHA
+    {
+        /* both at once has to match each on its own, fed in odd pieces,
+           some starting part way into a block */
+        Sha    sha;
+        byte   big[1000];
+        byte   md5Hash[MD5_DIGEST_SIZE];
+        byte   shaHash[SHA_DIGEST_SIZE];
+        byte   expMd5[MD5_DIGEST_SIZE];
+        byte   expSha[SHA_DIGEST_SIZE];
+        word32 j, step, sz;
+
+        for (j = 0; j < sizeof(big); j++)
+            big[j] = (byte)(j * 13);
+
+        for (step = 1; step < sizeof(big); step = step * 3 + 7) {
+            InitMd5(&md5);
+            InitSha(&sha);
+            if (step & 1) {
+                Md5Update(&md5, big, 1);
+                ShaUpdate(&sha, big, 1);
+            }
+            for (j = step & 1; j < sizeof(big); j += sz) {
+                sz = (step < sizeof(big) - j) ? step : sizeof(big) - j;
+                if (Md5ShaUpdate(&md5, &sha, big + j, sz) != 0)
+                    return -20;
+            }
+            Md5Final(&md5, md5Hash);
+            ShaFinal(&sha, shaHash);
+
+            Md5Hash(big, sizeof(big), expMd5);
+            ShaHash(big, sizeof(big), expSha);
+            if (memcmp(md5Hash, expMd5, MD5_DIGEST_SIZE) != 0)
+                return -21;
+            if (memcmp(shaHash, expSha, SHA_DIGEST_SIZE) != 0)
+                return -22;
+        }
+    }
+#endif
+
     return 0;
 }
 #endif /* NO_MD5 */
@@ -971,6 +1272,34 @@ static const byte blake2b_vec[BLAKE2_TESTS][BLAKE2B_OUTBYTES] =
 
 
 
+/* bytes 0, 1, 2, ... of blake2_long, under BLAKE2b and BLAKE2bp */
+static byte blake2_long[1500];
+
+static const byte blake2b_long_vec[BLAKE2B_OUTBYTES] =
+{
+    0xC8, 0xD8, 0x61, 0x4C, 0x3F, 0xA7, 0x1F, 0xDD,
+    0x5A, 0x23, 0xA0, 0x24, 0xCA, 0x39, 0x86, 0x42,
+    0x00, 0x2E, 0xA5, 0x97, 0x48, 0x7A, 0x1D, 0x54,
+    0xFD, 0x3B, 0x59, 0x84, 0x28, 0x6D, 0x56, 0x4D,
+    0x38, 0xC5, 0x72, 0x8A, 0x51, 0xDF, 0x22, 0xD3,
+    0x27, 0x79, 0x5B, 0x84, 0x3A, 0x1E, 0xF2, 0x38,
+    0xCD, 0x36, 0x26, 0xB1, 0xDD, 0xB1, 0x35, 0xA0,
+    0x38, 0xE8, 0x6E, 0x51, 0x1F, 0x8D, 0x19, 0xA7
+};
+
+static const byte blake2bp_long_vec[BLAKE2B_OUTBYTES] =
+{
+    0x4D, 0x5E, 0x9A, 0x80, 0xBC, 0x7F, 0x73, 0xAE,
+    0x9E, 0xFB, 0xF7, 0x37, 0x71, 0xFF, 0xE7, 0x9B,
+    0x23, 0xEA, 0xFB, 0x1A, 0x69, 0x7B, 0x54, 0x23,
+    0x39, 0x00, 0xDF, 0x22, 0x6F, 0xA5, 0x7D, 0xF7,
+    0x32, 0x31, 0xAE, 0xCC, 0xDF, 0xC3, 0xD7, 0xCA,
+    0xC0, 0x76, 0xBC, 0x9C, 0x24, 0x6E, 0xA9, 0x84,
+    0xCA, 0x99, 0x34, 0x60, 0x3F, 0xBB, 0x9B, 0x29,
+    0x42, 0xDE, 0x16, 0xBC, 0x97, 0x38, 0x89, 0xB1
+};
+
+
 int blake2b_test(void)
 {
     Blake2b b2b;
@@ -999,11 +1328,173 @@ int blake2b_test(void)
         }
     }
 
+    /* many blocks, fed in uneven pieces */
+    for (i = 0; i < (int)sizeof(blake2_long); i++)
+        blake2_long[i] = (byte)i;
+
+    if (InitBlake2b(&b2b, 64) != 0)
+        return -4002;
+    for (i = 0; i < (int)sizeof(blake2_long); i += 77) {
+        word32 sz = (int)sizeof(blake2_long) - i < 77 ?
+                    (word32)sizeof(blake2_long) - i : 77;
+        if (Blake2bUpdate(&b2b, blake2_long + i, sz) != 0)
+            return -4003;
+    }
+    if (Blake2bFinal(&b2b, digest, 64) != 0)
+        return -4004;
+    if (memcmp(digest, blake2b_long_vec, 64) != 0)
+        return -310;
+
+    return 0;
+}
+
+
+int blake2bp_test(void)
+{
+    Blake2bp b2bp;
+    byte     digest[64];
+    int      i, j;
+
+    /* in one go, then a byte and then 600 bytes at a time */
+    const int steps[] = { sizeof(blake2_long), 1, 600 };
+
+    for (i = 0; i < (int)sizeof(blake2_long); i++)
+        blake2_long[i] = (byte)i;
+
+    for (j = 0; j < (int)(sizeof(steps) / sizeof(steps[0])); j++) {
+        if (InitBlake2bp(&b2bp, 64) != 0)
+            return -320;
+        for (i = 0; i < (int)sizeof(blake2_long); i += steps[j]) {
+            word32 sz = (int)sizeof(blake2_long) - i < steps[j] ?
+                        (word32)sizeof(blake2_long) - i : (word32)steps[j];
+            if (Blake2bpUpdate(&b2bp, blake2_long + i, sz) != 0)
+                return -321;
+        }
+        if (Blake2bpFinal(&b2bp, digest, 64) != 0)
+            return -322;
+        if (memcmp(digest, blake2bp_long_vec, 64) != 0)
+            return -323 - j;
+    }
+
     return 0;
 }
 #endif /* HAVE_BLAKE2 */
 
 
+#ifdef CYASSL_TREE_HASH
+
+/* RFC 6962 roots over leaves of the 1000 bytes (byte)(i * 7) */
+static const byte treehash_sha256_100[SHA256_DIGEST_SIZE] =
+{
+    0x76, 0x8B, 0xDE, 0xC4, 0xF4, 0xB9, 0x05, 0xB8,
+    0xCC, 0xBD, 0x91, 0x57, 0xD4, 0xDF, 0x83, 0x64,
+    0xF4, 0x06, 0x67, 0x6D, 0x4E, 0x9E, 0x56, 0x8D,
+    0xC9, 0x23, 0xF4, 0x7A, 0x10, 0xCD, 0x25, 0xC8
+};
+
+static const byte treehash_sha256_64[SHA256_DIGEST_SIZE] =
+{
+    0x2A, 0xA3, 0x72, 0xAC, 0xB2, 0xB7, 0xD9, 0xBA,
+    0xB6, 0x1B, 0x54, 0x71, 0x67, 0x93, 0x29, 0x2B,
+    0xAD, 0x51, 0xE7, 0xDC, 0x34, 0x3C, 0xD5, 0x38,
+    0x82, 0xA6, 0x37, 0xE9, 0x5D, 0xE3, 0x4C, 0x1E
+};
+
+/* the empty input, SHA-256(0x00) */
+static const byte treehash_sha256_empty[SHA256_DIGEST_SIZE] =
+{
+    0x6E, 0x34, 0x0B, 0x9C, 0xFF, 0xB3, 0x7A, 0x98,
+    0x9C, 0xA5, 0x44, 0xE6, 0xBB, 0x78, 0x0A, 0x2C,
+    0x78, 0x90, 0x1D, 0x3F, 0xB3, 0x37, 0x38, 0x76,
+    0x85, 0x11, 0xA3, 0x06, 0x17, 0xAF, 0xA0, 0x1D
+};
+
+#ifdef HAVE_BLAKE2
+static const byte treehash_blake2b_100[BLAKE2B_OUTBYTES] =
+{
+    0x8B, 0x40, 0xAB, 0x2B, 0x77, 0x40, 0x60, 0x69,
+    0x19, 0x14, 0x5A, 0xC3, 0x84, 0xB3, 0xE4, 0xCF,
+    0x9D, 0x44, 0x8F, 0x41, 0xFA, 0xE2, 0x71, 0xB8,
+    0xAB, 0xFA, 0x63, 0x46, 0x5A, 0x2C, 0xE2, 0xBE,
+    0xA9, 0x12, 0x23, 0xCD, 0xEF, 0x87, 0x4C, 0xC4,
+    0x15, 0xB1, 0xA2, 0xB3, 0xAE, 0x08, 0x81, 0x45,
+    0x65, 0x86, 0x4B, 0xB6, 0x33, 0x1A, 0x7F, 0xE4,
+    0x0A, 0x3D, 0x62, 0x52, 0xB1, 0xEE, 0x78, 0x8E
+};
+#endif
+
+int treehash_test(void)
+{
+    byte input[1000];
+    byte digest[64];
+    int  i, threads;
+
+    for (i = 0; i < (int)sizeof(input); i++)
+        input[i] = (byte)(i * 7);
+
+    /* one thread, a few, and more than there are leaves */
+    for (threads = 1; threads <= 16; threads *= 4) {
+        if (TreeHash(SHA256, input, sizeof(input), 100, threads, digest) != 0)
+            return -4200;
+        if (memcmp(digest, treehash_sha256_100, SHA256_DIGEST_SIZE) != 0)
+            return -4201;
+
+        if (TreeHash(SHA256, input, sizeof(input), 64, threads, digest) != 0)
+            return -4202;
+        if (memcmp(digest, treehash_sha256_64, SHA256_DIGEST_SIZE) != 0)
+            return -4203;
+    }
+
+    if (TreeHash(SHA256, NULL, 0, 0, 0, digest) != 0)
+        return -4204;
+    if (memcmp(digest, treehash_sha256_empty, SHA256_DIGEST_SIZE) != 0)
+        return -4205;
+
+#ifdef HAVE_BLAKE2
+    if (TreeHash(BLAKE2B_ID, input, sizeof(input), 100, 0, digest) != 0)
+        return -4206;
+    if (memcmp(digest, treehash_blake2b_100, BLAKE2B_OUTBYTES) != 0)
+        return -4207;
+#endif
+
+    if (TreeHash(SHA256, NULL, 1, 0, 0, digest) != BAD_FUNC_ARG)
+        return -4208;
+
+#if !defined(NO_FILESYSTEM) && !defined(USE_CERT_BUFFERS_1024) && \
+    !defined(USE_CERT_BUFFERS_2048)
+    {
+        /* the mapped file has to give what hashing its bytes gives */
+        const char* file = "./certs/client-cert.der";
+        byte        fileDigest[SHA256_DIGEST_SIZE];
+        byte        der[4096];
+        FILE*       f;
+        int         derSz;
+        int         ret;
+
+        f = fopen(file, "rb");
+        if (!f)
+            return -4209;
+        derSz = (int)fread(der, 1, sizeof(der), f);
+        fclose(f);
+
+        ret = TreeHashFile(SHA256, file, 256, 0, fileDigest);
+        if (ret != NOT_COMPILED_IN) {
+            if (ret != 0)
+                return -4210;
+            if (TreeHash(SHA256, der, derSz, 256, 1, digest) != 0)
+                return -4211;
+            if (memcmp(digest, fileDigest, SHA256_DIGEST_SIZE) != 0)
+                return -4212;
+        }
+    }
+#endif
+
+    return 0;
+}
+
+#endif /* CYASSL_TREE_HASH */
+
+
 #ifndef NO_SHA256
 int sha256_test(void)
 {
@@ -1048,6 +1539,32 @@ int sha256_test(void)
             return -10 - i;
     }
 
+    /* many messages at once must match one at a time, around block edges */
+    {
+        static const word32 lens[9] = { 0, 1, 55, 56, 63, 64, 119, 120, 279 };
+        byte        msg[300];
+        const byte* in[9];
+        byte        out[9][SHA256_DIGEST_SIZE];
+        byte*       outs[9];
+
+        for (i = 0; i < (int)sizeof(msg); i++)
+            msg[i] = (byte)i;
+        for (i = 0; i < 9; i++) {
+            in[i]   = msg + i;
+            outs[i] = out[i];
+        }
+
+        if (Sha256HashMulti(in, lens, outs, 9) != 0)
+            return -4008;
+
+        for (i = 0; i < 9; i++) {
+            if (Sha256Hash(in[i], lens[i], hash) != 0)
+                return -4009;
+            if (memcmp(hash, out[i], SHA256_DIGEST_SIZE) != 0)
+                return -4010 - i;
+        }
+    }
+
     return 0;
 }
 #endif
@@ -1103,6 +1620,29 @@ int sha512_test(void)
             return -10 - i;
     }
 
+    /* several blocks in one call must match the same bytes one at a time */
+    {
+        byte large[1000];
+        byte hash2[SHA512_DIGEST_SIZE];
+
+        for (i = 0; i < (int)sizeof(large); i++)
+            large[i] = (byte)i;
+
+        if (Sha512Update(&sha, large, sizeof(large)) != 0 ||
+            Sha512Final(&sha, hash) != 0)
+            return -4015;
+
+        for (i = 0; i < (int)sizeof(large); i++) {
+            if (Sha512Update(&sha, large + i, 1) != 0)
+                return -4015;
+        }
+        if (Sha512Final(&sha, hash2) != 0)
+            return -4015;
+
+        if (memcmp(hash, hash2, SHA512_DIGEST_SIZE) != 0)
+            return -4016;
+    }
+
     return 0;
 }
 #endif
@@ -1156,6 +1696,29 @@ int sha384_test(void)
             return -10 - i;
     }
 
+    /* several blocks in one call must match the same bytes one at a time */
+    {
+        byte large[1000];
+        byte hash2[SHA384_DIGEST_SIZE];
+
+        for (i = 0; i < (int)sizeof(large); i++)
+            large[i] = (byte)i;
+
+        if (Sha384Update(&sha, large, sizeof(large)) != 0 ||
+            Sha384Final(&sha, hash) != 0)
+            return -4017;
+
+        for (i = 0; i < (int)sizeof(large); i++) {
+            if (Sha384Update(&sha, large + i, 1) != 0)
+                return -4017;
+        }
+        if (Sha384Final(&sha, hash2) != 0)
+            return -4017;
+
+        if (memcmp(hash, hash2, SHA384_DIGEST_SIZE) != 0)
+            return -4018;
+    }
+
     return 0;
 }
 #endif /* CYASSL_SHA384 */
@@ -1390,6 +1953,39 @@ int hmac_sha256_test(void)
 #endif
     }
 
+#ifndef HAVE_CAVIUM
+    /* precomputed key states, twice to check the clone stays keyed */
+    for (i = 0; i < times; ++i) {
+        HmacState state;
+        int       j;
+
+#ifdef HAVE_FIPS
+        if (i == 1)
+            continue;
+#endif
+        ret = HmacInitKeyedState(&state, SHA256, (byte*)keys[i],
+                                 (word32)strlen(keys[i]));
+        if (ret != 0)
+            return -4040;
+        ret = HmacCloneState(&hmac, &state);
+        if (ret != 0)
+            return -4041;
+
+        for (j = 0; j < 2; j++) {
+            ret = HmacUpdate(&hmac, (byte*)test_hmac[i].input,
+                       (word32)test_hmac[i].inLen);
+            if (ret != 0)
+                return -4042;
+            ret = HmacFinal(&hmac, hash);
+            if (ret != 0)
+                return -4043;
+
+            if (memcmp(hash, test_hmac[i].output, SHA256_DIGEST_SIZE) != 0)
+                return -4044;
+        }
+    }
+#endif
+
     return 0;
 }
 #endif
@@ -1881,6 +2477,9 @@ int chacha_test(void)
     byte   cipher[32];
     byte   plain[32];
     byte   input[] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    byte   big[64 * 13 + 23];
+    byte   bigCipher[sizeof(big)];
+    byte   bigPlain[sizeof(big)];
     word32 keySz;
     int    i;
     int    times = 4;
@@ -1969,6 +2568,25 @@ int chacha_test(void)
             return -130 - i;
     }
 
+    /* one long call, any multi block path, against a block at a time */
+    for (i = 0; i < (int)sizeof(big); i++)
+        big[i] = (byte)i;
+
+    XMEMSET(cipher, 0, sizeof(cipher));
+    Chacha_SetKey(&enc, key1, sizeof(key1));
+    Chacha_SetKey(&dec, key1, sizeof(key1));
+    Chacha_SetIV(&enc, cipher, 0);
+    Chacha_SetIV(&dec, cipher, 0);
+
+    Chacha_Process(&enc, bigCipher, big, (word32)sizeof(big));
+    for (i = 0; i < (int)sizeof(big); i += 64) {
+        word32 sz = (word32)sizeof(big) - i < 64 ? (word32)sizeof(big) - i : 64;
+        Chacha_Process(&dec, bigPlain + i, bigCipher + i, sz);
+    }
+
+    if (memcmp(bigPlain, big, sizeof(big)))
+        return -140;
+
     return 0;
 }
 #endif /* HAVE_CHACHA */
@@ -2065,6 +2683,9 @@ int des3_test(void)
         0x18,0x94,0x15,0x74,0x87,0x12,0x7d,0xb0
     };
 
+    byte   big[DES_BLOCK_SIZE * 25];
+    byte   bigCipher[DES_BLOCK_SIZE * 25];
+    word32 i;
     int ret;
 
 
@@ -2093,6 +2714,23 @@ int des3_test(void)
     if (memcmp(cipher, verify3, sizeof(cipher)))
         return -36;
 
+    /* long enough for the multi block decrypt, in place and split so the
+     * second call starts mid group */
+    for (i = 0; i < sizeof(big); i++)
+        big[i] = (byte)i;
+    if (Des3_SetIV(&enc, iv3) != 0 || Des3_SetIV(&dec, iv3) != 0)
+        return -37;
+    if (Des3_CbcEncrypt(&enc, bigCipher, big, sizeof(big)) != 0)
+        return -38;
+    if (Des3_CbcDecrypt(&dec, bigCipher, bigCipher, DES_BLOCK_SIZE * 9) != 0)
+        return -39;
+    if (Des3_CbcDecrypt(&dec, bigCipher + DES_BLOCK_SIZE * 9,
+                        bigCipher + DES_BLOCK_SIZE * 9,
+                        sizeof(bigCipher) - DES_BLOCK_SIZE * 9) != 0)
+        return -39;
+    if (memcmp(bigCipher, big, sizeof(big)))
+        return -40;
+
 #ifdef HAVE_CAVIUM
     Des3_FreeCavium(&enc);
     Des3_FreeCavium(&dec);
@@ -2153,6 +2791,40 @@ int aes_test(void)
     if (memcmp(cipher, verify, AES_BLOCK_SIZE))
         return -61;
 
+#ifndef HAVE_CAVIUM
+    /* long enough for the wide CBC decrypt paths and their tails, every key
+       size, in place and split so the iv carries across calls */
+    {
+        const byte bigKey[] = "0123456789abcdeffedcba9876543210";
+        byte   bigMsg[AES_BLOCK_SIZE * 43];
+        byte   bigBuf[AES_BLOCK_SIZE * 43];
+        word32 keySz;
+        int    i;
+
+        for (i = 0; i < (int)sizeof(bigMsg); i++)
+            bigMsg[i] = (byte)(i * 7);
+
+        for (keySz = 16; keySz <= 32; keySz += 8) {
+            if (AesSetKey(&enc, bigKey, keySz, iv, AES_ENCRYPTION) != 0)
+                return -1007;
+            if (AesSetKey(&dec, bigKey, keySz, iv, AES_DECRYPTION) != 0)
+                return -1008;
+
+            if (AesCbcEncrypt(&enc, bigBuf, bigMsg, sizeof(bigMsg)) != 0)
+                return -1009;
+            if (AesCbcDecrypt(&dec, bigBuf, bigBuf, AES_BLOCK_SIZE * 37) != 0)
+                return -1010;
+            if (AesCbcDecrypt(&dec, bigBuf + AES_BLOCK_SIZE * 37,
+                              bigBuf + AES_BLOCK_SIZE * 37,
+                              AES_BLOCK_SIZE * 6) != 0)
+                return -1011;
+
+            if (memcmp(bigBuf, bigMsg, sizeof(bigMsg)))
+                return -62;
+        }
+    }
+#endif
+
 #ifdef HAVE_CAVIUM
         AesFreeCavium(&enc);
         AesFreeCavium(&dec);
@@ -2238,6 +2910,51 @@ int aes_test(void)
 
         if (memcmp(cipher, oddCipher, 9))
             return -71;
+
+        /* 17 blocks and 5 bytes from a counter whose low 64 bits run out
+           at block 6, split so both calls have a partial block */
+        {
+            const byte carryIv[] =
+            {
+                0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
+                0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xfa
+            };
+
+            const byte carryCipher[] = /* blocks 5 and 6 */
+            {
+                0x28,0xaa,0x89,0xb1,0xf9,0xa5,0x80,0xb6,
+                0x13,0xf5,0x4f,0x65,0x00,0x75,0xb2,0xa2,
+                0xcf,0x7a,0x6e,0xde,0x20,0xb2,0xa8,0xaa,
+                0x73,0xfe,0x91,0xb5,0xfe,0xf0,0x32,0xff
+            };
+
+            const byte carryTail[] = { 0xbe,0x70,0xf6,0xcf,0xc4 };
+
+            byte   carryMsg[AES_BLOCK_SIZE * 17 + 5];
+            byte   carryOut[AES_BLOCK_SIZE * 17 + 5];
+            word32 i;
+
+            for (i = 0; i < sizeof(carryMsg); i++)
+                carryMsg[i] = (byte)(i * 13 + 5);
+
+            AesSetKeyDirect(&enc, ctrKey, AES_BLOCK_SIZE, carryIv,
+                            AES_ENCRYPTION);
+            AesCtrEncrypt(&enc, carryOut, carryMsg, 100);
+            AesCtrEncrypt(&enc, carryOut + 100, carryMsg + 100,
+                          sizeof(carryMsg) - 100);
+
+            if (memcmp(carryOut + AES_BLOCK_SIZE * 5, carryCipher,
+                       sizeof(carryCipher)))
+                return -72;
+            if (memcmp(carryOut + sizeof(carryOut) - 5, carryTail, 5))
+                return -73;
+
+            AesSetKeyDirect(&dec, ctrKey, AES_BLOCK_SIZE, carryIv,
+                            AES_ENCRYPTION);
+            AesCtrEncrypt(&dec, carryOut, carryOut, sizeof(carryOut));
+            if (memcmp(carryOut, carryMsg, sizeof(carryMsg)))
+                return -74;
+        }
     }
 #endif /* CYASSL_AES_COUNTER */
 
@@ -2290,6 +3007,8 @@ int poly1305_test(void)
     int      ret = 0;
     int      i;
     byte     tag[16];
+    byte     tag2[16];
+    byte     big[POLY1305_BLOCK_SIZE * 21 + 5];
     Poly1305 enc;
 
     const byte msg[] = 
@@ -2370,48 +3089,195 @@ int poly1305_test(void)
             return -61;
     }
 
+    /* one long update, any multi block path, against a block at a time */
+    for (i = 0; i < (int)sizeof(big); i++)
+        big[i] = (byte)(i * 7);
+
+    if (Poly1305SetKey(&enc, key, 32) != 0 ||
+        Poly1305Update(&enc, big, sizeof(big)) != 0 ||
+        Poly1305Final(&enc, tag) != 0)
+        return -62;
+
+    if (Poly1305SetKey(&enc, key, 32) != 0)
+        return -63;
+    for (i = 0; i < (int)sizeof(big); i += POLY1305_BLOCK_SIZE) {
+        word32 sz = (word32)sizeof(big) - i;
+        if (sz > POLY1305_BLOCK_SIZE)
+            sz = POLY1305_BLOCK_SIZE;
+        if (Poly1305Update(&enc, big + i, sz) != 0)
+            return -64;
+    }
+    if (Poly1305Final(&enc, tag2) != 0)
+        return -65;
+
+    if (memcmp(tag, tag2, sizeof(tag)))
+        return -66;
+
     return 0;
 } 
 #endif /* HAVE_POLY1305 */
 
-#ifdef HAVE_AESGCM
-int aesgcm_test(void)
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+int chacha20_poly1305_aead_test(void)
 {
-    Aes enc;
+    /* RFC 7539 section 2.8.2 */
+    const byte key[] = {
+        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+        0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+        0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+    };
 
-    /*
-     * This is Test Case 16 from the document Galois/
-     * Counter Mode of Operation (GCM) by McGrew and
-     * Viega.
-     */
-    const byte k[] =
-    {
-        0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
-        0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
-        0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
-        0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+    const byte plaintext[] = "Ladies and Gentlemen of the class of '99: "
+                             "If I could offer you only one tip for the "
+                             "future, sunscreen would be it.";
+
+    const byte iv[] = {
+        0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43,
+        0x44, 0x45, 0x46, 0x47
     };
 
-    const byte iv[] =
-    {
-        0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
-        0xde, 0xca, 0xf8, 0x88
+    const byte aad[] = {
+        0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3,
+        0xc4, 0xc5, 0xc6, 0xc7
     };
 
-    const byte p[] =
-    {
-        0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
-        0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
-        0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
-        0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
-        0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
-        0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
-        0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
-        0xba, 0x63, 0x7b, 0x39
+    const byte cipher[] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb,
+        0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+        0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12,
+        0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29,
+        0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+        0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94,
+        0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d,
+        0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
     };
 
-    const byte a[] =
-    {
+    const byte authTag[] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+        0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+
+    byte   generatedCiphertext[sizeof(cipher)];
+    byte   generatedPlaintext[sizeof(cipher)];
+    byte   generatedAuthTag[CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE];
+    byte   big[1024 * 2 + 77];
+    byte   bigCipher[sizeof(big)];
+    ChaCha chacha;
+    word32 i;
+    int    ret;
+
+    ret = ChaCha20Poly1305_Encrypt(key, iv, aad, sizeof(aad), plaintext,
+                                   sizeof(cipher), generatedCiphertext,
+                                   generatedAuthTag);
+    if (ret != 0)
+        return -4100;
+
+    if (memcmp(generatedCiphertext, cipher, sizeof(cipher)))
+        return -4101;
+
+    if (memcmp(generatedAuthTag, authTag, sizeof(authTag)))
+        return -4102;
+
+    ret = ChaCha20Poly1305_Decrypt(key, iv, aad, sizeof(aad), cipher,
+                                   sizeof(cipher), authTag,
+                                   generatedPlaintext);
+    if (ret != 0)
+        return -4103;
+
+    if (memcmp(generatedPlaintext, plaintext, sizeof(cipher)))
+        return -4104;
+
+    /* a bad tag is refused and no plaintext is handed back */
+    generatedAuthTag[0] ^= 1;
+    ret = ChaCha20Poly1305_Decrypt(key, iv, aad, sizeof(aad), cipher,
+                                   sizeof(cipher), generatedAuthTag,
+                                   generatedPlaintext);
+    if (ret != CHACHA_POLY_AUTH_E)
+        return -4105;
+
+    for (i = 0; i < sizeof(cipher); i++) {
+        if (generatedPlaintext[i] != 0)
+            return -4106;
+    }
+
+    /* several chunks, in place, keystream runs on from block 1 */
+    for (i = 0; i < sizeof(big); i++)
+        big[i] = (byte)i;
+
+    if (Chacha_SetKey(&chacha, key, sizeof(key)) != 0 ||
+        Chacha_SetIV(&chacha, iv, 1) != 0 ||
+        Chacha_Process(&chacha, bigCipher, big, sizeof(big)) != 0)
+        return -4107;
+
+    ret = ChaCha20Poly1305_Encrypt(key, iv, NULL, 0, big, sizeof(big), big,
+                                   generatedAuthTag);
+    if (ret != 0)
+        return -4108;
+
+    if (memcmp(big, bigCipher, sizeof(big)))
+        return -4109;
+
+    ret = ChaCha20Poly1305_Decrypt(key, iv, NULL, 0, big, sizeof(big),
+                                   generatedAuthTag, big);
+    if (ret != 0)
+        return -4110;
+
+    for (i = 0; i < sizeof(big); i++) {
+        if (big[i] != (byte)i)
+            return -4111;
+    }
+
+    return 0;
+}
+#endif /* HAVE_CHACHA && HAVE_POLY1305 */
+
+
+#ifdef HAVE_AESGCM
+int aesgcm_test(void)
+{
+    Aes enc;
+
+    /*
+     * This is Test Case 16 from the document Galois/
+     * Counter Mode of Operation (GCM) by McGrew and
+     * Viega.
+     */
+    const byte k[] =
+    {
+        0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+        0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+        0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+        0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+    };
+
+    const byte iv[] =
+    {
+        0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+        0xde, 0xca, 0xf8, 0x88
+    };
+
+    const byte p[] =
+    {
+        0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+        0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+        0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+        0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+        0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+        0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+        0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+        0xba, 0x63, 0x7b, 0x39
+    };
+
+    const byte a[] =
+    {
         0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
         0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
         0xab, 0xad, 0xda, 0xd2
@@ -2637,6 +3503,69 @@ int aesccm_test(void)
     if (memcmp(p2, c2, sizeof(p2)))
         return -112;
 
+    /* 9 blocks and a partial with a 7 byte nonce and 20 bytes of auth
+       data, long enough for the interleaved AES-NI blocks, in place */
+    {
+        const byte bigKey[] =
+        {
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f
+        };
+
+        const byte bigIv[] =
+        {
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16
+        };
+
+        const byte bigC0[] = /* first block */
+        {
+            0x50, 0x47, 0x24, 0x72, 0xe9, 0x64, 0xa0, 0x2f,
+            0x68, 0x2d, 0x9b, 0xa6, 0x35, 0x14, 0xf6, 0xd5
+        };
+
+        const byte bigCn[] = /* last block and the partial */
+        {
+            0x27, 0xa9, 0x33, 0x74, 0x7b, 0xba, 0xc1, 0x7c,
+            0x51, 0x28, 0x18, 0x6c, 0x98, 0xf9, 0xed, 0x32,
+            0x25, 0x47, 0x2d, 0xd7, 0x1d, 0x5a, 0x16
+        };
+
+        const byte bigT[] =
+        {
+            0x53, 0x74, 0x27, 0x47, 0x32, 0xe2, 0x2d, 0x19
+        };
+
+        byte bigA[20];
+        byte bigP[AES_BLOCK_SIZE * 9 + 7];
+        byte bigBuf[AES_BLOCK_SIZE * 9 + 7];
+        byte bigT2[sizeof(bigT)];
+        word32 i;
+
+        for (i = 0; i < sizeof(bigA); i++)
+            bigA[i] = (byte)i;
+        for (i = 0; i < sizeof(bigP); i++)
+            bigP[i] = (byte)(i * 3 + 1);
+
+        AesCcmSetKey(&enc, bigKey, sizeof(bigKey));
+        XMEMCPY(bigBuf, bigP, sizeof(bigP));
+        AesCcmEncrypt(&enc, bigBuf, bigBuf, sizeof(bigBuf), bigIv,
+                      sizeof(bigIv), bigT2, sizeof(bigT2), bigA, sizeof(bigA));
+        if (memcmp(bigBuf, bigC0, sizeof(bigC0)))
+            return -113;
+        if (memcmp(bigBuf + sizeof(bigBuf) - sizeof(bigCn), bigCn,
+                   sizeof(bigCn)))
+            return -114;
+        if (memcmp(bigT2, bigT, sizeof(bigT)))
+            return -115;
+
+        result = AesCcmDecrypt(&enc, bigBuf, bigBuf, sizeof(bigBuf), bigIv,
+                       sizeof(bigIv), bigT2, sizeof(bigT2), bigA, sizeof(bigA));
+        if (result != 0)
+            return -116;
+        if (memcmp(bigBuf, bigP, sizeof(bigP)))
+            return -117;
+    }
+
     return 0;
 }
 #endif /* HAVE_AESCCM */
@@ -2818,6 +3747,32 @@ int camellia_test(void)
         }
     }
 
+    /* long enough for the 16 block CBC decrypt and its tail, every key
+       size, in place and split so the iv carries across calls */
+    {
+        byte   bigMsg[CAMELLIA_BLOCK_SIZE * 37];
+        byte   bigBuf[CAMELLIA_BLOCK_SIZE * 37];
+        word32 keySz;
+
+        for (i = 0; i < (int)sizeof(bigMsg); i++)
+            bigMsg[i] = (byte)(i * 7);
+
+        for (keySz = 16; keySz <= 32; keySz += 8) {
+            if (CamelliaSetKey(&cam, k6, keySz, ivc) != 0)
+                return -126;
+            CamelliaCbcEncrypt(&cam, bigBuf, bigMsg, sizeof(bigMsg));
+
+            CamelliaSetIV(&cam, ivc);
+            CamelliaCbcDecrypt(&cam, bigBuf, bigBuf, CAMELLIA_BLOCK_SIZE * 33);
+            CamelliaCbcDecrypt(&cam, bigBuf + CAMELLIA_BLOCK_SIZE * 33,
+                               bigBuf + CAMELLIA_BLOCK_SIZE * 33,
+                               CAMELLIA_BLOCK_SIZE * 4);
+
+            if (memcmp(bigBuf, bigMsg, sizeof(bigMsg)))
+                return -127;
+        }
+    }
+
     /* Setting the IV and checking it was actually set. */
     CamelliaSetIV(&cam, ivc);
     if (XMEMCMP(cam.reg, ivc, CAMELLIA_BLOCK_SIZE))
@@ -2856,6 +3811,23 @@ int random_test(void)
         0xa9, 0xef, 0x55, 0xf0, 0x51, 0x85, 0xe0, 0xfb, 0x85, 0x81, 0xf9, 0x31,
         0x75, 0x17, 0x27, 0x6e, 0x06, 0xe9, 0x60, 0x7d, 0xdb, 0xcb, 0xcc, 0x2e
     };
+#ifdef HAVE_CTRDRBG
+    /* AES-256 CTR_DRBG, no df, so the reseed entropy is full length too */
+    const byte test1Output[] =
+    {
+        0x97, 0x5f, 0xf9, 0xbb, 0x5d, 0xe0, 0xaf, 0x85, 0x6d, 0xcf, 0x38, 0x7d,
+        0xf9, 0x55, 0x37, 0xbd, 0x10, 0xdf, 0xb4, 0x4f, 0xda, 0xed, 0x45, 0x38,
+        0x62, 0xd4, 0xbd, 0x78, 0xc9, 0xa7, 0x0a, 0x09, 0xbc, 0x97, 0x70, 0xe1,
+        0xfe, 0xe4, 0x08, 0xe1, 0x1e, 0xb9, 0xb5, 0x8a, 0x3b, 0x83, 0x2a, 0x27,
+        0x3b, 0xfe, 0xbe, 0xe5, 0x5c, 0x6b, 0x66, 0x21, 0xd2, 0x3f, 0x81, 0x2b,
+        0xb3, 0x01, 0x01, 0x83, 0x92, 0x3a, 0x4b, 0x88, 0x98, 0x95, 0x5f, 0x30,
+        0xc3, 0xb4, 0x0b, 0x50, 0x49, 0x60, 0xcc, 0x5e, 0xcd, 0x16, 0xe7, 0x26,
+        0x4d, 0x89, 0x7f, 0xb0, 0xa8, 0xeb, 0x61, 0xaf, 0xbf, 0x49, 0x77, 0xf3,
+        0x9b, 0x25, 0xbc, 0xc8, 0x89, 0x18, 0xcf, 0x50, 0xe1, 0x9b, 0x45, 0x63,
+        0x7f, 0xb7, 0x0f, 0xae, 0x4d, 0x5a, 0xac, 0x9a, 0xdb, 0xde, 0xf6, 0x55,
+        0x02, 0xd2, 0x68, 0xb8, 0x07, 0xed, 0x05, 0xce
+    };
+#else
     const byte test1Output[] =
     {
         0xd3, 0xe1, 0x60, 0xc3, 0x5b, 0x99, 0xf3, 0x40, 0xb2, 0x62, 0x82, 0x64,
@@ -2870,6 +3842,7 @@ int random_test(void)
         0x12, 0x04, 0x15, 0x52, 0x8b, 0x22, 0x95, 0x91, 0x02, 0x81, 0xb0, 0x2d,
         0xd4, 0x31, 0xf4, 0xc9, 0xf7, 0x04, 0x27, 0xdf
     };
+#endif
     const byte test2EntropyA[] =
     {
         0x63, 0x36, 0x33, 0x77, 0xe4, 0x1e, 0x86, 0x46, 0x8d, 0xeb, 0x0a, 0xb4,
@@ -2877,6 +3850,29 @@ int random_test(void)
         0x45, 0x4e, 0x81, 0xe9, 0x53, 0x58, 0xa5, 0x69, 0x80, 0x8a, 0xa3, 0x8f,
         0x2a, 0x72, 0xa6, 0x23, 0x59, 0x91, 0x5a, 0x9f, 0x8a, 0x04, 0xca, 0x68
     };
+#ifdef HAVE_CTRDRBG
+    const byte test2EntropyB[] =
+    {
+        0xe6, 0x2b, 0x8a, 0x8e, 0xe8, 0xf1, 0x41, 0xb6, 0x98, 0x05, 0x66, 0xe3,
+        0xbf, 0xe3, 0xc0, 0x49, 0x03, 0xda, 0xd4, 0xac, 0x2c, 0xdf, 0x9f, 0x22,
+        0x80, 0x01, 0x0a, 0x67, 0x39, 0xbc, 0x83, 0xd3, 0x5d, 0x1e, 0x3b, 0x0c,
+        0x74, 0x92, 0xa8, 0x21, 0xf7, 0x46, 0xc2, 0x58, 0x0e, 0x9b, 0x33, 0x6a
+    };
+    const byte test2Output[] =
+    {
+        0x06, 0x4b, 0x1b, 0x39, 0xcf, 0x7a, 0x21, 0x2c, 0x3b, 0x93, 0x81, 0x88,
+        0x3a, 0xbc, 0xc1, 0x44, 0xf8, 0x63, 0x44, 0x33, 0x39, 0x4d, 0xf7, 0x94,
+        0x84, 0xce, 0xda, 0x17, 0xd8, 0x71, 0x37, 0xed, 0x49, 0xf3, 0x7e, 0x1b,
+        0x86, 0xa8, 0x2c, 0x68, 0xc4, 0x80, 0xa6, 0xb9, 0xf2, 0x0a, 0x2d, 0xf2,
+        0xb8, 0x0d, 0x86, 0x46, 0xeb, 0x7f, 0x7a, 0x6c, 0x6c, 0x19, 0xd8, 0x38,
+        0x1a, 0x88, 0x7f, 0x21, 0xbf, 0xd2, 0xd0, 0xb8, 0x95, 0xc5, 0xc8, 0xfe,
+        0xc1, 0xf9, 0x5f, 0x4f, 0xff, 0x07, 0x2e, 0x10, 0x27, 0x11, 0x24, 0x5e,
+        0x60, 0x0d, 0xd1, 0x2a, 0xab, 0xed, 0x28, 0xe2, 0xdb, 0xb7, 0xb7, 0x21,
+        0x0d, 0x7f, 0xee, 0xde, 0x02, 0x6e, 0xbf, 0x8c, 0x24, 0x0a, 0xc0, 0x3b,
+        0x1f, 0xc7, 0x1a, 0x0b, 0x96, 0x28, 0xc0, 0xe8, 0x3c, 0x9c, 0x68, 0x50,
+        0x1c, 0xd7, 0xbe, 0xb1, 0x62, 0xde, 0x39, 0x49
+    };
+#else
     const byte test2EntropyB[] =
     {
         0xe6, 0x2b, 0x8a, 0x8e, 0xe8, 0xf1, 0x41, 0xb6, 0x98, 0x05, 0x66, 0xe3,
@@ -2897,6 +3893,7 @@ int random_test(void)
         0x82, 0xc9, 0x55, 0xa8, 0x19, 0x69, 0xe0, 0x69, 0xfa, 0x8c, 0xe0, 0x07,
         0xa1, 0x80, 0x18, 0x3a, 0x07, 0xdf, 0xae, 0x17
     };
+#endif
 
     byte output[SHA256_DIGEST_SIZE * 4];
     int ret;
@@ -2918,6 +3915,35 @@ int random_test(void)
     if (XMEMCMP(test2Output, output, sizeof(output)) != 0)
         return -42;
 
+#if defined(CYASSL_RNG_BUFFER) || defined(CYASSL_TLS_THREAD_RNG)
+    {
+        /* B draws from this thread's buffer, A too unless only TLS shares
+           it, across several refills */
+        RNG  rngA, rngB;
+        byte big[5000];
+        int  i;
+
+        if (InitRng(&rngA) != 0 || InitRngThread(&rngB) != 0)
+            return -43;
+
+        for (i = 0; i < 200; i++) {
+            if (RNG_GenerateBlock(&rngA, output, SHA256_DIGEST_SIZE) != 0 ||
+                RNG_GenerateBlock(&rngB, output + SHA256_DIGEST_SIZE,
+                                                   SHA256_DIGEST_SIZE) != 0)
+                return -44;
+            if (XMEMCMP(output, output + SHA256_DIGEST_SIZE,
+                                                   SHA256_DIGEST_SIZE) == 0)
+                return -45;
+        }
+
+        if (RNG_GenerateBlock(&rngA, big, sizeof(big)) != 0)
+            return -46;
+
+        if (FreeRng(&rngA) != 0 || FreeRng(&rngB) != 0)
+            return -47;
+    }
+#endif
+
     return 0;
 }
 
@@ -2945,6 +3971,140 @@ int random_test(void)
 #endif /* HAVE_HASHDRBG || NO_RC4 */
 
 
+#ifdef CYASSL_CRYPTO_DEV
+
+#define CRYPTODEV_TEST_ID 7
+
+/* counts what it's asked for, makes up random bytes and declines the rest */
+static int cryptodev_test_cb(int devId, CryptoDevInfo* info, void* ctx)
+{
+    int* calls = (int*)ctx;
+
+    if (devId != CRYPTODEV_TEST_ID)
+        return BAD_FUNC_ARG;
+
+    calls[info->algo]++;
+
+    if (info->algo == CRYPTO_DEV_RNG) {
+        XMEMSET(info->u.rng.out, 0x5a, info->u.rng.sz);
+        return 0;
+    }
+
+    return CRYPTO_DEV_UNAVAILABLE_E;
+}
+
+
+int cryptodev_test(void)
+{
+    int  calls[CRYPTO_DEV_RNG + 1];
+    byte block[32];
+    byte expected[32];
+    RNG  rng;
+    int  i, ret;
+
+    XMEMSET(calls, 0, sizeof(calls));
+    XMEMSET(&rng, 0, sizeof(rng));
+
+    if (CryptoDev_RegisterDevice(CRYPTODEV_TEST_ID, NULL, NULL) != BAD_FUNC_ARG)
+        return -4300;
+    if (CryptoDev_RegisterDevice(CRYPTODEV_TEST_ID, cryptodev_test_cb, calls)
+                                                                         != 0)
+        return -4301;
+
+    /* the device handles random */
+    if (InitRng(&rng) != 0)
+        return -4302;
+    RngSetDevId(&rng, CRYPTODEV_TEST_ID);
+    if (RNG_GenerateBlock(&rng, block, sizeof(block)) != 0)
+        return -4303;
+    for (i = 0; i < (int)sizeof(block); i++)
+        if (block[i] != 0x5a)
+            return -4304;
+    if (calls[CRYPTO_DEV_RNG] != 1)
+        return -4305;
+
+#if defined(HAVE_AESGCM)
+    {
+        /* declined, software has to give the same as without a device */
+        Aes  aes;
+        byte key[16], iv[12], aad[20], tag[16], tag2[16];
+        byte out[sizeof(block)], out2[sizeof(block)];
+
+        XMEMSET(&aes, 0, sizeof(aes));
+        for (i = 0; i < (int)sizeof(key); i++) key[i] = (byte)i;
+        XMEMSET(iv, 0x11, sizeof(iv));
+        XMEMSET(aad, 0x22, sizeof(aad));
+        XMEMSET(block, 0x33, sizeof(block));
+
+        AesGcmSetKey(&aes, key, sizeof(key));
+        AesGcmEncrypt(&aes, out, block, sizeof(block), iv, sizeof(iv),
+                      tag, sizeof(tag), aad, sizeof(aad));
+
+        AesGcmSetKey(&aes, key, sizeof(key));
+        AesSetDevId(&aes, CRYPTODEV_TEST_ID);
+        if (AesGcmEncrypt(&aes, out2, block, sizeof(block), iv, sizeof(iv),
+                          tag2, sizeof(tag2), aad, sizeof(aad)) != 0)
+            return -4306;
+        if (memcmp(out, out2, sizeof(out)) != 0 ||
+                                       memcmp(tag, tag2, sizeof(tag)) != 0)
+            return -4307;
+        if (AesGcmDecrypt(&aes, out2, out, sizeof(out), iv, sizeof(iv),
+                          tag, sizeof(tag), aad, sizeof(aad)) != 0)
+            return -4308;
+        if (memcmp(out2, block, sizeof(block)) != 0)
+            return -4309;
+        if (calls[CRYPTO_DEV_AES_GCM_ENC] != 1 ||
+                                           calls[CRYPTO_DEV_AES_GCM_DEC] != 1)
+            return -4310;
+    }
+#endif
+
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+    {
+        Hmac hmac;
+        byte key[20];
+        byte hash[SHA256_DIGEST_SIZE], hash2[SHA256_DIGEST_SIZE];
+
+        XMEMSET(&hmac, 0, sizeof(hmac));
+        XMEMSET(key, 0x0b, sizeof(key));
+        if (HmacSetKey(&hmac, SHA256, key, sizeof(key)) != 0 ||
+                HmacUpdate(&hmac, block, sizeof(block)) != 0 ||
+                HmacFinal(&hmac, hash) != 0)
+            return -4311;
+
+        HmacSetDevId(&hmac, CRYPTODEV_TEST_ID);
+        if (HmacSetKey(&hmac, SHA256, key, sizeof(key)) != 0 ||
+                HmacUpdate(&hmac, block, sizeof(block)) != 0 ||
+                HmacFinal(&hmac, hash2) != 0)
+            return -4312;
+        if (memcmp(hash, hash2, sizeof(hash)) != 0)
+            return -4313;
+        if (calls[CRYPTO_DEV_HMAC] != 3)
+            return -4314;
+    }
+#endif
+
+    /* gone, the rng is back to software */
+    CryptoDev_UnRegisterDevice(CRYPTODEV_TEST_ID);
+    XMEMSET(expected, 0x5a, sizeof(expected));
+    ret = RNG_GenerateBlock(&rng, block, sizeof(block));
+    if (ret != 0)
+        return -4315;
+    if (memcmp(block, expected, sizeof(block)) == 0)
+        return -4316;
+    if (calls[CRYPTO_DEV_RNG] != 1)
+        return -4317;
+
+#if defined(HAVE_HASHDRBG) || defined(NO_RC4)
+    FreeRng(&rng);
+#endif
+
+    return 0;
+}
+
+#endif /* CYASSL_CRYPTO_DEV */
+
+
 #ifdef HAVE_NTRU
 
 byte GetEntropy(ENTROPY_CMD cmd, byte* out);
@@ -3092,6 +4252,18 @@ int rsa_test(void)
 
     if (memcmp(plain, in, ret)) return -48;
 
+    /* blinded exponents differ per call, PKCS #1 v1.5 signatures don't */
+    {
+        byte   again[256];
+        word32 sigSz = (word32)RsaEncryptSize(&key);
+
+        ret = RsaSSL_Sign(in, inLen, again, sizeof(again), &key, &rng);
+        if (ret != (int)sigSz) return -315;
+        ret = RsaSSL_Sign(in, inLen, out, sizeof(out), &key, &rng);
+        if (ret != (int)sigSz) return -316;
+        if (memcmp(out, again, sigSz)) return -317;
+    }
+
 #if defined(CYASSL_MDK_ARM)
     #define sizeof(s) strlen((char *)(s))
 #endif
@@ -3221,6 +4393,18 @@ int rsa_test(void)
             return -306;
         }
 
+        /* generated primes make a working key */
+        ret = RsaSSL_Sign(in, inLen, out, sizeof(out), &derIn, &rng);
+        if (ret > 0)
+            ret = RsaSSL_Verify(out, ret, plain, sizeof(plain), &genKey);
+        if (ret != (int)inLen || XMEMCMP(plain, in, inLen)) {
+            free(der);
+            free(pem);
+            FreeRsaKey(&derIn);
+            FreeRsaKey(&genKey);
+            return -3061;
+        }
+
         FreeRsaKey(&derIn);
         FreeRsaKey(&genKey);
         free(pem);
@@ -3318,6 +4502,56 @@ int rsa_test(void)
         free(pem);
         free(derCert);
     }
+#if defined(CYASSL_TEST_CERT) && defined(CYASSL_ALT_NAMES)
+    /* lazy parse, alt names only decoded when asked for */
+    {
+        Cert        myCert;
+        DecodedCert decode;
+        byte*       derCert;
+        int         certSz;
+        /* subjectAltName extension, dNSName example.com */
+        const byte  altNames[] = {
+            0x30, 0x16, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x0f, 0x30,
+            0x0d, 0x82, 0x0b, 'e', 'x', 'a', 'm', 'p', 'l', 'e', '.',
+            'c', 'o', 'm'
+        };
+
+        derCert = (byte*)malloc(FOURK_BUF);
+        if (derCert == NULL)
+            return -417;
+
+        InitCert(&myCert);
+        strncpy(myCert.subject.commonName, "www.yassl.com", CTC_NAME_SIZE);
+        myCert.sigType = CTC_SHA256wRSA;
+        XMEMCPY(myCert.altNames, altNames, sizeof(altNames));
+        myCert.altNamesSz = (int)sizeof(altNames);
+
+        certSz = MakeSelfCert(&myCert, derCert, FOURK_BUF, &key, &rng);
+        if (certSz < 0) {
+            free(derCert);
+            return -418;
+        }
+
+        InitDecodedCert(&decode, derCert, certSz, 0);
+        decode.extLazy = 1;
+        ret = ParseCert(&decode, CERT_TYPE, NO_VERIFY, 0);
+        if (ret != 0 || decode.altNames != NULL || !decode.extLazyPending) {
+            FreeDecodedCert(&decode);
+            free(derCert);
+            return -419;
+        }
+        ret = DecodePendingExtensions(&decode);
+        if (ret != 0 || decode.altNames == NULL || decode.extLazyPending ||
+                        strcmp(decode.altNames->name, "example.com") != 0 ||
+                        DecodePendingExtensions(&decode) != 0) {
+            FreeDecodedCert(&decode);
+            free(derCert);
+            return -420;
+        }
+        FreeDecodedCert(&decode);
+        free(derCert);
+    }
+#endif /* CYASSL_TEST_CERT && CYASSL_ALT_NAMES */
     /* CA style */
     {
         RsaKey      caKey;
@@ -3456,6 +4690,61 @@ int rsa_test(void)
             return -415;
         }
         fclose(pemFile);
+
+        /* same issuer and subject as a batch, serials streamed */
+        {
+            CertIssuer    issuer;
+            CertBatchItem items[2];
+            byte          subject[256];
+            byte          pubKey[1024];
+            int           subjectSz, pubKeySz, i;
+
+            ret = InitCertIssuer(&issuer, &myCert, &caKey, NULL);
+            subjectSz = SetCertName(&myCert.subject, subject, sizeof(subject));
+            pubKeySz  = SetCertPublicKey(pubKey, sizeof(pubKey), &key, NULL);
+            if (ret != 0 || subjectSz <= 0 || pubKeySz <= 0) {
+                free(derCert);
+                free(pem);
+                FreeRsaKey(&caKey);
+                return -430;
+            }
+
+            memset(items, 0, sizeof(items));
+            for (i = 0; i < 2; i++) {
+                items[i].subject     = subject;
+                items[i].subjectSz   = subjectSz;
+                items[i].publicKey   = pubKey;
+                items[i].publicKeySz = pubKeySz;
+                items[i].serial[CTC_SERIAL_SIZE - 1] = (byte)(i + 1);
+                items[i].der   = i ? pem : derCert;
+                items[i].derSz = FOURK_BUF;
+            }
+
+            if (MakeCertBatch(&issuer, items, 2, &rng) != 2) {
+                free(derCert);
+                free(pem);
+                FreeRsaKey(&caKey);
+                return -431;
+            }
+
+#ifdef CYASSL_TEST_CERT
+            for (i = 0; i < 2; i++) {
+                InitDecodedCert(&decode, items[i].der, items[i].derSz, 0);
+                ret = ParseCert(&decode, CERT_TYPE, NO_VERIFY, 0);
+                if (ret == 0 && (decode.serialSz != CTC_SERIAL_SIZE ||
+                        decode.serial[CTC_SERIAL_SIZE - 1] != (byte)(i + 1)))
+                    ret = -1;
+                FreeDecodedCert(&decode);
+                if (ret != 0) {
+                    free(derCert);
+                    free(pem);
+                    FreeRsaKey(&caKey);
+                    return -432;
+                }
+            }
+#endif
+        }
+
         free(pem);
         free(derCert);
         FreeRsaKey(&caKey);
@@ -3964,6 +5253,63 @@ int dh_test(void)
     if (memcmp(agree, agree2, agreeSz))
         return -56;
 
+    /* again with key2 on a shared g table, the plain key has to agree */
+    {
+        DhFixedBase* fb;
+        byte   p[256], g[256];
+        word32 pSz = sizeof(p), gSz = sizeof(g);
+
+        if (DhParamsLoad(tmp, bytes, p, &pSz, g, &gSz) != 0)
+            return -57;
+
+        fb = (DhFixedBase*)XMALLOC(sizeof(DhFixedBase), NULL,
+                                   DYNAMIC_TYPE_TMP_BUFFER);
+        if (fb == NULL)
+            return -58;
+
+        ret = DhFixedBaseSetup(fb, p, pSz, g, gSz);
+        if (ret == 0)
+            ret = DhUseFixedBase(&key2, fb);
+        if (ret == 0)
+            ret = DhGenerateKeyPair(&key2, &rng, priv2, &privSz2, pub2,
+                                    &pubSz2);
+        if (ret == 0)
+            ret = DhAgree(&key, agree, &agreeSz, priv, privSz, pub2, pubSz2);
+        if (ret == 0)
+            ret = DhAgree(&key2, agree2, &agreeSz2, priv2, privSz2, pub,
+                          pubSz);
+
+        DhFixedBaseFree(fb);
+        XFREE(fb, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+        if (ret != 0)
+            return -59;
+        if (agreeSz != agreeSz2 || memcmp(agree, agree2, agreeSz))
+            return -60;
+    }
+
+    /* built in ffdhe2048, the only named group default fastmath fits */
+    FreeDhKey(&key);
+    FreeDhKey(&key2);
+    InitDhKey(&key);
+    InitDhKey(&key2);
+
+    privSz = privSz2 = pubSz = pubSz2 = 256;
+    ret =  DhSetNamedKey(&key, DH_FFDHE_2048);
+    ret += DhSetNamedKey(&key2, DH_FFDHE_2048);
+    if (ret == 0)
+        ret = DhGenerateKeyPair(&key, &rng, priv, &privSz, pub, &pubSz);
+    if (ret == 0)
+        ret = DhGenerateKeyPair(&key2, &rng, priv2, &privSz2, pub2, &pubSz2);
+    if (ret == 0)
+        ret = DhAgree(&key, agree, &agreeSz, priv, privSz, pub2, pubSz2);
+    if (ret == 0)
+        ret = DhAgree(&key2, agree2, &agreeSz2, priv2, privSz2, pub, pubSz);
+    if (ret != 0 || DhSetNamedKey(&key, 0) != BAD_FUNC_ARG)
+        return -61;
+    if (agreeSz != agreeSz2 || memcmp(agree, agree2, agreeSz))
+        return -62;
+
     FreeDhKey(&key);
     FreeDhKey(&key2);
 
@@ -4342,6 +5688,69 @@ int pbkdf2_test(void)
 }
 
 
+#ifndef NO_SHA256
+
+/* RFC 7914 section 11 vector, then a batch against one at a time */
+int pbkdf2_multi_test(void)
+{
+    const char* passwd[] = { "Password", "passwd", "", "pass\0word",
+                             "Password", "a much longer password than a "
+                             "single sha-256 block so it gets hashed first",
+                             "p", "Password1", "Password2" };
+    const char* salt[]   = { "NaCl", "salt", "NaCl", "sa\0lt", "", "NaCl",
+                             "s", "NaCl", "NaCl" };
+    int   count = (int)(sizeof(passwd) / sizeof(passwd[0]));
+    int   kLen  = 40;
+    int   pLen[9], sLen[9], i;
+    byte  derived[9][40], single[40];
+    byte* out[9];
+    const byte* p[9];
+    const byte* s[9];
+
+    const byte verify[] = {
+        0x4D, 0xDC, 0xD8, 0xF6, 0x0B, 0x98, 0xBE, 0x21, 0x83, 0x0C, 0xEE, 0x5E,
+        0xF2, 0x27, 0x01, 0xF9, 0x64, 0x1A, 0x44, 0x18, 0xD0, 0x4C, 0x04, 0x14,
+        0xAE, 0xFF, 0x08, 0x87, 0x6B, 0x34, 0xAB, 0x56, 0xA1, 0xD4, 0x25, 0xA1,
+        0x22, 0x58, 0x33, 0x54
+    };
+
+    if (PBKDF2(single, (const byte*)passwd[0], 8, (const byte*)salt[0], 4,
+               80000, kLen, SHA256) != 0)
+        return -104;
+    if (memcmp(single, verify, sizeof(verify)) != 0)
+        return -105;
+
+    for (i = 0; i < count; i++) {
+        p[i]    = (const byte*)passwd[i];
+        s[i]    = (const byte*)salt[i];
+        pLen[i] = (int)strlen(passwd[i]) + (i == 3 ? 5 : 0);
+        sLen[i] = (int)strlen(salt[i]) + (i == 3 ? 3 : 0);
+        out[i]  = derived[i];
+    }
+
+    if (PBKDF2Multi(out, p, pLen, s, sLen, 1000, kLen, SHA256, count) != 0)
+        return -106;
+
+    for (i = 0; i < count; i++) {
+        if (PBKDF2(single, p[i], pLen[i], s[i], sLen[i], 1000, kLen,
+                   SHA256) != 0)
+            return -107;
+        if (memcmp(single, derived[i], kLen) != 0)
+            return -108;
+    }
+
+    /* other hashes take the one at a time path */
+    if (PBKDF2Multi(out, p, pLen, s, sLen, 2048, 24, SHA, 2) != 0 ||
+        PBKDF2(single, p[1], pLen[1], s[1], sLen[1], 2048, 24, SHA) != 0 ||
+        memcmp(single, derived[1], 24) != 0)
+        return -109;
+
+    return 0;
+}
+
+#endif /* NO_SHA256 */
+
+
 int pbkdf1_test(void)
 {
     char passwd[] = "password";
@@ -4369,6 +5778,9 @@ int pwdbased_test(void)
 {
    int ret =  pbkdf1_test();
    ret += pbkdf2_test();
+#ifndef NO_SHA256
+   ret += pbkdf2_multi_test();
+#endif
 
    return ret + pkcs12_test();
 }
@@ -4413,6 +5825,11 @@ int hkdf_test(void)
                       0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf,
                       0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18,
                       0x58, 0x65 };
+    byte prk4[32] = { 0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf,
+                      0x0d, 0xdc, 0x3f, 0x0d, 0xc4, 0x7b, 0xba, 0x63,
+                      0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31,
+                      0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5 };
+    byte prk[32];
 
     (void)res1;
     (void)res2;
@@ -4420,6 +5837,8 @@ int hkdf_test(void)
     (void)res4;
     (void)salt1;
     (void)info1;
+    (void)prk4;
+    (void)prk;
 
 #ifndef NO_SHA
     ret = HKDF(SHA, ikm1, 22, NULL, 0, NULL, 0, okm1, L);
@@ -4456,6 +5875,25 @@ int hkdf_test(void)
 
     if (memcmp(okm1, res4, L) != 0)
         return -2007;
+
+    /* same vector one step at a time */
+    ret = HKDF_Extract(SHA256, salt1, 13, ikm1, 22, prk);
+    if (ret != 0)
+        return -2008;
+
+    if (memcmp(prk, prk4, sizeof(prk)) != 0)
+        return -2009;
+
+    ret = HKDF_Expand(SHA256, prk, sizeof(prk), info1, 10, okm1, L);
+    if (ret != 0)
+        return -2010;
+
+    if (memcmp(okm1, res4, L) != 0)
+        return -2011;
+
+    if (HKDF_Expand(SHA256, prk, sizeof(prk), info1, 10, okm1,
+                    255 * SHA256_DIGEST_SIZE + 1) != BAD_FUNC_ARG)
+        return -2012;
 #endif /* HAVE_FIPS */
 #endif /* NO_SHA256 */
 
@@ -4569,6 +6007,29 @@ int ecc_test(void)
     if (memcmp(sharedA, sharedB, y))
         return -1013;
 
+#ifdef HAVE_COMP_KEY
+    /* the other root, -Q, shares its x with Q */
+    exportBuf[0] ^= 0x01;
+    ecc_free(&pubKey);
+    ecc_init(&pubKey);
+    ret = ecc_import_x963(exportBuf, x, &pubKey);
+    if (ret != 0)
+        return -1060;
+
+    y = sizeof(sharedB);
+    ret = ecc_shared_secret(&userB, &pubKey, sharedB, &y);
+    if (ret != 0 || memcmp(sharedA, sharedB, y))
+        return -1061;
+
+    /* x = 1 isn't on P-256 */
+    memset(exportBuf + 1, 0, x - 1);
+    exportBuf[x - 1] = 0x01;
+    ecc_free(&pubKey);
+    ecc_init(&pubKey);
+    if (ecc_import_x963(exportBuf, x, &pubKey) == 0)
+        return -1062;
+#endif
+
     /* test DSA sign hash */
     for (i = 0; i < (int)sizeof(digest); i++)
         digest[i] = (byte)i;
@@ -4588,6 +6049,66 @@ int ecc_test(void)
     if (verify != 1)
         return -1016;
 
+    {
+        /* again through a key set up for repeated verifies */
+        ecc_verify_key vk;
+
+        ret = ecc_verify_key_prepare(&userA, &vk);
+        if (ret != 0)
+            return -1050;
+
+        verify = 0;
+        ret = ecc_verify_hash_vk(sig, x, digest, sizeof(digest), &verify, &vk);
+        if (ret == 0 && verify == 1) {
+            digest[0] ^= 1;
+            ret = ecc_verify_hash_vk(sig, x, digest, sizeof(digest), &verify,
+                                     &vk);
+            digest[0] ^= 1;
+        }
+        ecc_verify_key_free(&vk);
+        if (ret != 0 || verify != 0)
+            return -1051;
+    }
+
+    {
+        /* batch sign over both keys, check each alone and as a batch */
+        byte        bsig[4][ECC_BUFSIZE];
+        byte*       bout[4];
+        const byte* bin[4];
+        word32      binLen[4], boutLen[4];
+        int         bstat[4];
+        ecc_key*    bkey[4];
+
+        for (i = 0; i < 4; i++) {
+            bin[i]     = digest;
+            binLen[i]  = sizeof(digest) - i;
+            bout[i]    = bsig[i];
+            boutLen[i] = sizeof(bsig[i]);
+            bkey[i]    = (i & 1) ? &userB : &userA;
+        }
+
+        ret = ecc_sign_hash_batch(bin, binLen, bout, boutLen, 4, &rng, bkey);
+        if (ret != 0)
+            return -1042;
+
+        for (i = 0; i < 4; i++) {
+            verify = 0;
+            ret = ecc_verify_hash(bsig[i], boutLen[i], digest, binLen[i],
+                                  &verify, bkey[i]);
+            if (ret != 0 || verify != 1)
+                return -1043;
+        }
+
+        /* corrupt one signature, the rest must still verify */
+        bsig[2][boutLen[2] - 1] ^= 1;
+        ret = ecc_verify_hash_batch((const byte**)bout, boutLen, bin, binLen,
+                                    bstat, 4, bkey);
+        if (ret != 0)
+            return -1044;
+        if (bstat[0] != 1 || bstat[1] != 1 || bstat[2] != 0 || bstat[3] != 1)
+            return -1045;
+    }
+
     x = sizeof(exportBuf);
     ret = ecc_export_private_only(&userA, exportBuf, &x);
     if (ret != 0)
@@ -4673,9 +6194,152 @@ int ecc_test(void)
 
             if (verify != 1)
                 return -1023 - i;
+
+            /* the batch path on the generic curve code */
+            {
+                const byte* bsig  = sig;
+                const byte* bhash = hash;
+                byte*       bout[2];
+                const byte* bin[2];
+                word32      binLen[2], boutLen[2];
+                int         bstat[2];
+                ecc_key*    bkey[2];
+
+                y = sizeof(hash);
+                bkey[0] = &userA;
+                ret = ecc_verify_hash_batch(&bsig, &x, &bhash, &y, bstat, 1,
+                                            bkey);
+                if (ret != 0 || bstat[0] != 1)
+                    return -1046;
+
+                bin[0]  = bin[1] = hash;
+                binLen[0] = binLen[1] = sizeof(hash);
+                bout[0] = sharedA;
+                bout[1] = sharedB;
+                boutLen[0] = sizeof(sharedA);
+                boutLen[1] = sizeof(sharedB);
+                bkey[1] = &userA;
+                ret = ecc_sign_hash_batch(bin, binLen, bout, boutLen, 2, &rng,
+                                          bkey);
+                if (ret != 0)
+                    return -1047;
+
+                /* not DER at all, only marks the entries invalid */
+                ret = ecc_verify_hash_batch(bin, binLen, bin, binLen, bstat,
+                                            2, bkey);
+                if (ret != 0 || bstat[0] != 0 || bstat[1] != 0)
+                    return -1049;
+
+                ret = ecc_verify_hash_batch((const byte**)bout, boutLen, bin,
+                                            binLen, bstat, 2, bkey);
+                if (ret != 0 || bstat[0] != 1 || bstat[1] != 1)
+                    return -1048;
+            }
         }
     }
 
+    {
+        /* P-256 known answers for ECDSA verify and ECDH, then fixed base
+           key generation checked against a variable base multiply of G */
+        Sha     sha;
+        byte    msg[128];
+        byte    hash[SHA_DIGEST_SIZE];
+        ecc_key peer, gen, rnd;
+        const byte z[] = {
+            0xbd, 0x95, 0xc6, 0x5d, 0x75, 0x79, 0xd4, 0x85,
+            0x73, 0x42, 0x0a, 0xc4, 0xf0, 0xd0, 0x03, 0x94,
+            0xb3, 0x77, 0x4d, 0x90, 0x2b, 0x07, 0xf4, 0xfd,
+            0xc7, 0xa3, 0x26, 0xe4, 0xc3, 0x49, 0x74, 0x77
+        };
+
+        for (i = 0; i < (int)sizeof(msg); i++)
+            msg[i] = (byte)(i * 7 + 3);
+
+        ret = InitSha(&sha);
+        if (ret != 0)
+            return -1030;
+        ShaUpdate(&sha, msg, sizeof(msg));
+        ShaFinal(&sha, hash);
+
+        ecc_free(&userA);
+        ecc_init(&userA);
+        ret = ecc_import_raw(&userA,
+            "c18a3ea235f9d9ce2db1083f32d802d3c032d130b7b2a3c155916652def18d8a",
+            "9ea55241486dfb38d82ef78439edaad14099da22c0c4d30f6e955184b2024ffd",
+            "dded821c8822e5fc9cd5de855fb692b83a837a3f5062af177a7d2bfdbadbed8a",
+            "ECC-256");
+        if (ret != 0)
+            return -1031;
+
+        x = sizeof(sig);
+        ret = ecc_rs_to_sig(
+            "0c3a83db500812824eea17ddcf5f2202463abcb4c6a4e3176487623103dac822",
+            "455a2055c17ed7156cd7efc43afa98c4d32cb0e6e9032dc94d2c7642823742fa",
+            sig, &x);
+        if (ret != 0)
+            return -1032;
+
+        verify = 0;
+        ret = ecc_verify_hash(sig, x, hash, sizeof(hash), &verify, &userA);
+        if (ret != 0 || verify != 1)
+            return -1033;
+
+        hash[0] ^= 1;
+        ret = ecc_verify_hash(sig, x, hash, sizeof(hash), &verify, &userA);
+        if (ret != 0 || verify != 0)
+            return -1034;
+
+        ecc_init(&peer);
+        ret = ecc_import_raw(&peer,
+            "99b251492edde0b49b26b6e7302ef5f75211426af5a69247686490c0b0515966",
+            "2e0db0fa73621e49c8770ed305d016206b3d8f7fbfe56315c68ee2f66f5ef931",
+            "9a1346b0177214efcd4477bf87147cb9de98f3aa7e25a6d959ba9020202e73aa",
+            "ECC-256");
+        if (ret != 0)
+            return -1035;
+
+        x = sizeof(sharedA);
+        ret = ecc_shared_secret(&userA, &peer, sharedA, &x);
+        if (ret != 0 || x != sizeof(z) || memcmp(sharedA, z, x))
+            return -1036;
+
+        x = sizeof(sharedA);
+        ret = ecc_shared_secret(&peer, &userA, sharedA, &x);
+        if (ret != 0 || x != sizeof(z) || memcmp(sharedA, z, x))
+            return -1037;
+
+        /* the generator as a public key, k * G two different ways */
+        ecc_init(&gen);
+        ret = ecc_import_raw(&gen,
+            "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296",
+            "4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5",
+            "1", "ECC-256");
+        if (ret != 0)
+            return -1038;
+
+        for (i = 0; i < 4; i++) {
+            ecc_init(&rnd);
+            ret = ecc_make_key(&rng, 32, &rnd);
+            if (ret != 0)
+                return -1039;
+
+            x = sizeof(sharedA);
+            ret = ecc_shared_secret(&rnd, &gen, sharedA, &x);
+            if (ret != 0)
+                return -1040;
+
+            y = sizeof(exportBuf);
+            ret = ecc_export_x963(&rnd, exportBuf, &y);
+            if (ret != 0 || y != 2 * x + 1 || memcmp(sharedA, exportBuf + 1, x))
+                return -1041;
+
+            ecc_free(&rnd);
+        }
+
+        ecc_free(&gen);
+        ecc_free(&peer);
+    }
+
 
 #ifdef CYASSL_KEY_GEN
     {
@@ -4851,6 +6515,76 @@ int ecc_encrypt_test(void)
         ecc_ctx_free(cliCtx);
     }
 
+    {  /* sessions, A sends several messages to B on one key agreement */
+        ecEncSession* sendA = ecc_session_new(&userA, &userB, NULL);
+        ecEncSession* recvB = ecc_session_new(&userB, &userA, NULL);
+        byte    first[sizeof(out) + ECC_SESSION_NONCE_SZ];
+        byte    sess[sizeof(out) + ECC_SESSION_NONCE_SZ];
+        word32  sessSz;
+
+        if (sendA == NULL || recvB == NULL)
+            return -3015;
+
+        for (i = 0; i < 3; i++) {
+            sessSz = sizeof(sess);
+            ret = ecc_session_encrypt(sendA, msg, sizeof(msg), sess, &sessSz);
+            if (ret != 0 || sessSz != ECC_SESSION_NONCE_SZ + sizeof(msg) +
+                                      SHA256_DIGEST_SIZE)
+                return -3016;
+            if (i == 0)
+                memcpy(first, sess, sessSz);
+            else if (memcmp(first + ECC_SESSION_NONCE_SZ,
+                            sess + ECC_SESSION_NONCE_SZ, sizeof(msg)) == 0)
+                return -3017;                    /* IVs differ per message */
+
+            plainSz = sizeof(plain);
+            ret = ecc_session_decrypt(recvB, sess, sessSz, plain, &plainSz);
+            if (ret != 0 || plainSz != sizeof(msg) ||
+                                            memcmp(plain, msg, sizeof(msg)))
+                return -3018;
+        }
+
+        /* a replay, and a flipped bit */
+        plainSz = sizeof(plain);
+        if (ecc_session_decrypt(recvB, first, sessSz, plain, &plainSz) !=
+                                                             ECC_SESSION_SEQ_E)
+            return -3019;
+        sessSz = sizeof(sess);
+        ret = ecc_session_encrypt(sendA, msg, sizeof(msg), sess, &sessSz);
+        sess[ECC_SESSION_NONCE_SZ] ^= 1;
+        if (ret != 0 || ecc_session_decrypt(recvB, sess, sessSz, plain,
+                                            &plainSz) != ECC_SESSION_MAC_E)
+            return -3020;
+
+        /* streamed in pieces, the same session format */
+        ret  = ecc_session_encrypt_begin(sendA, sess);
+        ret += ecc_session_encrypt_update(sendA, msg, 16,
+                                          sess + ECC_SESSION_NONCE_SZ);
+        ret += ecc_session_encrypt_update(sendA, msg + 16, 32,
+                                          sess + ECC_SESSION_NONCE_SZ + 16);
+        ret += ecc_session_encrypt_final(sendA,
+                                    sess + ECC_SESSION_NONCE_SZ + sizeof(msg));
+        if (ret != 0)
+            return -3021;
+
+        ret  = ecc_session_decrypt_begin(recvB, sess);
+        ret += ecc_session_decrypt_update(recvB, sess + ECC_SESSION_NONCE_SZ,
+                                          32, plain);
+        ret += ecc_session_decrypt_update(recvB,
+                                   sess + ECC_SESSION_NONCE_SZ + 32, 16,
+                                   plain + 32);
+        ret += ecc_session_decrypt_final(recvB,
+                                    sess + ECC_SESSION_NONCE_SZ + sizeof(msg));
+        if (ret != 0 || memcmp(plain, msg, sizeof(msg)) != 0)
+            return -3022;
+
+        if (ecc_session_encrypt_update(sendA, msg, 15, sess) != BAD_ENC_STATE_E)
+            return -3023;
+
+        ecc_session_free(recvB);
+        ecc_session_free(sendA);
+    }
+
     /* cleanup */
     ecc_free(&userB);
     ecc_free(&userA);
@@ -4870,9 +6604,41 @@ int ecc25519_test(void)
     byte    sharedB[1024];
     word32  x, y;
     byte    exportBuf[1024];
-    int ret;
+    int ret, i;
     ecc25519_key userA, userB, pubKey;
 
+    /* RFC 7748 section 6.1, keys stored big endian */
+    const byte alicePriv[] = {
+        0x2a, 0x2c, 0xb9, 0x1d, 0xa5, 0xfb, 0x77, 0xb1,
+        0x2a, 0x99, 0xc0, 0xeb, 0x87, 0x2f, 0x4c, 0xdf,
+        0x45, 0x66, 0xb2, 0x51, 0x72, 0xc1, 0x16, 0x3c,
+        0x7d, 0xa5, 0x18, 0x73, 0x0a, 0x6d, 0x07, 0x77
+    };
+    const byte alicePub[] = {
+        0x6a, 0x4e, 0x9b, 0xaa, 0x8e, 0xa9, 0xa4, 0xeb,
+        0xf4, 0x1a, 0x38, 0x26, 0x0d, 0x3a, 0xbf, 0x0d,
+        0x5a, 0xf7, 0x3e, 0xb4, 0xdc, 0x7d, 0x8b, 0x74,
+        0x54, 0xa7, 0x30, 0x89, 0x09, 0xf0, 0x20, 0x85
+    };
+    const byte bobPriv[] = {
+        0xeb, 0xe0, 0x88, 0xff, 0x27, 0x8b, 0x2f, 0x1c,
+        0xfd, 0xb6, 0x18, 0x26, 0x29, 0xb1, 0x3b, 0x6f,
+        0xe6, 0x0e, 0x80, 0x83, 0x8b, 0x7f, 0xe1, 0x79,
+        0x4b, 0x8a, 0x4a, 0x62, 0x7e, 0x08, 0xab, 0x5d
+    };
+    const byte bobPub[] = {
+        0x4f, 0x2b, 0x88, 0x6f, 0x14, 0x7e, 0xfc, 0xad,
+        0x4d, 0x67, 0x78, 0x5b, 0xc8, 0x43, 0x83, 0x3f,
+        0x37, 0x35, 0xe4, 0xec, 0xc2, 0x61, 0x5b, 0xd3,
+        0xb4, 0xc1, 0x7d, 0x7b, 0x7d, 0xdb, 0x9e, 0xde
+    };
+    const byte kaShared[] = {
+        0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1,
+        0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+        0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+        0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+    };
+
     ret = InitRng(&rng);
     if (ret != 0)
         return -1001;
@@ -4928,6 +6694,49 @@ int ecc25519_test(void)
     if (memcmp(sharedA, sharedB, y))
         return -1010;
 
+    /* known answer */
+    if (ecc25519_import_private_raw(alicePriv, sizeof(alicePriv), alicePub,
+                                    sizeof(alicePub), &userA) != 0)
+        return -1040;
+
+    if (ecc25519_import_private_raw(bobPriv, sizeof(bobPriv), bobPub,
+                                    sizeof(bobPub), &userB) != 0)
+        return -1041;
+
+    x = sizeof(sharedA);
+    ret = ecc25519_shared_secret(&userA, &userB, sharedA, &x);
+    if (ret != 0 || x != sizeof(kaShared) || memcmp(sharedA, kaShared, x))
+        return -1042;
+
+    y = sizeof(sharedB);
+    ret = ecc25519_shared_secret(&userB, &userA, sharedB, &y);
+    if (ret != 0 || y != sizeof(kaShared) || memcmp(sharedB, kaShared, y))
+        return -1043;
+
+    /* against the base point 9, the fixed base path, gives the public keys,
+       little endian where they're stored big endian */
+    XMEMSET(exportBuf, 0, ECC25519_KEYSIZE);
+    exportBuf[ECC25519_KEYSIZE - 1] = 9;
+    if (ecc25519_import_private_raw(alicePriv, sizeof(alicePriv), exportBuf,
+                                    ECC25519_KEYSIZE, &pubKey) != 0)
+        return -1044;
+
+    x = sizeof(sharedA);
+    ret = ecc25519_shared_secret(&userA, &pubKey, sharedA, &x);
+    if (ret != 0 || x != sizeof(alicePub))
+        return -1045;
+    for (i = 0; i < (int)x; i++)
+        if (sharedA[i] != alicePub[x - 1 - i])
+            return -1046;
+
+    y = sizeof(sharedB);
+    ret = ecc25519_shared_secret(&userB, &pubKey, sharedB, &y);
+    if (ret != 0 || y != sizeof(bobPub))
+        return -1047;
+    for (i = 0; i < (int)y; i++)
+        if (sharedB[i] != bobPub[y - 1 - i])
+            return -1048;
+
 
     ecc25519_free(&pubKey);
     ecc25519_free(&userB);
@@ -4938,6 +6747,234 @@ int ecc25519_test(void)
 #endif /* HAVE_ECC25519 */
 
 
+#ifdef HAVE_ED25519
+
+int ed25519_test(void)
+{
+    RNG    rng;
+    byte   out[ED25519_SIG_SIZE];
+    byte   exportPKey[ED25519_PUB_KEY_SIZE];
+    byte   exportSKey[ED25519_KEY_SIZE];
+    byte   bad[ED25519_SIG_SIZE];
+    word32 outlen;
+    word32 exportPSz;
+    word32 exportSSz;
+    int    i;
+    int    ret;
+    int    verify;
+    int    stats[3];
+    ed25519_key  key[3];
+    ed25519_key  key2;
+    ed25519_key* keys[3];
+    const byte*  sigList[3];
+    const byte*  msgList[3];
+    word32       sigLens[3];
+
+    /* RFC 8032 section 7.1, tests 1 to 3 */
+    const byte sKey1[] = {
+        0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60,
+        0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+        0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19,
+        0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60
+    };
+    const byte sKey2[] = {
+        0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda,
+        0x9d, 0xb6, 0xc3, 0x46, 0xec, 0x11, 0x4e, 0x0f,
+        0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+        0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb
+    };
+    const byte sKey3[] = {
+        0xc5, 0xaa, 0x8d, 0xf4, 0x3f, 0x9f, 0x83, 0x7b,
+        0xed, 0xb7, 0x44, 0x2f, 0x31, 0xdc, 0xb7, 0xb1,
+        0x66, 0xd3, 0x85, 0x35, 0x07, 0x6f, 0x09, 0x4b,
+        0x85, 0xce, 0x3a, 0x2e, 0x0b, 0x44, 0x58, 0xf7
+    };
+    const byte pKey1[] = {
+        0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7,
+        0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+        0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25,
+        0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a
+    };
+    const byte pKey2[] = {
+        0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a,
+        0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+        0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+        0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c
+    };
+    const byte pKey3[] = {
+        0xfc, 0x51, 0xcd, 0x8e, 0x62, 0x18, 0xa1, 0xa3,
+        0x8d, 0xa4, 0x7e, 0xd0, 0x02, 0x30, 0xf0, 0x58,
+        0x08, 0x16, 0xed, 0x13, 0xba, 0x33, 0x03, 0xac,
+        0x5d, 0xeb, 0x91, 0x15, 0x48, 0x90, 0x80, 0x25
+    };
+    const byte sigs1[] = {
+        0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72,
+        0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+        0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74,
+        0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+        0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac,
+        0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+        0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24,
+        0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b
+    };
+    const byte sigs2[] = {
+        0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8,
+        0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+        0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+        0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+        0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e,
+        0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+        0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee,
+        0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00
+    };
+    const byte sigs3[] = {
+        0x62, 0x91, 0xd6, 0x57, 0xde, 0xec, 0x24, 0x02,
+        0x48, 0x27, 0xe6, 0x9c, 0x3a, 0xbe, 0x01, 0xa3,
+        0x0c, 0xe5, 0x48, 0xa2, 0x84, 0x74, 0x3a, 0x44,
+        0x5e, 0x36, 0x80, 0xd7, 0xdb, 0x5a, 0xc3, 0xac,
+        0x18, 0xff, 0x9b, 0x53, 0x8d, 0x16, 0xf2, 0x90,
+        0xae, 0x67, 0xf7, 0x60, 0x98, 0x4d, 0xc6, 0x59,
+        0x4a, 0x7c, 0x15, 0xe9, 0x71, 0x6e, 0xd2, 0x8d,
+        0xc0, 0x27, 0xbe, 0xce, 0xea, 0x1e, 0xc4, 0x0a
+    };
+    const byte msg1[] = { 0x00 };   /* test 1 signs the empty message */
+    const byte msg2[] = { 0x72 };
+    const byte msg3[] = { 0xaf, 0x82 };
+
+    const byte*  sKeys[]   = { sKey1, sKey2, sKey3 };
+    const byte*  pKeys[]   = { pKey1, pKey2, pKey3 };
+    const byte*  sigs[]    = { sigs1, sigs2, sigs3 };
+    const byte*  msgs[]    = { msg1,  msg2,  msg3 };
+    const word32 msgSz[]   = { 0, sizeof(msg2), sizeof(msg3) };
+
+    ret = InitRng(&rng);
+    if (ret != 0)
+        return -1100;
+
+    ed25519_init(&key2);
+
+    for (i = 0; i < 3; i++) {
+        ed25519_init(&key[i]);
+
+        if (ed25519_import_private_key(sKeys[i], ED25519_KEY_SIZE, pKeys[i],
+                                       ED25519_PUB_KEY_SIZE, &key[i]) != 0)
+            return -1101 - i;
+
+        outlen = sizeof(out);
+        if (ed25519_sign_msg(msgs[i], msgSz[i], out, &outlen, &key[i]) != 0)
+            return -1104 - i;
+
+        if (outlen != ED25519_SIG_SIZE || XMEMCMP(out, sigs[i], outlen))
+            return -1107 - i;
+
+        verify = 0;
+        if (ed25519_verify_msg(out, outlen, msgs[i], msgSz[i], &verify,
+                               &key[i]) != 0 || verify != 1)
+            return -1110 - i;
+
+        /* a changed R, a changed S, and S + l must all fail */
+        XMEMCPY(bad, out, sizeof(bad));
+        bad[1] ^= 0x01;
+        if (ed25519_verify_msg(bad, outlen, msgs[i], msgSz[i], &verify,
+                               &key[i]) != 0 || verify != 0)
+            return -1113 - i;
+
+        XMEMCPY(bad, out, sizeof(bad));
+        bad[40] ^= 0x01;
+        if (ed25519_verify_msg(bad, outlen, msgs[i], msgSz[i], &verify,
+                               &key[i]) != 0 || verify != 0)
+            return -1116 - i;
+
+        XMEMCPY(bad, out, sizeof(bad));
+        bad[63] |= 0xe0;
+        if (ed25519_verify_msg(bad, outlen, msgs[i], msgSz[i], &verify,
+                               &key[i]) != 0 || verify != 0)
+            return -1119 - i;
+
+        keys[i]    = &key[i];
+        sigList[i] = sigs[i];
+        msgList[i] = msgs[i];
+        sigLens[i] = ED25519_SIG_SIZE;
+    }
+
+    /* batch, all good then one bad */
+    if (ed25519_verify_msg_batch(sigList, sigLens, msgList, msgSz, stats, 3,
+                                 keys) != 0)
+        return -1122;
+    if (stats[0] != 1 || stats[1] != 1 || stats[2] != 1)
+        return -1123;
+
+    XMEMCPY(bad, sigs2, sizeof(bad));
+    bad[33] ^= 0x01;
+    sigList[1] = bad;
+    if (ed25519_verify_msg_batch(sigList, sigLens, msgList, msgSz, stats, 3,
+                                 keys) != 0)
+        return -1124;
+    if (stats[0] != 1 || stats[1] != 0 || stats[2] != 1)
+        return -1125;
+
+    /* generated key, round trip through export and import */
+    if (ed25519_make_key(&rng, ED25519_KEY_SIZE, &key2) != 0)
+        return -1126;
+
+    exportPSz = sizeof(exportPKey);
+    exportSSz = sizeof(exportSKey);
+    if (ed25519_export_public(&key2, exportPKey, &exportPSz) != 0 ||
+        ed25519_export_private_only(&key2, exportSKey, &exportSSz) != 0)
+        return -1127;
+
+    outlen = sizeof(out);
+    if (ed25519_sign_msg(msg3, sizeof(msg3), out, &outlen, &key2) != 0)
+        return -1128;
+
+    ed25519_free(&key[0]);
+    ed25519_init(&key[0]);
+    if (ed25519_import_public(exportPKey, exportPSz, &key[0]) != 0)
+        return -1129;
+
+    verify = 0;
+    if (ed25519_verify_msg(out, outlen, msg3, sizeof(msg3), &verify,
+                           &key[0]) != 0 || verify != 1)
+        return -1130;
+
+    /* the wrong key */
+    if (ed25519_verify_msg(out, outlen, msg3, sizeof(msg3), &verify,
+                           &key[2]) != 0 || verify != 0)
+        return -1131;
+
+    ed25519_free(&key[1]);
+    ed25519_init(&key[1]);
+    if (ed25519_import_private_key(exportSKey, exportSSz, exportPKey,
+                                   exportPSz, &key[1]) != 0)
+        return -1132;
+
+    outlen = sizeof(bad);
+    if (ed25519_sign_msg(msg3, sizeof(msg3), bad, &outlen, &key[1]) != 0 ||
+        XMEMCMP(out, bad, sizeof(bad)))
+        return -1133;
+
+    /* sizes and bad args */
+    outlen = ED25519_SIG_SIZE - 1;
+    if (ed25519_sign_msg(msg3, sizeof(msg3), out, &outlen, &key2) != BUFFER_E)
+        return -1134;
+
+    if (ed25519_sign_msg(msg3, sizeof(msg3), out, &outlen, NULL) !=
+                                                                 BAD_FUNC_ARG)
+        return -1135;
+
+    if (ed25519_size(&key2) != ED25519_KEY_SIZE ||
+        ed25519_sig_size(&key2) != ED25519_SIG_SIZE)
+        return -1136;
+
+    for (i = 0; i < 3; i++)
+        ed25519_free(&key[i]);
+    ed25519_free(&key2);
+
+    return 0;
+}
+#endif /* HAVE_ED25519 */
+
+
 #ifdef HAVE_LIBZ
 
 const byte sample_text[] =
@@ -5018,6 +7055,70 @@ const byte sample_text[] =
     "bag dolor terry richardson sapiente.\n";
 
 
+/* chunked deflate with a preset dictionary and a memory budget, reused after
+   a reset, through one persistent inflate stream */
+static int compress_stream_test(byte* c, word32 cSz, byte* d, word32 dSz)
+{
+    CompressStream cs, ds;
+    const byte* dict = sample_text + 64;
+    word32 dictSz = 512, chunk = 700;
+    word32 i, n, piece, cIdx, dIdx;
+    int    ret, pass;
+
+    if (CompressStreamInit(&cs, COMPRESS_STREAM_DEFLATE, 1024, NULL) == 0)
+        return -310;
+
+    if (CompressStreamInit(&cs, COMPRESS_STREAM_DEFLATE, 64 * 1024, NULL) != 0)
+        return -311;
+    if (CompressStreamInit(&ds, COMPRESS_STREAM_INFLATE, 0, NULL) != 0) {
+        CompressStreamFree(&cs);
+        return -312;
+    }
+
+    ret = 0;
+    if (CompressStreamSetDictionary(&cs, dict, dictSz) != 0 ||
+        CompressStreamSetDictionary(&ds, dict, dictSz) != 0)
+        ret = -313;
+
+    for (pass = 0; ret == 0 && pass < 2; pass++) {
+        cIdx = dIdx = 0;
+        for (i = 0; ret == 0 && i < dSz; i += n) {
+            n = (dSz - i < chunk) ? dSz - i : chunk;
+            ret = CompressStreamUpdate(&cs, c + cIdx, cSz - cIdx,
+                                       sample_text + i, n);
+            if (ret < 0) {
+                ret = -314;
+                break;
+            }
+            /* each sync flushed piece inflates on its own */
+            piece = (word32)ret;
+            ret = CompressStreamUpdate(&ds, d + dIdx, dSz - dIdx, c + cIdx,
+                                       piece);
+            if (ret < 0) {
+                ret = -315;
+                break;
+            }
+            cIdx += piece;
+            dIdx += (word32)ret;
+            ret  = 0;
+        }
+
+        if (ret == 0 && (dIdx != dSz || memcmp(d, sample_text, dSz)))
+            ret = -316;
+
+        if (ret == 0 && (CompressStreamFinal(&cs, c, cSz) <= 0 ||
+                         CompressStreamReset(&cs) != 0 ||
+                         CompressStreamReset(&ds) != 0))
+            ret = -317;
+    }
+
+    CompressStreamFree(&cs);
+    CompressStreamFree(&ds);
+
+    return ret;
+}
+
+
 int compress_test(void)
 {
     int ret = 0;
@@ -5046,6 +7147,9 @@ int compress_test(void)
     if (ret == 0 && memcmp(d, sample_text, dSz))
         ret = -303;
 
+    if (ret == 0)
+        ret = compress_stream_test(c, cSz, d, dSz);
+
     if (c) free(c);
     if (d) free(d);
 
@@ -5375,6 +7479,186 @@ int pkcs7signed_test(void)
     return ret;
 }
 
+/* stream chunks of in through update, appending to out */
+static int pkcs7_stream_chunks(PKCS7* pkcs7, PKCS7Stream* stream, int sign,
+                               const byte* in, word32 inSz, word32 chunk,
+                               byte* out, word32* outSz, word32 outMax)
+{
+    word32 i, n;
+    int    ret;
+
+    for (i = 0; i < inSz; i += n) {
+        n = (inSz - i < chunk) ? inSz - i : chunk;
+        if (sign)
+            ret = PKCS7_EncodeSignedDataUpdate(pkcs7, stream, in + i, n,
+                                               out + *outSz, outMax - *outSz);
+        else
+            ret = PKCS7_EncodeEnvelopedDataUpdate(pkcs7, stream, in + i, n,
+                                                  out + *outSz,
+                                                  outMax - *outSz);
+        if (ret < 0)
+            return ret;
+        *outSz += ret;
+    }
+
+    return 0;
+}
+
+int pkcs7stream_test(void)
+{
+    int ret = 0;
+
+    FILE* file;
+    byte* certDer;
+    byte* keyDer;
+    byte* out;
+    byte  data[1000];
+    word32 certDerSz, keyDerSz, outSz = 0, hdrSz = 0, i;
+    PKCS7 msg;
+    PKCS7Stream stream;
+    RNG rng;
+
+    for (i = 0; i < sizeof(data); i++)
+        data[i] = (byte)i;
+
+    certDer = (byte*)malloc(FOURK_BUF);
+    keyDer  = (byte*)malloc(FOURK_BUF);
+    out     = (byte*)malloc(FOURK_BUF);
+    if (certDer == NULL || keyDer == NULL || out == NULL) {
+        free(certDer);
+        free(keyDer);
+        free(out);
+        return -220;
+    }
+
+    file = fopen(clientCert, "rb");
+    if (!file) {
+        free(certDer);
+        free(keyDer);
+        free(out);
+        return -221;
+    }
+    certDerSz = (word32)fread(certDer, 1, FOURK_BUF, file);
+    fclose(file);
+
+    file = fopen(clientKey, "rb");
+    if (!file) {
+        free(certDer);
+        free(keyDer);
+        free(out);
+        return -221;
+    }
+    keyDerSz = (word32)fread(keyDer, 1, FOURK_BUF, file);
+    fclose(file);
+
+    ret = InitRng(&rng);
+    if (ret != 0) {
+        free(certDer);
+        free(keyDer);
+        free(out);
+        return -222;
+    }
+
+    /* signed, content in odd sized pieces */
+    PKCS7_InitWithCert(&msg, certDer, certDerSz);
+    msg.privateKey   = keyDer;
+    msg.privateKeySz = keyDerSz;
+    msg.hashOID      = SHAh;
+    msg.encryptOID   = RSAk;
+    msg.rng          = &rng;
+
+    ret = PKCS7_EncodeSignedDataInit(&msg, &stream, out, FOURK_BUF);
+    if (ret > 0) {
+        hdrSz = outSz = (word32)ret;
+        ret = pkcs7_stream_chunks(&msg, &stream, 1, data, sizeof(data), 77,
+                                  out, &outSz, FOURK_BUF);
+    }
+    if (ret == 0) {
+        ret = PKCS7_EncodeSignedDataFinal(&msg, &stream, out + outSz,
+                                          FOURK_BUF - outSz);
+        if (ret > 0) {
+            outSz += ret;
+            ret = 0;
+        }
+    }
+    PKCS7_Free(&msg);
+    if (ret != 0)
+        ret = -223;
+
+    /* verified a byte at a time, the signer cert comes from the message */
+    if (ret == 0) {
+        PKCS7_InitWithCert(&msg, NULL, 0);
+        ret = PKCS7_VerifySignedDataInit(&msg, &stream);
+        for (i = 0; i < outSz && ret == 0; i++)
+            ret = PKCS7_VerifySignedDataUpdate(&msg, &stream, out + i, 1);
+        if (ret == 0)
+            ret = PKCS7_VerifySignedDataFinal(&msg, &stream);
+        if (ret != 0 || msg.singleCert == NULL)
+            ret = -224;
+        PKCS7_Free(&msg);
+        PKCS7_StreamFree(&stream);
+    }
+
+    /* a changed content byte is caught */
+    if (ret == 0) {
+        out[hdrSz + 2 + 40] ^= 0x01;
+        PKCS7_InitWithCert(&msg, NULL, 0);
+        ret = PKCS7_VerifySignedDataInit(&msg, &stream);
+        if (ret == 0)
+            ret = PKCS7_VerifySignedDataUpdate(&msg, &stream, out, outSz);
+        if (ret == 0)
+            ret = PKCS7_VerifySignedDataFinal(&msg, &stream);
+        ret = (ret == 0) ? -225 : 0;
+        PKCS7_Free(&msg);
+        PKCS7_StreamFree(&stream);
+    }
+
+    /* enveloped, the one shot decodes the segments */
+    if (ret == 0) {
+        PKCS7_InitWithCert(&msg, certDer, certDerSz);
+        msg.contentOID   = DATA;
+        msg.encryptOID   = DES3b;
+        msg.privateKey   = keyDer;
+        msg.privateKeySz = keyDerSz;
+
+        ret = PKCS7_EncodeEnvelopedDataInit(&msg, &stream, out, FOURK_BUF);
+        if (ret > 0) {
+            outSz = (word32)ret;
+            ret = pkcs7_stream_chunks(&msg, &stream, 0, data, sizeof(data), 77,
+                                      out, &outSz, FOURK_BUF);
+        }
+        if (ret == 0) {
+            ret = PKCS7_EncodeEnvelopedDataFinal(&msg, &stream, out + outSz,
+                                                 FOURK_BUF - outSz);
+            if (ret > 0) {
+                outSz += ret;
+                ret = 0;
+            }
+        }
+        if (ret != 0)
+            ret = -226;
+    }
+    if (ret == 0) {
+        byte decoded[sizeof(data)];
+
+        if (PKCS7_DecodeEnvelopedData(&msg, out, outSz, decoded,
+                                      sizeof(decoded)) != (int)sizeof(data) ||
+            memcmp(decoded, data, sizeof(data)) != 0)
+            ret = -227;
+        PKCS7_Free(&msg);
+    }
+
+    free(certDer);
+    free(keyDer);
+    free(out);
+
+#if defined(HAVE_HASHDRBG) || defined(NO_RC4)
+    FreeRng(&rng);
+#endif
+
+    return ret;
+}
+
 #endif /* HAVE_PKCS7 */
 
 #endif /* NO_CRYPT_TEST */
@@ -40,7 +40,10 @@ CYASSL_LOCAL void FreeCRL(CYASSL_CRL*, int dynamic);
 
 CYASSL_LOCAL int  LoadCRL(CYASSL_CRL* crl, const char* path, int type, int mon);
 CYASSL_LOCAL int  BufferLoadCRL(CYASSL_CRL*, const byte*, long, int);
+CYASSL_LOCAL int  StreamLoadCRL(CYASSL_CRL*, CbCRLRead, void* ctx, int type);
 CYASSL_LOCAL int  CheckCertCRL(CYASSL_CRL*, DecodedCert*);
+CYASSL_LOCAL int  StartCRL_Fetch(CYASSL_CRL*);
+CYASSL_LOCAL int  EmbedCrlLookup(const char* url, int urlSz, byte** crlBuf);
 
 
 #ifdef __cplusplus
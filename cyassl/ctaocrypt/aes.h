@@ -84,9 +84,17 @@ typedef struct Aes {
     /* key-based fast multiplication table. */
     ALIGN16 byte M0[256][AES_BLOCK_SIZE];
 #endif /* GCM_TABLE */
+#ifdef CYASSL_AESNI
+    /* byte reflected H^1..H^4 for the PCLMULQDQ GHASH */
+    ALIGN16 byte Hpow[4][AES_BLOCK_SIZE];
+#endif /* CYASSL_AESNI */
 #endif /* HAVE_AESGCM */
 #ifdef CYASSL_AESNI
     byte use_aesni;
+    byte use_vaes;           /* 512 bit VAES for CBC decrypt */
+#ifdef HAVE_AESGCM
+    byte use_clmul;
+#endif
 #endif /* CYASSL_AESNI */
 #ifdef HAVE_CAVIUM
     AesType type;            /* aes key type */
@@ -94,6 +102,10 @@ typedef struct Aes {
     word32  magic;           /* using cavium magic */
     word64  contextHandle;   /* nitrox context memory handle */
 #endif
+#ifdef CYASSL_CRYPTO_DEV
+    int     cdevId;          /* crypto device id */
+    word32  cdevMagic;       /* using crypto device magic */
+#endif
 #ifdef CYASSL_AES_COUNTER
     word32  left;            /* unsued bytes left from last call */
 #endif
@@ -153,6 +165,10 @@ CYASSL_API int  AesCcmDecrypt(Aes* aes, byte* out, const byte* in, word32 inSz,
     CYASSL_API void AesFreeCavium(Aes*);
 #endif
 
+#ifdef CYASSL_CRYPTO_DEV
+    CYASSL_API void AesSetDevId(Aes*, int devId);
+#endif
+
 
 #ifdef HAVE_FIPS
     /* fips wrapper calls, user can call direct */
@@ -40,6 +40,12 @@
 #endif
 
 
+/* validity dates are converted to seconds since 1970 once when decoded */
+#if !defined(NO_TIME_H) && defined(WORD64_AVAILABLE)
+    #define HAVE_DATE_EPOCH
+#endif
+
+
 enum {
     ISSUER  = 0,
     SUBJECT = 1,
@@ -192,7 +198,8 @@ enum Key_Sum {
     DSAk   = 515,
     RSAk   = 645,
     NTRUk  = 274,
-    ECDSAk = 518
+    ECDSAk = 518,
+    ED25519k = 256   /* 1.3.101.112, RFC 8410 */
 };
 
 
@@ -358,6 +365,9 @@ struct DecodedCert {
     byte*   extensions;              /* not owned, points into raw cert  */
     int     extensionsSz;            /* length of cert extensions */
     word32  extensionsIdx;           /* if want to go back and parse later */
+    byte    extLazy;                 /* set before parse to defer the heavy
+                                        extensions, not needed to verify  */
+    byte    extLazyPending;          /* deferred extensions not decoded yet */
     byte*   extAuthInfo;             /* Authority Information Access URI */
     int     extAuthInfoSz;           /* length of the URI                */
     byte*   extCrlInfo;              /* CRL Distribution Points          */
@@ -403,6 +413,16 @@ struct DecodedCert {
     int     beforeDateLen;
     byte*   afterDate;
     int     afterDateLen;
+#ifdef HAVE_DATE_EPOCH
+    word64  beforeEpoch;             /* seconds since 1970, 0 if unparsed */
+    word64  afterEpoch;
+#endif
+#ifdef HAVE_PARALLEL_VERIFY
+    const byte* sigKey;              /* signature confirmed ahead with this
+                                        issuer key, NULL if not          */
+    word32  sigKeySz;
+    word32  sigKeyOID;
+#endif
 #ifdef HAVE_PKCS7
     byte*   issuerRaw;               /* pointer to issuer inside source */
     int     issuerRawLen;
@@ -478,6 +498,14 @@ struct Signer {
         byte    subjectKeyIdHash[SIGNER_DIGEST_SIZE];
                                      /* sha hash of names in certificate */
     #endif
+    #ifdef HAVE_OCSP
+        byte    subjectKeyHash[SIGNER_DIGEST_SIZE];
+                                     /* sha hash of publicKey, set on add */
+    #endif
+    #ifdef HAVE_TRUST_STORE
+        byte    inStore;             /* publicKey and name are in a store */
+    #endif
+    void*   caKey;                   /* publicKey decoded on first verify */
     Signer* next;
 };
 
@@ -496,12 +524,19 @@ CYASSL_TEST_API void FreeAltNames(DNS_entry*, void*);
 CYASSL_TEST_API void InitDecodedCert(DecodedCert*, byte*, word32, void*);
 CYASSL_TEST_API void FreeDecodedCert(DecodedCert*);
 CYASSL_TEST_API int  ParseCert(DecodedCert*, int type, int verify, void* cm);
+CYASSL_TEST_API int  DecodePendingExtensions(DecodedCert*);
 
 CYASSL_LOCAL int ParseCertRelative(DecodedCert*, int type, int verify,void* cm);
 CYASSL_LOCAL int DecodeToKey(DecodedCert*, int verify);
+#ifdef HAVE_PARALLEL_VERIFY
+CYASSL_LOCAL int ConfirmCertSignature(DecodedCert*, const byte* key,
+                                      word32 keySz, word32 keyOID);
+#endif
 
 CYASSL_LOCAL Signer* MakeSigner(void*);
 CYASSL_LOCAL void    FreeSigner(Signer*, void*);
+CYASSL_LOCAL void*   MakeSignerKey(Signer*, void*);
+CYASSL_LOCAL void    FreeSignerKey(word32 keyOID, void* key, void*);
 CYASSL_LOCAL void    FreeSignerTable(Signer**, int, void*);
 
 
@@ -509,6 +544,11 @@ CYASSL_LOCAL int ToTraditional(byte* buffer, word32 length);
 CYASSL_LOCAL int ToTraditionalEnc(byte* buffer, word32 length,const char*, int);
 
 CYASSL_LOCAL int ValidateDate(const byte* date, byte format, int dateType);
+CYASSL_LOCAL word32 DateTimeLeft(const byte* date, byte format);
+#ifdef HAVE_DATE_EPOCH
+CYASSL_LOCAL int GetDateEpoch(const byte* date, byte format, word64* epoch);
+CYASSL_LOCAL int ValidateEpoch(word64 epoch, int dateType);
+#endif
 
 /* ASN.1 helper functions */
 CYASSL_LOCAL int GetLength(const byte* input, word32* inOutIdx, int* len,
@@ -640,6 +680,8 @@ struct OcspResponse {
 
     byte*   source;          /* pointer to source buffer, not owned */
     word32  maxIdx;          /* max offset based on init size */
+
+    void*   cm;              /* responder must chain to these CAs, or NULL */
 };
 
 
@@ -673,19 +715,11 @@ CYASSL_LOCAL int  CompareOcspReqResp(OcspRequest*, OcspResponse*);
 #endif /* HAVE_OCSP */
 
 
-/* for pointer use */
-typedef struct RevokedCert RevokedCert;
-
 #ifdef HAVE_CRL
 
-struct RevokedCert {
-    byte         serialNumber[EXTERNAL_SERIAL_SIZE];
-    int          serialSz;
-    RevokedCert* next;
-};
-
 typedef struct DecodedCRL DecodedCRL;
 
+/* revoked serials are packed back to back, a length byte then the serial */
 struct DecodedCRL {
     word32  certBegin;               /* offset to start of cert          */
     word32  sigIndex;                /* offset to start of signature     */
@@ -698,12 +732,21 @@ struct DecodedCRL {
     byte    nextDate[MAX_DATE_SIZE]; /* next update date   */
     byte    lastDateFormat;          /* format of last date */
     byte    nextDateFormat;          /* format of next date */
-    RevokedCert* certs;              /* revoked cert list  */
-    int          totalCerts;         /* number on list     */
+#ifdef HAVE_DATE_EPOCH
+    word64  nextEpoch;               /* next date, seconds since 1970    */
+#endif
+    byte*   serials;                 /* packed revoked serials, owned    */
+    word32  serialsSz;               /* bytes used in serials            */
+    word32  serialsMax;              /* bytes allocated for serials      */
+    int     totalCerts;              /* number in serials                */
 };
 
+/* CRL input for streamed parsing, returns bytes read, 0 at end, < 0 error */
+typedef int (*CRL_ReadCb)(void* ctx, byte* buf, int sz);
+
 CYASSL_LOCAL void InitDecodedCRL(DecodedCRL*);
 CYASSL_LOCAL int  ParseCRL(DecodedCRL*, const byte* buff, word32 sz, void* cm);
+CYASSL_LOCAL int  ParseCRL_Stream(DecodedCRL*, CRL_ReadCb, void* ctx, void* cm);
 CYASSL_LOCAL void FreeDecodedCRL(DecodedCRL*);
 
 
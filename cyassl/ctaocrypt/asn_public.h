@@ -59,7 +59,8 @@ enum Ctc_SigType {
     CTC_SHA384wRSA   = 656,
     CTC_SHA384wECDSA = 525,
     CTC_SHA512wRSA   = 657,
-    CTC_SHA512wECDSA = 526
+    CTC_SHA512wECDSA = 526,
+    CTC_ED25519      = 256
 };
 
 enum Ctc_Encoding {
@@ -78,7 +79,9 @@ enum Ctc_Misc {
     CTC_NAME_SIZE    =    64,
     CTC_DATE_SIZE    =    32,
     CTC_MAX_ALT_SIZE = 16384,   /* may be huge */
-    CTC_SERIAL_SIZE  =     8
+    CTC_SERIAL_SIZE  =     8,
+    CTC_VERSION_ENC_SIZE =   8, /* encoded [0] version */
+    CTC_ISSUER_ENC_SIZE  = 352  /* encoded sig algo, issuer name, validity */
 };
 
 typedef struct CertName {
@@ -151,6 +154,42 @@ CYASSL_API int  SignCert(int requestSz, int sigType, byte* derBuffer,
                          word32 derSz, RsaKey*, ecc_key*, RNG*);
 CYASSL_API int  MakeSelfCert(Cert*, byte* derBuffer, word32 derSz, RsaKey*,
                              RNG*);
+
+/* issuer half of a certificate, encoded once by InitCertIssuer() and only
+   read by MakeCertBatch(), so threads can share it and the decoded CA key */
+typedef struct CertIssuer {
+    byte     version[CTC_VERSION_ENC_SIZE];
+    word32   versionSz;
+    byte     head[CTC_ISSUER_ENC_SIZE]; /* sig algo | issuer | validity */
+    word32   headSz;
+    word32   sigAlgoSz;                 /* sig algo leads head */
+    int      sigType;
+    RsaKey*  rsaKey;                    /* CA signing key */
+    ecc_key* eccKey;
+} CertIssuer;
+
+/* one certificate to issue, subject parts come pre-encoded */
+typedef struct CertBatchItem {
+    const byte* subject;                /* from SetCertName() */
+    word32      subjectSz;
+    const byte* publicKey;              /* from SetCertPublicKey() */
+    word32      publicKeySz;
+    const byte* extensions;             /* encoded [3] extensions or NULL */
+    word32      extensionsSz;
+    byte        serial[CTC_SERIAL_SIZE]; /* all 0 for a random one */
+    byte*       der;                    /* output buffer */
+    word32      derSz;                  /* in buffer size, out cert size */
+    int         ret;                    /* 0 or this item's error */
+} CertBatchItem;
+
+CYASSL_API int  InitCertIssuer(CertIssuer*, Cert*, RsaKey* caRsaKey,
+                               ecc_key* caEccKey);
+CYASSL_API int  SetCertName(const CertName*, byte* output, word32 outSz);
+CYASSL_API int  SetCertPublicKey(byte* output, word32 outSz, RsaKey*,
+                                 ecc_key*);
+CYASSL_API int  MakeCertBatch(const CertIssuer*, CertBatchItem*, int count,
+                              RNG*);
+
 CYASSL_API int  SetIssuer(Cert*, const char*);
 CYASSL_API int  SetSubject(Cert*, const char*);
 #ifdef CYASSL_ALT_NAMES
@@ -186,6 +225,44 @@ CYASSL_API word32 EncodeSignature(byte* out, const byte* digest, word32 digSz,
                                   int hashOID);
 CYASSL_API int GetCTC_HashOID(int type);
 
+
+/* DER cursor, spans point into the caller's buffer, nothing is allocated */
+typedef struct DerSpan {
+    const byte* data;           /* contents, after tag and length */
+    word32      sz;
+    byte        tag;
+} DerSpan;
+
+typedef struct DerCursor {
+    const byte* input;
+    word32      idx;
+    word32      maxIdx;
+} DerCursor;
+
+/* a certificate's top fields, each span is the element's contents */
+typedef struct DerCertFields {
+    DerSpan tbs;
+    DerSpan serial;
+    DerSpan sigAlgo;
+    DerSpan issuer;
+    DerSpan notBefore;
+    DerSpan notAfter;
+    DerSpan subject;
+    DerSpan publicKey;
+    DerSpan extensions;         /* sz 0 if none */
+    DerSpan signature;
+} DerCertFields;
+
+CYASSL_API int DerCursorInit(DerCursor*, const byte* der, word32 sz);
+CYASSL_API int DerNext(DerCursor*, DerSpan* item);
+CYASSL_API int DerEnter(const DerSpan* item, DerCursor* inner);
+CYASSL_API int DerGetCertFields(const byte* der, word32 sz, DerCertFields*);
+CYASSL_API int DerGetNameEntry(const DerSpan* name, byte dnType,
+                               DerSpan* value);
+CYASSL_API int DerGetExtension(const DerCertFields*, const byte* oid,
+                               word32 oidSz, DerSpan* value);
+CYASSL_API int DerGetAltNames(const DerCertFields*, DerCursor* names);
+
 #ifdef __cplusplus
     } /* extern "C" */
 #endif
@@ -37,10 +37,16 @@
 
 #include <cyassl/ctaocrypt/types.h>
 
+/* the little endian loads and stores go through XMEMCPY, the parameter
+   blocks are written field by field and read back as words, a plain pointer
+   cast lets the optimizer reorder those under strict aliasing */
+
 static inline word32 load32( const void *src )
 {
 #if defined(LITTLE_ENDIAN_ORDER)
-  return *( word32 * )( src );
+  word32 w;
+  XMEMCPY( &w, src, sizeof( w ) );
+  return w;
 #else
   const byte *p = ( byte * )src;
   word32 w = *p++;
@@ -54,7 +60,9 @@ static inline word32 load32( const void *src )
 static inline word64 load64( const void *src )
 {
 #if defined(LITTLE_ENDIAN_ORDER)
-  return *( word64 * )( src );
+  word64 w;
+  XMEMCPY( &w, src, sizeof( w ) );
+  return w;
 #else
   const byte *p = ( byte * )src;
   word64 w = *p++;
@@ -72,7 +80,7 @@ static inline word64 load64( const void *src )
 static inline void store32( void *dst, word32 w )
 {
 #if defined(LITTLE_ENDIAN_ORDER)
-  *( word32 * )( dst ) = w;
+  XMEMCPY( dst, &w, sizeof( w ) );
 #else
   byte *p = ( byte * )dst;
   *p++ = ( byte )w; w >>= 8;
@@ -85,7 +93,7 @@ static inline void store32( void *dst, word32 w )
 static inline void store64( void *dst, word64 w )
 {
 #if defined(LITTLE_ENDIAN_ORDER)
-  *( word64 * )( dst ) = w;
+  XMEMCPY( dst, &w, sizeof( w ) );
 #else
   byte *p = ( byte * )dst;
   *p++ = ( byte )w; w >>= 8;
@@ -85,8 +85,9 @@
     byte  salt[BLAKE2B_SALTBYTES]; /* 24 */
     byte  personal[BLAKE2S_PERSONALBYTES];  /* 32 */
   } blake2s_param;
+#pragma pack(pop)
 
-  ALIGN( 64 ) typedef struct __blake2s_state
+  typedef struct __blake2s_state
   {
     word32 h[8];
     word32 t[2];
@@ -96,6 +97,7 @@
     byte  last_node;
   } blake2s_state ;
 
+#pragma pack(push, 1)
   typedef struct __blake2b_param
   {
     byte  digest_length; /* 1 */
@@ -110,8 +112,11 @@
     byte  salt[BLAKE2B_SALTBYTES]; /* 48 */
     byte  personal[BLAKE2B_PERSONALBYTES];  /* 64 */
   } blake2b_param;
+#pragma pack(pop)
 
-  ALIGN( 64 ) typedef struct __blake2b_state
+  /* only the parameter blocks are packed, the states keep natural alignment
+     so they can be array elements and live in XMALLOC'd memory */
+  typedef struct __blake2b_state
   {
     word64 h[8];
     word64 t[2];
@@ -133,10 +138,9 @@
   {
     blake2b_state S[4][1];
     blake2b_state R[1];
-    byte buf[4 * BLAKE2B_BLOCKBYTES];
+    byte buf[8 * BLAKE2B_BLOCKBYTES];
     word64 buflen;
   } blake2bp_state;
-#pragma pack(pop)
 
   /* Streaming API */
   int blake2s_init( blake2s_state *S, const byte outlen );
@@ -50,6 +50,19 @@ CYASSL_API int Blake2bUpdate(Blake2b*, const byte*, word32);
 CYASSL_API int Blake2bFinal(Blake2b*, byte*, word32);
 
 
+/* BLAKE2bp, four BLAKE2b leaves over interleaved blocks, a different digest
+   than BLAKE2b of the same input */
+typedef struct Blake2bp {
+    blake2bp_state S[1];        /* our state */
+    word32         digestSz;    /* digest size used on init */
+} Blake2bp;
+
+
+CYASSL_API int InitBlake2bp(Blake2bp*, word32);
+CYASSL_API int Blake2bpUpdate(Blake2bp*, const byte*, word32);
+CYASSL_API int Blake2bpFinal(Blake2bp*, byte*, word32);
+
+
 
 #ifdef __cplusplus
     } 
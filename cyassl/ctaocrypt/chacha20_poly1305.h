@@ -0,0 +1,69 @@
+/* chacha20_poly1305.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+
+#ifndef CTAO_CRYPT_CHACHA20_POLY1305_H
+#define CTAO_CRYPT_CHACHA20_POLY1305_H
+
+#include <cyassl/ctaocrypt/types.h>
+#include <cyassl/ctaocrypt/chacha.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+enum {
+    CHACHA20_POLY1305_AEAD_KEYSIZE      = 32,
+    CHACHA20_POLY1305_AEAD_IV_SIZE      = 12,
+    CHACHA20_POLY1305_AEAD_AUTHTAG_SIZE = 16
+};
+
+
+/* RFC 7539 AEAD, the cipher and the MAC run over each chunk back to back
+ * so a message only passes through the cache once */
+CYASSL_API int ChaCha20Poly1305_Encrypt(const byte* key, const byte* iv,
+                                        const byte* aad, word32 aadSz,
+                                        const byte* in, word32 inSz,
+                                        byte* out, byte* authTag);
+/* returns CHACHA_POLY_AUTH_E and zeroes out if the tag does not match */
+CYASSL_API int ChaCha20Poly1305_Decrypt(const byte* key, const byte* iv,
+                                        const byte* aad, word32 aadSz,
+                                        const byte* in, word32 inSz,
+                                        const byte* authTag, byte* out);
+
+/* same with an already keyed ChaCha, as the TLS layer holds per direction */
+CYASSL_API int ChaCha20Poly1305_EncryptCtx(ChaCha* chacha, const byte* iv,
+                                           const byte* aad, word32 aadSz,
+                                           const byte* in, word32 inSz,
+                                           byte* out, byte* authTag);
+CYASSL_API int ChaCha20Poly1305_DecryptCtx(ChaCha* chacha, const byte* iv,
+                                           const byte* aad, word32 aadSz,
+                                           const byte* in, word32 inSz,
+                                           const byte* authTag, byte* out);
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_CHACHA20_POLY1305_H */
+
+#endif /* HAVE_CHACHA && HAVE_POLY1305 */
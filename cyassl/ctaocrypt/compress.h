@@ -27,6 +27,7 @@
 
 
 #include <cyassl/ctaocrypt/types.h>
+#include <zlib.h>
 
 
 #ifdef __cplusplus
@@ -41,6 +42,34 @@ CYASSL_API int Compress(byte*, word32, const byte*, word32, word32);
 CYASSL_API int DeCompress(byte*, word32, const byte*, word32);
 
 
+enum CompressStreamType {
+    COMPRESS_STREAM_DEFLATE = 1,
+    COMPRESS_STREAM_INFLATE = 2
+};
+
+/* persistent zlib stream, set up once and fed chunk after chunk, each Update
+   is sync flushed so output can go out on a record or message boundary */
+typedef struct CompressStream {
+    z_stream    stream;
+    const byte* dict;           /* preset dictionary, caller owns */
+    word32      dictSz;
+    byte        type;           /* CompressStreamType */
+    byte        init;           /* zlib state allocated */
+} CompressStream;
+
+/* memBudget caps zlib's allocations in bytes by shrinking the window and
+   hash sizes, 0 for the zlib defaults, heap is passed to XMALLOC */
+CYASSL_API int  CompressStreamInit(CompressStream*, int type, word32 memBudget,
+                                   void* heap);
+CYASSL_API int  CompressStreamSetDictionary(CompressStream*, const byte*,
+                                            word32);
+CYASSL_API int  CompressStreamUpdate(CompressStream*, byte* out, word32 outSz,
+                                     const byte* in, word32 inSz);
+CYASSL_API int  CompressStreamFinal(CompressStream*, byte* out, word32 outSz);
+CYASSL_API int  CompressStreamReset(CompressStream*);
+CYASSL_API void CompressStreamFree(CompressStream*);
+
+
 #ifdef __cplusplus
     } /* extern "C" */
 #endif
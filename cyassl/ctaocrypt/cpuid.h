@@ -0,0 +1,103 @@
+/* cpuid.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifndef CTAO_CRYPT_CPUID_H
+#define CTAO_CRYPT_CPUID_H
+
+
+#include <cyassl/ctaocrypt/types.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+     defined(_M_IX86)) && (defined(__GNUC__) || defined(_MSC_VER)) && \
+    !defined(NO_CYASSL_CPUID)
+    #define HAVE_CYASSL_CPUID
+#endif
+
+/* 64 bit ARM linux reads the crypto extensions from the auxiliary vector */
+#if defined(__aarch64__) && defined(__linux__) && defined(__GNUC__) && \
+    !defined(NO_CYASSL_CPUID)
+    #define HAVE_CYASSL_CPUID
+#endif
+
+/* x86_64 gcc/clang can build SIMD variants per function with the target
+ * attribute, the rest of the library stays baseline so one binary still
+ * runs on every cpu generation */
+#if defined(HAVE_CYASSL_CPUID) && defined(__x86_64__) && \
+    (defined(__clang__) || __GNUC__ > 4 || \
+     (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && !defined(NO_CYASSL_X86_SIMD)
+    #define HAVE_CYASSL_X86_SIMD
+    #define CYASSL_TARGET(t) __attribute__((target(t)))
+#endif
+
+/* same idea for the ARMv8 AES, PMULL and SHA instructions, gcc 6 and later
+ * or clang take them per function */
+#if defined(HAVE_CYASSL_CPUID) && defined(__aarch64__) && \
+    (defined(__clang__) || __GNUC__ >= 6) && !defined(NO_CYASSL_ARMV8_CRYPTO)
+    #define HAVE_CYASSL_ARMV8_CRYPTO
+    #define CYASSL_TARGET(t) __attribute__((target(t)))
+    #ifdef __clang__
+        #define CYASSL_ARMV8_CRYPTO_TARGET "crypto"
+    #else
+        #define CYASSL_ARMV8_CRYPTO_TARGET "+crypto"
+    #endif
+#endif
+
+
+/* cpu features probed once at CyaSSL_Init() */
+enum {
+    CYASSL_CPU_SSE2    = 0x0001,
+    CYASSL_CPU_SSSE3   = 0x0002,
+    CYASSL_CPU_SSE4_1  = 0x0004,
+    CYASSL_CPU_AESNI   = 0x0008,
+    CYASSL_CPU_PCLMUL  = 0x0010,
+    CYASSL_CPU_AVX     = 0x0020,
+    CYASSL_CPU_AVX2    = 0x0040,
+    CYASSL_CPU_BMI2    = 0x0080,
+    CYASSL_CPU_ADX     = 0x0100,
+    CYASSL_CPU_SHA     = 0x0200,
+    CYASSL_CPU_AVX512F = 0x0400,
+    CYASSL_CPU_VAES    = 0x0800,
+
+    CYASSL_CPU_ARM_AES   = 0x1000,
+    CYASSL_CPU_ARM_PMULL = 0x2000,
+    CYASSL_CPU_ARM_SHA1  = 0x4000,
+    CYASSL_CPU_ARM_SHA2  = 0x8000,
+    CYASSL_CPU_ARM_NEON  = 0x10000
+};
+
+
+CYASSL_API word32 CyaSSL_GetCpuFeatures(void);
+CYASSL_API void   CyaSSL_SetCpuFeatureMask(word32 mask);
+
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+
+#endif /* CTAO_CRYPT_CPUID_H */
+
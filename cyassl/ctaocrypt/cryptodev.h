@@ -0,0 +1,176 @@
+/* cryptodev.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef CYASSL_CRYPTO_DEV
+
+#ifndef CTAO_CRYPT_CRYPTODEV_H
+#define CTAO_CRYPT_CRYPTODEV_H
+
+#include <cyassl/ctaocrypt/types.h>
+#include <cyassl/ctaocrypt/random.h>
+#ifndef NO_AES
+    #include <cyassl/ctaocrypt/aes.h>
+#endif
+#ifndef NO_HMAC
+    #include <cyassl/ctaocrypt/hmac.h>
+#endif
+#ifndef NO_RSA
+    #include <cyassl/ctaocrypt/rsa.h>
+#endif
+#ifdef HAVE_ECC
+    #include <cyassl/ctaocrypt/ecc.h>
+#endif
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+#define CYASSL_CRYPTO_DEV_MAGIC 0xBEEF000D
+
+enum {
+    CRYPTO_DEV_MAX_DEVICES = 8,
+
+    CRYPTO_DEV_AES_GCM_ENC = 1,
+    CRYPTO_DEV_AES_GCM_DEC = 2,
+    CRYPTO_DEV_HMAC        = 3,
+    CRYPTO_DEV_RSA         = 4,
+    CRYPTO_DEV_ECC_SIGN    = 5,
+    CRYPTO_DEV_ECDH        = 6,
+    CRYPTO_DEV_RNG         = 7
+};
+
+
+/* one request to a device, algo says which member of u is filled in */
+typedef struct CryptoDevInfo {
+    int algo;
+    union {
+    #ifndef NO_AES
+        struct {                    /* AES_GCM_ENC fills authTag, DEC checks */
+            Aes*        aes;
+            byte*       out;
+            const byte* in;
+            word32      sz;
+            const byte* iv;
+            word32      ivSz;
+            byte*       authTag;
+            word32      authTagSz;
+            const byte* authIn;
+            word32      authInSz;
+        } aesGcm;
+    #endif
+    #ifndef NO_HMAC
+        struct {                    /* exactly one of key, in or digest set */
+            Hmac*       hmac;
+            int         macType;
+            const byte* key;        /* HmacSetKey */
+            word32      keySz;
+            const byte* in;         /* HmacUpdate */
+            word32      inSz;
+            byte*       digest;     /* HmacFinal */
+        } hmac;
+    #endif
+    #ifndef NO_RSA
+        struct {                    /* raw m^e or c^d mod n, no padding */
+            RsaKey*     key;
+            int         type;       /* RSA_PUBLIC or RSA_PRIVATE */
+            const byte* in;
+            word32      inSz;
+            byte*       out;
+            word32*     outSz;      /* in/out, key size on success */
+            RNG*        rng;        /* may be NULL */
+        } rsa;
+    #endif
+    #ifdef HAVE_ECC
+        struct {                    /* DER signature as ecc_sign_hash */
+            ecc_key*    key;
+            const byte* in;
+            word32      inSz;
+            byte*       out;
+            word32*     outSz;
+            RNG*        rng;
+        } eccSign;
+        struct {
+            ecc_key*    priv;
+            ecc_key*    pub;
+            byte*       out;
+            word32*     outSz;
+        } ecdh;
+    #endif
+        struct {
+            RNG*        rng;
+            byte*       out;
+            word32      sz;
+        } rng;
+    } u;
+} CryptoDevInfo;
+
+
+/* A device returns 0 or an error when it handled the request and
+   CRYPTO_DEV_UNAVAILABLE_E to decline it, which falls back to software.
+   Hmac requests for one object have to be all handled or all declined. */
+typedef int (*CryptoDevCallback)(int devId, CryptoDevInfo* info, void* ctx);
+
+/* register or replace the callback for devId, objects opt in with
+   AesSetDevId(), HmacSetDevId(), RsaSetDevId(), EccSetDevId() and
+   RngSetDevId(). Registration isn't locked, do it before other threads
+   use the device. */
+CYASSL_API int  CryptoDev_RegisterDevice(int devId, CryptoDevCallback cb,
+                                         void* ctx);
+CYASSL_API void CryptoDev_UnRegisterDevice(int devId);
+
+
+/* internal dispatch, CRYPTO_DEV_UNAVAILABLE_E when devId has no device or
+   it declined */
+#ifndef NO_AES
+CYASSL_LOCAL int CryptoDev_AesGcm(Aes* aes, int enc, byte* out,
+                                  const byte* in, word32 sz,
+                                  const byte* iv, word32 ivSz,
+                                  byte* authTag, word32 authTagSz,
+                                  const byte* authIn, word32 authInSz);
+#endif
+#ifndef NO_HMAC
+CYASSL_LOCAL int CryptoDev_Hmac(Hmac* hmac, int macType, const byte* key,
+                                word32 keySz, const byte* in, word32 inSz,
+                                byte* digest);
+#endif
+#ifndef NO_RSA
+CYASSL_LOCAL int CryptoDev_Rsa(RsaKey* key, int type, const byte* in,
+                               word32 inSz, byte* out, word32* outSz,
+                               RNG* rng);
+#endif
+#ifdef HAVE_ECC
+CYASSL_LOCAL int CryptoDev_EccSign(ecc_key* key, const byte* in, word32 inSz,
+                                   byte* out, word32* outSz, RNG* rng);
+CYASSL_LOCAL int CryptoDev_Ecdh(ecc_key* priv, ecc_key* pub, byte* out,
+                                word32* outSz);
+#endif
+CYASSL_LOCAL int CryptoDev_Rng(RNG* rng, byte* out, word32 sz);
+
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_CRYPTODEV_H */
+#endif /* CYASSL_CRYPTO_DEV */
+
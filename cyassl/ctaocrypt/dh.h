@@ -34,12 +34,30 @@
 #endif
 
 
+/* RFC 7919 named groups, the values are their TLS codepoints */
+enum {
+    DH_FFDHE_2048 = 0x0100,
+    DH_FFDHE_3072 = 0x0101,
+    DH_FFDHE_4096 = 0x0102
+};
+
+
 /* Diffie-Hellman Key */
 typedef struct DhKey {
     mp_int p, g;                            /* group parameters  */
+    mp_mont_ctx pMont;                      /* exptmod setup for p */
+    const mp_comb_ctx* gComb;               /* shared g table, or NULL */
 } DhKey;
 
 
+/* a group's g^x comb table, built once for parameters that get reused (a
+   server's) and read only after, any number of DhKeys can share it */
+typedef struct DhFixedBase {
+    DhKey       key;                        /* the group it was built for */
+    mp_comb_ctx gComb;
+} DhFixedBase;
+
+
 CYASSL_API void InitDhKey(DhKey* key);
 CYASSL_API void FreeDhKey(DhKey* key);
 
@@ -53,9 +71,23 @@ CYASSL_API int DhKeyDecode(const byte* input, word32* inOutIdx, DhKey* key,
                            word32);
 CYASSL_API int DhSetKey(DhKey* key, const byte* p, word32 pSz, const byte* g,
                         word32 gSz);
+CYASSL_LOCAL void DhSetupMont(DhKey* key);
+
+CYASSL_API int  DhFixedBaseSetup(DhFixedBase* fb, const byte* p, word32 pSz,
+                                 const byte* g, word32 gSz);
+CYASSL_API void DhFixedBaseFree(DhFixedBase* fb);
+/* key's public value from fb's table, 0 when fb is for key's group */
+CYASSL_API int  DhUseFixedBase(DhKey* key, const DhFixedBase* fb);
+
 CYASSL_API int DhParamsLoad(const byte* input, word32 inSz, byte* p,
                             word32* pInOutSz, byte* g, word32* gInOutSz);
 
+/* compiled in group parameters, no parsing. p over FP_MAX_BITS / 2 bits won't
+   fit fastmath, 3072 and 4096 need FP_MAX_BITS raised to 6144 and 8192 */
+CYASSL_API int DhGetNamedGroup(int group, const byte** p, word32* pSz,
+                               const byte** g, word32* gSz);
+CYASSL_API int DhSetNamedKey(DhKey* key, int group);
+
 
 #ifdef __cplusplus
     } /* extern "C" */
@@ -57,12 +57,49 @@ typedef struct {
 } ecc_set_type;
 
 
+#ifdef ALT_ECC_SIZE
+
+#ifndef USE_FAST_MATH
+    #error ALT_ECC_SIZE needs USE_FAST_MATH
+#endif
+
+/* Curve sized fp_int for coordinates and point math temporaries, big enough
+   for the product of two P-521 values, instead of the FP_MAX_BITS that RSA
+   needs.  Same layout as fp_int up to the shorter dp, always set up with
+   fp_init_size(,FP_SIZE_ECC) and then used through an mp_int pointer */
+#ifndef FP_MAX_BITS_ECC
+    #define FP_MAX_BITS_ECC  (528 * 2)
+#endif
+#define FP_MAX_SIZE_ECC  (FP_MAX_BITS_ECC + (8 * DIGIT_BIT))
+#define FP_SIZE_ECC      (FP_MAX_SIZE_ECC / DIGIT_BIT)
+
+#if FP_MAX_BITS_ECC > FP_MAX_BITS
+    #error FP_MAX_BITS_ECC must not be larger than FP_MAX_BITS
+#endif
+
+typedef struct {
+    int      used,
+             sign,
+             size;
+    fp_digit dp[FP_SIZE_ECC];
+} ecc_int;
+
+#endif /* ALT_ECC_SIZE */
+
+
 /* A point on an ECC curve, stored in Jacbobian format such that (x,y,z) =>
    (x/z^2, y/z^3, 1) when interpreted as affine */
 typedef struct {
-    mp_int x;        /* The x coordinate */
-    mp_int y;        /* The y coordinate */
-    mp_int z;        /* The z coordinate */
+#ifndef ALT_ECC_SIZE
+    mp_int  x[1];    /* The x coordinate */
+    mp_int  y[1];    /* The y coordinate */
+    mp_int  z[1];    /* The z coordinate */
+#else
+    mp_int* x;       /* The x coordinate, points into xyz */
+    mp_int* y;       /* The y coordinate */
+    mp_int* z;       /* The z coordinate */
+    ecc_int xyz[3];
+#endif
 } ecc_point;
 
 
@@ -76,9 +113,23 @@ typedef struct {
                                    curves (idx >= 0) or user supplied */
     ecc_point pubkey;   /* public key */  
     mp_int    k;        /* private key */
+#ifdef CYASSL_CRYPTO_DEV
+    int       cdevId;      /* crypto device id */
+    word32    cdevMagic;   /* using crypto device magic */
+#endif
 } ecc_key;
 
 
+/* A public key set up once for many verifies, a CA's or a token signer's.
+   For P-256 a 52 KB table of the point's multiples is precomputed too, which
+   makes a verify about as cheap as two fixed base multiplies. Read only once
+   set up, any number of threads can verify with it */
+typedef struct ecc_verify_key {
+    ecc_key                key;
+    struct ecc_p256_table* table;       /* owned, NULL for other curves */
+} ecc_verify_key;
+
+
 /* ECC predefined curve sets  */
 extern const ecc_set_type ecc_sets[];
 
@@ -95,11 +146,35 @@ CYASSL_API
 int ecc_verify_hash(const byte* sig, word32 siglen, const byte* hash,
                     word32 hashlen, int* stat, ecc_key* key);
 CYASSL_API
+int ecc_verify_key_import(const byte* in, word32 inLen, ecc_verify_key* vk);
+CYASSL_API
+int ecc_verify_key_prepare(ecc_key* key, ecc_verify_key* vk);
+CYASSL_API
+void ecc_verify_key_free(ecc_verify_key* vk);
+CYASSL_API
+int ecc_verify_hash_vk(const byte* sig, word32 siglen, const byte* hash,
+                       word32 hashlen, int* stat, ecc_verify_key* vk);
+CYASSL_API
+int ecc_sign_hash_batch(const byte** in, const word32* inlen, byte** out,
+                        word32* outlen, int count, RNG* rng, ecc_key** key);
+CYASSL_API
+int ecc_verify_hash_batch(const byte** sig, const word32* siglen,
+                          const byte** hash, const word32* hashlen,
+                          int* stat, int count, ecc_key** key);
+CYASSL_API
 void ecc_init(ecc_key* key);
 CYASSL_API
 void ecc_free(ecc_key* key);
+#ifdef CYASSL_CRYPTO_DEV
+CYASSL_API
+void EccSetDevId(ecc_key* key, int devId);
+#endif
 CYASSL_API
 void ecc_fp_free(void);
+CYASSL_API
+int  ecc_fp_init_fixed(void);
+CYASSL_API
+void ecc_fp_free_fixed(void);
 
 
 /* ASN key helpers */
@@ -152,7 +227,8 @@ enum {
     KEY_SIZE_256     = 32,   
     IV_SIZE_64       =  8,
     EXCHANGE_SALT_SZ = 16,  
-    EXCHANGE_INFO_SZ = 23  
+    EXCHANGE_INFO_SZ = 23,
+    ECC_SESSION_NONCE_SZ = 8   /* counter ahead of each session message */
 };
 
 enum ecFlags {
@@ -184,6 +260,38 @@ CYASSL_API
 int ecc_decrypt(ecc_key* privKey, ecc_key* pubKey, const byte* msg,
                 word32 msgSz, byte* out, word32* outSz, ecEncCtx* ctx);
 
+/* ecc encrypt session, the ECDH and KDF done once per peer */
+typedef struct ecEncSession ecEncSession;
+
+CYASSL_API
+ecEncSession* ecc_session_new(ecc_key* privKey, ecc_key* pubKey,
+                              ecEncCtx* ctx);
+CYASSL_API
+void ecc_session_free(ecEncSession*);
+
+CYASSL_API
+int ecc_session_encrypt(ecEncSession*, const byte* msg, word32 msgSz,
+                        byte* out, word32* outSz);
+CYASSL_API
+int ecc_session_decrypt(ecEncSession*, const byte* msg, word32 msgSz,
+                        byte* out, word32* outSz);
+
+/* streaming, nonce then updates of whole blocks then the mac */
+CYASSL_API
+int ecc_session_encrypt_begin(ecEncSession*, byte* nonce);
+CYASSL_API
+int ecc_session_encrypt_update(ecEncSession*, const byte* in, word32 sz,
+                               byte* out);
+CYASSL_API
+int ecc_session_encrypt_final(ecEncSession*, byte* mac);
+CYASSL_API
+int ecc_session_decrypt_begin(ecEncSession*, const byte* nonce);
+CYASSL_API
+int ecc_session_decrypt_update(ecEncSession*, const byte* in, word32 sz,
+                               byte* out);
+CYASSL_API
+int ecc_session_decrypt_final(ecEncSession*, const byte* mac);
+
 #endif /* HAVE_ECC_ENCRYPT */
 
 #ifdef __cplusplus
@@ -26,13 +26,24 @@
 #include <cyassl/ctaocrypt/settings.h>
 #include <stdint.h>
 
+/* 5x51-bit limbs where the compiler has a 128-bit type for the products,
+   else the ref10 10x25.5-bit limbs */
+#if !defined(NO_ECC25519_FE51) && defined(__SIZEOF_INT128__)
+    #define HAVE_ECC25519_FE51
+#endif
+
+#ifdef HAVE_ECC25519_FE51
+typedef uint64_t fe[5];
+#else
 typedef int32_t fe[10];
+#endif
 
 /*
 fe means field element.
 Here the field is \Z/(2^255-19).
 An element t, entries t[0]...t[9], represents the integer
 t[0]+2^26 t[1]+2^51 t[2]+2^77 t[3]+2^102 t[4]+...+2^230 t[9].
+With HAVE_ECC25519_FE51 it is t[0]+2^51 t[1]+2^102 t[2]+2^153 t[3]+2^204 t[4].
 Bounds on each t[i] vary depending on context.
 */
 
@@ -51,6 +62,17 @@ void fe_sq(fe,fe);
 void fe_mul121666(fe,fe);
 void fe_invert(fe,fe);
 
+/* extra pieces the Edwards curve code needs */
+void fe_neg(fe,fe);
+void fe_cmov(fe,const fe,unsigned int);
+void fe_sq2(fe,fe);
+
+#ifdef HAVE_ED25519
+void fe_pow22523(fe,fe);
+int  fe_isnegative(fe);
+int  fe_isnonzero(fe);
+#endif
+
 #endif
 
 #endif /*HAVE_ECC25519*/
@@ -0,0 +1,102 @@
+/* ecc25519_ge.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_ECC25519
+#ifndef CTAO_CRYPT_ECC25519_GE_H
+#define CTAO_CRYPT_ECC25519_GE_H
+
+#include <cyassl/ctaocrypt/ecc25519_fe.h>
+#include <cyassl/ctaocrypt/types.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+/* Points on -x^2 + y^2 = 1 + d x^2 y^2 in the ref10 coordinate systems:
+     p2:     (X:Y:Z)       x = X/Z, y = Y/Z
+     p3:     (X:Y:Z:T)     x = X/Z, y = Y/Z, xy = T/Z
+     p1p1:   ((X:Z),(Y:T)) x = X/Z, y = Y/T, the output of add and double
+     precomp: (y+x, y-x, 2dxy) of an affine point
+     cached:  (Y+X, Y-X, Z, 2dT) of a p3 point */
+typedef struct {
+    fe X;
+    fe Y;
+    fe Z;
+} ge_p2;
+
+typedef struct {
+    fe X;
+    fe Y;
+    fe Z;
+    fe T;
+} ge_p3;
+
+typedef struct {
+    fe X;
+    fe Y;
+    fe Z;
+    fe T;
+} ge_p1p1;
+
+typedef struct {
+    fe yplusx;
+    fe yminusx;
+    fe xy2d;
+} ge_precomp;
+
+typedef struct {
+    fe YplusX;
+    fe YminusX;
+    fe Z;
+    fe T2d;
+} ge_cached;
+
+
+/* h = a * B, a is 32 bytes little endian with a[31] <= 127, constant time.
+   The comb over the precomputed multiples of B, X25519 key generation and
+   ed25519 both use it. */
+CYASSL_LOCAL void ge_scalarmult_base(ge_p3* h, const byte* a);
+CYASSL_LOCAL void ge_p1p1_to_p2(ge_p2* r, ge_p1p1* p);
+CYASSL_LOCAL void ge_p2_dbl(ge_p1p1* r, ge_p2* p);
+
+#ifdef HAVE_ED25519
+CYASSL_LOCAL void ge_p2_0(ge_p2* h);
+CYASSL_LOCAL void ge_tobytes(byte* s, ge_p2* h);
+CYASSL_LOCAL void ge_p3_tobytes(byte* s, ge_p3* h);
+CYASSL_LOCAL int  ge_frombytes_negate_vartime(ge_p3* h, const byte* s);
+CYASSL_LOCAL void ge_base_odd(ge_precomp* Bi);
+CYASSL_LOCAL void ge_slide(signed char* r, const byte* a);
+CYASSL_LOCAL void ge_cached_odd(ge_cached* Ai, ge_p3* A);
+CYASSL_LOCAL void ge_multi_step(ge_p2* r, int i, int n, signed char** slides,
+                                ge_cached** Ai, signed char* bslide,
+                                ge_precomp* Bi);
+CYASSL_LOCAL void ge_double_scalarmult_vartime(ge_p2* r, const byte* a,
+                                               ge_p3* A, const byte* b);
+#endif /* HAVE_ED25519 */
+
+
+#ifdef __cplusplus
+    }    /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_ECC25519_GE_H */
+#endif /* HAVE_ECC25519 */
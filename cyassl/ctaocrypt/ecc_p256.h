@@ -0,0 +1,83 @@
+/* ecc_p256.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef HAVE_ECC
+
+#ifndef CTAO_CRYPT_ECC_P256_H
+#define CTAO_CRYPT_ECC_P256_H
+
+#include <cyassl/ctaocrypt/ecc.h>
+
+/* dedicated NIST P-256 arithmetic, 4x64-bit limbs, needs a 128-bit type */
+#if !defined(NO_ECC_P256) && defined(WORD64_AVAILABLE) && \
+    defined(__SIZEOF_INT128__)
+    #define HAVE_ECC_P256
+#endif
+
+#ifdef HAVE_ECC_P256
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+/* 1 if dp is the NIST P-256 curve the dedicated code handles */
+CYASSL_LOCAL int ecc_p256_curve(const ecc_set_type* dp);
+
+/* R = k * G, constant time, R returned in affine form (z = 1) */
+CYASSL_LOCAL int ecc_p256_mulmod_base(mp_int* k, ecc_point* R);
+
+/* R = k * P, constant time, R returned in affine form (z = 1) */
+CYASSL_LOCAL int ecc_p256_mulmod(mp_int* k, ecc_point* P, ecc_point* R);
+
+/* R = kG * G + kP * P, for verification, R returned in affine form */
+CYASSL_LOCAL int ecc_p256_mul2add(mp_int* kG, mp_int* kP, ecc_point* P,
+                                  ecc_point* R);
+
+/* y of the compressed point with x, the root with odd's parity, a fixed
+   exponentiation since p = 3 mod 4. MP_VAL when x isn't on the curve */
+CYASSL_LOCAL int ecc_p256_decompress(mp_int* x, int odd, mp_int* y);
+
+/* P's fixed base table, the same layout as the one built in for G: for
+   each of 52 5-bit windows i, 1..16 * 2^(5i) * P affine in the internal
+   Montgomery form. 52 KB, for a point that gets multiplied over and over
+   like a CA's or token signer's key. Read only once set up */
+typedef struct ecc_p256_table {
+    word64 pt[52][16][2][4];
+} ecc_p256_table;
+
+CYASSL_LOCAL int ecc_p256_table_setup(ecc_p256_table* tbl, ecc_point* P);
+
+/* ecc_p256_mul2add() with P's multiples from tbl, no doublings left */
+CYASSL_LOCAL int ecc_p256_mul2add_table(mp_int* kG, mp_int* kP,
+                                        const ecc_p256_table* tbl,
+                                        ecc_point* R);
+
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+#endif /* HAVE_ECC_P256 */
+#endif /* CTAO_CRYPT_ECC_P256_H */
+#endif /* HAVE_ECC */
+
@@ -0,0 +1,95 @@
+/* ed25519.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef HAVE_ED25519
+
+#ifndef CTAO_CRYPT_ED25519_H
+#define CTAO_CRYPT_ED25519_H
+
+#include <cyassl/ctaocrypt/ecc25519_fe.h>
+#include <cyassl/ctaocrypt/types.h>
+#include <cyassl/ctaocrypt/random.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+#define ED25519_KEY_SIZE     32   /* private seed */
+#define ED25519_PUB_KEY_SIZE 32   /* compressed point */
+#define ED25519_PRV_KEY_SIZE 64   /* seed followed by the public key */
+#define ED25519_SIG_SIZE     64   /* R then S */
+
+
+/* An ED25519 Key */
+typedef struct {
+    byte p[ED25519_PUB_KEY_SIZE];   /* public key, RFC 8032 encoding */
+    byte k[ED25519_PRV_KEY_SIZE];   /* private seed, then public key */
+    int  pubSet;                    /* p is valid */
+    int  privSet;                   /* k is valid */
+} ed25519_key;
+
+
+CYASSL_API
+int ed25519_make_key(RNG* rng, int keysize, ed25519_key* key);
+CYASSL_API
+int ed25519_sign_msg(const byte* in, word32 inlen, byte* out, word32* outlen,
+                     ed25519_key* key);
+CYASSL_API
+int ed25519_verify_msg(const byte* sig, word32 siglen, const byte* msg,
+                       word32 msglen, int* stat, ed25519_key* key);
+CYASSL_API
+int ed25519_verify_msg_batch(const byte** sig, const word32* siglen,
+                             const byte** msg, const word32* msglen,
+                             int* stat, int count, ed25519_key** key);
+CYASSL_API
+int ed25519_init(ed25519_key* key);
+CYASSL_API
+void ed25519_free(ed25519_key* key);
+
+
+/* raw key helpers */
+CYASSL_API
+int ed25519_import_public(const byte* in, word32 inLen, ed25519_key* key);
+CYASSL_API
+int ed25519_import_private_key(const byte* priv, word32 privSz,
+                               const byte* pub, word32 pubSz, ed25519_key* key);
+CYASSL_API
+int ed25519_export_public(ed25519_key* key, byte* out, word32* outLen);
+CYASSL_API
+int ed25519_export_private_only(ed25519_key* key, byte* out, word32* outLen);
+
+
+/* size helpers */
+CYASSL_API
+int ed25519_size(ed25519_key* key);
+CYASSL_API
+int ed25519_sig_size(ed25519_key* key);
+
+
+#ifdef __cplusplus
+    }    /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_ED25519_H */
+#endif /* HAVE_ED25519 */
+
@@ -139,6 +139,12 @@ enum {
     DRBG_CONT_FIPS_E    = -209,  /* HASH DRBG Continious test failure */
     AESGCM_KAT_FIPS_E   = -210,  /* AESGCM KAT failure */
 
+    CHACHA_POLY_AUTH_E  = -211,  /* ChaCha20-Poly1305 Authentication failure */
+    TREE_HASH_FILE_E    = -212,  /* Tree hash file open or map failure */
+    CRYPTO_DEV_UNAVAILABLE_E = -213, /* Crypto device missing or declined */
+    ECC_SESSION_SEQ_E   = -214,  /* Ecc session nonce replayed or used up */
+    ECC_SESSION_MAC_E   = -215,  /* Ecc session message mac mismatch */
+
     MIN_CODE_E          = -300   /* errors -101 - -299 */
 };
 
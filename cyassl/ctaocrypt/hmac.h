@@ -132,12 +132,20 @@ typedef union {
     #endif
 } Hash;
 
+/* keyed Hmac states, the hash after the inner pad and after the outer pad */
+typedef struct HmacState {
+    Hash    inner;
+    Hash    outer;
+    byte    macType;
+} HmacState;
+
 /* Hmac digest */
 typedef struct Hmac {
     Hash    hash;
     word32  ipad[HMAC_BLOCK_SIZE  / sizeof(word32)];  /* same block size all*/
     word32  opad[HMAC_BLOCK_SIZE  / sizeof(word32)];
     word32  innerHash[MAX_DIGEST_SIZE / sizeof(word32)];
+    const HmacState* state;                       /* keyed states, if cloned */
     byte    macType;                                     /* md5 sha or sha256 */
     byte    innerHashKeyed;                              /* keyed flag */
 #ifdef HAVE_CAVIUM
@@ -149,6 +157,10 @@ typedef struct Hmac {
     word64   contextHandle;   /* nitrox context memory handle */
     byte*    data;            /* buffered input data for one call */
 #endif
+#ifdef CYASSL_CRYPTO_DEV
+    int      cdevId;          /* crypto device id */
+    word32   cdevMagic;       /* using crypto device magic */
+#endif
 } Hmac;
 
 
@@ -157,11 +169,21 @@ CYASSL_API int HmacSetKey(Hmac*, int type, const byte* key, word32 keySz);
 CYASSL_API int HmacUpdate(Hmac*, const byte*, word32);
 CYASSL_API int HmacFinal(Hmac*, byte*);
 
+/* precompute a key's states once, each cloned Hmac then skips the pads,
+   the state has to outlive the Hmacs cloned from it */
+CYASSL_API int HmacInitKeyedState(HmacState*, int type, const byte* key,
+                                  word32 keySz);
+CYASSL_API int HmacCloneState(Hmac*, const HmacState*);
+
 #ifdef HAVE_CAVIUM
     CYASSL_API int  HmacInitCavium(Hmac*, int);
     CYASSL_API void HmacFreeCavium(Hmac*);
 #endif
 
+#ifdef CYASSL_CRYPTO_DEV
+    CYASSL_API void HmacSetDevId(Hmac*, int devId);
+#endif
+
 CYASSL_API int CyaSSL_GetHmacMaxSize(void);
 
 
@@ -172,6 +194,13 @@ CYASSL_API int HKDF(int type, const byte* inKey, word32 inKeySz,
                     const byte* info, word32 infoSz,
                     byte* out, word32 outSz);
 
+/* the two HKDF steps on their own, for key schedules that chain them */
+CYASSL_API int HKDF_Extract(int type, const byte* salt, word32 saltSz,
+                            const byte* inKey, word32 inKeySz, byte* prk);
+CYASSL_API int HKDF_Expand(int type, const byte* prk, word32 prkSz,
+                           const byte* info, word32 infoSz,
+                           byte* out, word32 outSz);
+
 #endif /* HAVE_HKDF */
 
 
@@ -174,6 +174,17 @@ typedef struct  {
     mp_digit *dp;
 } mp_int;
 
+/* Montgomery values cached per modulus, only fastmath keeps any, here the
+   exptmods always work them out */
+typedef struct {
+    int ready;
+} mp_mont_ctx;
+
+/* fixed base comb tables, also fastmath only */
+typedef struct {
+    int ready;
+} mp_comb_ctx;
+
 /* callback for mp_prime_random, should fill dst with random bytes and return
    how many read [upto len] */
 typedef int ltm_prime_callback(unsigned char *dst, int len, void *dat);
@@ -221,10 +232,26 @@ extern const char *mp_s_rmap;
 /* 6 functions needed by Rsa */
 int  mp_init (mp_int * a);
 void mp_clear (mp_int * a);
+#ifdef CYASSL_MP_POOL
+    CYASSL_API void mp_pool_free (void);
+#endif
 int  mp_unsigned_bin_size(mp_int * a);
 int  mp_read_unsigned_bin (mp_int * a, const unsigned char *b, int c);
 int  mp_to_unsigned_bin (mp_int * a, unsigned char *b);
 int  mp_exptmod (mp_int * G, mp_int * X, mp_int * P, mp_int * Y);
+int  mp_exptmod_ct (mp_int * G, mp_int * X, mp_int * P, mp_int * Y);
+void mp_mont_ctx_init (mp_mont_ctx * mc);
+int  mp_mont_ctx_setup (mp_mont_ctx * mc, mp_int * m);
+int  mp_exptmod_ex (mp_int * G, mp_int * X, mp_int * P,
+                    const mp_mont_ctx * mc, mp_int * Y);
+int  mp_exptmod_ct_ex (mp_int * G, mp_int * X, mp_int * P,
+                       const mp_mont_ctx * mc, mp_int * Y);
+void mp_comb_ctx_init (mp_comb_ctx * cc);
+int  mp_comb_ctx_setup (mp_comb_ctx * cc, mp_int * G, mp_int * P,
+                        const mp_mont_ctx * mc, int bits);
+int  mp_exptmod_comb (mp_int * G, mp_int * X, mp_int * P,
+                      const mp_mont_ctx * mc, const mp_comb_ctx * cc,
+                      mp_int * Y);
 /* end functions needed by Rsa */
 
 /* functions added to support above needed, removed TOOM and KARATSUBA */
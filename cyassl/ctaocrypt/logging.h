@@ -44,6 +44,9 @@ typedef void (*CyaSSL_Logging_cb)(const int logLevel,
 
 CYASSL_API int CyaSSL_SetLoggingCb(CyaSSL_Logging_cb log_function);
 
+/* with CYASSL_RING_LOG, write out each thread's latest log records */
+CYASSL_API int CyaSSL_Debugging_Dump(CyaSSL_Logging_cb f);
+
 
 #ifdef DEBUG_CYASSL
 
@@ -65,6 +65,12 @@ CYASSL_API void Md5Update(Md5*, const byte*, word32);
 CYASSL_API void Md5Final(Md5*, byte*);
 CYASSL_API int  Md5Hash(const byte*, word32, byte*);
 
+#ifndef NO_SHA
+    /* MD5 and SHA-1 of the same data, both at once */
+    struct Sha;
+    CYASSL_API int Md5ShaUpdate(Md5*, struct Sha*, const byte*, word32);
+#endif
+
 
 #ifdef __cplusplus
     } /* extern "C" */
@@ -48,6 +48,125 @@ CYASSL_API void  CyaSSL_Free(void *ptr);
 CYASSL_API void* CyaSSL_Realloc(void *ptr, size_t size);
 
 
+#ifdef CYASSL_SLAB_MALLOC
+/* Built in size classed allocator, the default backend when no callbacks
+   are set, can also be handed to CyaSSL_SetAllocators() */
+typedef struct CyaSSL_SlabStat {
+    size_t        size;      /* block size with header, 0 for oversized */
+    unsigned long allocs;    /* requests served */
+    unsigned long hits;      /* of those, taken from a free list */
+    unsigned long frees;
+    unsigned long cached;    /* free blocks held in thread caches and depot */
+} CyaSSL_SlabStat;
+
+CYASSL_API void* CyaSSL_SlabMalloc(size_t size);
+CYASSL_API void  CyaSSL_SlabFree(void *ptr);
+CYASSL_API void* CyaSSL_SlabRealloc(void *ptr, size_t size);
+CYASSL_API int   CyaSSL_SlabGetStats(CyaSSL_SlabStat* stats, int max);
+CYASSL_API void  CyaSSL_SlabFlush(void);
+#endif
+
+
+#ifdef CYASSL_STATIC_MEMORY
+/* Fixed size buckets in one static arena, the default backend when no
+   callbacks are set, sized at build time by STATIC_MEM_BUCKETS and
+   STATIC_MEM_CONNECTIONS */
+typedef struct CyaSSL_StaticMemStat {
+    size_t        size;      /* block size, 0 for requests bigger than all */
+    unsigned long total;     /* blocks in the bucket */
+    unsigned long inUse;
+    unsigned long peak;      /* most in use at once */
+    unsigned long allocs;    /* requests whose smallest fit this is */
+    unsigned long spills;    /* of those, served by a bigger bucket */
+    unsigned long fails;     /* of those, not served at all */
+    unsigned long largest;   /* biggest of those requests */
+} CyaSSL_StaticMemStat;
+
+CYASSL_API int   CyaSSL_StaticMemoryInit(void);
+CYASSL_API void* CyaSSL_StaticMalloc(size_t size);
+CYASSL_API void  CyaSSL_StaticFree(void *ptr);
+CYASSL_API void* CyaSSL_StaticRealloc(void *ptr, size_t size);
+CYASSL_API int   CyaSSL_StaticMemoryGetStats(CyaSSL_StaticMemStat* stats,
+                                             int max);
+CYASSL_API void  CyaSSL_StaticMemoryDump(void);
+#endif
+
+
+#ifdef CYASSL_MEM_STATS
+/* Memory accounting, a handle used as the XMALLOC heap hint counts what is
+   allocated through it, broken down by DYNAMIC_TYPE_* */
+#define CYASSL_MEM_TYPES 64
+
+typedef struct CyaSSL_MemUsage {
+    unsigned long current;                        /* bytes live now */
+    unsigned long peak;                           /* most bytes live */
+    unsigned long count;                          /* allocations made */
+    unsigned long typeCurrent[CYASSL_MEM_TYPES];
+    unsigned long typePeak[CYASSL_MEM_TYPES];
+    unsigned long typeCount[CYASSL_MEM_TYPES];
+} CyaSSL_MemUsage;
+
+typedef struct CyaSSL_MemStats CyaSSL_MemStats;
+
+CYASSL_API CyaSSL_MemStats* CyaSSL_MemStatsNew(CyaSSL_MemStats* parent);
+CYASSL_API void  CyaSSL_MemStatsFree(CyaSSL_MemStats* stats);
+CYASSL_API int   CyaSSL_MemStatsGet(CyaSSL_MemStats* stats,
+                                    CyaSSL_MemUsage* usage);
+
+/* XMALLOC/XFREE/XREALLOC when counting */
+CYASSL_API void* CyaSSL_MallocHint(size_t size, void* heap, int type);
+CYASSL_API void  CyaSSL_FreeHint(void *ptr);
+CYASSL_API void* CyaSSL_ReallocHint(void *ptr, size_t size, void* heap,
+                                    int type);
+#endif
+
+
+#ifdef CYASSL_MEM_TRACE
+/* Allocation tracing, every XMALLOC is counted by call site, DYNAMIC_TYPE_*
+   and the phase the calling thread is in. The library sets the phase for
+   CyaSSL_connect/accept, each handshake message it processes, CyaSSL_read
+   and CyaSSL_write, anything else lands in CYASSL_TRACE_OTHER */
+enum {
+    CYASSL_TRACE_OTHER     = 0,
+    CYASSL_TRACE_HANDSHAKE = 1,   /* connect and accept, sending side */
+    CYASSL_TRACE_READ      = 2,
+    CYASSL_TRACE_WRITE     = 3,
+    CYASSL_TRACE_USER      = 8,   /* free for the application, up to 15 */
+    CYASSL_TRACE_MSG_BASE  = 16,  /* plus the handshake type processed */
+    CYASSL_TRACE_PHASES    = CYASSL_TRACE_MSG_BASE + 256,
+    CYASSL_TRACE_ALL       = -1
+};
+
+typedef struct CyaSSL_MemTraceSite {
+    const char*   file;
+    int           line;
+    int           type;      /* DYNAMIC_TYPE_* */
+    int           phase;
+    unsigned long allocs;
+    unsigned long bytes;
+} CyaSSL_MemTraceSite;
+
+/* sets the calling thread's phase, returns the one it replaces */
+CYASSL_API int           CyaSSL_MemTraceSetPhase(int phase);
+CYASSL_API void          CyaSSL_MemTraceReset(void);
+/* allocations or frees so far in phase, or in all with CYASSL_TRACE_ALL */
+CYASSL_API unsigned long CyaSSL_MemTraceAllocs(int phase);
+CYASSL_API unsigned long CyaSSL_MemTraceFrees(int phase);
+/* copies out up to max call sites, returns how many there are */
+CYASSL_API int           CyaSSL_MemTraceGet(CyaSSL_MemTraceSite* sites,
+                                            int max);
+/* prints the call sites of phase, or of all, busiest first per phase */
+CYASSL_API void          CyaSSL_MemTraceDump(int phase);
+
+/* XMALLOC/XFREE/XREALLOC when tracing */
+CYASSL_API void* CyaSSL_MallocTrace(size_t size, int type, const char* file,
+                                    int line);
+CYASSL_API void  CyaSSL_FreeTrace(void *ptr, int type);
+CYASSL_API void* CyaSSL_ReallocTrace(void *ptr, size_t size, int type,
+                                     const char* file, int line);
+#endif
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -52,7 +52,9 @@ enum Pkcs7_Misc {
     MAX_CONTENT_KEY_LEN  = DES3_KEYLEN,   /* highest current cipher is 3DES */
     MAX_RECIP_SZ         = MAX_VERSION_SZ +
                            MAX_SEQ_SZ + ASN_NAME_MAX + MAX_SN_SZ +
-                           MAX_SEQ_SZ + MAX_ALGO_SZ + 1 + MAX_ENCRYPTED_KEY_SZ
+                           MAX_SEQ_SZ + MAX_ALGO_SZ + 1 + MAX_ENCRYPTED_KEY_SZ,
+    PKCS7_STREAM_HDR_SZ  = 128,           /* streamed verify header bytes */
+    PKCS7_STREAM_EOC_SZ  = 12             /* most end of contents in Final */
 };
 
 
@@ -91,6 +93,28 @@ typedef struct PKCS7 {
 } PKCS7;
 
 
+/* Incremental SignedData and EnvelopedData state, caller owned and the same
+   size whatever the content size. Encoding writes indefinite length BER,
+   content goes out as one OCTET STRING segment per Update() */
+typedef struct PKCS7Stream {
+    Sha    sha;                       /* content digest                  */
+    union {
+        Des  des;
+        Des3 des3;
+    } cipher;                         /* enveloped content cipher        */
+    byte   carry[DES_BLOCK_SIZE];     /* partial block not yet encrypted */
+    word32 carrySz;
+    byte   hdr[PKCS7_STREAM_HDR_SZ];  /* verify, header being parsed     */
+    word32 hdrSz;
+    word32 remain;                    /* verify, content left in segment */
+    byte*  trailer;                   /* verify, certs and signerInfos   */
+    word32 trailerSz;
+    word32 trailerMax;
+    int    state;
+    int    encryptOID;
+} PKCS7Stream;
+
+
 CYASSL_LOCAL int SetContentType(int pkcs7TypeOID, byte* output);
 CYASSL_LOCAL int GetContentType(const byte* input, word32* inOutIdx,
                                 word32* oid, word32 maxIdx);
@@ -113,6 +137,30 @@ CYASSL_API int  PKCS7_DecodeEnvelopedData(PKCS7* pkcs7, byte* pkiMsg,
                                           word32 pkiMsgSz, byte* output,
                                           word32 outputSz);
 
+/* streaming, Init/Update/Final return bytes written to output or < 0 */
+CYASSL_API int  PKCS7_EncodeSignedDataInit(PKCS7* pkcs7, PKCS7Stream* stream,
+                                           byte* output, word32 outputSz);
+CYASSL_API int  PKCS7_EncodeSignedDataUpdate(PKCS7* pkcs7, PKCS7Stream* stream,
+                                             const byte* in, word32 inSz,
+                                             byte* output, word32 outputSz);
+CYASSL_API int  PKCS7_EncodeSignedDataFinal(PKCS7* pkcs7, PKCS7Stream* stream,
+                                            byte* output, word32 outputSz);
+CYASSL_API int  PKCS7_VerifySignedDataInit(PKCS7* pkcs7, PKCS7Stream* stream);
+CYASSL_API int  PKCS7_VerifySignedDataUpdate(PKCS7* pkcs7, PKCS7Stream* stream,
+                                             const byte* in, word32 inSz);
+CYASSL_API int  PKCS7_VerifySignedDataFinal(PKCS7* pkcs7, PKCS7Stream* stream);
+CYASSL_API int  PKCS7_EncodeEnvelopedDataInit(PKCS7* pkcs7,
+                                              PKCS7Stream* stream,
+                                              byte* output, word32 outputSz);
+CYASSL_API int  PKCS7_EncodeEnvelopedDataUpdate(PKCS7* pkcs7,
+                                                PKCS7Stream* stream,
+                                                const byte* in, word32 inSz,
+                                                byte* output, word32 outputSz);
+CYASSL_API int  PKCS7_EncodeEnvelopedDataFinal(PKCS7* pkcs7,
+                                               PKCS7Stream* stream,
+                                               byte* output, word32 outputSz);
+CYASSL_API void PKCS7_StreamFree(PKCS7Stream* stream);
+
 #ifdef __cplusplus
     } /* extern "C" */
 #endif
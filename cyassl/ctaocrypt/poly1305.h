@@ -26,6 +26,7 @@
 #define CTAO_CRYPT_POLY1305_H
 
 #include <cyassl/ctaocrypt/types.h>
+#include <cyassl/ctaocrypt/cpuid.h>
 
 #ifdef __cplusplus
     extern "C" {
@@ -43,6 +44,10 @@
 #define POLY130532
 #endif
 
+#if defined(POLY130564) && defined(HAVE_CYASSL_X86_SIMD)
+    #define POLY1305_X86_SIMD
+#endif
+
 enum {
     POLY1305 = 7,
     POLY1305_BLOCK_SIZE = 16,
@@ -64,6 +69,10 @@ typedef struct Poly1305 {
 	size_t leftover;
 	unsigned char buffer[POLY1305_BLOCK_SIZE];
 	unsigned char final;
+#ifdef POLY1305_X86_SIMD
+	word32 rPow[4][5];     /* r^1..r^4 in 26 bit limbs, set on first use */
+	unsigned char rPowSet;
+#endif
 } Poly1305;
 
 
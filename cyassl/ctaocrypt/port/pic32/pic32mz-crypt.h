@@ -59,7 +59,13 @@
 #define SHA256_HASH_SIZE 32
 #define PIC32_HASH_SIZE 32
 
-#define PIC32MZ_MAX_BD   2
+/* Buffer descriptors chained into one engine job. A hash keeps one per
+   update until Final, AesCrypt() one per PIC32MZ_MAX_BUFLEN of input */
+#ifndef PIC32MZ_MAX_BD
+    #define PIC32MZ_MAX_BD   8
+#endif
+#define PIC32MZ_MAX_BUFLEN   0xFFF0     /* BD_CTRL.BUFLEN is 16 bits */
+
 typedef struct {      /* Crypt Engine descripter */
     int bdCount ;
     int err   ;
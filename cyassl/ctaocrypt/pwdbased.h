@@ -40,6 +40,11 @@ CYASSL_API int PBKDF1(byte* output, const byte* passwd, int pLen,
 CYASSL_API int PBKDF2(byte* output, const byte* passwd, int pLen,
                       const byte* salt, int sLen, int iterations, int kLen,
                       int hashType);
+/* count derivations, each with its own password and salt */
+CYASSL_API int PBKDF2Multi(byte** output, const byte** passwd,
+                           const int* pLen, const byte** salt,
+                           const int* sLen, int iterations, int kLen,
+                           int hashType, int count);
 CYASSL_API int PKCS12_PBKDF(byte* output, const byte* passwd, int pLen,
                             const byte* salt, int sLen, int iterations,
                             int kLen, int hashType, int purpose);
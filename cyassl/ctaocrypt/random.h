@@ -31,6 +31,15 @@
     #endif /* NO_SHA256 */
 
     #include <cyassl/ctaocrypt/sha256.h>
+
+    #ifdef HAVE_CTRDRBG
+        #ifdef NO_AES
+            #error "CTR DRBG requires AES."
+        #endif /* NO_AES */
+        #ifndef CYASSL_AES_DIRECT
+            #error "CTR DRBG requires CYASSL_AES_DIRECT."
+        #endif /* CYASSL_AES_DIRECT */
+    #endif /* HAVE_CTRDRBG */
 #else /* HAVE_HASHDRBG || NO_RC4 */
     #include <cyassl/ctaocrypt/arc4.h>
 #endif /* HAVE_HASHDRBG || NO_RC4 */
@@ -78,11 +87,16 @@ int GenerateSeed(OS_Seed* os, byte* seed, word32 sz);
 struct DRBG; /* Private DRBG state */
 
 
-/* Hash-based Deterministic Random Bit Generator */
+/* Hash-based, or with HAVE_CTRDRBG AES CTR, Deterministic Random Bit
+   Generator */
 typedef struct RNG {
     OS_Seed seed;
     struct DRBG* drbg;
     byte status;
+#ifdef CYASSL_CRYPTO_DEV
+    int    cdevId;          /* crypto device id */
+    word32 cdevMagic;       /* using crypto device magic */
+#endif
 } RNG;
 
 
@@ -101,6 +115,10 @@ typedef struct RNG {
     int    devId;           /* nitrox device id */
     word32 magic;           /* using cavium magic */
 #endif
+#ifdef CYASSL_CRYPTO_DEV
+    int    cdevId;          /* crypto device id */
+    word32 cdevMagic;       /* using crypto device magic */
+#endif
 } RNG;
 
 
@@ -116,9 +134,17 @@ CYASSL_API int  InitRng(RNG*);
 CYASSL_API int  RNG_GenerateBlock(RNG*, byte*, word32 sz);
 CYASSL_API int  RNG_GenerateByte(RNG*, byte*);
 
+#ifdef CYASSL_CRYPTO_DEV
+    CYASSL_API void RngSetDevId(RNG*, int devId);
+#endif
+
 
 #if defined(HAVE_HASHDRBG) || defined(NO_RC4)
     CYASSL_API int FreeRng(RNG*);
+    #if defined(CYASSL_RNG_BUFFER) || defined(CYASSL_TLS_THREAD_RNG)
+        /* share the calling thread's DRBG, no seeding per RNG */
+        CYASSL_API int InitRngThread(RNG*);
+    #endif
     CYASSL_API int RNG_HealthTest(int reseed,
                                         const byte* entropyA, word32 entropyASz,
                                         const byte* entropyB, word32 entropyBSz,
@@ -42,6 +42,7 @@ enum {
 /* RSA */
 typedef struct RsaKey {
     mp_int n, e, d, p, q, dP, dQ, u;
+    mp_mont_ctx nMont, pMont, qMont;          /* exptmod setup for n, p, q */
     int   type;                               /* public or private */
     void* heap;                               /* for user memory overrides */
 #ifdef HAVE_CAVIUM
@@ -58,6 +59,10 @@ typedef struct RsaKey {
     byte*  c_u;             /* sizes in bytes */
     word16 c_nSz, c_eSz, c_dSz, c_pSz, c_qSz, c_dP_Sz, c_dQ_Sz, c_uSz;
 #endif
+#ifdef CYASSL_CRYPTO_DEV
+    int    cdevId;          /* crypto device id */
+    word32 cdevMagic;       /* using crypto device magic */
+#endif
 } RsaKey;
 
 
@@ -86,6 +91,8 @@ CYASSL_API int RsaPublicKeyDecodeRaw(const byte* n, word32 nSz, const byte* e,
                                      word32 eSz, RsaKey* key);
 CYASSL_API int RsaFlattenPublicKey(RsaKey*, byte*, word32*, byte*, word32*);
 
+CYASSL_LOCAL void RsaSetupMont(RsaKey* key);
+
 #ifdef CYASSL_KEY_GEN
     CYASSL_API int MakeRsaKey(RsaKey* key, int size, long e, RNG* rng);
     CYASSL_API int RsaKeyToDer(RsaKey*, byte* output, word32 inLen);
@@ -96,6 +103,10 @@ CYASSL_API int RsaFlattenPublicKey(RsaKey*, byte*, word32*, byte*, word32*);
     CYASSL_API void RsaFreeCavium(RsaKey*);
 #endif
 
+#ifdef CYASSL_CRYPTO_DEV
+    CYASSL_API void RsaSetDevId(RsaKey*, int devId);
+#endif
+
 
 #ifdef HAVE_FIPS
     /* fips wrapper calls, user can call direct */
@@ -435,9 +435,11 @@
         #include "mutex.h"
     #endif
 
-    #define XMALLOC(s, h, t)    (void *)_mem_alloc_system((s))
-    #define XFREE(p, h, t)      {void* xp = (p); if ((xp)) _mem_free((xp));}
-    /* Note: MQX has no realloc, using fastmath above */
+    #ifndef CYASSL_STATIC_MEMORY
+        #define XMALLOC(s, h, t)    (void *)_mem_alloc_system((s))
+        #define XFREE(p, h, t)      {void* xp = (p); if ((xp)) _mem_free((xp));}
+        /* Note: MQX has no realloc, using fastmath above */
+    #endif
 #endif
 
 #ifdef CYASSL_STM32F2
@@ -725,6 +727,11 @@
     #define NO_SKID
 #endif
 
+/* verified cert cache is keyed by the SHA-256 of the DER */
+#if defined(HAVE_VERIFY_CACHE) && (defined(NO_SHA256) || defined(NO_CERTS))
+    #undef HAVE_VERIFY_CACHE
+#endif
+
 
 #ifdef __INTEL_COMPILER
     #pragma warning(disable:2259) /* explicit casts to smaller sizes, disable */
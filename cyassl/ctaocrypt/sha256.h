@@ -65,6 +65,9 @@ CYASSL_API int InitSha256(Sha256*);
 CYASSL_API int Sha256Update(Sha256*, const byte*, word32);
 CYASSL_API int Sha256Final(Sha256*, byte*);
 CYASSL_API int Sha256Hash(const byte*, word32, byte*);
+CYASSL_API int Sha256HashMulti(const byte**, const word32*, byte**, int);
+CYASSL_LOCAL int Sha256PbkdfMulti(const word32** inner, const word32** outer,
+                                  byte** u, int iterations, int count);
 
 
 #ifdef HAVE_FIPS
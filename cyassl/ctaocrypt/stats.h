@@ -0,0 +1,95 @@
+/* stats.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifndef CTAO_CRYPT_STATS_H
+#define CTAO_CRYPT_STATS_H
+
+
+#include <cyassl/ctaocrypt/types.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+#define CYASSL_STATS_ALERTS 256     /* one counter per alert description */
+
+#ifdef WORD64_AVAILABLE
+    typedef word64 CyaSSL_StatCount;
+#else
+    typedef word32 CyaSSL_StatCount;
+#endif
+
+/* Process wide counters since start up, only ever go up, so diff two
+   snapshots for rates */
+typedef struct CyaSSL_Stats {
+    CyaSSL_StatCount fullHandshakes;
+    CyaSSL_StatCount resumedHandshakes;
+    CyaSSL_StatCount renegotiations;    /* not in the two above */
+    CyaSSL_StatCount cacheHits;         /* session cache lookups */
+    CyaSSL_StatCount cacheMisses;       /* none or timed out */
+    CyaSSL_StatCount cacheEvictions;    /* live sessions pushed out */
+    CyaSSL_StatCount ticketFailures;    /* tickets that didn't decrypt */
+    CyaSSL_StatCount recordsIn;
+    CyaSSL_StatCount recordsOut;
+    CyaSSL_StatCount bytesIn;           /* off and on the wire */
+    CyaSSL_StatCount bytesOut;
+    CyaSSL_StatCount crlLookups;
+    CyaSSL_StatCount ocspLookups;
+    CyaSSL_StatCount fpCacheHits;       /* ECC fixed point base cache */
+    CyaSSL_StatCount fpCacheMisses;
+    CyaSSL_StatCount handshakesShed;    /* over CyaSSL_CTX_SetHandshakeLimit */
+    CyaSSL_StatCount alertsIn[CYASSL_STATS_ALERTS];     /* by description */
+    CyaSSL_StatCount alertsOut[CYASSL_STATS_ALERTS];
+} CyaSSL_Stats;
+
+/* sum every thread's counters, 0 on success, NOT_COMPILED_IN without
+   CYASSL_STATS */
+CYASSL_API int CyaSSL_get_stats(CyaSSL_Stats* stats);
+
+
+#ifdef CYASSL_STATS
+
+    /* this thread's counters, no lock to bump them */
+    CYASSL_LOCAL CyaSSL_Stats* StatsThread(void);
+    CYASSL_LOCAL int           StatsInit(void);
+
+    #define CYASSL_STAT_INC(f)     (StatsThread()->f++)
+    #define CYASSL_STAT_ADD(f, n)  (StatsThread()->f += (n))
+    #define CYASSL_STAT_ALERT(dir, type) \
+        (StatsThread()->dir[(type) & (CYASSL_STATS_ALERTS - 1)]++)
+
+#else
+
+    #define CYASSL_STAT_INC(f)           ((void)0)
+    #define CYASSL_STAT_ADD(f, n)        ((void)0)
+    #define CYASSL_STAT_ALERT(dir, type) ((void)0)
+
+#endif /* CYASSL_STATS */
+
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_STATS_H */
+
@@ -269,11 +269,45 @@
 #define FP_NO         0   /* no response */
 
 /* a FP type */
+#ifndef ALT_ECC_SIZE
 typedef struct {
     fp_digit dp[FP_SIZE];
     int      used, 
              sign;
 } fp_int;
+#else
+/* ECC coordinates are a shorter fp_int, see ecc_int in ecc.h, so the digits
+   come last and size says how many of them there really are */
+typedef struct {
+    int      used,
+             sign,
+             size;
+    fp_digit dp[FP_SIZE];
+} fp_int;
+#endif
+
+/* Montgomery values for one modulus, worked out once and handed to the
+   exptmods so they don't redo them on every call */
+typedef struct {
+    fp_int   rr;        /* R^2 mod m */
+    fp_digit mp;        /* -1/m mod b */
+    int      ready;     /* set once rr and mp hold m's values */
+} fp_mont_ctx;
+
+/* Lim-Lee comb for powers of one fixed base, in Montgomery form for the
+   modulus it was set up with. Entry j is the product of G^(2^(k * spacing))
+   over the bits k set in j, so an exponent of up to FP_COMB_TEETH * spacing
+   bits takes spacing squarings and as many table products */
+#ifndef FP_COMB_TEETH
+    #define FP_COMB_TEETH 6
+#endif
+
+typedef struct {
+   fp_digit table[1 << FP_COMB_TEETH][FP_SIZE/2];
+   int      spacing;   /* exponent bits between teeth */
+   int      used;      /* digits of the modulus */
+   int      ready;     /* set once table holds G's entries */
+} fp_comb_ctx;
 
 /* externally define this symbol to ignore the default settings, useful for changing the build from the make process */
 #ifndef TFM_ALREADY_SET
@@ -353,8 +387,14 @@ typedef struct {
 /*const char *fp_ident(void);*/
 
 /* initialize [or zero] an fp int */
+#ifndef ALT_ECC_SIZE
 #define fp_init(a)  (void)XMEMSET((a), 0, sizeof(fp_int))
 #define fp_zero(a)  fp_init(a)
+#else
+void fp_init(fp_int *a);
+void fp_init_size(fp_int *a, int size);
+void fp_zero(fp_int *a);
+#endif
 
 /* zero/even/odd ? */
 #define fp_iszero(a) (((a)->used == 0) ? FP_YES : FP_NO)
@@ -365,8 +405,13 @@ typedef struct {
 void fp_set(fp_int *a, fp_digit b);
 
 /* copy from a to b */
+#ifndef ALT_ECC_SIZE
 #define fp_copy(a, b)  (void)(((a) != (b)) ? ((void)XMEMCPY((b), (a), sizeof(fp_int))) : (void)0)
 #define fp_init_copy(a, b) fp_copy(b, a)
+#else
+void fp_copy(fp_int *a, fp_int *b);
+void fp_init_copy(fp_int *a, fp_int *b);
+#endif
 
 /* clamp digits */
 #define fp_clamp(a)   { while ((a)->used && (a)->dp[(a)->used-1] == 0) --((a)->used); (a)->sign = (a)->used ? (a)->sign : FP_ZPOS; }
@@ -473,6 +518,29 @@ void fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp);
 /* d = a**b (mod c) */
 int fp_exptmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d);
 
+/* d = a**b (mod c), c odd, timing independent of the values of b and c */
+int fp_exptmod_ct(fp_int *a, fp_int *b, fp_int *c, fp_int *d);
+
+/* fills mc for modulus m */
+int fp_mont_ctx_setup(fp_mont_ctx *mc, fp_int *m);
+
+/* as above but with mc's values for c when mc is ready */
+int fp_exptmod_ex(fp_int *a, fp_int *b, fp_int *c, const fp_mont_ctx *mc,
+                  fp_int *d);
+int fp_exptmod_ct_ex(fp_int *a, fp_int *b, fp_int *c, const fp_mont_ctx *mc,
+                     fp_int *d);
+
+/* fills cc with base a's comb for exponents of up to bits bits mod c, mc has
+   to be ready for c */
+void fp_comb_ctx_init(fp_comb_ctx *cc);
+int fp_comb_ctx_setup(fp_comb_ctx *cc, fp_int *a, fp_int *c,
+                      const fp_mont_ctx *mc, int bits);
+
+/* d = a**b (mod c) from cc's table when it's ready and b fits, otherwise as
+   fp_exptmod_ex. The table read doesn't depend on b */
+int fp_exptmod_comb(fp_int *a, fp_int *b, fp_int *c, const fp_mont_ctx *mc,
+                    const fp_comb_ctx *cc, fp_int *d);
+
 /* primality stuff */
 
 /* perform a Miller-Rabin test of a to the base b and store result in "result" */
@@ -626,6 +694,8 @@ void fp_sqr_comba64(fp_int *a, fp_int *b);
     typedef fp_digit mp_digit;
     typedef fp_word  mp_word;
     typedef fp_int mp_int;
+    typedef fp_mont_ctx mp_mont_ctx;
+    typedef fp_comb_ctx mp_comb_ctx;
 
 /* Constants */
     #define MP_LT   FP_LT   /* less than    */
@@ -652,6 +722,19 @@ int  mp_mulmod (mp_int * a, mp_int * b, mp_int * c, mp_int * d);
 int  mp_mod(mp_int *a, mp_int *b, mp_int *c);
 int  mp_invmod(mp_int *a, mp_int *b, mp_int *c);
 int  mp_exptmod (mp_int * g, mp_int * x, mp_int * p, mp_int * y);
+int  mp_exptmod_ct (mp_int * g, mp_int * x, mp_int * p, mp_int * y);
+int  mp_mont_ctx_setup (mp_mont_ctx * mc, mp_int * m);
+void mp_mont_ctx_init (mp_mont_ctx * mc);
+int  mp_exptmod_ex (mp_int * g, mp_int * x, mp_int * p,
+                    const mp_mont_ctx * mc, mp_int * y);
+int  mp_exptmod_ct_ex (mp_int * g, mp_int * x, mp_int * p,
+                       const mp_mont_ctx * mc, mp_int * y);
+void mp_comb_ctx_init (mp_comb_ctx * cc);
+int  mp_comb_ctx_setup (mp_comb_ctx * cc, mp_int * g, mp_int * p,
+                        const mp_mont_ctx * mc, int bits);
+int  mp_exptmod_comb (mp_int * g, mp_int * x, mp_int * p,
+                      const mp_mont_ctx * mc, const mp_comb_ctx * cc,
+                      mp_int * y);
 
 int  mp_cmp(mp_int *a, mp_int *b);
 int  mp_cmp_d(mp_int *a, mp_digit b);
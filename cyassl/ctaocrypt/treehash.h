@@ -0,0 +1,70 @@
+/* treehash.h
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+
+#ifdef CYASSL_TREE_HASH
+
+#ifndef CTAO_CRYPT_TREEHASH_H
+#define CTAO_CRYPT_TREEHASH_H
+
+#include <cyassl/ctaocrypt/types.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+
+enum {
+    TREE_HASH_LEAF_SIZE   = 1024 * 1024,    /* default leaf, 1 MiB */
+    TREE_HASH_MAX_THREADS = 64,
+
+    TREE_HASH_LEAF_PREFIX = 0x00,
+    TREE_HASH_NODE_PREFIX = 0x01
+};
+
+
+/* The Merkle tree hash of RFC 6962 over fixed size leaves. Leaf i is bytes
+   i * leafSz up to (i + 1) * leafSz of the input, hashed as H(0x00 || leaf),
+   an empty input is one empty leaf. Nodes are H(0x01 || left || right) and
+   the tree splits at the largest power of two below its leaf count, so
+   roots only agree for the same hash and leaf size and never equal the
+   plain hash of the input.
+
+   hashType is SHA, SHA256, SHA384, SHA512 or BLAKE2B_ID (64 byte digest),
+   digest needs TreeHashDigestSize(hashType) bytes. leafSz 0 takes
+   TREE_HASH_LEAF_SIZE, threads 0 takes one per online cpu, the calling
+   thread is one of them. */
+CYASSL_API int TreeHashDigestSize(int hashType);
+CYASSL_API int TreeHash(int hashType, const byte* in, word64 inSz,
+                        word32 leafSz, int threads, byte* digest);
+
+/* the same over a file mapped read only, it must not shrink meanwhile */
+CYASSL_API int TreeHashFile(int hashType, const char* fileName,
+                            word32 leafSz, int threads, byte* digest);
+
+
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+
+#endif /* CTAO_CRYPT_TREEHASH_H */
+#endif /* CYASSL_TREE_HASH */
+
@@ -175,13 +175,29 @@ enum {
     #define XFREE(p, h, t)       {void* xp = (p); if((xp)) free((xp));}
     #define XREALLOC(p, n, h, t) realloc((p), (n))
 #elif !defined(MICRIUM_MALLOC) && !defined(EBSNET) \
-        && !defined(CYASSL_SAFERTOS) && !defined(FREESCALE_MQX) \
-        && !defined(CYASSL_LEANPSK)
+        && !defined(CYASSL_SAFERTOS) && !defined(CYASSL_LEANPSK) \
+        && (!defined(FREESCALE_MQX) || defined(CYASSL_STATIC_MEMORY))
     /* default C runtime, can install different routines at runtime via cbs */
     #include <cyassl/ctaocrypt/memory.h>
-    #define XMALLOC(s, h, t)     ((void)h, (void)t, CyaSSL_Malloc((s)))
-    #define XFREE(p, h, t)       {void* xp = (p); if((xp)) CyaSSL_Free((xp));}
-    #define XREALLOC(p, n, h, t) CyaSSL_Realloc((p), (n))
+    #ifdef CYASSL_MEM_STATS
+        /* heap hint may be a stats handle, free goes by the block header */
+        #define XMALLOC(s, h, t)     CyaSSL_MallocHint((s), (h), (t))
+        #define XFREE(p, h, t)       {void* xp = (p); if((xp)) \
+                                                     CyaSSL_FreeHint((xp));}
+        #define XREALLOC(p, n, h, t) CyaSSL_ReallocHint((p), (n), (h), (t))
+    #elif defined(CYASSL_MEM_TRACE)
+        /* counted by call site */
+        #define XMALLOC(s, h, t)     ((void)h, CyaSSL_MallocTrace((s), (t), \
+                                                        __FILE__, __LINE__))
+        #define XFREE(p, h, t)       {void* xp = (p); if((xp)) \
+                                                 CyaSSL_FreeTrace((xp), (t));}
+        #define XREALLOC(p, n, h, t) CyaSSL_ReallocTrace((p), (n), (t), \
+                                                        __FILE__, __LINE__)
+    #else
+        #define XMALLOC(s, h, t)     ((void)h, (void)t, CyaSSL_Malloc((s)))
+        #define XFREE(p, h, t)       {void* xp = (p); if((xp)) CyaSSL_Free((xp));}
+        #define XREALLOC(p, n, h, t) CyaSSL_Realloc((p), (n))
+    #endif
 #endif
 
 #ifndef STRING_USER
@@ -192,6 +208,7 @@ enum {
     #define XMEMSET(b,c,l)    memset((b),(c),(l))
     #define XMEMCMP(s1,s2,n)  memcmp((s1),(s2),(n))
     #define XMEMMOVE(d,s,l)   memmove((d),(s),(l))
+    #define XMEMCHR(s,c,n)    memchr((s),(c),(n))
 
     #define XSTRLEN(s1)       strlen((s1))
     #define XSTRNCPY(s1,s2,n) strncpy((s1),(s2),(n))
@@ -272,7 +289,23 @@ enum {
     DYNAMIC_TYPE_X509         = 42,
     DYNAMIC_TYPE_TLSX         = 43,
     DYNAMIC_TYPE_OCSP         = 44,
-    DYNAMIC_TYPE_SIGNATURE    = 45
+    DYNAMIC_TYPE_SIGNATURE    = 45,
+    DYNAMIC_TYPE_SESSION_CACHE = 46,
+    DYNAMIC_TYPE_SESSION      = 47,
+    DYNAMIC_TYPE_ASYNC        = 48,
+    DYNAMIC_TYPE_CA_TABLE     = 49,
+    DYNAMIC_TYPE_ARENA        = 50,
+    DYNAMIC_TYPE_HASHES       = 51,
+    DYNAMIC_TYPE_SNI          = 52,
+    DYNAMIC_TYPE_DTLS_MUX     = 53,
+    DYNAMIC_TYPE_LOG_RING     = 54,
+    DYNAMIC_TYPE_HS_TIMING    = 55,
+    DYNAMIC_TYPE_STATS        = 56,
+    DYNAMIC_TYPE_PKCS7        = 57,
+    DYNAMIC_TYPE_PSK          = 58,
+    DYNAMIC_TYPE_CONN_POOL    = 59,
+    DYNAMIC_TYPE_WRITE_POOL   = 60,
+    DYNAMIC_TYPE_VERIFY_POOL  = 61
 };
 
 /* max error buffer string size */
@@ -127,6 +127,16 @@ enum CyaSSL_ErrorCodes {
     SANITY_MSG_E            = -394,        /* Sanity check on msg order error */
     DUPLICATE_MSG_E         = -395,        /* Duplicate message error */
     SNI_UNSUPPORTED         = -396,        /* SSL 3.0 does not support SNI */
+    KTLS_E                  = -397,        /* kernel TLS offload error */
+    WANT_ASYNC              = -398,        /* async op out, call again */
+    HIBERNATE_E             = -399,        /* can't hibernate/wake here */
+    UNKNOWN_ALPN_PROTOCOL_E = -400,        /* no ALPN protocol in common */
+    OCSP_WANT_READ          = -401,        /* OCSP responder recv would block */
+    OCSP_WANT_WRITE         = -402,        /* OCSP responder send would block */
+    CLIENT_HELLO_REJECT_E   = -403,        /* ClientHello callback said no */
+    WANT_CLIENT_HELLO       = -404,        /* ClientHello callback suspended */
+    CACHED_INFO_E           = -405,        /* cached chain hash mismatch */
+    HANDSHAKE_BUSY_E        = -406,        /* full handshake limit reached */
 
     /* add strings to SetErrorString !!!!! */
 
@@ -37,8 +37,10 @@
 #include <cyassl/ctaocrypt/sha.h>
 #include <cyassl/ctaocrypt/aes.h>
 #include <cyassl/ctaocrypt/poly1305.h>
+#include <cyassl/ctaocrypt/chacha20_poly1305.h>
 #include <cyassl/ctaocrypt/camellia.h>
 #include <cyassl/ctaocrypt/logging.h>
+#include <cyassl/ctaocrypt/stats.h>
 #include <cyassl/ctaocrypt/hmac.h>
 #ifndef NO_RC4
     #include <cyassl/ctaocrypt/arc4.h>
@@ -115,7 +117,7 @@
 
 
 #ifdef HAVE_LIBZ
-    #include "zlib.h"
+    #include <cyassl/ctaocrypt/compress.h>
 #endif
 
 #ifdef _MSC_VER
@@ -721,6 +723,7 @@ enum Misc {
     ID_LEN       = 32,         /* session id length       */
     MAX_COOKIE_LEN = 32,       /* max dtls cookie size    */
     COOKIE_SZ    = 20,         /* use a 20 byte cookie    */
+    DTLS_COOKIE_SECRET_SZ = 32, /* stateless cookie hmac key */
     SUITE_LEN    =  2,         /* cipher suite sz length  */
     ENUM_LEN     =  1,         /* always a byte           */
     OPAQUE8_LEN  =  1,         /* 1 byte                  */
@@ -745,11 +748,15 @@ enum Misc {
 
     DTLS_HANDSHAKE_HEADER_SZ = 12, /* normal + seq(2) + offset(3) + length(3) */
     DTLS_RECORD_HEADER_SZ    = 13, /* normal + epoch(2) + seq_num(6) */
+    READ_AHEAD_SZ = RECORD_HEADER_SZ + MAX_RECORD_SIZE + MAX_MSG_EXTRA,
+                                   /* least input room when reading ahead */
+    MAX_READ_AHEAD_SZ = 1024 * 1024,  /* most */
     DTLS_HANDSHAKE_EXTRA     = 8,  /* diff from normal */
     DTLS_RECORD_EXTRA        = 8,  /* diff from normal */
     DTLS_HANDSHAKE_SEQ_SZ    = 2,  /* handshake header sequence number */
     DTLS_HANDSHAKE_FRAG_SZ   = 3,  /* fragment offset and length are 24 bit */
     DTLS_POOL_SZ             = 5,  /* buffers to hold in the retry pool */
+    DTLS_MSG_SLOTS           = 8,  /* handshake messages held ahead */
 
     FINISHED_LABEL_SZ   = 15,  /* TLS finished label size */
     TLS_FINISHED_SZ     = 12,  /* TLS has a shorter size  */
@@ -955,6 +962,9 @@ CYASSL_LOCAL void InitSSL_Method(CYASSL_METHOD*, ProtocolVersion);
 CYASSL_LOCAL int DoFinished(CYASSL* ssl, const byte* input, word32* inOutIdx,
                             word32 size, word32 totalSz, int sniff);
 CYASSL_LOCAL int DoApplicationData(CYASSL* ssl, byte* input, word32* inOutIdx);
+#ifdef HAVE_SECURE_RENEGOTIATION
+CYASSL_LOCAL int HoldAppData(CYASSL* ssl, const byte* data, word32 sz);
+#endif
 
 
 /* CyaSSL buffer type */
@@ -964,6 +974,13 @@ typedef struct buffer {
 } buffer;
 
 
+/* one fragment of a gather list of caller data to send */
+typedef struct DataVec {
+    const byte* buffer;
+    word32      length;
+} DataVec;
+
+
 enum {
     FORCED_FREE = 1,
     NO_FORCED_FREE = 0
@@ -994,7 +1011,13 @@ enum {
 
 /* give user option to use 16K static buffers */
 #if defined(LARGE_STATIC_BUFFERS)
-    #define RECORD_SIZE MAX_RECORD_SIZE
+    #if defined(STATIC_FRAGMENT_SZ) && defined(HAVE_MAX_FRAGMENT)
+        /* sized for peers negotiating a max_fragment_length, bigger records
+           still get a dynamic buffer */
+        #define RECORD_SIZE STATIC_FRAGMENT_SZ
+    #else
+        #define RECORD_SIZE MAX_RECORD_SIZE
+    #endif
 #else
     #ifdef CYASSL_DTLS
         #define RECORD_SIZE MAX_MTU 
@@ -1038,6 +1061,9 @@ typedef struct {
     ALIGN16 byte staticBuffer[STATIC_BUFFER_LEN];
     byte   dynamicFlag;  /* dynamic memory currently in use */
     byte   offset;       /* alignment offset attempt */
+#ifdef CYASSL_RECORD_POOL
+    byte   poolClass;    /* record pool size class + 1, 0 from the heap */
+#endif
 } bufferStatic;
 
 /* Cipher Suites holder */
@@ -1054,7 +1080,7 @@ typedef struct Suites {
 
 CYASSL_LOCAL
 void InitSuites(Suites*, ProtocolVersion,
-                                     byte, byte, byte, byte, byte, byte, int);
+                               byte, byte, byte, byte, byte, byte, byte, int);
 CYASSL_LOCAL
 int  SetCipherList(Suites*, const char* list);
 
@@ -1086,19 +1112,121 @@ typedef struct OCSP_Entry OCSP_Entry;
     #define OCSP_DIGEST_SIZE 160
 #endif
 
+#ifndef NO_ASN
+    #define OCSP_SERIAL_SIZE EXTERNAL_SERIAL_SIZE
+#else
+    #define OCSP_SERIAL_SIZE 32
+#endif
+
+#ifndef HAVE_OCSP
+    typedef struct OcspId OcspId;
+#endif
+
+/* OCSP cert id, what a status is looked up by */
+struct OcspId {
+    byte    issuerHash[OCSP_DIGEST_SIZE];    /* issuer hash            */
+    byte    issuerKeyHash[OCSP_DIGEST_SIZE]; /* issuer public key hash */
+    byte    serial[OCSP_SERIAL_SIZE];        /* cert serial number     */
+    int     serialSz;                        /* serial length          */
+};
+
 #ifdef NO_ASN 
     /* no_asn won't have */
     typedef struct CertStatus CertStatus;
 #endif
 
+#ifndef OCSP_TABLE_SIZE
+    #define OCSP_TABLE_SIZE 64      /* status cache rows, issuer and serial */
+#endif
+
+#if defined(HAVE_OCSP) && defined(CYASSL_PTHREADS) && \
+    !defined(NO_OCSP_REFRESH)
+    #define HAVE_OCSP_REFRESH       /* background status refresher */
+#endif
+
+#ifndef OCSP_REFRESH_INTERVAL
+    #define OCSP_REFRESH_INTERVAL 60  /* seconds between refresher passes */
+#endif
+
+#ifndef OCSP_REFRESH_RETRY
+    #define OCSP_REFRESH_RETRY 60     /* seconds to back off a failed fetch */
+#endif
+
+#if defined(HAVE_OCSP) && !defined(CYASSL_USER_IO) && \
+    !defined(USE_WINDOWS_API) && !defined(CYASSL_LWIP) && \
+    !defined(MICRIUM) && !defined(NO_OCSP_NONBLOCK)
+    #define HAVE_OCSP_NONBLOCK      /* responder asked without blocking */
+#endif
+
+#ifndef MAX_URL_PART
+    #define MAX_URL_PART 80           /* domain name and path buffers */
+#endif
+
+#ifndef OCSP_CONN_MAX
+    #define OCSP_CONN_MAX 4           /* idle responder connections kept */
+#endif
+
+#ifndef OCSP_CONN_IDLE
+    #define OCSP_CONN_IDLE 30         /* seconds an idle one is kept */
+#endif
+
+/* cached OCSP status of one cert, by issuer and serial */
 struct OCSP_Entry {
-    OCSP_Entry* next;                        /* next entry             */
-    byte    issuerHash[OCSP_DIGEST_SIZE];    /* issuer hash            */ 
-    byte    issuerKeyHash[OCSP_DIGEST_SIZE]; /* issuer public key hash */
-    CertStatus* status;                      /* OCSP response list     */
-    int         totalStatus;                 /* number on list         */
+    OCSP_Entry* next;                   /* next entry in row */
+    OcspId      id;                     /* issuer and serial */
+    CertStatus* status;                 /* last good response */
+    word32      expires;                /* LowResTimer() at nextUpdate */
+    word32      refresh;                /* LowResTimer() to refetch at */
+    char*       url;                    /* responder, NULL: override */
+    int         urlSz;                  /* url length */
+    byte*       raw;                    /* DER response, kept for stapling */
+    word32      rawSz;                  /* raw length */
+    byte        keepRaw;                /* refresher keeps raw too */
+    byte        respHash[SHA_DIGEST_SIZE]; /* of the verified nonce-free
+                                              response, zeros if none */
+};
+
+
+#ifdef HAVE_OCSP_NONBLOCK
+
+/* idle keep-alive connection to a responder, for the next lookup there */
+typedef struct OcspConn {
+    SOCKET_T    fd;                     /* socket, if open */
+    byte        open;                   /* slot in use */
+    word16      port;                   /* responder port */
+    word32      idle;                   /* LowResTimer() when put back */
+    char        domain[MAX_URL_PART];   /* responder host */
+} OcspConn;
+
+enum OcspLookupState {
+    OCSP_LOOKUP_CONNECT = 0,            /* tcp connect in progress */
+    OCSP_LOOKUP_SEND,                   /* request going out */
+    OCSP_LOOKUP_RECV,                   /* response coming in */
+    OCSP_LOOKUP_DONE                    /* whole response in */
 };
 
+/* one non-blocking request to a responder, moved along by EmbedOcspStep()
+   each time the caller is back */
+typedef struct OcspLookup {
+    OcspId      id;                     /* asked about, request points here */
+    OcspRequest request;                /* kept for the nonce check */
+    SOCKET_T    fd;                     /* responder connection */
+    int         state;                  /* OcspLookupState */
+    byte        reused;                 /* fd was kept, may be closed by now */
+    byte        keepAlive;              /* responder lets fd stay open */
+    word16      port;                   /* responder port */
+    char        domain[MAX_URL_PART];   /* responder host */
+    byte*       out;                    /* http header and DER request */
+    word32      outSz;                  /* out length */
+    word32      outIdx;                 /* sent so far */
+    byte*       in;                     /* http response */
+    word32      inSz;                   /* in buffer size */
+    word32      inIdx;                  /* received so far */
+    word32      hdrSz;                  /* header length, 0 until all in */
+    word32      bodySz;                 /* Content-Length */
+} OcspLookup;
+
+#endif /* HAVE_OCSP_NONBLOCK */
 
 #ifndef HAVE_OCSP
     typedef struct CYASSL_OCSP CYASSL_OCSP;
@@ -1107,10 +1235,36 @@ struct OCSP_Entry {
 /* CyaSSL OCSP controller */
 struct CYASSL_OCSP {
     CYASSL_CERT_MANAGER* cm;            /* pointer back to cert manager */
-    OCSP_Entry*          ocspList;      /* OCSP response list */
-    CyaSSL_Mutex         ocspLock;      /* OCSP list lock */
+    OCSP_Entry*          ocspTable[OCSP_TABLE_SIZE]; /* status cache rows */
+    CyaSSL_Mutex         ocspLock;      /* OCSP table lock */
+#ifdef HAVE_OCSP_REFRESH
+    pthread_t            tid;           /* refresher thread id, 0 if none */
+    pthread_mutex_t      refreshLock;   /* guards refreshStop */
+    pthread_cond_t       refreshCond;   /* wakes refresher to stop */
+    int                  refreshStop;   /* refresher should exit */
+#endif
+#ifdef HAVE_OCSP_NONBLOCK
+    OcspConn             conns[OCSP_CONN_MAX]; /* kept alive, ocspLock */
+#endif
 };
 
+#ifndef CYASSL_USER_IO
+CYASSL_LOCAL int  EmbedOcspGet(const char* url, int urlSz, const byte* req,
+                               int reqSz, byte** resp);
+#endif
+
+#ifdef HAVE_OCSP_NONBLOCK
+CYASSL_LOCAL int  EmbedOcspStart(CYASSL_OCSP*, OcspLookup*, const char* url,
+                                 int urlSz, const byte* req, int reqSz);
+CYASSL_LOCAL int  EmbedOcspStep(CYASSL_OCSP*, OcspLookup*, byte** resp);
+CYASSL_LOCAL void EmbedOcspDone(CYASSL_OCSP*, OcspLookup*);
+CYASSL_LOCAL void FreeOcspConns(CYASSL_OCSP*);
+CYASSL_LOCAL int  CheckIdOCSP_NonBlock(CYASSL_OCSP*, const OcspId*,
+                                       const char* url, int urlSz,
+                                       OcspLookup** lookup);
+CYASSL_LOCAL void FreeOcspLookup(CYASSL_OCSP*, OcspLookup*);
+#endif
+
 #ifndef MAX_DATE_SIZE
 #define MAX_DATE_SIZE 32
 #endif
@@ -1123,10 +1277,6 @@ typedef struct CRL_Entry CRL_Entry;
     #define CRL_DIGEST_SIZE 160
 #endif
 
-#ifdef NO_ASN 
-    typedef struct RevokedCert RevokedCert;
-#endif
-
 /* Complete CRL */
 struct CRL_Entry {
     CRL_Entry* next;                      /* next entry */
@@ -1137,8 +1287,27 @@ struct CRL_Entry {
     byte    nextDate[MAX_DATE_SIZE]; /* next update date   */
     byte    lastDateFormat;          /* last date format */
     byte    nextDateFormat;          /* next date format */
-    RevokedCert* certs;              /* revoked cert list  */
-    int          totalCerts;         /* number on list     */
+#ifdef HAVE_DATE_EPOCH
+    word64  nextEpoch;               /* next date, seconds since 1970 */
+#endif
+    byte*   serials;                 /* packed revoked serials, sorted */
+    word32* serialIdx;               /* offset of each serial in serials */
+    int     totalCerts;              /* number in serialIdx */
+    char*   source;                  /* file or URL loaded from, NULL if from
+                                        a buffer */
+    CRL_Entry* retired;              /* next unlinked, waiting to be freed */
+};
+
+
+#ifndef CRL_TABLE_SIZE
+    #define CRL_TABLE_SIZE 16        /* issuer hash rows */
+#endif
+
+typedef struct CRL_Set CRL_Set;
+
+/* CRLs by issuer, a reload builds a new set and replaces the whole thing */
+struct CRL_Set {
+    CRL_Entry* crlTable[CRL_TABLE_SIZE];  /* our CRLs by issuer */
 };
 
 
@@ -1151,6 +1320,41 @@ struct CRL_Monitor {
 };
 
 
+#if defined(HAVE_CRL) && defined(CYASSL_PTHREADS) && \
+    !defined(CYASSL_USER_IO) && !defined(NO_CRL_FETCH)
+    #define HAVE_CRL_FETCH          /* background CDP fetcher */
+#endif
+
+#ifndef CRL_FETCH_MAX
+    #define CRL_FETCH_MAX       32    /* distribution points kept current */
+#endif
+
+#ifndef CRL_FETCH_URL_SZ
+    #define CRL_FETCH_URL_SZ   256    /* longest distribution point URL */
+#endif
+
+#ifndef CRL_FETCH_RETRY
+    #define CRL_FETCH_RETRY     60    /* seconds to back off a failed fetch */
+#endif
+
+#ifndef CRL_FETCH_INTERVAL
+    #define CRL_FETCH_INTERVAL 3600   /* seconds between fetches, no dates */
+#endif
+
+#ifndef CRL_FETCH_MAX_SZ
+    #define CRL_FETCH_MAX_SZ (16 * 1024 * 1024)  /* largest download */
+#endif
+
+typedef struct CRL_Fetch CRL_Fetch;
+
+/* CRL distribution point the fetcher keeps current, one per issuer */
+struct CRL_Fetch {
+    byte   issuerHash[CRL_DIGEST_SIZE];  /* issuer it was queued for */
+    char   url[CRL_FETCH_URL_SZ];        /* distribution point */
+    word32 refresh;                      /* LowResTimer() to fetch at */
+};
+
+
 #ifndef HAVE_CRL
     typedef struct CYASSL_CRL CYASSL_CRL;
 #endif
@@ -1158,13 +1362,23 @@ struct CRL_Monitor {
 /* CyaSSL CRL controller */
 struct CYASSL_CRL {
     CYASSL_CERT_MANAGER* cm;            /* pointer back to cert manager */
-    CRL_Entry*           crlList;       /* our CRL list */
+    CRL_Set*             crlSet;        /* current CRLs */
     CyaSSL_Mutex         crlLock;       /* CRL list lock */
+    int                  readers[2];    /* lockless lookups by epoch */
+    int                  epoch;         /* epoch new lookups join */
     CRL_Monitor          monitors[2];   /* PEM and DER possible */
 #ifdef HAVE_CRL_MONITOR
     pthread_t            tid;           /* monitoring thread */
     int                  mfd;           /* monitor fd, -1 if no init yet */
 #endif
+#ifdef HAVE_CRL_FETCH
+    CRL_Fetch*           fetches;       /* queued CDPs, NULL until started */
+    int                  fetchCount;    /* used in fetches */
+    pthread_t            fetchTid;      /* fetcher thread id, 0 if none */
+    pthread_mutex_t      fetchLock;     /* guards fetches and fetchStop */
+    pthread_cond_t       fetchCond;     /* wakes fetcher for new or stop */
+    int                  fetchStop;     /* fetcher should exit */
+#endif
 };
 
 
@@ -1174,13 +1388,75 @@ struct CYASSL_CRL {
 
 
 #ifndef CA_TABLE_SIZE
-    #define CA_TABLE_SIZE 11
+    #define CA_TABLE_SIZE 11          /* starting rows, and persisted rows */
+#endif
+#ifndef CA_TABLE_MAX_LOAD
+    #define CA_TABLE_MAX_LOAD 4       /* average signers per row to grow at */
+#endif
+
+/* CA table row entry, a signer is on one node per table generation */
+typedef struct CA_Node CA_Node;
+struct CA_Node {
+    Signer*  signer;
+    CA_Node* next;
+#ifndef NO_SKID
+    CA_Node* nameNext;                /* chain on nameRow */
+#endif
+};
+
+/* CA signer table, lookups may walk it without caLock. A resize builds a
+   whole new table and keeps the old one on retired, nodes intact, for
+   readers still on it, until the CAs are unloaded */
+typedef struct CA_Table CA_Table;
+struct CA_Table {
+    CA_Node** row;                    /* rows chains */
+#ifndef NO_SKID
+    CA_Node** nameRow;                /* same nodes by subject name hash */
+#endif
+    word32    rows;                   /* number of rows */
+    word32    count;                  /* signers on the table */
+    CA_Table* retired;                /* older generations, nodes only */
+};
+
+#ifdef HAVE_VERIFY_CACHE
+#ifndef VERIFY_CACHE_ROWS
+    #define VERIFY_CACHE_ROWS 128     /* default rows */
+#endif
+#ifndef VERIFY_CACHE_ROW_SZ
+    #define VERIFY_CACHE_ROW_SZ 8     /* entries per row */
+#endif
+#ifndef VERIFY_CACHE_TIMEOUT
+    #define VERIFY_CACHE_TIMEOUT 3600 /* seconds before a cert is reverified */
 #endif
 
+/* a cert whose signature was verified, by the SHA-256 of its DER */
+typedef struct VerifyCacheEntry {
+    byte    hash[SHA256_DIGEST_SIZE]; /* of the whole DER */
+    Signer* ca;                       /* signer it verified under, NULL free */
+    word32  expires;                  /* LowResTimer() to reverify at */
+    word32  used;                     /* row clock of last use, for LRU */
+#ifdef HAVE_DATE_EPOCH
+    Signer* self;                     /* chain CA the cert was filed as, its
+                                         DER is then taken as is */
+    word64  notAfter;                 /* cert expiry, seconds since 1970 */
+#endif
+} VerifyCacheEntry;
+
+typedef struct VerifyCacheRow {
+    VerifyCacheEntry entry[VERIFY_CACHE_ROW_SZ];
+    word32           clock;           /* use clock */
+} VerifyCacheRow;
+#endif /* HAVE_VERIFY_CACHE */
+
 /* CyaSSL Certificate Manager */
 struct CYASSL_CERT_MANAGER {
-    Signer*         caTable[CA_TABLE_SIZE]; /* the CA signer table */
+    CA_Table*       caTable;            /* the CA signer table */
     CyaSSL_Mutex    caLock;             /* CA list lock */
+#ifdef HAVE_VERIFY_CACHE
+    VerifyCacheRow* verifyCache;        /* verified certs, on first use */
+    word32          verifyCacheRows;    /* rows, 0 off */
+    CyaSSL_Mutex    verifyLock;         /* verified cert cache lock */
+#endif
     CallbackCACache caCacheCallback;    /* CA cache addition callback */
     void*           heap;               /* heap helper */
     CYASSL_CRL*     crl;                /* CRL checker */
@@ -1191,10 +1467,21 @@ struct CYASSL_CERT_MANAGER {
     byte            ocspEnabled;        /* is OCSP on ? */
     byte            ocspSendNonce;      /* send the OCSP nonce ? */
     byte            ocspUseOverrideURL; /* ignore cert's responder, override */
+    byte            ocspNonBlock;       /* ask responder without blocking */
     char*           ocspOverrideURL;    /* use this responder */
     void*           ocspIOCtx;          /* I/O callback CTX */
     CbOCSPIO        ocspIOCb;           /* I/O callback for OCSP lookup */
     CbOCSPRespFree  ocspRespFreeCb;     /* Frees OCSP Response from IO Cb */
+#ifdef CYASSL_LOAD_THREADS
+    word16          loadThreads;        /* CA load threads, 0 or 1 serial */
+    byte            loadPooled;         /* dir load pool running, files go
+                                           serially on its threads */
+#endif
+#ifdef HAVE_TRUST_STORE
+    const byte*     trustStore;         /* precompiled signer table image */
+    word32          trustStoreSz;       /* image size */
+    byte            trustStoreMapped;   /* we mapped it, unmap on unload */
+#endif
 };
 
 CYASSL_LOCAL int CM_SaveCertCache(CYASSL_CERT_MANAGER*, const char*);
@@ -1202,6 +1489,11 @@ CYASSL_LOCAL int CM_RestoreCertCache(CYASSL_CERT_MANAGER*, const char*);
 CYASSL_LOCAL int CM_MemSaveCertCache(CYASSL_CERT_MANAGER*, void*, int, int*);
 CYASSL_LOCAL int CM_MemRestoreCertCache(CYASSL_CERT_MANAGER*, const void*, int);
 CYASSL_LOCAL int CM_GetCertCacheMemSize(CYASSL_CERT_MANAGER*);
+#ifdef HAVE_TRUST_STORE
+CYASSL_LOCAL int CM_SaveTrustStore(CYASSL_CERT_MANAGER*, const char*);
+CYASSL_LOCAL int CM_LoadTrustStore(CYASSL_CERT_MANAGER*, const char*);
+CYASSL_LOCAL int CM_MemLoadTrustStore(CYASSL_CERT_MANAGER*, const void*, int);
+#endif
 
 /* CyaSSL Sock Addr */
 struct CYASSL_SOCKADDR {
@@ -1215,6 +1507,108 @@ typedef struct CYASSL_DTLS_CTX {
 } CYASSL_DTLS_CTX;
 
 
+#ifdef HAVE_DTLS_MUX
+
+enum {
+    DTLS_MUX_BATCH   = 32,   /* datagrams per recvmmsg() and sendmmsg() */
+    DTLS_MUX_QUEUE   = 8,    /* datagrams held for a peer until it reads */
+    DTLS_MUX_BUCKETS = 256   /* first peer table size, doubles as it fills */
+};
+
+/* a datagram waiting to be read, or to be sent to addr */
+typedef struct DtlsMuxDgram {
+    struct DtlsMuxDgram* next;
+    byte*                data;     /* allocated with the struct */
+    word32               sz;
+    byte*                addr;     /* sends only, after data */
+    word32               addrSz;
+} DtlsMuxDgram;
+
+typedef struct DtlsMuxPeer {
+    struct DtlsMuxPeer* next;      /* hash chain */
+    struct DtlsMuxPeer* readyNext; /* ready list */
+    struct CYASSL_DTLS_MUX* mux;
+    CYASSL*             ssl;
+    DtlsMuxDgram*       head;      /* queued input, oldest first */
+    DtlsMuxDgram*       tail;
+    word32              queued;
+    word32              hash;
+    byte                ready;     /* on the ready list */
+} DtlsMuxPeer;
+
+struct CYASSL_DTLS_MUX {
+    CYASSL_CTX*      ctx;
+    void*            heap;
+    int              fd;
+    DtlsMuxPeer**    table;         /* keyed on peer address */
+    word32           tableSz;       /* power of two */
+    word32           count;
+    DtlsMuxPeer*     readyHead;     /* peers with input, first come first */
+    DtlsMuxPeer*     readyTail;
+    DtlsMuxDgram*    sendHead;      /* queued output */
+    DtlsMuxDgram*    sendTail;
+    word32           sendCount;
+    byte*            recvBuf;       /* DTLS_MUX_BATCH * MAX_MTU */
+    CallbackDtlsMuxNewPeer newPeerCb;
+    void*            newPeerCtx;
+};
+
+CYASSL_LOCAL int EmbedMuxReceive(CYASSL* ssl, char* buf, int sz, void* ctx);
+CYASSL_LOCAL int EmbedMuxSend(CYASSL* ssl, char* buf, int sz, void* ctx);
+
+#endif /* HAVE_DTLS_MUX */
+
+
+#ifdef HAVE_CONN_POOL
+
+#ifndef CYASSL_PTHREADS
+    #error HAVE_CONN_POOL needs pthreads
+#endif
+
+#ifndef CONN_POOL_INTERVAL
+    #define CONN_POOL_INTERVAL 1      /* seconds between refill passes */
+#endif
+
+#ifndef CONN_POOL_RETRY
+    #define CONN_POOL_RETRY 5         /* seconds to back off a failed connect */
+#endif
+
+#ifndef CONN_POOL_HOST_SZ
+    #define CONN_POOL_HOST_SZ 256     /* host name and port server id */
+#endif
+
+/* an idle, handshaken connection */
+typedef struct ConnPoolConn {
+    struct ConnPoolConn* next;
+    CYASSL*              ssl;
+    word32               idleSince;    /* LowResTimer() when put back */
+} ConnPoolConn;
+
+typedef struct ConnPoolUpstream {
+    struct ConnPoolUpstream* next;
+    char                     host[CONN_POOL_HOST_SZ];
+    word16                   port;
+    byte                     serverId[SHA_DIGEST_SIZE]; /* host and port */
+    ConnPoolConn*            idle;         /* most recently idle first */
+    int                      idleCount;
+    word32                   retryAt;      /* LowResTimer() after a failure */
+} ConnPoolUpstream;
+
+struct CYASSL_CONN_POOL {
+    CYASSL_CTX*       ctx;
+    void*             heap;
+    int               target;           /* idle connections per upstream */
+    word32            maxIdle;          /* seconds one may sit idle */
+    ConnPoolUpstream* upstreams;
+    pthread_mutex_t   lock;
+    pthread_cond_t    cond;             /* wakes the refiller */
+    pthread_t         tid;
+    byte              stop;
+};
+
+#endif /* HAVE_CONN_POOL */
+
+
 #ifdef CYASSL_DTLS
 
     #ifdef WORD64_AVAILABLE
@@ -1222,17 +1616,25 @@ typedef struct CYASSL_DTLS_CTX {
     #else
         typedef word32 DtlsSeq;
     #endif
-    #define DTLS_SEQ_BITS (sizeof(DtlsSeq) * CHAR_BIT)
+    #define DTLS_WORD_BITS (sizeof(DtlsSeq) * CHAR_BIT)
+
+    /* replay window width in records, a multiple of DTLS_WORD_BITS, build
+     * with e.g. -DDTLS_SEQ_BITS=1024 for media streams on reordering paths */
+    #ifndef DTLS_SEQ_BITS
+        #define DTLS_SEQ_BITS DTLS_WORD_BITS
+    #endif
+    /* one spare word so advancing the window clears whole words only */
+    #define DTLS_SEQ_SZ   (DTLS_SEQ_BITS / DTLS_WORD_BITS + 1)
 
     typedef struct DtlsState {
-        DtlsSeq window;     /* Sliding window for current epoch    */
+        DtlsSeq window[DTLS_SEQ_SZ];     /* Sliding window for current epoch */
         word16 nextEpoch;   /* Expected epoch in next record       */
         word32 nextSeq;     /* Expected sequence in next record    */
 
         word16 curEpoch;    /* Received epoch in current record    */
         word32 curSeq;      /* Received sequence in current record */
 
-        DtlsSeq prevWindow; /* Sliding window for old epoch        */
+        DtlsSeq prevWindow[DTLS_SEQ_SZ]; /* Sliding window for old epoch */
         word32 prevSeq;     /* Next sequence in allowed old epoch  */
     } DtlsState;
 
@@ -1270,6 +1672,10 @@ typedef struct Keys {
     word32 padSz;                 /* how much to advance after decrypt part */
     byte   encryptionOn;          /* true after change cipher spec */
     byte   decryptedCur;          /* only decrypt current record once */
+#ifndef NO_TLS
+    HmacState macState[2];        /* client, server write MAC secrets keyed */
+    byte   macStateSet[2];        /* keyed since the secrets last changed */
+#endif
 } Keys;
 
 
@@ -1278,12 +1684,16 @@ typedef struct Keys {
 #ifdef HAVE_TLS_EXTENSIONS
 
 typedef enum {
-    SERVER_NAME_INDICATION = 0x0000,
-    MAX_FRAGMENT_LENGTH    = 0x0001,
-    TRUNCATED_HMAC         = 0x0004,
-    ELLIPTIC_CURVES        = 0x000a,
-    SESSION_TICKET         = 0x0023,
-    SECURE_RENEGOTIATION   = 0xff01
+    SERVER_NAME_INDICATION     = 0x0000,
+    MAX_FRAGMENT_LENGTH        = 0x0001,
+    TRUNCATED_HMAC             = 0x0004,
+    STATUS_REQUEST             = 0x0005,
+    ELLIPTIC_CURVES            = 0x000a,
+    APPLICATION_LAYER_PROTOCOL = 0x0010,
+    ENCRYPT_THEN_MAC           = 0x0016,
+    CACHED_INFO                = 0x0019,
+    SESSION_TICKET             = 0x0023,
+    SECURE_RENEGOTIATION       = 0xff01
 } TLSX_Type;
 
 typedef struct TLSX {
@@ -1313,9 +1723,13 @@ CYASSL_LOCAL int    TLSX_Parse(CYASSL* ssl, byte* input, word16 length,
 #elif defined(HAVE_SNI)                  \
    || defined(HAVE_MAX_FRAGMENT)         \
    || defined(HAVE_TRUNCATED_HMAC)       \
+   || defined(HAVE_ENCRYPT_THEN_MAC)     \
+   || defined(HAVE_CACHED_INFO)          \
    || defined(HAVE_SUPPORTED_CURVES)     \
    || defined(HAVE_SECURE_RENEGOTIATION) \
-   || defined(HAVE_SESSION_TICKET)
+   || defined(HAVE_SESSION_TICKET)       \
+   || defined(HAVE_CERTIFICATE_STATUS_REQUEST) \
+   || defined(HAVE_ALPN)
 
 #error Using TLS extensions requires HAVE_TLS_EXTENSIONS to be defined.
 
@@ -1345,6 +1759,26 @@ CYASSL_LOCAL word16 TLSX_SNI_GetRequest(TLSX* extensions, byte type,
                                                                    void** data);
 CYASSL_LOCAL int    TLSX_SNI_GetFromBuffer(const byte* buffer, word32 bufferSz,
                                          byte type, byte* sni, word32* inOutSz);
+
+enum {
+    SNI_HOST_BUCKETS = 64,      /* first table size, doubles as hosts come */
+    MAX_SNI_HOST_SZ  = 255      /* longest server name looked up */
+};
+
+/* virtual host, name as given, "*.example.com" for a wildcard */
+typedef struct SNIHost {
+    struct SNIHost* next;       /* bucket chain */
+    CYASSL_CTX*     ctx;        /* holds a reference */
+    char*           name;       /* stored after the struct */
+    word32          hash;
+    word16          nameSz;
+} SNIHost;
+
+CYASSL_LOCAL int         AddSNIHost(CYASSL_CTX*, const char* name,
+                                    word16 nameSz, CYASSL_CTX* vhost);
+CYASSL_LOCAL CYASSL_CTX* FindSNIHost(CYASSL_CTX*, const char* name,
+                                     word16 nameSz);
+CYASSL_LOCAL void        FreeSNIHosts(CYASSL_CTX*);
 #endif
 
 #endif /* HAVE_SNI */
@@ -1362,6 +1796,33 @@ CYASSL_LOCAL int TLSX_UseTruncatedHMAC(TLSX** extensions);
 
 #endif /* HAVE_TRUNCATED_HMAC */
 
+/* Encrypt-then-MAC, RFC 7366 */
+#ifdef HAVE_ENCRYPT_THEN_MAC
+
+CYASSL_LOCAL int TLSX_UseEncryptThenMac(TLSX** extensions);
+
+#endif /* HAVE_ENCRYPT_THEN_MAC */
+
+/* Cached Information, RFC 7924 */
+#ifdef HAVE_CACHED_INFO
+
+#ifdef NO_SHA256
+    #error Cached Information hashes the chain with SHA-256
+#endif
+
+enum {
+    CACHED_INFO_CERT = 1    /* CachedInformationType cert */
+};
+
+CYASSL_LOCAL int  TLSX_UseCachedInfo(TLSX** extensions, const byte* hash);
+CYASSL_LOCAL int  TLSX_CachedInfo_Match(TLSX* extensions, const byte* hash,
+                                                                word32 hashSz);
+#ifndef NO_CYASSL_SERVER
+CYASSL_LOCAL void TLSX_CachedInfo_Respond(CYASSL* ssl, const byte* hash);
+#endif
+
+#endif /* HAVE_CACHED_INFO */
+
 #ifdef HAVE_SUPPORTED_CURVES
 
 typedef struct EllipticCurve {
@@ -1372,6 +1833,18 @@ typedef struct EllipticCurve {
 CYASSL_LOCAL int TLSX_UseSupportedCurve(TLSX** extensions, word16 name);
 
 #ifndef NO_CYASSL_SERVER
+enum {
+    PEER_CURVES_MAX = 8         /* at least the curves we know */
+};
+
+/* the client's curves we know, in the order sent, parsed straight off the
+   hello into fixed slots instead of a TLSX list */
+typedef struct PeerCurves {
+    word16 name[PEER_CURVES_MAX];
+    byte   count;
+    byte   sent;                /* hello had the extension */
+} PeerCurves;
+
 CYASSL_LOCAL int TLSX_ValidateEllipticCurves(CYASSL* ssl, byte first,
                                                                    byte second);
 #endif
@@ -1393,6 +1866,7 @@ enum key_cache_state {
 typedef struct SecureRenegotiation {
    byte                 enabled;  /* secure_renegotiation flag in rfc */
    byte                 startScr; /* server requested client to start scr */
+   byte                 inProgress; /* a renegotiation, until it completes */
    enum key_cache_state cache_status;  /* track key cache state */
    byte                 client_verify_data[TLS_FINISHED_SZ];  /* cached */
    byte                 server_verify_data[TLS_FINISHED_SZ];  /* cached */
@@ -1417,42 +1891,381 @@ CYASSL_LOCAL int  TLSX_UseSessionTicket(TLSX** extensions,
 CYASSL_LOCAL SessionTicket* TLSX_SessionTicket_Create(word32 lifetime,
                                                        byte* data, word16 size);
 CYASSL_LOCAL void TLSX_SessionTicket_Free(SessionTicket* ticket);
+
+#ifndef NO_CYASSL_SERVER
+
+#if CYASSL_TICKET_KEYS < 1
+    #error CYASSL_TICKET_KEYS needs to be at least 1
+#endif
+
+enum TicketEngine {
+    TICKET_VERSION  = 1,                /* state layout, bump on change */
+    TICKET_IV_SZ    = 12,
+    TICKET_TAG_SZ   = 16,
+    TICKET_STATE_SZ = 1 + VERSION_SZ + SUITE_LEN + SECRET_LEN + 4 + 4,
+    TICKET_SZ       = CYASSL_TICKET_NAME_SZ + TICKET_IV_SZ + TICKET_STATE_SZ +
+                      TICKET_TAG_SZ
+};
+
+typedef struct TicketKey {
+    byte   name[CYASSL_TICKET_NAME_SZ];
+    byte   key[CYASSL_TICKET_KEY_SZ];
+    word32 created;                     /* LowResTimer() when installed */
+} TicketKey;
+
+CYASSL_LOCAL int  AddTicketKey(CYASSL_CTX*, const byte* name, const byte* key);
+CYASSL_LOCAL int  RotateTicketKey(CYASSL_CTX*, RNG*, int ifExpired);
+CYASSL_LOCAL int  DoClientTicket(CYASSL*, const byte* input, word32 len);
+CYASSL_LOCAL int  SendTicket(CYASSL*);
+CYASSL_LOCAL int  TLSX_SessionTicket_SetResponse(CYASSL*);
+#endif /* NO_CYASSL_SERVER */
 #endif /* HAVE_SESSION_TICKET */
 
+#ifdef HAVE_OCSP
+/* peer cert's OCSP check held back to the next message, until the server had
+   a chance to staple or the responder is asked without blocking */
+typedef struct OcspPending {
+    OcspId      id;
+    char*       url;      /* responder from the cert, NULL if none */
+    int         urlSz;
+#ifdef HAVE_OCSP_NONBLOCK
+    OcspLookup* lookup;   /* request out to the responder, NULL if none */
+#endif
+} OcspPending;
+#endif
+
+/* Certificate Status Request, OCSP stapling */
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+
+#ifndef HAVE_OCSP
+    #error OCSP stapling requires HAVE_OCSP to be defined.
+#endif
+
+enum {
+    CSR_OCSP = 1      /* status_type ocsp, the only one defined */
+};
+
+CYASSL_LOCAL int  TLSX_UseCertificateStatusRequest(TLSX** extensions);
+#ifndef NO_CYASSL_SERVER
+CYASSL_LOCAL int  SendCertificateStatus(CYASSL*);
+#endif
+#endif /* HAVE_CERTIFICATE_STATUS_REQUEST */
+
+/* Application-Layer Protocol Negotiation */
+#ifdef HAVE_ALPN
+
+enum {
+    ALPN_LIST_MAX = 0xFFFC  /* comma list size, fits the extension on wire */
+};
+
+typedef struct ALPN {
+    byte*  list;       /* length prefixed protocol names, wire format */
+    word16 size;       /* list size */
+    byte   options;    /* CYASSL_ALPN_* flags */
+    byte   negotiated; /* list holds just the protocol agreed on */
+} ALPN;
+
+CYASSL_LOCAL int TLSX_UseALPN(TLSX** extensions, const char* protocols,
+                                                   word32 size, byte options);
+CYASSL_LOCAL int TLSX_ALPN_GetProtocol(TLSX* extensions, char** name,
+                                                                 word16* size);
+
+#endif /* HAVE_ALPN */
+
+#ifndef NO_SESSION_CACHE
+    typedef struct SessionCache SessionCache;    /* defined in ssl.c */
+
+    CYASSL_LOCAL void FreeSessionCache(SessionCache*);
+
+    /* CYASSL_CTX internalCacheOff flags, used with external cache callbacks */
+    enum {
+        SESSION_NO_INTERNAL_LOOKUP = 0x01,
+        SESSION_NO_INTERNAL_STORE  = 0x02
+    };
+#endif
+
+#if !defined(NO_CYASSL_SERVER) && (defined(HAVE_ECC) || defined(HAVE_ECC25519))
+    #define HAVE_EPHEMERAL_KEY_POOL
+#endif
+
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+/* ephemeral ECDHE key pairs made ahead of the handshake, each a LIFO stack */
+typedef struct KeyPool {
+#ifdef HAVE_ECC
+    ecc_key**      ecc;
+    int            eccCount;
+    word16         eccKeySz;            /* eccTempKeySz the keys were made at */
+#endif
+#ifdef HAVE_ECC25519
+    ecc25519_key** ecc25519;
+    int            ecc25519Count;
+    word16         ecc25519KeySz;
+#endif
+    int            size;                /* slots per key type, 0 off */
+    CyaSSL_Mutex   mutex;
+} KeyPool;
+
+CYASSL_LOCAL int  SetKeyPoolSize(CYASSL_CTX*, int size);
+CYASSL_LOCAL int  FillKeyPool(CYASSL_CTX*, RNG*, int max);
+CYASSL_LOCAL int  KeyPoolCount(CYASSL_CTX*);
+#endif /* HAVE_EPHEMERAL_KEY_POOL */
+
+#ifdef HAVE_PARALLEL_WRITE
+
+#ifndef CYASSL_PTHREADS
+    #error HAVE_PARALLEL_WRITE needs pthreads
+#endif
+
+#if !defined(BUILD_AESGCM) && \
+    !(defined(HAVE_CHACHA) && defined(HAVE_POLY1305))
+    #error HAVE_PARALLEL_WRITE needs AES-GCM or ChaCha20-Poly1305
+#endif
+
+#ifndef PARALLEL_WRITE_MAX
+    #define PARALLEL_WRITE_MAX 32     /* worker threads per ctx */
+#endif
+
+#ifndef PARALLEL_WRITE_BATCH
+    #define PARALLEL_WRITE_BATCH 32   /* records sealed per round */
+#endif
+
+/* one AEAD record of a write, the writer lays out the header, explicit IV,
+   sequence and nonce in order, whichever thread claims it copies the
+   plaintext in and seals it */
+typedef struct WriteJob {
+    byte*          out;                        /* record header */
+    const DataVec* vec;                        /* plaintext from vecOff */
+    word32         vecOff;
+    word32         sz;                         /* plaintext size */
+    word32         ivSz;                       /* explicit IV after header */
+    word32         addSz;
+    byte           additional[16];             /* GCM 13, ChaCha 16 used */
+    byte           nonce[AEAD_NONCE_SZ];
+} WriteJob;
+
+/* the jobs of one write, queued until every one is claimed */
+typedef struct WriteBatch {
+    struct WriteBatch* next;
+    CYASSL*            ssl;
+    WriteJob*          jobs;
+    int                cnt;
+    int                claimed;
+    int                done;
+    int                ret;                    /* first sealing error */
+} WriteBatch;
+
+typedef struct WritePool {
+    pthread_mutex_t mutex;
+    pthread_cond_t  work;                      /* batch queued or stop */
+    pthread_cond_t  done;                      /* a batch finished */
+    pthread_t       tid[PARALLEL_WRITE_MAX];
+    int             threads;
+    byte            stop;
+    WriteBatch*     head;                      /* batches with unclaimed jobs */
+    WriteBatch*     tail;
+} WritePool;
+
+CYASSL_LOCAL int  SetWritePool(CYASSL_CTX*, int threads);
+#endif /* HAVE_PARALLEL_WRITE */
+
+#ifdef HAVE_PARALLEL_VERIFY
+
+#ifndef CYASSL_PTHREADS
+    #error HAVE_PARALLEL_VERIFY needs pthreads
+#endif
+
+#ifndef PARALLEL_VERIFY_MAX
+    #define PARALLEL_VERIFY_MAX 8     /* worker threads per ctx */
+#endif
+
+/* a received chain cert's signature checked against the key of the next
+   cert up, keySz stays 0 unless it held, the in order pass then skips the
+   check when the signer it finds has that same key */
+typedef struct VerifyJob {
+    const byte* cert;
+    word32      certSz;
+    const byte* issuer;                        /* next cert up the chain */
+    word32      issuerSz;
+    byte*       key;                           /* issuerSz room, caller's */
+    word32      keySz;
+    word32      keyOID;
+} VerifyJob;
+
+/* the jobs of one Certificate message, queued until every one is claimed */
+typedef struct VerifyBatch {
+    struct VerifyBatch* next;
+    VerifyJob*          jobs;
+    int                 cnt;
+    int                 claimed;
+    int                 done;
+    void*               heap;
+} VerifyBatch;
+
+typedef struct VerifyPool {
+    pthread_mutex_t mutex;
+    pthread_cond_t  work;                      /* batch queued or stop */
+    pthread_cond_t  done;                      /* a batch finished */
+    pthread_t       tid[PARALLEL_VERIFY_MAX];
+    int             threads;
+    byte            stop;
+    VerifyBatch*    head;                      /* batches with unclaimed jobs */
+    VerifyBatch*    tail;
+} VerifyPool;
+
+CYASSL_LOCAL int  SetVerifyPool(CYASSL_CTX*, int threads);
+#endif /* HAVE_PARALLEL_VERIFY */
+
+#if !defined(NO_PSK) && defined(HAVE_PSK_STORE)
+enum {
+    PSK_STORE_SEED_SZ = 16,             /* keys the identity hash */
+    PSK_STORE_MAX_SZ  = 0x3FFFFFFF      /* bytes of lines, keeps sizes 32 bit */
+};
+
+/* one immutable generation of the built in server PSK store, an open
+   addressed table, load at most half, of offsets into packed records of
+   idLen, keyLen, identity, key. All of it is a single allocation */
+typedef struct PskStoreGen {
+    word32  count;                      /* distinct identities */
+    word32  mask;                       /* slots - 1, a power of 2 */
+    byte    seed[PSK_STORE_SEED_SZ];
+    word32* slot;                       /* record offset + 1, 0 empty */
+    byte*   data;                       /* packed records */
+    word32  dataSz;
+} PskStoreGen;
+
+/* Lookups count themselves in readers[epoch & 1] and don't lock, a reload
+   swaps gen, bumps the epoch and waits for the old side to drain before
+   freeing the old generation. Without atomics lookups take lock too */
+typedef struct PskStore {
+    PskStoreGen* gen;
+    word32       readers[2];
+    word32       epoch;
+    CyaSSL_Mutex lock;                  /* serializes reloads */
+} PskStore;
+
+CYASSL_LOCAL void   FreePskStore(PskStore*, void* heap);
+CYASSL_LOCAL word32 PskStoreLookup(PskStore*, const char* identity,
+                                   byte* key, word32 keySz);
+#endif /* !NO_PSK && HAVE_PSK_STORE */
+
+
+enum AsyncOpState {
+    ASYNC_IDLE    = 0,
+    ASYNC_PENDING = 1,                  /* out with the executor */
+    ASYNC_DONE    = 2                   /* result waiting to be picked up */
+};
+
+#ifdef CYASSL_ASYNC_CRYPT
+
+/* one private key op out with the async executor, the CYASSL doesn't move
+   until the result is picked up so the key and rng are read from it */
+struct CYASSL_ASYNC_OP {
+    CYASSL*        ssl;
+    int            type;                /* CYASSL_ASYNC_ op */
+    int            state;               /* AsyncOpState, under mutex */
+    int            ret;                 /* op return */
+    word32         inSz;
+    word32         outSz;
+    byte           in[ENCRYPT_LEN];     /* also matches the call coming back */
+    byte           out[ENCRYPT_LEN];
+    CyaSSL_Mutex   mutex;
+};
+
+CYASSL_LOCAL int  GetAsyncState(CYASSL* ssl);
+CYASSL_LOCAL int  RunAsyncOp(CYASSL_ASYNC_OP* op);
+#else
+    #define GetAsyncState(ssl) ASYNC_IDLE
+#endif /* CYASSL_ASYNC_CRYPT */
+
+/* CTX reference counts are atomic where the compiler has the builtins,
+   CyaSSL_new() and CyaSSL_free() then don't take countMutex */
+#if !defined(SINGLE_THREADED) && defined(__ATOMIC_ACQUIRE) && \
+    !defined(NO_CTX_ATOMIC_REF)
+    #define CTX_ATOMIC_REF
+#endif
+
+#ifndef CYASSL_MAX_NUMA_NODES
+    #define CYASSL_MAX_NUMA_NODES 8   /* CyaSSL_CTX_SetNumaNode() nodes */
+#endif
+
 /* CyaSSL context type */
 struct CYASSL_CTX {
     CYASSL_METHOD* method;
     CyaSSL_Mutex   countMutex;    /* reference count mutex */
     int         refCount;         /* reference count */
+    CYASSL_CTX* rotated;          /* CyaSSL_CTX_Rotate() target, or NULL */
+    CYASSL_CTX* numaCtx[CYASSL_MAX_NUMA_NODES]; /* per node replicas */
+    byte        numaNodes;        /* numaCtx entries set */
+    int         hsLimit;          /* full handshakes at once, 0 no limit */
+    int         hsInFlight;       /* full handshakes admitted, not done */
+#ifdef CTX_ATOMIC_REF
+    word32      rotEpoch;         /* CyaSSL_new() counts itself on side */
+    word32      rotReaders[2];    /* rotEpoch & 1 while it reads rotated */
+#endif
 #ifndef NO_CERTS
     buffer      certificate;
     buffer      certChain;
                  /* chain after self, in DER, with leading size for each cert */
+    buffer      certMsg;          /* Certificate message body, built at load */
+#ifdef HAVE_CACHED_INFO
+    byte        certMsgHash[SHA256_DIGEST_SIZE]; /* of certMsg, RFC 7924 */
+#endif
     buffer      privateKey;
+#ifdef HAVE_ECC
+    buffer      eccCertificate;   /* ECDSA slot, filled when dualCert is on */
+    buffer      eccCertChain;
+    buffer      eccPrivateKey;
+#endif
+#ifndef NO_RSA
+    RsaKey*     privateRsaKey;    /* privateKey decoded at load, read only */
+#endif
+#ifdef HAVE_ECC
+    ecc_key*    privateEccKey;    /* or as ECC, same */
+    ecc_key*    eccSlotKey;       /* eccPrivateKey decoded, same */
+#endif
     buffer      serverDH_P;
     buffer      serverDH_G;
+#ifndef NO_DH
+    DhFixedBase* serverDH_Fb;     /* serverDH_P and G's g table, read only */
+#endif
     CYASSL_CERT_MANAGER* cm;      /* our cert manager, ctx owns SSL will use */
 #endif
     Suites      suites;
     void*       heap;             /* for user memory overrides */
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemStats* memStats;    /* what ctx and its SSLs allocate */
+#endif
     byte        verifyPeer;
     byte        verifyNone;
     byte        failNoCert;
     byte        sessionCacheOff;
     byte        sessionCacheFlushOff;
+#ifndef NO_SESSION_CACHE
+    SessionCache* sessionCache;   /* private cache, NULL uses global one */
+#endif
     byte        sendVerify;       /* for client side */
     byte        haveRSA;          /* RSA available */
     byte        haveDH;           /* server DH parms set by user */
     byte        haveNTRU;         /* server private NTRU  key loaded */
     byte        haveECDSAsig;     /* server cert signed w/ ECDSA */
     byte        haveStaticECC;    /* static server ECC private key */
+    byte        dualCert;         /* ECC cert and key loads go to ECC slot */
     byte        partialWrite;     /* only one msg per write call */
     byte        quietShutdown;    /* don't send close notify */
     byte        groupMessages;    /* group handshake messages before sending */
+    byte        compact;          /* shed handshake leftovers once done */
+    byte        falseStart;       /* client writes before server Finished */
+    word32      writeCoalesce;    /* app data bytes to batch per send, 0 off */
+    word32      readAhead;        /* input buffer bytes to read into, 0 off */
+    word32      dynRecordSz;      /* small record size at start, 0 off */
+    word32      dynRecordRamp;    /* app bytes sent small before full size */
+    word32      dynRecordIdle;    /* seconds idle that go back to small */
     CallbackIORecv CBIORecv;
     CallbackIOSend CBIOSend;
 #ifdef CYASSL_DTLS
     CallbackGenCookie CBIOCookie;       /* gen cookie callback */
+    byte        cookieSecret[DTLS_COOKIE_SECRET_SZ]; /* listen cookie key */
+    word32      cookieSecretSz;         /* 0 until set */
 #endif
     VerifyCallback  verifyCallback;     /* cert verification callback */
     word32          timeout;            /* session timeout */
@@ -1468,6 +2281,9 @@ struct CYASSL_CTX {
     psk_client_callback client_psk_cb;  /* client callback */
     psk_server_callback server_psk_cb;  /* server callback */
     char        server_hint[MAX_PSK_ID_LEN];
+#ifdef HAVE_PSK_STORE
+    PskStore    pskStore;               /* built in server identities */
+#endif
 #endif /* NO_PSK */
 #ifdef HAVE_ANON
     byte        haveAnon;               /* User wants to allow Anon suites */
@@ -1476,6 +2292,12 @@ struct CYASSL_CTX {
     pem_password_cb passwd_cb;
     void*            userdata;
 #endif /* OPENSSL_EXTRA */
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE)
+    byte             internalCacheOff;  /* SESSION_NO_INTERNAL_ flags */
+    CYASSL_SESSION* (*get_sess_cb)(CYASSL*, unsigned char*, int, int*);
+    int             (*new_sess_cb)(CYASSL*, CYASSL_SESSION*);
+    void            (*rem_sess_cb)(CYASSL_CTX*, CYASSL_SESSION*);
+#endif
 #ifdef HAVE_OCSP
     CYASSL_OCSP      ocsp;
 #endif
@@ -1485,10 +2307,54 @@ struct CYASSL_CTX {
 #ifdef HAVE_TLS_EXTENSIONS
     TLSX* extensions;                  /* RFC 6066 TLS Extensions data */
 #endif
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    TicketKey         ticketKeys[CYASSL_TICKET_KEYS]; /* current first */
+    int               ticketKeyCount;
+    word32            ticketKeyLifetime; /* auto rotate after, 0 never */
+    CallbackTicketKey ticketKeyCb;       /* told about new keys */
+    void*             ticketKeyCtx;
+    CyaSSL_Mutex      ticketKeyMutex;
+#endif
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+    KeyPool           keyPool;           /* pre-generated ECDHE keys */
+#endif
+#ifdef HAVE_PARALLEL_WRITE
+    WritePool*        writePool;         /* record sealing threads, or NULL */
+#endif
+#ifdef HAVE_PARALLEL_VERIFY
+    VerifyPool*       verifyPool;        /* chain signature threads, or NULL */
+#endif
+#ifdef HAVE_ALPN
+    CallbackALPNSelect alpnSelectCb;     /* server picks from client list */
+    void*              alpnSelectCtx;
+#endif
+#ifndef NO_CYASSL_SERVER
+    CallbackClientHello clientHelloCb;   /* sees the hello before it's used */
+#endif
+#if defined(HAVE_SNI) && !defined(NO_CYASSL_SERVER)
+    SNIHost**          sniHosts;         /* virtual hosts by server name */
+    word32             sniHostBuckets;   /* power of 2 */
+    word32             sniHostCount;
+    CallbackServerName sniCb;            /* sees the name after the table */
+    void*              sniCbCtx;
+#endif
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_SERVER)
+    OcspId            stapleId;          /* id of our cert's OCSP status */
+    byte              stapleOn;          /* staple it when asked */
+#endif
 #ifdef ATOMIC_USER
     CallbackMacEncrypt    MacEncryptCb;    /* Atomic User Mac/Encrypt Cb */
     CallbackDecryptVerify DecryptVerifyCb; /* Atomic User Decrypt/Verify Cb */
 #endif
+#ifdef CYASSL_ASYNC_CRYPT
+    CallbackAsyncSubmit AsyncSubmitCb;  /* hands private key ops out */
+#endif
+#ifdef CYASSL_HANDSHAKE_TIMING
+    CyaSSL_HsTimingCb hsTimingCb;       /* sampled handshake timings */
+    void*             hsTimingCtx;
+    word32            hsTimingRate;     /* time one in this many */
+    word32            hsTimingCount;    /* handshakes started, countMutex */
+#endif
 #ifdef HAVE_PK_CALLBACKS
     #ifdef HAVE_ECC
         CallbackEccSign   EccSignCb;    /* User EccSign   Callback handler */
@@ -1510,6 +2376,16 @@ CYASSL_LOCAL
 void FreeSSL_Ctx(CYASSL_CTX*);
 CYASSL_LOCAL
 void SSL_CtxResourceFree(CYASSL_CTX*);
+CYASSL_LOCAL
+int SSL_CtxUpRef(CYASSL_CTX*);
+CYASSL_LOCAL
+CYASSL_CTX* SSL_CtxRotated(CYASSL_CTX*);
+CYASSL_LOCAL
+int SSL_CtxSetRotated(CYASSL_CTX*, CYASSL_CTX*);
+CYASSL_LOCAL
+int SSL_CtxAdmitHandshake(CYASSL*);
+CYASSL_LOCAL
+void SSL_CtxReleaseHandshake(CYASSL*);
 
 CYASSL_LOCAL
 int DeriveTlsKeys(CYASSL* ssl);
@@ -1521,6 +2397,12 @@ int ProcessOldClientHello(CYASSL* ssl, const byte* input, word32* inOutIdx,
     int AddCA(CYASSL_CERT_MANAGER* ctx, buffer der, int type, int verify);
     CYASSL_LOCAL
     int AlreadySigner(CYASSL_CERT_MANAGER* cm, byte* hash);
+    CYASSL_LOCAL
+    void CacheCtxPrivateKey(CYASSL_CTX* ctx, int eccSlot);
+    #ifndef NO_DH
+        CYASSL_LOCAL
+        void CacheCtxDhParams(CYASSL_CTX* ctx);
+    #endif
 #endif
 
 /* All cipher suite related info */
@@ -1619,11 +2501,53 @@ enum ClientCertificateType {
 enum CipherType { stream, block, aead };
 
 
+/* --enable-suites builds whose suites share one bulk cipher fix it at
+   compile time, the record layer switches fold to a direct call and
+   SetCipherSpecs() refuses any other suite */
+#if defined(CYASSL_RECORD_AESGCM)
+    #define CYASSL_RECORD_BULK  cyassl_aes_gcm
+    #define CYASSL_RECORD_TYPE  aead
+#elif defined(CYASSL_RECORD_AESCCM)
+    #define CYASSL_RECORD_BULK  cyassl_aes_ccm
+    #define CYASSL_RECORD_TYPE  aead
+#elif defined(CYASSL_RECORD_CHACHA)
+    #define CYASSL_RECORD_BULK  cyassl_chacha
+    #define CYASSL_RECORD_TYPE  aead
+#elif defined(CYASSL_RECORD_AESCBC)
+    #define CYASSL_RECORD_BULK  cyassl_aes
+    #define CYASSL_RECORD_TYPE  block
+#elif defined(CYASSL_RECORD_DES3)
+    #define CYASSL_RECORD_BULK  cyassl_triple_des
+    #define CYASSL_RECORD_TYPE  block
+#elif defined(CYASSL_RECORD_RC4)
+    #define CYASSL_RECORD_BULK  cyassl_rc4
+    #define CYASSL_RECORD_TYPE  stream
+#endif
+
+/* only for records under negotiated keys */
+#ifdef CYASSL_RECORD_BULK
+    #define RECORD_BULK(ssl)  CYASSL_RECORD_BULK
+    #define RECORD_TYPE(ssl)  CYASSL_RECORD_TYPE
+#else
+    #define RECORD_BULK(ssl)  ((ssl)->specs.bulk_cipher_algorithm)
+    #define RECORD_TYPE(ssl)  ((ssl)->specs.cipher_type)
+#endif
+
+/* RFC 7366 only changes block records, stream and aead ones ignore the flag */
+#ifdef HAVE_ENCRYPT_THEN_MAC
+    #define RECORD_ETM(ssl)   ((ssl)->encrypt_then_mac && \
+                               RECORD_TYPE(ssl) == block)
+#endif
+
+
 
 
 
 
 /* cipher for now */
+/* record encrypt or decrypt, out/in/sz as Encrypt() and Decrypt() */
+typedef int (*cipherfp)(CYASSL*, byte*, const byte*, word16);
+
 typedef struct Ciphers {
 #ifdef BUILD_ARC4
     Arc4*   arc4;
@@ -1646,6 +2570,7 @@ typedef struct Ciphers {
 #ifdef BUILD_RABBIT
     Rabbit* rabbit;
 #endif
+    cipherfp process;    /* this side's record function, set with keys */
     byte    setup;       /* have we set it up flag for detection */
 } Ciphers;
 
@@ -1664,6 +2589,7 @@ typedef struct OneTimeAuth {
 
 CYASSL_LOCAL void InitCiphers(CYASSL* ssl);
 CYASSL_LOCAL void FreeCiphers(CYASSL* ssl);
+CYASSL_LOCAL void SetCipherFuncs(Ciphers* enc, Ciphers* dec, int bulk);
 
 
 /* hashes type */
@@ -1681,6 +2607,41 @@ typedef struct Hashes {
 } Hashes;
 
 
+/* handshake hashes a connection keeps running, HS_Hashes hashMask */
+enum HsHashBits {
+    HS_HASH_MD5    = 0x01,
+    HS_HASH_SHA    = 0x02,
+    HS_HASH_SHA256 = 0x04,
+    HS_HASH_SHA384 = 0x08,
+    HS_HASH_ALL    = 0x0f
+};
+
+
+/* running handshake hashes, only needed until the handshake is done */
+typedef struct HS_Hashes {
+#ifndef NO_OLD_TLS
+#ifndef NO_SHA
+    Sha             hashSha;            /* sha hash of handshake msgs */
+#endif
+#ifndef NO_MD5
+    Md5             hashMd5;            /* md5 hash of handshake msgs */
+#endif
+#endif
+#ifndef NO_SHA256
+    Sha256          hashSha256;         /* sha256 hash of handshake msgs */
+#endif
+#ifdef CYASSL_SHA384
+    Sha384          hashSha384;         /* sha384 hash of handshake msgs */
+#endif
+    Hashes          verifyHashes;
+    Hashes          certHashes;         /* for cert verify */
+    byte*           transcript;         /* messages before hashes are known */
+    word32          transcriptSz;
+    word32          transcriptMax;
+    byte            hashMask;           /* HsHashBits running, 0 buffers */
+} HS_Hashes;
+
+
 /* Static x509 buffer */
 typedef struct x509_buffer {
     int  length;                  /* actual size */
@@ -1702,6 +2663,7 @@ struct CYASSL_SESSION {
     byte         masterSecret[SECRET_LEN];      /* stored secret */
     word32       bornOn;                        /* create time in seconds   */
     word32       timeout;                       /* timeout in seconds       */
+    byte         isAlloced;                     /* from d2i, SESSION_free it */
 #ifdef SESSION_CERTS
     CYASSL_X509_CHAIN chain;                    /* peer cert chain, static  */
     ProtocolVersion version;                    /* which version was used */
@@ -1754,10 +2716,12 @@ enum AcceptState {
     ACCEPT_FIRST_REPLY_DONE,
     SERVER_HELLO_SENT,
     CERT_SENT,
+    CERT_STATUS_SENT,
     KEY_EXCHANGE_SENT,
     CERT_REQ_SENT,
     SERVER_HELLO_DONE,
     ACCEPT_SECOND_REPLY_DONE,
+    TICKET_SENT,
     CHANGE_CIPHER_SENT,
     ACCEPT_FINISHED_DONE,
     ACCEPT_THIRD_REPLY_DONE
@@ -1779,10 +2743,28 @@ typedef struct Buffers {
     bufferStatic    inputBuffer;
     bufferStatic    outputBuffer;
     buffer          clearOutputBuffer;
+#ifdef HAVE_SECURE_RENEGOTIATION
+    buffer          renegData;             /* app data read while
+                                              renegotiating, length is size */
+#endif
     int             prevSent;              /* previous plain text bytes sent
                                               when got WANT_WRITE            */
     int             plainSz;               /* plain text bytes in buffer to send
                                               when got WANT_WRITE            */
+    word32          writeCoalesce;         /* batch app data records up to
+                                              this many bytes per send, 0 off */
+    word32          readAhead;             /* fill an input buffer this big
+                                              per recv, not one record, 0 off*/
+    word32          dynRecordSz;           /* record plaintext size at start
+                                              and after idle, 0 off        */
+    word32          dynRecordRamp;         /* app bytes sent in small records
+                                              before going full size       */
+    word32          dynRecordIdle;         /* seconds quiet that go small  */
+    word32          dynRecordSent;         /* app bytes since last reset   */
+    word32          dynRecordLast;         /* LowResTimer() of last write  */
+    byte*           memOut;                /* memory IO records not taken */
+    word32          memOutSz;              /* memOut allocation size       */
+    word32          memOutLen;             /* bytes waiting in memOut      */
     byte            weOwnCert;             /* SSL own cert flag */
     byte            weOwnCertChain;        /* SSL own cert chain flag */
     byte            weOwnKey;              /* SSL own key  flag */
@@ -1809,6 +2791,11 @@ typedef struct Options {
     byte            clientState;
     byte            handShakeState;
     byte            handShakeDone;      /* at least one handshake complete */
+    byte            helloCbPending;     /* ClientHello callback suspended, the
+                                           hello was checked and hashed */
+    byte            hsAdmitted;         /* holds one of ctx's hsInFlight */
+    byte            memIO;              /* app feeds input and takes output,
+                                           no IO callbacks */
     byte            side;               /* client or server end */
     byte            verifyPeer;
     byte            verifyNone;
@@ -1821,6 +2808,7 @@ typedef struct Options {
     byte            tls;                /* using TLS ? */
     byte            tls1_1;             /* using TLSv1.1+ ? */
     byte            dtls;               /* using datagrams ? */
+    byte            dtlsHelloVerified;  /* cookie checked by dtls_listen */
     byte            connReset;          /* has the peer reset */
     byte            isClosed;           /* if we consider conn closed */
     byte            closeNotify;        /* we've recieved a close notify */
@@ -1834,6 +2822,7 @@ typedef struct Options {
     byte            haveNTRU;           /* server NTRU  private key loaded */
     byte            haveECDSAsig;       /* server ECDSA signed cert */
     byte            haveStaticECC;      /* static server ECC private key */
+    byte            haveDualCert;       /* RSA and ECDSA certs, pick per suite */
     byte            havePeerCert;       /* do we have peer's cert */
     byte            havePeerVerify;     /* and peer's cert verify */
     byte            usingPSK_cipher;    /* whether we're using psk as cipher */
@@ -1844,12 +2833,27 @@ typedef struct Options {
     byte            quietShutdown;      /* don't send close notify */
     byte            certOnly;           /* stop once we get cert */
     byte            groupMessages;      /* group handshake messages */
+    byte            moreToSend;         /* rest of the flight follows send */
+    byte            compact;            /* shed handshake leftovers once done */
+    byte            falseStart;         /* allowed to write before peer Fin */
+    byte            falseStarted;       /* wrote early, peer Fin still due */
     byte            usingNonblock;      /* set when using nonblocking socket */
     byte            saveArrays;         /* save array Memory for user get keys
                                            or psk */
 #ifdef HAVE_POLY1305
     byte            oldPoly;            /* set when to use old rfc way of poly*/
 #endif
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    byte            createTicket;       /* send client a NewSessionTicket */
+    byte            useTicket;          /* resuming from client's ticket */
+#endif
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+    byte            statusRequest;      /* server agreed to staple OCSP */
+#endif
+#ifdef CYASSL_KTLS
+    byte            ktlsTx;             /* kernel encrypts app data we send */
+    byte            ktlsRx;             /* kernel decrypts app data we read */
+#endif
 #ifndef NO_PSK
     byte            havePSK;            /* psk key set by user */
     psk_client_callback client_psk_cb;
@@ -1878,6 +2882,9 @@ typedef struct Arrays {
     word32          psk_keySz;          /* acutal size */
 #endif
     word32          preMasterSz;        /* differs for DH, actual size */
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    byte            ticketSuite[SUITE_LEN]; /* suite the ticket was for */
+#endif
 } Arrays;
 
 #ifndef ASN_NAME_MAX
@@ -1988,12 +2995,23 @@ typedef struct DtlsPool {
     int             used;
 } DtlsPool;
 
+/* most bytes of early handshake messages held per connection */
+#ifndef DTLS_MSG_MEM_MAX
+    #define DTLS_MSG_MEM_MAX (8 * MAX_RECORD_SIZE)
+#endif
+
+typedef struct DtlsFrag {
+    struct DtlsFrag* next;
+    word32           begin;    /* Offset of first byte received */
+    word32           end;      /* Offset past last byte         */
+} DtlsFrag;
+
 typedef struct DtlsMsg {
-    struct DtlsMsg* next;
     word32          seq;       /* Handshake sequence number    */
     word32          sz;        /* Length of whole mesage       */
-    word32          fragSz;    /* Length of fragments received */
+    word32          fragSz;    /* Bytes covered by fragList    */
     byte            type;
+    DtlsFrag*       fragList;  /* Sorted, disjoint byte ranges */
     byte*           buf;
     byte*           msg;
 } DtlsMsg;
@@ -2020,6 +3038,7 @@ typedef struct MsgsReceived {
     word16 got_hello_verify_request:1;
     word16 got_session_ticket:1;
     word16 got_certificate:1;
+    word16 got_certificate_status:1;
     word16 got_server_key_exchange:1;
     word16 got_certificate_request:1;
     word16 got_server_hello_done:1;
@@ -2030,6 +3049,71 @@ typedef struct MsgsReceived {
 } MsgsReceived;
 
 
+#ifdef CYASSL_HANDSHAKE_ARENA
+
+#ifndef HS_ARENA_EXTRA_SZ
+    #define HS_ARENA_EXTRA_SZ 0     /* room beyond the InitSSL objects */
+#endif
+#define HS_ARENA_ALIGN 16
+
+/* One block holding the handshake scoped objects, bump allocated. Frees
+ * inside it only count down, the block goes when the last one is freed */
+typedef struct HsArena {
+    byte*  block;
+    word32 size;
+    word32 used;
+    word32 last;        /* offset of the newest object, freeing it rewinds */
+    word32 live;        /* objects still in the block */
+} HsArena;
+
+CYASSL_LOCAL void* HsAlloc(CYASSL* ssl, word32 sz, int type);
+CYASSL_LOCAL void  HsFree(CYASSL* ssl, void* ptr, int type);
+
+#else
+
+#define HsAlloc(ssl, sz, t) XMALLOC((sz), (ssl)->heap, (t))
+#define HsFree(ssl, p, t)   XFREE((p), (ssl)->heap, (t))
+
+#endif /* CYASSL_HANDSHAKE_ARENA */
+
+
+#ifdef CYASSL_HANDSHAKE_TIMING
+
+/* A sampled handshake's events. Only the outermost of nested opens of one
+ * kind is timed, so a kind's time is never counted twice */
+typedef struct HsTimer {
+    CyaSSL_HsTiming timing;
+    word32          base;                       /* usecs at the start */
+    word32          start[CYASSL_HS_KINDS];     /* of the open event */
+    byte            depth[CYASSL_HS_KINDS];
+} HsTimer;
+
+CYASSL_LOCAL void HsTimingBegin(CYASSL* ssl);
+CYASSL_LOCAL void HsTimingDone(CYASSL* ssl);
+CYASSL_LOCAL void HsTimingOpen(CYASSL* ssl, int kind);
+CYASSL_LOCAL void HsTimingClose(CYASSL* ssl, int kind, int id);
+CYASSL_LOCAL void HsTimingMark(CYASSL* ssl, int state);
+
+#define HS_TIMING_BEGIN(ssl) HsTimingBegin(ssl)
+#define HS_TIMING_DONE(ssl)  HsTimingDone(ssl)
+#define HS_TIMING_OPEN(ssl, kind) \
+    do { if ((ssl)->hsTiming) HsTimingOpen((ssl), (kind)); } while (0)
+#define HS_TIMING_CLOSE(ssl, kind, id) \
+    do { if ((ssl)->hsTiming) HsTimingClose((ssl), (kind), (id)); } while (0)
+#define HS_TIMING_STATE(ssl, state) \
+    do { if ((ssl)->hsTiming) HsTimingMark((ssl), (state)); } while (0)
+
+#else
+
+#define HS_TIMING_BEGIN(ssl)
+#define HS_TIMING_DONE(ssl)
+#define HS_TIMING_OPEN(ssl, kind)
+#define HS_TIMING_CLOSE(ssl, kind, id)
+#define HS_TIMING_STATE(ssl, state)
+
+#endif /* CYASSL_HANDSHAKE_TIMING */
+
+
 /* CyaSSL ssl type */
 struct CYASSL {
     CYASSL_CTX*     ctx;
@@ -2054,25 +3138,13 @@ struct CYASSL {
     void*           IOCB_ReadCtx;
     void*           IOCB_WriteCtx;
     RNG*            rng;
-#ifndef NO_OLD_TLS
-#ifndef NO_SHA
-    Sha             hashSha;            /* sha hash of handshake msgs */
-#endif
-#ifndef NO_MD5
-    Md5             hashMd5;            /* md5 hash of handshake msgs */
-#endif
-#endif
-#ifndef NO_SHA256
-    Sha256          hashSha256;         /* sha256 hash of handshake msgs */
-#endif
-#ifdef CYASSL_SHA384
-    Sha384          hashSha384;         /* sha384 hash of handshake msgs */
-#endif
-    Hashes          verifyHashes;
-    Hashes          certHashes;         /* for cert verify */
+    HS_Hashes*      hsHashes;           /* only need during handshake */
     Buffers         buffers;
     Options         options;
     Arrays*         arrays;
+#ifdef CYASSL_HANDSHAKE_ARENA
+    HsArena         hsArena;            /* suites, keys, handshake temps */
+#endif
     CYASSL_SESSION  session;
     VerifyCallback  verifyCallback;      /* cert verification callback */
     void*           verifyCbCtx;         /* cert verify callback user ctx*/
@@ -2106,21 +3178,31 @@ struct CYASSL {
 #endif
     hmacfp          hmac;
     void*           heap;               /* for user overrides */
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemStats* memStats;          /* what this connection allocates */
+#endif
     RecordLayerHeader curRL;
     word16            curSize;
     word32          timeout;            /* session timeout */
     CYASSL_CIPHER   cipher;
 #ifdef HAVE_LIBZ
-    z_stream        c_stream;           /* compression   stream */
-    z_stream        d_stream;           /* decompression stream */
+    CompressStream  c_stream;           /* compression   stream */
+    CompressStream  d_stream;           /* decompression stream */
     byte            didStreamInit;      /* for stream init and end */
 #endif
 #ifdef CYASSL_DTLS
     int             dtls_timeout_init;  /* starting timeout vaule */
     int             dtls_timeout_max;   /* maximum timeout value */
     int             dtls_timeout;       /* current timeout value, changes */
+    word32          dtls_srtt;          /* smoothed flight rtt, ms */
+    word32          dtls_rttvar;        /* flight rtt variation, ms */
+    word32          dtls_flight_start;  /* LowResTimer() at flight's send */
+    word16          dtls_flight_peer;   /* peer msg seq expected then */
+    byte            dtls_rtt_valid;     /* srtt holds a sample */
+    byte            dtls_flight_timed;  /* no more samples this flight */
     DtlsPool*       dtls_pool;
-    DtlsMsg*        dtls_msg_list;
+    DtlsMsg*        dtls_msg_slots[DTLS_MSG_SLOTS]; /* by seq % slots */
+    word32          dtls_msg_mem;       /* bytes held in the slots */
     void*           IOCB_CookieCtx;     /* gen cookie ctx */
     word32          dtls_expected_rx;
 #endif
@@ -2130,12 +3212,17 @@ struct CYASSL {
     byte            hsInfoOn;           /* track handshake info        */
     byte            toInfoOn;           /* track timeout   info        */
 #endif
+#ifdef CYASSL_HANDSHAKE_TIMING
+    HsTimer*        hsTiming;           /* set while a sampled hs runs */
+    byte            hsTimingPicked;     /* this hs was counted for sampling */
+#endif
 #ifdef HAVE_FUZZER
     CallbackFuzzer  fuzzerCb;           /* for testing with using fuzzer */
     void*           fuzzerCtx;          /* user defined pointer */
 #endif
 #ifdef KEEP_PEER_CERT
     CYASSL_X509     peerCert;           /* X509 peer cert */
+    byte            peerCertLazy;       /* only derCert set, see GetPeerCert */
 #endif
 #ifdef FORTRESS
     void*           ex_data[MAX_EX_DATA]; /* external data, for Fortress */
@@ -2145,12 +3232,23 @@ struct CYASSL {
 #endif
 #ifdef HAVE_TLS_EXTENSIONS
     TLSX* extensions;                  /* RFC 6066 TLS Extensions data */
+    #if defined(HAVE_SUPPORTED_CURVES) && !defined(NO_CYASSL_SERVER)
+        PeerCurves peerCurves;         /* from the client hello */
+    #endif
     #ifdef HAVE_MAX_FRAGMENT
         word16 max_fragment;
     #endif
     #ifdef HAVE_TRUNCATED_HMAC
         byte truncated_hmac;
     #endif
+    #ifdef HAVE_ENCRYPT_THEN_MAC
+        byte encrypt_then_mac;         /* negotiated, block suites only */
+    #endif
+    #ifdef HAVE_CACHED_INFO
+        buffer cached_chain;           /* client, server's certificate_list */
+        byte   cached_keep;            /* client, hold the next chain sent */
+        byte   cached_cert;            /* Certificate carries only a hash */
+    #endif
     #ifdef HAVE_SECURE_RENEGOTIATION
         SecureRenegotiation* secure_renegotiation; /* valid pointer indicates */
     #endif                                         /* user turned on */
@@ -2159,7 +3257,18 @@ struct CYASSL {
         void*                 session_ticket_ctx;
         byte                  expect_session_ticket;
     #endif
+    #ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+        #ifndef NO_CYASSL_SERVER
+            buffer            ocspStaple;  /* response to staple, we own */
+        #endif
+    #endif
 #endif /* HAVE_TLS_EXTENSIONS */
+#ifdef HAVE_OCSP
+    OcspPending*    ocspPending;       /* peer cert check not done yet */
+#endif
+#ifdef HAVE_CONN_POOL
+    ConnPoolUpstream* poolUpstream;    /* pool handing this one out */
+#endif
 #ifdef HAVE_NETX
     NetX_Ctx        nxCtx;             /* NetX IO Context */
 #endif
@@ -2171,6 +3280,13 @@ struct CYASSL {
     void*    MacEncryptCtx;    /* Atomic User Mac/Encrypt Callback Context */
     void*    DecryptVerifyCtx; /* Atomic User Decrypt/Verify Callback Context */
 #endif
+#ifndef NO_CYASSL_SERVER
+    void*    ClientHelloCtx;  /* ClientHello Callback Context */
+#endif
+#ifdef CYASSL_ASYNC_CRYPT
+    CYASSL_ASYNC_OP* async;   /* op out with the executor, made on first use */
+    void*    AsyncSubmitCtx;  /* Async Submit Callback Context */
+#endif
 #ifdef HAVE_PK_CALLBACKS
     #ifdef HAVE_ECC
         void* EccSignCtx;     /* Ecc Sign   Callback Context */
@@ -2193,6 +3309,8 @@ struct CYASSL {
 CYASSL_LOCAL
 int  InitSSL(CYASSL*, CYASSL_CTX*);
 CYASSL_LOCAL
+int  InitHandshakeHashes(CYASSL*);
+CYASSL_LOCAL
 void FreeSSL(CYASSL*);
 CYASSL_API void SSL_ResourceFree(CYASSL*);   /* Micrium uses */
 
@@ -2286,6 +3404,7 @@ enum HandShakeType {
     certificate_verify  = 15, 
     client_key_exchange = 16,
     finished            = 20,
+    certificate_status  = 22,
     change_cipher_hs    = 55      /* simulate unique handshake type for sanity
                                      checks.  record layer change_cipher
                                      conflicts with handshake finished */
@@ -2302,15 +3421,29 @@ static const byte tls_server[FINISHED_LABEL_SZ + 1] = "server finished";
 /* internal functions */
 CYASSL_LOCAL int SendChangeCipher(CYASSL*);
 CYASSL_LOCAL int SendData(CYASSL*, const void*, int);
+CYASSL_LOCAL int SendDataV(CYASSL*, const DataVec*, int);
 CYASSL_LOCAL int SendCertificate(CYASSL*);
 CYASSL_LOCAL int SendCertificateRequest(CYASSL*);
 CYASSL_LOCAL int SendServerKeyExchange(CYASSL*);
 CYASSL_LOCAL int SendBuffered(CYASSL*);
 CYASSL_LOCAL int ReceiveData(CYASSL*, byte*, int, int);
+CYASSL_LOCAL int ReceiveDataView(CYASSL*, const byte**);
+CYASSL_LOCAL int ReleaseDataView(CYASSL*, int);
+CYASSL_LOCAL int GetReadDemand(CYASSL*);
+CYASSL_LOCAL int FeedInputData(CYASSL*, const byte*, word32);
+CYASSL_LOCAL int TakeOutputData(CYASSL*, byte*, word32);
 CYASSL_LOCAL int SendFinished(CYASSL*);
 CYASSL_LOCAL int SendAlert(CYASSL*, int, int);
 CYASSL_LOCAL int ProcessReply(CYASSL*);
 
+#ifdef CYASSL_KTLS
+    CYASSL_LOCAL int EmbedKTLSEnable(CYASSL*, int sd, int tx);
+    CYASSL_LOCAL int EmbedKTLSSend(CYASSL*, int sd, byte type, const byte*,
+                                   int);
+    CYASSL_LOCAL int EmbedKTLSReceive(CYASSL*, int sd, byte*, int, int peek,
+                                      byte* type);
+#endif
+
 CYASSL_LOCAL int SetCipherSpecs(CYASSL*);
 CYASSL_LOCAL int MakeMasterSecret(CYASSL*);
 
@@ -2324,6 +3457,20 @@ CYASSL_LOCAL int IsAtLeastTLSv1_2(const CYASSL* ssl);
 CYASSL_LOCAL void FreeHandshakeResources(CYASSL* ssl);
 CYASSL_LOCAL void ShrinkInputBuffer(CYASSL* ssl, int forcedFree);
 CYASSL_LOCAL void ShrinkOutputBuffer(CYASSL* ssl);
+#ifdef CYASSL_RECORD_POOL
+    CYASSL_LOCAL void FlushRecordPool(void);
+#endif
+#if defined(BUILD_AES) || defined(BUILD_AESGCM)
+    #ifdef CYASSL_CIPHER_POOL
+        CYASSL_LOCAL Aes* GetCipherAes(void* heap);
+        CYASSL_LOCAL void PutCipherAes(Aes* aes, void* heap);
+        CYASSL_LOCAL void FlushCipherPool(void);
+    #else
+        #define GetCipherAes(h) \
+                         ((Aes*)XMALLOC(sizeof(Aes), (h), DYNAMIC_TYPE_CIPHER))
+        #define PutCipherAes(a, h)  XFREE((a), (h), DYNAMIC_TYPE_CIPHER)
+    #endif
+#endif
 
 CYASSL_LOCAL int VerifyClientSuite(CYASSL* ssl);
 #ifndef NO_CERTS
@@ -2331,6 +3478,20 @@ CYASSL_LOCAL int VerifyClientSuite(CYASSL* ssl);
     #ifndef NO_SKID
         CYASSL_LOCAL Signer* GetCAByName(void* cm, byte* hash);
     #endif
+    CYASSL_LOCAL void*   GetCAKey(void* cm, Signer* ca);
+    #ifdef HAVE_VERIFY_CACHE
+        CYASSL_LOCAL int  VerifyCacheFind(void* cm, const byte* der,
+                                       word32 derSz, Signer* ca, byte* hash);
+        CYASSL_LOCAL void VerifyCacheAdd(void* cm, const byte* hash,
+                                         Signer* ca);
+        #ifdef HAVE_DATE_EPOCH
+            CYASSL_LOCAL int  VerifyCacheChainFind(void* cm, const byte* der,
+                                                   word32 derSz);
+            CYASSL_LOCAL void VerifyCacheChainAdd(void* cm, const byte* der,
+                                                  word32 derSz, byte* keyHash,
+                                                  word64 notAfter);
+        #endif
+    #endif
 #endif
 CYASSL_LOCAL int  BuildTlsFinished(CYASSL* ssl, Hashes* hashes,
                                    const byte* sender);
@@ -2342,6 +3503,7 @@ CYASSL_LOCAL  int GrowInputBuffer(CYASSL* ssl, int size, int usedLength);
     CYASSL_LOCAL int  MakeTlsMasterSecret(CYASSL*);
     CYASSL_LOCAL int  TLS_hmac(CYASSL* ssl, byte* digest, const byte* in,
                                word32 sz, int content, int verify);
+    CYASSL_LOCAL int  TLS_hmacKey(CYASSL* ssl, Hmac* hmac, int verify);
 #endif
 
 #ifndef NO_CYASSL_CLIENT
@@ -2353,8 +3515,12 @@ CYASSL_LOCAL  int GrowInputBuffer(CYASSL* ssl, int size, int usedLength);
 #ifndef NO_CYASSL_SERVER
     CYASSL_LOCAL int SendServerHello(CYASSL*);
     CYASSL_LOCAL int SendServerHelloDone(CYASSL*);
+    CYASSL_LOCAL int SetSSL_CTX(CYASSL*, CYASSL_CTX*);
     #ifdef CYASSL_DTLS
         CYASSL_LOCAL int SendHelloVerifyRequest(CYASSL*);
+        CYASSL_LOCAL int DtlsListen(CYASSL_CTX*, const byte*, word32,
+                                    const byte*, word32, byte*, word32*);
+        CYASSL_LOCAL int DtlsAcceptHello(CYASSL*, const byte*, word32);
     #endif
 #endif /* NO_CYASSL_SERVER */
 
@@ -2367,13 +3533,13 @@ CYASSL_LOCAL  int GrowInputBuffer(CYASSL* ssl, int size, int usedLength);
 
     CYASSL_LOCAL DtlsMsg* DtlsMsgNew(word32, void*);
     CYASSL_LOCAL void DtlsMsgDelete(DtlsMsg*, void*);
-    CYASSL_LOCAL void DtlsMsgListDelete(DtlsMsg*, void*);
-    CYASSL_LOCAL void DtlsMsgSet(DtlsMsg*, word32, const byte*, byte,
-                                                             word32, word32);
-    CYASSL_LOCAL DtlsMsg* DtlsMsgFind(DtlsMsg*, word32);
-    CYASSL_LOCAL DtlsMsg* DtlsMsgStore(DtlsMsg*, word32, const byte*, word32,
-                                                byte, word32, word32, void*);
-    CYASSL_LOCAL DtlsMsg* DtlsMsgInsert(DtlsMsg*, DtlsMsg*);
+    CYASSL_LOCAL void DtlsMsgListDelete(CYASSL*);
+    CYASSL_LOCAL int  DtlsMsgSet(DtlsMsg*, const byte*, word32, word32,
+                                                                     void*);
+    CYASSL_LOCAL DtlsMsg* DtlsMsgFind(CYASSL*, word32);
+    CYASSL_LOCAL void DtlsMsgRemove(CYASSL*, word32);
+    CYASSL_LOCAL int  DtlsMsgStore(CYASSL*, word32, const byte*, word32,
+                                                     byte, word32, word32);
 #endif /* CYASSL_DTLS */
 
 #ifndef NO_TLS
@@ -2391,6 +3557,9 @@ CYASSL_LOCAL void FreeX509(CYASSL_X509*);
 #ifndef NO_CERTS
     CYASSL_LOCAL int  CopyDecodedToX509(CYASSL_X509*, DecodedCert*);
 #endif
+#ifdef KEEP_PEER_CERT
+    CYASSL_LOCAL CYASSL_X509* GetPeerCert(CYASSL* ssl);
+#endif
 
 /* used by ssl.c and cyassl_int.c */
 CYASSL_LOCAL void c32to24(word32 in, word24 out);
@@ -35,11 +35,21 @@
 #endif
 
 typedef struct CYASSL_OCSP CYASSL_OCSP;
+typedef struct OcspId      OcspId;
 
 CYASSL_LOCAL int  InitOCSP(CYASSL_OCSP*, CYASSL_CERT_MANAGER*);
 CYASSL_LOCAL void FreeOCSP(CYASSL_OCSP*, int dynamic);
 
+CYASSL_LOCAL void SetOcspId(OcspId*, DecodedCert*);
 CYASSL_LOCAL int  CheckCertOCSP(CYASSL_OCSP*, DecodedCert*);
+CYASSL_LOCAL int  CheckIdOCSP(CYASSL_OCSP*, const OcspId*, const char* url,
+                              int urlSz);
+CYASSL_LOCAL int  CheckStapleOCSP(CYASSL_OCSP*, const OcspId*, byte* resp,
+                                  word32 respSz, const char* url, int urlSz);
+CYASSL_LOCAL int  SetStapleOCSP(CYASSL_OCSP*, DecodedCert*, OcspId* id);
+CYASSL_LOCAL int  GetStapleOCSP(CYASSL_OCSP*, const OcspId*, byte** resp,
+                                word32* respSz, void* heap);
+CYASSL_LOCAL int  StartOCSP_Refresh(CYASSL_OCSP*);
 
 #ifdef __cplusplus
     }  /* extern "C" */
@@ -56,10 +56,113 @@ CYASSL_API
 SSL_SNIFFER_API int ssl_DecodePacket(const unsigned char* packet, int length,
                                      unsigned char* data, char* error);
 
+/* A captured IP/TCP packet for the batch calls, e.g. a ring slot */
+typedef struct SSLSnifferPacket {
+    const unsigned char* packet;
+    int                  length;
+} SSLSnifferPacket;
+
+/* Batch decoded data, data points into the sniffer's buffer and is only */
+/* good until return. flowCtx is the user's per flow pointer, starts NULL. */
+/* Called with data NULL and length 0 when the flow goes away */
+typedef void (*SSLSnifferDataCb)(const unsigned char* data, int length,
+                                 int fromServer, void** flowCtx, void* ctx);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_DecodePacketBatch(const SSLSnifferPacket* packets,
+                                          int count, SSLSnifferDataCb cb,
+                                          void* ctx, char* error);
+
 CYASSL_API 
 SSL_SNIFFER_API int ssl_Trace(const char* traceFile, char* error);
+
+/* Sharded decoding: ssl_GetPacketShard() picks the worker for a packet, */
+/* both directions of a connection go to the same one, and that worker */
+/* alone calls ssl_DecodeShardPacket() for it, no lock on that path */
+CYASSL_API
+SSL_SNIFFER_API int ssl_SetShards(int count, char* error);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_GetPacketShard(const unsigned char* packet,
+                                       int length);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_DecodeShardPacket(int shard,
+                                          const unsigned char* packet,
+                                          int length, unsigned char* data,
+                                          char* error);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_DecodeShardPacketBatch(int shard,
+                                          const SSLSnifferPacket* packets,
+                                          int count, SSLSnifferDataCb cb,
+                                          void* ctx, char* error);
         
         
+/* Session sharing between sniffer instances: id is the SSL session ID, or */
+/* for session tickets the ticket's trailing ID bytes, and is what a later */
+/* resumption on any instance looks up. The callback sees each new session */
+/* once its handshake completes, hand it to ssl_ImportSession() elsewhere */
+typedef void (*SSLSnifferSessionCb)(const char* address, int port,
+                                    const unsigned char* id, int idSz,
+                                    const unsigned char* masterSecret,
+                                    int secretSz, void* ctx);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_SetSessionCb(SSLSnifferSessionCb cb, void* ctx,
+                                     char* error);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_ExportSession(const char* address, int port,
+                                      const unsigned char* id, int idSz,
+                                      unsigned char* masterSecret,
+                                      int* secretSz, char* error);
+
+CYASSL_API
+SSL_SNIFFER_API int ssl_ImportSession(const char* address, int port,
+                                      const unsigned char* id, int idSz,
+                                      const unsigned char* masterSecret,
+                                      int secretSz, char* error);
+
+
+/* RSA premaster decrypts off the decoding threads: threads workers take */
+/* the ClientKeyExchanges, each flow's later input is held until its keys */
+/* are set. The held input is decoded by the flow's next packet or by */
+/* ssl_PollDecrypts() on its Session Table (shard -1 for the one of */
+/* ssl_DecodePacket(), only when a single thread decodes it), that data */
+/* goes to the flow's batch callback or else cb. threads 0 stops them */
+CYASSL_API
+SSL_SNIFFER_API int ssl_SetDecryptWorkers(int threads, SSLSnifferDataCb cb,
+                                          void* ctx, char* error);
+
+/* returns flows resumed, -1 on error */
+CYASSL_API
+SSL_SNIFFER_API int ssl_PollDecrypts(int shard, char* error);
+
+
+/* Counters kept without tracing, totals since ssl_InitSniffer() across */
+/* all Session Tables, diff two reads for rates */
+#define SSL_SNIFFER_MAX_ERRORS 96   /* sniffer_error.h codes counted */
+
+typedef struct SSLStats {
+    unsigned long packets;          /* packets passed in */
+    unsigned long packetBytes;      /* their total length */
+    unsigned long decodedBytes;     /* application data decrypted */
+    unsigned long sessions;         /* sessions created */
+    unsigned long resumedSessions;  /* of those, resumed handshakes */
+    unsigned long activeSessions;   /* in the Session Tables now */
+    unsigned long reassemblyBytes;  /* out of order data held now */
+    double        handshakeSecs;    /* time in handshake processing */
+    double        decryptSecs;      /* time decrypting records */
+    unsigned long premasterHits;    /* RSA decrypts saved by the cache */
+    unsigned long errors[SSL_SNIFFER_MAX_ERRORS]; /* by error code */
+} SSLStats;
+
+/* Worker table counts are read while they run, so may lag a little */
+CYASSL_API
+SSL_SNIFFER_API int ssl_ReadStatistics(SSLStats* stats);
+
+
 CYASSL_API void ssl_InitSniffer(void);
         
 CYASSL_API void ssl_FreeSniffer(void);
@@ -105,7 +105,16 @@
 
 #define DECRYPT_KEYS_NOT_SETUP 71
 #define CLIENT_HELLO_LATE_KEY_STR 72
+#define SHARDS_RUNNING_STR 73
+#define BAD_SHARD_STR 74
+#define REASSEMBLY_MAX_STR 75
+
+#define SESSION_NOT_FOUND_STR 76
+#define BAD_SESSION_IMPORT_STR 77
+#define PENDING_MAX_STR 78
+#define DECRYPT_WORKERS_STR 79
 /* !!!! also add to msgTable in sniffer.c and .rc file !!!! */
+/* !!!! and keep below SSL_SNIFFER_MAX_ERRORS in sniffer.h !!!! */
 
 
 #endif /* CyaSSL_SNIFFER_ERROR_H */
@@ -172,7 +172,8 @@ enum AlertDescription {
     decrypt_error           = 51,
     protocol_version        = 70,
     no_renegotiation        = 100,
-    unrecognized_name       = 112
+    unrecognized_name       = 112,
+    no_application_protocol = 120
 };
 
 
@@ -246,6 +247,16 @@ CYASSL_API int  CyaSSL_connect(CYASSL*);     /* please see note at top of README
 CYASSL_API int  CyaSSL_write(CYASSL*, const void*, int);
 CYASSL_API int  CyaSSL_read(CYASSL*, void*, int);
 CYASSL_API int  CyaSSL_peek(CYASSL*, void*, int);
+CYASSL_API int  CyaSSL_read_zc(CYASSL*, const unsigned char**);
+CYASSL_API int  CyaSSL_read_zc_release(CYASSL*, int);
+CYASSL_API int  CyaSSL_read_all(CYASSL*, void*, int);
+CYASSL_API int  CyaSSL_get_read_demand(CYASSL*);
+/* memory IO, no recv or send callbacks, feed what the network delivered and
+   take what's to be sent in as large chunks as there are */
+CYASSL_API int  CyaSSL_SetMemIO(CYASSL*);
+CYASSL_API int  CyaSSL_feed_input(CYASSL*, const unsigned char*, int);
+CYASSL_API int  CyaSSL_take_output(CYASSL*, unsigned char*, int);
+CYASSL_API int  CyaSSL_pending_output(CYASSL*);
 CYASSL_API int  CyaSSL_accept(CYASSL*);
 CYASSL_API void CyaSSL_CTX_free(CYASSL_CTX*);
 CYASSL_API void CyaSSL_free(CYASSL*);
@@ -295,6 +306,17 @@ typedef int (*SessionSecretCb)(CYASSL* ssl,
 CYASSL_API int  CyaSSL_set_session_secret_cb(CYASSL*, SessionSecretCb, void*);
 #endif /* HAVE_SECRET_CALLBACK */
 
+/* session cache runtime sizing, global cache shared by CTXs without their
+   own private cache */
+CYASSL_API int  CyaSSL_set_session_cache_size(int);
+CYASSL_API int  CyaSSL_get_session_cache_size(void);
+CYASSL_API int  CyaSSL_CTX_set_session_cache_size(CYASSL_CTX*, int);
+CYASSL_API int  CyaSSL_CTX_get_session_cache_size(CYASSL_CTX*);
+#ifdef HAVE_SHARED_SESSION_CACHE
+/* global cache in shared memory, call before forking prefork workers */
+CYASSL_API int  CyaSSL_set_shared_session_cache(int);
+#endif
+
 /* session cache persistence */
 CYASSL_API int  CyaSSL_save_session_cache(const char*);
 CYASSL_API int  CyaSSL_restore_session_cache(const char*);
@@ -302,6 +324,13 @@ CYASSL_API int  CyaSSL_memsave_session_cache(void*, int);
 CYASSL_API int  CyaSSL_memrestore_session_cache(const void*, int);
 CYASSL_API int  CyaSSL_get_session_cache_memsize(void);
 
+/* append only journal of global session cache adds, written and compacted
+   by a background thread instead of a locked snapshot. Restore it before
+   starting, CyaSSL_Cleanup() stops it */
+CYASSL_API int  CyaSSL_start_session_journal(const char*);
+CYASSL_API int  CyaSSL_stop_session_journal(void);
+CYASSL_API int  CyaSSL_restore_session_journal(const char*);
+
 /* certificate cache persistence, uses ctx since certs are per ctx */
 CYASSL_API int  CyaSSL_CTX_save_cert_cache(CYASSL_CTX*, const char*);
 CYASSL_API int  CyaSSL_CTX_restore_cert_cache(CYASSL_CTX*, const char*);
@@ -309,6 +338,11 @@ CYASSL_API int  CyaSSL_CTX_memsave_cert_cache(CYASSL_CTX*, void*, int, int*);
 CYASSL_API int  CyaSSL_CTX_memrestore_cert_cache(CYASSL_CTX*, const void*, int);
 CYASSL_API int  CyaSSL_CTX_get_cert_cache_memsize(CYASSL_CTX*);
 
+/* precompiled trust store, a signer table image lookups use in place */
+CYASSL_API int  CyaSSL_CTX_save_trust_store(CYASSL_CTX*, const char*);
+CYASSL_API int  CyaSSL_CTX_load_trust_store(CYASSL_CTX*, const char*);
+CYASSL_API int  CyaSSL_CTX_memload_trust_store(CYASSL_CTX*, const void*, int);
+
 /* only supports full name from cipher_name[] delimited by : */
 CYASSL_API int  CyaSSL_CTX_set_cipher_list(CYASSL_CTX*, const char*);
 CYASSL_API int  CyaSSL_set_cipher_list(CYASSL*, const char*);
@@ -323,6 +357,16 @@ CYASSL_API int  CyaSSL_dtls(CYASSL* ssl);
 CYASSL_API int  CyaSSL_dtls_set_peer(CYASSL*, void*, unsigned int);
 CYASSL_API int  CyaSSL_dtls_get_peer(CYASSL*, void*, unsigned int*);
 
+/* Stateless DTLS listening, no CYASSL exists for a peer until its ClientHello
+   comes back with a cookie made from the CTX secret */
+CYASSL_API int  CyaSSL_CTX_dtls_set_cookie_secret(CYASSL_CTX*,
+                                          const unsigned char*, unsigned int);
+CYASSL_API int  CyaSSL_CTX_dtls_listen(CYASSL_CTX*, const unsigned char*,
+                                       unsigned int, const void*, unsigned int,
+                                       unsigned char*, unsigned int*);
+CYASSL_API int  CyaSSL_dtls_accept_hello(CYASSL*, const unsigned char*,
+                                         unsigned int);
+
 CYASSL_API int   CyaSSL_ERR_GET_REASON(int err);
 CYASSL_API char* CyaSSL_ERR_error_string(unsigned long,char*);
 CYASSL_API void  CyaSSL_ERR_error_string_n(unsigned long e, char* buf,
@@ -561,8 +605,11 @@ enum {
 
     CYASSL_OCSP_URL_OVERRIDE = 1,
     CYASSL_OCSP_NO_NONCE     = 2,
+    CYASSL_OCSP_REFRESH      = 4,
+    CYASSL_OCSP_NONBLOCK     = 8,
 
     CYASSL_CRL_CHECKALL = 1,
+    CYASSL_CRL_FETCH    = 2,
 
     ASN1_GENERALIZEDTIME = 4,
 
@@ -671,11 +718,15 @@ enum { /* ssl Constants */
     SSL_SESS_CACHE_BOTH               = 33,
     SSL_SESS_CACHE_NO_AUTO_CLEAR      = 34,
     SSL_SESS_CACHE_NO_INTERNAL_LOOKUP = 35,
+    SSL_SESS_CACHE_NO_INTERNAL_STORE  = 36,
+    SSL_SESS_CACHE_NO_INTERNAL        = 37,
 
     SSL_ERROR_WANT_READ        =  2,
     SSL_ERROR_WANT_WRITE       =  3,
     SSL_ERROR_WANT_CONNECT     =  7,
     SSL_ERROR_WANT_ACCEPT      =  8,
+    SSL_ERROR_WANT_ASYNC       =  9,
+    SSL_ERROR_WANT_CLIENT_HELLO = 11,
     SSL_ERROR_SYSCALL          =  5,
     SSL_ERROR_WANT_X509_LOOKUP = 83,
     SSL_ERROR_ZERO_RETURN      =  6,
@@ -714,6 +765,15 @@ enum { /* ssl Constants */
                                                     psk_server_callback);
     CYASSL_API void CyaSSL_set_psk_server_callback(CYASSL*,psk_server_callback);
 
+#ifdef HAVE_PSK_STORE
+    /* built in server identities as "identity:hexkey" lines, # comments,
+       looked up before the server callback. Loading again replaces the
+       whole store while handshakes keep going */
+    CYASSL_API int CyaSSL_CTX_load_psk_store(CYASSL_CTX*, const char* file);
+    CYASSL_API int CyaSSL_CTX_load_psk_store_buffer(CYASSL_CTX*,
+                                             const unsigned char*, long);
+#endif
+
     #define PSK_TYPES_DEFINED
 #endif /* NO_PSK */
 
@@ -801,6 +861,24 @@ CYASSL_API int CyaSSL_Init(void);
 /* call when done to cleanup/free session cache mutex / resources  */
 CYASSL_API int CyaSSL_Cleanup(void);
 
+/* library wide seconds clock for session, ticket and OCSP expiry, from the
+   application's event loop or refreshed by a background thread instead of
+   a clock read per check */
+typedef unsigned int (*CallbackLowResTime)(void* ctx);
+#ifndef USER_TICKS
+CYASSL_API void CyaSSL_SetLowResTimeCb(CallbackLowResTime, void* ctx);
+#endif
+CYASSL_API int  CyaSSL_StartCoarseClock(void);
+CYASSL_API int  CyaSSL_StopCoarseClock(void);
+
+#ifdef CYASSL_MEM_STATS
+/* memory accounting snapshots, see cyassl/ctaocrypt/memory.h, a CTX counts
+   itself and every SSL made from it */
+struct CyaSSL_MemUsage;
+CYASSL_API int CyaSSL_CTX_GetMemUsage(CYASSL_CTX*, struct CyaSSL_MemUsage*);
+CYASSL_API int CyaSSL_GetMemUsage(CYASSL*, struct CyaSSL_MemUsage*);
+#endif
+
 /* turn logging on, only if compiled in */
 CYASSL_API int  CyaSSL_Debugging_ON(void);
 /* turn logging off */
@@ -867,12 +945,21 @@ CYASSL_API int  CyaSSL_connect_cert(CYASSL* ssl);
 
 /* XXX This should be #ifndef NO_DH */
 #ifndef NO_CERTS
+/* RFC 7919 groups for the *_SetTmpDH_NamedGroup() calls, 3072 and 4096 need
+   FP_MAX_BITS 6144 and 8192 with fastmath */
+enum {
+    CYASSL_FFDHE_2048 = 0x0100,
+    CYASSL_FFDHE_3072 = 0x0101,
+    CYASSL_FFDHE_4096 = 0x0102
+};
+
 /* server Diffie-Hellman parameters */
 CYASSL_API int  CyaSSL_SetTmpDH(CYASSL*, const unsigned char* p, int pSz,
                                 const unsigned char* g, int gSz);
 CYASSL_API int  CyaSSL_SetTmpDH_buffer(CYASSL*, const unsigned char* b, long sz,
                                        int format);
 CYASSL_API int  CyaSSL_SetTmpEC_DHE_Sz(CYASSL*, unsigned short);
+CYASSL_API int  CyaSSL_SetTmpDH_NamedGroup(CYASSL*, int group);
 #ifndef NO_FILESYSTEM
     CYASSL_API int  CyaSSL_SetTmpDH_file(CYASSL*, const char* f, int format);
 #endif
@@ -883,6 +970,7 @@ CYASSL_API int  CyaSSL_CTX_SetTmpDH(CYASSL_CTX*, const unsigned char* p,
 CYASSL_API int  CyaSSL_CTX_SetTmpDH_buffer(CYASSL_CTX*, const unsigned char* b,
                                            long sz, int format);
 CYASSL_API int  CyaSSL_CTX_SetTmpEC_DHE_Sz(CYASSL_CTX*, unsigned short);
+CYASSL_API int  CyaSSL_CTX_SetTmpDH_NamedGroup(CYASSL_CTX*, int group);
 
 #ifndef NO_FILESYSTEM
     CYASSL_API int  CyaSSL_CTX_SetTmpDH_file(CYASSL_CTX*, const char* f,
@@ -916,6 +1004,59 @@ CYASSL_API int CyaSSL_make_eap_keys(CYASSL*, void* key, unsigned int len,
     #endif
 #endif
 
+#ifdef CYASSL_KTLS
+    /* kernel TLS offload, after the handshake */
+    enum {
+        CYASSL_KTLS_TX = 0x01,
+        CYASSL_KTLS_RX = 0x02
+    };
+    CYASSL_API int CyaSSL_EnableKTLS(CYASSL*, int flags);
+    CYASSL_API int CyaSSL_GetKTLS(CYASSL*);
+#endif
+
+#ifdef CYASSL_HIBERNATE
+    /* save an established connection's record layer, restore into a new ssl */
+    CYASSL_API int CyaSSL_hibernate(CYASSL*, unsigned char*, unsigned int*);
+    CYASSL_API int CyaSSL_wake(CYASSL*, const unsigned char*, unsigned int);
+#endif
+
+#ifdef CYASSL_HANDSHAKE_TIMING
+    /* handshake phase timing, times in microseconds from the first
+       connect/accept call, crypto events may sit inside each other */
+    enum {
+        CYASSL_HS_STATE  = 0,    /* id is the new connect/accept state */
+        CYASSL_HS_KEYGEN = 1,    /* key exchange math, the rest have the */
+        CYASSL_HS_SIGN   = 2,    /* handshake msg type they're for as id */
+        CYASSL_HS_VERIFY = 3,
+        CYASSL_HS_DECODE = 4,    /* peer certificate chain */
+        CYASSL_HS_PRF    = 5,    /* TLS PRF, id 0 for master and keys */
+        CYASSL_HS_KINDS  = 6,
+
+        CYASSL_HS_MAX_EVENTS = 48
+    };
+
+    typedef struct CyaSSL_HsEvent {
+        unsigned char kind;
+        unsigned char id;
+        unsigned int  start;
+        unsigned int  duration;  /* 0 for CYASSL_HS_STATE */
+    } CyaSSL_HsEvent;
+
+    typedef struct CyaSSL_HsTiming {
+        int            count;
+        int            dropped;  /* events past CYASSL_HS_MAX_EVENTS */
+        CyaSSL_HsEvent events[CYASSL_HS_MAX_EVENTS];
+    } CyaSSL_HsTiming;
+
+    /* called once a sampled handshake finishes, timing is only good until
+       return */
+    typedef void (*CyaSSL_HsTimingCb)(CYASSL*, const CyaSSL_HsTiming*, void*);
+
+    /* time one in sampleRate handshakes, 1 for all, NULL cb turns it off */
+    CYASSL_API int CyaSSL_CTX_SetHsTimingCb(CYASSL_CTX*, CyaSSL_HsTimingCb,
+                                            int sampleRate, void* cbCtx);
+#endif
+
 
 #ifndef NO_CERTS
     /* SSL_CTX versions */
@@ -941,6 +1082,45 @@ CYASSL_API int CyaSSL_make_eap_keys(CYASSL*, void* key, unsigned int len,
 
 CYASSL_API int CyaSSL_CTX_set_group_messages(CYASSL_CTX*);
 CYASSL_API int CyaSSL_set_group_messages(CYASSL*);
+CYASSL_API int CyaSSL_CTX_set_write_coalesce(CYASSL_CTX*, unsigned int);
+CYASSL_API int CyaSSL_set_write_coalesce(CYASSL*, unsigned int);
+CYASSL_API int CyaSSL_CTX_set_read_ahead(CYASSL_CTX*, int);
+CYASSL_API int CyaSSL_set_read_ahead(CYASSL*, int);
+CYASSL_API int CyaSSL_CTX_set_record_sizing(CYASSL_CTX*, unsigned int,
+                                            unsigned int, unsigned int);
+CYASSL_API int CyaSSL_set_record_sizing(CYASSL*, unsigned int, unsigned int,
+                                        unsigned int);
+CYASSL_API int CyaSSL_CTX_set_compact(CYASSL_CTX*);
+#ifdef HAVE_PARALLEL_WRITE
+CYASSL_API int CyaSSL_CTX_SetWriteThreads(CYASSL_CTX*, int threads);
+#endif
+#ifdef HAVE_PARALLEL_VERIFY
+CYASSL_API int CyaSSL_CTX_SetVerifyThreads(CYASSL_CTX*, int threads);
+#endif
+CYASSL_API int CyaSSL_set_compact(CYASSL*);
+CYASSL_API int CyaSSL_CTX_set_false_start(CYASSL_CTX*);
+CYASSL_API int CyaSSL_set_false_start(CYASSL*);
+/* ctx keeps an RSA and an ECC certificate/key, loads go by key type, the
+   server answers with ECDSA when the client offers it */
+CYASSL_API int CyaSSL_CTX_set_dual_cert(CYASSL_CTX*);
+/* certificate rotation, CyaSSL_new(ctx) builds on next from now on so next
+   should be set up like ctx with the new cert, key and CAs. Connections
+   already made keep the context they started with. ctx holds a reference,
+   next can be freed by the caller right away, NULL rotates back to ctx */
+CYASSL_API int CyaSSL_CTX_Rotate(CYASSL_CTX* ctx, CYASSL_CTX* next);
+/* NUMA replicas, CyaSSL_new(ctx) on a thread running on node builds on
+   nodeCtx instead, set up like ctx but loaded from a thread on that node so
+   its certs, keys, CAs and suites are node-local and its reference count
+   and locks stay there. Set before ctx is shared, ctx holds a reference, NULL
+   clears, Linux only, elsewhere ctx is always used */
+CYASSL_API int CyaSSL_CTX_SetNumaNode(CYASSL_CTX* ctx, int node,
+                                      CYASSL_CTX* nodeCtx);
+/* admission control, a server ClientHello that needs a full handshake while
+   max of ctx's are already in flight gets a handshake_failure alert and
+   HANDSHAKE_BUSY_E before any key exchange work, resumptions always go
+   through. 0, the default, is no limit */
+CYASSL_API int CyaSSL_CTX_SetHandshakeLimit(CYASSL_CTX* ctx, int max);
+CYASSL_API int CyaSSL_CTX_GetHandshakesInFlight(CYASSL_CTX* ctx);
 
 /* I/O callbacks */
 typedef int (*CallbackIORecv)(CYASSL *ssl, char *buf, int sz, void *ctx);
@@ -972,6 +1152,7 @@ CYASSL_API void* CyaSSL_GetIOWriteCtx(CYASSL* ssl);
 
 CYASSL_API void CyaSSL_SetIOReadFlags( CYASSL* ssl, int flags);
 CYASSL_API void CyaSSL_SetIOWriteFlags(CYASSL* ssl, int flags);
+CYASSL_API int  CyaSSL_GetIOSendMore(CYASSL* ssl);
 
 
 #ifndef CYASSL_USER_IO
@@ -991,6 +1172,65 @@ CYASSL_API void CyaSSL_SetIOWriteFlags(CYASSL* ssl, int flags);
         CYASSL_API int EmbedGenerateCookie(CYASSL* ssl, unsigned char* buf,
                                            int sz, void*);
     #endif /* CYASSL_DTLS */
+
+    #ifdef HAVE_DTLS_MUX
+        /* One unconnected UDP socket for many DTLS peers. The mux takes over
+           the CTX's I/O callbacks, datagrams are read in batches and queued
+           to the CYASSL added for their source address, sends are queued
+           and go out in batches on CyaSSL_DTLS_MUX_flush(). Remove a CYASSL
+           before freeing it */
+        typedef struct CYASSL_DTLS_MUX CYASSL_DTLS_MUX;
+
+        /* datagram from an address with no CYASSL, the callback can add one
+           for it (e.g. once CyaSSL_CTX_dtls_listen() is happy) and the
+           datagram is queued to it, unless the callback returns non zero
+           to say it used the datagram itself (CyaSSL_dtls_accept_hello()),
+           either way an added CYASSL comes back from CyaSSL_DTLS_MUX_ready()
+           */
+        typedef int (*CallbackDtlsMuxNewPeer)(CYASSL_DTLS_MUX* mux,
+                              const unsigned char* in, unsigned int inSz,
+                              const void* peer, unsigned int peerSz, void* ctx);
+
+        CYASSL_API CYASSL_DTLS_MUX* CyaSSL_DTLS_MUX_new(CYASSL_CTX*, int fd);
+        CYASSL_API void    CyaSSL_DTLS_MUX_free(CYASSL_DTLS_MUX*);
+        CYASSL_API void    CyaSSL_DTLS_MUX_SetNewPeerCb(CYASSL_DTLS_MUX*,
+                                              CallbackDtlsMuxNewPeer, void*);
+        CYASSL_API int     CyaSSL_DTLS_MUX_add(CYASSL_DTLS_MUX*, CYASSL*);
+        CYASSL_API int     CyaSSL_DTLS_MUX_remove(CYASSL_DTLS_MUX*, CYASSL*);
+        CYASSL_API CYASSL* CyaSSL_DTLS_MUX_find(CYASSL_DTLS_MUX*,
+                                                const void*, unsigned int);
+        CYASSL_API int     CyaSSL_DTLS_MUX_recv(CYASSL_DTLS_MUX*);
+        CYASSL_API CYASSL* CyaSSL_DTLS_MUX_ready(CYASSL_DTLS_MUX*);
+        CYASSL_API int     CyaSSL_DTLS_MUX_sendto(CYASSL_DTLS_MUX*,
+                                   const unsigned char*, unsigned int,
+                                   const void*, unsigned int);
+        CYASSL_API int     CyaSSL_DTLS_MUX_flush(CYASSL_DTLS_MUX*);
+    #endif /* HAVE_DTLS_MUX */
+
+    #ifdef HAVE_CONN_POOL
+        /* Client connections made ahead of time. A background thread keeps
+           idle handshaken connections to each added upstream, replacing
+           ones the peer closed or that sat idle too long, resuming the last
+           session when it can. CyaSSL_CONN_POOL_get() hands one out (or
+           connects right then if none is idle), give it back with
+           CyaSSL_CONN_POOL_put(), reuse 0 closes and frees it */
+        typedef struct CYASSL_CONN_POOL CYASSL_CONN_POOL;
+
+        CYASSL_API CYASSL_CONN_POOL* CyaSSL_CONN_POOL_new(CYASSL_CTX*,
+                                               int idle, int maxIdleSecs);
+        CYASSL_API void    CyaSSL_CONN_POOL_free(CYASSL_CONN_POOL*);
+        CYASSL_API int     CyaSSL_CONN_POOL_add(CYASSL_CONN_POOL*,
+                                                const char* host,
+                                                unsigned short port);
+        CYASSL_API CYASSL* CyaSSL_CONN_POOL_get(CYASSL_CONN_POOL*,
+                                                const char* host,
+                                                unsigned short port);
+        CYASSL_API int     CyaSSL_CONN_POOL_put(CYASSL_CONN_POOL*, CYASSL*,
+                                                int reuse);
+        CYASSL_API int     CyaSSL_CONN_POOL_idle(CYASSL_CONN_POOL*,
+                                                 const char* host,
+                                                 unsigned short port);
+    #endif /* HAVE_CONN_POOL */
 #endif /* CYASSL_USER_IO */
 
 
@@ -1038,6 +1278,7 @@ CYASSL_API int CyaSSL_CertPemToDer(const unsigned char*, int sz, unsigned char*,
 
 typedef void (*CallbackCACache)(unsigned char* der, int sz, int type);
 typedef void (*CbMissingCRL)(const char* url);
+typedef int  (*CbCRLRead)(void* ctx, unsigned char* buf, int sz);
 typedef int  (*CbOCSPIO)(void*, const char*, int,
                                          unsigned char*, int, unsigned char**);
 typedef void (*CbOCSPRespFree)(void*,unsigned char*);
@@ -1172,6 +1413,35 @@ CYASSL_API void  CyaSSL_CTX_SetRsaDecCb(CYASSL_CTX*, CallbackRsaDec);
 CYASSL_API void  CyaSSL_SetRsaDecCtx(CYASSL* ssl, void *ctx);
 CYASSL_API void* CyaSSL_GetRsaDecCtx(CYASSL* ssl);
 
+#ifdef CYASSL_ASYNC_CRYPT
+/* Asynchronous private key operations. With a submit callback set the
+   handshake hands each RSA sign/decrypt, ECDSA sign and ECDH op to it and
+   fails with SSL_ERROR_WANT_ASYNC. The executor calls CyaSSL_AsyncOpRun on
+   the op from any thread, then CyaSSL_accept/connect is called again to
+   pick up the result. The CYASSL must be left alone while an op is out,
+   CyaSSL_AsyncPending says when. The PK callbacks, if set, run inside
+   CyaSSL_AsyncOpRun, so hardware can sit behind the executor too */
+typedef struct CYASSL_ASYNC_OP CYASSL_ASYNC_OP;
+
+enum {
+    CYASSL_ASYNC_RSA_SIGN    = 1,
+    CYASSL_ASYNC_RSA_DECRYPT = 2,
+    CYASSL_ASYNC_ECC_SIGN    = 3,
+    CYASSL_ASYNC_ECC_SHARED  = 4
+};
+
+/* return 0 if the op was taken, anything else and it runs inline */
+typedef int (*CallbackAsyncSubmit)(CYASSL* ssl, CYASSL_ASYNC_OP* op,
+                                   void* ctx);
+CYASSL_API void  CyaSSL_CTX_SetAsyncSubmitCb(CYASSL_CTX*, CallbackAsyncSubmit);
+CYASSL_API void  CyaSSL_SetAsyncSubmitCtx(CYASSL* ssl, void *ctx);
+CYASSL_API void* CyaSSL_GetAsyncSubmitCtx(CYASSL* ssl);
+
+CYASSL_API int CyaSSL_AsyncOpType(CYASSL_ASYNC_OP* op);
+CYASSL_API int CyaSSL_AsyncOpRun(CYASSL_ASYNC_OP* op);
+CYASSL_API int CyaSSL_AsyncPending(CYASSL* ssl);
+#endif /* CYASSL_ASYNC_CRYPT */
+
 
 #ifndef NO_CERTS
 	CYASSL_API void CyaSSL_CTX_SetCACb(CYASSL_CTX*, CallbackCACache);
@@ -1182,6 +1452,18 @@ CYASSL_API void* CyaSSL_GetRsaDecCtx(CYASSL* ssl);
     CYASSL_API int CyaSSL_CertManagerLoadCA(CYASSL_CERT_MANAGER*, const char* f,
                                                                  const char* d);
     CYASSL_API int CyaSSL_CertManagerUnloadCAs(CYASSL_CERT_MANAGER* cm);
+    CYASSL_API int CyaSSL_CertManagerSetCATableSize(CYASSL_CERT_MANAGER* cm,
+                                                                      int rows);
+#ifdef CYASSL_LOAD_THREADS
+    CYASSL_API int CyaSSL_CertManagerSetLoadThreads(CYASSL_CERT_MANAGER*,
+                                                                   int threads);
+    CYASSL_API int CyaSSL_CTX_SetLoadThreads(CYASSL_CTX*, int threads);
+#endif
+#ifdef HAVE_VERIFY_CACHE
+    CYASSL_API int CyaSSL_CertManagerSetVerifyCacheSize(CYASSL_CERT_MANAGER*,
+                                                                      int rows);
+    CYASSL_API int CyaSSL_CertManagerFlushVerifyCache(CYASSL_CERT_MANAGER*);
+#endif
     CYASSL_API int CyaSSL_CertManagerVerify(CYASSL_CERT_MANAGER*, const char* f,
                                                                     int format);
     CYASSL_API int CyaSSL_CertManagerVerifyBuffer(CYASSL_CERT_MANAGER* cm,
@@ -1193,6 +1475,8 @@ CYASSL_API void* CyaSSL_GetRsaDecCtx(CYASSL* ssl);
     CYASSL_API int CyaSSL_CertManagerDisableCRL(CYASSL_CERT_MANAGER*);
     CYASSL_API int CyaSSL_CertManagerLoadCRL(CYASSL_CERT_MANAGER*, const char*,
                                                                       int, int);
+    CYASSL_API int CyaSSL_CertManagerLoadCRL_Stream(CYASSL_CERT_MANAGER*,
+                                              CbCRLRead, void* ctx, int type);
     CYASSL_API int CyaSSL_CertManagerSetCRL_Cb(CYASSL_CERT_MANAGER*,
                                                                   CbMissingCRL);
     CYASSL_API int CyaSSL_CertManagerCheckOCSP(CYASSL_CERT_MANAGER*,
@@ -1213,6 +1497,7 @@ CYASSL_API void* CyaSSL_GetRsaDecCtx(CYASSL* ssl);
     CYASSL_API int CyaSSL_DisableOCSP(CYASSL*);
     CYASSL_API int CyaSSL_SetOCSP_OverrideURL(CYASSL*, const char*);
     CYASSL_API int CyaSSL_SetOCSP_Cb(CYASSL*, CbOCSPIO, CbOCSPRespFree, void*);
+    CYASSL_API int CyaSSL_GetOcspFd(CYASSL*);
 
     CYASSL_API int CyaSSL_CTX_EnableCRL(CYASSL_CTX* ctx, int options);
     CYASSL_API int CyaSSL_CTX_DisableCRL(CYASSL_CTX* ctx);
@@ -1279,9 +1564,69 @@ CYASSL_API int CyaSSL_SNI_GetFromBuffer(
                  const unsigned char* clientHello, unsigned int helloSz,
                  unsigned char type, unsigned char* sni, unsigned int* inOutSz);
 
+/* virtual hosting, a server ssl made from ctx moves to vhost when the client
+   asks for name, "*.example.com" covers one more label, add before use;
+   the ssl then runs on vhost's settings, io callbacks included */
+CYASSL_API int CyaSSL_CTX_AddSNIContext(CYASSL_CTX* ctx, const char* name,
+                                        CYASSL_CTX* vhost);
+
+/* called with the requested host name once the table had its turn, may
+   CyaSSL_set_SSL_CTX, non zero return aborts with unrecognized_name */
+typedef int (*CallbackServerName)(CYASSL* ssl, const char* name,
+                                  unsigned short nameSz, void* ctx);
+CYASSL_API int CyaSSL_CTX_set_servername_callback(CYASSL_CTX*,
+                                                  CallbackServerName, void*);
+
 #endif
 #endif
 
+#ifndef NO_CYASSL_SERVER
+
+/* Early ClientHello look. The pointers are into the received message and
+   only good during the callback, absent parts are NULL with size 0. Sizes
+   are in bytes, suites and curves are lists of 2 byte ids, alpn is the
+   protocol_name_list of length prefixed names, sni the first host_name,
+   not terminated */
+typedef struct CYASSL_CLIENT_HELLO {
+    unsigned char        versionMajor;
+    unsigned char        versionMinor;
+    const unsigned char* random;             /* 32 bytes */
+    const unsigned char* sessionId;
+    unsigned char        sessionIdSz;
+    const unsigned char* suites;
+    unsigned short       suitesSz;
+    const unsigned char* extensions;         /* all of them, raw */
+    unsigned short       extensionsSz;
+    const char*          sni;
+    unsigned short       sniSz;
+    const unsigned char* alpn;
+    unsigned short       alpnSz;
+    const unsigned char* curves;
+    unsigned short       curvesSz;
+} CYASSL_CLIENT_HELLO;
+
+/* ClientHello callback returns */
+enum {
+    CYASSL_CLIENT_HELLO_OK      = 0,  /* go on, on a CTX it may have set */
+    CYASSL_CLIENT_HELLO_REJECT  = 1,  /* abort with handshake_failure */
+    CYASSL_CLIENT_HELLO_SUSPEND = 2   /* accept fails with
+                                         SSL_ERROR_WANT_CLIENT_HELLO */
+};
+
+/* Server side, called with each ClientHello before the session cache,
+   suites or key material are touched. It may CyaSSL_set_SSL_CTX to route
+   the connection. After a suspend the CYASSL can be moved to another thread
+   and accept called again there, which runs the callback again. Not called
+   for SSLv2 style hellos, DTLS can't suspend */
+typedef int (*CallbackClientHello)(CYASSL* ssl,
+                                   const CYASSL_CLIENT_HELLO* hello, void* ctx);
+CYASSL_API void  CyaSSL_CTX_SetClientHelloCb(CYASSL_CTX*, CallbackClientHello);
+CYASSL_API void  CyaSSL_SetClientHelloCtx(CYASSL* ssl, void *ctx);
+CYASSL_API void* CyaSSL_GetClientHelloCtx(CYASSL* ssl);
+CYASSL_API int   CyaSSL_set_SSL_CTX(CYASSL* ssl, CYASSL_CTX* ctx);
+
+#endif /* NO_CYASSL_SERVER */
+
 /* Maximum Fragment Length */
 #ifdef HAVE_MAX_FRAGMENT
 
@@ -1312,6 +1657,32 @@ CYASSL_API int CyaSSL_CTX_UseTruncatedHMAC(CYASSL_CTX* ctx);
 #endif
 #endif
 
+/* Encrypt-then-MAC, RFC 7366 */
+#ifdef HAVE_ENCRYPT_THEN_MAC
+#ifndef NO_CYASSL_CLIENT
+
+CYASSL_API int CyaSSL_UseEncryptThenMac(CYASSL* ssl);
+CYASSL_API int CyaSSL_CTX_UseEncryptThenMac(CYASSL_CTX* ctx);
+
+#endif
+#endif
+
+/* Cached Information, RFC 7924 */
+#ifdef HAVE_CACHED_INFO
+#ifndef NO_CYASSL_CLIENT
+
+/* offer a certificate_list saved from an earlier connection to the same
+   server, NULL just holds the one this connection receives */
+CYASSL_API int CyaSSL_UseCachedInfo(CYASSL* ssl, const unsigned char* chain,
+                                    unsigned int sz);
+/* copy out the held certificate_list, NULL chain gives its size in sz and
+   LENGTH_ONLY_E */
+CYASSL_API int CyaSSL_GetCachedInfo(CYASSL* ssl, unsigned char* chain,
+                                    unsigned int* sz);
+
+#endif
+#endif
+
 /* Elliptic Curves */
 #ifdef HAVE_SUPPORTED_CURVES
 
@@ -1355,6 +1726,86 @@ CYASSL_API int CyaSSL_set_SessionTicket_cb(CYASSL*,
                                                   CallbackSessionTicket, void*);
 
 #endif
+#ifndef NO_CYASSL_SERVER
+
+/* built in ticket engine, tickets are sealed with AES-GCM or
+   ChaCha20-Poly1305 under the current key, prior keys are still accepted */
+#define CYASSL_TICKET_NAME_SZ 16
+#define CYASSL_TICKET_KEY_SZ  32
+#ifndef CYASSL_TICKET_KEYS
+    #define CYASSL_TICKET_KEYS 3    /* current key plus prior ones accepted */
+#endif
+
+typedef int (*CallbackTicketKey)(CYASSL_CTX*, const unsigned char* name,
+                                 const unsigned char* key, void*);
+CYASSL_API int CyaSSL_CTX_set_SessionTicketKey(CYASSL_CTX*,
+                               const unsigned char* name,
+                               const unsigned char* key);
+CYASSL_API int CyaSSL_CTX_RotateSessionTicketKey(CYASSL_CTX*);
+CYASSL_API int CyaSSL_CTX_set_SessionTicketKeyLifetime(CYASSL_CTX*,
+                                                       unsigned int seconds);
+CYASSL_API int CyaSSL_CTX_set_SessionTicketKey_cb(CYASSL_CTX*,
+                                                  CallbackTicketKey, void*);
+
+#endif
+#endif
+
+/* Certificate Status Request, OCSP stapling */
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+#ifndef NO_CYASSL_CLIENT
+
+CYASSL_API int CyaSSL_UseOCSPStapling(CYASSL* ssl);
+CYASSL_API int CyaSSL_CTX_UseOCSPStapling(CYASSL_CTX* ctx);
+
+#endif
+#ifndef NO_CYASSL_SERVER
+
+/* staple the OCSP status of the CTX cert, fetched now and refreshed in the
+   background, the CTX cert and its issuer have to be loaded first */
+CYASSL_API int CyaSSL_CTX_EnableOCSPStapling(CYASSL_CTX* ctx);
+
+#endif
+#endif
+
+/* Application-Layer Protocol Negotiation */
+#ifdef HAVE_ALPN
+
+/* ALPN options */
+enum {
+    CYASSL_ALPN_CONTINUE_ON_MISMATCH = 0x01, /* server leaves ALPN out */
+    CYASSL_MAX_ALPN_NAME             = 255
+};
+
+/* protocols is a comma separated list in preference order, "h2,http/1.1",
+   offered by a client or supported by a server */
+CYASSL_API int CyaSSL_UseALPN(CYASSL* ssl, const char* protocols,
+                              unsigned int size, unsigned char options);
+CYASSL_API int CyaSSL_CTX_UseALPN(CYASSL_CTX* ctx, const char* protocols,
+                                  unsigned int size, unsigned char options);
+CYASSL_API int CyaSSL_ALPN_GetProtocol(CYASSL* ssl, char** name,
+                                       unsigned short* size);
+
+/* server picks *out from the client's length prefixed list in, 0 on pick */
+typedef int (*CallbackALPNSelect)(CYASSL* ssl, const unsigned char** out,
+                                  unsigned char* outSz,
+                                  const unsigned char* in, unsigned int inSz,
+                                  void* ctx);
+CYASSL_API int CyaSSL_CTX_set_ALPN_select_cb(CYASSL_CTX*, CallbackALPNSelect,
+                                             void*);
+
+#endif
+
+/* Ephemeral key pool, server ECDHE keys generated off the handshake path */
+#if !defined(NO_CYASSL_SERVER) && (defined(HAVE_ECC) || defined(HAVE_ECC25519))
+
+#ifndef CYASSL_MAX_KEY_POOL
+    #define CYASSL_MAX_KEY_POOL 1024    /* most pooled keys per key type */
+#endif
+
+CYASSL_API int CyaSSL_CTX_SetEphemeralKeyPool(CYASSL_CTX*, int size);
+CYASSL_API int CyaSSL_CTX_FillEphemeralKeyPool(CYASSL_CTX*, int max);
+CYASSL_API int CyaSSL_CTX_GetEphemeralKeyPoolCount(CYASSL_CTX*);
+
 #endif
 
 #define CYASSL_CRL_MONITOR   0x01   /* monitor this dir flag */
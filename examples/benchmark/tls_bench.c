@@ -0,0 +1,557 @@
+/* tls_bench.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* Client and server in one process, talking through memory buffers with the
+ * IO callbacks, so the numbers are CyaSSL's and not the network stack's.
+ * Each thread drives its own client/server pairs, full and resumed
+ * handshakes per second then bulk client to server MB/s per record size.
+ * The client doesn't verify the server, run from the CyaSSL home dir. */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#include <cyassl/ssl.h>
+#include <cyassl/test.h>
+
+#if !defined(NO_CYASSL_CLIENT) && !defined(NO_CYASSL_SERVER) && \
+    !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+
+#if !defined(SINGLE_THREADED) && defined(_POSIX_THREADS)
+    #define BENCH_THREADS
+#endif
+
+#define BENCH_PIPE_SZ     (64 * 1024)   /* a whole flight or 16K record */
+#define BENCH_MAX_THREADS 64
+#define BENCH_MAX_RECORDS 8
+#define BENCH_HS_LOOPS    64            /* connect/accept turns, no more */
+#define BENCH_MAX_RECORD  16384
+
+enum {
+    BENCH_KEY_RSA = 0,
+    BENCH_KEY_ECC = 1
+};
+
+static const char* keyName[] = { "RSA", "ECC" };
+
+/* default matrix, suites not built in are skipped */
+static const struct {
+    const char* suite;
+    int         keyType;
+} defaultSuites[] = {
+    { "AES128-SHA",                      BENCH_KEY_RSA },
+    { "AES128-GCM-SHA256",               BENCH_KEY_RSA },
+    { "ECDHE-RSA-AES128-GCM-SHA256",     BENCH_KEY_RSA },
+    { "ECDHE-RSA-CHACHA20-POLY1305",     BENCH_KEY_RSA },
+    { "ECDHE-ECDSA-AES128-GCM-SHA256",   BENCH_KEY_ECC },
+    { "ECDHE-ECDSA-CHACHA20-POLY1305",   BENCH_KEY_ECC }
+};
+
+
+/* one direction, bytes queue at sz and are taken from idx */
+typedef struct MemPipe {
+    byte buf[BENCH_PIPE_SZ];
+    int  idx;
+    int  sz;
+} MemPipe;
+
+typedef struct MemLink {
+    MemPipe toServer;
+    MemPipe toClient;
+} MemLink;
+
+
+typedef struct BenchArgs {
+    CYASSL_CTX* cliCtx;
+    CYASSL_CTX* srvCtx;
+    double      seconds;
+    int         recordSz[BENCH_MAX_RECORDS];
+    int         records;
+    /* results */
+    int         fullCount;
+    int         resumeCount;
+    double      fullTime;
+    double      resumeTime;
+    double      bulkBytes[BENCH_MAX_RECORDS];
+    double      bulkTime[BENCH_MAX_RECORDS];
+    int         err;
+} BenchArgs;
+
+
+static int MemRecv(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    MemPipe* pipe = (MemPipe*)ctx;
+    int      n    = pipe->sz - pipe->idx;
+
+    (void)ssl;
+
+    if (n == 0)
+        return CYASSL_CBIO_ERR_WANT_READ;
+    if (n > sz)
+        n = sz;
+
+    XMEMCPY(buf, pipe->buf + pipe->idx, n);
+    pipe->idx += n;
+    if (pipe->idx == pipe->sz)
+        pipe->idx = pipe->sz = 0;
+
+    return n;
+}
+
+
+static int MemSend(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    MemPipe* pipe = (MemPipe*)ctx;
+    int      n    = BENCH_PIPE_SZ - pipe->sz;
+
+    (void)ssl;
+
+    if (n == 0)
+        return CYASSL_CBIO_ERR_WANT_WRITE;
+    if (n > sz)
+        n = sz;
+
+    XMEMCPY(pipe->buf + pipe->sz, buf, n);
+    pipe->sz += n;
+
+    return n;
+}
+
+
+/* new client and server on an empty link, 0 on success */
+static int NewPair(BenchArgs* args, MemLink* link, CYASSL** cli, CYASSL** srv)
+{
+    link->toServer.idx = link->toServer.sz = 0;
+    link->toClient.idx = link->toClient.sz = 0;
+
+    *cli = CyaSSL_new(args->cliCtx);
+    *srv = CyaSSL_new(args->srvCtx);
+    if (*cli == NULL || *srv == NULL) {
+        CyaSSL_free(*cli);
+        CyaSSL_free(*srv);
+        return -1;
+    }
+
+    CyaSSL_SetIOReadCtx(*cli,  &link->toClient);
+    CyaSSL_SetIOWriteCtx(*cli, &link->toServer);
+    CyaSSL_SetIOReadCtx(*srv,  &link->toServer);
+    CyaSSL_SetIOWriteCtx(*srv, &link->toClient);
+
+    return 0;
+}
+
+
+static int WouldBlock(CYASSL* ssl, int ret)
+{
+    int err = CyaSSL_get_error(ssl, ret);
+
+    return err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE;
+}
+
+
+/* take turns until both ends finish, 0 on success */
+static int Handshake(CYASSL* cli, CYASSL* srv)
+{
+    int cliDone = 0, srvDone = 0;
+    int i, ret;
+
+    for (i = 0; i < BENCH_HS_LOOPS && !(cliDone && srvDone); i++) {
+        if (!cliDone) {
+            ret = CyaSSL_connect(cli);
+            if (ret == SSL_SUCCESS)
+                cliDone = 1;
+            else if (!WouldBlock(cli, ret))
+                return -1;
+        }
+        if (!srvDone) {
+            ret = CyaSSL_accept(srv);
+            if (ret == SSL_SUCCESS)
+                srvDone = 1;
+            else if (!WouldBlock(srv, ret))
+                return -1;
+        }
+    }
+
+    return (cliDone && srvDone) ? 0 : -1;
+}
+
+
+static int BenchFull(BenchArgs* args, MemLink* link)
+{
+    CYASSL* cli;
+    CYASSL* srv;
+    double  start = current_time();
+    int     ret = 0;
+
+    do {
+        if (NewPair(args, link, &cli, &srv) != 0)
+            return -1;
+        ret = Handshake(cli, srv);
+        CyaSSL_free(cli);
+        CyaSSL_free(srv);
+        if (ret == 0)
+            args->fullCount++;
+        args->fullTime = current_time() - start;
+    } while (ret == 0 && args->fullTime < args->seconds);
+
+    return ret;
+}
+
+
+static int BenchResume(BenchArgs* args, MemLink* link)
+{
+    CYASSL*         cli;
+    CYASSL*         srv;
+    CYASSL_SESSION* session = NULL;
+    double          start;
+    int             ret;
+
+    /* one full handshake for the session to resume */
+    if (NewPair(args, link, &cli, &srv) != 0)
+        return -1;
+    ret = Handshake(cli, srv);
+    if (ret == 0)
+        session = CyaSSL_get_session(cli);
+    CyaSSL_free(cli);
+    CyaSSL_free(srv);
+    if (session == NULL)
+        return -1;
+
+    start = current_time();
+    do {
+        if (NewPair(args, link, &cli, &srv) != 0)
+            return -1;
+        CyaSSL_set_session(cli, session);
+        ret = Handshake(cli, srv);
+        if (ret == 0) {
+            /* other threads may push ours out of the cache, take the new
+               session and don't count the full one */
+            if (CyaSSL_session_reused(cli))
+                args->resumeCount++;
+            session = CyaSSL_get_session(cli);
+        }
+        CyaSSL_free(cli);
+        CyaSSL_free(srv);
+        args->resumeTime = current_time() - start;
+    } while (ret == 0 && session != NULL && args->resumeTime < args->seconds);
+
+    return ret;
+}
+
+
+/* client writes recordSz at a time, server reads it all back out */
+static int BenchBulk(BenchArgs* args, MemLink* link, int r)
+{
+    CYASSL* cli;
+    CYASSL* srv;
+    byte*   msg;
+    byte*   in;
+    double  start;
+    int     sz = args->recordSz[r];
+    int     ret;
+
+    msg = (byte*)malloc(sz);
+    in  = (byte*)malloc(sz);
+    if (msg == NULL || in == NULL || NewPair(args, link, &cli, &srv) != 0) {
+        free(msg);
+        free(in);
+        return -1;
+    }
+    XMEMSET(msg, 0x5A, sz);
+
+    ret   = Handshake(cli, srv);
+    start = current_time();
+    while (ret == 0) {
+        int got = 0;
+
+        if (CyaSSL_write(cli, msg, sz) != sz) {
+            ret = -1;
+            break;
+        }
+        while (got < sz) {
+            int n = CyaSSL_read(srv, in, sz);
+            if (n <= 0) {
+                ret = -1;
+                break;
+            }
+            got += n;
+        }
+
+        args->bulkBytes[r] += sz;
+        args->bulkTime[r]   = current_time() - start;
+        if (args->bulkTime[r] >= args->seconds)
+            break;
+    }
+
+    CyaSSL_free(cli);
+    CyaSSL_free(srv);
+    free(msg);
+    free(in);
+
+    return ret;
+}
+
+
+static THREAD_RETURN CYASSL_THREAD BenchThread(void* vArgs)
+{
+    BenchArgs* args = (BenchArgs*)vArgs;
+    MemLink*   link = (MemLink*)malloc(sizeof(MemLink));
+    int        r;
+
+    if (link == NULL)
+        args->err = 1;
+
+    if (!args->err && BenchFull(args, link) != 0)
+        args->err = 1;
+    if (!args->err && BenchResume(args, link) != 0)
+        args->err = 1;
+    for (r = 0; r < args->records && !args->err; r++) {
+        if (BenchBulk(args, link, r) != 0)
+            args->err = 1;
+    }
+
+    free(link);
+
+    return 0;
+}
+
+
+static CYASSL_CTX* NewCtx(int server, const char* suite, int keyType)
+{
+    CYASSL_CTX* ctx;
+
+    ctx = CyaSSL_CTX_new(server ? CyaSSLv23_server_method()
+                                : CyaSSLv23_client_method());
+    if (ctx == NULL)
+        return NULL;
+
+    CyaSSL_SetIORecv(ctx, MemRecv);
+    CyaSSL_SetIOSend(ctx, MemSend);
+
+    if (CyaSSL_CTX_set_cipher_list(ctx, suite) != SSL_SUCCESS) {
+        CyaSSL_CTX_free(ctx);
+        return NULL;
+    }
+
+    if (server) {
+        const char* cert = keyType == BENCH_KEY_ECC ? eccCert : svrCert;
+        const char* key  = keyType == BENCH_KEY_ECC ? eccKey  : svrKey;
+
+        if (CyaSSL_CTX_use_certificate_file(ctx, cert, SSL_FILETYPE_PEM)
+                                                            != SSL_SUCCESS ||
+            CyaSSL_CTX_use_PrivateKey_file(ctx, key, SSL_FILETYPE_PEM)
+                                                            != SSL_SUCCESS)
+            err_sys("can't load server cert or key, "
+                    "Please run from CyaSSL home dir");
+    }
+    else {
+        CyaSSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, 0);
+#ifndef NO_SESSION_CACHE
+        /* both ends live in this process, on the global cache the server's
+           entry would replace the client's under the same session ID */
+        if (CyaSSL_CTX_set_session_cache_size(ctx, BENCH_MAX_THREADS * 2)
+                                                            != SSL_SUCCESS) {
+            CyaSSL_CTX_free(ctx);
+            return NULL;
+        }
+#endif
+    }
+
+    return ctx;
+}
+
+
+/* all threads on one suite and key, 0 if it ran, 1 if skipped */
+static int BenchSuite(const char* suite, int keyType, int threads,
+                      double seconds, const int* recordSz, int records)
+{
+    BenchArgs   args[BENCH_MAX_THREADS];
+    CYASSL_CTX* cliCtx = NewCtx(0, suite, keyType);
+    CYASSL_CTX* srvCtx = NewCtx(1, suite, keyType);
+    double      full = 0, resume = 0, mbs;
+    int         i, r, err = 0;
+#ifdef BENCH_THREADS
+    pthread_t   tid[BENCH_MAX_THREADS];
+#endif
+
+    if (cliCtx == NULL || srvCtx == NULL) {
+        CyaSSL_CTX_free(cliCtx);
+        CyaSSL_CTX_free(srvCtx);
+        return 1;
+    }
+
+    XMEMSET(args, 0, sizeof(args));
+    for (i = 0; i < threads; i++) {
+        args[i].cliCtx  = cliCtx;
+        args[i].srvCtx  = srvCtx;
+        args[i].seconds = seconds;
+        args[i].records = records;
+        XMEMCPY(args[i].recordSz, recordSz, records * sizeof(int));
+    }
+
+#ifdef BENCH_THREADS
+    for (i = 0; i < threads; i++)
+        pthread_create(&tid[i], 0, BenchThread, &args[i]);
+    for (i = 0; i < threads; i++)
+        pthread_join(tid[i], 0);
+#else
+    BenchThread(&args[0]);
+#endif
+
+    for (i = 0; i < threads; i++) {
+        err |= args[i].err;
+        if (args[i].fullTime > 0)
+            full   += args[i].fullCount / args[i].fullTime;
+        if (args[i].resumeTime > 0)
+            resume += args[i].resumeCount / args[i].resumeTime;
+    }
+
+    printf("%-32s %s %3d %9.1f %9.1f", suite, keyName[keyType], threads,
+           full, resume);
+    for (r = 0; r < records; r++) {
+        mbs = 0;
+        for (i = 0; i < threads; i++) {
+            if (args[i].bulkTime[r] > 0)
+                mbs += args[i].bulkBytes[r] / args[i].bulkTime[r] /
+                       (1024 * 1024);
+        }
+        printf(" %11.1f", mbs);
+    }
+    printf("%s\n", err ? "  (errors)" : "");
+
+    CyaSSL_CTX_free(cliCtx);
+    CyaSSL_CTX_free(srvCtx);
+
+    return 0;
+}
+
+
+static void Usage(void)
+{
+    printf("tls_bench, in process TLS handshake and record benchmark\n");
+    printf("-?          Help, print this usage\n");
+    printf("-t <num>    Threads, default 1, max %d\n", BENCH_MAX_THREADS);
+    printf("-s <sec>    Seconds per measurement, default 1\n");
+    printf("-l <str>    Cipher suite, default a built in list\n");
+    printf("-k <type>   Key type for -l, rsa (default) or ecc\n");
+    printf("-b <bytes>  Record size, repeat for more, default 1024 16384\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* suite    = NULL;
+    int         keyType  = BENCH_KEY_RSA;
+    int         threads  = 1;
+    double      seconds  = 1;
+    int         recordSz[BENCH_MAX_RECORDS] = { 1024, 16384 };
+    int         records  = 0;
+    int         ch, r, ran = 0;
+    size_t      i;
+
+    while ((ch = mygetopt(argc, argv, "?t:s:l:k:b:")) != -1) {
+        switch (ch) {
+            case '?' :
+                Usage();
+                return EXIT_SUCCESS;
+
+            case 't' :
+                threads = atoi(myoptarg);
+                break;
+
+            case 's' :
+                seconds = atof(myoptarg);
+                break;
+
+            case 'l' :
+                suite = myoptarg;
+                break;
+
+            case 'k' :
+                keyType = XSTRNCMP(myoptarg, "ecc", 3) == 0 ? BENCH_KEY_ECC
+                                                            : BENCH_KEY_RSA;
+                break;
+
+            case 'b' :
+                if (records == BENCH_MAX_RECORDS)
+                    err_sys("too many record sizes");
+                recordSz[records++] = atoi(myoptarg);
+                if (recordSz[records - 1] < 1 ||
+                    recordSz[records - 1] > BENCH_MAX_RECORD)
+                    err_sys("record size must be 1 to 16384");
+                break;
+
+            default:
+                Usage();
+                return MY_EX_USAGE;
+        }
+    }
+
+#ifndef BENCH_THREADS
+    threads = 1;
+#endif
+    if (threads < 1 || threads > BENCH_MAX_THREADS || seconds <= 0) {
+        Usage();
+        return MY_EX_USAGE;
+    }
+    if (records == 0)
+        records = 2;
+
+    CyaSSL_Init();
+
+    printf("%-32s key thr %9s %9s", "suite", "full/s", "resume/s");
+    for (r = 0; r < records; r++)
+        printf(" %6d MB/s", recordSz[r]);
+    printf("\n");
+
+    if (suite)
+        ran = BenchSuite(suite, keyType, threads, seconds, recordSz,
+                         records) == 0;
+    else {
+        for (i = 0; i < sizeof(defaultSuites) / sizeof(defaultSuites[0]); i++)
+            ran += BenchSuite(defaultSuites[i].suite, defaultSuites[i].keyType,
+                              threads, seconds, recordSz, records) == 0;
+    }
+
+    CyaSSL_Cleanup();
+
+    if (!ran) {
+        printf("no suite could run, not built in?\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int myoptind = 0;
+char* myoptarg = NULL;
+
+#else
+
+int main(void)
+{
+    printf("tls_bench needs client, server, filesystem and certs\n");
+    return 0;
+}
+
+#endif
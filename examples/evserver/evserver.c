@@ -0,0 +1,661 @@
+/* evserver.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* Event driven TLS echo server for load testing. One reactor thread per
+ * core, each with its own epoll (or kqueue) set and, where the OS has
+ * SO_REUSEPORT, its own listening socket so the kernel spreads connections
+ * without a shared accept lock. Sockets are non-blocking and a connection
+ * only runs when its socket is ready. The main thread prints handshakes/s,
+ * MB/s and live connections every report interval. */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#include <cyassl/ssl.h>
+#include <cyassl/test.h>
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+    #define EV_USE_EPOLL
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+      defined(__OpenBSD__) || defined(__DragonFly__)
+    #include <sys/event.h>
+    #define EV_USE_KQUEUE
+#endif
+
+#if !defined(NO_CYASSL_SERVER) && !defined(NO_FILESYSTEM) && \
+    !defined(NO_CERTS) && !defined(SINGLE_THREADED) && \
+    defined(_POSIX_THREADS) && (defined(EV_USE_EPOLL) || defined(EV_USE_KQUEUE))
+
+#include <signal.h>
+
+#define EV_MAX_REACTORS  256
+#define EV_MAX_EVENTS    256
+#define EV_BUF_SZ        16384          /* one full record */
+#define EV_WAIT_MS       100            /* checks quit and publishes stats */
+#define EV_LISTEN_BACKLOG 1024
+
+static const char evHttpReply[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 3\r\n"
+    "\r\n"
+    "ok\n";
+
+static volatile sig_atomic_t evQuit = 0;
+
+
+typedef struct EvStats {
+    double accepts;
+    double handshakes;
+    double closes;
+    double errors;
+    double bytesIn;
+    double bytesOut;
+} EvStats;
+
+typedef struct EvConn {
+    SOCKET_T       fd;              /* -1 once closed */
+    CYASSL*        ssl;
+    int            handshakeDone;
+    int            wantWrite;       /* registered for writable */
+    byte*          out;             /* reply CyaSSL_write wants again */
+    int            outSz;
+    struct EvConn* next;            /* on the dead list */
+} EvConn;
+
+typedef struct EvReactor {
+    CYASSL_CTX*     ctx;
+    SOCKET_T        listenFd;
+    int             evFd;
+    int             conns;
+    int             maxConns;
+    int             http;
+    EvConn*         dead;           /* freed after each event batch */
+    EvStats         local;          /* reactor thread only */
+    EvStats         shared;         /* copy of local for the reporter */
+    pthread_mutex_t lock;
+    pthread_t       tid;
+    byte            buf[EV_BUF_SZ];
+} EvReactor;
+
+
+typedef struct EvEvent {
+    void* ptr;                      /* EvConn, or NULL for the listener */
+    int   readable;
+    int   writable;
+} EvEvent;
+
+
+#ifdef EV_USE_EPOLL
+
+static int EvCreate(void)
+{
+    return epoll_create(EV_MAX_EVENTS);
+}
+
+
+static int EvCtl(int evFd, int op, SOCKET_T fd, void* ptr, int wantWrite)
+{
+    struct epoll_event ev;
+
+    XMEMSET(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN | (wantWrite ? EPOLLOUT : 0);
+    ev.data.ptr = ptr;
+
+    return epoll_ctl(evFd, op, fd, &ev);
+}
+
+
+static int EvAdd(int evFd, SOCKET_T fd, void* ptr)
+{
+    return EvCtl(evFd, EPOLL_CTL_ADD, fd, ptr, 0);
+}
+
+
+static int EvWatchWrite(int evFd, SOCKET_T fd, void* ptr, int wantWrite)
+{
+    return EvCtl(evFd, EPOLL_CTL_MOD, fd, ptr, wantWrite);
+}
+
+
+static int EvWait(int evFd, EvEvent* out, int max, int ms)
+{
+    struct epoll_event ev[EV_MAX_EVENTS];
+    int                n, i;
+
+    n = epoll_wait(evFd, ev, max, ms);
+    for (i = 0; i < n; i++) {
+        out[i].ptr      = ev[i].data.ptr;
+        out[i].readable = (ev[i].events & (EPOLLIN|EPOLLERR|EPOLLHUP)) != 0;
+        out[i].writable = (ev[i].events & (EPOLLOUT|EPOLLERR|EPOLLHUP)) != 0;
+    }
+
+    return n;
+}
+
+#else /* EV_USE_KQUEUE */
+
+static int EvCreate(void)
+{
+    return kqueue();
+}
+
+
+/* read always on, write added disabled and switched on when wanted */
+static int EvAdd(int evFd, SOCKET_T fd, void* ptr)
+{
+    struct kevent ch[2];
+
+    EV_SET(&ch[0], fd, EVFILT_READ,  EV_ADD, 0, 0, ptr);
+    EV_SET(&ch[1], fd, EVFILT_WRITE, EV_ADD | EV_DISABLE, 0, 0, ptr);
+
+    return kevent(evFd, ch, 2, NULL, 0, NULL);
+}
+
+
+static int EvWatchWrite(int evFd, SOCKET_T fd, void* ptr, int wantWrite)
+{
+    struct kevent ch;
+
+    EV_SET(&ch, fd, EVFILT_WRITE, wantWrite ? EV_ENABLE : EV_DISABLE, 0, 0,
+           ptr);
+
+    return kevent(evFd, &ch, 1, NULL, 0, NULL);
+}
+
+
+/* a socket can come back twice, once per filter */
+static int EvWait(int evFd, EvEvent* out, int max, int ms)
+{
+    struct kevent   ev[EV_MAX_EVENTS];
+    struct timespec ts;
+    int             n, i;
+
+    ts.tv_sec  = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000;
+
+    n = kevent(evFd, NULL, 0, ev, max, &ts);
+    for (i = 0; i < n; i++) {
+        out[i].ptr      = ev[i].udata;
+        out[i].readable = ev[i].filter == EVFILT_READ  ||
+                          (ev[i].flags & EV_EOF);
+        out[i].writable = ev[i].filter == EVFILT_WRITE ||
+                          (ev[i].flags & EV_EOF);
+    }
+
+    return n;
+}
+
+#endif /* EV_USE_EPOLL */
+
+
+static void EvOnSignal(int sig)
+{
+    (void)sig;
+    evQuit = 1;
+}
+
+
+static SOCKET_T EvListen(word16 port, int useAnyAddr, int reusePort)
+{
+    SOCKADDR_IN_T addr;
+    SOCKET_T      fd;
+    int           on = 1;
+
+    build_addr(&addr, (useAnyAddr ? INADDR_ANY : yasslIP), port, 0);
+    tcp_socket(&fd, 0);
+
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0)
+        err_sys("setsockopt SO_REUSEADDR failed");
+#ifdef SO_REUSEPORT
+    if (reusePort &&
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+        err_sys("setsockopt SO_REUSEPORT failed");
+#else
+    (void)reusePort;
+#endif
+
+    if (bind(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0)
+        err_sys("tcp bind failed");
+    if (listen(fd, EV_LISTEN_BACKLOG) != 0)
+        err_sys("tcp listen failed");
+
+    tcp_set_nonblocking(&fd);
+
+    return fd;
+}
+
+
+/* the conn stays allocated until the batch that may still name it is done */
+static void EvClose(EvReactor* r, EvConn* c, int error)
+{
+    CyaSSL_free(c->ssl);
+    CloseSocket(c->fd);
+    free(c->out);
+
+    c->ssl = NULL;
+    c->fd  = -1;
+    c->out = NULL;
+    c->next = r->dead;
+    r->dead = c;
+
+    r->conns--;
+    r->local.closes++;
+    if (error)
+        r->local.errors++;
+}
+
+
+static void EvAccept(EvReactor* r)
+{
+    SOCKADDR_IN_T peer;
+    socklen_t     peerSz;
+    SOCKET_T      fd;
+    EvConn*       c;
+
+    while (r->conns < r->maxConns) {
+        peerSz = sizeof(peer);
+        fd = accept(r->listenFd, (struct sockaddr*)&peer, &peerSz);
+        if (fd < 0)
+            return;                     /* drained, or another reactor won */
+
+        tcp_set_nonblocking(&fd);
+
+        c = (EvConn*)malloc(sizeof(EvConn));
+        if (c == NULL) {
+            CloseSocket(fd);
+            return;
+        }
+        XMEMSET(c, 0, sizeof(EvConn));
+        c->fd  = fd;
+        c->ssl = CyaSSL_new(r->ctx);
+
+        if (c->ssl == NULL || CyaSSL_set_fd(c->ssl, fd) != SSL_SUCCESS ||
+                                        EvAdd(r->evFd, fd, c) != 0) {
+            CyaSSL_free(c->ssl);
+            CloseSocket(fd);
+            free(c);
+            r->local.errors++;
+            continue;
+        }
+        CyaSSL_set_using_nonblock(c->ssl, 1);
+
+        r->conns++;
+        r->local.accepts++;
+    }
+}
+
+
+/* ret is a failed CyaSSL call, wait for the socket or close, 0 if kept */
+static int EvWaitOrClose(EvReactor* r, EvConn* c, int ret)
+{
+    int err       = CyaSSL_get_error(c->ssl, ret);
+    int wantWrite = err == SSL_ERROR_WANT_WRITE;
+
+    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+        if (c->wantWrite != wantWrite) {
+            if (EvWatchWrite(r->evFd, c->fd, c, wantWrite) != 0) {
+                EvClose(r, c, 1);
+                return -1;
+            }
+            c->wantWrite = wantWrite;
+        }
+        return 0;
+    }
+
+    /* a read of 0, close_notify or the peer hanging up, is the normal end */
+    EvClose(r, c, !(c->handshakeDone && ret == 0));
+    return -1;
+}
+
+
+/* run c as far as its socket allows */
+static void EvService(EvReactor* r, EvConn* c)
+{
+    const byte* reply;
+    int         replySz;
+    int         ret;
+
+    if (!c->handshakeDone) {
+        ret = CyaSSL_accept(c->ssl);
+        if (ret != SSL_SUCCESS) {
+            EvWaitOrClose(r, c, ret);
+            return;
+        }
+        c->handshakeDone = 1;
+        r->local.handshakes++;
+    }
+
+    /* a blocked write has to be retried with the same data first */
+    if (c->out) {
+        ret = CyaSSL_write(c->ssl, c->out, c->outSz);
+        if (ret <= 0) {
+            EvWaitOrClose(r, c, ret);
+            return;
+        }
+        r->local.bytesOut += ret;
+        free(c->out);
+        c->out = NULL;
+    }
+
+    for (;;) {
+        ret = CyaSSL_read(c->ssl, r->buf, sizeof(r->buf));
+        if (ret <= 0) {
+            EvWaitOrClose(r, c, ret);
+            return;
+        }
+        r->local.bytesIn += ret;
+
+        if (r->http) {
+            reply   = (const byte*)evHttpReply;
+            replySz = (int)XSTRLEN(evHttpReply);
+        }
+        else {
+            reply   = r->buf;
+            replySz = ret;
+        }
+
+        ret = CyaSSL_write(c->ssl, reply, replySz);
+        if (ret <= 0) {
+            if (CyaSSL_get_error(c->ssl, ret) == SSL_ERROR_WANT_WRITE) {
+                c->out = (byte*)malloc(replySz);
+                if (c->out == NULL) {
+                    EvClose(r, c, 1);
+                    return;
+                }
+                XMEMCPY(c->out, reply, replySz);
+                c->outSz = replySz;
+            }
+            EvWaitOrClose(r, c, ret);
+            return;
+        }
+        r->local.bytesOut += ret;
+    }
+}
+
+
+static void* EvReactorThread(void* arg)
+{
+    EvReactor* r = (EvReactor*)arg;
+    EvEvent    ev[EV_MAX_EVENTS];
+    EvConn*    c;
+    double     published = 0, now;
+    int        n, i;
+
+    while (!evQuit) {
+        n = EvWait(r->evFd, ev, EV_MAX_EVENTS, EV_WAIT_MS);
+
+        for (i = 0; i < n; i++) {
+            c = (EvConn*)ev[i].ptr;
+            if (c == NULL)
+                EvAccept(r);
+            else if (c->fd != -1 && (ev[i].readable || ev[i].writable))
+                EvService(r, c);
+        }
+
+        while (r->dead) {
+            c = r->dead;
+            r->dead = c->next;
+            free(c);
+        }
+
+        now = current_time();
+        if (now - published >= EV_WAIT_MS / 1000.0) {
+            pthread_mutex_lock(&r->lock);
+            r->shared = r->local;
+            pthread_mutex_unlock(&r->lock);
+            published = now;
+        }
+    }
+
+    return 0;
+}
+
+
+static void EvSum(EvReactor* reactors, int count, EvStats* total)
+{
+    int i;
+
+    XMEMSET(total, 0, sizeof(EvStats));
+    for (i = 0; i < count; i++) {
+        pthread_mutex_lock(&reactors[i].lock);
+        total->accepts    += reactors[i].shared.accepts;
+        total->handshakes += reactors[i].shared.handshakes;
+        total->closes     += reactors[i].shared.closes;
+        total->errors     += reactors[i].shared.errors;
+        total->bytesIn    += reactors[i].shared.bytesIn;
+        total->bytesOut   += reactors[i].shared.bytesOut;
+        pthread_mutex_unlock(&reactors[i].lock);
+    }
+}
+
+
+static void Usage(void)
+{
+    printf("evserver, event driven TLS echo server for load testing\n");
+    printf("-?          Help, print this usage\n");
+    printf("-p <num>    Port to listen on, default %d\n", yasslPort);
+    printf("-t <num>    Reactor threads, default one per core, max %d\n",
+           EV_MAX_REACTORS);
+    printf("-m <num>    Max connections per reactor, default 10000\n");
+    printf("-c <file>   Certificate file,           default %s\n", svrCert);
+    printf("-k <file>   Key file,                   default %s\n", svrKey);
+    printf("-l <str>    Cipher list\n");
+    printf("-b          Bind to any interface instead of localhost only\n");
+    printf("-H          Answer each read with a fixed HTTP 200, not an echo\n");
+    printf("-r <sec>    Report interval, default 1\n");
+    printf("-d <sec>    Run this long then exit, default until interrupted\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    EvReactor*  reactors;
+    CYASSL_CTX* ctx;
+    EvStats     total, last;
+    SOCKET_T    sharedFd = -1;
+    const char* cert     = svrCert;
+    const char* key      = svrKey;
+    const char* cipherList = NULL;
+    word16      port     = yasslPort;
+    int         threads  = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int         maxConns = 10000;
+    int         useAnyAddr = 0;
+    int         http     = 0;
+    double      interval = 1;
+    double      duration = 0;
+    double      start, now, lastTime;
+    int         ch, i;
+
+    while ((ch = mygetopt(argc, argv, "?p:t:m:c:k:l:bHr:d:")) != -1) {
+        switch (ch) {
+            case '?' :
+                Usage();
+                return EXIT_SUCCESS;
+
+            case 'p' :
+                port = (word16)atoi(myoptarg);
+                break;
+
+            case 't' :
+                threads = atoi(myoptarg);
+                break;
+
+            case 'm' :
+                maxConns = atoi(myoptarg);
+                break;
+
+            case 'c' :
+                cert = myoptarg;
+                break;
+
+            case 'k' :
+                key = myoptarg;
+                break;
+
+            case 'l' :
+                cipherList = myoptarg;
+                break;
+
+            case 'b' :
+                useAnyAddr = 1;
+                break;
+
+            case 'H' :
+                http = 1;
+                break;
+
+            case 'r' :
+                interval = atof(myoptarg);
+                break;
+
+            case 'd' :
+                duration = atof(myoptarg);
+                break;
+
+            default:
+                Usage();
+                return MY_EX_USAGE;
+        }
+    }
+
+    if (threads < 1 || threads > EV_MAX_REACTORS || maxConns < 1 ||
+                                            interval <= 0 || duration < 0) {
+        Usage();
+        return MY_EX_USAGE;
+    }
+
+    signal(SIGINT,  EvOnSignal);
+    signal(SIGTERM, EvOnSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    CyaSSL_Init();
+
+    ctx = CyaSSL_CTX_new(CyaSSLv23_server_method());
+    if (ctx == NULL)
+        err_sys("unable to get ctx");
+    if (CyaSSL_CTX_use_certificate_file(ctx, cert, SSL_FILETYPE_PEM)
+                                                            != SSL_SUCCESS)
+        err_sys("can't load server cert file, "
+                "Please run from CyaSSL home dir");
+    if (CyaSSL_CTX_use_PrivateKey_file(ctx, key, SSL_FILETYPE_PEM)
+                                                            != SSL_SUCCESS)
+        err_sys("can't load server key file, "
+                "Please run from CyaSSL home dir");
+    if (cipherList && CyaSSL_CTX_set_cipher_list(ctx, cipherList)
+                                                            != SSL_SUCCESS)
+        err_sys("server can't set cipher list");
+
+    reactors = (EvReactor*)malloc(threads * sizeof(EvReactor));
+    if (reactors == NULL)
+        err_sys("out of memory");
+    XMEMSET(reactors, 0, threads * sizeof(EvReactor));
+
+#ifndef SO_REUSEPORT
+    /* every reactor polls the one socket, losers see EAGAIN on accept */
+    sharedFd = EvListen(port, useAnyAddr, 0);
+#endif
+
+    for (i = 0; i < threads; i++) {
+        EvReactor* r = &reactors[i];
+
+        r->ctx      = ctx;
+        r->maxConns = maxConns;
+        r->http     = http;
+        r->listenFd = sharedFd != -1 ? sharedFd
+                                     : EvListen(port, useAnyAddr, 1);
+        r->evFd     = EvCreate();
+        if (r->evFd < 0 || EvAdd(r->evFd, r->listenFd, NULL) != 0)
+            err_sys("event set failed");
+        pthread_mutex_init(&r->lock, 0);
+        if (pthread_create(&r->tid, 0, EvReactorThread, r) != 0)
+            err_sys("reactor thread failed");
+    }
+
+    printf("evserver on port %d, %d reactors, %s\n", port, threads,
+           http ? "http reply" : "echo");
+    printf("%10s %9s %9s %9s %9s %8s\n", "time", "conns", "hs/s",
+           "in MB/s", "out MB/s", "errors");
+
+    XMEMSET(&last, 0, sizeof(last));
+    start = lastTime = current_time();
+    while (!evQuit) {
+        usleep((useconds_t)(interval * 1000000));
+        now = current_time();
+        EvSum(reactors, threads, &total);
+
+        printf("%10.1f %9.0f %9.1f %9.2f %9.2f %8.0f\n", now - start,
+               total.accepts - total.closes,
+               (total.handshakes - last.handshakes) / (now - lastTime),
+               (total.bytesIn  - last.bytesIn)  / (now - lastTime) /
+                                                            (1024 * 1024),
+               (total.bytesOut - last.bytesOut) / (now - lastTime) /
+                                                            (1024 * 1024),
+               total.errors);
+        fflush(stdout);
+
+        last     = total;
+        lastTime = now;
+        if (duration > 0 && now - start >= duration)
+            evQuit = 1;
+    }
+
+    for (i = 0; i < threads; i++)
+        pthread_join(reactors[i].tid, 0);
+
+    EvSum(reactors, threads, &total);
+    printf("total: %.0f handshakes, %.0f connections, %.0f errors\n",
+           total.handshakes, total.accepts, total.errors);
+
+    /* connections still open at exit are left to the OS */
+    for (i = 0; i < threads; i++) {
+        if (reactors[i].listenFd != sharedFd)
+            CloseSocket(reactors[i].listenFd);
+        close(reactors[i].evFd);
+        pthread_mutex_destroy(&reactors[i].lock);
+    }
+    if (sharedFd != -1)
+        CloseSocket(sharedFd);
+    free(reactors);
+
+    CyaSSL_CTX_free(ctx);
+    CyaSSL_Cleanup();
+
+    return EXIT_SUCCESS;
+}
+
+int myoptind = 0;
+char* myoptarg = NULL;
+
+#else
+
+int main(void)
+{
+    printf("evserver needs server, filesystem, certs, threads and "
+           "epoll or kqueue\n");
+    return 0;
+}
+
+#endif
@@ -482,6 +482,12 @@ THREAD_RETURN CYASSL_THREAD server_test(void* args)
             err_sys("UseSNI failed");
 #endif
 
+#ifdef HAVE_SESSION_TICKET
+    /* random ticket key, fine for a lone server */
+    if (CyaSSL_CTX_RotateSessionTicketKey(ctx) != SSL_SUCCESS)
+        printf("session ticket key not set, no tickets\n");
+#endif
+
     ssl = SSL_new(ctx);
     if (ssl == NULL)
         err_sys("unable to get SSL");
@@ -257,6 +257,48 @@ int CRYPT_HMAC_Finalize(CRYPT_HMAC_CTX* hmac, unsigned char* digest)
 }
 
 
+/* Add HMAC data from each packet, digest left for Finalize */
+int CRYPT_HMAC_DataAddv(CRYPT_HMAC_CTX* hmac, const CRYPT_PACKET* pkts,
+                        unsigned int count)
+{
+    unsigned int i;
+    int ret = 0;
+
+    if (hmac == NULL || (pkts == NULL && count != 0))
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < count && ret == 0; i++) {
+        if (pkts[i].in == NULL)
+            return BAD_FUNC_ARG;
+        ret = HmacUpdate((Hmac*)hmac, pkts[i].in, pkts[i].inSz);
+    }
+
+    return ret;
+}
+
+
+/* HMAC each packet into its out, Final rearms the same key for the next */
+int CRYPT_HMAC_Batch(CRYPT_HMAC_CTX* hmac, CRYPT_PACKET* pkts,
+                     unsigned int count)
+{
+    unsigned int i;
+    int ret = 0;
+
+    if (hmac == NULL || (pkts == NULL && count != 0))
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < count && ret == 0; i++) {
+        if (pkts[i].in == NULL || pkts[i].out == NULL)
+            return BAD_FUNC_ARG;
+        ret = HmacUpdate((Hmac*)hmac, pkts[i].in, pkts[i].inSz);
+        if (ret == 0)
+            ret = HmacFinal((Hmac*)hmac, pkts[i].out);
+    }
+
+    return ret;
+}
+
+
 /* Huffman Compression, set flag to do static, otherwise dynamic */
 /* return compressed size, otherwise < 0 for error */
 int CRYPT_HUFFMAN_Compress(unsigned char* out, unsigned int outSz,
@@ -408,6 +450,51 @@ int CRYPT_AES_CBC_Decrypt(CRYPT_AES_CTX* aes, unsigned char* out,
 }
 
 
+/* AES CBC over each packet, setting its iv if it has one */
+static int AesCbcBatch(Aes* aes, CRYPT_PACKET* pkts, unsigned int count,
+                       int dir)
+{
+    unsigned int i;
+    int ret = 0;
+
+    if (aes == NULL || (pkts == NULL && count != 0))
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < count && ret == 0; i++) {
+        if (pkts[i].in == NULL || pkts[i].out == NULL)
+            return BAD_FUNC_ARG;
+        if (pkts[i].iv)
+            ret = AesSetIV(aes, pkts[i].iv);
+        if (ret == 0) {
+            if (dir == CRYPT_AES_ENCRYPTION)
+                ret = AesCbcEncrypt(aes, pkts[i].out, pkts[i].in,
+                                    pkts[i].inSz);
+            else
+                ret = AesCbcDecrypt(aes, pkts[i].out, pkts[i].in,
+                                    pkts[i].inSz);
+        }
+    }
+
+    return ret;
+}
+
+
+/* AES CBC Encrypt a batch of packets */
+int CRYPT_AES_CBC_EncryptBatch(CRYPT_AES_CTX* aes, CRYPT_PACKET* pkts,
+                               unsigned int count)
+{
+    return AesCbcBatch((Aes*)aes, pkts, count, CRYPT_AES_ENCRYPTION);
+}
+
+
+/* AES CBC Decrypt a batch of packets */
+int CRYPT_AES_CBC_DecryptBatch(CRYPT_AES_CTX* aes, CRYPT_PACKET* pkts,
+                               unsigned int count)
+{
+    return AesCbcBatch((Aes*)aes, pkts, count, CRYPT_AES_DECRYPTION);
+}
+
+
 /* AES CTR Encrypt (used for decrypt too, with ENCRYPT key setup) */
 int CRYPT_AES_CTR_Encrypt(CRYPT_AES_CTX* aes, unsigned char* out,
                           const unsigned char* in, unsigned int inSz)
@@ -101,15 +101,29 @@ enum {
 };
 
 
+/* one packet of a batch call, out may equal in for the ciphers */
+typedef struct CRYPT_PACKET {
+    unsigned char*       out;   /* cipher output or HMAC digest */
+    const unsigned char* in;
+    unsigned int         inSz;
+    const unsigned char* iv;    /* AES CBC iv, NULL continues the chain */
+} CRYPT_PACKET;
+
+
 /* HMAC */
 typedef struct CRYPT_HMAC_CTX {
-    long long holder[67];   /* big enough to hold internal, but check on init */
+    long long holder[68];   /* big enough to hold internal, but check on init */
 } CRYPT_HMAC_CTX;
 
 int CRYPT_HMAC_SetKey(CRYPT_HMAC_CTX*, int, const unsigned char*, unsigned int);
 int CRYPT_HMAC_DataAdd(CRYPT_HMAC_CTX*, const unsigned char*, unsigned int);
 int CRYPT_HMAC_Finalize(CRYPT_HMAC_CTX*, unsigned char*);
 
+/* batch, DataAddv adds every packet's in to the one running mac, Batch
+   makes a separate digest per packet with the key left from SetKey */
+int CRYPT_HMAC_DataAddv(CRYPT_HMAC_CTX*, const CRYPT_PACKET*, unsigned int);
+int CRYPT_HMAC_Batch(CRYPT_HMAC_CTX*, CRYPT_PACKET*, unsigned int);
+
 /* HMAC types */
 enum {
     CRYPT_HMAC_SHA    = 1, 
@@ -177,6 +191,10 @@ int CRYPT_AES_CBC_Encrypt(CRYPT_AES_CTX*, unsigned char*,
 int CRYPT_AES_CBC_Decrypt(CRYPT_AES_CTX*, unsigned char*,
                            const unsigned char*, unsigned int);
 
+/* cbc batch, each packet in turn on the same key, stops at the first error */
+int CRYPT_AES_CBC_EncryptBatch(CRYPT_AES_CTX*, CRYPT_PACKET*, unsigned int);
+int CRYPT_AES_CBC_DecryptBatch(CRYPT_AES_CTX*, CRYPT_PACKET*, unsigned int);
+
 /* ctr (counter), use Encrypt both ways with ENCRYPT key setup */
 int CRYPT_AES_CTR_Encrypt(CRYPT_AES_CTX*, unsigned char*,
                           const unsigned char*, unsigned int);
@@ -83,6 +83,7 @@ static int check_des3(void);
 static int check_aescbc(void);
 static int check_aesctr(void);
 static int check_aesdirect(void);
+static int check_batch(void);
 static int check_rsa(void);
 static int check_ecc(void);
 
@@ -189,6 +190,12 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    ret = check_batch();
+    if (ret != 0) {
+        printf("mcapi check_batch failed\n");
+        return -1;
+    }
+
     ret = check_rsa();
     if (ret != 0) {
         printf("mcapi check_rsa failed\n");
@@ -925,6 +932,119 @@ static int check_aescbc(void)
 }
 
 
+#define BATCH_PACKETS 3
+
+/* check mcapi aes cbc and hmac batches against single calls */
+static int check_batch(void)
+{
+    CRYPT_AES_CTX  mcAes;
+    CRYPT_HMAC_CTX mcHmac;
+    CRYPT_PACKET   pkts[BATCH_PACKETS];
+    int            ret;
+    int            i;
+    byte           ivs[BATCH_PACKETS][CRYPT_AES_BLOCK_SIZE];
+    byte           out1[BATCH_PACKETS][AES_TEST_SIZE];
+    byte           out2[AES_TEST_SIZE];
+    byte           mcDigest[BATCH_PACKETS][CRYPT_SHA256_DIGEST_SIZE];
+    byte           defDigest[CRYPT_SHA256_DIGEST_SIZE];
+
+    strncpy((char*)key, "1234567890abcdefghijklmnopqrstuv", 32);
+
+    /* packets 0 and 1 have their own iv, 2 continues from 1 */
+    for (i = 0; i < BATCH_PACKETS; i++) {
+        memset(ivs[i], 'a' + i, CRYPT_AES_BLOCK_SIZE);
+        pkts[i].out  = out1[i];
+        pkts[i].in   = ourData + i * AES_TEST_SIZE;
+        pkts[i].inSz = AES_TEST_SIZE;
+        pkts[i].iv   = i < 2 ? ivs[i] : NULL;
+    }
+
+    ret = CRYPT_AES_KeySet(&mcAes, key, 16, NULL, CRYPT_AES_ENCRYPTION);
+    if (ret == 0)
+        ret = CRYPT_AES_CBC_EncryptBatch(&mcAes, pkts, BATCH_PACKETS);
+    if (ret != 0) {
+        printf("mcapi aes cbc batch encrypt failed\n");
+        return -1;
+    }
+
+    ret = CRYPT_AES_KeySet(&mcAes, key, 16, NULL, CRYPT_AES_ENCRYPTION);
+    for (i = 0; i < BATCH_PACKETS && ret == 0; i++) {
+        if (i < 2)
+            ret = CRYPT_AES_IvSet(&mcAes, ivs[i]);
+        if (ret == 0)
+            ret = CRYPT_AES_CBC_Encrypt(&mcAes, out2, pkts[i].in,
+                                        AES_TEST_SIZE);
+        if (ret == 0 && memcmp(out1[i], out2, AES_TEST_SIZE) != 0)
+            ret = -1;
+    }
+    if (ret != 0) {
+        printf("mcapi aes cbc batch encrypt cmp failed\n");
+        return -1;
+    }
+
+    /* decrypt in place */
+    for (i = 0; i < BATCH_PACKETS; i++)
+        pkts[i].in = out1[i];
+    ret = CRYPT_AES_KeySet(&mcAes, key, 16, NULL, CRYPT_AES_DECRYPTION);
+    if (ret == 0)
+        ret = CRYPT_AES_CBC_DecryptBatch(&mcAes, pkts, BATCH_PACKETS);
+    if (ret != 0) {
+        printf("mcapi aes cbc batch decrypt failed\n");
+        return -1;
+    }
+    if (memcmp(out1, ourData, sizeof(out1)) != 0) {
+        printf("mcapi aes cbc batch decrypt cmp failed\n");
+        return -1;
+    }
+
+    /* a digest per packet */
+    for (i = 0; i < BATCH_PACKETS; i++) {
+        pkts[i].out = mcDigest[i];
+        pkts[i].in  = ourData + i * AES_TEST_SIZE;
+    }
+    ret = CRYPT_HMAC_SetKey(&mcHmac, CRYPT_HMAC_SHA256, key, 32);
+    if (ret == 0)
+        ret = CRYPT_HMAC_Batch(&mcHmac, pkts, BATCH_PACKETS);
+    if (ret != 0) {
+        printf("mcapi hmac batch failed\n");
+        return -1;
+    }
+    for (i = 0; i < BATCH_PACKETS; i++) {
+        ret = CRYPT_HMAC_SetKey(&mcHmac, CRYPT_HMAC_SHA256, key, 32);
+        if (ret == 0)
+            ret = CRYPT_HMAC_DataAdd(&mcHmac, pkts[i].in, AES_TEST_SIZE);
+        if (ret == 0)
+            ret = CRYPT_HMAC_Finalize(&mcHmac, defDigest);
+        if (ret != 0 || memcmp(mcDigest[i], defDigest, sizeof(defDigest))) {
+            printf("mcapi hmac batch cmp failed\n");
+            return -1;
+        }
+    }
+
+    /* the packets gathered into one digest */
+    ret = CRYPT_HMAC_SetKey(&mcHmac, CRYPT_HMAC_SHA256, key, 32);
+    if (ret == 0)
+        ret = CRYPT_HMAC_DataAddv(&mcHmac, pkts, BATCH_PACKETS);
+    if (ret == 0)
+        ret = CRYPT_HMAC_Finalize(&mcHmac, mcDigest[0]);
+    if (ret == 0)
+        ret = CRYPT_HMAC_SetKey(&mcHmac, CRYPT_HMAC_SHA256, key, 32);
+    if (ret == 0)
+        ret = CRYPT_HMAC_DataAdd(&mcHmac, ourData,
+                                 BATCH_PACKETS * AES_TEST_SIZE);
+    if (ret == 0)
+        ret = CRYPT_HMAC_Finalize(&mcHmac, defDigest);
+    if (ret != 0 || memcmp(mcDigest[0], defDigest, sizeof(defDigest))) {
+        printf("mcapi hmac gather cmp failed\n");
+        return -1;
+    }
+
+    printf("batch       mcapi test passed\n");
+
+    return 0;
+}
+
+
 /* check mcapi aes ctr */
 static int check_aesctr(void)
 {
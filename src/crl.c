@@ -29,6 +29,7 @@
 
 #include <cyassl/internal.h>
 #include <cyassl/error-ssl.h>
+#include <cyassl/ctaocrypt/coding.h>
 
 #include <dirent.h>
 #include <sys/stat.h>
@@ -38,6 +39,32 @@
     static int StopMonitor(int mfd);
 #endif
 
+#ifdef HAVE_CRL_FETCH
+    #include <errno.h>
+    #include <time.h>
+
+    static void StopCRL_Fetch(CYASSL_CRL* crl);
+    static void QueueCRL_Fetch(CYASSL_CRL* crl, const byte* issuerHash,
+                               const char* url);
+#endif
+
+
+/* With pthreads and atomics the CRL set and row heads are published with
+   release stores and read with acquire loads, lookups then don't need crlLock
+   and count themselves in an epoch instead. A reload swaps in a whole new set
+   and frees the old one once the lookups of its epoch are done, writers still
+   serialize on crlLock */
+#if defined(CYASSL_PTHREADS) && defined(__ATOMIC_ACQUIRE) && \
+    !defined(NO_CRL_RCU)
+    #include <sched.h>
+    #define CRL_RCU
+    #define CRL_LOAD(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+    #define CRL_STORE(x, v)  __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#else
+    #define CRL_LOAD(x)      (x)
+    #define CRL_STORE(x, v)  ((x) = (v))
+#endif
+
 
 /* Initialze CRL members */
 int InitCRL(CYASSL_CRL* crl, CYASSL_CERT_MANAGER* cm)
@@ -45,21 +72,190 @@ int InitCRL(CYASSL_CRL* crl, CYASSL_CERT_MANAGER* cm)
     CYASSL_ENTER("InitCRL");
 
     crl->cm = cm;
-    crl->crlList = NULL;
     crl->monitors[0].path = NULL;
     crl->monitors[1].path = NULL;
+    crl->readers[0] = 0;
+    crl->readers[1] = 0;
+    crl->epoch      = 0;
 #ifdef HAVE_CRL_MONITOR
     crl->tid =  0;
     crl->mfd = -1;   /* mfd for bsd is kqueue fd, eventfd for linux */
 #endif
-    if (InitMutex(&crl->crlLock) != 0)
+#ifdef HAVE_CRL_FETCH
+    crl->fetches    = NULL;
+    crl->fetchCount = 0;
+    crl->fetchTid   = 0;
+    crl->fetchStop  = 0;
+#endif
+    crl->crlSet = (CRL_Set*)XMALLOC(sizeof(CRL_Set), NULL, DYNAMIC_TYPE_CRL);
+    if (crl->crlSet == NULL)
+        return MEMORY_E;
+    XMEMSET(crl->crlSet, 0, sizeof(CRL_Set));
+
+    if (InitMutex(&crl->crlLock) != 0) {
+        XFREE(crl->crlSet, NULL, DYNAMIC_TYPE_CRL);
+        crl->crlSet = NULL;
         return BAD_MUTEX_E; 
+    }
+
+#ifdef HAVE_CRL_FETCH
+    if (pthread_mutex_init(&crl->fetchLock, NULL) != 0) {
+        FreeMutex(&crl->crlLock);
+        XFREE(crl->crlSet, NULL, DYNAMIC_TYPE_CRL);
+        crl->crlSet = NULL;
+        return BAD_MUTEX_E;
+    }
+    if (pthread_cond_init(&crl->fetchCond, NULL) != 0) {
+        pthread_mutex_destroy(&crl->fetchLock);
+        FreeMutex(&crl->crlLock);
+        XFREE(crl->crlSet, NULL, DYNAMIC_TYPE_CRL);
+        crl->crlSet = NULL;
+        return BAD_MUTEX_E;
+    }
+#endif
 
     return 0;
 }
 
 
-/* Initialze CRL Entry */
+/* should a lookup result queue the issuer's distribution point, the fetcher
+   is running and the CRL is missing or past its next update */
+#ifdef HAVE_CRL_FETCH
+    #define CRL_FETCHING(crl, ret) ((crl)->fetchTid != 0 && \
+                             ((ret) == CRL_MISSING || (ret) == ASN_AFTER_DATE_E))
+#else
+    #define CRL_FETCHING(crl, ret) 0
+#endif
+
+
+/* start a lookup, 0 on success */
+static INLINE int LockCRL_Read(CYASSL_CRL* crl, int* epoch)
+{
+#ifdef CRL_RCU
+    for (;;) {
+        int e = __atomic_load_n(&crl->epoch, __ATOMIC_SEQ_CST);
+
+        __atomic_fetch_add(&crl->readers[e], 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&crl->epoch, __ATOMIC_SEQ_CST) == e) {
+            *epoch = e;
+            return 0;
+        }
+        /* a reload flipped the epoch under us, join the new one */
+        __atomic_fetch_sub(&crl->readers[e], 1, __ATOMIC_SEQ_CST);
+    }
+#else
+    *epoch = 0;
+    return LockMutex(&crl->crlLock);
+#endif
+}
+
+
+static INLINE void UnLockCRL_Read(CYASSL_CRL* crl, int epoch)
+{
+#ifdef CRL_RCU
+    __atomic_fetch_sub(&crl->readers[epoch], 1, __ATOMIC_RELEASE);
+#else
+    (void)epoch;
+    UnLockMutex(&crl->crlLock);
+#endif
+}
+
+
+/* after a new set is published or entries are unlinked wait out lookups that
+   may still use the old ones, caller holds crlLock */
+static void WaitCRL_Readers(CYASSL_CRL* crl)
+{
+#ifdef CRL_RCU
+    int old = crl->epoch;
+
+    __atomic_store_n(&crl->epoch, old ^ 1, __ATOMIC_SEQ_CST);
+
+    /* lookups are a hash and a binary search, only yield to them */
+    while (__atomic_load_n(&crl->readers[old], __ATOMIC_ACQUIRE) != 0)
+        sched_yield();
+#else
+    (void)crl;   /* lookups hold crlLock, none left */
+#endif
+}
+
+
+/* issuer hash is the SHA digest of the name, use first 32 bits for row */
+static INLINE word32 HashCRL_Issuer(const byte* hash)
+{
+    return (((word32)hash[0] << 24) | ((word32)hash[1] << 16) |
+            ((word32)hash[2] <<  8) |  (word32)hash[3]) % CRL_TABLE_SIZE;
+}
+
+
+/* order of revoked serials, by length then bytes, < 0, 0 or > 0 */
+static INLINE int CompareSerial(const byte* a, int aSz, const byte* b, int bSz)
+{
+    if (aSz != bSz)
+        return aSz - bSz;
+
+    return XMEMCMP(a, b, aSz);
+}
+
+
+/* order of the packed serials at offsets a and b */
+static INLINE int ComparePacked(const byte* serials, word32 a, word32 b)
+{
+    return CompareSerial(serials + a + 1, serials[a], serials + b + 1,
+                         serials[b]);
+}
+
+
+/* sift idx[root] down the heap of n serial offsets */
+static void SiftSerials(const byte* serials, word32* idx, int root, int n)
+{
+    for (;;) {
+        int    child = 2 * root + 1;
+        word32 tmp;
+
+        if (child >= n)
+            break;
+        if (child + 1 < n &&
+                ComparePacked(serials, idx[child], idx[child + 1]) < 0)
+            child++;
+        if (ComparePacked(serials, idx[root], idx[child]) >= 0)
+            break;
+
+        tmp        = idx[root];
+        idx[root]  = idx[child];
+        idx[child] = tmp;
+        root       = child;
+    }
+}
+
+
+/* sort serial offsets, heap sort in place so big CRLs need no scratch */
+static void SortSerials(const byte* serials, word32* idx, int n)
+{
+    int i;
+
+    /* CAs usually list serials in order already */
+    for (i = 1; i < n; i++) {
+        if (ComparePacked(serials, idx[i - 1], idx[i]) > 0)
+            break;
+    }
+    if (i >= n)
+        return;
+
+    for (i = n / 2 - 1; i >= 0; i--)
+        SiftSerials(serials, idx, i, n);
+
+    for (i = n - 1; i > 0; i--) {
+        word32 tmp = idx[0];
+
+        idx[0] = idx[i];
+        idx[i] = tmp;
+        SiftSerials(serials, idx, 0, i);
+    }
+}
+
+
+/* Initialze CRL Entry, the packed revoked serials are copied sorted, with an
+   offset index for binary search lookups */
 static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl)
 {
     CYASSL_ENTER("InitCRL_Entry");
@@ -71,10 +267,58 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl)
     XMEMCPY(crle->nextDate, dcrl->nextDate, MAX_DATE_SIZE);
     crle->lastDateFormat = dcrl->lastDateFormat;
     crle->nextDateFormat = dcrl->nextDateFormat;
+#ifdef HAVE_DATE_EPOCH
+    crle->nextEpoch      = dcrl->nextEpoch;
+#endif
+
+    crle->serials    = NULL;
+    crle->serialIdx  = NULL;
+    crle->totalCerts = 0;
+    crle->source     = NULL;
+    crle->retired    = NULL;
+
+    if (dcrl->totalCerts > 0) {
+        word32* idx;
+        byte*   packed;
+        word32  off = 0;
+        int     i, n = 0;
+
+        idx = (word32*)XMALLOC(dcrl->totalCerts * sizeof(word32), NULL,
+                                                       DYNAMIC_TYPE_REVOKED);
+        packed = (byte*)XMALLOC(dcrl->serialsSz, NULL, DYNAMIC_TYPE_REVOKED);
+        if (idx == NULL || packed == NULL) {
+            CYASSL_MSG("alloc revoked serials failed");
+            if (idx)
+                XFREE(idx, NULL, DYNAMIC_TYPE_REVOKED);
+            if (packed)
+                XFREE(packed, NULL, DYNAMIC_TYPE_REVOKED);
+            return MEMORY_E;
+        }
+
+        for (i = 0; i < dcrl->totalCerts; i++) {
+            idx[i] = off;
+            off   += 1 + dcrl->serials[off];
+        }
+        SortSerials(dcrl->serials, idx, dcrl->totalCerts);
+
+        off = 0;
+        for (i = 0; i < dcrl->totalCerts; i++) {
+            const byte* sn = dcrl->serials + idx[i];
+
+            /* same serial listed twice only needs one slot */
+            if (n > 0 && CompareSerial(packed + idx[n-1] + 1, packed[idx[n-1]],
+                                       sn + 1, sn[0]) == 0)
+                continue;
 
-    crle->certs = dcrl->certs;   /* take ownsership */
-    dcrl->certs = NULL;
-    crle->totalCerts = dcrl->totalCerts;
+            XMEMCPY(packed + off, sn, 1 + sn[0]);
+            idx[n++] = off;
+            off     += 1 + sn[0];
+        }
+
+        crle->serials    = packed;
+        crle->serialIdx  = idx;
+        crle->totalCerts = n;
+    }
 
     return 0;
 }
@@ -83,39 +327,61 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl)
 /* Free all CRL Entry resources */
 static void FreeCRL_Entry(CRL_Entry* crle)
 {
-    RevokedCert* tmp = crle->certs; 
-
     CYASSL_ENTER("FreeCRL_Entry");
 
-    while(tmp) {
-        RevokedCert* next = tmp->next;
-        XFREE(tmp, NULL, DYNAMIC_TYPE_REVOKED);
-        tmp = next;
-    }
+    if (crle->serials)
+        XFREE(crle->serials, NULL, DYNAMIC_TYPE_REVOKED);
+    if (crle->serialIdx)
+        XFREE(crle->serialIdx, NULL, DYNAMIC_TYPE_REVOKED);
+    if (crle->source)
+        XFREE(crle->source, NULL, DYNAMIC_TYPE_CRL_MONITOR);
+    crle->serials   = NULL;
+    crle->serialIdx = NULL;
+    crle->source    = NULL;
 }
 
 
 
+/* Free CRL set and all its entries */
+static void FreeCRL_Set(CRL_Set* set)
+{
+    int row;
+
+    for (row = 0; row < CRL_TABLE_SIZE; row++) {
+        CRL_Entry* tmp = set->crlTable[row];
+
+        while(tmp) {
+            CRL_Entry* next = tmp->next;
+            FreeCRL_Entry(tmp);
+            XFREE(tmp, NULL, DYNAMIC_TYPE_CRL_ENTRY);
+            tmp = next;
+        }
+    }
+    XFREE(set, NULL, DYNAMIC_TYPE_CRL);
+}
+
+
 /* Free all CRL resources */
 void FreeCRL(CYASSL_CRL* crl, int dynamic)
 {
-    CRL_Entry* tmp = crl->crlList;
-
     CYASSL_ENTER("FreeCRL");
 
+#ifdef HAVE_CRL_FETCH
+    /* fetcher adds to the set, stop it first */
+    StopCRL_Fetch(crl);
+    pthread_cond_destroy(&crl->fetchCond);
+    pthread_mutex_destroy(&crl->fetchLock);
+    if (crl->fetches)
+        XFREE(crl->fetches, NULL, DYNAMIC_TYPE_CRL);
+    crl->fetches = NULL;
+#endif
+
     if (crl->monitors[0].path)
         XFREE(crl->monitors[0].path, NULL, DYNAMIC_TYPE_CRL_MONITOR);
 
     if (crl->monitors[1].path)
         XFREE(crl->monitors[1].path, NULL, DYNAMIC_TYPE_CRL_MONITOR);
 
-    while(tmp) {
-        CRL_Entry* next = tmp->next;
-        FreeCRL_Entry(tmp);
-        XFREE(tmp, NULL, DYNAMIC_TYPE_CRL_ENTRY);
-        tmp = next;
-    }	
-
 #ifdef HAVE_CRL_MONITOR
     if (crl->tid != 0) {
         CYASSL_MSG("stopping monitor thread");
@@ -127,6 +393,11 @@ void FreeCRL(CYASSL_CRL* crl, int dynamic)
         }
     }
 #endif
+    /* monitor is done swapping, free the set last */
+    if (crl->crlSet)
+        FreeCRL_Set(crl->crlSet);
+    crl->crlSet = NULL;
+
     FreeMutex(&crl->crlLock);
     if (dynamic)   /* free self */
         XFREE(crl, NULL, DYNAMIC_TYPE_CRL);
@@ -136,25 +407,33 @@ void FreeCRL(CYASSL_CRL* crl, int dynamic)
 /* Is the cert ok with CRL, return 0 on success */
 int CheckCertCRL(CYASSL_CRL* crl, DecodedCert* cert)
 {
+    CRL_Set*   set;
     CRL_Entry* crle;
     int        foundEntry = 0;
     int        ret = 0;
+    int        epoch;
 
     CYASSL_ENTER("CheckCertCRL");
+    CYASSL_STAT_INC(crlLookups);
 
-    if (LockMutex(&crl->crlLock) != 0) {
+    if (LockCRL_Read(crl, &epoch) != 0) {
         CYASSL_MSG("LockMutex failed");
         return BAD_MUTEX_E;
     }
 
-    crle = crl->crlList;
+    set  = CRL_LOAD(crl->crlSet);
+    crle = CRL_LOAD(set->crlTable[HashCRL_Issuer(cert->issuerHash)]);
 
     while (crle) {
         if (XMEMCMP(crle->issuerHash, cert->issuerHash, SHA_DIGEST_SIZE) == 0) {
             CYASSL_MSG("Found CRL Entry on list");
             CYASSL_MSG("Checking next date validity");
 
+        #ifdef HAVE_DATE_EPOCH
+            if (!ValidateEpoch(crle->nextEpoch, AFTER)) {
+        #else
             if (!ValidateDate(crle->nextDate, crle->nextDateFormat, AFTER)) {
+        #endif
                 CYASSL_MSG("CRL next date is no longer valid");
                 ret = ASN_AFTER_DATE_E;
             }
@@ -162,39 +441,61 @@ int CheckCertCRL(CYASSL_CRL* crl, DecodedCert* cert)
                 foundEntry = 1;
             break;
         }
-        crle = crle->next;
+        crle = CRL_LOAD(crle->next);
     }
 
     if (foundEntry) {
-        RevokedCert* rc = crle->certs;
-
-        while (rc) {
-            if (XMEMCMP(rc->serialNumber, cert->serial, rc->serialSz) == 0) {
+        int lo = 0;
+        int hi = crle->totalCerts - 1;
+
+        /* binary search the sorted serials */
+        while (lo <= hi) {
+            int         mid = lo + (hi - lo) / 2;
+            const byte* sn  = crle->serials + crle->serialIdx[mid];
+            int         cmp = CompareSerial(sn + 1, sn[0],
+                                            cert->serial, cert->serialSz);
+            if (cmp == 0) {
                 CYASSL_MSG("Cert revoked");
                 ret = CRL_CERT_REVOKED;
                 break;
             }
-            rc = rc->next;	
+            if (cmp < 0)
+                lo = mid + 1;
+            else
+                hi = mid - 1;
         }
     }
 
-    UnLockMutex(&crl->crlLock);
+    UnLockCRL_Read(crl, epoch);
 
     if (foundEntry == 0) {
         CYASSL_MSG("Couldn't find CRL for status check");
         ret = CRL_MISSING;
-        if (crl->cm->cbMissingCRL) {
-            char url[256];
+    }
+
+    if ((foundEntry == 0 && crl->cm->cbMissingCRL) || CRL_FETCHING(crl, ret)) {
+        char url[256];
+
+        url[0] = '\0';
+        if (DecodePendingExtensions(cert) != 0) {
+            CYASSL_MSG("Couldn't decode CRL distribution points");
+        }
+        if (cert->extCrlInfoSz < (int)sizeof(url) -1 ) {
+            XMEMCPY(url, cert->extCrlInfo, cert->extCrlInfoSz);
+            url[cert->extCrlInfoSz] = '\0';
+        }
+        else  {
+            CYASSL_MSG("CRL url too long");
+        }
+
+    #ifdef HAVE_CRL_FETCH
+        /* the fetcher gets it for later checks, this one doesn't wait */
+        if (CRL_FETCHING(crl, ret) && url[0] != '\0')
+            QueueCRL_Fetch(crl, cert->issuerHash, url);
+    #endif
 
+        if (foundEntry == 0 && crl->cm->cbMissingCRL) {
             CYASSL_MSG("Issuing missing CRL callback");
-            url[0] = '\0';
-            if (cert->extCrlInfoSz < (int)sizeof(url) -1 ) {
-                XMEMCPY(url, cert->extCrlInfo, cert->extCrlInfoSz);
-                url[cert->extCrlInfoSz] = '\0';
-            }
-            else  {
-                CYASSL_MSG("CRL url too long");
-            }
             crl->cm->cbMissingCRL(url);
         }
     }
@@ -208,6 +509,7 @@ int CheckCertCRL(CYASSL_CRL* crl, DecodedCert* cert)
 static int AddCRL(CYASSL_CRL* crl, DecodedCRL* dcrl)
 {
     CRL_Entry* crle;
+    word32     row;
 
     CYASSL_ENTER("AddCRL");
 
@@ -222,6 +524,7 @@ static int AddCRL(CYASSL_CRL* crl, DecodedCRL* dcrl)
         XFREE(crle, NULL, DYNAMIC_TYPE_CRL_ENTRY);
         return -1;
     }
+    row = HashCRL_Issuer(crle->issuerHash);
 
     if (LockMutex(&crl->crlLock) != 0) {
         CYASSL_MSG("LockMutex failed");
@@ -229,8 +532,9 @@ static int AddCRL(CYASSL_CRL* crl, DecodedCRL* dcrl)
         XFREE(crle, NULL, DYNAMIC_TYPE_CRL_ENTRY);
         return BAD_MUTEX_E;
     }
-    crle->next = crl->crlList;
-    crl->crlList = crle;
+    /* complete before it's visible, lookups walk the row without the lock */
+    crle->next = crl->crlSet->crlTable[row];
+    CRL_STORE(crl->crlSet->crlTable[row], crle);
     UnLockMutex(&crl->crlLock);
 
     return 0;
@@ -307,6 +611,639 @@ int BufferLoadCRL(CYASSL_CRL* crl, const byte* buff, long sz, int type)
 }
 
 
+#ifndef CRL_PEM_LINE_SZ
+    #define CRL_PEM_LINE_SZ 80      /* header lines looked at, longer text
+                                       lines around the PEM just get skipped */
+#endif
+
+#define CRL_PEM_B64_SZ  64          /* base64 chars decoded at once */
+
+enum {
+    CRL_PEM_HEADER = 0,             /* looking for the BEGIN line */
+    CRL_PEM_BODY,                   /* decoding base64 */
+    CRL_PEM_DONE                    /* hit the END line or end of input */
+};
+
+/* streams the DER out of a PEM CRL, a line of base64 at a time */
+typedef struct CRL_PemStream {
+    CbCRLRead read;                         /* raw input callback */
+    void*     ctx;                          /* raw input context */
+    int       state;                        /* CRL_PEM_ state */
+    int       inSz;                         /* raw bytes in in */
+    int       inIdx;                        /* next raw byte */
+    int       lineSz;                       /* header line bytes */
+    int       b64Sz;                        /* base64 chars pending */
+    int       outSz;                        /* decoded bytes in out */
+    int       outIdx;                       /* next decoded byte */
+    byte      in[FILE_BUFFER_SIZE];         /* raw input */
+    byte      line[CRL_PEM_LINE_SZ];        /* header search line */
+    byte      b64[CRL_PEM_B64_SZ];          /* base64 not yet decoded */
+    byte      out[CRL_PEM_B64_SZ / 4 * 3];  /* decoded, not yet read */
+} CRL_PemStream;
+
+
+/* decode the pending base64 into out, 0 on success */
+static int CRL_PemFlush(CRL_PemStream* pem)
+{
+    word32 outSz = sizeof(pem->out);
+
+    if (pem->b64Sz == 0)
+        return 0;
+
+    if ((pem->b64Sz % 4) != 0 ||
+               Base64_Decode(pem->b64, pem->b64Sz, pem->out, &outSz) != 0) {
+        CYASSL_MSG("CRL PEM base64 decode failed");
+        return ASN_INPUT_E;
+    }
+
+    pem->b64Sz  = 0;
+    pem->outSz  = outSz;
+    pem->outIdx = 0;
+
+    return 0;
+}
+
+
+/* run raw input through the PEM states until there's decoded output or the
+   CRL is done, 0 on success */
+static int CRL_PemDecode(CRL_PemStream* pem)
+{
+    static const char header[] = "-----BEGIN X509 CRL-----";
+    int ret;
+
+    while (pem->outIdx >= pem->outSz && pem->state != CRL_PEM_DONE) {
+        byte c;
+
+        if (pem->inIdx >= pem->inSz) {
+            pem->inIdx = 0;
+            pem->inSz  = pem->read(pem->ctx, pem->in, sizeof(pem->in));
+            if (pem->inSz < 0) {
+                CYASSL_MSG("CRL read callback failed");
+                return pem->inSz;
+            }
+            if (pem->inSz == 0) {
+                pem->state = CRL_PEM_DONE;
+                return CRL_PemFlush(pem);
+            }
+        }
+        c = pem->in[pem->inIdx++];
+
+        if (pem->state == CRL_PEM_HEADER) {
+            if (c == '\n') {
+                if (pem->lineSz >= (int)sizeof(header) - 1 &&
+                        XMEMCMP(pem->line, header, sizeof(header) - 1) == 0)
+                    pem->state = CRL_PEM_BODY;
+                pem->lineSz = 0;
+            }
+            else if (pem->lineSz < (int)sizeof(pem->line))
+                pem->line[pem->lineSz++] = c;
+        }
+        else if (c == '-') {            /* END line, base64 has no dashes */
+            pem->state = CRL_PEM_DONE;
+            if ((ret = CRL_PemFlush(pem)) != 0)
+                return ret;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            pem->b64[pem->b64Sz++] = c;
+            if (pem->b64Sz == CRL_PEM_B64_SZ &&
+                                           (ret = CRL_PemFlush(pem)) != 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+
+/* CRL input callback giving the DER inside a PEM CRL stream */
+static int CRL_PemRead(void* ctx, byte* buf, int sz)
+{
+    CRL_PemStream* pem = (CRL_PemStream*)ctx;
+    int            got = 0;
+    int            ret;
+
+    while (got < sz) {
+        int n = pem->outSz - pem->outIdx;
+
+        if (n == 0) {
+            if (pem->state == CRL_PEM_DONE)
+                break;
+            if ((ret = CRL_PemDecode(pem)) != 0)
+                return ret;
+            continue;
+        }
+        if (n > sz - got)
+            n = sz - got;
+
+        XMEMCPY(buf + got, pem->out + pem->outIdx, n);
+        pem->outIdx += n;
+        got         += n;
+    }
+
+    return got;
+}
+
+
+/* Load CRL from a read callback of type, parsing as it streams in so only a
+   window of the input is in memory, SSL_SUCCESS on ok */
+int StreamLoadCRL(CYASSL_CRL* crl, CbCRLRead cb, void* ctx, int type)
+{
+    int            ret;
+    CRL_PemStream* pem = NULL;
+#ifdef CYASSL_SMALL_STACK
+    DecodedCRL*    dcrl;
+#else
+    DecodedCRL     dcrl[1];
+#endif
+
+    CYASSL_ENTER("StreamLoadCRL");
+
+    if (crl == NULL || cb == NULL)
+        return BAD_FUNC_ARG;
+
+    if (type == SSL_FILETYPE_PEM) {
+        pem = (CRL_PemStream*)XMALLOC(sizeof(CRL_PemStream), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+        if (pem == NULL)
+            return MEMORY_E;
+
+        XMEMSET(pem, 0, sizeof(CRL_PemStream));
+        pem->read  = cb;
+        pem->ctx   = ctx;
+        pem->state = CRL_PEM_HEADER;
+
+        cb  = CRL_PemRead;
+        ctx = pem;
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    dcrl = (DecodedCRL*)XMALLOC(sizeof(DecodedCRL), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (dcrl == NULL) {
+        if (pem)
+            XFREE(pem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+        return MEMORY_E;
+    }
+#endif
+
+    InitDecodedCRL(dcrl);
+    ret = ParseCRL_Stream(dcrl, cb, ctx, crl->cm);
+    if (ret != 0) {
+        CYASSL_MSG("ParseCRL_Stream error");
+    }
+    else {
+        ret = AddCRL(crl, dcrl);
+        if (ret != 0) {
+            CYASSL_MSG("AddCRL error");
+        }
+    }
+
+    FreeDecodedCRL(dcrl);
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(dcrl, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    if (pem)
+        XFREE(pem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    return ret ? ret : SSL_SUCCESS; /* convert 0 to SSL_SUCCESS */
+}
+
+
+/* CRL read callback for a file */
+static int CRL_FileRead(void* ctx, byte* buf, int sz)
+{
+    return (int)XFREAD(buf, 1, sz, (XFILE)ctx);
+}
+
+
+/* Load CRL file of type, streamed in, SSL_SUCCESS on ok */
+static int LoadCRL_File(CYASSL_CRL* crl, const char* name, int type)
+{
+    int   ret;
+    XFILE file = XFOPEN(name, "rb");
+
+    if (file == XBADFILE)
+        return SSL_BAD_FILE;
+
+    ret = StreamLoadCRL(crl, CRL_FileRead, file, type);
+    XFCLOSE(file);
+
+    /* signatures over the whole TBS, like Ed25519, need it all in memory */
+    if (ret == ASN_SIG_HASH_E) {
+        CYASSL_MSG("CRL can't be streamed, loading whole file");
+        ret = ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl);
+    }
+
+    return ret;
+}
+
+
+/* copy of path for the monitor or an entry's source, freed with XFREE like
+   the rest of crl */
+static char* CopyMonitorPath(const char* path)
+{
+    word32 len = (word32)XSTRLEN(path) + 1;
+    char*  copy = (char*)XMALLOC(len, NULL, DYNAMIC_TYPE_CRL_MONITOR);
+
+    if (copy)
+        XMEMCPY(copy, path, len);
+
+    return copy;
+}
+
+
+/* is name a CRL file LoadCRL reads for type, 1 if so */
+static int CRL_FileMatchesType(const char* name, int type)
+{
+    if (type == SSL_FILETYPE_PEM)
+        return strstr(name, ".pem") != NULL;
+
+    return strstr(name, ".der") != NULL || strstr(name, ".crl") != NULL;
+}
+
+
+/* put the entries of newSet, all from source, a file name or URL, in place
+   of those from an earlier load of source. newSet may be NULL to only drop
+   them. Lookups see either an old entry or its replacement, unlinked ones
+   are freed once no lookup can hold them. 0 on success */
+static int ReplaceCRL_Source(CYASSL_CRL* crl, const char* source,
+                             CRL_Set* newSet)
+{
+    CRL_Entry* retired  = NULL;
+    word32     sourceSz = (word32)XSTRLEN(source) + 1;   /* with the 0 */
+    int        row;
+
+    if (newSet) {
+        for (row = 0; row < CRL_TABLE_SIZE; row++) {
+            CRL_Entry* crle;
+
+            for (crle = newSet->crlTable[row]; crle; crle = crle->next) {
+                crle->source = CopyMonitorPath(source);
+                if (crle->source == NULL) {
+                    FreeCRL_Set(newSet);
+                    return MEMORY_E;
+                }
+            }
+        }
+    }
+
+    if (LockMutex(&crl->crlLock) != 0) {
+        CYASSL_MSG("LockMutex failed");
+        if (newSet)
+            FreeCRL_Set(newSet);
+        return BAD_MUTEX_E;
+    }
+
+    for (row = 0; row < CRL_TABLE_SIZE; row++) {
+        CRL_Entry** prev = &crl->crlSet->crlTable[row];
+        CRL_Entry*  crle = *prev;
+
+        /* unlink, a lookup standing on crle still finds the rest of the row */
+        while (crle) {
+            if (crle->source && XSTRNCMP(crle->source, source, sourceSz) == 0){
+                CRL_STORE(*prev, crle->next);
+                crle->retired = retired;
+                retired = crle;
+            }
+            else
+                prev = &crle->next;
+            crle = crle->next;
+        }
+
+        /* complete before they're visible, like AddCRL */
+        if (newSet) {
+            while ((crle = newSet->crlTable[row]) != NULL) {
+                newSet->crlTable[row] = crle->next;
+                crle->next = crl->crlSet->crlTable[row];
+                CRL_STORE(crl->crlSet->crlTable[row], crle);
+            }
+        }
+    }
+
+    if (retired)
+        WaitCRL_Readers(crl);
+
+    UnLockMutex(&crl->crlLock);
+
+    while (retired) {
+        CRL_Entry* next = retired->retired;
+        FreeCRL_Entry(retired);
+        XFREE(retired, NULL, DYNAMIC_TYPE_CRL_ENTRY);
+        retired = next;
+    }
+    if (newSet)
+        FreeCRL_Set(newSet);   /* rows are empty now */
+
+    return 0;
+}
+
+
+/* Load CRL file name of type on its own, its entries replace those from an
+   earlier load of the same file. A file that's gone drops them, one that
+   doesn't parse keeps them. SSL_SUCCESS on ok */
+static int ReloadCRL_File(CYASSL_CRL* crl, const char* name, int type)
+{
+    int      ret;
+    CRL_Set* newSet = NULL;
+#ifdef CYASSL_SMALL_STACK
+    CYASSL_CRL* tmp;
+#else
+    CYASSL_CRL tmp[1];
+#endif
+
+#ifdef CYASSL_SMALL_STACK
+    tmp = (CYASSL_CRL*)XMALLOC(sizeof(CYASSL_CRL), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (tmp == NULL)
+        return MEMORY_E;
+#endif
+
+    ret = InitCRL(tmp, crl->cm);
+    if (ret == 0) {
+        /* parse outside crlLock, lookups and other loads go on meanwhile */
+        ret = LoadCRL_File(tmp, name, type);
+        if (ret == SSL_SUCCESS) {
+            newSet      = tmp->crlSet;
+            tmp->crlSet = NULL;
+        }
+        FreeCRL(tmp, 0);
+
+        if (ret == SSL_SUCCESS || ret == SSL_BAD_FILE) {
+            ret = ReplaceCRL_Source(crl, name, newSet);
+            if (ret == 0)
+                ret = SSL_SUCCESS;
+        }
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+#ifdef HAVE_CRL_FETCH
+
+/* seconds until the CRLs of set should be fetched again, a quarter of their
+   time left before the earliest next update */
+static int CRL_FetchWait(CRL_Set* set)
+{
+#ifdef HAVE_DATE_EPOCH
+    word64 next = 0;
+    word64 now  = (word64)time(0);
+    int    row;
+
+    for (row = 0; row < CRL_TABLE_SIZE; row++) {
+        CRL_Entry* crle;
+
+        for (crle = set->crlTable[row]; crle; crle = crle->next) {
+            if (next == 0 || crle->nextEpoch < next)
+                next = crle->nextEpoch;
+        }
+    }
+
+    if (next > now) {
+        word64 left = next - now;
+
+        left -= left / 4;
+        if (left > CRL_FETCH_RETRY)
+            return left > 0x7fffffff ? 0x7fffffff : (int)left;
+    }
+
+    return CRL_FETCH_RETRY;
+#else
+    (void)set;
+    return CRL_FETCH_INTERVAL;
+#endif
+}
+
+
+/* Download the CRL at url and cache it in place of the last one from there,
+   parsing and checking it outside crlLock. return seconds until it should be
+   fetched again, < 0 on error */
+static int FetchCRL(CYASSL_CRL* crl, const char* url)
+{
+    int      ret;
+    int      derSz;
+    int      wait = 0;
+    byte*    der  = NULL;
+    CRL_Set* newSet;
+#ifdef CYASSL_SMALL_STACK
+    CYASSL_CRL* tmp;
+#else
+    CYASSL_CRL tmp[1];
+#endif
+
+    CYASSL_ENTER("FetchCRL");
+
+    derSz = EmbedCrlLookup(url, (int)XSTRLEN(url), &der);
+    if (derSz <= 0) {
+        CYASSL_MSG("CRL download failed");
+        return -1;
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    tmp = (CYASSL_CRL*)XMALLOC(sizeof(CYASSL_CRL), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (tmp == NULL) {
+        XFREE(der, NULL, DYNAMIC_TYPE_IN_BUFFER);
+        return MEMORY_E;
+    }
+#endif
+
+    ret = InitCRL(tmp, crl->cm);
+    if (ret == 0) {
+        /* distribution points serve DER, the signature is checked here */
+        ret = BufferLoadCRL(tmp, der, derSz, SSL_FILETYPE_ASN1);
+        if (ret == SSL_SUCCESS) {
+            newSet      = tmp->crlSet;
+            tmp->crlSet = NULL;
+            wait        = CRL_FetchWait(newSet);
+            ret         = ReplaceCRL_Source(crl, url, newSet);
+        }
+        FreeCRL(tmp, 0);
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+    XFREE(der, NULL, DYNAMIC_TYPE_IN_BUFFER);
+
+    return ret == 0 ? wait : -1;
+}
+
+
+/* Queue url for issuer unless it's already kept, never blocks on a fetch */
+static void QueueCRL_Fetch(CYASSL_CRL* crl, const byte* issuerHash,
+                           const char* url)
+{
+    int i;
+
+    if (XSTRLEN(url) >= CRL_FETCH_URL_SZ) {
+        CYASSL_MSG("CRL fetch url too long");
+        return;
+    }
+
+    pthread_mutex_lock(&crl->fetchLock);
+
+    for (i = 0; i < crl->fetchCount; i++) {
+        if (XMEMCMP(crl->fetches[i].issuerHash, issuerHash,
+                                                    CRL_DIGEST_SIZE) == 0)
+            break;
+    }
+
+    /* known issuers are fetched on their own schedule, or backing off */
+    if (i == crl->fetchCount) {
+        if (crl->fetchCount == CRL_FETCH_MAX) {
+            CYASSL_MSG("CRL fetch table full");
+        }
+        else {
+            CRL_Fetch* fetch = &crl->fetches[crl->fetchCount++];
+
+            XMEMCPY(fetch->issuerHash, issuerHash, CRL_DIGEST_SIZE);
+            XSTRNCPY(fetch->url, url, CRL_FETCH_URL_SZ);
+            fetch->refresh = LowResTimer();
+            pthread_cond_signal(&crl->fetchCond);
+        }
+    }
+
+    pthread_mutex_unlock(&crl->fetchLock);
+}
+
+
+/* Tell the fetcher to exit and wait for it */
+static void StopCRL_Fetch(CYASSL_CRL* crl)
+{
+    if (crl->fetchTid == 0)
+        return;
+
+    CYASSL_MSG("stopping CRL fetch thread");
+
+    pthread_mutex_lock(&crl->fetchLock);
+    crl->fetchStop = 1;
+    pthread_cond_signal(&crl->fetchCond);
+    pthread_mutex_unlock(&crl->fetchLock);
+
+    pthread_join(crl->fetchTid, NULL);
+    crl->fetchTid = 0;
+}
+
+
+/* Fetcher thread, sleeps until the next distribution point is due, fetches
+   it and schedules the one after, until stopped */
+static void* DoCrlFetch(void* arg)
+{
+    CYASSL_CRL* crl = (CYASSL_CRL*)arg;
+    char        url[CRL_FETCH_URL_SZ];
+
+    CYASSL_ENTER("DoCrlFetch");
+
+    for (;;) {
+        int    due = -1;
+        int    wait;
+        word32 now;
+
+        pthread_mutex_lock(&crl->fetchLock);
+        while (!crl->fetchStop) {
+            word32 next = 0;
+            int    i;
+
+            now = LowResTimer();
+            for (i = 0; i < crl->fetchCount; i++) {
+                if ((int)(crl->fetches[i].refresh - now) <= 0) {
+                    due = i;
+                    break;
+                }
+                if (next == 0 || (int)(crl->fetches[i].refresh - next) < 0)
+                    next = crl->fetches[i].refresh;
+            }
+            if (due >= 0)
+                break;
+
+            if (next == 0)
+                pthread_cond_wait(&crl->fetchCond, &crl->fetchLock);
+            else {
+                struct timespec wake;
+
+                clock_gettime(CLOCK_REALTIME, &wake);
+                wake.tv_sec += next - now;
+                pthread_cond_timedwait(&crl->fetchCond, &crl->fetchLock,
+                                       &wake);
+            }
+        }
+
+        if (crl->fetchStop) {
+            pthread_mutex_unlock(&crl->fetchLock);
+            break;
+        }
+
+        /* a failed fetch backs off, entries stay put so due stays valid */
+        XMEMCPY(url, crl->fetches[due].url, CRL_FETCH_URL_SZ);
+        crl->fetches[due].refresh = now + CRL_FETCH_RETRY;
+        pthread_mutex_unlock(&crl->fetchLock);
+
+        wait = FetchCRL(crl, url);
+        if (wait < 0) {
+            CYASSL_MSG("\tCRL fetch failed, will retry");
+            continue;
+        }
+
+        pthread_mutex_lock(&crl->fetchLock);
+        crl->fetches[due].refresh = LowResTimer() + wait;
+        pthread_mutex_unlock(&crl->fetchLock);
+    }
+
+    return NULL;
+}
+
+
+/* Start fetching missing and expiring CRLs from their certs' distribution
+   points in the background */
+int StartCRL_Fetch(CYASSL_CRL* crl)
+{
+    CYASSL_ENTER("StartCRL_Fetch");
+
+    if (crl == NULL)
+        return BAD_FUNC_ARG;
+
+    if (crl->fetchTid != 0) {
+        CYASSL_MSG("CRL fetch thread already running");
+        return SSL_SUCCESS;
+    }
+
+    if (crl->fetches == NULL) {
+        crl->fetches = (CRL_Fetch*)XMALLOC(sizeof(CRL_Fetch) * CRL_FETCH_MAX,
+                                           NULL, DYNAMIC_TYPE_CRL);
+        if (crl->fetches == NULL)
+            return MEMORY_E;
+    }
+
+    crl->fetchStop = 0;
+    if (pthread_create(&crl->fetchTid, NULL, DoCrlFetch, crl) != 0) {
+        CYASSL_MSG("Thread creation error");
+        crl->fetchTid = 0;
+        return THREAD_CREATE_E;
+    }
+
+    return SSL_SUCCESS;
+}
+
+#else /* HAVE_CRL_FETCH */
+
+int StartCRL_Fetch(CYASSL_CRL* crl)
+{
+    (void)crl;
+
+    CYASSL_ENTER("StartCRL_Fetch");
+    CYASSL_MSG("Not compiled in");
+
+    return NOT_COMPILED_IN;
+}
+
+#endif /* HAVE_CRL_FETCH */
+
+
 #ifdef HAVE_CRL_MONITOR
 
 
@@ -314,7 +1251,7 @@ int BufferLoadCRL(CYASSL_CRL* crl, const byte* buff, long sz, int type)
 static int SwapLists(CYASSL_CRL* crl)
 {
     int        ret;
-    CRL_Entry* newList;
+    CRL_Set*   newSet;
 #ifdef CYASSL_SMALL_STACK
     CYASSL_CRL* tmp;    
 #else
@@ -368,11 +1305,12 @@ static int SwapLists(CYASSL_CRL* crl)
         return -1;
     }
 
-    newList = tmp->crlList;
-
-    /* swap lists */
-    tmp->crlList  = crl->crlList;
-    crl->crlList = newList;
+    /* publish the new set whole, then free the old one when no lookup can
+       still be using it */
+    newSet      = tmp->crlSet;
+    tmp->crlSet = crl->crlSet;
+    CRL_STORE(crl->crlSet, newSet);
+    WaitCRL_Readers(crl);
 
     UnLockMutex(&crl->crlLock);
 
@@ -515,6 +1453,7 @@ static void* DoMonitor(void* arg)
 #include <sys/inotify.h>
 #include <sys/eventfd.h>
 #include <unistd.h>
+#include <time.h>
 
 
 #ifndef max
@@ -525,6 +1464,91 @@ static void* DoMonitor(void* arg)
 #endif /* max */
 
 
+#ifndef CRL_MONITOR_QUIET_MS
+    #define CRL_MONITOR_QUIET_MS   200   /* reload after this long quiet */
+#endif
+#ifndef CRL_MONITOR_MAX_DELAY
+    #define CRL_MONITOR_MAX_DELAY    2   /* seconds, reload even if busy */
+#endif
+#ifndef CRL_MONITOR_MAX_CHANGES
+    #define CRL_MONITOR_MAX_CHANGES 64   /* more files reload both dirs */
+#endif
+
+
+/* CRL files changed since the last reload, a burst of events on one file
+   leaves one name here */
+typedef struct CRL_Changes {
+    int    count;
+    int    all;                        /* reload both dirs whole */
+    time_t first;                      /* when the oldest change came */
+    int    type[CRL_MONITOR_MAX_CHANGES];
+    char   name[CRL_MONITOR_MAX_CHANGES][MAX_FILENAME_SZ];
+} CRL_Changes;
+
+
+/* note file in monitored dir mon changed */
+static void AddCRL_Change(CRL_Changes* changes, CRL_Monitor* mon,
+                          const char* file)
+{
+    char* name;
+    int   i;
+
+    if (!CRL_FileMatchesType(file, mon->type))
+        return;
+
+    if (changes->count == 0 && !changes->all)
+        changes->first = time(0);
+
+    if (changes->all)
+        return;
+
+    if (changes->count == CRL_MONITOR_MAX_CHANGES ||
+            XSTRLEN(mon->path) + 1 + XSTRLEN(file) >= MAX_FILENAME_SZ/2) {
+        changes->all = 1;
+        return;
+    }
+
+    /* same name LoadCRL builds, the entries are tagged with it */
+    name = changes->name[changes->count];
+    XMEMSET(name, 0, MAX_FILENAME_SZ);
+    XSTRNCPY(name, mon->path, MAX_FILENAME_SZ/2 - 2);
+    XSTRNCAT(name, "/", 1);
+    XSTRNCAT(name, file, MAX_FILENAME_SZ/2);
+
+    for (i = 0; i < changes->count; i++) {
+        if (changes->type[i] == mon->type &&
+                XSTRNCMP(changes->name[i], name, MAX_FILENAME_SZ) == 0)
+            return;
+    }
+
+    changes->type[changes->count++] = mon->type;
+}
+
+
+/* reload what changed, only those files unless there were too many */
+static void ApplyCRL_Changes(CYASSL_CRL* crl, CRL_Changes* changes)
+{
+    int i;
+
+    if (changes->all) {
+        if (SwapLists(crl) < 0) {
+            CYASSL_MSG("SwapLists problem, continue");
+        }
+    }
+    else {
+        for (i = 0; i < changes->count; i++) {
+            if (ReloadCRL_File(crl, changes->name[i], changes->type[i])
+                                                              != SSL_SUCCESS) {
+                CYASSL_MSG("CRL file reload problem, continue");
+            }
+        }
+    }
+
+    changes->count = 0;
+    changes->all   = 0;
+}
+
+
 /* shutdown monitor thread, 0 on success */
 static int StopMonitor(int mfd)
 {
@@ -540,16 +1564,19 @@ static int StopMonitor(int mfd)
 }
 
 
-/* linux monitoring */
+/* linux monitoring, events name the file so only it is reloaded, after the
+   dir has been quiet a moment so a burst of writes reloads it once */
 static void* DoMonitor(void* arg)
 {
-    int         notifyFd;
-    int         wd  = -1;
-    CYASSL_CRL* crl = (CYASSL_CRL*)arg;
+    int          notifyFd;
+    int          i;
+    int          wd[2] = { -1, -1 };
+    CYASSL_CRL*  crl = (CYASSL_CRL*)arg;
+    CRL_Changes* changes;
 #ifdef CYASSL_SMALL_STACK
-    char*       buff;
+    char*        buff;
 #else
-    char        buff[8192];
+    char         buff[8192];
 #endif
 
     CYASSL_ENTER("DoMonitor");
@@ -567,52 +1594,67 @@ static void* DoMonitor(void* arg)
         return NULL;
     }
 
-    if (crl->monitors[0].path) {
-        wd = inotify_add_watch(notifyFd, crl->monitors[0].path, IN_CLOSE_WRITE |
-                                                                IN_DELETE);
-        if (wd < 0) {
-            CYASSL_MSG("PEM notify add watch failed");
-            close(crl->mfd);
-            close(notifyFd);
-            return NULL;
-        }
-    }
+    for (i = 0; i < 2; i++) {
+        if (crl->monitors[i].path == NULL)
+            continue;
 
-    if (crl->monitors[1].path) {
-        wd = inotify_add_watch(notifyFd, crl->monitors[1].path, IN_CLOSE_WRITE |
-                                                                IN_DELETE);
-        if (wd < 0) {
-            CYASSL_MSG("DER notify add watch failed");
+        wd[i] = inotify_add_watch(notifyFd, crl->monitors[i].path,
+                         IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_TO |
+                         IN_MOVED_FROM);
+        if (wd[i] < 0) {
+            CYASSL_MSG(i == 0 ? "PEM notify add watch failed"
+                              : "DER notify add watch failed");
             close(crl->mfd);
             close(notifyFd);
             return NULL;
         }
     }
 
+    changes = (CRL_Changes*)XMALLOC(sizeof(CRL_Changes), NULL,
+                                    DYNAMIC_TYPE_TMP_BUFFER);
+    if (changes == NULL)
+        return NULL;
+    XMEMSET(changes, 0, sizeof(CRL_Changes));
+
 #ifdef CYASSL_SMALL_STACK
     buff = (char*)XMALLOC(8192, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-    if (buff == NULL)
+    if (buff == NULL) {
+        XFREE(changes, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         return NULL;
+    }
 #endif
 
     for (;;) {
-        fd_set readfds;
-        int    result;
-        int    length;
+        fd_set         readfds;
+        struct timeval quiet;
+        int            pending = changes->count > 0 || changes->all;
+        int            result;
+        int            length;
 
         FD_ZERO(&readfds);
         FD_SET(notifyFd, &readfds);
         FD_SET(crl->mfd, &readfds);
 
-        result = select(max(notifyFd, crl->mfd) + 1, &readfds, NULL, NULL,NULL);
-       
-        CYASSL_MSG("Got notify event");
+        quiet.tv_sec  = CRL_MONITOR_QUIET_MS / 1000;
+        quiet.tv_usec = (CRL_MONITOR_QUIET_MS % 1000) * 1000;
+
+        /* block until a change, then only until the dir goes quiet */
+        result = select(max(notifyFd, crl->mfd) + 1, &readfds, NULL, NULL,
+                        pending ? &quiet : NULL);
 
         if (result < 0) {
             CYASSL_MSG("select problem, continue");
             continue;
         }
 
+        if (result == 0) {
+            CYASSL_MSG("CRL dirs quiet, reloading changes");
+            ApplyCRL_Changes(crl, changes);
+            continue;
+        }
+
+        CYASSL_MSG("Got notify event");
+
         if (FD_ISSET(crl->mfd, &readfds)) {
             CYASSL_MSG("got custom shutdown event, breaking out");
             break;
@@ -624,17 +1666,47 @@ static void* DoMonitor(void* arg)
             continue;
         } 
 
-        if (SwapLists(crl) < 0) {
-            CYASSL_MSG("SwapLists problem, continue");
+        for (i = 0; i + (int)sizeof(struct inotify_event) <= length; ) {
+            struct inotify_event event;
+            const char*          file = buff + i + sizeof(event);
+
+            XMEMCPY(&event, buff + i, sizeof(event));
+            i += sizeof(event) + event.len;
+
+            if (event.mask & IN_Q_OVERFLOW) {
+                CYASSL_MSG("notify queue overflow, reloading all");
+                if (changes->count == 0 && !changes->all)
+                    changes->first = time(0);
+                changes->all = 1;
+                continue;
+            }
+            if (event.len == 0 || i > length)
+                continue;
+
+            /* both types may watch the same dir, names sort them out */
+            if (event.wd == wd[0])
+                AddCRL_Change(changes, &crl->monitors[0], file);
+            if (event.wd == wd[1])
+                AddCRL_Change(changes, &crl->monitors[1], file);
+        }
+
+        /* steady writes never go quiet, don't wait on them forever */
+        if ((changes->count > 0 || changes->all) &&
+                time(0) - changes->first >= CRL_MONITOR_MAX_DELAY) {
+            CYASSL_MSG("CRL dirs still busy, reloading changes");
+            ApplyCRL_Changes(crl, changes);
         }
     }
 
 #ifdef CYASSL_SMALL_STACK
     XFREE(buff, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
+    XFREE(changes, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 
-    if (wd > 0)
-        inotify_rm_watch(notifyFd, wd);
+    for (i = 0; i < 2; i++) {
+        if (wd[i] >= 0)
+            inotify_rm_watch(notifyFd, wd[i]);
+    }
     close(crl->mfd);
     close(notifyFd);
 
@@ -732,23 +1804,12 @@ int LoadCRL(CYASSL_CRL* crl, const char* path, int type, int monitor)
         }
         if (s.st_mode & S_IFREG) {
 
-            if (type == SSL_FILETYPE_PEM) {
-                if (strstr(entry->d_name, ".pem") == NULL) {
-                    CYASSL_MSG("not .pem file, skipping");
-                    continue;
-                }
-            }
-            else {
-                if (strstr(entry->d_name, ".der") == NULL &&
-                    strstr(entry->d_name, ".crl") == NULL) {
-
-                    CYASSL_MSG("not .der or .crl file, skipping");
-                    continue;
-                }
+            if (!CRL_FileMatchesType(entry->d_name, type)) {
+                CYASSL_MSG("not a CRL file for type, skipping");
+                continue;
             }
 
-            if (ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl)
-                                                               != SSL_SUCCESS) {
+            if (ReloadCRL_File(crl, name, type) != SSL_SUCCESS) {
                 CYASSL_MSG("CRL file load failed, continuing");
             }
         }
@@ -762,12 +1823,12 @@ int LoadCRL(CYASSL_CRL* crl, const char* path, int type, int monitor)
         CYASSL_MSG("monitor path requested");
 
         if (type == SSL_FILETYPE_PEM) {
-            crl->monitors[0].path = strdup(path);
+            crl->monitors[0].path = CopyMonitorPath(path);
             crl->monitors[0].type = SSL_FILETYPE_PEM;
             if (crl->monitors[0].path == NULL)
                 ret = MEMORY_E;
         } else {
-            crl->monitors[1].path = strdup(path);
+            crl->monitors[1].path = CopyMonitorPath(path);
             crl->monitors[1].type = SSL_FILETYPE_ASN1;
             if (crl->monitors[1].path == NULL)
                 ret = MEMORY_E;
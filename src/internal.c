@@ -30,6 +30,10 @@
 #include <cyassl/error-ssl.h>
 #include <cyassl/ctaocrypt/asn.h>
 
+#ifdef CYASSL_CRYPTO_DEV
+    #include <cyassl/ctaocrypt/cryptodev.h>
+#endif
+
 #ifdef HAVE_LIBZ
     #include "zlib.h"
 #endif
@@ -50,6 +54,10 @@
     #include <sys/filio.h>
 #endif
 
+#if defined(CYASSL_HANDSHAKE_TIMING) && !defined(USE_WINDOWS_API)
+    #include <sys/time.h>
+#endif
+
 #ifndef TRUE
     #define TRUE  1
 #endif
@@ -67,8 +75,18 @@ CYASSL_CALLBACKS needs LARGE_STATIC_BUFFERS, please add LARGE_STATIC_BUFFERS
     #error Cannot use both secure-renegotiation and renegotiation-indication
 #endif
 
+#if defined(CYASSL_KTLS) && (!defined(HAVE_AESGCM) || defined(CYASSL_USER_IO))
+    #error CYASSL_KTLS needs HAVE_AESGCM and the default socket IO callbacks
+#endif
+
 static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
                         const byte* input, int inSz, int type);
+static int BuildMessageV(CYASSL* ssl, byte* output, int outSz,
+                         const DataVec* in, word32 inOff, int inSz, int type);
+
+#ifdef CYASSL_STATIC_SUITES
+    static word16 StaticSuites(Suites* suites, word16 sz);
+#endif
 
 #ifndef NO_CYASSL_CLIENT
     static int DoHelloVerifyRequest(CYASSL* ssl, const byte* input, word32*,
@@ -84,6 +102,10 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
         static int DoSessionTicket(CYASSL* ssl, const byte* input, word32*,
                                                                         word32);
     #endif
+    #ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+        static int DoCertificateStatus(CYASSL* ssl, byte* input, word32*,
+                                                                        word32);
+    #endif
 #endif
 
 
@@ -101,6 +123,12 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
     static INLINE int DtlsUpdateWindow(DtlsState* state);
 #endif
 
+#ifdef HAVE_OCSP
+    static int  SetOcspPending(CYASSL* ssl, DecodedCert* cert);
+    static int  CheckPendingOCSP(CYASSL* ssl);
+    static void FreeOcspPending(CYASSL* ssl);
+#endif
+
 
 typedef enum {
     doProcessInit = 0,
@@ -253,38 +281,18 @@ static INLINE void ato32(const byte* c, word32* u32)
 
 #ifdef HAVE_LIBZ
 
-    /* alloc user allocs to work with zlib */
-    static void* myAlloc(void* opaque, unsigned int item, unsigned int size)
-    {
-        (void)opaque;
-        return XMALLOC(item * size, opaque, DYNAMIC_TYPE_LIBZ);
-    }
-
-
-    static void myFree(void* opaque, void* memory)
-    {
-        (void)opaque;
-        XFREE(memory, opaque, DYNAMIC_TYPE_LIBZ);
-    }
-
-
     /* init zlib comp/decomp streams, 0 on success */
     static int InitStreams(CYASSL* ssl)
     {
-        ssl->c_stream.zalloc = (alloc_func)myAlloc;
-        ssl->c_stream.zfree  = (free_func)myFree;
-        ssl->c_stream.opaque = (voidpf)ssl->heap;
-
-        if (deflateInit(&ssl->c_stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        if (CompressStreamInit(&ssl->c_stream, COMPRESS_STREAM_DEFLATE, 0,
+                               ssl->heap) != 0)
             return ZLIB_INIT_ERROR;
 
         ssl->didStreamInit = 1;
 
-        ssl->d_stream.zalloc = (alloc_func)myAlloc;
-        ssl->d_stream.zfree  = (free_func)myFree;
-        ssl->d_stream.opaque = (voidpf)ssl->heap;
-
-        if (inflateInit(&ssl->d_stream) != Z_OK) return ZLIB_INIT_ERROR;
+        if (CompressStreamInit(&ssl->d_stream, COMPRESS_STREAM_INFLATE, 0,
+                               ssl->heap) != 0)
+            return ZLIB_INIT_ERROR;
 
         return 0;
     }
@@ -293,8 +301,8 @@ static INLINE void ato32(const byte* c, word32* u32)
     static void FreeStreams(CYASSL* ssl)
     {
         if (ssl->didStreamInit) {
-            deflateEnd(&ssl->c_stream);
-            inflateEnd(&ssl->d_stream);
+            CompressStreamFree(&ssl->c_stream);
+            CompressStreamFree(&ssl->d_stream);
         }
     }
 
@@ -302,36 +310,18 @@ static INLINE void ato32(const byte* c, word32* u32)
     /* compress in to out, return out size or error */
     static int myCompress(CYASSL* ssl, byte* in, int inSz, byte* out, int outSz)
     {
-        int    err;
-        int    currTotal = (int)ssl->c_stream.total_out;
+        int ret = CompressStreamUpdate(&ssl->c_stream, out, outSz, in, inSz);
 
-        ssl->c_stream.next_in   = in;
-        ssl->c_stream.avail_in  = inSz;
-        ssl->c_stream.next_out  = out;
-        ssl->c_stream.avail_out = outSz;
-
-        err = deflate(&ssl->c_stream, Z_SYNC_FLUSH);
-        if (err != Z_OK && err != Z_STREAM_END) return ZLIB_COMPRESS_ERROR;
-
-        return (int)ssl->c_stream.total_out - currTotal;
+        return ret < 0 ? ZLIB_COMPRESS_ERROR : ret;
     }
 
 
     /* decompress in to out, returnn out size or error */
     static int myDeCompress(CYASSL* ssl, byte* in,int inSz, byte* out,int outSz)
     {
-        int    err;
-        int    currTotal = (int)ssl->d_stream.total_out;
-
-        ssl->d_stream.next_in   = in;
-        ssl->d_stream.avail_in  = inSz;
-        ssl->d_stream.next_out  = out;
-        ssl->d_stream.avail_out = outSz;
-
-        err = inflate(&ssl->d_stream, Z_SYNC_FLUSH);
-        if (err != Z_OK && err != Z_STREAM_END) return ZLIB_DECOMPRESS_ERROR;
+        int ret = CompressStreamUpdate(&ssl->d_stream, out, outSz, in, inSz);
 
-        return (int)ssl->d_stream.total_out - currTotal;
+        return ret < 0 ? ZLIB_DECOMPRESS_ERROR : ret;
     }
 
 #endif /* HAVE_LIBZ */
@@ -350,23 +340,58 @@ int InitSSL_Ctx(CYASSL_CTX* ctx, CYASSL_METHOD* method)
 {
     ctx->method = method;
     ctx->refCount = 1;          /* so either CTX_free or SSL_free can release */
+    ctx->rotated  = NULL;
+    XMEMSET(ctx->numaCtx, 0, sizeof(ctx->numaCtx));
+    ctx->numaNodes  = 0;
+    ctx->hsLimit    = 0;
+    ctx->hsInFlight = 0;
+#ifdef CTX_ATOMIC_REF
+    ctx->rotEpoch      = 0;
+    ctx->rotReaders[0] = 0;
+    ctx->rotReaders[1] = 0;
+#endif
 #ifndef NO_CERTS
     ctx->certificate.buffer = 0;
     ctx->certChain.buffer   = 0;
+    ctx->certMsg.buffer     = 0;
     ctx->privateKey.buffer  = 0;
+#ifdef HAVE_ECC
+    ctx->eccCertificate.buffer = 0;
+    ctx->eccCertChain.buffer   = 0;
+    ctx->eccPrivateKey.buffer  = 0;
+#endif
+#ifndef NO_RSA
+    ctx->privateRsaKey      = NULL;
+#endif
+#ifdef HAVE_ECC
+    ctx->privateEccKey      = NULL;
+    ctx->eccSlotKey         = NULL;
+#endif
     ctx->serverDH_P.buffer  = 0;
     ctx->serverDH_G.buffer  = 0;
+#ifndef NO_DH
+    ctx->serverDH_Fb        = NULL;
+#endif
 #endif
     ctx->haveDH             = 0;
     ctx->haveNTRU           = 0;    /* start off */
     ctx->haveECDSAsig       = 0;    /* start off */
     ctx->haveStaticECC      = 0;    /* start off */
+    ctx->dualCert           = 0;
     ctx->heap               = ctx;  /* defaults to self */
+#ifdef CYASSL_MEM_STATS
+    ctx->memStats = CyaSSL_MemStatsNew(NULL);
+    if (ctx->memStats)
+        ctx->heap = ctx->memStats;
+#endif
 #ifndef NO_PSK
     ctx->havePSK            = 0;
     ctx->server_hint[0]     = 0;
     ctx->client_psk_cb      = 0;
     ctx->server_psk_cb      = 0;
+#ifdef HAVE_PSK_STORE
+    XMEMSET(&ctx->pskStore, 0, sizeof(ctx->pskStore));  /* empty */
+#endif
 #endif /* NO_PSK */
 #ifdef HAVE_ANON
     ctx->haveAnon           = 0;
@@ -382,6 +407,12 @@ int InitSSL_Ctx(CYASSL_CTX* ctx, CYASSL_METHOD* method)
     ctx->passwd_cb   = 0;
     ctx->userdata    = 0;
 #endif /* OPENSSL_EXTRA */
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE)
+    ctx->internalCacheOff = 0;
+    ctx->get_sess_cb      = NULL;
+    ctx->new_sess_cb      = NULL;
+    ctx->rem_sess_cb      = NULL;
+#endif
 
     ctx->timeout = CYASSL_SESSION_TIMEOUT;
 
@@ -403,6 +434,9 @@ int InitSSL_Ctx(CYASSL_CTX* ctx, CYASSL_METHOD* method)
         ctx->CBIOCookie = NULL;
     #endif
 #endif /* CYASSL_USER_IO */
+#ifdef CYASSL_DTLS
+    ctx->cookieSecretSz = 0;
+#endif
 #ifdef HAVE_NETX
     ctx->CBIORecv = NetX_Receive;
     ctx->CBIOSend = NetX_Send;
@@ -427,25 +461,77 @@ int InitSSL_Ctx(CYASSL_CTX* ctx, CYASSL_METHOD* method)
     ctx->suites.setSuites = 0;  /* user hasn't set yet */
     /* remove DH later if server didn't set, add psk later */
     InitSuites(&ctx->suites, method->version, TRUE, FALSE, TRUE, ctx->haveNTRU,
-               ctx->haveECDSAsig, ctx->haveStaticECC, method->side);
+               ctx->haveECDSAsig, ctx->haveStaticECC, FALSE, method->side);
     ctx->verifyPeer = 0;
     ctx->verifyNone = 0;
     ctx->failNoCert = 0;
     ctx->sessionCacheOff      = 0;  /* initially on */
     ctx->sessionCacheFlushOff = 0;  /* initially on */
+#ifndef NO_SESSION_CACHE
+    ctx->sessionCache         = NULL;  /* use global cache */
+#endif
     ctx->sendVerify = 0;
     ctx->quietShutdown = 0;
     ctx->groupMessages = 0;
+    ctx->compact       = 0;
+    ctx->falseStart    = 0;
+    ctx->readAhead     = 0;
+    ctx->dynRecordSz   = 0;
+    ctx->dynRecordRamp = 0;
+    ctx->dynRecordIdle = 0;
+    ctx->writeCoalesce = 0;
+#ifdef HAVE_PARALLEL_WRITE
+    ctx->writePool     = NULL;
+#endif
+#ifdef HAVE_PARALLEL_VERIFY
+    ctx->verifyPool    = NULL;
+#endif
 #ifdef HAVE_CAVIUM
     ctx->devId = NO_CAVIUM_DEVICE;
 #endif
 #ifdef HAVE_TLS_EXTENSIONS
     ctx->extensions = NULL;
 #endif
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    ctx->ticketKeyCount    = 0;      /* no keys, no ticket engine */
+    ctx->ticketKeyLifetime = 0;
+    ctx->ticketKeyCb       = NULL;
+    ctx->ticketKeyCtx      = NULL;
+#endif
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+    XMEMSET(&ctx->keyPool, 0, sizeof(ctx->keyPool));    /* off */
+#endif
+#ifdef HAVE_ALPN
+    ctx->alpnSelectCb  = NULL;
+    ctx->alpnSelectCtx = NULL;
+#endif
+#ifndef NO_CYASSL_SERVER
+    ctx->clientHelloCb  = NULL;
+#endif
+#if defined(HAVE_SNI) && !defined(NO_CYASSL_SERVER)
+    ctx->sniHosts       = NULL;
+    ctx->sniHostBuckets = 0;
+    ctx->sniHostCount   = 0;
+    ctx->sniCb          = NULL;
+    ctx->sniCbCtx       = NULL;
+#endif
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_SERVER)
+    XMEMSET(&ctx->stapleId, 0, sizeof(ctx->stapleId));
+    ctx->stapleOn = 0;
+#endif
 #ifdef ATOMIC_USER
     ctx->MacEncryptCb    = NULL;
     ctx->DecryptVerifyCb = NULL;
 #endif
+#ifdef CYASSL_ASYNC_CRYPT
+    ctx->AsyncSubmitCb   = NULL;
+#endif
+#ifdef CYASSL_HANDSHAKE_TIMING
+    ctx->hsTimingCb    = NULL;
+    ctx->hsTimingCtx   = NULL;
+    ctx->hsTimingRate  = 1;
+    ctx->hsTimingCount = 0;
+#endif
 #ifdef HAVE_PK_CALLBACKS
     #ifdef HAVE_ECC
         ctx->EccSignCb   = NULL;
@@ -463,196 +549,842 @@ int InitSSL_Ctx(CYASSL_CTX* ctx, CYASSL_METHOD* method)
         CYASSL_MSG("Mutex error on CTX init");
         return BAD_MUTEX_E;
     }
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    if (InitMutex(&ctx->ticketKeyMutex) < 0) {
+        CYASSL_MSG("Mutex error on CTX ticket key init");
+        return BAD_MUTEX_E;
+    }
+#endif
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+    if (InitMutex(&ctx->keyPool.mutex) < 0) {
+        CYASSL_MSG("Mutex error on CTX key pool init");
+        return BAD_MUTEX_E;
+    }
+#endif
+#if !defined(NO_PSK) && defined(HAVE_PSK_STORE)
+    if (InitMutex(&ctx->pskStore.lock) < 0) {
+        CYASSL_MSG("Mutex error on CTX PSK store init");
+        return BAD_MUTEX_E;
+    }
+#endif
 #ifndef NO_CERTS
     if (ctx->cm == NULL) {
         CYASSL_MSG("Bad Cert Manager New");
         return BAD_CERT_MANAGER_ERROR;
     }
+#endif
+#ifdef CYASSL_MEM_STATS
+    if (ctx->memStats == NULL) {
+        CYASSL_MSG("Memory stats handle alloc failed");
+        return MEMORY_E;
+    }
 #endif
     return 0;
 }
 
 
-/* In case contexts are held in array and don't want to free actual ctx */
-void SSL_CtxResourceFree(CYASSL_CTX* ctx)
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+
+#ifdef HAVE_ECC
+/* drop pooled ECC keys, caller holds the pool mutex */
+static void FlushPooledEccKeys(KeyPool* pool, void* heap)
 {
-    XFREE(ctx->method, ctx->heap, DYNAMIC_TYPE_METHOD);
+    int i;
 
-#ifndef NO_CERTS
-    XFREE(ctx->serverDH_G.buffer, ctx->heap, DYNAMIC_TYPE_DH);
-    XFREE(ctx->serverDH_P.buffer, ctx->heap, DYNAMIC_TYPE_DH);
-    XFREE(ctx->privateKey.buffer, ctx->heap, DYNAMIC_TYPE_KEY);
-    XFREE(ctx->certificate.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
-    XFREE(ctx->certChain.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
-    CyaSSL_CertManagerFree(ctx->cm);
-#endif
-#ifdef HAVE_TLS_EXTENSIONS
-    TLSX_FreeAll(ctx->extensions);
-#endif
+    for (i = 0; i < pool->eccCount; i++) {
+        ecc_free(pool->ecc[i]);
+        XFREE(pool->ecc[i], heap, DYNAMIC_TYPE_ECC);
+    }
+    pool->eccCount = 0;
+
+    (void)heap;
 }
+#endif
 
 
-void FreeSSL_Ctx(CYASSL_CTX* ctx)
+#ifdef HAVE_ECC25519
+/* drop pooled curve25519 keys, caller holds the pool mutex */
+static void FlushPooledEcc25519Keys(KeyPool* pool, void* heap)
 {
-    int doFree = 0;
+    int i;
 
-    if (LockMutex(&ctx->countMutex) != 0) {
-        CYASSL_MSG("Couldn't lock count mutex");
-        return;
+    for (i = 0; i < pool->ecc25519Count; i++) {
+        ecc25519_free(pool->ecc25519[i]);
+        XFREE(pool->ecc25519[i], heap, DYNAMIC_TYPE_ECC);
     }
-    ctx->refCount--;
-    if (ctx->refCount == 0)
-        doFree = 1;
-    UnLockMutex(&ctx->countMutex);
+    pool->ecc25519Count = 0;
 
-    if (doFree) {
-        CYASSL_MSG("CTX ref count down to 0, doing full free");
-        SSL_CtxResourceFree(ctx);
-        FreeMutex(&ctx->countMutex);
-        XFREE(ctx, ctx->heap, DYNAMIC_TYPE_CTX);
-    }
-    else {
-        (void)ctx;
-        CYASSL_MSG("CTX ref count not 0 yet, no free");
-    }
+    (void)heap;
 }
+#endif
 
 
-/* Set cipher pointers to null */
-void InitCiphers(CYASSL* ssl)
+/* drop all pooled keys and slots, caller holds the pool mutex */
+static void FreeKeyPool(KeyPool* pool, void* heap)
 {
-#ifdef BUILD_ARC4
-    ssl->encrypt.arc4 = NULL;
-    ssl->decrypt.arc4 = NULL;
-#endif
-#ifdef BUILD_DES3
-    ssl->encrypt.des3 = NULL;
-    ssl->decrypt.des3 = NULL;
-#endif
-#ifdef BUILD_AES
-    ssl->encrypt.aes = NULL;
-    ssl->decrypt.aes = NULL;
-#endif
-#ifdef HAVE_CAMELLIA
-    ssl->encrypt.cam = NULL;
-    ssl->decrypt.cam = NULL;
-#endif
-#ifdef HAVE_HC128
-    ssl->encrypt.hc128 = NULL;
-    ssl->decrypt.hc128 = NULL;
-#endif
-#ifdef BUILD_RABBIT
-    ssl->encrypt.rabbit = NULL;
-    ssl->decrypt.rabbit = NULL;
-#endif
-#ifdef HAVE_CHACHA
-    ssl->encrypt.chacha = NULL;
-    ssl->decrypt.chacha = NULL;
-#endif
-#ifdef HAVE_POLY1305
-    ssl->auth.poly1305 = NULL;
+#ifdef HAVE_ECC
+    FlushPooledEccKeys(pool, heap);
+    XFREE(pool->ecc, heap, DYNAMIC_TYPE_ECC);
+    pool->ecc = NULL;
 #endif
-    ssl->encrypt.setup = 0;
-    ssl->decrypt.setup = 0;
-#ifdef HAVE_ONE_TIME_AUTH
-    ssl->auth.setup    = 0;
+#ifdef HAVE_ECC25519
+    FlushPooledEcc25519Keys(pool, heap);
+    XFREE(pool->ecc25519, heap, DYNAMIC_TYPE_ECC);
+    pool->ecc25519 = NULL;
 #endif
+    pool->size = 0;
+
+    (void)heap;
 }
 
 
-/* Free ciphers */
-void FreeCiphers(CYASSL* ssl)
+/* size slots per key type, 0 turns the pool off, pooled keys are dropped */
+int SetKeyPoolSize(CYASSL_CTX* ctx, int size)
 {
-    (void)ssl;
-#ifdef BUILD_ARC4
-    #ifdef HAVE_CAVIUM
-    if (ssl->devId != NO_CAVIUM_DEVICE) {
-        Arc4FreeCavium(ssl->encrypt.arc4);
-        Arc4FreeCavium(ssl->decrypt.arc4);
-    }
-    #endif
-    XFREE(ssl->encrypt.arc4, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.arc4, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    KeyPool*       pool     = &ctx->keyPool;
+#ifdef HAVE_ECC
+    ecc_key**      ecc      = NULL;
 #endif
-#ifdef BUILD_DES3
-    #ifdef HAVE_CAVIUM
-    if (ssl->devId != NO_CAVIUM_DEVICE) {
-        Des3_FreeCavium(ssl->encrypt.des3);
-        Des3_FreeCavium(ssl->decrypt.des3);
-    }
-    #endif
-    XFREE(ssl->encrypt.des3, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.des3, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#ifdef HAVE_ECC25519
+    ecc25519_key** ecc25519 = NULL;
 #endif
-#ifdef BUILD_AES
-    #ifdef HAVE_CAVIUM
-    if (ssl->devId != NO_CAVIUM_DEVICE) {
-        AesFreeCavium(ssl->encrypt.aes);
-        AesFreeCavium(ssl->decrypt.aes);
+    int            ret      = 0;
+
+    if (size > 0) {
+    #ifdef HAVE_ECC
+        ecc = (ecc_key**)XMALLOC(size * sizeof(ecc_key*), ctx->heap,
+                                 DYNAMIC_TYPE_ECC);
+        if (ecc == NULL)
+            ret = MEMORY_E;
+    #endif
+    #ifdef HAVE_ECC25519
+        ecc25519 = (ecc25519_key**)XMALLOC(size * sizeof(ecc25519_key*),
+                                           ctx->heap, DYNAMIC_TYPE_ECC);
+        if (ecc25519 == NULL)
+            ret = MEMORY_E;
+    #endif
     }
+
+    if (ret == 0 && LockMutex(&pool->mutex) != 0)
+        ret = BAD_MUTEX_E;
+
+    if (ret == 0) {
+        FreeKeyPool(pool, ctx->heap);
+    #ifdef HAVE_ECC
+        pool->ecc      = ecc;
+        ecc            = NULL;
     #endif
-    XFREE(ssl->encrypt.aes, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.aes, ssl->heap, DYNAMIC_TYPE_CIPHER);
-#endif
-#ifdef HAVE_CAMELLIA
-    XFREE(ssl->encrypt.cam, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.cam, ssl->heap, DYNAMIC_TYPE_CIPHER);
-#endif
-#ifdef HAVE_HC128
-    XFREE(ssl->encrypt.hc128, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.hc128, ssl->heap, DYNAMIC_TYPE_CIPHER);
-#endif
-#ifdef BUILD_RABBIT
-    XFREE(ssl->encrypt.rabbit, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.rabbit, ssl->heap, DYNAMIC_TYPE_CIPHER);
-#endif
-#ifdef HAVE_CHACHA
-    XFREE(ssl->encrypt.chacha, ssl->heap, DYNAMIC_TYPE_CIPHER);
-    XFREE(ssl->decrypt.chacha, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    #ifdef HAVE_ECC25519
+        pool->ecc25519 = ecc25519;
+        ecc25519       = NULL;
+    #endif
+        pool->size = size;
+        UnLockMutex(&pool->mutex);
+    }
+
+#ifdef HAVE_ECC
+    XFREE(ecc, ctx->heap, DYNAMIC_TYPE_ECC);
 #endif
-#ifdef HAVE_POLY1305
-    XFREE(ssl->auth.poly1305, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#ifdef HAVE_ECC25519
+    XFREE(ecc25519, ctx->heap, DYNAMIC_TYPE_ECC);
 #endif
+
+    return ret;
 }
 
 
-void InitCipherSpecs(CipherSpecs* cs)
+#ifdef HAVE_ECC
+/* make an ECC key at the ctx's ECDHE size and pool it, 1 if stored */
+static int AddPooledEccKey(CYASSL_CTX* ctx, RNG* rng)
 {
-    cs->bulk_cipher_algorithm = INVALID_BYTE;
-    cs->cipher_type           = INVALID_BYTE;
-    cs->mac_algorithm         = INVALID_BYTE;
-    cs->kea                   = INVALID_BYTE;
-    cs->sig_algo              = INVALID_BYTE;
+    KeyPool* pool = &ctx->keyPool;
+    word16   sz   = ctx->eccTempKeySz;
+    ecc_key* key;
+    int      ret  = 0;
 
-    cs->hash_size   = 0;
-    cs->static_ecdh = 0;
-    cs->key_size    = 0;
-    cs->iv_size     = 0;
-    cs->block_size  = 0;
+    key = (ecc_key*)XMALLOC(sizeof(ecc_key), ctx->heap, DYNAMIC_TYPE_ECC);
+    if (key == NULL)
+        return MEMORY_E;
+
+    ecc_init(key);
+    if (ecc_make_key(rng, sz, key) != 0)
+        ret = ECC_MAKEKEY_ERROR;
+    else if (LockMutex(&pool->mutex) != 0)
+        ret = BAD_MUTEX_E;
+    else {
+        /* a resize or another filler may have got there first */
+        if (pool->eccKeySz == sz && pool->eccCount < pool->size) {
+            pool->ecc[pool->eccCount++] = key;
+            key = NULL;
+            ret = 1;
+        }
+        UnLockMutex(&pool->mutex);
+    }
+
+    if (key) {
+        ecc_free(key);
+        XFREE(key, ctx->heap, DYNAMIC_TYPE_ECC);
+    }
+
+    return ret;
 }
+#endif
 
-static void InitSuitesHashSigAlgo(Suites* suites, int haveECDSAsig,
-                                                  int haveRSAsig, int haveAnon)
+
+#ifdef HAVE_ECC25519
+/* make a curve25519 key and pool it, 1 if stored */
+static int AddPooledEcc25519Key(CYASSL_CTX* ctx, RNG* rng)
 {
-    int idx = 0;
+    KeyPool*      pool = &ctx->keyPool;
+    word16        sz   = ctx->ecc25519TempKeySz;
+    ecc25519_key* key;
+    int           ret  = 0;
+
+    key = (ecc25519_key*)XMALLOC(sizeof(ecc25519_key), ctx->heap,
+                                 DYNAMIC_TYPE_ECC);
+    if (key == NULL)
+        return MEMORY_E;
 
-    if (haveECDSAsig) {
-        #ifdef CYASSL_SHA384
-            suites->hashSigAlgo[idx++] = sha384_mac;
-            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
-        #endif
-        #ifndef NO_SHA256
-            suites->hashSigAlgo[idx++] = sha256_mac;
-            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
-        #endif
-        #ifndef NO_SHA
-            suites->hashSigAlgo[idx++] = sha_mac;
-            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
-        #endif
+    if (ecc25519_init(key) != 0 || ecc25519_make_key(rng, sz, key) != 0)
+        ret = ECC_MAKEKEY_ERROR;
+    else if (LockMutex(&pool->mutex) != 0)
+        ret = BAD_MUTEX_E;
+    else {
+        if (pool->ecc25519KeySz == sz && pool->ecc25519Count < pool->size) {
+            pool->ecc25519[pool->ecc25519Count++] = key;
+            key = NULL;
+            ret = 1;
+        }
+        UnLockMutex(&pool->mutex);
     }
 
-    if (haveRSAsig) {
-        #ifdef CYASSL_SHA384
+    if (key) {
+        ecc25519_free(key);
+        XFREE(key, ctx->heap, DYNAMIC_TYPE_ECC);
+    }
+
+    return ret;
+}
+#endif
+
+
+/* generate up to max keys (all free slots if max <= 0) into the emptier
+   type first, returns the number pooled or < 0 on error. Runs without the
+   mutex held across key generation so handshakes can keep popping */
+int FillKeyPool(CYASSL_CTX* ctx, RNG* rng, int max)
+{
+    KeyPool* pool = &ctx->keyPool;
+    int      made = 0;
+    int      ret  = 0;
+
+    while (ret >= 0 && (max <= 0 || made < max)) {
+        int eccRoom      = 0;
+        int ecc25519Room = 0;
+
+        if (LockMutex(&pool->mutex) != 0)
+            return BAD_MUTEX_E;
+    #ifdef HAVE_ECC
+        if (pool->eccKeySz != ctx->eccTempKeySz) {
+            /* ECDHE size changed, old keys would never be used */
+            FlushPooledEccKeys(pool, ctx->heap);
+            pool->eccKeySz = ctx->eccTempKeySz;
+        }
+        eccRoom = pool->size - pool->eccCount;
+    #endif
+    #ifdef HAVE_ECC25519
+        if (pool->ecc25519KeySz != ctx->ecc25519TempKeySz) {
+            FlushPooledEcc25519Keys(pool, ctx->heap);
+            pool->ecc25519KeySz = ctx->ecc25519TempKeySz;
+        }
+        ecc25519Room = pool->size - pool->ecc25519Count;
+    #endif
+        UnLockMutex(&pool->mutex);
+
+        if (eccRoom <= 0 && ecc25519Room <= 0)
+            break;
+
+    #if defined(HAVE_ECC) && defined(HAVE_ECC25519)
+        if (eccRoom >= ecc25519Room)
+            ret = AddPooledEccKey(ctx, rng);
+        else
+            ret = AddPooledEcc25519Key(ctx, rng);
+    #elif defined(HAVE_ECC)
+        ret = AddPooledEccKey(ctx, rng);
+    #else
+        ret = AddPooledEcc25519Key(ctx, rng);
+    #endif
+        if (ret > 0)
+            made += ret;
+    }
+
+    return ret < 0 ? ret : made;
+}
+
+
+/* keys currently pooled, all types */
+int KeyPoolCount(CYASSL_CTX* ctx)
+{
+    KeyPool* pool  = &ctx->keyPool;
+    int      count = 0;
+
+    if (LockMutex(&pool->mutex) != 0)
+        return BAD_MUTEX_E;
+#ifdef HAVE_ECC
+    count += pool->eccCount;
+#endif
+#ifdef HAVE_ECC25519
+    count += pool->ecc25519Count;
+#endif
+    UnLockMutex(&pool->mutex);
+
+    return count;
+}
+
+#endif /* HAVE_EPHEMERAL_KEY_POOL */
+
+
+#ifndef NO_CERTS
+
+/* private keys are decoded once at load, handshakes on any thread then share
+   the read only copy, Montgomery setup included, instead of parsing the DER */
+
+#ifndef NO_RSA
+
+static void FreeCachedRsaKey(RsaKey** key, void* heap)
+{
+    (void)heap;
+
+    if (*key) {
+        FreeRsaKey(*key);
+        XFREE(*key, heap, DYNAMIC_TYPE_RSA);
+        *key = NULL;
+    }
+}
+
+
+static RsaKey* DecodeCachedRsaKey(buffer* der, void* heap)
+{
+    word32  idx = 0;
+    RsaKey* key = (RsaKey*)XMALLOC(sizeof(RsaKey), heap, DYNAMIC_TYPE_RSA);
+
+    if (key == NULL)
+        return NULL;
+
+    if (InitRsaKey(key, heap) != 0) {
+        XFREE(key, heap, DYNAMIC_TYPE_RSA);
+        return NULL;
+    }
+
+    if (RsaPrivateKeyDecode(der->buffer, &idx, key, der->length) != 0)
+        FreeCachedRsaKey(&key, heap);
+
+    return key;
+}
+
+#endif /* NO_RSA */
+
+#ifdef HAVE_ECC
+
+static void FreeCachedEccKey(ecc_key** key, void* heap)
+{
+    (void)heap;
+
+    if (*key) {
+        ecc_free(*key);
+        XFREE(*key, heap, DYNAMIC_TYPE_ECC);
+        *key = NULL;
+    }
+}
+
+
+static ecc_key* DecodeCachedEccKey(buffer* der, void* heap)
+{
+    word32   idx = 0;
+    ecc_key* key = (ecc_key*)XMALLOC(sizeof(ecc_key), heap, DYNAMIC_TYPE_ECC);
+
+    if (key == NULL)
+        return NULL;
+
+    ecc_init(key);
+    if (EccPrivateKeyDecode(der->buffer, &idx, key, der->length) != 0)
+        FreeCachedEccKey(&key, heap);
+
+    return key;
+}
+
+#endif /* HAVE_ECC */
+
+
+/* redo the decoded copy after the ctx's private key, or its ECC slot key,
+   was replaced, a key that doesn't decode is left to the handshake */
+void CacheCtxPrivateKey(CYASSL_CTX* ctx, int eccSlot)
+{
+#ifdef HAVE_ECC
+    if (eccSlot) {
+        FreeCachedEccKey(&ctx->eccSlotKey, ctx->heap);
+        if (ctx->eccPrivateKey.buffer)
+            ctx->eccSlotKey = DecodeCachedEccKey(&ctx->eccPrivateKey,
+                                                 ctx->heap);
+        return;
+    }
+    FreeCachedEccKey(&ctx->privateEccKey, ctx->heap);
+#endif
+#ifndef NO_RSA
+    FreeCachedRsaKey(&ctx->privateRsaKey, ctx->heap);
+#endif
+    (void)eccSlot;
+
+    if (ctx->privateKey.buffer == NULL)
+        return;
+
+#ifndef NO_RSA
+    ctx->privateRsaKey = DecodeCachedRsaKey(&ctx->privateKey, ctx->heap);
+    if (ctx->privateRsaKey)
+        return;
+#endif
+#ifdef HAVE_ECC
+    ctx->privateEccKey = DecodeCachedEccKey(&ctx->privateKey, ctx->heap);
+#endif
+}
+
+
+#ifndef NO_DH
+
+static void FreeCachedDhBase(DhFixedBase** fb, void* heap)
+{
+    (void)heap;
+
+    if (*fb) {
+        DhFixedBaseFree(*fb);
+        XFREE(*fb, heap, DYNAMIC_TYPE_DH);
+        *fb = NULL;
+    }
+}
+
+
+/* redo the g table after the ctx's DH parameters were replaced, without one
+   the handshakes just do the whole exptmod */
+void CacheCtxDhParams(CYASSL_CTX* ctx)
+{
+    FreeCachedDhBase(&ctx->serverDH_Fb, ctx->heap);
+
+    if (ctx->serverDH_P.buffer == NULL || ctx->serverDH_G.buffer == NULL)
+        return;
+
+    ctx->serverDH_Fb = (DhFixedBase*)XMALLOC(sizeof(DhFixedBase), ctx->heap,
+                                             DYNAMIC_TYPE_DH);
+    if (ctx->serverDH_Fb == NULL)
+        return;
+
+    if (DhFixedBaseSetup(ctx->serverDH_Fb,
+                         ctx->serverDH_P.buffer, ctx->serverDH_P.length,
+                         ctx->serverDH_G.buffer, ctx->serverDH_G.length) != 0)
+        FreeCachedDhBase(&ctx->serverDH_Fb, ctx->heap);
+}
+
+#endif /* NO_DH */
+
+#endif /* NO_CERTS */
+
+
+/* In case contexts are held in array and don't want to free actual ctx */
+void SSL_CtxResourceFree(CYASSL_CTX* ctx)
+{
+    int i;
+
+    if (ctx->rotated)
+        FreeSSL_Ctx(ctx->rotated);
+    for (i = 0; i < CYASSL_MAX_NUMA_NODES; i++)
+        if (ctx->numaCtx[i])
+            FreeSSL_Ctx(ctx->numaCtx[i]);
+    XFREE(ctx->method, ctx->heap, DYNAMIC_TYPE_METHOD);
+#ifdef CYASSL_DTLS
+    XMEMSET(ctx->cookieSecret, 0, sizeof(ctx->cookieSecret));
+#endif
+
+#ifndef NO_CERTS
+    XFREE(ctx->serverDH_G.buffer, ctx->heap, DYNAMIC_TYPE_DH);
+    XFREE(ctx->serverDH_P.buffer, ctx->heap, DYNAMIC_TYPE_DH);
+    XFREE(ctx->privateKey.buffer, ctx->heap, DYNAMIC_TYPE_KEY);
+    XFREE(ctx->certificate.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
+    XFREE(ctx->certChain.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
+    XFREE(ctx->certMsg.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
+#ifdef HAVE_ECC
+    XFREE(ctx->eccPrivateKey.buffer, ctx->heap, DYNAMIC_TYPE_KEY);
+    XFREE(ctx->eccCertificate.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
+    XFREE(ctx->eccCertChain.buffer, ctx->heap, DYNAMIC_TYPE_CERT);
+    FreeCachedEccKey(&ctx->privateEccKey, ctx->heap);
+    FreeCachedEccKey(&ctx->eccSlotKey, ctx->heap);
+#endif
+#ifndef NO_RSA
+    FreeCachedRsaKey(&ctx->privateRsaKey, ctx->heap);
+#endif
+#ifndef NO_DH
+    FreeCachedDhBase(&ctx->serverDH_Fb, ctx->heap);
+#endif
+    CyaSSL_CertManagerFree(ctx->cm);
+#endif
+#if !defined(NO_PSK) && defined(HAVE_PSK_STORE)
+    FreePskStore(&ctx->pskStore, ctx->heap);
+#endif
+#ifdef HAVE_TLS_EXTENSIONS
+    TLSX_FreeAll(ctx->extensions);
+#endif
+#if defined(HAVE_SNI) && !defined(NO_CYASSL_SERVER)
+    FreeSNIHosts(ctx);
+#endif
+#ifndef NO_SESSION_CACHE
+    FreeSessionCache(ctx->sessionCache);
+#endif
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    XMEMSET(ctx->ticketKeys, 0, sizeof(ctx->ticketKeys));
+#endif
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+    FreeKeyPool(&ctx->keyPool, ctx->heap);
+#endif
+#ifdef HAVE_PARALLEL_WRITE
+    SetWritePool(ctx, 0);
+#endif
+#ifdef HAVE_PARALLEL_VERIFY
+    SetVerifyPool(ctx, 0);
+#endif
+}
+
+
+void FreeSSL_Ctx(CYASSL_CTX* ctx)
+{
+    int doFree = 0;
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemStats* stats = ctx->memStats;
+#endif
+
+#ifdef CTX_ATOMIC_REF
+    /* the last one out acquires every other holder's release */
+    if (__atomic_sub_fetch(&ctx->refCount, 1, __ATOMIC_ACQ_REL) == 0)
+        doFree = 1;
+#else
+    if (LockMutex(&ctx->countMutex) != 0) {
+        CYASSL_MSG("Couldn't lock count mutex");
+        return;
+    }
+    ctx->refCount--;
+    if (ctx->refCount == 0)
+        doFree = 1;
+    UnLockMutex(&ctx->countMutex);
+#endif
+
+    if (doFree) {
+        CYASSL_MSG("CTX ref count down to 0, doing full free");
+        SSL_CtxResourceFree(ctx);
+        FreeMutex(&ctx->countMutex);
+    #if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+        FreeMutex(&ctx->ticketKeyMutex);
+    #endif
+    #ifdef HAVE_EPHEMERAL_KEY_POOL
+        FreeMutex(&ctx->keyPool.mutex);
+    #endif
+    #if !defined(NO_PSK) && defined(HAVE_PSK_STORE)
+        FreeMutex(&ctx->pskStore.lock);
+    #endif
+        XFREE(ctx, ctx->heap, DYNAMIC_TYPE_CTX);
+    #ifdef CYASSL_MEM_STATS
+        CyaSSL_MemStatsFree(stats);
+    #endif
+    }
+    else {
+        (void)ctx;
+        CYASSL_MSG("CTX ref count not 0 yet, no free");
+    }
+}
+
+
+/* take a reference on ctx, FreeSSL_Ctx() drops it */
+int SSL_CtxUpRef(CYASSL_CTX* ctx)
+{
+#ifdef CTX_ATOMIC_REF
+    /* holders already keep ctx alive, nothing to order */
+    __atomic_add_fetch(&ctx->refCount, 1, __ATOMIC_RELAXED);
+#else
+    if (LockMutex(&ctx->countMutex) != 0) {
+        CYASSL_MSG("Couldn't lock CTX count mutex");
+        return BAD_MUTEX_E;
+    }
+    ctx->refCount++;
+    UnLockMutex(&ctx->countMutex);
+#endif
+
+    return 0;
+}
+
+
+/* the context rotated into ctx with a reference taken, NULL if none */
+CYASSL_CTX* SSL_CtxRotated(CYASSL_CTX* ctx)
+{
+    CYASSL_CTX* rotated;
+#ifdef CTX_ATOMIC_REF
+    word32      side;
+
+    if (__atomic_load_n(&ctx->rotated, __ATOMIC_SEQ_CST) == NULL)
+        return NULL;
+
+    /* a rotation bumping the epoch between the two loads may already be
+       waiting on the other side, count there instead */
+    for (;;) {
+        side = __atomic_load_n(&ctx->rotEpoch, __ATOMIC_SEQ_CST) & 1;
+        __atomic_add_fetch(&ctx->rotReaders[side], 1, __ATOMIC_SEQ_CST);
+        if ((__atomic_load_n(&ctx->rotEpoch, __ATOMIC_SEQ_CST) & 1) == side)
+            break;
+        __atomic_sub_fetch(&ctx->rotReaders[side], 1, __ATOMIC_SEQ_CST);
+    }
+    rotated = __atomic_load_n(&ctx->rotated, __ATOMIC_SEQ_CST);
+    if (rotated)
+        SSL_CtxUpRef(rotated);
+    __atomic_sub_fetch(&ctx->rotReaders[side], 1, __ATOMIC_SEQ_CST);
+#else
+    if (LockMutex(&ctx->countMutex) != 0)
+        return NULL;
+    rotated = ctx->rotated;
+    if (rotated && SSL_CtxUpRef(rotated) != 0)
+        rotated = NULL;
+    UnLockMutex(&ctx->countMutex);
+#endif
+
+    return rotated;
+}
+
+
+/* count ssl's full handshake against its CTX's limit, ahead of the server
+   key exchange signature and the rest of the expensive work, resumptions
+   don't count. Over the limit the client just gets an alert */
+int SSL_CtxAdmitHandshake(CYASSL* ssl)
+{
+    CYASSL_CTX* ctx = ssl->ctx;
+    int         inFlight;
+
+    if (ctx->hsLimit == 0 || ssl->options.hsAdmitted)
+        return 0;
+
+#ifdef CTX_ATOMIC_REF
+    inFlight = __atomic_add_fetch(&ctx->hsInFlight, 1, __ATOMIC_RELAXED);
+    if (inFlight > ctx->hsLimit)
+        __atomic_sub_fetch(&ctx->hsInFlight, 1, __ATOMIC_RELAXED);
+#else
+    if (LockMutex(&ctx->countMutex) != 0)
+        return BAD_MUTEX_E;
+    inFlight = ++ctx->hsInFlight;
+    if (inFlight > ctx->hsLimit)
+        ctx->hsInFlight--;
+    UnLockMutex(&ctx->countMutex);
+#endif
+
+    if (inFlight > ctx->hsLimit) {
+        CYASSL_MSG("Full handshake limit reached, shedding");
+        CYASSL_STAT_INC(handshakesShed);
+        SendAlert(ssl, alert_fatal, handshake_failure);
+        return HANDSHAKE_BUSY_E;
+    }
+
+    ssl->options.hsAdmitted = 1;
+
+    return 0;
+}
+
+
+/* give back the slot SSL_CtxAdmitHandshake() took, if it did */
+void SSL_CtxReleaseHandshake(CYASSL* ssl)
+{
+    if (!ssl->options.hsAdmitted)
+        return;
+
+    ssl->options.hsAdmitted = 0;
+#ifdef CTX_ATOMIC_REF
+    __atomic_sub_fetch(&ssl->ctx->hsInFlight, 1, __ATOMIC_RELAXED);
+#else
+    if (LockMutex(&ssl->ctx->countMutex) == 0) {
+        ssl->ctx->hsInFlight--;
+        UnLockMutex(&ssl->ctx->countMutex);
+    }
+#endif
+}
+
+
+/* publish next, referenced, as the context new SSLs from ctx use, NULL goes
+   back to ctx itself. SSLs made before keep theirs, the previous one is
+   released once no CyaSSL_new() can still be picking it up */
+int SSL_CtxSetRotated(CYASSL_CTX* ctx, CYASSL_CTX* next)
+{
+    CYASSL_CTX* old;
+
+    if (next && SSL_CtxUpRef(next) != 0)
+        return BAD_MUTEX_E;
+
+    if (LockMutex(&ctx->countMutex) != 0) {
+        if (next)
+            FreeSSL_Ctx(next);
+        return BAD_MUTEX_E;
+    }
+
+    old = ctx->rotated;
+#ifdef CTX_ATOMIC_REF
+    {
+        word32 side = ctx->rotEpoch & 1;
+
+        __atomic_store_n(&ctx->rotated, next, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&ctx->rotEpoch, 1, __ATOMIC_SEQ_CST);
+
+        /* readers on the old side only take a reference */
+        while (__atomic_load_n(&ctx->rotReaders[side], __ATOMIC_SEQ_CST) != 0)
+            ;
+    }
+#else
+    ctx->rotated = next;
+#endif
+
+    UnLockMutex(&ctx->countMutex);
+    if (old)
+        FreeSSL_Ctx(old);
+
+    return 0;
+}
+
+
+/* Set cipher pointers to null */
+void InitCiphers(CYASSL* ssl)
+{
+#ifdef BUILD_ARC4
+    ssl->encrypt.arc4 = NULL;
+    ssl->decrypt.arc4 = NULL;
+#endif
+#ifdef BUILD_DES3
+    ssl->encrypt.des3 = NULL;
+    ssl->decrypt.des3 = NULL;
+#endif
+#ifdef BUILD_AES
+    ssl->encrypt.aes = NULL;
+    ssl->decrypt.aes = NULL;
+#endif
+#ifdef HAVE_CAMELLIA
+    ssl->encrypt.cam = NULL;
+    ssl->decrypt.cam = NULL;
+#endif
+#ifdef HAVE_HC128
+    ssl->encrypt.hc128 = NULL;
+    ssl->decrypt.hc128 = NULL;
+#endif
+#ifdef BUILD_RABBIT
+    ssl->encrypt.rabbit = NULL;
+    ssl->decrypt.rabbit = NULL;
+#endif
+#ifdef HAVE_CHACHA
+    ssl->encrypt.chacha = NULL;
+    ssl->decrypt.chacha = NULL;
+#endif
+#ifdef HAVE_POLY1305
+    ssl->auth.poly1305 = NULL;
+#endif
+    ssl->encrypt.process = NULL;
+    ssl->decrypt.process = NULL;
+    ssl->encrypt.setup = 0;
+    ssl->decrypt.setup = 0;
+#ifdef HAVE_ONE_TIME_AUTH
+    ssl->auth.setup    = 0;
+#endif
+}
+
+
+/* Free ciphers */
+void FreeCiphers(CYASSL* ssl)
+{
+    (void)ssl;
+#ifdef BUILD_ARC4
+    #ifdef HAVE_CAVIUM
+    if (ssl->devId != NO_CAVIUM_DEVICE) {
+        Arc4FreeCavium(ssl->encrypt.arc4);
+        Arc4FreeCavium(ssl->decrypt.arc4);
+    }
+    #endif
+    XFREE(ssl->encrypt.arc4, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.arc4, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef BUILD_DES3
+    #ifdef HAVE_CAVIUM
+    if (ssl->devId != NO_CAVIUM_DEVICE) {
+        Des3_FreeCavium(ssl->encrypt.des3);
+        Des3_FreeCavium(ssl->decrypt.des3);
+    }
+    #endif
+    XFREE(ssl->encrypt.des3, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.des3, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef BUILD_AES
+    #ifdef HAVE_CAVIUM
+    if (ssl->devId != NO_CAVIUM_DEVICE) {
+        AesFreeCavium(ssl->encrypt.aes);
+        AesFreeCavium(ssl->decrypt.aes);
+    }
+    #endif
+    PutCipherAes(ssl->encrypt.aes, ssl->heap);
+    PutCipherAes(ssl->decrypt.aes, ssl->heap);
+#endif
+#ifdef HAVE_CAMELLIA
+    XFREE(ssl->encrypt.cam, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.cam, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef HAVE_HC128
+    XFREE(ssl->encrypt.hc128, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.hc128, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef BUILD_RABBIT
+    XFREE(ssl->encrypt.rabbit, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.rabbit, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef HAVE_CHACHA
+    XFREE(ssl->encrypt.chacha, ssl->heap, DYNAMIC_TYPE_CIPHER);
+    XFREE(ssl->decrypt.chacha, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+#ifdef HAVE_POLY1305
+    XFREE(ssl->auth.poly1305, ssl->heap, DYNAMIC_TYPE_CIPHER);
+#endif
+}
+
+
+void InitCipherSpecs(CipherSpecs* cs)
+{
+    cs->bulk_cipher_algorithm = INVALID_BYTE;
+    cs->cipher_type           = INVALID_BYTE;
+    cs->mac_algorithm         = INVALID_BYTE;
+    cs->kea                   = INVALID_BYTE;
+    cs->sig_algo              = INVALID_BYTE;
+
+    cs->hash_size   = 0;
+    cs->static_ecdh = 0;
+    cs->key_size    = 0;
+    cs->iv_size     = 0;
+    cs->block_size  = 0;
+}
+
+static void InitSuitesHashSigAlgo(Suites* suites, int haveECDSAsig,
+                                                  int haveRSAsig, int haveAnon)
+{
+    int idx = 0;
+
+    if (haveECDSAsig) {
+        #ifdef CYASSL_SHA384
+            suites->hashSigAlgo[idx++] = sha384_mac;
+            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
+        #endif
+        #ifndef NO_SHA256
+            suites->hashSigAlgo[idx++] = sha256_mac;
+            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
+        #endif
+        #ifndef NO_SHA
+            suites->hashSigAlgo[idx++] = sha_mac;
+            suites->hashSigAlgo[idx++] = ecc_dsa_sa_algo;
+        #endif
+    }
+
+    if (haveRSAsig) {
+        #ifdef CYASSL_SHA384
             suites->hashSigAlgo[idx++] = sha384_mac;
             suites->hashSigAlgo[idx++] = rsa_sa_algo;
         #endif
@@ -678,7 +1410,7 @@ static void InitSuitesHashSigAlgo(Suites* suites, int haveECDSAsig,
 
 void InitSuites(Suites* suites, ProtocolVersion pv, byte haveRSA, byte havePSK,
                 byte haveDH, byte haveNTRU, byte haveECDSAsig,
-                byte haveStaticECC, int side)
+                byte haveStaticECC, byte haveDualCert, int side)
 {
     word16 idx = 0;
     int    tls    = pv.major == SSLv3_MAJOR && pv.minor >= TLSv1_MINOR;
@@ -710,6 +1442,11 @@ void InitSuites(Suites* suites, ProtocolVersion pv, byte haveRSA, byte havePSK,
         (void)haveRSAsig;   /* non ecc builds won't read */
     }
 
+    if (side == CYASSL_SERVER_END && haveDualCert) {
+        haveRSAsig   = 1;   /* RSA cert plus the ECDSA one */
+        haveECDSAsig = 1;
+    }
+
 #ifdef CYASSL_DTLS
     if (pv.major == DTLS_MAJOR) {
         tls    = 1;
@@ -1389,6 +2126,10 @@ void InitSuites(Suites* suites, ProtocolVersion pv, byte haveRSA, byte havePSK,
     }
 #endif
 
+#ifdef CYASSL_STATIC_SUITES
+    idx = StaticSuites(suites, idx);
+#endif
+
     suites->suiteSz = idx;
 
     InitSuitesHashSigAlgo(suites, haveECDSAsig, haveRSAsig, 0);
@@ -1492,6 +2233,265 @@ void FreeX509(CYASSL_X509* x509)
 #endif /* NO_CERTS */
 
 
+#ifdef CYASSL_HANDSHAKE_ARENA
+
+#define HS_ARENA_ROUND(sz) \
+            (((sz) + HS_ARENA_ALIGN - 1) & ~(word32)(HS_ARENA_ALIGN - 1))
+
+/* room for the objects FreeHandshakeResources always releases: suites, peer
+ * and temp keys, the DTLS pool and DoCertificate's cert. The arrays and rng
+ * may be kept after the handshake so they stay on the heap */
+static word32 HsArenaSize(CYASSL* ssl)
+{
+    word32 sz = HS_ARENA_ROUND(sizeof(Suites));
+
+    sz += HS_ARENA_ROUND(sizeof(HS_Hashes));
+
+#ifndef NO_RSA
+    sz += HS_ARENA_ROUND(sizeof(RsaKey));
+#endif
+#ifdef HAVE_ECC
+    sz += 4 * HS_ARENA_ROUND(sizeof(ecc_key));
+#endif
+#ifdef HAVE_ECC25519
+    sz += 2 * HS_ARENA_ROUND(sizeof(ecc25519_key));
+#endif
+#ifdef CYASSL_DTLS
+    if (ssl->options.dtls)
+        sz += HS_ARENA_ROUND(sizeof(DtlsPool));
+#endif
+#if defined(CYASSL_SMALL_STACK) && !defined(NO_CERTS)
+    sz += HS_ARENA_ROUND(sizeof(DecodedCert));
+#endif
+    (void)ssl;
+
+    return sz + HS_ARENA_EXTRA_SZ;
+}
+
+
+/* one allocation for the handshake, without it HsAlloc uses the heap */
+static void HsArenaInit(CYASSL* ssl)
+{
+    word32 sz = HsArenaSize(ssl);
+
+    ssl->hsArena.block = (byte*)XMALLOC(sz, ssl->heap, DYNAMIC_TYPE_ARENA);
+    if (ssl->hsArena.block == NULL) {
+        CYASSL_MSG("Handshake arena Memory error, using the heap");
+        return;
+    }
+    ssl->hsArena.size = sz;
+}
+
+
+static int HsArenaOwns(HsArena* arena, const void* ptr)
+{
+    return arena->block != NULL && (const byte*)ptr >= arena->block &&
+                                (const byte*)ptr < arena->block + arena->size;
+}
+
+
+void* HsAlloc(CYASSL* ssl, word32 sz, int type)
+{
+    HsArena* arena = &ssl->hsArena;
+    word32   need  = HS_ARENA_ROUND(sz);
+
+    if (arena->block == NULL || need < sz || need > arena->size - arena->used)
+        return XMALLOC(sz, ssl->heap, type);
+
+    arena->last  = arena->used;
+    arena->used += need;
+    arena->live++;
+
+    return arena->block + arena->last;
+}
+
+
+void HsFree(CYASSL* ssl, void* ptr, int type)
+{
+    HsArena* arena = &ssl->hsArena;
+
+    if (ptr == NULL)
+        return;
+
+    if (!HsArenaOwns(arena, ptr)) {
+        XFREE(ptr, ssl->heap, type);
+        return;
+    }
+    (void)type;
+
+    /* newest object, e.g. a DecodedCert, gives its room back */
+    if ((byte*)ptr == arena->block + arena->last)
+        arena->used = arena->last;
+
+    if (--arena->live == 0) {
+        XFREE(arena->block, ssl->heap, DYNAMIC_TYPE_ARENA);
+        XMEMSET(arena, 0, sizeof(HsArena));
+    }
+}
+
+#endif /* CYASSL_HANDSHAKE_ARENA */
+
+
+#ifdef CYASSL_HANDSHAKE_TIMING
+
+/* microseconds from an arbitrary start, wraps every 71 minutes */
+static word32 HsTimingNow(void)
+{
+#ifdef USE_WINDOWS_API
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER        count;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+
+    return (word32)(count.QuadPart * 1000000 / freq.QuadPart);
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, 0);
+
+    return (word32)tv.tv_sec * 1000000 + (word32)tv.tv_usec;
+#endif
+}
+
+
+static void HsTimingAdd(HsTimer* timer, int kind, int id, word32 start,
+                        word32 duration)
+{
+    CyaSSL_HsTiming* timing = &timer->timing;
+    CyaSSL_HsEvent*  event;
+
+    if (timing->count == CYASSL_HS_MAX_EVENTS) {
+        timing->dropped++;
+        return;
+    }
+
+    event = &timing->events[timing->count++];
+    event->kind     = (byte)kind;
+    event->id       = (byte)id;
+    event->start    = start;
+    event->duration = duration;
+}
+
+
+/* pick whether this handshake is sampled, called as connect/accept start */
+void HsTimingBegin(CYASSL* ssl)
+{
+    CYASSL_CTX* ctx = ssl->ctx;
+    word32      count;
+
+    /* connect and accept come back here on WANT_READ, count it once */
+    if (ssl->hsTimingPicked || ctx->hsTimingCb == NULL)
+        return;
+    ssl->hsTimingPicked = 1;
+
+    if (LockMutex(&ctx->countMutex) != 0)
+        return;
+    count = ctx->hsTimingCount++;
+    UnLockMutex(&ctx->countMutex);
+
+    if (count % ctx->hsTimingRate != 0)
+        return;
+
+    ssl->hsTiming = (HsTimer*)XMALLOC(sizeof(HsTimer), ssl->heap,
+                                      DYNAMIC_TYPE_HS_TIMING);
+    if (ssl->hsTiming == NULL) {
+        CYASSL_MSG("Handshake timing Memory error, not sampled");
+        return;
+    }
+    XMEMSET(ssl->hsTiming, 0, sizeof(HsTimer));
+    ssl->hsTiming->base = HsTimingNow();
+}
+
+
+/* hand the events to the user and stop timing */
+void HsTimingDone(CYASSL* ssl)
+{
+    HsTimer* timer = ssl->hsTiming;
+
+    ssl->hsTimingPicked = 0;    /* a renegotiation is a new handshake */
+    if (timer == NULL)
+        return;
+
+    ssl->hsTiming = NULL;
+    if (ssl->ctx->hsTimingCb)
+        ssl->ctx->hsTimingCb(ssl, &timer->timing, ssl->ctx->hsTimingCtx);
+    XFREE(timer, ssl->heap, DYNAMIC_TYPE_HS_TIMING);
+}
+
+
+void HsTimingOpen(CYASSL* ssl, int kind)
+{
+    HsTimer* timer = ssl->hsTiming;
+
+    if (timer->depth[kind]++ == 0)
+        timer->start[kind] = HsTimingNow();
+}
+
+
+void HsTimingClose(CYASSL* ssl, int kind, int id)
+{
+    HsTimer* timer = ssl->hsTiming;
+
+    if (timer->depth[kind] == 0 || --timer->depth[kind] != 0)
+        return;
+
+    HsTimingAdd(timer, kind, id, timer->start[kind] - timer->base,
+                HsTimingNow() - timer->start[kind]);
+}
+
+
+void HsTimingMark(CYASSL* ssl, int state)
+{
+    HsTimer* timer = ssl->hsTiming;
+
+    HsTimingAdd(timer, CYASSL_HS_STATE, state, HsTimingNow() - timer->base, 0);
+}
+
+#endif /* CYASSL_HANDSHAKE_TIMING */
+
+
+#if defined(HAVE_ECC) && !defined(NO_CERTS)
+
+/* serve the ctx's RSA or ECC slot, ctx still owns both */
+static void PickServerCert(CYASSL* ssl, CYASSL_CTX* ctx, int ecc)
+{
+    if (ecc) {
+        ssl->buffers.certificate = ctx->eccCertificate;
+        ssl->buffers.certChain   = ctx->eccCertChain;
+        ssl->buffers.key         = ctx->eccPrivateKey;
+    }
+    else {
+        ssl->buffers.certificate = ctx->certificate;
+        ssl->buffers.certChain   = ctx->certChain;
+        ssl->buffers.key         = ctx->privateKey;
+    }
+}
+
+
+/* with both slots of ctx loaded the server picks one per suite, with only
+   the ECC one that is the certificate */
+static void InitDualCert(CYASSL* ssl, CYASSL_CTX* ctx)
+{
+    ssl->options.haveDualCert = 0;
+
+    if (ssl->options.side != CYASSL_SERVER_END ||
+                  !ctx->eccCertificate.buffer || !ctx->eccPrivateKey.buffer)
+        return;
+
+    if (ctx->certificate.buffer && ctx->privateKey.buffer)
+        ssl->options.haveDualCert = 1;
+    else {
+        PickServerCert(ssl, ctx, 1);
+        ssl->options.haveECDSAsig  = 1;
+        ssl->options.haveStaticECC = 1;
+    }
+}
+
+#endif /* HAVE_ECC && !NO_CERTS */
+
+
 /* init everything to 0, NULL, default values before calling anything that may
    fail so that desctructor has a "good" state to cleanup */
 int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
@@ -1504,6 +2504,12 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->ctx     = ctx; /* only for passing to calls, options could change */
     ssl->version = ctx->method->version;
     ssl->suites  = NULL;
+#ifdef CYASSL_MEM_STATS
+    ssl->memStats = NULL;
+#endif
+#ifdef CYASSL_HANDSHAKE_ARENA
+    XMEMSET(&ssl->hsArena, 0, sizeof(HsArena));
+#endif
 
 #ifdef HAVE_LIBZ
     ssl->didStreamInit = 0;
@@ -1538,8 +2544,15 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 #endif
     ssl->buffers.clearOutputBuffer.buffer  = 0;
     ssl->buffers.clearOutputBuffer.length  = 0;
+#ifdef HAVE_SECURE_RENEGOTIATION
+    ssl->buffers.renegData.buffer = NULL;
+    ssl->buffers.renegData.length = 0;
+#endif
     ssl->buffers.prevSent                  = 0;
     ssl->buffers.plainSz                   = 0;
+    ssl->buffers.memOut                    = NULL;
+    ssl->buffers.memOutSz                  = 0;
+    ssl->buffers.memOutLen                 = 0;
 #ifdef HAVE_PK_CALLBACKS
     #ifdef HAVE_ECC
         ssl->buffers.peerEccDsaKey.buffer = 0;
@@ -1599,9 +2612,6 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 #ifdef CYASSL_DTLS
     ssl->IOCB_CookieCtx = NULL;      /* we don't use for default cb */
     ssl->dtls_expected_rx = MAX_MTU;
-    ssl->keys.dtls_state.window = 0;
-    ssl->keys.dtls_state.nextEpoch = 0;
-    ssl->keys.dtls_state.nextSeq = 0;
 #endif
 
     XMEMSET(&ssl->msgsReceived, 0, sizeof(ssl->msgsReceived));
@@ -1629,6 +2639,7 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->options.haveNTRU      = ctx->haveNTRU;
     ssl->options.haveECDSAsig  = ctx->haveECDSAsig;
     ssl->options.haveStaticECC = ctx->haveStaticECC;
+    ssl->options.haveDualCert  = 0;
     ssl->options.havePeerCert    = 0;
     ssl->options.havePeerVerify  = 0;
     ssl->options.usingPSK_cipher = 0;
@@ -1651,27 +2662,38 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->options.acceptState  = ACCEPT_BEGIN;
     ssl->options.handShakeState  = NULL_STATE;
     ssl->options.handShakeDone   = 0;
+    ssl->options.helloCbPending  = 0;
+    ssl->options.hsAdmitted      = 0;
+    ssl->options.memIO           = 0;
     ssl->options.processReply = doProcessInit;
 
 #ifdef CYASSL_DTLS
     ssl->keys.dtls_sequence_number      = 0;
-    ssl->keys.dtls_state.curSeq         = 0;
-    ssl->keys.dtls_state.nextSeq        = 0;
     ssl->keys.dtls_handshake_number     = 0;
     ssl->keys.dtls_expected_peer_handshake_number = 0;
     ssl->keys.dtls_epoch                = 0;
-    ssl->keys.dtls_state.curEpoch       = 0;
-    ssl->keys.dtls_state.nextEpoch      = 0;
+    XMEMSET(&ssl->keys.dtls_state, 0, sizeof(DtlsState));
     ssl->dtls_timeout_init              = DTLS_TIMEOUT_INIT;
     ssl->dtls_timeout_max               = DTLS_TIMEOUT_MAX;
     ssl->dtls_timeout                   = ssl->dtls_timeout_init;
+    ssl->dtls_srtt                      = 0;
+    ssl->dtls_rttvar                    = 0;
+    ssl->dtls_flight_start              = 0;
+    ssl->dtls_flight_peer               = 0;
+    ssl->dtls_rtt_valid                 = 0;
+    ssl->dtls_flight_timed              = 0;
     ssl->dtls_pool                      = NULL;
-    ssl->dtls_msg_list                  = NULL;
+    XMEMSET(ssl->dtls_msg_slots, 0, sizeof(ssl->dtls_msg_slots));
+    ssl->dtls_msg_mem                   = 0;
 #endif
     ssl->keys.encryptSz    = 0;
     ssl->keys.padSz        = 0;
     ssl->keys.encryptionOn = 0;     /* initially off */
     ssl->keys.decryptedCur = 0;     /* initially off */
+#ifndef NO_TLS
+    ssl->keys.macStateSet[0] = 0;
+    ssl->keys.macStateSet[1] = 0;
+#endif
     ssl->options.sessionCacheOff      = ctx->sessionCacheOff;
     ssl->options.sessionCacheFlushOff = ctx->sessionCacheFlushOff;
 
@@ -1688,18 +2710,46 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
         ssl->hmac = TLS_hmac;
     #endif
     ssl->heap = ctx->heap;    /* defaults to self */
+#ifdef CYASSL_MEM_STATS
+    ssl->memStats = CyaSSL_MemStatsNew(ctx->memStats);
+    if (ssl->memStats)
+        ssl->heap = ssl->memStats;
+#endif
     ssl->options.tls    = 0;
     ssl->options.tls1_1 = 0;
     ssl->options.dtls = ssl->version.major == DTLS_MAJOR;
+    ssl->options.dtlsHelloVerified = 0;
     ssl->options.partialWrite  = ctx->partialWrite;
     ssl->options.quietShutdown = ctx->quietShutdown;
     ssl->options.certOnly = 0;
     ssl->options.groupMessages = ctx->groupMessages;
+    ssl->options.moreToSend    = 0;
+    ssl->options.compact       = ctx->compact;
+    ssl->options.falseStart    = ctx->falseStart;
+    ssl->options.falseStarted  = 0;
+    ssl->buffers.readAhead     = ctx->readAhead;
+    ssl->buffers.dynRecordSz   = ctx->dynRecordSz;
+    ssl->buffers.dynRecordRamp = ctx->dynRecordRamp;
+    ssl->buffers.dynRecordIdle = ctx->dynRecordIdle;
+    ssl->buffers.dynRecordSent = 0;
+    ssl->buffers.dynRecordLast = 0;
+    ssl->buffers.writeCoalesce = ctx->writeCoalesce;
     ssl->options.usingNonblock = 0;
     ssl->options.saveArrays = 0;
 #ifdef HAVE_POLY1305
     ssl->options.oldPoly = 0;
 #endif
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_SERVER)
+    ssl->options.createTicket = 0;
+    ssl->options.useTicket    = 0;
+#endif
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+    ssl->options.statusRequest = 0;
+#endif
+#ifdef CYASSL_KTLS
+    ssl->options.ktlsTx = 0;
+    ssl->options.ktlsRx = 0;
+#endif
 
 #ifndef NO_CERTS
     /* ctx still owns certificate, certChain, key, dh, and cm */
@@ -1710,6 +2760,9 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
         ssl->buffers.serverDH_P = ctx->serverDH_P;
         ssl->buffers.serverDH_G = ctx->serverDH_G;
     }
+#ifdef HAVE_ECC
+    InitDualCert(ssl, ctx);
+#endif
 #endif
     ssl->buffers.weOwnCert      = 0;
     ssl->buffers.weOwnCertChain = 0;
@@ -1725,8 +2778,11 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 #ifdef KEEP_PEER_CERT
     ssl->peerCert.issuer.sz    = 0;
     ssl->peerCert.subject.sz   = 0;
+    ssl->peerCertLazy          = 0;
 #endif
 
+    ssl->session.isAlloced = 0;
+
 #ifdef SESSION_CERTS
     ssl->session.chain.count = 0;
 #endif
@@ -1752,18 +2808,35 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->toInfoOn = 0;
 #endif
 
+#ifdef CYASSL_HANDSHAKE_TIMING
+    ssl->hsTiming       = NULL;
+    ssl->hsTimingPicked = 0;
+#endif
+
 #ifdef HAVE_CAVIUM
     ssl->devId = ctx->devId;
 #endif
 
 #ifdef HAVE_TLS_EXTENSIONS
     ssl->extensions = NULL;
+#if defined(HAVE_SUPPORTED_CURVES) && !defined(NO_CYASSL_SERVER)
+    XMEMSET(&ssl->peerCurves, 0, sizeof(ssl->peerCurves));
+#endif
 #ifdef HAVE_MAX_FRAGMENT
     ssl->max_fragment = MAX_RECORD_SIZE;
 #endif
 #ifdef HAVE_TRUNCATED_HMAC
     ssl->truncated_hmac = 0;
 #endif
+#ifdef HAVE_ENCRYPT_THEN_MAC
+    ssl->encrypt_then_mac = 0;
+#endif
+#ifdef HAVE_CACHED_INFO
+    ssl->cached_chain.buffer = NULL;
+    ssl->cached_chain.length = 0;
+    ssl->cached_keep = 0;
+    ssl->cached_cert = 0;
+#endif
 #ifdef HAVE_SECURE_RENEGOTIATION
     ssl->secure_renegotiation = NULL;
 #endif
@@ -1772,10 +2845,23 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->session_ticket_ctx = NULL;
     ssl->expect_session_ticket = 0;
 #endif
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+#ifndef NO_CYASSL_SERVER
+    ssl->ocspStaple.buffer = NULL;
+    ssl->ocspStaple.length = 0;
+#endif
+#endif
+#endif
+#ifdef HAVE_OCSP
+    ssl->ocspPending = NULL;
+#endif
+#ifdef HAVE_CONN_POOL
+    ssl->poolUpstream = NULL;
 #endif
 
     ssl->rng    = NULL;
     ssl->arrays = NULL;
+    ssl->hsHashes = NULL;
 
     /* default alert state (none) */
     ssl->alert_history.last_rx.code  = -1;
@@ -1793,6 +2879,13 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
     ssl->fuzzerCb         = NULL;
     ssl->fuzzerCtx        = NULL;
 #endif
+#ifndef NO_CYASSL_SERVER
+    ssl->ClientHelloCtx   = NULL;
+#endif
+#ifdef CYASSL_ASYNC_CRYPT
+    ssl->async            = NULL;
+    ssl->AsyncSubmitCtx   = NULL;
+#endif
 #ifdef HAVE_PK_CALLBACKS
     #ifdef HAVE_ECC
         ssl->EccSignCtx   = NULL;
@@ -1808,37 +2901,34 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 
     /* all done with init, now can return errors, call other stuff */
 
-#ifndef NO_OLD_TLS
-#ifndef NO_MD5
-    InitMd5(&ssl->hashMd5);
-#endif
-#ifndef NO_SHA
-    ret = InitSha(&ssl->hashSha);
-    if (ret != 0) {
-        return ret;
+#ifdef CYASSL_MEM_STATS
+    if (ssl->memStats == NULL) {
+        CYASSL_MSG("Memory stats handle alloc failed");
+        return MEMORY_E;
     }
 #endif
-#endif
-#ifndef NO_SHA256
-    ret = InitSha256(&ssl->hashSha256);
-    if (ret != 0) {
+
+    /* increment CTX reference count */
+    if ((ret = SSL_CtxUpRef(ctx)) != 0)
         return ret;
-    }
+
+#ifdef CYASSL_HANDSHAKE_ARENA
+    HsArenaInit(ssl);
 #endif
-#ifdef CYASSL_SHA384
-    ret = InitSha384(&ssl->hashSha384);
-    if (ret != 0) {
-        return ret;
+
+    /* handshake hashes */
+    ssl->hsHashes = (HS_Hashes*)HsAlloc(ssl, sizeof(HS_Hashes),
+                                                           DYNAMIC_TYPE_HASHES);
+    if (ssl->hsHashes == NULL) {
+        CYASSL_MSG("HS_Hashes Memory error");
+        return MEMORY_E;
     }
-#endif
+    XMEMSET(ssl->hsHashes, 0, sizeof(HS_Hashes));
 
-    /* increment CTX reference count */
-    if (LockMutex(&ctx->countMutex) != 0) {
-        CYASSL_MSG("Couldn't lock CTX count mutex");
-        return BAD_MUTEX_E;
+    ret = InitHandshakeHashes(ssl);
+    if (ret != 0) {
+        return ret;
     }
-    ctx->refCount++;
-    UnLockMutex(&ctx->countMutex);
 
     /* arrays */
     ssl->arrays = (Arrays*)XMALLOC(sizeof(Arrays), ssl->heap,
@@ -1870,14 +2960,19 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
         return MEMORY_E;
     }
 
-    if ( (ret = InitRng(ssl->rng)) != 0) {
+#ifdef CYASSL_TLS_THREAD_RNG
+    /* connections share their thread's DRBG, seeded once per thread */
+    ret = InitRngThread(ssl->rng);
+#else
+    ret = InitRng(ssl->rng);
+#endif
+    if (ret != 0) {
         CYASSL_MSG("RNG Init error");
         return ret;
     }
 
     /* suites */
-    ssl->suites = (Suites*)XMALLOC(sizeof(Suites), ssl->heap,
-                                   DYNAMIC_TYPE_SUITES);
+    ssl->suites = (Suites*)HsAlloc(ssl, sizeof(Suites), DYNAMIC_TYPE_SUITES);
     if (ssl->suites == NULL) {
         CYASSL_MSG("Suites Memory error");
         return MEMORY_E;
@@ -1886,8 +2981,7 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 
     /* peer key */
 #ifndef NO_RSA
-    ssl->peerRsaKey = (RsaKey*)XMALLOC(sizeof(RsaKey), ssl->heap,
-                                       DYNAMIC_TYPE_RSA);
+    ssl->peerRsaKey = (RsaKey*)HsAlloc(ssl, sizeof(RsaKey), DYNAMIC_TYPE_RSA);
     if (ssl->peerRsaKey == NULL) {
         CYASSL_MSG("PeerRsaKey Memory error");
         return MEMORY_E;
@@ -1904,26 +2998,26 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
         }
 #endif
 #ifdef HAVE_ECC
-    ssl->peerEccKey = (ecc_key*)XMALLOC(sizeof(ecc_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->peerEccKey = (ecc_key*)HsAlloc(ssl, sizeof(ecc_key),
+                                                             DYNAMIC_TYPE_ECC);
     if (ssl->peerEccKey == NULL) {
         CYASSL_MSG("PeerEccKey Memory error");
         return MEMORY_E;
     }
-    ssl->peerEccDsaKey = (ecc_key*)XMALLOC(sizeof(ecc_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->peerEccDsaKey = (ecc_key*)HsAlloc(ssl, sizeof(ecc_key),
+                                                             DYNAMIC_TYPE_ECC);
     if (ssl->peerEccDsaKey == NULL) {
         CYASSL_MSG("PeerEccDsaKey Memory error");
         return MEMORY_E;
     }
-    ssl->eccDsaKey = (ecc_key*)XMALLOC(sizeof(ecc_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->eccDsaKey = (ecc_key*)HsAlloc(ssl, sizeof(ecc_key),
+                                                             DYNAMIC_TYPE_ECC);
     if (ssl->eccDsaKey == NULL) {
         CYASSL_MSG("EccDsaKey Memory error");
         return MEMORY_E;
     }
-    ssl->eccTempKey = (ecc_key*)XMALLOC(sizeof(ecc_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->eccTempKey = (ecc_key*)HsAlloc(ssl, sizeof(ecc_key),
+                                                             DYNAMIC_TYPE_ECC);
     if (ssl->eccTempKey == NULL) {
         CYASSL_MSG("EccTempKey Memory error");
         return MEMORY_E;
@@ -1939,14 +3033,14 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
 #endif
 
 #ifdef HAVE_ECC25519
-    ssl->peerEcc25519Key = (ecc25519_key*)XMALLOC(sizeof(ecc25519_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->peerEcc25519Key = (ecc25519_key*)HsAlloc(ssl,
+                                       sizeof(ecc25519_key), DYNAMIC_TYPE_ECC);
     if (ssl->peerEcc25519Key == NULL) {
         CYASSL_MSG("PeerEcc25519Key Memory error");
         return MEMORY_E;
     }
-    ssl->ecc25519TempKey = (ecc25519_key*)XMALLOC(sizeof(ecc25519_key),
-                                                   ctx->heap, DYNAMIC_TYPE_ECC);
+    ssl->ecc25519TempKey = (ecc25519_key*)HsAlloc(ssl,
+                                       sizeof(ecc25519_key), DYNAMIC_TYPE_ECC);
     if (ssl->ecc25519TempKey == NULL) {
         CYASSL_MSG("Ecc25519TempKey Memory error");
         return MEMORY_E;
@@ -1962,11 +3056,12 @@ int InitSSL(CYASSL* ssl, CYASSL_CTX* ctx)
         InitSuites(ssl->suites, ssl->version, haveRSA, havePSK,
                    ssl->options.haveDH, ssl->options.haveNTRU,
                    ssl->options.haveECDSAsig, ssl->options.haveStaticECC,
-                   ssl->options.side);
+                   ssl->options.haveDualCert, ssl->options.side);
     else
         InitSuites(ssl->suites, ssl->version, haveRSA, havePSK, TRUE,
                    ssl->options.haveNTRU, ssl->options.haveECDSAsig,
-                   ssl->options.haveStaticECC, ssl->options.side);
+                   ssl->options.haveStaticECC,
+                   ssl->options.haveDualCert, ssl->options.side);
 
     return 0;
 }
@@ -1994,14 +3089,21 @@ void SSL_ResourceFree(CYASSL* ssl)
      * example with the RNG, it isn't used beyond the handshake except when
      * using stream ciphers where it is retained. */
 
+    SSL_CtxReleaseHandshake(ssl);
     FreeCiphers(ssl);
     FreeArrays(ssl, 0);
 #if defined(HAVE_HASHDRBG) || defined(NO_RC4)
     FreeRng(ssl->rng);
 #endif
     XFREE(ssl->rng, ssl->heap, DYNAMIC_TYPE_RNG);
-    XFREE(ssl->suites, ssl->heap, DYNAMIC_TYPE_SUITES);
+    HsFree(ssl, ssl->suites, DYNAMIC_TYPE_SUITES);
+    if (ssl->hsHashes)
+        XFREE(ssl->hsHashes->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+    HsFree(ssl, ssl->hsHashes, DYNAMIC_TYPE_HASHES);
     XFREE(ssl->buffers.domainName.buffer, ssl->heap, DYNAMIC_TYPE_DOMAIN);
+#ifdef HAVE_SECURE_RENEGOTIATION
+    XFREE(ssl->buffers.renegData.buffer, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+#endif
 
 #ifndef NO_CERTS
     XFREE(ssl->buffers.serverDH_Priv.buffer, ssl->heap, DYNAMIC_TYPE_DH);
@@ -2022,22 +3124,21 @@ void SSL_ResourceFree(CYASSL* ssl)
 #ifndef NO_RSA
     if (ssl->peerRsaKey) {
         FreeRsaKey(ssl->peerRsaKey);
-        XFREE(ssl->peerRsaKey, ssl->heap, DYNAMIC_TYPE_RSA);
+        HsFree(ssl, ssl->peerRsaKey, DYNAMIC_TYPE_RSA);
     }
 #endif
     if (ssl->buffers.inputBuffer.dynamicFlag)
         ShrinkInputBuffer(ssl, FORCED_FREE);
     if (ssl->buffers.outputBuffer.dynamicFlag)
         ShrinkOutputBuffer(ssl);
+    if (ssl->buffers.memOut)
+        XFREE(ssl->buffers.memOut, ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
 #ifdef CYASSL_DTLS
     if (ssl->dtls_pool != NULL) {
         DtlsPoolReset(ssl);
-        XFREE(ssl->dtls_pool, ssl->heap, DYNAMIC_TYPE_NONE);
-    }
-    if (ssl->dtls_msg_list != NULL) {
-        DtlsMsgListDelete(ssl->dtls_msg_list, ssl->heap);
-        ssl->dtls_msg_list = NULL;
+        HsFree(ssl, ssl->dtls_pool, DYNAMIC_TYPE_DTLS_POOL);
     }
+    DtlsMsgListDelete(ssl);
     XFREE(ssl->buffers.dtlsCtx.peer.sa, ssl->heap, DYNAMIC_TYPE_SOCKADDR);
     ssl->buffers.dtlsCtx.peer.sa = NULL;
 #endif
@@ -2056,34 +3157,34 @@ void SSL_ResourceFree(CYASSL* ssl)
     if (ssl->peerEccKey) {
         if (ssl->peerEccKeyPresent)
             ecc_free(ssl->peerEccKey);
-        XFREE(ssl->peerEccKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEccKey, DYNAMIC_TYPE_ECC);
     }
     if (ssl->peerEccDsaKey) {
         if (ssl->peerEccDsaKeyPresent)
             ecc_free(ssl->peerEccDsaKey);
-        XFREE(ssl->peerEccDsaKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEccDsaKey, DYNAMIC_TYPE_ECC);
     }
     if (ssl->eccTempKey) {
         if (ssl->eccTempKeyPresent)
             ecc_free(ssl->eccTempKey);
-        XFREE(ssl->eccTempKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->eccTempKey, DYNAMIC_TYPE_ECC);
     }
     if (ssl->eccDsaKey) {
         if (ssl->eccDsaKeyPresent)
             ecc_free(ssl->eccDsaKey);
-        XFREE(ssl->eccDsaKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->eccDsaKey, DYNAMIC_TYPE_ECC);
     }
 #endif
 #ifdef HAVE_ECC25519
     if (ssl->peerEcc25519Key) {
         if (ssl->peerEcc25519KeyPresent)
             ecc25519_free(ssl->peerEcc25519Key);
-        XFREE(ssl->peerEcc25519Key, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEcc25519Key, DYNAMIC_TYPE_ECC);
     }
     if (ssl->ecc25519TempKey) {
         if (ssl->ecc25519TempKeyPresent)
             ecc25519_free(ssl->ecc25519TempKey);
-        XFREE(ssl->ecc25519TempKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->ecc25519TempKey, DYNAMIC_TYPE_ECC);
     }
 #endif
 #ifdef HAVE_PK_CALLBACKS
@@ -2094,13 +3195,42 @@ void SSL_ResourceFree(CYASSL* ssl)
         XFREE(ssl->buffers.peerRsaKey.buffer, ssl->heap, DYNAMIC_TYPE_RSA);
     #endif /* NO_RSA */
 #endif /* HAVE_PK_CALLBACKS */
+#ifdef CYASSL_ASYNC_CRYPT
+    if (ssl->async) {
+        FreeMutex(&ssl->async->mutex);
+        XMEMSET(ssl->async, 0, sizeof(CYASSL_ASYNC_OP));
+        XFREE(ssl->async, ssl->heap, DYNAMIC_TYPE_ASYNC);
+    }
+#endif
 #ifdef HAVE_TLS_EXTENSIONS
     TLSX_FreeAll(ssl->extensions);
 #endif
+#ifdef HAVE_CACHED_INFO
+    XFREE(ssl->cached_chain.buffer, ssl->heap, DYNAMIC_TYPE_CERT);
+#endif
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+#ifndef NO_CYASSL_SERVER
+    if (ssl->ocspStaple.buffer)
+        XFREE(ssl->ocspStaple.buffer, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+#endif
+#endif
+#ifdef HAVE_OCSP
+    FreeOcspPending(ssl);
+#endif
 #ifdef HAVE_NETX
     if (ssl->nxCtx.nxPacket)
         nx_packet_release(ssl->nxCtx.nxPacket);
 #endif
+#ifdef CYASSL_HANDSHAKE_ARENA
+    /* anything still counted in it was lost on an error path */
+    XFREE(ssl->hsArena.block, ssl->heap, DYNAMIC_TYPE_ARENA);
+    ssl->hsArena.block = NULL;
+#endif
+#ifdef CYASSL_HANDSHAKE_TIMING
+    /* handshake never finished, no callback */
+    XFREE(ssl->hsTiming, ssl->heap, DYNAMIC_TYPE_HS_TIMING);
+    ssl->hsTiming = NULL;
+#endif
 }
 
 
@@ -2115,16 +3245,23 @@ void FreeHandshakeResources(CYASSL* ssl)
     }
 #endif
 
-    /* input buffer */
-    if (ssl->buffers.inputBuffer.dynamicFlag)
+    /* input buffer, unless early app data there still waits for a read */
+    if (ssl->buffers.inputBuffer.dynamicFlag &&
+                                 ssl->buffers.clearOutputBuffer.length == 0)
         ShrinkInputBuffer(ssl, NO_FORCED_FREE);
 
     /* suites */
-    XFREE(ssl->suites, ssl->heap, DYNAMIC_TYPE_SUITES);
+    HsFree(ssl, ssl->suites, DYNAMIC_TYPE_SUITES);
     ssl->suites = NULL;
 
-    /* RNG */
-    if (ssl->specs.cipher_type == stream || ssl->options.tls1_1 == 0) {
+    /* handshake hashes */
+    if (ssl->hsHashes)
+        XFREE(ssl->hsHashes->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+    HsFree(ssl, ssl->hsHashes, DYNAMIC_TYPE_HASHES);
+    ssl->hsHashes = NULL;
+
+    /* RNG, only block ciphers with explicit IVs still need it */
+    if (ssl->specs.cipher_type != block || ssl->options.tls1_1 == 0) {
 #if defined(HAVE_HASHDRBG) || defined(NO_RC4)
         FreeRng(ssl->rng);
 #endif
@@ -2136,20 +3273,60 @@ void FreeHandshakeResources(CYASSL* ssl)
     /* DTLS_POOL */
     if (ssl->options.dtls && ssl->dtls_pool != NULL) {
         DtlsPoolReset(ssl);
-        XFREE(ssl->dtls_pool, ssl->heap, DYNAMIC_TYPE_DTLS_POOL);
+        HsFree(ssl, ssl->dtls_pool, DYNAMIC_TYPE_DTLS_POOL);
         ssl->dtls_pool = NULL;
     }
 #endif
 
     /* arrays */
-    if (ssl->options.saveArrays)
+    if (!ssl->options.saveArrays)
         FreeArrays(ssl, 1);
 
+#ifndef NO_CERTS
+    /* our ephemeral DH pair, and the peer's params when we're the client */
+    XFREE(ssl->buffers.serverDH_Priv.buffer, ssl->heap, DYNAMIC_TYPE_DH);
+    ssl->buffers.serverDH_Priv.buffer = NULL;
+    XFREE(ssl->buffers.serverDH_Pub.buffer, ssl->heap, DYNAMIC_TYPE_DH);
+    ssl->buffers.serverDH_Pub.buffer = NULL;
+    if (ssl->options.side == CYASSL_CLIENT_END ||
+                        (ssl->options.compact && ssl->buffers.weOwnDH)) {
+        XFREE(ssl->buffers.serverDH_G.buffer, ssl->heap, DYNAMIC_TYPE_DH);
+        ssl->buffers.serverDH_G.buffer = NULL;
+        XFREE(ssl->buffers.serverDH_P.buffer, ssl->heap, DYNAMIC_TYPE_DH);
+        ssl->buffers.serverDH_P.buffer = NULL;
+        ssl->buffers.weOwnDH = 0;
+    }
+
+    /* compact also drops a cert and key this ssl loaded for itself, the
+       record phase doesn't use them */
+    if (ssl->options.compact) {
+        if (ssl->buffers.weOwnCert) {
+            XFREE(ssl->buffers.certificate.buffer, ssl->heap,
+                                                            DYNAMIC_TYPE_CERT);
+            ssl->buffers.certificate.buffer = NULL;
+            ssl->buffers.certificate.length = 0;
+            ssl->buffers.weOwnCert = 0;
+        }
+        if (ssl->buffers.weOwnCertChain) {
+            XFREE(ssl->buffers.certChain.buffer, ssl->heap, DYNAMIC_TYPE_CERT);
+            ssl->buffers.certChain.buffer = NULL;
+            ssl->buffers.certChain.length = 0;
+            ssl->buffers.weOwnCertChain = 0;
+        }
+        if (ssl->buffers.weOwnKey) {
+            XFREE(ssl->buffers.key.buffer, ssl->heap, DYNAMIC_TYPE_KEY);
+            ssl->buffers.key.buffer = NULL;
+            ssl->buffers.key.length = 0;
+            ssl->buffers.weOwnKey = 0;
+        }
+    }
+#endif
+
 #ifndef NO_RSA
     /* peerRsaKey */
     if (ssl->peerRsaKey) {
         FreeRsaKey(ssl->peerRsaKey);
-        XFREE(ssl->peerRsaKey, ssl->heap, DYNAMIC_TYPE_RSA);
+        HsFree(ssl, ssl->peerRsaKey, DYNAMIC_TYPE_RSA);
         ssl->peerRsaKey = NULL;
     }
 #endif
@@ -2161,7 +3338,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc_free(ssl->peerEccKey);
             ssl->peerEccKeyPresent = 0;
         }
-        XFREE(ssl->peerEccKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEccKey, DYNAMIC_TYPE_ECC);
         ssl->peerEccKey = NULL;
     }
     if (ssl->peerEccDsaKey)
@@ -2170,7 +3347,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc_free(ssl->peerEccDsaKey);
             ssl->peerEccDsaKeyPresent = 0;
         }
-        XFREE(ssl->peerEccDsaKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEccDsaKey, DYNAMIC_TYPE_ECC);
         ssl->peerEccDsaKey = NULL;
     }
     if (ssl->eccTempKey)
@@ -2179,7 +3356,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc_free(ssl->eccTempKey);
             ssl->eccTempKeyPresent = 0;
         }
-        XFREE(ssl->eccTempKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->eccTempKey, DYNAMIC_TYPE_ECC);
         ssl->eccTempKey = NULL;
     }
     if (ssl->eccDsaKey)
@@ -2188,7 +3365,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc_free(ssl->eccDsaKey);
             ssl->eccDsaKeyPresent = 0;
         }
-        XFREE(ssl->eccDsaKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->eccDsaKey, DYNAMIC_TYPE_ECC);
         ssl->eccDsaKey = NULL;
     }
 #endif
@@ -2200,7 +3377,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc25519_free(ssl->peerEcc25519Key);
             ssl->peerEcc25519KeyPresent = 0;
         }
-        XFREE(ssl->peerEcc25519Key, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->peerEcc25519Key, DYNAMIC_TYPE_ECC);
         ssl->peerEcc25519Key = NULL;
     }
     if (ssl->ecc25519TempKey)
@@ -2209,7 +3386,7 @@ void FreeHandshakeResources(CYASSL* ssl)
             ecc25519_free(ssl->ecc25519TempKey);
             ssl->ecc25519TempKeyPresent = 0;
         }
-        XFREE(ssl->ecc25519TempKey, ssl->heap, DYNAMIC_TYPE_ECC);
+        HsFree(ssl, ssl->ecc25519TempKey, DYNAMIC_TYPE_ECC);
         ssl->ecc25519TempKey = NULL;
     }
 #endif
@@ -2226,21 +3403,91 @@ void FreeHandshakeResources(CYASSL* ssl)
 }
 
 
-void FreeSSL(CYASSL* ssl)
+void FreeSSL(CYASSL* ssl)
+{
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemStats* stats = ssl->memStats;
+#endif
+
+    FreeSSL_Ctx(ssl->ctx);  /* will decrement and free underyling CTX if 0 */
+    SSL_ResourceFree(ssl);
+    XFREE(ssl, ssl->heap, DYNAMIC_TYPE_SSL);
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemStatsFree(stats);
+#endif
+}
+
+
+#ifdef CYASSL_DTLS
+
+/* Retransmission timeout for a new flight in seconds, RFC 6298 style from
+ * the measured flight round trips once there is a sample. LowResTimer() has
+ * one second resolution so that is also the smallest variance allowed. */
+static int DtlsRto(CYASSL* ssl)
+{
+    word32 rto;
+
+    if (!ssl->dtls_rtt_valid || ssl->dtls_timeout_init == 0)
+        return ssl->dtls_timeout_init;
+
+    rto = ssl->dtls_srtt + (ssl->dtls_rttvar < 250 ? 1000
+                                                  : 4 * ssl->dtls_rttvar);
+    rto = (rto + 999) / 1000;
+
+    return (int)min(rto, (word32)ssl->dtls_timeout_max);
+}
+
+
+/* Takes the time from sending the current flight to the first message of the
+ * peer's reply. Per Karn, flights that were resent give no sample. */
+static void DtlsRttSample(CYASSL* ssl)
 {
-    FreeSSL_Ctx(ssl->ctx);  /* will decrement and free underyling CTX if 0 */
-    SSL_ResourceFree(ssl);
-    XFREE(ssl, ssl->heap, DYNAMIC_TYPE_SSL);
+    word32 rtt;
+
+    if (ssl->dtls_flight_timed || ssl->dtls_pool == NULL ||
+                                                  ssl->dtls_pool->used == 0)
+        return;
+
+    ssl->dtls_flight_timed = 1;
+    rtt = (LowResTimer() - ssl->dtls_flight_start) * 1000;
+
+    if (!ssl->dtls_rtt_valid) {
+        ssl->dtls_srtt   = rtt;
+        ssl->dtls_rttvar = rtt / 2;
+        ssl->dtls_rtt_valid = 1;
+    }
+    else {
+        word32 diff = ssl->dtls_srtt > rtt ? ssl->dtls_srtt - rtt
+                                           : rtt - ssl->dtls_srtt;
+
+        ssl->dtls_rttvar = (3 * ssl->dtls_rttvar + diff) / 4;
+        ssl->dtls_srtt   = (7 * ssl->dtls_srtt + rtt) / 8;
+    }
 }
 
 
-#ifdef CYASSL_DTLS
+/* The peer only builds its next flight once all of ours arrived, so any of
+ * it showing up means there is nothing of ours left to resend. */
+static int DtlsPoolAnswered(CYASSL* ssl)
+{
+    int i;
+
+    if (ssl->keys.dtls_expected_peer_handshake_number > ssl->dtls_flight_peer)
+        return 1;
+
+    for (i = 0; i < DTLS_MSG_SLOTS; i++)
+        if (ssl->dtls_msg_slots[i] != NULL)
+            return 1;
+
+    return 0;
+}
+
 
 int DtlsPoolInit(CYASSL* ssl)
 {
     if (ssl->dtls_pool == NULL) {
-        DtlsPool *pool = (DtlsPool*)XMALLOC(sizeof(DtlsPool),
-                                             ssl->heap, DYNAMIC_TYPE_DTLS_POOL);
+        DtlsPool *pool = (DtlsPool*)HsAlloc(ssl, sizeof(DtlsPool),
+                                                        DYNAMIC_TYPE_DTLS_POOL);
         if (pool == NULL) {
             CYASSL_MSG("DTLS Buffer Pool Memory error");
             return MEMORY_E;
@@ -2265,6 +3512,15 @@ int DtlsPoolSave(CYASSL* ssl, const byte *src, int sz)
     DtlsPool *pool = ssl->dtls_pool;
     if (pool != NULL && pool->used < DTLS_POOL_SZ) {
         buffer *pBuf = &pool->buf[pool->used];
+
+        if (pool->used == 0) {
+            /* first record of a flight, the peer's reply times it */
+            ssl->dtls_flight_start = LowResTimer();
+            ssl->dtls_flight_peer  =
+                               ssl->keys.dtls_expected_peer_handshake_number;
+            ssl->dtls_flight_timed = 0;
+        }
+
         pBuf->buffer = (byte*)XMALLOC(sz, ssl->heap, DYNAMIC_TYPE_DTLS_POOL);
         if (pBuf->buffer == NULL) {
             CYASSL_MSG("DTLS Buffer Memory error");
@@ -2293,7 +3549,7 @@ void DtlsPoolReset(CYASSL* ssl)
         }
         pool->used = 0;
     }
-    ssl->dtls_timeout = ssl->dtls_timeout_init;
+    ssl->dtls_timeout = DtlsRto(ssl);
 }
 
 
@@ -2313,8 +3569,15 @@ int DtlsPoolSend(CYASSL* ssl)
     int ret;
     DtlsPool *pool = ssl->dtls_pool;
 
+    if (pool != NULL && pool->used > 0 && DtlsPoolAnswered(ssl)) {
+        CYASSL_MSG("Peer is replying to our flight, not resending it");
+        return 0;
+    }
+
     if (pool != NULL && pool->used > 0) {
         int i;
+
+        ssl->dtls_flight_timed = 1;     /* reply could be to either send */
         for (i = 0; i < pool->used; i++) {
             int sendResult;
             buffer* buf = &pool->buf[i];
@@ -2368,10 +3631,11 @@ DtlsMsg* DtlsMsgNew(word32 sz, void* heap)
         msg->buf = (byte*)XMALLOC(sz + DTLS_HANDSHAKE_HEADER_SZ,
                                                      heap, DYNAMIC_TYPE_NONE);
         if (msg->buf != NULL) {
-            msg->next = NULL;
             msg->seq = 0;
             msg->sz = sz;
             msg->fragSz = 0;
+            msg->type = 0;
+            msg->fragList = NULL;
             msg->msg = msg->buf + DTLS_HANDSHAKE_HEADER_SZ;
         }
         else {
@@ -2388,6 +3652,13 @@ void DtlsMsgDelete(DtlsMsg* item, void* heap)
     (void)heap;
 
     if (item != NULL) {
+        DtlsFrag* frag = item->fragList;
+
+        while (frag != NULL) {
+            DtlsFrag* next = frag->next;
+            XFREE(frag, heap, DYNAMIC_TYPE_DTLS_MSG);
+            frag = next;
+        }
         if (item->buf != NULL)
             XFREE(item->buf, heap, DYNAMIC_TYPE_NONE);
         XFREE(item, heap, DYNAMIC_TYPE_DTLS_MSG);
@@ -2395,123 +3666,155 @@ void DtlsMsgDelete(DtlsMsg* item, void* heap)
 }
 
 
-void DtlsMsgListDelete(DtlsMsg* head, void* heap)
+void DtlsMsgListDelete(CYASSL* ssl)
 {
-    DtlsMsg* next;
-    while (head) {
-        next = head->next;
-        DtlsMsgDelete(head, heap);
-        head = next;
+    int i;
+
+    for (i = 0; i < DTLS_MSG_SLOTS; i++) {
+        DtlsMsgDelete(ssl->dtls_msg_slots[i], ssl->heap);
+        ssl->dtls_msg_slots[i] = NULL;
     }
+    ssl->dtls_msg_mem = 0;
 }
 
 
-void DtlsMsgSet(DtlsMsg* msg, word32 seq, const byte* data, byte type,
-                                              word32 fragOffset, word32 fragSz)
+/* Merges the byte range [begin, end) into the message's sorted range list,
+ * counting only bytes not already covered so duplicate and overlapping
+ * fragments can't complete a message early. */
+static int DtlsMsgAddFrag(DtlsMsg* msg, word32 begin, word32 end, void* heap)
 {
-    if (msg != NULL && data != NULL && msg->fragSz <= msg->sz &&
-                     fragOffset < msg->sz && (fragOffset + fragSz) <= msg->sz) {
+    DtlsFrag** prev = &msg->fragList;
+    DtlsFrag*  cur;
+    DtlsFrag*  frag;
 
-        msg->seq = seq;
-        msg->type = type;
-        msg->fragSz += fragSz;
-        /* If fragOffset is zero, this is either a full message that is out
-         * of order, or the first fragment of a fragmented message. Copy the
-         * handshake message header as well as the message data. */
-        if (fragOffset == 0)
-            XMEMCPY(msg->buf, data - DTLS_HANDSHAKE_HEADER_SZ,
-                                            fragSz + DTLS_HANDSHAKE_HEADER_SZ);
-        else {
-            /* If fragOffet is non-zero, this is an additional fragment that
-             * needs to be copied to its location in the message buffer. Also
-             * copy the total size of the message over the fragment size. The
-             * hash routines look at a defragmented message if it had actually
-             * come across as a single handshake message. */
-            XMEMCPY(msg->msg + fragOffset, data, fragSz);
-            c32to24(msg->sz, msg->msg - DTLS_HANDSHAKE_FRAG_SZ);
+    (void)heap;
+
+    while (*prev != NULL && (*prev)->end < begin)
+        prev = &(*prev)->next;
+    cur = *prev;
+
+    if (cur == NULL || end < cur->begin) {
+        frag = (DtlsFrag*)XMALLOC(sizeof(DtlsFrag), heap,
+                                                        DYNAMIC_TYPE_DTLS_MSG);
+        if (frag == NULL)
+            return MEMORY_E;
+
+        frag->begin = begin;
+        frag->end   = end;
+        frag->next  = cur;
+        *prev = frag;
+        msg->fragSz += end - begin;
+        return 0;
+    }
+
+    /* touches cur, widen it and swallow any ranges the new one bridges */
+    if (begin < cur->begin) {
+        msg->fragSz += cur->begin - begin;
+        cur->begin = begin;
+    }
+    while (end > cur->end) {
+        frag = cur->next;
+        if (frag == NULL || end < frag->begin) {
+            msg->fragSz += end - cur->end;
+            cur->end = end;
+            break;
         }
+        msg->fragSz += frag->begin - cur->end;
+        cur->end  = frag->end;
+        cur->next = frag->next;
+        XFREE(frag, heap, DYNAMIC_TYPE_DTLS_MSG);
     }
+
+    return 0;
 }
 
 
-DtlsMsg* DtlsMsgFind(DtlsMsg* head, word32 seq)
+int DtlsMsgSet(DtlsMsg* msg, const byte* data, word32 fragOffset,
+                                                   word32 fragSz, void* heap)
 {
-    while (head != NULL && head->seq != seq) {
-        head = head->next;
-    }
-    return head;
+    int ret;
+
+    if (msg == NULL || data == NULL || fragSz == 0 || fragOffset > msg->sz ||
+                                               fragSz > msg->sz - fragOffset)
+        return BAD_FUNC_ARG;
+
+    ret = DtlsMsgAddFrag(msg, fragOffset, fragOffset + fragSz, heap);
+    if (ret == 0)
+        XMEMCPY(msg->msg + fragOffset, data, fragSz);
+
+    return ret;
 }
 
 
-DtlsMsg* DtlsMsgStore(DtlsMsg* head, word32 seq, const byte* data,
-        word32 dataSz, byte type, word32 fragOffset, word32 fragSz, void* heap)
+DtlsMsg* DtlsMsgFind(CYASSL* ssl, word32 seq)
 {
+    DtlsMsg* item = ssl->dtls_msg_slots[seq % DTLS_MSG_SLOTS];
 
-    /* See if seq exists in the list. If it isn't in the list, make
-     * a new item of size dataSz, copy fragSz bytes from data to msg->msg
-     * starting at offset fragOffset, and add fragSz to msg->fragSz. If
-     * the seq is in the list and it isn't full, copy fragSz bytes from
-     * data to msg->msg starting at offset fragOffset, and add fragSz to
-     * msg->fragSz. The new item should be inserted into the list in its
-     * proper position.
-     *
-     * 1. Find seq in list, or where seq should go in list. If seq not in
-     *    list, create new item and insert into list. Either case, keep
-     *    pointer to item.
-     * 2. If msg->fragSz + fragSz < sz, copy data to msg->msg at offset
-     *    fragOffset. Add fragSz to msg->fragSz.
-     */
+    return (item != NULL && item->seq == seq) ? item : NULL;
+}
 
-    if (head != NULL) {
-        DtlsMsg* cur = DtlsMsgFind(head, seq);
-        if (cur == NULL) {
-            cur = DtlsMsgNew(dataSz, heap);
-            if (cur != NULL) {
-                DtlsMsgSet(cur, seq, data, type, fragOffset, fragSz);
-                head = DtlsMsgInsert(head, cur);
-            }
-        }
-        else {
-            DtlsMsgSet(cur, seq, data, type, fragOffset, fragSz);
-        }
-    }
-    else {
-        head = DtlsMsgNew(dataSz, heap);
-        DtlsMsgSet(head, seq, data, type, fragOffset, fragSz);
-    }
 
-    return head;
+void DtlsMsgRemove(CYASSL* ssl, word32 seq)
+{
+    DtlsMsg* item = DtlsMsgFind(ssl, seq);
+
+    if (item != NULL) {
+        ssl->dtls_msg_slots[seq % DTLS_MSG_SLOTS] = NULL;
+        ssl->dtls_msg_mem -= item->sz + DTLS_HANDSHAKE_HEADER_SZ;
+        DtlsMsgDelete(item, ssl->heap);
+    }
 }
 
 
-/* DtlsMsgInsert() is an in-order insert. */
-DtlsMsg* DtlsMsgInsert(DtlsMsg* head, DtlsMsg* item)
+/* Holds a fragment of handshake message seq until it can be processed. The
+ * slot is seq modulo DTLS_MSG_SLOTS, so only messages within that distance
+ * of the expected one are kept, and only while the connection's total stays
+ * under DTLS_MSG_MEM_MAX. Anything dropped comes again with the peer's next
+ * retransmission, so only allocation failures are errors. */
+int DtlsMsgStore(CYASSL* ssl, word32 seq, const byte* data, word32 dataSz,
+                                   byte type, word32 fragOffset, word32 fragSz)
 {
-    if (head == NULL || item->seq < head->seq) {
-        item->next = head;
-        head = item;
-    }
-    else if (head->next == NULL) {
-        head->next = item;
-    }
-    else {
-        DtlsMsg* cur = head->next;
-        DtlsMsg* prev = head;
-        while (cur) {
-            if (item->seq < cur->seq) {
-                item->next = cur;
-                prev->next = item;
-                break;
-            }
-            prev = cur;
-            cur = cur->next;
-        }
-        if (cur == NULL) {
-            prev->next = item;
+    DtlsMsg* item;
+    word32   expected = ssl->keys.dtls_expected_peer_handshake_number;
+    int      ret;
+
+    if (seq < expected || seq - expected >= DTLS_MSG_SLOTS)
+        return 0;
+
+    item = DtlsMsgFind(ssl, seq);
+    if (item == NULL) {
+        word32 need = dataSz + DTLS_HANDSHAKE_HEADER_SZ;
+
+        if (dataSz > DTLS_MSG_MEM_MAX - DTLS_HANDSHAKE_HEADER_SZ ||
+                                 ssl->dtls_msg_mem > DTLS_MSG_MEM_MAX - need) {
+            CYASSL_MSG("DTLS message store full, dropping fragment");
+            return 0;
         }
+
+        item = DtlsMsgNew(dataSz, ssl->heap);
+        if (item == NULL)
+            return MEMORY_E;
+
+        /* header as if the message had come whole, that's what gets hashed */
+        item->seq  = seq;
+        item->type = type;
+        item->buf[0] = type;
+        c32to24(dataSz, item->buf + 1);
+        c16toa((word16)seq, item->buf + HANDSHAKE_HEADER_SZ);
+        c32to24(0, item->msg - 2 * DTLS_HANDSHAKE_FRAG_SZ);
+        c32to24(dataSz, item->msg - DTLS_HANDSHAKE_FRAG_SZ);
+
+        ssl->dtls_msg_slots[seq % DTLS_MSG_SLOTS] = item;
+        ssl->dtls_msg_mem += need;
+    }
+    else if (item->sz != dataSz || item->type != type) {
+        CYASSL_MSG("DTLS fragment doesn't match stored message");
+        return 0;
     }
 
-    return head;
+    ret = DtlsMsgSet(item, data, fragOffset, fragSz, ssl->heap);
+
+    return ret == MEMORY_E ? ret : 0;
 }
 
 #endif /* CYASSL_DTLS */
@@ -2557,7 +3860,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
 #ifdef USE_WINDOWS_API
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         static int           init = 0;
         static LARGE_INTEGER freq;
@@ -2577,7 +3880,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
     #include "rtptime.h"
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         return (word32)rtp_get_system_sec();
     }
@@ -2585,7 +3888,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
 #elif defined(MICRIUM)
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         NET_SECURE_OS_TICK  clk;
 
@@ -2598,7 +3901,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
 #elif defined(MICROCHIP_TCPIP_V5)
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         return (word32) TickGet();
     }
@@ -2610,14 +3913,14 @@ ProtocolVersion MakeDTLSv1_2(void)
 
         #include <system/tmr/sys_tmr.h>
 
-        word32 LowResTimer(void)
+        static word32 SysLowResTimer(void)
         {
             return (word32) SYS_TMR_TickCountGet();
         }
 
     #else
 
-        word32 LowResTimer(void)
+        static word32 SysLowResTimer(void)
         {
             return (word32) SYS_TICK_Get();
         }
@@ -2626,7 +3929,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
 #elif defined(FREESCALE_MQX)
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         TIME_STRUCT mqxTime;
 
@@ -2637,7 +3940,7 @@ ProtocolVersion MakeDTLSv1_2(void)
 
 #elif defined(CYASSL_TIRTOS)
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         return (word32) MYTIME_gettime();
     }
@@ -2656,21 +3959,358 @@ ProtocolVersion MakeDTLSv1_2(void)
 
     #include <time.h>
 
-    word32 LowResTimer(void)
+    static word32 SysLowResTimer(void)
     {
         return (word32)time(0);
     }
 
-
-#endif /* USE_WINDOWS_API */
+
+#endif /* USE_WINDOWS_API */
+
+
+#ifndef USER_TICKS
+
+/* LowResTimer() is read on every session lookup, ticket and OCSP check.
+   Where the clock is a real syscall it can come from the application's
+   event loop instead, CyaSSL_SetLowResTimeCb(), or from a value a
+   background thread refreshes, CyaSSL_StartCoarseClock() */
+
+static CallbackLowResTime lowResTimeCb  = NULL;
+static void*              lowResTimeCtx = NULL;
+
+#if defined(CYASSL_PTHREADS) && !defined(NO_COARSE_CLOCK)
+    #define HAVE_COARSE_CLOCK
+
+    #include <errno.h>
+    #include <time.h>
+
+    #ifndef COARSE_CLOCK_TICK_MS
+        #define COARSE_CLOCK_TICK_MS 100    /* refresh period */
+    #endif
+
+    static volatile word32 coarseClock   = 0;
+    static volatile int    coarseClockOn = 0;
+    static int             coarseStop    = 0;
+    static pthread_t       coarseTid     = 0;  /* 0 if not running */
+    static pthread_mutex_t coarseLock    = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t  coarseCond    = PTHREAD_COND_INITIALIZER;
+#endif
+
+
+word32 LowResTimer(void)
+{
+    CallbackLowResTime cb = lowResTimeCb;
+
+    if (cb)
+        return (word32)cb(lowResTimeCtx);
+
+#ifdef HAVE_COARSE_CLOCK
+    if (coarseClockOn)
+        return coarseClock;
+#endif
+
+    return SysLowResTimer();
+}
+
+
+/* Use cb(ctx) for the library's seconds clock, NULL goes back to the system
+   one. It only has to be monotonic and tick in seconds, set it before
+   sessions get cached since their times come from it */
+void CyaSSL_SetLowResTimeCb(CallbackLowResTime cb, void* ctx)
+{
+    lowResTimeCtx = ctx;
+    lowResTimeCb  = cb;
+}
+
+
+#ifdef HAVE_COARSE_CLOCK
+
+static void* DoCoarseClock(void* arg)
+{
+    struct timespec wake;
+
+    (void)arg;
+
+    pthread_mutex_lock(&coarseLock);
+    while (!coarseStop) {
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_nsec += COARSE_CLOCK_TICK_MS * 1000000L;
+        if (wake.tv_nsec >= 1000000000L) {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        if (pthread_cond_timedwait(&coarseCond, &coarseLock, &wake) ==
+                                                                    ETIMEDOUT)
+            coarseClock = SysLowResTimer();
+    }
+    pthread_mutex_unlock(&coarseLock);
+
+    return NULL;
+}
+
+
+/* Serve LowResTimer() from a value a background thread refreshes every
+   COARSE_CLOCK_TICK_MS, one clock read per tick however many lookups */
+int CyaSSL_StartCoarseClock(void)
+{
+    CYASSL_ENTER("CyaSSL_StartCoarseClock");
+
+    if (coarseTid != 0) {
+        CYASSL_MSG("Coarse clock thread already running");
+        return SSL_SUCCESS;
+    }
+
+    coarseStop  = 0;
+    coarseClock = SysLowResTimer();
+    if (pthread_create(&coarseTid, NULL, DoCoarseClock, NULL) != 0) {
+        CYASSL_MSG("Thread creation error");
+        coarseTid = 0;
+        return THREAD_CREATE_E;
+    }
+    coarseClockOn = 1;
+
+    return SSL_SUCCESS;
+}
+
+
+/* back to reading the clock directly, CyaSSL_Cleanup() calls this */
+int CyaSSL_StopCoarseClock(void)
+{
+    CYASSL_ENTER("CyaSSL_StopCoarseClock");
+
+    if (coarseTid == 0)
+        return SSL_SUCCESS;
+
+    coarseClockOn = 0;
+    pthread_mutex_lock(&coarseLock);
+    coarseStop = 1;
+    pthread_cond_signal(&coarseCond);
+    pthread_mutex_unlock(&coarseLock);
+
+    pthread_join(coarseTid, NULL);
+    coarseTid = 0;
+
+    return SSL_SUCCESS;
+}
+
+#endif /* HAVE_COARSE_CLOCK */
+
+#endif /* USER_TICKS */
+
+
+#ifndef HAVE_COARSE_CLOCK
+
+int CyaSSL_StartCoarseClock(void)
+{
+    CYASSL_ENTER("CyaSSL_StartCoarseClock");
+    CYASSL_MSG("Not compiled in");
+
+    return NOT_COMPILED_IN;
+}
+
+
+int CyaSSL_StopCoarseClock(void)
+{
+    return SSL_SUCCESS;
+}
+
+#endif /* HAVE_COARSE_CLOCK */
+
+
+/* (re)start the handshake hashes, messages are buffered until the version
+   and suite say which hashes the handshake needs */
+int InitHandshakeHashes(CYASSL* ssl)
+{
+    int ret = 0;
+
+#ifndef NO_OLD_TLS
+#ifndef NO_MD5
+    InitMd5(&ssl->hsHashes->hashMd5);
+#endif
+#ifndef NO_SHA
+    ret = InitSha(&ssl->hsHashes->hashSha);
+    if (ret != 0)
+        return ret;
+#endif
+#endif
+#ifndef NO_SHA256
+    ret = InitSha256(&ssl->hsHashes->hashSha256);
+    if (ret != 0)
+        return ret;
+#endif
+#ifdef CYASSL_SHA384
+    ret = InitSha384(&ssl->hsHashes->hashSha384);
+    if (ret != 0)
+        return ret;
+#endif
+
+    ssl->hsHashes->transcriptSz = 0;
+    ssl->hsHashes->hashMask     = 0;
+
+    return ret;
+}
+
+
+static int UpdateHandshakeHashes(CYASSL* ssl, byte mask, const byte* data,
+                                 int sz)
+{
+    int ret = 0;
+
+#ifndef NO_OLD_TLS
+#if !defined(NO_SHA) && !defined(NO_MD5)
+    /* TLS 1.0 and 1.1 keep both, run them in one pass */
+    if ((mask & (HS_HASH_SHA | HS_HASH_MD5)) == (HS_HASH_SHA | HS_HASH_MD5)) {
+        Md5ShaUpdate(&ssl->hsHashes->hashMd5, &ssl->hsHashes->hashSha, data,
+                     sz);
+        mask = (byte)(mask & ~(HS_HASH_SHA | HS_HASH_MD5));
+    }
+#endif
+#ifndef NO_SHA
+    if (mask & HS_HASH_SHA)
+        ShaUpdate(&ssl->hsHashes->hashSha, data, sz);
+#endif
+#ifndef NO_MD5
+    if (mask & HS_HASH_MD5)
+        Md5Update(&ssl->hsHashes->hashMd5, data, sz);
+#endif
+#endif
+#ifndef NO_SHA256
+    if (mask & HS_HASH_SHA256) {
+        ret = Sha256Update(&ssl->hsHashes->hashSha256, data, sz);
+        if (ret != 0)
+            return ret;
+    }
+#endif
+#ifdef CYASSL_SHA384
+    if (mask & HS_HASH_SHA384) {
+        ret = Sha384Update(&ssl->hsHashes->hashSha384, data, sz);
+        if (ret != 0)
+            return ret;
+    }
+#endif
+
+    (void)mask;
+    (void)data;
+    (void)sz;
+
+    return ret;
+}
+
+
+/* version and suite are set once the hellos are through */
+static INLINE int HandshakeHashesKnown(CYASSL* ssl)
+{
+    if (ssl->options.side == CYASSL_SERVER_END)
+        return ssl->options.clientState >= CLIENT_HELLO_COMPLETE;
+
+    return ssl->options.serverState >= SERVER_HELLO_COMPLETE;
+}
+
+
+/* old versions hash with md5 and sha, TLS 1.2 only with its PRF hash unless
+   a CertificateVerify could sign the transcript with another one */
+static byte NeededHandshakeHashes(CYASSL* ssl)
+{
+    byte mask;
+
+    if (!IsAtLeastTLSv1_2(ssl))
+        return HS_HASH_MD5 | HS_HASH_SHA;
+
+    if (ssl->specs.mac_algorithm <= sha256_mac)
+        mask = HS_HASH_SHA256;
+    else if (ssl->specs.mac_algorithm == sha384_mac)
+        mask = HS_HASH_SHA384;
+    else
+        return HS_HASH_ALL;
+
+#ifndef NO_CERTS
+    if ((ssl->options.side == CYASSL_SERVER_END && ssl->options.verifyPeer) ||
+        (ssl->options.side == CYASSL_CLIENT_END &&
+                                           ssl->buffers.certificate.buffer))
+        mask |= HS_HASH_SHA | HS_HASH_SHA256 | HS_HASH_SHA384;
+#endif
+
+    return mask;
+}
+
+
+/* start running the mask's hashes, over the buffered transcript first */
+static int PickHandshakeHashes(CYASSL* ssl, byte mask)
+{
+    HS_Hashes* hs = ssl->hsHashes;
+    int        ret = 0;
+
+    hs->hashMask = mask;
+    if (hs->transcriptSz)
+        ret = UpdateHandshakeHashes(ssl, mask, hs->transcript,
+                                    hs->transcriptSz);
+
+    XFREE(hs->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+    hs->transcript    = NULL;
+    hs->transcriptSz  = 0;
+    hs->transcriptMax = 0;
+
+    return ret;
+}
+
+
+/* make sure nothing is still buffered before the hashes are read */
+static int FlushHandshakeHashes(CYASSL* ssl)
+{
+    if (ssl->hsHashes->hashMask)
+        return 0;
+
+    return PickHandshakeHashes(ssl, HandshakeHashesKnown(ssl) ?
+                                    NeededHandshakeHashes(ssl) : HS_HASH_ALL);
+}
+
+
+/* add handshake bytes to the transcript, buffered until the hellos decide
+   the hashes, out of memory just runs them all */
+static int HashRaw(CYASSL* ssl, const byte* data, int sz)
+{
+    HS_Hashes* hs = ssl->hsHashes;
+    int        ret = 0;
+
+    if (hs->hashMask == 0 && HandshakeHashesKnown(ssl))
+        ret = PickHandshakeHashes(ssl, NeededHandshakeHashes(ssl));
+    else if (hs->hashMask == 0) {
+        if (hs->transcriptSz + sz > hs->transcriptMax) {
+            word32 max = (hs->transcriptSz + sz) * 2;
+            byte*  tmp = (byte*)XMALLOC(max, ssl->heap, DYNAMIC_TYPE_HASHES);
+
+            if (tmp == NULL)
+                ret = PickHandshakeHashes(ssl, HS_HASH_ALL);
+            else {
+                if (hs->transcriptSz)
+                    XMEMCPY(tmp, hs->transcript, hs->transcriptSz);
+                XFREE(hs->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+                hs->transcript    = tmp;
+                hs->transcriptMax = max;
+            }
+        }
+        if (hs->hashMask == 0) {
+            XMEMCPY(hs->transcript + hs->transcriptSz, data, sz);
+            hs->transcriptSz += sz;
+            return 0;
+        }
+    }
+    if (ret != 0)
+        return ret;
+
+    return UpdateHandshakeHashes(ssl, hs->hashMask, data, sz);
+}
 
 
-/* add output to md5 and sha handshake hashes, exclude record header */
+/* add output to the handshake hashes, exclude record header */
 static int HashOutput(CYASSL* ssl, const byte* output, int sz, int ivSz)
 {
     const byte* adj = output + RECORD_HEADER_SZ + ivSz;
     sz -= RECORD_HEADER_SZ;
 
+    if (ssl->hsHashes == NULL)
+        return 0;   /* handshake done, nothing left to hash into */
+
 #ifdef HAVE_FUZZER
     if (ssl->fuzzerCb)
         ssl->fuzzerCb(ssl, output, sz, FUZZ_HASH, ssl->fuzzerCtx);
@@ -2681,40 +4321,20 @@ static int HashOutput(CYASSL* ssl, const byte* output, int sz, int ivSz)
         sz  -= DTLS_RECORD_EXTRA;
     }
 #endif
-#ifndef NO_OLD_TLS
-#ifndef NO_SHA
-    ShaUpdate(&ssl->hashSha, adj, sz);
-#endif
-#ifndef NO_MD5
-    Md5Update(&ssl->hashMd5, adj, sz);
-#endif
-#endif
-
-    if (IsAtLeastTLSv1_2(ssl)) {
-        int ret;
-
-#ifndef NO_SHA256
-        ret = Sha256Update(&ssl->hashSha256, adj, sz);
-        if (ret != 0)
-            return ret;
-#endif
-#ifdef CYASSL_SHA384
-        ret = Sha384Update(&ssl->hashSha384, adj, sz);
-        if (ret != 0)
-            return ret;
-#endif
-    }
 
-    return 0;
+    return HashRaw(ssl, adj, sz);
 }
 
 
-/* add input to md5 and sha handshake hashes, include handshake header */
+/* add input to the handshake hashes, include handshake header */
 static int HashInput(CYASSL* ssl, const byte* input, int sz)
 {
     const byte* adj = input - HANDSHAKE_HEADER_SZ;
     sz += HANDSHAKE_HEADER_SZ;
 
+    if (ssl->hsHashes == NULL)
+        return 0;   /* handshake done, message gets rejected as out of order */
+
 #ifdef CYASSL_DTLS
     if (ssl->options.dtls) {
         adj -= DTLS_HANDSHAKE_EXTRA;
@@ -2722,31 +4342,7 @@ static int HashInput(CYASSL* ssl, const byte* input, int sz)
     }
 #endif
 
-#ifndef NO_OLD_TLS
-#ifndef NO_SHA
-    ShaUpdate(&ssl->hashSha, adj, sz);
-#endif
-#ifndef NO_MD5
-    Md5Update(&ssl->hashMd5, adj, sz);
-#endif
-#endif
-
-    if (IsAtLeastTLSv1_2(ssl)) {
-        int ret;
-
-#ifndef NO_SHA256
-        ret = Sha256Update(&ssl->hashSha256, adj, sz);
-        if (ret != 0)
-            return ret;
-#endif
-#ifdef CYASSL_SHA384
-        ret = Sha384Update(&ssl->hashSha384, adj, sz);
-        if (ret != 0)
-            return ret;
-#endif
-    }
-
-    return 0;
+    return HashRaw(ssl, adj, sz);
 }
 
 
@@ -2755,6 +4351,11 @@ static void AddRecordHeader(byte* output, word32 length, byte type, CYASSL* ssl)
 {
     RecordLayerHeader* rl;
 
+    /* once encrypting this is the plaintext header BuildMessage replaces,
+       BuildMessage counts the real one */
+    if (!ssl->keys.encryptionOn)
+        CYASSL_STAT_INC(recordsOut);
+
     /* record layer header */
     rl = (RecordLayerHeader*)output;
     rl->type    = type;
@@ -2880,16 +4481,285 @@ retry:
                 return recvd;
         }
 
+    CYASSL_STAT_ADD(bytesIn, recvd);
+
     return recvd;
 }
 
 
+#if defined(CYASSL_RECORD_POOL) || defined(CYASSL_CIPHER_POOL)
+
+/* Pools are fixed rows of slots. Taking an object swaps a slot to NULL and
+   giving one back swaps a NULL slot to it, so there are no locks and no ABA,
+   a full row or an empty one just falls back to the heap */
+#if defined(__ATOMIC_ACQUIRE)
+    #define RP_LOAD(x)         __atomic_load_n(&(x), __ATOMIC_RELAXED)
+    #define RP_XCHG(x, v)      __atomic_exchange_n(&(x), (v), __ATOMIC_ACQ_REL)
+    #define RP_CAS(x, e, v)    __atomic_compare_exchange_n(&(x), &(e), (v), 0,\
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+    #define RP_ADD(x, v)       __atomic_fetch_add(&(x), (v), __ATOMIC_RELAXED)
+#elif defined(SINGLE_THREADED)
+    static INLINE byte* RpXchg(byte** x, byte* v)
+    {
+        byte* old = *x;
+        *x = v;
+        return old;
+    }
+    static INLINE int RpCas(byte** x, byte* e, byte* v)
+    {
+        if (*x != e)
+            return 0;
+        *x = v;
+        return 1;
+    }
+    #define RP_LOAD(x)         (x)
+    #define RP_XCHG(x, v)      RpXchg(&(x), (v))
+    #define RP_CAS(x, e, v)    RpCas(&(x), (e), (v))
+    #define RP_ADD(x, v)       ((x) += (v))
+#else
+    #error "record and cipher pools need compiler atomics or SINGLE_THREADED"
+#endif
+
+#endif /* CYASSL_RECORD_POOL || CYASSL_CIPHER_POOL */
+
+
+#ifdef CYASSL_RECORD_POOL
+
+/* Record buffers come from a global pool of size classes */
+#ifndef RECORD_POOL_SLOTS
+    #define RECORD_POOL_SLOTS 64        /* buffers kept per size class */
+#endif
+
+/* a record of fragment sz, the cipher's expansion and alignment slack */
+#define RECORD_POOL_SZ(sz) (RECORD_HEADER_SZ + (sz) + COMP_EXTRA + \
+                            MAX_MSG_EXTRA + 64)
+
+enum {
+    RECORD_POOL_CLASSES = 6,
+    /* a full record, the allowed ciphertext expansion and alignment slack */
+    RECORD_POOL_MAX_SZ  = RECORD_HEADER_SZ + MAX_RECORD_SIZE + COMP_EXTRA +
+                          2048 + 64
+};
+
+/* the smaller classes hold one record of each max_fragment_length */
+static const word32 recordPoolSz[RECORD_POOL_CLASSES] = {
+    RECORD_POOL_SZ(512), RECORD_POOL_SZ(1024), RECORD_POOL_SZ(2048),
+    RECORD_POOL_SZ(4096), RECORD_POOL_SZ(8192), RECORD_POOL_MAX_SZ
+};
+
+static byte*  recordPool[RECORD_POOL_CLASSES][RECORD_POOL_SLOTS];
+static word32 recordPoolHint[RECORD_POOL_CLASSES];  /* where to look first */
+static int    recordPoolCount[RECORD_POOL_CLASSES]; /* about how many kept */
+
+
+/* Get a record buffer of at least sz, *poolClass is set to its class + 1 or
+   0 if it's from the heap */
+static byte* GetRecordBuffer(CYASSL* ssl, word32 sz, byte* poolClass, int type)
+{
+    int    c;
+    word32 i;
+    word32 start;
+    byte*  mem;
+
+    (void)ssl;
+    (void)type;
+
+    for (c = 0; c < RECORD_POOL_CLASSES; c++)
+        if (sz <= recordPoolSz[c])
+            break;
+
+    if (c == RECORD_POOL_CLASSES) {
+        *poolClass = 0;
+        return (byte*)XMALLOC(sz, ssl->heap, type);
+    }
+    *poolClass = (byte)(c + 1);
+
+    if (RP_LOAD(recordPoolCount[c]) > 0) {
+        start = RP_LOAD(recordPoolHint[c]);
+        for (i = 0; i < RECORD_POOL_SLOTS; i++) {
+            word32 j = (start + i) % RECORD_POOL_SLOTS;
+
+            if (RP_LOAD(recordPool[c][j]) == NULL)
+                continue;
+            mem = RP_XCHG(recordPool[c][j], (byte*)NULL);
+            if (mem != NULL) {
+                RP_ADD(recordPoolCount[c], -1);
+                return mem;
+            }
+        }
+    }
+
+    return (byte*)XMALLOC(recordPoolSz[c], NULL, type);
+}
+
+
+/* give a record buffer back to its class, or the heap when the row is full */
+static void PutRecordBuffer(CYASSL* ssl, byte* mem, byte poolClass, int type)
+{
+    int    c = poolClass - 1;
+    word32 i;
+
+    (void)ssl;
+    (void)type;
+
+    if (poolClass == 0) {
+        XFREE(mem, ssl->heap, type);
+        return;
+    }
+
+    if (RP_LOAD(recordPoolCount[c]) < RECORD_POOL_SLOTS) {
+        for (i = 0; i < RECORD_POOL_SLOTS; i++) {
+            byte* empty = NULL;
+
+            if (RP_LOAD(recordPool[c][i]) != NULL)
+                continue;
+            if (RP_CAS(recordPool[c][i], empty, mem)) {
+                RP_ADD(recordPoolCount[c], 1);
+                recordPoolHint[c] = i;   /* racy hint is fine */
+                return;
+            }
+        }
+    }
+
+    XFREE(mem, NULL, type);
+}
+
+
+/* release every pooled buffer, at CyaSSL_Cleanup */
+void FlushRecordPool(void)
+{
+    int    c;
+    word32 i;
+
+    for (c = 0; c < RECORD_POOL_CLASSES; c++) {
+        for (i = 0; i < RECORD_POOL_SLOTS; i++) {
+            byte* mem = RP_XCHG(recordPool[c][i], (byte*)NULL);
+            if (mem != NULL) {
+                RP_ADD(recordPoolCount[c], -1);
+                XFREE(mem, NULL, DYNAMIC_TYPE_IN_BUFFER);
+            }
+        }
+    }
+}
+
+#define RECORD_CLASS(b)         ((b).poolClass)
+#define SET_RECORD_CLASS(b, c)  ((b).poolClass = (c))
+
+#else
+
+#define GetRecordBuffer(ssl, sz, c, t) \
+                          (*(c) = 0, (byte*)XMALLOC((sz), (ssl)->heap, (t)))
+#define PutRecordBuffer(ssl, m, c, t)  XFREE((m), (ssl)->heap, (t))
+#define RECORD_CLASS(b)         0
+#define SET_RECORD_CLASS(b, c)  (void)(c)
+
+#endif /* CYASSL_RECORD_POOL */
+
+
+#ifdef CYASSL_CIPHER_POOL
+
+#ifdef HAVE_CAVIUM
+    #error "cipher pool can't keep cavium AES contexts"
+#endif
+
+/* Every connection takes two AES contexts and with GCM tables each is over
+   4k, keep freed ones in a global row so SetKeys() can reuse them, it loads
+   a whole new schedule and table anyway */
+#ifndef CIPHER_POOL_SLOTS
+    #define CIPHER_POOL_SLOTS 128       /* AES contexts kept */
+#endif
+
+static byte*  cipherPool[CIPHER_POOL_SLOTS];
+static word32 cipherPoolHint;                   /* where to look first */
+static int    cipherPoolCount;                  /* about how many kept */
+
+
+/* an AES context for SetKeys(), pooled or from the heap */
+Aes* GetCipherAes(void* heap)
+{
+    word32 i;
+    word32 start;
+    byte*  mem;
+
+    (void)heap;
+
+    if (RP_LOAD(cipherPoolCount) > 0) {
+        start = RP_LOAD(cipherPoolHint);
+        for (i = 0; i < CIPHER_POOL_SLOTS; i++) {
+            word32 j = (start + i) % CIPHER_POOL_SLOTS;
+
+            if (RP_LOAD(cipherPool[j]) == NULL)
+                continue;
+            mem = RP_XCHG(cipherPool[j], (byte*)NULL);
+            if (mem != NULL) {
+                RP_ADD(cipherPoolCount, -1);
+                return (Aes*)mem;
+            }
+        }
+    }
+
+    return (Aes*)XMALLOC(sizeof(Aes), NULL, DYNAMIC_TYPE_CIPHER);
+}
+
+
+/* give an AES context back, the key schedule is cleared first */
+void PutCipherAes(Aes* aes, void* heap)
+{
+    word32 i;
+
+    (void)heap;
+
+    if (aes == NULL)
+        return;
+
+    XMEMSET(aes->key, 0, sizeof(aes->key));
+#ifdef HAVE_AESGCM
+    XMEMSET(aes->H, 0, sizeof(aes->H));
+#endif
+
+    if (RP_LOAD(cipherPoolCount) < CIPHER_POOL_SLOTS) {
+        for (i = 0; i < CIPHER_POOL_SLOTS; i++) {
+            byte* empty = NULL;
+
+            if (RP_LOAD(cipherPool[i]) != NULL)
+                continue;
+            if (RP_CAS(cipherPool[i], empty, (byte*)aes)) {
+                RP_ADD(cipherPoolCount, 1);
+                cipherPoolHint = i;   /* racy hint is fine */
+                return;
+            }
+        }
+    }
+
+    XFREE(aes, NULL, DYNAMIC_TYPE_CIPHER);
+}
+
+
+/* release every pooled context, at CyaSSL_Cleanup */
+void FlushCipherPool(void)
+{
+    word32 i;
+
+    for (i = 0; i < CIPHER_POOL_SLOTS; i++) {
+        byte* mem = RP_XCHG(cipherPool[i], (byte*)NULL);
+        if (mem != NULL) {
+            RP_ADD(cipherPoolCount, -1);
+            XFREE(mem, NULL, DYNAMIC_TYPE_CIPHER);
+        }
+    }
+}
+
+#endif /* CYASSL_CIPHER_POOL */
+
+
 /* Switch dynamic output buffer back to static, buffer is assumed clear */
 void ShrinkOutputBuffer(CYASSL* ssl)
 {
     CYASSL_MSG("Shrinking output buffer\n");
-    XFREE(ssl->buffers.outputBuffer.buffer - ssl->buffers.outputBuffer.offset,
-          ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+    PutRecordBuffer(ssl, ssl->buffers.outputBuffer.buffer -
+                    ssl->buffers.outputBuffer.offset,
+                    RECORD_CLASS(ssl->buffers.outputBuffer),
+                    DYNAMIC_TYPE_OUT_BUFFER);
     ssl->buffers.outputBuffer.buffer = ssl->buffers.outputBuffer.staticBuffer;
     ssl->buffers.outputBuffer.bufferSize  = STATIC_BUFFER_LEN;
     ssl->buffers.outputBuffer.dynamicFlag = 0;
@@ -2913,8 +4783,10 @@ void ShrinkInputBuffer(CYASSL* ssl, int forcedFree)
                ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.idx,
                usedLength);
 
-    XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-          ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+    PutRecordBuffer(ssl, ssl->buffers.inputBuffer.buffer -
+                    ssl->buffers.inputBuffer.offset,
+                    RECORD_CLASS(ssl->buffers.inputBuffer),
+                    DYNAMIC_TYPE_IN_BUFFER);
     ssl->buffers.inputBuffer.buffer = ssl->buffers.inputBuffer.staticBuffer;
     ssl->buffers.inputBuffer.bufferSize  = STATIC_BUFFER_LEN;
     ssl->buffers.inputBuffer.dynamicFlag = 0;
@@ -2924,8 +4796,52 @@ void ShrinkInputBuffer(CYASSL* ssl, int forcedFree)
 }
 
 
+/* memory IO, move what's buffered behind the records CyaSSL_take_output()
+   hasn't drained yet, in place of handing it to the send callback */
+static int SendBufferedMem(CYASSL* ssl)
+{
+    word32 len  = ssl->buffers.outputBuffer.length;
+    word32 need = ssl->buffers.memOutLen + len;
+
+    if (need > ssl->buffers.memOutSz) {
+        word32 sz  = ssl->buffers.memOutSz * 2;
+        byte*  tmp;
+
+        if (sz < need)
+            sz = need;
+        tmp = (byte*)XMALLOC(sz, ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+        if (tmp == NULL)
+            return MEMORY_E;
+
+        if (ssl->buffers.memOut) {
+            XMEMCPY(tmp, ssl->buffers.memOut, ssl->buffers.memOutLen);
+            XFREE(ssl->buffers.memOut, ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+        }
+        ssl->buffers.memOut   = tmp;
+        ssl->buffers.memOutSz = sz;
+    }
+
+    XMEMCPY(ssl->buffers.memOut + ssl->buffers.memOutLen,
+            ssl->buffers.outputBuffer.buffer + ssl->buffers.outputBuffer.idx,
+            len);
+    ssl->buffers.memOutLen += len;
+    CYASSL_STAT_ADD(bytesOut, len);
+
+    ssl->buffers.outputBuffer.idx    = 0;
+    ssl->buffers.outputBuffer.length = 0;
+
+    if (ssl->buffers.outputBuffer.dynamicFlag)
+        ShrinkOutputBuffer(ssl);
+
+    return 0;
+}
+
+
 int SendBuffered(CYASSL* ssl)
 {
+    if (ssl->options.memIO)
+        return SendBufferedMem(ssl);
+
     if (ssl->ctx->CBIOSend == NULL) {
         CYASSL_MSG("Your IO Send callback is null, please set");
         return SOCKET_ERROR_E;
@@ -2982,6 +4898,7 @@ int SendBuffered(CYASSL* ssl)
 
         ssl->buffers.outputBuffer.idx += sent;
         ssl->buffers.outputBuffer.length -= sent;
+        CYASSL_STAT_ADD(bytesOut, sent);
     }
 
     ssl->buffers.outputBuffer.idx = 0;
@@ -2993,10 +4910,29 @@ int SendBuffered(CYASSL* ssl)
 }
 
 
+/* Send a handshake message that the rest of its flight follows, grouped
+   messages stay buffered, otherwise the send is flagged so the transport
+   can hold it back to fill segments, the flight's last message flushes */
+static int SendFlightPart(CYASSL* ssl)
+{
+    int ret;
+
+    if (ssl->options.groupMessages)
+        return 0;
+
+    ssl->options.moreToSend = ssl->options.dtls == 0;
+    ret = SendBuffered(ssl);
+    ssl->options.moreToSend = 0;
+
+    return ret;
+}
+
+
 /* Grow the output buffer */
 static INLINE int GrowOutputBuffer(CYASSL* ssl, int size)
 {
     byte* tmp;
+    byte  poolClass;
     byte  hdrSz = ssl->options.dtls ? DTLS_RECORD_HEADER_SZ :
                                       RECORD_HEADER_SZ;
     byte  align = CYASSL_GENERAL_ALIGNMENT;
@@ -3009,8 +4945,8 @@ static INLINE int GrowOutputBuffer(CYASSL* ssl, int size)
            align *= 2;
     }
 
-    tmp = (byte*) XMALLOC(size + ssl->buffers.outputBuffer.length + align,
-                          ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+    tmp = GetRecordBuffer(ssl, size + ssl->buffers.outputBuffer.length + align,
+                          &poolClass, DYNAMIC_TYPE_OUT_BUFFER);
     CYASSL_MSG("growing output buffer\n");
 
     if (!tmp) return MEMORY_E;
@@ -3022,10 +4958,12 @@ static INLINE int GrowOutputBuffer(CYASSL* ssl, int size)
                ssl->buffers.outputBuffer.length);
 
     if (ssl->buffers.outputBuffer.dynamicFlag)
-        XFREE(ssl->buffers.outputBuffer.buffer -
-              ssl->buffers.outputBuffer.offset, ssl->heap,
-              DYNAMIC_TYPE_OUT_BUFFER);
+        PutRecordBuffer(ssl, ssl->buffers.outputBuffer.buffer -
+                        ssl->buffers.outputBuffer.offset,
+                        RECORD_CLASS(ssl->buffers.outputBuffer),
+                        DYNAMIC_TYPE_OUT_BUFFER);
     ssl->buffers.outputBuffer.dynamicFlag = 1;
+    SET_RECORD_CLASS(ssl->buffers.outputBuffer, poolClass);
     if (align)
         ssl->buffers.outputBuffer.offset = align - hdrSz;
     else
@@ -3041,6 +4979,7 @@ static INLINE int GrowOutputBuffer(CYASSL* ssl, int size)
 int GrowInputBuffer(CYASSL* ssl, int size, int usedLength)
 {
     byte* tmp;
+    byte  poolClass;
     byte  hdrSz = DTLS_RECORD_HEADER_SZ;
     byte  align = ssl->options.dtls ? CYASSL_GENERAL_ALIGNMENT : 0;
     /* the encrypted data will be offset from the front of the buffer by
@@ -3052,7 +4991,7 @@ int GrowInputBuffer(CYASSL* ssl, int size, int usedLength)
        while (align < hdrSz)
            align *= 2;
     }
-    tmp = (byte*) XMALLOC(size + usedLength + align, ssl->heap,
+    tmp = GetRecordBuffer(ssl, size + usedLength + align, &poolClass,
                           DYNAMIC_TYPE_IN_BUFFER);
     CYASSL_MSG("growing input buffer\n");
 
@@ -3065,10 +5004,13 @@ int GrowInputBuffer(CYASSL* ssl, int size, int usedLength)
                     ssl->buffers.inputBuffer.idx, usedLength);
 
     if (ssl->buffers.inputBuffer.dynamicFlag)
-        XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-              ssl->heap,DYNAMIC_TYPE_IN_BUFFER);
+        PutRecordBuffer(ssl, ssl->buffers.inputBuffer.buffer -
+                        ssl->buffers.inputBuffer.offset,
+                        RECORD_CLASS(ssl->buffers.inputBuffer),
+                        DYNAMIC_TYPE_IN_BUFFER);
 
     ssl->buffers.inputBuffer.dynamicFlag = 1;
+    SET_RECORD_CLASS(ssl->buffers.inputBuffer, poolClass);
     if (align)
         ssl->buffers.inputBuffer.offset = align - hdrSz;
     else
@@ -3183,6 +5125,7 @@ static int GetRecordHeader(CYASSL* ssl, const byte* input, word32* inOutIdx,
 
     /* haven't decrypted this record yet */
     ssl->keys.decryptedCur = 0;
+    CYASSL_STAT_INC(recordsIn);
 
     return 0;
 }
@@ -3258,17 +5201,17 @@ static void BuildMD5(CYASSL* ssl, Hashes* hashes, const byte* sender)
     byte md5_result[MD5_DIGEST_SIZE];
 
     /* make md5 inner */
-    Md5Update(&ssl->hashMd5, sender, SIZEOF_SENDER);
-    Md5Update(&ssl->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
-    Md5Update(&ssl->hashMd5, PAD1, PAD_MD5);
-    Md5Final(&ssl->hashMd5, md5_result);
+    Md5Update(&ssl->hsHashes->hashMd5, sender, SIZEOF_SENDER);
+    Md5Update(&ssl->hsHashes->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
+    Md5Update(&ssl->hsHashes->hashMd5, PAD1, PAD_MD5);
+    Md5Final(&ssl->hsHashes->hashMd5, md5_result);
 
     /* make md5 outer */
-    Md5Update(&ssl->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
-    Md5Update(&ssl->hashMd5, PAD2, PAD_MD5);
-    Md5Update(&ssl->hashMd5, md5_result, MD5_DIGEST_SIZE);
+    Md5Update(&ssl->hsHashes->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
+    Md5Update(&ssl->hsHashes->hashMd5, PAD2, PAD_MD5);
+    Md5Update(&ssl->hsHashes->hashMd5, md5_result, MD5_DIGEST_SIZE);
 
-    Md5Final(&ssl->hashMd5, hashes->md5);
+    Md5Final(&ssl->hsHashes->hashMd5, hashes->md5);
 }
 
 
@@ -3278,22 +5221,23 @@ static void BuildSHA(CYASSL* ssl, Hashes* hashes, const byte* sender)
     byte sha_result[SHA_DIGEST_SIZE];
 
     /* make sha inner */
-    ShaUpdate(&ssl->hashSha, sender, SIZEOF_SENDER);
-    ShaUpdate(&ssl->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
-    ShaUpdate(&ssl->hashSha, PAD1, PAD_SHA);
-    ShaFinal(&ssl->hashSha, sha_result);
+    ShaUpdate(&ssl->hsHashes->hashSha, sender, SIZEOF_SENDER);
+    ShaUpdate(&ssl->hsHashes->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
+    ShaUpdate(&ssl->hsHashes->hashSha, PAD1, PAD_SHA);
+    ShaFinal(&ssl->hsHashes->hashSha, sha_result);
 
     /* make sha outer */
-    ShaUpdate(&ssl->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
-    ShaUpdate(&ssl->hashSha, PAD2, PAD_SHA);
-    ShaUpdate(&ssl->hashSha, sha_result, SHA_DIGEST_SIZE);
+    ShaUpdate(&ssl->hsHashes->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
+    ShaUpdate(&ssl->hsHashes->hashSha, PAD2, PAD_SHA);
+    ShaUpdate(&ssl->hsHashes->hashSha, sha_result, SHA_DIGEST_SIZE);
 
-    ShaFinal(&ssl->hashSha, hashes->sha);
+    ShaFinal(&ssl->hsHashes->hashSha, hashes->sha);
 }
 #endif
 
 
-static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
+static int BuildFinishedHashes(CYASSL* ssl, Hashes* hashes,
+                               const byte* sender)
 {
     int ret = 0;
 #ifdef CYASSL_SMALL_STACK
@@ -3367,17 +5311,17 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
     /* store current states, building requires get_digest which resets state */
 #ifndef NO_OLD_TLS
 #ifndef NO_MD5
-    md5[0] = ssl->hashMd5;
+    md5[0] = ssl->hsHashes->hashMd5;
 #endif
 #ifndef NO_SHA
-    sha[0] = ssl->hashSha;
+    sha[0] = ssl->hsHashes->hashSha;
     #endif
 #endif
 #ifndef NO_SHA256
-    sha256[0] = ssl->hashSha256;
+    sha256[0] = ssl->hsHashes->hashSha256;
 #endif
 #ifdef CYASSL_SHA384
-    sha384[0] = ssl->hashSha384;
+    sha384[0] = ssl->hsHashes->hashSha384;
 #endif
 
 #ifndef NO_TLS
@@ -3395,18 +5339,18 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
     /* restore */
 #ifndef NO_OLD_TLS
     #ifndef NO_MD5
-        ssl->hashMd5 = md5[0];
+        ssl->hsHashes->hashMd5 = md5[0];
     #endif
     #ifndef NO_SHA
-    ssl->hashSha = sha[0];
+    ssl->hsHashes->hashSha = sha[0];
     #endif
 #endif
     if (IsAtLeastTLSv1_2(ssl)) {
     #ifndef NO_SHA256
-        ssl->hashSha256 = sha256[0];
+        ssl->hsHashes->hashSha256 = sha256[0];
     #endif
     #ifdef CYASSL_SHA384
-        ssl->hashSha384 = sha384[0];
+        ssl->hsHashes->hashSha384 = sha384[0];
     #endif
     }
 
@@ -3431,23 +5375,35 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
 }
 
 
-    /* cipher requirements */
+/* the Finished hashes cover the whole transcript, nothing may be buffered */
+static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
+{
+    int ret = FlushHandshakeHashes(ssl);
+
+    if (ret == 0)
+        ret = BuildFinishedHashes(ssl, hashes, sender);
+
+    return ret;
+}
+
+
+    /* cipher requirements, flags so a suite's are known in one lookup */
     enum {
-        REQUIRES_RSA,
-        REQUIRES_DHE,
-        REQUIRES_ECC_DSA,
-        REQUIRES_ECC_STATIC,
-        REQUIRES_PSK,
-        REQUIRES_NTRU,
-        REQUIRES_RSA_SIG
+        REQUIRES_RSA        = 0x01,
+        REQUIRES_DHE        = 0x02,
+        REQUIRES_ECC_DSA    = 0x04,
+        REQUIRES_ECC_STATIC = 0x08,
+        REQUIRES_PSK        = 0x10,
+        REQUIRES_NTRU       = 0x20,
+        REQUIRES_RSA_SIG    = 0x40
     };
 
 
 
-    /* Does this cipher suite (first, second) have the requirement
+    /* All the requirements of cipher suite (first, second),
        an ephemeral key exchange will still require the key for signing
        the key exchange so ECHDE_RSA requires an rsa key thus rsa_kea */
-    static int CipherRequires(byte first, byte second, int requirement)
+    static int CipherRequirements(byte first, byte second)
     {
 
         if (first == CHACHA_BYTE) {
@@ -3455,21 +5411,17 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
         switch (second) {
 
         case TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_DHE_RSA_WITH_CHACHA20_POLY1305_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
+
+        default:
+            CYASSL_MSG("Unsupported cipher suite, CipherRequires ChaCha");
+            return 0;
             }
         }
 
@@ -3480,207 +5432,121 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
 
 #ifndef NO_RSA
         case TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDH_RSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 
 #ifndef NO_DES3
         case TLS_ECDHE_RSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDH_RSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 #endif
 
 #ifndef NO_RC4
         case TLS_ECDHE_RSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDH_RSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 #endif
 #endif /* NO_RSA */
 
 #ifndef NO_DES3
         case TLS_ECDHE_ECDSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 #endif
 #ifndef NO_RC4
         case TLS_ECDHE_ECDSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 #endif
 #ifndef NO_RSA
         case TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDH_RSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 #endif
 
         case TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 
         case TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 
         case TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_AES_128_GCM_SHA256 :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 
         case TLS_ECDH_ECDSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC;
 
 #ifndef NO_RSA
         case TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_ECDH_RSA_WITH_AES_128_GCM_SHA256 :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 
         case TLS_ECDH_RSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_ECC_STATIC | REQUIRES_RSA_SIG;
 
         case TLS_RSA_WITH_AES_128_CCM_8 :
         case TLS_RSA_WITH_AES_256_CCM_8 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_RSA_SIG;
 
         case TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256 :
         case TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA384 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_RSA_SIG;
 
         case TLS_ECDH_RSA_WITH_AES_128_CBC_SHA256 :
         case TLS_ECDH_RSA_WITH_AES_256_CBC_SHA384 :
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_RSA_SIG | REQUIRES_ECC_STATIC;
 #endif
 
         case TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8 :
         case TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384 :
         case TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA;
 
         case TLS_ECDH_ECDSA_WITH_AES_128_CBC_SHA256 :
         case TLS_ECDH_ECDSA_WITH_AES_256_CBC_SHA384 :
-            if (requirement == REQUIRES_ECC_DSA)
-                return 1;
-            if (requirement == REQUIRES_ECC_STATIC)
-                return 1;
-            break;
+            return REQUIRES_ECC_DSA | REQUIRES_ECC_STATIC;
 
         case TLS_PSK_WITH_AES_128_CCM:
         case TLS_PSK_WITH_AES_256_CCM:
         case TLS_PSK_WITH_AES_128_CCM_8:
         case TLS_PSK_WITH_AES_256_CCM_8:
-            if (requirement == REQUIRES_PSK)
-                return 1;
-            break;
+            return REQUIRES_PSK;
 
         case TLS_DHE_PSK_WITH_AES_128_CCM:
         case TLS_DHE_PSK_WITH_AES_256_CCM:
-            if (requirement == REQUIRES_PSK)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_PSK | REQUIRES_DHE;
 
         default:
             CYASSL_MSG("Unsupported cipher suite, CipherRequires ECC");
@@ -3692,65 +5558,41 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
 
 #ifndef NO_RSA
         case SSL_RSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_NTRU_RSA_WITH_RC4_128_SHA :
-            if (requirement == REQUIRES_NTRU)
-                return 1;
-            break;
+            return REQUIRES_NTRU;
 
         case SSL_RSA_WITH_RC4_128_MD5 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case SSL_RSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_NTRU_RSA_WITH_3DES_EDE_CBC_SHA :
-            if (requirement == REQUIRES_NTRU)
-                return 1;
-            break;
+            return REQUIRES_NTRU;
 
         case TLS_RSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_AES_128_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_NTRU_RSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_NTRU)
-                return 1;
-            break;
+            return REQUIRES_NTRU;
 
         case TLS_RSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_AES_256_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_NULL_SHA :
         case TLS_RSA_WITH_NULL_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_NTRU_RSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_NTRU)
-                return 1;
-            break;
+            return REQUIRES_NTRU;
 #endif
 
         case TLS_PSK_WITH_AES_128_GCM_SHA256 :
@@ -3762,9 +5604,7 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
         case TLS_PSK_WITH_NULL_SHA384 :
         case TLS_PSK_WITH_NULL_SHA256 :
         case TLS_PSK_WITH_NULL_SHA :
-            if (requirement == REQUIRES_PSK)
-                return 1;
-            break;
+            return REQUIRES_PSK;
 
         case TLS_DHE_PSK_WITH_AES_128_GCM_SHA256 :
         case TLS_DHE_PSK_WITH_AES_256_GCM_SHA384 :
@@ -3772,106 +5612,60 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
         case TLS_DHE_PSK_WITH_AES_256_CBC_SHA384 :
         case TLS_DHE_PSK_WITH_NULL_SHA384 :
         case TLS_DHE_PSK_WITH_NULL_SHA256 :
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            if (requirement == REQUIRES_PSK)
-                return 1;
-            break;
+            return REQUIRES_DHE | REQUIRES_PSK;
 
 #ifndef NO_RSA
         case TLS_DHE_RSA_WITH_AES_128_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
 
         case TLS_DHE_RSA_WITH_AES_256_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
 
         case TLS_DHE_RSA_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
 
         case TLS_DHE_RSA_WITH_AES_256_CBC_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
 
         case TLS_RSA_WITH_HC_128_MD5 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_HC_128_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_HC_128_B2B256:
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_AES_128_CBC_B2B256:
         case TLS_RSA_WITH_AES_256_CBC_B2B256:
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_RABBIT_SHA :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_RSA_WITH_AES_128_GCM_SHA256 :
         case TLS_RSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_DHE_RSA_WITH_AES_128_GCM_SHA256 :
         case TLS_DHE_RSA_WITH_AES_256_GCM_SHA384 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_DHE;
 
         case TLS_RSA_WITH_CAMELLIA_128_CBC_SHA :
         case TLS_RSA_WITH_CAMELLIA_256_CBC_SHA :
         case TLS_RSA_WITH_CAMELLIA_128_CBC_SHA256 :
         case TLS_RSA_WITH_CAMELLIA_256_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            break;
+            return REQUIRES_RSA;
 
         case TLS_DHE_RSA_WITH_CAMELLIA_128_CBC_SHA :
         case TLS_DHE_RSA_WITH_CAMELLIA_256_CBC_SHA :
         case TLS_DHE_RSA_WITH_CAMELLIA_128_CBC_SHA256 :
         case TLS_DHE_RSA_WITH_CAMELLIA_256_CBC_SHA256 :
-            if (requirement == REQUIRES_RSA)
-                return 1;
-            if (requirement == REQUIRES_RSA_SIG)
-                return 1;
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_RSA | REQUIRES_RSA_SIG | REQUIRES_DHE;
 #endif
 #ifdef HAVE_ANON
         case TLS_DH_anon_WITH_AES_128_CBC_SHA :
-            if (requirement == REQUIRES_DHE)
-                return 1;
-            break;
+            return REQUIRES_DHE;
 #endif
 
         default:
@@ -3884,6 +5678,13 @@ static int BuildFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
     }
 
 
+    /* Does this cipher suite (first, second) have the requirement */
+    static int CipherRequires(byte first, byte second, int requirement)
+    {
+        return (CipherRequirements(first, second) & requirement) != 0;
+    }
+
+
 #ifndef NO_CERTS
 
 
@@ -3944,7 +5745,7 @@ static int CheckAltNames(DecodedCert* dCert, char* domain)
 
     CYASSL_MSG("Checking AltNames");
 
-    if (dCert)
+    if (dCert && DecodePendingExtensions(dCert) == 0)
         altName = dCert->altNames;
 
     while (altName) {
@@ -3972,6 +5773,10 @@ int CopyDecodedToX509(CYASSL_X509* x509, DecodedCert* dCert)
     if (x509 == NULL || dCert == NULL)
         return BAD_FUNC_ARG;
 
+    /* X509 users get every field, finish a lazy parse */
+    if ((ret = DecodePendingExtensions(dCert)) != 0)
+        return ret;
+
     x509->version = dCert->version + 1;
 
     XSTRNCPY(x509->issuer.name, dCert->issuer, ASN_NAME_MAX);
@@ -4146,7 +5951,335 @@ int CopyDecodedToX509(CYASSL_X509* x509, DecodedCert* dCert)
 #endif /* KEEP_PEER_CERT || SESSION_CERTS */
 
 
-static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
+#ifdef KEEP_PEER_CERT
+
+/* Keep only the peer's DER in peerCert, dropping an earlier handshake's
+   cert, 0 on success */
+static int KeepPeerCertDer(CYASSL* ssl, const byte* der, word32 sz)
+{
+    FreeX509(&ssl->peerCert);
+    InitX509(&ssl->peerCert, 0);
+    ssl->peerCert.issuer.sz  = 0;
+    ssl->peerCert.subject.sz = 0;
+    ssl->peerCertLazy        = 0;
+
+    ssl->peerCert.derCert.buffer = (byte*)XMALLOC(sz, NULL, DYNAMIC_TYPE_CERT);
+    if (ssl->peerCert.derCert.buffer == NULL)
+        return MEMORY_E;
+
+    XMEMCPY(ssl->peerCert.derCert.buffer, der, sz);
+    ssl->peerCert.derCert.length = sz;
+    ssl->peerCertLazy = 1;
+
+    return 0;
+}
+
+
+/* The peer's cert, the X509 fields are decoded from the kept DER on first
+   use, NULL if there's none */
+CYASSL_X509* GetPeerCert(CYASSL* ssl)
+{
+    if (ssl->peerCertLazy) {
+        buffer der = ssl->peerCert.derCert;
+        int    ret;
+    #ifdef CYASSL_SMALL_STACK
+        DecodedCert* dCert;
+
+        dCert = (DecodedCert*)XMALLOC(sizeof(DecodedCert), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+        if (dCert == NULL)
+            return NULL;
+    #else
+        DecodedCert  dCert[1];
+    #endif
+
+        /* the copy sets derCert again */
+        ssl->peerCertLazy = 0;
+        ssl->peerCert.derCert.buffer = NULL;
+        ssl->peerCert.derCert.length = 0;
+
+        InitDecodedCert(dCert, der.buffer, der.length, ssl->heap);
+        ret = ParseCertRelative(dCert, CERT_TYPE, NO_VERIFY, NULL);
+        if (ret == 0 || ret == ASN_CRIT_EXT_E)
+            CopyDecodedToX509(&ssl->peerCert, dCert);
+        FreeDecodedCert(dCert);
+
+        if (ssl->peerCert.derCert.buffer == NULL)
+            ssl->peerCert.derCert = der;
+        else
+            XFREE(der.buffer, NULL, DYNAMIC_TYPE_CERT);
+
+    #ifdef CYASSL_SMALL_STACK
+        XFREE(dCert, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    #endif
+    }
+
+    return ssl->peerCert.issuer.sz ? &ssl->peerCert : NULL;
+}
+
+#endif /* KEEP_PEER_CERT */
+
+
+#ifdef HAVE_PARALLEL_VERIFY
+
+/* parse a chain cert and the one above it without verify and check the
+   first's signature with the second's key, keeping that key on success */
+static void ConfirmChainJob(VerifyJob* job, void* heap)
+{
+    int ret;
+#ifdef CYASSL_SMALL_STACK
+    DecodedCert* cert;
+    DecodedCert* issuer;
+
+    cert = (DecodedCert*)XMALLOC(sizeof(DecodedCert) * 2, heap,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    if (cert == NULL)
+        return;
+    issuer = cert + 1;
+#else
+    DecodedCert  cert[1];
+    DecodedCert  issuer[1];
+#endif
+
+    InitDecodedCert(issuer, (byte*)job->issuer, job->issuerSz, heap);
+    issuer->extLazy = 1;
+    InitDecodedCert(cert, (byte*)job->cert, job->certSz, heap);
+    cert->extLazy = 1;
+
+    ret = ParseCertRelative(issuer, CERT_TYPE, NO_VERIFY, NULL);
+    if (ret == 0)
+        ret = ParseCertRelative(cert, CERT_TYPE, NO_VERIFY, NULL);
+    if (ret == 0 && XMEMCMP(cert->issuerHash, issuer->subjectHash,
+                            SHA_SIZE) != 0)
+        ret = ASN_NO_SIGNER_E;                  /* not in chain order */
+    if (ret == 0 && issuer->pubKeySize > job->issuerSz)
+        ret = BUFFER_E;
+    if (ret == 0)
+        ret = ConfirmCertSignature(cert, issuer->publicKey,
+                                   issuer->pubKeySize, issuer->keyOID);
+    if (ret == 0) {
+        XMEMCPY(job->key, issuer->publicKey, issuer->pubKeySize);
+        job->keySz  = issuer->pubKeySize;
+        job->keyOID = issuer->keyOID;
+    }
+
+    FreeDecodedCert(cert);
+    FreeDecodedCert(issuer);
+#ifdef CYASSL_SMALL_STACK
+    XFREE(cert, heap, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+}
+
+
+/* next job of batch, pool mutex held, the batch leaves the queue with its
+   last one */
+static VerifyJob* ClaimVerifyJob(VerifyPool* pool, VerifyBatch* batch)
+{
+    VerifyJob* job = &batch->jobs[batch->claimed++];
+
+    if (batch->claimed == batch->cnt) {
+        VerifyBatch* prev = NULL;
+        VerifyBatch* cur;
+
+        for (cur = pool->head; cur != batch; cur = cur->next)
+            prev = cur;
+        if (prev)
+            prev->next = batch->next;
+        else
+            pool->head = batch->next;
+        if (pool->tail == batch)
+            pool->tail = prev;
+    }
+
+    return job;
+}
+
+
+static void* DoVerifyWorker(void* arg)
+{
+    VerifyPool* pool = (VerifyPool*)arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        VerifyBatch* batch;
+        VerifyJob*   job;
+
+        while (pool->head == NULL && !pool->stop)
+            pthread_cond_wait(&pool->work, &pool->mutex);
+        if (pool->head == NULL)
+            break;                              /* stopping, queue drained */
+
+        batch = pool->head;
+        job   = ClaimVerifyJob(pool, batch);
+        pthread_mutex_unlock(&pool->mutex);
+
+        ConfirmChainJob(job, batch->heap);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (++batch->done == batch->cnt)
+            pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+
+/* queue a job per cert below the top one of the bottom up chain, the
+   handshake thread goes on with the top cert meanwhile. Returns the key
+   buffer for FreeChainVerify, NULL with batch->cnt 0 leaves it all to the
+   in order pass */
+static byte* StartChainVerify(CYASSL* ssl, VerifyBatch* batch,
+                              VerifyJob* jobs, buffer* certs, int totalCerts)
+{
+    VerifyPool* pool = ssl->ctx->verifyPool;
+    word32      keysSz = 0;
+    byte*       keys;
+    int         i;
+
+    batch->cnt = 0;
+    for (i = 1; i < totalCerts; i++)
+        keysSz += certs[i].length;
+    keys = (byte*)XMALLOC(keysSz, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (keys == NULL)
+        return NULL;
+
+    keysSz = 0;
+    for (i = 0; i < totalCerts - 1; i++) {
+        jobs[i].cert     = certs[i].buffer;
+        jobs[i].certSz   = certs[i].length;
+        jobs[i].issuer   = certs[i + 1].buffer;
+        jobs[i].issuerSz = certs[i + 1].length;
+        jobs[i].key      = keys + keysSz;
+        jobs[i].keySz    = 0;
+        jobs[i].keyOID   = 0;
+        keysSz += certs[i + 1].length;
+    }
+
+    batch->next    = NULL;
+    batch->jobs    = jobs;
+    batch->cnt     = totalCerts - 1;
+    batch->claimed = 0;
+    batch->done    = 0;
+    batch->heap    = ssl->heap;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->tail)
+        pool->tail->next = batch;
+    else
+        pool->head = batch;
+    pool->tail = batch;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return keys;
+}
+
+
+/* run what the workers haven't claimed yet and wait for the rest */
+static void WaitChainVerify(VerifyPool* pool, VerifyBatch* batch)
+{
+    if (batch->cnt == 0)
+        return;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (batch->claimed < batch->cnt) {
+        VerifyJob* job = ClaimVerifyJob(pool, batch);
+
+        pthread_mutex_unlock(&pool->mutex);
+        ConfirmChainJob(job, batch->heap);
+        pthread_mutex_lock(&pool->mutex);
+        batch->done++;
+    }
+    while (batch->done < batch->cnt)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+
+/* hand cert idx's confirmed signer key to its parse, if it had one */
+static void UseChainVerify(CYASSL* ssl, VerifyBatch* batch, int idx,
+                           DecodedCert* cert)
+{
+    if (batch->cnt == 0)
+        return;
+
+    WaitChainVerify(ssl->ctx->verifyPool, batch);
+    if (batch->jobs[idx].keySz) {
+        cert->sigKey    = batch->jobs[idx].key;
+        cert->sigKeySz  = batch->jobs[idx].keySz;
+        cert->sigKeyOID = batch->jobs[idx].keyOID;
+    }
+}
+
+
+static void FreeChainVerify(CYASSL* ssl, VerifyBatch* batch, byte* keys)
+{
+    WaitChainVerify(ssl->ctx->verifyPool, batch);
+    batch->cnt = 0;
+    XFREE(keys, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+}
+
+
+/* stop the ctx's chain verify threads, then start threads new ones, 0
+   stops */
+int SetVerifyPool(CYASSL_CTX* ctx, int threads)
+{
+    VerifyPool* pool = ctx->verifyPool;
+    int         i;
+
+    if (pool) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stop = 1;
+        pthread_cond_broadcast(&pool->work);
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (i = 0; i < pool->threads; i++)
+            pthread_join(pool->tid[i], NULL);
+
+        pthread_cond_destroy(&pool->done);
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->mutex);
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_VERIFY_POOL);
+        ctx->verifyPool = NULL;
+    }
+
+    if (threads == 0)
+        return 0;
+
+    pool = (VerifyPool*)XMALLOC(sizeof(VerifyPool), ctx->heap,
+                                DYNAMIC_TYPE_VERIFY_POOL);
+    if (pool == NULL)
+        return MEMORY_E;
+    XMEMSET(pool, 0, sizeof(VerifyPool));
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_VERIFY_POOL);
+        return BAD_MUTEX_E;
+    }
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&pool->tid[i], NULL, DoVerifyWorker, pool) != 0)
+            break;
+        pool->threads++;
+    }
+
+    ctx->verifyPool = pool;
+    if (pool->threads == 0) {
+        CYASSL_MSG("No verify pool threads started");
+        SetVerifyPool(ctx, 0);
+        return THREAD_CREATE_E;
+    }
+
+    return 0;
+}
+
+#endif /* HAVE_PARALLEL_VERIFY */
+
+
+static int DoCertificateList(CYASSL* ssl, byte* input, word32* inOutIdx,
                                                                     word32 size)
 {
     word32 listSz;
@@ -4156,6 +6289,11 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
     int    totalCerts = 0;    /* number of certs in certs buffer */
     int    count;
     buffer certs[MAX_CHAIN_DEPTH];
+#ifdef HAVE_PARALLEL_VERIFY
+    VerifyJob   vJobs[MAX_CHAIN_DEPTH];
+    VerifyBatch vBatch;
+    byte*       vKeys = NULL;
+#endif
 
 #ifdef CYASSL_SMALL_STACK
     char*                  domain = NULL;
@@ -4234,18 +6372,42 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
     count = totalCerts;
 
 #ifdef CYASSL_SMALL_STACK
-    dCert = (DecodedCert*)XMALLOC(sizeof(DecodedCert), NULL,
+    dCert = (DecodedCert*)HsAlloc(ssl, sizeof(DecodedCert),
                                                        DYNAMIC_TYPE_TMP_BUFFER);
     if (dCert == NULL)
         return MEMORY_E;
 #endif
 
+#ifdef HAVE_PARALLEL_VERIFY
+    /* the signatures below the top cert on the pool, the top one here */
+    vBatch.cnt = 0;
+    if (ssl->ctx->verifyPool && !ssl->options.verifyNone && totalCerts > 1)
+        vKeys = StartChainVerify(ssl, &vBatch, vJobs, certs, totalCerts);
+#endif
+
     /* verify up to peer's first */
     while (count > 1) {
         buffer myCert = certs[count - 1];
         byte* subjectHash;
 
+    #if defined(HAVE_VERIFY_CACHE) && defined(HAVE_DATE_EPOCH)
+        /* same DER filed as a CA by an earlier chain, nothing left to do */
+        if (!ssl->options.verifyNone && !(ssl->ctx->cm->crlEnabled &&
+                                          ssl->ctx->cm->crlCheckAll) &&
+                VerifyCacheChainFind(ssl->ctx->cm, myCert.buffer,
+                                     myCert.length) == 1) {
+            CYASSL_MSG("Chain CA verified before, cached");
+            count--;
+            continue;
+        }
+    #endif
+
         InitDecodedCert(dCert, myCert.buffer, myCert.length, ssl->heap);
+        dCert->extLazy = 1;   /* decoded on demand, see DecodePendingExtensions */
+    #ifdef HAVE_PARALLEL_VERIFY
+        if (count < totalCerts)
+            UseChainVerify(ssl, &vBatch, count - 1, dCert);
+    #endif
         ret = ParseCertRelative(dCert, CERT_TYPE, !ssl->options.verifyNone,
                                 ssl->ctx->cm);
         #ifndef NO_SKID
@@ -4267,8 +6429,12 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
                                         DYNAMIC_TYPE_CA);
             CYASSL_MSG("Adding CA from chain");
 
-            if (add.buffer == NULL)
+            if (add.buffer == NULL) {
+            #ifdef HAVE_PARALLEL_VERIFY
+                FreeChainVerify(ssl, &vBatch, vKeys);
+            #endif
                 return MEMORY_E;
+            }
             XMEMCPY(add.buffer, myCert.buffer, myCert.length);
 
             ret = AddCA(ssl->ctx->cm, add, CYASSL_CHAIN_CA,
@@ -4293,6 +6459,12 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
         }
 #endif /* HAVE_CRL */
 
+    #if defined(HAVE_VERIFY_CACHE) && defined(HAVE_DATE_EPOCH)
+        if (ret == 0 && dCert->isCA && !ssl->options.verifyNone)
+            VerifyCacheChainAdd(ssl->ctx->cm, myCert.buffer, myCert.length,
+                                subjectHash, dCert->afterEpoch);
+    #endif
+
         if (ret != 0 && anyError == 0)
             anyError = ret;   /* save error from last time */
 
@@ -4308,8 +6480,15 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
         CYASSL_MSG("Verifying Peer's cert");
 
         InitDecodedCert(dCert, myCert.buffer, myCert.length, ssl->heap);
+        dCert->extLazy = 1;
+    #ifdef HAVE_PARALLEL_VERIFY
+        UseChainVerify(ssl, &vBatch, 0, dCert);
+    #endif
         ret = ParseCertRelative(dCert, CERT_TYPE, !ssl->options.verifyNone,
                                 ssl->ctx->cm);
+    #ifdef HAVE_PARALLEL_VERIFY
+        FreeChainVerify(ssl, &vBatch, vKeys);
+    #endif
         if (ret == 0) {
             CYASSL_MSG("Verified Peer's cert");
             fatal = 0;
@@ -4353,6 +6532,27 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
         }
 #endif
 
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_CLIENT)
+        /* wait for a staple, the CRL fallback needs the cert so not with it */
+        if (fatal == 0 && ssl->ctx->cm->ocspEnabled &&
+                ssl->options.statusRequest && !ssl->ctx->cm->crlEnabled) {
+            ret = SetOcspPending(ssl, dCert);
+            if (ret != 0)
+                fatal = 1;
+        }
+        else
+#endif
+#ifdef HAVE_OCSP_NONBLOCK
+        /* ask the responder once the next message is in, without blocking */
+        if (fatal == 0 && ssl->ctx->cm->ocspEnabled &&
+                ssl->ctx->cm->ocspNonBlock && !ssl->options.dtls &&
+                !ssl->ctx->cm->crlEnabled) {
+            ret = SetOcspPending(ssl, dCert);
+            if (ret != 0)
+                fatal = 1;
+        }
+        else
+#endif
 #ifdef HAVE_OCSP
         if (fatal == 0 && ssl->ctx->cm->ocspEnabled) {
             ret = CheckCertOCSP(ssl->ctx->cm->ocsp, dCert);
@@ -4387,12 +6587,10 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
 #endif /* HAVE_CRL */
 
 #ifdef KEEP_PEER_CERT
-        {
-        /* set X509 format for peer cert even if fatal */
-        int copyRet = CopyDecodedToX509(&ssl->peerCert, dCert);
-        if (copyRet == MEMORY_E)
+        /* keep the peer cert even if fatal, only its DER for now, most
+           connections never ask for the X509, GetPeerCert() builds it */
+        if (KeepPeerCertDer(ssl, dCert->source, dCert->maxIdx) != 0)
             fatal = 1;
-        }
 #endif
 
 #ifndef IGNORE_KEY_EXTENSIONS
@@ -4431,7 +6629,7 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
         if (fatal) {
             FreeDecodedCert(dCert);
         #ifdef CYASSL_SMALL_STACK
-            XFREE(dCert, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            HsFree(ssl, dCert, DYNAMIC_TYPE_TMP_BUFFER);
         #endif
             ssl->error = ret;
             return ret;
@@ -4442,7 +6640,7 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
         domain = (char*)XMALLOC(ASN_NAME_MAX, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         if (domain == NULL) {
             FreeDecodedCert(dCert);
-            XFREE(dCert, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            HsFree(ssl, dCert, DYNAMIC_TYPE_TMP_BUFFER);
             return MEMORY_E;
         }
 #endif
@@ -4561,7 +6759,7 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
     }
 
 #ifdef CYASSL_SMALL_STACK
-    XFREE(dCert, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    HsFree(ssl, dCert, DYNAMIC_TYPE_TMP_BUFFER);
 
     store = (CYASSL_X509_STORE_CTX*)XMALLOC(sizeof(CYASSL_X509_STORE_CTX),
                                                  NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -4589,7 +6787,7 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
                 store->domain = domain;
                 store->userCtx = ssl->verifyCbCtx;
 #ifdef KEEP_PEER_CERT
-                store->current_cert = &ssl->peerCert;
+                store->current_cert = GetPeerCert(ssl);
 #else
                 store->current_cert = NULL;
 #endif
@@ -4626,7 +6824,7 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
             store->domain = domain;
             store->userCtx = ssl->verifyCbCtx;
 #ifdef KEEP_PEER_CERT
-            store->current_cert = &ssl->peerCert;
+            store->current_cert = GetPeerCert(ssl);
 #endif
             store->ex_data = ssl;
 
@@ -4647,28 +6845,224 @@ static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
     }
 #endif
 
-    if (ssl->options.verifyNone &&
-                              (ret == CRL_MISSING || ret == CRL_CERT_REVOKED)) {
-        CYASSL_MSG("Ignoring CRL problem based on verify setting");
-        ret = ssl->error = 0;
-    }
+    if (ssl->options.verifyNone &&
+                              (ret == CRL_MISSING || ret == CRL_CERT_REVOKED)) {
+        CYASSL_MSG("Ignoring CRL problem based on verify setting");
+        ret = ssl->error = 0;
+    }
+
+    if (ret == 0 && ssl->options.side == CYASSL_CLIENT_END)
+        ssl->options.serverState = SERVER_CERT_COMPLETE;
+
+    if (ssl->keys.encryptionOn) {
+        *inOutIdx += ssl->keys.padSz;
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(store,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(domain, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+/* RFC 7924, a Certificate that is just the hash of the chain we offered has
+   that chain processed in its place, a full one is kept when asked to */
+static int DoCertificate(CYASSL* ssl, byte* input, word32* inOutIdx,
+                                                                    word32 size)
+{
+#ifdef HAVE_CACHED_INFO
+    byte* msg = input + *inOutIdx;
+
+    if (ssl->options.side == CYASSL_CLIENT_END && ssl->cached_cert) {
+        word32 idx = 0;
+
+        if (size < OPAQUE8_LEN || size != (word32)OPAQUE8_LEN + msg[0] ||
+                ssl->cached_chain.buffer == NULL ||
+                !TLSX_CachedInfo_Match(ssl->extensions, msg + OPAQUE8_LEN,
+                                                                     msg[0])) {
+            SendAlert(ssl, alert_fatal, illegal_parameter);
+            return CACHED_INFO_E;
+        }
+        *inOutIdx += size;
+        if (ssl->keys.encryptionOn)
+            *inOutIdx += ssl->keys.padSz;
+
+        return DoCertificateList(ssl, ssl->cached_chain.buffer, &idx,
+                                 ssl->cached_chain.length);
+    }
+
+    if (ssl->options.side == CYASSL_CLIENT_END && ssl->cached_keep) {
+        byte* chain = (byte*)XMALLOC(size, ssl->heap, DYNAMIC_TYPE_CERT);
+
+        if (chain == NULL)
+            return MEMORY_E;
+
+        XMEMCPY(chain, msg, size);
+        XFREE(ssl->cached_chain.buffer, ssl->heap, DYNAMIC_TYPE_CERT);
+        ssl->cached_chain.buffer = chain;
+        ssl->cached_chain.length = size;
+    }
+#endif
+
+    return DoCertificateList(ssl, input, inOutIdx, size);
+}
+
+#endif /* !NO_CERTS */
+
+#ifdef HAVE_OCSP
+
+/* Hold the peer cert's OCSP check until the next message, CertificateStatus
+   may have come by then */
+static int SetOcspPending(CYASSL* ssl, DecodedCert* cert)
+{
+    OcspPending* pending;
+    int          ret;
+
+    FreeOcspPending(ssl);   /* renegotiation */
+
+    if ((ret = DecodePendingExtensions(cert)) != 0)
+        return ret;
+
+    pending = (OcspPending*)XMALLOC(sizeof(OcspPending), ssl->heap,
+                                                       DYNAMIC_TYPE_OCSP_ENTRY);
+    if (pending == NULL)
+        return MEMORY_E;
+
+    SetOcspId(&pending->id, cert);
+    pending->url   = NULL;
+    pending->urlSz = 0;
+#ifdef HAVE_OCSP_NONBLOCK
+    pending->lookup = NULL;
+#endif
+
+    if (cert->extAuthInfo != NULL && cert->extAuthInfoSz > 0) {
+        pending->url = (char*)XMALLOC(cert->extAuthInfoSz, ssl->heap,
+                                                       DYNAMIC_TYPE_OCSP_ENTRY);
+        if (pending->url == NULL) {
+            XFREE(pending, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+            return MEMORY_E;
+        }
+        XMEMCPY(pending->url, cert->extAuthInfo, cert->extAuthInfoSz);
+        pending->urlSz = cert->extAuthInfoSz;
+    }
+
+    ssl->ocspPending = pending;
+
+    return 0;
+}
+
+
+static void FreeOcspPending(CYASSL* ssl)
+{
+    OcspPending* pending = ssl->ocspPending;
+
+    if (pending == NULL)
+        return;
+
+#ifdef HAVE_OCSP_NONBLOCK
+    if (pending->lookup)
+        FreeOcspLookup(ssl->ctx->cm->ocsp, pending->lookup);
+#endif
+    if (pending->url)
+        XFREE(pending->url, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+    XFREE(pending, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+    ssl->ocspPending = NULL;
+}
+
+
+/* Finish the held back check with its status, as DoCertificate would have */
+static int OcspPendingDone(CYASSL* ssl, int ret)
+{
+    FreeOcspPending(ssl);
+
+    if (ret != 0) {
+        CYASSL_MSG("\tOCSP Lookup not ok");
+        if (!ssl->options.verifyNone) {
+            SendAlert(ssl, alert_fatal, bad_certificate);
+            ssl->options.isClosed = 1;
+        }
+        ssl->error = ret;
+    }
+
+    return ret;
+}
+
+
+/* No usable staple, ask the responder ourselves. Without blocking that
+   returns OCSP_WANT_READ or OCSP_WANT_WRITE until its answer is in */
+static int CheckPendingOCSP(CYASSL* ssl)
+{
+    OcspPending* pending = ssl->ocspPending;
+
+    CYASSL_MSG("Doing the held back OCSP lookup");
+
+#ifdef HAVE_OCSP_NONBLOCK
+    if (ssl->ctx->cm->ocspNonBlock && !ssl->options.dtls) {
+        int ret = CheckIdOCSP_NonBlock(ssl->ctx->cm->ocsp, &pending->id,
+                                       pending->url, pending->urlSz,
+                                       &pending->lookup);
+
+        if (ret == OCSP_WANT_READ || ret == OCSP_WANT_WRITE)
+            return ret;
+
+        return OcspPendingDone(ssl, ret);
+    }
+#endif
+
+    return OcspPendingDone(ssl, CheckIdOCSP(ssl->ctx->cm->ocsp, &pending->id,
+                                            pending->url, pending->urlSz));
+}
 
-    if (ret == 0 && ssl->options.side == CYASSL_CLIENT_END)
-        ssl->options.serverState = SERVER_CERT_COMPLETE;
+#endif /* HAVE_OCSP */
 
-    if (ssl->keys.encryptionOn) {
+
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_CLIENT)
+
+
+static int DoCertificateStatus(CYASSL* ssl, byte* input, word32* inOutIdx,
+                                                                    word32 size)
+{
+    word32 begin = *inOutIdx;
+    word32 length;
+    int    ret;
+
+    #ifdef CYASSL_CALLBACKS
+        if (ssl->hsInfoOn)
+            AddPacketName("CertificateStatus", &ssl->handShakeInfo);
+        if (ssl->toInfoOn)
+            AddLateName("CertificateStatus", &ssl->timeoutInfo);
+    #endif
+
+    if (size < ENUM_LEN + OPAQUE24_LEN)
+        return BUFFER_ERROR;
+
+    c24to32(input + begin + ENUM_LEN, &length);
+    if (input[begin] != CSR_OCSP || ENUM_LEN + OPAQUE24_LEN + length != size)
+        return BUFFER_ERROR;
+
+    *inOutIdx += size;
+    if (ssl->keys.encryptionOn)
         *inOutIdx += ssl->keys.padSz;
-    }
 
-#ifdef CYASSL_SMALL_STACK
-    XFREE(store,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
-    XFREE(domain, NULL, DYNAMIC_TYPE_TMP_BUFFER);
-#endif
+    if (ssl->ocspPending == NULL)
+        return 0;       /* not checking OCSP or already did */
 
-    return ret;
+    ret = CheckStapleOCSP(ssl->ctx->cm->ocsp, &ssl->ocspPending->id,
+                          input + begin + ENUM_LEN + OPAQUE24_LEN, length,
+                          ssl->ocspPending->url, ssl->ocspPending->urlSz);
+
+    /* anything but the responder's answer is left to the fallback */
+    if (ret == 0 || ret == OCSP_CERT_REVOKED || ret == OCSP_CERT_UNKNOWN)
+        return OcspPendingDone(ssl, ret);
+
+    CYASSL_MSG("Stapled OCSP response not usable");
+
+    return 0;
 }
 
-#endif /* !NO_CERTS */
+#endif /* HAVE_CERTIFICATE_STATUS_REQUEST && !NO_CYASSL_CLIENT */
 
 
 static int DoHelloRequest(CYASSL* ssl, const byte* input, word32* inOutIdx,
@@ -4721,7 +7115,8 @@ int DoFinished(CYASSL* ssl, const byte* input, word32* inOutIdx, word32 size,
     #endif
 
     if (sniff == NO_SNIFF) {
-        if (XMEMCMP(input + *inOutIdx, &ssl->verifyHashes, size) != 0) {
+        if (XMEMCMP(input + *inOutIdx, &ssl->hsHashes->verifyHashes,
+                                                                 size) != 0) {
             CYASSL_MSG("Verify finished error on hashes");
             return VERIFY_FINISHED_ERROR;
         }
@@ -4863,6 +7258,27 @@ static int SanityCheckMsgReceived(CYASSL* ssl, byte type)
 #endif
             break;
 
+#if !defined(NO_CYASSL_CLIENT) && defined(HAVE_CERTIFICATE_STATUS_REQUEST)
+        case certificate_status:
+            if (ssl->msgsReceived.got_certificate_status) {
+                CYASSL_MSG("Duplicate CertificateStatus received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_certificate_status = 1;
+
+            if (ssl->msgsReceived.got_certificate == 0 ||
+                                ssl->msgsReceived.got_server_key_exchange) {
+                CYASSL_MSG("CertificateStatus not right after Cert");
+                return OUT_OF_ORDER_E;
+            }
+            if (!ssl->options.statusRequest) {
+                CYASSL_MSG("CertificateStatus without status_request");
+                return OUT_OF_ORDER_E;
+            }
+
+            break;
+#endif
+
 #ifndef NO_CYASSL_CLIENT
         case server_key_exchange:
             if (ssl->msgsReceived.got_server_key_exchange) {
@@ -4879,133 +7295,433 @@ static int SanityCheckMsgReceived(CYASSL* ssl, byte type)
             break;
 #endif
 
-#ifndef NO_CYASSL_CLIENT
-        case certificate_request:
-            if (ssl->msgsReceived.got_certificate_request) {
-                CYASSL_MSG("Duplicate CertificateRequest received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_certificate_request = 1;
+#ifndef NO_CYASSL_CLIENT
+        case certificate_request:
+            if (ssl->msgsReceived.got_certificate_request) {
+                CYASSL_MSG("Duplicate CertificateRequest received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_certificate_request = 1;
+
+            break;
+#endif
+
+#ifndef NO_CYASSL_CLIENT
+        case server_hello_done:
+            if (ssl->msgsReceived.got_server_hello_done) {
+                CYASSL_MSG("Duplicate ServerHelloDone received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_server_hello_done = 1;
+
+            if (ssl->msgsReceived.got_certificate == 0) {
+                if (ssl->specs.kea == psk_kea ||
+                    ssl->specs.kea == dhe_psk_kea ||
+                    ssl->options.usingAnon_cipher) {
+                    CYASSL_MSG("No Cert required");
+                } else {
+                    CYASSL_MSG("No Certificate before ServerHelloDone");
+                    return OUT_OF_ORDER_E;
+                }
+            }
+            if (ssl->msgsReceived.got_server_key_exchange == 0) {
+                if (ssl->specs.static_ecdh == 1 ||
+                    ssl->specs.kea == rsa_kea ||
+                    ssl->specs.kea == ntru_kea) {
+                    CYASSL_MSG("No KeyExchange required");
+                } else {
+                    CYASSL_MSG("No ServerKeyExchange before ServerDone");
+                    return OUT_OF_ORDER_E;
+                }
+            }
+            break;
+#endif
+
+#ifndef NO_CYASSL_SERVER
+        case certificate_verify:
+            if (ssl->msgsReceived.got_certificate_verify) {
+                CYASSL_MSG("Duplicate CertificateVerify received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_certificate_verify = 1;
+
+            if ( ssl->msgsReceived.got_certificate == 0) {
+                CYASSL_MSG("No Cert before CertVerify");
+                return OUT_OF_ORDER_E;
+            }
+            break;
+#endif
+
+#ifndef NO_CYASSL_SERVER
+        case client_key_exchange:
+            if (ssl->msgsReceived.got_client_key_exchange) {
+                CYASSL_MSG("Duplicate ClientKeyExchange received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_client_key_exchange = 1;
+
+            if (ssl->msgsReceived.got_client_hello == 0) {
+                CYASSL_MSG("No ClientHello before ClientKeyExchange");
+                return OUT_OF_ORDER_E;
+            }
+            break;
+#endif
+
+        case finished:
+            if (ssl->msgsReceived.got_finished) {
+                CYASSL_MSG("Duplicate Finished received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_finished = 1;
+
+            if (ssl->msgsReceived.got_change_cipher == 0) {
+                CYASSL_MSG("Finished received before ChangeCipher");
+                return NO_CHANGE_CIPHER_E;
+            }
+
+            break;
+
+        case change_cipher_hs:
+            if (ssl->msgsReceived.got_change_cipher) {
+                CYASSL_MSG("Duplicate ChangeCipher received");
+                return DUPLICATE_MSG_E;
+            }
+            ssl->msgsReceived.got_change_cipher = 1;
+
+#ifndef NO_CYASSL_CLIENT
+            if (ssl->options.side == CYASSL_CLIENT_END) {
+                if (!ssl->options.resuming &&
+                                 ssl->msgsReceived.got_server_hello_done == 0) {
+                    CYASSL_MSG("No ServerHelloDone before ChangeCipher");
+                    return OUT_OF_ORDER_E;
+                }
+            }
+#endif
+#ifndef NO_CYASSL_SERVER
+            if (ssl->options.side == CYASSL_SERVER_END) {
+                if (!ssl->options.resuming &&
+                               ssl->msgsReceived.got_client_key_exchange == 0) {
+                    CYASSL_MSG("No ClientKeyExchange before ChangeCipher");
+                    return OUT_OF_ORDER_E;
+                }
+            }
+#endif
+
+            break;
+
+        default:
+            CYASSL_MSG("Unknown message type");
+            return SANITY_MSG_E;
+    }
+
+    return 0;
+}
+
+
+#ifndef NO_CERTS
+
+#ifndef NO_RSA
+
+/* ssl's RSA private key in *use, the ctx's decoded copy when ssl has the ctx
+   key, else key after decoding ssl->buffers.key into it */
+static int DecodeRsaPrivateKey(CYASSL* ssl, RsaKey* key, RsaKey** use)
+{
+    CYASSL_CTX* ctx = ssl->ctx;
+    word32      idx = 0;
+
+    *use = key;
+
+    if (ssl->buffers.key.buffer == ctx->privateKey.buffer) {
+        if (ctx->privateRsaKey) {
+            *use = ctx->privateRsaKey;
+            return 0;
+        }
+    #ifdef HAVE_ECC
+        if (ctx->privateEccKey)
+            return ASN_PARSE_E;     /* known to be ECC, don't try */
+    #endif
+    }
+#ifdef HAVE_ECC
+    if (ssl->buffers.key.buffer == ctx->eccPrivateKey.buffer && ctx->eccSlotKey)
+        return ASN_PARSE_E;
+#endif
+
+    return RsaPrivateKeyDecode(ssl->buffers.key.buffer, &idx, key,
+                               ssl->buffers.key.length);
+}
+
+#endif /* NO_RSA */
+
+#ifdef HAVE_ECC
+
+/* same for an ECC private key */
+static int DecodeEccPrivateKey(CYASSL* ssl, ecc_key* key, ecc_key** use)
+{
+    CYASSL_CTX* ctx    = ssl->ctx;
+    ecc_key*    cached = NULL;
+    word32      idx    = 0;
+
+    if (ssl->buffers.key.buffer == ctx->privateKey.buffer)
+        cached = ctx->privateEccKey;
+    else if (ssl->buffers.key.buffer == ctx->eccPrivateKey.buffer)
+        cached = ctx->eccSlotKey;
+
+    if (cached) {
+        *use = cached;
+        return 0;
+    }
+
+    *use = key;
+
+    return EccPrivateKeyDecode(ssl->buffers.key.buffer, &idx, key,
+                               ssl->buffers.key.length);
+}
+
+#endif /* HAVE_ECC */
+
+#endif /* NO_CERTS */
+
+
+#ifdef CYASSL_ASYNC_CRYPT
+
+#ifndef NO_RSA
+
+static int DoAsyncRsaOp(CYASSL_ASYNC_OP* op)
+{
+    CYASSL* ssl = op->ssl;
+    RsaKey  key;
+    RsaKey* use;
+    int     ret;
+
+#ifdef HAVE_PK_CALLBACKS
+    if (op->type == CYASSL_ASYNC_RSA_SIGN && ssl->ctx->RsaSignCb) {
+        op->outSz = sizeof(op->out);
+        return ssl->ctx->RsaSignCb(ssl, op->in, op->inSz, op->out, &op->outSz,
+                                   ssl->buffers.key.buffer,
+                                   ssl->buffers.key.length, ssl->RsaSignCtx);
+    }
+    if (op->type == CYASSL_ASYNC_RSA_DECRYPT && ssl->ctx->RsaDecCb) {
+        byte* out = NULL;
+
+        /* decrypts in place, keep op->in for matching */
+        XMEMCPY(op->out, op->in, op->inSz);
+        ret = ssl->ctx->RsaDecCb(ssl, op->out, op->inSz, &out,
+                                 ssl->buffers.key.buffer,
+                                 ssl->buffers.key.length, ssl->RsaDecCtx);
+        if (ret > 0 && out != NULL) {
+            XMEMMOVE(op->out, out, ret);
+            op->outSz = ret;
+        }
+        return ret;
+    }
+#endif /* HAVE_PK_CALLBACKS */
+
+    ret = InitRsaKey(&key, ssl->heap);
+    if (ret != 0)
+        return ret;
+
+    ret = DecodeRsaPrivateKey(ssl, &key, &use);
+    if (ret == 0) {
+        if (op->type == CYASSL_ASYNC_RSA_SIGN)
+            ret = RsaSSL_Sign(op->in, op->inSz, op->out, sizeof(op->out),
+                              use, ssl->rng);
+        else
+            ret = RsaPrivateDecrypt(op->in, op->inSz, op->out,
+                                    sizeof(op->out), use);
+        if (ret > 0)
+            op->outSz = ret;
+    }
+    FreeRsaKey(&key);
+
+    return ret;
+}
+
+#endif /* NO_RSA */
+
+#ifdef HAVE_ECC
+
+static int DoAsyncEccOp(CYASSL_ASYNC_OP* op)
+{
+    CYASSL*  ssl = op->ssl;
+    ecc_key  key;
+    ecc_key* use;
+    int      ret;
+
+    op->outSz = sizeof(op->out);
+
+    if (op->type == CYASSL_ASYNC_ECC_SHARED)
+        return ecc_shared_secret(ssl->eccTempKey, ssl->peerEccKey, op->out,
+                                 &op->outSz);
+
+#ifdef HAVE_PK_CALLBACKS
+    if (ssl->ctx->EccSignCb)
+        return ssl->ctx->EccSignCb(ssl, op->in, op->inSz, op->out, &op->outSz,
+                                   ssl->buffers.key.buffer,
+                                   ssl->buffers.key.length, ssl->EccSignCtx);
+#endif
+
+    ecc_init(&key);
+    ret = DecodeEccPrivateKey(ssl, &key, &use);
+    if (ret == 0)
+        ret = ecc_sign_hash(op->in, op->inSz, op->out, &op->outSz, ssl->rng,
+                            use);
+    ecc_free(&key);
+
+    return ret;
+}
+
+#endif /* HAVE_ECC */
+
+#ifdef HAVE_ECC25519
+
+/* the shared secret when the peer sent a Montgomery point */
+static int DoAsyncEcc25519Op(CYASSL_ASYNC_OP* op)
+{
+    CYASSL* ssl = op->ssl;
+
+    op->outSz = sizeof(op->out);
+
+    return ecc25519_shared_secret(ssl->ecc25519TempKey, ssl->peerEcc25519Key,
+                                  op->out, &op->outSz);
+}
+
+#endif /* HAVE_ECC25519 */
 
-            break;
-#endif
 
-#ifndef NO_CYASSL_CLIENT
-        case server_hello_done:
-            if (ssl->msgsReceived.got_server_hello_done) {
-                CYASSL_MSG("Duplicate ServerHelloDone received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_server_hello_done = 1;
+/* does the op on whatever thread the executor runs it on, then marks it done
+   for the next CyaSSL_accept/connect */
+int RunAsyncOp(CYASSL_ASYNC_OP* op)
+{
+    int ret = BAD_FUNC_ARG;
 
-            if (ssl->msgsReceived.got_certificate == 0) {
-                if (ssl->specs.kea == psk_kea ||
-                    ssl->specs.kea == dhe_psk_kea ||
-                    ssl->options.usingAnon_cipher) {
-                    CYASSL_MSG("No Cert required");
-                } else {
-                    CYASSL_MSG("No Certificate before ServerHelloDone");
-                    return OUT_OF_ORDER_E;
-                }
-            }
-            if (ssl->msgsReceived.got_server_key_exchange == 0) {
-                if (ssl->specs.static_ecdh == 1 ||
-                    ssl->specs.kea == rsa_kea ||
-                    ssl->specs.kea == ntru_kea) {
-                    CYASSL_MSG("No KeyExchange required");
-                } else {
-                    CYASSL_MSG("No ServerKeyExchange before ServerDone");
-                    return OUT_OF_ORDER_E;
-                }
+    switch (op->type) {
+    #ifndef NO_RSA
+        case CYASSL_ASYNC_RSA_SIGN:
+        case CYASSL_ASYNC_RSA_DECRYPT:
+            ret = DoAsyncRsaOp(op);
+            break;
+    #endif
+    #if defined(HAVE_ECC) || defined(HAVE_ECC25519)
+        case CYASSL_ASYNC_ECC_SIGN:
+        case CYASSL_ASYNC_ECC_SHARED:
+        #ifdef HAVE_ECC25519
+            if (op->type == CYASSL_ASYNC_ECC_SHARED &&
+                                                op->ssl->specs.useCurve25519) {
+                ret = DoAsyncEcc25519Op(op);
+                break;
             }
+        #endif
+        #ifdef HAVE_ECC
+            ret = DoAsyncEccOp(op);
+        #endif
             break;
-#endif
+    #endif
+        default:
+            CYASSL_MSG("Unknown async op type");
+    }
 
-#ifndef NO_CYASSL_SERVER
-        case certificate_verify:
-            if (ssl->msgsReceived.got_certificate_verify) {
-                CYASSL_MSG("Duplicate CertificateVerify received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_certificate_verify = 1;
+    if (LockMutex(&op->mutex) != 0)
+        return BAD_MUTEX_E;
+    op->ret   = ret;
+    op->state = ASYNC_DONE;
+    UnLockMutex(&op->mutex);
 
-            if ( ssl->msgsReceived.got_certificate == 0) {
-                CYASSL_MSG("No Cert before CertVerify");
-                return OUT_OF_ORDER_E;
-            }
-            break;
-#endif
+    return ret;
+}
 
-#ifndef NO_CYASSL_SERVER
-        case client_key_exchange:
-            if (ssl->msgsReceived.got_client_key_exchange) {
-                CYASSL_MSG("Duplicate ClientKeyExchange received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_client_key_exchange = 1;
 
-            if (ssl->msgsReceived.got_client_hello == 0) {
-                CYASSL_MSG("No ClientHello before ClientKeyExchange");
-                return OUT_OF_ORDER_E;
-            }
-            break;
-#endif
+int GetAsyncState(CYASSL* ssl)
+{
+    int state;
 
-        case finished:
-            if (ssl->msgsReceived.got_finished) {
-                CYASSL_MSG("Duplicate Finished received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_finished = 1;
+    if (ssl->async == NULL)
+        return ASYNC_IDLE;
 
-            if (ssl->msgsReceived.got_change_cipher == 0) {
-                CYASSL_MSG("Finished received before ChangeCipher");
-                return NO_CHANGE_CIPHER_E;
-            }
+    if (LockMutex(&ssl->async->mutex) != 0)
+        return ASYNC_PENDING;
+    state = ssl->async->state;
+    UnLockMutex(&ssl->async->mutex);
 
-            break;
+    return state;
+}
 
-        case change_cipher_hs:
-            if (ssl->msgsReceived.got_change_cipher) {
-                CYASSL_MSG("Duplicate ChangeCipher received");
-                return DUPLICATE_MSG_E;
-            }
-            ssl->msgsReceived.got_change_cipher = 1;
 
-#ifndef NO_CYASSL_CLIENT
-            if (ssl->options.side == CYASSL_CLIENT_END) {
-                if (!ssl->options.resuming &&
-                                 ssl->msgsReceived.got_server_hello_done == 0) {
-                    CYASSL_MSG("No ServerHelloDone before ChangeCipher");
-                    return OUT_OF_ORDER_E;
-                }
-            }
-#endif
-#ifndef NO_CYASSL_SERVER
-            if (ssl->options.side == CYASSL_SERVER_END) {
-                if (!ssl->options.resuming &&
-                               ssl->msgsReceived.got_client_key_exchange == 0) {
-                    CYASSL_MSG("No ClientKeyExchange before ChangeCipher");
-                    return OUT_OF_ORDER_E;
+/* Private key op through the async executor. The first call hands the op to
+   the submit callback and returns WANT_ASYNC, the handshake step is run again
+   once the op is done and the same call then gets the result in out */
+static int AsyncPkOp(CYASSL* ssl, int type, const byte* in, word32 inSz,
+                     byte* out, word32* outSz)
+{
+    CYASSL_ASYNC_OP* op = ssl->async;
+    int              ret, state = GetAsyncState(ssl);
+
+    if (state == ASYNC_PENDING)
+        return WANT_ASYNC;
+
+    if (state == ASYNC_DONE) {
+        op->state = ASYNC_IDLE;
+        if (op->type == type && op->inSz == inSz &&
+                                            XMEMCMP(op->in, in, inSz) == 0) {
+            ret = op->ret;
+            if (ret >= 0) {
+                if (op->outSz > *outSz)
+                    ret = BUFFER_E;
+                else {
+                    XMEMCPY(out, op->out, op->outSz);
+                    *outSz = op->outSz;
                 }
             }
-#endif
+            XMEMSET(op->out, 0, sizeof(op->out));
+            return ret;
+        }
+        CYASSL_MSG("Async result was for other input, doing op again");
+    }
 
-            break;
+    if (inSz > sizeof(op->in))
+        return BUFFER_E;
 
-        default:
-            CYASSL_MSG("Unknown message type");
-            return SANITY_MSG_E;
+    if (op == NULL) {
+        op = (CYASSL_ASYNC_OP*)XMALLOC(sizeof(CYASSL_ASYNC_OP), ssl->heap,
+                                       DYNAMIC_TYPE_ASYNC);
+        if (op == NULL)
+            return MEMORY_E;
+        if (InitMutex(&op->mutex) != 0) {
+            XFREE(op, ssl->heap, DYNAMIC_TYPE_ASYNC);
+            return BAD_MUTEX_E;
+        }
+        ssl->async = op;
     }
 
-    return 0;
+    op->ssl   = ssl;
+    op->type  = type;
+    op->ret   = 0;
+    op->inSz  = inSz;
+    op->outSz = 0;
+    op->state = ASYNC_PENDING;
+    XMEMCPY(op->in, in, inSz);
+
+    /* the dtls handshake can't rerun a message, and a refused op runs here */
+    if (ssl->options.dtls ||
+                    ssl->ctx->AsyncSubmitCb(ssl, op, ssl->AsyncSubmitCtx) != 0) {
+        RunAsyncOp(op);
+        if (op->state != ASYNC_DONE)
+            return BAD_MUTEX_E;
+        return AsyncPkOp(ssl, type, in, inSz, out, outSz);
+    }
+
+    return WANT_ASYNC;
 }
 
+#endif /* CYASSL_ASYNC_CRYPT */
+
 
 static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
                           byte type, word32 size, word32 totalSz)
 {
     int ret = 0;
+#ifdef CYASSL_MEM_TRACE
+    int phase;
+#endif
     (void)totalSz;
 
     CYASSL_ENTER("DoHandShakeMsgType");
@@ -5014,16 +7730,30 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
     if (*inOutIdx + size > totalSz)
         return INCOMPLETE_DATA;
 
-    /* sanity check msg received */
-    if ( (ret = SanityCheckMsgReceived(ssl, type)) != 0) {
-        CYASSL_MSG("Sanity Check on handshake message type received failed");
-        return ret;
+#ifdef HAVE_OCSP
+    /* past where a staple could be, check the peer cert ourselves. This
+       message isn't looked at yet, after an OCSP_WANT_ it's just run again */
+    if (ssl->ocspPending != NULL && type != certificate_status) {
+        ret = CheckPendingOCSP(ssl);
+        if (ret != 0)
+            return ret;
     }
+#endif
+
+    /* a message run again for its async result, or a ClientHello again for
+       its callback, was checked and hashed the first time through */
+    if (GetAsyncState(ssl) != ASYNC_DONE && !ssl->options.helloCbPending) {
+        /* sanity check msg received */
+        if ( (ret = SanityCheckMsgReceived(ssl, type)) != 0) {
+            CYASSL_MSG("Sanity Check on handshake message type received failed");
+            return ret;
+        }
 
-    /* hello_request not hashed */
-    if (type != hello_request) {
-        ret = HashInput(ssl, input + *inOutIdx, size);
-        if (ret != 0) return ret;
+        /* hello_request not hashed */
+        if (type != hello_request) {
+            ret = HashInput(ssl, input + *inOutIdx, size);
+            if (ret != 0) return ret;
+        }
     }
 
 #ifdef CYASSL_CALLBACKS
@@ -5065,6 +7795,10 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
     }
 
 
+#ifdef CYASSL_MEM_TRACE
+    phase = CyaSSL_MemTraceSetPhase(CYASSL_TRACE_MSG_BASE + type);
+#endif
+
     switch (type) {
 
     case hello_request:
@@ -5092,7 +7826,9 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
 
     case server_key_exchange:
         CYASSL_MSG("processing server key exchange");
+        HS_TIMING_OPEN(ssl, CYASSL_HS_VERIFY);
         ret = DoServerKeyExchange(ssl, input, inOutIdx, size);
+        HS_TIMING_CLOSE(ssl, CYASSL_HS_VERIFY, server_key_exchange);
         break;
 
 #ifdef HAVE_SESSION_TICKET
@@ -5101,12 +7837,21 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
         ret = DoSessionTicket(ssl, input, inOutIdx, size);
         break;
 #endif /* HAVE_SESSION_TICKET */
+
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+    case certificate_status:
+        CYASSL_MSG("processing certificate status");
+        ret = DoCertificateStatus(ssl, input, inOutIdx, size);
+        break;
+#endif
 #endif
 
 #ifndef NO_CERTS
     case certificate:
         CYASSL_MSG("processing certificate");
-        ret =  DoCertificate(ssl, input, inOutIdx, size);
+        HS_TIMING_OPEN(ssl, CYASSL_HS_DECODE);
+        ret = DoCertificate(ssl, input, inOutIdx, size);
+        HS_TIMING_CLOSE(ssl, CYASSL_HS_DECODE, certificate);
         break;
 #endif
 
@@ -5133,17 +7878,23 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
     case client_hello:
         CYASSL_MSG("processing client hello");
         ret = DoClientHello(ssl, input, inOutIdx, size);
+        if (ret == 0 && !ssl->options.resuming)
+            ret = SSL_CtxAdmitHandshake(ssl);
         break;
 
     case client_key_exchange:
         CYASSL_MSG("processing client key exchange");
+        HS_TIMING_OPEN(ssl, CYASSL_HS_KEYGEN);
         ret = DoClientKeyExchange(ssl, input, inOutIdx, size);
+        HS_TIMING_CLOSE(ssl, CYASSL_HS_KEYGEN, client_key_exchange);
         break;
 
 #if !defined(NO_RSA) || defined(HAVE_ECC)
     case certificate_verify:
         CYASSL_MSG("processing certificate verify");
+        HS_TIMING_OPEN(ssl, CYASSL_HS_VERIFY);
         ret = DoCertificateVerify(ssl, input, inOutIdx, size);
+        HS_TIMING_CLOSE(ssl, CYASSL_HS_VERIFY, certificate_verify);
         break;
 #endif /* !NO_RSA || HAVE_ECC */
 
@@ -5155,6 +7906,10 @@ static int DoHandShakeMsgType(CYASSL* ssl, byte* input, word32* inOutIdx,
         break;
     }
 
+#ifdef CYASSL_MEM_TRACE
+    CyaSSL_MemTraceSetPhase(phase);
+#endif
+
     CYASSL_LEAVE("DoHandShakeMsgType()", ret);
     return ret;
 }
@@ -5165,6 +7920,7 @@ static int DoHandShakeMsg(CYASSL* ssl, byte* input, word32* inOutIdx,
 {
     byte   type;
     word32 size;
+    word32 begin = *inOutIdx;
     int    ret = 0;
 
     CYASSL_ENTER("DoHandShakeMsg()");
@@ -5174,6 +7930,12 @@ static int DoHandShakeMsg(CYASSL* ssl, byte* input, word32* inOutIdx,
 
     ret = DoHandShakeMsgType(ssl, input, inOutIdx, type, size, totalSz);
 
+    /* whole message again once the op, OCSP responder or ClientHello
+       callback is back */
+    if (ret == WANT_ASYNC || ret == OCSP_WANT_READ || ret == OCSP_WANT_WRITE ||
+                                                   ret == WANT_CLIENT_HELLO)
+        *inOutIdx = begin;
+
     CYASSL_LEAVE("DoHandShakeMsg()", ret);
     return ret;
 }
@@ -5181,11 +7943,15 @@ static int DoHandShakeMsg(CYASSL* ssl, byte* input, word32* inOutIdx,
 
 #ifdef CYASSL_DTLS
 
+/* The windows are rings of DTLS_SEQ_SZ words indexed by sequence number,
+ * record seq has bit (seq % DTLS_WORD_BITS) of word (seq / DTLS_WORD_BITS)
+ * modulo the ring. The spare word keeps the DTLS_SEQ_BITS records below next
+ * from aliasing, so moving forward only zeroes the words entered. */
 static INLINE int DtlsCheckWindow(DtlsState* state)
 {
     word32 cur;
     word32 next;
-    DtlsSeq window;
+    DtlsSeq* window;
 
     if (state->curEpoch == state->nextEpoch) {
         next = state->nextSeq;
@@ -5201,10 +7967,14 @@ static INLINE int DtlsCheckWindow(DtlsState* state)
 
     cur = state->curSeq;
 
-    if ((next > DTLS_SEQ_BITS) && (cur < next - DTLS_SEQ_BITS)) {
+    if (cur >= next) {
+        return 1;
+    }
+    else if (next - cur > DTLS_SEQ_BITS) {
         return 0;
     }
-    else if ((cur < next) && (window & ((DtlsSeq)1 << (next - cur - 1)))) {
+    else if (window[(cur / DTLS_WORD_BITS) % DTLS_SEQ_SZ] &
+                                   ((DtlsSeq)1 << (cur % DTLS_WORD_BITS))) {
         return 0;
     }
 
@@ -5220,47 +7990,50 @@ static INLINE int DtlsUpdateWindow(DtlsState* state)
 
     if (state->curEpoch == state->nextEpoch) {
         next = &state->nextSeq;
-        window = &state->window;
+        window = state->window;
     }
     else {
         next = &state->prevSeq;
-        window = &state->prevWindow;
+        window = state->prevWindow;
     }
 
     cur = state->curSeq;
 
-    if (cur < *next) {
-        *window |= ((DtlsSeq)1 << (*next - cur - 1));
-    }
-    else {
-        *window <<= (1 + cur - *next);
-        *window |= 1;
+    if (cur >= *next) {
+        if (*next > 0) {
+            word32 last  = (*next - 1) / DTLS_WORD_BITS;
+            word32 words = cur / DTLS_WORD_BITS - last;
+
+            if (words > DTLS_SEQ_SZ)
+                words = DTLS_SEQ_SZ;
+            while (words--)
+                window[++last % DTLS_SEQ_SZ] = 0;
+        }
         *next = cur + 1;
     }
 
+    window[(cur / DTLS_WORD_BITS) % DTLS_SEQ_SZ] |=
+                                     ((DtlsSeq)1 << (cur % DTLS_WORD_BITS));
+
     return 1;
 }
 
 
 static int DtlsMsgDrain(CYASSL* ssl)
 {
-    DtlsMsg* item = ssl->dtls_msg_list;
+    word32 seq = ssl->keys.dtls_expected_peer_handshake_number;
+    DtlsMsg* item = DtlsMsgFind(ssl, seq);
     int ret = 0;
 
-    /* While there is an item in the store list, and it is the expected
-     * message, and it is complete, and there hasn't been an error in the
-     * last messge... */
-    while (item != NULL &&
-            ssl->keys.dtls_expected_peer_handshake_number == item->seq &&
-            item->fragSz == item->sz &&
-            ret == 0) {
+    /* While the expected message is stored, and it is complete, and there
+     * hasn't been an error in the last messge... */
+    while (item != NULL && item->fragSz == item->sz && ret == 0) {
         word32 idx = 0;
         ssl->keys.dtls_expected_peer_handshake_number++;
         ret = DoHandShakeMsgType(ssl, item->msg,
                                  &idx, item->type, item->sz, item->sz);
-        ssl->dtls_msg_list = item->next;
-        DtlsMsgDelete(item, ssl->heap);
-        item = ssl->dtls_msg_list;
+        DtlsMsgRemove(ssl, seq);
+        item = DtlsMsgFind(ssl, ++seq);
     }
 
     return ret;
@@ -5283,6 +8056,9 @@ static int DoDtlsHandShakeMsg(CYASSL* ssl, byte* input, word32* inOutIdx,
     if (*inOutIdx + fragSz > totalSz)
         return INCOMPLETE_DATA;
 
+    if (ssl->keys.dtls_peer_handshake_number >= ssl->dtls_flight_peer)
+        DtlsRttSample(ssl);
+
     /* Check the handshake sequence number first. If out of order,
      * add the current message to the list. If the message is in order,
      * but it is a fragment, add the current message to the list, then
@@ -5294,38 +8070,40 @@ static int DoDtlsHandShakeMsg(CYASSL* ssl, byte* input, word32* inOutIdx,
      */
     if (ssl->keys.dtls_peer_handshake_number >
                                 ssl->keys.dtls_expected_peer_handshake_number) {
-        /* Current message is out of order. It will get stored in the list.
+        /* Current message is out of order. It will get stored in its slot.
          * Storing also takes care of defragmentation. */
-        ssl->dtls_msg_list = DtlsMsgStore(ssl->dtls_msg_list,
-                        ssl->keys.dtls_peer_handshake_number, input + *inOutIdx,
-                        size, type, fragOffset, fragSz, ssl->heap);
+        ret = DtlsMsgStore(ssl, ssl->keys.dtls_peer_handshake_number,
+                  input + *inOutIdx, size, type, fragOffset, fragSz);
         *inOutIdx += fragSz;
-        ret = 0;
     }
     else if (ssl->keys.dtls_peer_handshake_number <
                                 ssl->keys.dtls_expected_peer_handshake_number) {
-        /* Already saw this message and processed it. It can be ignored. */
+        /* Already saw this message and processed it. It can be ignored.
+         * If it ends the flight our pool answers, the peer is resending that
+         * flight because ours got lost, resend without waiting to time out. */
         *inOutIdx += fragSz;
         ret = 0;
+        if (ssl->keys.dtls_peer_handshake_number + 1 == ssl->dtls_flight_peer
+                                                         && fragOffset == 0)
+            ret = DtlsPoolSend(ssl);
     }
     else if (fragSz < size) {
-        /* Since this branch is in order, but fragmented, dtls_msg_list will be
-         * pointing to the message with this fragment in it. Check it to see
-         * if it is completed. */
-        ssl->dtls_msg_list = DtlsMsgStore(ssl->dtls_msg_list,
-                        ssl->keys.dtls_peer_handshake_number, input + *inOutIdx,
-                        size, type, fragOffset, fragSz, ssl->heap);
+        /* Since this branch is in order, but fragmented, the expected slot
+         * holds the message with this fragment in it. Drain processes it
+         * once it is completed. */
+        ret = DtlsMsgStore(ssl, ssl->keys.dtls_peer_handshake_number,
+                  input + *inOutIdx, size, type, fragOffset, fragSz);
         *inOutIdx += fragSz;
-        ret = 0;
-        if (ssl->dtls_msg_list != NULL &&
-            ssl->dtls_msg_list->fragSz >= ssl->dtls_msg_list->sz)
+        if (ret == 0)
             ret = DtlsMsgDrain(ssl);
     }
     else {
-        /* This branch is in order next, and a complete message. */
+        /* This branch is in order next, and a complete message. Drop any
+         * fragments of it stored earlier. */
+        DtlsMsgRemove(ssl, ssl->keys.dtls_peer_handshake_number);
         ssl->keys.dtls_expected_peer_handshake_number++;
         ret = DoHandShakeMsgType(ssl, input, inOutIdx, type, size, totalSz);
-        if (ret == 0 && ssl->dtls_msg_list != NULL)
+        if (ret == 0)
             ret = DtlsMsgDrain(ssl);
     }
 
@@ -5534,6 +8312,21 @@ static int  ChachaAEADEncrypt(CYASSL* ssl, byte* out, const byte* input,
 		printf("\n");
 	#endif
 	
+	#ifdef HAVE_POLY1305
+		/* current layout, cipher and MAC in one pass over the record */
+		if (ssl->options.oldPoly == 0) {
+		    if (sz < ssl->specs.aead_mac_size)
+		        return INPUT_CASE_ERROR;
+		    ret = ChaCha20Poly1305_EncryptCtx(ssl->encrypt.chacha, nonce,
+		                additional, CHACHA20_BLOCK_SIZE, input,
+		                sz - ssl->specs.aead_mac_size, out,
+		                out + sz - ssl->specs.aead_mac_size);
+		    AeadIncrementExpIV(ssl);
+		    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+		    return ret;
+		}
+	#endif
+
 	/* set the nonce for chacha and get poly1305 key */
 	if ((ret = Chacha_SetIV(ssl->encrypt.chacha, nonce, 0)) != 0)
 	    return ret;
@@ -5638,6 +8431,25 @@ static int ChachaAEADDecrypt(CYASSL* ssl, byte* plain, const byte* input,
 		printf("\n\n");
 	#endif
 	
+	#ifdef HAVE_POLY1305
+		/* current layout, MAC and cipher in one pass over the record */
+		if (ssl->options.oldPoly == 0) {
+		    if (sz < ssl->specs.aead_mac_size)
+		        return INPUT_CASE_ERROR;
+		    ret = ChaCha20Poly1305_DecryptCtx(ssl->decrypt.chacha, nonce,
+		                additional, CHACHA20_BLOCK_SIZE, input,
+		                sz - ssl->specs.aead_mac_size,
+		                input + sz - ssl->specs.aead_mac_size, plain);
+		    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+		    if (ret == CHACHA_POLY_AUTH_E) {
+		        CYASSL_MSG("Mac did not match");
+		        SendAlert(ssl, alert_fatal, bad_record_mac);
+		        return VERIFY_MAC_ERROR;
+		    }
+		    return ret;
+		}
+	#endif
+
 	/* set nonce and get poly1305 key */
 	if ((ret = Chacha_SetIV(ssl->decrypt.chacha, nonce, 0)) != 0)
 	    return ret;
@@ -5691,318 +8503,494 @@ static int ChachaAEADDecrypt(CYASSL* ssl, byte* plain, const byte* input,
 	
 	return ret;
 }
-#endif /* HAVE_CHACHA */
-#endif
+#endif /* HAVE_CHACHA */
+#endif
+
+
+/* Record encrypt and decrypt, one function per bulk cipher. SetKeysSide()
+   stores the pair for the negotiated cipher in Ciphers.process so each
+   record calls its cipher directly instead of walking a switch. */
+
+#ifdef BUILD_ARC4
+
+static int Arc4RecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                             word16 sz)
+{
+    Arc4Process(ssl->encrypt.arc4, out, input, sz);
+    return 0;
+}
+
+
+static int Arc4RecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                             word16 sz)
+{
+    Arc4Process(ssl->decrypt.arc4, plain, input, sz);
+    return 0;
+}
+
+#endif /* BUILD_ARC4 */
+
+
+#ifdef BUILD_DES3
+
+static int Des3RecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                             word16 sz)
+{
+    return Des3_CbcEncrypt(ssl->encrypt.des3, out, input, sz);
+}
+
+
+static int Des3RecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                             word16 sz)
+{
+    return Des3_CbcDecrypt(ssl->decrypt.des3, plain, input, sz);
+}
+
+#endif /* BUILD_DES3 */
+
+
+#ifdef BUILD_AES
+
+static int AesCbcRecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                               word16 sz)
+{
+    return AesCbcEncrypt(ssl->encrypt.aes, out, input, sz);
+}
+
+
+static int AesCbcRecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                               word16 sz)
+{
+    return AesCbcDecrypt(ssl->decrypt.aes, plain, input, sz);
+}
+
+#endif /* BUILD_AES */
+
+
+#ifdef BUILD_AESGCM
+
+static int AesGcmAEADEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                             word16 sz)
+{
+    int  gcmRet;
+    byte additional[AEAD_AUTH_DATA_SZ];
+    byte nonce[AEAD_NONCE_SZ];
+    const byte* additionalSrc = input - 5;
+
+    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
+
+    /* sequence number field is 64-bits, we only use 32-bits */
+    c32toa(GetSEQIncrement(ssl, 0), additional + AEAD_SEQ_OFFSET);
+
+    /* Store the type, version. Unfortunately, they are in
+     * the input buffer ahead of the plaintext. */
+    #ifdef CYASSL_DTLS
+        if (ssl->options.dtls) {
+            c16toa(ssl->keys.dtls_epoch, additional);
+            additionalSrc -= DTLS_HANDSHAKE_EXTRA;
+        }
+    #endif
+    XMEMCPY(additional + AEAD_TYPE_OFFSET, additionalSrc, 3);
+
+    /* Store the length of the plain text minus the explicit
+     * IV length minus the authentication tag size. */
+    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                                additional + AEAD_LEN_OFFSET);
+    XMEMCPY(nonce, ssl->keys.aead_enc_imp_IV, AEAD_IMP_IV_SZ);
+    XMEMCPY(nonce + AEAD_IMP_IV_SZ, ssl->keys.aead_exp_IV, AEAD_EXP_IV_SZ);
+    gcmRet = AesGcmEncrypt(ssl->encrypt.aes,
+                 out + AEAD_EXP_IV_SZ, input + AEAD_EXP_IV_SZ,
+                 sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                 nonce, AEAD_NONCE_SZ,
+                 out + sz - ssl->specs.aead_mac_size,
+                 ssl->specs.aead_mac_size,
+                 additional, AEAD_AUTH_DATA_SZ);
+    if (gcmRet == 0)
+        AeadIncrementExpIV(ssl);
+    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+    return gcmRet;
+}
+
+
+static int AesGcmAEADDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                             word16 sz)
+{
+    byte additional[AEAD_AUTH_DATA_SZ];
+    byte nonce[AEAD_NONCE_SZ];
+
+    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
+
+    /* sequence number field is 64-bits, we only use 32-bits */
+    c32toa(GetSEQIncrement(ssl, 1), additional + AEAD_SEQ_OFFSET);
+
+    #ifdef CYASSL_DTLS
+        if (ssl->options.dtls)
+            c16toa(ssl->keys.dtls_state.curEpoch, additional);
+    #endif
+
+    additional[AEAD_TYPE_OFFSET] = ssl->curRL.type;
+    additional[AEAD_VMAJ_OFFSET] = ssl->curRL.pvMajor;
+    additional[AEAD_VMIN_OFFSET] = ssl->curRL.pvMinor;
+
+    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                            additional + AEAD_LEN_OFFSET);
+    XMEMCPY(nonce, ssl->keys.aead_dec_imp_IV, AEAD_IMP_IV_SZ);
+    XMEMCPY(nonce + AEAD_IMP_IV_SZ, input, AEAD_EXP_IV_SZ);
+    if (AesGcmDecrypt(ssl->decrypt.aes,
+                plain + AEAD_EXP_IV_SZ,
+                input + AEAD_EXP_IV_SZ,
+                    sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                nonce, AEAD_NONCE_SZ,
+                input + sz - ssl->specs.aead_mac_size,
+                ssl->specs.aead_mac_size,
+                additional, AEAD_AUTH_DATA_SZ) < 0) {
+        SendAlert(ssl, alert_fatal, bad_record_mac);
+        XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+        return VERIFY_MAC_ERROR;
+    }
+    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+    return 0;
+}
+
+#endif /* BUILD_AESGCM */
+
+
+#ifdef HAVE_AESCCM
+
+static int AesCcmAEADEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                             word16 sz)
+{
+    byte additional[AEAD_AUTH_DATA_SZ];
+    byte nonce[AEAD_NONCE_SZ];
+    const byte* additionalSrc = input - 5;
+
+    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
+
+    /* sequence number field is 64-bits, we only use 32-bits */
+    c32toa(GetSEQIncrement(ssl, 0), additional + AEAD_SEQ_OFFSET);
+
+    /* Store the type, version. Unfortunately, they are in
+     * the input buffer ahead of the plaintext. */
+    #ifdef CYASSL_DTLS
+        if (ssl->options.dtls) {
+            c16toa(ssl->keys.dtls_epoch, additional);
+            additionalSrc -= DTLS_HANDSHAKE_EXTRA;
+        }
+    #endif
+    XMEMCPY(additional + AEAD_TYPE_OFFSET, additionalSrc, 3);
+
+    /* Store the length of the plain text minus the explicit
+     * IV length minus the authentication tag size. */
+    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                                additional + AEAD_LEN_OFFSET);
+    XMEMCPY(nonce, ssl->keys.aead_enc_imp_IV, AEAD_IMP_IV_SZ);
+    XMEMCPY(nonce + AEAD_IMP_IV_SZ, ssl->keys.aead_exp_IV, AEAD_EXP_IV_SZ);
+    AesCcmEncrypt(ssl->encrypt.aes,
+        out + AEAD_EXP_IV_SZ, input + AEAD_EXP_IV_SZ,
+            sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+        nonce, AEAD_NONCE_SZ,
+        out + sz - ssl->specs.aead_mac_size,
+        ssl->specs.aead_mac_size,
+        additional, AEAD_AUTH_DATA_SZ);
+    AeadIncrementExpIV(ssl);
+    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+    return 0;
+}
+
+
+static int AesCcmAEADDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                             word16 sz)
+{
+    byte additional[AEAD_AUTH_DATA_SZ];
+    byte nonce[AEAD_NONCE_SZ];
+
+    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
+
+    /* sequence number field is 64-bits, we only use 32-bits */
+    c32toa(GetSEQIncrement(ssl, 1), additional + AEAD_SEQ_OFFSET);
+
+    #ifdef CYASSL_DTLS
+        if (ssl->options.dtls)
+            c16toa(ssl->keys.dtls_state.curEpoch, additional);
+    #endif
+
+    additional[AEAD_TYPE_OFFSET] = ssl->curRL.type;
+    additional[AEAD_VMAJ_OFFSET] = ssl->curRL.pvMajor;
+    additional[AEAD_VMIN_OFFSET] = ssl->curRL.pvMinor;
+
+    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                            additional + AEAD_LEN_OFFSET);
+    XMEMCPY(nonce, ssl->keys.aead_dec_imp_IV, AEAD_IMP_IV_SZ);
+    XMEMCPY(nonce + AEAD_IMP_IV_SZ, input, AEAD_EXP_IV_SZ);
+    if (AesCcmDecrypt(ssl->decrypt.aes,
+                plain + AEAD_EXP_IV_SZ,
+                input + AEAD_EXP_IV_SZ,
+                    sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
+                nonce, AEAD_NONCE_SZ,
+                input + sz - ssl->specs.aead_mac_size,
+                ssl->specs.aead_mac_size,
+                additional, AEAD_AUTH_DATA_SZ) < 0) {
+        SendAlert(ssl, alert_fatal, bad_record_mac);
+        XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+        return VERIFY_MAC_ERROR;
+    }
+    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
+    return 0;
+}
 
+#endif /* HAVE_AESCCM */
 
-static INLINE int Encrypt(CYASSL* ssl, byte* out, const byte* input, word16 sz)
+
+#ifdef HAVE_CAMELLIA
+
+static int CamelliaRecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                                 word16 sz)
 {
-    (void)out;
-    (void)input;
-    (void)sz;
+    CamelliaCbcEncrypt(ssl->encrypt.cam, out, input, sz);
+    return 0;
+}
 
-    if (ssl->encrypt.setup == 0) {
-        CYASSL_MSG("Encrypt ciphers not setup");
-        return ENCRYPT_ERROR;
+
+static int CamelliaRecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                                 word16 sz)
+{
+    CamelliaCbcDecrypt(ssl->decrypt.cam, plain, input, sz);
+    return 0;
+}
+
+#endif /* HAVE_CAMELLIA */
+
+
+#ifdef HAVE_HC128
+
+static int Hc128RecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                              word16 sz)
+{
+    return Hc128_Process(ssl->encrypt.hc128, out, input, sz);
+}
+
+
+static int Hc128RecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                              word16 sz)
+{
+    return Hc128_Process(ssl->decrypt.hc128, plain, input, sz);
+}
+
+#endif /* HAVE_HC128 */
+
+
+#ifdef BUILD_RABBIT
+
+static int RabbitRecordEncrypt(CYASSL* ssl, byte* out, const byte* input,
+                               word16 sz)
+{
+    return RabbitProcess(ssl->encrypt.rabbit, out, input, sz);
+}
+
+
+static int RabbitRecordDecrypt(CYASSL* ssl, byte* plain, const byte* input,
+                               word16 sz)
+{
+    return RabbitProcess(ssl->decrypt.rabbit, plain, input, sz);
+}
+
+#endif /* BUILD_RABBIT */
+
+
+#ifdef HAVE_NULL_CIPHER
+
+static int NullRecordProcess(CYASSL* ssl, byte* out, const byte* input,
+                             word16 sz)
+{
+    (void)ssl;
+
+    if (input != out) {
+        XMEMMOVE(out, input, sz);
     }
+    return 0;
+}
+
+#endif /* HAVE_NULL_CIPHER */
 
-#ifdef HAVE_FUZZER
-    if (ssl->fuzzerCb)
-        ssl->fuzzerCb(ssl, input, sz, FUZZ_ENCRYPT, ssl->fuzzerCtx);
-#endif
 
-    switch (ssl->specs.bulk_cipher_algorithm) {
+static INLINE cipherfp EncryptFunc(int bulk)
+{
+    switch (bulk) {
         #ifdef BUILD_ARC4
             case cyassl_rc4:
-                Arc4Process(ssl->encrypt.arc4, out, input, sz);
-                break;
+                return Arc4RecordEncrypt;
         #endif
 
         #ifdef BUILD_DES3
             case cyassl_triple_des:
-                return Des3_CbcEncrypt(ssl->encrypt.des3, out, input, sz);
+                return Des3RecordEncrypt;
         #endif
 
         #ifdef BUILD_AES
             case cyassl_aes:
-                return AesCbcEncrypt(ssl->encrypt.aes, out, input, sz);
+                return AesCbcRecordEncrypt;
         #endif
 
         #ifdef BUILD_AESGCM
             case cyassl_aes_gcm:
-                {
-                    int  gcmRet;
-                    byte additional[AEAD_AUTH_DATA_SZ];
-                    byte nonce[AEAD_NONCE_SZ];
-                    const byte* additionalSrc = input - 5;
-
-                    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
-
-                    /* sequence number field is 64-bits, we only use 32-bits */
-                    c32toa(GetSEQIncrement(ssl, 0),
-                                            additional + AEAD_SEQ_OFFSET);
-
-                    /* Store the type, version. Unfortunately, they are in
-                     * the input buffer ahead of the plaintext. */
-                    #ifdef CYASSL_DTLS
-                        if (ssl->options.dtls) {
-                            c16toa(ssl->keys.dtls_epoch, additional);
-                            additionalSrc -= DTLS_HANDSHAKE_EXTRA;
-                        }
-                    #endif
-                    XMEMCPY(additional + AEAD_TYPE_OFFSET, additionalSrc, 3);
-
-                    /* Store the length of the plain text minus the explicit
-                     * IV length minus the authentication tag size. */
-                    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                                                additional + AEAD_LEN_OFFSET);
-                    XMEMCPY(nonce,
-                                 ssl->keys.aead_enc_imp_IV, AEAD_IMP_IV_SZ);
-                    XMEMCPY(nonce + AEAD_IMP_IV_SZ,
-                                     ssl->keys.aead_exp_IV, AEAD_EXP_IV_SZ);
-                    gcmRet = AesGcmEncrypt(ssl->encrypt.aes,
-                                 out + AEAD_EXP_IV_SZ, input + AEAD_EXP_IV_SZ,
-                                 sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                                 nonce, AEAD_NONCE_SZ,
-                                 out + sz - ssl->specs.aead_mac_size,
-                                 ssl->specs.aead_mac_size,
-                                 additional, AEAD_AUTH_DATA_SZ);
-                    if (gcmRet == 0)
-                        AeadIncrementExpIV(ssl);
-                    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-                    return gcmRet;
-                }
-                break;
+                return AesGcmAEADEncrypt;
         #endif
 
         #ifdef HAVE_AESCCM
             case cyassl_aes_ccm:
-                {
-                    byte additional[AEAD_AUTH_DATA_SZ];
-                    byte nonce[AEAD_NONCE_SZ];
-                    const byte* additionalSrc = input - 5;
-
-                    XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
-
-                    /* sequence number field is 64-bits, we only use 32-bits */
-                    c32toa(GetSEQIncrement(ssl, 0),
-                                            additional + AEAD_SEQ_OFFSET);
-
-                    /* Store the type, version. Unfortunately, they are in
-                     * the input buffer ahead of the plaintext. */
-                    #ifdef CYASSL_DTLS
-                        if (ssl->options.dtls) {
-                            c16toa(ssl->keys.dtls_epoch, additional);
-                            additionalSrc -= DTLS_HANDSHAKE_EXTRA;
-                        }
-                    #endif
-                    XMEMCPY(additional + AEAD_TYPE_OFFSET, additionalSrc, 3);
-
-                    /* Store the length of the plain text minus the explicit
-                     * IV length minus the authentication tag size. */
-                    c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                                                additional + AEAD_LEN_OFFSET);
-                    XMEMCPY(nonce,
-                                 ssl->keys.aead_enc_imp_IV, AEAD_IMP_IV_SZ);
-                    XMEMCPY(nonce + AEAD_IMP_IV_SZ,
-                                     ssl->keys.aead_exp_IV, AEAD_EXP_IV_SZ);
-                    AesCcmEncrypt(ssl->encrypt.aes,
-                        out + AEAD_EXP_IV_SZ, input + AEAD_EXP_IV_SZ,
-                            sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                        nonce, AEAD_NONCE_SZ,
-                        out + sz - ssl->specs.aead_mac_size,
-                        ssl->specs.aead_mac_size,
-                        additional, AEAD_AUTH_DATA_SZ);
-                    AeadIncrementExpIV(ssl);
-                    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-                }
-                break;
+                return AesCcmAEADEncrypt;
         #endif
 
         #ifdef HAVE_CAMELLIA
             case cyassl_camellia:
-                CamelliaCbcEncrypt(ssl->encrypt.cam, out, input, sz);
-                break;
+                return CamelliaRecordEncrypt;
         #endif
 
         #ifdef HAVE_HC128
             case cyassl_hc128:
-                return Hc128_Process(ssl->encrypt.hc128, out, input, sz);
+                return Hc128RecordEncrypt;
         #endif
 
         #ifdef BUILD_RABBIT
             case cyassl_rabbit:
-                return RabbitProcess(ssl->encrypt.rabbit, out, input, sz);
+                return RabbitRecordEncrypt;
         #endif
 
         #ifdef HAVE_CHACHA
             case cyassl_chacha:
-                return ChachaAEADEncrypt(ssl, out, input, sz);
+                return ChachaAEADEncrypt;
         #endif
 
         #ifdef HAVE_NULL_CIPHER
             case cyassl_cipher_null:
-                if (input != out) {
-                    XMEMMOVE(out, input, sz);
-                }
-                break;
+                return NullRecordProcess;
         #endif
 
             default:
-                CYASSL_MSG("CyaSSL Encrypt programming error");
-                return ENCRYPT_ERROR;
+                return NULL;
     }
-
-    return 0;
 }
 
 
-
-static INLINE int Decrypt(CYASSL* ssl, byte* plain, const byte* input,
-                           word16 sz)
+static INLINE cipherfp DecryptFunc(int bulk)
 {
-    (void)plain;
-    (void)input;
-    (void)sz;
-
-    if (ssl->decrypt.setup == 0) {
-        CYASSL_MSG("Decrypt ciphers not setup");
-        return DECRYPT_ERROR;
-    }
-
-    switch (ssl->specs.bulk_cipher_algorithm) {
+    switch (bulk) {
         #ifdef BUILD_ARC4
             case cyassl_rc4:
-                Arc4Process(ssl->decrypt.arc4, plain, input, sz);
-                break;
+                return Arc4RecordDecrypt;
         #endif
 
         #ifdef BUILD_DES3
             case cyassl_triple_des:
-                return Des3_CbcDecrypt(ssl->decrypt.des3, plain, input, sz);
+                return Des3RecordDecrypt;
         #endif
 
         #ifdef BUILD_AES
             case cyassl_aes:
-                return AesCbcDecrypt(ssl->decrypt.aes, plain, input, sz);
+                return AesCbcRecordDecrypt;
         #endif
 
         #ifdef BUILD_AESGCM
             case cyassl_aes_gcm:
-            {
-                byte additional[AEAD_AUTH_DATA_SZ];
-                byte nonce[AEAD_NONCE_SZ];
-
-                XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
-
-                /* sequence number field is 64-bits, we only use 32-bits */
-                c32toa(GetSEQIncrement(ssl, 1), additional + AEAD_SEQ_OFFSET);
-
-                #ifdef CYASSL_DTLS
-                    if (ssl->options.dtls)
-                        c16toa(ssl->keys.dtls_state.curEpoch, additional);
-                #endif
-
-                additional[AEAD_TYPE_OFFSET] = ssl->curRL.type;
-                additional[AEAD_VMAJ_OFFSET] = ssl->curRL.pvMajor;
-                additional[AEAD_VMIN_OFFSET] = ssl->curRL.pvMinor;
-
-                c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                                        additional + AEAD_LEN_OFFSET);
-                XMEMCPY(nonce, ssl->keys.aead_dec_imp_IV, AEAD_IMP_IV_SZ);
-                XMEMCPY(nonce + AEAD_IMP_IV_SZ, input, AEAD_EXP_IV_SZ);
-                if (AesGcmDecrypt(ssl->decrypt.aes,
-                            plain + AEAD_EXP_IV_SZ,
-                            input + AEAD_EXP_IV_SZ,
-                                sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                            nonce, AEAD_NONCE_SZ,
-                            input + sz - ssl->specs.aead_mac_size,
-                            ssl->specs.aead_mac_size,
-                            additional, AEAD_AUTH_DATA_SZ) < 0) {
-                    SendAlert(ssl, alert_fatal, bad_record_mac);
-                    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-                    return VERIFY_MAC_ERROR;
-                }
-                XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-            }
-            break;
+                return AesGcmAEADDecrypt;
         #endif
 
         #ifdef HAVE_AESCCM
             case cyassl_aes_ccm:
-            {
-                byte additional[AEAD_AUTH_DATA_SZ];
-                byte nonce[AEAD_NONCE_SZ];
-
-                XMEMSET(additional, 0, AEAD_AUTH_DATA_SZ);
-
-                /* sequence number field is 64-bits, we only use 32-bits */
-                c32toa(GetSEQIncrement(ssl, 1), additional + AEAD_SEQ_OFFSET);
-
-                #ifdef CYASSL_DTLS
-                    if (ssl->options.dtls)
-                        c16toa(ssl->keys.dtls_state.curEpoch, additional);
-                #endif
-
-                additional[AEAD_TYPE_OFFSET] = ssl->curRL.type;
-                additional[AEAD_VMAJ_OFFSET] = ssl->curRL.pvMajor;
-                additional[AEAD_VMIN_OFFSET] = ssl->curRL.pvMinor;
-
-                c16toa(sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                                        additional + AEAD_LEN_OFFSET);
-                XMEMCPY(nonce, ssl->keys.aead_dec_imp_IV, AEAD_IMP_IV_SZ);
-                XMEMCPY(nonce + AEAD_IMP_IV_SZ, input, AEAD_EXP_IV_SZ);
-                if (AesCcmDecrypt(ssl->decrypt.aes,
-                            plain + AEAD_EXP_IV_SZ,
-                            input + AEAD_EXP_IV_SZ,
-                                sz - AEAD_EXP_IV_SZ - ssl->specs.aead_mac_size,
-                            nonce, AEAD_NONCE_SZ,
-                            input + sz - ssl->specs.aead_mac_size,
-                            ssl->specs.aead_mac_size,
-                            additional, AEAD_AUTH_DATA_SZ) < 0) {
-                    SendAlert(ssl, alert_fatal, bad_record_mac);
-                    XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-                    return VERIFY_MAC_ERROR;
-                }
-                XMEMSET(nonce, 0, AEAD_NONCE_SZ);
-            }
-            break;
+                return AesCcmAEADDecrypt;
         #endif
 
         #ifdef HAVE_CAMELLIA
             case cyassl_camellia:
-                CamelliaCbcDecrypt(ssl->decrypt.cam, plain, input, sz);
-                break;
+                return CamelliaRecordDecrypt;
         #endif
 
         #ifdef HAVE_HC128
             case cyassl_hc128:
-                return Hc128_Process(ssl->decrypt.hc128, plain, input, sz);
+                return Hc128RecordDecrypt;
         #endif
 
         #ifdef BUILD_RABBIT
             case cyassl_rabbit:
-                return RabbitProcess(ssl->decrypt.rabbit, plain, input, sz);
+                return RabbitRecordDecrypt;
         #endif
 
         #ifdef HAVE_CHACHA
             case cyassl_chacha:
-                return ChachaAEADDecrypt(ssl, plain, input, sz);
+                return ChachaAEADDecrypt;
         #endif
 
         #ifdef HAVE_NULL_CIPHER
             case cyassl_cipher_null:
-                if (input != plain) {
-                    XMEMMOVE(plain, input, sz);
-                }
-                break;
+                return NullRecordProcess;
         #endif
 
             default:
-                CYASSL_MSG("CyaSSL Decrypt programming error");
-                return DECRYPT_ERROR;
+                return NULL;
     }
-    return 0;
+}
+
+
+/* pick the record functions for bulk, either side may be NULL */
+void SetCipherFuncs(Ciphers* enc, Ciphers* dec, int bulk)
+{
+    if (enc)
+        enc->process = EncryptFunc(bulk);
+    if (dec)
+        dec->process = DecryptFunc(bulk);
+}
+
+
+static INLINE int Encrypt(CYASSL* ssl, byte* out, const byte* input, word16 sz)
+{
+    cipherfp process;
+
+    if (ssl->encrypt.setup == 0) {
+        CYASSL_MSG("Encrypt ciphers not setup");
+        return ENCRYPT_ERROR;
+    }
+
+#ifdef HAVE_FUZZER
+    if (ssl->fuzzerCb)
+        ssl->fuzzerCb(ssl, input, sz, FUZZ_ENCRYPT, ssl->fuzzerCtx);
+#endif
+
+#ifdef CYASSL_RECORD_BULK
+    process = EncryptFunc(RECORD_BULK(ssl));    /* constant, a direct call */
+#else
+    process = ssl->encrypt.process;
+#endif
+    if (process == NULL) {
+        CYASSL_MSG("CyaSSL Encrypt programming error");
+        return ENCRYPT_ERROR;
+    }
+
+    return process(ssl, out, input, sz);
+}
+
+
+
+static INLINE int Decrypt(CYASSL* ssl, byte* plain, const byte* input,
+                           word16 sz)
+{
+    cipherfp process;
+
+    if (ssl->decrypt.setup == 0) {
+        CYASSL_MSG("Decrypt ciphers not setup");
+        return DECRYPT_ERROR;
+    }
+
+#ifdef CYASSL_RECORD_BULK
+    process = DecryptFunc(RECORD_BULK(ssl));    /* constant, a direct call */
+#else
+    process = ssl->decrypt.process;
+#endif
+    if (process == NULL) {
+        CYASSL_MSG("CyaSSL Decrypt programming error");
+        return DECRYPT_ERROR;
+    }
+
+    return process(ssl, plain, input, sz);
 }
 
 
@@ -6016,23 +9004,35 @@ static int SanityCheckCipherText(CYASSL* ssl, word32 encryptSz)
     word32 minLength = ssl->specs.hash_size; /* covers stream */
 #endif
 
-    if (ssl->specs.cipher_type == block) {
-        if (encryptSz % ssl->specs.block_size) {
-            CYASSL_MSG("Block ciphertext not block size");
-            return SANITY_CIPHER_E;
+    if (RECORD_TYPE(ssl) == block) {
+        word32 cipherSz = encryptSz;
+
+#ifdef HAVE_ENCRYPT_THEN_MAC
+        if (RECORD_ETM(ssl)) {
+            /* the mac follows a ciphertext of at least the pad byte's block */
+            cipherSz  -= min(encryptSz, minLength);
+            minLength += ssl->specs.block_size;
         }
+        else
+#endif
+        {
+            minLength++;  /* pad byte */
 
-        minLength++;  /* pad byte */
+            if (ssl->specs.block_size > minLength)
+                minLength = ssl->specs.block_size;
+        }
 
-        if (ssl->specs.block_size > minLength)
-            minLength = ssl->specs.block_size;
+        if (cipherSz % ssl->specs.block_size) {
+            CYASSL_MSG("Block ciphertext not block size");
+            return SANITY_CIPHER_E;
+        }
 
         if (ssl->options.tls1_1)
             minLength += ssl->specs.block_size;  /* explicit IV */
     }
-    else if (ssl->specs.cipher_type == aead) {
+    else if (RECORD_TYPE(ssl) == aead) {
         minLength = ssl->specs.aead_mac_size;    /* authTag size */
-        if (ssl->specs.bulk_cipher_algorithm != cyassl_chacha)
+        if (RECORD_BULK(ssl) != cyassl_chacha)
            minLength += AEAD_EXP_IV_SZ;          /* explicit IV  */
     }
 
@@ -6206,45 +9206,56 @@ static INLINE void CompressRounds(CYASSL* ssl, int rounds, const byte* dummy)
 }
 
 
+/* all ones when a < b, no branch, a and b are small non negative ints */
+static INLINE byte MaskLessThan(int a, int b)
+{
+    return (byte)(0 - ((word32)(a - b) >> 31));
+}
+
+
 /* check all length bytes for equality, return 0 on success */
 static int ConstantCompare(const byte* a, const byte* b, int length)
 {
-    int i;
-    int good = 0;
-    int bad  = 0;
+    int  i;
+    byte diff = 0;
 
-    for (i = 0; i < length; i++) {
-        if (a[i] == b[i])
-            good++;
-        else
-            bad++;
-    }
+    for (i = 0; i < length; i++)
+        diff |= a[i] ^ b[i];
 
-    if (good == length)
-        return 0;
-    else
-        return 0 - bad;  /* compare failed */
+    return 0 - (diff != 0);  /* compare failed */
 }
 
 
 /* check all length bytes for the pad value, return 0 on success */
 static int PadCheck(const byte* input, byte pad, int length)
 {
-    int i;
-    int good = 0;
-    int bad  = 0;
+    int  i;
+    byte diff = 0;
 
-    for (i = 0; i < length; i++) {
-        if (input[i] == pad)
-            good++;
-        else
-            bad++;
-    }
+    for (i = 0; i < length; i++)
+        diff |= input[i] ^ pad;
 
-    if (good == length)
-        return 0;
-    else
-        return 0 - bad;  /* pad check failed */
+    return 0 - (diff != 0);  /* pad check failed */
+}
+
+
+/* one pass over the last MAX_PAD_SIZE bytes of the pLen byte record (all of
+   it if shorter), the same work whatever padLen is, all ones when the
+   padLen + 1 bytes at the end all hold padLen */
+static byte TimingPadCheck(const byte* input, int pLen, int padLen)
+{
+    int  i;
+    int  checkSz = (int)min((word32)pLen, MAX_PAD_SIZE);
+    byte bad;
+
+    /* a pad longer than what we looked at can't be right */
+    bad = MaskLessThan(checkSz, padLen + 1);
+
+    for (i = 0; i < checkSz; i++)
+        bad |= MaskLessThan(i, padLen + 1) &
+               (input[pLen - 1 - i] ^ (byte)padLen);
+
+    return (byte)~(0 - (word32)(bad != 0));
 }
 
 
@@ -6275,46 +9286,35 @@ static INLINE int GetRounds(int pLen, int padLen, int t)
 }
 
 
-/* timing resistant pad/verify check, return 0 on success */
+/* timing resistant pad/verify check, return 0 on success, a bad pad or too
+   short a record runs the same single pad pass, mac and compare as a good
+   one, only with the pad taken as zero */
 static int TimingPadVerify(CYASSL* ssl, const byte* input, int padLen, int t,
                            int pLen, int content)
 {
     byte verify[MAX_DIGEST_SIZE];
-    byte dummy[MAX_PAD_SIZE];
-    int  ret = 0;
+    byte dummy[COMPRESS_DUMMY_SIZE];
+    byte good;
+    int  ret;
 
     XMEMSET(dummy, 1, sizeof(dummy));
 
-    if ( (t + padLen + 1) > pLen) {
-        CYASSL_MSG("Plain Len not long enough for pad/mac");
-        PadCheck(dummy, (byte)padLen, MAX_PAD_SIZE);
-        ssl->hmac(ssl, verify, input, pLen - t, content, 1); /* still compare */
-        ConstantCompare(verify, input + pLen - t, t);
-
-        return VERIFY_MAC_ERROR;
-    }
-
-    if (PadCheck(input + pLen - (padLen + 1), (byte)padLen, padLen + 1) != 0) {
-        CYASSL_MSG("PadCheck failed");
-        PadCheck(dummy, (byte)padLen, MAX_PAD_SIZE - padLen - 1);
-        ssl->hmac(ssl, verify, input, pLen - t, content, 1); /* still compare */
-        ConstantCompare(verify, input + pLen - t, t);
+    good  = (byte)~MaskLessThan(pLen, t + padLen + 1);  /* room for mac+pad */
+    good &= TimingPadCheck(input, pLen, padLen);
+    padLen &= good;
 
-        return VERIFY_MAC_ERROR;
-    }
-
-    PadCheck(dummy, (byte)padLen, MAX_PAD_SIZE - padLen - 1);
     ret = ssl->hmac(ssl, verify, input, pLen - padLen - 1 - t, content, 1);
 
     CompressRounds(ssl, GetRounds(pLen, padLen, t), dummy);
 
-    if (ConstantCompare(verify, input + (pLen - padLen - 1 - t), t) != 0) {
-        CYASSL_MSG("Verify MAC compare failed");
+    if (ConstantCompare(verify, input + (pLen - padLen - 1 - t), t) != 0)
+        good = 0;
+
+    if (ret != 0 || good != 0xff) {
+        CYASSL_MSG("Pad check or verify MAC compare failed");
         return VERIFY_MAC_ERROR;
     }
 
-    if (ret != 0)
-        return VERIFY_MAC_ERROR;
     return 0;
 }
 
@@ -6329,19 +9329,26 @@ int DoApplicationData(CYASSL* ssl, byte* input, word32* inOutIdx)
 #ifdef HAVE_LIBZ
     byte   decomp[MAX_RECORD_SIZE + MAX_COMP_EXTRA];
 #endif
+#ifdef HAVE_SECURE_RENEGOTIATION
+    int    hold = 0;
+#endif
 
-    if (ssl->options.handShakeDone == 0) {
+    /* a false start client may write right behind its verified Finished */
+    if (ssl->options.handShakeDone == 0 &&
+            !(ssl->options.side == CYASSL_SERVER_END &&
+              !ssl->options.resuming &&
+              ssl->options.clientState == CLIENT_FINISHED_COMPLETE)) {
         CYASSL_MSG("Received App data before a handshake completed");
         SendAlert(ssl, alert_fatal, unexpected_message);
         return OUT_OF_ORDER_E;
     }
 
-    if (ssl->specs.cipher_type == block) {
+    if (RECORD_TYPE(ssl) == block) {
         if (ssl->options.tls1_1)
             ivExtra = ssl->specs.block_size;
     }
-    else if (ssl->specs.cipher_type == aead) {
-        if (ssl->specs.bulk_cipher_algorithm != cyassl_chacha)
+    else if (RECORD_TYPE(ssl) == aead) {
+        if (RECORD_BULK(ssl) != cyassl_chacha)
             ivExtra = AEAD_EXP_IV_SZ;
     }
 
@@ -6363,8 +9370,16 @@ int DoApplicationData(CYASSL* ssl, byte* input, word32* inOutIdx)
 #endif
         idx += rawSz;
 
-        ssl->buffers.clearOutputBuffer.buffer = rawData;
-        ssl->buffers.clearOutputBuffer.length = dataSz;
+    #ifdef HAVE_SECURE_RENEGOTIATION
+        if (ssl->options.handShakeDone &&
+                          ssl->options.handShakeState != HANDSHAKE_DONE)
+            hold = 1;   /* copied out below, once decompressed */
+        else
+    #endif
+        {
+            ssl->buffers.clearOutputBuffer.buffer = rawData;
+            ssl->buffers.clearOutputBuffer.length = dataSz;
+        }
     }
 
     idx += ssl->keys.padSz;
@@ -6375,11 +9390,57 @@ int DoApplicationData(CYASSL* ssl, byte* input, word32* inOutIdx)
         XMEMMOVE(rawData, decomp, dataSz);
 #endif
 
+#ifdef HAVE_SECURE_RENEGOTIATION
+    /* the renegotiation reads on past it in the input buffer */
+    if (hold) {
+        int ret = HoldAppData(ssl, rawData, dataSz);
+        if (ret != 0)
+            return ret;
+    }
+#endif
+
     *inOutIdx = idx;
     return 0;
 }
 
 
+#ifdef HAVE_SECURE_RENEGOTIATION
+
+/* Copy app data that came in during a renegotiation out of the input buffer,
+   behind what clearOutputBuffer still has unread, which then points at the
+   copy. The buffer is kept for the next renegotiation */
+int HoldAppData(CYASSL* ssl, const byte* data, word32 sz)
+{
+    buffer* held    = &ssl->buffers.renegData;
+    buffer* clear   = &ssl->buffers.clearOutputBuffer;
+    word32  total   = clear->length + sz;
+
+    if (total > held->length) {
+        byte* grown = (byte*)XMALLOC(total, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+        if (grown == NULL)
+            return MEMORY_E;
+
+        if (clear->length > 0)
+            XMEMCPY(grown, clear->buffer, clear->length);
+        XFREE(held->buffer, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+        held->buffer = grown;
+        held->length = total;
+    }
+    else if (clear->length > 0 && clear->buffer != held->buffer)
+        XMEMMOVE(held->buffer, clear->buffer, clear->length);
+
+    if (sz > 0)
+        XMEMCPY(held->buffer + clear->length, data, sz);
+
+    clear->buffer = held->buffer;
+    clear->length = total;
+
+    return 0;
+}
+
+#endif /* HAVE_SECURE_RENEGOTIATION */
+
+
 /* process alert, return level */
 static int DoAlert(CYASSL* ssl, byte* input, word32* inOutIdx, int* type,
                    word32 totalSz)
@@ -6405,6 +9466,7 @@ static int DoAlert(CYASSL* ssl, byte* input, word32* inOutIdx, int* type,
     ssl->alert_history.last_rx.code = code;
     ssl->alert_history.last_rx.level = level;
     *type = code;
+    CYASSL_STAT_ALERT(alertsIn, code);
     if (level == alert_fatal) {
         ssl->options.isClosed = 1;  /* Don't send close_notify */
     }
@@ -6425,6 +9487,25 @@ static int DoAlert(CYASSL* ssl, byte* input, word32* inOutIdx, int* type,
     return level;
 }
 
+/* read ahead buffer size, datagrams are read whole already */
+static INLINE int ReadAheadSz(CYASSL* ssl)
+{
+    if (ssl->options.dtls)
+        return 0;
+
+#ifdef HAVE_MAX_FRAGMENT
+    /* as many records as at full size, a smaller negotiated fragment length
+       needs less room for them */
+    if (ssl->buffers.readAhead && ssl->max_fragment < MAX_RECORD_SIZE)
+        return (int)(ssl->buffers.readAhead / READ_AHEAD_SZ *
+                     (RECORD_HEADER_SZ + ssl->max_fragment + COMP_EXTRA +
+                      MAX_MSG_EXTRA));
+#endif
+
+    return (int)ssl->buffers.readAhead;
+}
+
+
 static int GetInputData(CYASSL *ssl, word32 size)
 {
     int in;
@@ -6432,6 +9513,7 @@ static int GetInputData(CYASSL *ssl, word32 size)
     int maxLength;
     int usedLength;
     int dtlsExtra = 0;
+    int readAhead = ReadAheadSz(ssl);
 
 
     /* check max input length */
@@ -6439,6 +9521,14 @@ static int GetInputData(CYASSL *ssl, word32 size)
     maxLength  = ssl->buffers.inputBuffer.bufferSize - usedLength;
     inSz       = (int)(size - usedLength);      /* from last partial read */
 
+    /* memory IO, everything there is was fed in already */
+    if (ssl->options.memIO)
+        return inSz <= 0 ? 0 : WANT_READ;
+
+    /* read ahead may already have it all */
+    if (readAhead && inSz <= 0)
+        return 0;
+
 #ifdef CYASSL_DTLS
     if (ssl->options.dtls) {
         if (size < ssl->dtls_expected_rx)
@@ -6448,42 +9538,72 @@ static int GetInputData(CYASSL *ssl, word32 size)
 #endif
 
     if (inSz > maxLength) {
-        if (GrowInputBuffer(ssl, size + dtlsExtra, usedLength) < 0)
+        int growSz = size + dtlsExtra;
+
+        if (growSz < readAhead)
+            growSz = readAhead;
+        if (GrowInputBuffer(ssl, growSz, usedLength) < 0)
+            return MEMORY_E;
+    }
+    else if (readAhead &&
+                  (int)ssl->buffers.inputBuffer.bufferSize < readAhead) {
+        /* room for whole records, not just the next header */
+        if (GrowInputBuffer(ssl, readAhead, usedLength) < 0)
             return MEMORY_E;
     }
 
     if (inSz <= 0)
         return BUFFER_ERROR;
 
-    /* Put buffer data at start if not there */
-    if (usedLength > 0 && ssl->buffers.inputBuffer.idx != 0)
-        XMEMMOVE(ssl->buffers.inputBuffer.buffer,
-                ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.idx,
-                usedLength);
+    /* Put buffer data at start if not there, with read ahead only once the
+       rest of the record no longer fits behind it */
+    if (usedLength == 0 || !readAhead ||
+            (int)(ssl->buffers.inputBuffer.bufferSize -
+                  ssl->buffers.inputBuffer.length) < inSz) {
+        if (usedLength > 0 && ssl->buffers.inputBuffer.idx != 0)
+            XMEMMOVE(ssl->buffers.inputBuffer.buffer,
+                    ssl->buffers.inputBuffer.buffer +
+                    ssl->buffers.inputBuffer.idx, usedLength);
 
-    /* remove processed data */
-    ssl->buffers.inputBuffer.idx    = 0;
-    ssl->buffers.inputBuffer.length = usedLength;
+        /* remove processed data */
+        ssl->buffers.inputBuffer.idx    = 0;
+        ssl->buffers.inputBuffer.length = usedLength;
+    }
 
     /* read data from network */
     do {
+        int want = inSz;
+
+        /* with read ahead take all the buffer holds, saving a recv per
+           record and per header */
+        if (readAhead)
+            want = ssl->buffers.inputBuffer.bufferSize -
+                   ssl->buffers.inputBuffer.length;
+
         in = Receive(ssl,
                      ssl->buffers.inputBuffer.buffer +
                      ssl->buffers.inputBuffer.length,
-                     inSz);
+                     want);
         if (in == -1)
             return SOCKET_ERROR_E;
 
-        if (in == WANT_READ)
+        if (in == WANT_READ) {
+            /* an idle connection doesn't keep a read ahead buffer */
+            if (readAhead && ssl->buffers.inputBuffer.dynamicFlag &&
+                             ssl->buffers.inputBuffer.length ==
+                                               ssl->buffers.inputBuffer.idx)
+                ShrinkInputBuffer(ssl, NO_FORCED_FREE);
             return WANT_READ;
+        }
 
-        if (in > inSz)
+        if (in > want)
             return RECV_OVERFLOW_E;
 
         ssl->buffers.inputBuffer.length += in;
         inSz -= in;
 
-    } while (ssl->buffers.inputBuffer.length < size);
+    } while (ssl->buffers.inputBuffer.length - ssl->buffers.inputBuffer.idx <
+                                                                         size);
 
     return 0;
 }
@@ -6504,7 +9624,7 @@ static INLINE int VerifyMac(CYASSL* ssl, const byte* input, word32 msgSz,
 #endif
     byte   verify[MAX_DIGEST_SIZE];
 
-    if (ssl->specs.cipher_type == block) {
+    if (RECORD_TYPE(ssl) == block) {
         if (ssl->options.tls1_1)
             ivExtra = ssl->specs.block_size;
         pad = *(input + msgSz - ivExtra - 1);
@@ -6538,7 +9658,7 @@ static INLINE int VerifyMac(CYASSL* ssl, const byte* input, word32 msgSz,
                 return VERIFY_MAC_ERROR;
         }
     }
-    else if (ssl->specs.cipher_type == stream) {
+    else if (RECORD_TYPE(ssl) == stream) {
         ret = ssl->hmac(ssl, verify, input, msgSz - digestSz, content, 1);
         if (ConstantCompare(verify, input + msgSz - digestSz, digestSz) != 0){
             return VERIFY_MAC_ERROR;
@@ -6547,7 +9667,7 @@ static INLINE int VerifyMac(CYASSL* ssl, const byte* input, word32 msgSz,
             return VERIFY_MAC_ERROR;
     }
 
-    if (ssl->specs.cipher_type == aead) {
+    if (RECORD_TYPE(ssl) == aead) {
         *padSz = ssl->specs.aead_mac_size;
     }
     else {
@@ -6558,6 +9678,51 @@ static INLINE int VerifyMac(CYASSL* ssl, const byte* input, word32 msgSz,
 }
 
 
+#ifdef HAVE_ENCRYPT_THEN_MAC
+
+/* RFC 7366 record, the mac covers the iv and ciphertext so it is checked
+   before anything is decrypted, a record that verifies came from the peer
+   and its pad can be read plainly without the timing resistant passes */
+static int DecryptEtM(CYASSL* ssl, byte* input, word32 sz, int content,
+                      word32* padSz)
+{
+#ifdef HAVE_TRUNCATED_HMAC
+    word32 digestSz = ssl->truncated_hmac ? TRUNCATED_HMAC_SZ
+                                          : ssl->specs.hash_size;
+#else
+    word32 digestSz = ssl->specs.hash_size;
+#endif
+    word32 cipherSz = sz - digestSz;  /* sanity checked */
+    word32 ivExtra  = ssl->options.tls1_1 ? ssl->specs.block_size : 0;
+    word32 pad;
+    byte   verify[MAX_DIGEST_SIZE];
+    int    ret;
+
+    ret = ssl->hmac(ssl, verify, input, cipherSz, content, 1);
+    if (ret != 0 || ConstantCompare(verify, input + cipherSz, digestSz) != 0) {
+        CYASSL_MSG("Encrypt-then-MAC verify failed");
+        return VERIFY_MAC_ERROR;
+    }
+
+    ret = Decrypt(ssl, input, input, cipherSz);
+    if (ret != 0)
+        return ret;
+
+    pad = input[cipherSz - 1];
+    if (pad + 1 > cipherSz - ivExtra ||
+                     PadCheck(input + cipherSz - pad - 1, (byte)pad, pad) != 0) {
+        CYASSL_MSG("Encrypt-then-MAC bad pad");
+        return VERIFY_MAC_ERROR;
+    }
+
+    *padSz = digestSz + pad + 1;
+
+    return 0;
+}
+
+#endif /* HAVE_ENCRYPT_THEN_MAC */
+
+
 /* process input requests, return 0 is done, 1 is call again to complete, and
    negative number is error */
 int ProcessReply(CYASSL* ssl)
@@ -6574,7 +9739,11 @@ int ProcessReply(CYASSL* ssl)
         atomicUser = 1;
 #endif
 
-    if (ssl->error != 0 && ssl->error != WANT_READ && ssl->error != WANT_WRITE){
+    if (ssl->error != 0 && ssl->error != WANT_READ && ssl->error != WANT_WRITE
+                        && ssl->error != WANT_ASYNC
+                        && ssl->error != WANT_CLIENT_HELLO
+                        && ssl->error != OCSP_WANT_READ
+                        && ssl->error != OCSP_WANT_WRITE) {
         CYASSL_MSG("ProcessReply retry in error state, not allowed");
         return ssl->error;
     }
@@ -6669,6 +9838,8 @@ int ProcessReply(CYASSL* ssl)
                                         ssl->buffers.inputBuffer.length -
                                         ssl->buffers.inputBuffer.idx,
                                         ssl->curSize);
+            if (ret == 0 && !ssl->options.resuming)
+                ret = SSL_CtxAdmitHandshake(ssl);
             if (ret < 0)
                 return ret;
 
@@ -6735,6 +9906,18 @@ int ProcessReply(CYASSL* ssl)
                 if (ret < 0)
                     return ret;
 
+            #ifdef HAVE_ENCRYPT_THEN_MAC
+                if (RECORD_ETM(ssl)) {
+                    ret = DecryptEtM(ssl, ssl->buffers.inputBuffer.buffer +
+                                     ssl->buffers.inputBuffer.idx,
+                                     ssl->curSize, ssl->curRL.type,
+                                     &ssl->keys.padSz);
+                    if (ssl->options.tls1_1)
+                        ssl->buffers.inputBuffer.idx += ssl->specs.block_size;
+                        /* go past TLSv1.1 IV */
+                }
+                else
+            #endif
                 if (atomicUser) {
                 #ifdef ATOMIC_USER
                     ret = ssl->ctx->DecryptVerifyCb(ssl,
@@ -6744,11 +9927,11 @@ int ProcessReply(CYASSL* ssl)
                                   ssl->buffers.inputBuffer.idx,
                                   ssl->curSize, ssl->curRL.type, 1,
                                   &ssl->keys.padSz, ssl->DecryptVerifyCtx);
-                    if (ssl->options.tls1_1 && ssl->specs.cipher_type == block)
+                    if (ssl->options.tls1_1 && RECORD_TYPE(ssl) == block)
                         ssl->buffers.inputBuffer.idx += ssl->specs.block_size;
                         /* go past TLSv1.1 IV */
-                    if (ssl->specs.cipher_type == aead &&
-                            ssl->specs.bulk_cipher_algorithm != cyassl_chacha)
+                    if (RECORD_TYPE(ssl) == aead &&
+                            RECORD_BULK(ssl) != cyassl_chacha)
                         ssl->buffers.inputBuffer.idx += AEAD_EXP_IV_SZ;
                 #endif /* ATOMIC_USER */
                 }
@@ -6762,11 +9945,11 @@ int ProcessReply(CYASSL* ssl)
                         CYASSL_ERROR(ret);
                         return DECRYPT_ERROR;
                     }
-                    if (ssl->options.tls1_1 && ssl->specs.cipher_type == block)
+                    if (ssl->options.tls1_1 && RECORD_TYPE(ssl) == block)
                         ssl->buffers.inputBuffer.idx += ssl->specs.block_size;
                         /* go past TLSv1.1 IV */
-                    if (ssl->specs.cipher_type == aead &&
-                            ssl->specs.bulk_cipher_algorithm != cyassl_chacha)
+                    if (RECORD_TYPE(ssl) == aead &&
+                            RECORD_BULK(ssl) != cyassl_chacha)
                         ssl->buffers.inputBuffer.idx += AEAD_EXP_IV_SZ;
 
                     ret = VerifyMac(ssl, ssl->buffers.inputBuffer.buffer +
@@ -6867,9 +10050,16 @@ int ProcessReply(CYASSL* ssl)
 
                     #ifdef CYASSL_DTLS
                         if (ssl->options.dtls) {
+                            DtlsState* state = &ssl->keys.dtls_state;
+
                             DtlsPoolReset(ssl);
-                            ssl->keys.dtls_state.nextEpoch++;
-                            ssl->keys.dtls_state.nextSeq = 0;
+                            /* old epoch keeps its window for stragglers */
+                            XMEMCPY(state->prevWindow, state->window,
+                                                      sizeof(state->window));
+                            XMEMSET(state->window, 0, sizeof(state->window));
+                            state->prevSeq = state->nextSeq;
+                            state->nextEpoch++;
+                            state->nextSeq = 0;
                         }
                     #endif
 
@@ -6880,10 +10070,12 @@ int ProcessReply(CYASSL* ssl)
                     #endif
                     if (ssl->options.resuming && ssl->options.side ==
                                                               CYASSL_CLIENT_END)
-                        ret = BuildFinished(ssl, &ssl->verifyHashes, server);
+                        ret = BuildFinished(ssl,
+                                        &ssl->hsHashes->verifyHashes, server);
                     else if (!ssl->options.resuming && ssl->options.side ==
                                                               CYASSL_SERVER_END)
-                        ret = BuildFinished(ssl, &ssl->verifyHashes, client);
+                        ret = BuildFinished(ssl,
+                                        &ssl->hsHashes->verifyHashes, client);
                     if (ret != 0)
                         return ret;
                     break;
@@ -6924,6 +10116,16 @@ int ProcessReply(CYASSL* ssl)
 
             ssl->options.processReply = doProcessInit;
 
+        #ifdef CYASSL_RECORD_POOL
+            /* nothing in flight, give the record buffer back */
+            if (ssl->buffers.inputBuffer.dynamicFlag &&
+                    ssl->buffers.inputBuffer.idx ==
+                                           ssl->buffers.inputBuffer.length &&
+                    ssl->buffers.clearOutputBuffer.length == 0 &&
+                    !ReadAheadSz(ssl))
+                ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+        #endif
+
             /* input exhausted? */
             if (ssl->buffers.inputBuffer.idx == ssl->buffers.inputBuffer.length)
                 return 0;
@@ -6948,6 +10150,11 @@ int ProcessReply(CYASSL* ssl)
             }
             /* more records */
             else {
+                /* read ahead can hold a record past this one, leave it until
+                   the caller has the plaintext still in the input buffer */
+                if (ssl->buffers.clearOutputBuffer.length > 0)
+                    return 0;
+
                 CYASSL_MSG("More records in input");
                 ssl->options.processReply = doProcessInit;
                 continue;
@@ -7027,7 +10234,7 @@ int SendChangeCipher(CYASSL* ssl)
     }
     #endif
     else
-        return SendBuffered(ssl);
+        return SendFlightPart(ssl);
 }
 
 
@@ -7101,16 +10308,16 @@ static void BuildMD5_CertVerify(CYASSL* ssl, byte* digest)
     byte md5_result[MD5_DIGEST_SIZE];
 
     /* make md5 inner */
-    Md5Update(&ssl->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
-    Md5Update(&ssl->hashMd5, PAD1, PAD_MD5);
-    Md5Final(&ssl->hashMd5, md5_result);
+    Md5Update(&ssl->hsHashes->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
+    Md5Update(&ssl->hsHashes->hashMd5, PAD1, PAD_MD5);
+    Md5Final(&ssl->hsHashes->hashMd5, md5_result);
 
     /* make md5 outer */
-    Md5Update(&ssl->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
-    Md5Update(&ssl->hashMd5, PAD2, PAD_MD5);
-    Md5Update(&ssl->hashMd5, md5_result, MD5_DIGEST_SIZE);
+    Md5Update(&ssl->hsHashes->hashMd5, ssl->arrays->masterSecret, SECRET_LEN);
+    Md5Update(&ssl->hsHashes->hashMd5, PAD2, PAD_MD5);
+    Md5Update(&ssl->hsHashes->hashMd5, md5_result, MD5_DIGEST_SIZE);
 
-    Md5Final(&ssl->hashMd5, digest);
+    Md5Final(&ssl->hsHashes->hashMd5, digest);
 }
 
 
@@ -7119,16 +10326,16 @@ static void BuildSHA_CertVerify(CYASSL* ssl, byte* digest)
     byte sha_result[SHA_DIGEST_SIZE];
 
     /* make sha inner */
-    ShaUpdate(&ssl->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
-    ShaUpdate(&ssl->hashSha, PAD1, PAD_SHA);
-    ShaFinal(&ssl->hashSha, sha_result);
+    ShaUpdate(&ssl->hsHashes->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
+    ShaUpdate(&ssl->hsHashes->hashSha, PAD1, PAD_SHA);
+    ShaFinal(&ssl->hsHashes->hashSha, sha_result);
 
     /* make sha outer */
-    ShaUpdate(&ssl->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
-    ShaUpdate(&ssl->hashSha, PAD2, PAD_SHA);
-    ShaUpdate(&ssl->hashSha, sha_result, SHA_DIGEST_SIZE);
+    ShaUpdate(&ssl->hsHashes->hashSha, ssl->arrays->masterSecret, SECRET_LEN);
+    ShaUpdate(&ssl->hsHashes->hashSha, PAD2, PAD_SHA);
+    ShaUpdate(&ssl->hsHashes->hashSha, sha_result, SHA_DIGEST_SIZE);
 
-    ShaFinal(&ssl->hashSha, digest);
+    ShaFinal(&ssl->hsHashes->hashSha, digest);
 }
 #endif /* NO_CERTS */
 #endif /* NO_OLD_TLS */
@@ -7140,35 +10347,44 @@ static int BuildCertHashes(CYASSL* ssl, Hashes* hashes)
 {
     /* store current states, building requires get_digest which resets state */
     #ifndef NO_OLD_TLS
-    Md5 md5 = ssl->hashMd5;
-    Sha sha = ssl->hashSha;
+    Md5 md5 = ssl->hsHashes->hashMd5;
+    Sha sha = ssl->hsHashes->hashSha;
     #endif
     #ifndef NO_SHA256
-        Sha256 sha256 = ssl->hashSha256;
+        Sha256 sha256 = ssl->hsHashes->hashSha256;
     #endif
     #ifdef CYASSL_SHA384
-        Sha384 sha384 = ssl->hashSha384;
+        Sha384 sha384 = ssl->hsHashes->hashSha384;
     #endif
 
     if (ssl->options.tls) {
+        byte mask = ssl->hsHashes->hashMask;
+
 #if ! defined( NO_OLD_TLS )
-        Md5Final(&ssl->hashMd5, hashes->md5);
-        ShaFinal(&ssl->hashSha, hashes->sha);
+        if (mask & HS_HASH_MD5)
+            Md5Final(&ssl->hsHashes->hashMd5, hashes->md5);
+        if (mask & HS_HASH_SHA)
+            ShaFinal(&ssl->hsHashes->hashSha, hashes->sha);
 #endif
         if (IsAtLeastTLSv1_2(ssl)) {
             int ret;
 
             #ifndef NO_SHA256
-                ret = Sha256Final(&ssl->hashSha256, hashes->sha256);
+            if (mask & HS_HASH_SHA256) {
+                ret = Sha256Final(&ssl->hsHashes->hashSha256, hashes->sha256);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef CYASSL_SHA384
-                ret = Sha384Final(&ssl->hashSha384, hashes->sha384);
+            if (mask & HS_HASH_SHA384) {
+                ret = Sha384Final(&ssl->hsHashes->hashSha384, hashes->sha384);
                 if (ret != 0)
                     return ret;
+            }
             #endif
         }
+        (void)mask;
     }
 #if ! defined( NO_OLD_TLS )
     else {
@@ -7177,15 +10393,15 @@ static int BuildCertHashes(CYASSL* ssl, Hashes* hashes)
     }
 
     /* restore */
-    ssl->hashMd5 = md5;
-    ssl->hashSha = sha;
+    ssl->hsHashes->hashMd5 = md5;
+    ssl->hsHashes->hashSha = sha;
 #endif
     if (IsAtLeastTLSv1_2(ssl)) {
         #ifndef NO_SHA256
-            ssl->hashSha256 = sha256;
+            ssl->hsHashes->hashSha256 = sha256;
         #endif
         #ifdef CYASSL_SHA384
-            ssl->hashSha384 = sha384;
+            ssl->hsHashes->hashSha384 = sha384;
         #endif
     }
 
@@ -7195,8 +10411,89 @@ static int BuildCertHashes(CYASSL* ssl, Hashes* hashes)
 #endif /* CYASSL_LEANPSK */
 
 /* Build SSL Message, encrypted */
+#if defined(BUILD_AES) && !defined(NO_TLS) && !defined(HAVE_FUZZER)
+
+#ifndef CYASSL_STITCH_CHUNK_SZ
+    #define CYASSL_STITCH_CHUNK_SZ 1024    /* multiple of AES and SHA blocks */
+#endif
+
+/* TLS MAC then AES-CBC encrypt in one pass over the record, each chunk is
+   hashed and its whole blocks encrypted while still hot in L1 instead of
+   walking the record once for TLS_hmac() and again for Encrypt(), output
+   has the header, explicit IV, inSz of plaintext, room for the digest and
+   the pad already set, encryption covers size bytes after the header */
+static int StitchedMacEncrypt(CYASSL* ssl, byte* output, word32 headerSz,
+                              word32 ivSz, word32 inSz, word32 digestSz,
+                              word32 size, int type)
+{
+    Hmac   hmac;
+    byte   inner[CYASSL_TLS_HMAC_INNER_SZ];
+    byte   digest[MAX_DIGEST_SIZE];
+    byte*  plain = output + headerSz + ivSz;
+    byte*  enc   = output + headerSz;
+    word32 hashed = 0;     /* plaintext through the MAC */
+    word32 encSz  = 0;     /* bytes from enc already encrypted */
+    int    ret;
+
+    if (ssl->encrypt.setup == 0) {
+        CYASSL_MSG("Encrypt ciphers not setup");
+        return ENCRYPT_ERROR;
+    }
+
+    CyaSSL_SetTlsHmacInner(ssl, inner, inSz, type, 0);
+
+    ret = TLS_hmacKey(ssl, &hmac, 0);
+    if (ret == 0)
+        ret = HmacUpdate(&hmac, inner, sizeof(inner));
+
+    while (ret == 0 && hashed < inSz) {
+        word32 chunk = min(CYASSL_STITCH_CHUNK_SZ, inSz - hashed);
+        word32 ready;
+
+        ret = HmacUpdate(&hmac, plain + hashed, chunk);
+        hashed += chunk;
+
+        /* whole cipher blocks with every plaintext byte already MACed */
+        ready = (ivSz + hashed) / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+        if (ret == 0 && ready > encSz) {
+            ret = AesCbcEncrypt(ssl->encrypt.aes, enc + encSz, enc + encSz,
+                                ready - encSz);
+            encSz = ready;
+        }
+    }
+
+    if (ret == 0)
+        ret = HmacFinal(&hmac, digest);
+    if (ret == 0) {
+        XMEMCPY(plain + inSz, digest, digestSz);   /* may be truncated */
+        ret = AesCbcEncrypt(ssl->encrypt.aes, enc + encSz, enc + encSz,
+                            size - encSz);
+    }
+
+    XMEMSET(digest, 0, sizeof(digest));
+
+    return ret;
+}
+
+#endif /* BUILD_AES && !NO_TLS && !HAVE_FUZZER */
+
+
 static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
                         const byte* input, int inSz, int type)
+{
+    DataVec in;
+
+    in.buffer = input;
+    in.length = inSz;
+
+    return BuildMessageV(ssl, output, outSz, &in, 0, inSz, type);
+}
+
+
+/* build record from inSz bytes of the in fragments starting inOff bytes into
+   the first one, caller makes sure the fragments hold that much */
+static int BuildMessageV(CYASSL* ssl, byte* output, int outSz,
+                         const DataVec* in, word32 inOff, int inSz, int type)
 {
 #ifdef HAVE_TRUNCATED_HMAC
     word32 digestSz = min(ssl->specs.hash_size,
@@ -7213,6 +10510,7 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
     byte               iv[AES_BLOCK_SIZE];                  /* max size */
     int ret        = 0;
     int atomicUser = 0;
+    int etm        = 0;   /* RFC 7366, mac goes after the padded ciphertext */
 
 #ifdef CYASSL_DTLS
     if (ssl->options.dtls) {
@@ -7227,7 +10525,11 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
         atomicUser = 1;
 #endif
 
-    if (ssl->specs.cipher_type == block) {
+#ifdef HAVE_ENCRYPT_THEN_MAC
+    etm = RECORD_ETM(ssl);
+#endif
+
+    if (RECORD_TYPE(ssl) == block) {
         word32 blockSz = ssl->specs.block_size;
         if (ssl->options.tls1_1) {
             ivSz = blockSz;
@@ -7242,14 +10544,14 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
 
         }
         sz += 1;       /* pad byte */
-        pad = (sz - headerSz) % blockSz;
+        pad = (sz - headerSz - (etm ? digestSz : 0)) % blockSz;
         pad = blockSz - pad;
         sz += pad;
     }
 
 #ifdef HAVE_AEAD
-    if (ssl->specs.cipher_type == aead) {
-        if (ssl->specs.bulk_cipher_algorithm != cyassl_chacha)
+    if (RECORD_TYPE(ssl) == aead) {
+        if (RECORD_BULK(ssl) != cyassl_chacha)
             ivSz = AEAD_EXP_IV_SZ;
 
         sz += (ivSz + ssl->specs.aead_mac_size - digestSz);
@@ -7262,13 +10564,19 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
     }
     size = (word16)(sz - headerSz);    /* include mac and digest */
     AddRecordHeader(output, size, (byte)type, ssl);
+    CYASSL_STAT_INC(recordsOut);
 
     /* write to output */
     if (ivSz) {
         XMEMCPY(output + idx, iv, min(ivSz, sizeof(iv)));
         idx += ivSz;
     }
-    XMEMCPY(output + idx, input, inSz);
+    for (i = 0; i < (word32)inSz; in++, inOff = 0) {
+        word32 chunk = min(in->length - inOff, inSz - i);
+
+        XMEMCPY(output + idx + i, in->buffer + inOff, chunk);
+        i += chunk;
+    }
     idx += inSz;
 
     if (type == handshake) {
@@ -7277,14 +10585,27 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
             return ret;
     }
 
-    if (ssl->specs.cipher_type == block) {
-        word32 tmpIdx = idx + digestSz;
+    if (RECORD_TYPE(ssl) == block) {
+        word32 tmpIdx = idx + (etm ? 0 : digestSz);
 
         for (i = 0; i <= pad; i++)
             output[tmpIdx++] = (byte)pad; /* pad byte gets pad value too */
     }
 
-    if (atomicUser) {   /* User Record Layer Callback handling */
+    if (etm) {
+        word32 cipherSz = size - digestSz;
+        byte   mac[MAX_DIGEST_SIZE];
+
+        if ( (ret = Encrypt(ssl, output + headerSz, output + headerSz,
+                            cipherSz)) != 0)
+            return ret;
+
+        ret = ssl->hmac(ssl, mac, output + headerSz, cipherSz, type, 0);
+        if (ret != 0)
+            return ret;
+        XMEMCPY(output + headerSz + cipherSz, mac, digestSz);
+    }
+    else if (atomicUser) {   /* User Record Layer Callback handling */
 #ifdef ATOMIC_USER
         if ( (ret = ssl->ctx->MacEncryptCb(ssl, output + idx,
                         output + headerSz + ivSz, inSz, type, 0,
@@ -7293,8 +10614,16 @@ static int BuildMessage(CYASSL* ssl, byte* output, int outSz,
             return ret;
 #endif
     }
+#if defined(BUILD_AES) && !defined(NO_TLS) && !defined(HAVE_FUZZER)
+    else if (RECORD_BULK(ssl) == cyassl_aes &&
+                                                     ssl->hmac == TLS_hmac) {
+        if ( (ret = StitchedMacEncrypt(ssl, output, headerSz, ivSz, inSz,
+                                       digestSz, size, type)) != 0)
+            return ret;
+    }
+#endif
     else {
-        if (ssl->specs.cipher_type != aead) {
+        if (RECORD_TYPE(ssl) != aead) {
 #ifdef HAVE_TRUNCATED_HMAC
             if (ssl->truncated_hmac && ssl->specs.hash_size > digestSz) {
             #ifdef CYASSL_SMALL_STACK
@@ -7409,7 +10738,7 @@ int SendFinished(CYASSL* ssl)
         AddSession(ssl);    /* just try */
 #endif
         if (ssl->options.side == CYASSL_CLIENT_END) {
-            ret = BuildFinished(ssl, &ssl->verifyHashes, server);
+            ret = BuildFinished(ssl, &ssl->hsHashes->verifyHashes, server);
             if (ret != 0) return ret;
         }
         else {
@@ -7439,7 +10768,7 @@ int SendFinished(CYASSL* ssl)
             #endif
         }
         else {
-            ret = BuildFinished(ssl, &ssl->verifyHashes, client);
+            ret = BuildFinished(ssl, &ssl->hsHashes->verifyHashes, client);
             if (ret != 0) return ret;
         }
     }
@@ -7469,6 +10798,7 @@ int SendCertificate(CYASSL* ssl)
     word32 i = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
     word32 certSz, listSz;
     byte*  output = 0;
+    buffer* body  = NULL;
 
     if (ssl->options.usingPSK_cipher || ssl->options.usingAnon_cipher)
         return 0;  /* not needed */
@@ -7478,6 +10808,23 @@ int SendCertificate(CYASSL* ssl)
         length = CERT_HEADER_SZ;
         listSz = 0;
     }
+#ifdef HAVE_CACHED_INFO
+    else if (ssl->options.side == CYASSL_SERVER_END && ssl->cached_cert) {
+        /* RFC 7924, the client holds this chain, just name it */
+        certSz = 0;
+        length = OPAQUE8_LEN + SHA256_DIGEST_SIZE;
+        listSz = 0;
+    }
+#endif
+    else if (ssl->ctx->certMsg.buffer &&
+             ssl->buffers.certificate.buffer == ssl->ctx->certificate.buffer &&
+             ssl->buffers.certChain.buffer   == ssl->ctx->certChain.buffer) {
+        /* the CTX's own chain, its message body was serialized at load */
+        body   = &ssl->ctx->certMsg;
+        certSz = 0;
+        length = body->length;
+        listSz = 0;
+    }
     else {
         certSz = ssl->buffers.certificate.length;
         /* list + cert size */
@@ -7512,9 +10859,22 @@ int SendCertificate(CYASSL* ssl)
 
     AddHeaders(output, length, certificate, ssl);
 
-    /* list total */
-    c32to24(listSz, output + i);
-    i += CERT_HEADER_SZ;
+    if (body) {
+        XMEMCPY(output + i, body->buffer, body->length);
+        i += body->length;
+    }
+#ifdef HAVE_CACHED_INFO
+    else if (ssl->options.side == CYASSL_SERVER_END && ssl->cached_cert) {
+        output[i++] = SHA256_DIGEST_SIZE;
+        XMEMCPY(output + i, ssl->ctx->certMsgHash, SHA256_DIGEST_SIZE);
+        i += SHA256_DIGEST_SIZE;
+    }
+#endif
+    else {
+        /* list total */
+        c32to24(listSz, output + i);
+        i += CERT_HEADER_SZ;
+    }
 
     /* member */
     if (certSz) {
@@ -7569,10 +10929,7 @@ int SendCertificate(CYASSL* ssl)
         ssl->options.serverState = SERVER_CERT_COMPLETE;
 
     ssl->buffers.outputBuffer.length += sendSz;
-    if (ssl->options.groupMessages)
-        return 0;
-    else
-        return SendBuffered(ssl);
+    return SendFlightPart(ssl);
 }
 
 
@@ -7655,31 +11012,468 @@ int SendCertificateRequest(CYASSL* ssl)
                           sendSz, ssl->heap);
     #endif
     ssl->buffers.outputBuffer.length += sendSz;
-    if (ssl->options.groupMessages)
+    return SendFlightPart(ssl);
+}
+#endif /* !NO_CERTS */
+
+
+int SendData(CYASSL* ssl, const void* data, int sz)
+{
+    DataVec vec;
+
+    vec.buffer = (const byte*)data;
+    vec.length = sz;
+
+    return SendDataV(ssl, &vec, 1);
+}
+
+
+/* move the (vecIdx, vecOff) gather cursor forward by sz bytes */
+static INLINE void SeekDataVec(const DataVec* vec, int* vecIdx, word32* vecOff,
+                               word32 sz)
+{
+    while (sz > 0 && sz >= vec[*vecIdx].length - *vecOff) {
+        sz -= vec[*vecIdx].length - *vecOff;
+        *vecOff = 0;
+        (*vecIdx)++;
+    }
+    *vecOff += sz;
+}
+
+
+#ifdef HAVE_PARALLEL_WRITE
+
+/* records of this write the ctx's pool can seal, AEAD whose nonces follow
+   from the sequence and nothing that has to see each record go by in turn */
+static INLINE int ParallelWriteOk(CYASSL* ssl)
+{
+    if (ssl->ctx->writePool == NULL || ssl->options.dtls ||
+            ssl->options.partialWrite || ssl->encrypt.setup == 0)
         return 0;
+#ifdef HAVE_LIBZ
+    if (ssl->options.usingCompression)
+        return 0;
+#endif
+#ifdef ATOMIC_USER
+    if (ssl->ctx->MacEncryptCb)
+        return 0;
+#endif
+#ifdef HAVE_FUZZER
+    if (ssl->fuzzerCb)
+        return 0;
+#endif
+
+#if defined(BUILD_AESGCM) && !defined(CYASSL_PIC32MZ_CRYPT)
+    if (RECORD_BULK(ssl) == cyassl_aes_gcm) {
+    #ifdef CYASSL_CRYPTO_DEV
+        if (ssl->encrypt.aes->cdevMagic == CYASSL_CRYPTO_DEV_MAGIC)
+            return 0;
+    #endif
+        return 1;
+    }
+#endif
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    if (RECORD_BULK(ssl) == cyassl_chacha && ssl->options.oldPoly == 0)
+        return 1;
+#endif
+
+    return 0;
+}
+
+
+/* header, explicit IV, sequence and nonce of the next record the way
+   AesGcmAEADEncrypt() and ChachaAEADEncrypt() would have them */
+static void LayoutWriteJob(CYASSL* ssl, WriteJob* job, byte* out,
+                           const DataVec* vec, word32 vecOff, word32 sz)
+{
+    job->out    = out;
+    job->vec    = vec;
+    job->vecOff = vecOff;
+    job->sz     = sz;
+    job->ivSz   = RECORD_BULK(ssl) == cyassl_chacha ? 0 : AEAD_EXP_IV_SZ;
+
+    AddRecordHeader(out, job->ivSz + sz + ssl->specs.aead_mac_size,
+                    application_data, ssl);
+    CYASSL_STAT_INC(recordsOut);
+
+    XMEMSET(job->additional, 0, sizeof(job->additional));
+    XMEMSET(job->nonce, 0, sizeof(job->nonce));
+    if (job->ivSz) {
+        XMEMCPY(out + RECORD_HEADER_SZ, ssl->keys.aead_exp_IV, AEAD_EXP_IV_SZ);
+        XMEMCPY(job->nonce, ssl->keys.aead_enc_imp_IV, AEAD_IMP_IV_SZ);
+        XMEMCPY(job->nonce + AEAD_IMP_IV_SZ, ssl->keys.aead_exp_IV,
+                AEAD_EXP_IV_SZ);
+        c16toa((word16)sz, job->additional + AEAD_LEN_OFFSET);
+        job->addSz = AEAD_AUTH_DATA_SZ;
+    }
+#ifdef HAVE_CHACHA
+    else {
+        c32toa(ssl->keys.sequence_number,
+               job->nonce + AEAD_IMP_IV_SZ + AEAD_SEQ_OFFSET);
+        job->addSz = CHACHA20_BLOCK_SIZE;
+    }
+#endif
+    c32toa(GetSEQIncrement(ssl, 0), job->additional + AEAD_SEQ_OFFSET);
+    XMEMCPY(job->additional + AEAD_TYPE_OFFSET, out, 3);
+    AeadIncrementExpIV(ssl);
+}
+
+
+/* copy the plaintext in behind the explicit IV and seal it in place, only
+   reads ssl's keys so any number of jobs can run at once */
+static int SealWriteJob(CYASSL* ssl, WriteJob* job)
+{
+    byte*          plain = job->out + RECORD_HEADER_SZ + job->ivSz;
+    const DataVec* in    = job->vec;
+    word32         inOff = job->vecOff;
+    word32         i;
+    int            ret   = ENCRYPT_ERROR;
+
+    for (i = 0; i < job->sz; in++, inOff = 0) {
+        word32 chunk = min(in->length - inOff, job->sz - i);
+
+        XMEMCPY(plain + i, in->buffer + inOff, chunk);
+        i += chunk;
+    }
+
+#ifdef BUILD_AESGCM
+    if (RECORD_BULK(ssl) == cyassl_aes_gcm)
+        ret = AesGcmEncrypt(ssl->encrypt.aes, plain, plain, job->sz,
+                            job->nonce, AEAD_NONCE_SZ, plain + job->sz,
+                            ssl->specs.aead_mac_size, job->additional,
+                            job->addSz);
+#endif
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    if (RECORD_BULK(ssl) == cyassl_chacha) {
+        ChaCha chacha = *ssl->encrypt.chacha;   /* takes this record's IV */
+
+        ret = ChaCha20Poly1305_EncryptCtx(&chacha, job->nonce,
+                                          job->additional, job->addSz, plain,
+                                          job->sz, plain, plain + job->sz);
+        XMEMSET(&chacha, 0, sizeof(chacha));
+    }
+#endif
+    XMEMSET(job->nonce, 0, sizeof(job->nonce));
+
+    return ret;
+}
+
+
+/* next job of batch, pool mutex held, the batch leaves the queue with its
+   last one */
+static WriteJob* ClaimWriteJob(WritePool* pool, WriteBatch* batch)
+{
+    WriteJob* job = &batch->jobs[batch->claimed++];
+
+    if (batch->claimed == batch->cnt) {
+        WriteBatch* prev = NULL;
+        WriteBatch* cur;
+
+        for (cur = pool->head; cur != batch; cur = cur->next)
+            prev = cur;
+        if (prev)
+            prev->next = batch->next;
+        else
+            pool->head = batch->next;
+        if (pool->tail == batch)
+            pool->tail = prev;
+    }
+
+    return job;
+}
+
+
+/* pool mutex held, the batch's writer may return once done reaches cnt */
+static void FinishWriteJob(WritePool* pool, WriteBatch* batch, int ret)
+{
+    if (ret != 0 && batch->ret == 0)
+        batch->ret = ret;
+    if (++batch->done == batch->cnt)
+        pthread_cond_broadcast(&pool->done);
+}
+
+
+static void* DoWriteWorker(void* arg)
+{
+    WritePool* pool = (WritePool*)arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        WriteBatch* batch;
+        WriteJob*   job;
+        int         ret;
+
+        while (pool->head == NULL && !pool->stop)
+            pthread_cond_wait(&pool->work, &pool->mutex);
+        if (pool->head == NULL)
+            break;                              /* stopping, queue drained */
+
+        batch = pool->head;
+        job   = ClaimWriteJob(pool, batch);
+        pthread_mutex_unlock(&pool->mutex);
+
+        ret = SealWriteJob(batch->ssl, job);
+
+        pthread_mutex_lock(&pool->mutex);
+        FinishWriteJob(pool, batch, ret);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+
+/* seal cnt jobs on the pool with this thread pitching in, returns once all
+   of them are */
+static int RunWriteJobs(CYASSL* ssl, WriteJob* jobs, int cnt)
+{
+    WritePool* pool = ssl->ctx->writePool;
+    WriteBatch batch;
+
+    batch.next    = NULL;
+    batch.ssl     = ssl;
+    batch.jobs    = jobs;
+    batch.cnt     = cnt;
+    batch.claimed = 0;
+    batch.done    = 0;
+    batch.ret     = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->tail)
+        pool->tail->next = &batch;
     else
-        return SendBuffered(ssl);
+        pool->head = &batch;
+    pool->tail = &batch;
+    pthread_cond_broadcast(&pool->work);
+
+    while (batch.claimed < batch.cnt) {
+        WriteJob* job = ClaimWriteJob(pool, &batch);
+        int       ret;
+
+        pthread_mutex_unlock(&pool->mutex);
+        ret = SealWriteJob(ssl, job);
+        pthread_mutex_lock(&pool->mutex);
+        FinishWriteJob(pool, &batch, ret);
+    }
+    while (batch.done < batch.cnt)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return batch.ret;
+}
+
+
+/* lay out up to PARALLEL_WRITE_BATCH full records of recSz plaintext bytes
+   from the cursor into the output buffer and seal them all at once, returns
+   the plaintext size taken or an error */
+static int SealRecordsParallel(CYASSL* ssl, const DataVec* vec, int vecIdx,
+                               word32 vecOff, int recSz, int left)
+{
+    WriteJob jobs[PARALLEL_WRITE_BATCH];
+    int      cnt    = min(left / recSz, PARALLEL_WRITE_BATCH);
+    int      outSz  = RECORD_HEADER_SZ + AEAD_EXP_IV_SZ + recSz +
+                      ssl->specs.aead_mac_size;
+    int      used   = 0;
+    byte*    out;
+    int      ret, i;
+
+    if ((ret = CheckAvailableSize(ssl, cnt * outSz)) != 0)
+        return ret;
+
+    out = ssl->buffers.outputBuffer.buffer + ssl->buffers.outputBuffer.length;
+    for (i = 0; i < cnt; i++) {
+        LayoutWriteJob(ssl, &jobs[i], out + used, vec + vecIdx, vecOff,
+                       recSz);
+        used += RECORD_HEADER_SZ + jobs[i].ivSz + recSz +
+                ssl->specs.aead_mac_size;
+        SeekDataVec(vec, &vecIdx, &vecOff, recSz);
+    }
+
+    if ((ret = RunWriteJobs(ssl, jobs, cnt)) != 0)
+        return ret;
+
+    ssl->buffers.outputBuffer.length += used;
+
+    return cnt * recSz;
+}
+
+
+/* stop the ctx's sealing threads, then start threads new ones, 0 stops */
+int SetWritePool(CYASSL_CTX* ctx, int threads)
+{
+    WritePool* pool = ctx->writePool;
+    int        i;
+
+    if (pool) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stop = 1;
+        pthread_cond_broadcast(&pool->work);
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (i = 0; i < pool->threads; i++)
+            pthread_join(pool->tid[i], NULL);
+
+        pthread_cond_destroy(&pool->done);
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->mutex);
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_WRITE_POOL);
+        ctx->writePool = NULL;
+    }
+
+    if (threads == 0)
+        return 0;
+
+    pool = (WritePool*)XMALLOC(sizeof(WritePool), ctx->heap,
+                               DYNAMIC_TYPE_WRITE_POOL);
+    if (pool == NULL)
+        return MEMORY_E;
+    XMEMSET(pool, 0, sizeof(WritePool));
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_WRITE_POOL);
+        return BAD_MUTEX_E;
+    }
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&pool->tid[i], NULL, DoWriteWorker, pool) != 0)
+            break;
+        pool->threads++;
+    }
+
+    ctx->writePool = pool;
+    if (pool->threads == 0) {
+        CYASSL_MSG("No write pool threads started");
+        SetWritePool(ctx, 0);
+        return THREAD_CREATE_E;
+    }
+
+    return 0;
+}
+
+#endif /* HAVE_PARALLEL_WRITE */
+
+
+#ifdef CYASSL_KTLS
+
+/* kernel builds the records, hand it the plaintext fragments as they are,
+   prevSent keeps what the kernel already took across a WANT_WRITE */
+static int SendDataKTLS(CYASSL* ssl, const DataVec* vec, int cnt, int sz)
+{
+    int    sent   = ssl->buffers.prevSent;
+    int    vecIdx = 0;
+    word32 vecOff = 0;
+
+    ssl->buffers.prevSent = 0;
+    if (sent > sz) {
+        CYASSL_MSG("error: write() after WANT_WRITE with short size");
+        return ssl->error = BAD_FUNC_ARG;
+    }
+    SeekDataVec(vec, &vecIdx, &vecOff, sent);
+
+    while (sent < sz && vecIdx < cnt) {
+        int len = (int)(vec[vecIdx].length - vecOff);
+        int ret;
+
+        if (len == 0) {
+            vecIdx++;
+            vecOff = 0;
+            continue;
+        }
+
+        ret = ssl->ctx->CBIOSend(ssl, (char*)vec[vecIdx].buffer + vecOff, len,
+                                 ssl->IOCB_WriteCtx);
+        if (ret < 0) {
+            switch (ret) {
+                case CYASSL_CBIO_ERR_WANT_WRITE:
+                    ssl->buffers.prevSent = sent;
+                    return ssl->error = WANT_WRITE;
+                case CYASSL_CBIO_ERR_ISR:
+                    continue;
+                case CYASSL_CBIO_ERR_CONN_RST:
+                case CYASSL_CBIO_ERR_CONN_CLOSE:
+                    ssl->options.connReset = 1;
+                    return 0;  /* peer reset */
+                default:
+                    return ssl->error = SOCKET_ERROR_E;
+            }
+        }
+        if (ret > len) {
+            CYASSL_MSG("SendDataKTLS() out of bounds read");
+            return ssl->error = SEND_OOB_READ_E;
+        }
+
+        sent += ret;
+        SeekDataVec(vec, &vecIdx, &vecOff, ret);
+
+        /* only one message per attempt */
+        if (ssl->options.partialWrite == 1)
+            break;
+    }
+
+    return sent;
 }
-#endif /* !NO_CERTS */
 
+#endif /* CYASSL_KTLS */
 
-int SendData(CYASSL* ssl, const void* data, int sz)
+
+/* send the concatenation of the cnt fragments in vec, records are packed
+   straight from the fragments so there is no staging copy */
+int SendDataV(CYASSL* ssl, const DataVec* vec, int cnt)
 {
     int sent = 0,  /* plainText size */
+        sz   = 0,
         sendSz,
         ret,
-        dtlsExtra = 0;
+        dtlsExtra = 0,
+        vecIdx = 0,
+        flushed,   /* plainText size already handed to SendBuffered() */
+        i;
+    word32 vecOff = 0;
+    word32 coalesce;
+#ifdef HAVE_PARALLEL_WRITE
+    int    parallel;
+#endif
+
+    for (i = 0; i < cnt; i++) {
+        if ((int)vec[i].length < 0 || sz + (int)vec[i].length < sz)
+            return BAD_FUNC_ARG;
+        sz += (int)vec[i].length;
+    }
+
+#ifdef HAVE_LIBZ
+    if (ssl->options.usingCompression && cnt > 1) {
+        CYASSL_MSG("Compression needs a single data buffer");
+        return BAD_FUNC_ARG;
+    }
+#endif
 
-    if (ssl->error == WANT_WRITE)
+    if (ssl->error == WANT_WRITE || ssl->error == WANT_ASYNC)
         ssl->error = 0;
 
-    if (ssl->options.handShakeState != HANDSHAKE_DONE) {
+    if (ssl->options.handShakeState != HANDSHAKE_DONE &&
+                                                 !ssl->options.falseStarted) {
         int err;
         CYASSL_MSG("handshake not complete, trying to finish");
-        if ( (err = CyaSSL_negotiate(ssl)) != SSL_SUCCESS)
-            return  err;
+        if ( (err = CyaSSL_negotiate(ssl)) != SSL_SUCCESS) {
+        #ifdef HAVE_SECURE_RENEGOTIATION
+            /* renegotiating with our Finished out, writes go on meanwhile */
+            if (ssl->options.handShakeDone && ssl->error == WANT_READ &&
+                    ssl->options.side == CYASSL_CLIENT_END &&
+                    ssl->options.connectState == FINISHED_DONE)
+                ssl->error = 0;
+            else
+        #endif
+                return  err;
+        }
     }
 
+#ifdef CYASSL_KTLS
+    if (ssl->options.ktlsTx)
+        return SendDataKTLS(ssl, vec, cnt, sz);
+#endif
+
     /* last time system socket output buffer was full, try again to send */
     if (ssl->buffers.outputBuffer.length > 0) {
         CYASSL_MSG("output buffer was full, trying to send again");
@@ -7698,6 +11492,7 @@ int SendData(CYASSL* ssl, const void* data, int sz)
                 CYASSL_MSG("error: write() after WANT_WRITE with short size");
                 return ssl->error = BAD_FUNC_ARG;
             }
+            SeekDataVec(vec, &vecIdx, &vecOff, sent);
         }
     }
 
@@ -7707,6 +11502,32 @@ int SendData(CYASSL* ssl, const void* data, int sz)
     }
 #endif
 
+    /* batching records keeps datagram boundaries from lining up */
+    coalesce = ssl->buffers.writeCoalesce;
+    if (ssl->options.dtls || ssl->options.partialWrite)
+        coalesce = 0;
+
+    if (coalesce && sz - sent > OUTPUT_RECORD_SIZE) {
+        /* one grow up front instead of one per held back record */
+        if ((ret = CheckAvailableSize(ssl, coalesce)) != 0)
+            return ssl->error = ret;
+    }
+
+    /* dynamic record sizing, a quiet spell starts over with small records */
+    if (ssl->buffers.dynRecordSz) {
+        word32 now = LowResTimer();
+
+        if (ssl->buffers.dynRecordIdle &&
+                now - ssl->buffers.dynRecordLast >= ssl->buffers.dynRecordIdle)
+            ssl->buffers.dynRecordSent = 0;
+        ssl->buffers.dynRecordLast = now;
+    }
+
+    flushed = sent;
+#ifdef HAVE_PARALLEL_WRITE
+    parallel = ParallelWriteOk(ssl);
+#endif
+
     for (;;) {
 #ifdef HAVE_MAX_FRAGMENT
         int   len = min(sz - sent, min(ssl->max_fragment, OUTPUT_RECORD_SIZE));
@@ -7714,7 +11535,6 @@ int SendData(CYASSL* ssl, const void* data, int sz)
         int   len = min(sz - sent, OUTPUT_RECORD_SIZE);
 #endif
         byte* out;
-        byte* sendBuffer = (byte*)data + sent;  /* may switch on comp */
         int   buffSz = len;                     /* may switch on comp */
         int   outputSz;
 #ifdef HAVE_LIBZ
@@ -7723,6 +11543,13 @@ int SendData(CYASSL* ssl, const void* data, int sz)
 
         if (sent == sz) break;
 
+        /* one segment records until the connection has ramped up */
+        if (ssl->buffers.dynRecordSz &&
+                ssl->buffers.dynRecordSent < ssl->buffers.dynRecordRamp) {
+            len    = min(len, ssl->buffers.dynRecordSz);
+            buffSz = len;
+        }
+
 #ifdef CYASSL_DTLS
         if (ssl->options.dtls) {
             len    = min(len, MAX_UDP_SIZE);
@@ -7730,6 +11557,19 @@ int SendData(CYASSL* ssl, const void* data, int sz)
         }
 #endif
 
+#ifdef HAVE_PARALLEL_WRITE
+        /* full records once past any ramp, sealed a batch at a time */
+        if (parallel && sz - sent >= 2 * len &&
+                ssl->buffers.dynRecordSent >= ssl->buffers.dynRecordRamp) {
+            len = SealRecordsParallel(ssl, vec, vecIdx, vecOff, len,
+                                      sz - sent);
+            if (len < 0)
+                return ssl->error = len;
+            outputSz = len;
+            goto sealed;
+        }
+#endif
+
         /* check for available size */
         outputSz = len + COMP_EXTRA + dtlsExtra + MAX_MSG_EXTRA;
         if ((ret = CheckAvailableSize(ssl, outputSz)) != 0)
@@ -7741,32 +11581,48 @@ int SendData(CYASSL* ssl, const void* data, int sz)
 
 #ifdef HAVE_LIBZ
         if (ssl->options.usingCompression) {
-            buffSz = myCompress(ssl, sendBuffer, buffSz, comp, sizeof(comp));
+            buffSz = myCompress(ssl, (byte*)vec[vecIdx].buffer + vecOff,
+                                buffSz, comp, sizeof(comp));
             if (buffSz < 0) {
                 return buffSz;
             }
-            sendBuffer = comp;
+            sendSz = BuildMessage(ssl, out, outputSz, comp, buffSz,
+                                  application_data);
         }
+        else
 #endif
-        sendSz = BuildMessage(ssl, out, outputSz, sendBuffer, buffSz,
-                              application_data);
+            sendSz = BuildMessageV(ssl, out, outputSz, vec + vecIdx, vecOff,
+                                   buffSz, application_data);
         if (sendSz < 0)
             return BUILD_MSG_ERROR;
 
         ssl->buffers.outputBuffer.length += sendSz;
 
+#ifdef HAVE_PARALLEL_WRITE
+    sealed:
+#endif
+        sent += len;
+        SeekDataVec(vec, &vecIdx, &vecOff, len);
+        if (ssl->buffers.dynRecordSent < ssl->buffers.dynRecordRamp)
+            ssl->buffers.dynRecordSent += len;
+
+        /* hold the record back while another full one fits the batch */
+        if (coalesce && sent < sz &&
+                ssl->buffers.outputBuffer.length + outputSz <= coalesce)
+            continue;
+
         if ( (ret = SendBuffered(ssl)) < 0) {
             CYASSL_ERROR(ret);
             /* store for next call if WANT_WRITE or user embedSend() that
                doesn't present like WANT_WRITE */
-            ssl->buffers.plainSz  = len;
-            ssl->buffers.prevSent = sent;
+            ssl->buffers.plainSz  = sent - flushed;
+            ssl->buffers.prevSent = flushed;
             if (ret == SOCKET_ERROR_E && ssl->options.connReset)
                 return 0;  /* peer reset */
             return ssl->error = ret;
         }
 
-        sent += len;
+        flushed = sent;
 
         /* only one message per attempt */
         if (ssl->options.partialWrite == 1) {
@@ -7779,13 +11635,12 @@ int SendData(CYASSL* ssl, const void* data, int sz)
 }
 
 /* process input data */
-int ReceiveData(CYASSL* ssl, byte* output, int sz, int peek)
+/* process records until decrypted application data is available in
+   clearOutputBuffer, return available size, 0 on peer close, or error */
+static int GetAppData(CYASSL* ssl)
 {
-    int size;
-
-    CYASSL_ENTER("ReceiveData()");
-
-    if (ssl->error == WANT_READ)
+    if (ssl->error == WANT_READ || ssl->error == WANT_ASYNC ||
+            ssl->error == OCSP_WANT_READ || ssl->error == OCSP_WANT_WRITE)
         ssl->error = 0;
 
     if (ssl->error != 0 && ssl->error != WANT_WRITE) {
@@ -7793,7 +11648,13 @@ int ReceiveData(CYASSL* ssl, byte* output, int sz, int peek)
         return ssl->error;
     }
 
-    if (ssl->options.handShakeState != HANDSHAKE_DONE) {
+    if (ssl->options.handShakeState != HANDSHAKE_DONE
+    #ifdef HAVE_SECURE_RENEGOTIATION
+            /* what came in while renegotiating is there to read already */
+            && !(ssl->options.handShakeDone &&
+                 ssl->buffers.clearOutputBuffer.length > 0)
+    #endif
+            ) {
         int err;
         CYASSL_MSG("Handshake not complete, trying to finish");
         if ( (err = CyaSSL_negotiate(ssl)) != SSL_SUCCESS)
@@ -7834,27 +11695,287 @@ startScr:
         #endif
     }
 
-    if (sz < (int)ssl->buffers.clearOutputBuffer.length)
-        size = sz;
-    else
-        size = ssl->buffers.clearOutputBuffer.length;
+    return (int)ssl->buffers.clearOutputBuffer.length;
+}
 
-    XMEMCPY(output, ssl->buffers.clearOutputBuffer.buffer, size);
 
-    if (peek == 0) {
-        ssl->buffers.clearOutputBuffer.length -= size;
-        ssl->buffers.clearOutputBuffer.buffer += size;
-    }
+/* mark sz bytes of clearOutputBuffer as read, shrinking input when done */
+static void ConsumeData(CYASSL* ssl, int sz)
+{
+    ssl->buffers.clearOutputBuffer.length -= sz;
+    ssl->buffers.clearOutputBuffer.buffer += sz;
 
+    /* a read ahead buffer stays for the next records, GetInputData() gives
+       it back once the peer goes quiet */
     if (ssl->buffers.clearOutputBuffer.length == 0 &&
-                                           ssl->buffers.inputBuffer.dynamicFlag)
+            ssl->buffers.inputBuffer.dynamicFlag && !ReadAheadSz(ssl))
        ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+}
+
+
+#ifdef CYASSL_KTLS
+
+/* one EmbedKTLSReceive() on our read socket, retried on interrupt */
+static int KTLSRecv(CYASSL* ssl, byte* buf, int sz, int peek, byte* type)
+{
+    int ret;
+
+    do {
+        ret = EmbedKTLSReceive(ssl, *(int*)ssl->IOCB_ReadCtx, buf, sz, peek,
+                               type);
+    } while (ret == CYASSL_CBIO_ERR_ISR);
+
+    return ret;
+}
+
+
+/* kernel decrypts the records, app data lands right in output, alerts come
+   through as their own record type and are handled here */
+static int ReceiveDataKTLS(CYASSL* ssl, byte* output, int sz, int peek)
+{
+    if (ssl->error == WANT_READ)
+        ssl->error = 0;
+
+    if (ssl->error != 0 && ssl->error != WANT_WRITE) {
+        CYASSL_MSG("User calling CyaSSL_read in error state, not allowed");
+        return ssl->error;
+    }
+
+    for (;;) {
+        byte type;
+        byte rec[ALERT_SIZE];
+        int  got = 0;
+        int  ret = KTLSRecv(ssl, output, sz, peek, &type);
+
+        if (ret >= 0 && type == application_data)
+            return ret;
+
+        if (ret >= 0 && type != alert) {
+            CYASSL_MSG("Kernel TLS can't handle post handshake messages");
+            return ssl->error = KTLS_E;
+        }
+
+        /* alert already read into output, unless only peeked at */
+        if (ret >= 0 && !peek) {
+            got = min(ret, ALERT_SIZE);
+            XMEMCPY(rec, output, got);
+        }
+        while (ret >= 0 && got < ALERT_SIZE) {
+            ret = KTLSRecv(ssl, rec + got, ALERT_SIZE - got, 0, &type);
+            if (ret > 0)
+                got += ret;
+        }
+
+        if (ret < 0) {
+            switch (ret) {
+                case CYASSL_CBIO_ERR_WANT_READ:
+                    return ssl->error = WANT_READ;
+                case CYASSL_CBIO_ERR_CONN_RST:
+                    ssl->options.connReset = 1;
+                    return 0;     /* peer reset */
+                case CYASSL_CBIO_ERR_CONN_CLOSE:
+                    ssl->options.isClosed = 1;
+                    return 0;     /* peer closed */
+                default:
+                    return ssl->error = SOCKET_ERROR_E;
+            }
+        }
+
+        ssl->alert_history.last_rx.level = rec[0];
+        ssl->alert_history.last_rx.code  = rec[1];
+        if (rec[1] == close_notify) {
+            CYASSL_MSG("Got alert, close notify");
+            ssl->options.closeNotify = 1;
+            ssl->error = ZERO_RETURN;
+            return 0;     /* no more data coming */
+        }
+        if (rec[0] == alert_fatal) {
+            CYASSL_MSG("Got fatal alert");
+            ssl->options.isClosed = 1;  /* Don't send close_notify */
+            return ssl->error = FATAL_ERROR;
+        }
+        CYASSL_MSG("Got warning alert, keep reading");
+    }
+}
+
+#endif /* CYASSL_KTLS */
+
+
+int ReceiveData(CYASSL* ssl, byte* output, int sz, int peek)
+{
+    int size;
+
+    CYASSL_ENTER("ReceiveData()");
+
+#ifdef CYASSL_KTLS
+    if (ssl->options.ktlsRx)
+        return ReceiveDataKTLS(ssl, output, sz, peek);
+#endif
+
+    if ( (size = GetAppData(ssl)) <= 0)
+        return size;
+
+    if (sz < size)
+        size = sz;
+
+    XMEMCPY(output, ssl->buffers.clearOutputBuffer.buffer, size);
+
+    if (peek == 0)
+        ConsumeData(ssl, size);
 
     CYASSL_LEAVE("ReceiveData()", size);
     return size;
 }
 
 
+/* point data at decrypted plaintext still in the input buffer, no copy, the
+   view stays valid until ReleaseDataView() or the next read */
+int ReceiveDataView(CYASSL* ssl, const byte** data)
+{
+    int size;
+
+    CYASSL_ENTER("ReceiveDataView()");
+
+    *data = NULL;
+#ifdef CYASSL_KTLS
+    if (ssl->options.ktlsRx) {
+        CYASSL_MSG("Kernel TLS reads have no input buffer to view");
+        return KTLS_E;
+    }
+#endif
+    if ( (size = GetAppData(ssl)) <= 0)
+        return size;
+
+    *data = ssl->buffers.clearOutputBuffer.buffer;
+
+    CYASSL_LEAVE("ReceiveDataView()", size);
+    return size;
+}
+
+
+/* done with sz bytes of a ReceiveDataView() */
+int ReleaseDataView(CYASSL* ssl, int sz)
+{
+    CYASSL_ENTER("ReleaseDataView()");
+
+    if (sz < 0 || sz > (int)ssl->buffers.clearOutputBuffer.length)
+        return BAD_FUNC_ARG;
+
+    ConsumeData(ssl, sz);
+
+    return 0;
+}
+
+
+/* memory IO, append sz bytes the app received to the input buffer, keeps
+   any plaintext not yet read in place ahead of what's still to process */
+int FeedInputData(CYASSL* ssl, const byte* in, word32 sz)
+{
+    word32 keep = ssl->buffers.inputBuffer.idx;
+    word32 idx  = ssl->buffers.inputBuffer.idx;
+    word32 used;
+
+    if (ssl->buffers.clearOutputBuffer.length > 0)
+        keep = (word32)(ssl->buffers.clearOutputBuffer.buffer -
+                        ssl->buffers.inputBuffer.buffer);
+    used = ssl->buffers.inputBuffer.length - keep;
+
+    if (ssl->buffers.inputBuffer.bufferSize -
+                                    ssl->buffers.inputBuffer.length < sz) {
+        if (ssl->buffers.inputBuffer.bufferSize - used >= sz) {
+            XMEMMOVE(ssl->buffers.inputBuffer.buffer,
+                     ssl->buffers.inputBuffer.buffer + keep, used);
+            ssl->buffers.inputBuffer.length = used;
+        }
+        else {
+            /* room for another buffer's worth, a record fed a segment at
+               a time doesn't grow it on every one */
+            word32 grow = ssl->buffers.inputBuffer.bufferSize;
+
+            if (grow < sz)
+                grow = sz;
+            ssl->buffers.inputBuffer.idx = keep;
+            if (GrowInputBuffer(ssl, (int)grow, (int)used) < 0) {
+                ssl->buffers.inputBuffer.idx = idx;
+                return MEMORY_E;
+            }
+        }
+        ssl->buffers.inputBuffer.idx = idx - keep;
+        if (ssl->buffers.clearOutputBuffer.length > 0)
+            ssl->buffers.clearOutputBuffer.buffer =
+                                               ssl->buffers.inputBuffer.buffer;
+    }
+
+    XMEMCPY(ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.length,
+            in, sz);
+    ssl->buffers.inputBuffer.length += sz;
+    CYASSL_STAT_ADD(bytesIn, sz);
+
+    return 0;
+}
+
+
+/* memory IO, copy out up to sz bytes of the records waiting to be sent,
+   returns the count */
+int TakeOutputData(CYASSL* ssl, byte* out, word32 sz)
+{
+    if (sz > ssl->buffers.memOutLen)
+        sz = ssl->buffers.memOutLen;
+
+    XMEMCPY(out, ssl->buffers.memOut, sz);
+    ssl->buffers.memOutLen -= sz;
+    if (ssl->buffers.memOutLen)
+        XMEMMOVE(ssl->buffers.memOut, ssl->buffers.memOut + sz,
+                 ssl->buffers.memOutLen);
+
+    return (int)sz;
+}
+
+
+/* bytes still to come before ProcessReply() can finish the next record, 0
+   when what's buffered lets it move on now */
+int GetReadDemand(CYASSL* ssl)
+{
+    word32 used  = ssl->buffers.inputBuffer.length -
+                   ssl->buffers.inputBuffer.idx;
+    word32 hdrSz = RECORD_HEADER_SZ;
+    word32 need;
+
+    if (ssl->buffers.clearOutputBuffer.length > 0)
+        return 0;
+
+#ifdef CYASSL_DTLS
+    if (ssl->options.dtls)
+        hdrSz = DTLS_RECORD_HEADER_SZ;
+#endif
+
+    switch (ssl->options.processReply) {
+        case doProcessInit:
+            need = hdrSz;
+            if (used >= hdrSz) {
+                /* header is in, its last two bytes are the record length */
+                byte* hdr = ssl->buffers.inputBuffer.buffer +
+                            ssl->buffers.inputBuffer.idx;
+                need += (hdr[hdrSz - 2] << 8) | hdr[hdrSz - 1];
+            }
+            break;
+
+    #ifndef NO_CYASSL_SERVER
+        case runProcessOldClientHello:
+    #endif
+        case getData:
+            need = ssl->curSize;
+            break;
+
+        default:
+            need = 0;   /* record is here, only processing is left */
+            break;
+    }
+
+    return used < need ? (int)(need - used) : 0;
+}
+
+
 /* send alert message */
 int SendAlert(CYASSL* ssl, int severity, int type)
 {
@@ -7891,10 +12012,26 @@ int SendAlert(CYASSL* ssl, int severity, int type)
     input[1] = (byte)type;
     ssl->alert_history.last_tx.code = type;
     ssl->alert_history.last_tx.level = severity;
+    CYASSL_STAT_ALERT(alertsOut, type);
     if (severity == alert_fatal) {
         ssl->options.isClosed = 1;  /* Don't send close_notify */
     }
 
+#ifdef CYASSL_KTLS
+    if (ssl->options.ktlsTx) {
+        /* kernel owns the record layer, tell it the record type */
+        do {
+            ret = EmbedKTLSSend(ssl, *(int*)ssl->IOCB_WriteCtx, alert, input,
+                                ALERT_SIZE);
+        } while (ret == CYASSL_CBIO_ERR_ISR);
+
+        if (ret == CYASSL_CBIO_ERR_WANT_WRITE)
+            return WANT_WRITE;
+
+        return ret == ALERT_SIZE ? 0 : SOCKET_ERROR_E;
+    }
+#endif
+
     /* only send encrypted alert if handshake actually complete, otherwise
        other side may not be able to handle it */
     if (ssl->keys.encryptionOn && ssl->options.handShakeDone)
@@ -8234,6 +12371,38 @@ const char* CyaSSL_ERR_reason_error_string(unsigned long e)
     case DUPLICATE_MSG_E:
         return "Duplicate HandShake message Error";
 
+    case KTLS_E:
+        return "Kernel TLS offload Error";
+
+    case WANT_ASYNC :
+    case SSL_ERROR_WANT_ASYNC :
+        return "async private key op not done yet";
+
+    case OCSP_WANT_READ:
+        return "OCSP responder socket not readable yet, call again";
+
+    case OCSP_WANT_WRITE:
+        return "OCSP responder socket not writable yet, call again";
+
+    case CLIENT_HELLO_REJECT_E:
+        return "ClientHello callback rejected the handshake";
+
+    case WANT_CLIENT_HELLO :
+    case SSL_ERROR_WANT_CLIENT_HELLO :
+        return "ClientHello callback suspended, call again";
+
+    case HIBERNATE_E:
+        return "Connection can't be hibernated or woken in this state";
+
+    case UNKNOWN_ALPN_PROTOCOL_E:
+        return "No application protocol in common with the peer";
+
+    case CACHED_INFO_E:
+        return "Certificate hash doesn't match the cached chain";
+
+    case HANDSHAKE_BUSY_E:
+        return "Full handshake limit reached, connection shed";
+
     default :
         return "unknown error number";
     }
@@ -9048,6 +13217,64 @@ int GetCipherNamesSize(void)
 }
 
 
+/* first suite byte of a cipher_names[] entry */
+static byte SuiteFirstByte(const char* name)
+{
+    return (XSTRSTR(name, "CHACHA")) ? CHACHA_BYTE
+         : (XSTRSTR(name, "EC"))     ? ECC_BYTE
+         : (XSTRSTR(name, "CCM"))    ? ECC_BYTE
+         : 0x00; /* normal */
+}
+
+
+#ifdef CYASSL_STATIC_SUITES
+
+/* name is on the --enable-suites list */
+static int StaticSuiteAllowed(const char* name)
+{
+    const char* list = CYASSL_STATIC_SUITES;
+    word32      len  = (word32)XSTRLEN(name);
+
+    while (*list) {
+        const char* end = XSTRSTR(list, ":");
+        word32      sz  = end ? (word32)(end - list) : (word32)XSTRLEN(list);
+
+        if (sz == len && XSTRNCMP(list, name, len) == 0)
+            return 1;
+        list += end ? sz + 1 : sz;
+    }
+
+    return 0;
+}
+
+
+/* drop the suites InitSuites() picked that aren't on the list, returns the
+   new size */
+static word16 StaticSuites(Suites* suites, word16 sz)
+{
+    const int names = GetCipherNamesSize();
+    word16    in, out = 0;
+    int       i;
+
+    for (in = 0; in + 1 < sz; in += 2) {
+        for (i = 0; i < names; i++) {
+            if (suites->suites[in + 1] == (byte)cipher_name_idx[i] &&
+                    suites->suites[in] == SuiteFirstByte(cipher_names[i])) {
+                if (StaticSuiteAllowed(cipher_names[i])) {
+                    suites->suites[out++] = suites->suites[in];
+                    suites->suites[out++] = suites->suites[in + 1];
+                }
+                break;
+            }
+        }
+    }
+
+    return out;
+}
+
+#endif /* CYASSL_STATIC_SUITES */
+
+
 /**
 Set the enabled cipher suites.
 
@@ -9090,11 +13317,11 @@ int SetCipherList(Suites* suites, const char* list)
 
         for (i = 0; i < suiteSz; i++) {
             if (XSTRNCMP(name, cipher_names[i], sizeof(name)) == 0) {
-                suites->suites[idx++] = (XSTRSTR(name, "CHACHA")) ? CHACHA_BYTE
-                                      : (XSTRSTR(name, "EC"))     ? ECC_BYTE
-                                      : (XSTRSTR(name, "CCM"))    ? ECC_BYTE
-                                      : 0x00; /* normal */
-
+            #ifdef CYASSL_STATIC_SUITES
+                if (!StaticSuiteAllowed(name))
+                    break;      /* not in this build's record layer */
+            #endif
+                suites->suites[idx++] = SuiteFirstByte(name);
                 suites->suites[idx++] = (byte)cipher_name_idx[i];
 
                 /* The suites are either ECDSA, RSA, PSK, or Anon. The RSA
@@ -9317,6 +13544,10 @@ static void PickHashSigAlgo(CYASSL* ssl,
             return SUITES_ERROR;
         }
 
+#ifdef HAVE_CACHED_INFO
+        ssl->cached_cert = 0;  /* until this server takes our chain */
+#endif
+
 #ifdef HAVE_SESSION_TICKET
         if (ssl->options.resuming && ssl->session.ticketLen > 0) {
             SessionTicket* ticket;
@@ -11040,10 +15271,7 @@ static void PickHashSigAlgo(CYASSL* ssl,
 
             ssl->buffers.outputBuffer.length += sendSz;
 
-            if (ssl->options.groupMessages)
-                ret = 0;
-            else
-                ret = SendBuffered(ssl);
+            ret = SendFlightPart(ssl);
         }
 
     #ifdef CYASSL_SMALL_STACK
@@ -11071,12 +15299,22 @@ static void PickHashSigAlgo(CYASSL* ssl,
         word32             idx = 0;
         word32             sigOutSz = 0;
 #ifndef NO_RSA
-        RsaKey             key;
+    #ifdef CYASSL_SMALL_STACK
+        RsaKey*            key = NULL;
+    #else
+        RsaKey             key[1];
+    #endif
+        RsaKey*            signKey = NULL;  /* key, or the ctx's decoded */
         int                initRsaKey = 0;
 #endif
         int                usingEcc = 0;
 #ifdef HAVE_ECC
-        ecc_key            eccKey;
+    #ifdef CYASSL_SMALL_STACK
+        ecc_key*           eccKey = NULL;
+    #else
+        ecc_key            eccKey[1];
+    #endif
+        ecc_key*           signEccKey = NULL;
 #endif
 
         (void)idx;
@@ -11095,30 +15333,45 @@ static void PickHashSigAlgo(CYASSL* ssl,
         output = ssl->buffers.outputBuffer.buffer +
                  ssl->buffers.outputBuffer.length;
 
-        ret = BuildCertHashes(ssl, &ssl->certHashes);
+        ret = BuildCertHashes(ssl, &ssl->hsHashes->certHashes);
         if (ret != 0)
             return ret;
 
+#ifdef CYASSL_SMALL_STACK
+    #ifndef NO_RSA
+        key = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (key == NULL)
+            return MEMORY_E;
+    #endif
+    #ifdef HAVE_ECC
+        eccKey = (ecc_key*)XMALLOC(sizeof(ecc_key), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+        if (eccKey == NULL) {
+        #ifndef NO_RSA
+            XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        #endif
+            return MEMORY_E;
+        }
+    #endif
+#endif
+
 #ifdef HAVE_ECC
-        ecc_init(&eccKey);
+        ecc_init(eccKey);
 #endif
 #ifndef NO_RSA
-        ret = InitRsaKey(&key, ssl->heap);
+        ret = InitRsaKey(key, ssl->heap);
         if (ret == 0) initRsaKey = 1;
         if (ret == 0)
-            ret = RsaPrivateKeyDecode(ssl->buffers.key.buffer, &idx, &key,
-                                      ssl->buffers.key.length);
+            ret = DecodeRsaPrivateKey(ssl, key, &signKey);
         if (ret == 0)
-            sigOutSz = RsaEncryptSize(&key);
+            sigOutSz = RsaEncryptSize(signKey);
         else
 #endif
         {
     #ifdef HAVE_ECC
             CYASSL_MSG("Trying ECC client cert, RSA didn't work");
 
-            idx = 0;
-            ret = EccPrivateKeyDecode(ssl->buffers.key.buffer, &idx, &eccKey,
-                                      ssl->buffers.key.length);
+            ret = DecodeEccPrivateKey(ssl, eccKey, &signEccKey);
             if (ret == 0) {
                 CYASSL_MSG("Using ECC client cert");
                 usingEcc = 1;
@@ -11133,7 +15386,7 @@ static void PickHashSigAlgo(CYASSL* ssl,
             byte*  verify = (byte*)&output[RECORD_HEADER_SZ +
                                            HANDSHAKE_HEADER_SZ];
 #ifndef NO_OLD_TLS
-            byte*  signBuffer = ssl->certHashes.md5;
+            byte*  signBuffer = ssl->hsHashes->certHashes.md5;
 #else
             byte*  signBuffer = NULL;
 #endif
@@ -11151,10 +15404,16 @@ static void PickHashSigAlgo(CYASSL* ssl,
             if (encodedSig == NULL) {
             #ifndef NO_RSA
                 if (initRsaKey)
-                    FreeRsaKey(&key);
+                    FreeRsaKey(key);
             #endif
             #ifdef HAVE_ECC
-                ecc_free(&eccKey);
+                ecc_free(eccKey);
+            #endif
+            #ifndef NO_RSA
+                XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            #endif
+            #ifdef HAVE_ECC
+                XFREE(eccKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             #endif
                 return MEMORY_E;
             }
@@ -11184,11 +15443,11 @@ static void PickHashSigAlgo(CYASSL* ssl,
 #ifndef NO_OLD_TLS
                 /* old tls default */
                 digestSz = SHA_DIGEST_SIZE;
-                digest   = ssl->certHashes.sha;
+                digest   = ssl->hsHashes->certHashes.sha;
 #else
                 /* new tls default */
                 digestSz = SHA256_DIGEST_SIZE;
-                digest   = ssl->certHashes.sha256;
+                digest   = ssl->hsHashes->certHashes.sha256;
 #endif
 
                 #ifdef HAVE_PK_CALLBACKS
@@ -11201,24 +15460,30 @@ static void PickHashSigAlgo(CYASSL* ssl,
                 if (IsAtLeastTLSv1_2(ssl)) {
                     if (ssl->suites->hashAlgo == sha_mac) {
                         #ifndef NO_SHA
-                            digest = ssl->certHashes.sha;
+                            digest = ssl->hsHashes->certHashes.sha;
                             digestSz = SHA_DIGEST_SIZE;
                         #endif
                     }
                     else if (ssl->suites->hashAlgo == sha256_mac) {
                         #ifndef NO_SHA256
-                            digest = ssl->certHashes.sha256;
+                            digest = ssl->hsHashes->certHashes.sha256;
                             digestSz = SHA256_DIGEST_SIZE;
                         #endif
                     }
                     else if (ssl->suites->hashAlgo == sha384_mac) {
                         #ifdef CYASSL_SHA384
-                            digest = ssl->certHashes.sha384;
+                            digest = ssl->hsHashes->certHashes.sha384;
                             digestSz = SHA384_DIGEST_SIZE;
                         #endif
                     }
                 }
 
+            #ifdef CYASSL_ASYNC_CRYPT
+                if (ssl->ctx->AsyncSubmitCb)
+                    ret = AsyncPkOp(ssl, CYASSL_ASYNC_ECC_SIGN, digest,
+                                    digestSz, encodedSig, &localSz);
+                else
+            #endif
                 if (doUserEcc) {
                 #ifdef HAVE_PK_CALLBACKS
                     #ifdef HAVE_ECC
@@ -11232,7 +15497,7 @@ static void PickHashSigAlgo(CYASSL* ssl,
                 }
                 else {
                     ret = ecc_sign_hash(digest, digestSz, encodedSig,
-                                        &localSz, ssl->rng, &eccKey);
+                                        &localSz, ssl->rng, signEccKey);
                 }
                 if (ret == 0) {
                     length = localSz;
@@ -11252,32 +15517,32 @@ static void PickHashSigAlgo(CYASSL* ssl,
 
                 if (IsAtLeastTLSv1_2(ssl)) {
 #ifndef NO_OLD_TLS
-                    byte* digest = ssl->certHashes.sha;
+                    byte* digest = ssl->hsHashes->certHashes.sha;
                     int   digestSz = SHA_DIGEST_SIZE;
                     int   typeH = SHAh;
 #else
-                    byte* digest = ssl->certHashes.sha256;
+                    byte* digest = ssl->hsHashes->certHashes.sha256;
                     int   digestSz = SHA256_DIGEST_SIZE;
                     int   typeH = SHA256h;
 #endif
 
                     if (ssl->suites->hashAlgo == sha_mac) {
                         #ifndef NO_SHA
-                            digest = ssl->certHashes.sha;
+                            digest = ssl->hsHashes->certHashes.sha;
                             typeH    = SHAh;
                             digestSz = SHA_DIGEST_SIZE;
                         #endif
                     }
                     else if (ssl->suites->hashAlgo == sha256_mac) {
                         #ifndef NO_SHA256
-                            digest = ssl->certHashes.sha256;
+                            digest = ssl->hsHashes->certHashes.sha256;
                             typeH    = SHA256h;
                             digestSz = SHA256_DIGEST_SIZE;
                         #endif
                     }
                     else if (ssl->suites->hashAlgo == sha384_mac) {
                         #ifdef CYASSL_SHA384
-                            digest = ssl->certHashes.sha384;
+                            digest = ssl->hsHashes->certHashes.sha384;
                             typeH    = SHA384h;
                             digestSz = SHA384_DIGEST_SIZE;
                         #endif
@@ -11288,6 +15553,15 @@ static void PickHashSigAlgo(CYASSL* ssl,
                 }
 
                 c16toa((word16)length, verify + extraSz); /* prepend hdr */
+            #ifdef CYASSL_ASYNC_CRYPT
+                if (ssl->ctx->AsyncSubmitCb) {
+                    word32 ioLen = ENCRYPT_LEN;
+                    ret = AsyncPkOp(ssl, CYASSL_ASYNC_RSA_SIGN, signBuffer,
+                                    signSz, verify + extraSz + VERIFY_HEADER,
+                                    &ioLen);
+                }
+                else
+            #endif
                 if (doUserRsa) {
                 #ifdef HAVE_PK_CALLBACKS
                     #ifndef NO_RSA
@@ -11303,7 +15577,7 @@ static void PickHashSigAlgo(CYASSL* ssl,
                 }
                 else {
                     ret = RsaSSL_Sign(signBuffer, signSz, verify + extraSz +
-                                  VERIFY_HEADER, ENCRYPT_LEN, &key, ssl->rng);
+                                  VERIFY_HEADER, ENCRYPT_LEN, signKey, ssl->rng);
                 }
 
                 if (ret > 0)
@@ -11351,18 +15625,26 @@ static void PickHashSigAlgo(CYASSL* ssl,
 
                 #ifdef CYASSL_DTLS
                     if (ssl->options.dtls) {
-                        if ((ret = DtlsPoolSave(ssl, output, sendSz)) != 0)
-                            return ret;
+                        if (ret == 0)
+                            ret = DtlsPoolSave(ssl, output, sendSz);
                     }
                 #endif
             }
         }
 #ifndef NO_RSA
         if (initRsaKey)
-            FreeRsaKey(&key);
+            FreeRsaKey(key);
 #endif
 #ifdef HAVE_ECC
-        ecc_free(&eccKey);
+        ecc_free(eccKey);
+#endif
+#ifdef CYASSL_SMALL_STACK
+    #ifndef NO_RSA
+        XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    #endif
+    #ifdef HAVE_ECC
+        XFREE(eccKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    #endif
 #endif
 
         if (ret == 0) {
@@ -11374,10 +15656,7 @@ static void PickHashSigAlgo(CYASSL* ssl,
                                   output, sendSz, ssl->heap);
             #endif
             ssl->buffers.outputBuffer.length += sendSz;
-            if (ssl->options.groupMessages)
-                return 0;
-            else
-                return SendBuffered(ssl);
+            return SendFlightPart(ssl);
         }
         else
             return ret;
@@ -11447,7 +15726,7 @@ int DoSessionTicket(CYASSL* ssl,
 
     ssl->expect_session_ticket = 0;
 
-    return BuildFinished(ssl, &ssl->verifyHashes, server);
+    return BuildFinished(ssl, &ssl->hsHashes->verifyHashes, server);
 }
 #endif /* HAVE_SESSION_TICKET */
 
@@ -11468,6 +15747,27 @@ int DoSessionTicket(CYASSL* ssl,
                + SUITE_LEN
                + ENUM_LEN;
 
+#ifdef HAVE_ENCRYPT_THEN_MAC
+        /* RFC 7366, no response when the chosen suite isn't a block one */
+        if (ssl->encrypt_then_mac && RECORD_TYPE(ssl) != block) {
+            TLSX* etm = TLSX_Find(ssl->extensions, ENCRYPT_THEN_MAC);
+
+            if (etm)
+                etm->resp = 0;
+            ssl->encrypt_then_mac = 0;
+        }
+#endif
+
+#ifdef HAVE_CACHED_INFO
+        /* only the CTX's own chain has its hash at hand */
+        if (ssl->ctx->certMsg.buffer &&
+                ssl->buffers.certificate.buffer == ssl->ctx->certificate.buffer &&
+                ssl->buffers.certChain.buffer   == ssl->ctx->certChain.buffer)
+            TLSX_CachedInfo_Respond(ssl, ssl->ctx->certMsgHash);
+        else
+            ssl->cached_cert = 0;
+#endif
+
 #ifdef HAVE_TLS_EXTENSIONS
         length += TLSX_GetResponseSize(ssl);
 #endif
@@ -11569,10 +15869,7 @@ int DoSessionTicket(CYASSL* ssl,
 
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
 
-        if (ssl->options.groupMessages)
-            return 0;
-        else
-            return SendBuffered(ssl);
+        return SendFlightPart(ssl);
     }
 
 
@@ -11614,6 +15911,85 @@ int DoSessionTicket(CYASSL* ssl,
 
 #endif /* HAVE_ECC25519 */
 
+#ifdef HAVE_EPHEMERAL_KEY_POOL
+#ifdef HAVE_ECC
+
+    /* take a pre-generated ECDHE key from the ctx pool, 1 if there was one */
+    static int UsePooledEccKey(CYASSL* ssl)
+    {
+        KeyPool* pool = &ssl->ctx->keyPool;
+        ecc_key* key  = NULL;
+
+        if (LockMutex(&pool->mutex) != 0)
+            return 0;
+        if (pool->eccCount > 0 && pool->eccKeySz == ssl->eccTempKeySz)
+            key = pool->ecc[--pool->eccCount];
+        UnLockMutex(&pool->mutex);
+
+        if (key == NULL)
+            return 0;
+
+        /* ours was only initialized, nothing to free inside */
+        HsFree(ssl, ssl->eccTempKey, DYNAMIC_TYPE_ECC);
+        ssl->eccTempKey = key;
+
+        return 1;
+    }
+
+#endif /* HAVE_ECC */
+#ifdef HAVE_ECC25519
+
+    static int UsePooledEcc25519Key(CYASSL* ssl)
+    {
+        KeyPool*      pool = &ssl->ctx->keyPool;
+        ecc25519_key* key  = NULL;
+
+        if (LockMutex(&pool->mutex) != 0)
+            return 0;
+        if (pool->ecc25519Count > 0 &&
+                              pool->ecc25519KeySz == ssl->ecc25519TempKeySz)
+            key = pool->ecc25519[--pool->ecc25519Count];
+        UnLockMutex(&pool->mutex);
+
+        if (key == NULL)
+            return 0;
+
+        HsFree(ssl, ssl->ecc25519TempKey, DYNAMIC_TYPE_ECC);
+        ssl->ecc25519TempKey = key;
+
+        return 1;
+    }
+
+#endif /* HAVE_ECC25519 */
+#else
+    #define UsePooledEccKey(ssl)      0
+    #define UsePooledEcc25519Key(ssl) 0
+#endif /* HAVE_EPHEMERAL_KEY_POOL */
+
+#ifndef NO_DH
+
+    /* ssl's server DH group in key, with the ctx's g table when ssl still
+       has the ctx's parameters */
+    static int SetServerDhKey(CYASSL* ssl, DhKey* key)
+    {
+        int ret;
+
+        InitDhKey(key);
+        ret = DhSetKey(key, ssl->buffers.serverDH_P.buffer,
+                            ssl->buffers.serverDH_P.length,
+                            ssl->buffers.serverDH_G.buffer,
+                            ssl->buffers.serverDH_G.length);
+    #ifndef NO_CERTS
+        if (ret == 0 && ssl->ctx->serverDH_Fb &&
+                ssl->buffers.serverDH_P.buffer == ssl->ctx->serverDH_P.buffer)
+            DhUseFixedBase(key, ssl->ctx->serverDH_Fb);
+    #endif
+
+        return ret;
+    }
+
+#endif /* NO_DH */
+
     int SendServerKeyExchange(CYASSL* ssl)
     {
         int ret = 0;
@@ -11676,10 +16052,7 @@ int DoSessionTicket(CYASSL* ssl,
         #endif
 
             ssl->buffers.outputBuffer.length += sendSz;
-            if (ssl->options.groupMessages)
-                ret = 0;
-            else
-                ret = SendBuffered(ssl);
+            ret = SendFlightPart(ssl);
             ssl->options.serverState = SERVER_KEYEXCHANGE_COMPLETE;
         }
     #endif /*NO_PSK */
@@ -11712,11 +16085,8 @@ int DoSessionTicket(CYASSL* ssl,
                     return MEMORY_E;
             }
 
-            InitDhKey(&dhKey);
-            ret = DhSetKey(&dhKey, ssl->buffers.serverDH_P.buffer,
-                                   ssl->buffers.serverDH_P.length,
-                                   ssl->buffers.serverDH_G.buffer,
-                                   ssl->buffers.serverDH_G.length);
+            HS_TIMING_OPEN(ssl, CYASSL_HS_KEYGEN);
+            ret = SetServerDhKey(ssl, &dhKey);
             if (ret == 0)
                 ret = DhGenerateKeyPair(&dhKey, ssl->rng,
                                          ssl->buffers.serverDH_Priv.buffer,
@@ -11724,6 +16094,7 @@ int DoSessionTicket(CYASSL* ssl,
                                          ssl->buffers.serverDH_Pub.buffer,
                                         &ssl->buffers.serverDH_Pub.length);
             FreeDhKey(&dhKey);
+            HS_TIMING_CLOSE(ssl, CYASSL_HS_KEYGEN, server_key_exchange);
             if (ret != 0)
                 return ret;
 
@@ -11804,10 +16175,7 @@ int DoSessionTicket(CYASSL* ssl,
         #endif
 
             ssl->buffers.outputBuffer.length += sendSz;
-            if (ssl->options.groupMessages)
-                ret = 0;
-            else
-                ret = SendBuffered(ssl);
+            ret = SendFlightPart(ssl);
             ssl->options.serverState = SERVER_KEYEXCHANGE_COMPLETE;
         }
     #endif /* !NO_DH && !NO_PSK */
@@ -11821,10 +16189,20 @@ int DoSessionTicket(CYASSL* ssl,
             word32   sigSz;
             word32   preSigSz, preSigIdx;
         #ifndef NO_RSA
-            RsaKey   rsaKey;
+        #ifdef CYASSL_SMALL_STACK
+            RsaKey*  rsaKey = NULL;
+        #else
+            RsaKey   rsaKey[1];
+        #endif
+            RsaKey*  signKey = NULL;        /* rsaKey or the ctx's decoded */
         #endif
         #ifdef HAVE_ECC
-            ecc_key  dsaKey;
+        #ifdef CYASSL_SMALL_STACK
+            ecc_key* dsaKey = NULL;
+        #else
+            ecc_key  dsaKey[1];
+        #endif
+            ecc_key* signEccKey = NULL;     /* dsaKey or the ctx's decoded */
         #endif
         #ifdef CYASSL_SMALL_STACK
             byte*   exportBuf = NULL;
@@ -11847,17 +16225,21 @@ int DoSessionTicket(CYASSL* ssl,
             if (ssl->specs.useCurve25519) {
 	            /* in case used set_accept_state after init */
 	            if (ssl->ecc25519TempKeyPresent == 0) {
-	                if (ecc25519_make_key(ssl->rng, ssl->ecc25519TempKeySz,
+	                HS_TIMING_OPEN(ssl, CYASSL_HS_KEYGEN);
+	                if (!UsePooledEcc25519Key(ssl) &&
+	                    ecc25519_make_key(ssl->rng, ssl->ecc25519TempKeySz,
 	                                 ssl->ecc25519TempKey) != 0) {
 	                    ssl->error = ECC_MAKEKEY_ERROR;
 	                    CYASSL_ERROR(ssl->error);
 	                    return ECC_MAKEKEY_ERROR;
 	                }
+	                HS_TIMING_CLOSE(ssl, CYASSL_HS_KEYGEN,
+	                                server_key_exchange);
 	                ssl->ecc25519TempKeyPresent = 1;
 	            }
 
             #ifdef CYASSL_SMALL_STACK
-                exportBuf = (byte*)XMALLOC(MAX_EXPORT_ECC_SX, NULL,
+                exportBuf = (byte*)XMALLOC(MAX_EXPORT_ECC_SZ, NULL,
                         DYNAMIC_TYPE_TMP_BUFFER);
                 if (exportBuf == NULL)
                     return MEMORY_E;
@@ -11871,16 +16253,20 @@ int DoSessionTicket(CYASSL* ssl,
 #ifdef HAVE_ECC
             if (!ssl->specs.useCurve25519) {
 	            if (ssl->eccTempKeyPresent == 0) {
-	                if (ecc_make_key(ssl->rng, ssl->eccTempKeySz,
+	                HS_TIMING_OPEN(ssl, CYASSL_HS_KEYGEN);
+	                if (!UsePooledEccKey(ssl) &&
+	                    ecc_make_key(ssl->rng, ssl->eccTempKeySz,
 	                                 ssl->eccTempKey) != 0) {
 	                    ssl->error = ECC_MAKEKEY_ERROR;
 	                    CYASSL_ERROR(ssl->error);
 	                    return ECC_MAKEKEY_ERROR;
 	                }
+	                HS_TIMING_CLOSE(ssl, CYASSL_HS_KEYGEN,
+	                                server_key_exchange);
 	                ssl->eccTempKeyPresent = 1;
 	            }
             #ifdef CYASSL_SMALL_STACK
-                exportBuf = (byte*)XMALLOC(MAX_EXPORT_ECC_SX, NULL,
+                exportBuf = (byte*)XMALLOC(MAX_EXPORT_ECC_SZ, NULL,
                         DYNAMIC_TYPE_TMP_BUFFER);
                 if (exportBuf == NULL)
                     return MEMORY_E;
@@ -11895,13 +16281,28 @@ int DoSessionTicket(CYASSL* ssl,
             preSigSz  = length;
             preSigIdx = idx;
 
+        #ifdef CYASSL_SMALL_STACK
+        #ifndef NO_RSA
+            rsaKey = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+            if (rsaKey == NULL)
+                ERROR_OUT(MEMORY_E, done_a);
+        #endif
+        #ifdef HAVE_ECC
+            dsaKey = (ecc_key*)XMALLOC(sizeof(ecc_key), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+            if (dsaKey == NULL)
+                ERROR_OUT(MEMORY_E, done_a);
+        #endif
+        #endif
+
         #ifndef NO_RSA
-            ret = InitRsaKey(&rsaKey, ssl->heap);
+            ret = InitRsaKey(rsaKey, ssl->heap);
             if (ret != 0)
                 goto done_a;
         #endif
         #ifdef HAVE_ECC
-            ecc_init(&dsaKey);
+            ecc_init(dsaKey);
         #endif
 
             /* sig length */
@@ -11909,10 +16310,10 @@ int DoSessionTicket(CYASSL* ssl,
 
             if (!ssl->buffers.key.buffer) {
             #ifndef NO_RSA
-                FreeRsaKey(&rsaKey);
+                FreeRsaKey(rsaKey);
             #endif
             #ifdef HAVE_ECC
-                ecc_free(&dsaKey);
+                ecc_free(dsaKey);
             #endif
                 ERROR_OUT(NO_PRIVATE_KEY, done_a);
             }
@@ -11920,32 +16321,28 @@ int DoSessionTicket(CYASSL* ssl,
         #ifndef NO_RSA
             if (ssl->specs.sig_algo == rsa_sa_algo) {
                 /* rsa sig size */
-                word32 i = 0;
-                ret = RsaPrivateKeyDecode(ssl->buffers.key.buffer, &i,
-                                          &rsaKey, ssl->buffers.key.length);
+                ret = DecodeRsaPrivateKey(ssl, rsaKey, &signKey);
                 if (ret != 0)
                     goto done_a;
-                sigSz = RsaEncryptSize(&rsaKey); 
+                sigSz = RsaEncryptSize(signKey);
             } else 
 #endif
         #ifdef HAVE_ECC
            if (ssl->specs.sig_algo == ecc_dsa_sa_algo) {
                 /* ecdsa sig size */
-                word32 i = 0;
-                ret = EccPrivateKeyDecode(ssl->buffers.key.buffer, &i,
-                                          &dsaKey, ssl->buffers.key.length);
+                ret = DecodeEccPrivateKey(ssl, dsaKey, &signEccKey);
                 if (ret != 0)
                     goto done_a;
-                sigSz = ecc_sig_size(&dsaKey);  /* worst case estimate */
+                sigSz = ecc_sig_size(signEccKey);  /* worst case estimate */
             }
             else
         #endif
             {
         #ifndef NO_RSA
-                FreeRsaKey(&rsaKey);
+                FreeRsaKey(rsaKey);
         #endif
         #ifdef HAVE_ECC
-                ecc_free(&dsaKey);
+                ecc_free(dsaKey);
         #endif
                 ERROR_OUT(ALGO_ID_E, done_a);  /* unsupported type */
             }
@@ -11966,10 +16363,10 @@ int DoSessionTicket(CYASSL* ssl,
             /* check for available size */
             if ((ret = CheckAvailableSize(ssl, sendSz)) != 0) {
             #ifndef NO_RSA
-                FreeRsaKey(&rsaKey);
+                FreeRsaKey(rsaKey);
             #endif
             #ifdef HAVE_ECC
-                ecc_free(&dsaKey); 
+                ecc_free(dsaKey); 
             #endif
                 goto done_a;
             } 
@@ -12177,6 +16574,14 @@ int DoSessionTicket(CYASSL* ssl,
                     c16toa((word16)sigSz, output + idx);
                     idx += LENGTH_SZ;
 
+                #ifdef CYASSL_ASYNC_CRYPT
+                    if (ssl->ctx->AsyncSubmitCb) {
+                        word32 ioLen = sigSz;
+                        ret = AsyncPkOp(ssl, CYASSL_ASYNC_RSA_SIGN, signBuffer,
+                                        signSz, output + idx, &ioLen);
+                    }
+                    else
+                #endif
                     if (doUserRsa) {
                     #ifdef HAVE_PK_CALLBACKS
                         word32 ioLen = sigSz;
@@ -12187,16 +16592,20 @@ int DoSessionTicket(CYASSL* ssl,
                                             ssl->RsaSignCtx);
                     #endif /*HAVE_PK_CALLBACKS */
                     }
-                    else
+                    else {
+                        HS_TIMING_OPEN(ssl, CYASSL_HS_SIGN);
                         ret = RsaSSL_Sign(signBuffer, signSz, output + idx,
-                                          sigSz, &rsaKey, ssl->rng);
+                                          sigSz, signKey, ssl->rng);
+                        HS_TIMING_CLOSE(ssl, CYASSL_HS_SIGN,
+                                        server_key_exchange);
+                    }
 
-                    FreeRsaKey(&rsaKey);
+                    FreeRsaKey(rsaKey);
                 #ifdef HAVE_ECC
-                    ecc_free(&dsaKey);
+                    ecc_free(dsaKey);
                 #endif
                 #ifdef CYASSL_SMALL_STACK
-                    XFREE(encodeSig, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+                    XFREE(encodedSig, NULL, DYNAMIC_TYPE_TMP_BUFFER);
                 #endif
                     if (ret < 0)
                         goto done_a2;
@@ -12243,6 +16652,12 @@ int DoSessionTicket(CYASSL* ssl,
                         }
                     }
 
+                #ifdef CYASSL_ASYNC_CRYPT
+                    if (ssl->ctx->AsyncSubmitCb)
+                        ret = AsyncPkOp(ssl, CYASSL_ASYNC_ECC_SIGN, digest,
+                                       digestSz, output + LENGTH_SZ + idx, &sz);
+                    else
+                #endif
                     if (doUserEcc) {
                     #ifdef HAVE_PK_CALLBACKS
                         #ifdef HAVE_ECC
@@ -12255,13 +16670,16 @@ int DoSessionTicket(CYASSL* ssl,
                     #endif /*HAVE_PK_CALLBACKS */
                     }
                     else {
+                        HS_TIMING_OPEN(ssl, CYASSL_HS_SIGN);
                         ret = ecc_sign_hash(digest, digestSz,
-                              output + LENGTH_SZ + idx, &sz, ssl->rng, &dsaKey);
+                              output + LENGTH_SZ + idx, &sz, ssl->rng, signEccKey);
+                        HS_TIMING_CLOSE(ssl, CYASSL_HS_SIGN,
+                                        server_key_exchange);
                     }
                 #ifndef NO_RSA
-                    FreeRsaKey(&rsaKey);
+                    FreeRsaKey(rsaKey);
                 #endif
-                    ecc_free(&dsaKey);
+                    ecc_free(dsaKey);
 
                     if (ret < 0)
                         goto done_a2;
@@ -12316,15 +16734,18 @@ int DoSessionTicket(CYASSL* ssl,
         #endif
 
             ssl->buffers.outputBuffer.length += sendSz;
-            if (ssl->options.groupMessages)
-                ret = 0;
-            else
-                ret = SendBuffered(ssl);
+            ret = SendFlightPart(ssl);
             ssl->options.serverState = SERVER_KEYEXCHANGE_COMPLETE;
 
         done_a:
         #ifdef CYASSL_SMALL_STACK
             XFREE(exportBuf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        #ifndef NO_RSA
+            XFREE(rsaKey,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        #endif
+        #ifdef HAVE_ECC
+            XFREE(dsaKey,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        #endif
         #endif
 
             return ret;
@@ -12336,9 +16757,14 @@ int DoSessionTicket(CYASSL* ssl,
             byte    *output;
             word32   length = 0, idx = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
             int      sendSz;
-            word32   sigSz = 0, i = 0;
+            word32   sigSz = 0;
             word32   preSigSz = 0, preSigIdx = 0;
-            RsaKey   rsaKey;
+        #ifdef CYASSL_SMALL_STACK
+            RsaKey*  rsaKey = NULL;
+        #else
+            RsaKey   rsaKey[1];
+        #endif
+            RsaKey*  signKey = NULL;        /* rsaKey or the ctx's decoded */
             DhKey    dhKey;
 
             if (ssl->buffers.serverDH_P.buffer == NULL ||
@@ -12361,11 +16787,8 @@ int DoSessionTicket(CYASSL* ssl,
                     return MEMORY_E;
             }
 
-            InitDhKey(&dhKey);
-            ret = DhSetKey(&dhKey, ssl->buffers.serverDH_P.buffer,
-                                   ssl->buffers.serverDH_P.length,
-                                   ssl->buffers.serverDH_G.buffer,
-                                   ssl->buffers.serverDH_G.length);
+            HS_TIMING_OPEN(ssl, CYASSL_HS_KEYGEN);
+            ret = SetServerDhKey(ssl, &dhKey);
             if (ret == 0)
                 ret = DhGenerateKeyPair(&dhKey, ssl->rng,
                                          ssl->buffers.serverDH_Priv.buffer,
@@ -12373,6 +16796,7 @@ int DoSessionTicket(CYASSL* ssl,
                                          ssl->buffers.serverDH_Pub.buffer,
                                         &ssl->buffers.serverDH_Pub.length);
             FreeDhKey(&dhKey);
+            HS_TIMING_CLOSE(ssl, CYASSL_HS_KEYGEN, server_key_exchange);
 
             if (ret != 0) return ret;
 
@@ -12385,23 +16809,42 @@ int DoSessionTicket(CYASSL* ssl,
             preSigSz  = length;
 
             if (!ssl->options.usingAnon_cipher) {
-                ret = InitRsaKey(&rsaKey, ssl->heap);
-                if (ret != 0) return ret;
+            #ifdef CYASSL_SMALL_STACK
+                rsaKey = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+                if (rsaKey == NULL)
+                    return MEMORY_E;
+            #endif
+
+                ret = InitRsaKey(rsaKey, ssl->heap);
+                if (ret != 0) {
+                #ifdef CYASSL_SMALL_STACK
+                    XFREE(rsaKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+                #endif
+                    return ret;
+                }
 
                 /* sig length */
                 length += LENGTH_SZ;
 
-                if (!ssl->buffers.key.buffer)
+                if (!ssl->buffers.key.buffer) {
+                    FreeRsaKey(rsaKey);
+                #ifdef CYASSL_SMALL_STACK
+                    XFREE(rsaKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+                #endif
                     return NO_PRIVATE_KEY;
+                }
 
-                ret = RsaPrivateKeyDecode(ssl->buffers.key.buffer, &i, &rsaKey,
-                                          ssl->buffers.key.length);
+                ret = DecodeRsaPrivateKey(ssl, rsaKey, &signKey);
                 if (ret == 0) {
-                    sigSz = RsaEncryptSize(&rsaKey);
+                    sigSz = RsaEncryptSize(signKey);
                     length += sigSz;
                 }
                 else {
-                    FreeRsaKey(&rsaKey);
+                    FreeRsaKey(rsaKey);
+                #ifdef CYASSL_SMALL_STACK
+                    XFREE(rsaKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+                #endif
                     return ret;
                 }
 
@@ -12422,7 +16865,10 @@ int DoSessionTicket(CYASSL* ssl,
             /* check for available size */
             if ((ret = CheckAvailableSize(ssl, sendSz)) != 0) {
                 if (!ssl->options.usingAnon_cipher)
-                    FreeRsaKey(&rsaKey);
+                    FreeRsaKey(rsaKey);
+            #ifdef CYASSL_SMALL_STACK
+                XFREE(rsaKey, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            #endif
                 return ret;
             }
 
@@ -12509,9 +16955,8 @@ int DoSessionTicket(CYASSL* ssl,
                 hash = (byte*)XMALLOC(FINISHED_SZ, NULL,
                                                        DYNAMIC_TYPE_TMP_BUFFER);
                 if (hash == NULL)
-                    return MEMORY_E; /* No heap commitment before this point,
-                                        from now on, the resources are freed
-                                        at done_b. */
+                    ERROR_OUT(MEMORY_E, done_b); /* from now on, the resources
+                                                    are freed at done_b. */
             #endif
 
         #ifndef NO_OLD_TLS
@@ -12644,11 +17089,15 @@ int DoSessionTicket(CYASSL* ssl,
                                                   ssl->RsaSignCtx);
                     #endif
                     }
-                    else
+                    else {
+                        HS_TIMING_OPEN(ssl, CYASSL_HS_SIGN);
                         ret = RsaSSL_Sign(signBuffer, signSz, output + idx,
-                                          sigSz, &rsaKey, ssl->rng);
+                                          sigSz, signKey, ssl->rng);
+                        HS_TIMING_CLOSE(ssl, CYASSL_HS_SIGN,
+                                        server_key_exchange);
+                    }
 
-                    FreeRsaKey(&rsaKey);
+                    FreeRsaKey(rsaKey);
 
                 #ifdef CYASSL_SMALL_STACK
                     XFREE(encodedSig, NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -12671,6 +17120,7 @@ int DoSessionTicket(CYASSL* ssl,
                 XFREE(sha384,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
                 XFREE(hash384, NULL, DYNAMIC_TYPE_TMP_BUFFER);
             #endif
+                XFREE(rsaKey,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
         #endif
 
                 if (ret < 0) return ret;
@@ -12694,10 +17144,7 @@ int DoSessionTicket(CYASSL* ssl,
         #endif
 
             ssl->buffers.outputBuffer.length += sendSz;
-            if (ssl->options.groupMessages)
-                ret = 0;
-            else
-                ret = SendBuffered(ssl);
+            ret = SendFlightPart(ssl);
             ssl->options.serverState = SERVER_KEYEXCHANGE_COMPLETE;
         }
     #endif /* NO_DH */
@@ -12707,11 +17154,40 @@ int DoSessionTicket(CYASSL* ssl,
     }
 
 
-    /* Make sure server cert/key are valid for this suite, true on success */
-    static int VerifyServerSuite(CYASSL* ssl, word16 idx)
+    /* keys this end has for the suites, as REQUIRES_* flags */
+    static int ServerSuiteKeys(CYASSL* ssl)
     {
-        int  haveRSA = !ssl->options.haveStaticECC;
-        int  havePSK = 0;
+        int have = 0;
+
+        if (!ssl->options.haveStaticECC && !ssl->options.haveNTRU)
+            have |= REQUIRES_RSA;
+        if (ssl->options.haveDH)
+            have |= REQUIRES_DHE;
+        if (ssl->options.haveECDSAsig)
+            have |= REQUIRES_ECC_DSA;
+        if (ssl->options.haveStaticECC)
+            have |= REQUIRES_ECC_STATIC;
+    #ifndef NO_PSK
+        if (ssl->options.havePSK)
+            have |= REQUIRES_PSK;
+    #endif
+        if (ssl->options.haveNTRU)
+            have |= REQUIRES_NTRU;
+        if (!(ssl->options.side == CYASSL_SERVER_END &&
+                                             ssl->options.haveECDSAsig == 1))
+            have |= REQUIRES_RSA_SIG;
+        if (ssl->options.haveDualCert)
+            have |= REQUIRES_RSA | REQUIRES_RSA_SIG | REQUIRES_ECC_DSA;
+
+        return have;
+    }
+
+
+    /* Make sure server cert/key are valid for this suite, true on success,
+       have is from ServerSuiteKeys */
+    static int VerifyServerSuite(CYASSL* ssl, word16 idx, int have)
+    {
+        int  missing;
         byte first;
         byte second;
 
@@ -12725,68 +17201,10 @@ int DoSessionTicket(CYASSL* ssl,
         first   = ssl->suites->suites[idx];
         second  = ssl->suites->suites[idx+1];
 
-        #ifndef NO_PSK
-            havePSK = ssl->options.havePSK;
-        #endif
-
-        if (ssl->options.haveNTRU)
-            haveRSA = 0;
-
-        if (CipherRequires(first, second, REQUIRES_RSA)) {
-            CYASSL_MSG("Requires RSA");
-            if (haveRSA == 0) {
-                CYASSL_MSG("Don't have RSA");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_DHE)) {
-            CYASSL_MSG("Requires DHE");
-            if (ssl->options.haveDH == 0) {
-                CYASSL_MSG("Don't have DHE");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_ECC_DSA)) {
-            CYASSL_MSG("Requires ECCDSA");
-            if (ssl->options.haveECDSAsig == 0) {
-                CYASSL_MSG("Don't have ECCDSA");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_ECC_STATIC)) {
-            CYASSL_MSG("Requires static ECC");
-            if (ssl->options.haveStaticECC == 0) {
-                CYASSL_MSG("Don't have static ECC");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_PSK)) {
-            CYASSL_MSG("Requires PSK");
-            if (havePSK == 0) {
-                CYASSL_MSG("Don't have PSK");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_NTRU)) {
-            CYASSL_MSG("Requires NTRU");
-            if (ssl->options.haveNTRU == 0) {
-                CYASSL_MSG("Don't have NTRU");
-                return 0;
-            }
-        }
-
-        if (CipherRequires(first, second, REQUIRES_RSA_SIG)) {
-            CYASSL_MSG("Requires RSA Signature");
-            if (ssl->options.side == CYASSL_SERVER_END &&
-                                           ssl->options.haveECDSAsig == 1) {
-                CYASSL_MSG("Don't have RSA Signature");
-                return 0;
-            }
+        missing = CipherRequirements(first, second) & ~have;
+        if (missing) {
+            CYASSL_MSG("Don't have a key or signature type the suite requires");
+            return 0;
         }
 
 #ifdef HAVE_SUPPORTED_CURVES
@@ -12811,9 +17229,32 @@ int DoSessionTicket(CYASSL* ssl,
     }
 
 
+    /* rows of a suite bitmap, by first suite byte */
+    enum {
+        SUITE_ROW_NORMAL,
+        SUITE_ROW_ECC,
+        SUITE_ROW_CHACHA,
+        SUITE_ROWS,
+        SUITE_ROW_SZ = 256 / 8
+    };
+
+    static INLINE int SuiteRow(byte first)
+    {
+        switch (first) {
+            case ECC_BYTE:    return SUITE_ROW_ECC;
+            case CHACHA_BYTE: return SUITE_ROW_CHACHA;
+            case 0x00:        return SUITE_ROW_NORMAL;
+            default:          return -1;    /* none we could pick anyway */
+        }
+    }
+
+
     static int MatchSuite(CYASSL* ssl, Suites* peerSuites)
     {
-        word16 i, j;
+        word16 i;
+        int    have;
+        int    pass;
+        byte   offered[SUITE_ROWS][SUITE_ROW_SZ];   /* peer's suites as bits */
 
         CYASSL_ENTER("MatchSuite");
 
@@ -12823,27 +17264,57 @@ int DoSessionTicket(CYASSL* ssl,
 
         if (ssl->suites == NULL)
             return SUITES_ERROR;
-        /* start with best, if a match we are good */
-        for (i = 0; i < ssl->suites->suiteSz; i += 2)
-            for (j = 0; j < peerSuites->suiteSz; j += 2)
-                if (ssl->suites->suites[i]   == peerSuites->suites[j] &&
-                    ssl->suites->suites[i+1] == peerSuites->suites[j+1] ) {
-
-                    if (VerifyServerSuite(ssl, i)) {
-                        int result;
-                        CYASSL_MSG("Verified suite validity");
-                        ssl->options.cipherSuite0 = ssl->suites->suites[i];
-                        ssl->options.cipherSuite  = ssl->suites->suites[i+1];
-                        result = SetCipherSpecs(ssl);
-                        if (result == 0)
-                            PickHashSigAlgo(ssl, peerSuites->hashSigAlgo,
-                                                 peerSuites->hashSigAlgoSz);
-                        return result;
-                    }
-                    else {
-                        CYASSL_MSG("Could not verify suite validity, continue");
-                    }
+
+        /* one pass over each list instead of comparing every pair */
+        XMEMSET(offered, 0, sizeof(offered));
+        for (i = 0; i < peerSuites->suiteSz; i += 2) {
+            int  row    = SuiteRow(peerSuites->suites[i]);
+            byte second = peerSuites->suites[i+1];
+
+            if (row >= 0)
+                offered[row][second >> 3] |= (byte)(1 << (second & 7));
+        }
+
+        have = ServerSuiteKeys(ssl);
+
+        /* with both certs a first pass takes ECDSA if the client can */
+        for (pass = ssl->options.haveDualCert ? 0 : 1; pass < 2; pass++) {
+            /* start with best, if a match we are good */
+            for (i = 0; i < ssl->suites->suiteSz; i += 2) {
+                int  row    = SuiteRow(ssl->suites->suites[i]);
+                byte first  = ssl->suites->suites[i];
+                byte second = ssl->suites->suites[i+1];
+                int  ecdsa;
+
+                if (row < 0 ||
+                           !(offered[row][second >> 3] & (1 << (second & 7))))
+                    continue;
+
+                ecdsa = (CipherRequirements(first, second) &
+                                                        REQUIRES_ECC_DSA) != 0;
+                if (pass == 0 && !ecdsa)
+                    continue;
+
+                if (VerifyServerSuite(ssl, i, have)) {
+                    int result;
+                    CYASSL_MSG("Verified suite validity");
+                #if defined(HAVE_ECC) && !defined(NO_CERTS)
+                    if (ssl->options.haveDualCert)
+                        PickServerCert(ssl, ssl->ctx, ecdsa);
+                #endif
+                    ssl->options.cipherSuite0 = first;
+                    ssl->options.cipherSuite  = second;
+                    result = SetCipherSpecs(ssl);
+                    if (result == 0)
+                        PickHashSigAlgo(ssl, peerSuites->hashSigAlgo,
+                                             peerSuites->hashSigAlgoSz);
+                    return result;
+                }
+                else {
+                    CYASSL_MSG("Could not verify suite validity, continue");
                 }
+            }
+        }
 
         return MATCH_SUITE_ERROR;
     }
@@ -12872,22 +17343,12 @@ int DoSessionTicket(CYASSL* ssl,
 #endif
 
         /* manually hash input since different format */
-#ifndef NO_OLD_TLS
-#ifndef NO_MD5
-        Md5Update(&ssl->hashMd5, input + idx, sz);
-#endif
-#ifndef NO_SHA
-        ShaUpdate(&ssl->hashSha, input + idx, sz);
-#endif
-#endif
-#ifndef NO_SHA256
-        if (IsAtLeastTLSv1_2(ssl)) {
-            int shaRet = Sha256Update(&ssl->hashSha256, input + idx, sz);
+        {
+            int hashRet = HashRaw(ssl, input + idx, sz);
 
-            if (shaRet != 0)
-                return shaRet;
+            if (hashRet != 0)
+                return hashRet;
         }
-#endif
 
         /* does this value mean client_hello? */
         idx++;
@@ -12935,7 +17396,7 @@ int DoSessionTicket(CYASSL* ssl,
             InitSuites(ssl->suites, ssl->version, haveRSA, havePSK,
                        ssl->options.haveDH, ssl->options.haveNTRU,
                        ssl->options.haveECDSAsig, ssl->options.haveStaticECC,
-                       ssl->options.side);
+                       ssl->options.haveDualCert, ssl->options.side);
         }
 
         /* suite size */
@@ -13008,31 +17469,174 @@ int DoSessionTicket(CYASSL* ssl,
                     ssl->session = *session; /* restore session certs. */
                 #endif
 
-                ret = RNG_GenerateBlock(ssl->rng, ssl->arrays->serverRandom,
-                                                                       RAN_LEN);
-                if (ret != 0)
-                    return ret;
+                ret = RNG_GenerateBlock(ssl->rng, ssl->arrays->serverRandom,
+                                                                       RAN_LEN);
+                if (ret != 0)
+                    return ret;
+
+                #ifdef NO_OLD_TLS
+                    ret = DeriveTlsKeys(ssl);
+                #else
+                    #ifndef NO_TLS
+                        if (ssl->options.tls)
+                            ret = DeriveTlsKeys(ssl);
+                    #endif
+                        if (!ssl->options.tls)
+                            ret = DeriveKeys(ssl);
+                #endif
+                ssl->options.clientState = CLIENT_KEYEXCHANGE_COMPLETE;
+
+                return ret;
+            }
+        }
+
+        return MatchSuite(ssl, &clSuites);
+    }
+
+#endif /* OLD_HELLO_ALLOWED */
+
+
+    /* extension types picked out for the ClientHello callback */
+    enum {
+        HELLO_EXT_SERVER_NAME = 0x0000,
+        HELLO_EXT_CURVES      = 0x000a,
+        HELLO_EXT_ALPN        = 0x0010
+    };
+
+    /* point hello's fields into the ClientHello body, no copies and no
+       allocation, only framing is checked */
+    static int GetClientHelloInfo(CYASSL* ssl, const byte* input, word32 sz,
+                                  CYASSL_CLIENT_HELLO* hello)
+    {
+        word32 i = 0;
+        word16 len;
+
+        XMEMSET(hello, 0, sizeof(CYASSL_CLIENT_HELLO));
+
+        if (OPAQUE16_LEN + RAN_LEN + OPAQUE8_LEN > sz)
+            return BUFFER_ERROR;
+        hello->versionMajor = input[i++];
+        hello->versionMinor = input[i++];
+        hello->random = input + i;
+        i += RAN_LEN;
+
+        hello->sessionIdSz = input[i++];
+        hello->sessionId   = input + i;
+        i += hello->sessionIdSz;
+
+    #ifdef CYASSL_DTLS
+        if (ssl->options.dtls) {
+            if (i + OPAQUE8_LEN > sz)
+                return BUFFER_ERROR;
+            i += OPAQUE8_LEN + input[i];                  /* cookie */
+        }
+    #else
+        (void)ssl;
+    #endif
+
+        if (i + OPAQUE16_LEN > sz)
+            return BUFFER_ERROR;
+        ato16(input + i, &len);
+        i += OPAQUE16_LEN;
+        hello->suites   = input + i;
+        hello->suitesSz = len;
+        i += len;
+
+        if (i + OPAQUE8_LEN > sz)
+            return BUFFER_ERROR;
+        i += OPAQUE8_LEN + input[i];                      /* compression */
+        if (i > sz)
+            return BUFFER_ERROR;
+
+        if (i + OPAQUE16_LEN > sz)
+            return 0;                                     /* no extensions */
+        ato16(input + i, &len);
+        i += OPAQUE16_LEN;
+        if (i + len > sz)
+            return BUFFER_ERROR;
+        hello->extensions   = input + i;
+        hello->extensionsSz = len;
+
+        for (sz = i + len; i + HELLO_EXT_TYPE_SZ + OPAQUE16_LEN <= sz;
+                                                                  i += len) {
+            const byte* data;
+            word16      type;
+            word16      listSz;
+
+            ato16(input + i, &type);
+            ato16(input + i + HELLO_EXT_TYPE_SZ, &len);
+            i += HELLO_EXT_TYPE_SZ + OPAQUE16_LEN;
+            if (i + len > sz)
+                return BUFFER_ERROR;
+            data = input + i;
+
+            /* each one a list behind a 2 byte length */
+            if (len < OPAQUE16_LEN)
+                continue;
+            ato16(data, &listSz);
+            if (listSz > len - OPAQUE16_LEN)
+                return BUFFER_ERROR;
+            data += OPAQUE16_LEN;
+
+            switch (type) {
+                case HELLO_EXT_SERVER_NAME:
+                    /* first host_name entry */
+                    if (listSz >= ENUM_LEN + OPAQUE16_LEN && data[0] == 0) {
+                        word16 nameSz;
+
+                        ato16(data + ENUM_LEN, &nameSz);
+                        if (nameSz > listSz - ENUM_LEN - OPAQUE16_LEN)
+                            return BUFFER_ERROR;
+                        hello->sni   = (const char*)data + ENUM_LEN +
+                                       OPAQUE16_LEN;
+                        hello->sniSz = nameSz;
+                    }
+                    break;
 
-                #ifdef NO_OLD_TLS
-                    ret = DeriveTlsKeys(ssl);
-                #else
-                    #ifndef NO_TLS
-                        if (ssl->options.tls)
-                            ret = DeriveTlsKeys(ssl);
-                    #endif
-                        if (!ssl->options.tls)
-                            ret = DeriveKeys(ssl);
-                #endif
-                ssl->options.clientState = CLIENT_KEYEXCHANGE_COMPLETE;
+                case HELLO_EXT_CURVES:
+                    hello->curves   = data;
+                    hello->curvesSz = listSz;
+                    break;
 
-                return ret;
+                case HELLO_EXT_ALPN:
+                    hello->alpn   = data;
+                    hello->alpnSz = listSz;
+                    break;
             }
         }
 
-        return MatchSuite(ssl, &clSuites);
+        return 0;
     }
 
-#endif /* OLD_HELLO_ALLOWED */
+
+    /* show the hello to the ClientHello callback before anything is taken
+       from it. It may move ssl to another CTX, reject it, or suspend so
+       accept can be called again, from another thread too, running the
+       callback of the CTX ssl is in by then. DTLS can't suspend */
+    static int DoClientHelloCb(CYASSL* ssl, const byte* input, word32 sz)
+    {
+        CYASSL_CLIENT_HELLO hello;
+        int                 ret;
+
+        ssl->options.helloCbPending = 0;
+
+        if ((ret = GetClientHelloInfo(ssl, input, sz, &hello)) != 0)
+            return ret;
+
+        ret = ssl->ctx->clientHelloCb(ssl, &hello, ssl->ClientHelloCtx);
+        if (ret == CYASSL_CLIENT_HELLO_OK)
+            return 0;
+
+        if (ret == CYASSL_CLIENT_HELLO_SUSPEND && !ssl->options.dtls) {
+            CYASSL_MSG("ClientHello callback suspended the handshake");
+            ssl->options.helloCbPending = 1;
+            return WANT_CLIENT_HELLO;
+        }
+
+        CYASSL_MSG("ClientHello callback rejected the handshake");
+        SendAlert(ssl, alert_fatal, handshake_failure);
+        return CLIENT_HELLO_REJECT_E;
+    }
 
 
     static int DoClientHello(CYASSL* ssl, const byte* input, word32* inOutIdx,
@@ -13049,10 +17653,22 @@ int DoSessionTicket(CYASSL* ssl,
         if (ssl->toInfoOn) AddLateName("ClientHello", &ssl->timeoutInfo);
 #endif
 
+        if (ssl->ctx->clientHelloCb) {
+            int ret = DoClientHelloCb(ssl, input + i, helloSz);
+            if (ret != 0)
+                return ret;
+        }
+
         /* protocol version, random and session id length check */
         if ((i - begin) + OPAQUE16_LEN + RAN_LEN + OPAQUE8_LEN > helloSz)
             return BUFFER_ERROR;
 
+#ifdef HAVE_SESSION_TICKET
+        /* decided again for each hello, DTLS may send two */
+        ssl->options.createTicket = 0;
+        ssl->options.useTicket    = 0;
+#endif
+
         /* protocol version */
         XMEMCPY(&pv, input + i, OPAQUE16_LEN);
         ssl->chVersion = pv;   /* store */
@@ -13097,7 +17713,7 @@ int DoSessionTicket(CYASSL* ssl,
             InitSuites(ssl->suites, ssl->version, haveRSA, havePSK,
                        ssl->options.haveDH, ssl->options.haveNTRU,
                        ssl->options.haveECDSAsig, ssl->options.haveStaticECC,
-                       ssl->options.side);
+                       ssl->options.haveDualCert, ssl->options.side);
         }
 
         /* random */
@@ -13149,16 +17765,19 @@ int DoSessionTicket(CYASSL* ssl,
                     if ((i - begin) + b > helloSz)
                         return BUFFER_ERROR;
 
-                    if (ssl->ctx->CBIOCookie == NULL) {
-                        CYASSL_MSG("Your Cookie callback is null, please set");
-                        return COOKIE_ERROR;
-                    }
+                    /* CyaSSL_CTX_dtls_listen() already checked this one */
+                    if (!ssl->options.dtlsHelloVerified) {
+                        if (ssl->ctx->CBIOCookie == NULL) {
+                            CYASSL_MSG("Your Cookie callback is null, please set");
+                            return COOKIE_ERROR;
+                        }
 
-                    if ((ssl->ctx->CBIOCookie(ssl, cookie, COOKIE_SZ,
-                                              ssl->IOCB_CookieCtx) != COOKIE_SZ)
-                            || (b != COOKIE_SZ)
-                            || (XMEMCMP(cookie, input + i, b) != 0)) {
-                        return COOKIE_ERROR;
+                        if ((ssl->ctx->CBIOCookie(ssl, cookie, COOKIE_SZ,
+                                             ssl->IOCB_CookieCtx) != COOKIE_SZ)
+                                || (b != COOKIE_SZ)
+                                || (XMEMCMP(cookie, input + i, b) != 0)) {
+                            return COOKIE_ERROR;
+                        }
                     }
 
                     i += b;
@@ -13298,9 +17917,17 @@ int DoSessionTicket(CYASSL* ssl,
 
         /* ProcessOld uses same resume code */
         if (ssl->options.resuming && (!ssl->options.dtls ||
-               ssl->options.acceptState == HELLO_VERIFY_SENT)) { /* let's try */
+               ssl->options.acceptState == HELLO_VERIFY_SENT ||
+               ssl->options.dtlsHelloVerified)) { /* let's try */
             int ret = -1;
-            CYASSL_SESSION* session = GetSession(ssl,ssl->arrays->masterSecret);
+            CYASSL_SESSION* session;
+
+        #if defined(HAVE_SESSION_TICKET)
+            if (ssl->options.useTicket)
+                session = &ssl->session;    /* DoClientTicket filled in */
+            else
+        #endif
+                session = GetSession(ssl, ssl->arrays->masterSecret);
 
             if (!session) {
                 CYASSL_MSG("Session lookup for resume failed");
@@ -13311,8 +17938,19 @@ int DoSessionTicket(CYASSL* ssl,
                     CYASSL_MSG("Unsupported cipher suite, ClientHello");
                     return UNSUPPORTED_SUITE;
                 }
+            #if defined(HAVE_SESSION_TICKET)
+                if (ssl->options.useTicket &&
+                     (ssl->options.cipherSuite0 != ssl->arrays->ticketSuite[0]
+                   || ssl->options.cipherSuite  != ssl->arrays->ticketSuite[1])) {
+                    CYASSL_MSG("Ticket suite not chosen, full handshake");
+                    ssl->options.resuming  = 0;
+                    ssl->options.useTicket = 0;
+                    return TLSX_SessionTicket_SetResponse(ssl);
+                }
+            #endif
                 #ifdef SESSION_CERTS
-                    ssl->session = *session; /* restore session certs. */
+                    if (session != &ssl->session)
+                        ssl->session = *session; /* restore session certs. */
                 #endif
 
                 ret = RNG_GenerateBlock(ssl->rng, ssl->arrays->serverRandom,
@@ -13408,7 +18046,7 @@ int DoSessionTicket(CYASSL* ssl,
                 byte   encodedSig[MAX_ENCODED_SIG_SZ];
 #endif
                 word32 sigSz;
-                byte*  digest = ssl->certHashes.sha;
+                byte*  digest = ssl->hsHashes->certHashes.sha;
                 int    typeH = SHAh;
                 int    digestSz = SHA_DIGEST_SIZE;
 
@@ -13425,14 +18063,14 @@ int DoSessionTicket(CYASSL* ssl,
 
                 if (hashAlgo == sha256_mac) {
                     #ifndef NO_SHA256
-                        digest = ssl->certHashes.sha256;
+                        digest = ssl->hsHashes->certHashes.sha256;
                         typeH    = SHA256h;
                         digestSz = SHA256_DIGEST_SIZE;
                     #endif
                 }
                 else if (hashAlgo == sha384_mac) {
                     #ifdef CYASSL_SHA384
-                        digest = ssl->certHashes.sha384;
+                        digest = ssl->hsHashes->certHashes.sha384;
                         typeH    = SHA384h;
                         digestSz = SHA384_DIGEST_SIZE;
                     #endif
@@ -13450,7 +18088,7 @@ int DoSessionTicket(CYASSL* ssl,
             }
             else {
                 if (outLen == FINISHED_SZ && out && XMEMCMP(out,
-                                            &ssl->certHashes, FINISHED_SZ) == 0)
+                                  &ssl->hsHashes->certHashes, FINISHED_SZ) == 0)
                     ret = 0; /* verified */
             }
         }
@@ -13459,7 +18097,7 @@ int DoSessionTicket(CYASSL* ssl,
         if (ssl->peerEccDsaKeyPresent) {
             int verify =  0;
             int err    = -1;
-            byte* digest = ssl->certHashes.sha;
+            byte* digest = ssl->hsHashes->certHashes.sha;
             word32 digestSz = SHA_DIGEST_SIZE;
             byte doUserEcc = 0;
 
@@ -13477,13 +18115,13 @@ int DoSessionTicket(CYASSL* ssl,
 
                 if (hashAlgo == sha256_mac) {
                     #ifndef NO_SHA256
-                        digest = ssl->certHashes.sha256;
+                        digest = ssl->hsHashes->certHashes.sha256;
                         digestSz = SHA256_DIGEST_SIZE;
                     #endif
                 }
                 else if (hashAlgo == sha384_mac) {
                     #ifdef CYASSL_SHA384
-                        digest = ssl->certHashes.sha384;
+                        digest = ssl->hsHashes->certHashes.sha384;
                         digestSz = SHA384_DIGEST_SIZE;
                     #endif
                 }
@@ -13503,28 +18141,442 @@ int DoSessionTicket(CYASSL* ssl,
                                                    &verify, ssl->peerEccDsaKey);
             }
 
-            if (err == 0 && verify == 1)
-               ret = 0; /* verified */
+            if (err == 0 && verify == 1)
+               ret = 0; /* verified */
+        }
+#endif
+        *inOutIdx += sz;
+
+        if (ret == 0)
+            ssl->options.havePeerVerify = 1;
+
+        return ret;
+    }
+#endif /* !NO_RSA || HAVE_ECC */
+
+    int SendServerHelloDone(CYASSL* ssl)
+    {
+        byte              *output;
+        int                sendSz = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
+        int                ret;
+
+        #ifdef CYASSL_DTLS
+            if (ssl->options.dtls)
+                sendSz += DTLS_RECORD_EXTRA + DTLS_HANDSHAKE_EXTRA;
+        #endif
+        /* check for available size */
+        if ((ret = CheckAvailableSize(ssl, sendSz)) != 0)
+            return ret;
+
+        /* get ouput buffer */
+        output = ssl->buffers.outputBuffer.buffer +
+                 ssl->buffers.outputBuffer.length;
+
+        AddHeaders(output, 0, server_hello_done, ssl);
+
+        #ifdef CYASSL_DTLS
+            if (ssl->options.dtls) {
+                if ((ret = DtlsPoolSave(ssl, output, sendSz)) != 0)
+                    return 0;
+            }
+        #endif
+
+        ret = HashOutput(ssl, output, sendSz, 0);
+            if (ret != 0)
+                return ret;
+
+#ifdef CYASSL_CALLBACKS
+        if (ssl->hsInfoOn)
+            AddPacketName("ServerHelloDone", &ssl->handShakeInfo);
+        if (ssl->toInfoOn)
+            AddPacketInfo("ServerHelloDone", &ssl->timeoutInfo, output, sendSz,
+                          ssl->heap);
+#endif
+        ssl->options.serverState = SERVER_HELLODONE_COMPLETE;
+
+        ssl->buffers.outputBuffer.length += sendSz;
+
+        return SendBuffered(ssl);
+    }
+
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+
+    /* staple the OCSP response picked when the client asked for it */
+    int SendCertificateStatus(CYASSL* ssl)
+    {
+        byte*  output;
+        word32 length;
+        word32 i = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
+        int    sendSz;
+        int    ret;
+
+        if (ssl->ocspStaple.buffer == NULL || ssl->options.resuming)
+            return 0;  /* not needed */
+
+        length = ENUM_LEN + OPAQUE24_LEN + ssl->ocspStaple.length;
+        if (length + HANDSHAKE_HEADER_SZ > MAX_RECORD_SIZE) {
+            /* the client asks the responder itself */
+            CYASSL_MSG("OCSP response too big to staple");
+            XFREE(ssl->ocspStaple.buffer, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+            ssl->ocspStaple.buffer = NULL;
+            return 0;
+        }
+
+        sendSz = length + RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
+
+        #ifdef CYASSL_DTLS
+            if (ssl->options.dtls) {
+                sendSz += DTLS_RECORD_EXTRA + DTLS_HANDSHAKE_EXTRA;
+                i      += DTLS_RECORD_EXTRA + DTLS_HANDSHAKE_EXTRA;
+            }
+        #endif
+
+        if (ssl->keys.encryptionOn)
+            sendSz += MAX_MSG_EXTRA;
+
+        /* check for available size */
+        if ((ret = CheckAvailableSize(ssl, sendSz)) != 0)
+            return ret;
+
+        /* get ouput buffer */
+        output = ssl->buffers.outputBuffer.buffer +
+                 ssl->buffers.outputBuffer.length;
+
+        AddHeaders(output, length, certificate_status, ssl);
+
+        output[i++] = CSR_OCSP;
+        c32to24(ssl->ocspStaple.length, output + i);
+        i += OPAQUE24_LEN;
+        XMEMCPY(output + i, ssl->ocspStaple.buffer, ssl->ocspStaple.length);
+        i += ssl->ocspStaple.length;
+
+        XFREE(ssl->ocspStaple.buffer, ssl->heap, DYNAMIC_TYPE_OCSP_ENTRY);
+        ssl->ocspStaple.buffer = NULL;
+        ssl->ocspStaple.length = 0;
+
+        if (ssl->keys.encryptionOn) {
+            byte* input;
+            int   inputSz = i - RECORD_HEADER_SZ; /* build msg adds rec hdr */
+
+            input = (byte*)XMALLOC(inputSz, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+            if (input == NULL)
+                return MEMORY_E;
+
+            XMEMCPY(input, output + RECORD_HEADER_SZ, inputSz);
+            sendSz = BuildMessage(ssl, output, sendSz, input, inputSz,
+                                                                     handshake);
+            XFREE(input, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+
+            if (sendSz < 0)
+                return sendSz;
+        } else {
+            ret = HashOutput(ssl, output, sendSz, 0);
+            if (ret != 0)
+                return ret;
+        }
+
+        #ifdef CYASSL_DTLS
+            if (ssl->options.dtls) {
+                if ((ret = DtlsPoolSave(ssl, output, sendSz)) != 0)
+                    return ret;
+            }
+        #endif
+
+        #ifdef CYASSL_CALLBACKS
+            if (ssl->hsInfoOn)
+                AddPacketName("CertificateStatus", &ssl->handShakeInfo);
+            if (ssl->toInfoOn)
+                AddPacketInfo("CertificateStatus", &ssl->timeoutInfo, output,
+                              sendSz, ssl->heap);
+        #endif
+
+        ssl->buffers.outputBuffer.length += sendSz;
+        return SendFlightPart(ssl);
+    }
+
+#endif /* HAVE_CERTIFICATE_STATUS_REQUEST */
+
+#ifdef HAVE_SESSION_TICKET
+
+    /* seal (enc) or open ticket state in place, key name is the additional
+       data so a ticket can't be moved under another key */
+    static int TicketCrypt(const byte* key, const byte* name, const byte* iv,
+                           byte* state, byte* tag, int enc)
+    {
+        int ret;
+    #if defined(HAVE_AESGCM)
+    #ifdef CYASSL_SMALL_STACK
+        Aes* aes = (Aes*)XMALLOC(sizeof(Aes), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+        if (aes == NULL)
+            return MEMORY_E;
+    #else
+        Aes  aes[1];
+    #endif
+
+        ret = AesGcmSetKey(aes, key, CYASSL_TICKET_KEY_SZ);
+        if (ret == 0 && enc)
+            ret = AesGcmEncrypt(aes, state, state, TICKET_STATE_SZ,
+                                iv, TICKET_IV_SZ, tag, TICKET_TAG_SZ,
+                                name, CYASSL_TICKET_NAME_SZ);
+        else if (ret == 0)
+            ret = AesGcmDecrypt(aes, state, state, TICKET_STATE_SZ,
+                                iv, TICKET_IV_SZ, tag, TICKET_TAG_SZ,
+                                name, CYASSL_TICKET_NAME_SZ);
+
+        XMEMSET(aes, 0, sizeof(Aes));
+    #ifdef CYASSL_SMALL_STACK
+        XFREE(aes, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    #endif
+    #elif defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+        ChaCha   chacha;
+        Poly1305 poly;
+        byte     polyKey[CHACHA20_256_KEY_SIZE * 2];      /* all of pad 0 */
+        byte     calc[TICKET_TAG_SZ];
+        byte     pad[POLY1305_BLOCK_SIZE];
+        word32   padSz = (POLY1305_BLOCK_SIZE -
+                          TICKET_STATE_SZ % POLY1305_BLOCK_SIZE) %
+                          POLY1305_BLOCK_SIZE;
+
+        /* RFC 7539 AEAD, one time poly key from pad 0, data from 1 on */
+        XMEMSET(polyKey, 0, sizeof(polyKey));
+        ret = Chacha_SetKey(&chacha, key, CYASSL_TICKET_KEY_SZ);
+        if (ret == 0)
+            ret = Chacha_SetIV(&chacha, iv, 0);
+        if (ret == 0)
+            ret = Chacha_Process(&chacha, polyKey, polyKey, sizeof(polyKey));
+        if (ret == 0)
+            ret = Chacha_SetIV(&chacha, iv, 1);
+        if (ret == 0 && enc)
+            ret = Chacha_Process(&chacha, state, state, TICKET_STATE_SZ);
+
+        /* name is a whole pad, no padding needed */
+        if (ret == 0)
+            ret = Poly1305SetKey(&poly, polyKey, CHACHA20_256_KEY_SIZE);
+        if (ret == 0)
+            ret = Poly1305Update(&poly, name, CYASSL_TICKET_NAME_SZ);
+        if (ret == 0)
+            ret = Poly1305Update(&poly, state, TICKET_STATE_SZ);
+        XMEMSET(pad, 0, sizeof(pad));
+        if (ret == 0 && padSz)
+            ret = Poly1305Update(&poly, pad, padSz);
+        if (ret == 0) {
+            pad[0] = CYASSL_TICKET_NAME_SZ;   /* little endian 64 bit sizes */
+            pad[8] = TICKET_STATE_SZ;
+            ret = Poly1305Update(&poly, pad, sizeof(pad));
+        }
+        if (ret == 0)
+            ret = Poly1305Final(&poly, calc);
+
+        if (ret == 0) {
+            if (enc)
+                XMEMCPY(tag, calc, TICKET_TAG_SZ);
+            else if (ConstantCompare(calc, tag, TICKET_TAG_SZ) != 0)
+                ret = VERIFY_MAC_ERROR;
+            else
+                ret = Chacha_Process(&chacha, state, state, TICKET_STATE_SZ);
+        }
+
+        XMEMSET(polyKey, 0, sizeof(polyKey));
+        XMEMSET(&chacha, 0, sizeof(chacha));
+    #else
+        (void)key;
+        (void)name;
+        (void)iv;
+        (void)state;
+        (void)tag;
+        (void)enc;
+        ret = NOT_COMPILED_IN;
+    #endif
+
+        return ret;
+    }
+
+
+    /* make name and key the current ticket key, prior ones shift down and
+       the oldest drops off. With ifExpired only if the current one is past
+       its lifetime, checked under the lock so racing threads rotate once */
+    static int InstallTicketKey(CYASSL_CTX* ctx, const byte* name,
+                                const byte* key, int ifExpired)
+    {
+        int i;
+        int install = 1;
+
+        if (LockMutex(&ctx->ticketKeyMutex) != 0)
+            return BAD_MUTEX_E;
+
+        if (ifExpired)
+            install = ctx->ticketKeyLifetime && ctx->ticketKeyCount &&
+                      LowResTimer() - ctx->ticketKeys[0].created >=
+                                                         ctx->ticketKeyLifetime;
+        if (install) {
+            for (i = CYASSL_TICKET_KEYS - 1; i > 0; i--)
+                ctx->ticketKeys[i] = ctx->ticketKeys[i - 1];
+
+            XMEMCPY(ctx->ticketKeys[0].name, name, CYASSL_TICKET_NAME_SZ);
+            XMEMCPY(ctx->ticketKeys[0].key,  key,  CYASSL_TICKET_KEY_SZ);
+            ctx->ticketKeys[0].created = LowResTimer();
+
+            if (ctx->ticketKeyCount < CYASSL_TICKET_KEYS)
+                ctx->ticketKeyCount++;
+        }
+
+        UnLockMutex(&ctx->ticketKeyMutex);
+
+        /* outside the lock, the callback may well distribute the key */
+        if (install && ctx->ticketKeyCb)
+            ctx->ticketKeyCb(ctx, name, key, ctx->ticketKeyCtx);
+
+        return 0;
+    }
+
+
+    int AddTicketKey(CYASSL_CTX* ctx, const byte* name, const byte* key)
+    {
+        return InstallTicketKey(ctx, name, key, 0);
+    }
+
+
+    /* new random current key, ifExpired only rotates a key past its lifetime */
+    int RotateTicketKey(CYASSL_CTX* ctx, RNG* rng, int ifExpired)
+    {
+        byte name[CYASSL_TICKET_NAME_SZ];
+        byte key[CYASSL_TICKET_KEY_SZ];
+        int  ret;
+
+        /* cheap check first, InstallTicketKey checks again */
+        if (ifExpired && (ctx->ticketKeyLifetime == 0 ||
+                          LowResTimer() - ctx->ticketKeys[0].created <
+                                                       ctx->ticketKeyLifetime))
+            return 0;
+
+        ret = RNG_GenerateBlock(rng, name, sizeof(name));
+        if (ret == 0)
+            ret = RNG_GenerateBlock(rng, key, sizeof(key));
+        if (ret == 0)
+            ret = InstallTicketKey(ctx, name, key, ifExpired);
+
+        XMEMSET(key, 0, sizeof(key));
+
+        return ret;
+    }
+
+
+    /* try to resume from client's ticket, 0 on success. Anything else just
+       means a full handshake and a fresh ticket */
+    int DoClientTicket(CYASSL* ssl, const byte* input, word32 len)
+    {
+        byte   ticket[TICKET_SZ];
+        byte   key[CYASSL_TICKET_KEY_SZ];
+        byte*  state = ticket + CYASSL_TICKET_NAME_SZ + TICKET_IV_SZ;
+        word32 idx   = 0;
+        word32 bornOn;
+        word32 timeout;
+        int    found = 0;
+        int    ret;
+        int    i;
+
+        if (len != TICKET_SZ) {
+            CYASSL_MSG("Not one of our tickets");
+            return BUFFER_E;
+        }
+        XMEMCPY(ticket, input, TICKET_SZ);
+
+        if (LockMutex(&ssl->ctx->ticketKeyMutex) != 0)
+            return BAD_MUTEX_E;
+
+        for (i = 0; i < ssl->ctx->ticketKeyCount; i++) {
+            if (XMEMCMP(ssl->ctx->ticketKeys[i].name, ticket,
+                                                CYASSL_TICKET_NAME_SZ) == 0) {
+                XMEMCPY(key, ssl->ctx->ticketKeys[i].key, sizeof(key));
+                found = 1;
+                break;
+            }
+        }
+
+        UnLockMutex(&ssl->ctx->ticketKeyMutex);
+
+        if (!found) {
+            CYASSL_MSG("Ticket key unknown or retired");
+            return BUFFER_E;
+        }
+
+        ret = TicketCrypt(key, ticket, ticket + CYASSL_TICKET_NAME_SZ, state,
+                          state + TICKET_STATE_SZ, 0);
+        XMEMSET(key, 0, sizeof(key));
+        if (ret != 0) {
+            CYASSL_MSG("Ticket failed to open");
+            return ret;
+        }
+
+        if (state[idx++] != TICKET_VERSION) {
+            ret = BUFFER_E;
+        }
+        else if (state[idx]     != ssl->version.major ||
+                 state[idx + 1] != ssl->version.minor) {
+            CYASSL_MSG("Ticket for another protocol version");
+            ret = VERSION_ERROR;
+        }
+        else {
+            idx += VERSION_SZ;
+            ssl->arrays->ticketSuite[0] = state[idx++];
+            ssl->arrays->ticketSuite[1] = state[idx++];
+            XMEMCPY(ssl->arrays->masterSecret, state + idx, SECRET_LEN);
+            idx += SECRET_LEN;
+            ato32(state + idx, &bornOn);
+            idx += OPAQUE32_LEN;
+            ato32(state + idx, &timeout);
+
+            if (LowResTimer() >= bornOn + timeout) {
+                CYASSL_MSG("Ticket timed out");
+                ret = BUFFER_E;
+            }
+        }
+
+        if (ret == 0 && !ssl->options.resuming) {
+            /* no session id to echo back, make one */
+            ret = RNG_GenerateBlock(ssl->rng, ssl->arrays->sessionID, ID_LEN);
         }
-#endif
-        *inOutIdx += sz;
 
-        if (ret == 0)
-            ssl->options.havePeerVerify = 1;
+        if (ret == 0) {
+            CYASSL_MSG("Resuming from session ticket");
+            XMEMCPY(ssl->session.masterSecret, ssl->arrays->masterSecret,
+                                                                   SECRET_LEN);
+            ssl->session.bornOn    = bornOn;
+            ssl->session.timeout   = timeout;
+            ssl->options.resuming  = 1;
+            ssl->options.useTicket = 1;
+        }
+        else
+            XMEMSET(ssl->arrays->masterSecret, 0, SECRET_LEN);
+
+        XMEMSET(state, 0, TICKET_STATE_SZ);
 
         return ret;
     }
-#endif /* !NO_RSA || HAVE_ECC */
 
-    int SendServerHelloDone(CYASSL* ssl)
+
+    /* NewSessionTicket, state sealed under the current key */
+    int SendTicket(CYASSL* ssl)
     {
-        byte              *output;
-        int                sendSz = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
-        int                ret;
+        byte*  output;
+        byte*  ticket;
+        byte*  state;
+        byte   key[CYASSL_TICKET_KEY_SZ];
+        word32 length = OPAQUE32_LEN + OPAQUE16_LEN + TICKET_SZ;
+        word32 idx    = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
+        int    sendSz = length + idx;
+        int    ret;
+
+        ret = RotateTicketKey(ssl->ctx, ssl->rng, 1);
+        if (ret != 0)
+            return ret;
 
         #ifdef CYASSL_DTLS
-            if (ssl->options.dtls)
+            if (ssl->options.dtls) {
+                idx    += DTLS_RECORD_EXTRA + DTLS_HANDSHAKE_EXTRA;
                 sendSz += DTLS_RECORD_EXTRA + DTLS_HANDSHAKE_EXTRA;
+            }
         #endif
         /* check for available size */
         if ((ret = CheckAvailableSize(ssl, sendSz)) != 0)
@@ -13534,31 +18586,288 @@ int DoSessionTicket(CYASSL* ssl,
         output = ssl->buffers.outputBuffer.buffer +
                  ssl->buffers.outputBuffer.length;
 
-        AddHeaders(output, 0, server_hello_done, ssl);
+        AddHeaders(output, length, session_ticket, ssl);
+
+        c32toa(ssl->timeout, output + idx);   /* lifetime hint */
+        idx += OPAQUE32_LEN;
+        c16toa(TICKET_SZ, output + idx);
+        idx += OPAQUE16_LEN;
+
+        ticket = output + idx;
+        state  = ticket + CYASSL_TICKET_NAME_SZ + TICKET_IV_SZ;
+
+        if (LockMutex(&ssl->ctx->ticketKeyMutex) != 0)
+            return BAD_MUTEX_E;
+        XMEMCPY(ticket, ssl->ctx->ticketKeys[0].name, CYASSL_TICKET_NAME_SZ);
+        XMEMCPY(key, ssl->ctx->ticketKeys[0].key, sizeof(key));
+        UnLockMutex(&ssl->ctx->ticketKeyMutex);
+
+        ret = RNG_GenerateBlock(ssl->rng, ticket + CYASSL_TICKET_NAME_SZ,
+                                                                 TICKET_IV_SZ);
+        if (ret == 0) {
+            idx = 0;
+            state[idx++] = TICKET_VERSION;
+            state[idx++] = ssl->version.major;
+            state[idx++] = ssl->version.minor;
+            state[idx++] = ssl->options.cipherSuite0;
+            state[idx++] = ssl->options.cipherSuite;
+            XMEMCPY(state + idx, ssl->arrays->masterSecret, SECRET_LEN);
+            idx += SECRET_LEN;
+            c32toa(LowResTimer(), state + idx);
+            idx += OPAQUE32_LEN;
+            c32toa(ssl->timeout, state + idx);
+
+            ret = TicketCrypt(key, ticket, ticket + CYASSL_TICKET_NAME_SZ,
+                              state, state + TICKET_STATE_SZ, 1);
+        }
+        XMEMSET(key, 0, sizeof(key));
+        if (ret != 0) {
+            XMEMSET(state, 0, TICKET_STATE_SZ);
+            return ret;
+        }
 
         #ifdef CYASSL_DTLS
             if (ssl->options.dtls) {
                 if ((ret = DtlsPoolSave(ssl, output, sendSz)) != 0)
-                    return 0;
+                    return ret;
             }
         #endif
 
         ret = HashOutput(ssl, output, sendSz, 0);
+        if (ret != 0)
+            return ret;
+
+        #ifdef CYASSL_CALLBACKS
+            if (ssl->hsInfoOn)
+                AddPacketName("SessionTicket", &ssl->handShakeInfo);
+            if (ssl->toInfoOn)
+                AddPacketInfo("SessionTicket", &ssl->timeoutInfo, output,
+                              sendSz, ssl->heap);
+        #endif
+
+        ssl->buffers.outputBuffer.length += sendSz;
+        ssl->options.createTicket = 0;
+
+        return SendFlightPart(ssl);
+    }
+
+#endif /* HAVE_SESSION_TICKET */
+
+#ifdef HAVE_SNI
+
+    /* FNV-1a of the lower case name */
+    static word32 SNIHostHash(const char* name, word16 nameSz)
+    {
+        word32 hash = 2166136261U;
+        word16 i;
+
+        for (i = 0; i < nameSz; i++)
+            hash = (hash ^ (byte)XTOLOWER((byte)name[i])) * 16777619U;
+
+        return hash;
+    }
+
+
+    static SNIHost* SNIHostLookup(CYASSL_CTX* ctx, const char* name,
+                                  word16 nameSz)
+    {
+        word32   hash = SNIHostHash(name, nameSz);
+        SNIHost* host = ctx->sniHosts[hash & (ctx->sniHostBuckets - 1)];
+
+        for (; host; host = host->next)
+            if (host->hash == hash && host->nameSz == nameSz &&
+                               XSTRNCASECMP(host->name, name, nameSz) == 0)
+                return host;
+
+        return NULL;
+    }
+
+
+    /* double the buckets, chains keep their order reversed, that's fine */
+    static int GrowSNIHosts(CYASSL_CTX* ctx)
+    {
+        word32    i;
+        word32    buckets = ctx->sniHostBuckets ? ctx->sniHostBuckets * 2
+                                                : SNI_HOST_BUCKETS;
+        SNIHost** table   = (SNIHost**)XMALLOC(buckets * sizeof(SNIHost*),
+                                               ctx->heap, DYNAMIC_TYPE_SNI);
+
+        if (table == NULL)
+            return MEMORY_E;
+
+        XMEMSET(table, 0, buckets * sizeof(SNIHost*));
+
+        for (i = 0; i < ctx->sniHostBuckets; i++) {
+            SNIHost* host = ctx->sniHosts[i];
+
+            while (host) {
+                SNIHost* next = host->next;
+
+                host->next = table[host->hash & (buckets - 1)];
+                table[host->hash & (buckets - 1)] = host;
+                host = next;
+            }
+        }
+
+        XFREE(ctx->sniHosts, ctx->heap, DYNAMIC_TYPE_SNI);
+        ctx->sniHosts       = table;
+        ctx->sniHostBuckets = buckets;
+
+        return 0;
+    }
+
+
+    /* map name to vhost, replacing any CTX the name had, vhost is held until
+       ctx is freed */
+    int AddSNIHost(CYASSL_CTX* ctx, const char* name, word16 nameSz,
+                   CYASSL_CTX* vhost)
+    {
+        SNIHost* host;
+        word32   bucket;
+
+        if (ctx->sniHostCount >= ctx->sniHostBuckets) {
+            int ret = GrowSNIHosts(ctx);
             if (ret != 0)
                 return ret;
+        }
 
-#ifdef CYASSL_CALLBACKS
-        if (ssl->hsInfoOn)
-            AddPacketName("ServerHelloDone", &ssl->handShakeInfo);
-        if (ssl->toInfoOn)
-            AddPacketInfo("ServerHelloDone", &ssl->timeoutInfo, output, sendSz,
-                          ssl->heap);
-#endif
-        ssl->options.serverState = SERVER_HELLODONE_COMPLETE;
+        if (SSL_CtxUpRef(vhost) != 0)
+            return BAD_MUTEX_E;
 
-        ssl->buffers.outputBuffer.length += sendSz;
+        if (ctx->sniHostCount && (host = SNIHostLookup(ctx, name, nameSz))) {
+            FreeSSL_Ctx(host->ctx);
+            host->ctx = vhost;
+            return 0;
+        }
 
-        return SendBuffered(ssl);
+        host = (SNIHost*)XMALLOC(sizeof(SNIHost) + nameSz, ctx->heap,
+                                 DYNAMIC_TYPE_SNI);
+        if (host == NULL) {
+            FreeSSL_Ctx(vhost);
+            return MEMORY_E;
+        }
+
+        host->name   = (char*)(host + 1);
+        host->nameSz = nameSz;
+        host->hash   = SNIHostHash(name, nameSz);
+        host->ctx    = vhost;
+        XMEMCPY(host->name, name, nameSz);
+
+        bucket = host->hash & (ctx->sniHostBuckets - 1);
+        host->next = ctx->sniHosts[bucket];
+        ctx->sniHosts[bucket] = host;
+        ctx->sniHostCount++;
+
+        return 0;
+    }
+
+
+    /* CTX for the name the client sent, exact match first then "*.rest" for
+       the first label, NULL if none */
+    CYASSL_CTX* FindSNIHost(CYASSL_CTX* ctx, const char* name, word16 nameSz)
+    {
+        char     wild[MAX_SNI_HOST_SZ + 1];
+        SNIHost* host;
+        word16   dot;
+
+        if (ctx->sniHostCount == 0 || nameSz == 0 || nameSz > MAX_SNI_HOST_SZ)
+            return NULL;
+
+        if ((host = SNIHostLookup(ctx, name, nameSz)) != NULL)
+            return host->ctx;
+
+        for (dot = 1; dot < nameSz && name[dot] != '.'; dot++)
+            ;
+        if (dot == nameSz)
+            return NULL;
+
+        wild[0] = '*';
+        XMEMCPY(wild + 1, name + dot, nameSz - dot);
+        host = SNIHostLookup(ctx, wild, nameSz - dot + 1);
+
+        return host ? host->ctx : NULL;
+    }
+
+
+    void FreeSNIHosts(CYASSL_CTX* ctx)
+    {
+        word32 i;
+
+        for (i = 0; i < ctx->sniHostBuckets; i++) {
+            while (ctx->sniHosts[i]) {
+                SNIHost* host = ctx->sniHosts[i];
+
+                ctx->sniHosts[i] = host->next;
+                FreeSSL_Ctx(host->ctx);
+                XFREE(host, ctx->heap, DYNAMIC_TYPE_SNI);
+            }
+        }
+
+        XFREE(ctx->sniHosts, ctx->heap, DYNAMIC_TYPE_SNI);
+        ctx->sniHosts       = NULL;
+        ctx->sniHostBuckets = 0;
+        ctx->sniHostCount   = 0;
+    }
+
+#endif /* HAVE_SNI */
+
+    /* move a server ssl to ctx before suites are matched, it takes ctx's
+       certificate, key and suites unless it has its own */
+    int SetSSL_CTX(CYASSL* ssl, CYASSL_CTX* ctx)
+    {
+        CYASSL_CTX* old = ssl->ctx;
+
+        if (ctx == old)
+            return 0;
+
+        if (ctx->method->side != ssl->options.side)
+            return BAD_FUNC_ARG;
+
+        if (SSL_CtxUpRef(ctx) != 0)
+            return BAD_MUTEX_E;
+
+    #ifndef NO_CERTS
+        if (!ssl->buffers.weOwnCertChain)
+            ssl->buffers.certChain = ctx->certChain;
+        if (!ssl->buffers.weOwnCert && !ssl->buffers.weOwnKey) {
+            ssl->buffers.certificate   = ctx->certificate;
+            ssl->buffers.key           = ctx->privateKey;
+            ssl->options.haveECDSAsig  = ctx->haveECDSAsig;
+            ssl->options.haveStaticECC = ctx->haveStaticECC;
+            ssl->options.haveNTRU      = ctx->haveNTRU;
+        #ifdef HAVE_ECC
+            ssl->pkCurveOID            = ctx->pkCurveOID;
+            InitDualCert(ssl, ctx);
+        #endif
+        }
+        if (!ssl->buffers.weOwnDH && ssl->options.side == CYASSL_SERVER_END) {
+            ssl->buffers.serverDH_P = ctx->serverDH_P;
+            ssl->buffers.serverDH_G = ctx->serverDH_G;
+            ssl->options.haveDH     = ctx->haveDH;
+        }
+    #endif
+
+        if (ssl->suites) {
+            /* same as InitSSL, the ctx list is kept if the user set one */
+            byte haveRSA = 0;
+            byte havePSK = 0;
+        #ifndef NO_RSA
+            haveRSA = 1;
+        #endif
+        #ifndef NO_PSK
+            havePSK = ssl->options.havePSK;
+        #endif
+            *ssl->suites = ctx->suites;
+            InitSuites(ssl->suites, ssl->version, haveRSA, havePSK,
+                       ssl->options.haveDH, ssl->options.haveNTRU,
+                       ssl->options.haveECDSAsig, ssl->options.haveStaticECC,
+                       ssl->options.haveDualCert, ssl->options.side);
+        }
+
+        ssl->ctx = ctx;
+        FreeSSL_Ctx(old);
+
+        return 0;
     }
 
 #ifdef CYASSL_DTLS
@@ -13610,8 +18919,200 @@ int DoSessionTicket(CYASSL* ssl,
 
         return SendBuffered(ssl);
     }
+
+
+    /* stateless cookie, HMAC under the listen secret of the peer address and
+       the ClientHello version and random, which the client has to repeat */
+    static int DtlsListenCookie(CYASSL_CTX* ctx, const byte* peer,
+                                word32 peerSz, const byte* hello, byte* cookie)
+    {
+        Hmac hmac;
+    #ifndef NO_SHA256
+        byte digest[SHA256_DIGEST_SIZE];
+        int  ret = HmacSetKey(&hmac, SHA256, ctx->cookieSecret,
+                                                         ctx->cookieSecretSz);
+    #else
+        byte digest[SHA_DIGEST_SIZE];
+        int  ret = HmacSetKey(&hmac, SHA, ctx->cookieSecret,
+                                                         ctx->cookieSecretSz);
+    #endif
+
+        if (ret == 0)
+            ret = HmacUpdate(&hmac, peer, peerSz);
+        if (ret == 0)
+            ret = HmacUpdate(&hmac, hello, VERSION_SZ + RAN_LEN);
+        if (ret == 0)
+            ret = HmacFinal(&hmac, digest);
+        if (ret == 0)
+            XMEMCPY(cookie, digest, COOKIE_SZ);
+
+        XMEMSET(&hmac, 0, sizeof(hmac));
+
+        return ret;
+    }
+
+
+    /* finds the ClientHello body and its cookie in a datagram, which has to
+       start with an unfragmented epoch 0 ClientHello record */
+    static int DtlsListenParse(const byte* in, word32 inSz, word32* bodySz,
+                               word32* cookieIdx, byte* cookieSz)
+    {
+        const byte* hs   = in + DTLS_RECORD_HEADER_SZ;
+        const byte* body = hs + DTLS_HANDSHAKE_HEADER_SZ;
+        word16 recSz;
+        word32 hsSz, fragOffset, fragSz;
+        word32 idx = VERSION_SZ + RAN_LEN;
+
+        if (inSz < DTLS_RECORD_HEADER_SZ + DTLS_HANDSHAKE_HEADER_SZ ||
+                in[0] != handshake || in[1] != DTLS_MAJOR ||
+                in[3] != 0 || in[4] != 0)
+            return BUFFER_ERROR;
+
+        ato16(hs - LENGTH_SZ, &recSz);
+        c24to32(hs + ENUM_LEN, &hsSz);
+        c24to32(hs + HANDSHAKE_HEADER_SZ + DTLS_HANDSHAKE_SEQ_SZ, &fragOffset);
+        c24to32(body - DTLS_HANDSHAKE_FRAG_SZ, &fragSz);
+
+        if (DTLS_RECORD_HEADER_SZ + (word32)recSz > inSz ||
+                hs[0] != client_hello || fragOffset != 0 || fragSz != hsSz ||
+                DTLS_HANDSHAKE_HEADER_SZ + hsSz > recSz)
+            return BUFFER_ERROR;
+
+        /* session id then cookie */
+        if (idx + ENUM_LEN > hsSz || body[idx] > ID_LEN)
+            return BUFFER_ERROR;
+        idx += ENUM_LEN + body[idx];
+        if (idx + ENUM_LEN > hsSz)
+            return BUFFER_ERROR;
+        *cookieSz = body[idx++];
+        if (idx + *cookieSz > hsSz)
+            return BUFFER_ERROR;
+
+        *bodySz    = hsSz;
+        *cookieIdx = DTLS_RECORD_HEADER_SZ + DTLS_HANDSHAKE_HEADER_SZ + idx;
+
+        return 0;
+    }
+
+
+    /* 1 if the ClientHello datagram in carries peer's cookie, else 0 with
+       the HelloVerifyRequest answer in out. The request takes the record and
+       message sequence numbers of the ClientHello, as RFC 6347 asks of a
+       stateless server. Nothing about peer is kept. */
+    int DtlsListen(CYASSL_CTX* ctx, const byte* in, word32 inSz,
+                   const byte* peer, word32 peerSz, byte* out, word32* outSz)
+    {
+        const byte* hs   = in + DTLS_RECORD_HEADER_SZ;
+        const byte* body = hs + DTLS_HANDSHAKE_HEADER_SZ;
+        byte   cookie[COOKIE_SZ];
+        byte   cookieSz;
+        word32 cookieIdx;
+        word32 bodySz;
+        word32 length = VERSION_SZ + ENUM_LEN + COOKIE_SZ;
+        word32 sendSz = DTLS_RECORD_HEADER_SZ + DTLS_HANDSHAKE_HEADER_SZ +
+                                                                        length;
+        int    ret;
+
+        ret = DtlsListenParse(in, inSz, &bodySz, &cookieIdx, &cookieSz);
+        if (ret == 0)
+            ret = DtlsListenCookie(ctx, peer, peerSz, body, cookie);
+        if (ret != 0)
+            return ret;
+
+        if (cookieSz == COOKIE_SZ &&
+                         ConstantCompare(cookie, in + cookieIdx, COOKIE_SZ) == 0)
+            return 1;
+
+        if (*outSz < sendSz)
+            return BUFFER_E;
+
+        /* record header as received, type, version, epoch and sequence */
+        XMEMCPY(out, in, DTLS_RECORD_HEADER_SZ - LENGTH_SZ);
+        c16toa((word16)(DTLS_HANDSHAKE_HEADER_SZ + length),
+                                  out + DTLS_RECORD_HEADER_SZ - LENGTH_SZ);
+        out += DTLS_RECORD_HEADER_SZ;
+
+        out[0] = hello_verify_request;
+        c32to24(length, out + ENUM_LEN);
+        XMEMCPY(out + HANDSHAKE_HEADER_SZ, hs + HANDSHAKE_HEADER_SZ,
+                                                       DTLS_HANDSHAKE_SEQ_SZ);
+        c32to24(0, out + HANDSHAKE_HEADER_SZ + DTLS_HANDSHAKE_SEQ_SZ);
+        c32to24(length, out + DTLS_HANDSHAKE_HEADER_SZ -
+                                                       DTLS_HANDSHAKE_FRAG_SZ);
+        out += DTLS_HANDSHAKE_HEADER_SZ;
+
+        out[0] = body[0];
+        out[1] = body[1];
+        out[VERSION_SZ] = COOKIE_SZ;
+        XMEMCPY(out + VERSION_SZ + ENUM_LEN, cookie, COOKIE_SZ);
+
+        *outSz = sendSz;
+        (void)bodySz;
+
+        return 0;
+    }
+
+
+    /* queue the ClientHello CyaSSL_CTX_dtls_listen() verified as the first
+       input, numbering our records and messages on from it */
+    int DtlsAcceptHello(CYASSL* ssl, const byte* in, word32 inSz)
+    {
+        word16 msgSeq;
+        word32 recSeq;
+
+        if (inSz < DTLS_RECORD_HEADER_SZ + DTLS_HANDSHAKE_HEADER_SZ ||
+                                                       in[0] != handshake)
+            return BUFFER_ERROR;
+
+        if (ssl->buffers.inputBuffer.length > ssl->buffers.inputBuffer.idx)
+            return BAD_FUNC_ARG;
+
+        if (inSz > ssl->buffers.inputBuffer.bufferSize &&
+                                     GrowInputBuffer(ssl, inSz, 0) < 0)
+            return MEMORY_E;
+
+        XMEMCPY(ssl->buffers.inputBuffer.buffer, in, inSz);
+        ssl->buffers.inputBuffer.idx    = 0;
+        ssl->buffers.inputBuffer.length = inSz;
+
+        /* low 32 bits of the 48 bit record sequence */
+        ato32(in + DTLS_RECORD_HEADER_SZ - LENGTH_SZ - OPAQUE32_LEN, &recSeq);
+        ato16(in + DTLS_RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ, &msgSeq);
+
+        ssl->keys.dtls_sequence_number = recSeq;
+        ssl->keys.dtls_handshake_number = msgSeq;
+        ssl->keys.dtls_expected_peer_handshake_number = msgSeq;
+        ssl->options.dtlsHelloVerified = 1;
+
+        return 0;
+    }
 #endif
 
+#ifndef NO_PSK
+    /* key for the client identity in arrays, the ctx's PSK store first then
+       the user callback, 0 on success */
+    static int GetServerPsk(CYASSL* ssl)
+    {
+        ssl->arrays->psk_keySz = 0;
+
+    #ifdef HAVE_PSK_STORE
+        ssl->arrays->psk_keySz = PskStoreLookup(&ssl->ctx->pskStore,
+                                       ssl->arrays->client_identity,
+                                       ssl->arrays->psk_key, MAX_PSK_KEY_LEN);
+    #endif
+        if (ssl->arrays->psk_keySz == 0 && ssl->options.server_psk_cb)
+            ssl->arrays->psk_keySz = ssl->options.server_psk_cb(ssl,
+                ssl->arrays->client_identity, ssl->arrays->psk_key,
+                MAX_PSK_KEY_LEN);
+
+        if (ssl->arrays->psk_keySz == 0 ||
+                                   ssl->arrays->psk_keySz > MAX_PSK_KEY_LEN)
+            return PSK_KEY_ERROR;
+
+        return 0;
+    }
+#endif /* NO_PSK */
+
     static int DoClientKeyExchange(CYASSL* ssl, byte* input, word32* inOutIdx,
                                                                     word32 size)
     {
@@ -13657,50 +19158,81 @@ int DoSessionTicket(CYASSL* ssl,
         #ifndef NO_RSA
             case rsa_kea:
             {
-                word32 idx = 0;
-                RsaKey key;
+            #ifdef CYASSL_SMALL_STACK
+                RsaKey* key = NULL;
+            #else
+                RsaKey  key[1];
+            #endif
+                RsaKey* decKey = NULL;      /* key or the ctx's decoded */
                 byte   doUserRsa = 0;
+            #ifdef CYASSL_ASYNC_CRYPT
+                byte   secret[SECRET_LEN];
+            #endif
 
                 #ifdef HAVE_PK_CALLBACKS
                     if (ssl->ctx->RsaDecCb)
                         doUserRsa = 1;
                 #endif
 
-                ret = InitRsaKey(&key, ssl->heap);
-                if (ret != 0) return ret;
-
-                if (ssl->buffers.key.buffer)
-                    ret = RsaPrivateKeyDecode(ssl->buffers.key.buffer, &idx,
-                                             &key, ssl->buffers.key.length);
-                else
+                if (!ssl->buffers.key.buffer)
                     return NO_PRIVATE_KEY;
 
+            #ifdef CYASSL_SMALL_STACK
+                key = (RsaKey*)XMALLOC(sizeof(RsaKey), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+                if (key == NULL)
+                    return MEMORY_E;
+            #endif
+
+                ret = InitRsaKey(key, ssl->heap);
+                if (ret != 0) {
+                #ifdef CYASSL_SMALL_STACK
+                    XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+                #endif
+                    return ret;
+                }
+
+                ret = DecodeRsaPrivateKey(ssl, key, &decKey);
+
                 if (ret == 0) {
-                    length = RsaEncryptSize(&key);
+                    length = RsaEncryptSize(decKey);
                     ssl->arrays->preMasterSz = SECRET_LEN;
 
                     if (ssl->options.tls) {
                         word16 check;
 
                         if ((*inOutIdx - begin) + OPAQUE16_LEN > size)
-                            return BUFFER_ERROR;
-
-                        ato16(input + *inOutIdx, &check);
-                        *inOutIdx += OPAQUE16_LEN;
-
-                        if ((word32) check != length) {
-                            CYASSL_MSG("RSA explicit size doesn't match");
-                            FreeRsaKey(&key);
-                            return RSA_PRIVATE_ERROR;
+                            ret = BUFFER_ERROR;
+                        else {
+                            ato16(input + *inOutIdx, &check);
+                            *inOutIdx += OPAQUE16_LEN;
+
+                            if ((word32) check != length) {
+                                CYASSL_MSG("RSA explicit size doesn't match");
+                                ret = RSA_PRIVATE_ERROR;
+                            }
                         }
                     }
 
-                    if ((*inOutIdx - begin) + length > size) {
+                    if (ret == 0 && (*inOutIdx - begin) + length > size) {
                         CYASSL_MSG("RSA message too big");
-                        FreeRsaKey(&key);
-                        return BUFFER_ERROR;
+                        ret = BUFFER_ERROR;
                     }
+                }
+
+                if (ret == 0) {
+
+                #ifdef CYASSL_ASYNC_CRYPT
+                    if (ssl->ctx->AsyncSubmitCb) {
+                        word32 secretSz = SECRET_LEN;
 
+                        ret = AsyncPkOp(ssl, CYASSL_ASYNC_RSA_DECRYPT,
+                                        input + *inOutIdx, length, secret,
+                                        &secretSz);
+                        out = secret;
+                    }
+                    else
+                #endif
                     if (doUserRsa) {
                         #ifdef HAVE_PK_CALLBACKS
                             ret = ssl->ctx->RsaDecCb(ssl,
@@ -13712,7 +19244,7 @@ int DoSessionTicket(CYASSL* ssl,
                     }
                     else {
                         ret = RsaPrivateDecryptInline(input + *inOutIdx, length,
-                                                                    &out, &key);
+                                                                  &out, decKey);
                     }
 
                     *inOutIdx += length;
@@ -13727,12 +19259,15 @@ int DoSessionTicket(CYASSL* ssl,
                         else
                             ret = MakeMasterSecret(ssl);
                     }
-                    else {
+                    else if (ret != WANT_ASYNC) {
                         ret = RSA_PRIVATE_ERROR;
                     }
                 }
 
-                FreeRsaKey(&key);
+                FreeRsaKey(key);
+            #ifdef CYASSL_SMALL_STACK
+                XFREE(key, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            #endif
             }
             break;
         #endif
@@ -13758,12 +19293,7 @@ int DoSessionTicket(CYASSL* ssl,
                 *inOutIdx += ci_sz;
 
                 ssl->arrays->client_identity[min(ci_sz, MAX_PSK_ID_LEN-1)] = 0;
-                ssl->arrays->psk_keySz = ssl->options.server_psk_cb(ssl,
-                    ssl->arrays->client_identity, ssl->arrays->psk_key,
-                    MAX_PSK_KEY_LEN);
-
-                if (ssl->arrays->psk_keySz == 0 ||
-                                       ssl->arrays->psk_keySz > MAX_PSK_KEY_LEN)
+                if (GetServerPsk(ssl) != 0)
                     return PSK_KEY_ERROR;
 
                 /* make psk pre master secret */
@@ -13829,10 +19359,14 @@ int DoSessionTicket(CYASSL* ssl,
         #if defined(HAVE_ECC) || defined(HAVE_ECC25519)
             case ecc_diffie_hellman_kea:
             {
+                word32 pubSz;
+
                 if ((*inOutIdx - begin) + OPAQUE8_LEN > size)
                     return BUFFER_ERROR;
 
                 length = input[(*inOutIdx)++];
+                pubSz  = length;
+                (void)pubSz;
 
                 if ((*inOutIdx - begin) + length > size)
                     return BUFFER_ERROR;
@@ -13856,6 +19390,13 @@ int DoSessionTicket(CYASSL* ssl,
 
                     /* Location where ECDH logic would go if needed  */
 
+                #ifdef CYASSL_ASYNC_CRYPT
+                    if (ssl->ctx->AsyncSubmitCb)
+                        ret = AsyncPkOp(ssl, CYASSL_ASYNC_ECC_SHARED,
+                                        input + *inOutIdx - pubSz, pubSz,
+                                        ssl->arrays->preMasterSecret, &length);
+                    else
+                #endif
                     ret = ecc25519_shared_secret(ssl->ecc25519TempKey,
                                          ssl->peerEcc25519Key,
                                          ssl->arrays->preMasterSecret, &length);
@@ -13880,19 +19421,24 @@ int DoSessionTicket(CYASSL* ssl,
 	                length = sizeof(ssl->arrays->preMasterSecret);
 
 	                if (ssl->specs.static_ecdh) {
-	                    ecc_key staticKey;
-	                    word32 i = 0;
+	                    ecc_key  staticKey;
+	                    ecc_key* useKey = NULL;
 
 	                    ecc_init(&staticKey);
-	                    ret = EccPrivateKeyDecode(ssl->buffers.key.buffer, &i,
-	                                       &staticKey, ssl->buffers.key.length);
+	                    ret = DecodeEccPrivateKey(ssl, &staticKey, &useKey);
 
 	                    if (ret == 0)
-	                        ret = ecc_shared_secret(&staticKey, ssl->peerEccKey,
+	                        ret = ecc_shared_secret(useKey, ssl->peerEccKey,
 	                                     ssl->arrays->preMasterSecret, &length);
 
 	                    ecc_free(&staticKey);
 	                }
+	            #ifdef CYASSL_ASYNC_CRYPT
+	                else if (ssl->ctx->AsyncSubmitCb)
+	                    ret = AsyncPkOp(ssl, CYASSL_ASYNC_ECC_SHARED,
+	                                    input + *inOutIdx - pubSz, pubSz,
+	                                    ssl->arrays->preMasterSecret, &length);
+	            #endif
 	                else
 	                    ret = ecc_shared_secret(ssl->eccTempKey, ssl->peerEccKey
                                        , ssl->arrays->preMasterSecret, &length);
@@ -13905,6 +19451,8 @@ int DoSessionTicket(CYASSL* ssl,
                 }
 #endif
 
+                if (ret == WANT_ASYNC)
+                    return ret;
                 if (ret != 0)
                     return ECC_SHARED_ERROR;
 
@@ -14003,12 +19551,7 @@ int DoSessionTicket(CYASSL* ssl,
 
                 /* Use the PSK hint to look up the PSK and add it to the
                  * preMasterSecret here. */
-                ssl->arrays->psk_keySz = ssl->options.server_psk_cb(ssl,
-                    ssl->arrays->client_identity, ssl->arrays->psk_key,
-                    MAX_PSK_KEY_LEN);
-
-                if (ssl->arrays->psk_keySz == 0 ||
-                                       ssl->arrays->psk_keySz > MAX_PSK_KEY_LEN)
+                if (GetServerPsk(ssl) != 0)
                     return PSK_KEY_ERROR;
 
                 c16toa((word16) ssl->arrays->psk_keySz, pms);
@@ -14042,7 +19585,7 @@ int DoSessionTicket(CYASSL* ssl,
             ssl->options.clientState = CLIENT_KEYEXCHANGE_COMPLETE;
             #ifndef NO_CERTS
                 if (ssl->options.verifyPeer)
-                    ret = BuildCertHashes(ssl, &ssl->certHashes);
+                    ret = BuildCertHashes(ssl, &ssl->hsHashes->certHashes);
             #endif
         }
 
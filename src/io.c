@@ -19,6 +19,10 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
  */
 
+#if defined(HAVE_DTLS_MUX) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE     /* recvmmsg() and sendmmsg() */
+#endif
+
 #ifdef HAVE_CONFIG_H
     #include <config.h>
 #endif
@@ -106,6 +110,10 @@
     #include <sys/filio.h>
 #endif
 
+#if defined(HAVE_OCSP_NONBLOCK) || defined(HAVE_CONN_POOL)
+    #include <poll.h>
+#endif
+
 #ifdef USE_WINDOWS_API 
     /* no epipe yet */
     #ifndef WSAEPIPE
@@ -311,8 +319,14 @@ int EmbedSend(CYASSL* ssl, char *buf, int sz, void *ctx)
     int sent;
     int len = sz;
     int err;
+    int flags = ssl->wflags;
 
-    sent = (int)SEND_FUNCTION(sd, &buf[sz - len], len, ssl->wflags);
+#ifdef MSG_MORE
+    if (ssl->options.moreToSend)
+        flags |= MSG_MORE;       /* let the stack fill segments */
+#endif
+
+    sent = (int)SEND_FUNCTION(sd, &buf[sz - len], len, flags);
 
     if (sent < 0) {
         err = LastError();
@@ -344,6 +358,208 @@ int EmbedSend(CYASSL* ssl, char *buf, int sz, void *ctx)
 }
 
 
+#ifdef CYASSL_KTLS
+
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+    #define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+    #define TCP_ULP 31
+#endif
+
+
+/* Translates errno from the kernel TLS socket calls into CBIO codes */
+static int KTLSError(int want)
+{
+    int err = LastError();
+
+    if (err == SOCKET_EWOULDBLOCK || err == SOCKET_EAGAIN) {
+        CYASSL_MSG("    Would block");
+        return want;
+    }
+    else if (err == SOCKET_ECONNRESET) {
+        CYASSL_MSG("    Connection reset");
+        return CYASSL_CBIO_ERR_CONN_RST;
+    }
+    else if (err == SOCKET_EINTR) {
+        CYASSL_MSG("    Socket interrupted");
+        return CYASSL_CBIO_ERR_ISR;
+    }
+    else if (err == SOCKET_EPIPE) {
+        CYASSL_MSG("    Socket EPIPE");
+        return CYASSL_CBIO_ERR_CONN_CLOSE;
+    }
+
+    CYASSL_MSG("    General error");
+    return CYASSL_CBIO_ERR_GENERAL;
+}
+
+
+/* Hand one direction of the TLS 1.2 AES-GCM record layer on socket sd to
+ * the kernel, tx for our writes, otherwise for peer's
+ *  return : 0 on success
+ */
+int EmbedKTLSEnable(CYASSL* ssl, int sd, int tx)
+{
+    union {
+        struct tls12_crypto_info_aes_gcm_128 gcm128;
+    #ifdef TLS_CIPHER_AES_GCM_256
+        struct tls12_crypto_info_aes_gcm_256 gcm256;
+    #endif
+    } info;
+    const byte* key;
+    const byte* salt;
+    byte        seq[8];
+    word32      seqNum;
+    int         infoSz;
+    int         ret;
+
+    /* our writes use our side's keys, reads the peer's */
+    if ((ssl->options.side == CYASSL_CLIENT_END) == (tx != 0))
+        key = ssl->keys.client_write_key;
+    else
+        key = ssl->keys.server_write_key;
+
+    salt   = tx ? ssl->keys.aead_enc_imp_IV : ssl->keys.aead_dec_imp_IV;
+    seqNum = tx ? ssl->keys.sequence_number : ssl->keys.peer_sequence_number;
+
+    XMEMSET(seq, 0, sizeof(seq));
+    seq[4] = (byte)(seqNum >> 24);
+    seq[5] = (byte)(seqNum >> 16);
+    seq[6] = (byte)(seqNum >>  8);
+    seq[7] = (byte) seqNum;
+
+    XMEMSET(&info, 0, sizeof(info));
+    if (ssl->specs.key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+        info.gcm128.info.version     = TLS_1_2_VERSION;
+        info.gcm128.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        XMEMCPY(info.gcm128.key, key, TLS_CIPHER_AES_GCM_128_KEY_SIZE);
+        XMEMCPY(info.gcm128.salt, salt, TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+        XMEMCPY(info.gcm128.iv, ssl->keys.aead_exp_IV,
+                                               TLS_CIPHER_AES_GCM_128_IV_SIZE);
+        XMEMCPY(info.gcm128.rec_seq, seq, sizeof(seq));
+        infoSz = (int)sizeof(info.gcm128);
+    }
+#ifdef TLS_CIPHER_AES_GCM_256
+    else if (ssl->specs.key_size == TLS_CIPHER_AES_GCM_256_KEY_SIZE) {
+        info.gcm256.info.version     = TLS_1_2_VERSION;
+        info.gcm256.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        XMEMCPY(info.gcm256.key, key, TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+        XMEMCPY(info.gcm256.salt, salt, TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+        XMEMCPY(info.gcm256.iv, ssl->keys.aead_exp_IV,
+                                               TLS_CIPHER_AES_GCM_256_IV_SIZE);
+        XMEMCPY(info.gcm256.rec_seq, seq, sizeof(seq));
+        infoSz = (int)sizeof(info.gcm256);
+    }
+#endif
+    else {
+        CYASSL_MSG("Kernel TLS doesn't support this key size");
+        return KTLS_E;
+    }
+
+    /* already set if the other direction went first */
+    if (setsockopt(sd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0 &&
+                                                            errno != EEXIST) {
+        CYASSL_MSG("setsockopt TCP_ULP tls failed, no kernel tls module?");
+        ret = KTLS_E;
+    }
+    else if (setsockopt(sd, SOL_TLS, tx ? TLS_TX : TLS_RX, &info,
+                        (socklen_t)infoSz) != 0) {
+        CYASSL_MSG("setsockopt SOL_TLS keys failed");
+        ret = KTLS_E;
+    }
+    else
+        ret = 0;
+
+    XMEMSET(&info, 0, sizeof(info));
+
+    return ret;
+}
+
+
+/* Send one non application data record (alert) through the kernel TLS
+ * socket, application data just goes through EmbedSend()
+ *  return : nb bytes sent, or error
+ */
+int EmbedKTLSSend(CYASSL* ssl, int sd, byte type, const byte* buf, int sz)
+{
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr* cmsg;
+    char            control[CMSG_SPACE(sizeof(byte))];
+    int             sent;
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    iov.iov_base       = (void*)buf;
+    iov.iov_len        = sz;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type  = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(byte));
+    *CMSG_DATA(cmsg) = type;
+    msg.msg_controllen = cmsg->cmsg_len;
+
+    sent = (int)sendmsg(sd, &msg, ssl->wflags);
+    if (sent < 0) {
+        CYASSL_MSG("Embed KTLS Send error");
+        return KTLSError(CYASSL_CBIO_ERR_WANT_WRITE);
+    }
+
+    return sent;
+}
+
+
+/* Receive decrypted record data from the kernel TLS socket, *type is set
+ * to the record type, which is only ever one per call
+ *  return : nb bytes read, or error
+ */
+int EmbedKTLSReceive(CYASSL* ssl, int sd, byte* buf, int sz, int peek,
+                     byte* type)
+{
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr* cmsg;
+    char            control[CMSG_SPACE(sizeof(byte))];
+    int             recvd;
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    iov.iov_base       = buf;
+    iov.iov_len        = sz;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    recvd = (int)recvmsg(sd, &msg, ssl->rflags | (peek ? MSG_PEEK : 0));
+    if (recvd < 0) {
+        CYASSL_MSG("Embed KTLS Receive error");
+        return KTLSError(CYASSL_CBIO_ERR_WANT_READ);
+    }
+    else if (recvd == 0) {
+        CYASSL_MSG("Embed KTLS receive connection closed");
+        return CYASSL_CBIO_ERR_CONN_CLOSE;
+    }
+
+    *type = application_data;
+    cmsg  = CMSG_FIRSTHDR(&msg);
+    if (cmsg && cmsg->cmsg_level == SOL_TLS &&
+                                        cmsg->cmsg_type == TLS_GET_RECORD_TYPE)
+        *type = *CMSG_DATA(cmsg);
+
+    return recvd;
+}
+
+#endif /* CYASSL_KTLS */
+
+
 #ifdef CYASSL_DTLS
 
 #include <cyassl/ctaocrypt/sha.h>
@@ -512,352 +728,1596 @@ int EmbedGenerateCookie(CYASSL* ssl, byte *buf, int sz, void *ctx)
     return sz;
 }
 
-#endif /* CYASSL_DTLS */
 
-#ifdef HAVE_OCSP
+#ifdef HAVE_DTLS_MUX
+
+/* FNV-1a over the address bytes */
+static word32 MuxHash(const byte* addr, word32 sz)
+{
+    word32 hash = 2166136261U;
 
+    while (sz--) {
+        hash ^= *addr++;
+        hash *= 16777619U;
+    }
 
-static int Word16ToString(char* d, word16 number)
+    return hash;
+}
+
+
+static DtlsMuxPeer* MuxFind(CYASSL_DTLS_MUX* mux, const byte* addr, word32 sz,
+                            word32 hash)
 {
-    int i = 0;
+    DtlsMuxPeer* peer = mux->table[hash & (mux->tableSz - 1)];
 
-    if (d != NULL) {
-        word16 order = 10000;
-        word16 digit;
+    for (; peer != NULL; peer = peer->next) {
+        CYASSL_SOCKADDR* sa = &peer->ssl->buffers.dtlsCtx.peer;
 
-        if (number == 0) {
-            d[i++] = '0';
-        }
-        else {
-            while (order) {
-                digit = number / order;
-                if (i > 0 || digit != 0) {
-                    d[i++] = (char)digit + '0';
-                }
-                if (digit != 0)
-                    number %= digit * order;
-                if (order > 1)
-                    order /= 10;
-                else
-                    order = 0;
-            }
-        }
-        d[i] = 0;
+        if (peer->hash == hash && sa->sz == sz
+                               && XMEMCMP(sa->sa, addr, sz) == 0)
+            return peer;
     }
 
-    return i;
+    return NULL;
 }
 
 
-static int tcp_connect(SOCKET_T* sockfd, const char* ip, word16 port)
+/* double the table once it averages two peers a bucket */
+static void MuxGrow(CYASSL_DTLS_MUX* mux)
 {
-    struct sockaddr_storage addr;
-    int sockaddr_len = sizeof(struct sockaddr_in);
-    XMEMSET(&addr, 0, sizeof(addr));
+    word32        newSz = mux->tableSz * 2;
+    DtlsMuxPeer** table;
+    word32        i;
+
+    table = (DtlsMuxPeer**)XMALLOC(newSz * sizeof(DtlsMuxPeer*), mux->heap,
+                                   DYNAMIC_TYPE_DTLS_MUX);
+    if (table == NULL)
+        return;     /* chains get longer, lookups still work */
+
+    XMEMSET(table, 0, newSz * sizeof(DtlsMuxPeer*));
+    for (i = 0; i < mux->tableSz; i++) {
+        DtlsMuxPeer* peer = mux->table[i];
+
+        while (peer != NULL) {
+            DtlsMuxPeer*  next   = peer->next;
+            DtlsMuxPeer** bucket = &table[peer->hash & (newSz - 1)];
+
+            peer->next = *bucket;
+            *bucket    = peer;
+            peer       = next;
+        }
+    }
 
-    #ifdef HAVE_GETADDRINFO
-    {
-        struct addrinfo hints;
-        struct addrinfo* answer = NULL;
-        char strPort[6];
+    XFREE(mux->table, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+    mux->table   = table;
+    mux->tableSz = newSz;
+}
 
-        XMEMSET(&hints, 0, sizeof(hints));
-        hints.ai_family = AF_UNSPEC;
-        hints.ai_socktype = SOCK_STREAM;
-        hints.ai_protocol = IPPROTO_TCP;
 
-        if (Word16ToString(strPort, port) == 0) {
-            CYASSL_MSG("invalid port number for OCSP responder");
-            return -1;
-        }
+static DtlsMuxDgram* MuxDgramNew(void* heap, const byte* data, word32 sz,
+                                 const byte* addr, word32 addrSz)
+{
+    DtlsMuxDgram* dgram;
+
+    (void)heap;
+
+    dgram = (DtlsMuxDgram*)XMALLOC(sizeof(DtlsMuxDgram) + sz + addrSz, heap,
+                                   DYNAMIC_TYPE_DTLS_MUX);
+    if (dgram != NULL) {
+        dgram->next   = NULL;
+        dgram->data   = (byte*)(dgram + 1);
+        dgram->sz     = sz;
+        dgram->addr   = dgram->data + sz;
+        dgram->addrSz = addrSz;
+        XMEMCPY(dgram->data, data, sz);
+        if (addrSz)
+            XMEMCPY(dgram->addr, addr, addrSz);
+    }
 
-        if (getaddrinfo(ip, strPort, &hints, &answer) < 0 || answer == NULL) {
-            CYASSL_MSG("no addr info for OCSP responder");
-            return -1;
-        }
+    return dgram;
+}
 
-        sockaddr_len = answer->ai_addrlen;
-        XMEMCPY(&addr, answer->ai_addr, sockaddr_len);
-        freeaddrinfo(answer);
 
+static void MuxDgramListFree(void* heap, DtlsMuxDgram* dgram)
+{
+    (void)heap;
+
+    while (dgram != NULL) {
+        DtlsMuxDgram* next = dgram->next;
+        XFREE(dgram, heap, DYNAMIC_TYPE_DTLS_MUX);
+        dgram = next;
     }
-    #else /* HAVE_GETADDRINFO */
-    {
-        struct hostent* entry = gethostbyname(ip);
-        struct sockaddr_in *sin = (struct sockaddr_in *)&addr;
+}
 
-        if (entry) {
-            sin->sin_family = AF_INET;
-            sin->sin_port = htons(port);
-            XMEMCPY(&sin->sin_addr.s_addr, entry->h_addr_list[0],
-                                                               entry->h_length);
-        }
-        else {
-            CYASSL_MSG("no addr info for OCSP responder");
-            return -1;
-        }
+
+static void MuxSetReady(CYASSL_DTLS_MUX* mux, DtlsMuxPeer* peer)
+{
+    if (!peer->ready) {
+        peer->ready     = 1;
+        peer->readyNext = NULL;
+        if (mux->readyTail)
+            mux->readyTail->readyNext = peer;
+        else
+            mux->readyHead = peer;
+        mux->readyTail = peer;
     }
-    #endif /* HAVE_GETADDRINFO */
+}
 
-    *sockfd = socket(addr.ss_family, SOCK_STREAM, 0);
 
-#ifdef USE_WINDOWS_API
-    if (*sockfd == INVALID_SOCKET) {
-        CYASSL_MSG("bad socket fd, out of fds?");
-        return -1;
+/* queue a received datagram to its peer, unknown addresses go to the new
+   peer callback first which may add a CYASSL for it */
+static void MuxDispatch(CYASSL_DTLS_MUX* mux, const byte* data, word32 sz,
+                        const byte* addr, word32 addrSz)
+{
+    word32        hash = MuxHash(addr, addrSz);
+    DtlsMuxPeer*  peer = MuxFind(mux, addr, addrSz, hash);
+    DtlsMuxDgram* dgram;
+
+    if (peer == NULL && mux->newPeerCb != NULL) {
+        int used = mux->newPeerCb(mux, data, sz, addr, addrSz,
+                                  mux->newPeerCtx);
+
+        peer = MuxFind(mux, addr, addrSz, hash);
+        if (peer != NULL && used) {
+            MuxSetReady(mux, peer);     /* has input, just not queued here */
+            return;
+        }
     }
-#else
-     if (*sockfd < 0) {
-         CYASSL_MSG("bad socket fd, out of fds?");
-         return -1;
-     }
-#endif
+    if (peer == NULL)
+        return;
 
-    if (connect(*sockfd, (struct sockaddr *)&addr, sockaddr_len) != 0) {
-        CYASSL_MSG("OCSP responder tcp connect failed");
-        return -1;
+    if (peer->queued >= DTLS_MUX_QUEUE) {
+        CYASSL_MSG("DTLS mux peer queue full, dropping datagram");
+        return;
     }
 
-    return 0;
-}
+    dgram = MuxDgramNew(mux->heap, data, sz, NULL, 0);
+    if (dgram == NULL)
+        return;
 
+    if (peer->tail)
+        peer->tail->next = dgram;
+    else
+        peer->head = dgram;
+    peer->tail = dgram;
+    peer->queued++;
 
-static int build_http_request(const char* domainName, const char* path,
-                                    int ocspReqSz, byte* buf, int bufSize)
-{
-    word32 domainNameLen, pathLen, ocspReqSzStrLen, completeLen;
-    char ocspReqSzStr[6];
+    MuxSetReady(mux, peer);
+}
 
-    domainNameLen = (word32)XSTRLEN(domainName);
-    pathLen = (word32)XSTRLEN(path);
-    ocspReqSzStrLen = Word16ToString(ocspReqSzStr, (word16)ocspReqSz);
 
-    completeLen = domainNameLen + pathLen + ocspReqSzStrLen + 84;
-    if (completeLen > (word32)bufSize)
-        return 0;
+CYASSL_DTLS_MUX* CyaSSL_DTLS_MUX_new(CYASSL_CTX* ctx, int fd)
+{
+    CYASSL_DTLS_MUX* mux;
+
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_new");
+
+    if (ctx == NULL || fd < 0)
+        return NULL;
+
+    mux = (CYASSL_DTLS_MUX*)XMALLOC(sizeof(CYASSL_DTLS_MUX), ctx->heap,
+                                    DYNAMIC_TYPE_DTLS_MUX);
+    if (mux == NULL)
+        return NULL;
+
+    XMEMSET(mux, 0, sizeof(CYASSL_DTLS_MUX));
+    mux->ctx     = ctx;
+    mux->heap    = ctx->heap;
+    mux->fd      = fd;
+    mux->tableSz = DTLS_MUX_BUCKETS;
+    mux->table   = (DtlsMuxPeer**)XMALLOC(mux->tableSz * sizeof(DtlsMuxPeer*),
+                                          mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+    mux->recvBuf = (byte*)XMALLOC(DTLS_MUX_BATCH * MAX_MTU, mux->heap,
+                                  DYNAMIC_TYPE_DTLS_MUX);
+    if (mux->table == NULL || mux->recvBuf == NULL) {
+        CyaSSL_DTLS_MUX_free(mux);
+        return NULL;
+    }
+    XMEMSET(mux->table, 0, mux->tableSz * sizeof(DtlsMuxPeer*));
 
-    XSTRNCPY((char*)buf, "POST ", 5);
-    buf += 5;
-    XSTRNCPY((char*)buf, path, pathLen);
-    buf += pathLen;
-    XSTRNCPY((char*)buf, " HTTP/1.1\r\nHost: ", 17);
-    buf += 17;
-    XSTRNCPY((char*)buf, domainName, domainNameLen);
-    buf += domainNameLen;
-    XSTRNCPY((char*)buf, "\r\nContent-Length: ", 18);
-    buf += 18;
-    XSTRNCPY((char*)buf, ocspReqSzStr, ocspReqSzStrLen);
-    buf += ocspReqSzStrLen;
-    XSTRNCPY((char*)buf,
-                      "\r\nContent-Type: application/ocsp-request\r\n\r\n", 44);
+    ctx->CBIORecv = EmbedMuxReceive;
+    ctx->CBIOSend = EmbedMuxSend;
 
-    return completeLen;
+    return mux;
 }
 
 
-static int decode_url(const char* url, int urlSz,
-    char* outName, char* outPath, word16* outPort)
+void CyaSSL_DTLS_MUX_free(CYASSL_DTLS_MUX* mux)
 {
-    int result = -1;
+    void*  heap;
+    word32 i;
 
-    if (outName != NULL && outPath != NULL && outPort != NULL)
-    {
-        if (url == NULL || urlSz == 0)
-        {
-            *outName = 0;
-            *outPath = 0;
-            *outPort = 0;
-        }
-        else
-        {
-            int i, cur;
-    
-            /* need to break the url down into scheme, address, and port */
-            /*     "http://example.com:8080/" */
-            /*     "http://[::1]:443/"        */
-            if (XSTRNCMP(url, "http://", 7) == 0) {
-                cur = 7;
-            } else cur = 0;
-    
-            i = 0;
-            if (url[cur] == '[') {
-                cur++;
-                /* copy until ']' */
-                while (url[cur] != 0 && url[cur] != ']' && cur < urlSz) {
-                    outName[i++] = url[cur++];
-                }
-                cur++; /* skip ']' */
-            }
-            else {
-                while (url[cur] != 0 && url[cur] != ':' &&
-                                               url[cur] != '/' && cur < urlSz) {
-                    outName[i++] = url[cur++];
-                }
-            }
-            outName[i] = 0;
-            /* Need to pick out the path after the domain name */
-    
-            if (cur < urlSz && url[cur] == ':') {
-                char port[6];
-                int j;
-                word32 bigPort = 0;
-                i = 0;
-                cur++;
-                while (cur < urlSz && url[cur] != 0 && url[cur] != '/' &&
-                        i < 6) {
-                    port[i++] = url[cur++];
-                }
-    
-                for (j = 0; j < i; j++) {
-                    if (port[j] < '0' || port[j] > '9') return -1;
-                    bigPort = (bigPort * 10) + (port[j] - '0');
-                }
-                *outPort = (word16)bigPort;
-            }
-            else
-                *outPort = 80;
-    
-            if (cur < urlSz && url[cur] == '/') {
-                i = 0;
-                while (cur < urlSz && url[cur] != 0 && i < 80) {
-                    outPath[i++] = url[cur++];
-                }
-                outPath[i] = 0;
-            }
-            else {
-                outPath[0] = '/';
-                outPath[1] = 0;
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_free");
+
+    if (mux == NULL)
+        return;
+
+    heap = mux->heap;
+    (void)heap;
+
+    if (mux->table) {
+        for (i = 0; i < mux->tableSz; i++) {
+            DtlsMuxPeer* peer = mux->table[i];
+
+            while (peer != NULL) {
+                DtlsMuxPeer* next = peer->next;
+
+                peer->ssl->IOCB_ReadCtx  = &peer->ssl->rfd;
+                peer->ssl->IOCB_WriteCtx = &peer->ssl->wfd;
+                MuxDgramListFree(mux->heap, peer->head);
+                XFREE(peer, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+                peer = next;
             }
-            result = 0;
         }
+        XFREE(mux->table, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
     }
 
-    return result;
+    MuxDgramListFree(mux->heap, mux->sendHead);
+    XFREE(mux->recvBuf, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+    XFREE(mux, heap, DYNAMIC_TYPE_DTLS_MUX);
 }
 
 
-/* return: >0 OCSP Response Size
+void CyaSSL_DTLS_MUX_SetNewPeerCb(CYASSL_DTLS_MUX* mux,
+                                  CallbackDtlsMuxNewPeer cb, void* ctx)
+{
+    if (mux) {
+        mux->newPeerCb  = cb;
+        mux->newPeerCtx = ctx;
+    }
+}
+
+
+/* add ssl under the address set with CyaSSL_dtls_set_peer(), ssl must come
+   from the mux's CTX and is switched to non blocking */
+int CyaSSL_DTLS_MUX_add(CYASSL_DTLS_MUX* mux, CYASSL* ssl)
+{
+    CYASSL_SOCKADDR* sa;
+    DtlsMuxPeer*     peer;
+    DtlsMuxPeer**    bucket;
+    word32           hash;
+
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_add");
+
+    if (mux == NULL || ssl == NULL || ssl->ctx != mux->ctx)
+        return BAD_FUNC_ARG;
+
+    sa = &ssl->buffers.dtlsCtx.peer;
+    if (sa->sa == NULL || sa->sz == 0)
+        return BAD_FUNC_ARG;
+
+    hash = MuxHash((const byte*)sa->sa, sa->sz);
+    if (MuxFind(mux, (const byte*)sa->sa, sa->sz, hash) != NULL)
+        return BAD_FUNC_ARG;    /* address already taken */
+
+    peer = (DtlsMuxPeer*)XMALLOC(sizeof(DtlsMuxPeer), mux->heap,
+                                 DYNAMIC_TYPE_DTLS_MUX);
+    if (peer == NULL)
+        return MEMORY_E;
+
+    XMEMSET(peer, 0, sizeof(DtlsMuxPeer));
+    peer->mux  = mux;
+    peer->ssl  = ssl;
+    peer->hash = hash;
+
+    bucket     = &mux->table[hash & (mux->tableSz - 1)];
+    peer->next = *bucket;
+    *bucket    = peer;
+
+    if (++mux->count > 2 * mux->tableSz)
+        MuxGrow(mux);
+
+    ssl->buffers.dtlsCtx.fd = mux->fd;
+    ssl->IOCB_ReadCtx  = peer;
+    ssl->IOCB_WriteCtx = peer;
+    CyaSSL_set_using_nonblock(ssl, 1);
+
+    return SSL_SUCCESS;
+}
+
+
+int CyaSSL_DTLS_MUX_remove(CYASSL_DTLS_MUX* mux, CYASSL* ssl)
+{
+    CYASSL_SOCKADDR* sa;
+    DtlsMuxPeer**    prev;
+    DtlsMuxPeer*     peer;
+    word32           hash;
+
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_remove");
+
+    if (mux == NULL || ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    sa   = &ssl->buffers.dtlsCtx.peer;
+    hash = MuxHash((const byte*)sa->sa, sa->sz);
+    prev = &mux->table[hash & (mux->tableSz - 1)];
+
+    for (peer = *prev; peer != NULL; prev = &peer->next, peer = peer->next)
+        if (peer->ssl == ssl)
+            break;
+
+    if (peer == NULL)
+        return BAD_FUNC_ARG;
+
+    *prev = peer->next;
+    mux->count--;
+
+    if (peer->ready) {
+        DtlsMuxPeer** rprev = &mux->readyHead;
+        DtlsMuxPeer*  last  = NULL;
+
+        while (*rprev != peer) {
+            last  = *rprev;
+            rprev = &(*rprev)->readyNext;
+        }
+        *rprev = peer->readyNext;
+        if (mux->readyTail == peer)
+            mux->readyTail = last;
+    }
+
+    ssl->IOCB_ReadCtx  = &ssl->rfd;
+    ssl->IOCB_WriteCtx = &ssl->wfd;
+    MuxDgramListFree(mux->heap, peer->head);
+    XFREE(peer, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+
+    return SSL_SUCCESS;
+}
+
+
+CYASSL* CyaSSL_DTLS_MUX_find(CYASSL_DTLS_MUX* mux, const void* addr,
+                             unsigned int addrSz)
+{
+    DtlsMuxPeer* peer;
+
+    if (mux == NULL || addr == NULL)
+        return NULL;
+
+    peer = MuxFind(mux, (const byte*)addr, addrSz,
+                   MuxHash((const byte*)addr, addrSz));
+
+    return peer ? peer->ssl : NULL;
+}
+
+
+/* read what the socket has, up to a batch, and queue it to the peers
+ *  return : datagrams read, or error
+ */
+int CyaSSL_DTLS_MUX_recv(CYASSL_DTLS_MUX* mux)
+{
+    int got = 0;
+    int err;
+
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_recv");
+
+    if (mux == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_RECVMMSG
+    {
+        struct mmsghdr          msgs[DTLS_MUX_BATCH];
+        struct iovec            iov[DTLS_MUX_BATCH];
+        struct sockaddr_storage addrs[DTLS_MUX_BATCH];
+        int i;
+
+        XMEMSET(msgs, 0, sizeof(msgs));
+        for (i = 0; i < DTLS_MUX_BATCH; i++) {
+            iov[i].iov_base = mux->recvBuf + i * MAX_MTU;
+            iov[i].iov_len  = MAX_MTU;
+            msgs[i].msg_hdr.msg_iov     = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+            msgs[i].msg_hdr.msg_name    = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        }
+
+        got = recvmmsg(mux->fd, msgs, DTLS_MUX_BATCH, MSG_DONTWAIT, NULL);
+        if (got < 0)
+            got = 0;    /* error checked below */
+        else
+            for (i = 0; i < got; i++)
+                MuxDispatch(mux, (byte*)iov[i].iov_base, msgs[i].msg_len,
+                            (byte*)&addrs[i], msgs[i].msg_hdr.msg_namelen);
+
+        if (got > 0)
+            return got;
+    }
+#else
+    while (got < DTLS_MUX_BATCH) {
+        struct sockaddr_storage addr;
+        XSOCKLENT addrSz = sizeof(addr);
+        int       recvd;
+
+        recvd = (int)RECVFROM_FUNCTION(mux->fd, (char*)mux->recvBuf, MAX_MTU,
+                                     MSG_DONTWAIT, (struct sockaddr*)&addr,
+                                     &addrSz);
+        if (recvd < 0)
+            break;
+
+        MuxDispatch(mux, mux->recvBuf, recvd, (byte*)&addr, addrSz);
+        got++;
+    }
+
+    if (got > 0)
+        return got;
+#endif
+
+    err = LastError();
+    if (err == SOCKET_EWOULDBLOCK || err == SOCKET_EAGAIN ||
+                                     err == SOCKET_EINTR ||
+                                     err == SOCKET_ECONNREFUSED)
+        return 0;
+
+    CYASSL_MSG("DTLS mux receive error");
+    return SOCKET_ERROR_E;
+}
+
+
+/* next CYASSL with queued input, or NULL */
+CYASSL* CyaSSL_DTLS_MUX_ready(CYASSL_DTLS_MUX* mux)
+{
+    DtlsMuxPeer* peer;
+
+    if (mux == NULL || mux->readyHead == NULL)
+        return NULL;
+
+    peer = mux->readyHead;
+    mux->readyHead = peer->readyNext;
+    if (mux->readyHead == NULL)
+        mux->readyTail = NULL;
+    peer->readyNext = NULL;
+    peer->ready     = 0;
+
+    return peer->ssl;
+}
+
+
+/* queue a datagram to addr, e.g. a CyaSSL_CTX_dtls_listen() verify request,
+   the batch goes out when full or on CyaSSL_DTLS_MUX_flush() */
+int CyaSSL_DTLS_MUX_sendto(CYASSL_DTLS_MUX* mux, const byte* data,
+                           unsigned int sz, const void* addr,
+                           unsigned int addrSz)
+{
+    DtlsMuxDgram* dgram;
+
+    if (mux == NULL || data == NULL || addr == NULL || addrSz == 0)
+        return BAD_FUNC_ARG;
+
+    dgram = MuxDgramNew(mux->heap, data, sz, (const byte*)addr, addrSz);
+    if (dgram == NULL)
+        return MEMORY_E;
+
+    if (mux->sendTail)
+        mux->sendTail->next = dgram;
+    else
+        mux->sendHead = dgram;
+    mux->sendTail = dgram;
+
+    if (++mux->sendCount >= DTLS_MUX_BATCH)
+        CyaSSL_DTLS_MUX_flush(mux);
+
+    return (int)sz;
+}
+
+
+/* write queued datagrams, anything the socket won't take stays queued
+ *  return : datagrams left queued, or error
+ */
+int CyaSSL_DTLS_MUX_flush(CYASSL_DTLS_MUX* mux)
+{
+    int err;
+
+    CYASSL_ENTER("CyaSSL_DTLS_MUX_flush");
+
+    if (mux == NULL)
+        return BAD_FUNC_ARG;
+
+    while (mux->sendHead != NULL) {
+        DtlsMuxDgram* dgram;
+        int sent;
+#ifdef HAVE_SENDMMSG
+        struct mmsghdr msgs[DTLS_MUX_BATCH];
+        struct iovec   iov[DTLS_MUX_BATCH];
+        int n = 0;
+
+        XMEMSET(msgs, 0, sizeof(msgs));
+        for (dgram = mux->sendHead; dgram && n < DTLS_MUX_BATCH;
+                                    dgram = dgram->next, n++) {
+            iov[n].iov_base = dgram->data;
+            iov[n].iov_len  = dgram->sz;
+            msgs[n].msg_hdr.msg_iov     = &iov[n];
+            msgs[n].msg_hdr.msg_iovlen  = 1;
+            msgs[n].msg_hdr.msg_name    = dgram->addr;
+            msgs[n].msg_hdr.msg_namelen = dgram->addrSz;
+        }
+
+        sent = sendmmsg(mux->fd, msgs, n, MSG_DONTWAIT);
+#else
+        dgram = mux->sendHead;
+        sent  = (int)SENDTO_FUNCTION(mux->fd, (char*)dgram->data, dgram->sz,
+                                     MSG_DONTWAIT,
+                                     (const struct sockaddr*)dgram->addr,
+                                     dgram->addrSz);
+        if (sent >= 0)
+            sent = 1;
+#endif
+        if (sent < 0) {
+            err = LastError();
+            if (err == SOCKET_EWOULDBLOCK || err == SOCKET_EAGAIN ||
+                                             err == SOCKET_EINTR)
+                break;
+            if (err == SOCKET_ECONNREFUSED)
+                sent = 1;   /* peer went away, drop its datagram */
+            else {
+                CYASSL_MSG("DTLS mux send error");
+                return SOCKET_ERROR_E;
+            }
+        }
+
+        while (sent-- > 0) {
+            dgram = mux->sendHead;
+            mux->sendHead = dgram->next;
+            mux->sendCount--;
+            XFREE(dgram, mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+        }
+        if (mux->sendHead == NULL)
+            mux->sendTail = NULL;
+    }
+
+    return (int)mux->sendCount;
+}
+
+
+/* The receive callback for CYASSLs on a mux, reads the peer's queue
+ *  return : nb bytes read, or error
+ */
+int EmbedMuxReceive(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    DtlsMuxPeer*  peer = (DtlsMuxPeer*)ctx;
+    DtlsMuxDgram* dgram;
+
+    (void)ssl;
+
+    CYASSL_ENTER("EmbedMuxReceive()");
+
+    dgram = peer->head;
+    if (dgram == NULL)
+        return CYASSL_CBIO_ERR_WANT_READ;
+
+    if ((word32)sz > dgram->sz)
+        sz = (int)dgram->sz;
+    XMEMCPY(buf, dgram->data, sz);
+
+    peer->head = dgram->next;
+    if (peer->head == NULL)
+        peer->tail = NULL;
+    peer->queued--;
+    XFREE(dgram, peer->mux->heap, DYNAMIC_TYPE_DTLS_MUX);
+
+    return sz;
+}
+
+
+/* The send callback for CYASSLs on a mux, queues to the peer's address
+ *  return : nb bytes sent, or error
+ */
+int EmbedMuxSend(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    DtlsMuxPeer*     peer = (DtlsMuxPeer*)ctx;
+    CYASSL_SOCKADDR* sa   = &ssl->buffers.dtlsCtx.peer;
+    int              ret;
+
+    CYASSL_ENTER("EmbedMuxSend()");
+
+    ret = CyaSSL_DTLS_MUX_sendto(peer->mux, (byte*)buf, sz, sa->sa, sa->sz);
+    if (ret < 0)
+        return CYASSL_CBIO_ERR_GENERAL;
+
+    return ret;
+}
+
+#endif /* HAVE_DTLS_MUX */
+
+#endif /* CYASSL_DTLS */
+
+#if defined(HAVE_OCSP) || defined(HAVE_CRL_FETCH) || defined(HAVE_CONN_POOL)
+
+
+static int Word16ToString(char* d, word16 number)
+{
+    int i = 0;
+
+    if (d != NULL) {
+        word16 order = 10000;
+        word16 digit;
+
+        if (number == 0) {
+            d[i++] = '0';
+        }
+        else {
+            while (order) {
+                digit = number / order;
+                if (i > 0 || digit != 0) {
+                    d[i++] = (char)digit + '0';
+                }
+                if (digit != 0)
+                    number %= digit * order;
+                if (order > 1)
+                    order /= 10;
+                else
+                    order = 0;
+            }
+        }
+        d[i] = 0;
+    }
+
+    return i;
+}
+
+
+/* nonBlock leaves the socket non-blocking, 1 is returned then while the
+   connect is still going on */
+static int tcp_connect(SOCKET_T* sockfd, const char* ip, word16 port,
+                       int nonBlock)
+{
+    struct sockaddr_storage addr;
+    int sockaddr_len = sizeof(struct sockaddr_in);
+    XMEMSET(&addr, 0, sizeof(addr));
+
+    #ifdef HAVE_GETADDRINFO
+    {
+        struct addrinfo hints;
+        struct addrinfo* answer = NULL;
+        char strPort[6];
+
+        XMEMSET(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        if (Word16ToString(strPort, port) == 0) {
+            CYASSL_MSG("invalid port number for OCSP responder");
+            return -1;
+        }
+
+        if (getaddrinfo(ip, strPort, &hints, &answer) < 0 || answer == NULL) {
+            CYASSL_MSG("no addr info for OCSP responder");
+            return -1;
+        }
+
+        sockaddr_len = answer->ai_addrlen;
+        XMEMCPY(&addr, answer->ai_addr, sockaddr_len);
+        freeaddrinfo(answer);
+
+    }
+    #else /* HAVE_GETADDRINFO */
+    {
+        struct hostent* entry = gethostbyname(ip);
+        struct sockaddr_in *sin = (struct sockaddr_in *)&addr;
+
+        if (entry) {
+            sin->sin_family = AF_INET;
+            sin->sin_port = htons(port);
+            XMEMCPY(&sin->sin_addr.s_addr, entry->h_addr_list[0],
+                                                               entry->h_length);
+        }
+        else {
+            CYASSL_MSG("no addr info for OCSP responder");
+            return -1;
+        }
+    }
+    #endif /* HAVE_GETADDRINFO */
+
+    *sockfd = socket(addr.ss_family, SOCK_STREAM, 0);
+
+#ifdef USE_WINDOWS_API
+    if (*sockfd == INVALID_SOCKET) {
+        CYASSL_MSG("bad socket fd, out of fds?");
+        return -1;
+    }
+#else
+     if (*sockfd < 0) {
+         CYASSL_MSG("bad socket fd, out of fds?");
+         return -1;
+     }
+#endif
+
+#ifdef HAVE_OCSP_NONBLOCK
+    if (nonBlock) {
+        int flags = fcntl(*sockfd, F_GETFL, 0);
+
+        if (flags < 0 || fcntl(*sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            CYASSL_MSG("can't make OCSP responder socket non-blocking");
+            close(*sockfd);
+            return -1;
+        }
+    }
+#else
+    (void)nonBlock;
+#endif
+
+    if (connect(*sockfd, (struct sockaddr *)&addr, sockaddr_len) != 0) {
+    #ifdef HAVE_OCSP_NONBLOCK
+        if (nonBlock) {
+            if (errno == EINPROGRESS)
+                return 1;
+            close(*sockfd);
+        }
+    #endif
+        CYASSL_MSG("OCSP responder tcp connect failed");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/* request headers, reqType "POST" with a body of reqSz and contentType, or
+   "GET" with contentType NULL and no body, return length or 0 if too big */
+static int build_http_request(const char* reqType, const char* domainName,
+                              const char* path, int reqSz,
+                              const char* contentType, byte* buf, int bufSize)
+{
+    word32 reqTypeLen, domainNameLen, pathLen, completeLen;
+    word32 reqSzStrLen = 0, contentTypeLen = 0;
+    char reqSzStr[6];
+
+    reqTypeLen = (word32)XSTRLEN(reqType);
+    domainNameLen = (word32)XSTRLEN(domainName);
+    pathLen = (word32)XSTRLEN(path);
+    if (contentType) {
+        reqSzStrLen = Word16ToString(reqSzStr, (word16)reqSz);
+        contentTypeLen = (word32)XSTRLEN(contentType);
+    }
+
+    completeLen = reqTypeLen + pathLen + domainNameLen + 22;
+    if (contentType)
+        completeLen += reqSzStrLen + contentTypeLen + 34;
+    if (completeLen > (word32)bufSize)
+        return 0;
+
+    XSTRNCPY((char*)buf, reqType, reqTypeLen);
+    buf += reqTypeLen;
+    XSTRNCPY((char*)buf, " ", 1);
+    buf += 1;
+    XSTRNCPY((char*)buf, path, pathLen);
+    buf += pathLen;
+    XSTRNCPY((char*)buf, " HTTP/1.1\r\nHost: ", 17);
+    buf += 17;
+    XSTRNCPY((char*)buf, domainName, domainNameLen);
+    buf += domainNameLen;
+    if (contentType) {
+        XSTRNCPY((char*)buf, "\r\nContent-Length: ", 18);
+        buf += 18;
+        XSTRNCPY((char*)buf, reqSzStr, reqSzStrLen);
+        buf += reqSzStrLen;
+        XSTRNCPY((char*)buf, "\r\nContent-Type: ", 16);
+        buf += 16;
+        XSTRNCPY((char*)buf, contentType, contentTypeLen);
+        buf += contentTypeLen;
+    }
+    XSTRNCPY((char*)buf, "\r\n\r\n", 4);
+
+    return completeLen;
+}
+
+
+/* outName and outPath are MAX_URL_PART, longer parts are cut short */
+static int decode_url(const char* url, int urlSz,
+    char* outName, char* outPath, word16* outPort)
+{
+    int result = -1;
+
+    if (outName != NULL && outPath != NULL && outPort != NULL)
+    {
+        if (url == NULL || urlSz == 0)
+        {
+            *outName = 0;
+            *outPath = 0;
+            *outPort = 0;
+        }
+        else
+        {
+            int i, cur;
+    
+            /* need to break the url down into scheme, address, and port */
+            /*     "http://example.com:8080/" */
+            /*     "http://[::1]:443/"        */
+            if (XSTRNCMP(url, "http://", 7) == 0) {
+                cur = 7;
+            } else cur = 0;
+    
+            i = 0;
+            if (url[cur] == '[') {
+                cur++;
+                /* copy until ']' */
+                while (url[cur] != 0 && url[cur] != ']' && cur < urlSz &&
+                                                       i < MAX_URL_PART - 1) {
+                    outName[i++] = url[cur++];
+                }
+                cur++; /* skip ']' */
+            }
+            else {
+                while (url[cur] != 0 && url[cur] != ':' &&
+                                               url[cur] != '/' && cur < urlSz &&
+                                                       i < MAX_URL_PART - 1) {
+                    outName[i++] = url[cur++];
+                }
+            }
+            outName[i] = 0;
+            /* Need to pick out the path after the domain name */
+    
+            if (cur < urlSz && url[cur] == ':') {
+                char port[6];
+                int j;
+                word32 bigPort = 0;
+                i = 0;
+                cur++;
+                while (cur < urlSz && url[cur] != 0 && url[cur] != '/' &&
+                        i < 6) {
+                    port[i++] = url[cur++];
+                }
+    
+                for (j = 0; j < i; j++) {
+                    if (port[j] < '0' || port[j] > '9') return -1;
+                    bigPort = (bigPort * 10) + (port[j] - '0');
+                }
+                *outPort = (word16)bigPort;
+            }
+            else
+                *outPort = 80;
+    
+            if (cur < urlSz && url[cur] == '/') {
+                i = 0;
+                while (cur < urlSz && url[cur] != 0 && i < MAX_URL_PART - 1) {
+                    outPath[i++] = url[cur++];
+                }
+                outPath[i] = 0;
+            }
+            else {
+                outPath[0] = '/';
+                outPath[1] = 0;
+            }
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+
+/* appStr is the expected Content-Type, NULL takes any or none, maxSz limits
+ * the body, 0 for no limit
+ * return: >0 Response Size
  *         -1 error */
-static int process_http_response(int sfd, byte** respBuf,
-                                                  byte* httpBuf, int httpBufSz)
+static int process_http_response(int sfd, byte** respBuf, byte* httpBuf,
+                          int httpBufSz, const char* appStr, int maxSz)
+{
+    int result;
+    int len = 0;
+    char *start, *end;
+    byte *recvBuf = NULL;
+    int recvBufSz = 0;
+    enum phr_state { phr_init, phr_http_start, phr_have_length,
+                     phr_have_type, phr_wait_end, phr_http_end
+    } state = phr_init;
+
+    start = end = NULL;
+    do {
+        if (end == NULL) {
+            result = (int)recv(sfd, (char*)httpBuf+len, httpBufSz-len-1, 0);
+            if (result > 0) {
+                len += result;
+                start = (char*)httpBuf;
+                start[len] = 0;
+            }
+            else {
+                CYASSL_MSG("process_http_response recv http from peer failed");
+                return -1;
+            }
+        }
+        end = XSTRSTR(start, "\r\n");
+
+        if (end == NULL) {
+            if (len != 0)
+                XMEMMOVE(httpBuf, start, len);
+            start = end = NULL;
+        }
+        else if (end == start) {
+            if (state == phr_wait_end ||
+                            (appStr == NULL && state == phr_have_length)) {
+                state = phr_http_end;
+                len -= 2;
+                start += 2;
+             }
+             else {
+                CYASSL_MSG("process_http_response header ended early");
+                return -1;
+             }
+        }
+        else {
+            *end = 0;
+            len -= (int)(end - start) + 2;
+                /* adjust len to remove the first line including the /r/n */
+
+            if (XSTRNCASECMP(start, "HTTP/1", 6) == 0) {
+                start += 9;
+                if (XSTRNCASECMP(start, "200 OK", 6) != 0 ||
+                                                           state != phr_init) {
+                    CYASSL_MSG("process_http_response not OK");
+                    return -1;
+                }
+                state = phr_http_start;
+            }
+            else if (XSTRNCASECMP(start, "Content-Type:", 13) == 0) {
+                start += 13;
+                while (*start == ' ' && *start != '\0') start++;
+                if (appStr && XSTRNCASECMP(start, appStr,
+                                               XSTRLEN(appStr)) != 0) {
+                    CYASSL_MSG("process_http_response wrong content type");
+                    return -1;
+                }
+                
+                if (state == phr_http_start) state = phr_have_type;
+                else if (state == phr_have_length) state = phr_wait_end;
+                else {
+                    CYASSL_MSG("process_http_response type invalid state");
+                    return -1;
+                }
+            }
+            else if (XSTRNCASECMP(start, "Content-Length:", 15) == 0) {
+                start += 15;
+                while (*start == ' ' && *start != '\0') start++;
+                recvBufSz = atoi(start);
+
+                if (state == phr_http_start) state = phr_have_length;
+                else if (state == phr_have_type) state = phr_wait_end;
+                else {
+                    CYASSL_MSG("process_http_response length invalid state");
+                    return -1;
+                }
+            }
+            
+            start = end + 2;
+        }
+    } while (state != phr_http_end);
+
+    if (recvBufSz <= 0 || (maxSz > 0 && recvBufSz > maxSz) || len > recvBufSz) {
+        CYASSL_MSG("process_http_response bad content length");
+        return -1;
+    }
+
+    recvBuf = (byte*)XMALLOC(recvBufSz, NULL, DYNAMIC_TYPE_IN_BUFFER);
+    if (recvBuf == NULL) {
+        CYASSL_MSG("process_http_response couldn't create response buffer");
+        return -1;
+    }
+
+    /* copy the remainder of the httpBuf into the respBuf */
+    if (len != 0)
+        XMEMCPY(recvBuf, start, len);
+
+    /* receive the response data */
+    while (len != recvBufSz) {
+        result = (int)recv(sfd, (char*)recvBuf+len, recvBufSz-len, 0);
+        if (result > 0)
+            len += result;
+        else {
+            CYASSL_MSG("process_http_response recv body from peer failed");
+            XFREE(recvBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
+            return -1;
+        }
+    }
+
+    *respBuf = recvBuf;
+    return recvBufSz;
+}
+
+
+#define SCRATCH_BUFFER_SIZE 512
+
+#ifdef HAVE_OCSP
+
+#ifndef OCSP_GET_MAX
+    #define OCSP_GET_MAX 255    /* longest encoded request sent by GET */
+#endif
+
+#define OCSP_GET_PATH_SZ (MAX_URL_PART + 1 + OCSP_GET_MAX + 1)
+
+
+/* Turn path, OCSP_GET_PATH_SZ long, into the RFC 6960 A.1 GET path for the
+   DER request req: the url-encoded base64 of req appended. Returns 0 with
+   path as it was when the encoding is over OCSP_GET_MAX, POST it then */
+static int OcspGetPath(char* path, const byte* req, int reqSz)
 {
-    int result;
-    int len = 0;
-    char *start, *end;
-    byte *recvBuf = NULL;
-    int recvBufSz = 0;
-    enum phr_state { phr_init, phr_http_start, phr_have_length,
-                     phr_have_type, phr_wait_end, phr_http_end
-    } state = phr_init;
+    static const char b64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int pathSz = (int)XSTRLEN(path);
+    int outSz  = pathSz;
+    int i;
+
+    if (pathSz == 0 || path[pathSz - 1] != '/')
+        path[outSz++] = '/';
+
+    for (i = 0; i < reqSz; i += 3) {
+        word32 n = (word32)req[i] << 16;
+        char   c[4];
+        int    j;
+
+        if (i + 1 < reqSz) n |= (word32)req[i + 1] << 8;
+        if (i + 2 < reqSz) n |= req[i + 2];
+
+        c[0] = b64[(n >> 18) & 0x3f];
+        c[1] = b64[(n >> 12) & 0x3f];
+        c[2] = i + 1 < reqSz ? b64[(n >> 6) & 0x3f] : '=';
+        c[3] = i + 2 < reqSz ? b64[n & 0x3f] : '=';
+
+        for (j = 0; j < 4; j++) {
+            /* '+', '/' and '=' aren't taken as is in a path */
+            const char* esc = c[j] == '+' ? "%2B" : c[j] == '/' ? "%2F" :
+                              c[j] == '=' ? "%3D" : NULL;
+
+            if (outSz + (esc ? 3 : 1) > pathSz + 1 + OCSP_GET_MAX) {
+                path[pathSz] = 0;
+                return 0;
+            }
+            if (esc) {
+                XMEMCPY(path + outSz, esc, 3);
+                outSz += 3;
+            }
+            else
+                path[outSz++] = c[j];
+        }
+    }
+    path[outSz] = 0;
 
-    start = end = NULL;
-    do {
-        if (end == NULL) {
-            result = (int)recv(sfd, (char*)httpBuf+len, httpBufSz-len-1, 0);
-            if (result > 0) {
-                len += result;
-                start = (char*)httpBuf;
-                start[len] = 0;
+    return outSz;
+}
+
+
+/* Blocking lookup of req at url, by GET if get is set and it's short
+   enough, else POST */
+static int OcspHttpLookup(const char* url, int urlSz, const byte* ocspReqBuf,
+                          int ocspReqSz, byte** ocspRespBuf, int get)
+{
+    SOCKET_T sfd = 0;
+    word16   port;
+    int      ret = -1;
+#ifdef CYASSL_SMALL_STACK
+    char*    path;
+    char*    domainName;
+#else
+    char     path[OCSP_GET_PATH_SZ];
+    char     domainName[MAX_URL_PART];
+#endif
+
+#ifdef CYASSL_SMALL_STACK
+    path = (char*)XMALLOC(OCSP_GET_PATH_SZ, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (path == NULL)
+        return -1;
+    
+    domainName = (char*)XMALLOC(MAX_URL_PART, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (domainName == NULL) {
+        XFREE(path, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return -1;
+    }
+#endif
+
+    if (ocspReqBuf == NULL || ocspReqSz == 0) {
+        CYASSL_MSG("OCSP request is required for lookup");
+    }
+    else if (ocspRespBuf == NULL) {
+        CYASSL_MSG("Cannot save OCSP response");
+    }
+    else if (decode_url(url, urlSz, domainName, path, &port) < 0) {
+        CYASSL_MSG("Unable to decode OCSP URL");
+    }
+    else {
+        /* Note, the library uses the EmbedOcspRespFree() callback to
+         * free this buffer. */
+        int   httpBufSz = SCRATCH_BUFFER_SIZE;
+        byte* httpBuf   = (byte*)XMALLOC(httpBufSz, NULL, 
+                                                        DYNAMIC_TYPE_IN_BUFFER);
+
+        if (httpBuf == NULL) {
+            CYASSL_MSG("Unable to create OCSP response buffer");
+        }
+        else {
+            if (get && OcspGetPath(path, ocspReqBuf, ocspReqSz) > 0) {
+                httpBufSz = build_http_request("GET", domainName, path, 0,
+                                               NULL, httpBuf, httpBufSz);
+                ocspReqSz = 0;
+            }
+            else
+                httpBufSz = build_http_request("POST", domainName, path,
+                     ocspReqSz, "application/ocsp-request", httpBuf, httpBufSz);
+
+            if ((tcp_connect(&sfd, domainName, port, 0) != 0) || (sfd <= 0)) {
+                CYASSL_MSG("OCSP Responder connection failed");
+            }
+            else if ((int)send(sfd, (char*)httpBuf, httpBufSz, 0) !=
+                                                                    httpBufSz) {
+                CYASSL_MSG("OCSP http request failed");
+            }
+            else if (ocspReqSz > 0 && (int)send(sfd, (char*)ocspReqBuf,
+                                                   ocspReqSz, 0) != ocspReqSz) {
+                CYASSL_MSG("OCSP ocsp request failed");
             }
             else {
-                CYASSL_MSG("process_http_response recv http from peer failed");
+                ret = process_http_response(sfd, ocspRespBuf, httpBuf,
+                           SCRATCH_BUFFER_SIZE, "application/ocsp-response", 0);
+            }
+
+            close(sfd);
+            XFREE(httpBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
+        }
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(path,       NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(domainName, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+
+int EmbedOcspLookup(void* ctx, const char* url, int urlSz,
+                        byte* ocspReqBuf, int ocspReqSz, byte** ocspRespBuf)
+{
+    (void)ctx;
+
+    return OcspHttpLookup(url, urlSz, ocspReqBuf, ocspReqSz, ocspRespBuf, 0);
+}
+
+
+/* EmbedOcspLookup() by GET, for nonce-free requests an HTTP cache in front
+   of the responder can answer. Freed with EmbedOcspRespFree() too */
+int EmbedOcspGet(const char* url, int urlSz, const byte* req, int reqSz,
+                 byte** resp)
+{
+    return OcspHttpLookup(url, urlSz, req, reqSz, resp, 1);
+}
+
+
+void EmbedOcspRespFree(void* ctx, byte *resp)
+{
+    (void)ctx;
+
+    if (resp)
+        XFREE(resp, NULL, DYNAMIC_TYPE_IN_BUFFER);
+}
+
+
+#ifdef HAVE_OCSP_NONBLOCK
+
+#ifndef OCSP_HTTP_HDR_SZ
+    #define OCSP_HTTP_HDR_SZ 2048       /* longest response header taken */
+#endif
+
+#ifndef OCSP_HTTP_MAX_SZ
+    #define OCSP_HTTP_MAX_SZ 65536      /* longest response body taken */
+#endif
+
+#ifdef MSG_NOSIGNAL
+    #define OCSP_SEND_FLAGS MSG_NOSIGNAL    /* a kept connection may be gone */
+#else
+    #define OCSP_SEND_FLAGS 0
+#endif
+
+
+/* Kept connection to domain and port, -1 if none. Ones idle too long are
+   closed on the way */
+static SOCKET_T TakeOcspConn(CYASSL_OCSP* ocsp, const char* domain,
+                             word16 port)
+{
+    SOCKET_T fd  = -1;
+    word32   now = LowResTimer();
+    int      i;
+
+    if (LockMutex(&ocsp->ocspLock) != 0)
+        return -1;
+
+    for (i = 0; i < OCSP_CONN_MAX; i++) {
+        OcspConn* conn = &ocsp->conns[i];
+
+        if (!conn->open)
+            continue;
+
+        if (now - conn->idle > OCSP_CONN_IDLE) {
+            close(conn->fd);
+            conn->open = 0;
+        }
+        else if (fd == -1 && conn->port == port &&
+                          XSTRNCMP(conn->domain, domain, MAX_URL_PART) == 0) {
+            fd = conn->fd;
+            conn->open = 0;
+        }
+    }
+
+    UnLockMutex(&ocsp->ocspLock);
+
+    return fd;
+}
+
+
+/* Keep the connection of lookup for the next request there, in a free slot
+   or in place of the one idle the longest */
+static void PutOcspConn(CYASSL_OCSP* ocsp, OcspLookup* lookup)
+{
+    OcspConn* slot = NULL;
+    int       i;
+
+    if (LockMutex(&ocsp->ocspLock) != 0) {
+        close(lookup->fd);
+        return;
+    }
+
+    for (i = 0; i < OCSP_CONN_MAX; i++) {
+        OcspConn* conn = &ocsp->conns[i];
+
+        if (!conn->open) {
+            slot = conn;
+            break;
+        }
+        if (slot == NULL || (int)(conn->idle - slot->idle) < 0)
+            slot = conn;
+    }
+
+    if (slot->open)
+        close(slot->fd);
+
+    slot->fd   = lookup->fd;
+    slot->open = 1;
+    slot->port = lookup->port;
+    slot->idle = LowResTimer();
+    XSTRNCPY(slot->domain, lookup->domain, MAX_URL_PART);
+
+    UnLockMutex(&ocsp->ocspLock);
+}
+
+
+/* Close the kept connections, ocsp is going away */
+void FreeOcspConns(CYASSL_OCSP* ocsp)
+{
+    int i;
+
+    for (i = 0; i < OCSP_CONN_MAX; i++) {
+        if (ocsp->conns[i].open) {
+            close(ocsp->conns[i].fd);
+            ocsp->conns[i].open = 0;
+        }
+    }
+}
+
+
+/* Connection for lookup, a kept one if reuse and there is one, 0 on ok */
+static int OcspConnect(CYASSL_OCSP* ocsp, OcspLookup* lookup, int reuse)
+{
+    int ret;
+
+    lookup->outIdx = 0;
+    lookup->inIdx  = 0;
+    lookup->hdrSz  = 0;
+    lookup->bodySz = 0;
+    lookup->reused = 0;
+
+    if (reuse) {
+        lookup->fd = TakeOcspConn(ocsp, lookup->domain, lookup->port);
+        if (lookup->fd != -1) {
+            CYASSL_MSG("Reusing kept OCSP responder connection");
+            lookup->reused = 1;
+            lookup->state  = OCSP_LOOKUP_SEND;
+            return 0;
+        }
+    }
+
+    ret = tcp_connect(&lookup->fd, lookup->domain, lookup->port, 1);
+    if (ret < 0) {
+        lookup->fd = -1;
+        return -1;
+    }
+    lookup->state = (ret == 0) ? OCSP_LOOKUP_SEND : OCSP_LOOKUP_CONNECT;
+
+    return 0;
+}
+
+
+/* The request failed on its connection. A kept one may have been closed by
+   the responder meanwhile, then it goes out again on a new one */
+static int OcspRetry(CYASSL_OCSP* ocsp, OcspLookup* lookup)
+{
+    if (!lookup->reused || lookup->inIdx != 0) {
+        CYASSL_MSG("OCSP responder connection failed");
+        return -1;
+    }
+
+    CYASSL_MSG("Kept OCSP responder connection gone, connecting again");
+    close(lookup->fd);
+    lookup->fd = -1;
+
+    return OcspConnect(ocsp, lookup, 0);
+}
+
+
+/* does header line, lineSz long, start with name */
+static int HttpHeaderIs(const char* line, int lineSz, const char* name)
+{
+    int nameSz = (int)XSTRLEN(name);
+
+    return lineSz >= nameSz && XSTRNCASECMP(line, name, nameSz) == 0;
+}
+
+
+/* Parse the response header once it's all in, 1 when it was and is ok, 0 if
+   more is needed, -1 on a bad one */
+static int ParseOcspHttpHeader(OcspLookup* lookup)
+{
+    const char* hdr = (const char*)lookup->in;
+    const char* line;
+    word32      end;
+    word32      bodySz = 0;
+    int         haveType = 0, haveLength = 0;
+
+    for (end = 0; end + 4 <= lookup->inIdx; end++) {
+        if (XMEMCMP(hdr + end, "\r\n\r\n", 4) == 0)
+            break;
+    }
+    if (end + 4 > lookup->inIdx)
+        return 0;
+
+    /* status line, HTTP/1.1 connections stay unless the responder says */
+    if (end < 12 || XSTRNCMP(hdr, "HTTP/1.", 7) != 0 ||
+                                             XSTRNCMP(hdr + 8, " 200", 4) != 0) {
+        CYASSL_MSG("OCSP http response not OK");
+        return -1;
+    }
+    lookup->keepAlive = (hdr[7] == '1');
+
+    /* lines all end, the header does with an empty one */
+    for (line = hdr; line[0] != '\r' || line[1] != '\n'; line++)
+        ;
+    for (line += 2; line < hdr + end; ) {
+        const char* next;
+        const char* value;
+        int         lineSz;
+
+        for (next = line; next[0] != '\r' || next[1] != '\n'; next++)
+            ;
+        lineSz = (int)(next - line);
+
+        for (value = line; value < next && *value != ':'; value++)
+            ;
+        if (value < next)
+            value++;
+        while (value < next && *value == ' ')
+            value++;
+
+        if (HttpHeaderIs(line, lineSz, "Content-Type:")) {
+            if (!HttpHeaderIs(value, (int)(next - value),
+                                          "application/ocsp-response")) {
+                CYASSL_MSG("OCSP http response wrong content type");
+                return -1;
+            }
+            haveType = 1;
+        }
+        else if (HttpHeaderIs(line, lineSz, "Content-Length:")) {
+            for (; value < next && *value >= '0' && *value <= '9'; value++) {
+                bodySz = bodySz * 10 + (*value - '0');
+                if (bodySz > OCSP_HTTP_MAX_SZ) {
+                    CYASSL_MSG("OCSP http response too long");
+                    return -1;
+                }
+            }
+            haveLength = 1;
+        }
+        else if (HttpHeaderIs(line, lineSz, "Connection:")) {
+            if (HttpHeaderIs(value, (int)(next - value), "close"))
+                lookup->keepAlive = 0;
+            else if (HttpHeaderIs(value, (int)(next - value), "keep-alive"))
+                lookup->keepAlive = 1;
+        }
+
+        line = next + 2;
+    }
+
+    if (!haveType || !haveLength || bodySz == 0) {
+        CYASSL_MSG("OCSP http response header incomplete");
+        return -1;
+    }
+
+    lookup->hdrSz  = end + 4;
+    lookup->bodySz = bodySz;
+
+    /* room for all of the body */
+    if (lookup->hdrSz + bodySz > lookup->inSz) {
+        byte* in = (byte*)XREALLOC(lookup->in, lookup->hdrSz + bodySz, NULL,
+                                   DYNAMIC_TYPE_IN_BUFFER);
+        if (in == NULL)
+            return -1;
+        lookup->in   = in;
+        lookup->inSz = lookup->hdrSz + bodySz;
+    }
+
+    return 1;
+}
+
+
+/* Set up lookup to send the DER request req to the responder at url, the
+   connection is started. Nonce-free ones go by GET when short enough, the
+   rest by POST. 0 on ok */
+int EmbedOcspStart(CYASSL_OCSP* ocsp, OcspLookup* lookup, const char* url,
+                   int urlSz, const byte* req, int reqSz)
+{
+    char path[OCSP_GET_PATH_SZ];
+    int  hdrSz;
+
+    if (decode_url(url, urlSz, lookup->domain, path, &lookup->port) < 0) {
+        CYASSL_MSG("Unable to decode OCSP URL");
+        return -1;
+    }
+
+    lookup->out = (byte*)XMALLOC(SCRATCH_BUFFER_SIZE + reqSz, NULL,
+                                                        DYNAMIC_TYPE_IN_BUFFER);
+    if (lookup->out == NULL)
+        return MEMORY_E;
+
+    if (lookup->request.nonceSz == 0 && OcspGetPath(path, req, reqSz) > 0) {
+        hdrSz = build_http_request("GET", lookup->domain, path, 0, NULL,
+                                   lookup->out, SCRATCH_BUFFER_SIZE);
+        reqSz = 0;
+    }
+    else
+        hdrSz = build_http_request("POST", lookup->domain, path, reqSz,
+                   "application/ocsp-request", lookup->out, SCRATCH_BUFFER_SIZE);
+    if (hdrSz == 0)
+        return -1;
+
+    XMEMCPY(lookup->out + hdrSz, req, reqSz);
+    lookup->outSz = hdrSz + reqSz;
+
+    return OcspConnect(ocsp, lookup, 1);
+}
+
+
+/* Move lookup on as far as its connection allows without blocking. Returns
+   OCSP_WANT_READ or OCSP_WANT_WRITE to be called again once lookup->fd is
+   ready, the body size with *resp pointing to it when all of the response
+   is in, or < 0 on error */
+int EmbedOcspStep(CYASSL_OCSP* ocsp, OcspLookup* lookup, byte** resp)
+{
+    for (;;) {
+        int n;
+
+        switch (lookup->state) {
+
+        case OCSP_LOOKUP_CONNECT:
+        {
+            struct pollfd pfd;
+            int           err = 0;
+            socklen_t     errSz = sizeof(err);
+
+            pfd.fd      = lookup->fd;
+            pfd.events  = POLLOUT;
+            pfd.revents = 0;
+
+            n = poll(&pfd, 1, 0);
+            if (n == 0)
+                return OCSP_WANT_WRITE;
+            if (n < 0 || getsockopt(lookup->fd, SOL_SOCKET, SO_ERROR,
+                                    &err, &errSz) != 0 || err != 0) {
+                CYASSL_MSG("OCSP responder tcp connect failed");
                 return -1;
             }
+            lookup->state = OCSP_LOOKUP_SEND;
+            break;
         }
-        end = XSTRSTR(start, "\r\n");
 
-        if (end == NULL) {
-            if (len != 0)
-                XMEMMOVE(httpBuf, start, len);
-            start = end = NULL;
-        }
-        else if (end == start) {
-            if (state == phr_wait_end) {
-                state = phr_http_end;
-                len -= 2;
-                start += 2;
-             }
-             else {
-                CYASSL_MSG("process_http_response header ended early");
-                return -1;
-             }
-        }
-        else {
-            *end = 0;
-            len -= (int)(end - start) + 2;
-                /* adjust len to remove the first line including the /r/n */
+        case OCSP_LOOKUP_SEND:
+            n = (int)send(lookup->fd, (char*)lookup->out + lookup->outIdx,
+                          lookup->outSz - lookup->outIdx, OCSP_SEND_FLAGS);
+            if (n < 0) {
+                int err = LastError();
 
-            if (XSTRNCASECMP(start, "HTTP/1", 6) == 0) {
-                start += 9;
-                if (XSTRNCASECMP(start, "200 OK", 6) != 0 ||
-                                                           state != phr_init) {
-                    CYASSL_MSG("process_http_response not OK");
+                if (err == SOCKET_EWOULDBLOCK || err == SOCKET_EAGAIN)
+                    return OCSP_WANT_WRITE;
+                if (err != SOCKET_EINTR && OcspRetry(ocsp, lookup) != 0)
                     return -1;
-                }
-                state = phr_http_start;
+                break;
             }
-            else if (XSTRNCASECMP(start, "Content-Type:", 13) == 0) {
-                start += 13;
-                while (*start == ' ' && *start != '\0') start++;
-                if (XSTRNCASECMP(start, "application/ocsp-response", 25) != 0) {
-                    CYASSL_MSG("process_http_response not ocsp-response");
-                    return -1;
-                }
-                
-                if (state == phr_http_start) state = phr_have_type;
-                else if (state == phr_have_length) state = phr_wait_end;
-                else {
-                    CYASSL_MSG("process_http_response type invalid state");
+            lookup->outIdx += n;
+            if (lookup->outIdx == lookup->outSz)
+                lookup->state = OCSP_LOOKUP_RECV;
+            break;
+
+        case OCSP_LOOKUP_RECV:
+            if (lookup->in == NULL) {
+                lookup->in = (byte*)XMALLOC(OCSP_HTTP_HDR_SZ, NULL,
+                                                        DYNAMIC_TYPE_IN_BUFFER);
+                if (lookup->in == NULL)
+                    return MEMORY_E;
+                lookup->inSz = OCSP_HTTP_HDR_SZ;
+            }
+
+            /* no more than the body once its length is known */
+            n = (int)(lookup->hdrSz == 0 ? lookup->inSz - lookup->inIdx
+                           : lookup->hdrSz + lookup->bodySz - lookup->inIdx);
+            n = (int)recv(lookup->fd, (char*)lookup->in + lookup->inIdx, n, 0);
+            if (n <= 0) {
+                int err = (n < 0) ? LastError() : 0;
+
+                if (n < 0 && (err == SOCKET_EWOULDBLOCK ||
+                              err == SOCKET_EAGAIN))
+                    return OCSP_WANT_READ;
+                if (err != SOCKET_EINTR && OcspRetry(ocsp, lookup) != 0)
                     return -1;
-                }
+                break;
             }
-            else if (XSTRNCASECMP(start, "Content-Length:", 15) == 0) {
-                start += 15;
-                while (*start == ' ' && *start != '\0') start++;
-                recvBufSz = atoi(start);
+            lookup->inIdx += n;
 
-                if (state == phr_http_start) state = phr_have_length;
-                else if (state == phr_have_type) state = phr_wait_end;
-                else {
-                    CYASSL_MSG("process_http_response length invalid state");
+            if (lookup->hdrSz == 0) {
+                n = ParseOcspHttpHeader(lookup);
+                if (n < 0)
                     return -1;
+                if (n == 0) {
+                    if (lookup->inIdx == lookup->inSz) {
+                        CYASSL_MSG("OCSP http response header too long");
+                        return -1;
+                    }
+                    break;
                 }
             }
-            
-            start = end + 2;
-        }
-    } while (state != phr_http_end);
 
-    recvBuf = (byte*)XMALLOC(recvBufSz, NULL, DYNAMIC_TYPE_IN_BUFFER);
-    if (recvBuf == NULL) {
-        CYASSL_MSG("process_http_response couldn't create response buffer");
-        return -1;
-    }
+            if (lookup->inIdx > lookup->hdrSz + lookup->bodySz) {
+                CYASSL_MSG("OCSP http response longer than its length");
+                return -1;
+            }
+            if (lookup->inIdx == lookup->hdrSz + lookup->bodySz)
+                lookup->state = OCSP_LOOKUP_DONE;
+            break;
 
-    /* copy the remainder of the httpBuf into the respBuf */
-    if (len != 0)
-        XMEMCPY(recvBuf, start, len);
+        case OCSP_LOOKUP_DONE:
+            *resp = lookup->in + lookup->hdrSz;
+            return (int)lookup->bodySz;
 
-    /* receive the OCSP response data */
-    do {
-        result = (int)recv(sfd, (char*)recvBuf+len, recvBufSz-len, 0);
-        if (result > 0)
-            len += result;
-        else {
-            CYASSL_MSG("process_http_response recv ocsp from peer failed");
+        default:
             return -1;
         }
-    } while (len != recvBufSz);
+    }
+}
 
-    *respBuf = recvBuf;
-    return recvBufSz;
+
+/* Free what lookup holds, its connection is kept when the responder lets
+   it stay and the whole response was read */
+void EmbedOcspDone(CYASSL_OCSP* ocsp, OcspLookup* lookup)
+{
+    if (lookup->fd != -1) {
+        if (ocsp && lookup->state == OCSP_LOOKUP_DONE && lookup->keepAlive)
+            PutOcspConn(ocsp, lookup);
+        else
+            close(lookup->fd);
+        lookup->fd = -1;
+    }
+
+    if (lookup->out)
+        XFREE(lookup->out, NULL, DYNAMIC_TYPE_IN_BUFFER);
+    if (lookup->in)
+        XFREE(lookup->in, NULL, DYNAMIC_TYPE_IN_BUFFER);
+    lookup->out = NULL;
+    lookup->in  = NULL;
 }
 
+#endif /* HAVE_OCSP_NONBLOCK */
 
-#define SCRATCH_BUFFER_SIZE 512
+#endif /* HAVE_OCSP */
 
-int EmbedOcspLookup(void* ctx, const char* url, int urlSz,
-                        byte* ocspReqBuf, int ocspReqSz, byte** ocspRespBuf)
+
+#ifdef HAVE_CRL_FETCH
+
+/* GET the CRL at a distribution point url, any content type is taken, the
+ * CRL's signature is what's checked. *crlBuf is freed with XFREE
+ * DYNAMIC_TYPE_IN_BUFFER
+ * return: >0 CRL size
+ *         -1 error */
+int EmbedCrlLookup(const char* url, int urlSz, byte** crlBuf)
 {
     SOCKET_T sfd = 0;
     word16   port;
@@ -866,64 +2326,58 @@ int EmbedOcspLookup(void* ctx, const char* url, int urlSz,
     char*    path;
     char*    domainName;
 #else
-    char     path[80];
-    char     domainName[80];
+    char     path[MAX_URL_PART];
+    char     domainName[MAX_URL_PART];
 #endif
 
+    if (url == NULL || urlSz == 0 || crlBuf == NULL)
+        return -1;
+
 #ifdef CYASSL_SMALL_STACK
-    path = (char*)XMALLOC(80, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    path = (char*)XMALLOC(MAX_URL_PART, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     if (path == NULL)
         return -1;
-    
-    domainName = (char*)XMALLOC(80, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    domainName = (char*)XMALLOC(MAX_URL_PART, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     if (domainName == NULL) {
         XFREE(path, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         return -1;
     }
 #endif
 
-    (void)ctx;
-
-    if (ocspReqBuf == NULL || ocspReqSz == 0) {
-        CYASSL_MSG("OCSP request is required for lookup");
-    }
-    else if (ocspRespBuf == NULL) {
-        CYASSL_MSG("Cannot save OCSP response");
-    }
-    else if (decode_url(url, urlSz, domainName, path, &port) < 0) {
-        CYASSL_MSG("Unable to decode OCSP URL");
+    if (decode_url(url, urlSz, domainName, path, &port) < 0) {
+        CYASSL_MSG("Unable to decode CRL URL");
     }
     else {
-        /* Note, the library uses the EmbedOcspRespFree() callback to
-         * free this buffer. */
         int   httpBufSz = SCRATCH_BUFFER_SIZE;
-        byte* httpBuf   = (byte*)XMALLOC(httpBufSz, NULL, 
+        byte* httpBuf   = (byte*)XMALLOC(httpBufSz, NULL,
                                                         DYNAMIC_TYPE_IN_BUFFER);
 
         if (httpBuf == NULL) {
-            CYASSL_MSG("Unable to create OCSP response buffer");
+            CYASSL_MSG("Unable to create CRL response buffer");
         }
         else {
-            httpBufSz = build_http_request(domainName, path, ocspReqSz,
+            httpBufSz = build_http_request("GET", domainName, path, 0, NULL,
                                                             httpBuf, httpBufSz);
 
-            if ((tcp_connect(&sfd, domainName, port) != 0) || (sfd <= 0)) {
-                CYASSL_MSG("OCSP Responder connection failed");
+            if (httpBufSz == 0) {
+                CYASSL_MSG("CRL http request too big");
+            }
+            else if ((tcp_connect(&sfd, domainName, port, 0) != 0) ||
+                                                                 (sfd <= 0)) {
+                CYASSL_MSG("CRL distribution point connection failed");
             }
             else if ((int)send(sfd, (char*)httpBuf, httpBufSz, 0) !=
                                                                     httpBufSz) {
-                CYASSL_MSG("OCSP http request failed");
-            }
-            else if ((int)send(sfd, (char*)ocspReqBuf, ocspReqSz, 0) !=
-                                                                    ocspReqSz) {
-                CYASSL_MSG("OCSP ocsp request failed");
+                CYASSL_MSG("CRL http request failed");
             }
             else {
-                ret = process_http_response(sfd, ocspRespBuf, httpBuf,
-                                                           SCRATCH_BUFFER_SIZE);
+                ret = process_http_response(sfd, crlBuf, httpBuf,
+                                  SCRATCH_BUFFER_SIZE, NULL, CRL_FETCH_MAX_SZ);
             }
 
-            close(sfd);
+            if (sfd > 0)
+                close(sfd);
             XFREE(httpBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
         }
     }
@@ -936,18 +2390,417 @@ int EmbedOcspLookup(void* ctx, const char* url, int urlSz,
     return ret;
 }
 
+#endif /* HAVE_CRL_FETCH */
 
-void EmbedOcspRespFree(void* ctx, byte *resp)
+
+#ifdef HAVE_CONN_POOL
+
+/* Close and free a pooled connection, no close_notify, the peer may be gone
+   already */
+static void PoolClose(CYASSL* ssl)
 {
-    (void)ctx;
+    int fd = CyaSSL_get_fd(ssl);
 
-    if (resp)
-        XFREE(resp, NULL, DYNAMIC_TYPE_IN_BUFFER);
+    CyaSSL_free(ssl);
+    if (fd >= 0)
+        close(fd);
+}
+
+
+/* An idle connection is good while not idle too long and with nothing to
+   read, an idle server only sends when it goes away (alert or FIN) */
+static int PoolConnAlive(CYASSL_CONN_POOL* pool, ConnPoolConn* conn,
+                         word32 now)
+{
+    struct pollfd pfd;
+
+    if (now - conn->idleSince >= pool->maxIdle)
+        return 0;
+
+    pfd.fd      = CyaSSL_get_fd(conn->ssl);
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+
+    return poll(&pfd, 1, 0) == 0;
 }
 
 
+/* New handshaken connection to up, resuming the last session there when the
+   client cache has one, NULL on failure */
+static CYASSL* PoolConnect(CYASSL_CONN_POOL* pool, ConnPoolUpstream* up)
+{
+    CYASSL*  ssl;
+    SOCKET_T fd = -1;
+
+    if (tcp_connect(&fd, up->host, up->port, 0) != 0) {
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    ssl = CyaSSL_new(pool->ctx);
+    if (ssl == NULL) {
+        close(fd);
+        return NULL;
+    }
+    CyaSSL_set_fd(ssl, fd);
+#if !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE)
+    CyaSSL_SetServerID(ssl, up->serverId, sizeof(up->serverId), 0);
 #endif
 
+    if (CyaSSL_connect(ssl) != SSL_SUCCESS) {
+        CYASSL_MSG("Pool connect handshake failed");
+        PoolClose(ssl);
+        return NULL;
+    }
+    ssl->poolUpstream = up;
+
+    return ssl;
+}
+
+
+/* Upstream for host and port, NULL if not added, caller has the lock */
+static ConnPoolUpstream* PoolFind(CYASSL_CONN_POOL* pool, const char* host,
+                                  word16 port)
+{
+    ConnPoolUpstream* up;
+
+    for (up = pool->upstreams; up != NULL; up = up->next) {
+        if (up->port == port &&
+                           XSTRNCMP(up->host, host, CONN_POOL_HOST_SZ) == 0)
+            break;
+    }
+
+    return up;
+}
+
+
+/* Put ssl on the idle list of up, caller has the lock */
+static int PoolPush(CYASSL_CONN_POOL* pool, ConnPoolUpstream* up, CYASSL* ssl)
+{
+    ConnPoolConn* conn;
+
+    conn = (ConnPoolConn*)XMALLOC(sizeof(ConnPoolConn), pool->heap,
+                                  DYNAMIC_TYPE_CONN_POOL);
+    if (conn == NULL)
+        return MEMORY_E;
+
+    conn->ssl       = ssl;
+    conn->idleSince = LowResTimer();
+    conn->next      = up->idle;
+    up->idle        = conn;
+    up->idleCount++;
+
+    return 0;
+}
+
+
+/* Close idle connections of up that went stale, caller has the lock */
+static void PoolPrune(CYASSL_CONN_POOL* pool, ConnPoolUpstream* up)
+{
+    ConnPoolConn** prev = &up->idle;
+    word32         now  = LowResTimer();
+
+    while (*prev != NULL) {
+        ConnPoolConn* conn = *prev;
+
+        if (PoolConnAlive(pool, conn, now)) {
+            prev = &conn->next;
+            continue;
+        }
+
+        *prev = conn->next;
+        up->idleCount--;
+        PoolClose(conn->ssl);
+        XFREE(conn, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+    }
+}
+
+
+/* Refiller thread, every CONN_POOL_INTERVAL or when woken drops stale idle
+   connections and connects each upstream back up to target, the connects
+   are done without the lock */
+static void* DoConnPoolRefill(void* arg)
+{
+    CYASSL_CONN_POOL* pool = (CYASSL_CONN_POOL*)arg;
+    struct timespec   wake;
+
+    CYASSL_ENTER("DoConnPoolRefill");
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (!pool->stop) {
+        ConnPoolUpstream* up;
+
+        for (up = pool->upstreams; up != NULL; up = up->next) {
+            PoolPrune(pool, up);
+
+            while (!pool->stop && up->idleCount < pool->target &&
+                                   (int)(LowResTimer() - up->retryAt) >= 0) {
+                CYASSL* ssl;
+
+                pthread_mutex_unlock(&pool->lock);
+                ssl = PoolConnect(pool, up);
+                pthread_mutex_lock(&pool->lock);
+
+                if (ssl == NULL) {
+                    CYASSL_MSG("Pool refill failed, backing off");
+                    up->retryAt = LowResTimer() + CONN_POOL_RETRY;
+                }
+                else if (pool->stop || PoolPush(pool, up, ssl) != 0) {
+                    PoolClose(ssl);
+                    break;
+                }
+            }
+        }
+
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += CONN_POOL_INTERVAL;
+        if (!pool->stop)
+            pthread_cond_timedwait(&pool->cond, &pool->lock, &wake);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+
+/* Pool keeping idle connections to each added upstream, maxIdleSecs 0 never
+   drops one for being idle */
+CYASSL_CONN_POOL* CyaSSL_CONN_POOL_new(CYASSL_CTX* ctx, int idle,
+                                       int maxIdleSecs)
+{
+    CYASSL_CONN_POOL* pool;
+
+    CYASSL_ENTER("CyaSSL_CONN_POOL_new");
+
+    if (ctx == NULL || idle < 0 || maxIdleSecs < 0)
+        return NULL;
+
+    pool = (CYASSL_CONN_POOL*)XMALLOC(sizeof(CYASSL_CONN_POOL), ctx->heap,
+                                      DYNAMIC_TYPE_CONN_POOL);
+    if (pool == NULL)
+        return NULL;
+
+    XMEMSET(pool, 0, sizeof(CYASSL_CONN_POOL));
+    pool->ctx     = ctx;
+    pool->heap    = ctx->heap;
+    pool->target  = idle;
+    pool->maxIdle = maxIdleSecs ? (word32)maxIdleSecs : (word32)-1;
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        XFREE(pool, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->cond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        XFREE(pool, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        return NULL;
+    }
+    if (pthread_create(&pool->tid, NULL, DoConnPoolRefill, pool) != 0) {
+        CYASSL_MSG("Thread creation error");
+        pthread_cond_destroy(&pool->cond);
+        pthread_mutex_destroy(&pool->lock);
+        XFREE(pool, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        return NULL;
+    }
+
+    return pool;
+}
+
+
+/* Stop the refiller and close all idle connections, ones handed out are the
+   caller's to free then, not to put back */
+void CyaSSL_CONN_POOL_free(CYASSL_CONN_POOL* pool)
+{
+    ConnPoolUpstream* up;
+
+    CYASSL_ENTER("CyaSSL_CONN_POOL_free");
+
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_join(pool->tid, NULL);
+
+    while ((up = pool->upstreams) != NULL) {
+        ConnPoolConn* conn;
+
+        while ((conn = up->idle) != NULL) {
+            up->idle = conn->next;
+            PoolClose(conn->ssl);
+            XFREE(conn, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        }
+        pool->upstreams = up->next;
+        XFREE(up, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+    }
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+    XFREE(pool, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+}
+
+
+/* Keep idle connections to host and port from now on, the refiller makes
+   them */
+int CyaSSL_CONN_POOL_add(CYASSL_CONN_POOL* pool, const char* host,
+                         unsigned short port)
+{
+    ConnPoolUpstream* up;
+    char              id[CONN_POOL_HOST_SZ + 6];
+    int               hostSz;
+    int               ret;
+
+    CYASSL_ENTER("CyaSSL_CONN_POOL_add");
+
+    if (pool == NULL || host == NULL)
+        return BAD_FUNC_ARG;
+
+    hostSz = (int)XSTRLEN(host);
+    if (hostSz == 0 || hostSz >= CONN_POOL_HOST_SZ)
+        return BAD_FUNC_ARG;
+
+    up = (ConnPoolUpstream*)XMALLOC(sizeof(ConnPoolUpstream), pool->heap,
+                                    DYNAMIC_TYPE_CONN_POOL);
+    if (up == NULL)
+        return MEMORY_E;
+
+    XMEMSET(up, 0, sizeof(ConnPoolUpstream));
+    XMEMCPY(up->host, host, hostSz);
+    up->port    = port;
+    up->retryAt = LowResTimer();
+
+    /* client cache ids are SERVER_ID_LEN at most, hash host:port down */
+    XMEMCPY(id, host, hostSz);
+    id[hostSz] = ':';
+    ret = ShaHash((const byte*)id,
+                  hostSz + 1 + Word16ToString(id + hostSz + 1, port),
+                  up->serverId);
+    if (ret != 0) {
+        XFREE(up, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        return ret;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (PoolFind(pool, host, port) != NULL) {
+        pthread_mutex_unlock(&pool->lock);
+        XFREE(up, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+        return SSL_SUCCESS;
+    }
+    up->next = pool->upstreams;
+    pool->upstreams = up;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    return SSL_SUCCESS;
+}
+
+
+/* Handshaken connection to host and port, an idle one if any is still good
+   or else a new one made now, NULL if that fails or host wasn't added */
+CYASSL* CyaSSL_CONN_POOL_get(CYASSL_CONN_POOL* pool, const char* host,
+                             unsigned short port)
+{
+    ConnPoolUpstream* up;
+    CYASSL*           ssl = NULL;
+
+    CYASSL_ENTER("CyaSSL_CONN_POOL_get");
+
+    if (pool == NULL || host == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    up = PoolFind(pool, host, port);
+    if (up == NULL) {
+        pthread_mutex_unlock(&pool->lock);
+        CYASSL_MSG("Upstream not in pool");
+        return NULL;
+    }
+
+    PoolPrune(pool, up);
+    if (up->idle != NULL) {
+        ConnPoolConn* conn = up->idle;
+
+        up->idle = conn->next;
+        up->idleCount--;
+        ssl = conn->ssl;
+        XFREE(conn, pool->heap, DYNAMIC_TYPE_CONN_POOL);
+    }
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (ssl == NULL) {
+        CYASSL_MSG("No idle pool connection, connecting now");
+        ssl = PoolConnect(pool, up);
+    }
+
+    return ssl;
+}
+
+
+/* Give back a connection from CyaSSL_CONN_POOL_get(), with reuse it stays
+   idle for the next get if it is still clean and the upstream isn't full,
+   otherwise it's closed and freed */
+int CyaSSL_CONN_POOL_put(CYASSL_CONN_POOL* pool, CYASSL* ssl, int reuse)
+{
+    ConnPoolUpstream* up;
+
+    CYASSL_ENTER("CyaSSL_CONN_POOL_put");
+
+    if (pool == NULL || ssl == NULL || ssl->poolUpstream == NULL)
+        return BAD_FUNC_ARG;
+
+    up = ssl->poolUpstream;
+
+    if (reuse && ((ssl->error != 0 && ssl->error != WANT_READ &&
+                   ssl->error != WANT_WRITE) || ssl->options.isClosed ||
+                  ssl->options.connReset || ssl->options.sentNotify ||
+                  ssl->options.handShakeState != HANDSHAKE_DONE ||
+                  CyaSSL_pending(ssl) > 0))
+        reuse = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    if (reuse && !pool->stop && up->idleCount < pool->target &&
+                                               PoolPush(pool, up, ssl) == 0)
+        ssl = NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (ssl != NULL)
+        PoolClose(ssl);
+
+    return SSL_SUCCESS;
+}
+
+
+/* Idle connections kept for host and port right now, BAD_FUNC_ARG if it
+   wasn't added */
+int CyaSSL_CONN_POOL_idle(CYASSL_CONN_POOL* pool, const char* host,
+                          unsigned short port)
+{
+    ConnPoolUpstream* up;
+    int               ret = BAD_FUNC_ARG;
+
+    if (pool == NULL || host == NULL)
+        return BAD_FUNC_ARG;
+
+    pthread_mutex_lock(&pool->lock);
+    up = PoolFind(pool, host, port);
+    if (up != NULL)
+        ret = up->idleCount;
+    pthread_mutex_unlock(&pool->lock);
+
+    return ret;
+}
+
+#endif /* HAVE_CONN_POOL */
+
+
+#endif /* HAVE_OCSP || HAVE_CRL_FETCH || HAVE_CONN_POOL */
+
 #endif /* CYASSL_USER_IO */
 
 CYASSL_API void CyaSSL_SetIORecv(CYASSL_CTX *ctx, CallbackIORecv CBIORecv)
@@ -1004,6 +2857,17 @@ CYASSL_API void CyaSSL_SetIOWriteFlags(CYASSL* ssl, int flags)
 }
 
 
+/* 1 while the send callback is handed a handshake message that more of the
+   same flight follows, custom callbacks can cork or pass MSG_MORE on it */
+CYASSL_API int CyaSSL_GetIOSendMore(CYASSL* ssl)
+{
+    if (ssl)
+        return ssl->options.moreToSend;
+
+    return 0;
+}
+
+
 #ifdef CYASSL_DTLS
 
 CYASSL_API void CyaSSL_CTX_SetGenCookie(CYASSL_CTX* ctx, CallbackGenCookie cb)
@@ -1828,6 +1828,13 @@ int SetCipherSpecs(CYASSL* ssl)
     }  /* switch */
     }  /* if ECC / Normal suites else */
 
+#ifdef CYASSL_RECORD_BULK
+    if (ssl->specs.bulk_cipher_algorithm != CYASSL_RECORD_BULK) {
+        CYASSL_MSG("Suite's bulk cipher not in this record layer build");
+        return UNSUPPORTED_SUITE;
+    }
+#endif
+
     /* set TLS if it hasn't been turned off */
     if (ssl->version.major == 3 && ssl->version.minor >= 1) {
 #ifndef NO_TLS
@@ -2145,11 +2152,11 @@ static int SetKeys(Ciphers* enc, Ciphers* dec, Keys* keys, CipherSpecs* specs,
         int aesRet = 0;
 
         if (enc && enc->aes == NULL)
-            enc->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            enc->aes = GetCipherAes(heap);
         if (enc && enc->aes == NULL)
             return MEMORY_E;
         if (dec && dec->aes == NULL)
-            dec->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            dec->aes = GetCipherAes(heap);
         if (dec && dec->aes == NULL)
             return MEMORY_E;
 #ifdef HAVE_CAVIUM
@@ -2208,11 +2215,11 @@ static int SetKeys(Ciphers* enc, Ciphers* dec, Keys* keys, CipherSpecs* specs,
         int gcmRet;
 
         if (enc && enc->aes == NULL)
-            enc->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            enc->aes = GetCipherAes(heap);
         if (enc && enc->aes == NULL)
             return MEMORY_E;
         if (dec && dec->aes == NULL)
-            dec->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            dec->aes = GetCipherAes(heap);
         if (dec && dec->aes == NULL)
             return MEMORY_E;
 
@@ -2258,11 +2265,11 @@ static int SetKeys(Ciphers* enc, Ciphers* dec, Keys* keys, CipherSpecs* specs,
 #ifdef HAVE_AESCCM
     if (specs->bulk_cipher_algorithm == cyassl_aes_ccm) {
         if (enc && enc->aes == NULL)
-            enc->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            enc->aes = GetCipherAes(heap);
         if (enc && enc->aes == NULL)
             return MEMORY_E;
         if (dec && dec->aes == NULL)
-            dec->aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_CIPHER);
+            dec->aes = GetCipherAes(heap);
         if (dec && dec->aes == NULL)
             return MEMORY_E;
 
@@ -2442,6 +2449,8 @@ int SetKeysSide(CYASSL* ssl, enum encrypt_side side)
 
     ret = SetKeys(encrypt, decrypt, keys, &ssl->specs, ssl->options.side,
                   ssl->heap, devId);
+    if (ret == 0)
+        SetCipherFuncs(encrypt, decrypt, ssl->specs.bulk_cipher_algorithm);
 
 #ifdef HAVE_SECURE_RENEGOTIATION
     if (copy) {
@@ -2452,6 +2461,9 @@ int SetKeysSide(CYASSL* ssl, enum encrypt_side side)
         else if (ssl->options.side == CYASSL_SERVER_END && decrypt)
             clientCopy = 1;
 
+    #ifndef NO_TLS
+        ssl->keys.macStateSet[clientCopy ? 0 : 1] = 0;
+    #endif
         if (clientCopy) {
             XMEMCPY(ssl->keys.client_write_MAC_secret,
                     keys->client_write_MAC_secret, MAX_DIGEST_SIZE);
@@ -2503,6 +2515,11 @@ int StoreKeys(CYASSL* ssl, const byte* keyData)
 
     if (ssl->specs.cipher_type != aead) {
         sz = ssl->specs.hash_size;
+    #ifndef NO_TLS
+        /* rekey the cached MAC states on next use */
+        ssl->keys.macStateSet[0] = 0;
+        ssl->keys.macStateSet[1] = 0;
+    #endif
         XMEMCPY(keys->client_write_MAC_secret,&keyData[i], sz);
         i += sz;
         XMEMCPY(keys->server_write_MAC_secret,&keyData[i], sz);
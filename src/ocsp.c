@@ -31,6 +31,11 @@
 #include <cyassl/ocsp.h>
 #include <cyassl/internal.h>
 
+#ifdef HAVE_OCSP_REFRESH
+    #include <errno.h>
+    #include <time.h>
+#endif
+
 
 int InitOCSP(CYASSL_OCSP* ocsp, CYASSL_CERT_MANAGER* cm)
 {
@@ -40,47 +45,82 @@ int InitOCSP(CYASSL_OCSP* ocsp, CYASSL_CERT_MANAGER* cm)
     if (InitMutex(&ocsp->ocspLock) != 0)
         return BAD_MUTEX_E;
 
+#ifdef HAVE_OCSP_REFRESH
+    if (pthread_mutex_init(&ocsp->refreshLock, NULL) != 0) {
+        FreeMutex(&ocsp->ocspLock);
+        return BAD_MUTEX_E;
+    }
+    if (pthread_cond_init(&ocsp->refreshCond, NULL) != 0) {
+        pthread_mutex_destroy(&ocsp->refreshLock);
+        FreeMutex(&ocsp->ocspLock);
+        return BAD_MUTEX_E;
+    }
+#endif
+
     return 0;
 }
 
 
-static int InitOCSP_Entry(OCSP_Entry* ocspe, DecodedCert* cert)
+static void FreeOCSP_Entry(OCSP_Entry* ocspe)
 {
-    CYASSL_ENTER("InitOCSP_Entry");
-
-    XMEMSET(ocspe, 0, sizeof(*ocspe));
-    XMEMCPY(ocspe->issuerHash, cert->issuerHash, SHA_DIGEST_SIZE);
-    XMEMCPY(ocspe->issuerKeyHash, cert->issuerKeyHash, SHA_DIGEST_SIZE);
+    CYASSL_ENTER("FreeOCSP_Entry");
 
-    return 0;
+    if (ocspe->status)
+        XFREE(ocspe->status, NULL, DYNAMIC_TYPE_OCSP_STATUS);
+    if (ocspe->url)
+        XFREE(ocspe->url, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+    if (ocspe->raw)
+        XFREE(ocspe->raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
 }
 
 
-static void FreeOCSP_Entry(OCSP_Entry* ocspe)
+#ifdef HAVE_OCSP_REFRESH
+
+/* Tell the refresher to exit and wait for it */
+static void StopOCSP_Refresh(CYASSL_OCSP* ocsp)
 {
-    CertStatus* tmp = ocspe->status;
+    if (ocsp->tid == 0)
+        return;
 
-    CYASSL_ENTER("FreeOCSP_Entry");
+    CYASSL_MSG("stopping OCSP refresh thread");
 
-    while (tmp) {
-        CertStatus* next = tmp->next;
-        XFREE(tmp, NULL, DYNAMIC_TYPE_OCSP_STATUS);
-        tmp = next;
-    }
+    pthread_mutex_lock(&ocsp->refreshLock);
+    ocsp->refreshStop = 1;
+    pthread_cond_signal(&ocsp->refreshCond);
+    pthread_mutex_unlock(&ocsp->refreshLock);
+
+    pthread_join(ocsp->tid, NULL);
+    ocsp->tid = 0;
 }
 
+#endif /* HAVE_OCSP_REFRESH */
+
 
 void FreeOCSP(CYASSL_OCSP* ocsp, int dynamic)
 {
-    OCSP_Entry* tmp = ocsp->ocspList;
+    int row;
 
     CYASSL_ENTER("FreeOCSP");
 
-    while (tmp) {
-        OCSP_Entry* next = tmp->next;
-        FreeOCSP_Entry(tmp);
-        XFREE(tmp, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
-        tmp = next;
+#ifdef HAVE_OCSP_REFRESH
+    /* refresher uses the table, stop it first */
+    StopOCSP_Refresh(ocsp);
+    pthread_cond_destroy(&ocsp->refreshCond);
+    pthread_mutex_destroy(&ocsp->refreshLock);
+#endif
+#ifdef HAVE_OCSP_NONBLOCK
+    FreeOcspConns(ocsp);
+#endif
+
+    for (row = 0; row < OCSP_TABLE_SIZE; row++) {
+        OCSP_Entry* tmp = ocsp->ocspTable[row];
+
+        while (tmp) {
+            OCSP_Entry* next = tmp->next;
+            FreeOCSP_Entry(tmp);
+            XFREE(tmp, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+            tmp = next;
+        }
     }
 
     FreeMutex(&ocsp->ocspLock);
@@ -102,171 +142,336 @@ static int xstat2err(int stat)
 }
 
 
-int CheckCertOCSP(CYASSL_OCSP* ocsp, DecodedCert* cert)
+/* Is result a responder's answer rather than a lookup failure */
+static INLINE int IsOCSP_Status(int result)
 {
-    byte* ocspReqBuf = NULL;
-    int ocspReqSz = 2048;
-    byte* ocspRespBuf = NULL;
-    int result = -1;
-    OCSP_Entry* ocspe;
-    CertStatus* certStatus = NULL;
-    const char *url;
-    int urlSz;
-#ifdef CYASSL_SMALL_STACK
-    CertStatus* newStatus;
-    OcspRequest* ocspRequest;
-    OcspResponse* ocspResponse;
-#else
-    CertStatus newStatus[1];
-    OcspRequest ocspRequest[1];
-    OcspResponse ocspResponse[1];
-#endif
+    return result == 0 || result == OCSP_CERT_REVOKED ||
+           result == OCSP_CERT_UNKNOWN;
+}
 
-    CYASSL_ENTER("CheckCertOCSP");
 
-    if (LockMutex(&ocsp->ocspLock) != 0) {
-        CYASSL_LEAVE("CheckCertOCSP", BAD_MUTEX_E);
-        return BAD_MUTEX_E;
-    }
+/* Fill in id from a cert parsed with its issuer */
+void SetOcspId(OcspId* id, DecodedCert* cert)
+{
+    XMEMCPY(id->issuerHash, cert->issuerHash, SHA_DIGEST_SIZE);
+    XMEMCPY(id->issuerKeyHash, cert->issuerKeyHash, SHA_DIGEST_SIZE);
+    XMEMCPY(id->serial, cert->serial, cert->serialSz);
+    id->serialSz = cert->serialSz;
+}
+
+
+/* Table row for issuer and serial */
+static word32 OCSP_Row(const OcspId* id)
+{
+    word32 hash = ((word32)id->issuerHash[0] << 24) |
+                  (id->issuerHash[1] << 16) | (id->issuerHash[2] << 8) |
+                  id->issuerHash[3];
+    int    i;
+
+    for (i = 0; i < id->serialSz; i++)
+        hash = hash * 31 + id->serial[i];
+
+    return hash % OCSP_TABLE_SIZE;
+}
+
+
+/* Find cached entry for id, caller holds ocspLock */
+static OCSP_Entry* FindOCSP_Entry(CYASSL_OCSP* ocsp, const OcspId* id)
+{
+    OCSP_Entry* ocspe = ocsp->ocspTable[OCSP_Row(id)];
 
-    ocspe = ocsp->ocspList;
     while (ocspe) {
-        if (XMEMCMP(ocspe->issuerHash, cert->issuerHash, SHA_DIGEST_SIZE) == 0
-            && XMEMCMP(ocspe->issuerKeyHash, cert->issuerKeyHash,
-                                                        SHA_DIGEST_SIZE) == 0)
+        if (ocspe->id.serialSz == id->serialSz &&
+            XMEMCMP(ocspe->id.serial, id->serial, id->serialSz) == 0 &&
+            XMEMCMP(ocspe->id.issuerHash, id->issuerHash,
+                                                     SHA_DIGEST_SIZE) == 0 &&
+            XMEMCMP(ocspe->id.issuerKeyHash, id->issuerKeyHash,
+                                                     SHA_DIGEST_SIZE) == 0)
             break;
-        else
-            ocspe = ocspe->next;
+        ocspe = ocspe->next;
     }
 
+    return ocspe;
+}
+
+
+/* Cached status of id in result, returns 1 on an unexpired entry. Past
+   refresh but before nextUpdate is still good, the refresher is fetching
+   a new one in the background */
+static int CachedOCSP_Status(CYASSL_OCSP* ocsp, const OcspId* id, int* result)
+{
+    OCSP_Entry* ocspe;
+    int         found = 0;
+
+    if (LockMutex(&ocsp->ocspLock) != 0) {
+        *result = BAD_MUTEX_E;
+        return 1;
+    }
+
+    ocspe = FindOCSP_Entry(ocsp, id);
+    if (ocspe != NULL && (int)(ocspe->expires - LowResTimer()) > 0) {
+        *result = xstat2err(ocspe->status->status);
+        found = 1;
+    }
+
+    UnLockMutex(&ocsp->ocspLock);
+
+    if (ocspe != NULL && !found) {
+        CYASSL_MSG("\tcached status expired, looking up cert");
+    }
+
+    return found;
+}
+
+
+/* Seconds newStatus is good for, 0 without a usable nextUpdate */
+static word32 OCSP_StatusLeft(CertStatus* newStatus)
+{
+    if (newStatus->nextDate[0] == 0 ||
+            !ValidateDate(newStatus->thisDate, newStatus->thisDateFormat,
+                          BEFORE))
+        return 0;
+
+    return DateTimeLeft(newStatus->nextDate, newStatus->nextDateFormat);
+}
+
+
+/* Cache newStatus of id until its nextUpdate, url NULL means use the
+   override. raw is the DER response to staple, the cache owns it either
+   way. respHash is that of the response newStatus came from, NULL if not
+   known. Responses without a usable nextUpdate aren't cached, same as
+   before */
+static int CacheOCSP_Status(CYASSL_OCSP* ocsp, const OcspId* id,
+                            CertStatus* newStatus, byte* raw, word32 rawSz,
+                            const byte* respHash, const char* url, int urlSz)
+{
+    OCSP_Entry* ocspe;
+    word32      left;
+    word32      now;
+
+    CYASSL_ENTER("CacheOCSP_Status");
+
+    left = OCSP_StatusLeft(newStatus);
+    if (left == 0) {
+        CYASSL_MSG("\tinvalid status date, not caching");
+        if (raw)
+            XFREE(raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        return 0;
+    }
+
+    if (LockMutex(&ocsp->ocspLock) != 0) {
+        if (raw)
+            XFREE(raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        return BAD_MUTEX_E;
+    }
+
+    ocspe = FindOCSP_Entry(ocsp, id);
     if (ocspe == NULL) {
-        ocspe = (OCSP_Entry*)XMALLOC(sizeof(OCSP_Entry),
-                                                NULL, DYNAMIC_TYPE_OCSP_ENTRY);
-        if (ocspe != NULL) {
-            InitOCSP_Entry(ocspe, cert);
-            ocspe->next = ocsp->ocspList;
-            ocsp->ocspList = ocspe;
-        }
-        else {
+        word32 row = OCSP_Row(id);
+
+        ocspe = (OCSP_Entry*)XMALLOC(sizeof(OCSP_Entry), NULL,
+                                     DYNAMIC_TYPE_OCSP_ENTRY);
+        if (ocspe == NULL) {
             UnLockMutex(&ocsp->ocspLock);
-            CYASSL_LEAVE("CheckCertOCSP", MEMORY_ERROR);
-            return MEMORY_ERROR;
+            if (raw)
+                XFREE(raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+            return MEMORY_E;
         }
-    }
-    else {
-        certStatus = ocspe->status;
-        while (certStatus) {
-            if (certStatus->serialSz == cert->serialSz &&
-                 XMEMCMP(certStatus->serial, cert->serial, cert->serialSz) == 0)
-                break;
-            else
-                certStatus = certStatus->next;
-        }
-    }
+        XMEMSET(ocspe, 0, sizeof(OCSP_Entry));
 
-    if (certStatus != NULL) {
-        if (!ValidateDate(certStatus->thisDate,
-                                        certStatus->thisDateFormat, BEFORE) ||
-            (certStatus->nextDate[0] == 0) ||
-            !ValidateDate(certStatus->nextDate,
-                                        certStatus->nextDateFormat, AFTER)) {
-            CYASSL_MSG("\tinvalid status date, looking up cert");
+        ocspe->status = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                             DYNAMIC_TYPE_OCSP_STATUS);
+        if (url) {
+            ocspe->url = (char*)XMALLOC(urlSz + 1, NULL,
+                                        DYNAMIC_TYPE_OCSP_ENTRY);
+            if (ocspe->url) {
+                XMEMCPY(ocspe->url, url, urlSz);
+                ocspe->url[urlSz] = '\0';
+                ocspe->urlSz = urlSz;
+            }
         }
-        else {
-            result = xstat2err(certStatus->status);
+        if (ocspe->status == NULL || (url && ocspe->url == NULL)) {
+            FreeOCSP_Entry(ocspe);
+            XFREE(ocspe, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
             UnLockMutex(&ocsp->ocspLock);
-            CYASSL_LEAVE("CheckCertOCSP", result);
-            return result;
+            if (raw)
+                XFREE(raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+            return MEMORY_E;
         }
+
+        XMEMCPY(&ocspe->id, id, sizeof(OcspId));
+        ocspe->next = ocsp->ocspTable[row];
+        ocsp->ocspTable[row] = ocspe;
     }
 
-    UnLockMutex(&ocsp->ocspLock);
+    XMEMCPY(ocspe->status, newStatus, sizeof(CertStatus));
+    ocspe->status->next = NULL;
 
-    if (ocsp->cm->ocspUseOverrideURL) {
-        url = ocsp->cm->ocspOverrideURL;
-        if (url != NULL && url[0] != '\0')
-            urlSz = (int)XSTRLEN(url);
-        else
-            return OCSP_NEED_URL;
+    if (respHash)
+        XMEMCPY(ocspe->respHash, respHash, SHA_DIGEST_SIZE);
+    else
+        XMEMSET(ocspe->respHash, 0, SHA_DIGEST_SIZE);
+
+    if (raw) {
+        if (ocspe->raw)
+            XFREE(ocspe->raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        ocspe->raw     = raw;
+        ocspe->rawSz   = rawSz;
+        ocspe->keepRaw = 1;
     }
-    else if (cert->extAuthInfoSz != 0 && cert->extAuthInfo != NULL) {
-        url = (const char *)cert->extAuthInfo;
-        urlSz = cert->extAuthInfoSz;
+    else if (ocspe->raw) {
+        /* status moved on without a response to staple, until refetched */
+        XFREE(ocspe->raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        ocspe->raw   = NULL;
+        ocspe->rawSz = 0;
     }
-    else {
-        /* cert doesn't have extAuthInfo, assuming CERT_GOOD */
-        return 0;
+
+    /* refetch with a quarter of the lifetime left */
+    now = LowResTimer();
+    ocspe->expires = now + left;
+    ocspe->refresh = now + left - left / 4;
+
+    UnLockMutex(&ocsp->ocspLock);
+
+    return 0;
+}
+
+
+/* Status the responder gives in its answer resp to req, newStatus filled in.
+   OCSP_LOOKUP_FAIL if it isn't a good answer to req */
+static int DecodeOcspAnswer(OcspRequest* req, OcspResponse* resp,
+                            CertStatus* newStatus, byte* buf, int sz)
+{
+    XMEMSET(newStatus, 0, sizeof(CertStatus));
+
+    InitOcspResponse(resp, newStatus, buf, sz);
+
+    if (OcspResponseDecode(resp) != 0 ||
+            resp->responseStatus != OCSP_SUCCESSFUL)
+        return OCSP_LOOKUP_FAIL;
+
+    if (CompareOcspReqResp(req, resp) != 0)
+        return OCSP_LOOKUP_FAIL;
+
+    return xstat2err(resp->status->status);
+}
+
+
+/* Status from the responder's answer buf to req, like DecodeOcspAnswer().
+   An answer to a nonce-free request is hashed into respHash first, if it's
+   byte for byte the one cached for id its signature was checked already and
+   the cached status is taken. A cache in front of the responder hands out
+   the same one until it expires. respHash is zeroed with a nonce */
+static int OcspAnswerStatus(CYASSL_OCSP* ocsp, const OcspId* id,
+                            OcspRequest* req, OcspResponse* resp,
+                            CertStatus* newStatus, byte* buf, int sz,
+                            byte* respHash)
+{
+    int known = 0;
+
+    XMEMSET(respHash, 0, SHA_DIGEST_SIZE);
+
+    /* with a nonce the same bytes again would be a replay */
+    if (req->nonceSz == 0 && ShaHash(buf, sz, respHash) == 0 &&
+                                           LockMutex(&ocsp->ocspLock) == 0) {
+        OCSP_Entry* ocspe = FindOCSP_Entry(ocsp, id);
+
+        if (ocspe != NULL &&
+                XMEMCMP(ocspe->respHash, respHash, SHA_DIGEST_SIZE) == 0) {
+            XMEMCPY(newStatus, ocspe->status, sizeof(CertStatus));
+            known = 1;
+        }
+        UnLockMutex(&ocsp->ocspLock);
+    }
+
+    if (known && OCSP_StatusLeft(newStatus) != 0) {
+        CYASSL_MSG("\tsame OCSP response as cached, already verified");
+        return xstat2err(newStatus->status);
     }
 
+    return DecodeOcspAnswer(req, resp, newStatus, buf, sz);
+}
+
+
+/* Ask the responder at url about id, on a responder answer returns its
+   status (0, OCSP_CERT_REVOKED or OCSP_CERT_UNKNOWN) with newStatus filled
+   in, otherwise an error. With raw set a copy of the DER response is
+   returned there too, for stapling. respHash is set for CacheOCSP_Status() */
+static int RequestOCSP(CYASSL_OCSP* ocsp, const OcspId* id, const char* url,
+                       int urlSz, CertStatus* newStatus, byte** raw,
+                       word32* rawSz, byte* respHash)
+{
+    byte* ocspReqBuf = NULL;
+    int ocspReqSz = 2048;
+    byte* ocspRespBuf = NULL;
+    int result = -1;
+#ifdef CYASSL_SMALL_STACK
+    OcspRequest* ocspRequest;
+    OcspResponse* ocspResponse;
+#else
+    OcspRequest ocspRequest[1];
+    OcspResponse ocspResponse[1];
+#endif
+
+    CYASSL_ENTER("RequestOCSP");
+
+    if (raw)
+        *raw = NULL;
+
     ocspReqBuf = (byte*)XMALLOC(ocspReqSz, NULL, DYNAMIC_TYPE_IN_BUFFER);
-    if (ocspReqBuf == NULL) {
-        CYASSL_LEAVE("CheckCertOCSP", MEMORY_ERROR);
+    if (ocspReqBuf == NULL)
         return MEMORY_ERROR;
-    }
 
 #ifdef CYASSL_SMALL_STACK
-    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
-                                                       DYNAMIC_TYPE_TMP_BUFFER);
     ocspRequest = (OcspRequest*)XMALLOC(sizeof(OcspRequest), NULL,
                                                        DYNAMIC_TYPE_TMP_BUFFER);
     ocspResponse = (OcspResponse*)XMALLOC(sizeof(OcspResponse), NULL,
                                                        DYNAMIC_TYPE_TMP_BUFFER);
 
-    if (newStatus == NULL || ocspRequest == NULL || ocspResponse == NULL) {
-        if (newStatus)    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (ocspRequest == NULL || ocspResponse == NULL) {
         if (ocspRequest)  XFREE(ocspRequest,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
         if (ocspResponse) XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 
-        XFREE(ocspReqBuf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(ocspReqBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
 
-        CYASSL_LEAVE("CheckCertOCSP", MEMORY_ERROR);
         return MEMORY_E;
     }
 #endif
 
-    InitOcspRequest(ocspRequest, cert, ocsp->cm->ocspSendNonce,
+    /* no cert, the refresher only has the cached ids */
+    InitOcspRequest(ocspRequest, NULL, ocsp->cm->ocspSendNonce,
                                                          ocspReqBuf, ocspReqSz);
+    ocspRequest->issuerHash    = (byte*)id->issuerHash;
+    ocspRequest->issuerKeyHash = (byte*)id->issuerKeyHash;
+    ocspRequest->serial        = (byte*)id->serial;
+    ocspRequest->serialSz      = id->serialSz;
     ocspReqSz = EncodeOcspRequest(ocspRequest);
-    
+
+    XMEMSET(respHash, 0, SHA_DIGEST_SIZE);
+
+#ifndef CYASSL_USER_IO
+    /* nonce-free requests go by GET, a cache in front can answer those */
+    if (ocsp->cm->ocspIOCb == EmbedOcspLookup && ocspRequest->nonceSz == 0)
+        result = EmbedOcspGet(url, urlSz, ocspReqBuf, ocspReqSz,
+                                                                &ocspRespBuf);
+    else
+#endif
     if (ocsp->cm->ocspIOCb)
         result = ocsp->cm->ocspIOCb(ocsp->cm->ocspIOCtx, url, urlSz,
                                            ocspReqBuf, ocspReqSz, &ocspRespBuf);
 
     if (result >= 0 && ocspRespBuf) {
-        XMEMSET(newStatus, 0, sizeof(CertStatus));
-
-        InitOcspResponse(ocspResponse, newStatus, ocspRespBuf, result);
-        OcspResponseDecode(ocspResponse);
-    
-        if (ocspResponse->responseStatus != OCSP_SUCCESSFUL)
-            result = OCSP_LOOKUP_FAIL;
-        else {
-            if (CompareOcspReqResp(ocspRequest, ocspResponse) == 0) {
-                result = xstat2err(ocspResponse->status->status);
-
-                if (LockMutex(&ocsp->ocspLock) != 0)
-                    result = BAD_MUTEX_E;
-                else {
-                    if (certStatus != NULL)
-                        /* Replace existing certificate entry with updated */
-                        XMEMCPY(certStatus, newStatus, sizeof(CertStatus));
-                    else {
-                        /* Save new certificate entry */
-                        certStatus = (CertStatus*)XMALLOC(sizeof(CertStatus),
-                                          NULL, DYNAMIC_TYPE_OCSP_STATUS);
-                        if (certStatus != NULL) {
-                            XMEMCPY(certStatus, newStatus, sizeof(CertStatus));
-                            certStatus->next = ocspe->status;
-                            ocspe->status = certStatus;
-                            ocspe->totalStatus++;
-                        }
-                    }
-
-                    UnLockMutex(&ocsp->ocspLock);
-                }
+        int respSz = result;
+
+        result = OcspAnswerStatus(ocsp, id, ocspRequest, ocspResponse,
+                                  newStatus, ocspRespBuf, respSz, respHash);
+
+        if (raw && IsOCSP_Status(result)) {
+            *raw = (byte*)XMALLOC(respSz, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+            if (*raw) {
+                XMEMCPY(*raw, ocspRespBuf, respSz);
+                *rawSz = (word32)respSz;
             }
-            else
-                result = OCSP_LOOKUP_FAIL;
         }
     }
     else
@@ -275,7 +480,6 @@ int CheckCertOCSP(CYASSL_OCSP* ocsp, DecodedCert* cert)
     XFREE(ocspReqBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
 
 #ifdef CYASSL_SMALL_STACK
-    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
     XFREE(ocspRequest,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
     XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
@@ -283,11 +487,621 @@ int CheckCertOCSP(CYASSL_OCSP* ocsp, DecodedCert* cert)
     if (ocspRespBuf != NULL && ocsp->cm->ocspRespFreeCb)
         ocsp->cm->ocspRespFreeCb(ocsp->cm->ocspIOCtx, ocspRespBuf);
 
-    CYASSL_LEAVE("CheckCertOCSP", result);
     return result;
 }
 
 
+/* Responder for id, the override if in use or url. Returns 0 with url set,
+   1 when there is no responder to ask */
+static int OCSP_Responder(CYASSL_OCSP* ocsp, const char** url, int* urlSz)
+{
+    if (ocsp->cm->ocspUseOverrideURL) {
+        const char* override = ocsp->cm->ocspOverrideURL;
+
+        if (override == NULL || override[0] == '\0')
+            return OCSP_NEED_URL;
+
+        *url   = override;
+        *urlSz = (int)XSTRLEN(override);
+        return 0;
+    }
+
+    return (*url != NULL && *urlSz != 0) ? 0 : 1;
+}
+
+
+/* Status of id, from the cache or else the responder at url */
+int CheckIdOCSP(CYASSL_OCSP* ocsp, const OcspId* id, const char* url,
+                int urlSz)
+{
+    int  result = -1;
+    byte respHash[SHA_DIGEST_SIZE];
+#ifdef CYASSL_SMALL_STACK
+    CertStatus* newStatus;
+#else
+    CertStatus newStatus[1];
+#endif
+
+    CYASSL_ENTER("CheckIdOCSP");
+    CYASSL_STAT_INC(ocspLookups);
+
+    if (CachedOCSP_Status(ocsp, id, &result)) {
+        CYASSL_LEAVE("CheckIdOCSP", result);
+        return result;
+    }
+
+    result = OCSP_Responder(ocsp, &url, &urlSz);
+    if (result == 1) {
+        /* cert doesn't have extAuthInfo, assuming CERT_GOOD */
+        return 0;
+    }
+    if (result != 0)
+        return result;
+
+#ifdef CYASSL_SMALL_STACK
+    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (newStatus == NULL) {
+        CYASSL_LEAVE("CheckIdOCSP", MEMORY_E);
+        return MEMORY_E;
+    }
+#endif
+
+    result = RequestOCSP(ocsp, id, url, urlSz, newStatus, NULL, NULL,
+                         respHash);
+
+    if (IsOCSP_Status(result)) {
+        /* the override can change, refresh with whatever is set then */
+        if (CacheOCSP_Status(ocsp, id, newStatus, NULL, 0, respHash,
+                    ocsp->cm->ocspUseOverrideURL ? NULL : url, urlSz) != 0) {
+            CYASSL_MSG("\tunable to cache OCSP status");
+        }
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(newStatus, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    CYASSL_LEAVE("CheckIdOCSP", result);
+    return result;
+}
+
+
+int CheckCertOCSP(CYASSL_OCSP* ocsp, DecodedCert* cert)
+{
+    OcspId id;
+    int    ret;
+
+    CYASSL_ENTER("CheckCertOCSP");
+
+    /* the responder url is in AIA, left behind by a lazy parse */
+    if ((ret = DecodePendingExtensions(cert)) != 0)
+        return ret;
+
+    SetOcspId(&id, cert);
+
+    return CheckIdOCSP(ocsp, &id, (const char*)cert->extAuthInfo,
+                       cert->extAuthInfo ? cert->extAuthInfoSz : 0);
+}
+
+
+#ifdef HAVE_OCSP_NONBLOCK
+
+/* Done with lookup, its connection is kept for the next one if it can be */
+void FreeOcspLookup(CYASSL_OCSP* ocsp, OcspLookup* lookup)
+{
+    if (lookup == NULL)
+        return;
+
+    EmbedOcspDone(ocsp, lookup);
+    XFREE(lookup, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+}
+
+
+/* Send the request for id to the responder at url, *lookup set */
+static int StartOcspLookup(CYASSL_OCSP* ocsp, const OcspId* id,
+                           const char* url, int urlSz, OcspLookup** lookup)
+{
+    OcspLookup* look;
+    byte*       reqBuf;
+    int         reqSz = 2048;
+    int         ret;
+
+    reqBuf = (byte*)XMALLOC(reqSz, NULL, DYNAMIC_TYPE_IN_BUFFER);
+    if (reqBuf == NULL)
+        return MEMORY_E;
+
+    look = (OcspLookup*)XMALLOC(sizeof(OcspLookup), NULL,
+                                                       DYNAMIC_TYPE_OCSP_ENTRY);
+    if (look == NULL) {
+        XFREE(reqBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
+        return MEMORY_E;
+    }
+    XMEMSET(look, 0, sizeof(OcspLookup));
+    look->fd = -1;
+    XMEMCPY(&look->id, id, sizeof(OcspId));
+
+    InitOcspRequest(&look->request, NULL, ocsp->cm->ocspSendNonce,
+                                                                reqBuf, reqSz);
+    look->request.issuerHash    = look->id.issuerHash;
+    look->request.issuerKeyHash = look->id.issuerKeyHash;
+    look->request.serial        = look->id.serial;
+    look->request.serialSz      = look->id.serialSz;
+    reqSz = EncodeOcspRequest(&look->request);
+
+    /* sent from the http buffer, only the nonce is needed from here on */
+    ret = reqSz > 0 ? EmbedOcspStart(ocsp, look, url, urlSz, reqBuf, reqSz)
+                    : OCSP_LOOKUP_FAIL;
+    look->request.dest   = NULL;
+    look->request.destSz = 0;
+    XFREE(reqBuf, NULL, DYNAMIC_TYPE_IN_BUFFER);
+
+    if (ret != 0) {
+        FreeOcspLookup(ocsp, look);
+        return OCSP_LOOKUP_FAIL;
+    }
+
+    *lookup = look;
+
+    return 0;
+}
+
+
+/* Status of id like CheckIdOCSP(), but the responder is asked without
+   blocking. Returns OCSP_WANT_READ or OCSP_WANT_WRITE until its answer is
+   in, call again with the same *lookup and url then. *lookup is freed and
+   set back to NULL once the status is known */
+int CheckIdOCSP_NonBlock(CYASSL_OCSP* ocsp, const OcspId* id, const char* url,
+                         int urlSz, OcspLookup** lookup)
+{
+    byte* resp = NULL;
+    int   result;
+    byte  respHash[SHA_DIGEST_SIZE];
+#ifdef CYASSL_SMALL_STACK
+    CertStatus*   newStatus;
+    OcspResponse* ocspResponse;
+#else
+    CertStatus    newStatus[1];
+    OcspResponse  ocspResponse[1];
+#endif
+
+    CYASSL_ENTER("CheckIdOCSP_NonBlock");
+
+    if (*lookup == NULL) {
+        /* a user I/O callback can only be called the blocking way */
+        if (ocsp->cm->ocspIOCb != EmbedOcspLookup)
+            return CheckIdOCSP(ocsp, id, url, urlSz);
+
+        CYASSL_STAT_INC(ocspLookups);
+
+        if (CachedOCSP_Status(ocsp, id, &result))
+            return result;
+
+        result = OCSP_Responder(ocsp, &url, &urlSz);
+        if (result == 1)
+            return 0;       /* no extAuthInfo, assuming CERT_GOOD */
+        if (result != 0)
+            return result;
+
+        if ((result = StartOcspLookup(ocsp, id, url, urlSz, lookup)) != 0)
+            return result;
+    }
+    else if (OCSP_Responder(ocsp, &url, &urlSz) != 0) {
+        url   = NULL;       /* override gone meanwhile */
+        urlSz = 0;
+    }
+
+    result = EmbedOcspStep(ocsp, *lookup, &resp);
+    if (result == OCSP_WANT_READ || result == OCSP_WANT_WRITE)
+        return result;
+
+#ifdef CYASSL_SMALL_STACK
+    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    ocspResponse = (OcspResponse*)XMALLOC(sizeof(OcspResponse), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+
+    if (newStatus == NULL || ocspResponse == NULL) {
+        if (newStatus)    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (ocspResponse) XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+        FreeOcspLookup(ocsp, *lookup);
+        *lookup = NULL;
+        return MEMORY_E;
+    }
+#endif
+
+    if (result > 0)
+        result = OcspAnswerStatus(ocsp, id, &(*lookup)->request, ocspResponse,
+                                  newStatus, resp, result, respHash);
+    else
+        result = OCSP_LOOKUP_FAIL;
+
+    if (IsOCSP_Status(result)) {
+        /* the override can change, refresh with whatever is set then */
+        if (CacheOCSP_Status(ocsp, id, newStatus, NULL, 0, respHash,
+                    ocsp->cm->ocspUseOverrideURL ? NULL : url, urlSz) != 0) {
+            CYASSL_MSG("\tunable to cache OCSP status");
+        }
+    }
+
+    FreeOcspLookup(ocsp, *lookup);
+    *lookup = NULL;
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    CYASSL_LEAVE("CheckIdOCSP_NonBlock", result);
+    return result;
+}
+
+#endif /* HAVE_OCSP_NONBLOCK */
+
+
+/* Status of id from a response the server stapled. The responder has to
+   chain to one of our CAs and the response has to be current, anything
+   else is OCSP_LOOKUP_FAIL so the caller can ask the responder itself.
+   url is the responder the refresher uses for the cached status */
+int CheckStapleOCSP(CYASSL_OCSP* ocsp, const OcspId* id, byte* resp,
+                    word32 respSz, const char* url, int urlSz)
+{
+    int result = -1;
+#ifdef CYASSL_SMALL_STACK
+    CertStatus*   newStatus;
+    OcspRequest*  ocspRequest;
+    OcspResponse* ocspResponse;
+#else
+    CertStatus    newStatus[1];
+    OcspRequest   ocspRequest[1];
+    OcspResponse  ocspResponse[1];
+#endif
+
+    CYASSL_ENTER("CheckStapleOCSP");
+
+    if (CachedOCSP_Status(ocsp, id, &result)) {
+        CYASSL_LEAVE("CheckStapleOCSP", result);
+        return result;
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    ocspRequest = (OcspRequest*)XMALLOC(sizeof(OcspRequest), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    ocspResponse = (OcspResponse*)XMALLOC(sizeof(OcspResponse), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+
+    if (newStatus == NULL || ocspRequest == NULL || ocspResponse == NULL) {
+        if (newStatus)    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (ocspRequest)  XFREE(ocspRequest,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (ocspResponse) XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+        CYASSL_LEAVE("CheckStapleOCSP", MEMORY_E);
+        return MEMORY_E;
+    }
+#endif
+
+    /* request the staple has to answer, no nonce in a staple */
+    InitOcspRequest(ocspRequest, NULL, 0, NULL, 0);
+    ocspRequest->issuerHash    = (byte*)id->issuerHash;
+    ocspRequest->issuerKeyHash = (byte*)id->issuerKeyHash;
+    ocspRequest->serial        = (byte*)id->serial;
+    ocspRequest->serialSz      = id->serialSz;
+
+    XMEMSET(newStatus, 0, sizeof(CertStatus));
+    InitOcspResponse(ocspResponse, newStatus, resp, respSz);
+    ocspResponse->cm = ocsp->cm;
+
+    if (OcspResponseDecode(ocspResponse) != 0 ||
+            ocspResponse->responseStatus != OCSP_SUCCESSFUL) {
+        CYASSL_MSG("\tbad stapled OCSP response");
+        result = OCSP_LOOKUP_FAIL;
+    }
+    else if (CompareOcspReqResp(ocspRequest, ocspResponse) != 0) {
+        CYASSL_MSG("\tstapled OCSP response is for another cert");
+        result = OCSP_LOOKUP_FAIL;
+    }
+    else if (OCSP_StatusLeft(newStatus) == 0) {
+        /* could be replayed, only trust it with a nextUpdate to go */
+        CYASSL_MSG("\tstapled OCSP response is stale");
+        result = OCSP_LOOKUP_FAIL;
+    }
+    else {
+        result = xstat2err(newStatus->status);
+
+        /* NULL refreshes from the override */
+        if (ocsp->cm->ocspUseOverrideURL || urlSz == 0)
+            url = NULL;
+
+        if (CacheOCSP_Status(ocsp, id, newStatus, NULL, 0, NULL, url,
+                             urlSz) != 0) {
+            CYASSL_MSG("\tunable to cache OCSP status");
+        }
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(newStatus,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(ocspRequest,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(ocspResponse, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    CYASSL_LEAVE("CheckStapleOCSP", result);
+    return result;
+}
+
+
+/* Fetch and cache the status of our own cert for stapling, id filled in
+   for GetStapleOCSP. The refresher keeps it current after this */
+int SetStapleOCSP(CYASSL_OCSP* ocsp, DecodedCert* cert, OcspId* id)
+{
+    const char* url   = (const char*)cert->extAuthInfo;
+    int         urlSz = cert->extAuthInfo ? cert->extAuthInfoSz : 0;
+    byte*       raw   = NULL;
+    word32      rawSz = 0;
+    int         result;
+    byte        respHash[SHA_DIGEST_SIZE];
+#ifdef CYASSL_SMALL_STACK
+    CertStatus* newStatus;
+#else
+    CertStatus newStatus[1];
+#endif
+
+    CYASSL_ENTER("SetStapleOCSP");
+
+    SetOcspId(id, cert);
+
+    result = OCSP_Responder(ocsp, &url, &urlSz);
+    if (result == 1) {
+        CYASSL_MSG("\tno OCSP responder for our cert");
+        return OCSP_NEED_URL;
+    }
+    if (result != 0)
+        return result;
+
+#ifdef CYASSL_SMALL_STACK
+    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (newStatus == NULL)
+        return MEMORY_E;
+#endif
+
+    result = RequestOCSP(ocsp, id, url, urlSz, newStatus, &raw, &rawSz,
+                         respHash);
+
+    if (!IsOCSP_Status(result)) {
+        CYASSL_MSG("\tOCSP lookup of our cert failed");
+    }
+    else if (raw == NULL) {
+        result = MEMORY_E;
+    }
+    else if (OCSP_StatusLeft(newStatus) == 0) {
+        CYASSL_MSG("\tno nextUpdate in our OCSP response, can't staple it");
+        XFREE(raw, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        result = OCSP_LOOKUP_FAIL;
+    }
+    else {
+        result = CacheOCSP_Status(ocsp, id, newStatus, raw, rawSz, respHash,
+                           ocsp->cm->ocspUseOverrideURL ? NULL : url, urlSz);
+    }
+
+#ifdef CYASSL_SMALL_STACK
+    XFREE(newStatus, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return result;
+}
+
+
+/* Copy of the unexpired response for id to staple, allocated from heap */
+int GetStapleOCSP(CYASSL_OCSP* ocsp, const OcspId* id, byte** resp,
+                  word32* respSz, void* heap)
+{
+    OCSP_Entry* ocspe;
+    int         ret = OCSP_LOOKUP_FAIL;
+
+    (void)heap;
+
+    *resp   = NULL;
+    *respSz = 0;
+
+    if (LockMutex(&ocsp->ocspLock) != 0)
+        return BAD_MUTEX_E;
+
+    ocspe = FindOCSP_Entry(ocsp, id);
+    if (ocspe != NULL && ocspe->raw != NULL &&
+                                (int)(ocspe->expires - LowResTimer()) > 0) {
+        *resp = (byte*)XMALLOC(ocspe->rawSz, heap, DYNAMIC_TYPE_OCSP_ENTRY);
+        if (*resp) {
+            XMEMCPY(*resp, ocspe->raw, ocspe->rawSz);
+            *respSz = ocspe->rawSz;
+            ret = 0;
+        }
+        else
+            ret = MEMORY_E;
+    }
+
+    UnLockMutex(&ocsp->ocspLock);
+
+    return ret;
+}
+
+
+#ifdef HAVE_OCSP_REFRESH
+
+#ifndef OCSP_REFRESH_BATCH
+    #define OCSP_REFRESH_BATCH 8    /* entries fetched per row pass */
+#endif
+
+/* due entry, copied so the fetch runs without ocspLock */
+typedef struct OCSP_Due {
+    OcspId      id;
+    const char* url;            /* entries live until FreeOCSP */
+    int         urlSz;
+    byte        keepRaw;
+} OCSP_Due;
+
+
+static int OCSP_RefreshStopping(CYASSL_OCSP* ocsp)
+{
+    int stop;
+
+    pthread_mutex_lock(&ocsp->refreshLock);
+    stop = ocsp->refreshStop;
+    pthread_mutex_unlock(&ocsp->refreshLock);
+
+    return stop;
+}
+
+
+/* Collect up to max entries of row past their refresh time, unexpired or
+   stapled ones. Their refresh time is pushed out first so a failed fetch
+   backs off */
+static int GetDueOCSP(CYASSL_OCSP* ocsp, int row, OCSP_Due* due, int max)
+{
+    OCSP_Entry* ocspe;
+    word32      now = LowResTimer();
+    int         count = 0;
+
+    if (LockMutex(&ocsp->ocspLock) != 0)
+        return 0;
+
+    for (ocspe = ocsp->ocspTable[row]; ocspe && count < max;
+                                                        ocspe = ocspe->next) {
+        if ((int)(ocspe->refresh - now) > 0)
+            continue;
+        if (!ocspe->keepRaw && (int)(ocspe->expires - now) <= 0)
+            continue;
+
+        XMEMCPY(&due[count].id, &ocspe->id, sizeof(OcspId));
+        due[count].url     = ocspe->url;
+        due[count].urlSz   = ocspe->urlSz;
+        due[count].keepRaw = ocspe->keepRaw;
+        count++;
+
+        ocspe->refresh = now + OCSP_REFRESH_RETRY;
+    }
+
+    UnLockMutex(&ocsp->ocspLock);
+
+    return count;
+}
+
+
+/* Refetch due entries of one row */
+static void RefreshOCSP_Row(CYASSL_OCSP* ocsp, int row, CertStatus* newStatus)
+{
+    OCSP_Due due[OCSP_REFRESH_BATCH];
+    int      count;
+    int      i;
+
+    do {
+        count = GetDueOCSP(ocsp, row, due, OCSP_REFRESH_BATCH);
+
+        for (i = 0; i < count && !OCSP_RefreshStopping(ocsp); i++) {
+            const char* url   = due[i].url;
+            int         urlSz = due[i].urlSz;
+            byte*       raw   = NULL;
+            word32      rawSz = 0;
+            int         result;
+            byte        respHash[SHA_DIGEST_SIZE];
+
+            if (url == NULL) {
+                url = ocsp->cm->ocspOverrideURL;
+                if (url == NULL || url[0] == '\0')
+                    continue;
+                urlSz = (int)XSTRLEN(url);
+            }
+
+            result = RequestOCSP(ocsp, &due[i].id, url, urlSz, newStatus,
+                                 due[i].keepRaw ? &raw : NULL, &rawSz,
+                                 respHash);
+            if (IsOCSP_Status(result) && (!due[i].keepRaw || raw != NULL))
+                CacheOCSP_Status(ocsp, &due[i].id, newStatus, raw, rawSz,
+                                 respHash, due[i].url, due[i].urlSz);
+            else {
+                CYASSL_MSG("\tOCSP refresh failed, will retry");
+            }
+        }
+    } while (count == OCSP_REFRESH_BATCH && !OCSP_RefreshStopping(ocsp));
+}
+
+
+/* Refresher thread, refetches every OCSP_REFRESH_INTERVAL until stopped */
+static void* DoOcspRefresh(void* arg)
+{
+    CYASSL_OCSP*    ocsp = (CYASSL_OCSP*)arg;
+    CertStatus      newStatus;
+    struct timespec wake;
+    int             row;
+
+    CYASSL_ENTER("DoOcspRefresh");
+
+    for (;;) {
+        int stop;
+
+        pthread_mutex_lock(&ocsp->refreshLock);
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += OCSP_REFRESH_INTERVAL;
+        while (!ocsp->refreshStop) {
+            if (pthread_cond_timedwait(&ocsp->refreshCond, &ocsp->refreshLock,
+                                       &wake) == ETIMEDOUT)
+                break;
+        }
+        stop = ocsp->refreshStop;
+        pthread_mutex_unlock(&ocsp->refreshLock);
+
+        if (stop)
+            break;
+
+        for (row = 0; row < OCSP_TABLE_SIZE; row++)
+            RefreshOCSP_Row(ocsp, row, &newStatus);
+    }
+
+    return NULL;
+}
+
+
+/* Start refreshing cached statuses before they expire, the cert manager's
+   OCSP I/O callback gets called from the refresh thread */
+int StartOCSP_Refresh(CYASSL_OCSP* ocsp)
+{
+    CYASSL_ENTER("StartOCSP_Refresh");
+
+    if (ocsp == NULL)
+        return BAD_FUNC_ARG;
+
+    if (ocsp->tid != 0) {
+        CYASSL_MSG("OCSP refresh thread already running");
+        return SSL_SUCCESS;
+    }
+
+    ocsp->refreshStop = 0;
+    if (pthread_create(&ocsp->tid, NULL, DoOcspRefresh, ocsp) != 0) {
+        CYASSL_MSG("Thread creation error");
+        ocsp->tid = 0;
+        return THREAD_CREATE_E;
+    }
+
+    return SSL_SUCCESS;
+}
+
+#else /* HAVE_OCSP_REFRESH */
+
+int StartOCSP_Refresh(CYASSL_OCSP* ocsp)
+{
+    (void)ocsp;
+
+    CYASSL_ENTER("StartOCSP_Refresh");
+    CYASSL_MSG("Not compiled in");
+
+    return NOT_COMPILED_IN;
+}
+
+#endif /* HAVE_OCSP_REFRESH */
+
+
 #else /* HAVE_OCSP */
 
 
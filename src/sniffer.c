@@ -34,6 +34,7 @@
 
 #ifndef _WIN32
   #include <arpa/inet.h>
+  #include <sys/time.h>
 #endif
 
 #ifdef _WIN32
@@ -63,6 +64,31 @@ static INLINE word32 min(word32 a, word32 b)
     /* Cache unclosed Sessions for 15 minutes since last used */
 #endif
 
+#ifndef CYASSL_SNIFFER_FLOW_MAX
+    #define CYASSL_SNIFFER_FLOW_MAX (256 * 1024)
+    /* Out of order bytes held for one session */
+#endif
+
+#ifndef CYASSL_SNIFFER_REASSEMBLY_MAX
+    #define CYASSL_SNIFFER_REASSEMBLY_MAX (64 * 1024 * 1024)
+    /* Out of order bytes held for a Session Table, oldest flows give way */
+#endif
+
+#ifndef CYASSL_SNIFFER_HASH_SIZE
+    #define CYASSL_SNIFFER_HASH_SIZE 512
+    /* Session Hash Table first Rows, power of two, doubles as it fills */
+#endif
+
+#ifndef CYASSL_SNIFFER_PMS_CACHE_SIZE
+    #define CYASSL_SNIFFER_PMS_CACHE_SIZE 1024
+    /* Premaster Cache rows, by hash of the encrypted premaster */
+#endif
+
+#ifndef CYASSL_SNIFFER_PENDING_MAX
+    #define CYASSL_SNIFFER_PENDING_MAX (64 * 1024)
+    /* Input held for one session while its premaster decrypts */
+#endif
+
 /* Misc constants */
 enum {
     MAX_SERVER_ADDRESS = 128, /* maximum server address length */
@@ -76,14 +102,22 @@ enum {
     IPV4               = 4,   /* IP version 4 */
     TCP_PROTOCOL       = 6,   /* TCP Protocol id */
     TRACE_MSG_SZ       = 80,  /* Trace Message buffer size */
-    HASH_SIZE          = 499, /* Session Hash Table Rows */
+    STALE_WHEEL_SLOTS  = 64,  /* Stale Session timer wheel slots */
+    REASSEMBLY_CHUNK   = 2048,/* PacketBuffer data size, segments coalesce */
+    REASSEMBLY_POOL    = 256, /* free PacketBuffers kept per worker table */
     PSEUDO_HDR_SZ      = 12,  /* TCP Pseudo Header size in bytes */
     FATAL_ERROR_STATE  =  1,  /* SnifferSession fatal error state */
     TICKET_HINT_LEN    = 4,   /* Session Ticket Hint length */
     EXT_TYPE_SZ        = 2,   /* Extension length */
     MAX_INPUT_SZ       = MAX_RECORD_SIZE + COMP_EXTRA + MAX_MSG_EXTRA + 
                          MTU_EXTRA,  /* Max input sz of reassembly */
-    TICKET_EXT_ID      = 0x23 /* Session Ticket Extension ID */
+    TICKET_EXT_ID      = 0x23,/* Session Ticket Extension ID */
+    DECRYPT_WORKERS_MAX = 64, /* premaster decrypt threads */
+#ifndef NO_SHA256
+    PMS_ID_SZ          = SHA256_DIGEST_SIZE /* Premaster Cache key */
+#else
+    PMS_ID_SZ          = SHA_DIGEST_SIZE
+#endif
 };
 
 
@@ -233,7 +267,16 @@ static const char* const msgTable[] =
 
     /* 71 */
     "Decrypt Keys Not Set Up",
-    "Late Key Load Error"
+    "Late Key Load Error",
+    "Shards Running, Server List Fixed",
+    "Bad Shard Index",
+    "Reassembly Buffer Size Exceeded",
+
+    /* 76 */
+    "Session Not Found",
+    "Bad Session Import",
+    "Held Input Exceeded Waiting For Premaster",
+    "Decrypt Workers Error"
 };
 
 
@@ -258,11 +301,13 @@ static void GetError(int idx, char* buffer)
 #endif /* _WIN32 */
 
 
-/* Packet Buffer for reassembly list and ready list */
+/* Packet Buffer for reassembly list and ready list, one interval of */
+/* contiguous data, later segments that fit are added on the end */
 typedef struct PacketBuffer {
     word32  begin;      /* relative sequence begin */
     word32  end;        /* relative sequence end   */
     byte*   data;       /* actual data             */
+    word32  cap;        /* data size               */
     struct PacketBuffer* next; /* next on reassembly list or ready list */
 } PacketBuffer;
 
@@ -317,6 +362,39 @@ typedef struct FinCaputre {
 } FinCaputre;
 
 
+/* Premaster Cache entry, one ClientKeyExchange decrypted */
+typedef struct PmsEntry {
+    SnifferServer* context;         /* server the premaster was sent to */
+    byte           id[PMS_ID_SZ];   /* hash of the encrypted premaster */
+    byte           pms[SECRET_LEN]; /* decrypted premaster */
+} PmsEntry;
+
+
+/* Premaster decrypt for a worker, the session only points at it */
+typedef struct DecryptJob {
+    SnifferServer* context;         /* for the Premaster Cache */
+    byte*          key;             /* copy of the DER private key */
+    word32         keySz;
+    byte           input[ENCRYPT_LEN]; /* encrypted premaster */
+    word32         inputSz;
+    byte           id[PMS_ID_SZ];
+    byte           pms[SECRET_LEN];
+    int            ret;             /* 0 or error string index */
+    byte           done;            /* worker finished, pms or ret set */
+    byte           orphan;          /* session gone, worker frees */
+    struct DecryptJob* next;        /* work queue */
+} DecryptJob;
+
+
+/* Input held while a session waits for its premaster, in arrival order */
+typedef struct PendingData {
+    byte*  data;                    /* follows the struct */
+    word32 sz;
+    byte   side;                    /* which end it was headed to */
+    struct PendingData* next;
+} PendingData;
+
+
 /* Sniffer Session holds info for each client/server SSL/TLS session */
 typedef struct SnifferSession {
     SnifferServer* context;         /* server context */
@@ -335,20 +413,91 @@ typedef struct SnifferSession {
     time_t         lastUsed;          /* last used ticks */
     PacketBuffer*  cliReassemblyList; /* client out of order packets */
     PacketBuffer*  srvReassemblyList; /* server out of order packets */
+    PacketBuffer*  cliReassemblyTail; /* last on client list */
+    PacketBuffer*  srvReassemblyTail; /* last on server list */
+    word32         reassemblyBytes;   /* held on both lists */
+    struct SnifferSession*  heldNext; /* table's holding list, oldest first */
+    struct SnifferSession** heldPrev; /* link to us, 0 if holding nothing */
     struct SnifferSession* next;      /* for hash table list */
+    struct SnifferShard*   shard;     /* table this session is in */
+    word32         hash;              /* FlowHash, row and resize */
+    struct SnifferSession*  wheelNext;  /* stale timer wheel slot list */
+    struct SnifferSession** wheelPrev;  /* link to us, 0 if not in a slot */
     byte*          ticketID;          /* mac ID of session ticket */
+    SSLSnifferDataCb dataCb;          /* batch decoded data callback */
+    void*          dataCtx;           /* user ctx for dataCb */
+    void*          flowCtx;           /* user per flow ctx for dataCb */
+    DecryptJob*    pmsJob;            /* premaster decrypting, 0 if not */
+    PendingData*   pendingHead;       /* input held until pmsJob is done */
+    PendingData*   pendingTail;
+    word32         pendingBytes;
 } SnifferSession;
 
 
+/* Stale timer wheel tick, the wheel spans at least the timeout */
+#define STALE_TICK_SECS ((CYASSL_SNIFFER_TIMEOUT + STALE_WHEEL_SLOTS - 1) / \
+                         STALE_WHEEL_SLOTS)
+
+
+/* Session Hash Table and stale timer wheel */
+typedef struct SnifferShard {
+    SnifferSession** table;         /* power of two rows, 0 until first use */
+    word32           tableSz;
+    word32           count;         /* sessions in table */
+    SnifferSession*  wheel[STALE_WHEEL_SLOTS]; /* sessions by expiry tick */
+    word32           wheelTick;     /* last tick expired, 0 not started */
+    SnifferSession*  heldHead;      /* sessions holding out of order data */
+    SnifferSession** heldTail;      /* link to add the next one at */
+    word32           reassemblyBytes; /* held by all sessions */
+    PacketBuffer*    pool;          /* free REASSEMBLY_CHUNK PacketBuffers */
+    int              poolCount;
+    SSLStats         stats;         /* counters, sizes come from above */
+    byte             locked;        /* shared, use SessionMutex and */
+                                    /* ReassemblyMutex, no pool */
+} SnifferShard;
+
+
 /* Sniffer Server List and mutex */
 static SnifferServer* ServerList = 0;
 static CyaSSL_Mutex ServerListMutex;
 
 
-/* Session Hash Table, mutex, and count */
-static SnifferSession* SessionTable[HASH_SIZE];
+/* Session Table for ssl_DecodePacket() and its mutexes */
+static SnifferShard SessionShard;
 static CyaSSL_Mutex SessionMutex;
-static int SessionCount = 0;
+static CyaSSL_Mutex ReassemblyMutex;    /* byte counts and holding list */
+static CyaSSL_Mutex StatsMutex;         /* its counters */
+
+
+/* Worker Session Tables, each owned by one thread so no mutex */
+static SnifferShard* Shards = 0;
+static int ShardCount = 0;
+
+
+/* Premaster Cache, shared by all Session Tables */
+static PmsEntry     PmsCache[CYASSL_SNIFFER_PMS_CACHE_SIZE];
+static CyaSSL_Mutex PmsCacheMutex;
+
+
+/* Premaster decrypt workers, their queue and job states */
+static CyaSSL_Mutex     DecryptMutex;
+static DecryptJob*      DecryptQueue = 0;      /* oldest first */
+static DecryptJob**     DecryptQueueTail = &DecryptQueue;
+static int              DecryptWorkers = 0;
+static SSLSnifferDataCb DecryptDataCb = 0;     /* for flows without one */
+static void*            DecryptDataCtx = 0;
+#ifdef CYASSL_PTHREADS
+static pthread_t        DecryptTid[DECRYPT_WORKERS_MAX];
+static pthread_cond_t   DecryptCond;
+static int              DecryptStop = 0;
+#endif
+
+static void StopDecryptWorkers(void);
+
+
+/* New session callback for sharing with other sniffers, fixed like keys */
+static SSLSnifferSessionCb SessionCb = 0;
+static void*               SessionCbCtx = 0;
 
 
 /* Initialize overall Sniffer */
@@ -357,6 +506,94 @@ void ssl_InitSniffer(void)
     CyaSSL_Init();
     InitMutex(&ServerListMutex);
     InitMutex(&SessionMutex);
+    InitMutex(&ReassemblyMutex);
+    InitMutex(&StatsMutex);
+    InitMutex(&PmsCacheMutex);
+    InitMutex(&DecryptMutex);
+#ifdef CYASSL_PTHREADS
+    pthread_cond_init(&DecryptCond, NULL);
+#endif
+    SessionShard.locked = 1;
+}
+
+
+/* Server List is fixed once shards run, workers read it without the mutex */
+/* returns 1 if locked, pass to UnLockServerList */
+static int LockServerList(void)
+{
+    if (ShardCount)
+        return 0;
+
+    LockMutex(&ServerListMutex);
+    return 1;
+}
+
+
+static void UnLockServerList(int locked)
+{
+    if (locked)
+        UnLockMutex(&ServerListMutex);
+}
+
+
+static void LockShard(SnifferShard* shard)
+{
+    if (shard->locked)
+        LockMutex(&SessionMutex);
+}
+
+
+static void UnLockShard(SnifferShard* shard)
+{
+    if (shard->locked)
+        UnLockMutex(&SessionMutex);
+}
+
+
+static void LockStats(SnifferShard* shard)
+{
+    if (shard->locked)
+        LockMutex(&StatsMutex);
+}
+
+
+static void UnLockStats(SnifferShard* shard)
+{
+    if (shard->locked)
+        UnLockMutex(&StatsMutex);
+}
+
+
+/* Seconds from an arbitrary start, for timing processing stages */
+static double StageTime(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER        count;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, 0);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+#endif
+}
+
+
+/* Add time since start to shard's stage counter */
+static void AddStageTime(SnifferShard* shard, double* secs, double start)
+{
+    double now = StageTime();
+
+    LockStats(shard);
+    *secs += now - start;
+    UnLockStats(shard);
 }
 
 
@@ -405,18 +642,24 @@ static void FreeSnifferServer(SnifferServer* srv)
 }
 
 
-/* free PacketBuffer's resources/self */
-static void FreePacketBuffer(PacketBuffer* del)
+/* free PacketBuffer's resources/self, or keep it in the shard's pool */
+static void FreePacketBuffer(SnifferShard* shard, PacketBuffer* del)
 {
     if (del) {
-        free(del->data);
-        free(del);
+        if (!shard->locked && del->cap == REASSEMBLY_CHUNK &&
+                                          shard->poolCount < REASSEMBLY_POOL) {
+            del->next   = shard->pool;
+            shard->pool = del;
+            shard->poolCount++;
+            return;
+        }
+        free(del);  /* data allocated with it */
     }
 }
 
 
 /* remove PacketBuffer List */
-static void FreePacketList(PacketBuffer* in)
+static void FreePacketList(SnifferShard* shard, PacketBuffer* in)
 {
     if (in) {
         PacketBuffer* del;
@@ -425,8 +668,95 @@ static void FreePacketList(PacketBuffer* in)
         while (packet) {
             del = packet;
             packet = packet->next;
-            FreePacketBuffer(del);
+            FreePacketBuffer(shard, del);
+        }
+    }
+}
+
+
+static void LockReassembly(SnifferShard* shard)
+{
+    if (shard->locked)
+        LockMutex(&ReassemblyMutex);
+}
+
+
+static void UnLockReassembly(SnifferShard* shard)
+{
+    if (shard->locked)
+        UnLockMutex(&ReassemblyMutex);
+}
+
+
+/* Add (or remove if negative) bytes held out of order for session, keeps */
+/* the table's count and its holding list, oldest holder first */
+static void HoldReassembly(SnifferSession* session, int bytes)
+{
+    SnifferShard* shard = session->shard;
+
+    LockReassembly(shard);
+
+    shard->reassemblyBytes   += bytes;
+    session->reassemblyBytes += bytes;
+
+    if (session->reassemblyBytes && session->heldPrev == NULL) {
+        session->heldNext = NULL;
+        if (shard->heldTail == NULL)
+            shard->heldTail = &shard->heldHead;
+        session->heldPrev = shard->heldTail;
+        *shard->heldTail  = session;
+        shard->heldTail   = &session->heldNext;
+    }
+    else if (session->reassemblyBytes == 0 && session->heldPrev) {
+        *session->heldPrev = session->heldNext;
+        if (session->heldNext)
+            session->heldNext->heldPrev = session->heldPrev;
+        else
+            shard->heldTail = session->heldPrev;
+        session->heldPrev = NULL;
+        session->heldNext = NULL;
+    }
+
+    UnLockReassembly(shard);
+}
+
+
+/* Free both of session's reassembly lists */
+static void FreeReassembly(SnifferSession* session)
+{
+    FreePacketList(session->shard, session->cliReassemblyList);
+    FreePacketList(session->shard, session->srvReassemblyList);
+    session->cliReassemblyList = NULL;
+    session->srvReassemblyList = NULL;
+    session->cliReassemblyTail = NULL;
+    session->srvReassemblyTail = NULL;
+
+    if (session->reassemblyBytes)
+        HoldReassembly(session, -(int)session->reassemblyBytes);
+}
+
+
+/* Drop a session's held input and let go of its premaster decrypt */
+static void FreePending(SnifferSession* session)
+{
+    while (session->pendingHead) {
+        PendingData* del = session->pendingHead;
+        session->pendingHead = del->next;
+        free(del);
+    }
+    session->pendingTail  = 0;
+    session->pendingBytes = 0;
+
+    if (session->pmsJob) {
+        LockMutex(&DecryptMutex);
+        if (session->pmsJob->done) {
+            XMEMSET(session->pmsJob->pms, 0, SECRET_LEN);
+            free(session->pmsJob);
         }
+        else
+            session->pmsJob->orphan = 1;   /* queued or in a worker */
+        UnLockMutex(&DecryptMutex);
+        session->pmsJob = 0;
     }
 }
 
@@ -438,24 +768,63 @@ static void FreeSnifferSession(SnifferSession* session)
         SSL_free(session->sslClient);
         SSL_free(session->sslServer);
         
-        FreePacketList(session->cliReassemblyList);
-        FreePacketList(session->srvReassemblyList);
+        if (session->shard)
+            FreeReassembly(session);
 
         free(session->ticketID);
+        FreePending(session);
+
+        /* end of flow, let the user free flowCtx */
+        if (session->dataCb)
+            session->dataCb(NULL, 0, 0, &session->flowCtx, session->dataCtx);
     }
     free(session);
 }
 
 
+/* Free all Sniffer Sessions in a Session Table */
+static void FreeShardSessions(SnifferShard* shard)
+{
+    SnifferSession* session;
+    SnifferSession* removeSession;
+    int i;
+
+    for (i = 0; shard->table && i < (int)shard->tableSz; i++) {
+        session = shard->table[i];
+        while (session) {
+            removeSession = session;
+            session = session->next;
+            FreeSnifferSession(removeSession);
+        }
+    }
+
+    while (shard->pool) {
+        PacketBuffer* del = shard->pool;
+        shard->pool = del->next;
+        free(del);
+    }
+
+    free(shard->table);
+    XMEMSET(shard->wheel, 0, sizeof(shard->wheel));
+    shard->table     = 0;
+    shard->tableSz   = 0;
+    shard->count     = 0;
+    shard->wheelTick = 0;
+    shard->poolCount = 0;
+    XMEMSET(&shard->stats, 0, sizeof(SSLStats));
+}
+
+
 /* Free overall Sniffer */
 void ssl_FreeSniffer(void)
 {
     SnifferServer*  srv;
     SnifferServer*  removeServer;
-    SnifferSession* session;
-    SnifferSession* removeSession;
     int i;
 
+    /* the workers only touch their jobs and the Premaster Cache */
+    StopDecryptWorkers();
+
     LockMutex(&ServerListMutex);
     LockMutex(&SessionMutex);
     
@@ -465,20 +834,32 @@ void ssl_FreeSniffer(void)
         srv = srv->next;
         FreeSnifferServer(removeServer);
     }
+    ServerList = 0;
 
-    for (i = 0; i < HASH_SIZE; i++) {
-        session = SessionTable[i];
-        while (session) {
-            removeSession = session;
-            session = session->next;
-            FreeSnifferSession(removeSession);
-        }
-    }
+    FreeShardSessions(&SessionShard);
+
+    for (i = 0; i < ShardCount; i++)
+        FreeShardSessions(&Shards[i]);
+    free(Shards);
+    Shards = 0;
+    ShardCount = 0;
+    SessionCb = 0;
+    SessionCbCtx = 0;
+    DecryptDataCb = 0;
+    DecryptDataCtx = 0;
+    XMEMSET(PmsCache, 0, sizeof(PmsCache));
 
     UnLockMutex(&SessionMutex);
     UnLockMutex(&ServerListMutex);
 
     FreeMutex(&SessionMutex);
+    FreeMutex(&ReassemblyMutex);
+    FreeMutex(&StatsMutex);
+    FreeMutex(&PmsCacheMutex);
+    FreeMutex(&DecryptMutex);
+#ifdef CYASSL_PTHREADS
+    pthread_cond_destroy(&DecryptCond);
+#endif
     FreeMutex(&ServerListMutex);
 
     if (TraceFile) {
@@ -547,8 +928,24 @@ static void InitSession(SnifferSession* session)
     session->lastUsed       = 0;
     session->cliReassemblyList = 0;
     session->srvReassemblyList = 0;
+    session->cliReassemblyTail = 0;
+    session->srvReassemblyTail = 0;
+    session->reassemblyBytes   = 0;
+    session->heldNext       = 0;
+    session->heldPrev       = 0;
     session->next           = 0;
+    session->shard          = 0;
+    session->hash           = 0;
+    session->wheelNext      = 0;
+    session->wheelPrev      = 0;
     session->ticketID       = 0;
+    session->dataCb         = 0;
+    session->dataCtx        = 0;
+    session->flowCtx        = 0;
+    session->pmsJob         = 0;
+    session->pendingHead    = 0;
+    session->pendingTail    = 0;
+    session->pendingBytes   = 0;
     
     InitFlags(&session->flags);
     InitFinCapture(&session->finCaputre);
@@ -856,23 +1253,46 @@ static void TraceRemovedSession(void)
 
 
 /* Set user error string */
+/* Count error idx against shard */
+static void CountError(SnifferShard* shard, int idx)
+{
+    if (idx < 0 || idx >= SSL_SNIFFER_MAX_ERRORS)
+        return;
+
+    LockStats(shard);
+    shard->stats.errors[idx]++;
+    UnLockStats(shard);
+}
+
+
 static void SetError(int idx, char* error, SnifferSession* session, int fatal)
 {
     GetError(idx, error);
     Trace(idx);
+    CountError(session && session->shard ? session->shard : &SessionShard,idx);
     if (session && fatal == FATAL_ERROR_STATE)
         session->flags.fatalError = 1;
 }
 
 
+/* Set Error for a packet on shard that has no session */
+static void SetShardError(int idx, char* error, SnifferShard* shard)
+{
+    GetError(idx, error);
+    Trace(idx);
+    CountError(shard, idx);
+}
+
+
 /* See if this IPV4 network order address has been registered */
 /* return 1 is true, 0 is false */
 static int IsServerRegistered(word32 addr)
 {
     int ret = 0;     /* false */
     SnifferServer* sniffer;
+    int locked;
 
-    LockMutex(&ServerListMutex);
+    locked = LockServerList();
     
     sniffer = ServerList;
     while (sniffer) {
@@ -883,7 +1303,7 @@ static int IsServerRegistered(word32 addr)
         sniffer = sniffer->next;
     }
     
-    UnLockMutex(&ServerListMutex);
+    UnLockServerList(locked);
 
     return ret;
 }
@@ -895,8 +1315,9 @@ static int IsPortRegistered(word32 port)
 {
     int ret = 0;    /* false */
     SnifferServer* sniffer;
+    int locked;
     
-    LockMutex(&ServerListMutex);
+    locked = LockServerList();
     
     sniffer = ServerList;
     while (sniffer) {
@@ -907,7 +1328,7 @@ static int IsPortRegistered(word32 port)
         sniffer = sniffer->next;
     }
     
-    UnLockMutex(&ServerListMutex);
+    UnLockServerList(locked);
 
     return ret;
 }
@@ -917,8 +1338,9 @@ static int IsPortRegistered(word32 port)
 static SnifferServer* GetSnifferServer(IpInfo* ipInfo, TcpInfo* tcpInfo)
 {
     SnifferServer* sniffer;
+    int locked;
     
-    LockMutex(&ServerListMutex);
+    locked = LockServerList();
     
     sniffer = ServerList;
     while (sniffer) {
@@ -929,34 +1351,59 @@ static SnifferServer* GetSnifferServer(IpInfo* ipInfo, TcpInfo* tcpInfo)
         sniffer = sniffer->next;
     }
     
-    UnLockMutex(&ServerListMutex);
+    UnLockServerList(locked);
     
     return sniffer;
 }
 
 
-/* Hash the Session Info, return hash row */
+/* Symmetric flow hash, both directions of a connection give the same value */
+static word32 FlowHash(word32 src, word32 dst, word16 srcPort, word16 dstPort)
+{
+    word32 hash;
+
+    if (src > dst || (src == dst && srcPort > dstPort)) {
+        word32 addr = src;
+        word16 port = srcPort;
+
+        src = dst;         dst = addr;
+        srcPort = dstPort; dstPort = port;
+    }
+
+    hash  = src * 0x9E3779B1U;
+    hash ^= dst + (hash << 6) + (hash >> 2);
+    hash ^= ((word32)srcPort << 16 | dstPort) * 0x85EBCA6BU;
+    hash ^= hash >> 15;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+
+/* Hash the Session Info */
 static word32 SessionHash(IpInfo* ipInfo, TcpInfo* tcpInfo)
 {
-    word32 hash = ipInfo->src * ipInfo->dst;
-    hash *= tcpInfo->srcPort * tcpInfo->dstPort;
-    
-    return hash % HASH_SIZE;
+    return FlowHash(ipInfo->src, ipInfo->dst, (word16)tcpInfo->srcPort,
+                    (word16)tcpInfo->dstPort);
 }
 
 
+static void ExpireSessions(SnifferShard* shard, time_t currTime);
+
+
 /* Get Exisiting SnifferSession from IP and Port */
-static SnifferSession* GetSnifferSession(IpInfo* ipInfo, TcpInfo* tcpInfo)
+static SnifferSession* GetSnifferSession(SnifferShard* shard, IpInfo* ipInfo,
+                                         TcpInfo* tcpInfo)
 {
-    SnifferSession* session;
-    time_t          currTime = time(NULL); 
-    word32          row = SessionHash(ipInfo, tcpInfo);
+    SnifferSession* session = 0;
+    time_t          currTime = (time_t)LowResTimer();
+    word32          hash = SessionHash(ipInfo, tcpInfo);
 
-    assert(row <= HASH_SIZE);
-    
-    LockMutex(&SessionMutex);
+    LockShard(shard);
     
-    session = SessionTable[row];
+    if (shard->table)
+        session = shard->table[hash & (shard->tableSz - 1)];
     while (session) {
         if (session->server == ipInfo->src && session->client == ipInfo->dst &&
                     session->srvPort == tcpInfo->srcPort &&
@@ -973,7 +1420,8 @@ static SnifferSession* GetSnifferSession(IpInfo* ipInfo, TcpInfo* tcpInfo)
     if (session)
         session->lastUsed= currTime; /* keep session alive, remove stale will */
                                      /* leave alone */   
-    UnLockMutex(&SessionMutex);
+    ExpireSessions(shard, currTime);
+    UnLockShard(shard);
     
     /* determine side */
     if (session) {
@@ -1165,8 +1613,13 @@ int ssl_SetNamedPrivateKey(const char* name,
     TraceSetNamedServer(name, address, port, keyFile);
 
     LockMutex(&ServerListMutex);
-    ret = SetNamedPrivateKey(name, address, port, keyFile,
-                             typeKey, password, error);
+    if (ShardCount) {
+        SetError(SHARDS_RUNNING_STR, error, NULL, 0);
+        ret = -1;
+    }
+    else
+        ret = SetNamedPrivateKey(name, address, port, keyFile,
+                                 typeKey, password, error);
     UnLockMutex(&ServerListMutex);
 
     if (ret == 0)
@@ -1189,8 +1642,13 @@ int ssl_SetPrivateKey(const char* address, int port, const char* keyFile,
     TraceSetServer(address, port, keyFile);
 
     LockMutex(&ServerListMutex);
-    ret = SetNamedPrivateKey(NULL, address, port, keyFile,
-                             typeKey, password, error);
+    if (ShardCount) {
+        SetError(SHARDS_RUNNING_STR, error, NULL, 0);
+        ret = -1;
+    }
+    else
+        ret = SetNamedPrivateKey(NULL, address, port, keyFile,
+                                 typeKey, password, error);
     UnLockMutex(&ServerListMutex);
 
     if (ret == 0)
@@ -1200,72 +1658,203 @@ int ssl_SetPrivateKey(const char* address, int port, const char* keyFile,
 }
 
 
-/* Check IP Header for IPV4, TCP, and a registered server address */
+/* Sets the new session callback, call before ssl_SetShards() */
 /* returns 0 on success, -1 on error */
-static int CheckIpHdr(IpHdr* iphdr, IpInfo* info, int length, char* error)
+int ssl_SetSessionCb(SSLSnifferSessionCb cb, void* ctx, char* error)
 {
-    int    version = IP_V(iphdr);
+    int ret = 0;
 
-    TraceIP(iphdr);
-    Trace(IP_CHECK_STR);
+    LockMutex(&ServerListMutex);
+    if (ShardCount) {
+        SetError(SHARDS_RUNNING_STR, error, NULL, 0);
+        ret = -1;
+    }
+    else {
+        SessionCb    = cb;
+        SessionCbCtx = ctx;
+    }
+    UnLockMutex(&ServerListMutex);
 
-    if (version != IPV4) {
-        SetError(BAD_IPVER_STR, error, NULL, 0); 
-        return -1;
+    return ret;
+}
+
+
+/* Get an SSL with session id set on the context of server address and port, */
+/* its session cache is the one resumptions to that server look in */
+/* returns SSL on success, NULL on error */
+static SSL* GetSessionSSL(const char* address, int port, const byte* id,
+                          int idSz, char* error)
+{
+    SnifferServer* sniffer;
+    SSL*           ssl = NULL;
+    word32         serverIp;
+    int            locked;
+
+    if (address == NULL || id == NULL || idSz != ID_LEN) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return NULL;
     }
 
-    if (iphdr->protocol != TCP_PROTOCOL) { 
-        SetError(BAD_PROTO_STR, error, NULL, 0);
-        return -1;
+    serverIp = inet_addr(address);
+    locked = LockServerList();
+
+    sniffer = ServerList;
+    while (sniffer != NULL &&
+           (sniffer->server != serverIp || sniffer->port != port)) {
+        sniffer = sniffer->next;
     }
+    if (sniffer)
+        ssl = SSL_new(sniffer->ctx);
 
-    if (!IsServerRegistered(iphdr->src) && !IsServerRegistered(iphdr->dst)) {
+    UnLockServerList(locked);
+
+    if (sniffer == NULL) {
         SetError(SERVER_NOT_REG_STR, error, NULL, 0);
-        return -1;
+        return NULL;
+    }
+    if (ssl == NULL) {
+        SetError(MEMORY_STR, error, NULL, 0);
+        return NULL;
     }
 
-    info->length  = IP_HL(iphdr);
-    info->total   = ntohs(iphdr->length);
-    info->src     = iphdr->src;
-    info->dst     = iphdr->dst;
-
-    if (info->total == 0)
-        info->total = length;  /* reassembled may be off */
+    XMEMCPY(ssl->arrays->sessionID, id, ID_LEN);
+    ssl->arrays->sessionIDSz    = ID_LEN;
+    ssl->options.haveSessionId  = 1;
 
-    return 0;
+    return ssl;
 }
 
 
-/* Check TCP Header for a registered port */
+/* Copies out the master secret of session id for server address and port */
 /* returns 0 on success, -1 on error */
-static int CheckTcpHdr(TcpHdr* tcphdr, TcpInfo* info, char* error)
+int ssl_ExportSession(const char* address, int port, const unsigned char* id,
+                      int idSz, unsigned char* masterSecret, int* secretSz,
+                      char* error)
 {
-    TraceTcp(tcphdr);
-    Trace(TCP_CHECK_STR);
-    info->srcPort   = ntohs(tcphdr->srcPort);
-    info->dstPort   = ntohs(tcphdr->dstPort);
-    info->length    = TCP_LEN(tcphdr);
-    info->sequence  = ntohl(tcphdr->sequence);
-    info->fin       = tcphdr->flags & TCP_FIN;
-    info->rst       = tcphdr->flags & TCP_RST;
-    info->syn       = tcphdr->flags & TCP_SYN;
-    info->ack       = tcphdr->flags & TCP_ACK;
-    if (info->ack)
-        info->ackNumber = ntohl(tcphdr->ack); 
+    SSL* ssl;
+    int  ret = 0;
 
-    if (!IsPortRegistered(info->srcPort) && !IsPortRegistered(info->dstPort)) {
-        SetError(SERVER_PORT_NOT_REG_STR, error, NULL, 0);
+    if (masterSecret == NULL || secretSz == NULL || *secretSz < SECRET_LEN) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
         return -1;
     }
 
-    return 0;
+    ssl = GetSessionSSL(address, port, id, idSz, error);
+    if (ssl == NULL)
+        return -1;
+
+    if (GetSession(ssl, ssl->arrays->masterSecret) == NULL) {
+        SetError(SESSION_NOT_FOUND_STR, error, NULL, 0);
+        ret = -1;
+    }
+    else {
+        XMEMCPY(masterSecret, ssl->arrays->masterSecret, SECRET_LEN);
+        *secretSz = SECRET_LEN;
+    }
+    SSL_free(ssl);
+
+    return ret;
 }
 
 
-/* Decode Record Layer Header */
-static int GetRecordHeader(const byte* input, RecordLayerHeader* rh, int* size)
+/* Adds session id with master secret from another sniffer so a resumption */
+/* to server address and port seen here can be decoded */
+/* returns 0 on success, -1 on error */
+int ssl_ImportSession(const char* address, int port, const unsigned char* id,
+                      int idSz, const unsigned char* masterSecret, int secretSz,
+                      char* error)
 {
-    XMEMCPY(rh, input, RECORD_HEADER_SZ);
+    SSL* ssl;
+    int  ret = 0;
+
+    if (masterSecret == NULL || secretSz != SECRET_LEN) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return -1;
+    }
+
+    ssl = GetSessionSSL(address, port, id, idSz, error);
+    if (ssl == NULL)
+        return -1;
+
+    XMEMCPY(ssl->arrays->masterSecret, masterSecret, SECRET_LEN);
+    if (AddSession(ssl) != 0) {
+        SetError(BAD_SESSION_IMPORT_STR, error, NULL, 0);
+        ret = -1;
+    }
+    SSL_free(ssl);
+
+    return ret;
+}
+
+
+/* Check IP Header for IPV4, TCP, and a registered server address */
+/* returns 0 on success, -1 on error */
+static int CheckIpHdr(SnifferShard* shard, IpHdr* iphdr, IpInfo* info,
+                      int length, char* error)
+{
+    int    version = IP_V(iphdr);
+
+    TraceIP(iphdr);
+    Trace(IP_CHECK_STR);
+
+    if (version != IPV4) {
+        SetShardError(BAD_IPVER_STR, error, shard);
+        return -1;
+    }
+
+    if (iphdr->protocol != TCP_PROTOCOL) { 
+        SetShardError(BAD_PROTO_STR, error, shard);
+        return -1;
+    }
+
+    if (!IsServerRegistered(iphdr->src) && !IsServerRegistered(iphdr->dst)) {
+        SetShardError(SERVER_NOT_REG_STR, error, shard);
+        return -1;
+    }
+
+    info->length  = IP_HL(iphdr);
+    info->total   = ntohs(iphdr->length);
+    info->src     = iphdr->src;
+    info->dst     = iphdr->dst;
+
+    if (info->total == 0)
+        info->total = length;  /* reassembled may be off */
+
+    return 0;
+}
+
+
+/* Check TCP Header for a registered port */
+/* returns 0 on success, -1 on error */
+static int CheckTcpHdr(SnifferShard* shard, TcpHdr* tcphdr, TcpInfo* info,
+                       char* error)
+{
+    TraceTcp(tcphdr);
+    Trace(TCP_CHECK_STR);
+    info->srcPort   = ntohs(tcphdr->srcPort);
+    info->dstPort   = ntohs(tcphdr->dstPort);
+    info->length    = TCP_LEN(tcphdr);
+    info->sequence  = ntohl(tcphdr->sequence);
+    info->fin       = tcphdr->flags & TCP_FIN;
+    info->rst       = tcphdr->flags & TCP_RST;
+    info->syn       = tcphdr->flags & TCP_SYN;
+    info->ack       = tcphdr->flags & TCP_ACK;
+    if (info->ack)
+        info->ackNumber = ntohl(tcphdr->ack); 
+
+    if (!IsPortRegistered(info->srcPort) && !IsPortRegistered(info->dstPort)) {
+        SetShardError(SERVER_PORT_NOT_REG_STR, error, shard);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/* Decode Record Layer Header */
+static int GetRecordHeader(const byte* input, RecordLayerHeader* rh, int* size)
+{
+    XMEMCPY(rh, input, RECORD_HEADER_SZ);
     *size = (rh->length[0] << 8) | rh->length[1];
 
     if (*size > (MAX_RECORD_SIZE + COMP_EXTRA + MAX_MSG_EXTRA))
@@ -1275,70 +1864,127 @@ static int GetRecordHeader(const byte* input, RecordLayerHeader* rh, int* size)
 }
 
 
-/* Process Client Key Exchange, RSA only */
-static int ProcessClientKeyExchange(const byte* input, int* sslBytes,
-                                    SnifferSession* session, char* error)
+/* Premaster Cache key for an encrypted premaster */
+static void PmsId(const byte* input, word32 sz, byte* id)
+{
+#ifndef NO_SHA256
+    Sha256 sha;
+
+    if (InitSha256(&sha) != 0 || Sha256Update(&sha, input, sz) != 0 ||
+                                 Sha256Final(&sha, id) != 0)
+        XMEMSET(id, 0, PMS_ID_SZ);      /* only ever misses */
+#else
+    Sha sha;
+
+    if (InitSha(&sha) != 0)
+        XMEMSET(id, 0, PMS_ID_SZ);
+    else {
+        ShaUpdate(&sha, input, sz);
+        ShaFinal(&sha, id);
+    }
+#endif
+}
+
+
+/* Premaster Cache row for id */
+static PmsEntry* PmsRow(const byte* id)
+{
+    word32 hash = ((word32)id[0] << 24) | ((word32)id[1] << 16) |
+                  ((word32)id[2] <<  8) |  (word32)id[3];
+
+    return &PmsCache[hash % CYASSL_SNIFFER_PMS_CACHE_SIZE];
+}
+
+
+/* Get a cached premaster into pms */
+/* returns 1 if found, 0 otherwise */
+static int GetCachedPms(SnifferServer* context, const byte* id, byte* pms)
+{
+    PmsEntry* row = PmsRow(id);
+    int       found = 0;
+
+    LockMutex(&PmsCacheMutex);
+    if (row->context == context && XMEMCMP(row->id, id, PMS_ID_SZ) == 0) {
+        XMEMCPY(pms, row->pms, SECRET_LEN);
+        found = 1;
+    }
+    UnLockMutex(&PmsCacheMutex);
+
+    return found;
+}
+
+
+/* Cache a decrypted premaster, replaces what was in its row */
+static void AddCachedPms(SnifferServer* context, const byte* id,
+                         const byte* pms)
+{
+    PmsEntry* row = PmsRow(id);
+
+    LockMutex(&PmsCacheMutex);
+    row->context = context;
+    XMEMCPY(row->id, id, PMS_ID_SZ);
+    XMEMCPY(row->pms, pms, SECRET_LEN);
+    UnLockMutex(&PmsCacheMutex);
+}
+
+
+/* RSA decrypt an encrypted premaster with the DER private key */
+/* returns 0 on success, error string index otherwise */
+static int DecryptPms(const byte* keyBuf, word32 keySz, const byte* input,
+                      word32 inputSz, byte* pms)
 {
     word32 idx = 0;
     RsaKey key;
     int    ret;
 
-    ret = InitRsaKey(&key, 0);
-    if (ret == 0) 
-        ret = RsaPrivateKeyDecode(session->sslServer->buffers.key.buffer,
-                          &idx, &key, session->sslServer->buffers.key.length);
-    if (ret == 0) {
-        int length = RsaEncryptSize(&key);
-        
-        if (IsTLS(session->sslServer)) 
-            input += 2;     /* tls pre length */
-       
-        if (length > *sslBytes) { 
-            SetError(PARTIAL_INPUT_STR, error, session, FATAL_ERROR_STATE);
-            FreeRsaKey(&key);
-            return -1;
-        }
-        ret = RsaPrivateDecrypt(input, length, 
-                  session->sslServer->arrays->preMasterSecret,SECRET_LEN, &key);
-        
-        if (ret != SECRET_LEN) {
-            SetError(RSA_DECRYPT_STR, error, session, FATAL_ERROR_STATE);
-            FreeRsaKey(&key);
-            return -1;
-        }
-        ret = 0;  /* not in error state */
-        session->sslServer->arrays->preMasterSz = SECRET_LEN;
-        
-        /* store for client side as well */
-        XMEMCPY(session->sslClient->arrays->preMasterSecret,
-               session->sslServer->arrays->preMasterSecret, SECRET_LEN);
-        session->sslClient->arrays->preMasterSz = SECRET_LEN;
-        
-        #ifdef SHOW_SECRETS
-        {
-            int i;
-            printf("pre master secret: ");
-            for (i = 0; i < SECRET_LEN; i++)
-                printf("%02x", session->sslServer->arrays->preMasterSecret[i]);
-            printf("\n");
-        }
-        #endif
-    }
-    else {
-        SetError(RSA_DECODE_STR, error, session, FATAL_ERROR_STATE);
-        FreeRsaKey(&key);
-        return -1;
+    if (InitRsaKey(&key, 0) != 0)
+        return RSA_DECODE_STR;
+
+    if (RsaPrivateKeyDecode(keyBuf, &idx, &key, keySz) != 0)
+        ret = RSA_DECODE_STR;
+    else if (RsaEncryptSize(&key) != (int)inputSz)
+        ret = PARTIAL_INPUT_STR;
+    else if (RsaPrivateDecrypt(input, inputSz, pms, SECRET_LEN, &key)
+                                                               != SECRET_LEN)
+        ret = RSA_DECRYPT_STR;
+    else
+        ret = 0;
+
+    FreeRsaKey(&key);
+    return ret;
+}
+
+
+/* Set both sides' keys from the premaster */
+/* returns 0 on success, -1 on error */
+static int SetPremaster(SnifferSession* session, const byte* pms, char* error)
+{
+    int ret;
+
+    XMEMCPY(session->sslServer->arrays->preMasterSecret, pms, SECRET_LEN);
+    session->sslServer->arrays->preMasterSz = SECRET_LEN;
+
+    /* store for client side as well */
+    XMEMCPY(session->sslClient->arrays->preMasterSecret, pms, SECRET_LEN);
+    session->sslClient->arrays->preMasterSz = SECRET_LEN;
+
+    #ifdef SHOW_SECRETS
+    {
+        int i;
+        printf("pre master secret: ");
+        for (i = 0; i < SECRET_LEN; i++)
+            printf("%02x", session->sslServer->arrays->preMasterSecret[i]);
+        printf("\n");
     }
-    
+    #endif
+
     if (SetCipherSpecs(session->sslServer) != 0) {
         SetError(BAD_CIPHER_SPEC_STR, error, session, FATAL_ERROR_STATE);
-        FreeRsaKey(&key);
         return -1;
     }
-   
+
     if (SetCipherSpecs(session->sslClient) != 0) {
         SetError(BAD_CIPHER_SPEC_STR, error, session, FATAL_ERROR_STATE);
-        FreeRsaKey(&key);
         return -1;
     }
 
@@ -1369,8 +2015,94 @@ static int ProcessClientKeyExchange(const byte* input, int* sslBytes,
         printf("client suite = %d\n", session->sslClient->options.cipherSuite);
     }
 #endif   
-    
-    FreeRsaKey(&key);
+
+    return 0;
+}
+
+
+/* Hand the premaster decrypt to the workers, session input is held */
+/* until it's done */
+/* returns 0 on success, -1 on error */
+static int QueueDecrypt(SnifferSession* session, const byte* input,
+                        word32 inputSz, const byte* id, char* error)
+{
+    word32      keySz = session->sslServer->buffers.key.length;
+    DecryptJob* job;
+
+    job = (DecryptJob*)malloc(sizeof(DecryptJob) + keySz);
+    if (job == NULL) {
+        SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
+        return -1;
+    }
+    XMEMSET(job, 0, sizeof(DecryptJob));
+    job->context = session->context;
+    job->key     = (byte*)(job + 1);
+    job->keySz   = keySz;
+    job->inputSz = inputSz;
+    XMEMCPY(job->key, session->sslServer->buffers.key.buffer, keySz);
+    XMEMCPY(job->input, input, inputSz);
+    XMEMCPY(job->id, id, PMS_ID_SZ);
+
+    LockMutex(&DecryptMutex);
+    *DecryptQueueTail = job;
+    DecryptQueueTail  = &job->next;
+#ifdef CYASSL_PTHREADS
+    pthread_cond_signal(&DecryptCond);
+#endif
+    UnLockMutex(&DecryptMutex);
+
+    session->pmsJob = job;
+    return 0;
+}
+
+
+/* Process Client Key Exchange, RSA only */
+static int ProcessClientKeyExchange(const byte* input, int size,
+                                    SnifferSession* session, char* error)
+{
+    byte id[PMS_ID_SZ];
+    byte pms[SECRET_LEN];
+    int  length = size;
+    int  ret;
+
+    if (IsTLS(session->sslServer)) {
+        if (size < 2) {
+            SetError(PARTIAL_INPUT_STR, error, session, FATAL_ERROR_STATE);
+            return -1;
+        }
+        length = (input[0] << 8) | input[1];
+        input += 2;     /* tls pre length */
+        size  -= 2;
+    }
+
+    if (length > size || length > ENCRYPT_LEN) {
+        SetError(PARTIAL_INPUT_STR, error, session, FATAL_ERROR_STATE);
+        return -1;
+    }
+
+    /* retransmits and replays decrypt to the same premaster */
+    PmsId(input, length, id);
+    if (GetCachedPms(session->context, id, pms)) {
+        LockStats(session->shard);
+        session->shard->stats.premasterHits++;
+        UnLockStats(session->shard);
+    }
+    else if (DecryptWorkers && session->flags.serverCipherOn == 0)
+        return QueueDecrypt(session, input, length, id, error);
+    else {
+        ret = DecryptPms(session->sslServer->buffers.key.buffer,
+                         session->sslServer->buffers.key.length,
+                         input, length, pms);
+        if (ret != 0) {
+            SetError(ret, error, session, FATAL_ERROR_STATE);
+            return -1;
+        }
+        AddCachedPms(session->context, id, pms);
+    }
+
+    ret = SetPremaster(session, pms, error);
+    XMEMSET(pms, 0, SECRET_LEN);
+
     return ret;
 }
 
@@ -1502,6 +2234,10 @@ static int ProcessServerHello(const byte* input, int* sslBytes,
         XMEMCPY(session->sslClient->arrays->masterSecret,
                session->sslServer->arrays->masterSecret, SECRET_LEN);
         session->flags.resuming = 1;
+
+        LockStats(session->shard);
+        session->shard->stats.resumedSessions++;
+        UnLockStats(session->shard);
         
         Trace(SERVER_DID_RESUMPTION_STR);
         if (SetCipherSpecs(session->sslServer) != 0) {
@@ -1757,8 +2493,15 @@ static int ProcessFinished(const byte* input, int size, int* sslBytes,
     if (ret == 0 && session->flags.cached == 0) {
         if (session->sslServer->options.haveSessionId) {
             CYASSL_SESSION* sess = GetSession(session->sslServer, NULL);
-            if (sess == NULL)
+            if (sess == NULL) {
                 AddSession(session->sslServer);  /* don't re add */
+                if (SessionCb)
+                    SessionCb(session->context->address,
+                              session->context->port,
+                              session->sslServer->arrays->sessionID, ID_LEN,
+                              session->sslServer->arrays->masterSecret,
+                              SECRET_LEN, SessionCbCtx);
+            }
             session->flags.cached = 1;
          }
     }
@@ -1834,7 +2577,7 @@ static int DoHandShake(const byte* input, int* sslBytes,
             break;
         case client_key_exchange:
             Trace(GOT_CLIENT_KEY_EX_STR);
-            ret = ProcessClientKeyExchange(input, sslBytes, session, error);
+            ret = ProcessClientKeyExchange(input, size, session, error);
             break;
         case certificate_verify:
             Trace(GOT_CERT_VER_STR);
@@ -1929,34 +2672,57 @@ static const byte* DecryptMessage(SSL* ssl, const byte* input, word32 sz,
 }
 
 
-/* remove session from table, use rowHint if no info (means we have a lock) */
-static void RemoveSession(SnifferSession* session, IpInfo* ipInfo,
-                        TcpInfo* tcpInfo, word32 rowHint)
+/* Put session in the timer wheel slot of its expiry tick, have a lock */
+static void WheelAdd(SnifferShard* shard, SnifferSession* session)
+{
+    word32 tick = (word32)((session->lastUsed + CYASSL_SNIFFER_TIMEOUT) /
+                           STALE_TICK_SECS) + 1;   /* never early */
+    SnifferSession** slot = &shard->wheel[tick % STALE_WHEEL_SLOTS];
+
+    session->wheelNext = *slot;
+    if (*slot)
+        (*slot)->wheelPrev = &session->wheelNext;
+    session->wheelPrev = slot;
+    *slot = session;
+}
+
+
+static void WheelRemove(SnifferSession* session)
+{
+    if (session->wheelPrev) {
+        *session->wheelPrev = session->wheelNext;
+        if (session->wheelNext)
+            session->wheelNext->wheelPrev = session->wheelPrev;
+        session->wheelPrev = 0;
+        session->wheelNext = 0;
+    }
+}
+
+
+/* remove session from table, haveLock if caller holds the shard lock */
+static void RemoveSession(SnifferSession* session, int haveLock)
 {
+    SnifferShard*   shard = session->shard;
     SnifferSession* previous = 0;
     SnifferSession* current;
-    word32          row = rowHint;
-    int             haveLock = 0;
+    word32          row;
    
-    if (ipInfo && tcpInfo)
-        row = SessionHash(ipInfo, tcpInfo);
-    else
-        haveLock = 1;
-    
-    assert(row <= HASH_SIZE);
     Trace(REMOVE_SESSION_STR);
     
     if (!haveLock)
-        LockMutex(&SessionMutex);
+        LockShard(shard);
     
-    current = SessionTable[row];
+    row = session->hash & (shard->tableSz - 1);
+    current = shard->table[row];
     
     while (current) {
         if (current == session) {
             if (previous)
                 previous->next = current->next;
             else
-                SessionTable[row] = current->next;
+                shard->table[row] = current->next;
+            shard->count--;
+            WheelRemove(session);
             FreeSnifferSession(session);
             TraceRemovedSession();
             break;
@@ -1966,42 +2732,104 @@ static void RemoveSession(SnifferSession* session, IpInfo* ipInfo,
     }
     
     if (!haveLock)
-        UnLockMutex(&SessionMutex);
+        UnLockShard(shard);
 }
 
 
-/* Remove stale sessions from the Session Table, have a lock */
-static void RemoveStaleSessions(void)
+/* Expire the timer wheel slots up to now, have a lock */
+/* sessions used since they went in just move to their new slot */
+static void ExpireSessions(SnifferShard* shard, time_t currTime)
 {
-    word32 i;
-    SnifferSession* session;
-    
-    for (i = 0; i < HASH_SIZE; i++) {
-        session = SessionTable[i];
+    word32 nowTick = (word32)(currTime / STALE_TICK_SECS);
+    int    slots   = STALE_WHEEL_SLOTS;
+
+    if (shard->wheelTick == 0) {
+        shard->wheelTick = nowTick;
+        return;
+    }
+    if ((int)(nowTick - shard->wheelTick) <= 0)
+        return;
+
+    TraceFindingStale();
+
+    while (shard->wheelTick != nowTick) {
+        SnifferSession* session;
+
+        if (slots-- == 0) {
+            shard->wheelTick = nowTick;     /* every slot done, jumped ahead */
+            break;
+        }
+
+        shard->wheelTick++;
+        session = shard->wheel[shard->wheelTick % STALE_WHEEL_SLOTS];
+        shard->wheel[shard->wheelTick % STALE_WHEEL_SLOTS] = 0;
+
         while (session) {
-            SnifferSession* next = session->next; 
-            if (time(NULL) >= session->lastUsed + CYASSL_SNIFFER_TIMEOUT) {
+            SnifferSession* next = session->wheelNext;
+
+            session->wheelPrev = 0;
+            session->wheelNext = 0;
+            if (currTime >= session->lastUsed + CYASSL_SNIFFER_TIMEOUT) {
                 TraceStaleSession();
-                RemoveSession(session, NULL, NULL, i);
+                RemoveSession(session, 1);
             }
+            else
+                WheelAdd(shard, session);
+            session = next;
+        }
+    }
+}
+
+
+/* Double the Session Hash Table once it averages a session a row, or set */
+/* it up on first use, have a lock */
+/* returns 0 on success, -1 on error if there's no table at all */
+static int GrowSessionTable(SnifferShard* shard)
+{
+    word32           newSz = shard->tableSz ? shard->tableSz * 2 :
+                                              CYASSL_SNIFFER_HASH_SIZE;
+    SnifferSession** table;
+    word32           i;
+
+    table = (SnifferSession**)malloc(newSz * sizeof(SnifferSession*));
+    if (table == NULL)
+        return shard->table ? 0 : -1;  /* longer chains, still works */
+
+    XMEMSET(table, 0, newSz * sizeof(SnifferSession*));
+    for (i = 0; i < shard->tableSz; i++) {
+        SnifferSession* session = shard->table[i];
+
+        while (session) {
+            SnifferSession*  next = session->next;
+            SnifferSession** row  = &table[session->hash & (newSz - 1)];
+
+            session->next = *row;
+            *row = session;
             session = next;
         }
     }
+
+    free(shard->table);
+    shard->table   = table;
+    shard->tableSz = newSz;
+
+    return 0;
 }
 
 
 /* Create a new Sniffer Session */
-static SnifferSession* CreateSession(IpInfo* ipInfo, TcpInfo* tcpInfo,
-                                     char* error)
+static SnifferSession* CreateSession(SnifferShard* shard, IpInfo* ipInfo,
+                                     TcpInfo* tcpInfo, char* error)
 {
     SnifferSession* session = 0;
-    int row;
+    SnifferSession** row;
+    int ret = 0;
         
     Trace(NEW_SESSION_STR);
     /* create a new one */
     session = (SnifferSession*)malloc(sizeof(SnifferSession));
     if (session == NULL) {
-        SetError(MEMORY_STR, error, NULL, 0);
+        SetShardError(MEMORY_STR, error, shard);
         return 0;
     }
     InitSession(session);
@@ -2009,13 +2837,15 @@ static SnifferSession* CreateSession(IpInfo* ipInfo, TcpInfo* tcpInfo,
     session->client  = ipInfo->src;
     session->srvPort = (word16)tcpInfo->dstPort;
     session->cliPort = (word16)tcpInfo->srcPort;
+    session->shard   = shard;
+    session->hash    = SessionHash(ipInfo, tcpInfo);
     session->cliSeqStart = tcpInfo->sequence;
     session->cliExpected = 1;  /* relative */
-    session->lastUsed= time(NULL);
+    session->lastUsed= (time_t)LowResTimer();
                 
     session->context = GetSnifferServer(ipInfo, tcpInfo);
     if (session->context == NULL) {
-        SetError(SERVER_NOT_REG_STR, error, NULL, 0);
+        SetShardError(SERVER_NOT_REG_STR, error, shard);
         free(session);
         return 0;
     }
@@ -2038,22 +2868,34 @@ static SnifferSession* CreateSession(IpInfo* ipInfo, TcpInfo* tcpInfo,
     /* put server back into server mode */
     session->sslServer->options.side = CYASSL_SERVER_END;
         
-    row = SessionHash(ipInfo, tcpInfo);
-    
     /* add it to the session table */
-    LockMutex(&SessionMutex);
+    LockShard(shard);
         
-    session->next = SessionTable[row];
-    SessionTable[row] = session;
-    
-    SessionCount++;
-    
-    if ( (SessionCount % HASH_SIZE) == 0) {
-        TraceFindingStale();
-        RemoveStaleSessions();
+    if (shard->count >= shard->tableSz)
+        ret = GrowSessionTable(shard);
+
+    if (ret == 0) {
+        row = &shard->table[session->hash & (shard->tableSz - 1)];
+        session->next = *row;
+        *row = session;
+        shard->count++;
+
+        WheelAdd(shard, session);
+        ExpireSessions(shard, session->lastUsed);
     }
         
-    UnLockMutex(&SessionMutex);
+    UnLockShard(shard);
+
+    if (ret == 0) {
+        LockStats(shard);
+        shard->stats.sessions++;
+        UnLockStats(shard);
+    }
+    else {
+        SetShardError(MEMORY_STR, error, shard);
+        FreeSnifferSession(session);
+        return 0;
+    }
         
     /* determine headed side */
     if (ipInfo->dst == session->context->server &&
@@ -2166,32 +3008,34 @@ int TcpChecksum(IpInfo* ipInfo, TcpInfo* tcpInfo, int dataLen,
 
 /* Check IP and TCP headers, set payload */
 /* returns 0 on success, -1 on error */
-static int CheckHeaders(IpInfo* ipInfo, TcpInfo* tcpInfo, const byte* packet,
-                  int length, const byte** sslFrame, int* sslBytes, char* error)
+static int CheckHeaders(SnifferShard* shard, IpInfo* ipInfo, TcpInfo* tcpInfo,
+                        const byte* packet, int length, const byte** sslFrame,
+                        int* sslBytes, char* error)
 {
     TraceHeader();
     TracePacket();
 
     /* ip header */
     if (length < IP_HDR_SZ) {
-        SetError(PACKET_HDR_SHORT_STR, error, NULL, 0);
+        SetShardError(PACKET_HDR_SHORT_STR, error, shard);
         return -1;
     }
-    if (CheckIpHdr((IpHdr*)packet, ipInfo, length, error) != 0)
+    if (CheckIpHdr(shard, (IpHdr*)packet, ipInfo, length, error) != 0)
         return -1;
    
     /* tcp header */ 
     if (length < (ipInfo->length + TCP_HDR_SZ)) {
-        SetError(PACKET_HDR_SHORT_STR, error, NULL, 0);
+        SetShardError(PACKET_HDR_SHORT_STR, error, shard);
         return -1;
     }
-    if (CheckTcpHdr((TcpHdr*)(packet + ipInfo->length), tcpInfo, error) != 0)
+    if (CheckTcpHdr(shard, (TcpHdr*)(packet + ipInfo->length), tcpInfo,
+                    error) != 0)
         return -1;
    
     /* setup */ 
     *sslFrame = packet + ipInfo->length + tcpInfo->length;
     if (*sslFrame > packet + length) {
-        SetError(PACKET_HDR_SHORT_STR, error, NULL, 0);
+        SetShardError(PACKET_HDR_SHORT_STR, error, shard);
         return -1;
     }
     *sslBytes = (int)(packet + length - *sslFrame);
@@ -2202,27 +3046,27 @@ static int CheckHeaders(IpInfo* ipInfo, TcpInfo* tcpInfo, const byte* packet,
 
 /* Create or Find existing session */
 /* returns 0 on success (continue), -1 on error, 1 on success (end) */
-static int CheckSession(IpInfo* ipInfo, TcpInfo* tcpInfo, int sslBytes,
-                        SnifferSession** session, char* error)
+static int CheckSession(SnifferShard* shard, IpInfo* ipInfo, TcpInfo* tcpInfo,
+                        int sslBytes, SnifferSession** session, char* error)
 {
     /* create a new SnifferSession on client SYN */
     if (tcpInfo->syn && !tcpInfo->ack) {
         TraceClientSyn(tcpInfo->sequence);
-        *session = CreateSession(ipInfo, tcpInfo, error);
+        *session = CreateSession(shard, ipInfo, tcpInfo, error);
         if (*session == NULL) {
-            *session = GetSnifferSession(ipInfo, tcpInfo);
+            *session = GetSnifferSession(shard, ipInfo, tcpInfo);
             /* already had exisiting, so OK */
             if (*session)
                 return 1;
             
-            SetError(MEMORY_STR, error, NULL, 0);
+            SetShardError(MEMORY_STR, error, shard);
             return -1;
         }
         return 1;
     }
     /* get existing sniffer session */
     else {
-        *session = GetSnifferSession(ipInfo, tcpInfo);
+        *session = GetSnifferSession(shard, ipInfo, tcpInfo);
         if (*session == NULL) {
             /* don't worry about extraneous RST or duplicate FINs */
             if (tcpInfo->fin || tcpInfo->rst)
@@ -2231,7 +3075,7 @@ static int CheckSession(IpInfo* ipInfo, TcpInfo* tcpInfo, int sslBytes,
             if (sslBytes == 0 && tcpInfo->ack)
                 return 1;
             
-            SetError(BAD_SESSION_STR, error, NULL, 0);
+            SetShardError(BAD_SESSION_STR, error, shard);
             return -1;
         }        
     }
@@ -2239,114 +3083,174 @@ static int CheckSession(IpInfo* ipInfo, TcpInfo* tcpInfo, int sslBytes,
 }
 
 
-/* Create a Packet Buffer from *begin - end, adjust new *begin and bytesLeft */
-static PacketBuffer* CreateBuffer(word32* begin, word32 end, const byte* data,
-                                  int* bytesLeft)
+/* Create a Packet Buffer for begin - end, from the pool if it fits */
+static PacketBuffer* CreateBuffer(SnifferShard* shard, word32 begin,
+                                  word32 end, const byte* data)
 {
     PacketBuffer* pb;
-    
-    int added = end - *begin + 1;
-    assert(*begin <= end);
-    
-    pb = (PacketBuffer*)malloc(sizeof(PacketBuffer));
-    if (pb == NULL) return NULL;
-    
+    word32        added = end - begin + 1;
+    word32        cap   = added > REASSEMBLY_CHUNK ? added : REASSEMBLY_CHUNK;
+
+    assert(begin <= end);
+
+    if (cap == REASSEMBLY_CHUNK && shard->pool) {
+        pb = shard->pool;
+        shard->pool = pb->next;
+        shard->poolCount--;
+    }
+    else {
+        pb = (PacketBuffer*)malloc(sizeof(PacketBuffer) + cap);
+        if (pb == NULL) return NULL;
+        pb->data = (byte*)(pb + 1);
+        pb->cap  = cap;
+    }
+
     pb->next  = 0;
-    pb->begin = *begin;
+    pb->begin = begin;
     pb->end   = end;
-    pb->data = (byte*)malloc(added);
-    
-    if (pb->data == NULL) {
-        free(pb);
-        return NULL;
-    }
     XMEMCPY(pb->data, data, added);
-    
-    *bytesLeft -= added;
-    *begin      = pb->end + 1;
-    
+
     return pb;
 }
 
 
-/* Add sslFrame to Reassembly List */
-/* returns 1 (end) on success, -1, on error */
-static int AddToReassembly(byte from, word32 seq, const byte* sslFrame,
-                           int sslBytes, SnifferSession* session, char* error)
+/* Make room for bytes more out of order data on session, over the table */
+/* cap the oldest holders lose theirs, a shared table can't touch others */
+/* returns 0 on success, -1 on error */
+static int ReserveReassembly(SnifferSession* session, word32 bytes,
+                             char* error)
 {
-    PacketBuffer*  add;
-    PacketBuffer** front = (from == CYASSL_SERVER_END) ?
-                       &session->cliReassemblyList: &session->srvReassemblyList;
-    PacketBuffer*  curr = *front;
-    PacketBuffer*  prev = curr;
-    
-    word32  startSeq = seq;
-    word32  added;
-    int     bytesLeft = sslBytes;  /* could be overlapping fragment */
+    SnifferShard* shard = session->shard;
+    int           ret = 0;
 
-    /* if list is empty add full frame to front */
-    if (!curr) {
-        add = CreateBuffer(&seq, seq + sslBytes - 1, sslFrame, &bytesLeft);
-        if (add == NULL) {
-            SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
-            return -1;
+    if (session->reassemblyBytes + bytes > CYASSL_SNIFFER_FLOW_MAX) {
+        SetError(REASSEMBLY_MAX_STR, error, session, FATAL_ERROR_STATE);
+        return -1;
+    }
+
+    LockReassembly(shard);
+    while (shard->reassemblyBytes + bytes > CYASSL_SNIFFER_REASSEMBLY_MAX) {
+        SnifferSession* oldest = shard->heldHead;
+
+        if (oldest == session)
+            oldest = oldest->heldNext;
+        if (oldest == NULL || shard->locked) {
+            ret = -1;
+            break;
         }
-        *front = add;
-        return 1;
+
+        /* its stream has a hole now, done on its next packet */
+        FreeReassembly(oldest);
+        oldest->flags.fatalError = FATAL_ERROR_STATE;
     }
-    
-    /* add to front if before current front, up to next->begin */
-    if (seq < curr->begin) {
-        word32 end = seq + sslBytes - 1;
-        
-        if (end >= curr->begin)
-            end = curr->begin - 1;
-        
-        add = CreateBuffer(&seq, end, sslFrame, &bytesLeft);
-        if (add == NULL) {
-            SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
+    UnLockReassembly(shard);
+
+    if (ret != 0)
+        SetError(REASSEMBLY_MAX_STR, error, session, FATAL_ERROR_STATE);
+
+    return ret;
+}
+
+
+/* Add seq - end to the list after *prev, on the end of *prev if it's */
+/* contiguous and has room, *prev set to where the data went */
+/* returns 0 on success, -1 on error */
+static int AddInterval(SnifferSession* session, PacketBuffer** front,
+                       PacketBuffer** tail, PacketBuffer** prev, word32 seq,
+                       word32 end, const byte* data)
+{
+    PacketBuffer* pb = *prev;
+    word32        added = end - seq + 1;
+
+    if (pb && pb->end + 1 == seq &&
+                              pb->cap - (pb->end - pb->begin + 1) >= added) {
+        XMEMCPY(pb->data + (pb->end - pb->begin + 1), data, added);
+        pb->end = end;
+    }
+    else {
+        pb = CreateBuffer(session->shard, seq, end, data);
+        if (pb == NULL)
             return -1;
+
+        if (*prev) {
+            pb->next = (*prev)->next;
+            (*prev)->next = pb;
         }
-        add->next = curr;
-        *front = add;
+        else {
+            pb->next = *front;
+            *front = pb;
+        }
+        if (pb->next == NULL)
+            *tail = pb;
+        *prev = pb;
     }
-    
-    /* while we have bytes left, try to find a gap to fill */
-    while (bytesLeft > 0) {
-        /* get previous packet in list */
-        while (curr && (seq >= curr->begin)) {
+
+    HoldReassembly(session, (int)added);
+
+    return 0;
+}
+
+
+/* Add sslFrame to Reassembly List, keeping only bytes we don't have */
+/* returns 1 (end) on success, -1, on error */
+static int AddToReassembly(byte from, word32 seq, const byte* sslFrame,
+                           int sslBytes, SnifferSession* session, char* error)
+{
+    PacketBuffer** front = (from == CYASSL_SERVER_END) ?
+                       &session->cliReassemblyList: &session->srvReassemblyList;
+    PacketBuffer** tail  = (from == CYASSL_SERVER_END) ?
+                       &session->cliReassemblyTail: &session->srvReassemblyTail;
+    PacketBuffer*  prev = 0;             /* last interval begining <= seq */
+    PacketBuffer*  curr = *front;        /* next interval */
+    word32         startSeq = seq;
+    word32         last;
+
+    if (sslBytes <= 0)
+        return 1;
+    last = seq + sslBytes - 1;
+
+    if (ReserveReassembly(session, sslBytes, error) != 0)
+        return -1;
+
+    /* usually past everything held, otherwise find the spot */
+    if (*tail && seq > (*tail)->end) {
+        prev = *tail;
+        curr = 0;
+    }
+    else {
+        while (curr && curr->begin <= seq) {
             prev = curr;
             curr = curr->next;
         }
-        
-        /* don't add  duplicate data */
-        if (prev->end >= seq) {
-            if ( (seq + bytesLeft - 1) <= prev->end)
-                return 1;
+    }
+
+    /* fill the gaps between held intervals */
+    while (seq - startSeq < (word32)sslBytes) {
+        word32 end = last;
+
+        /* don't add duplicate data */
+        if (prev && prev->end >= seq) {
+            if (prev->end >= last)
+                break;
             seq = prev->end + 1;
-            bytesLeft = startSeq + sslBytes - seq;
         }
-        
-        if (!curr)
-            /* we're at the end */
-            added = bytesLeft;
-        else 
-            /* we're in between two frames */
-            added = min((word32)bytesLeft, curr->begin - seq);
-        
-        /* data already there */
-        if (added == 0)
+        if (curr && curr->begin <= seq) {
+            prev = curr;
+            curr = curr->next;
             continue;
-        
-        add = CreateBuffer(&seq, seq + added - 1, &sslFrame[seq - startSeq],
-                           &bytesLeft);
-        if (add == NULL) {
+        }
+
+        if (curr && curr->begin <= last)
+            end = curr->begin - 1;
+
+        if (AddInterval(session, front, tail, &prev, seq, end,
+                        &sslFrame[seq - startSeq]) != 0) {
             SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
             return -1;
         }
-        add->next  = prev->next;
-        prev->next = add;
+        seq = end + 1;
     }
+
     return 1;
 }
 
@@ -2494,7 +3398,7 @@ static int CheckSequence(IpInfo* ipInfo, TcpInfo* tcpInfo,
 
 /* Check Status before record processing */
 /* returns 0 on success (continue), -1 on error, 1 on success (end) */
-static int CheckPreRecord(IpInfo* ipInfo, TcpInfo* tcpInfo,
+static int CheckPreRecord(TcpInfo* tcpInfo,
                           const byte** sslFrame, SnifferSession** session,
                           int* sslBytes, const byte** end, char* error)
 {
@@ -2510,14 +3414,14 @@ static int CheckPreRecord(IpInfo* ipInfo, TcpInfo* tcpInfo,
             (*session)->flags.finCount += 2;
         
         if ((*session)->flags.finCount >= 2) {
-            RemoveSession(*session, ipInfo, tcpInfo, 0);
+            RemoveSession(*session, 0);
             *session = NULL;
             return 1;
         }
     }
     
     if ((*session)->flags.fatalError == FATAL_ERROR_STATE) {
-        SetError(FATAL_ERROR_STR, error, NULL, 0);
+        SetError(FATAL_ERROR_STR, error, *session, 0);
         return -1;
     }
     
@@ -2577,6 +3481,8 @@ static int HaveMoreInput(SnifferSession* session, const byte** sslFrame,
     int            moreInput = 0;
     PacketBuffer** front = (session->flags.side == CYASSL_SERVER_END) ?
                       &session->cliReassemblyList : &session->srvReassemblyList;
+    PacketBuffer** tail  = (session->flags.side == CYASSL_SERVER_END) ?
+                      &session->cliReassemblyTail : &session->srvReassemblyTail;
     word32*        expected = (session->flags.side == CYASSL_SERVER_END) ?
                                   &session->cliExpected : &session->srvExpected;
     /* buffer is on receiving end */
@@ -2601,6 +3507,10 @@ static int HaveMoreInput(SnifferSession* session, const byte** sslFrame,
                 SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
                 return 0;
             }
+            /* buffer moved, pick up new location and size */
+            myBuffer   = ssl->buffers.inputBuffer.buffer;
+            bufferSize = ssl->buffers.inputBuffer.bufferSize;
+            room       = bufferSize - *length;
         }
         
         if (packetLen <= room) {
@@ -2612,7 +3522,10 @@ static int HaveMoreInput(SnifferSession* session, const byte** sslFrame,
             
             /* remove used packet */
             *front = (*front)->next;
-            FreePacketBuffer(del);
+            if (*front == NULL)
+                *tail = NULL;
+            FreePacketBuffer(session->shard, del);
+            HoldReassembly(session, -(int)packetLen);
             
             moreInput = 1;
         }
@@ -2629,6 +3542,120 @@ static int HaveMoreInput(SnifferSession* session, const byte** sslFrame,
                          
 
 
+/* Add sz bytes headed to side to the session's held input */
+/* returns the new PendingData, 0 on error */
+static PendingData* AddPending(SnifferSession* session, word32 sz,
+                               char* error)
+{
+    PendingData* pend;
+
+    if (session->pendingBytes + sz > CYASSL_SNIFFER_PENDING_MAX) {
+        SetError(PENDING_MAX_STR, error, session, FATAL_ERROR_STATE);
+        return 0;
+    }
+
+    pend = (PendingData*)malloc(sizeof(PendingData) + sz);
+    if (pend == NULL) {
+        SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
+        return 0;
+    }
+    pend->data = (byte*)(pend + 1);
+    pend->sz   = sz;
+    pend->side = session->flags.side;
+    pend->next = 0;
+
+    if (session->pendingTail)
+        session->pendingTail->next = pend;
+    else
+        session->pendingHead = pend;
+    session->pendingTail   = pend;
+    session->pendingBytes += sz;
+
+    return pend;
+}
+
+
+/* Hold the in order reassembly data of the current side too, it would */
+/* otherwise be taken ahead of what is held */
+/* returns 0 on success, -1 on error */
+static int HoldReadyInput(SnifferSession* session, char* error)
+{
+    PacketBuffer** front = (session->flags.side == CYASSL_SERVER_END) ?
+                      &session->cliReassemblyList : &session->srvReassemblyList;
+    PacketBuffer** tail  = (session->flags.side == CYASSL_SERVER_END) ?
+                      &session->cliReassemblyTail : &session->srvReassemblyTail;
+    word32*        expected = (session->flags.side == CYASSL_SERVER_END) ?
+                                  &session->cliExpected : &session->srvExpected;
+
+    while (*front && ((*front)->begin == *expected) ) {
+        PacketBuffer* del = *front;
+        word32 packetLen = del->end - del->begin + 1;
+        PendingData* pend = AddPending(session, packetLen, error);
+        if (pend == NULL)
+            return -1;
+
+        XMEMCPY(pend->data, del->data, packetLen);
+        *expected += packetLen;
+
+        *front = del->next;
+        if (*front == NULL)
+            *tail = NULL;
+        FreePacketBuffer(session->shard, del);
+        HoldReassembly(session, -(int)packetLen);
+    }
+
+    return 0;
+}
+
+
+/* Hold sslBytes of sslFrame for the current side until the premaster is */
+/* decrypted, the side's partial input is already at the front of it */
+/* returns 0 on success, -1 on error */
+static int HoldInput(SnifferSession* session, const byte* sslFrame,
+                     int sslBytes, char* error)
+{
+    SSL* ssl = (session->flags.side == CYASSL_SERVER_END) ?
+                                        session->sslServer : session->sslClient;
+
+    if (sslBytes > 0) {
+        PendingData* pend = AddPending(session, sslBytes, error);
+        if (pend == NULL)
+            return -1;
+        XMEMCPY(pend->data, sslFrame, sslBytes);
+    }
+    ssl->buffers.inputBuffer.length = 0;
+
+    return HoldReadyInput(session, error);
+}
+
+
+/* Hold what follows the ClientKeyExchange at msg, messages left in its */
+/* record get a record header of their own */
+/* returns 0 on success, -1 on error */
+static int HoldRecordRest(SnifferSession* session, const RecordLayerHeader* rh,
+                          const byte* msg, const byte* recordEnd,
+                          const byte* end, char* error)
+{
+    word32       rest = (word32)(recordEnd - msg);
+    PendingData* pend;
+
+    if (rest == 0)
+        return HoldInput(session, msg, (int)(end - msg), error);
+
+    pend = AddPending(session, RECORD_HEADER_SZ + (word32)(end - msg), error);
+    if (pend == NULL)
+        return -1;
+    pend->data[0] = rh->type;
+    pend->data[1] = rh->pvMajor;
+    pend->data[2] = rh->pvMinor;
+    pend->data[3] = (byte)(rest >> 8);
+    pend->data[4] = (byte)rest;
+    XMEMCPY(pend->data + RECORD_HEADER_SZ, msg, end - msg);
+
+    return HoldInput(session, NULL, 0, error);
+}
+
+
 /* Process Message(s) from sslFrame */
 /* return Number of bytes on success, 0 for no data yet, and -1 on error */
 static int ProcessMessage(const byte* sslFrame, SnifferSession* session,
@@ -2690,7 +3717,9 @@ doMessage:
                                                session->flags.serverCipherOn)
      || (session->flags.side == CYASSL_CLIENT_END &&
                                                session->flags.clientCipherOn)) {
-        int ivAdvance = 0;  /* TLSv1.1 advance amount */
+        int    ivAdvance = 0;  /* TLSv1.1 advance amount */
+        double start;
+
         if (ssl->decrypt.setup != 1) {
             SetError(DECRYPT_KEYS_NOT_SETUP, error, session, FATAL_ERROR_STATE);
             return -1;
@@ -2699,9 +3728,11 @@ doMessage:
             SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
             return -1;
         }
+        start = StageTime();
         sslFrame = DecryptMessage(ssl, sslFrame, rhSize,
                                   ssl->buffers.outputBuffer.buffer, &errCode,
                                   &ivAdvance);
+        AddStageTime(session->shard, &session->shard->stats.decryptSecs,start);
         recordEnd = sslFrame - ivAdvance + rhSize;  /* sslFrame moved so
                                                        should recordEnd */
         decrypted = 1;
@@ -2716,11 +3747,14 @@ doPart:
     switch ((enum ContentType)rh.type) {
         case handshake:
             {
-                int startIdx = sslBytes;
-                int used;
+                int    startIdx = sslBytes;
+                int    used;
+                double start = StageTime();
 
                 Trace(GOT_HANDSHAKE_STR);
                 ret = DoHandShake(sslFrame, &sslBytes, session, error);
+                AddStageTime(session->shard,
+                             &session->shard->stats.handshakeSecs, start);
                 if (ret != 0) {
                     if (session->flags.fatalError == 0)
                         SetError(BAD_HANDSHAKE_STR, error, session,
@@ -2733,6 +3767,14 @@ doPart:
                 sslFrame += used;
                 if (decrypted)
                     sslFrame += ssl->keys.padSz;
+
+                /* premaster went to the workers, the rest waits for it */
+                if (session->pmsJob) {
+                    if (HoldRecordRest(session, &rh, sslFrame, recordEnd, end,
+                                       error) != 0)
+                        return -1;
+                    return decoded;
+                }
             }
             break;
         case change_cipher_spec:
@@ -2758,8 +3800,14 @@ doPart:
                     ret = ssl->buffers.clearOutputBuffer.length;
                     TraceGotData(ret);
                     if (ret) {  /* may be blank message */
-                        XMEMCPY(&data[decoded],
-                               ssl->buffers.clearOutputBuffer.buffer, ret);
+                        if (data)
+                            XMEMCPY(&data[decoded],
+                                   ssl->buffers.clearOutputBuffer.buffer, ret);
+                        else if (session->dataCb) /* batch, no copy */
+                            session->dataCb(
+                                   ssl->buffers.clearOutputBuffer.buffer, ret,
+                                   session->flags.side == CYASSL_CLIENT_END,
+                                   &session->flowCtx, session->dataCtx);
                         TraceAddedData(ret, decoded);
                         decoded += ret;
                         ssl->buffers.clearOutputBuffer.length = 0;
@@ -2818,9 +3866,93 @@ doPart:
 }
 
 
+/* Has the session's premaster decrypt finished */
+/* returns 1 for TRUE, 0 for FALSE */
+static int PmsJobDone(SnifferSession* session)
+{
+    int done;
+
+    LockMutex(&DecryptMutex);
+    done = session->pmsJob->done;
+    UnLockMutex(&DecryptMutex);
+
+    return done;
+}
+
+
+/* Set the keys from the finished premaster decrypt and decode the input */
+/* held meanwhile, its data goes to the flow's callback or DecryptDataCb */
+/* returns Number of bytes decoded, -1 on error */
+static int FinishDecrypt(SnifferSession* session, char* error)
+{
+    DecryptJob* job  = session->pmsJob;
+    byte        side = session->flags.side;
+    int         decoded = 0;
+    int         ret;
+
+    session->pmsJob = 0;
+    if (job->ret != 0) {
+        SetError(job->ret, error, session, FATAL_ERROR_STATE);
+        free(job);
+        return -1;
+    }
+    ret = SetPremaster(session, job->pms, error);
+    XMEMSET(job->pms, 0, SECRET_LEN);
+    free(job);
+    if (ret != 0)
+        return -1;
+
+    if (session->dataCb == NULL) {
+        session->dataCb  = DecryptDataCb;
+        session->dataCtx = DecryptDataCtx;
+    }
+
+    while (session->pendingHead) {
+        PendingData* pend  = session->pendingHead;
+        const byte*  frame = pend->data;
+        int          bytes = (int)pend->sz;
+        word32       length;
+        SSL*         ssl;
+
+        session->flags.side = pend->side;
+        ssl = (pend->side == CYASSL_SERVER_END) ? session->sslServer :
+                                                  session->sslClient;
+
+        /* as CheckPreRecord, a partial record goes in front */
+        if ( (length = ssl->buffers.inputBuffer.length) ) {
+            if (bytes + length > ssl->buffers.inputBuffer.bufferSize) {
+                if (GrowInputBuffer(ssl, bytes, length) < 0) {
+                    SetError(MEMORY_STR, error, session, FATAL_ERROR_STATE);
+                    ret = -1;
+                    break;
+                }
+            }
+            XMEMCPY(&ssl->buffers.inputBuffer.buffer[length], frame, bytes);
+            bytes += length;
+            ssl->buffers.inputBuffer.length = bytes;
+            frame = ssl->buffers.inputBuffer.buffer;
+        }
+
+        ret = ProcessMessage(frame, session, bytes, NULL, frame + bytes,
+                             error);
+
+        session->pendingHead   = pend->next;
+        session->pendingBytes -= pend->sz;
+        free(pend);
+        if (ret < 0)
+            break;
+        decoded += ret;
+    }
+    if (session->pendingHead == NULL)
+        session->pendingTail = 0;
+    session->flags.side = side;
+
+    return ret < 0 ? -1 : decoded;
+}
+
+
 /* See if we need to process any pending FIN captures */
-static void CheckFinCapture(IpInfo* ipInfo, TcpInfo* tcpInfo, 
-                            SnifferSession* session)
+static void CheckFinCapture(SnifferSession* session)
 {
     if (session->finCaputre.cliFinSeq && session->finCaputre.cliFinSeq <= 
                                          session->cliExpected) {
@@ -2841,27 +3973,31 @@ static void CheckFinCapture(IpInfo* ipInfo, TcpInfo* tcpInfo,
     }
                 
     if (session->flags.finCount >= 2) 
-        RemoveSession(session, ipInfo, tcpInfo, 0);
+        RemoveSession(session, 0);
 }
 
 
 /* If session is in fatal error state free resources now 
    return true if removed, 0 otherwise */
-static int RemoveFatalSession(IpInfo* ipInfo, TcpInfo* tcpInfo,
-                              SnifferSession* session, char* error)
+static int RemoveFatalSession(SnifferSession* session, char* error)
 {
     if (session && session->flags.fatalError == FATAL_ERROR_STATE) {
-        RemoveSession(session, ipInfo, tcpInfo, 0);
-        SetError(FATAL_ERROR_STR, error, NULL, 0);
+        SnifferShard* shard = session->shard;
+
+        RemoveSession(session, 0);
+        SetShardError(FATAL_ERROR_STR, error, shard);
         return 1;
     }
     return 0;
 }
 
 
-/* Passes in an IP/TCP packet for decoding (ethernet/localhost frame) removed */
+/* Decode an IP/TCP packet against a Session Table, into data or if that's */
+/* NULL through cb */
 /* returns Number of bytes on success, 0 for no data yet, and -1 on error */
-int ssl_DecodePacket(const byte* packet, int length, byte* data, char* error)
+static int DecodePacket(SnifferShard* shard, const byte* packet, int length,
+                        byte* data, SSLSnifferDataCb cb, void* cbCtx,
+                        char* error)
 {
     TcpInfo           tcpInfo;
     IpInfo            ipInfo;
@@ -2871,33 +4007,401 @@ int ssl_DecodePacket(const byte* packet, int length, byte* data, char* error)
     int               ret;
     SnifferSession*   session = 0;
 
-    if (CheckHeaders(&ipInfo, &tcpInfo, packet, length, &sslFrame, &sslBytes,
-                     error) != 0)
+    LockStats(shard);
+    shard->stats.packets++;
+    shard->stats.packetBytes += length;
+    UnLockStats(shard);
+
+    if (CheckHeaders(shard, &ipInfo, &tcpInfo, packet, length, &sslFrame,
+                     &sslBytes, error) != 0)
         return -1;
     
-    ret = CheckSession(&ipInfo, &tcpInfo, sslBytes, &session, error);
-    if (RemoveFatalSession(&ipInfo, &tcpInfo, session, error)) return -1;
+    ret = CheckSession(shard, &ipInfo, &tcpInfo, sslBytes, &session, error);
+    if (RemoveFatalSession(session, error)) return -1;
     else if (ret == -1) return -1;
     else if (ret ==  1) return  0;   /* done for now */
     
     ret = CheckSequence(&ipInfo, &tcpInfo, session, &sslBytes, &sslFrame,error);
-    if (RemoveFatalSession(&ipInfo, &tcpInfo, session, error)) return -1;
+    if (RemoveFatalSession(session, error)) return -1;
     else if (ret == -1) return -1;
     else if (ret ==  1) return  0;   /* done for now */
     
-    ret = CheckPreRecord(&ipInfo, &tcpInfo, &sslFrame, &session, &sslBytes,
+    ret = CheckPreRecord(&tcpInfo, &sslFrame, &session, &sslBytes,
                          &end, error);
-    if (RemoveFatalSession(&ipInfo, &tcpInfo, session, error)) return -1;
+    if (RemoveFatalSession(session, error)) return -1;
     else if (ret == -1) return -1;
     else if (ret ==  1) return  0;   /* done for now */
 
+    if (data == NULL) {
+        session->dataCb  = cb;
+        session->dataCtx = cbCtx;
+    }
+
+    if (session->pmsJob) {
+        /* still decrypting, this input waits behind the rest */
+        if (!PmsJobDone(session)) {
+            HoldInput(session, sslFrame, sslBytes, error);
+            if (RemoveFatalSession(session, error)) return -1;
+            return 0;
+        }
+        ret = FinishDecrypt(session, error);
+        if (RemoveFatalSession(session, error)) return -1;
+        if (ret > 0) {
+            LockStats(shard);
+            shard->stats.decodedBytes += ret;
+            UnLockStats(shard);
+        }
+    }
+
     ret = ProcessMessage(sslFrame, session, sslBytes, data, end, error);
-    if (RemoveFatalSession(&ipInfo, &tcpInfo, session, error)) return -1;
-    CheckFinCapture(&ipInfo, &tcpInfo, session);
+    if (RemoveFatalSession(session, error)) return -1;
+    if (ret > 0) {
+        LockStats(shard);
+        shard->stats.decodedBytes += ret;
+        UnLockStats(shard);
+    }
+    CheckFinCapture(session);
     return ret;
 }
 
 
+/* Passes in an IP/TCP packet for decoding (ethernet/localhost frame) removed */
+/* returns Number of bytes on success, 0 for no data yet, and -1 on error */
+int ssl_DecodePacket(const byte* packet, int length, byte* data, char* error)
+{
+    return DecodePacket(&SessionShard, packet, length, data, NULL, NULL,
+                        error);
+}
+
+
+/* Decode a batch of packets against a Session Table */
+/* returns number of packets in error, error holds the last message */
+static int DecodePacketBatch(SnifferShard* shard,
+                             const SSLSnifferPacket* packets, int count,
+                             SSLSnifferDataCb cb, void* ctx, char* error)
+{
+    int i;
+    int bad = 0;
+
+    if (packets == NULL || cb == NULL || count < 0) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+        if (DecodePacket(shard, packets[i].packet, packets[i].length, NULL,
+                         cb, ctx, error) < 0)
+            bad++;
+
+    return bad;
+}
+
+
+/* Passes in count IP/TCP packets, decoded data goes to cb pointing into */
+/* our buffers, valid until cb returns, no copy */
+/* returns number of packets in error, error holds the last message, */
+/* -1 on bad input */
+int ssl_DecodePacketBatch(const SSLSnifferPacket* packets, int count,
+                          SSLSnifferDataCb cb, void* ctx, char* error)
+{
+    return DecodePacketBatch(&SessionShard, packets, count, cb, ctx, error);
+}
+
+
+/* Add shard's counters and current sizes to stats */
+static void SumStats(SnifferShard* shard, SSLStats* stats)
+{
+    int i;
+
+    LockStats(shard);
+    stats->packets         += shard->stats.packets;
+    stats->packetBytes     += shard->stats.packetBytes;
+    stats->decodedBytes    += shard->stats.decodedBytes;
+    stats->sessions        += shard->stats.sessions;
+    stats->resumedSessions += shard->stats.resumedSessions;
+    stats->handshakeSecs   += shard->stats.handshakeSecs;
+    stats->decryptSecs     += shard->stats.decryptSecs;
+    stats->premasterHits   += shard->stats.premasterHits;
+    for (i = 0; i < SSL_SNIFFER_MAX_ERRORS; i++)
+        stats->errors[i] += shard->stats.errors[i];
+    UnLockStats(shard);
+
+    LockShard(shard);
+    stats->activeSessions += shard->count;
+    UnLockShard(shard);
+
+    LockReassembly(shard);
+    stats->reassemblyBytes += shard->reassemblyBytes;
+    UnLockReassembly(shard);
+}
+
+
+/* Fills stats with totals over all Session Tables */
+/* returns 0 on success, -1 on error */
+int ssl_ReadStatistics(SSLStats* stats)
+{
+    int i;
+
+    if (stats == NULL)
+        return -1;
+
+    XMEMSET(stats, 0, sizeof(SSLStats));
+
+    SumStats(&SessionShard, stats);
+    for (i = 0; i < ShardCount; i++)
+        SumStats(&Shards[i], stats);
+
+    return 0;
+}
+
+
+/* Sets up count worker Session Tables, call once keys are set and before */
+/* the workers start, the Server List can't change after this */
+/* returns 0 on success, -1 on error */
+int ssl_SetShards(int count, char* error)
+{
+    int ret = 0;
+
+    if (count <= 0) {
+        SetError(BAD_SHARD_STR, error, NULL, 0);
+        return -1;
+    }
+
+    LockMutex(&ServerListMutex);
+    if (ShardCount) {
+        SetError(SHARDS_RUNNING_STR, error, NULL, 0);
+        ret = -1;
+    }
+    else {
+        Shards = (SnifferShard*)malloc(count * sizeof(SnifferShard));
+        if (Shards == NULL) {
+            SetError(MEMORY_STR, error, NULL, 0);
+            ret = -1;
+        }
+        else {
+            XMEMSET(Shards, 0, count * sizeof(SnifferShard));
+            ShardCount = count;
+        }
+    }
+    UnLockMutex(&ServerListMutex);
+
+    return ret;
+}
+
+
+/* Picks the worker shard for an IP/TCP packet, both directions of a */
+/* connection map to the same shard */
+/* returns shard index, or -1 if no shards or not IPv4/TCP */
+int ssl_GetPacketShard(const byte* packet, int length)
+{
+    IpHdr*  iphdr = (IpHdr*)packet;
+    TcpHdr* tcphdr;
+    int     ipLen;
+    word32  hash;
+
+    if (ShardCount == 0 || length < IP_HDR_SZ)
+        return -1;
+
+    ipLen = IP_HL(iphdr);
+    if (IP_V(iphdr) != IPV4 || iphdr->protocol != TCP_PROTOCOL ||
+                               length < ipLen + TCP_HDR_SZ)
+        return -1;
+
+    tcphdr = (TcpHdr*)(packet + ipLen);
+
+    hash = FlowHash(iphdr->src, iphdr->dst, ntohs(tcphdr->srcPort),
+                    ntohs(tcphdr->dstPort));
+
+    /* table rows use the low bits, remix so shards don't pick rows */
+    return (int)(((hash * 0x9E3779B1U) >> 16) % (word32)ShardCount);
+}
+
+
+/* ssl_DecodePacket() on a worker's own Session Table, no mutex */
+/* returns Number of bytes on success, 0 for no data yet, and -1 on error */
+int ssl_DecodeShardPacket(int shard, const byte* packet, int length,
+                          byte* data, char* error)
+{
+    if (shard < 0 || shard >= ShardCount) {
+        SetError(BAD_SHARD_STR, error, NULL, 0);
+        return -1;
+    }
+
+    return DecodePacket(&Shards[shard], packet, length, data, NULL, NULL,
+                        error);
+}
+
+
+/* ssl_DecodePacketBatch() on a worker's own Session Table, no mutex */
+/* returns number of packets in error, error holds the last message, */
+/* -1 on bad input */
+int ssl_DecodeShardPacketBatch(int shard, const SSLSnifferPacket* packets,
+                               int count, SSLSnifferDataCb cb, void* ctx,
+                               char* error)
+{
+    if (shard < 0 || shard >= ShardCount) {
+        SetError(BAD_SHARD_STR, error, NULL, 0);
+        return -1;
+    }
+
+    return DecodePacketBatch(&Shards[shard], packets, count, cb, ctx, error);
+}
+
+
+#ifdef CYASSL_PTHREADS
+
+/* Premaster decrypt worker, runs the queue until stopped and it's empty */
+static void* DecryptWorker(void* arg)
+{
+    (void)arg;
+
+    LockMutex(&DecryptMutex);
+    for (;;) {
+        DecryptJob* job;
+
+        while (DecryptQueue == NULL && !DecryptStop)
+            pthread_cond_wait(&DecryptCond, &DecryptMutex);
+        if (DecryptQueue == NULL)
+            break;
+
+        job = DecryptQueue;
+        DecryptQueue = job->next;
+        if (DecryptQueue == NULL)
+            DecryptQueueTail = &DecryptQueue;
+
+        if (job->orphan) {
+            free(job);
+            continue;
+        }
+        UnLockMutex(&DecryptMutex);
+
+        job->ret = DecryptPms(job->key, job->keySz, job->input, job->inputSz,
+                              job->pms);
+        if (job->ret == 0)
+            AddCachedPms(job->context, job->id, job->pms);
+
+        LockMutex(&DecryptMutex);
+        if (job->orphan) {
+            XMEMSET(job->pms, 0, SECRET_LEN);
+            free(job);
+        }
+        else
+            job->done = 1;
+    }
+    UnLockMutex(&DecryptMutex);
+
+    return NULL;
+}
+
+
+/* Stop the workers once they've drained the queue */
+static void StopDecryptWorkers(void)
+{
+    int i;
+
+    LockMutex(&DecryptMutex);
+    DecryptStop = 1;
+    pthread_cond_broadcast(&DecryptCond);
+    UnLockMutex(&DecryptMutex);
+
+    for (i = 0; i < DecryptWorkers; i++)
+        pthread_join(DecryptTid[i], NULL);
+
+    DecryptWorkers = 0;
+    DecryptStop    = 0;
+}
+
+#else
+
+static void StopDecryptWorkers(void)
+{
+}
+
+#endif /* CYASSL_PTHREADS */
+
+
+/* Starts threads premaster decrypt workers, or stops them for 0 */
+/* returns 0 on success, -1 on error */
+int ssl_SetDecryptWorkers(int threads, SSLSnifferDataCb cb, void* ctx,
+                          char* error)
+{
+    if (threads < 0 || threads > DECRYPT_WORKERS_MAX) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return -1;
+    }
+
+    if (threads == 0) {
+        StopDecryptWorkers();
+        return 0;
+    }
+
+    if (DecryptWorkers) {
+        SetError(DECRYPT_WORKERS_STR, error, NULL, 0);
+        return -1;
+    }
+
+#ifdef CYASSL_PTHREADS
+    DecryptDataCb  = cb;
+    DecryptDataCtx = ctx;
+
+    while (DecryptWorkers < threads) {
+        if (pthread_create(&DecryptTid[DecryptWorkers], NULL, DecryptWorker,
+                           NULL) != 0) {
+            StopDecryptWorkers();
+            SetError(DECRYPT_WORKERS_STR, error, NULL, 0);
+            return -1;
+        }
+        DecryptWorkers++;
+    }
+
+    return 0;
+#else
+    (void)cb;
+    (void)ctx;
+    SetError(DECRYPT_WORKERS_STR, error, NULL, 0);
+    return -1;
+#endif
+}
+
+
+/* Finish sessions of a Session Table whose premaster decrypt is done */
+/* returns sessions resumed, -1 on error */
+int ssl_PollDecrypts(int shard, char* error)
+{
+    SnifferShard* table;
+    int           resumed = 0;
+    word32        i;
+
+    if (shard < -1 || shard >= ShardCount) {
+        SetError(BAD_SHARD_STR, error, NULL, 0);
+        return -1;
+    }
+    table = (shard == -1) ? &SessionShard : &Shards[shard];
+
+    for (i = 0; table->table && i < table->tableSz; i++) {
+        SnifferSession* session = table->table[i];
+
+        while (session) {
+            SnifferSession* next = session->next;
+
+            if (session->pmsJob && PmsJobDone(session)) {
+                int ret = FinishDecrypt(session, error);
+
+                if (!RemoveFatalSession(session, error) && ret > 0) {
+                    LockStats(table);
+                    table->stats.decodedBytes += ret;
+                    UnLockStats(table);
+                }
+                resumed++;
+            }
+            session = next;
+        }
+    }
+
+    return resumed;
+}
+
+
 /* Enables (if traceFile)/ Disables debug tracing */
 /* returns 0 on success, -1 on error */
 int ssl_Trace(const char* traceFile, char* error)
@@ -66,21 +66,26 @@ static int p_hash(byte* result, word32 resLen, const byte* secret,
     byte*  previous;
     byte*  current;
     Hmac*  hmac;    
+    HmacState* keyed;
 #else
     byte   previous[P_HASH_MAX_SIZE];  /* max size */
     byte   current[P_HASH_MAX_SIZE];   /* max size */
     Hmac   hmac[1];
+    HmacState keyed[1];                /* secret's pads hashed once */
 #endif
 
 #ifdef CYASSL_SMALL_STACK
     previous = (byte*)XMALLOC(P_HASH_MAX_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     current  = (byte*)XMALLOC(P_HASH_MAX_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     hmac     = (Hmac*)XMALLOC(sizeof(Hmac),    NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    keyed    = (HmacState*)XMALLOC(sizeof(HmacState), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
 
-    if (previous == NULL || current == NULL || hmac == NULL) {
+    if (previous == NULL || current == NULL || hmac == NULL || keyed == NULL) {
         if (previous) XFREE(previous, NULL, DYNAMIC_TYPE_TMP_BUFFER);
         if (current)  XFREE(current,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
         if (hmac)     XFREE(hmac,     NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (keyed)    XFREE(keyed,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
 
         return MEMORY_E;
     }
@@ -125,7 +130,10 @@ static int p_hash(byte* result, word32 resLen, const byte* secret,
 
     lastTime = times - 1;
 
-    if ((ret = HmacSetKey(hmac, hash, secret, secLen)) == 0) {
+    ret = HmacInitKeyedState(keyed, hash, secret, secLen);
+    if (ret == 0)
+        ret = HmacCloneState(hmac, keyed);
+    if (ret == 0) {
         if ((ret = HmacUpdate(hmac, seed, seedLen)) == 0) { /* A0 = seed */
             if ((ret = HmacFinal(hmac, previous)) == 0) {   /* A1 */
                 for (i = 0; i < times; i++) {
@@ -160,11 +168,13 @@ static int p_hash(byte* result, word32 resLen, const byte* secret,
     XMEMSET(previous, 0, P_HASH_MAX_SIZE);
     XMEMSET(current,  0, P_HASH_MAX_SIZE);
     XMEMSET(hmac,     0, sizeof(Hmac));
+    XMEMSET(keyed,    0, sizeof(HmacState));
 
 #ifdef CYASSL_SMALL_STACK
     XFREE(previous, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     XFREE(current,  NULL, DYNAMIC_TYPE_TMP_BUFFER);
     XFREE(hmac,     NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(keyed,    NULL, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
 
     return ret;
@@ -326,16 +336,20 @@ int BuildTlsFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
     const byte* side;
     byte        handshake_hash[HSHASH_SZ];
     word32      hashSz = FINISHED_SZ;
+    int         ret;
 
 #ifndef NO_OLD_TLS
-    Md5Final(&ssl->hashMd5, handshake_hash);
-    ShaFinal(&ssl->hashSha, &handshake_hash[MD5_DIGEST_SIZE]);
+    /* TLS 1.2 running only its PRF hash skips these */
+    if (ssl->hsHashes->hashMask & HS_HASH_MD5)
+        Md5Final(&ssl->hsHashes->hashMd5, handshake_hash);
+    if (ssl->hsHashes->hashMask & HS_HASH_SHA)
+        ShaFinal(&ssl->hsHashes->hashSha, &handshake_hash[MD5_DIGEST_SIZE]);
 #endif
     
     if (IsAtLeastTLSv1_2(ssl)) {
 #ifndef NO_SHA256
         if (ssl->specs.mac_algorithm <= sha256_mac) {
-            int ret = Sha256Final(&ssl->hashSha256, handshake_hash);
+            ret = Sha256Final(&ssl->hsHashes->hashSha256, handshake_hash);
 
             if (ret != 0)
                 return ret;
@@ -345,7 +359,7 @@ int BuildTlsFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
 #endif
 #ifdef CYASSL_SHA384
         if (ssl->specs.mac_algorithm == sha384_mac) {
-            int ret = Sha384Final(&ssl->hashSha384, handshake_hash);
+            ret = Sha384Final(&ssl->hsHashes->hashSha384, handshake_hash);
 
             if (ret != 0)
                 return ret;
@@ -360,9 +374,13 @@ int BuildTlsFinished(CYASSL* ssl, Hashes* hashes, const byte* sender)
     else
         side = tls_server;
 
-    return PRF((byte*)hashes, TLS_FINISHED_SZ, ssl->arrays->masterSecret,
-               SECRET_LEN, side, FINISHED_LABEL_SZ, handshake_hash, hashSz,
-               IsAtLeastTLSv1_2(ssl), ssl->specs.mac_algorithm);
+    HS_TIMING_OPEN(ssl, CYASSL_HS_PRF);
+    ret = PRF((byte*)hashes, TLS_FINISHED_SZ, ssl->arrays->masterSecret,
+              SECRET_LEN, side, FINISHED_LABEL_SZ, handshake_hash, hashSz,
+              IsAtLeastTLSv1_2(ssl), ssl->specs.mac_algorithm);
+    HS_TIMING_CLOSE(ssl, CYASSL_HS_PRF, finished);
+
+    return ret;
 }
 
 
@@ -439,10 +457,12 @@ int DeriveTlsKeys(CYASSL* ssl)
     }
 #endif
 
+    HS_TIMING_OPEN(ssl, CYASSL_HS_PRF);
     ret = CyaSSL_DeriveTlsKeys(key_data, length,
                            ssl->arrays->masterSecret, SECRET_LEN,
                            ssl->arrays->serverRandom, ssl->arrays->clientRandom,
                            IsAtLeastTLSv1_2(ssl), ssl->specs.mac_algorithm);
+    HS_TIMING_CLOSE(ssl, CYASSL_HS_PRF, 0);
     if (ret == 0)
         ret = StoreKeys(ssl, key_data);
 
@@ -474,10 +494,12 @@ int MakeTlsMasterSecret(CYASSL* ssl)
 {
     int   ret;
 
+    HS_TIMING_OPEN(ssl, CYASSL_HS_PRF);
     ret = CyaSSL_MakeTlsMasterSecret(ssl->arrays->masterSecret, SECRET_LEN,
               ssl->arrays->preMasterSecret, ssl->arrays->preMasterSz,
               ssl->arrays->clientRandom, ssl->arrays->serverRandom,
               IsAtLeastTLSv1_2(ssl), ssl->specs.mac_algorithm);
+    HS_TIMING_CLOSE(ssl, CYASSL_HS_PRF, 0);
 
     if (ret == 0) {
     #ifdef SHOW_SECRETS
@@ -670,6 +692,27 @@ int CyaSSL_SetTlsHmacInner(CYASSL* ssl, byte* inner, word32 sz, int content,
 
 
 /* TLS type HMAC */
+/* start hmac keyed with the MAC secret for this direction, the secret's
+   pads are hashed once into ssl->keys and every record clones them */
+int TLS_hmacKey(CYASSL* ssl, Hmac* hmac, int verify)
+{
+    const byte* secret = CyaSSL_GetMacSecret(ssl, verify);
+    int         idx    = secret == ssl->keys.client_write_MAC_secret ? 0 : 1;
+    HmacState*  state  = &ssl->keys.macState[idx];
+
+    if (!ssl->keys.macStateSet[idx] ||
+                                state->macType != CyaSSL_GetHmacType(ssl)) {
+        int ret = HmacInitKeyedState(state, CyaSSL_GetHmacType(ssl), secret,
+                                     ssl->specs.hash_size);
+        if (ret != 0)
+            return ret;
+        ssl->keys.macStateSet[idx] = 1;
+    }
+
+    return HmacCloneState(hmac, state);
+}
+
+
 int TLS_hmac(CYASSL* ssl, byte* digest, const byte* in, word32 sz,
               int content, int verify)
 {
@@ -687,8 +730,7 @@ int TLS_hmac(CYASSL* ssl, byte* digest, const byte* in, word32 sz,
 
     CyaSSL_SetTlsHmacInner(ssl, myInner, sz, content, verify);
 
-    ret = HmacSetKey(&hmac, CyaSSL_GetHmacType(ssl),
-                     CyaSSL_GetMacSecret(ssl, verify), ssl->specs.hash_size);
+    ret = TLS_hmacKey(ssl, &hmac, verify);
     if (ret != 0)
         return ret;
     ret = HmacUpdate(&hmac, myInner, sizeof(myInner));
@@ -942,6 +984,74 @@ byte TLSX_SNI_Status(TLSX* extensions, byte type)
 }
 #endif
 
+#ifndef NO_CYASSL_SERVER
+
+/* switch to the virtual host CTX for the client's host name, 1 if it was
+   taken, 0 to go on with the CTX's own SNI, < 0 on error */
+static int TLSX_SNI_VirtualHost(CYASSL* ssl, byte* input, word16 length)
+{
+    CYASSL_CTX* ctx   = ssl->ctx;
+    CYASSL_CTX* vhost;
+    word16      size  = 0;
+    word16      offset;
+    int         r;
+
+    if (OPAQUE16_LEN > length)
+        return BUFFER_ERROR;
+
+    ato16(input, &size);
+
+    if (length != OPAQUE16_LEN + size)
+        return BUFFER_ERROR;
+
+    for (offset = OPAQUE16_LEN; offset < length; offset += size) {
+        byte type = input[offset++];
+
+        if (offset + OPAQUE16_LEN > length)
+            return BUFFER_ERROR;
+
+        ato16(input + offset, &size);
+        offset += OPAQUE16_LEN;
+
+        if (offset + size > length)
+            return BUFFER_ERROR;
+
+        if (type == CYASSL_SNI_HOST_NAME)
+            break;
+    }
+
+    if (offset >= length)
+        return 0; /* no host name */
+
+    if ((vhost = FindSNIHost(ctx, (const char*)input + offset, size))) {
+        if ((r = SetSSL_CTX(ssl, vhost)) != 0)
+            return r;
+    }
+
+    if (ctx->sniCb && ctx->sniCb(ssl, (const char*)input + offset, size,
+                                                         ctx->sniCbCtx) != 0) {
+        SendAlert(ssl, alert_fatal, unrecognized_name);
+
+        return UNKNOWN_SNI_HOST_NAME_E;
+    }
+
+    if (ssl->ctx == ctx)
+        return 0;
+
+    /* answer for the virtual host, the getters see the name */
+    r = TLSX_UseSNI(&ssl->extensions, CYASSL_SNI_HOST_NAME, input + offset,
+                                                                         size);
+    if (r != SSL_SUCCESS) return r; /* throw error */
+
+    TLSX_SNI_SetStatus(ssl->extensions, CYASSL_SNI_HOST_NAME,
+                                                        CYASSL_SNI_REAL_MATCH);
+    TLSX_SetResponse(ssl, SERVER_NAME_INDICATION);
+
+    return 1;
+}
+
+#endif
+
 static int TLSX_SNI_Parse(CYASSL* ssl, byte* input, word16 length,
                                                                  byte isRequest)
 {
@@ -949,8 +1059,18 @@ static int TLSX_SNI_Parse(CYASSL* ssl, byte* input, word16 length,
     word16 size = 0;
     word16 offset = 0;
 #endif
+    TLSX *extension;
 
-    TLSX *extension = TLSX_Find(ssl->extensions, SERVER_NAME_INDICATION);
+#ifndef NO_CYASSL_SERVER
+    if (isRequest && (ssl->ctx->sniHostCount || ssl->ctx->sniCb)) {
+        int r = TLSX_SNI_VirtualHost(ssl, input, length);
+
+        if (r != 0)
+            return r < 0 ? r : 0;
+    }
+#endif
+
+    extension = TLSX_Find(ssl->extensions, SERVER_NAME_INDICATION);
 
     if (!extension)
         extension = TLSX_Find(ssl->ctx->extensions, SERVER_NAME_INDICATION);
@@ -1359,6 +1479,198 @@ int TLSX_UseTruncatedHMAC(TLSX** extensions)
 
 #endif /* HAVE_TRUNCATED_HMAC */
 
+#ifdef HAVE_ENCRYPT_THEN_MAC
+
+static int TLSX_EtM_Parse(CYASSL* ssl, byte* input, word16 length,
+                                                                 byte isRequest)
+{
+    if (length != 0 || input == NULL)
+        return BUFFER_ERROR;
+
+#ifndef NO_CYASSL_SERVER
+    if (isRequest) {
+        int r = TLSX_UseEncryptThenMac(&ssl->extensions);
+
+        if (r != SSL_SUCCESS) return r; /* throw error */
+
+        /* SendServerHello takes the response back for a non block suite */
+        TLSX_SetResponse(ssl, ENCRYPT_THEN_MAC);
+    }
+#endif
+
+    ssl->encrypt_then_mac = 1;
+
+    return 0;
+}
+
+int TLSX_UseEncryptThenMac(TLSX** extensions)
+{
+    int ret = 0;
+
+    if (extensions == NULL)
+        return BAD_FUNC_ARG;
+
+    if ((ret = TLSX_Push(extensions, ENCRYPT_THEN_MAC, NULL)) != 0)
+        return ret;
+
+    return SSL_SUCCESS;
+}
+
+#define ETM_PARSE TLSX_EtM_Parse
+
+#else
+
+#define ETM_PARSE(a, b, c, d) 0
+
+#endif /* HAVE_ENCRYPT_THEN_MAC */
+
+/* Cached Information, RFC 7924, only the cert type, the extension data is
+   the SHA-256 of the certificate_list, ours to offer on the client and the
+   client's offer on the server */
+
+#ifdef HAVE_CACHED_INFO
+
+static word16 TLSX_CachedInfo_GetSize(byte isRequest)
+{
+    /* list length then type, the request adds the hash */
+    return OPAQUE16_LEN + ENUM_LEN +
+                           (isRequest ? OPAQUE8_LEN + SHA256_DIGEST_SIZE : 0);
+}
+
+static word16 TLSX_CachedInfo_Write(byte* hash, byte* output, byte isRequest)
+{
+    word16 offset = OPAQUE16_LEN;
+
+    output[offset++] = CACHED_INFO_CERT;
+
+    if (isRequest) {
+        output[offset++] = SHA256_DIGEST_SIZE;
+        XMEMCPY(output + offset, hash, SHA256_DIGEST_SIZE);
+        offset += SHA256_DIGEST_SIZE;
+    }
+
+    c16toa(offset - OPAQUE16_LEN, output);
+
+    return offset;
+}
+
+static int TLSX_CachedInfo_Parse(CYASSL* ssl, byte* input, word16 length,
+                                                                 byte isRequest)
+{
+    word16 size;
+    word16 i     = OPAQUE16_LEN;
+    byte*  offer = NULL;
+    byte   taken = 0;
+
+    if (OPAQUE16_LEN > length)
+        return BUFFER_ERROR;
+
+    ato16(input, &size);
+
+    if (size == 0 || length != OPAQUE16_LEN + size)
+        return BUFFER_ERROR;
+
+    while (i < length) {
+        byte type = input[i++];
+
+        if (!isRequest) {
+            taken |= type == CACHED_INFO_CERT;
+            continue;
+        }
+
+        if (i + OPAQUE8_LEN > length || input[i] == 0 ||
+                                    i + OPAQUE8_LEN + input[i] > length)
+            return BUFFER_ERROR;
+
+        if (type == CACHED_INFO_CERT && input[i] == SHA256_DIGEST_SIZE)
+            offer = input + i + OPAQUE8_LEN;
+
+        i += OPAQUE8_LEN + input[i];
+    }
+
+    if (!isRequest) {
+        TLSX* extension = TLSX_Find(ssl->extensions, CACHED_INFO);
+
+        if (taken && (!extension || !extension->data))
+            return BUFFER_ERROR; /* cached info response without a request */
+
+        ssl->cached_cert = taken;
+
+        return 0;
+    }
+
+#ifndef NO_CYASSL_SERVER
+    /* SendServerHello answers once it knows which chain goes out */
+    if (offer) {
+        int r = TLSX_UseCachedInfo(&ssl->extensions, offer);
+
+        if (r != SSL_SUCCESS) return r; /* throw error */
+    }
+#endif
+
+    return 0;
+}
+
+int TLSX_UseCachedInfo(TLSX** extensions, const byte* hash)
+{
+    byte* data;
+    int   ret;
+
+    if (extensions == NULL || hash == NULL)
+        return BAD_FUNC_ARG;
+
+    data = (byte*)XMALLOC(SHA256_DIGEST_SIZE, 0, DYNAMIC_TYPE_TLSX);
+    if (data == NULL)
+        return MEMORY_E;
+
+    XMEMCPY(data, hash, SHA256_DIGEST_SIZE);
+
+    if ((ret = TLSX_Push(extensions, CACHED_INFO, data)) != 0) {
+        XFREE(data, 0, DYNAMIC_TYPE_TLSX);
+        return ret;
+    }
+
+    return SSL_SUCCESS;
+}
+
+/* 1 if hash is the one offered */
+int TLSX_CachedInfo_Match(TLSX* extensions, const byte* hash, word32 hashSz)
+{
+    TLSX* extension = TLSX_Find(extensions, CACHED_INFO);
+
+    return extension && extension->data && hashSz == SHA256_DIGEST_SIZE &&
+           XMEMCMP(extension->data, hash, hashSz) == 0;
+}
+
+#ifndef NO_CYASSL_SERVER
+
+/* answer the client's offer when it names the chain we are about to send */
+void TLSX_CachedInfo_Respond(CYASSL* ssl, const byte* hash)
+{
+    ssl->cached_cert = 0;
+
+    if (TLSX_CachedInfo_Match(ssl->extensions, hash, SHA256_DIGEST_SIZE)) {
+        TLSX_SetResponse(ssl, CACHED_INFO);
+        ssl->cached_cert = 1;
+    }
+}
+
+#endif
+
+#define CI_FREE_ALL(data)   XFREE(data, 0, DYNAMIC_TYPE_TLSX)
+#define CI_GET_SIZE         TLSX_CachedInfo_GetSize
+#define CI_WRITE            TLSX_CachedInfo_Write
+#define CI_PARSE            TLSX_CachedInfo_Parse
+
+#else
+
+#define CI_FREE_ALL(a)
+#define CI_GET_SIZE(a)        0
+#define CI_WRITE(a, b, c)     0
+#define CI_PARSE(a, b, c, d)  0
+
+#endif /* HAVE_CACHED_INFO */
+
 #ifdef HAVE_SUPPORTED_CURVES
 
 #ifndef HAVE_ECC
@@ -1447,41 +1759,65 @@ static word16 TLSX_EllipticCurve_Write(EllipticCurve* list, byte* output)
 #endif /* NO_CYASSL_CLIENT */
 #ifndef NO_CYASSL_SERVER
 
+static int TLSX_EllipticCurve_Known(word16 name)
+{
+    switch (name) {
+#ifdef HAVE_ECC25519
+        case CYASSL_ECC_CURVE25519:
+#endif
+        case CYASSL_ECC_SECP160R1:
+        case CYASSL_ECC_SECP192R1:
+        case CYASSL_ECC_SECP224R1:
+        case CYASSL_ECC_SECP256R1:
+        case CYASSL_ECC_SECP384R1:
+        case CYASSL_ECC_SECP521R1:
+            return 1;
+    }
+
+    return 0;
+}
+
 static int TLSX_EllipticCurve_Parse(CYASSL* ssl, byte* input, word16 length,
                                                                  byte isRequest)
 {
+    PeerCurves* peer = &ssl->peerCurves;
     word16 offset;
+    word16 size;
     word16 name;
-    int r;
+    int i;
 
     (void) isRequest; /* shut up compiler! */
 
     if (OPAQUE16_LEN > length || length % OPAQUE16_LEN)
         return BUFFER_ERROR;
 
-    ato16(input, &offset);
+    ato16(input, &size);
 
     /* validating curve list length */
-    if (length != OPAQUE16_LEN + offset)
+    if (length != OPAQUE16_LEN + size)
         return BUFFER_ERROR;
 
-    while (offset) {
+    peer->sent = 1;
+
+    for (offset = OPAQUE16_LEN; offset < length; offset += OPAQUE16_LEN) {
         ato16(input + offset, &name);
-        offset -= OPAQUE16_LEN;
 
-        r = TLSX_UseSupportedCurve(&ssl->extensions, name);
+        if (!TLSX_EllipticCurve_Known(name))
+            continue; /* unsupported curve */
 
-        if (r != SSL_SUCCESS) return r; /* throw error */
+        for (i = 0; i < peer->count && peer->name[i] != name; i++);
+
+        if (i == peer->count && peer->count < PEER_CURVES_MAX)
+            peer->name[peer->count++] = name; /* first one of its name */
     }
 
     return 0;
 }
 
 int TLSX_ValidateEllipticCurves(CYASSL* ssl, byte first, byte second) {
-    TLSX*          extension = (first == ECC_BYTE)
-                             ? TLSX_Find(ssl->extensions, ELLIPTIC_CURVES)
-                             : NULL;
-    EllipticCurve* curve     = NULL;
+    PeerCurves*    peer      = &ssl->peerCurves;
+    int            sent      = first == ECC_BYTE && peer->sent;
+    int            i;
     word32         oid       = 0;
     word16         octets    = 0; /* acording to 'ecc_set_type ecc_sets[];' */
     int            sig       = 0; /* valitade signature */
@@ -1538,12 +1874,12 @@ int TLSX_ValidateEllipticCurves(CYASSL* ssl, byte first, byte second) {
 
 #endif
 
-    if (!extension && !use25519) {
+    if (!sent && !use25519) {
         /* no curve restrictions sent accross */
         CYASSL_MSG("Can not use curve25519 but there is no other restrictions");
         return 1;
     } else {
-	    if (!extension && use25519) {
+	    if (!sent && use25519) {
 #ifdef HAVE_ECC25519
             ssl->specs.useCurve25519 = 1;
 #endif
@@ -1551,9 +1887,9 @@ int TLSX_ValidateEllipticCurves(CYASSL* ssl, byte first, byte second) {
 	    }
     }
 
-    for (curve = extension->data; curve && !(sig && key); curve = curve->next) {
+    for (i = 0; i < peer->count && !(sig && key); i++) {
 
-        switch (curve->name) {
+        switch (peer->name[i]) {
 #ifdef HAVE_ECC25519
             case CYASSL_ECC_CURVE25519: oid = CURVE25519_OID;   octets = 32;
                                         ssl->specs.useCurve25519 = 1; break;
@@ -1864,17 +2200,47 @@ static int TLSX_SessionTicket_Parse(CYASSL* ssl, byte* input, word16 length,
     if (!isRequest) {
         if (length != 0)
             return BUFFER_ERROR;
-        
+
+#ifndef NO_CYASSL_CLIENT
         ssl->expect_session_ticket = 1;
+#endif
     }
-    else {
-        /* TODO server side */
-        (void)input;        
+#ifndef NO_CYASSL_SERVER
+    else if (ssl->ctx->ticketKeyCount > 0) {
+        /* built in engine, resume from a good ticket, issue a new one for an
+           empty or unusable one */
+        if (length == 0)
+            return TLSX_SessionTicket_SetResponse(ssl);
+        if (DoClientTicket(ssl, input, length) != 0) {
+            CYASSL_STAT_INC(ticketFailures);
+            return TLSX_SessionTicket_SetResponse(ssl);
+        }
     }
+#endif
+    else
+        (void)input;    /* no ticket keys, ignore like before */
 
     return 0;
 }
 
+#ifndef NO_CYASSL_SERVER
+
+/* echo an empty ticket extension and send NewSessionTicket */
+int TLSX_SessionTicket_SetResponse(CYASSL* ssl)
+{
+    int ret = TLSX_UseSessionTicket(&ssl->extensions, NULL);
+
+    if (ret != SSL_SUCCESS)
+        return ret;
+
+    TLSX_SetResponse(ssl, SESSION_TICKET);
+    ssl->options.createTicket = 1;
+
+    return 0;
+}
+
+#endif
+
 CYASSL_LOCAL SessionTicket* TLSX_SessionTicket_Create(word32 lifetime,
                                                        byte* data, word16 size)
 {
@@ -1921,6 +2287,7 @@ int TLSX_UseSessionTicket(TLSX** extensions, SessionTicket* ticket)
 #define STK_GET_SIZE         TLSX_SessionTicket_GetSize
 #define STK_WRITE            TLSX_SessionTicket_Write
 #define STK_PARSE            TLSX_SessionTicket_Parse
+#define STK_FREE             TLSX_SessionTicket_Free
 
 #else
 
@@ -1928,9 +2295,341 @@ int TLSX_UseSessionTicket(TLSX** extensions, SessionTicket* ticket)
 #define STK_GET_SIZE(a, b)      0
 #define STK_WRITE(a, b, c)      0
 #define STK_PARSE(a, b, c, d)   0
+#define STK_FREE(a)
 
 #endif /* HAVE_SESSION_TICKET */
 
+/* Certificate Status Request, OCSP stapling */
+#ifdef HAVE_CERTIFICATE_STATUS_REQUEST
+
+/* status_type, empty responder_id_list and request_extensions */
+#define CSR_REQUEST_SZ (ENUM_LEN + OPAQUE16_LEN + OPAQUE16_LEN)
+
+static word16 TLSX_CSR_GetSize(int isRequest)
+{
+    return isRequest ? CSR_REQUEST_SZ : 0; /* server echoes it empty */
+}
+
+static word16 TLSX_CSR_Write(byte* output, int isRequest)
+{
+    if (!isRequest)
+        return 0;
+
+    output[0] = CSR_OCSP;
+    c16toa(0, output + ENUM_LEN);
+    c16toa(0, output + ENUM_LEN + OPAQUE16_LEN);
+
+    return CSR_REQUEST_SZ;
+}
+
+static int TLSX_CSR_Parse(CYASSL* ssl, byte* input, word16 length,
+                                                                 byte isRequest)
+{
+    if (!isRequest) {
+        if (length != 0)
+            return BUFFER_ERROR;
+
+        ssl->options.statusRequest = 1; /* CertificateStatus will follow */
+        return 0;
+    }
+
+#ifndef NO_CYASSL_SERVER
+    /* responder ids and request extensions are ignored, any is fine */
+    if (length < ENUM_LEN || input[0] != CSR_OCSP)
+        return 0;
+
+    /* the CTX staple is for the CTX cert only */
+    if (ssl->ctx->stapleOn && !ssl->buffers.weOwnCert &&
+                                              ssl->ocspStaple.buffer == NULL) {
+        int r;
+
+        if (GetStapleOCSP(ssl->ctx->cm->ocsp, &ssl->ctx->stapleId,
+                          &ssl->ocspStaple.buffer, &ssl->ocspStaple.length,
+                          ssl->heap) != 0) {
+            CYASSL_MSG("No current OCSP response to staple");
+            return 0;
+        }
+
+        r = TLSX_UseCertificateStatusRequest(&ssl->extensions);
+
+        if (r != SSL_SUCCESS) return r; /* throw error */
+
+        TLSX_SetResponse(ssl, STATUS_REQUEST);
+    }
+#else
+    (void)input;
+#endif
+
+    return 0;
+}
+
+int TLSX_UseCertificateStatusRequest(TLSX** extensions)
+{
+    int ret = 0;
+
+    if (extensions == NULL)
+        return BAD_FUNC_ARG;
+
+    if ((ret = TLSX_Push(extensions, STATUS_REQUEST, NULL)) != 0)
+        return ret;
+
+    return SSL_SUCCESS;
+}
+
+#define CSR_GET_SIZE TLSX_CSR_GetSize
+#define CSR_WRITE    TLSX_CSR_Write
+#define CSR_PARSE    TLSX_CSR_Parse
+
+#else
+
+#define CSR_GET_SIZE(a)       0
+#define CSR_WRITE(a, b)       0
+#define CSR_PARSE(a, b, c, d) 0
+
+#endif /* HAVE_CERTIFICATE_STATUS_REQUEST */
+
+/* Application-Layer Protocol Negotiation */
+#ifdef HAVE_ALPN
+
+static void TLSX_ALPN_Free(ALPN* alpn)
+{
+    if (alpn) {
+        if (alpn->list)
+            XFREE(alpn->list, 0, DYNAMIC_TYPE_TLSX);
+
+        XFREE(alpn, 0, DYNAMIC_TYPE_TLSX);
+    }
+}
+
+static word16 TLSX_ALPN_GetSize(ALPN* alpn)
+{
+    return OPAQUE16_LEN + alpn->size;
+}
+
+static word16 TLSX_ALPN_Write(ALPN* alpn, byte* output)
+{
+    c16toa(alpn->size, output);
+    XMEMCPY(output + OPAQUE16_LEN, alpn->list, alpn->size);
+
+    return OPAQUE16_LEN + alpn->size;
+}
+
+/* 1 if name is in the length prefixed protocol list */
+static int TLSX_ALPN_Has(const byte* list, word16 size, const byte* name,
+                                                                   byte nameSz)
+{
+    word16 i;
+
+    for (i = 0; i < size; i += OPAQUE8_LEN + list[i])
+        if (list[i] == nameSz && XMEMCMP(list + i + OPAQUE8_LEN, name,
+                                                                 nameSz) == 0)
+            return 1;
+
+    return 0;
+}
+
+/* copy of a length prefixed protocol list as a new ALPN extension */
+static int TLSX_ALPN_Push(TLSX** extensions, const byte* list, word16 size,
+                                                byte options, byte negotiated)
+{
+    int   ret;
+    ALPN* alpn = (ALPN*)XMALLOC(sizeof(ALPN), 0, DYNAMIC_TYPE_TLSX);
+
+    if (alpn == NULL)
+        return MEMORY_E;
+
+    alpn->list = (byte*)XMALLOC(size, 0, DYNAMIC_TYPE_TLSX);
+    if (alpn->list == NULL) {
+        XFREE(alpn, 0, DYNAMIC_TYPE_TLSX);
+        return MEMORY_E;
+    }
+
+    XMEMCPY(alpn->list, list, size);
+    alpn->size       = size;
+    alpn->options    = options;
+    alpn->negotiated = negotiated;
+
+    if ((ret = TLSX_Push(extensions, APPLICATION_LAYER_PROTOCOL, alpn)) != 0) {
+        TLSX_ALPN_Free(alpn);
+        return ret;
+    }
+
+    return SSL_SUCCESS;
+}
+
+/* the chosen protocol replaces any list on ssl, later read by the getter */
+static int TLSX_ALPN_SetProtocol(CYASSL* ssl, const byte* name, byte nameSz)
+{
+    byte wire[OPAQUE8_LEN + CYASSL_MAX_ALPN_NAME];
+
+    wire[0] = nameSz;
+    XMEMCPY(wire + OPAQUE8_LEN, name, nameSz);
+
+    return TLSX_ALPN_Push(&ssl->extensions, wire, OPAQUE8_LEN + nameSz, 0, 1);
+}
+
+static int TLSX_ALPN_Parse(CYASSL* ssl, byte* input, word16 length,
+                                                                 byte isRequest)
+{
+    word16 size;
+    word16 i;
+    int    r;
+    ALPN*  ours;
+    TLSX*  extension = TLSX_Find(ssl->extensions, APPLICATION_LAYER_PROTOCOL);
+
+    if (!extension)
+        extension = TLSX_Find(ssl->ctx->extensions,
+                                                   APPLICATION_LAYER_PROTOCOL);
+
+    ours = extension ? (ALPN*)extension->data : NULL;
+
+    if (!isRequest && !ours)
+        return BUFFER_ERROR; /* ALPN response without a request */
+
+    if (!ours && !ssl->ctx->alpnSelectCb)
+        return 0; /* not using ALPN */
+
+    if (OPAQUE16_LEN > length)
+        return BUFFER_ERROR;
+
+    ato16(input, &size);
+    input += OPAQUE16_LEN;
+
+    /* validating protocol list, no empty names */
+    if (size == 0 || length != OPAQUE16_LEN + size)
+        return BUFFER_ERROR;
+
+    for (i = 0; i < size; i += OPAQUE8_LEN + input[i])
+        if (input[i] == 0 || i + OPAQUE8_LEN + input[i] > size)
+            return BUFFER_ERROR;
+
+    if (!isRequest) {
+        /* server must pick exactly one of ours */
+        if (input[0] != size - OPAQUE8_LEN)
+            return BUFFER_ERROR;
+
+        if (!TLSX_ALPN_Has(ours->list, ours->size, input + OPAQUE8_LEN,
+                                                                   input[0])) {
+            SendAlert(ssl, alert_fatal, illegal_parameter);
+
+            return UNKNOWN_ALPN_PROTOCOL_E;
+        }
+
+        r = TLSX_ALPN_SetProtocol(ssl, input + OPAQUE8_LEN, input[0]);
+
+        return r == SSL_SUCCESS ? 0 : r;
+    }
+
+#ifndef NO_CYASSL_SERVER
+    {
+        const byte* pick   = NULL;
+        byte        pickSz = 0;
+
+        if (ssl->ctx->alpnSelectCb) {
+            if (ssl->ctx->alpnSelectCb(ssl, &pick, &pickSz, input, size,
+                                         ssl->ctx->alpnSelectCtx) != 0
+                                                                || pickSz == 0)
+                pick = NULL;
+        }
+        else {
+            /* our preference order wins */
+            for (i = 0; i < ours->size && !pick;
+                                         i += OPAQUE8_LEN + ours->list[i]) {
+                if (TLSX_ALPN_Has(input, size, ours->list + i + OPAQUE8_LEN,
+                                                               ours->list[i])) {
+                    pick   = ours->list + i + OPAQUE8_LEN;
+                    pickSz = ours->list[i];
+                }
+            }
+        }
+
+        if (!pick) {
+            if (!ours || ours->options & CYASSL_ALPN_CONTINUE_ON_MISMATCH)
+                return 0;
+
+            SendAlert(ssl, alert_fatal, no_application_protocol);
+
+            return UNKNOWN_ALPN_PROTOCOL_E;
+        }
+
+        r = TLSX_ALPN_SetProtocol(ssl, pick, pickSz);
+
+        if (r != SSL_SUCCESS) return r; /* throw error */
+
+        TLSX_SetResponse(ssl, APPLICATION_LAYER_PROTOCOL);
+    }
+#endif
+
+    return 0;
+}
+
+int TLSX_UseALPN(TLSX** extensions, const char* protocols, word32 size,
+                                                                  byte options)
+{
+    int    ret;
+    word32 i;
+    word32 start = 0;
+    byte*  list;
+
+    if (extensions == NULL || protocols == NULL || size == 0 ||
+                                                         size > ALPN_LIST_MAX)
+        return BAD_FUNC_ARG;
+
+    /* "h2,http/1.1" goes on the wire as "\x02h2\x08http/1.1" */
+    list = (byte*)XMALLOC(size + OPAQUE8_LEN, 0, DYNAMIC_TYPE_TLSX);
+    if (list == NULL)
+        return MEMORY_E;
+
+    for (i = 0; i <= size; i++) {
+        if (i < size && protocols[i] != ',') {
+            list[i + OPAQUE8_LEN] = (byte)protocols[i];
+            continue;
+        }
+
+        if (i == start || i - start > CYASSL_MAX_ALPN_NAME) {
+            XFREE(list, 0, DYNAMIC_TYPE_TLSX);
+            return BAD_FUNC_ARG;
+        }
+
+        list[start] = (byte)(i - start);
+        start = i + 1;
+    }
+
+    ret = TLSX_ALPN_Push(extensions, list, (word16)(size + OPAQUE8_LEN),
+                                                                   options, 0);
+    XFREE(list, 0, DYNAMIC_TYPE_TLSX);
+
+    return ret;
+}
+
+int TLSX_ALPN_GetProtocol(TLSX* extensions, char** name, word16* size)
+{
+    TLSX* extension = TLSX_Find(extensions, APPLICATION_LAYER_PROTOCOL);
+    ALPN* alpn      = extension ? (ALPN*)extension->data : NULL;
+
+    if (!alpn || !alpn->negotiated)
+        return SSL_FAILURE;
+
+    *name = (char*)alpn->list + OPAQUE8_LEN;
+    *size = alpn->list[0];
+
+    return SSL_SUCCESS;
+}
+
+#define ALPN_FREE     TLSX_ALPN_Free
+#define ALPN_GET_SIZE TLSX_ALPN_GetSize
+#define ALPN_WRITE    TLSX_ALPN_Write
+#define ALPN_PARSE    TLSX_ALPN_Parse
+
+#else
+
+#define ALPN_FREE(a)
+#define ALPN_GET_SIZE(a)       0
+#define ALPN_WRITE(a, b)       0
+#define ALPN_PARSE(a, b, c, d) 0
+
+#endif /* HAVE_ALPN */
+
 
 TLSX* TLSX_Find(TLSX* list, TLSX_Type type)
 {
@@ -1959,6 +2658,8 @@ void TLSX_FreeAll(TLSX* list)
                 break;
 
             case TRUNCATED_HMAC:
+            case ENCRYPT_THEN_MAC:
+            case STATUS_REQUEST:
                 /* Nothing to do. */
                 break;
 
@@ -1971,7 +2672,15 @@ void TLSX_FreeAll(TLSX* list)
                 break;
 
             case SESSION_TICKET:
-                /* Nothing to do. */
+                STK_FREE(extension->data);
+                break;
+
+            case APPLICATION_LAYER_PROTOCOL:
+                ALPN_FREE((ALPN*)extension->data);
+                break;
+
+            case CACHED_INFO:
+                CI_FREE_ALL(extension->data);
                 break;
         }
 
@@ -2010,9 +2719,14 @@ static word16 TLSX_GetSize(TLSX* list, byte* semaphore, byte isRequest)
                 break;
 
             case TRUNCATED_HMAC:
+            case ENCRYPT_THEN_MAC:
                 /* empty extension. */
                 break;
 
+            case STATUS_REQUEST:
+                length += CSR_GET_SIZE(isRequest);
+                break;
+
             case ELLIPTIC_CURVES:
                 length += EC_GET_SIZE(extension->data);
                 break;
@@ -2024,6 +2738,14 @@ static word16 TLSX_GetSize(TLSX* list, byte* semaphore, byte isRequest)
             case SESSION_TICKET:
                 length += STK_GET_SIZE(extension->data, isRequest);
                 break;
+
+            case APPLICATION_LAYER_PROTOCOL:
+                length += ALPN_GET_SIZE((ALPN*)extension->data);
+                break;
+
+            case CACHED_INFO:
+                length += CI_GET_SIZE(isRequest);
+                break;
         }
 
         TURN_ON(semaphore, TLSX_ToSemaphore(extension->type));
@@ -2065,9 +2787,14 @@ static word16 TLSX_Write(TLSX* list, byte* output, byte* semaphore,
                 break;
 
             case TRUNCATED_HMAC:
+            case ENCRYPT_THEN_MAC:
                 /* empty extension. */
                 break;
 
+            case STATUS_REQUEST:
+                offset += CSR_WRITE(output + offset, isRequest);
+                break;
+
             case ELLIPTIC_CURVES:
                 offset += EC_WRITE(extension->data, output + offset);
                 break;
@@ -2081,6 +2808,15 @@ static word16 TLSX_Write(TLSX* list, byte* output, byte* semaphore,
                 offset += STK_WRITE(extension->data, output + offset,
                                                                      isRequest);
                 break;
+
+            case APPLICATION_LAYER_PROTOCOL:
+                offset += ALPN_WRITE((ALPN*)extension->data, output + offset);
+                break;
+
+            case CACHED_INFO:
+                offset += CI_WRITE((byte*)extension->data, output + offset,
+                                                                     isRequest);
+                break;
         }
 
         /* writing extension data length */
@@ -2215,6 +2951,11 @@ int TLSX_Parse(CYASSL* ssl, byte* input, word16 length, byte isRequest,
     if (!ssl || !input || (isRequest && !suites))
         return BAD_FUNC_ARG;
 
+#if defined(HAVE_SUPPORTED_CURVES) && !defined(NO_CYASSL_SERVER)
+    if (isRequest)
+        XMEMSET(&ssl->peerCurves, 0, sizeof(PeerCurves)); /* new hello */
+#endif
+
     while (ret == 0 && offset < length) {
         word16 type;
         word16 size;
@@ -2250,6 +2991,18 @@ int TLSX_Parse(CYASSL* ssl, byte* input, word16 length, byte isRequest,
                 ret = THM_PARSE(ssl, input + offset, size, isRequest);
                 break;
 
+            case ENCRYPT_THEN_MAC:
+                CYASSL_MSG("Encrypt-then-MAC extension received");
+
+                ret = ETM_PARSE(ssl, input + offset, size, isRequest);
+                break;
+
+            case STATUS_REQUEST:
+                CYASSL_MSG("Certificate Status Request extension received");
+
+                ret = CSR_PARSE(ssl, input + offset, size, isRequest);
+                break;
+
             case ELLIPTIC_CURVES:
                 CYASSL_MSG("Elliptic Curves extension received");
 
@@ -2268,6 +3021,18 @@ int TLSX_Parse(CYASSL* ssl, byte* input, word16 length, byte isRequest,
                 ret = STK_PARSE(ssl, input + offset, size, isRequest);
                 break;
 
+            case APPLICATION_LAYER_PROTOCOL:
+                CYASSL_MSG("ALPN extension received");
+
+                ret = ALPN_PARSE(ssl, input + offset, size, isRequest);
+                break;
+
+            case CACHED_INFO:
+                CYASSL_MSG("Cached Information extension received");
+
+                ret = CI_PARSE(ssl, input + offset, size, isRequest);
+                break;
+
             case HELLO_EXT_SIG_ALGO:
                 if (isRequest) {
                     /* do not mess with offset inside the switch! */
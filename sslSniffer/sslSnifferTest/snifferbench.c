@@ -0,0 +1,548 @@
+/* snifferbench.c
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#if !defined(CYASSL_SNIFFER) || defined(_WIN32) || defined(SINGLE_THREADED)
+
+/* blank build, the replay threads are pthreads */
+#include <stdio.h>
+#include <stdlib.h>
+int main(void)
+{
+    printf("do ./configure --enable-sniffer to enable build support\n");
+    return EXIT_SUCCESS;
+}
+
+#else
+/* do a full build */
+
+#include <pcap/pcap.h>     /* pcap_open_offline */
+#include <stdio.h>         /* printf */
+#include <stdlib.h>        /* EXIT_SUCCESS */
+#include <string.h>        /* strcmp */
+#include <pthread.h>       /* decode threads */
+#include <sys/time.h>      /* gettimeofday */
+
+#include <cyassl/sniffer.h>
+#include <cyassl/ctaocrypt/memory.h>
+
+
+/* Replays a capture from memory through the sniffer as fast as it goes and
+   reports packets/sec, decrypted MB/s, new sessions/sec and the high water
+   mark of the library's allocations while decoding.
+
+   ./snifferbench [-t threads] [-l loops] [-w FILE] [-b FILE] [-p PCT]
+                  dump pemKey [server] [port] [password]
+
+   Each loop starts a fresh sniffer, so every loop sees the same sessions
+   from their handshakes on, and the fastest loop is reported. With more
+   than one thread the packets go to ssl_SetShards() tables by
+   ssl_GetPacketShard(), each thread feeding its own. -w FILE writes the
+   results as a baseline, -b FILE fails if packets/sec is more than PCT
+   percent (default 20) below the baseline's or the memory high water mark
+   more than PCT percent above it. */
+
+#define BENCH_BATCH      64        /* packets per batch call */
+#define BENCH_LOOPS      5
+#define BENCH_THRESHOLD  20        /* percent */
+#define BENCH_MAX_THREADS 64
+
+enum {
+    ETHER_IF_FRAME_LEN = 14,   /* ethernet interface frame length */
+    NULL_IF_FRAME_LEN =   4,   /* no link interface frame length  */
+};
+
+
+typedef struct BenchCapture {
+    SSLSnifferPacket* packets;
+    int               count;
+    unsigned char*    data;         /* all packets back to back */
+    size_t            dataSz;
+} BenchCapture;
+
+typedef struct BenchThread {
+    pthread_t         tid;
+    int               shard;        /* -1 for the default Session Table */
+    SSLSnifferPacket* packets;
+    int               count;
+    int               bad;          /* packets in error */
+    unsigned long     appBytes;     /* seen by the data callback */
+    char              error[PCAP_ERRBUF_SIZE];
+} BenchThread;
+
+typedef struct BenchResult {
+    double pps;                     /* packets/sec */
+    double mbps;                    /* decrypted MB/s */
+    double sps;                     /* new sessions/sec */
+    double peak;                    /* allocation high water mark, bytes */
+} BenchResult;
+
+
+static void err_sys(const char* msg)
+{
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+
+static double current_time(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000;
+}
+
+
+/* size header in front of each allocation, the counters are updated from
+   every decode thread */
+typedef union BenchMemHdr {
+    size_t size;
+    double align;
+} BenchMemHdr;
+
+static long memCurrent = 0;
+static long memPeak    = 0;
+
+
+static void BenchMemAdd(long sz)
+{
+    long now  = __atomic_add_fetch(&memCurrent, sz, __ATOMIC_RELAXED);
+    long peak = __atomic_load_n(&memPeak, __ATOMIC_RELAXED);
+
+    while (now > peak && !__atomic_compare_exchange_n(&memPeak, &peak, now, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+
+static void* BenchMalloc(size_t sz)
+{
+    BenchMemHdr* hdr = (BenchMemHdr*)malloc(sizeof(BenchMemHdr) + sz);
+
+    if (hdr == NULL)
+        return NULL;
+    hdr->size = sz;
+    BenchMemAdd((long)sz);
+
+    return hdr + 1;
+}
+
+
+static void BenchFree(void* ptr)
+{
+    BenchMemHdr* hdr;
+
+    if (ptr == NULL)
+        return;
+    hdr = (BenchMemHdr*)ptr - 1;
+    BenchMemAdd(-(long)hdr->size);
+    free(hdr);
+}
+
+
+static void* BenchRealloc(void* ptr, size_t sz)
+{
+    BenchMemHdr* hdr;
+    size_t       old;
+
+    if (ptr == NULL)
+        return BenchMalloc(sz);
+
+    hdr = (BenchMemHdr*)ptr - 1;
+    old = hdr->size;
+    hdr = (BenchMemHdr*)realloc(hdr, sizeof(BenchMemHdr) + sz);
+    if (hdr == NULL)
+        return NULL;
+    hdr->size = sz;
+    BenchMemAdd((long)sz - (long)old);
+
+    return hdr + 1;
+}
+
+
+/* Reads every IP packet of the capture into one buffer */
+static int LoadCapture(const char* fname, BenchCapture* cap)
+{
+    char                err[PCAP_ERRBUF_SIZE];
+    pcap_t*             pcap;
+    struct pcap_pkthdr* header;
+    const u_char*       packet;
+    size_t*             offsets = NULL;
+    int                 frame = ETHER_IF_FRAME_LEN;
+    int                 max = 0;
+    int                 i;
+
+    memset(cap, 0, sizeof(BenchCapture));
+
+    pcap = pcap_open_offline(fname, err);
+    if (pcap == NULL) {
+        printf("pcap_open_offline failed %s\n", err);
+        return -1;
+    }
+    if (pcap_datalink(pcap) == DLT_NULL)
+        frame = NULL_IF_FRAME_LEN;
+
+    while (pcap_next_ex(pcap, &header, &packet) == 1) {
+        unsigned int len;
+
+        if (header->caplen <= 40)   /* min ip(20) + min tcp(20) */
+            continue;
+        len = header->caplen - frame;
+
+        if (cap->count == max) {
+            max = max ? max * 2 : 1024;
+            offsets = (size_t*)realloc(offsets, max * sizeof(size_t));
+            if (offsets == NULL)
+                err_sys("out of memory loading capture");
+        }
+        cap->data = (unsigned char*)realloc(cap->data, cap->dataSz + len);
+        if (cap->data == NULL)
+            err_sys("out of memory loading capture");
+
+        memcpy(cap->data + cap->dataSz, packet + frame, len);
+        offsets[cap->count++] = cap->dataSz;
+        cap->dataSz += len;
+    }
+    pcap_close(pcap);
+
+    /* the buffer moved while growing, point in once it's done */
+    cap->packets = (SSLSnifferPacket*)malloc(
+                                   (cap->count + 1) * sizeof(SSLSnifferPacket));
+    if (cap->packets == NULL)
+        err_sys("out of memory loading capture");
+    for (i = 0; i < cap->count; i++) {
+        size_t end = i + 1 < cap->count ? offsets[i + 1] : cap->dataSz;
+
+        cap->packets[i].packet = cap->data + offsets[i];
+        cap->packets[i].length = (int)(end - offsets[i]);
+    }
+    free(offsets);
+
+    return cap->count;
+}
+
+
+static void BenchDataCb(const unsigned char* data, int length, int fromServer,
+                        void** flowCtx, void* ctx)
+{
+    (void)data;
+    (void)fromServer;
+    (void)flowCtx;
+
+    ((BenchThread*)ctx)->appBytes += length;
+}
+
+
+static void* BenchDecode(void* arg)
+{
+    BenchThread* thread = (BenchThread*)arg;
+    int          i, n, ret;
+
+    for (i = 0; i < thread->count; i += n) {
+        n = thread->count - i;
+        if (n > BENCH_BATCH)
+            n = BENCH_BATCH;
+
+        if (thread->shard < 0)
+            ret = ssl_DecodePacketBatch(thread->packets + i, n, BenchDataCb,
+                                        thread, thread->error);
+        else
+            ret = ssl_DecodeShardPacketBatch(thread->shard,
+                                             thread->packets + i, n,
+                                             BenchDataCb, thread,
+                                             thread->error);
+        if (ret > 0)
+            thread->bad += ret;
+    }
+
+    return NULL;
+}
+
+
+/* One replay on a fresh sniffer, returns 0 on success */
+static int BenchLoop(BenchCapture* cap, int threads, const char* keyFile,
+                     const char* server, int port, const char* passwd,
+                     BenchResult* res)
+{
+    static BenchThread list[BENCH_MAX_THREADS];
+    SSLSnifferPacket*  shardPackets = NULL;
+    SSLStats           stats;
+    char               err[PCAP_ERRBUF_SIZE];
+    double             start, total;
+    unsigned long      appBytes = 0;
+    int                bad = 0;
+    int                i, ret;
+
+    memset(list, 0, sizeof(list));
+
+    ssl_InitSniffer();
+    ret = ssl_SetPrivateKey(server, port, keyFile, FILETYPE_PEM, passwd, err);
+    if (ret == 0 && threads > 1)
+        ret = ssl_SetShards(threads, err);
+    if (ret != 0) {
+        printf("sniffer setup failed %s\n", err);
+        ssl_FreeSniffer();
+        return -1;
+    }
+
+    if (threads == 1) {
+        list[0].shard   = -1;
+        list[0].packets = cap->packets;
+        list[0].count   = cap->count;
+    }
+    else {
+        /* split by flow in capture order, ahead of the clock */
+        int* shards = (int*)malloc((cap->count + 1) * sizeof(int));
+        int  used = 0;
+
+        shardPackets = (SSLSnifferPacket*)malloc(
+                                   (cap->count + 1) * sizeof(SSLSnifferPacket));
+        if (shards == NULL || shardPackets == NULL)
+            err_sys("out of memory splitting capture");
+
+        for (i = 0; i < cap->count; i++) {
+            shards[i] = ssl_GetPacketShard(cap->packets[i].packet,
+                                           cap->packets[i].length);
+            if (shards[i] >= 0)
+                list[shards[i]].count++;
+        }
+        for (i = 0; i < threads; i++) {
+            list[i].shard   = i;
+            list[i].packets = shardPackets + used;
+            used += list[i].count;
+            list[i].count = 0;
+        }
+        for (i = 0; i < cap->count; i++)
+            if (shards[i] >= 0)
+                list[shards[i]].packets[list[shards[i]].count++] =
+                                                                cap->packets[i];
+        free(shards);
+    }
+
+    __atomic_store_n(&memPeak, __atomic_load_n(&memCurrent, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    start = current_time();
+
+    if (threads == 1)
+        BenchDecode(&list[0]);
+    else {
+        for (i = 0; i < threads; i++)
+            if (pthread_create(&list[i].tid, NULL, BenchDecode, &list[i]) != 0)
+                err_sys("pthread_create failed");
+        for (i = 0; i < threads; i++)
+            pthread_join(list[i].tid, NULL);
+    }
+
+    total = current_time() - start;
+
+    for (i = 0; i < threads; i++) {
+        appBytes += list[i].appBytes;
+        bad      += list[i].bad;
+        if (list[i].bad)
+            printf("  thread %d: %d packets in error, last %s\n", i,
+                   list[i].bad, list[i].error);
+    }
+
+    ssl_ReadStatistics(&stats);
+    if (stats.decodedBytes != appBytes)
+        printf("  decoded %lu bytes, callbacks saw %lu\n", stats.decodedBytes,
+               appBytes);
+
+    if (total <= 0)
+        total = 1e-9;
+    res->pps  = stats.packets / total;
+    res->mbps = stats.decodedBytes / total / (1024 * 1024);
+    res->sps  = stats.sessions / total;
+    res->peak = (double)__atomic_load_n(&memPeak, __ATOMIC_RELAXED);
+
+    printf("  %lu packets %lu sessions (%lu resumed) %lu bytes in "
+           "%.3f seconds\n", stats.packets, stats.sessions,
+           stats.resumedSessions, stats.decodedBytes, total);
+
+    ssl_FreeSniffer();
+    free(shardPackets);
+
+    return bad == cap->count ? -1 : 0;
+}
+
+
+/* baseline lines are "threads pps mbps sps peak", # comments */
+static int BenchLoad(const char* fname, int threads, BenchResult* res)
+{
+    FILE* file = fopen(fname, "r");
+    char  line[160];
+    int   found = -1;
+
+    if (file == NULL) {
+        printf("unable to open baseline %s\n", fname);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        BenchResult tmp;
+        int         n;
+
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%d %lf %lf %lf %lf", &n, &tmp.pps, &tmp.mbps,
+                   &tmp.sps, &tmp.peak) == 5 && n == threads) {
+            *res  = tmp;
+            found = 0;
+        }
+    }
+
+    fclose(file);
+    if (found != 0)
+        printf("baseline %s has no %d thread results\n", fname, threads);
+
+    return found;
+}
+
+
+static int BenchSave(const char* fname, int threads, BenchResult* res)
+{
+    FILE* file = fopen(fname, "w");
+
+    if (file == NULL) {
+        printf("unable to write baseline %s\n", fname);
+        return -1;
+    }
+
+    fprintf(file, "# sniffer replay baseline, threads packets/sec MB/s "
+                  "sessions/sec peak bytes\n");
+    fprintf(file, "%d %.0f %.3f %.1f %.0f\n", threads, res->pps, res->mbps,
+            res->sps, res->peak);
+
+    fclose(file);
+    return 0;
+}
+
+
+static void Usage(void)
+{
+    printf("usage: ./snifferbench [-t threads] [-l loops] [-w FILE] "
+           "[-b FILE] [-p PCT] dump pemKey [server] [port] [password]\n");
+    exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char** argv)
+{
+    BenchCapture cap;
+    BenchResult  best, res, base;
+    const char*  baseline = NULL;
+    const char*  output = NULL;
+    const char*  server = "127.0.0.1";
+    const char*  passwd = NULL;
+    int          threads = 1;
+    int          loops = BENCH_LOOPS;
+    int          threshold = BENCH_THRESHOLD;
+    int          port = 443;
+    int          failed = 0;
+    int          i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i += 2) {
+        if (i + 1 >= argc)
+            Usage();
+        if (strcmp(argv[i], "-t") == 0)
+            threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-l") == 0)
+            loops = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-w") == 0)
+            output = argv[i + 1];
+        else if (strcmp(argv[i], "-b") == 0)
+            baseline = argv[i + 1];
+        else if (strcmp(argv[i], "-p") == 0)
+            threshold = atoi(argv[i + 1]);
+        else
+            Usage();
+    }
+    argc -= i;
+    argv += i;
+
+    if (argc < 2 || threads < 1 || threads > BENCH_MAX_THREADS || loops < 1 ||
+                                                                threshold < 0)
+        Usage();
+    if (argc >= 3)
+        server = argv[2];
+    if (argc >= 4)
+        port = atoi(argv[3]);
+    if (argc >= 5)
+        passwd = argv[4];
+
+    if (CyaSSL_SetAllocators(BenchMalloc, BenchFree, BenchRealloc) != 0)
+        err_sys("CyaSSL_SetAllocators failed");
+
+    if (LoadCapture(argv[0], &cap) <= 0)
+        err_sys("no packets in capture");
+    printf("%s: %d packets, %lu bytes, %d thread%s\n", argv[0], cap.count,
+           (unsigned long)cap.dataSz, threads, threads > 1 ? "s" : "");
+
+    memset(&best, 0, sizeof(best));
+    for (i = 0; i < loops; i++) {
+        if (BenchLoop(&cap, threads, argv[1], server, port, passwd, &res) != 0)
+            err_sys("every packet failed to decode, check key and server");
+        if (res.pps > best.pps) {
+            best.pps  = res.pps;
+            best.mbps = res.mbps;
+            best.sps  = res.sps;
+        }
+        if (res.peak > best.peak)
+            best.peak = res.peak;
+    }
+
+    printf("packets/sec   %12.0f\n", best.pps);
+    printf("decrypted MB/s%12.3f\n", best.mbps);
+    printf("sessions/sec  %12.1f\n", best.sps);
+    printf("peak bytes    %12.0f\n", best.peak);
+
+    if (baseline) {
+        if (BenchLoad(baseline, threads, &base) != 0)
+            failed = 1;
+        else {
+            if (best.pps < base.pps * (100 - threshold) / 100) {
+                printf("slower, %.0f packets/sec, baseline %.0f\n", best.pps,
+                       base.pps);
+                failed = 1;
+            }
+            if (best.peak > base.peak * (100 + threshold) / 100) {
+                printf("more memory, %.0f peak bytes, baseline %.0f\n",
+                       best.peak, base.peak);
+                failed = 1;
+            }
+        }
+    }
+    if (output && BenchSave(output, threads, &best) != 0)
+        failed = 1;
+
+    free(cap.packets);
+    free(cap.data);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif /* full build */
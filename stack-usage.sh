@@ -0,0 +1,29 @@
+#!/bin/sh
+#
+#
+# Our per function stack report, needs a --enable-stackusage build.
+# Lists the largest library frames first, optionally only those over a budget.
+#
+# usage: ./stack-usage.sh [bytes] [count]
+
+budget=${1:-0}
+count=${2:-40}
+
+files=`find ctaocrypt/src src -name "*.su" 2> /dev/null`
+
+if [ "$files" = "" ]; then
+    echo "no .su files, configure with --enable-stackusage and build" >&2
+    exit 1
+fi
+
+cat $files | sort -t "	" -k 2 -n -r | \
+    awk -F "	" -v budget="$budget" '$2 > budget' | head -n "$count"
+
+over=`cat $files | awk -F "	" -v budget="$budget" '$2 > budget' | wc -l`
+
+if [ "$budget" -gt 0 ] && [ "$over" -gt 0 ]; then
+    echo "$over frames over $budget bytes" >&2
+    exit 1
+fi
+
+exit 0
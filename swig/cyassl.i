@@ -33,12 +33,66 @@
 %}
 
 
+/* read and write take any object with the buffer protocol, bytes, str,
+   bytearray, memoryview, array, and use its memory directly, a read fills
+   the whole buffer at most, pass a memoryview slice for part of one */
+%typemap(in) (unsigned char* buf, int sz) (Py_buffer view) {
+    view.obj = NULL;
+    if (PyObject_GetBuffer($input, &view, PyBUF_WRITABLE) != 0)
+        SWIG_fail;
+    $1 = (unsigned char*)view.buf;
+    $2 = view.len > INT_MAX ? INT_MAX : (int)view.len;
+}
+%typemap(freearg) (unsigned char* buf, int sz) {
+    PyBuffer_Release(&view$argnum);
+}
+
+%typemap(in) (const unsigned char* data, int sz) (Py_buffer view) {
+    view.obj = NULL;
+    if (PyObject_GetBuffer($input, &view, PyBUF_SIMPLE) != 0)
+        SWIG_fail;
+    $1 = (const unsigned char*)view.buf;
+    $2 = view.len > INT_MAX ? INT_MAX : (int)view.len;
+}
+%typemap(freearg) (const unsigned char* data, int sz) {
+    PyBuffer_Release(&view$argnum);
+}
+
+
+/* calls that block on the network or do handshake crypto let other Python
+   threads run, the buffers above stay exported meanwhile */
+%define CYASSL_RELEASE_GIL(func)
+%exception func {
+    Py_BEGIN_ALLOW_THREADS
+    $action
+    Py_END_ALLOW_THREADS
+}
+%enddef
+
+CYASSL_RELEASE_GIL(CyaSSL_read);
+CYASSL_RELEASE_GIL(CyaSSL_write);
+CYASSL_RELEASE_GIL(CyaSSL_connect);
+CYASSL_RELEASE_GIL(CyaSSL_accept);
+CYASSL_RELEASE_GIL(CyaSSL_shutdown);
+CYASSL_RELEASE_GIL(CyaSSL_swig_connect);
+
+
 CYASSL_METHOD* CyaTLSv1_client_method(void);
+CYASSL_METHOD* CyaTLSv1_server_method(void);
 CYASSL_CTX*    CyaSSL_CTX_new(CYASSL_METHOD*);
+void           CyaSSL_CTX_free(CYASSL_CTX*);
 int            CyaSSL_CTX_load_verify_locations(CYASSL_CTX*, const char*, const char*);
+int            CyaSSL_CTX_use_certificate_file(CYASSL_CTX*, const char*, int);
+int            CyaSSL_CTX_use_PrivateKey_file(CYASSL_CTX*, const char*, int);
 CYASSL*        CyaSSL_new(CYASSL_CTX*);
+void           CyaSSL_free(CYASSL*);
+int            CyaSSL_set_fd(CYASSL*, int);
 int            CyaSSL_get_error(CYASSL*, int);
-int            CyaSSL_write(CYASSL*, const char*, int);
+int            CyaSSL_connect(CYASSL*);
+int            CyaSSL_accept(CYASSL*);
+int            CyaSSL_shutdown(CYASSL*);
+int            CyaSSL_read(CYASSL*, unsigned char* buf, int sz);
+int            CyaSSL_write(CYASSL*, const unsigned char* data, int sz);
 int            CyaSSL_Debugging_ON(void);
 int            CyaSSL_Init(void);
 char*          CyaSSL_error_string(int);
@@ -55,9 +109,9 @@ void    FillSignStr(unsigned char*, const char*, int);
 %include carrays.i
 %include cdata.i
 %array_class(unsigned char, byteArray);
-int         CyaSSL_read(CYASSL*, unsigned char*, int);
 
 
 #define    SSL_FAILURE      0
 #define    SSL_SUCCESS      1
+#define    SSL_FILETYPE_PEM 1
 
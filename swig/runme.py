@@ -28,13 +28,14 @@ if ret != cyassl.SSL_SUCCESS:
     exit(-1)
 
 print "...Connected"
-written = cyassl.CyaSSL_write(ssl, "hello from python\r\n", 19)
+written = cyassl.CyaSSL_write(ssl, "hello from python\r\n")
 
 if written > 0:
     print "Wrote ", written, " bytes"
 
-byteArray = cyassl.byteArray(100)
-readBytes = cyassl.CyaSSL_read(ssl, byteArray, 100)
+reply = bytearray(100)
+readBytes = cyassl.CyaSSL_read(ssl, reply)
 
-print "server reply: ", cyassl.cdata(byteArray, readBytes) 
+if readBytes > 0:
+    print "server reply: ", str(reply[:readBytes])
 
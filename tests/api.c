@@ -32,6 +32,10 @@
     #include <cyassl/ctaocrypt/ecc.h>   /* ecc_fp_free */
 #endif
 #include <cyassl/error-ssl.h>
+#include <cyassl/ctaocrypt/asn_public.h>  /* CERT_TYPE */
+#include <cyassl/ctaocrypt/asn.h>         /* ASN_COMMON_NAME */
+#include <cyassl/ctaocrypt/stats.h>
+#include <cyassl/ctaocrypt/cpuid.h>  /* CyaSSL_SetCpuFeatureMask */
 
 #include <stdlib.h>
 #include <cyassl/ssl.h>
@@ -1143,6 +1147,4036 @@ static void test_CyaSSL_UseSupportedCurve(void)
 #endif
 }
 
+/*----------------------------------------------------------------------------*
+ | Session Cache
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_UseOCSPStapling(void)
+{
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_CLIENT)
+    CYASSL_CTX *ctx = CyaSSL_CTX_new(CyaSSLv23_client_method());
+    CYASSL     *ssl = CyaSSL_new(ctx);
+
+    AssertNotNull(ctx);
+    AssertNotNull(ssl);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_UseOCSPStapling(NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseOCSPStapling(NULL));
+
+    /* success case */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseOCSPStapling(ctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_UseOCSPStapling(ssl));
+
+    CyaSSL_free(ssl);
+    CyaSSL_CTX_free(ctx);
+#endif
+#if defined(HAVE_CERTIFICATE_STATUS_REQUEST) && !defined(NO_CYASSL_SERVER)
+    {
+        CYASSL_CTX *sctx = CyaSSL_CTX_new(CyaSSLv23_server_method());
+
+        AssertNotNull(sctx);
+
+        /* error cases, no ctx or no certificate to staple for */
+        AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_EnableOCSPStapling(NULL));
+        AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_EnableOCSPStapling(sctx));
+
+        CyaSSL_CTX_free(sctx);
+    }
+#endif
+}
+
+static void test_CyaSSL_set_session_cache_size(void)
+{
+#ifndef NO_SESSION_CACHE
+    int defaultSz = CyaSSL_get_session_cache_size();
+
+    AssertTrue(defaultSz > 0);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_set_session_cache_size(-1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_set_session_cache_size(0x7FFFFFFF));
+    AssertIntEQ(defaultSz, CyaSSL_get_session_cache_size());
+
+    /* success cases */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(1));
+    AssertTrue(CyaSSL_get_session_cache_size() >= 1);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(0));
+    AssertIntEQ(defaultSz, CyaSSL_get_session_cache_size());
+
+    /* private CTX cache */
+    {
+        CYASSL_CTX* ctx;
+
+        AssertNotNull(ctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+        AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(NULL, 10));
+        AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(ctx, -1));
+        AssertIntEQ(defaultSz, CyaSSL_CTX_get_session_cache_size(ctx));
+
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(ctx, 50));
+        AssertTrue(CyaSSL_CTX_get_session_cache_size(ctx) >= 50);
+        AssertIntEQ(defaultSz, CyaSSL_get_session_cache_size());
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(ctx, 500));
+        AssertTrue(CyaSSL_CTX_get_session_cache_size(ctx) >= 500);
+    #ifdef OPENSSL_EXTRA
+        AssertIntEQ(0, CyaSSL_CTX_sess_number(ctx));
+        AssertIntEQ(0, CyaSSL_CTX_sess_hits(ctx));
+    #endif
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(ctx, 0));
+        AssertIntEQ(defaultSz, CyaSSL_CTX_get_session_cache_size(ctx));
+
+        /* freed with the CTX */
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(ctx, 50));
+        CyaSSL_CTX_free(ctx);
+    }
+
+    /* leave a heap cache in place for the handshake tests, Cleanup frees */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(1000));
+    AssertTrue(CyaSSL_get_session_cache_size() >= 1000);
+#endif
+}
+
+static void test_CyaSSL_SESSION_serialize(void)
+{
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE)
+    /* version, id size, id, secret, born on, timeout, protocol, suite,
+       no certs, no server id, no ticket */
+    unsigned char der[1 + 1 + 32 + 48 + 4 + 4 + 2 + 2 + 1 + 2 + 2];
+    unsigned char out[sizeof(der)];
+    unsigned char* outP = out;
+    const unsigned char* p = der;
+    CYASSL_SESSION* sess = NULL;
+    CYASSL_CTX*     ctx;
+    int i = 0;
+
+    memset(der, 0, sizeof(der));
+    der[i++] = 1;
+    der[i++] = 32;
+    for (; i < 2 + 32 + 48; i++)
+        der[i] = (unsigned char)i;
+    der[i++] = 0x01; der[i++] = 0x02; der[i++] = 0x03; der[i++] = 0x04;
+    der[i++] = 0x00; der[i++] = 0x00; der[i++] = 0x01; der[i++] = 0xF4;
+
+    /* error cases */
+    AssertNull(CyaSSL_d2i_SSL_SESSION(NULL, NULL, sizeof(der)));
+    AssertNull(CyaSSL_d2i_SSL_SESSION(NULL, &p, sizeof(der) - 1));
+    AssertTrue(p == der);
+    AssertIntEQ(0, CyaSSL_i2d_SSL_SESSION(NULL, NULL));
+
+    /* round trip */
+    AssertNotNull(CyaSSL_d2i_SSL_SESSION(&sess, &p, sizeof(der)));
+    AssertTrue(p == der + sizeof(der));
+    AssertIntEQ(500, CyaSSL_SESSION_get_timeout(sess));
+    AssertIntEQ(0x01020304, CyaSSL_SESSION_get_time(sess));
+
+    AssertIntEQ(sizeof(der), CyaSSL_i2d_SSL_SESSION(sess, NULL));
+    AssertIntEQ(sizeof(der), CyaSSL_i2d_SSL_SESSION(sess, &outP));
+    AssertTrue(outP == out + sizeof(out));
+    AssertIntEQ(0, memcmp(der, out, sizeof(der)));
+    CyaSSL_SESSION_free(sess);
+
+    /* callbacks and modes just need to take */
+    AssertNotNull(ctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    CyaSSL_CTX_sess_set_get_cb(ctx, NULL);
+    CyaSSL_CTX_sess_set_new_cb(ctx, NULL);
+    CyaSSL_CTX_sess_set_remove_cb(ctx, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_mode(ctx,
+                                                  SSL_SESS_CACHE_NO_INTERNAL));
+    CyaSSL_CTX_free(ctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | In Memory IO
+ *----------------------------------------------------------------------------*/
+
+#if !defined(NO_CYASSL_CLIENT) && !defined(NO_CYASSL_SERVER) \
+    && !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+
+#define HAVE_MEMIO_TESTS_DEPENDENCIES
+
+/* one way in memory pipe, so both ends can run in this thread */
+typedef struct test_memio {
+    char buf[81920];
+    int  len;
+    int  sends;
+    int  recvs;
+    int  mores;     /* sends flagged with more of the flight to come */
+    int  lastMore;
+} test_memio;
+
+static int test_memio_send(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    test_memio* io = (test_memio*)ctx;
+
+    (void)ssl;
+
+    if (io->len + sz > (int)sizeof(io->buf))
+        return CYASSL_CBIO_ERR_GENERAL;
+
+    memcpy(io->buf + io->len, buf, sz);
+    io->len += sz;
+    io->sends++;
+    io->lastMore = CyaSSL_GetIOSendMore(ssl);
+    io->mores   += io->lastMore;
+
+    return sz;
+}
+
+static int test_memio_recv(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    test_memio* io = (test_memio*)ctx;
+
+    (void)ssl;
+
+    io->recvs++;
+    if (io->len == 0)
+        return CYASSL_CBIO_ERR_WANT_READ;
+
+    if (sz > io->len)
+        sz = io->len;
+
+    memcpy(buf, io->buf, sz);
+    memmove(io->buf, io->buf + sz, io->len - sz);
+    io->len -= sz;
+
+    return sz;
+}
+
+/* Contexts given as NULL are made with the default methods, the server with
+ * its RSA cert and the client not verifying it, and both get the memory IO
+ * callbacks. A client or server is only made when asked for, and is wired to
+ * the pipes so toServer carries what the client sends. */
+static void test_memio_setup(CYASSL_CTX** cctx, CYASSL_CTX** sctx,
+                             CYASSL** client, CYASSL** server,
+                             test_memio* toServer, test_memio* toClient)
+{
+    if (*sctx == NULL) {
+        AssertNotNull(*sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+        AssertTrue(CyaSSL_CTX_use_certificate_file(*sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+        AssertTrue(CyaSSL_CTX_use_PrivateKey_file(*sctx, svrKey,
+                                                            SSL_FILETYPE_PEM));
+    }
+    if (*cctx == NULL) {
+        AssertNotNull(*cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+        CyaSSL_CTX_set_verify(*cctx, SSL_VERIFY_NONE, 0);
+    }
+    CyaSSL_SetIORecv(*sctx, test_memio_recv);
+    CyaSSL_SetIOSend(*sctx, test_memio_send);
+    CyaSSL_SetIORecv(*cctx, test_memio_recv);
+    CyaSSL_SetIOSend(*cctx, test_memio_send);
+
+    if (client != NULL) {
+        AssertNotNull(*client = CyaSSL_new(*cctx));
+        CyaSSL_SetIOWriteCtx(*client, toServer);
+        CyaSSL_SetIOReadCtx(*client, toClient);
+    }
+    if (server != NULL) {
+        AssertNotNull(*server = CyaSSL_new(*sctx));
+        CyaSSL_SetIOWriteCtx(*server, toClient);
+        CyaSSL_SetIOReadCtx(*server, toServer);
+    }
+}
+
+static int test_memio_handshake(CYASSL* client, CYASSL* server)
+{
+    int i;
+    int c = SSL_FATAL_ERROR;
+    int s = SSL_FATAL_ERROR;
+
+    for (i = 0; i < 10 && (c != SSL_SUCCESS || s != SSL_SUCCESS); i++) {
+        if (c != SSL_SUCCESS) {
+            c = CyaSSL_connect(client);
+            if (c != SSL_SUCCESS &&
+                               CyaSSL_get_error(client, c) != SSL_ERROR_WANT_READ)
+                return c;
+        }
+        if (s != SSL_SUCCESS) {
+            s = CyaSSL_accept(server);
+            if (s != SSL_SUCCESS &&
+                               CyaSSL_get_error(server, s) != SSL_ERROR_WANT_READ)
+                return s;
+        }
+    }
+
+    return c == SSL_SUCCESS && s == SSL_SUCCESS ? SSL_SUCCESS : SSL_FATAL_ERROR;
+}
+
+#endif /* HAVE_MEMIO_TESTS_DEPENDENCIES */
+
+/*----------------------------------------------------------------------------*
+ | Zero Copy Read, Gather and Coalesced Write
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_read_zc(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    static unsigned char msg[40000];
+    static unsigned char got[40000];
+    const unsigned char* view;
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         recSz = 4096;
+    int         i;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)i;
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+    /* bad args */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_zc(NULL, &view));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_zc(server, NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_zc_release(NULL, 0));
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+#ifdef CYASSL_KTLS
+    /* kernel offload needs the default socket IO */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_EnableKTLS(NULL, CYASSL_KTLS_TX));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_EnableKTLS(client, 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_EnableKTLS(client, 0x04));
+    AssertIntEQ(KTLS_E, CyaSSL_EnableKTLS(client, CYASSL_KTLS_TX));
+    AssertIntEQ(KTLS_E, CyaSSL_EnableKTLS(server, CYASSL_KTLS_RX));
+    AssertIntEQ(0, CyaSSL_GetKTLS(client));
+#endif
+
+    /* nothing sent yet */
+    AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read_zc(server, &view));
+    AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server, 0));
+
+    /* whole record in one view, released in two parts */
+    AssertIntEQ(recSz, CyaSSL_write(client, msg, recSz));
+    AssertIntEQ(recSz, CyaSSL_read_zc(server, &view));
+    AssertIntEQ(0, memcmp(view, msg, recSz));
+    AssertIntEQ(recSz, CyaSSL_pending(server));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_zc_release(server, recSz + 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_zc_release(server, -1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_read_zc_release(server, 1000));
+
+    /* rest of the record is still there, for either read style */
+    AssertIntEQ(recSz - 1000, CyaSSL_read_zc(server, &view));
+    AssertIntEQ(0, memcmp(view, msg + 1000, recSz - 1000));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_read_zc_release(server, recSz - 1000));
+    AssertIntEQ(0, CyaSSL_pending(server));
+
+#if !defined(USE_WINDOWS_API) && !defined(NO_WRITEV)
+    {
+        struct iovec iov[4];
+
+        /* fragments are packed into a single record */
+        iov[0].iov_base = msg;        iov[0].iov_len = 100;
+        iov[1].iov_base = msg + 100;  iov[1].iov_len = 0;
+        iov[2].iov_base = msg + 100;  iov[2].iov_len = 3000;
+        iov[3].iov_base = msg + 3100; iov[3].iov_len = 10;
+        AssertIntEQ(BAD_FUNC_ARG, CyaSSL_writev(NULL, iov, 4));
+        AssertIntEQ(BAD_FUNC_ARG, CyaSSL_writev(client, NULL, 4));
+        AssertIntEQ(3110, CyaSSL_writev(client, iov, 4));
+        AssertIntEQ(3110, CyaSSL_read_zc(server, &view));
+        AssertIntEQ(0, memcmp(view, msg, 3110));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_read_zc_release(server, 3110));
+        AssertIntEQ(0, CyaSSL_writev(client, iov, 0));
+    }
+#endif
+
+    /* write coalescing, three records go out in one send */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_write_coalesce(NULL, 65536));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_write_coalesce(NULL, 65536));
+    for (i = 0; i < 2; i++) {
+        int sends = toServer.sends;
+        int idx   = 0;
+
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_write_coalesce(client,
+                                                          i ? 0 : 65536));
+        AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+        AssertIntEQ(i ? 3 : 1, toServer.sends - sends);
+
+        while (idx < (int)sizeof(msg)) {
+            int ret = CyaSSL_read(server, got + idx, sizeof(got) - idx);
+            AssertTrue(ret > 0);
+            idx += ret;
+        }
+        AssertIntEQ(0, memcmp(got, msg, sizeof(msg)));
+    }
+
+    /* close notify ends the stream */
+    CyaSSL_shutdown(client);
+    AssertIntEQ(0, CyaSSL_read_zc(server, &view));
+    AssertNull(view);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_read_ahead(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    static char       hold[2048];
+    unsigned char     msg[1000];
+    unsigned char     got[1000];
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         recvs;
+    int         recSz;
+    int         i;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)i;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_read_ahead(NULL, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_read_ahead(NULL, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_read_ahead(sctx, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_get_read_demand(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_read_all(NULL, got, sizeof(got)));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_read_ahead(sctx, 1));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_read_ahead(client, 1));
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    AssertIntEQ(5, CyaSSL_get_read_demand(server));   /* a record header */
+
+    /* three records drained with one recv, plus the one that would block */
+    for (i = 0; i < 3; i++)
+        AssertIntEQ(100, CyaSSL_write(client, msg + i * 100, 100));
+    recvs = toServer.recvs;
+    AssertIntEQ(300, CyaSSL_read_all(server, got, sizeof(got)));
+    AssertIntEQ(0, memcmp(got, msg, 300));
+    AssertIntEQ(2, toServer.recvs - recvs);
+    AssertIntEQ(1, CyaSSL_want_read(server));
+
+    /* the second record stays buffered behind the first one's plaintext */
+    AssertIntEQ(100, CyaSSL_write(client, msg, 100));
+    AssertIntEQ(100, CyaSSL_write(client, msg + 100, 100));
+    AssertIntEQ(10, CyaSSL_read(server, got, 10));
+    AssertIntEQ(90, CyaSSL_pending(server));
+    AssertIntEQ(0, CyaSSL_get_read_demand(server));
+    AssertIntEQ(90, CyaSSL_read(server, got + 10, sizeof(got) - 10));
+    AssertIntEQ(0, CyaSSL_get_read_demand(server));
+    recvs = toServer.recvs;
+    AssertIntEQ(100, CyaSSL_read(server, got + 100, sizeof(got) - 100));
+    AssertIntEQ(recvs, toServer.recvs);
+    AssertIntEQ(0, memcmp(got, msg, 200));
+
+    /* exact demand while a record trickles in */
+    AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    recSz = toServer.len;
+    AssertTrue(recSz <= (int)sizeof(hold));
+    memcpy(hold, toServer.buf, recSz);
+    toServer.len = 3;
+    AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(server, got, sizeof(got)));
+    AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server, 0));
+    AssertIntEQ(2, CyaSSL_get_read_demand(server));
+    memcpy(toServer.buf, hold + 3, 12);
+    toServer.len = 12;
+    AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(server, got, sizeof(got)));
+    AssertIntEQ(recSz - 15, CyaSSL_get_read_demand(server));
+    memcpy(toServer.buf, hold + 15, recSz - 15);
+    toServer.len = recSz - 15;
+    AssertIntEQ(sizeof(msg), CyaSSL_read_all(server, got, sizeof(got)));
+    AssertIntEQ(0, memcmp(got, msg, sizeof(msg)));
+    AssertIntEQ(5, CyaSSL_get_read_demand(server));
+
+    /* 20 records are more than the default buffer, but one 64k recv */
+    for (i = 0; i < 2; i++) {
+        static unsigned char all[20 * sizeof(msg)];
+        int j;
+
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_read_ahead(server,
+                                                       i ? 65536 : 1));
+        for (j = 0; j < 20; j++)
+            AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+        recvs = toServer.recvs;
+        AssertIntEQ(sizeof(all), CyaSSL_read_all(server, all, sizeof(all)));
+        AssertIntEQ(0, memcmp(all + 19 * sizeof(msg), msg, sizeof(msg)));
+        AssertIntEQ(i ? 1 : 2, toServer.recvs - recvs);
+    }
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_read_ahead_max_fragment(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(HAVE_MAX_FRAGMENT)
+    static test_memio toServer, toClient;
+    unsigned char     msg[100];
+    static unsigned char got[5000];
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         recvs;
+    int         i;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)i;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_read_ahead(sctx, 1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseMaxFragment(cctx, CYASSL_MFL_2_12));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+    /* a full size read ahead takes these in one recv, one 4096 byte
+       fragment record's worth of buffer can't */
+    for (i = 0; i < 40; i++)
+        AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    AssertTrue(toServer.len > 5000);
+    recvs = toServer.recvs;
+    AssertIntEQ(40 * sizeof(msg), CyaSSL_read_all(server, got, sizeof(got)));
+    AssertIntEQ(0, memcmp(got + 39 * sizeof(msg), msg, sizeof(msg)));
+    AssertTrue(toServer.recvs - recvs > 2);
+
+    /* bigger writes are split to the negotiated fragment */
+    AssertIntEQ(5000, CyaSSL_write(client, got, 5000));
+    AssertIntEQ(4096, CyaSSL_read(server, got, sizeof(got)));
+    AssertIntEQ(904, CyaSSL_read_all(server, got, sizeof(got)));
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+/* number of TLS records waiting in io, the first one's size in *firstSz */
+static int test_memio_records(test_memio* io, int* firstSz)
+{
+    int idx = 0;
+    int cnt = 0;
+
+    *firstSz = 0;
+    while (idx + 5 <= io->len) {
+        int sz = ((unsigned char)io->buf[idx + 3] << 8) |
+                  (unsigned char)io->buf[idx + 4];
+        if (cnt++ == 0)
+            *firstSz = sz;
+        idx += 5 + sz;
+    }
+
+    return cnt;
+}
+#endif
+
+static void test_CyaSSL_record_sizing(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio  toServer, toClient;
+    static unsigned char msg[10000];
+    static unsigned char got[10000];
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         firstSz;
+    int         idx;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_record_sizing(NULL, 1400, 0, 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_record_sizing(sctx, 16385, 0, 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_record_sizing(NULL, 1400, 0, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_record_sizing(sctx, 1400, 4000,
+                                                          1));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+    /* 3 small records cover the ramp, the rest goes in one */
+    AssertIntEQ(sizeof(msg), CyaSSL_write(server, msg, sizeof(msg)));
+    AssertIntEQ(4, test_memio_records(&toClient, &firstSz));
+    AssertTrue(firstSz > 1400 && firstSz < 1500);
+    for (idx = 0; idx < (int)sizeof(msg); ) {
+        int ret = CyaSSL_read(client, got + idx, sizeof(got) - idx);
+        AssertTrue(ret > 0);
+        idx += ret;
+    }
+
+    /* ramped up now */
+    AssertIntEQ(sizeof(msg), CyaSSL_write(server, msg, sizeof(msg)));
+    AssertIntEQ(1, test_memio_records(&toClient, &firstSz));
+    AssertTrue(firstSz > (int)sizeof(msg));
+    AssertIntEQ(sizeof(msg), CyaSSL_read(client, got, sizeof(got)));
+
+    /* off, the client never was on */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_record_sizing(server, 0, 0, 0));
+    AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    AssertIntEQ(1, test_memio_records(&toServer, &firstSz));
+    AssertIntEQ(sizeof(msg), CyaSSL_read(server, got, sizeof(got)));
+
+    /* set on the ssl starts the ramp again */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_record_sizing(client, 1000, 1, 0));
+    AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    AssertIntEQ(2, test_memio_records(&toServer, &firstSz));
+    AssertTrue(firstSz > 1000 && firstSz < 1100);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_flight_more(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         group;
+
+    AssertIntEQ(0, CyaSSL_GetIOSendMore(NULL));
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    for (group = 0; group < 2; group++) {
+        memset(&toServer, 0, sizeof(toServer));
+        memset(&toClient, 0, sizeof(toClient));
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        if (group) {
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_set_group_messages(client));
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_set_group_messages(server));
+        }
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        /* every flight ends on a flushing send */
+        AssertIntEQ(0, toClient.lastMore);
+        AssertIntEQ(0, toServer.lastMore);
+        AssertIntEQ(0, CyaSSL_GetIOSendMore(server));
+        if (group) {
+            AssertIntEQ(0, toClient.mores);
+            AssertIntEQ(0, toServer.mores);
+        }
+        else {
+            /* ServerHello and Certificate at least, the client's CCS */
+            AssertTrue(toClient.mores >= 2);
+            AssertTrue(toServer.mores >= 1);
+            AssertTrue(toClient.sends > toClient.mores);
+        }
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+
+/* move all of from's pending records to to, seg bytes at a time, return the
+   count */
+static int test_mem_io_move(CYASSL* from, CYASSL* to, int seg)
+{
+    static unsigned char buf[81920];
+    int sz;
+    int i;
+
+    AssertIntLE(CyaSSL_pending_output(from), (int)sizeof(buf));
+    sz = CyaSSL_take_output(from, buf, sizeof(buf));
+    AssertIntEQ(0, CyaSSL_pending_output(from));
+
+    for (i = 0; i < sz; i += seg)
+        AssertIntEQ(sz - i < seg ? sz - i : seg,
+                    CyaSSL_feed_input(to, buf + i, sz - i < seg ? sz - i : seg));
+
+    return sz;
+}
+
+#endif
+
+static void test_CyaSSL_SetMemIO(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    static unsigned char msg[40000];
+    static unsigned char got[40000];
+    static unsigned char wire[81920];
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         c = SSL_FATAL_ERROR;
+    int         s = SSL_FATAL_ERROR;
+    int         i;
+    int         sz;
+    int         fed;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)i;
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+    /* bad args, and feeding or taking needs memory IO on */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_SetMemIO(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_feed_input(client, msg, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_take_output(client, got, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_pending_output(NULL));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_SetMemIO(client));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_SetMemIO(server));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_feed_input(NULL, msg, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_feed_input(client, NULL, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_feed_input(client, msg, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_take_output(NULL, got, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_take_output(client, NULL, 1));
+    AssertIntEQ(0, CyaSSL_take_output(client, got, sizeof(got)));
+
+    /* whole flights come out in one take, fed back a few bytes at a time */
+    for (i = 0; i < 10 && (c != SSL_SUCCESS || s != SSL_SUCCESS); i++) {
+        if (c != SSL_SUCCESS) {
+            c = CyaSSL_connect(client);
+            if (c != SSL_SUCCESS)
+                AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(client, c));
+        }
+        test_mem_io_move(client, server, 7);
+        if (s != SSL_SUCCESS) {
+            s = CyaSSL_accept(server);
+            if (s != SSL_SUCCESS)
+                AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server, s));
+        }
+        test_mem_io_move(server, client, 1000);
+    }
+    AssertIntEQ(SSL_SUCCESS, c);
+    AssertIntEQ(SSL_SUCCESS, s);
+
+    /* several records, taken at once, fed in segments between small reads
+       so the input buffer moves under plaintext not read yet */
+    AssertIntEQ((int)sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    AssertIntGT(sz = CyaSSL_pending_output(client), (int)sizeof(msg));
+    AssertIntLE(sz, (int)sizeof(wire));
+    AssertIntEQ(sz, CyaSSL_take_output(client, wire, sizeof(wire)));
+    AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(server, got, 1));
+    AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server, 0));
+
+    for (i = 0, fed = 0; i < (int)sizeof(got); ) {
+        int ret;
+
+        if (fed < sz) {
+            ret = sz - fed < 3000 ? sz - fed : 3000;
+            AssertIntEQ(ret, CyaSSL_feed_input(server, wire + fed, ret));
+            fed += ret;
+        }
+        ret = CyaSSL_read(server, got + i, 100);
+        if (ret < 0)
+            AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server, 0));
+        else
+            i += ret;
+    }
+    AssertIntEQ(0, memcmp(msg, got, sizeof(msg)));
+
+    /* and a reply split across two feeds */
+    AssertIntEQ(5, CyaSSL_write(server, "hello", 5));
+    AssertIntGT(sz = CyaSSL_pending_output(server), 5);
+    AssertIntEQ(3, CyaSSL_take_output(server, got, 3));
+    AssertIntEQ(sz - 3, CyaSSL_pending_output(server));
+    AssertIntEQ(3, CyaSSL_feed_input(client, got, 3));
+    AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(client, got, sizeof(got)));
+    AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(client, 0));
+    test_mem_io_move(server, client, sz);
+    AssertIntEQ(5, CyaSSL_read(client, got, sizeof(got)));
+    AssertIntEQ(0, memcmp("hello", got, 5));
+
+    /* the callbacks never ran */
+    AssertIntEQ(0, toServer.sends + toServer.recvs);
+    AssertIntEQ(0, toClient.sends + toClient.recvs);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_false_start(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    const char* suites[] = {
+    #if defined(HAVE_ECC) && defined(HAVE_AESGCM)
+        "ECDHE-RSA-AES128-GCM-SHA256",
+    #endif
+        "AES128-SHA"
+    };
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    char        buf[16];
+    int         i, early;
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_false_start(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_false_start(NULL));
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_false_start(cctx));
+
+    for (i = 0; i < (int)(sizeof(suites) / sizeof(suites[0])); i++) {
+        /* only the forward secret AEAD suite may go early */
+        early = strncmp(suites[i], "ECDHE", 5) == 0;
+
+        memset(&toServer, 0, sizeof(toServer));
+        memset(&toClient, 0, sizeof(toClient));
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client, suites[i]));
+
+        /* ClientHello, then the server's first flight */
+        AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+        AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server));
+
+        /* client's second flight, done early without the server Finished */
+        if (!early) {
+            AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+            AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(client, 0));
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+        }
+        else {
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_connect(client));
+            AssertIntEQ(0, toClient.len);
+            AssertIntEQ(5, CyaSSL_write(client, "early", 5));
+
+            /* server takes the app data right behind the client Finished */
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_accept(server));
+            AssertIntEQ(5, CyaSSL_read(server, buf, sizeof(buf)));
+            AssertIntEQ(0, memcmp(buf, "early", 5));
+        }
+
+        /* first client read checks the server Finished */
+        AssertIntEQ(4, CyaSSL_write(server, "late", 4));
+        AssertIntEQ(4, CyaSSL_read(client, buf, sizeof(buf)));
+        AssertIntEQ(0, memcmp(buf, "late", 4));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_connect(client));
+        AssertIntEQ(5, CyaSSL_write(client, "after", 5));
+        AssertIntEQ(5, CyaSSL_read(server, buf, sizeof(buf)));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_UseEncryptThenMac(void)
+{
+#ifdef HAVE_ENCRYPT_THEN_MAC
+    CYASSL_CTX *ctx = CyaSSL_CTX_new(CyaSSLv23_client_method());
+    CYASSL     *ssl = CyaSSL_new(ctx);
+
+    AssertNotNull(ctx);
+    AssertNotNull(ssl);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_UseEncryptThenMac(NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseEncryptThenMac(NULL));
+
+    /* success case */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseEncryptThenMac(ctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_UseEncryptThenMac(ssl));
+
+    CyaSSL_free(ssl);
+    CyaSSL_CTX_free(ctx);
+
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_AES) \
+    && !defined(NO_RSA)
+    {
+        static test_memio toServer, toClient;
+        static unsigned char msg[3000];
+        static unsigned char got[3000];
+        const int   sizes[] = { 1, 15, 16, 20, 1025, 3000 };
+        CYASSL_CTX* cctx;
+        CYASSL_CTX* sctx = NULL;
+        CYASSL*     client;
+        CYASSL*     server;
+        int         i, k;
+
+        for (i = 0; i < (int)sizeof(msg); i++)
+            msg[i] = (unsigned char)(i * 7);
+
+        /* TLS 1.0 has no explicit IV, TLS 1.2 does */
+        for (k = 0; k < 2; k++) {
+        #ifdef NO_OLD_TLS
+            if (k == 0)
+                continue;
+        #endif
+            AssertNotNull(cctx = CyaSSL_CTX_new(k ? CyaTLSv1_2_client_method()
+                                                  : CyaTLSv1_client_method()));
+            CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseEncryptThenMac(cctx));
+
+            toServer.len = toClient.len = 0;
+            test_memio_setup(&cctx, &sctx, &client, &server, &toServer,
+                             &toClient);
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client,
+                                                                "AES128-SHA"));
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+            for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+                AssertIntEQ(sizes[i], CyaSSL_write(client, msg, sizes[i]));
+                /* 20 byte SHA-1 mac after whole blocks, past the 5 byte
+                   record header */
+                AssertIntEQ(4, (toServer.len - 5) & 15);
+                AssertIntEQ(sizes[i], CyaSSL_read(server, got, sizeof(got)));
+                AssertIntEQ(0, memcmp(got, msg, sizes[i]));
+                AssertIntEQ(sizes[i], CyaSSL_write(server, msg, sizes[i]));
+                AssertIntEQ(4, (toClient.len - 5) & 15);
+                AssertIntEQ(sizes[i], CyaSSL_read(client, got, sizeof(got)));
+                AssertIntEQ(0, memcmp(got, msg, sizes[i]));
+            }
+
+            /* a flipped ciphertext bit fails the mac before any decrypt */
+            AssertIntEQ(100, CyaSSL_write(client, msg, 100));
+            toServer.buf[toServer.len - 21] ^= 0x01;
+            AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(server, got, sizeof(got)));
+            AssertIntEQ(DECRYPT_ERROR, CyaSSL_get_error(server, 0));
+
+            CyaSSL_free(client);
+            CyaSSL_free(server);
+
+        #ifdef HAVE_AESGCM
+            /* no response for an aead suite, records stay as they were */
+            if (k == 1) {
+                toServer.len = toClient.len = 0;
+                test_memio_setup(&cctx, &sctx, &client, &server, &toServer,
+                                 &toClient);
+                AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client,
+                                                "AES128-GCM-SHA256"));
+                AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+                AssertIntEQ(100, CyaSSL_write(client, msg, 100));
+                AssertIntEQ(100, CyaSSL_read(server, got, sizeof(got)));
+                AssertIntEQ(0, memcmp(got, msg, 100));
+                CyaSSL_free(client);
+                CyaSSL_free(server);
+            }
+        #endif
+
+            CyaSSL_CTX_free(cctx);
+        }
+
+        CyaSSL_CTX_free(sctx);
+    }
+#endif
+#endif
+}
+
+#if defined(HAVE_CACHED_INFO) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+/* one connection offering chain if not NULL, flightSz gets the size of the
+   server's first flight, the held chain is copied back into chain */
+static int test_cached_info_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                       unsigned char* chain, unsigned int* chainSz,
+                       int* flightSz)
+{
+    static test_memio toServer, toClient;
+    CYASSL* client;
+    CYASSL* server;
+    char    buf[16];
+    int     ret;
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_UseCachedInfo(client,
+                                      *chainSz ? chain : NULL, *chainSz));
+
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server));
+    *flightSz = toClient.len;
+
+    ret = test_memio_handshake(client, server);
+    if (ret == SSL_SUCCESS) {
+        AssertIntEQ(5, CyaSSL_write(client, "hello", 5));
+        AssertIntEQ(5, CyaSSL_read(server, buf, sizeof(buf)));
+        *chainSz = 8192;
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_GetCachedInfo(client, chain, chainSz));
+    }
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return ret;
+}
+#endif
+
+static void test_CyaSSL_UseCachedInfo(void)
+{
+#ifdef HAVE_CACHED_INFO
+    CYASSL_CTX*  ctx = CyaSSL_CTX_new(CyaSSLv23_client_method());
+    CYASSL*      ssl = CyaSSL_new(ctx);
+    unsigned int sz  = 0;
+
+    AssertNotNull(ctx);
+    AssertNotNull(ssl);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseCachedInfo(NULL, NULL, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseCachedInfo(ssl, NULL, 1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_GetCachedInfo(NULL, NULL, &sz));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_GetCachedInfo(ssl, NULL, NULL));
+    AssertIntEQ(SSL_FAILURE, CyaSSL_GetCachedInfo(ssl, NULL, &sz));
+
+    /* success case */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_UseCachedInfo(ssl, NULL, 0));
+
+    CyaSSL_free(ssl);
+    CyaSSL_CTX_free(ctx);
+
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    {
+        static unsigned char chain[8192];
+        unsigned int chainSz = 0;
+        unsigned int held;
+        int          fullSz, cachedSz, missSz;
+        CYASSL_CTX*  cctx;
+        CYASSL_CTX*  sctx = NULL;
+
+        AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+        AssertTrue(CyaSSL_CTX_load_verify_locations(cctx, caCert, 0));
+        test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+        /* first visit, the full chain comes and is held */
+        AssertIntEQ(SSL_SUCCESS, test_cached_info_connect(cctx, sctx, chain,
+                                                         &chainSz, &fullSz));
+        AssertTrue(chainSz > 512);
+        held = chainSz;
+
+        /* returning, only its hash comes, still verified from the cache */
+        AssertIntEQ(SSL_SUCCESS, test_cached_info_connect(cctx, sctx, chain,
+                                                       &chainSz, &cachedSz));
+        AssertIntEQ(held, chainSz);
+        /* a 33 byte hash for the chain, 7 for the ServerHello extension and
+           2 more when it's the only one */
+        AssertTrue(cachedSz <= fullSz - (int)held + 33 + 7 + 2);
+        AssertTrue(cachedSz >= fullSz - (int)held + 33 + 7);
+
+        /* a stale chain isn't taken, the full one comes again */
+        chain[chainSz - 1] ^= 0x01;
+        AssertIntEQ(SSL_SUCCESS, test_cached_info_connect(cctx, sctx, chain,
+                                                         &chainSz, &missSz));
+        AssertIntEQ(fullSz, missSz);
+        AssertIntEQ(held, chainSz);
+
+        CyaSSL_CTX_free(cctx);
+        CyaSSL_CTX_free(sctx);
+    }
+#endif
+#endif
+}
+
+static void test_CyaSSL_cbc_records(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_AES) \
+    && !defined(NO_RSA) && !defined(NO_SHA256)
+    static test_memio toServer, toClient;
+    static unsigned char msg[16384];
+    static unsigned char got[16384];
+    const int   sizes[] = { 1, 15, 16, 1023, 1024, 1025, 3000, 16384 };
+    const char* suites[] = { "AES128-SHA", "AES256-SHA256" };
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i, j, k;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)(i * 7);
+
+    /* TLS 1.0 has no explicit IV, TLS 1.2 does */
+    for (k = 0; k < 2; k++) {
+    #ifdef NO_OLD_TLS
+        if (k == 0)
+            continue;
+    #endif
+        AssertNotNull(cctx = CyaSSL_CTX_new(k ? CyaTLSv1_2_client_method()
+                                              : CyaTLSv1_client_method()));
+        CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+
+        for (i = 0; i < (int)(sizeof(suites) / sizeof(suites[0])); i++) {
+            if (k == 0 && i == 1)
+                continue;  /* SHA-256 suites are TLS 1.2 only */
+
+            toServer.len = toClient.len = 0;
+            test_memio_setup(&cctx, &sctx, &client, &server, &toServer,
+                             &toClient);
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client,
+                                                                  suites[i]));
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+            /* sizes around block and chunk boundaries, both directions */
+            for (j = 0; j < (int)(sizeof(sizes) / sizeof(sizes[0])); j++) {
+                AssertIntEQ(sizes[j], CyaSSL_write(client, msg, sizes[j]));
+                AssertIntEQ(sizes[j], CyaSSL_read(server, got, sizeof(got)));
+                AssertIntEQ(0, memcmp(got, msg, sizes[j]));
+                AssertIntEQ(sizes[j], CyaSSL_write(server, msg, sizes[j]));
+                AssertIntEQ(sizes[j], CyaSSL_read(client, got, sizeof(got)));
+                AssertIntEQ(0, memcmp(got, msg, sizes[j]));
+            }
+
+            /* a flipped bit in the last block garbles the pad */
+            AssertIntEQ(100, CyaSSL_write(client, msg, 100));
+            toServer.buf[toServer.len - 1] ^= 0x01;
+            AssertIntEQ(SSL_FATAL_ERROR, CyaSSL_read(server, got, sizeof(got)));
+            AssertIntEQ(DECRYPT_ERROR, CyaSSL_get_error(server, 0));
+
+            CyaSSL_free(client);
+            CyaSSL_free(server);
+        }
+
+        CyaSSL_CTX_free(cctx);
+    }
+
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_CTX_SetWriteThreads(void)
+{
+#if defined(HAVE_PARALLEL_WRITE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_RSA)
+    static test_memio toServer, toClient;
+    static unsigned char msg[16384 * 4 + 1000];
+    static unsigned char got[sizeof(msg)];
+    const char* suites[] = {
+    #ifdef HAVE_AESGCM
+        "AES128-GCM-SHA256",
+    #endif
+    #if defined(HAVE_CHACHA) && defined(HAVE_POLY1305) && defined(HAVE_ECC)
+        "ECDHE-RSA-CHACHA20-POLY1305",
+    #endif
+        NULL
+    };
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i, j;
+
+    for (i = 0; i < (int)sizeof(msg); i++)
+        msg[i] = (unsigned char)(i * 13);
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetWriteThreads(NULL, 2));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetWriteThreads(cctx, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetWriteThreads(cctx, 100000));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetWriteThreads(cctx, 2));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetWriteThreads(cctx, 3));
+
+    for (i = 0; suites[i] != NULL; i++) {
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client, suites[i]));
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        /* four full records sealed as a batch in one send, the rest after,
+           twice so the sequence carries on right past a batch */
+        for (j = 0; j < 2; j++) {
+            int sends = toServer.sends;
+            int idx   = 0;
+
+            AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+            AssertIntEQ(2, toServer.sends - sends);
+
+            while (idx < (int)sizeof(msg)) {
+                int ret = CyaSSL_read(server, got + idx, sizeof(got) - idx);
+                AssertTrue(ret > 0);
+                idx += ret;
+            }
+            AssertIntEQ(0, memcmp(got, msg, sizeof(msg)));
+        }
+
+        /* small writes stay on this thread, in order with the batches */
+        AssertIntEQ(100, CyaSSL_write(client, msg, 100));
+        AssertIntEQ(100, CyaSSL_read(server, got, sizeof(got)));
+        AssertIntEQ(0, memcmp(got, msg, 100));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetWriteThreads(cctx, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetWriteThreads(cctx, 1));
+    CyaSSL_CTX_free(cctx);     /* stops the workers */
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_CTX_SetVerifyThreads(void)
+{
+#if defined(HAVE_PARALLEL_VERIFY) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_RSA) && !defined(NO_FILESYSTEM)
+    static test_memio toServer, toClient;
+    static unsigned char chain[16384];
+    const char* tops[] = { NULL, cliCert };
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i;
+
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_load_verify_locations(cctx, caCert, 0));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_PEER, 0);
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetVerifyThreads(NULL, 2));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetVerifyThreads(cctx, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetVerifyThreads(cctx, 100000));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetVerifyThreads(cctx, 1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetVerifyThreads(cctx, 2));
+
+    /* server cert file carries its CA, checked ahead, then a top cert
+       that signed nothing below it, which must fail the same as without
+       the workers */
+    for (i = 0; i < 2; i++) {
+        const char* parts[2];
+        size_t      sz = 0;
+        int         j;
+
+        parts[0] = svrCert;
+        parts[1] = tops[i];
+        for (j = 0; j < 2 && parts[j] != NULL; j++) {
+            FILE* in;
+
+            AssertNotNull(in = fopen(parts[j], "rb"));
+            sz += fread(chain + sz, 1, sizeof(chain) - sz, in);
+            fclose(in);
+        }
+
+        AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_use_certificate_chain_buffer(sctx,
+                                                             chain, (long)sz));
+        AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey,
+                                                            SSL_FILETYPE_PEM));
+
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        if (i == 0)
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+        else
+            AssertIntNE(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+        CyaSSL_CTX_free(sctx);
+    }
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetVerifyThreads(cctx, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetVerifyThreads(cctx, 1));
+    CyaSSL_CTX_free(cctx);     /* stops the workers */
+#endif
+}
+
+#if !defined(NO_CYASSL_SERVER) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_RSA) && !defined(NO_AES)
+static int         helloAction;           /* next callback return */
+static int         helloCalls;
+static CYASSL_CTX* helloRoute;            /* switch to it when set */
+
+static int test_client_hello_cb(CYASSL* ssl, const CYASSL_CLIENT_HELLO* hello,
+                                void* ctx)
+{
+    AssertTrue(ctx == (void*)1);
+    AssertIntEQ(3, hello->versionMajor);
+    AssertNotNull(hello->random);
+    AssertTrue(hello->suitesSz >= 2 && (hello->suitesSz & 1) == 0);
+#ifdef HAVE_SNI
+    AssertIntEQ(11, hello->sniSz);
+    AssertIntEQ(0, memcmp(hello->sni, "www.cya.com", 11));
+#endif
+    helloCalls++;
+
+    if (helloRoute)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_SSL_CTX(ssl, helloRoute));
+
+    return helloAction;
+}
+#endif
+
+static void test_CyaSSL_SetClientHelloCb(void)
+{
+#if !defined(NO_CYASSL_SERVER) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_RSA) && !defined(NO_AES)
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL_CTX* vctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i;
+
+    /* the front ctx has no suite the client offers, the routed one does */
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(vctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    for (i = 0; i < 2; i++) {
+        CYASSL_CTX* ctx = i == 0 ? sctx : vctx;
+
+        AssertTrue(CyaSSL_CTX_use_certificate_file(ctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+        AssertTrue(CyaSSL_CTX_use_PrivateKey_file(ctx, svrKey,
+                                                            SSL_FILETYPE_PEM));
+    }
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(sctx, "AES256-SHA"));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(cctx, "AES128-SHA"));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    CyaSSL_SetIORecv(vctx, test_memio_recv);
+    CyaSSL_SetIOSend(vctx, test_memio_send);
+    CyaSSL_CTX_SetClientHelloCb(sctx, test_client_hello_cb);
+
+    /* routed, rejected, then suspended once and resumed */
+    for (i = 0; i < 3; i++) {
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    #ifdef HAVE_SNI
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_UseSNI(client, CYASSL_SNI_HOST_NAME,
+                                               "www.cya.com", 11));
+    #endif
+        CyaSSL_SetClientHelloCtx(server, (void*)1);
+        AssertTrue(CyaSSL_GetClientHelloCtx(server) == (void*)1);
+        helloCalls = 0;
+        helloRoute = vctx;
+
+        if (i == 0) {
+            helloAction = CYASSL_CLIENT_HELLO_OK;
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+            AssertIntEQ(1, helloCalls);
+        }
+        else if (i == 1) {
+            helloAction = CYASSL_CLIENT_HELLO_REJECT;
+            AssertIntNE(SSL_SUCCESS, test_memio_handshake(client, server));
+            AssertIntEQ(CLIENT_HELLO_REJECT_E, CyaSSL_get_error(server, 0));
+        }
+        else {
+            /* vctx has no callback, only move there when done */
+            helloAction = CYASSL_CLIENT_HELLO_SUSPEND;
+            helloRoute  = NULL;
+            AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+            AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server));
+            AssertIntEQ(SSL_ERROR_WANT_CLIENT_HELLO,
+                        CyaSSL_get_error(server, 0));
+            AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server));
+            AssertIntEQ(SSL_ERROR_WANT_CLIENT_HELLO,
+                        CyaSSL_get_error(server, 0));
+
+            helloAction = CYASSL_CLIENT_HELLO_OK;
+            helloRoute  = vctx;
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+            AssertIntEQ(3, helloCalls);
+        }
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(vctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_chain_ca_cache(void)
+{
+#if defined(HAVE_VERIFY_CACHE) && defined(HAVE_DATE_EPOCH) && \
+    defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_RSA) && \
+    !defined(NO_FILESYSTEM)
+    static test_memio toServer, toClient;
+    const int   trusted[] = { 1, 1, 1, 0, 1 };
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    /* the server cert file carries the CA after it */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_use_certificate_chain_file(sctx,
+                                                                   svrCert));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_PEER, 0);
+
+    /* the chain CA is learned on the first, taken from the cache after,
+       and forgotten with the CAs it was verified under */
+    for (i = 0; i < (int)(sizeof(trusted) / sizeof(trusted[0])); i++) {
+        if (i == 0 || (trusted[i] && !trusted[i - 1]))
+            AssertTrue(CyaSSL_CTX_load_verify_locations(cctx, caCert, 0));
+        if (!trusted[i])
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UnloadCAs(cctx));
+
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        if (trusted[i])
+            AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+        else
+            AssertIntNE(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_hibernate(void)
+{
+#if defined(CYASSL_HIBERNATE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_AES) && !defined(NO_RSA)
+    static test_memio toServer, toClient;
+    unsigned char cBlob[512];
+    unsigned char sBlob[512];
+    unsigned int  cSz, sSz;
+    char          got[64];
+    CYASSL_CTX*   cctx;
+    CYASSL_CTX*   sctx = NULL;
+    CYASSL*       client;
+    CYASSL*       server;
+    int           i, k;
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_hibernate(NULL, cBlob, &cSz));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_wake(NULL, cBlob, sizeof(cBlob)));
+
+    /* TLS 1.0 CBC chains IVs across records, then TLS 1.2 with its default */
+    for (k = 0; k < 2; k++) {
+    #ifdef NO_OLD_TLS
+        if (k == 0)
+            continue;
+    #endif
+        AssertNotNull(cctx = CyaSSL_CTX_new(k ? CyaSSLv23_client_method()
+                                              : CyaTLSv1_client_method()));
+        CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        if (k == 0)
+            AssertIntEQ(SSL_SUCCESS, CyaSSL_set_cipher_list(client,
+                                                                "AES128-SHA"));
+
+        /* not established yet */
+        cSz = sizeof(cBlob);
+        AssertIntEQ(HIBERNATE_E, CyaSSL_hibernate(client, cBlob, &cSz));
+
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+        for (i = 0; i < 3; i++) {
+            AssertIntEQ(5, CyaSSL_write(client, "hello", 5));
+            AssertIntEQ(5, CyaSSL_read(server, got, sizeof(got)));
+        }
+
+        /* a record still sitting in the server's buffers blocks it */
+        AssertIntEQ(5, CyaSSL_write(client, "hello", 5));
+        AssertIntEQ(2, CyaSSL_read(server, got, 2));
+        sSz = sizeof(sBlob);
+        AssertIntEQ(HIBERNATE_E, CyaSSL_hibernate(server, sBlob, &sSz));
+        AssertIntEQ(3, CyaSSL_read(server, got, sizeof(got)));
+
+        AssertIntEQ(LENGTH_ONLY_E, CyaSSL_hibernate(server, NULL, &sSz));
+        AssertTrue(sSz <= sizeof(sBlob));
+        cSz = sSz - 1;
+        AssertIntEQ(BUFFER_E, CyaSSL_hibernate(client, cBlob, &cSz));
+        cSz = sizeof(cBlob);
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_hibernate(client, cBlob, &cSz));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_hibernate(server, sBlob, &sSz));
+        AssertIntEQ(cSz, sSz);
+        CyaSSL_free(server);
+
+        /* wrong side, short blob, then the real thing */
+        AssertNotNull(server = CyaSSL_new(sctx));
+        AssertIntEQ(HIBERNATE_E, CyaSSL_wake(server, cBlob, cSz));
+        AssertIntEQ(BUFFER_E, CyaSSL_wake(server, sBlob, sSz - 1));
+        CyaSSL_free(server);
+        AssertNotNull(server = CyaSSL_new(sctx));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_wake(server, sBlob, sSz));
+        AssertIntEQ(HIBERNATE_E, CyaSSL_wake(server, sBlob, sSz));
+        CyaSSL_SetIOWriteCtx(server, &toClient);
+        CyaSSL_SetIOReadCtx(server, &toServer);
+
+        /* the live client can't tell, and the client side wakes too */
+        for (i = 0; i < 6; i++) {
+            if (i == 3) {
+                cSz = sizeof(cBlob);
+                AssertIntEQ(SSL_SUCCESS, CyaSSL_hibernate(client, cBlob, &cSz));
+                CyaSSL_free(client);
+                AssertNotNull(client = CyaSSL_new(cctx));
+                AssertIntEQ(SSL_SUCCESS, CyaSSL_wake(client, cBlob, cSz));
+                CyaSSL_SetIOWriteCtx(client, &toServer);
+                CyaSSL_SetIOReadCtx(client, &toClient);
+            }
+            AssertIntEQ(5, CyaSSL_write(client, "again", 5));
+            AssertIntEQ(5, CyaSSL_read(server, got, sizeof(got)));
+            AssertIntEQ(0, memcmp(got, "again", 5));
+            AssertIntEQ(2, CyaSSL_write(server, "ok", 2));
+            AssertIntEQ(2, CyaSSL_read(client, got, sizeof(got)));
+            AssertIntEQ(0, memcmp(got, "ok", 2));
+        }
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+        CyaSSL_CTX_free(cctx);
+    }
+
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+#if defined(CYASSL_HANDSHAKE_TIMING) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+typedef struct HsTimingSeen {
+    int calls;
+    int states;
+    int last;               /* last state seen */
+    int kinds[CYASSL_HS_KINDS];
+    int ordered;            /* starts never go back */
+} HsTimingSeen;
+
+static void test_hs_timing_cb(CYASSL* ssl, const CyaSSL_HsTiming* timing,
+                              void* ctx)
+{
+    HsTimingSeen* seen = (HsTimingSeen*)ctx;
+    int i;
+
+    (void)ssl;
+    seen->calls++;
+    seen->ordered = timing->dropped == 0;
+    for (i = 0; i < timing->count; i++) {
+        const CyaSSL_HsEvent* ev = &timing->events[i];
+
+        seen->kinds[ev->kind]++;
+        if (ev->kind == CYASSL_HS_STATE) {
+            seen->states++;
+            seen->last = ev->id;
+            if (i > 0 && ev->start < timing->events[i - 1].start)
+                seen->ordered = 0;
+        }
+    }
+}
+#endif
+
+static void test_CyaSSL_handshake_timing(void)
+{
+#if defined(CYASSL_HANDSHAKE_TIMING) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    static test_memio toServer, toClient;
+    HsTimingSeen  cSeen, sSeen;
+    CYASSL_CTX*   cctx = NULL;
+    CYASSL_CTX*   sctx = NULL;
+    CYASSL*       client;
+    CYASSL*       server;
+    int           i;
+
+    XMEMSET(&cSeen, 0, sizeof(cSeen));
+    XMEMSET(&sSeen, 0, sizeof(sSeen));
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetHsTimingCb(NULL, test_hs_timing_cb,
+                                                       1, NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetHsTimingCb(sctx, test_hs_timing_cb,
+                                                       0, NULL));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetHsTimingCb(sctx, test_hs_timing_cb,
+                                                      1, &sSeen));
+    /* client only times every other handshake */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetHsTimingCb(cctx, test_hs_timing_cb,
+                                                      2, &cSeen));
+
+    for (i = 0; i < 2; i++) {
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+        /* memio handshake comes back on WANT_READ many times */
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    AssertIntEQ(2, sSeen.calls);
+    AssertIntEQ(1, cSeen.calls);
+    AssertTrue(sSeen.ordered);
+    AssertTrue(cSeen.ordered);
+    AssertTrue(cSeen.states > 5);
+    AssertTrue(sSeen.states > 2 * 5);
+    AssertIntNE(0, cSeen.last);
+    AssertIntNE(0, sSeen.last);
+
+    /* the full handshake's crypto */
+    AssertIntEQ(1, cSeen.kinds[CYASSL_HS_DECODE]);
+    AssertIntEQ(1, cSeen.kinds[CYASSL_HS_KEYGEN]);
+    AssertTrue(sSeen.kinds[CYASSL_HS_KEYGEN] >= 2);
+    AssertTrue(cSeen.kinds[CYASSL_HS_PRF] >= 3);   /* master, keys, finished */
+    AssertTrue(sSeen.kinds[CYASSL_HS_PRF] >= 2 * 3);
+
+    /* off again */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetHsTimingCb(sctx, NULL, 0, NULL));
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    AssertIntEQ(2, sSeen.calls);
+    AssertIntEQ(2, cSeen.calls);
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+#if defined(CYASSL_STATS) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE)
+/* one connection, resuming session if not NULL, client closes it */
+static CYASSL_SESSION* test_stats_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                                          CYASSL_SESSION* session)
+{
+    static test_memio toServer, toClient;
+    CYASSL_SESSION* got;
+    CYASSL* client;
+    CYASSL* server;
+    char    buf[16];
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    if (session)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session(client, session));
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    AssertIntEQ((session != NULL), CyaSSL_session_reused(server));
+    AssertIntEQ(5, CyaSSL_write(client, "hello", 5));
+    AssertIntEQ(5, CyaSSL_read(server, buf, sizeof(buf)));
+    CyaSSL_shutdown(client);
+    AssertIntEQ(0, CyaSSL_read(server, buf, sizeof(buf)));
+
+    got = CyaSSL_get_session(client);
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return got;
+}
+#endif
+
+static void test_CyaSSL_get_stats(void)
+{
+#if defined(CYASSL_STATS) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE)
+    static CyaSSL_Stats before, after;
+    CYASSL_SESSION* session;
+    CYASSL_CTX*     cctx;
+    CYASSL_CTX*     sctx;
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_get_stats(NULL));
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    /* own cache so the server's entry doesn't overwrite the client's */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(sctx, 50));
+
+    AssertIntEQ(0, CyaSSL_get_stats(&before));
+
+    /* each handshake counts on both ends, both run here */
+    AssertNotNull(session = test_stats_connect(cctx, sctx, NULL));
+    test_stats_connect(cctx, sctx, session);
+
+    AssertIntEQ(0, CyaSSL_get_stats(&after));
+    AssertIntEQ(2, (int)(after.fullHandshakes - before.fullHandshakes));
+    AssertIntEQ(2, (int)(after.resumedHandshakes - before.resumedHandshakes));
+    AssertTrue(after.cacheHits > before.cacheHits);
+    AssertTrue(after.recordsOut - before.recordsOut >= 2 * 9);
+    AssertIntEQ((int)(after.recordsOut - before.recordsOut),
+                (int)(after.recordsIn - before.recordsIn));
+    AssertIntEQ((int)(after.bytesOut - before.bytesOut),
+                (int)(after.bytesIn - before.bytesIn));
+    AssertIntEQ(2, (int)(after.alertsOut[0] - before.alertsOut[0]));
+    AssertIntEQ(2, (int)(after.alertsIn[0] - before.alertsIn[0]));
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Session Tickets
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_SESSION_TICKET) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE)
+
+static int test_ticket_keys = 0;
+
+static int test_ticket_key_cb(CYASSL_CTX* ctx, const unsigned char* name,
+                              const unsigned char* key, void* cbCtx)
+{
+    (void)ctx;
+    (void)name;
+    (void)key;
+
+    (*(int*)cbCtx)++;
+
+    return 0;
+}
+
+/* connect with session (NULL for a full handshake), return server reused */
+static int test_ticket_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                               CYASSL_SESSION* session, CYASSL** client)
+{
+    static test_memio toServer, toClient;
+    CYASSL* server;
+    int     reused;
+
+    toServer.len = toClient.len = 0;
+
+    test_memio_setup(&cctx, &sctx, client, &server, &toServer, &toClient);
+
+    if (session)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session(*client, session));
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(*client, server));
+    reused = CyaSSL_session_reused(server);
+    AssertIntEQ(reused, CyaSSL_session_reused(*client));
+
+    CyaSSL_free(server);
+
+    return reused;
+}
+
+#endif
+
+static void test_CyaSSL_SessionTicket_engine(void)
+{
+#if defined(HAVE_SESSION_TICKET) && !defined(NO_CYASSL_CLIENT) \
+    && !defined(NO_CYASSL_SERVER) && !defined(NO_SESSION_CACHE) \
+    && !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+    unsigned char name[CYASSL_TICKET_NAME_SZ] = { 0 };
+    unsigned char key[CYASSL_TICKET_KEY_SZ]   = { 0 };
+    unsigned char ticket[256];
+    unsigned int  ticketSz;
+    CYASSL_SESSION* session;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    int         i;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseSessionTicket(cctx));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey(NULL, name, key));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey(sctx, NULL, key));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey(sctx, name, NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_RotateSessionTicketKey(NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKeyLifetime(NULL, 1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey_cb(NULL, NULL,
+                                                                       NULL));
+
+    /* no keys, no tickets */
+    AssertIntEQ(0, test_ticket_connect(cctx, sctx, NULL, &client));
+    ticketSz = sizeof(ticket);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_get_SessionTicket(client, ticket,
+                                                                   &ticketSz));
+    AssertIntEQ(0, ticketSz);
+    CyaSSL_free(client);
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey_cb(sctx,
+                                         test_ticket_key_cb, &test_ticket_keys));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_SessionTicketKey(sctx, name, key));
+    AssertIntEQ(1, test_ticket_keys);
+
+    /* full handshake hands out a ticket */
+    AssertIntEQ(0, test_ticket_connect(cctx, sctx, NULL, &client));
+    ticketSz = sizeof(ticket);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_get_SessionTicket(client, ticket,
+                                                                   &ticketSz));
+    AssertTrue(ticketSz > 0);
+    AssertNotNull(session = CyaSSL_get_session(client));
+    CyaSSL_free(client);
+
+    /* stateless resumption, then still good under a prior key */
+    AssertIntEQ(1, test_ticket_connect(cctx, sctx, session, &client));
+    CyaSSL_free(client);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_RotateSessionTicketKey(sctx));
+    AssertIntEQ(2, test_ticket_keys);
+    AssertIntEQ(1, test_ticket_connect(cctx, sctx, session, &client));
+    CyaSSL_free(client);
+
+    /* pushed out by newer keys, full handshake and a new ticket */
+    for (i = 1; i < CYASSL_TICKET_KEYS; i++)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_RotateSessionTicketKey(sctx));
+    AssertIntEQ(0, test_ticket_connect(cctx, sctx, session, &client));
+    AssertNotNull(session = CyaSSL_get_session(client));
+    CyaSSL_free(client);
+    AssertIntEQ(1, test_ticket_connect(cctx, sctx, session, &client));
+    CyaSSL_free(client);
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Application-Layer Protocol Negotiation
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_ALPN) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+
+/* takes the last protocol the client offers */
+static int test_alpn_select_cb(CYASSL* ssl, const unsigned char** out,
+                               unsigned char* outSz, const unsigned char* in,
+                               unsigned int inSz, void* ctx)
+{
+    unsigned int i = 0;
+
+    (void)ssl;
+    (void)ctx;
+
+    while (i + 1 + in[i] < inSz)
+        i += 1 + in[i];
+
+    *out   = in + i + 1;
+    *outSz = in[i];
+
+    return 0;
+}
+
+/* handshake with the given lists, NULL for none, copies out the protocol
+   agreed on and returns the handshake result */
+static int test_alpn_connect(const char* offer, const char* accept,
+                             unsigned char options, CallbackALPNSelect cb,
+                             char* name, unsigned short* size)
+{
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+    char*       cName;
+    char*       sName;
+    word16      sSize;
+    int         ret;
+
+    toServer.len = toClient.len = 0;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+
+    if (offer)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseALPN(cctx, offer,
+                                                (unsigned)strlen(offer), 0));
+    if (accept)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_UseALPN(sctx, accept,
+                                          (unsigned)strlen(accept), options));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_ALPN_select_cb(sctx, cb, NULL));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+    ret = test_memio_handshake(client, server);
+
+    if (ret == SSL_SUCCESS) {
+        int got = CyaSSL_ALPN_GetProtocol(client, &cName, size);
+
+        /* both ends agree */
+        AssertIntEQ(got, CyaSSL_ALPN_GetProtocol(server, &sName, &sSize));
+        if (got == SSL_SUCCESS) {
+            AssertIntEQ(*size, sSize);
+            AssertIntEQ(0, memcmp(cName, sName, sSize));
+            memcpy(name, cName, sSize);
+        }
+        else
+            *size = 0;
+    }
+    else
+        ret = CyaSSL_get_error(server, 0);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    return ret;
+}
+
+#endif
+
+static void test_CyaSSL_UseALPN(void)
+{
+#if defined(HAVE_ALPN) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    CYASSL_CTX*    ctx;
+    CYASSL*        ssl;
+    char*          name;
+    char           buf[CYASSL_MAX_ALPN_NAME];
+    unsigned short size;
+
+    AssertNotNull(ctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertNotNull(ssl = CyaSSL_new(ctx));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_UseALPN(NULL, "h2", 2, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(NULL, "h2", 2, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(ssl, NULL, 2, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(ssl, "h2", 0, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(ssl, "h2,", 3, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(ssl, ",h2", 3, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_UseALPN(ssl, "h2,,spdy/3", 10, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_ALPN_GetProtocol(NULL, &name, &size));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_ALPN_select_cb(NULL, NULL, NULL));
+
+    /* success case, nothing negotiated yet */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_UseALPN(ssl, "h2,http/1.1", 11, 0));
+    AssertIntEQ(SSL_FAILURE, CyaSSL_ALPN_GetProtocol(ssl, &name, &size));
+
+    CyaSSL_free(ssl);
+    CyaSSL_CTX_free(ctx);
+
+    /* server preference order wins */
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect("http/1.1,h2", "h2,http/1.1",
+                                                   0, NULL, buf, &size));
+    AssertIntEQ(2, size);
+    AssertIntEQ(0, memcmp(buf, "h2", 2));
+
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect("spdy/3,http/1.1", "h2,http/1.1",
+                                                   0, NULL, buf, &size));
+    AssertIntEQ(8, size);
+    AssertIntEQ(0, memcmp(buf, "http/1.1", 8));
+
+    /* callback picks instead */
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect("h2,spdy/3", NULL, 0,
+                                     test_alpn_select_cb, buf, &size));
+    AssertIntEQ(6, size);
+    AssertIntEQ(0, memcmp(buf, "spdy/3", 6));
+
+    /* one side without ALPN */
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect("h2", NULL, 0, NULL,
+                                                              buf, &size));
+    AssertIntEQ(0, size);
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect(NULL, "h2", 0, NULL,
+                                                              buf, &size));
+    AssertIntEQ(0, size);
+
+    /* nothing in common */
+    AssertIntEQ(UNKNOWN_ALPN_PROTOCOL_E, test_alpn_connect("spdy/3", "h2", 0,
+                                                        NULL, buf, &size));
+    AssertIntEQ(SSL_SUCCESS, test_alpn_connect("spdy/3", "h2",
+                   CYASSL_ALPN_CONTINUE_ON_MISMATCH, NULL, buf, &size));
+    AssertIntEQ(0, size);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | SNI Virtual Hosts
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_SNI) && defined(HAVE_ECC) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+
+/* moves "switch.example.com" onto the CTX passed in, refuses "bad.com" */
+static int test_sni_servername_cb(CYASSL* ssl, const char* name,
+                                  unsigned short nameSz, void* ctx)
+{
+    if (nameSz == 7 && memcmp(name, "bad.com", 7) == 0)
+        return -1;
+
+    if (nameSz == 18 && memcmp(name, "switch.example.com", 18) == 0)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_SSL_CTX(ssl, (CYASSL_CTX*)ctx));
+
+    return 0;
+}
+
+/* handshake asking for host, NULL for no SNI, 1 when the ECC virtual host
+   answered, 0 for the default RSA one, the error code on failure */
+static int test_sni_vhost_connect(const char* host)
+{
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL_CTX* vhost;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         ret;
+
+    toServer.len = toClient.len = 0;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(vhost = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(vhost, eccCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(vhost, eccKey,
+                                                            SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    CyaSSL_SetIORecv(vhost, test_memio_recv);
+    CyaSSL_SetIOSend(vhost, test_memio_send);
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(sctx, "www.example.com",
+                                                                       vhost));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(sctx, "*.example.org",
+                                                                       vhost));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_servername_callback(sctx,
+                                               test_sni_servername_cb, vhost));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+    if (host)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_UseSNI(client, CYASSL_SNI_HOST_NAME,
+                                          host, (word16)strlen(host)));
+
+    /* the server keeps the virtual host alive by itself */
+    CyaSSL_CTX_free(vhost);
+
+    ret = test_memio_handshake(client, server);
+
+    if (ret == SSL_SUCCESS)
+        ret = strstr(CyaSSL_get_cipher(client), "ECDSA") != NULL;
+    else
+        ret = CyaSSL_get_error(server, 0);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    return ret;
+}
+
+#endif
+
+static void test_CyaSSL_SNI_VirtualHosts(void)
+{
+#if defined(HAVE_SNI) && defined(HAVE_ECC) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    CYASSL_CTX* ctx;
+    CYASSL_CTX* vhost;
+    CYASSL*     ssl;
+
+    AssertNotNull(ctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(vhost = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(ctx, svrCert, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(ctx, svrKey, SSL_FILETYPE_PEM));
+    AssertNotNull(ssl = CyaSSL_new(ctx));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(NULL, "a.com", vhost));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, NULL, vhost));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, "", vhost));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, "a.com", NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, "a.com", ctx));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_servername_callback(NULL, NULL,
+                                                                       NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_set_SSL_CTX(NULL, vhost));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_set_SSL_CTX(ssl, NULL));
+
+    /* replacing a name is fine */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, "a.com", vhost));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_AddSNIContext(ctx, "A.com", vhost));
+
+    CyaSSL_free(ssl);
+    CyaSSL_CTX_free(vhost);
+    CyaSSL_CTX_free(ctx);
+
+    /* table hits, names are case insensitive */
+    AssertIntEQ(1, test_sni_vhost_connect("www.example.com"));
+    AssertIntEQ(1, test_sni_vhost_connect("WWW.Example.COM"));
+    AssertIntEQ(1, test_sni_vhost_connect("mail.example.org"));
+
+    /* misses stay on the default host */
+    AssertIntEQ(0, test_sni_vhost_connect(NULL));
+    AssertIntEQ(0, test_sni_vhost_connect("example.com"));
+    AssertIntEQ(0, test_sni_vhost_connect("example.org"));
+    AssertIntEQ(0, test_sni_vhost_connect("a.b.example.org"));
+
+    /* the callback switches or refuses */
+    AssertIntEQ(1, test_sni_vhost_connect("switch.example.com"));
+    AssertIntEQ(UNKNOWN_SNI_HOST_NAME_E, test_sni_vhost_connect("bad.com"));
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Dual RSA and ECDSA Certificates
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+
+/* handshake with a dual cert server, rsa loads its RSA slot too, list limits
+   the client's suites, NULL for all, 1 when ECDSA answered, 0 for RSA, the
+   error code on failure */
+static int test_dual_cert_connect(int rsa, const char* list)
+{
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         ret;
+
+    toServer.len = toClient.len = 0;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_dual_cert(sctx));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, eccCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, eccKey, SSL_FILETYPE_PEM));
+    if (rsa) {
+        AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+        AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey,
+                                                            SSL_FILETYPE_PEM));
+    }
+    if (list)
+        AssertTrue(CyaSSL_CTX_set_cipher_list(cctx, list));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+    ret = test_memio_handshake(client, server);
+
+    if (ret == SSL_SUCCESS)
+        ret = strstr(CyaSSL_get_cipher(client), "ECDSA") != NULL;
+    else
+        ret = CyaSSL_get_error(server, 0);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    return ret;
+}
+
+#endif
+
+static void test_CyaSSL_CTX_set_dual_cert(void)
+{
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_set_dual_cert(NULL));
+
+    /* ECDSA whenever the client offers it */
+    AssertIntEQ(1, test_dual_cert_connect(1, NULL));
+
+    /* RSA for the others */
+    AssertIntEQ(0, test_dual_cert_connect(1,
+                                 "ECDHE-RSA-AES128-SHA:AES128-SHA"));
+
+    /* the ECC slot alone still serves */
+    AssertIntEQ(1, test_dual_cert_connect(0, NULL));
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Peer Certificate
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_get_peer_certificate(void)
+{
+#if defined(KEEP_PEER_CERT) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    static test_memio toServer, toClient;
+    CYASSL_CTX*  cctx = NULL;
+    CYASSL_CTX*  sctx = NULL;
+    CYASSL*      client;
+    CYASSL*      server;
+    CYASSL_X509* peer;
+    int          derSz = 0;
+
+    toServer.len = toClient.len = 0;
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+    /* the server didn't ask, the client's X509 is built on this call */
+    AssertNull(CyaSSL_get_peer_certificate(server));
+    AssertNotNull(peer = CyaSSL_get_peer_certificate(client));
+    AssertTrue(peer == CyaSSL_get_peer_certificate(client));
+    AssertStrEQ("www.wolfssl.com", CyaSSL_X509_get_subjectCN(peer));
+    AssertNotNull(CyaSSL_X509_get_der(peer, &derSz));
+    AssertIntGT(derSz, 0);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Certificate Rotation
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+
+/* handshake server with a fresh client, 1 when it answered with ECDSA */
+static int test_rotate_connect(CYASSL* server)
+{
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL*     client;
+    int         ret;
+
+    toServer.len = toClient.len = 0;
+
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    CyaSSL_SetIORecv(cctx, test_memio_recv);
+    CyaSSL_SetIOSend(cctx, test_memio_send);
+
+    AssertNotNull(client = CyaSSL_new(cctx));
+    CyaSSL_SetIOWriteCtx(client, &toServer);
+    CyaSSL_SetIOReadCtx(client, &toClient);
+    CyaSSL_SetIOWriteCtx(server, &toClient);
+    CyaSSL_SetIOReadCtx(server, &toServer);
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    ret = strstr(CyaSSL_get_cipher(client), "ECDSA") != NULL;
+
+    CyaSSL_free(client);
+    CyaSSL_CTX_free(cctx);
+
+    return ret;
+}
+
+#endif
+
+static void test_CyaSSL_CTX_Rotate(void)
+{
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    CYASSL_CTX* sctx;
+    CYASSL_CTX* next;
+    CYASSL_CTX* cctx;
+    CYASSL*     before;
+    CYASSL*     after;
+    CYASSL*     back;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(next = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(next, eccCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(next, eccKey, SSL_FILETYPE_PEM));
+    CyaSSL_SetIORecv(sctx, test_memio_recv);
+    CyaSSL_SetIOSend(sctx, test_memio_send);
+    CyaSSL_SetIORecv(next, test_memio_recv);
+    CyaSSL_SetIOSend(next, test_memio_send);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_Rotate(NULL, next));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_Rotate(sctx, sctx));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_Rotate(sctx, cctx));
+    CyaSSL_CTX_free(cctx);
+
+    /* an ssl made before the rotation keeps the old certificate, the
+       rotation keeps next alive after its own handle is gone */
+    AssertNotNull(before = CyaSSL_new(sctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_Rotate(sctx, next));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_Rotate(next, sctx));
+    CyaSSL_CTX_free(next);
+    AssertNotNull(after = CyaSSL_new(sctx));
+
+    /* and back */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_Rotate(sctx, NULL));
+    AssertNotNull(back = CyaSSL_new(sctx));
+
+    AssertIntEQ(0, test_rotate_connect(before));
+    AssertIntEQ(1, test_rotate_connect(after));
+    AssertIntEQ(0, test_rotate_connect(back));
+
+    CyaSSL_free(before);
+    CyaSSL_free(after);
+    CyaSSL_free(back);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_CTX_SetNumaNode(void)
+{
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    CYASSL_CTX* sctx;
+    CYASSL_CTX* node;
+    CYASSL_CTX* cctx;
+    CYASSL*     local;
+    CYASSL*     home;
+    int         nodes;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(node = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(node, eccCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(node, eccKey, SSL_FILETYPE_PEM));
+    CyaSSL_SetIORecv(sctx, test_memio_recv);
+    CyaSSL_SetIOSend(sctx, test_memio_send);
+    CyaSSL_SetIORecv(node, test_memio_recv);
+    CyaSSL_SetIOSend(node, test_memio_send);
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(NULL, 0, node));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(sctx, -1, node));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(sctx, 1000, node));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(sctx, 0, sctx));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(sctx, 0, cctx));
+    CyaSSL_CTX_free(cctx);
+
+    /* the same replica on every node whichever one this thread is on, it
+       outlives its own handle */
+    for (nodes = 0; CyaSSL_CTX_SetNumaNode(sctx, nodes, node) == SSL_SUCCESS;
+                                                                      nodes++)
+        ;
+    AssertTrue(nodes > 1);
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(node, 0, sctx));
+    CyaSSL_CTX_free(node);
+    AssertNotNull(local = CyaSSL_new(sctx));
+
+    /* cleared, back to sctx */
+    while (nodes--)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetNumaNode(sctx, nodes, NULL));
+    AssertNotNull(home = CyaSSL_new(sctx));
+
+#ifdef __linux__
+    AssertIntEQ(1, test_rotate_connect(local));
+#else
+    AssertIntEQ(0, test_rotate_connect(local));
+#endif
+    AssertIntEQ(0, test_rotate_connect(home));
+
+    CyaSSL_free(local);
+    CyaSSL_free(home);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Handshake Admission Control
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_CTX_SetHandshakeLimit(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_SESSION_CACHE)
+    static test_memio toServer[4], toClient[4];
+    CYASSL_SESSION* session;
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client[4];
+    CYASSL*     server[4];
+    int         i;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    /* error cases */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetHandshakeLimit(NULL, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetHandshakeLimit(sctx, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_GetHandshakesInFlight(NULL));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetHandshakeLimit(sctx, 1));
+
+    for (i = 0; i < 4; i++) {
+        test_memio_setup(&cctx, &sctx, &client[i], &server[i], &toServer[i],
+                         &toClient[i]);
+    }
+
+    /* one full handshake at a time, the slot is given back when it's done */
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client[0], server[0]));
+    AssertIntEQ(0, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+    AssertNotNull(session = CyaSSL_get_session(client[0]));
+
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client[1]));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server[1]));
+    AssertIntEQ(SSL_ERROR_WANT_READ, CyaSSL_get_error(server[1], 0));
+    AssertIntEQ(1, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+
+    /* the next one is shed at its ClientHello, the client sees the alert */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client[2]));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server[2]));
+    AssertIntEQ(HANDSHAKE_BUSY_E, CyaSSL_get_error(server[2], 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client[2]));
+    AssertIntNE(SSL_ERROR_WANT_READ, CyaSSL_get_error(client[2], 0));
+    AssertIntEQ(1, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+
+    /* resumptions aren't counted */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session(client[3], session));
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client[3], server[3]));
+    AssertIntEQ(1, CyaSSL_session_reused(server[3]));
+    AssertIntEQ(1, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+
+    /* nor is an abandoned one once it's freed */
+    CyaSSL_free(server[2]);
+    CyaSSL_free(server[1]);
+    AssertIntEQ(0, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+
+    /* room again */
+    toServer[2].len = toClient[2].len = 0;
+    CyaSSL_free(client[2]);
+    test_memio_setup(&cctx, &sctx, &client[2], &server[2], &toServer[2],
+                     &toClient[2]);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client[2], server[2]));
+    AssertIntEQ(0, CyaSSL_CTX_GetHandshakesInFlight(sctx));
+
+    for (i = 0; i < 4; i++) {
+        CyaSSL_free(client[i]);
+        if (i != 1)
+            CyaSSL_free(server[i]);
+    }
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Decoded Private Key Cache
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_CTX_private_key_cache(void)
+{
+#if defined(HAVE_ECC) && !defined(NO_RSA) \
+    && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         i;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+
+    /* reloading replaces the copy decoded by the first load */
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+
+    /* ECDHE-RSA signs and RSA decrypts with the shared copy */
+    for (i = 0; i < 2; i++) {
+        toServer.len = toClient.len = 0;
+
+        AssertTrue(CyaSSL_CTX_set_cipher_list(cctx, i == 0
+                                  ? "ECDHE-RSA-AES128-SHA" : "AES128-SHA"));
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Stateless DTLS Listen
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_CTX_dtls_listen(void)
+{
+#if defined(CYASSL_DTLS) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    static test_memio toServer, toClient;
+    CYASSL_CTX*   cctx;
+    CYASSL_CTX*   sctx;
+    CYASSL*       client;
+    CYASSL*       server;
+    unsigned char out[128];
+    unsigned int  outSz = sizeof(out);
+    const char    peer[] = "peer-a";
+    const char    other[] = "peer-b";
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaDTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaDTLSv1_2_client_method()));
+
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+
+    test_memio_setup(&cctx, &sctx, &client, NULL, &toServer, &toClient);
+
+    /* no secret yet */
+    AssertIntEQ(COOKIE_ERROR, CyaSSL_CTX_dtls_listen(sctx, out, 0, peer,
+                                              sizeof(peer), out, &outSz));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_dtls_set_cookie_secret(sctx, NULL, 0));
+
+    /* first ClientHello gets a HelloVerifyRequest */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+    AssertIntGT(toServer.len, 0);
+    AssertIntEQ(0, CyaSSL_CTX_dtls_listen(sctx, (byte*)toServer.buf,
+                       toServer.len, peer, sizeof(peer), out, &outSz));
+    AssertIntGT(outSz, 0);
+    toServer.len = 0;
+    memcpy(toClient.buf, out, outSz);
+    toClient.len = outSz;
+
+    /* the cookie only holds for the address it was made for */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_connect(client));
+    AssertIntGT(toServer.len, 0);
+    outSz = sizeof(out);
+    AssertIntEQ(0, CyaSSL_CTX_dtls_listen(sctx, (byte*)toServer.buf,
+                       toServer.len, other, sizeof(other), out, &outSz));
+    outSz = sizeof(out);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_dtls_listen(sctx,
+                       (byte*)toServer.buf, toServer.len, peer, sizeof(peer),
+                       out, &outSz));
+    AssertIntEQ(0, outSz);
+
+    /* only now is there a server side object */
+    test_memio_setup(&cctx, &sctx, NULL, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_dtls_accept_hello(server,
+                               (byte*)toServer.buf, toServer.len));
+    toServer.len = 0;
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | DTLS Server Mux
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_DTLS_MUX) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+static int test_mux_new_peer(CYASSL_DTLS_MUX* mux, const unsigned char* in,
+                             unsigned int inSz, const void* peer,
+                             unsigned int peerSz, void* ctx)
+{
+    CYASSL_CTX*   sctx = (CYASSL_CTX*)ctx;
+    CYASSL*       ssl;
+    unsigned char out[256];
+    unsigned int  outSz = sizeof(out);
+    int           ret;
+
+    ret = CyaSSL_CTX_dtls_listen(sctx, in, inSz, peer, peerSz, out, &outSz);
+    if (ret == 0)
+        CyaSSL_DTLS_MUX_sendto(mux, out, outSz, peer, peerSz);
+    if (ret != SSL_SUCCESS)
+        return 1;
+
+    AssertNotNull(ssl = CyaSSL_new(sctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_dtls_set_peer(ssl, (void*)peer, peerSz));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_DTLS_MUX_add(mux, ssl));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_dtls_accept_hello(ssl, in, inSz));
+
+    return 1;
+}
+#endif
+
+static void test_CyaSSL_DTLS_MUX(void)
+{
+#if defined(HAVE_DTLS_MUX) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    CYASSL_DTLS_MUX* mux;
+    CYASSL_CTX*      cctx;
+    CYASSL_CTX*      sctx;
+    CYASSL*          client[2];
+    CYASSL*          server[2];
+    SOCKET_T         sfd, cfd[2];
+    SOCKADDR_IN_T    saddr, caddr[2];
+    socklen_t        len;
+    char             msg[16];
+    int              done, i, loops;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaDTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaDTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_dtls_set_cookie_secret(sctx, NULL, 0));
+
+    build_addr(&saddr, yasslIP, 0, 1);
+    tcp_socket(&sfd, 1);
+    AssertIntEQ(0, bind(sfd, (struct sockaddr*)&saddr, sizeof(saddr)));
+    len = sizeof(saddr);
+    AssertIntEQ(0, getsockname(sfd, (struct sockaddr*)&saddr, &len));
+
+    AssertNull(CyaSSL_DTLS_MUX_new(NULL, sfd));
+    AssertNotNull(mux = CyaSSL_DTLS_MUX_new(sctx, sfd));
+    CyaSSL_DTLS_MUX_SetNewPeerCb(mux, test_mux_new_peer, sctx);
+
+    for (i = 0; i < 2; i++) {
+        build_addr(&caddr[i], yasslIP, 0, 1);
+        tcp_socket(&cfd[i], 1);
+        AssertIntEQ(0, bind(cfd[i], (struct sockaddr*)&caddr[i],
+                            sizeof(caddr[i])));
+        len = sizeof(caddr[i]);
+        AssertIntEQ(0, getsockname(cfd[i], (struct sockaddr*)&caddr[i], &len));
+        tcp_set_nonblocking(&cfd[i]);
+
+        AssertNotNull(client[i] = CyaSSL_new(cctx));
+        CyaSSL_set_fd(client[i], cfd[i]);
+        CyaSSL_set_using_nonblock(client[i], 1);
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_dtls_set_peer(client[i], &saddr,
+                                                      sizeof(saddr)));
+    }
+
+    /* one socket, both handshakes interleaved */
+    for (loops = 0, done = 0; done != 2 && loops < 1000; loops++) {
+        CYASSL* ready;
+
+        for (i = 0, done = 0; i < 2; i++)
+            done += CyaSSL_connect(client[i]) == SSL_SUCCESS;
+
+        AssertIntGE(CyaSSL_DTLS_MUX_recv(mux), 0);
+        while ((ready = CyaSSL_DTLS_MUX_ready(mux)) != NULL)
+            CyaSSL_accept(ready);
+        AssertIntEQ(0, CyaSSL_DTLS_MUX_flush(mux));
+    }
+    AssertIntEQ(2, done);
+
+    for (i = 0; i < 2; i++) {
+        AssertNotNull(server[i] = CyaSSL_DTLS_MUX_find(mux, &caddr[i],
+                                                       sizeof(caddr[i])));
+        AssertIntEQ(BAD_FUNC_ARG, CyaSSL_DTLS_MUX_add(mux, server[i]));
+    }
+    AssertTrue(server[0] != server[1]);
+
+    /* data goes to the right association */
+    AssertIntEQ(2, CyaSSL_write(client[1], "b1", 2));
+    AssertIntEQ(2, CyaSSL_write(client[0], "a0", 2));
+    for (loops = 0; loops < 1000 && CyaSSL_DTLS_MUX_recv(mux) < 2; loops++)
+        ;
+    AssertTrue(CyaSSL_DTLS_MUX_ready(mux) == server[1]);
+    AssertTrue(CyaSSL_DTLS_MUX_ready(mux) == server[0]);
+    AssertNull(CyaSSL_DTLS_MUX_ready(mux));
+    AssertIntEQ(2, CyaSSL_read(server[0], msg, sizeof(msg)));
+    AssertIntEQ(0, memcmp(msg, "a0", 2));
+    AssertIntEQ(2, CyaSSL_read(server[1], msg, sizeof(msg)));
+    AssertIntEQ(0, memcmp(msg, "b1", 2));
+
+    for (i = 0; i < 2; i++) {
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_DTLS_MUX_remove(mux, server[i]));
+        AssertIntEQ(BAD_FUNC_ARG, CyaSSL_DTLS_MUX_remove(mux, server[i]));
+        CyaSSL_free(server[i]);
+        CyaSSL_free(client[i]);
+        CloseSocket(cfd[i]);
+    }
+    AssertNull(CyaSSL_DTLS_MUX_find(mux, &caddr[0], sizeof(caddr[0])));
+
+    CyaSSL_DTLS_MUX_free(mux);
+    CloseSocket(sfd);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Connection Pool
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_CONN_POOL) && !defined(NO_RSA) && !defined(NO_FILESYSTEM) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE)
+#define POOL_SERVER_MAX 16
+
+typedef struct pool_server {
+    CYASSL_CTX*     ctx;
+    SOCKET_T        sfd;
+    CYASSL*         ssl[POOL_SERVER_MAX];
+    int             count;
+    pthread_mutex_t lock;
+} pool_server;
+
+/* handshakes every connection made to it and keeps it open, until sfd is
+   shut down */
+static void* test_pool_server(void* arg)
+{
+    pool_server* srv = (pool_server*)arg;
+    SOCKET_T     cfd;
+
+    while ((cfd = accept(srv->sfd, NULL, NULL)) >= 0) {
+        CYASSL* ssl = CyaSSL_new(srv->ctx);
+
+        CyaSSL_set_fd(ssl, cfd);
+        pthread_mutex_lock(&srv->lock);
+        if (CyaSSL_accept(ssl) == SSL_SUCCESS && srv->count < POOL_SERVER_MAX)
+            srv->ssl[srv->count++] = ssl;
+        else {
+            CyaSSL_free(ssl);
+            CloseSocket(cfd);
+        }
+        pthread_mutex_unlock(&srv->lock);
+    }
+
+    return NULL;
+}
+
+static int test_pool_server_count(pool_server* srv)
+{
+    int count;
+
+    pthread_mutex_lock(&srv->lock);
+    count = srv->count;
+    pthread_mutex_unlock(&srv->lock);
+
+    return count;
+}
+#endif
+
+static void test_CyaSSL_CONN_POOL(void)
+{
+#if defined(HAVE_CONN_POOL) && !defined(NO_RSA) && !defined(NO_FILESYSTEM) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE)
+    CYASSL_CONN_POOL* pool;
+    CYASSL_CTX*       cctx;
+    CYASSL*           ssl[2];
+    pool_server       srv;
+    pthread_t         tid;
+    SOCKADDR_IN_T     saddr;
+    socklen_t         len;
+    word16            port;
+    int               i;
+
+    XMEMSET(&srv, 0, sizeof(srv));
+    AssertIntEQ(0, pthread_mutex_init(&srv.lock, NULL));
+    AssertNotNull(srv.ctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(srv.ctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(srv.ctx, svrKey,
+                                                            SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    /* both ends store the same session ids, keep the client's apart */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    build_addr(&saddr, yasslIP, 0, 0);
+    tcp_socket(&srv.sfd, 0);
+    AssertIntEQ(0, bind(srv.sfd, (struct sockaddr*)&saddr, sizeof(saddr)));
+    AssertIntEQ(0, listen(srv.sfd, 5));
+    len = sizeof(saddr);
+    AssertIntEQ(0, getsockname(srv.sfd, (struct sockaddr*)&saddr, &len));
+#ifndef TEST_IPV6
+    port = ntohs(saddr.sin_port);
+#else
+    port = ntohs(saddr.sin6_port);
+#endif
+    AssertIntEQ(0, pthread_create(&tid, NULL, test_pool_server, &srv));
+
+    AssertNull(CyaSSL_CONN_POOL_new(NULL, 2, 0));
+    AssertNotNull(pool = CyaSSL_CONN_POOL_new(cctx, 2, 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CONN_POOL_idle(pool, yasslIP, port));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CONN_POOL_add(pool, yasslIP, port));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CONN_POOL_add(pool, yasslIP, port));
+
+    /* warmed up in the background */
+    for (i = 0; i < 100 && CyaSSL_CONN_POOL_idle(pool, yasslIP, port) < 2; i++)
+        usleep(50000);
+    AssertIntEQ(2, CyaSSL_CONN_POOL_idle(pool, yasslIP, port));
+    AssertIntEQ(2, test_pool_server_count(&srv));
+
+    /* server drops them, the pool notices and makes new ones, resumed */
+    pthread_mutex_lock(&srv.lock);
+    for (i = 0; i < srv.count; i++)
+        shutdown(CyaSSL_get_fd(srv.ssl[i]), SHUT_RDWR);
+    pthread_mutex_unlock(&srv.lock);
+
+    for (i = 0; i < 100 && (test_pool_server_count(&srv) < 4 ||
+                    CyaSSL_CONN_POOL_idle(pool, yasslIP, port) < 2); i++)
+        usleep(50000);
+    AssertIntEQ(4, test_pool_server_count(&srv));
+    AssertIntEQ(2, CyaSSL_CONN_POOL_idle(pool, yasslIP, port));
+
+    for (i = 0; i < 2; i++) {
+        AssertNotNull(ssl[i] = CyaSSL_CONN_POOL_get(pool, yasslIP, port));
+        AssertTrue(CyaSSL_session_reused(ssl[i]));
+    }
+    AssertNull(CyaSSL_CONN_POOL_get(pool, "localhost.invalid", port));
+
+    /* one back for reuse, the other closed */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CONN_POOL_put(pool, ssl[0], 1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CONN_POOL_put(pool, ssl[1], 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CONN_POOL_put(pool, NULL, 1));
+
+    CyaSSL_CONN_POOL_free(pool);
+
+    shutdown(srv.sfd, SHUT_RDWR);
+    pthread_join(tid, NULL);
+    for (i = 0; i < srv.count; i++) {
+        int fd = CyaSSL_get_fd(srv.ssl[i]);
+
+        CyaSSL_free(srv.ssl[i]);
+        CloseSocket(fd);
+    }
+    CloseSocket(srv.sfd);
+    pthread_mutex_destroy(&srv.lock);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(srv.ctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Ephemeral Key Pool
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_EphemeralKeyPool(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(HAVE_ECC) \
+    && !defined(NO_RSA) && !defined(NO_AES) && !defined(NO_SHA)
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    int         full;
+    int         i;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(cctx,
+                                                      "ECDHE-RSA-AES128-SHA"));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetEphemeralKeyPool(NULL, 1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetEphemeralKeyPool(sctx, -1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetEphemeralKeyPool(sctx,
+                                                      CYASSL_MAX_KEY_POOL + 1));
+    AssertIntLT(CyaSSL_CTX_FillEphemeralKeyPool(NULL, 0), 0);
+    AssertIntLT(CyaSSL_CTX_GetEphemeralKeyPoolCount(NULL), 0);
+
+    /* off by default, nothing to fill */
+    AssertIntEQ(0, CyaSSL_CTX_FillEphemeralKeyPool(sctx, 0));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetEphemeralKeyPool(sctx, 2));
+    AssertIntEQ(1, CyaSSL_CTX_FillEphemeralKeyPool(sctx, 1));
+    AssertTrue((full = CyaSSL_CTX_FillEphemeralKeyPool(sctx, 0) + 1) >= 2);
+    AssertIntEQ(full, CyaSSL_CTX_GetEphemeralKeyPoolCount(sctx));
+    AssertIntEQ(0, CyaSSL_CTX_FillEphemeralKeyPool(sctx, 0));
+
+    /* each handshake takes a pooled key, then falls back to inline ones */
+    for (i = 1; i <= 3; i++) {
+        toServer.len = toClient.len = 0;
+        test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+        AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+
+        AssertIntEQ(full - (i < 2 ? i : 2),
+                    CyaSSL_CTX_GetEphemeralKeyPoolCount(sctx));
+    }
+
+#ifdef OPENSSL_EXTRA
+    /* new ECDHE size makes the old keys useless, refill replaces them */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetTmpEC_DHE_Sz(sctx, 48));
+    AssertTrue(CyaSSL_CTX_FillEphemeralKeyPool(sctx, 0) >= 2);
+#endif
+
+    /* turning it off drops the pooled keys */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetEphemeralKeyPool(sctx, 0));
+    AssertIntEQ(0, CyaSSL_CTX_GetEphemeralKeyPoolCount(sctx));
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Named DH Groups
+ *----------------------------------------------------------------------------*/
+
+static void test_CyaSSL_SetTmpDH_NamedGroup(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_DH) \
+    && !defined(NO_RSA) && !defined(NO_AES) && !defined(NO_SHA)
+    static test_memio toServer, toClient;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(cctx,
+                                                        "DHE-RSA-AES128-SHA"));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetTmpDH_NamedGroup(NULL,
+                                                           CYASSL_FFDHE_2048));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_SetTmpDH_NamedGroup(sctx, 0));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_SetTmpDH_NamedGroup(NULL,
+                                                           CYASSL_FFDHE_2048));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_SetTmpDH_NamedGroup(sctx,
+                                                           CYASSL_FFDHE_2048));
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntNE(SSL_SUCCESS, CyaSSL_SetTmpDH_NamedGroup(server, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_SetTmpDH_NamedGroup(server,
+                                                           CYASSL_FFDHE_2048));
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | PSK Store
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_PSK) \
+    && defined(HAVE_PSK_STORE) && !defined(NO_AES) && !defined(NO_SHA256)
+
+static unsigned char test_psk_key[2];
+
+static unsigned int test_psk_client_cb(CYASSL* ssl, const char* hint,
+        char* identity, unsigned int idMaxLen, unsigned char* key,
+        unsigned int keyMaxLen)
+{
+    (void)ssl;
+    (void)hint;
+    (void)keyMaxLen;
+
+    XSTRNCPY(identity, "client", idMaxLen);
+    XMEMCPY(key, test_psk_key, sizeof(test_psk_key));
+
+    return sizeof(test_psk_key);
+}
+
+static int test_psk_store_handshake(CYASSL_CTX* cctx, CYASSL_CTX* sctx)
+{
+    static test_memio toServer, toClient;
+    CYASSL* client;
+    CYASSL* server;
+    int     ret;
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    ret = test_memio_handshake(client, server);
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return ret;
+}
+
+#endif
+
+static void test_CyaSSL_CTX_load_psk_store(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_PSK) \
+    && defined(HAVE_PSK_STORE) && !defined(NO_AES) && !defined(NO_SHA256)
+    const char  store[] = "# test identities\n"
+                          "alpha:0102\n"
+                          "client:1a2b\r\n"
+                          "\n"
+                          "client:3c4d\n";
+    const char  reload[] = "client:0e0f";
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    CyaSSL_CTX_set_psk_client_callback(cctx, test_psk_client_cb);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_use_psk_identity_hint(sctx,
+                                                              "cyassl server"));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(cctx,
+                                                     "PSK-AES128-CBC-SHA256"));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(NULL,
+                                    (const unsigned char*)store, sizeof(store)));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                                    (const unsigned char*)"client", 6));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                                    (const unsigned char*)"client:abc", 10));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                                    (const unsigned char*)"client:zz", 9));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                                    (const unsigned char*)":0102", 5));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_psk_store(sctx,
+                                                "./certs/does-not-exist"));
+
+    /* the last key for an identity wins */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                              (const unsigned char*)store, sizeof(store) - 1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(sctx,
+                                                     "PSK-AES128-CBC-SHA256"));
+    test_psk_key[0] = 0x3c;
+    test_psk_key[1] = 0x4d;
+    AssertIntEQ(SSL_SUCCESS, test_psk_store_handshake(cctx, sctx));
+
+    /* reload replaces the whole store */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_load_psk_store_buffer(sctx,
+                                (const unsigned char*)reload, sizeof(reload) - 1));
+    test_psk_key[0] = 0x0e;
+    test_psk_key[1] = 0x0f;
+    AssertIntEQ(SSL_SUCCESS, test_psk_store_handshake(cctx, sctx));
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Low Resolution Clock
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_SESSION_CACHE) \
+    && !defined(USER_TICKS)
+
+static unsigned int test_clock = 0;
+
+static unsigned int test_clock_cb(void* ctx)
+{
+    (*(int*)ctx)++;
+
+    return test_clock;
+}
+
+/* connect with session (NULL for a full handshake), return server reused */
+static int test_clock_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                              CYASSL_SESSION** session)
+{
+    static test_memio toServer, toClient;
+    CYASSL* client;
+    CYASSL* server;
+    int     reused;
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    if (*session)
+        CyaSSL_set_session(client, *session);   /* fails once it expired */
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    reused = CyaSSL_session_reused(server);
+    *session = CyaSSL_get_session(client);
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return reused;
+}
+
+#endif
+
+static void test_CyaSSL_SetLowResTimeCb(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_SESSION_CACHE) \
+    && !defined(USER_TICKS)
+    CYASSL_CTX*     cctx = NULL;
+    CYASSL_CTX*     sctx = NULL;
+    CYASSL_SESSION* session = NULL;
+    int             calls = 0;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    /* session lifetimes follow the callback's clock */
+    test_clock = 1000;
+    CyaSSL_SetLowResTimeCb(test_clock_cb, &calls);
+    AssertIntEQ(0, test_clock_connect(cctx, sctx, &session));
+    test_clock += 100;
+    AssertIntEQ(1, test_clock_connect(cctx, sctx, &session));
+    test_clock += 1000;                                 /* past the timeout */
+    AssertIntEQ(0, test_clock_connect(cctx, sctx, &session));
+    AssertIntGT(calls, 0);
+    CyaSSL_SetLowResTimeCb(NULL, NULL);
+
+#ifndef SINGLE_THREADED
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_StartCoarseClock());
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_StartCoarseClock());
+    AssertIntEQ(0, test_clock_connect(cctx, sctx, &session));
+    AssertIntEQ(1, test_clock_connect(cctx, sctx, &session));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_StopCoarseClock());
+#endif
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_StopCoarseClock());
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Shared Session Cache
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_SHARED_SESSION_CACHE) && !defined(NO_RSA) \
+    && !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+
+#include <sys/wait.h>
+
+/* client in this process against a server in a forked child, which exits
+   with its resumption status. 1 if both sides resumed */
+static int test_shared_cache_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                                     CYASSL_SESSION* session,
+                                     CYASSL_SESSION** got)
+{
+    CYASSL* client;
+    pid_t   pid;
+    int     sv[2];
+    int     status;
+    int     reused;
+
+    AssertIntEQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    AssertTrue((pid = fork()) >= 0);
+
+    if (pid == 0) {
+        CYASSL* server = CyaSSL_new(sctx);
+
+        close(sv[0]);
+        if (server == NULL || CyaSSL_set_fd(server, sv[1]) != SSL_SUCCESS ||
+                                      CyaSSL_accept(server) != SSL_SUCCESS)
+            _exit(2);
+        reused = CyaSSL_session_reused(server);
+        CyaSSL_free(server);    /* not shutdown, the client may be gone */
+        _exit(reused ? 0 : 1);
+    }
+
+    close(sv[1]);
+    AssertNotNull(client = CyaSSL_new(cctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_fd(client, sv[0]));
+    if (session)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session(client, session));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_connect(client));
+    reused = CyaSSL_session_reused(client);
+    if (got)
+        *got = CyaSSL_get_session(client);
+    CyaSSL_free(client);
+    close(sv[0]);
+
+    AssertIntEQ(pid, waitpid(pid, &status, 0));
+    AssertTrue(WIFEXITED(status) && WEXITSTATUS(status) != 2);
+    AssertIntEQ(reused, WEXITSTATUS(status) == 0);
+
+    return reused;
+}
+
+#endif
+
+static void test_CyaSSL_set_shared_session_cache(void)
+{
+#if defined(HAVE_SHARED_SESSION_CACHE) && !defined(NO_RSA) \
+    && !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+    CYASSL_CTX*     cctx;
+    CYASSL_CTX*     sctx;
+    CYASSL_SESSION* session = NULL;
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_shared_session_cache(0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_shared_session_cache(-1));
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    /* the client's sessions stay in this process */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    /* each server is a fresh fork of this process, which never adds a
+       session itself, so only a shared cache lets the second resume */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_shared_session_cache(100));
+    AssertIntGE(CyaSSL_get_session_cache_size(), 100);
+    AssertIntEQ(0, test_shared_cache_connect(cctx, sctx, NULL, &session));
+    AssertNotNull(session);
+    AssertIntEQ(1, test_shared_cache_connect(cctx, sctx, session, NULL));
+
+    /* detached again, the next worker misses */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(0));
+    AssertIntEQ(0, test_shared_cache_connect(cctx, sctx, session, &session));
+    AssertIntEQ(0, test_shared_cache_connect(cctx, sctx, session, NULL));
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Session Journal
+ *----------------------------------------------------------------------------*/
+
+#if defined(PERSIST_SESSION_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE) \
+    && !defined(NO_FILESYSTEM) && !defined(SINGLE_THREADED)
+
+/* one connection by server id, 1 if the server resumed */
+static int test_journal_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx)
+{
+    static test_memio toServer, toClient;
+    CYASSL* client;
+    CYASSL* server;
+    int     reused;
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_SetServerID(client,
+                                     (const unsigned char*)"journal", 7, 0));
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    reused = CyaSSL_session_reused(server);
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return reused;
+}
+
+#endif
+
+static void test_CyaSSL_session_journal(void)
+{
+#if defined(PERSIST_SESSION_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE) \
+    && !defined(NO_FILESYSTEM) && !defined(SINGLE_THREADED)
+    const char* journal = "./session-journal.tmp";
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    /* client sessions stay out of the journaled global cache, which the
+       server side shares in this process */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    /* error cases */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_start_session_journal(NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_restore_session_journal(NULL));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_restore_session_journal(
+                                                     "./certs/does-not-exist"));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_restore_session_journal(svrCert));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(0)); /* empty */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_start_session_journal(journal));
+    AssertIntEQ(0, test_journal_connect(cctx, sctx));
+    AssertIntEQ(1, test_journal_connect(cctx, sctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_stop_session_journal());
+
+    /* a restart loses the cache, the journal brings it back */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_restore_session_journal(journal));
+    AssertIntEQ(1, test_journal_connect(cctx, sctx));
+
+    remove(journal);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_session_cache_size(0));
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Client Session Cache
+ *----------------------------------------------------------------------------*/
+
+#if defined(OPENSSL_EXTRA) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE)
+
+/* one connection to server id "backend", 1 if resumed. id gets the session
+   id the client ended up with */
+static int test_client_cache_connect(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                                     int newSession, unsigned char* id)
+{
+    static test_memio toServer, toClient;
+    unsigned char     der[2048];
+    unsigned char*    p = der;
+    CYASSL* client;
+    CYASSL* server;
+    int     reused;
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_SetServerID(client,
+                             (const unsigned char*)"backend", 7, newSession));
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+    reused = CyaSSL_session_reused(client);
+    AssertIntEQ(reused, CyaSSL_session_reused(server));
+
+    /* serialized as version, id size, id */
+    AssertIntLE(CyaSSL_i2d_SSL_SESSION(CyaSSL_get_session(client), NULL),
+                                                            (int)sizeof(der));
+    AssertIntGT(CyaSSL_i2d_SSL_SESSION(CyaSSL_get_session(client), &p), 34);
+    memcpy(id, der + 2, 32);
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    return reused;
+}
+
+#endif
+
+static void test_CyaSSL_client_session_cache(void)
+{
+#if defined(OPENSSL_EXTRA) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_SESSION_CACHE) && !defined(NO_CLIENT_CACHE)
+    CYASSL_CTX*   cctx = NULL;
+    CYASSL_CTX*   sctx = NULL;
+    unsigned char a[32], b[32], c[32], d[32];
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_session_cache_size(cctx, 64));
+
+    /* two parallel first connects each leave a session */
+    AssertIntEQ(0, test_client_cache_connect(cctx, sctx, 1, a));
+    AssertIntEQ(0, test_client_cache_connect(cctx, sctx, 1, b));
+    AssertIntNE(0, memcmp(a, b, sizeof(a)));
+
+    /* the next two resume both, not one of them twice */
+    AssertIntEQ(1, test_client_cache_connect(cctx, sctx, 0, c));
+    AssertIntEQ(1, test_client_cache_connect(cctx, sctx, 0, d));
+    AssertIntNE(0, memcmp(c, d, sizeof(c)));
+    AssertTrue(memcmp(c, a, sizeof(a)) == 0 || memcmp(c, b, sizeof(b)) == 0);
+    AssertTrue(memcmp(d, a, sizeof(a)) == 0 || memcmp(d, b, sizeof(b)) == 0);
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ | Async Private Key Operations
+ *----------------------------------------------------------------------------*/
+
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(CYASSL_ASYNC_CRYPT) \
+    && !defined(NO_RSA) && !defined(NO_AES) && !defined(NO_SHA)
+
+/* holds the op instead of running it, the test runs it between calls */
+typedef struct test_async {
+    CYASSL_ASYNC_OP* op;
+    int              submits;
+    int              types;
+} test_async;
+
+static int test_async_submit(CYASSL* ssl, CYASSL_ASYNC_OP* op, void* ctx)
+{
+    test_async* async = (test_async*)ctx;
+
+    (void)ssl;
+
+    async->op = op;
+    async->submits++;
+    async->types |= 1 << CyaSSL_AsyncOpType(op);
+
+    return 0;
+}
+
+static int test_async_handshake(CYASSL* client, CYASSL* server,
+                                test_async* async)
+{
+    int i;
+    int c = SSL_FATAL_ERROR;
+    int s = SSL_FATAL_ERROR;
+
+    for (i = 0; i < 20 && (c != SSL_SUCCESS || s != SSL_SUCCESS); i++) {
+        if (c != SSL_SUCCESS) {
+            c = CyaSSL_connect(client);
+            if (c != SSL_SUCCESS &&
+                               CyaSSL_get_error(client, c) != SSL_ERROR_WANT_READ)
+                return c;
+        }
+        if (s != SSL_SUCCESS) {
+            s = CyaSSL_accept(server);
+            if (s != SSL_SUCCESS &&
+                          CyaSSL_get_error(server, s) == SSL_ERROR_WANT_ASYNC) {
+                /* still out, calling again doesn't move it along */
+                AssertIntEQ(1, CyaSSL_AsyncPending(server));
+                AssertIntNE(SSL_SUCCESS, CyaSSL_accept(server));
+                AssertIntEQ(SSL_ERROR_WANT_ASYNC,
+                            CyaSSL_get_error(server, SSL_FATAL_ERROR));
+
+                AssertIntEQ(0, CyaSSL_AsyncOpRun(async->op));
+                AssertIntEQ(0, CyaSSL_AsyncPending(server));
+                async->op = NULL;
+            }
+            else if (s != SSL_SUCCESS &&
+                               CyaSSL_get_error(server, s) != SSL_ERROR_WANT_READ)
+                return s;
+        }
+    }
+
+    return c == SSL_SUCCESS && s == SSL_SUCCESS ? SSL_SUCCESS : SSL_FATAL_ERROR;
+}
+
+static void test_async_suite(const char* cert, const char* key,
+                             const char* suite, int types)
+{
+    static test_memio toServer, toClient;
+    test_async  async;
+    CYASSL_CTX* cctx;
+    CYASSL_CTX* sctx;
+    CYASSL*     client;
+    CYASSL*     server;
+    char        msg[] = "async hello";
+    char        reply[sizeof(msg)];
+
+    XMEMSET(&async, 0, sizeof(async));
+    toServer.len = toClient.len = 0;
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaTLSv1_2_server_method()));
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaTLSv1_2_client_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, cert, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, key, SSL_FILETYPE_PEM));
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_cipher_list(cctx, suite));
+    CyaSSL_CTX_SetAsyncSubmitCb(sctx, test_async_submit);
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    CyaSSL_SetAsyncSubmitCtx(server, &async);
+    AssertTrue(CyaSSL_GetAsyncSubmitCtx(server) == &async);
+
+    AssertIntEQ(SSL_SUCCESS, test_async_handshake(client, server, &async));
+    AssertTrue(async.submits > 0);
+    AssertIntEQ(types, async.types);
+
+    /* keys agree, data flows */
+    AssertIntEQ(sizeof(msg), CyaSSL_write(client, msg, sizeof(msg)));
+    AssertIntEQ(sizeof(msg), CyaSSL_read(server, reply, sizeof(reply)));
+    AssertIntEQ(0, XMEMCMP(msg, reply, sizeof(msg)));
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+}
+
+#endif
+
+static void test_CyaSSL_AsyncCrypt(void)
+{
+#if defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(CYASSL_ASYNC_CRYPT) \
+    && !defined(NO_RSA) && !defined(NO_AES) && !defined(NO_SHA)
+    /* error cases */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_AsyncOpType(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_AsyncOpRun(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_AsyncPending(NULL));
+    AssertNull(CyaSSL_GetAsyncSubmitCtx(NULL));
+
+    test_async_suite(svrCert, svrKey, "AES128-SHA",
+                     1 << CYASSL_ASYNC_RSA_DECRYPT);
+#ifdef HAVE_ECC
+    test_async_suite(svrCert, svrKey, "ECDHE-RSA-AES128-SHA",
+                     1 << CYASSL_ASYNC_RSA_SIGN | 1 << CYASSL_ASYNC_ECC_SHARED);
+    test_async_suite(eccCert, eccKey, "ECDHE-ECDSA-AES128-SHA",
+                     1 << CYASSL_ASYNC_ECC_SIGN | 1 << CYASSL_ASYNC_ECC_SHARED);
+#endif
+#endif
+}
+
+static void test_CyaSSL_SlabMalloc(void)
+{
+#ifdef CYASSL_SLAB_MALLOC
+    CyaSSL_SlabStat stats[64];
+    byte*           a;
+    byte*           b;
+    int             n;
+    int             i;
+    unsigned long   hits = 0;
+
+    AssertIntGT(n = CyaSSL_SlabGetStats(NULL, 0), 1);
+    AssertTrue(n <= (int)(sizeof(stats) / sizeof(stats[0])));
+
+    /* a freed block comes straight back */
+    AssertNotNull(a = (byte*)CyaSSL_SlabMalloc(600));
+    XMEMSET(a, 0xA5, 600);
+    CyaSSL_SlabFree(a);
+    AssertNotNull(b = (byte*)CyaSSL_SlabMalloc(590));
+    AssertTrue(a == b);
+
+    /* growing within the class keeps the block, past it moves the data */
+    AssertTrue(CyaSSL_SlabRealloc(b, 620) == b);
+    b[0] = 0x5A;
+    AssertNotNull(a = (byte*)CyaSSL_SlabRealloc(b, 5000));
+    AssertIntEQ(0x5A, a[0]);
+    CyaSSL_SlabFree(a);
+
+    /* oversized requests go to the heap */
+    AssertNotNull(a = (byte*)CyaSSL_SlabMalloc(100000));
+    AssertNotNull(a = (byte*)CyaSSL_SlabRealloc(a, 200000));
+    CyaSSL_SlabFree(a);
+    CyaSSL_SlabFree(NULL);
+
+    AssertIntEQ(n, CyaSSL_SlabGetStats(stats, n));
+    AssertIntEQ(0, (int)stats[n - 1].size);
+    AssertTrue(stats[n - 1].allocs >= 1);
+    for (i = 0; i < n - 1; i++) {
+        AssertTrue(stats[i].size > 0);
+        hits += stats[i].hits;
+    }
+    AssertTrue(hits >= 1);
+
+    CyaSSL_SlabFlush();
+    AssertIntEQ(n, CyaSSL_SlabGetStats(stats, n));
+    for (i = 0; i < n - 1; i++)
+        AssertIntEQ(0, (int)stats[i].cached);
+#endif
+}
+
+static void test_CyaSSL_StaticMemory(void)
+{
+#ifdef CYASSL_STATIC_MEMORY
+    CyaSSL_StaticMemStat stats[64];
+    CyaSSL_StaticMemStat after[64];
+    byte**               all;
+    byte*                a;
+    byte*                b;
+    unsigned long        avail;
+    unsigned long        i;
+    int                  n;
+
+    AssertIntGT(n = CyaSSL_StaticMemoryGetStats(NULL, 0), 1);
+    AssertTrue(n <= (int)(sizeof(stats) / sizeof(stats[0])));
+
+    /* a freed block comes straight back */
+    AssertNotNull(a = (byte*)CyaSSL_StaticMalloc(600));
+    XMEMSET(a, 0xA5, 600);
+    CyaSSL_StaticFree(a);
+    AssertNotNull(b = (byte*)CyaSSL_StaticMalloc(590));
+    AssertTrue(a == b);
+
+    /* growing within the block keeps it, past it moves the data */
+    AssertTrue(CyaSSL_StaticRealloc(b, 620) == b);
+    b[0] = 0x5A;
+    AssertNotNull(a = (byte*)CyaSSL_StaticRealloc(b, 3000));
+    AssertIntEQ(0x5A, a[0]);
+    CyaSSL_StaticFree(a);
+    CyaSSL_StaticFree(NULL);
+
+    /* bigger than every bucket fails, no heap behind it */
+    AssertNull(CyaSSL_StaticMalloc(16 * 1024 * 1024));
+    AssertIntEQ(n, CyaSSL_StaticMemoryGetStats(stats, n));
+    AssertIntEQ(0, (int)stats[n - 1].size);
+    AssertTrue(stats[n - 1].fails >= 1);
+    AssertTrue(stats[n - 1].largest >= 16 * 1024 * 1024);
+
+    /* the smallest bucket run dry spills into the next one */
+    avail = stats[0].total - stats[0].inUse;
+    AssertNotNull(all = (byte**)XMALLOC((avail + 1) * sizeof(byte*), NULL,
+                                        DYNAMIC_TYPE_TMP_BUFFER));
+    for (i = 0; i <= avail; i++)
+        AssertNotNull(all[i] = (byte*)CyaSSL_StaticMalloc(1));
+    AssertIntEQ(n, CyaSSL_StaticMemoryGetStats(after, n));
+    AssertIntEQ(after[0].total, after[0].inUse);
+    AssertIntEQ(after[0].total, after[0].peak);
+    AssertIntEQ(stats[0].spills + 1, after[0].spills);
+    AssertIntEQ(stats[1].inUse + 1, after[1].inUse);
+    for (i = 0; i <= avail; i++)
+        CyaSSL_StaticFree(all[i]);
+    XFREE(all, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    AssertIntEQ(n, CyaSSL_StaticMemoryGetStats(after, n));
+    AssertIntEQ(stats[0].inUse, after[0].inUse);
+    AssertIntEQ(stats[1].inUse, after[1].inUse);
+#endif
+}
+
+static void test_CyaSSL_MemUsage(void)
+{
+#if defined(CYASSL_MEM_STATS) && !defined(NO_FILESYSTEM) && \
+    !defined(NO_CERTS) && !defined(NO_RSA)
+    CYASSL_CTX*     ctx;
+    CYASSL*         ssl;
+    CyaSSL_MemUsage before;
+    CyaSSL_MemUsage ctxUse;
+    CyaSSL_MemUsage sslUse;
+
+    AssertNotNull(ctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_GetMemUsage(NULL, &before));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_GetMemUsage(ctx, NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_GetMemUsage(NULL, &sslUse));
+
+    /* loading the key pair is charged to the ctx */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_GetMemUsage(ctx, &before));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(ctx, svrCert, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(ctx, svrKey, SSL_FILETYPE_PEM));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_GetMemUsage(ctx, &ctxUse));
+    AssertTrue(ctxUse.current > before.current);
+    AssertTrue(ctxUse.typeCurrent[DYNAMIC_TYPE_CERT] > 0);
+    AssertTrue(ctxUse.typeCurrent[DYNAMIC_TYPE_KEY] > 0);
+    before = ctxUse;
+
+    /* connection internals show up per SSL and roll up into the ctx */
+    AssertNotNull(ssl = CyaSSL_new(ctx));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_GetMemUsage(ssl, &sslUse));
+    AssertTrue(sslUse.count > 0);
+    AssertTrue(sslUse.current > 0);
+    AssertTrue(sslUse.peak >= sslUse.current);
+    AssertTrue(sslUse.typeCurrent[DYNAMIC_TYPE_RNG] > 0);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_GetMemUsage(ctx, &ctxUse));
+    AssertTrue(ctxUse.current >= before.current + sslUse.current);
+    AssertTrue(ctxUse.typeCurrent[DYNAMIC_TYPE_SSL] > 0);
+
+    /* freeing it gives everything back */
+    CyaSSL_free(ssl);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_GetMemUsage(ctx, &ctxUse));
+    AssertTrue(ctxUse.current == before.current);
+    AssertTrue(ctxUse.peak > before.peak);
+    AssertTrue(ctxUse.typeCurrent[DYNAMIC_TYPE_SSL] == 0);
+
+    CyaSSL_CTX_free(ctx);
+#endif
+}
+
+static void test_CyaSSL_set_compact(void)
+{
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+    static test_memio toServer, toClient;
+    char        msg[16];
+    CYASSL_CTX* cctx = NULL;
+    CYASSL_CTX* sctx = NULL;
+    CYASSL*     client;
+    CYASSL*     server;
+#ifdef CYASSL_MEM_STATS
+    CyaSSL_MemUsage use;
+#endif
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_set_compact(NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_set_compact(NULL));
+
+    test_memio_setup(&cctx, &sctx, NULL, NULL, NULL, NULL);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_set_compact(cctx));
+
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+#ifdef OPENSSL_EXTRA
+    /* server takes its own copy of the pair so compact has something to shed */
+    AssertTrue(CyaSSL_use_certificate_file(server, svrCert, SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_use_PrivateKey_file(server, svrKey, SSL_FILETYPE_PEM));
+#endif
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_set_compact(server));
+
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+#ifdef CYASSL_MEM_STATS
+    /* only the record layer is left */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_GetMemUsage(server, &use));
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_HASHES]);
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_ARRAYS]);
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_CERT]);
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_KEY]);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_GetMemUsage(client, &use));
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_HASHES]);
+    AssertIntEQ(0, (int)use.typeCurrent[DYNAMIC_TYPE_ARRAYS]);
+#endif
+
+    /* and it still carries data both ways */
+    AssertIntEQ(5, CyaSSL_write(client, "hello", 5));
+    AssertIntEQ(5, CyaSSL_read(server, msg, sizeof(msg)));
+    AssertIntEQ(0, memcmp(msg, "hello", 5));
+    AssertIntEQ(2, CyaSSL_write(server, "hi", 2));
+    AssertIntEQ(2, CyaSSL_read(client, msg, sizeof(msg)));
+    AssertIntEQ(0, memcmp(msg, "hi", 2));
+
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+#endif
+}
+
+static void test_CyaSSL_CertManager_Ed25519(void)
+{
+#if defined(HAVE_ED25519) && !defined(NO_FILESYSTEM)
+    CYASSL_CERT_MANAGER* cm;
+
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+
+    /* nothing to verify against yet */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                          "./certs/server-ed25519.pem", SSL_FILETYPE_PEM));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                              "./certs/ca-ed25519.pem", 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                          "./certs/server-ed25519.pem", SSL_FILETYPE_PEM));
+
+    /* an RSA signed cert doesn't chain to the Ed25519 CA */
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                         "./certs/server-cert.pem",
+                                         SSL_FILETYPE_PEM));
+
+    CyaSSL_CertManagerFree(cm);
+#endif
+}
+
+static void test_CyaSSL_CertManager_CATable(void)
+{
+#if !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    CYASSL_CERT_MANAGER* cm;
+    int rows[] = { 1, 2, 64, 3 };
+    int i;
+
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetCATableSize(NULL, 16));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetCATableSize(cm, 0));
+
+    /* resizing an empty table is fine too */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerSetCATableSize(cm, 1));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                "./certs/client-cert.pem", 0));
+
+    for (i = 0; i < (int)(sizeof(rows) / sizeof(rows[0])); i++) {
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerSetCATableSize(cm,
+                                                                    rows[i]));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/client-cert.pem", SSL_FILETYPE_PEM));
+    }
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerUnloadCAs(cm));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    /* loads again onto a fresh table */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    CyaSSL_CertManagerFree(cm);
+#endif
+}
+
+static void test_CyaSSL_CertManager_LoadThreads(void)
+{
+#if defined(CYASSL_LOAD_THREADS) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    const char* bundle  = "./test-cabundle.pem";
+    const char* parts[] = { caCert, cliCert, caCert };
+    char        buf[8192];
+    FILE*       out;
+    CYASSL_CERT_MANAGER* cm;
+    int         i;
+
+    /* CAs one after the other, a duplicate and junk at the end */
+    AssertNotNull(out = fopen(bundle, "wb"));
+    for (i = 0; i < (int)(sizeof(parts) / sizeof(parts[0])); i++) {
+        FILE*  in;
+        size_t sz;
+
+        AssertNotNull(in = fopen(parts[i], "rb"));
+        sz = fread(buf, 1, sizeof(buf), in);
+        fclose(in);
+        AssertIntEQ((int)sz, (int)fwrite(buf, 1, sz, out));
+    }
+    fputs("\n# end of bundle\n", out);
+    fclose(out);
+
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetLoadThreads(NULL, 2));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetLoadThreads(cm, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_SetLoadThreads(NULL, 2));
+
+    for (i = 0; i <= 4; i += 4) {
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerSetLoadThreads(cm, i));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm, bundle, 0));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm, svrCert,
+                                                             SSL_FILETYPE_PEM));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm, cliCert,
+                                                             SSL_FILETYPE_PEM));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerUnloadCAs(cm));
+    }
+
+    CyaSSL_CertManagerFree(cm);
+    remove(bundle);
+#endif
+}
+
+static void test_CyaSSL_CTX_TrustStore(void)
+{
+#if defined(HAVE_TRUST_STORE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) \
+    && !defined(NO_RSA)
+    static test_memio toServer, toClient;
+    const char*   store   = "./test-truststore.bin";
+    const char*   resaved = "./test-truststore2.bin";
+    unsigned char junk[64];
+    CYASSL_CTX*   cctx;
+    CYASSL_CTX*   sctx;
+    CYASSL*       client;
+    CYASSL*       server;
+
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+
+    /* error cases */
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_save_trust_store(NULL, store));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_load_trust_store(cctx, NULL));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CTX_memload_trust_store(cctx, junk, 0));
+    memset(junk, 0, sizeof(junk));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_memload_trust_store(cctx, junk,
+                                                                sizeof(junk)));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CTX_load_trust_store(cctx, caCert));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_load_verify_locations(cctx, caCert, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_save_trust_store(cctx, store));
+    CyaSSL_CTX_free(cctx);
+
+    AssertNotNull(sctx = CyaSSL_CTX_new(CyaSSLv23_server_method()));
+    AssertTrue(CyaSSL_CTX_use_certificate_file(sctx, svrCert,
+                                                            SSL_FILETYPE_PEM));
+    AssertTrue(CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM));
+
+    /* new client trusting the server through the store only, then through
+       a store saved again from the mapped one */
+    AssertNotNull(cctx = CyaSSL_CTX_new(CyaSSLv23_client_method()));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_load_trust_store(cctx, store));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_save_trust_store(cctx, resaved));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CTX_load_trust_store(cctx, resaved));
+
+    toServer.len = toClient.len = 0;
+    test_memio_setup(&cctx, &sctx, &client, &server, &toServer, &toClient);
+    AssertIntEQ(SSL_SUCCESS, test_memio_handshake(client, server));
+
+    CyaSSL_free(server);
+    CyaSSL_free(client);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    remove(store);
+    remove(resaved);
+#endif
+}
+
+static void test_CyaSSL_CertManager_VerifyCache(void)
+{
+#if defined(HAVE_VERIFY_CACHE) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    CYASSL_CERT_MANAGER* cm;
+    int i;
+
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetVerifyCacheSize(NULL, 1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerSetVerifyCacheSize(cm, -1));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerFlushVerifyCache(NULL));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+
+    /* first one verifies and caches, the rest are hits */
+    for (i = 0; i < 3; i++)
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    /* a hit still needs a signer, cached certs go with the CAs */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerUnloadCAs(cm));
+    AssertIntNE(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerFlushVerifyCache(cm));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    /* one row, and off */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerSetVerifyCacheSize(cm, 1));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                "./certs/client-cert.pem", 0));
+    for (i = 0; i < 2; i++) {
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+        AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/client-cert.pem", SSL_FILETYPE_PEM));
+    }
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerSetVerifyCacheSize(cm, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerVerify(cm,
+                                 "./certs/server-cert.pem", SSL_FILETYPE_PEM));
+
+    CyaSSL_CertManagerFree(cm);
+#endif
+}
+
+#if defined(HAVE_CRL) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+/* hands the CRL over a few bytes at a time to cross the parser's window */
+static int test_CRL_Read(void* ctx, unsigned char* buf, int sz)
+{
+    return (int)fread(buf, 1, sz < 5 ? sz : 5, (FILE*)ctx);
+}
+#endif
+
+static void test_CyaSSL_CertManager_CRL(void)
+{
+#if defined(HAVE_CRL) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    CYASSL_CERT_MANAGER* cm;
+    FILE*         file;
+    unsigned char pem[16384];     /* has the -text dump in front */
+    unsigned char der[4096];
+    int           pemSz;
+    int           derSz;
+
+    AssertNotNull(file = fopen("./certs/server-cert.pem", "rb"));
+    pemSz = (int)fread(pem, 1, sizeof(pem), file);
+    fclose(file);
+    AssertIntGT(derSz = CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                            CERT_TYPE), 0);
+
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerEnableCRL(cm, 0));
+
+    /* no CRL for the issuer yet */
+    AssertIntEQ(CRL_MISSING, CyaSSL_CertManagerCheckCRL(cm, der, derSz));
+
+    /* crl.pem is from ca-cert and revokes nothing */
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCRL(cm, "./certs/crl",
+                                                       SSL_FILETYPE_PEM, 0));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerCheckCRL(cm, der, derSz));
+
+    CyaSSL_CertManagerFree(cm);
+
+    /* same CRL streamed in through a read callback */
+    AssertNotNull(cm = CyaSSL_CertManagerNew());
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCA(cm,
+                                                    "./certs/ca-cert.pem", 0));
+    AssertIntEQ(BAD_FUNC_ARG, CyaSSL_CertManagerLoadCRL_Stream(cm, NULL, NULL,
+                                                           SSL_FILETYPE_PEM));
+
+    AssertNotNull(file = fopen("./certs/crl/crl.pem", "rb"));
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerLoadCRL_Stream(cm,
+                                      test_CRL_Read, file, SSL_FILETYPE_PEM));
+    fclose(file);
+    AssertIntEQ(SSL_SUCCESS, CyaSSL_CertManagerCheckCRL(cm, der, derSz));
+
+    CyaSSL_CertManagerFree(cm);
+#endif
+}
+
+static void test_CyaSSL_CertPemToDer(void)
+{
+#if !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    FILE*         file;
+    unsigned char pem[16384];     /* key in front of the cert's -text dump */
+    unsigned char der[4096];
+    unsigned char der2[4096];
+    char*         body;
+    int           pemSz;
+    int           derSz;
+
+    AssertNotNull(file = fopen("./certs/server-key.pem", "rb"));
+    pemSz = (int)fread(pem, 1, sizeof(pem), file);
+    fclose(file);
+    AssertNotNull(file = fopen("./certs/server-cert.pem", "rb"));
+    pemSz += (int)fread(pem + pemSz, 1, sizeof(pem) - pemSz, file);
+    fclose(file);
+
+    /* the key block is skipped over */
+    AssertIntGT(derSz = CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                            CERT_TYPE), 0);
+    AssertIntEQ(0x30, der[0]);
+
+    /* same DER from the byte at a time decoder */
+    CyaSSL_SetCpuFeatureMask(0);
+    AssertIntEQ(derSz, CyaSSL_CertPemToDer(pem, pemSz, der2, sizeof(der2),
+                                           CERT_TYPE));
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+    AssertIntEQ(0, XMEMCMP(der, der2, derSz));
+
+    /* a stray character mid line is caught either way */
+    AssertNotNull(body = strstr((char*)pem, "-----BEGIN CERTIFICATE-----"));
+    body[28 + 65 + 30] = '*';
+    AssertIntLT(CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                    CERT_TYPE), 0);
+    CyaSSL_SetCpuFeatureMask(0);
+    AssertIntLT(CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                    CERT_TYPE), 0);
+    CyaSSL_SetCpuFeatureMask(0xFFFFFFFF);
+#endif
+}
+
+static void test_DerGetCertFields(void)
+{
+#if !defined(NO_FILESYSTEM) && !defined(NO_ASN)
+    FILE*         file;
+    unsigned char pem[4096];
+    unsigned char der[2048];
+    int           pemSz;
+    int           derSz;
+    int           dns = 0;
+    int           tag;
+    DerCertFields fields;
+    DerCursor     names;
+    DerSpan       item;
+
+    AssertNotNull(file = fopen("./certs/test/san-cert.pem", "rb"));
+    pemSz = (int)fread(pem, 1, sizeof(pem), file);
+    fclose(file);
+    AssertIntGT(derSz = CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                            CERT_TYPE), 0);
+
+    AssertIntEQ(0, DerGetCertFields(der, derSz, &fields));
+    AssertIntEQ(ASN_UTC_TIME, fields.notBefore.tag);
+    AssertIntGT(fields.extensions.sz, 0);
+
+    AssertIntEQ(0, DerGetNameEntry(&fields.subject, ASN_COMMON_NAME, &item));
+    AssertIntEQ(15, item.sz);
+    AssertIntEQ(0, XMEMCMP(item.data, "www.wolfssl.com", 15));
+    AssertIntEQ(0, DerGetNameEntry(&fields.issuer, ASN_ORGUNIT_NAME, &item));
+    AssertIntEQ(0, XMEMCMP(item.data, "Testing", 7));
+
+    /* two DNS names among the IP and email ones */
+    AssertIntEQ(0, DerGetAltNames(&fields, &names));
+    while ((tag = DerNext(&names, &item)) > 0) {
+        if (tag == (ASN_CONTEXT_SPECIFIC | ASN_DNS_TYPE))
+            dns++;
+    }
+    AssertIntEQ(0, tag);
+    AssertIntEQ(2, dns);
+
+    /* truncated anywhere is an error, never a read past the end */
+    AssertIntLT(DerGetCertFields(der, derSz - 1, &fields), 0);
+    AssertIntLT(DerGetCertFields(der, 40, &fields), 0);
+
+    /* no extensions at all */
+    AssertNotNull(file = fopen("./certs/ntru-cert.pem", "rb"));
+    pemSz = (int)fread(pem, 1, sizeof(pem), file);
+    fclose(file);
+    AssertIntGT(derSz = CyaSSL_CertPemToDer(pem, pemSz, der, sizeof(der),
+                                            CERT_TYPE), 0);
+    AssertIntEQ(0, DerGetCertFields(der, derSz, &fields));
+    AssertIntEQ(0, fields.extensions.sz);
+    AssertIntLT(DerGetAltNames(&fields, &names), 0);
+#endif
+}
+
 /*----------------------------------------------------------------------------*
  | Main
  *----------------------------------------------------------------------------*/
@@ -1159,13 +5193,65 @@ void ApiTest(void)
     test_CyaSSL_CTX_load_verify_locations();
     test_server_CyaSSL_new();
     test_client_CyaSSL_new();
+    test_CyaSSL_set_session_cache_size();
+    test_CyaSSL_SESSION_serialize();
+    test_CyaSSL_SessionTicket_engine();
+    test_CyaSSL_EphemeralKeyPool();
+    test_CyaSSL_SetTmpDH_NamedGroup();
+    test_CyaSSL_CTX_load_psk_store();
+    test_CyaSSL_SetLowResTimeCb();
+    test_CyaSSL_set_shared_session_cache();
+    test_CyaSSL_session_journal();
+    test_CyaSSL_client_session_cache();
+    test_CyaSSL_AsyncCrypt();
+    test_CyaSSL_SlabMalloc();
+    test_CyaSSL_StaticMemory();
+    test_CyaSSL_MemUsage();
+    test_CyaSSL_set_compact();
+    test_CyaSSL_CertManager_Ed25519();
+    test_CyaSSL_CertManager_CATable();
+    test_CyaSSL_CTX_TrustStore();
+    test_CyaSSL_CertManager_LoadThreads();
+    test_CyaSSL_CertManager_VerifyCache();
+    test_CyaSSL_CertManager_CRL();
+    test_CyaSSL_CertPemToDer();
+    test_DerGetCertFields();
     test_CyaSSL_read_write();
+    test_CyaSSL_read_zc();
+    test_CyaSSL_read_ahead();
+    test_CyaSSL_read_ahead_max_fragment();
+    test_CyaSSL_record_sizing();
+    test_CyaSSL_flight_more();
+    test_CyaSSL_SetMemIO();
+    test_CyaSSL_false_start();
+    test_CyaSSL_cbc_records();
+    test_CyaSSL_CTX_SetWriteThreads();
+    test_CyaSSL_CTX_SetVerifyThreads();
+    test_CyaSSL_chain_ca_cache();
+    test_CyaSSL_SetClientHelloCb();
+    test_CyaSSL_hibernate();
+    test_CyaSSL_handshake_timing();
+    test_CyaSSL_get_stats();
 
     /* TLS extensions tests */
     test_CyaSSL_UseSNI();
     test_CyaSSL_UseMaxFragment();
     test_CyaSSL_UseTruncatedHMAC();
+    test_CyaSSL_UseEncryptThenMac();
+    test_CyaSSL_UseCachedInfo();
     test_CyaSSL_UseSupportedCurve();
+    test_CyaSSL_UseOCSPStapling();
+    test_CyaSSL_UseALPN();
+    test_CyaSSL_SNI_VirtualHosts();
+    test_CyaSSL_CTX_set_dual_cert();
+    test_CyaSSL_get_peer_certificate();
+    test_CyaSSL_CTX_Rotate();
+    test_CyaSSL_CTX_SetNumaNode();
+    test_CyaSSL_CTX_SetHandshakeLimit();
+    test_CyaSSL_CTX_private_key_cache();
+    test_CyaSSL_CTX_dtls_listen();
+    test_CyaSSL_DTLS_MUX();
+    test_CyaSSL_CONN_POOL();
 
     test_CyaSSL_Cleanup();
     printf(" End API Tests\n");
@@ -0,0 +1,510 @@
+/* bench.c record layer benchmarks for the unit test driver
+ *
+ * Copyright (C) 2006-2014 wolfSSL Inc.
+ *
+ * This file is part of CyaSSL.
+ *
+ * CyaSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * CyaSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <cyassl/ctaocrypt/settings.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <cyassl/ssl.h>
+#include <cyassl/ctaocrypt/memory.h>
+#include <tests/unit.h>
+
+
+/* Each server suite of tests/test.conf that needs no more than a version,
+   a cipher list and a cert/key runs a handshake over memory pipes, then
+   the client writes BENCH_RECORDS records the server reads. That is
+   BuildMessage, DecryptMessage, ProcessReply and GetInputData once each
+   per record, reported as ns/record and allocations/record.
+
+   unit.test -b [FILE] runs them, comparing against the baseline FILE if
+   given, -w FILE writes the results as a baseline, -t PCT is the slowdown
+   allowed over the baseline before failing, allocations may not grow */
+
+#define BENCH_RECORDS     2000
+#define BENCH_RECORD_SZ   1024
+#define BENCH_THRESHOLD   50       /* percent */
+#define BENCH_MAX_SUITES  256
+#define BENCH_SUITE_SZ    80
+#define BENCH_CONF        "tests/test.conf"
+
+#if !defined(NO_CYASSL_CLIENT) && !defined(NO_CYASSL_SERVER) \
+    && !defined(NO_FILESYSTEM) && !defined(NO_CERTS)
+
+typedef struct BenchResult {
+    char   suite[BENCH_SUITE_SZ + 1];
+    int    version;
+    double ns;          /* per record */
+    double allocs;      /* per record, -1 if not counted */
+} BenchResult;
+
+
+/* one way in memory pipe */
+typedef struct BenchPipe {
+    char buf[81920];
+    int  len;
+} BenchPipe;
+
+static BenchPipe toServer, toClient;
+
+
+static int BenchSend(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    BenchPipe* io = (BenchPipe*)ctx;
+
+    (void)ssl;
+
+    if (io->len + sz > (int)sizeof(io->buf))
+        return CYASSL_CBIO_ERR_GENERAL;
+
+    memcpy(io->buf + io->len, buf, sz);
+    io->len += sz;
+
+    return sz;
+}
+
+
+static int BenchRecv(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    BenchPipe* io = (BenchPipe*)ctx;
+
+    (void)ssl;
+
+    if (io->len == 0)
+        return CYASSL_CBIO_ERR_WANT_READ;
+
+    if (sz > io->len)
+        sz = io->len;
+
+    memcpy(buf, io->buf, sz);
+    memmove(io->buf, io->buf + sz, io->len - sz);
+    io->len -= sz;
+
+    return sz;
+}
+
+
+#ifdef USE_CYASSL_MEMORY
+
+static unsigned long benchAllocs = 0;
+
+static void* BenchMalloc(size_t sz)
+{
+    benchAllocs++;
+#ifdef CYASSL_SLAB_MALLOC
+    return CyaSSL_SlabMalloc(sz);
+#else
+    return malloc(sz);
+#endif
+}
+
+static void BenchFree(void* ptr)
+{
+#ifdef CYASSL_SLAB_MALLOC
+    CyaSSL_SlabFree(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static void* BenchRealloc(void* ptr, size_t sz)
+{
+    benchAllocs++;
+#ifdef CYASSL_SLAB_MALLOC
+    return CyaSSL_SlabRealloc(ptr, sz);
+#else
+    return realloc(ptr, sz);
+#endif
+}
+
+#endif /* USE_CYASSL_MEMORY */
+
+
+static CYASSL_METHOD* BenchMethod(int version, int server)
+{
+    switch (version) {
+#ifndef NO_OLD_TLS
+    #ifdef CYASSL_ALLOW_SSLV3
+        case 0:
+            return server ? CyaSSLv3_server_method() : CyaSSLv3_client_method();
+    #endif
+        case 1:
+            return server ? CyaTLSv1_server_method() : CyaTLSv1_client_method();
+        case 2:
+            return server ? CyaTLSv1_1_server_method() :
+                            CyaTLSv1_1_client_method();
+#endif
+        case 3:
+            return server ? CyaTLSv1_2_server_method() :
+                            CyaTLSv1_2_client_method();
+        default:
+            return NULL;
+    }
+}
+
+
+/* handshake and time the records, returns 0 on success, NOT_COMPILED_IN if
+   the build lacks the suite or version */
+static int BenchSuite(BenchResult* res, const char* cert, const char* key)
+{
+    static char   msg[BENCH_RECORD_SZ];
+    static char   got[BENCH_RECORD_SZ];
+    CYASSL_METHOD* cm = BenchMethod(res->version, 0);
+    CYASSL_METHOD* sm = BenchMethod(res->version, 1);
+    CYASSL_CTX*   cctx = NULL;
+    CYASSL_CTX*   sctx = NULL;
+    CYASSL*       client = NULL;
+    CYASSL*       server = NULL;
+    int           c = SSL_FATAL_ERROR;
+    int           s = SSL_FATAL_ERROR;
+    int           ret = NOT_COMPILED_IN;
+    int           i;
+    double        start;
+#ifdef USE_CYASSL_MEMORY
+    unsigned long allocs;
+#endif
+
+    if (cm == NULL || sm == NULL)
+        return NOT_COMPILED_IN;
+
+    sctx = CyaSSL_CTX_new(sm);
+    cctx = CyaSSL_CTX_new(cm);
+    if (sctx == NULL || cctx == NULL)
+        goto done;
+    if (CyaSSL_CTX_set_cipher_list(sctx, res->suite) != SSL_SUCCESS ||
+        CyaSSL_CTX_set_cipher_list(cctx, res->suite) != SSL_SUCCESS ||
+        CyaSSL_CTX_use_certificate_file(sctx, cert, SSL_FILETYPE_PEM)
+                                                             != SSL_SUCCESS ||
+        CyaSSL_CTX_use_PrivateKey_file(sctx, key, SSL_FILETYPE_PEM)
+                                                             != SSL_SUCCESS)
+        goto done;
+    CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+    CyaSSL_SetIORecv(sctx, BenchRecv);
+    CyaSSL_SetIOSend(sctx, BenchSend);
+    CyaSSL_SetIORecv(cctx, BenchRecv);
+    CyaSSL_SetIOSend(cctx, BenchSend);
+
+    client = CyaSSL_new(cctx);
+    server = CyaSSL_new(sctx);
+    if (client == NULL || server == NULL)
+        goto done;
+#ifndef NO_DH
+    CyaSSL_SetTmpDH_file(server, dhParam, SSL_FILETYPE_PEM);
+#endif
+    toServer.len = toClient.len = 0;
+    CyaSSL_SetIOWriteCtx(client, &toServer);
+    CyaSSL_SetIOReadCtx(client, &toClient);
+    CyaSSL_SetIOWriteCtx(server, &toClient);
+    CyaSSL_SetIOReadCtx(server, &toServer);
+
+    ret = SSL_FATAL_ERROR;
+    for (i = 0; i < 10 && (c != SSL_SUCCESS || s != SSL_SUCCESS); i++) {
+        if (c != SSL_SUCCESS)
+            c = CyaSSL_connect(client);
+        if (s != SSL_SUCCESS)
+            s = CyaSSL_accept(server);
+    }
+    if (c != SSL_SUCCESS || s != SSL_SUCCESS) {
+        printf("bench %s handshake failed\n", res->suite);
+        goto done;
+    }
+
+    /* one untimed record to settle buffers */
+    memset(msg, 0x42, sizeof(msg));
+    if (CyaSSL_write(client, msg, sizeof(msg)) != (int)sizeof(msg) ||
+        CyaSSL_read(server, got, sizeof(got)) != (int)sizeof(got))
+        goto done;
+
+#ifdef USE_CYASSL_MEMORY
+    allocs = benchAllocs;
+#endif
+    start = current_time();
+    for (i = 0; i < BENCH_RECORDS; i++) {
+        if (CyaSSL_write(client, msg, sizeof(msg)) != (int)sizeof(msg) ||
+            CyaSSL_read(server, got, sizeof(got)) != (int)sizeof(got)) {
+            printf("bench %s record %d failed\n", res->suite, i);
+            goto done;
+        }
+    }
+    res->ns = (current_time() - start) * 1e9 / BENCH_RECORDS;
+#ifdef USE_CYASSL_MEMORY
+    res->allocs = (double)(benchAllocs - allocs) / BENCH_RECORDS;
+#else
+    res->allocs = -1;
+#endif
+    ret = 0;
+
+done:
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    return ret;
+}
+
+
+/* pull the server lines of one test.conf case apart, returns 1 if the
+   bench can run it */
+static int BenchParseCase(char** args, int argsSz, BenchResult* res,
+                          const char** cert, const char** key)
+{
+    int i;
+
+    res->suite[0] = '\0';
+    res->version  = 3;
+    *cert = svrCert;
+    *key  = svrKey;
+
+    for (i = 0; i < argsSz; i++) {
+        const char* arg = args[i];
+
+        if (arg[0] != '-' || arg[1] == '\0' || (arg[2] != ' ' && arg[2]))
+            return 0;
+        switch (arg[1]) {
+            case 'v':
+                res->version = atoi(arg + 2);
+                break;
+            case 'l':
+                strncpy(res->suite, arg + 3, BENCH_SUITE_SZ);
+                res->suite[BENCH_SUITE_SZ] = '\0';
+                break;
+            case 'c':
+                *cert = arg + 3;
+                break;
+            case 'k':
+                *key = arg + 3;
+                break;
+            case 'A':
+                break;
+            default:
+                return 0;       /* psk, anon and the like need more setup */
+        }
+    }
+
+    return res->suite[0] != '\0';
+}
+
+
+static int BenchFind(BenchResult* list, int count, const BenchResult* res)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (list[i].version == res->version &&
+                                       strcmp(list[i].suite, res->suite) == 0)
+            return i;
+
+    return -1;
+}
+
+
+/* run every usable server case of BENCH_CONF once per suite and version */
+static int BenchRun(BenchResult* results)
+{
+    FILE*  file;
+    char   line[160];
+    char   lines[16][160];
+    char*  args[16];
+    int    argsSz = 0;
+    int    cliMode = 0;
+    int    count = 0;
+    int    eof = 0;
+
+    file = fopen(BENCH_CONF, "r");
+    if (file == NULL) {
+        printf("unable to open %s\n", BENCH_CONF);
+        return -1;
+    }
+
+    while (!eof) {
+        size_t len;
+
+        if (fgets(line, sizeof(line), file) == NULL) {
+            eof = 1;
+            line[0] = '\0';
+        }
+        len = strlen(line);
+        while (len && (line[len-1] == '\n' || line[len-1] == '\r' ||
+                       line[len-1] == ' '  || line[len-1] == '\t'))
+            line[--len] = '\0';
+
+        if (line[0] == '#')
+            continue;
+        if (line[0] != '\0') {
+            if (!cliMode && argsSz < 16) {
+                strcpy(lines[argsSz], line);
+                args[argsSz] = lines[argsSz];
+                argsSz++;
+            }
+            continue;
+        }
+
+        /* blank line, server case done or client case done */
+        if (!cliMode && argsSz) {
+            cliMode = 1;
+            continue;
+        }
+        if (cliMode) {
+            BenchResult* res = &results[count];
+            const char*  cert;
+            const char*  key;
+
+            if (count < BENCH_MAX_SUITES &&
+                    BenchParseCase(args, argsSz, res, &cert, &key) &&
+                    BenchFind(results, count, res) < 0 &&
+                    BenchSuite(res, cert, key) == 0) {
+                printf("  %-40s v%d %10.0f ns/record %6.2f allocs/record\n",
+                       res->suite, res->version, res->ns, res->allocs);
+                count++;
+            }
+            argsSz  = 0;
+            cliMode = 0;
+        }
+    }
+
+    fclose(file);
+    return count;
+}
+
+
+/* baseline lines are "suite version ns allocs", # comments */
+static int BenchLoad(const char* fname, BenchResult* list)
+{
+    FILE* file = fopen(fname, "r");
+    char  line[160];
+    int   count = 0;
+
+    if (file == NULL) {
+        printf("unable to open baseline %s\n", fname);
+        return -1;
+    }
+
+    while (count < BENCH_MAX_SUITES && fgets(line, sizeof(line), file)) {
+        BenchResult* res = &list[count];
+
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%80s %d %lf %lf", res->suite, &res->version,
+                   &res->ns, &res->allocs) == 4)
+            count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+
+static int BenchSave(const char* fname, BenchResult* list, int count)
+{
+    FILE* file = fopen(fname, "w");
+    int   i;
+
+    if (file == NULL) {
+        printf("unable to write baseline %s\n", fname);
+        return -1;
+    }
+
+    fprintf(file, "# record layer baseline, suite version ns/record "
+                  "allocs/record\n");
+    for (i = 0; i < count; i++)
+        fprintf(file, "%s %d %.0f %.2f\n", list[i].suite, list[i].version,
+                list[i].ns, list[i].allocs);
+
+    fclose(file);
+    return 0;
+}
+
+
+int BenchTest(const char* baseline, const char* output, int threshold)
+{
+    static BenchResult results[BENCH_MAX_SUITES];
+    static BenchResult base[BENCH_MAX_SUITES];
+    int count;
+    int baseCount = 0;
+    int failed = 0;
+    int i;
+
+    if (threshold <= 0)
+        threshold = BENCH_THRESHOLD;
+
+#ifdef USE_CYASSL_MEMORY
+    CyaSSL_SetAllocators(BenchMalloc, BenchFree, BenchRealloc);
+#endif
+
+    printf(" Begin Record Layer Benchmarks\n");
+
+    count = BenchRun(results);
+    if (count < 0)
+        return -1;
+
+    if (output && BenchSave(output, results, count) != 0)
+        return -1;
+
+    if (baseline) {
+        baseCount = BenchLoad(baseline, base);
+        if (baseCount < 0)
+            return -1;
+    }
+
+    for (i = 0; i < count && baseCount; i++) {
+        int idx = BenchFind(base, baseCount, &results[i]);
+
+        if (idx < 0)
+            continue;
+        if (results[i].ns > base[idx].ns * (100 + threshold) / 100) {
+            printf("  %s v%d slower, %.0f ns/record, baseline %.0f\n",
+                   results[i].suite, results[i].version, results[i].ns,
+                   base[idx].ns);
+            failed++;
+        }
+        if (results[i].allocs >= 0 && base[idx].allocs >= 0 &&
+                                results[i].allocs > base[idx].allocs + 0.005) {
+            printf("  %s v%d allocates more, %.2f allocs/record, "
+                   "baseline %.2f\n", results[i].suite, results[i].version,
+                   results[i].allocs, base[idx].allocs);
+            failed++;
+        }
+    }
+
+    printf(" End Record Layer Benchmarks, %d suites, %d regressions\n", count,
+           failed);
+
+    return failed ? 1 : 0;
+}
+
+#else
+
+int BenchTest(const char* baseline, const char* output, int threshold)
+{
+    (void)baseline;
+    (void)output;
+    (void)threshold;
+
+    printf("record layer benchmarks need client, server and certs\n");
+    return 0;
+}
+
+#endif
@@ -6,6 +6,8 @@
 #include <cyassl/ctaocrypt/settings.h>
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <tests/unit.h>
 
 
@@ -23,10 +25,35 @@ int main(int argc, char** argv)
 int unit_test(int argc, char** argv)
 {
     int ret;
+    int i;
+    int bench = 0;
+    int threshold = 0;
+    const char* baseline = NULL;
+    const char* output = NULL;
+
+    /* -b [baseline] record layer benchmarks instead of the tests,
+       -w file writes a baseline, -t pct allowed slowdown */
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0) {
+            bench = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                baseline = argv[++i];
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            bench = 1;
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threshold = atoi(argv[++i]);
+        else {
+            printf("usage: %s [-b [baseline]] [-w baseline] [-t pct]\n",
+                   argv[0]);
+            return -1;
+        }
+    }
 
-    (void)argc;
-    (void)argv;
-    printf("starting unit tests...\n");
+    if (!bench)
+        printf("starting unit tests...\n");
 
 #ifdef HAVE_CAVIUM
     ret = OpenNitroxDevice(CAVIUM_DIRECT, CAVIUM_DEV_ID);
@@ -41,6 +68,9 @@ int unit_test(int argc, char** argv)
         ChangeDirBack(3);
 #endif
 
+    if (bench)
+        return BenchTest(baseline, output, threshold);
+
     ApiTest();
 
     if ( (ret = HashTest()) != 0){
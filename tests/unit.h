@@ -58,6 +58,7 @@
 void ApiTest(void);
 int SuiteTest(void);
 int HashTest(void);
+int BenchTest(const char* baseline, const char* output, int threshold);
 
 
 #endif /* CyaSSL_UNIT_H */
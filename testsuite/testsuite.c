@@ -43,6 +43,12 @@ void file_test(const char* file, byte* hash);
 
 void simple_test(func_args*);
 
+#if defined(CYASSL_MEM_TRACE) && !defined(NO_CERTS) && \
+    !defined(NO_FILESYSTEM) && !defined(NO_SESSION_CACHE)
+    #define HAVE_TRACE_TEST
+    static int trace_test(void);
+#endif
+
 enum {
     NUMARGS = 3
 };
@@ -161,6 +167,12 @@ int testsuite_test(int argc, char** argv)
         if (server_args.return_code != 0) return server_args.return_code;
     }
 
+#ifdef HAVE_TRACE_TEST
+    /* allocations per handshake */
+    if (trace_test() != 0)
+        return EXIT_FAILURE;
+#endif
+
     /* show ciphers */
     {
         char ciphers[1024];
@@ -275,6 +287,147 @@ void simple_test(func_args* args)
 }
 
 
+#ifdef HAVE_TRACE_TEST
+
+/* one way memory pipe for the traced handshakes */
+typedef struct trace_pipe {
+    char buf[32768];
+    int  len;
+} trace_pipe;
+
+static trace_pipe toServer, toClient;
+
+
+static int trace_send(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    trace_pipe* io = (trace_pipe*)ctx;
+
+    (void)ssl;
+
+    if (io->len + sz > (int)sizeof(io->buf))
+        return CYASSL_CBIO_ERR_GENERAL;
+
+    memcpy(io->buf + io->len, buf, sz);
+    io->len += sz;
+
+    return sz;
+}
+
+
+static int trace_recv(CYASSL* ssl, char* buf, int sz, void* ctx)
+{
+    trace_pipe* io = (trace_pipe*)ctx;
+
+    (void)ssl;
+
+    if (io->len == 0)
+        return CYASSL_CBIO_ERR_WANT_READ;
+
+    if (sz > io->len)
+        sz = io->len;
+
+    memcpy(buf, io->buf, sz);
+    memmove(io->buf, io->buf + sz, io->len - sz);
+    io->len -= sz;
+
+    return sz;
+}
+
+
+/* connection setup through shutdown, resuming session when given, returns
+   the allocations made or 0 on failure */
+static unsigned long trace_handshake(CYASSL_CTX* cctx, CYASSL_CTX* sctx,
+                                     CYASSL_SESSION** session)
+{
+    CYASSL* client;
+    CYASSL* server;
+    int     c = SSL_FATAL_ERROR;
+    int     s = SSL_FATAL_ERROR;
+    int     i;
+    unsigned long allocs = CyaSSL_MemTraceAllocs(CYASSL_TRACE_ALL);
+
+    toServer.len = toClient.len = 0;
+    client = CyaSSL_new(cctx);
+    server = CyaSSL_new(sctx);
+    if (client == NULL || server == NULL) {
+        CyaSSL_free(client);
+        CyaSSL_free(server);
+        return 0;
+    }
+    CyaSSL_SetIOWriteCtx(client, &toServer);
+    CyaSSL_SetIOReadCtx(client, &toClient);
+    CyaSSL_SetIOWriteCtx(server, &toClient);
+    CyaSSL_SetIOReadCtx(server, &toServer);
+    if (*session)
+        CyaSSL_set_session(client, *session);
+
+    for (i = 0; i < 10 && (c != SSL_SUCCESS || s != SSL_SUCCESS); i++) {
+        if (c != SSL_SUCCESS)
+            c = CyaSSL_connect(client);
+        if (s != SSL_SUCCESS)
+            s = CyaSSL_accept(server);
+    }
+    if (c == SSL_SUCCESS && *session && !CyaSSL_session_reused(client))
+        c = SSL_FATAL_ERROR;
+
+    *session = CyaSSL_get_session(client);
+    CyaSSL_shutdown(client);
+    CyaSSL_free(client);
+    CyaSSL_free(server);
+
+    if (c != SSL_SUCCESS || s != SSL_SUCCESS)
+        return 0;
+
+    return CyaSSL_MemTraceAllocs(CYASSL_TRACE_ALL) - allocs;
+}
+
+
+static int trace_test(void)
+{
+    CYASSL_CTX*     cctx = CyaSSL_CTX_new(CyaSSLv23_client_method());
+    CYASSL_CTX*     sctx = CyaSSL_CTX_new(CyaSSLv23_server_method());
+    CYASSL_SESSION* session = NULL;
+    unsigned long   full = 0;
+    unsigned long   resumed = 0;
+
+    if (cctx && sctx &&
+        CyaSSL_CTX_use_certificate_file(sctx, svrCert, SSL_FILETYPE_PEM)
+                                                             == SSL_SUCCESS &&
+        CyaSSL_CTX_use_PrivateKey_file(sctx, svrKey, SSL_FILETYPE_PEM)
+                                                             == SSL_SUCCESS) {
+        /* client and server entries would share a row of one cache */
+        CyaSSL_CTX_set_session_cache_size(sctx, 16);
+        CyaSSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, 0);
+        CyaSSL_SetIORecv(cctx, trace_recv);
+        CyaSSL_SetIOSend(cctx, trace_send);
+        CyaSSL_SetIORecv(sctx, trace_recv);
+        CyaSSL_SetIOSend(sctx, trace_send);
+
+        CyaSSL_MemTraceReset();
+        full = trace_handshake(cctx, sctx, &session);
+        if (full)
+            CyaSSL_MemTraceDump(CYASSL_TRACE_ALL);
+        if (full)
+            resumed = trace_handshake(cctx, sctx, &session);
+    }
+
+    CyaSSL_CTX_free(cctx);
+    CyaSSL_CTX_free(sctx);
+
+    if (full == 0 || resumed == 0) {
+        printf("traced handshakes failed\n");
+        return -1;
+    }
+
+    printf("allocations per full handshake: %lu\n", full);
+    printf("allocations per resumed handshake: %lu\n", resumed);
+
+    return 0;
+}
+
+#endif /* HAVE_TRACE_TEST */
+
+
 void wait_tcp_ready(func_args* args)
 {
 #if defined(_POSIX_THREADS) && !defined(__MINGW32__)